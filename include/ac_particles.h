@@ -43,6 +43,7 @@
 #define MAX_PARTICLE_OUTPUT_VARIABLE_LENGTH 12
 #define MAX_PARTICLE_FILENAME_LENGTH        80
 #define MAX_PARTICLE_STRING_LENGTH         255
+#define PARTICLE_BINARY_BUFFER_SIZE   (1<<22)
 
 #define XI_BOUNDARY_TOLERANCE0 1.0e-8
 #define XI_BOUNDARY_TOLERANCE1 1.0e-12
@@ -73,7 +74,7 @@ enum Particle_Model_t { NO_PARTICLE_MODEL,
                         CHARGED_TRACER_EXPLICIT, CHARGED_TRACER_IMPLICIT,
 			DIELECTROPHORETIC_TRACER_IMPLICIT};
 
-enum Particle_Output_Format_t { FLAT_TEXT, TECPLOT };
+enum Particle_Output_Format_t { FLAT_TEXT, TECPLOT, BINARY };
 
 enum PBC { PBC_OUTFLOW, PBC_SOURCE, PBC_TARGET, PBC_FREESTREAM_SOURCE, PBC_IMPERMEABLE };
 
@@ -147,6 +148,7 @@ extern dbl Particle_Output_Time_Step;
 extern int Particle_Max_Time_Steps;
 extern enum Particle_Output_Format_t Particle_Output_Format;
 extern int Particle_Full_Output_Stride;
+extern int Particle_Compaction_Stride;
 extern particle_filename_s Particle_Full_Output_Filename;
 extern int Particle_Number_Sample_Types;
 extern int *Particle_Number_Samples;
@@ -48,6 +48,9 @@ EXTERN dbl LSA_3D_of_2D_wave_number; /* value of the wave number */
 EXTERN dbl *LSA_wave_numbers;	/* the wave numbers (not necessarily integers!) to compute */
 EXTERN int LSA_number_wave_numbers; /* length of LSA_wave_numbers */
 EXTERN int LSA_current_wave_number; /* index of current LSA_wave_number */
+EXTERN int LSA_wave_number_interpolation; /* get the matrices of the wave
+					  * numbers past the first three from
+					  * a quadratic in the wave number */
 
 EXTERN int solve_stability_problem /* ac_solve.c */
     PROTO((struct Aztec_Linear_Solver_System *,
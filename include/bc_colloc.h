@@ -195,6 +195,13 @@ PROTO((struct Data_Table *,   /* table               */
        double *,              /* slope                 */
        double []));           /* gradient array         */
 
+EXTERN void table_interval_setup
+PROTO((struct Data_Table *));  /* table               */
+
+EXTERN int table_interval
+PROTO((struct Data_Table *,   /* table               */
+       const double));        /* x                     */
+
 EXTERN double table_distance_search
 PROTO((struct Data_Table *,   /* table               */
        double [],                     /* x            */
@@ -26,6 +26,10 @@
 #define EXTERN extern
 #endif
 
+EXTERN void mark_dirichlet_rows
+PROTO((const int ,		/* num_total_nodes */
+       struct elem_side_bc_struct *)); /* elem_side_bc */
+
 EXTERN int put_dirichlet_in_matrix
 PROTO((double [],		/* x - Solution vector                       */
        const int));		/* num_total_nodes */
@@ -111,6 +111,9 @@ EXTERN void calculate_2D_rotation_vectors
 PROTO((Exo_DB *,		/* exo - ptr to the whole FE mesh */
        double []));		/* x - Soln vector */
 
+EXTERN void rotation_vectors_invalidate
+PROTO((void));
+
 									
 EXTERN void append_vectors
 PROTO (( int , 
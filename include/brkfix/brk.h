@@ -5,4 +5,11 @@
 
 int brk_exo_file(int num_pieces, char *Brk_File, char *Exo_File);
 
+#ifdef PARALLEL
+/* The same, with the per-piece work shared by all the ranks of comm */
+
+int brk_exo_file_comm(int num_pieces, char *Brk_File, char *Exo_File,
+		      MPI_Comm comm);
+#endif
+
 #endif /* BRK_H */
@@ -0,0 +1,42 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/* geom_part.h - prototype declarations for geom_part.c
+ */
+
+#ifndef _GEOM_PART_H
+#define _GEOM_PART_H
+
+#ifdef EXTERN
+#undef EXTERN
+#endif
+
+#ifdef _GEOM_PART_C
+#define EXTERN /* do nothing */
+#endif
+
+#ifndef _GEOM_PART_C
+#define EXTERN extern
+#endif
+
+EXTERN void geom_partition	/* geom_part.c */
+PROTO((const int ,		/* method - BRK_PART_RCB or BRK_PART_HILBERT */
+       const int ,		/* nvtxs - number of graph verteces */
+       const int ,		/* ndim - number of coordinates, 1..3 */
+       flt *,			/* x coordinates */
+       flt *,			/* y coordinates (NULL if ndim < 2) */
+       flt *,			/* z coordinates (NULL if ndim < 3) */
+       const int *,		/* vwgts - vertex weights, NULL for unit */
+       const int ,		/* nsets - number of pieces */
+       int *));			/* assignment - set 0..nsets-1 of ea vertex */
+
+#endif /* _GEOM_PART_H */
@@ -30,9 +30,10 @@
 
 #ifdef _PPI_C
 const char filter[]="sed -e 's/#.*$//' -e '/^[ 	]*$/d' -e 's/[ 	]*$//'";
-#define TEMP_PREFIX	"tmp."
 #endif
 
+#define TEMP_PREFIX	"tmp."	/* brk_pre_process() output is tmp.<input> */
+
 EXTERN void brk_pre_process
 PROTO((char *));		/* input filename */
 
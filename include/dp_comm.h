@@ -30,10 +30,35 @@ PROTO((Comm_Ex *,		/* cx - ptr to communications exchange info */
        Dpi *,			/* dpi - distributed processing info */
        double *));		/* x - local processor dof-based vector */
 
+EXTERN void exchange_dof_begin
+PROTO((Comm_Ex *,		/* cx - ptr to communications exchange info */
+       Dpi *,			/* dpi - distributed processing info */
+       double *));		/* x - local processor dof-based vector */
+
+EXTERN void exchange_dof_end
+PROTO((void));
+
+EXTERN int exchange_pending
+PROTO((void));
+
+EXTERN void exchange_dof_multi
+PROTO((Comm_Ex *,		/* cx - ptr to communications exchange info */
+       Dpi *,			/* dpi - distributed processing info */
+       const int,		/* nvec - number of vectors */
+       double **));		/* xs - nvec local processor dof-based vectors */
 
 EXTERN void exchange_node
 PROTO((Comm_Ex *cx,		/* cx - ptr to communications exchange info */
        Dpi *d,			/* dpi - distributed processing info */
        double *a));		/* x - local processor node-based vector */
 
+EXTERN void exchange_node_multi
+PROTO((Comm_Ex *,		/* cx - ptr to communications exchange info */
+       Dpi *,			/* dpi - distributed processing info */
+       const int,		/* nvec - number of vectors */
+       double **));		/* xs - nvec local processor node-based vectors */
+
+EXTERN void exchange_free
+PROTO((void));
+
 #endif /* _DP_COMM_H */
@@ -0,0 +1,51 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * dp_comm_prof.h -- counters of the point to point traffic with each
+ * neighbor and of the reductions at each call site, for the
+ * Communication Report File
+ */
+
+#ifndef _DP_COMM_PROF_H
+#define _DP_COMM_PROF_H
+
+#ifdef EXTERN
+#undef EXTERN
+#endif
+
+#ifdef _DP_COMM_PROF_C
+#define EXTERN /* do nothing */
+#endif
+
+#ifndef _DP_COMM_PROF_C
+#define EXTERN extern
+#endif
+
+EXTERN char Comm_Report_File[MAX_FNL]; /* "Communication Report File",
+					* empty if none */
+
+#define COMM_PROF_ON	(Comm_Report_File[0] != '\0')
+
+EXTERN void comm_prof_send
+PROTO((const int ,		/* rank - neighbor sent to */
+       const int ));		/* bytes */
+
+EXTERN void comm_prof_recv
+PROTO((const int ,		/* rank - neighbor received from */
+       const int ,		/* bytes */
+       const dbl ));		/* wait - seconds spent waiting for it */
+
+EXTERN void comm_report
+PROTO((void));			/* collective, at the end of the run */
+
+#endif /* _DP_COMM_PROF_H */
@@ -84,6 +84,7 @@ struct Derived_Datatype_Description
   int *block_count;
   MPI_Datatype *data_type;
   MPI_Aint     *address;
+  int          *byte_count;     /* bytes of each member, ddd_set_pack() */
   MPI_Datatype  new_type;
 
   MPI_Aint extent;              /* extent of new derived data type */
@@ -51,6 +51,13 @@ PROTO((void));
 EXTERN void ddd_set_commit 
 PROTO((DDD));
 
+EXTERN void ddd_set_pack
+PROTO((DDD));
+
+EXTERN void ddd_bcast
+PROTO((DDD,			/* which collection? */
+       int));			/* root - processor that has it */
+
 EXTERN void ddd_free 
 PROTO((DDD));
 
@@ -67,11 +74,27 @@ extern int  gminloc_int(const int, const int, int *);
 extern int  gmax_int(const int);
 extern int  gmin_int(const int);
 extern int  gsum_Int(const int);
+extern goma_gid gsum_Gid(const goma_gid);
 extern double gavg_double(const double);
 extern void print_sync_start(int);
 extern void print_sync_end(int);
 extern void sync_processors(void);
 
+/*
+ * Global status reduction, see dp_utils.c
+ */
+#define GSTATUS_MAX_SLOTS 32
+#define GSTATUS_SUM 0
+#define GSTATUS_MAX 1
+#define GSTATUS_MIN 2
+#define GSTATUS_MAXLOC 3
+
+extern void   gstatus_begin(void);
+extern int    gstatus_add(const int, const double);
+extern int    gstatus_add_maxloc(const double);
+extern void   gstatus_start(void);
+extern double gstatus_get(const int);
+
 #ifdef PARALLEL
 extern int Proc_Config[AZ_PROC_SIZE];
 #else
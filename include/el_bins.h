@@ -0,0 +1,69 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * el_bins.h -- uniform bins of element bounding boxes, for point location
+ *
+ * Each bin lists the elements whose bounding box overlaps it, so the few
+ * elements that can hold a point are found without looking at all of
+ * them.  The bins are built from whatever coordinates are passed in;
+ * after the mesh moves they are simply built again.
+ */
+
+#ifndef _EL_BINS_H
+#define _EL_BINS_H
+
+#ifdef EXTERN
+#undef EXTERN
+#endif
+
+#ifdef _EL_BINS_C
+#define EXTERN /* do nothing */
+#endif
+
+#ifndef _EL_BINS_C
+#define EXTERN extern
+#endif
+
+typedef struct Elem_Bins
+{
+  int  dim;			/* coordinates used, 1 to 3 */
+  int  e_start, e_end;		/* the elements binned, [e_start,e_end) */
+  int  nb[3];			/* bins in each direction */
+  dbl  lo[3];			/* low corner of the bins */
+  dbl  h[3];			/* bin widths */
+  int *bin_ptr;			/* [nbins+1] start of each bin in bin_list */
+  int *bin_list;		/* the elements overlapping each bin */
+} ELEM_BINS;
+
+EXTERN void elem_bins_build
+PROTO((ELEM_BINS *,		/* eb - filled in                            */
+       Exo_DB *,		/* exo - ptr to EXODUS II finite element db  */
+       dbl **,			/* coor - [dim][node] node coordinates       */
+       const int ,		/* dim - coordinates to use                  */
+       const int ,		/* e_start - first element binned            */
+       const int ));		/* e_end - one past the last one             */
+
+EXTERN void elem_bins_free
+PROTO((ELEM_BINS *));		/* eb                                        */
+
+EXTERN int elem_bins_at		/* returns the number of candidates          */
+PROTO((const ELEM_BINS *,	/* eb                                        */
+       const dbl [],		/* x - point                                 */
+       int **));		/* elems - (out) the elements that may hold x*/
+
+EXTERN int elem_bins_nearest	/* returns the element, -1 if none           */
+PROTO((const ELEM_BINS *,	/* eb                                        */
+       const dbl [],		/* x - point                                 */
+       dbl **));		/* ctr - [elem][dim] a point of each element */
+
+#endif /* _EL_BINS_H */
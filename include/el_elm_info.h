@@ -13,6 +13,8 @@
 #ifndef _EL_ELM_INFO_H
 #define _EL_ELM_INFO_H
 
+#include "el_elm.h"
+#include "mm_as_const.h"
 
 #ifdef EXTERN
 #undef EXTERN
@@ -26,10 +28,13 @@
 #define EXTERN extern
 #endif
 
-EXTERN int elem_info
+EXTERN int elem_info_switch	/* elem_info() without the table             */
 PROTO((const int ,		/* info                                      */
        const int ));		/* ielem_type                                */
 
+EXTERN int reduced_quad_type	/* rule for "Reduced Quadrature" equations   */
+PROTO((const int ));		/* ielem_type                                */
+
 #ifdef DEBUG_HKM
 EXTERN int node_info
 PROTO((const int  ,		/* n                                         */
@@ -44,16 +49,103 @@ PROTO((const int ,              /* n                                         */
        const int ,              /* interp_type                               */
        const int));	        /* edge                                      */
       
-EXTERN int type2shape
+EXTERN int type2shape_switch	/* type2shape() without the table            */
 PROTO((const int ));		/* element_type                              */
 
-EXTERN int shape2sides
+EXTERN int shape2sides_switch	/* shape2sides() without the table           */
 PROTO((const int ));		/* element_shape                             */
 
-EXTERN int getdofs
+EXTERN int getdofs_switch	/* getdofs() without the table               */
 PROTO((const int ,		/* element_shape                             */
        const int ));		/* interpolation                             */
 
+/*
+ * elem_info(), type2shape(), shape2sides() and getdofs() answer from
+ * tables, so that the element and quadrature point loops that ask them
+ * over and over do not go through the switches of el_elm_info.c each
+ * time. A table entry holds the answer plus one and is filled the first
+ * time it is asked, zero means not asked yet; threads racing on an entry
+ * store the same value. Arguments outside the tables, and answers that
+ * are errors, always go to the switch.
+ */
+
+#define ELEM_INFO_CODES   (NQUAD_EDGE + 1)
+#define NUM_ELEM_TYPES    (P0_SHELL + 1)
+#define NUM_ELEM_SHAPES   (TRISHELL + 1)
+
+EXTERN int Elem_Info_Table[NUM_ELEM_TYPES][ELEM_INFO_CODES];
+EXTERN int Elem_Shape_Table[NUM_ELEM_TYPES];
+EXTERN int Elem_Sides_Table[NUM_ELEM_SHAPES];
+EXTERN int Elem_Dofs_Table[NUM_ELEM_SHAPES][MAX_INTERP_TYPES];
+
+static inline int
+elem_info(const int info,
+	  const int ielem_type)
+{
+  int answer;
+
+  if (ielem_type < 0 || ielem_type >= NUM_ELEM_TYPES ||
+      info < 0 || info >= ELEM_INFO_CODES)
+    return (elem_info_switch(info, ielem_type));
+  answer = Elem_Info_Table[ielem_type][info];
+  if (answer == 0)
+    {
+      answer = elem_info_switch(info, ielem_type) + 1;
+      Elem_Info_Table[ielem_type][info] = answer;
+    }
+  return (answer - 1);
+}
+
+static inline int
+type2shape(const int element_type)
+{
+  int shape;
+
+  if (element_type < 0 || element_type >= NUM_ELEM_TYPES)
+    return (type2shape_switch(element_type));
+  shape = Elem_Shape_Table[element_type];
+  if (shape == 0)
+    {
+      shape = type2shape_switch(element_type) + 1;
+      Elem_Shape_Table[element_type] = shape;
+    }
+  return (shape - 1);
+}
+
+static inline int
+shape2sides(const int element_shape)
+{
+  int num_sides;
+
+  if (element_shape < 0 || element_shape >= NUM_ELEM_SHAPES)
+    return (shape2sides_switch(element_shape));
+  num_sides = Elem_Sides_Table[element_shape];
+  if (num_sides == 0)
+    {
+      num_sides = shape2sides_switch(element_shape) + 1;
+      Elem_Sides_Table[element_shape] = num_sides;
+    }
+  return (num_sides - 1);
+}
+
+static inline int
+getdofs(const int element_shape,
+	const int interpolation)
+{
+  int dofs;
+
+  if (element_shape < 0 || element_shape >= NUM_ELEM_SHAPES ||
+      interpolation < 0 || interpolation >= MAX_INTERP_TYPES)
+    return (getdofs_switch(element_shape, interpolation));
+  dofs = Elem_Dofs_Table[element_shape][interpolation];
+  if (dofs == 0)
+    {
+      dofs = getdofs_switch(element_shape, interpolation) + 1;
+      Elem_Dofs_Table[element_shape][interpolation] = dofs;
+    }
+  return (dofs - 1);
+}
+
 EXTERN void find_stu
 PROTO((const int ,		/* iquad - current GQ index                  */
        const int ,		/* ielem_type - element type                 */
@@ -72,6 +164,26 @@ PROTO((const int ,		/* iquad - current GQ index                  */
        double *,                /* t -                                       */
        double *));		/* u -                                       */
 
+/*
+ * Surface quadrature of one side of one element type, tabulated once
+ * from find_surf_st() and Gq_surf_weight().
+ */
+struct Surf_Quad_Side
+{
+  int filled;
+  int nquad;
+  dbl xi[MAX_SURF_GP][DIM];
+  dbl s[MAX_SURF_GP];
+  dbl t[MAX_SURF_GP];
+  dbl u[MAX_SURF_GP];
+  dbl wt[MAX_SURF_GP];
+};
+
+EXTERN const struct Surf_Quad_Side *surf_quad_side
+PROTO((const int ,		/* ielem_type - element type                 */
+       const int ,		/* iside - side of element                   */
+       const int ));		/* dim - dimension of element                */
+
 EXTERN int find_edge_s
 PROTO((const int ,		/* iquad - current GQ index                  */
        const int ,		/* ielem_type - element type                 */
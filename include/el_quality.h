@@ -31,5 +31,10 @@ PROTO(( Exo_DB *,  		/* Exodus database structure */
         double *,		/* Solution vector */
         int *));		/* proc_config array */
 
+EXTERN void element_quality_jac_collect
+PROTO(( const int ,		/* ngp - Gauss points of the element */
+        const double ,		/* Jw_min - smallest |detJ| weight there */
+        const double ));	/* Jw_sum - their sum */
+
 
 #endif /* _EL_QUALITY_H */
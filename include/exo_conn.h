@@ -37,6 +37,12 @@ PROTO((Exo_DB *));		/* exo - ptr to EXODUS II database struct */
 EXTERN void build_elem_elem	/* exo_conn.c */
 PROTO((Exo_DB *));		/* exo - ptr to EXODUS II database struct */
 
+EXTERN void need_node_node	/* exo_conn.c -- build it if it was freed */
+PROTO((Exo_DB *));		/* exo - ptr to EXODUS II database struct */
+
+EXTERN void trim_exo		/* exo_conn.c -- Memory Lean */
+PROTO((Exo_DB *));		/* exo - ptr to EXODUS II database struct */
+
 EXTERN int build_side_node_list
 PROTO((int ,			/* elem - the element number */
        int ,			/* face - the face number */
@@ -329,6 +329,9 @@ struct Exodus_Database
 
   dbl	*ss_distfact_list;	/* SS df list. */
 
+  int	distfact_freed;		/* ns/ss_distfact_list freed by Memory
+				 * Lean, read back by rd_exo_distfacts() */
+
   /*
    * These weird beasts help to reference node names and the correct
    * distribution factors in a sideset. This is problematic because the
@@ -75,18 +75,23 @@
 #include "bc_contact.h"
 #include "bc_surfacedomain.h"
 #include "dp_comm.h"
+#include "dp_comm_prof.h"
 #include "dp_map_comm_vec.h"
 #include "dp_utils.h"
 #include "dp_vif.h"
 #include "el_elm_info.h"
 #include "el_quality.h"
 #include "exo_conn.h"
+#include "el_bins.h"
+#include "goma_lib.h"
 #include "md_timer.h"
 #include "mm_as_alloc.h"
 #include "mm_augc_util.h"
 #include "mm_bc.h"
 #include "mm_chemkin.h"
 #include "mm_fill.h"
+#include "mm_fill_thread.h"
+#include "mm_elem_cost.h"
 #include "mm_fill_util.h"
 #include "mm_fill_aux.h"
 #include "mm_fill_fill.h"
@@ -103,18 +108,22 @@
 #include "mm_fill_terms.h"
 #include "mm_flux.h"
 #include "mm_input.h"
+#include "mm_input_index.h"
 #include "mm_more_utils.h"
 #include "mm_numjac.h"
 #include "mm_ns_bc.h"
+#include "mm_plugin.h"
 #include "mm_post_proc.h"
 #include "mm_prob_def.h"
 #include "mm_shell_util.h"
 #include "mm_sol_nonlinear.h"
+#include "mm_sol_accel.h"
 #include "mm_std_models.h"
 #include "mm_qtensor_model.h"
 #include "mm_unknown_map.h"
 #include "mm_viscosity.h"
 #include "mm_dil_viscosity.h"
+#include "rd_donor_field.h"
 #include "rd_dpi.h"
 #include "rd_exo.h"
 #include "rd_mesh.h"
@@ -134,7 +143,12 @@
 #include "rf_node_const.h"
 #include "rf_pre_proc.h"
 #include "rf_shape.h"
+#include "rf_rom.h"
 #include "rf_solve.h"
+#include "rf_bdf.h"
+#include "rf_checkpoint.h"
+#include "rf_setup_cache.h"
+#include "rf_node_order.h"
 #include "rf_util.h"
 #include "sl_aux.h"
 #include "sl_auxutil.h"
@@ -151,7 +165,9 @@
 #include "user_pre.h"
 #include "wr_dpi.h"
 #include "wr_exo.h"
+#include "wr_insitu.h"
 #include "wr_side_data.h"
 #include "wr_soln.h"
+#include "wr_stats.h"
 
 #endif
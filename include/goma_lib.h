@@ -0,0 +1,82 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * goma_lib.h -- calling goma as a library, for repeated solves
+ *
+ * goma_lib_init() does what the executable does before its solve, once:
+ * input file, mesh, decomposition, dof maps. Each goma_lib_solve() then
+ * solves with the parameters as they stand, starting from the solution
+ * of the previous solve and reusing its matrix graph and solver; in
+ * between, goma_lib_set_parameter() changes boundary condition, material,
+ * augmenting condition or user parameters as continuation would.
+ * goma_lib_finalize() closes the results and frees the problem.
+ *
+ * All of these are collective: every processor calls them, with the same
+ * arguments. Link libgoma.a built with -DGOMA_LIBRARY, which leaves out
+ * main().
+ */
+
+#ifndef _GOMA_LIB_H
+#define _GOMA_LIB_H
+
+#ifdef EXTERN
+#undef EXTERN
+#endif
+
+#ifdef _GOMA_LIB_C
+#define EXTERN /* do nothing */
+#endif
+
+#ifndef _GOMA_LIB_C
+#define EXTERN extern
+#endif
+
+/*
+ * Parameter types, those of the continuation and sensitivity cards
+ */
+#define GOMA_LIB_BC 1		/* id = BC index, tag = float index */
+#define GOMA_LIB_MT 2		/* id = material index, tag = property tag,
+				   sub = its subindex */
+#define GOMA_LIB_AC 3		/* id = AC index, tag = float index or -1 */
+#define GOMA_LIB_UM 4		/* id = material index, tag = property tag,
+				   sub = user model float index */
+#define GOMA_LIB_UF 5		/* update_user_parameter(), ids unused */
+
+EXTERN int goma_lib_init	/* 0, or -1 if the mesh could not be read */
+(int ,				/* argc - goma command line */
+ char **);			/* argv */
+
+EXTERN int goma_lib_set_parameter /* 0, or -1 for a bad type or id */
+(const int ,			/* type - GOMA_LIB_BC, ... */
+ const int ,			/* id */
+ const int ,			/* tag */
+ const int ,			/* sub */
+ const double );		/* value */
+
+EXTERN int goma_lib_get_parameter /* 0, or -1 for a bad type or id */
+(const int ,			/* type - GOMA_LIB_BC, ..., not GOMA_LIB_UF */
+ const int ,			/* id */
+ const int ,			/* tag */
+ const int ,			/* sub */
+ double *);			/* value (out) */
+
+EXTERN int goma_lib_solve	/* 0 */
+(void);
+
+EXTERN const double *goma_lib_solution /* NULL before the first solve */
+(int *);			/* num_unknowns - of this processor (out) */
+
+EXTERN int goma_lib_finalize	/* 0 */
+(void);
+
+#endif /* _GOMA_LIB_H */
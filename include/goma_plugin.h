@@ -0,0 +1,92 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * goma_plugin.h -- the interface of a property plugin (Property Plugin
+ *                  card of the material file).
+ *
+ * This is the only Goma header a plugin needs; it has no other Goma
+ * dependencies, so a plugin can be built, and rebuilt, apart from Goma:
+ *
+ *	cc -O3 -fPIC -shared -o libmyvisc.so myvisc.c
+ *
+ * The plugin is a function
+ *
+ *	int my_visc(goma_plugin_batch *b);
+ *
+ * called with the state at the b->n quadrature points of an element (or
+ * at a single point, where Goma needs the property outside the element's
+ * volume quadrature). Every array is point fastest, so
+ *
+ *	for (i = 0; i < b->n; i++)
+ *	  {
+ *	    b->value[i] = b->params[0] * exp(-b->params[1] * b->T[i]);
+ *	    b->d_T[i] = -b->params[1] * b->value[i];
+ *	  }
+ *
+ * is a loop the compiler can vectorize. The state of a variable that is
+ * not active in the material is zero; C[w*n + i] is species w at point
+ * i. The results are zeroed by Goma before the call, so a plugin only
+ * sets the derivatives that are not zero. The params are the constants
+ * of the property's USER model. The function returns 0, or anything else
+ * to stop the run with an error.
+ *
+ * A plugin may export
+ *
+ *	int goma_plugin_abi_version = GOMA_PLUGIN_ABI_VERSION;
+ *
+ * and is then refused if it was built against another version of this
+ * header.
+ */
+
+#ifndef _GOMA_PLUGIN_H
+#define _GOMA_PLUGIN_H
+
+#define GOMA_PLUGIN_ABI_VERSION		1
+
+#define GOMA_PLUGIN_VISCOSITY		0
+#define GOMA_PLUGIN_DENSITY		1
+#define GOMA_PLUGIN_THERMAL_CONDUCTIVITY 2
+#define GOMA_PLUGIN_HEAT_SOURCE		3
+#define GOMA_PLUGIN_DIFFUSIVITY		4 /* of b->species */
+
+typedef struct goma_plugin_batch
+{
+  int abi_version;		/* GOMA_PLUGIN_ABI_VERSION */
+  int property;			/* GOMA_PLUGIN_VISCOSITY, ... */
+  int species;			/* for GOMA_PLUGIN_DIFFUSIVITY, else -1 */
+  int n;			/* points in the batch */
+  int dim;			/* of x, v, d_x and d_v */
+  int num_species;		/* of C and d_C */
+  int num_params;
+  const double *params;
+  double time;
+
+  /* state at the points */
+  const double *x[3];		/* coordinates, displaced */
+  const double *T;		/* temperature */
+  const double *P;		/* pressure */
+  const double *v[3];		/* velocity */
+  const double *C;		/* species, C[w*n + i] */
+
+  /* results, zeroed by Goma */
+  double *value;
+  double *d_T;
+  double *d_P;
+  double *d_x[3];
+  double *d_v[3];
+  double *d_C;			/* d_C[w*n + i] */
+} goma_plugin_batch;
+
+typedef int (*goma_plugin_fn)(goma_plugin_batch *);
+
+#endif
@@ -164,6 +164,8 @@ struct eigen_info_struct {
    int    Max_Iter;           /* Maximum number of iterations of eigensolver */
    int    Every_n_Steps;      /* Allow for eigenvalue calc every n steps along
                                  a continuation run                          */
+   int    Warm_Start;         /* Start from the modes and shifts of the last
+                                 eigensolve, if there was one               */
 };
 
 struct private_info_struct {
@@ -13,6 +13,7 @@
 #ifndef _MD_TIMER_H
 #define _MD_TIMER_H
 
+#include "rf_io_const.h"	/* MAX_FNL */
 
 #ifdef EXTERN
 #undef EXTERN
@@ -32,6 +33,112 @@ PROTO((void));
 EXTERN double ust		/* user + system time in seconds */
 PROTO((void));
 
+EXTERN char Perf_Report_File[MAX_FNL]; /* "Performance Report File", empty
+					* if none */
+EXTERN int Perf_Report_Interval; /* time steps between reports, 0 for only
+				  * the one at the end of the run */
+
+EXTERN dbl wall_time		/* elapsed seconds */
+PROTO((void));
+
+EXTERN dbl cpu_time		/* user + system time in seconds */
+PROTO((void));
+
+EXTERN void timer_push
+PROTO((const char *));		/* name - of the region opened */
+
+EXTERN void timer_pop
+PROTO((const char *));		/* name - of the region closed */
+
+EXTERN void timer_report
+PROTO((const int ));		/* step - time step, -1 at the end */
+
+EXTERN void timer_report_step
+PROTO((const int ));		/* step - report if a multiple of the
+				 * Performance Report interval */
+
+EXTERN char Trace_File[MAX_FNL]; /* "Trace File", empty if none */
+EXTERN int Trace_Depth;		/* region levels traced, from the top */
+
+EXTERN void trace_open
+PROTO((void));			/* collective, before the solve */
+
+EXTERN void trace_close
+PROTO((void));			/* collective, at the end of the run */
+
+EXTERN char Perf_Log_File[MAX_FNL]; /* "Performance Log File", empty if
+				    * none */
+
+EXTERN void perf_log_begin_step
+PROTO((const int ));		/* step - time step number */
+
+EXTERN void perf_log_output
+PROTO((const dbl ));		/* seconds - spent writing output */
+
+EXTERN void perf_log_newton
+PROTO((const int ,		/* iter - Newton iteration */
+       const dbl ,		/* time */
+       const dbl ,		/* assembly - seconds */
+       const dbl ,		/* solve - seconds */
+       const int ,		/* krylov_its - -1 if none */
+       const char *,		/* precond - calc, recalc, reuse or NULL */
+       const int ,		/* jacobian_formed */
+       const dbl ,		/* residual - L2 norm */
+       const dbl ,		/* update - L2 norm, -1 if none */
+       const int ));		/* converged */
+
+EXTERN void perf_log_step
+PROTO((const dbl ,		/* time */
+       const dbl ,		/* delta_t */
+       const int ,		/* accepted */
+       const int ));		/* newton_its - -1 if failed */
+
+EXTERN void perf_log_close
+PROTO((void));
+
+/*
+ * Kernels timed by the Kernel Benchmark
+ */
+#define KB_LOAD_BASIS         0
+#define KB_BEER_BELLY         1
+#define KB_LOAD_FV            2
+#define KB_LOAD_FV_GRADS      3
+#define KB_LOAD_FV_MESH       4
+#define KB_MOMENTUM           5
+#define KB_CONTINUITY         6
+#define KB_ENERGY             7
+#define KB_STRESS_LOG_CONF    8
+#define KB_LOAD_LEC           9
+#define KB_NUM               10
+
+EXTERN int Kernel_Bench_Reps;	/* "Kernel Benchmark", 0 if none */
+EXTERN int Kernel_Bench_Active;	/* the kernels are being timed */
+EXTERN dbl Kernel_Bench_Time[KB_NUM];
+EXTERN dbl Kernel_Bench_Calls[KB_NUM];
+
+/*
+ * Time one kernel call, t0 being a dbl of the caller's. Only a flag test
+ * when the benchmark is not running.
+ */
+#define KB_START(t0)							\
+  do { if (Kernel_Bench_Active) (t0) = wall_time(); } while (0)
+#define KB_STOP(k, t0)							\
+  do {									\
+    if (Kernel_Bench_Active) {						\
+      Kernel_Bench_Time[k] += wall_time() - (t0);			\
+      Kernel_Bench_Calls[k] += 1.;					\
+    }									\
+  } while (0)
+
+EXTERN int kernel_bench_pending
+PROTO((void));
+
+EXTERN void kernel_bench_begin
+PROTO((void));
+
+EXTERN void kernel_bench_end
+PROTO((const dbl ));		/* seconds - wall time of the assemblies */
+
 EXTERN void get_date
 PROTO((char *));		/* string - fill in with mm/dd/yy */
 
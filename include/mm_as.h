@@ -73,4 +73,15 @@ extern struct Phase_Function_Data               *pfd;
 extern struct Lubrication_Auxiliaries           *LubAux;
 extern struct Lubrication_Auxiliaries           *LubAux_old;
 
+#ifdef _OPENMP
+/*
+ * Per-element scratch written by matrix_fill(). Each assembly thread owns
+ * its own copy, see mm_fill_thread.c.
+ */
+#pragma omp threadprivate(ei, eiRelated, esp, esp_old, esp_dot, esp_dbl_dot, evp, \
+                         pd, bf, bfd, bfi, bfex, fv, fv_sens, fv_dot_dot,       \
+                         fv_dot_dot_old, fv_old, fv_dot, fv_dot_old, pmv,       \
+                         pmv_old, pmv_ml, cr, lec, Stab, LubAux, LubAux_old)
+#endif
+
 #endif /* _MM_AS_H */
@@ -132,6 +132,8 @@ typedef char CK_NAME_STR[64];
 
 #define LEC_J_STRESS_INDEX(peqn, pvar, index_i, index_j) ((lec->max_dof*MAX_LOCAL_VAR_DESC*lec->max_dof)*(peqn)) + ((MAX_LOCAL_VAR_DESC*lec->max_dof)*(pvar))+(lec->max_dof*(index_i)) + index_j
 
+#define LEC_DIRICHLET_ROW(peqn_macro, index_macro) (lec->num_dirichlet_rows > 0 && lec->dirichlet_row[LEC_R_INDEX(peqn_macro, index_macro)])
+
 #ifndef MAX_PHASE_FUNC
 #define MAX_PHASE_FUNC 5
 #endif
@@ -696,6 +698,12 @@ struct Element_Quality_Metrics
   double vol_low;		/* Volume change global minimum		 */
   int vol_count;		/* Volume change Gauss point counter	 */
   int tol_type;			/* Tolerance type indicator		 */
+  int incremental;		/* Jacobian metric from the assembly	 */
+  double inc_margin;		/* full pass below margin*eq_tol	 */
+  int inc_full_every;		/* and every so many checks, 0 never	 */
+  double jac_sum;		/* Jacobian metric sum over elements	 */
+  double jac_low;		/* Jacobian metric minimum		 */
+  int jac_count;		/* Jacobian metric element counter	 */
 };
 
 /*___________________________________________________________________________*/
@@ -719,6 +727,13 @@ struct Local_Element_Contributions
   dbl *J_stress_neighbor;
   //dbl J_stress_neighbor[4][MDE][MAX_PROB_VAR + MAX_CONC][MDE];
 
+  /*
+   * Rows of the current element that put_dirichlet_in_matrix() will
+   * overwrite, flagged by mark_dirichlet_rows(); indexed like R.
+   */
+  int *dirichlet_row;
+  int num_dirichlet_rows;
+
   /*
    * NOTE: concentration entries in local element arrays are stored at
    *       the end of
@@ -934,6 +949,10 @@ struct Problem_Description
   int   LSVelocityIntegral;     /* Augmenting sevel set velocity integral flag */
   int   Num_Porous_Eqn;         /* number of porous media Equations */
   int   Do_Surf_Geometry;       /* Problem needs a bundle of surface geometry defined on it */
+  int   old_grad[MAX_VARIABLE_TYPES]; /* TRUE if a term of this material
+				 * reads the gradient of the variable at the
+				 * old time, fv_old->grad_*; load_fv_grads()
+				 * skips the others. Set in setup_pd(). */
 };
 typedef struct Problem_Description PROBLEM_DESCRIPTION_STRUCT;
 
@@ -1025,8 +1044,20 @@ struct Transient_Information
   dbl theta;        /* time step parameter: theta = 0. => Backward Euler
 		                            theta = 1. => Forward Euler
 		                            theta = .5 => Crack-Nicholson  */
+  int bdf_max_order; /* > 0 => variable order BDF up to this order; theta
+			is then set for each step */
   dbl eps;          /* time step error  */
   int use_var_norm[MAX_VARIABLE_TYPES]; /* Booleans used for time step truncation error control */
+  int ts_controller;	/* TS_CONTROL_ELEMENTARY, _PI or _H211B */
+  dbl ts_reject_growth;	/* largest dt ratio of the step after a rejection */
+  int ts_newton_target;	/* Newton steps beyond which dt shrinks in proportion, 0 off */
+  int multirate_subcycles; /* substeps of the fast unknowns per step, 1 off */
+  int multirate_num_blocks; /* element blocks whose own unknowns are fast */
+  int multirate_block_id[MAX_MULTIRATE_BLOCKS]; /* their ids, or MULTIRATE_SHELL */
+  dbl ptc_delta_t0;	/* first pseudo time step of a steady solve, 0 off */
+  dbl ptc_delta_t_max;	/* pseudo time step at which the plain Newton takes over */
+  int ptc_max_steps;	/* pseudo time steps before it does anyway */
+  dbl explicit_cfl;	/* fraction of the stable central difference step, 0 off */
   int fix_freq;
   int print_freq;
   double print_delt;
@@ -1034,6 +1065,8 @@ struct Transient_Information
   double print_delt2;
   double init_time;
   int const_dt_after_failure;
+  int ckpt_depth;	/* accepted steps kept in the checkpoint ring */
+  int ckpt_max_rollbacks; /* rollbacks allowed when dt reaches the minimum */
   int Restart_Time_Integ_After_Renorm;
 
   /* Quantities of displacement acceleration.   This is added
@@ -1074,6 +1107,7 @@ struct Eigensolver_Info
   int Eigen_Matrix_Output;
   int Eigen_Solve_Freq;
   int Eigen_Write_Freq;
+  int Eigen_Warm_Start;		/* seed from the previous solve's modes */
   dbl Eigen_Tolerance;
   dbl Eigen_IV_Wt;
   dbl Eigen_Shifts[4];
@@ -1104,6 +1138,7 @@ struct Continuation_Information
   int use_var_norm[MAX_VARIABLE_TYPES];
   int print_freq;
   int fix_freq;
+  int hunt_secant;		/* hzero: predict from the last two steps */
   double print_delt;
   double print_delt2_path;
   double print_delt2;
@@ -1398,6 +1433,31 @@ struct HC_Information
  *	(iv) mesh derivatives of (iii)
  */
 
+/*
+ * Tabulated phi and dphidxi of one basis function at one reference point
+ * for one element type and local dof layout. See load_basis_functions().
+ */
+#define BF_CACHE_SLOTS 1024	/* hash slots per basis function (power of 2) */
+#define BF_CACHE_MAX    512	/* max tabulated points per basis function */
+
+struct Basis_Function_Cache_Entry
+{
+  int ielem_type;		/* element type the table was made for */
+  int ndof;			/* ei->dof[v] when tabulated */
+  dbl xi[DIM];			/* reference coordinates of the point */
+  int node[MDE];		/* ei->dof_list[v][i] when tabulated */
+  int active[MDE];		/* ei->active_interp_ledof[] when tabulated */
+  dbl phi[MDE];
+  dbl dphidxi[MDE][DIM];
+};
+
+struct Basis_Function_Cache
+{
+  int num_entries;		/* entries in use, <= BF_CACHE_MAX */
+  int slot[BF_CACHE_SLOTS];	/* hash on xi -> entry index, -1 if empty */
+  struct Basis_Function_Cache_Entry *entry;
+};
+
 struct Basis_Functions
 {
   int ielem_type;		/* old SHM identifier of elements... */
@@ -1422,6 +1482,8 @@ struct Basis_Functions
    */
   dbl phi[MDE];			/* phi_i */
   dbl dphidxi[MDE][DIM];	/* d(phi_i)/d(xi_j) */
+  struct Basis_Function_Cache *cache; /* phi, dphidxi at points seen so far */
+  dbl xi[DIM];			/* reference point phi, dphidxi were loaded at */
 
   /*
    * beer_belly() fills in these elemental Jacobian things...
@@ -2613,6 +2675,7 @@ struct Level_Set_Data { int    var;
                         double Control_Width;
                         double Renorm_Tolerance;
                         int    Renorm_Method;
+                        double Renorm_Band;     /* Fast_Marching band, 0 = everywhere */
                         int    Search_Option;
                         int    Grid_Search_Depth;
                         int    Integration_Depth;
@@ -2620,6 +2683,8 @@ struct Level_Set_Data { int    var;
                         char * output_file;
                         int    Renorm_Freq;
                         int    Renorm_Countdown;
+                        int    Narrow_Band;     /* element layers assembled around the interface, 0 = all */
+                        double Lumped_Courant;  /* Courant number of the lumped explicit substeps */
 						int    Force_Initial_Renorm;
                         double Mass_Value;
                         int    Mass_Sign;
@@ -2635,8 +2700,10 @@ struct Level_Set_Data { int    var;
                         int    Elem_Sign;
 						int    elem_overlap_state;
                         int    SubElemIntegration;
+                        double SubElem_Cache_Tol;  /* relative dof change that keeps cached subelement points */
                         int    AdaptIntegration;
                         int    Adaptive_Order;
+                        int    Curvature_Projection; /* LS_CURV_PROJ_... */
                         int    CrossMeshQuadPoints;
                         int    on_sharp_surf;
                         int    Extension_Velocity;
@@ -33,6 +33,11 @@
 
 #include "loca_const.h"
 
+EXTERN int AC_Sensitivity_Forward; /* one-sided dR/dp, shared R(p) */
+
+EXTERN void ac_sensitivity_reset
+PROTO((void));
+
 EXTERN void update_parameterAC
 PROTO((int,                     /* NUMBER OF AC'S */
        double*,                 /* SOLUTION VECTOR */
@@ -142,5 +147,12 @@ EXTERN int assign_overlap_acs
 PROTO (( double [],
          Exo_DB * ));             /* Ptr to ExodusII database */
 
+EXTERN int periodic_node_pairs
+PROTO (( Exo_DB *,                /* Ptr to ExodusII database */
+         const int ,              /* ssid1 - side set of surface 1 */
+         const int ,              /* ssid2 - side set of surface 2 */
+         int **,                  /* node_list1 - (out) nodes of ssid1 */
+         int ** ));               /* node_list2match - (out) their match */
+
 
 #endif /* _MM_AUGC_UTIL_H */
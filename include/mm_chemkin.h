@@ -36,6 +36,9 @@ extern int ck_decide_vol_chem    PROTO ((CPC_VOLDOMAIN_STRUCT *));
 extern int chemkin_mat_prop_init PROTO ((MATRL_PROP_STRUCT *, int,
 				 	 PROBLEM_DESCRIPTION_STRUCT *));
 extern void chemkin_initialize_mp PROTO((void));
+extern int ck_gas_source_cached PROTO((const int, double, double, double [],
+				      const int, const int, double [],
+				      double [], double []));
 
 /*
  * externals in the mm_placid.c file
@@ -0,0 +1,171 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * mm_dual.h -- forward mode automatic differentiation for property models
+ *
+ * A DUAL carries a value and its derivatives with respect to up to
+ * DUAL_MAX_SLOTS independent Gauss point quantities (shear rate,
+ * temperature, model parameters, ...). A model assigns the slots it
+ * needs, seeds its inputs with dual_var() and is then written once in
+ * terms of the operations below; the chain rule is done by the
+ * operations. The caller turns the slot derivatives of the result into
+ * the per-dof dependence structs (d_mu, ...) with the usual basis
+ * functions.
+ *
+ * The slot count is a compile time constant, so the derivative loops are
+ * fixed length and are unrolled by the compiler; everything is static
+ * inline and passed by value.
+ */
+
+#ifndef _MM_DUAL_H
+#define _MM_DUAL_H
+
+#include <math.h>
+
+#ifndef DUAL_MAX_SLOTS
+#define DUAL_MAX_SLOTS 10
+#endif
+
+typedef struct Dual_Number {
+  dbl v;			/* value */
+  dbl d[DUAL_MAX_SLOTS];	/* d(value)/d(slot) */
+} DUAL;
+
+static inline DUAL
+dual_const(const dbl v)
+{
+  DUAL r;
+  int k;
+  r.v = v;
+  for (k = 0; k < DUAL_MAX_SLOTS; k++) r.d[k] = 0.;
+  return r;
+}
+
+/* an independent quantity, the derivative in its own slot is one */
+static inline DUAL
+dual_var(const dbl v, const int slot)
+{
+  DUAL r = dual_const(v);
+  r.d[slot] = 1.;
+  return r;
+}
+
+/* f(a) given f and f' at a.v */
+static inline DUAL
+dual_chain(const DUAL a, const dbl f, const dbl df)
+{
+  DUAL r;
+  int k;
+  r.v = f;
+  for (k = 0; k < DUAL_MAX_SLOTS; k++) r.d[k] = df * a.d[k];
+  return r;
+}
+
+static inline DUAL
+dual_add(const DUAL a, const DUAL b)
+{
+  DUAL r;
+  int k;
+  r.v = a.v + b.v;
+  for (k = 0; k < DUAL_MAX_SLOTS; k++) r.d[k] = a.d[k] + b.d[k];
+  return r;
+}
+
+static inline DUAL
+dual_sub(const DUAL a, const DUAL b)
+{
+  DUAL r;
+  int k;
+  r.v = a.v - b.v;
+  for (k = 0; k < DUAL_MAX_SLOTS; k++) r.d[k] = a.d[k] - b.d[k];
+  return r;
+}
+
+static inline DUAL
+dual_mul(const DUAL a, const DUAL b)
+{
+  DUAL r;
+  int k;
+  r.v = a.v * b.v;
+  for (k = 0; k < DUAL_MAX_SLOTS; k++) r.d[k] = a.d[k] * b.v + a.v * b.d[k];
+  return r;
+}
+
+static inline DUAL
+dual_div(const DUAL a, const DUAL b)
+{
+  DUAL r;
+  int k;
+  dbl binv = 1. / b.v;
+  r.v = a.v * binv;
+  for (k = 0; k < DUAL_MAX_SLOTS; k++) r.d[k] = (a.d[k] - r.v * b.d[k]) * binv;
+  return r;
+}
+
+/* a + c */
+static inline DUAL
+dual_add_c(const DUAL a, const dbl c)
+{
+  DUAL r = a;
+  r.v += c;
+  return r;
+}
+
+/* c * a */
+static inline DUAL
+dual_scale(const DUAL a, const dbl c)
+{
+  return dual_chain(a, c * a.v, c);
+}
+
+static inline DUAL
+dual_exp(const DUAL a)
+{
+  dbl e = exp(a.v);
+  return dual_chain(a, e, e);
+}
+
+static inline DUAL
+dual_log(const DUAL a)
+{
+  return dual_chain(a, log(a.v), 1. / a.v);
+}
+
+static inline DUAL
+dual_sqrt(const DUAL a)
+{
+  dbl s = sqrt(a.v);
+  return dual_chain(a, s, (s != 0.) ? 0.5 / s : 0.);
+}
+
+/* a^p for a constant p */
+static inline DUAL
+dual_pow_c(const DUAL a, const dbl p)
+{
+  return dual_chain(a, pow(a.v, p), (p != 0.) ? p * pow(a.v, p - 1.) : 0.);
+}
+
+/* a^p; the derivatives through p need a > 0 */
+static inline DUAL
+dual_pow(const DUAL a, const DUAL p)
+{
+  DUAL r = dual_pow_c(a, p.v);
+  int k;
+  if (a.v > 0.) {
+    dbl rlog = r.v * log(a.v);
+    for (k = 0; k < DUAL_MAX_SLOTS; k++) r.d[k] += rlog * p.d[k];
+  }
+  return r;
+}
+
+#endif /* _MM_DUAL_H */
@@ -0,0 +1,57 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * mm_elem_cost.h -- prototype declarations for mm_elem_cost.c
+ *
+ * Measured assembly cost of each element, and the load imbalance of the
+ * assembly between processors.
+ */
+
+#ifndef _MM_ELEM_COST_H
+#define _MM_ELEM_COST_H
+
+#ifdef EXTERN
+#undef EXTERN
+#endif
+
+#ifdef _MM_ELEM_COST_C
+#define EXTERN /* do nothing */
+#endif
+
+#ifndef _MM_ELEM_COST_C
+#define EXTERN extern
+#endif
+
+EXTERN char Elem_Cost_File[MAX_FNL]; /* "Element Cost File", empty if none */
+EXTERN dbl *Elem_Cost;		/* [num_elems] seconds spent in matrix_fill(),
+				 * NULL unless costs are being measured */
+
+EXTERN dbl elem_cost_clock
+PROTO((void));
+
+EXTERN void elem_cost_fill_begin
+PROTO((Exo_DB *));		/* exo - ptr to EXODUS II finite element db  */
+
+EXTERN void elem_cost_fill_end
+PROTO((void));
+
+EXTERN void elem_cost_report
+PROTO((Exo_DB *,		/* exo - ptr to EXODUS II finite element db  */
+       Dpi *));			/* dpi - ptr to distributed processing info  */
+
+EXTERN int elem_cost_read
+PROTO((char *,			/* filename - as written by elem_cost_report */
+       int ,			/* num_elems - of the monolith */
+       dbl *));			/* cost - [num_elems] out, -1 if not listed */
+
+#endif /* _MM_ELEM_COST_H */
@@ -127,10 +127,33 @@ PROTO((double pf_constraint,
        double d_pf_lm[][MDE],
        double d_lm_pf[][MDE]));
 
+EXTERN void precond_fill_set	/* mm_fill.c                                 */
+PROTO((const int ));		/* on - assemble the Preconditioner Matrix   */
+
+EXTERN int mesh_stiffness_lagged /* TRUE: assemble_mesh() skips its Jacobian */
+PROTO((void));
+
+EXTERN void mesh_segregation_set /* mm_fill.c                                */
+PROTO((const int ));		/* phase - MESH_SEG_OFF, _FLOW or _MESH      */
+
+EXTERN void fill_element_subset	/* mm_fill.c                                 */
+PROTO((const int *));		/* mask - elements to fill, NULL for all     */
+
+EXTERN void fill_frozen_rows	/* mm_fill.c                                 */
+PROTO((const int *));		/* mask - rows held fixed, NULL for none     */
+
 
        
+/*
+ * With an msr matrix, matrix_fill_full() checks the whole assembled
+ * system at once and only checks each element (to report where a
+ * non-finite entry came from) when that fails.
+ */
+extern int Finite_Check_Elements;	/* mm_fill.c */
+
 #if  defined (CHECK_FINITE)  || defined (DEBUG_NAN) || defined (DEBUG_INF)
-#define CHECKFINITE(MESSAGE)	checkfinite(__FILE__, __LINE__, MESSAGE)
+#define CHECKFINITE(MESSAGE)	\
+	(Finite_Check_Elements ? checkfinite(__FILE__, __LINE__, MESSAGE) : 0)
 #else
 #define CHECKFINITE(MESSAGE)	0
 #endif
@@ -58,6 +58,13 @@ PROTO((dbl [DIM],		/* h                                         */
        dbl [DIM][MDE],		/* dh_dxnode                                 */
        const int DeformingMesh));
 
+EXTERN void h_elem_cache_init
+PROTO((const Exo_DB *));	/* exo - ptr to EXODUS II FE database        */
+
+EXTERN void h_elem_cache_invalidate
+PROTO((const Exo_DB *,		/* exo - ptr to EXODUS II FE database        */
+       const int []));		/* moved - nodes moved, NULL for all         */
+
 EXTERN void get_supg_stuff
 PROTO((dbl *,                    /* supg_term                                 */
        dbl [DIM],               /* elemental centroid velocity               */
@@ -55,6 +55,29 @@ PROTO((struct Aztec_Linear_Solver_System *, /* ams - cf "sl_util_structs.h"  */
        Dpi *,  			/* dpi - distributed processing info         */
        Comm_Ex * ));            /* cx - comm structure                       */
 
+EXTERN int integrate_explicit_lumped
+PROTO((struct Aztec_Linear_Solver_System *, /* ams - cf "sl_util_structs.h"  */
+       double [],		/* rf - residual for fill equation only      */
+       double [],		/* xf - vector with fill at nodes only       */
+       double [],		/* xf_old - vector with fill at nodes only   */
+       double [],		/* xfdot - vector with fill at nodes only    */
+       double [],		/* x - Solution vector for                   */
+       double [],		/* x_old - Solution vector at last timestep  */
+       double [],		/* xdot - time derivative of soln vector     */
+       dbl ,			/* delta_t - time step size                  */
+       int [],			/* node_to_fill                              */
+       Exo_DB *,		/* exo - ptr to exodus file                  */
+       Dpi *,  			/* dpi - distributed processing info         */
+       Comm_Ex * ));            /* cx - comm structure                       */
+
+EXTERN double explicit_fill_time_step
+PROTO((double [],		/* x                                         */
+       double [],		/* x_old                                     */
+       double [],		/* xdot                                      */
+       double [],		/* xdot_old                                  */
+       double [],		/* resid_vector                              */
+       Exo_DB *));		/* exo                                       */
+
 
 #ifndef COUPLED_FILL
 EXTERN int assemble_fill
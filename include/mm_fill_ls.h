@@ -161,6 +161,14 @@ PROTO(( const Exo_DB *,       /* exo */
 	double [],            /* x[] (solution vector) */
 	int ));               /* num_total_unknowns */
 
+EXTERN void ls_project_curvature
+PROTO(( Exo_DB *,             /* exo */
+	Dpi *,                /* dpi */
+	double [] ));         /* x[] (solution vector) */
+
+EXTERN void ls_projected_fv
+PROTO(( void ));
+
 EXTERN void find_facets
 PROTO((  struct LS_Surf_List *,
 	 int,
@@ -284,6 +292,13 @@ struct Extended_Shape_Fcn_Basics {
    double grad_F_plus[DIM];
    double *active_vol;
    double *tot_vol;
+   int num_rows;		/* rows of active_vol, tot_vol added to */
+   int *rows;			/*  in this fill, and their bits in */
+   int *row_bits;		/*  a bitset over the unknowns */
+   int *elem_cross;		/* element spans the interface */
+   int *node_cross;		/* elements spanning it around each node */
+   int num_xnodes;		/* nodes with extended interpolations, */
+   int *xnodes;			/*  -1 until xfem_predict/correct list them */
 };
 
 EXTERN struct Extended_Shape_Fcn_Basics * xfem;       /* This is a global structure for the basic pieces needed for XFEM */
@@ -484,6 +499,15 @@ PROTO (( SGRID *, struct LS_Surf_List * ));
 NTREE *create_shape_fcn_tree
 PROTO(( int ));
 
+EXTERN NTREE *shape_fcn_tree_for_elem
+PROTO(( int ));
+
+EXTERN void free_shape_fcn_tree_cache
+PROTO(( void ));
+
+EXTERN void free_subelement_cache
+PROTO(( void ));
+
 int build_integration_grid
 PROTO(( SGRID *,
 	int,
@@ -697,8 +721,14 @@ PROTO(( double,            /* isoval */
 	double (**)[DIM],  /* (**s)[DIM] */
 	double ** ));      /* **wt  */
 
+EXTERN void update_xfem_elem_state
+PROTO(( double [],		/* x */
+	const Exo_DB * ));
+
 EXTERN void clear_xfem_contribution
-PROTO(( int ));
+PROTO(( int ,			/* N - unknowns */
+	double [],		/* x - the fill's solution vector */
+	const Exo_DB * ));
 
 
 EXTERN void compute_xfem_contribution
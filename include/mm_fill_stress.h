@@ -176,6 +176,9 @@ PROTO((Exo_DB *,		/* exo                                       */
 EXTERN int segregate_stress_update /* mm_fill_stress.c                       */
 PROTO(( double [] ));		/* x_update                                  */
 
+EXTERN int condense_stress_lec	/* mm_fill_stress.c                          */
+PROTO(( void ));
+
 EXTERN int stress_eqn_pointer
 PROTO((int [MAX_MODES][DIM][DIM])); /* v_s */
 
@@ -185,6 +188,17 @@ PROTO((dbl [DIM][DIM],		/* s - total stress */
        dbl [MAX_MODES][DIM][DIM][MDE], /* d_mun_dS - derivative of mun wrt S*/ 
        dbl [DIM][DIM][MDE]));	/* d_mun_dG - derivative of mun wrt G */
 
+void
+sym_eigen_jacobi(const int,		// n - size of the tensor, <= DIM
+		 double [DIM][DIM],	// s - symmetric tensor (upper triangle)
+		 double [DIM],		// eig - eigenvalues, ascending
+		 double [DIM][DIM]);	// R - eigenvectors in the columns
+
+void
+compute_sym_eigen(double [DIM][DIM],	// s - symmetric tensor (upper triangle)
+		  double [DIM],		// eig - eigenvalues, ascending
+		  double [DIM][DIM]);	// R - eigenvectors in the columns
+
 void
 compute_exp_s(double [DIM][DIM],
 	      double [DIM][DIM],
@@ -0,0 +1,78 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * mm_fill_thread.h -- prototype declarations for mm_fill_thread.c
+ *
+ * Threaded element assembly.  Elements are colored so that no two
+ * elements of the same color share a node, and hence never scatter into
+ * the same rows of the global matrix or residual.  The elements of one
+ * color are then handed out to the OpenMP threads, each of which owns a
+ * private copy of the per-element scratch structures (ei, fv, bf, lec, ...;
+ * see the threadprivate lists in mm_as.h and mm_mp.h).
+ */
+
+#ifndef _MM_FILL_THREAD_H
+#define _MM_FILL_THREAD_H
+
+#ifdef EXTERN
+#undef EXTERN
+#endif
+
+#ifdef _MM_FILL_THREAD_C
+#define EXTERN /* do nothing */
+#endif
+
+#ifndef _MM_FILL_THREAD_C
+#define EXTERN extern
+#endif
+
+EXTERN int Num_Elem_Colors;	/* number of element colors on this proc */
+EXTERN int *Elem_Color_Ptr;	/* [Num_Elem_Colors+1] pointers into list */
+EXTERN int *Elem_Color_List;	/* elements sorted by color */
+
+EXTERN int elem_color_setup
+PROTO((Exo_DB *));		/* exo - ptr to EXODUS II finite element db  */
+
+EXTERN void elem_color_free
+PROTO((void));
+
+EXTERN void assembly_threads_setup
+PROTO((const int ));		/* mpi_threads_ok - MPI_THREAD_FUNNELED given */
+
+EXTERN int assembly_threads_active
+PROTO((Exo_DB *));		/* exo - ptr to EXODUS II finite element db  */
+
+EXTERN void assembly_threads_refresh
+PROTO((void));
+
+EXTERN int matrix_fill_threaded
+PROTO((struct Aztec_Linear_Solver_System *,
+       double [],   /* x - Solution vector                       */
+       double [],   /* resid_vector - Residual vector            */
+       double [],   /* x_old -  previous last time step          */
+       double [],   /* x_older - previous prev time step         */
+       double [],   /* xdot - xdot of current solution           */
+       double [],   /* xdot_old - xdot_old of current soln       */
+       double [],   /* x_update - last update vector             */
+       double *,    /* delta_t - current time step size          */
+       double *,    /* theta- parameter to vary time integration */
+       struct elem_side_bc_struct *[],
+       double *,    /* time_value  */
+       Exo_DB *,    /* exo - ptr to EXODUS II finite element db  */
+       Dpi *,       /* dpi - ptr to distributed processing info  */
+       int *,	    /* num_total_nodes - Number of nodes that proc owns */
+       dbl *,       /* h_elem_avg - global average element size  for PSPG */
+       dbl *,       /* U_norm - global average velocity for PSPG */
+       dbl *));     /* estifm - element stiffness Matrix for frontal solver */
+
+#endif /* _MM_FILL_THREAD_H */
@@ -29,9 +29,22 @@
 
 #include "mm_as_structs.h"
 
+/*
+ * Largest block condense_lec_block() takes, the components of one stress
+ * mode at every local dof.
+ */
+#define CONDENSE_MAX_DOF (DIM*(DIM+1)/2*MDE)
+
 EXTERN int beer_belly
 PROTO((void));
 
+EXTERN void geom_cache_init
+PROTO((Exo_DB *));		/* exo - ptr to EXODUS II finite element db  */
+
+EXTERN void geom_cache_invalidate
+PROTO((const Exo_DB *,		/* exo - ptr to EXODUS II finite element db  */
+       const int []));		/* moved - nodes moved, NULL for all         */
+
 EXTERN void calc_surf_tangent
 PROTO((const int ,		/* ielem - current element number            */
        const int ,		/* iconnect_ptr - Ptr into the beginning of the
@@ -164,6 +177,21 @@ PROTO((double *, /* local_J */
        int ,			/* var_type - Variable type to be zeroed */
        int ));			/* ldof - Local dof of that variable */
 
+EXTERN void condense_record_init /* mm_fill_util.c                            */
+PROTO((Exo_DB *));		/* exo - ptr to EXODUS II finite element db  */
+
+EXTERN int condense_lec_begin	/* mm_fill_util.c                            */
+PROTO((void));
+
+EXTERN int condense_lec_block	/* mm_fill_util.c                            */
+PROTO((const int ,		/* n - number of dofs in the block           */
+       const int [],		/* peqn - row of each dof                    */
+       const int [],		/* pvar - column of each dof                 */
+       const int []));		/* ldof - local dof number of each           */
+
+EXTERN int condense_interior_lec /* mm_fill_util.c                           */
+PROTO((void));
+
 EXTERN int find_VBR_index
 PROTO((const int ,	/* Block row index */
        const int ,     /* Block column index */
@@ -225,6 +253,16 @@ extern void set_solid_inertia(void);
 
 extern int fill_variable_vector(int inode, int ivec_varType[], int ivec_matID[]);
 
+EXTERN int *problem_graph_build	/* MSR bindx layout, from alloc_int_1()      */
+PROTO((Exo_DB *,		/* exo - ptr to FE EXODUS II database        */
+       const int ,		/* num_nodes - row nodes, [0,num_nodes)      */
+       const int ,		/* skip_diag - leave out the diagonal        */
+       int *));			/* len - (out) length of what is returned    */
+
+EXTERN int prune_zero_couplings	/* TRUE when the matrix was pruned           */
+PROTO((struct Aztec_Linear_Solver_System *, /* ams - the MSR Jacobian       */
+       Dpi *));			/* dpi - distributed processing info         */
+
 EXTERN void get_supg_tau(struct SUPG_terms *supg_terms,
                          int dim,
                          dbl diffusivity,
@@ -45,6 +45,10 @@ PROTO((const Exo_DB *,		/* exo - ptr to basic exodus ii mesh info    */
        const int ));            /* print flag                                */
 
 
+EXTERN void integrals_local	/* mm_flux.c                                 */
+PROTO((const int ,		/* local - TRUE to leave the sums unreduced  */
+       const int * ));		/* skip - elements to leave out, may be NULL */
+
 EXTERN double evaluate_global_flux
 PROTO((const Exo_DB *,
        const Dpi *,
@@ -96,6 +100,15 @@ PROTO((const Exo_DB *,
        const double,  
        const int ));
 
+EXTERN void evaluate_volume_integrals
+PROTO((const Exo_DB *,		/* exo - ptr to basic exodus ii mesh info    */
+       const Dpi *,		/* dpi - distributed processing info         */
+       const double [],		/* x - solution vector                       */
+       const double [],		/* xdot - dx/dt vector                       */
+       const double,		/* delta_t - time-step size                  */
+       const double,		/* time_value - current time                 */
+       const int ));		/* print_flag - 1=print                      */
+
 EXTERN int compute_volume_integrand
 PROTO((const int,
        const int,
@@ -127,6 +140,9 @@ PROTO((double *,
        const int,
        const int ));
 
+EXTERN void free_adaptive_weight_cache	/* mm_flux.c */
+PROTO((void));
+
 EXTERN int solve_quadratic
 PROTO((const double,
        const double, 
@@ -298,6 +298,9 @@ extern FILE *fopen_aprepro	/* mm_input.c                                */
 PROTO((const char *,		/* filename                                  */
        const char *));		/* format                                    */
 
+extern FILE *fopen_table	/* mm_input.c                                */
+PROTO((const char *));		/* filename - text or binary table file      */
+
 extern struct Data_Table *setup_gd_table_BC /* mm_input.c                    */
 PROTO((FILE *,			/* ifp                                       */
        char *,			/* input                                     */
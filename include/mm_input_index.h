@@ -0,0 +1,48 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * mm_input_index.h -- index of the cards of an open input file
+ *
+ * The card searches (look_for(), look_for_optional(), ...) ask the index
+ * where the next card of a name is instead of reading their way to it,
+ * and seek there.  The file is read and split up once per termination
+ * character; the index is dropped when the file changes under it.
+ */
+
+#ifndef _MM_INPUT_INDEX_H
+#define _MM_INPUT_INDEX_H
+
+#ifdef EXTERN
+#undef EXTERN
+#endif
+
+#ifdef _MM_INPUT_INDEX_C
+#define EXTERN /* do nothing */
+#endif
+
+#ifndef _MM_INPUT_INDEX_C
+#define EXTERN extern
+#endif
+
+#include <stdio.h>
+
+EXTERN int input_index_find	/* 1 found, -1 not found, 0 no index         */
+PROTO((FILE *,			/* ifp - open input file                     */
+       const char *,		/* string - card name, as strip() leaves it  */
+       const char ,		/* ch_term - termination character           */
+       const int ));		/* from_start - else from the current spot   */
+
+EXTERN void input_index_free
+PROTO((FILE *));		/* ifp - NULL for all of them                */
+
+#endif /* _MM_INPUT_INDEX_H */
@@ -46,6 +46,11 @@ extern struct Viscoelastic_Nonmodal *vn, **vn_glob;
 
 extern struct  Viscoplastic_Constitutive *evpl, **evpl_glob;
 
+#ifdef _OPENMP
+/* Material pointers (and private property copies) for threaded assembly */
+#pragma omp threadprivate(mp, mp_glob, gn, elc, elc_rs, ve, vn, evpl)
+#endif
+
 
 extern struct Variable_Initialization	Var_init[MAX_VARIABLE_TYPES + 
 							 MAX_CONC];
@@ -21,6 +21,10 @@
 #define MAX_MODES  8     /* maximum number of viscoelastic modes allowed */
 #endif
 
+/* viscosity, density, conductivity, heat source, then a diffusivity per
+ * species: the properties that can be a Property Plugin */
+#define MAX_PLUGIN_SLOTS  (4 + MAX_CONC)
+
 
 extern int Num_Var_Init_Mat[MAX_NUMBER_MATLS];	/* number of variables to overwrite with 
                                            material-specific initialization */
@@ -337,6 +337,9 @@ struct Material_Properties
   dbl *u_diffusivity[MAX_CONC];
   dbl d_diffusivity[MAX_CONC][MAX_VARIABLE_TYPES + MAX_CONC];
 
+  int Plugin[MAX_PLUGIN_SLOTS];	/* Property Plugin of each USER model that
+				 * has one, -1 if none; see mm_plugin.h */
+
   dbl diffusivity_gen_fick[MAX_CONC][MAX_CONC]; /* generalized fickian diffusion ACS 4/00 */
   dbl loadfv[MAX_CONC][15];
   dbl d_diffusivity_gf[MAX_CONC][MAX_CONC][MAX_VARIABLE_TYPES + MAX_CONC];
@@ -533,6 +536,7 @@ struct Material_Properties
   dbl d_saturation[MAX_VARIABLE_TYPES + MAX_CONC + MAX_PMV];
   dbl d_d_saturation[MAX_VARIABLE_TYPES+MAX_CONC][MAX_VARIABLE_TYPES+MAX_CONC];
   int saturation_tableid;
+  dbl saturation_table_tol;	/* VAN_GENUCHTEN table error, 0 = exact curve */
   int SAT_external_field_index;
 
     /*
@@ -1002,6 +1006,15 @@ struct Generalized_Newtonian
   int thixoModel;
   int len_u_thixo;
   dbl *u_thixo_factor;
+  //! Shear rate model routine picked from ConstitutiveEquation
+  /*!
+   *  Set by setup_pd() on every processor, so viscosity() calls
+   *  the model straight away at each Gauss point; NULL for the models
+   *  viscosity() sorts out itself.
+   */
+  dbl (*shear_viscosity)(struct Generalized_Newtonian *,
+			 dbl [DIM][DIM],
+			 struct viscosity_dependence *);
 };
 typedef struct Generalized_Newtonian GEN_NEWT_STRUCT;
 
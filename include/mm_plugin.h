@@ -0,0 +1,63 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+#ifndef _MM_PLUGIN_H
+#define _MM_PLUGIN_H
+
+#include "goma_plugin.h"
+
+#ifdef EXTERN
+#undef EXTERN
+#endif
+
+#ifdef _MM_PLUGIN_C
+#define EXTERN /* do nothing */
+#endif
+
+#ifndef _MM_PLUGIN_C
+#define EXTERN extern
+#endif
+
+#define MAX_PLUGINS		16
+#define MAX_PLUGIN_QP		64 /* larger elements get no batch */
+
+/*
+ * The libraries and functions of the Property Plugin cards, the same
+ * pair once however many materials use it. Each processor opens the
+ * library itself, the first time the function is called.
+ */
+EXTERN int Num_Plugins;
+EXTERN char Plugin_Library[MAX_PLUGINS][MAX_FNL];
+EXTERN char Plugin_Function[MAX_PLUGINS][MAX_FNL];
+
+EXTERN int plugin_register	/* index of the library and function */
+PROTO((const char *,		/* library */
+       const char *));		/* function */
+
+EXTERN int plugin_property_id	/* GOMA_PLUGIN_..., -1 if not a plugin one */
+PROTO((const char *));		/* name - VISCOSITY, DENSITY, ... */
+
+EXTERN void plugin_element_begin
+PROTO((const int ,		/* ip_total - of the Gauss rule, 0 for none */
+       const int ,		/* ielem_type */
+       struct Basis_Functions **, /* bfd */
+       const dbl ));		/* time */
+
+EXTERN void plugin_element_end
+PROTO((void));
+
+EXTERN int plugin_property	/* mm_plugin.c */
+PROTO((const int ,		/* property - GOMA_PLUGIN_... */
+       const int ,		/* species - of a diffusivity, else -1 */
+       const dbl ));		/* time */
+
+#endif /* _MM_PLUGIN_H */
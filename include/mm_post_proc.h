@@ -55,6 +55,33 @@ PROTO((double [],               /* x                                         */
        RESULTS_DESCRIPTION_STRUCT *,  /* exodus description of variables   */
        char [] ));  /* exodus filename   */
 
+EXTERN void fused_post_proc_begin /* mm_post_proc.c                          */
+PROTO((RESULTS_DESCRIPTION_STRUCT *, /* rd                                   */
+       Dpi *));                 /* dpi                                       */
+
+EXTERN int fused_post_proc_active /* mm_post_proc.c                          */
+PROTO((void));
+
+EXTERN void fused_post_proc_skip /* mm_post_proc.c                           */
+PROTO((void));
+
+EXTERN int fused_post_proc_ip   /* mm_post_proc.c                            */
+PROTO((double ,                 /* delta_t                                   */
+       double ,                 /* theta                                     */
+       int ,                    /* ielem                                     */
+       const int ,              /* ielem_type                                */
+       int ,                    /* ip                                        */
+       int ,                    /* ip_total                                  */
+       double ,                 /* time                                      */
+       Exo_DB *,                /* exo                                       */
+       double [DIM]));          /* xi                                        */
+
+EXTERN void fused_post_proc_end /* mm_post_proc.c                            */
+PROTO((const int ,              /* keep                                      */
+       double [],               /* x                                         */
+       const double ,           /* time                                      */
+       const double ));         /* delta_t                                   */
+
 EXTERN void post_process_elem   /* mm_post_proc.c                            */
 PROTO((double [],               /* x - soln vector                           */
        double [],               /* x_old - soln vector at previous time step */
@@ -133,6 +160,9 @@ PROTO((const dbl ,		/* x_coordinate */
        const int,      /*Starting element for contiguous search */
        const int));    /*ending element for contiguous search */
 
+extern void find_id_elem_invalidate /* mm_post_proc_util.c */
+PROTO((void));
+
 extern int invert_isoparametric_map   /*mm_post_proc_util.c */
 PROTO (( int *,              /* Current element id */
         const dbl [],              /* x_coordinate */
@@ -20,21 +20,28 @@
 /*
  * QP_Storage:
  *
- *    This structure is a linked list, containing a persistent storage
- *  location that a boundary condition or set of boundary conditions
- *  can employ throughout the element assembly process. The storage
- *  is wiped out at the end of a residual or Jacobian fill operation.
+ *    This structure holds a persistent storage location that a boundary
+ *  condition or set of boundary conditions can employ throughout the
+ *  element assembly process.
  *
  *  The storage is associated with a guass point on an element
  *  side.  The storage is identified primary via an integer number,
  *  StorageType, usually associated with the boundary condition integer
  *  id. The storage consists of a pointer to void, which the boundary
- *  condition can use to store the pointer to its own malloced data.  
- *  Note that it must supply a routine in the function
- *  qp_storage_list_destroy() to destroy that data at the end of a
- *  fill operation.
+ *  condition can use to store the pointer to its own malloced data.
+ *
+ *  Each element side that needs storage gets one contiguous block of
+ *  these, QP_STORAGE_NUM_TYPES per quadrature point, the first time it
+ *  asks for one. The blocks and what the boundary conditions hang on
+ *  them are kept for the whole run; global_qp_storage_reset() marks
+ *  them as holding nothing useful at the end of a fill, and
+ *  global_qp_storage_destroy() frees them. A storage type must have a
+ *  slot in qp_storage_slot() and a reset and a destroy case in
+ *  mm_qp_storage.c.
  */
 
+#define QP_STORAGE_NUM_TYPES 3	/* storage types with a slot */
+
 struct QP_Storage {
 /*
  * The following are unused fields, that will be added in later
@@ -49,7 +56,6 @@ struct QP_Storage {
     int    LocalQPNum;
     int    StorageType;
     void  *Storage;
-    struct QP_Storage *next;
 };
 typedef struct QP_Storage QP_STORAGE_STRUCT;
 
@@ -57,11 +63,9 @@ typedef struct QP_Storage QP_STORAGE_STRUCT;
  * Prototypes for functions in mm_qp_storage.c
  */
 EXTERN void elem_qp_storage_free(ELEM_SIDE_BC_STRUCT *);
-extern void qp_storage_list_destroy(QP_STORAGE_STRUCT **);
 extern void **side_qp_storage_findalloc(const int, const int,
 					ELEM_SIDE_BC_STRUCT *);
-extern void **qp_storage_findalloc(const int, const int, 
-				   QP_STORAGE_STRUCT **);
+extern void global_qp_storage_reset(void);
 extern void global_qp_storage_destroy(void);
 
 #endif
@@ -122,6 +122,11 @@ extern int MMH_ip;
 /*don't ask about this skeleton. I need the local material-referenced element number deep in the bowels of the assembly routines, and passing exo struct down there is brutal. */
 extern int PRS_mat_ielem; 
 
+/* both are set per element and per quadrature point by the assembly threads */
+#ifdef _OPENMP
+#pragma omp threadprivate(MMH_ip, PRS_mat_ielem)
+#endif
+
 #define QTENSOR_SMALL_DBL 1.0e-14
 
 #define MAGIC_VECTOR_0 1.0
@@ -0,0 +1,48 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * mm_sol_accel.h -- prototype declarations for mm_sol_accel.c
+ *
+ * Quasi-Newton acceleration of modified Newton steps: a Good Broyden
+ * update, or Anderson mixing, applied on top of the factored Jacobian
+ * that is being reused.
+ */
+
+#ifndef _MM_SOL_ACCEL_H
+#define _MM_SOL_ACCEL_H
+
+#ifdef EXTERN
+#undef EXTERN
+#endif
+
+#ifdef _MM_SOL_ACCEL_C
+#define EXTERN /* do nothing */
+#endif
+
+#ifndef _MM_SOL_ACCEL_C
+#define EXTERN extern
+#endif
+
+EXTERN void newton_accel_begin
+PROTO((const int ));		/* nloc - owned unknowns on this processor   */
+
+EXTERN void newton_accel_step
+PROTO((double [],		/* x - current solution, before the update   */
+       double [],		/* delta_x - J0^-1 R in, accelerated out     */
+       const int ,		/* nloc - owned unknowns on this processor   */
+       const int ));		/* reused - TRUE if J0 was not reformed      */
+
+EXTERN void newton_accel_end
+PROTO((void));
+
+#endif /* _MM_SOL_ACCEL_H */
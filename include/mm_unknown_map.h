@@ -54,6 +54,8 @@ extern int Index_Solution(
 				 * the material id                           */
     );
 
+extern void index_solution_tables(void);
+
 extern int variable_type_nodalInterp(int);
 
 extern VARIABLE_DESCRIPTION_STRUCT *
@@ -61,4 +63,31 @@ Index_Solution_Inv(const int, int *, int *, int *, int *);
 
 extern void dofname40(const int, char *);
 
+extern int var_type_dof_sets
+PROTO((const int,		/* num_rows - local unknowns to classify     */
+       int **,			/* set_var - (out) var type of each set      */
+       int **,			/* set_ptr - (out) start of each set in list */
+       int **));		/* set_list - (out) unknowns, set by set     */
+
+extern int node_dof_blocks
+PROTO((const int,		/* num_rows - local unknowns to classify     */
+       int **));		/* block_of_row - (out) node block of each   */
+
+extern int near_null_space
+PROTO((const int,		/* num_rows - local unknowns                 */
+       double **));		/* vectors - (out) num_rows each, in a row   */
+
+extern int periodic_links_setup
+PROTO((Exo_DB *,		/* exo - ptr to FE EXODUS II database        */
+       Dpi *));			/* dpi - ptr to parallel info                */
+
+extern int periodic_graph_links
+PROTO((const int,		/* inode - node of the graph row             */
+       const int **));		/* links - (out) its extra neighbor nodes    */
+
+extern void periodic_fold
+PROTO((struct Aztec_Linear_Solver_System *, /* ams - the assembled system */
+       const double [],		/* x - current solution                      */
+       double []));		/* resid_vector - the assembled residual     */
+
 #endif /* __MM_UNKNOWN_MAP_H */
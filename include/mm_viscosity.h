@@ -31,6 +31,26 @@ PROTO((GEN_NEWT_STRUCT *,               /* gn_local                          */
        dbl [DIM][DIM],	        	/* gamma_dot - strain rate tensor    */
        VISCOSITY_DEPENDENCE_STRUCT *)); /* d_mu - viscosity dependence       */
 
+EXTERN void viscosity_qp_cache	/* mm_viscosity.c                            */
+PROTO((const int));			/* on - TRUE at a freshly loaded Gauss pt */
+
+EXTERN void set_shear_viscosity	/* mm_viscosity.c                            */
+PROTO((GEN_NEWT_STRUCT *));             /* gn_local                          */
+
+EXTERN void power_law_viscosity_batch	/* mm_viscosity.c                    */
+PROTO((const GEN_NEWT_STRUCT *,         /* gn_local                          */
+       const int,			/* n - number of points              */
+       const dbl [],			/* gd - strain rate invariant [n]    */
+       dbl [],				/* mu - viscosity [n]                */
+       dbl []));			/* dmu_dgd - d(mu)/d(gd) [n]         */
+
+EXTERN void carreau_viscosity_batch	/* mm_viscosity.c                    */
+PROTO((const GEN_NEWT_STRUCT *,         /* gn_local                          */
+       const int,			/* n - number of points              */
+       const dbl [],			/* gd - strain rate invariant [n]    */
+       dbl [],				/* mu - viscosity [n]                */
+       dbl []));			/* dmu_dgd - d(mu)/d(gd) [n]         */
+
 EXTERN double power_law_viscosity	/* mm_viscosity.c                    */
 PROTO((GEN_NEWT_STRUCT *,               /* gn_local                          */
        dbl [DIM][DIM],	        	/* gamma_dot - strain rate tensor    */
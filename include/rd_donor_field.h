@@ -0,0 +1,41 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * rd_donor_field.h -- external fields interpolated from a non-matching mesh
+ */
+
+#ifndef _RD_DONOR_FIELD_H
+#define _RD_DONOR_FIELD_H
+
+#ifdef EXTERN
+#undef EXTERN
+#endif
+
+#ifdef _RD_DONOR_FIELD_C
+#define EXTERN /* do nothing */
+#endif
+
+#ifndef _RD_DONOR_FIELD_C
+#define EXTERN extern
+#endif
+
+EXTERN int rd_donor_nodal_field	/* nodes outside the donor, -1 on error      */
+PROTO((const int ,		/* exoid - open EXODUS II file               */
+       const int ,		/* time_step - 1 based                       */
+       const int ,		/* var_index - nodal variable, 1 based       */
+       const Exo_DB *,		/* exo - the problem mesh                    */
+       dbl *));			/* val - [exo->num_nodes] (out)              */
+
+extern int Ext_Field_Donor_Mesh; /* interpolate even when node counts match */
+
+#endif /* _RD_DONOR_FIELD_H */
@@ -55,6 +55,12 @@ PROTO((const int ,		/* val    - integer whose category we seek   */
 EXTERN void init_exo_struct	/* rd_exo.c */
 PROTO((Exo_DB *));		/* ptr to FE database described exo_struct.h */
 
+EXTERN void free_exo_distfacts	/* rd_exo.c -- free ns and ss dist factors */
+PROTO((Exo_DB *));		/* x - ptr to EXODUS II database struct */
+
+EXTERN void rd_exo_distfacts	/* rd_exo.c -- read them back from x->path */
+PROTO((Exo_DB *));		/* x - ptr to EXODUS II database struct */
+
 EXTERN void free_exo_ev		/* rd_exo.c -- free up big elem var results */
 PROTO((Exo_DB *));		/* ptr to FE database described exo_struct.h */
 
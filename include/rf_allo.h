@@ -42,6 +42,12 @@
 #define INT_NOINIT          -68361
 #define DBL_NOINIT          -34.39383E11
 
+/*
+ * Fewest values per thread for which alloc_dbl_1_ft() and alloc_int_1_ft()
+ * touch in parallel; below it a page or two is not worth the fork.
+ */
+#define FIRST_TOUCH_MIN     4096
+
 /*
  * Wrapper helps identify where allocations take place and for how much.
  * Someday need to wrap varargs array_alloc() too.
@@ -55,6 +61,10 @@
 #define alloc_short_1(arg1,arg2) \
                              alloc_short_1_FL((arg1), (arg2), __FILE__, __LINE__)
 #define alloc_dbl_1(arg1,arg2) alloc_dbl_1_FL((arg1), (arg2), __FILE__, __LINE__)
+#define alloc_int_1_ft(arg1,arg2) \
+                           alloc_int_1_ft_FL((arg1), (arg2), __FILE__, __LINE__)
+#define alloc_dbl_1_ft(arg1,arg2) \
+                           alloc_dbl_1_ft_FL((arg1), (arg2), __FILE__, __LINE__)
 #define alloc_void_struct_1(arg1,arg2) \
                        alloc_void_struct_1_FL((arg1), (arg2), __FILE__, __LINE__)
 #define  alloc_struct_1(x, num)  \
@@ -104,6 +114,9 @@ extern int    *alloc_int_1_FL(const int, const int, const char *, const int);
 extern short int  *alloc_short_1_FL(const int, const int,
 				    const char *, const int);
 extern double *alloc_dbl_1_FL(const int, const double, const char *, const int);
+extern int    *alloc_int_1_ft_FL(const int, const int, const char *, const int);
+extern double *alloc_dbl_1_ft_FL(const int, const double, const char *,
+				 const int);
 extern void *alloc_void_struct_1_FL(const size_t, const int, const char *,
 				    const int); 
 extern void zero_structure(void *, const size_t, const int);
@@ -126,5 +139,14 @@ extern void *realloc_void_struct_1_FL(void *, const size_t, const int, const int
 				       const int);
 extern void checkFinite(double tmp);
 
+/*
+ * Allocation tracking, see the Memory Report File card.
+ */
+extern char Memory_Report_File[];	/* empty if none */
+extern int Memory_Report_Top;		/* sites listed in each table */
+
+extern void alloc_track_begin(void);
+extern void alloc_report(const char *);
+
 
 #endif
@@ -1220,6 +1220,9 @@ struct Data_Table {
   int ngrid2;	/* for 3d tables, the number of grid points in directions 1&2 */
   double yscale;       /* Scaling value for the y axis */
   double Emin;         /* Minimum modulus value (for FAUX_PLASTICITY */
+  int   t_ascending;   /* TRUE if t[] is strictly increasing */
+  double t_spacing;    /* spacing of t[] if uniform, else 0 */
+  int   last_interval; /* interval found by the last table_interval() */
 };
 
 extern int num_BC_Tables;
@@ -1398,7 +1401,7 @@ struct elem_side_bc_struct {
     int                          Num_BC;
     int                          MatID_List[2];
     int                          Num_MatID;
-    struct QP_Storage          **Side_QP_Storage;
+    struct QP_Storage           *Side_QP_Storage;
     struct elem_side_bc_struct	*next_side_bc;
 };
 typedef struct elem_side_bc_struct ELEM_SIDE_BC_STRUCT;
@@ -1445,6 +1448,7 @@ extern int num_BC_nodes;
 extern int *BC_dup_nodes;
 extern int ***BC_dup_list;
 extern int BC_dup_ptr;
+extern int *BC_dup_index;	/* [node] position in BC_dup_nodes, -1 */
 extern int *ss_to_blks[MAX_MAT_PER_SS+1];
 extern int dup_blks_list[MAX_MAT_PER_SS+1];
 extern int *SS_Internal_Boundary;
@@ -1454,6 +1458,8 @@ extern int num_mesh_rotate;
 extern int *mom_rotate_node;
 extern int *mom_rotate_ss;
 extern int num_mom_rotate;
+extern int *mesh_rotate_index;	/* [node] position in mesh_rotate_node, -1 */
+extern int *mom_rotate_index;	/* [node] position in mom_rotate_node, -1 */
 extern int PRESSURE_DATUM; /* flag to determine if a pressure datum is set */
 extern int pressure_datum_element; /* element in which the pressure datum is set */
 extern double pressure_datum_value; /* value of the pressure datum */
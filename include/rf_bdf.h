@@ -0,0 +1,92 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * rf_bdf.h -- prototype declarations for rf_bdf.c
+ *
+ * Variable-order, variable-step BDF time integration: solution history,
+ * predictor, BDF coefficients and the order selection used by
+ * time_step_control().
+ */
+
+#ifndef _RF_BDF_H
+#define _RF_BDF_H
+
+#ifdef EXTERN
+#undef EXTERN
+#endif
+
+#ifdef _RF_BDF_C
+#define EXTERN /* do nothing */
+#endif
+
+#ifndef _RF_BDF_C
+#define EXTERN extern
+#endif
+
+EXTERN void bdf_init
+PROTO((const int ,		/* N - unknowns on this processor            */
+       const int ));		/* max_order - 1 to MAX_BDF_ORDER            */
+
+EXTERN void bdf_free
+PROTO((void));
+
+EXTERN int bdf_active
+PROTO((void));
+
+EXTERN void bdf_restart
+PROTO((const double ,		/* time - time of x[]                        */
+       const double []));	/* x - the only solution kept in the history */
+
+EXTERN double bdf_prepare	/* returns equivalent time step parameter    */
+PROTO((const double ));		/* delta_t - step about to be tried          */
+
+EXTERN int bdf_order
+PROTO((void));
+
+EXTERN int bdf_predict		/* returns FALSE if the history is too short */
+PROTO((const int ,		/* N - unknowns on this processor            */
+       double [],		/* x - predicted solution                    */
+       double []));		/* xdot - BDF derivative of the prediction   */
+
+EXTERN void bdf_error_orders
+PROTO((int *,			/* q_lo - lower order to estimate, or -1     */
+       int *));			/* q_hi - higher order to estimate, or -1    */
+
+EXTERN double bdf_extrapolate
+PROTO((const int ,		/* q - degree of the extrapolant             */
+       const int ));		/* i - unknown                               */
+
+EXTERN double bdf_prev_correction
+PROTO((const int ));		/* i - unknown                               */
+
+EXTERN double bdf_error_factor
+PROTO((const int ));		/* q - order                                 */
+
+EXTERN double bdf_select_order	/* returns the step for the next order       */
+PROTO((const double ,		/* delta_t - step just taken                 */
+       const double ,		/* delta_t_new - step proposed at this order */
+       const double ,		/* eps - time step error tolerance           */
+       const double ,		/* err_lo - error estimate at order - 1      */
+       const double ,		/* err - error estimate at this order        */
+       const double ,		/* err_hi - error estimate at order + 1      */
+       const int ));		/* const_delta_t - TRUE if dt is held fixed  */
+
+EXTERN void bdf_push
+PROTO((const double ,		/* time - time of the accepted solution      */
+       const double [],		/* x - accepted solution                     */
+       const double []));	/* x_pred - its prediction                   */
+
+EXTERN void bdf_step_failed
+PROTO((void));
+
+#endif /* _RF_BDF_H */
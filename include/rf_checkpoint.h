@@ -0,0 +1,68 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * rf_checkpoint.h -- prototype declarations for rf_checkpoint.c
+ *
+ * An in-memory ring of snapshots of the time-dependent state, taken after
+ * each accepted time step, for rolling the transient solve back.
+ */
+
+#ifndef _RF_CHECKPOINT_H
+#define _RF_CHECKPOINT_H
+
+#ifdef EXTERN
+#undef EXTERN
+#endif
+
+#ifdef _RF_CHECKPOINT_C
+#define EXTERN /* do nothing */
+#endif
+
+#ifndef _RF_CHECKPOINT_C
+#define EXTERN extern
+#endif
+
+EXTERN void ckpt_init
+PROTO((const int ));		/* depth - snapshots kept, 0 for none        */
+
+EXTERN void ckpt_register
+PROTO((void *,			/* p - memory that is part of the state      */
+       const size_t ));		/* nbytes - its size                         */
+
+EXTERN void ckpt_register_nodal
+PROTO((dbl *,			/* p - vector over the local unknowns        */
+       const size_t ));		/* nbytes - its size                         */
+
+EXTERN void ckpt_register_elem
+PROTO((const int ));		/* eb - element block index                  */
+
+EXTERN void ckpt_save
+PROTO((void));
+
+EXTERN int ckpt_restore		/* returns FALSE if there is no such one     */
+PROTO((const int ));		/* back - snapshots back from the newest     */
+
+EXTERN void ckpt_free
+PROTO((void));
+
+EXTERN int ckpt_write_file	/* 0, or -1 if it could not be written       */
+PROTO((const char *));		/* fname - checkpoint file                   */
+
+EXTERN int ckpt_read_file	/* 0, or -1 if it does not fit this problem  */
+PROTO((const char *));		/* fname - checkpoint file                   */
+
+extern char Checkpoint_File[];	/* Checkpoint File card, "" for none         */
+extern dbl Checkpoint_Interval;	/* wall seconds between checkpoint files     */
+extern char Checkpoint_Restart_File[]; /* Checkpoint Restart File card       */
+
+#endif /* _RF_CHECKPOINT_H */
@@ -14,18 +14,31 @@
 #define _RF_ELEMENT_STORAGE_STRUCT_H
 
 
+/*
+ * Element_Storage: the per element history of an element block, one
+ * per block.
+ *
+ *  Each field is one contiguous array over the elements of the block,
+ *  Num_Storage values per element: the volumetric quadrature points,
+ *  followed, with porous mass lumping, by the nodes of the element.
+ *  The value of element ielem (numbered within the block) at point ip is
+ *  field[ielem * Num_Storage + ip]; use ES_QP(). The fields are pieces of
+ *  the one allocation Data[Length]; the ones a block has no use for are
+ *  NULL.
+ */
 struct Element_Storage {
 
     /*
      * int Glob_elem_number; Such a beast is available in the dpi struct.
      *                       It would be logical to include it here.
-     *                       Note, the processor element number is 
-     *                       implicitly available via the index that
-     *                       is used to access this structure, so we don't
-     *                       need to duplicate that here.
      *                       However, we don't at the moment need this 
      *                       field, so I will leave it commented out.
      */
+  int Num_Storage;        /* values per element in each field */
+  int Num_Elems;          /* elements in the block */
+  int Length;             /* doubles in Data */
+  double *Data;           /* all the fields */
+
   double *Sat_QP_tn;      /*
 			   * Storage of the saturation at the quadrature
 			   * points. This is a vector of doubles.
@@ -57,6 +70,13 @@ struct Element_Storage {
 };
 typedef struct Element_Storage ELEMENT_STORAGE_STRUCT;
 
+/*
+ * The value of a field of the element storage of block eb_ptr for
+ * element ielem of the block at point ip; an lvalue.
+ */
+#define ES_QP(eb_ptr, field, ielem, ip) \
+  ((eb_ptr)->ElemStorage->field[(ielem) * (eb_ptr)->ElemStorage->Num_Storage + (ip)])
+
 
 #endif
 
@@ -81,6 +81,7 @@
 #define FULL_DG         2
 #define SEGREGATED      3
 #define LUMPED          4
+#define CONDENSED_DG    5
 
 /* Mesh Motion parameters */
 #define ARBITRARY	   1
@@ -1011,6 +1012,28 @@
 #define TIME_STEP_GROWTH_CAP (1.5)
 #endif
 
+/*
+ * Time Step Controller: how the next step size follows from the error
+ * estimates. The elementary one looks at the last step only; the PI
+ * (Gustafsson) and H211b (Soderlind) ones also at the one before it.
+ */
+#define TS_CONTROL_ELEMENTARY	0
+#define TS_CONTROL_PI		1
+#define TS_CONTROL_H211B	2
+
+/*
+ * Highest order of the variable-order BDF integrator (BDF Maximum Order).
+ */
+
+#define MAX_BDF_ORDER 5
+
+/*
+ * Multirate Subcycles: most element block ids the fast set may list.
+ * A block id of MULTIRATE_SHELL stands for all the shell blocks.
+ */
+#define MAX_MULTIRATE_BLOCKS	16
+#define MULTIRATE_SHELL		(-1)
+
 
 /*
  * This moves here from el_elm.h. The maximum number of degrees of freedom
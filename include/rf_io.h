@@ -65,6 +65,14 @@ extern char Soln_OutFile[MAX_FNL];
 
 extern int Brk_Flag;            /* Flag to check for built-in brking */
 
+extern int Brk_Num_Ranks;       /* ranks sharing the built-in brk */
+
+extern int Brk_Partitioner;     /* how the built-in brk cuts the graph */
+
+#define BRK_PART_CHACO   0	/* Chaco multilevel partition */
+#define BRK_PART_RCB     1	/* recursive coordinate bisection */
+#define BRK_PART_HILBERT 2	/* Hilbert curve through the nodes */
+
 extern int Debug_Flag;		/* Flag to specify debug info is to be     */
 				/* printed out. The value of this flag     */
 				/* determines the level of diagnostic info */
@@ -96,6 +104,53 @@ extern int Write_Initial_Solution;
 				/* Flag to indicate whether to write the
 			         * initial solution to the ascii and 
 				 * exodus output files */
+extern int Exo_Flush_Interval;	/* output steps between flushes of the
+				 * results file kept open across writes;
+				 * 0 = open/close it for every write */
+extern int Async_Output_Memory;	/* MB of results that may be queued for the
+				 * background output writer; 0 = write
+				 * synchronously */
+extern char Catalyst_Script[MAX_FNL];	/* in situ pipeline run at each
+					 * output step; "" = none */
+extern char Catalyst_Implementation[MAX_FNL];	/* Catalyst library to
+						 * load, "" = its default */
+extern char ROM_Basis_File[MAX_FNL];	/* POD basis written or read */
+extern char Mesh_Sequence_File[MAX_MESH_SEQUENCE][MAX_FNL]; /* coarse meshes
+							     * solved first */
+extern int Mesh_Sequence_Length;	/* how many, 0 = none */
+extern char Running_Statistics[MAX_CHAR_IN_INPUT];	/* nodal variables to
+							 * keep statistics of */
+extern int Output_Compression_Level;	/* deflate level 1-9 of a NetCDF-4
+					 * results file; 0 = classic */
+extern int Output_Compression_Shuffle;	/* byte shuffle before deflate */
+extern int Output_Significant_Digits;	/* decimal digits kept in results
+					 * values; 0 = all (lossless) */
+
+/*
+ * Output subsets: a nodal or element results variable written only over
+ * some element blocks, node sets or a box, and/or only every stride'th
+ * output step. Elsewhere (and in between) it is left unwritten, or zero
+ * where the variable is stored for a whole block anyway.
+ */
+#define MAX_OUTPUT_SUBSETS	32
+#define MAX_SUBSET_IDS		16
+
+#define OUTPUT_SUBSET_ALL	0	/* no region, stride only */
+#define OUTPUT_SUBSET_BLOCK	1	/* ids[] are element block ids */
+#define OUTPUT_SUBSET_NODESET	2	/* ids[] are node set ids */
+#define OUTPUT_SUBSET_BOX	3	/* box[] = xmin xmax ymin ymax zmin zmax */
+
+struct Output_Subset {
+  char	 var_name[MAX_VAR_NAME_LNGTH];	/* as written to the results file */
+  int	 stride;			/* write every stride'th step */
+  int	 region;			/* OUTPUT_SUBSET_* */
+  int	 num_ids;
+  int	 ids[MAX_SUBSET_IDS];
+  double box[6];
+};
+
+extern int Num_Output_Subsets;
+extern struct Output_Subset Output_Subsets[MAX_OUTPUT_SUBSETS];
 extern int Num_Var_Init ;	/* Number of variables to overwrite with
 				 * global initialization */
 extern int Num_Var_LS_Init;     /* number of variables to overwirte with
@@ -38,6 +38,8 @@
 #define	MAX_FNL		128	/* maximum filename len (EXODUS II, Chemkin)*/
 #endif
 
+#define MAX_MESH_SEQUENCE	8	/* coarse meshes of a Mesh Sequence */
+
 #ifndef NEXO
 #define	NEXO		 2	/* number EXODUS II databases available. */
 				/* Convention here: */
@@ -116,6 +118,8 @@
 #define NOECHO              20 /* Disable echoing of input/material files */
 #define TIME_START              21 /* Initial simulation time */
 #define TIME_END                22 /* Maximum simulation time */
+#define GUESS_EXOII_FILE        23 /* initial guess from the last solution in a file */
+#define NO_MESH_SEQUENCE        24 /* ignore the Mesh Sequence card */
 
 #define CONT_BEG_PVALUE        101 /* BEGIN VALUE */
 #define CONT_END_PVALUE        102 /* END VALUE */
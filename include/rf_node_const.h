@@ -24,6 +24,17 @@
 /*                       STRUCTURE DEFINITIONS                               */
 /*****************************************************************************/
 
+/*
+ * Dirichlet_Dof: one Dirichlet unknown at a node, by its offset in the
+ * node's unknowns and the index of its variable description in
+ * Nodal_Vars_Info->Var_Desc_List.
+ */
+struct Dirichlet_Dof
+{
+  short int offset;
+  short int lvdesc;
+};
+
 /*
  * BCCondMask: masks for specifying certain boundary condition flags on a node.
  *
@@ -200,6 +211,15 @@ struct Node_Info {
      *  Length = Number of unknowns at this node
      */
     short int *DBC;
+    /*
+     * DBC_Dofs[k]:
+     *      The unknowns at this node that DBC[] flags, in increasing
+     *  offset order, compiled by find_and_set_Dirichlet() so that
+     *  put_dirichlet_in_matrix() visits only them.
+     *  Length = Num_DBC_Dofs
+     */
+    int Num_DBC_Dofs;
+    struct Dirichlet_Dof *DBC_Dofs;
 };
 typedef struct Node_Info NODE_INFO_STRUCT;
 
@@ -229,6 +249,7 @@ extern int first_matID_at_node(const int);
 extern int index_umi_list(const UMI_LIST_STRUCT *, const int);
 extern int node_matrl_index(const int, const int);
 extern void free_umi_list(UMI_LIST_STRUCT *);
+extern void compact_node_mat_lists(const int);
 extern void node_info_tmp_free (void);
 extern NODAL_RESID_WKSP_STRUCT *nodal_resid_wksp_alloc (void);
 extern void nodal_resid_wksp_destroy(NODAL_RESID_WKSP_STRUCT **);
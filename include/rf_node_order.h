@@ -0,0 +1,41 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * rf_node_order.h -- prototype declarations for rf_node_order.c
+ *
+ * The order in which the nodes have their unknowns numbered (Node Reorder
+ * card).  The mesh itself, and so everything that is read or written in
+ * terms of node numbers, keeps the order of the EXODUS II file.
+ */
+
+#ifndef _RF_NODE_ORDER_H
+#define _RF_NODE_ORDER_H
+
+#ifdef EXTERN
+#undef EXTERN
+#endif
+
+#ifdef _RF_NODE_ORDER_C
+#define EXTERN /* do nothing */
+#endif
+
+#ifndef _RF_NODE_ORDER_C
+#define EXTERN extern
+#endif
+
+EXTERN int *node_unknown_order	/* returns [num nodes] or NULL if unchanged */
+PROTO((const char *,		/* method - "none", "rcm" or "morton"        */
+       Exo_DB *,		/* exo - ptr to EXODUS II finite element db  */
+       Dpi *));			/* dpi - distributed processing info         */
+
+#endif /* _RF_NODE_ORDER_H */
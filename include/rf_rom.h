@@ -0,0 +1,60 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * rf_rom.h -- POD-Galerkin reduced order models
+ *
+ * Reduced Order Model = collect keeps the solutions written as snapshots
+ * and writes their POD basis at the end of the run; = solve replaces the
+ * Newton iteration by a reduced one in that basis, with the fills limited
+ * to the elements around a sample of nodes.
+ */
+
+#ifndef _RF_ROM_H
+#define _RF_ROM_H
+
+#ifdef EXTERN
+#undef EXTERN
+#endif
+
+#ifdef _RF_ROM_C
+#define EXTERN /* do nothing */
+#endif
+
+#ifndef _RF_ROM_C
+#define EXTERN extern
+#endif
+
+EXTERN void rom_snapshot
+PROTO((double []));		/* x - solution being written                */
+
+EXTERN int rom_solve		/* Newton iterations, -1 if a fill failed    */
+PROTO((struct Aztec_Linear_Solver_System *,
+       double [],		/* x - solution, the initial guess (in/out)  */
+       double ,			/* delta_t - time step size                   */
+       double ,			/* theta - time integration parameter         */
+       double [],		/* x_old                                      */
+       double [],		/* x_older                                    */
+       double [],		/* xdot (in/out)                              */
+       double [],		/* xdot_old                                   */
+       double [],		/* resid_vector                               */
+       double [],		/* x_update                                   */
+       int *,			/* converged (out)                            */
+       double ,			/* time_value                                 */
+       Exo_DB *,		/* exo - ptr to EXODUS II finite element db   */
+       Dpi *,			/* dpi - distributed processing info          */
+       Comm_Ex *));		/* cx - communications structures             */
+
+EXTERN void rom_finish
+PROTO((void));
+
+#endif /* _RF_ROM_H */
@@ -0,0 +1,50 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * rf_setup_cache.h -- prototype declarations for rf_setup_cache.c
+ *
+ * Setup products kept on disk from one launch to the next (Setup Cache
+ * card), each processor in its own file.
+ */
+
+#ifndef _RF_SETUP_CACHE_H
+#define _RF_SETUP_CACHE_H
+
+#ifdef EXTERN
+#undef EXTERN
+#endif
+
+#ifdef _RF_SETUP_CACHE_C
+#define EXTERN /* do nothing */
+#endif
+
+#ifndef _RF_SETUP_CACHE_C
+#define EXTERN extern
+#endif
+
+EXTERN int *setup_cache_read_graph /* the cached graph, NULL if none fits */
+PROTO((Exo_DB *,		/* exo - ptr to FE db                        */
+       const int ,		/* num_nodes - rows of their unknowns        */
+       const int ,		/* skip_diag - as for problem_graph_build()  */
+       int * ));		/* len - of the graph returned               */
+
+EXTERN void setup_cache_write_graph
+PROTO((Exo_DB *,		/* exo - ptr to FE db                        */
+       const int ,		/* num_nodes - rows of their unknowns        */
+       const int ,		/* skip_diag - as for problem_graph_build()  */
+       const int *,		/* g - the graph                             */
+       const int ));		/* len - its length                          */
+
+extern char Setup_Cache[];	/* Setup Cache card, "" for none             */
+
+#endif /* _RF_SETUP_CACHE_H */
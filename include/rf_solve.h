@@ -50,6 +50,12 @@ PROTO((Exo_DB *,		/* exo - ptr to finite element mesh database */
        Dpi *,  			/* dpi - ptr to distributed processing info */
        dbl *));			/* te_out - return actual end time */
 
+EXTERN void solve_problem_keep_state
+PROTO((const int));		/* keep - TRUE between library solves */
+
+EXTERN double *solve_problem_solution /* kept solution, or NULL */
+PROTO((double **));		/* xdot - its time derivative (out) */
+
 EXTERN int anneal_mesh		/* rf_solve.c */
 PROTO(( double [],		/* x - solution vector */
 	int ,			/* tev - number elem results */
@@ -98,4 +104,7 @@ extern int create_periodic_acs(Exo_DB *);
  */
 extern void print_code_version(void);
 extern void echo_command_line( int, char *[], char *);
+extern int goma_setup(int, char **);	/* all before the solve */
+extern int goma_solve(void);		/* the solve of the input file */
+extern int goma_finish(void);		/* all after it */
 #endif /* _RF_SOLVE_H */
@@ -57,6 +57,61 @@
 #define AZTECOO         9
 #define STRATIMIKOS     10
 
+/*
+ * Newton forcing terms for the linear tolerance (Newton Forcing Term)
+ */
+
+#define NEWTON_FORCING_NONE	0	/* fixed Residual Ratio Tolerance */
+#define NEWTON_FORCING_EW1	1	/* Eisenstat-Walker choice 1 */
+#define NEWTON_FORCING_EW2	2	/* Eisenstat-Walker choice 2 */
+
+/*
+ * Jacobian reuse policies (Jacobian Reuse)
+ */
+
+#define JACOBIAN_REUSE_FIXED	0	/* strides and Modified Newton Tolerance */
+#define JACOBIAN_REUSE_ADAPTIVE	1	/* reform on observed contraction rate */
+#define JACOBIAN_REUSE_CONSTANT	2	/* linear problem: reform when dt changes */
+
+/*
+ * Acceleration of modified Newton steps (Newton Acceleration)
+ */
+
+#define NEWTON_ACCEL_NONE	0
+#define NEWTON_ACCEL_BROYDEN	1	/* Good Broyden on top of J0 */
+#define NEWTON_ACCEL_ANDERSON	2	/* Anderson mixing */
+#define MAX_NEWTON_ACCEL_DEPTH	10	/* most steps it may remember */
+
+/*
+ * Globalization of the Newton update (Newton Line Search)
+ */
+
+#define NEWTON_LINE_SEARCH_NONE		0	/* fixed damping factors only */
+#define NEWTON_LINE_SEARCH_ARMIJO	1	/* backtrack on ||R|| */
+
+/*
+ * Preconditioner Matrix: what the assembled matrix holds when
+ * Matrix-Free Newton applies the Jacobian itself.
+ */
+#define PRECOND_MATRIX_EXACT		0	/* the Jacobian */
+#define PRECOND_MATRIX_NO_MESH		1	/* without the d/dx of non-mesh equations */
+#define PRECOND_MATRIX_DECOUPLED	2	/* only each equation's own unknowns */
+
+/*
+ * Mesh Segregation: the unknowns a Newton step of the segregated ALE
+ * iteration solves for, the others being held fixed.
+ */
+#define MESH_SEG_OFF			0	/* all of them */
+#define MESH_SEG_FLOW			1	/* all but the mesh displacements */
+#define MESH_SEG_MESH			2	/* only the mesh displacements */
+
+/*
+ * Reduced Order Model
+ */
+#define ROM_NONE			0
+#define ROM_COLLECT			1	/* snapshots, then their POD basis */
+#define ROM_SOLVE			2	/* reduced Newton in that basis */
+
 /*
  * FORTRAN BLAS functions. Inside C, use "DCOPY" and the preprocessor to
  * make it look like the FORTRAN name for this routine.
@@ -68,7 +68,9 @@ PROTO(( double *,
         int ,                  /* number of variables in EXODUS II file */
         int ,                  /* ID of the open EXODUS II file */
         int ,                  /* 1-based */
-        int ));                /* this is zero or the species number */
+        int ,                  /* this is zero or the species number */
+        const Exo_DB * ));     /* problem mesh to interpolate onto, NULL if
+				* the file has the same mesh */
 
 int rd_exoII_ev(double *u,
                 int varType,
@@ -93,7 +95,8 @@ PROTO((const double ,		/* delta_t_old                               */
        const double [],         /* x_AC_pred                                 */
        const double ,		/* eps                                       */
        int *,			/* success_dt                                */
-       const int []));		/* use_var_norm                              */
+       const int [],		/* use_var_norm                              */
+       const int ));		/* num_newton - Newton steps of this step    */
 
 extern int dump_stability_matrices /* rf_util.c                              */
 PROTO((const int [],		/* ija - CMSR column pointers into matrix    */
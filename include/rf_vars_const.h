@@ -167,6 +167,11 @@ struct Nodal_Vars {
 			     * from the list of variables in the solution
 			     * vector corresponding to this node.
 			     */
+    short int *Index_Table; /* Var_Desc_List index that Index_Solution()
+			     * returns for each (variable type, species,
+			     * material), -1 for none. NULL until
+			     * index_solution_tables() fills it in.
+			     */
 };
 typedef struct Nodal_Vars NODAL_VARS_STRUCT;
 
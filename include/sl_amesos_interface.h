@@ -34,11 +34,25 @@ amesos_solve_msr ( char *,
 		   double *,
 		   double *,
 		   int );
+EXTERN void
+amesos_solve_msr_multi ( char *,
+			 struct Aztec_Linear_Solver_System *,
+			 double **,	/* x_ - nrhs solutions             */
+			 double **,	/* b_ - nrhs right hand sides      */
+			 int,		/* nrhs                            */
+			 int );		/* NewMatrix - else reuse the LU   */
 EXTERN int
 amesos_solve_epetra( char *choice,
                      struct Aztec_Linear_Solver_System *ams,
                   double *x_,
                   double *resid_vector);
+EXTERN int
+amesos_solve_epetra_multi( char *choice,
+                     struct Aztec_Linear_Solver_System *ams,
+                  double **x_,
+                  double **b_,
+                  int nrhs,
+                  int NewMatrix);
 
 EXTERN void
 trilinos_solve_ls (double *,
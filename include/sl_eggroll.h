@@ -136,6 +136,28 @@ PROTO((dbl ,
        dbl *,
        dbl *));
 
+extern void egg_mass_compress	/* sl_eggrollutil.c */
+PROTO((int ,			/* n */
+       int *,			/* ija */
+       dbl *,			/* mas */
+       EGG_MASS *));
+
+extern void egg_mass_mv		/* sl_eggrollutil.c */
+PROTO((EGG_MASS *,
+       int *,			/* ija */
+       dbl *,			/* v */
+       dbl *));			/* z */
+
+extern void egg_mass_shift	/* sl_eggrollutil.c */
+PROTO((EGG_MASS *,
+       int ,			/* nnz */
+       dbl *,			/* jac */
+       dbl ,			/* sigma */
+       dbl *));			/* mat */
+
+extern void egg_mass_free	/* sl_eggrollutil.c */
+PROTO((EGG_MASS *));
+
 extern void gevp_order		/* sl_eggroll05.c */
 PROTO((int ,			/* nj */
        int ,			/* ev_n */
@@ -156,7 +178,7 @@ PROTO((int ,			/* UMF_system_id */
        int ,			/* nnz */
        int *,			/* ija */
        dbl *,			/* jac */
-       dbl *,			/* mas */
+       EGG_MASS *,		/* mas */
        dbl *,			/* mat */
 /*      int soln_tech,  */
        dbl *,			/* w */
@@ -169,8 +191,8 @@ extern void eggrollwrap /* sl_eggrollwrap.c */
            dbl *,       /* Info for eigenvalue extraction */
            int *,       /* Column pointer array */
            dbl *,       /* Nonzero array */
-           dbl *,       /* Nonzero array - same structure
-                           as jac[] (ija[]) */
+           EGG_MASS *,  /* Mass matrix, a subset of the
+                           structure of jac[] (ija[]) */
            dbl *,       /* Value of the solution vector */
            char *,      /* Name of exoII output file */
            int,
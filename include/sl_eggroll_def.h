@@ -43,6 +43,19 @@ typedef struct
   dbl **u;
 } EV;
 
+/* Mass matrix kept as its own (much sparser) subset of the MSR
+ * pattern ija[] of the Jacobian: the nonzeros of row i are
+ * val[ptr[i]..ptr[i+1]), found at pos[] in the MSR arrays.
+ */
+typedef struct
+{
+  int n;			/* rows */
+  int nnz;			/* stored nonzeros */
+  int *ptr;			/* [n+1] */
+  int *pos;			/* [nnz] */
+  dbl *val;			/* [nnz] */
+} EGG_MASS;
+
 /* Postscript structure
  */
 typedef struct 
@@ -8,6 +8,8 @@
 #ifndef INCLUDE_SL_EPETRA_INTERFACE_H_
 #define INCLUDE_SL_EPETRA_INTERFACE_H_
 
+#include "std.h"		/* goma_gid */
+
 #ifdef __cplusplus
 typedef Epetra_RowMatrix C_Epetra_RowMatrix_t;
 #else
@@ -20,10 +22,13 @@ extern "C" {
 
 C_Epetra_RowMatrix_t* EpetraCreateRowMatrix(int NumberProcRows);
 
-void EpetraInsertGlobalRowMatrix(C_Epetra_RowMatrix_t *AMatrix, int GlobalRow,
-    int NumEntries, const double *Values, const int *Indices);
+void EpetraInsertGlobalRowMatrix(C_Epetra_RowMatrix_t *AMatrix, goma_gid GlobalRow,
+    int NumEntries, const double *Values, const goma_gid *Indices);
+
+void EpetraSumIntoGlobalRowMatrix(C_Epetra_RowMatrix_t *AMatrix, goma_gid GlobalRow,
+    int NumEntries, const double* Values, const goma_gid* Indices);
 
-void EpetraSumIntoGlobalRowMatrix(C_Epetra_RowMatrix_t *AMatrix, int GlobalRow,
+void EpetraSumIntoMyRowMatrix(C_Epetra_RowMatrix_t *AMatrix, int MyRow,
     int NumEntries, const double* Values, const int* Indices);
 
 void EpetraPutScalarRowMatrix(C_Epetra_RowMatrix_t *AMatrix, double scalar);
@@ -31,7 +36,7 @@ void EpetraPutScalarRowMatrix(C_Epetra_RowMatrix_t *AMatrix, double scalar);
 void EpetraFillCompleteRowMatrix(C_Epetra_RowMatrix_t *AMatrix);
 
 int EpetraExtractRowValuesRowMatrix(C_Epetra_RowMatrix_t *AMatrix,
-    int GlobalRow, int size, double *values, int *indices);
+    goma_gid GlobalRow, int size, double *values, goma_gid *indices);
 
 void EpetraDeleteRowMatrix(C_Epetra_RowMatrix_t *AMatrix);
 
@@ -17,7 +17,7 @@ void EpetraLoadLec(Exo_DB *exo, int ielem, struct Aztec_Linear_Solver_System *am
 
 void EpetraRowSumScale(struct Aztec_Linear_Solver_System *ams, double *b, double *scale);
 
-void EpetraSetDiagonalOnly(struct Aztec_Linear_Solver_System *ams, int GlobalRow);
+void EpetraSetDiagonalOnly(struct Aztec_Linear_Solver_System *ams, goma_gid GlobalRow);
 
 #ifdef __cplusplus
 } // end of extern "C"
@@ -38,11 +38,11 @@ PROTO((int ,			/* local_order                          (in) */
        int ,			/* local_nnz - number of nonzeroes      (in) */
        int ,			/* local_nnz_plus - including external 
 				 * rows                                 (in) */
-       int *,			/* global_order - the real order       (out) */
-       int *,			/* global_order_plus - overcounting external 
+       goma_gid *,		/* global_order - the real order       (out) */
+       goma_gid *,		/* global_order_plus - overcounting external 
 				 * rows                                (out) */
-       int *,			/* global_nnz - the strict count       (out) */
-       int *));			/* global_nnz_plus - overcounting external 
+       goma_gid *,		/* global_nnz - the strict count       (out) */
+       goma_gid *));		/* global_nnz_plus - overcounting external 
 				 * rows                                (out) */
 
 EXTERN void print_msr_matrix	/* sl_matrix_util.c                          */
@@ -117,4 +117,19 @@ extern void matrix_dump_vbr(struct Aztec_Linear_Solver_System *,
 			    Exo_DB *, Dpi *, double *);
 #endif
 
+/*
+ * Prototypes from sl_matrix_replay.c
+ */
+extern char Matrix_Replay_Dump_File[];	/* "Matrix Replay Dump", empty if
+					 * none */
+extern int Matrix_Replay_Dump_Count;	/* which solve to dump, from 1 */
+extern char Matrix_Replay_File[];	/* "Matrix Replay File", empty if
+					 * none */
+
+extern void matrix_replay_dump(struct Aztec_Linear_Solver_System *,
+			       Exo_DB *, Dpi *, double []);
+extern int matrix_replay_load(struct Aztec_Linear_Solver_System *,
+			      double []);
+extern void matrix_replay_report(const dbl, const dbl, const int);
+
 #endif /* _SL_MATRIX_UTIL_H */
@@ -6,7 +6,20 @@ extern "C" {
 #endif
 
 int stratimikos_solve(struct Aztec_Linear_Solver_System *ams, double *x_,
-    double *b_, int *iterations, char *stratimikos_file);
+    double *b_, int *iterations, char *stratimikos_file,
+    double tolerance);		/* tolerance - > 0 overrides the file's */
+
+/* the same for nrhs right hand sides at once, a block solve if the
+ * stratimikos file asks for one (e.g. Belos "Block GMRES"); the solver
+ * and preconditioner of the last stratimikos_solve() are reused if it was
+ * for this matrix, whose values must not have changed since */
+int stratimikos_solve_multi(struct Aztec_Linear_Solver_System *ams,
+    double **x_, double **b_, int nrhs, int *iterations,
+    char *stratimikos_file, double tolerance);
+
+/* the next solve is that of Newton iteration newton_its, for the
+ * Krylov Recycling and Krylov Initial Guess cards */
+void stratimikos_next_solve(int newton_its, double delta_t);
 
 #ifdef __cplusplus
 } // end of extern "C"
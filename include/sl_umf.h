@@ -39,6 +39,18 @@ PROTO (( int,
 	 double *,
 	 double *  ));
 
+extern int SL_UMF_refine
+PROTO (( int,
+	 int,
+	 int,
+	 int *,
+	 double *,
+	 double *,
+	 double *  ));
+
+extern dbl Direct_Refine_Tol;	/* Direct Solve Refinement card */
+extern int Direct_Refine_Steps;
+
 struct UMF_Linear_Solver_System
 {
 	int n, nnz;
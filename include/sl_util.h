@@ -37,11 +37,13 @@
 #define ADVECT                          0
 #define CORRECT                         1
 #define PROJECT                         2
+#define LUMP                            3 /* lumped fill mass, for LS_EVOLVE_ADVECT_LUMPED */
 #define EXO_READ                        4
 #define HUYGENS                         5
 #define SURFACES                        6
 #define HUYGENS_C                       7
 #define SM_OBJECT                       8
+#define FAST_MARCH                      9
 
 #define LS_SURF_POINT                   0
 #define LS_SURF_PLANE                   1
@@ -60,6 +62,11 @@
                                              (current requires not using COUPLED_FILL  */
 #define LS_EVOLVE_SEMILAGRANGIAN        3 /* Semi-lagrangian scheme for evolution
                                              (current requires not using COUPLED_FILL  */
+#define LS_EVOLVE_ADVECT_LUMPED         4 /* Subcycled explicit advection, lumped mass
+                                             (current requires not using COUPLED_FILL  */
+
+#define LS_CURV_PROJ_COUPLED            0 /* CURVATURE, NORMAL equations, if any */
+#define LS_CURV_PROJ_LUMPED             1 /* explicit lumped L2 projections instead */
 
 #define MAX_NXN_RANK 6 /* To avoid many malloc()'s in solve_NxN_system(). */
 
@@ -147,6 +154,55 @@ PROTO((dbl *,			/* A */
        const int,               /* rank (<= row_size) */
        const int));             /* row_size (A's 2nd dimension is row_size) */
 
+/*
+ * Prototypes from sl_autotune.c
+ */
+extern int Autotune_Linear_Solver;	/* "Linear Solver Autotune" */
+extern dbl Autotune_Degrade;		/* iterations ratio that retunes */
+
+extern int aztec_autotune_pending
+PROTO((void));
+
+extern void aztec_autotune
+PROTO((struct Aztec_Linear_Solver_System *,
+       double [],		/* delta_x - scratch */
+       double []));		/* resid_vector - right hand side */
+
+extern void aztec_autotune_check
+PROTO((struct Aztec_Linear_Solver_System *));
+
+/*
+ * Prototypes from sl_fallback.c
+ */
+#define MAX_FALLBACK_LEVELS	6
+
+#define FALLBACK_ILU		1 /* gmres, ilu(k) subdomains */
+#define FALLBACK_ILUT		2 /* gmres, ilut subdomains, more fill */
+#define FALLBACK_LU		3 /* gmres, exact lu subdomains */
+#define FALLBACK_AMESOS		4 /* direct solve with Amesos_Package */
+
+extern int Num_Fallback_Levels;	/* "Linear Solver Fallback" */
+extern int Fallback_Type[MAX_FALLBACK_LEVELS];
+extern dbl Fallback_Fill[MAX_FALLBACK_LEVELS]; /* k of ilu(k), ilut fill */
+
+extern int linear_fallback_begin /* number of attempts allowed */
+PROTO((struct Aztec_Linear_Solver_System *,
+       double []));		/* resid_vector - right hand side */
+
+extern int linear_fallback_next	/* TRUE if already solved, directly */
+PROTO((struct Aztec_Linear_Solver_System *,
+       const int ,		/* attempt - 1, 2, ... */
+       double [],		/* delta_x */
+       double []));		/* resid_vector */
+
+extern void linear_fallback_end
+PROTO((struct Aztec_Linear_Solver_System *,
+       const int ,		/* attempts made */
+       const int ));		/* solved - of the last attempt */
+
+extern void linear_fallback_report
+PROTO((void));
+
 #if defined(ENABLE_AMESOS) && defined(TRILINOS)
 /* Use prototype in sl_amesos_interface.h */
 #else
@@ -156,6 +212,22 @@ PROTO((char *,
        double *,
        double *,
        int ));
+
+extern void amesos_solve_msr_multi
+PROTO((char *,
+       struct Aztec_Linear_Solver_System *,
+       double **,		/* x_ - nrhs solutions */
+       double **,		/* b_ - nrhs right hand sides */
+       int ,			/* nrhs */
+       int ));
+
+extern int amesos_solve_epetra_multi
+PROTO((char *,
+       struct Aztec_Linear_Solver_System *,
+       double **,		/* x_ - nrhs solutions */
+       double **,		/* b_ - nrhs right hand sides */
+       int ,			/* nrhs */
+       int ));
 #endif
 
 /*****************************************************************************/
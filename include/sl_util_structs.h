@@ -104,7 +104,7 @@ struct Aztec_Linear_Solver_System
 			    * inherent inefficiency... */
 
   double *val;		   /* "a" */
-  double *val_old;	   /* "a_old" */
+  double *val_old;	   /* "a_old", NULL unless save_old_A */
   int     npn;             /* number of processor nodes, excluding external
 			      nodes */
   int     npn_plus;        /* number of processor nodes, including external
@@ -120,7 +120,8 @@ struct Aztec_Linear_Solver_System
 #endif
 
   C_Epetra_RowMatrix_t *RowMatrix; /* This is a Epetra_RowMatrix object */
-  int *GlobalIDs;                  /* Pointer to global ids of DOFs (only available with epetra) */
+  goma_gid *GlobalIDs;             /* Pointer to global ids of DOFs (only available with epetra) */
+  int *ColumnLIDs;                 /* Column map local ids of the same DOFs (only available with epetra) */
 };
 
 /* See paper by Hood (1976, J. Numer. Meth Engr.) for details of this
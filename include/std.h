@@ -336,6 +336,18 @@
 #ifdef HAVE_MPI_H
 #include <mpi.h>
 #endif
+
+/*
+ * Communication Report File: each MPI_Allreduce is counted by its call
+ * site, in dp_comm_prof.c. Not in C++, where the Trilinos headers make
+ * their own calls.
+ */
+#if defined(HAVE_MPI_H) && !defined(__cplusplus) && !defined(_DP_COMM_PROF_C)
+extern int comm_allreduce_FL(const void *, void *, int, MPI_Datatype, MPI_Op,
+			     MPI_Comm, const char *, const int);
+#define MPI_Allreduce(s, r, n, t, o, c)	\
+  comm_allreduce_FL((s), (r), (n), (t), (o), (c), __FILE__, __LINE__)
+#endif
 #ifdef HAVE_MPE_H
 #include <mpe.h>
 #endif
@@ -354,6 +366,7 @@ typedef int MPI_Aint;
 #define MPI_INT 2
 #define MPI_FLOAT 3
 #define MPI_DOUBLE 4
+#define MPI_LONG_LONG 5
 #endif
 
 /*************************************************************************/
@@ -464,6 +477,21 @@ typedef unsigned long  int		u_long;
 
 typedef	double	dbl;
 
+/*
+ * Global ordinals: unknown, node and element numbers across all of the
+ * processors, and sums of nonzeroes over them. They are 64 bit when goma
+ * is built with -DGOMA_GLOBAL_INDEX_64 (the epetra matrices then need a
+ * Trilinos with 64 bit global indices); local indices stay int.
+ */
+
+#ifdef GOMA_GLOBAL_INDEX_64
+typedef long long goma_gid;
+#define MPI_GOMA_GID MPI_LONG_LONG
+#else
+typedef int goma_gid;
+#define MPI_GOMA_GID MPI_INT
+#endif
+
 /*
  * A boolean type named bool
  */
@@ -73,6 +73,12 @@ PROTO(( Exo_DB *,                /* exo - ptr to mesh struct */
 	double [] ));            /* global value vector */
 	
 
+EXTERN void wr_exo_session_close /* wr_exo.c */
+PROTO((void));
+
+EXTERN void wr_exo_output_finish /* wr_exo.c */
+PROTO((void));
+
 EXTERN void add_qa_stamp
 PROTO((Exo_DB *));		/* exo                                       */
 
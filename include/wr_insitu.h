@@ -0,0 +1,63 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * wr_insitu.h -- hand output steps to an in situ Catalyst pipeline
+ *
+ * At each output step the mesh and the nodal fields written to the
+ * results file are described to Catalyst as a Conduit Mesh Blueprint,
+ * pointing at goma's own arrays instead of copies wherever they live
+ * long enough. Without GOMA_CATALYST these are all no-ops.
+ */
+
+#ifndef _WR_INSITU_H
+#define _WR_INSITU_H
+
+#ifdef EXTERN
+#undef EXTERN
+#endif
+
+#ifdef _WR_INSITU_C
+#define EXTERN /* do nothing */
+#endif
+
+#ifndef _WR_INSITU_C
+#define EXTERN extern
+#endif
+
+/*
+ * How insitu_nodal_field() may hold on to the values passed in.
+ */
+#define INSITU_SHARE 0		/* unchanged until insitu_step_execute() */
+#define INSITU_COPY  1		/* about to be overwritten, copy them */
+
+EXTERN int insitu_active	/* TRUE if a Catalyst Script is in use       */
+PROTO((void));
+
+EXTERN void insitu_step_begin
+PROTO((Exo_DB *,		/* exo - ptr to EXODUS II finite element db  */
+       Dpi *,			/* dpi - distributed processing info         */
+       const int ,		/* step - output step number                 */
+       const dbl ));		/* time - time value of the step             */
+
+EXTERN void insitu_nodal_field
+PROTO((const char *,		/* name - as written to the results file     */
+       dbl *,			/* values - [num_nodes]                      */
+       const int ));		/* hold - INSITU_SHARE or INSITU_COPY        */
+
+EXTERN void insitu_step_execute	/* run the pipelines on the open step        */
+PROTO((void));
+
+EXTERN void insitu_finalize
+PROTO((void));
+
+#endif /* _WR_INSITU_H */
@@ -0,0 +1,54 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * wr_stats.h -- running statistics of nodal solution variables
+ *
+ * The variables named on the "Running Statistics" card are sampled at
+ * every accepted time step into a time-weighted mean, variance, minimum,
+ * maximum and time integral per node, which are added to the results
+ * file as further nodal variables and written with every output step.
+ */
+
+#ifndef _WR_STATS_H
+#define _WR_STATS_H
+
+#ifdef EXTERN
+#undef EXTERN
+#endif
+
+#ifdef _WR_STATS_C
+#define EXTERN /* do nothing */
+#endif
+
+#ifndef _WR_STATS_C
+#define EXTERN extern
+#endif
+
+EXTERN int running_stats_register /* number of results variables added      */
+PROTO((struct Results_Description *, /* rd - after load_nodal_tkn()          */
+       Exo_DB *));		/* exo - ptr to EXODUS II finite element db  */
+
+EXTERN void running_stats_update
+PROTO((double [],		/* x - solution at the end of the step       */
+       Exo_DB *,		/* exo - ptr to EXODUS II finite element db  */
+       const dbl ));		/* delta_t - size of the step                */
+
+EXTERN void running_stats_write
+PROTO((struct Results_Description *, /* rd - of the results file             */
+       Exo_DB *,		/* exo - ptr to EXODUS II finite element db  */
+       char *,			/* filename - results file                   */
+       dbl *,			/* gvec - work vector, [num_nodes]           */
+       const int ,		/* step - output step number                 */
+       const dbl ));		/* time_value - time of the step             */
+
+#endif /* _WR_STATS_H */
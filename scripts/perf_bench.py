@@ -0,0 +1,171 @@
+#!/usr/bin/env python3
+# Usage:
+#      perf_bench.py run <suite> <results.json> [--goma goma] [--mpirun mpirun]
+#      perf_bench.py compare <baseline.json> <results.json> [--tol 0.10]
+#                            [--floor 0.05]
+#
+# Runs a suite of Goma problems at fixed processor counts and gathers
+# the region times each one writes to its Performance Report File, then
+# compares a set of results against a stored baseline.
+#
+# A suite file has one problem per line (# starts a comment):
+#
+#      <name> <ranks> <directory> <input deck>
+#
+# where the directory is taken relative to the suite file. Each deck
+# must name a JSON Performance Report File in its FEM File
+# Specifications; the end of run report is what is collected.
+#
+# compare prints each region whose maximum wall time over the
+# processors is more than --tol slower (as a fraction) than in the
+# baseline, ignoring regions under --floor seconds in both, and exits
+# with status 1 if there were any or if a problem is missing or failed.
+
+import argparse
+import json
+import os
+import re
+import subprocess
+import sys
+import time
+
+
+def read_suite(suite):
+    problems = []
+    base = os.path.dirname(os.path.abspath(suite))
+    with open(suite) as f:
+        for num, line in enumerate(f, 1):
+            line = line.split('#', 1)[0].strip()
+            if not line:
+                continue
+            fields = line.split()
+            if len(fields) != 4:
+                sys.exit("%s:%d: expected <name> <ranks> <directory> <input>"
+                         % (suite, num))
+            problems.append({'name': fields[0],
+                             'ranks': int(fields[1]),
+                             'dir': os.path.join(base, fields[2]),
+                             'input': fields[3]})
+    return problems
+
+
+def report_file(deck):
+    ''' Returns the Performance Report File named in deck, or None '''
+    card = re.compile(r'^\s*Performance\s+Report\s+File\s*=\s*(\S+)',
+                      re.IGNORECASE)
+    with open(deck) as f:
+        for line in f:
+            m = card.match(line)
+            if m and m.group(1).upper() not in ('NONE', 'NO'):
+                return m.group(1)
+    return None
+
+
+def run_problem(p, goma, mpirun):
+    result = {'ranks': p['ranks'], 'status': 'failed', 'regions': {}}
+    report = report_file(os.path.join(p['dir'], p['input']))
+    if report is None or report.lower().endswith('.csv'):
+        result['status'] = 'no json Performance Report File in the deck'
+        return result
+    report = os.path.join(p['dir'], report)
+    if os.path.exists(report):
+        os.remove(report)
+
+    cmd = [goma, '-i', p['input']]
+    if p['ranks'] > 1:
+        cmd = [mpirun, '-np', str(p['ranks'])] + cmd
+    start = time.time()
+    with open(os.path.join(p['dir'], 'perf_bench.log'), 'w') as log:
+        rc = subprocess.call(cmd, cwd=p['dir'], stdout=log,
+                             stderr=subprocess.STDOUT)
+    result['elapsed'] = time.time() - start
+    if rc != 0 or not os.path.exists(report):
+        result['status'] = 'failed (exit %d), see perf_bench.log' % rc
+        return result
+
+    with open(report) as f:
+        data = json.load(f)
+    for r in data['regions']:
+        result['regions'][r['path']] = {'wall_max': r['wall']['max'],
+                                        'wall_avg': r['wall']['avg'],
+                                        'calls': r['calls']}
+    result['status'] = 'ok'
+    return result
+
+
+def run(args):
+    results = {}
+    for p in read_suite(args.suite):
+        print("%-32s %3d ranks ..." % (p['name'], p['ranks']), end=' ')
+        sys.stdout.flush()
+        results[p['name']] = run_problem(p, args.goma, args.mpirun)
+        r = results[p['name']]
+        if r['status'] == 'ok':
+            print("%.2f s" % r['elapsed'])
+        else:
+            print(r['status'])
+    with open(args.results, 'w') as f:
+        json.dump(results, f, indent=2, sort_keys=True)
+    return 0
+
+
+def compare(args):
+    with open(args.baseline) as f:
+        base = json.load(f)
+    with open(args.results) as f:
+        new = json.load(f)
+
+    bad = 0
+    for name in sorted(base):
+        b = base[name]
+        n = new.get(name)
+        if n is None or n['status'] != 'ok':
+            print("%s: %s" % (name, 'missing' if n is None else n['status']))
+            bad += 1
+            continue
+        if b['ranks'] != n['ranks']:
+            print("%s: run on %d ranks, baseline on %d"
+                  % (name, n['ranks'], b['ranks']))
+            bad += 1
+            continue
+        for path in sorted(b['regions']):
+            tb = b['regions'][path]['wall_max']
+            tn = n['regions'].get(path, {}).get('wall_max', 0.)
+            if max(tb, tn) < args.floor:
+                continue
+            if tn > tb * (1. + args.tol):
+                print("%s: %s %.3f s -> %.3f s (%+.0f%%)"
+                      % (name, path, tb, tn, 100. * (tn - tb) / max(tb, 1e-30)))
+                bad += 1
+    if bad == 0:
+        print("no regressions beyond %.0f%%" % (100. * args.tol))
+    return 1 if bad else 0
+
+
+def main():
+    parser = argparse.ArgumentParser(description='Goma performance suite')
+    sub = parser.add_subparsers(dest='command')
+
+    p = sub.add_parser('run', help='run a suite and gather region times')
+    p.add_argument('suite')
+    p.add_argument('results')
+    p.add_argument('--goma', default='goma')
+    p.add_argument('--mpirun', default='mpirun')
+
+    p = sub.add_parser('compare', help='compare results with a baseline')
+    p.add_argument('baseline')
+    p.add_argument('results')
+    p.add_argument('--tol', type=float, default=0.10)
+    p.add_argument('--floor', type=float, default=0.05)
+
+    args = parser.parse_args()
+    if args.command == 'run':
+        return run(args)
+    if args.command == 'compare':
+        return compare(args)
+    parser.print_help()
+    return 2
+
+
+if __name__ == '__main__':
+    sys.exit(main())
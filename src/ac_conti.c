@@ -41,9 +41,69 @@ PROTO((int *,			/* nelem_glob */
        int *));			/* allocated */
 #endif
 
+/*
+ * Second order prediction: the quadratic through x_old with slope
+ * x_sens there, the tangent of the last converged solve, that also
+ * passes through x_older, ds_old before it. Without x_older (fewer than
+ * two converged steps) it is the first order prediction.
+ */
+
+static void
+second_order_prediction(const int n,
+			double *x,
+			const double *x_old,
+			const double *x_older,
+			const double *x_sens,
+			const double ds,	/* signed step to the new point */
+			const double ds_old,	/* signed step back to x_older */
+			const int quadratic)
+{
+  int i;
+  double c;
+
+  for (i = 0; i < n; i++)
+    {
+      c = 0.0;
+      if (quadratic)
+	c = (x_older[i] - x_old[i] - ds_old * x_sens[i]) / (ds_old * ds_old);
+      x[i] = x_old[i] + ds * x_sens[i] + c * ds * ds;
+    }
+}
+
+/*
+ * RMS over all processors of the difference between the converged
+ * solution and its prediction, relative to 1 + |x|.
+ */
+
+static double
+predictor_error(const int n,
+		const double *x,
+		const double *x_pred)
+{
+  int i;
+  double e, sum[2];
+#ifdef PARALLEL
+  double sum_global[2];
+#endif
+
+  sum[0] = 0.0;
+  sum[1] = (double) n;
+  for (i = 0; i < n; i++)
+    {
+      e = (x[i] - x_pred[i]) / (1.0 + fabs(x[i]));
+      sum[0] += e * e;
+    }
+#ifdef PARALLEL
+  MPI_Allreduce(sum, sum_global, 2, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  sum[0] = sum_global[0];
+  sum[1] = sum_global[1];
+#endif
+  return (sum[1] > 0.0 ? sqrt(sum[0] / sum[1]) : 0.0);
+}
+
 /*
 
-   ZERO AND FIRST ORDER CONTINUATION
+   ZERO, FIRST AND SECOND ORDER CONTINUATION
 
    BASED ON solve_problem() IN rf_solve.c
 
@@ -78,6 +138,7 @@ continue_problem (Comm_Ex *cx,	/* array of communications structures */
   double *x_old=NULL;		/* old solution vector                          */
   double *x_older=NULL;		/* older solution vector                        */
   double *x_oldest=NULL;	/* oldest solution vector saved                 */
+  double *x_pred=NULL;		/* prediction the last Newton solve started at  */
   double *xdot=NULL;		/* current path derivative of soln              */
   double *xdot_old=NULL;
   double *x_update=NULL;
@@ -129,6 +190,8 @@ continue_problem (Comm_Ex *cx,	/* array of communications structures */
   double        delta_t;
   double	theta=0.0;
   double        eps;
+  double        pred_err, ds_ratio;
+  int           pred_order = 0;	/* order of the last prediction */
   double        lambda, lambdaEnd;
   double        timeValueRead = 0.0;
 
@@ -362,6 +425,7 @@ continue_problem (Comm_Ex *cx,	/* array of communications structures */
   asdv(&x_old,    numProcUnknowns);
   asdv(&x_older,  numProcUnknowns);
   asdv(&x_oldest, numProcUnknowns);
+  asdv(&x_pred,   numProcUnknowns);
   asdv(&xdot,     numProcUnknowns);
   asdv(&xdot_old, numProcUnknowns);
   asdv(&x_update, numProcUnknowns);
@@ -664,6 +728,7 @@ continue_problem (Comm_Ex *cx,	/* array of communications structures */
 
   log_msg("sl_init()...");
   sl_init(matrix_systems_mask, ams, exo, dpi, cx);
+  trim_exo(exo);
 
   /*
   * Make sure the solver was properly initialized on all processors.
@@ -756,6 +821,10 @@ continue_problem (Comm_Ex *cx,	/* array of communications structures */
 		  break;	/* duh */
 		}
 	      break;
+	    case  ALC_SECOND:
+	      second_order_prediction(NumUnknowns, x, x_old, x_older, x_sens,
+				      aldALC*delta_s, -aldALC*delta_s_old, nt > 1);
+	      break;
 	    default:
 	      DPRINTF(stderr, "%s: Bad Continuation, %d\n", yo, Continuation);
               EH(-1,"\t");
@@ -781,6 +850,9 @@ continue_problem (Comm_Ex *cx,	/* array of communications structures */
 	    case  ALC_FIRST:
 	      DPRINTF(stderr, "\n\tFirst Order Continuation:");
 	      break;
+	    case  ALC_SECOND:
+	      DPRINTF(stderr, "\n\tSecond Order Continuation:");
+	      break;
 	    default:
 	      DPRINTF(stderr, "%s: Bad Continuation, %d\n", yo, Continuation);
               EH(-1,"\t");
@@ -848,6 +920,11 @@ continue_problem (Comm_Ex *cx,	/* array of communications structures */
       ni = 0;
       do {
 
+	/* Keep the prediction, to measure its error once converged */
+	dcopy1(numProcUnknowns, x, x_pred);
+	pred_order = (Continuation == ALC_ZEROTH) ? 0 :
+	  ((Continuation == ALC_SECOND && nt > 1) ? 2 : 1);
+
 #ifdef DEBUG
 	DPRINTF(stderr, "%s: starting solve_nonlinear_problem\n", yo);
 #endif
@@ -1010,18 +1087,7 @@ continue_problem (Comm_Ex *cx,	/* array of communications structures */
  	    /*
       	     * Compute global volumetric quantities
       	     */
-     	     for (i = 0; i < nn_volume; i++ ) {
-       		evaluate_volume_integral(exo, dpi,
-                                pp_volume[i]->volume_type,
-                                pp_volume[i]->volume_name,
-                                pp_volume[i]->blk_id,
-                                pp_volume[i]->species_no,
-                                pp_volume[i]->volume_fname,
-                                pp_volume[i]->params,
-                                pp_volume[i]->num_params,
-                                NULL,  x, xdot, delta_s,
-                                path1, 1);
-     		}
+     	     evaluate_volume_integrals(exo, dpi, x, xdot, delta_s, path1, 1);
 
 	  }   /*  end of if converged block  */
 
@@ -1123,6 +1189,10 @@ continue_problem (Comm_Ex *cx,	/* array of communications structures */
 		    break;		/* duh */
 		  }
 		break;
+	      case  ALC_SECOND:
+		second_order_prediction(numProcUnknowns, x, x_old, x_older, x_sens,
+					aldALC*delta_s, -aldALC*delta_s_old, nt > 1);
+		break;
 	      default:
 		DPRINTF(stderr, "%s: Bad Continuation, %d\n", yo, Continuation);
                 EH(-1,"\t");
@@ -1176,6 +1246,23 @@ continue_problem (Comm_Ex *cx,	/* array of communications structures */
 					  eps,
 					  &success_ds,
 					  cont->use_var_norm, inewton);
+
+	  /*
+	   * With a Path Step Error, also hold the predictor error, which
+	   * goes as delta_s^(order+1), to that target.
+	   */
+	  if (eps > 0.0)
+	    {
+	      pred_err = predictor_error(NumUnknowns, x, x_pred);
+	      if (pred_err > 0.0)
+		{
+		  ds_ratio = 0.9 * pow(eps / pred_err, 1.0 / (double)(pred_order + 1));
+		  ds_ratio = MAX(0.5, MIN(3.0, ds_ratio));
+		  DPRINTF(stderr, "\tPredictor error %10.4e, step ratio %g\n",
+			  pred_err, ds_ratio);
+		  delta_s_new = MIN(delta_s_new, ds_ratio * delta_s);
+		}
+	    }
 	  if (delta_s_new > Delta_s_max)
 	    delta_s_new = Delta_s_max;
 	}
@@ -1215,6 +1302,8 @@ continue_problem (Comm_Ex *cx,	/* array of communications structures */
 	}
 
       if (step_fix != 0 && nt == step_fix) {
+	/* Every piece must be complete on disk before it is fixed */
+	wr_exo_session_close();
 #ifdef PARALLEL
 	/* Barrier because fix needs both files to be finished printing
 	   and fix always occurs on the same timestep as printing */
@@ -1298,6 +1387,10 @@ continue_problem (Comm_Ex *cx,	/* array of communications structures */
 	      break;		/* duh */
 	    }
 	  break;
+	case  ALC_SECOND:
+	  second_order_prediction(numProcUnknowns, x, x_old, x_older, x_sens,
+				  aldALC*delta_s, -aldALC*delta_s_old, nt > 1);
+	  break;
 	}
 
        if (!good_mesh) goto free_and_clear;
@@ -1384,6 +1477,7 @@ continue_problem (Comm_Ex *cx,	/* array of communications structures */
   safer_free( (void **) &x_old);
   safer_free( (void **) &x_older);
   safer_free( (void **) &x_oldest);
+  safer_free( (void **) &x_pred);
   safer_free( (void **) &xdot);
   safer_free( (void **) &xdot_old);
   safer_free( (void **) &x_update);
@@ -132,6 +132,7 @@ hunt_problem(Comm_Ex *cx,	/* array of communications structures */
   double	hunt_par, dhunt_par, hunt_par_old;	/* hunting continuation parameter */
   double        dhunt_par_max=1.0, dhunt_par_min=0., dhunt_par_0=0.1;
   double        dhunt_par_new=0.1, dhunt_par_old;
+  double        r_secant;     /* secant predictor step ratio */
   int           log_ID=-1;
   double        timeValueRead = 0.0;
 
@@ -706,6 +707,7 @@ hunt_problem(Comm_Ex *cx,	/* array of communications structures */
 
   log_msg("sl_init()...");
   sl_init(matrix_systems_mask, ams, exo, dpi, cx);
+  trim_exo(exo);
 
 #ifdef PARALLEL
   /*
@@ -1036,18 +1038,7 @@ hunt_problem(Comm_Ex *cx,	/* array of communications structures */
  	/*
       	 * Compute global volumetric quantities
       	 */
-     	 for (i = 0; i < nn_volume; i++ ) {
-       		evaluate_volume_integral(exo, dpi,
-                                pp_volume[i]->volume_type,
-                                pp_volume[i]->volume_name,
-                                pp_volume[i]->blk_id,
-                                pp_volume[i]->species_no,
-                                pp_volume[i]->volume_fname,
-                                pp_volume[i]->params,
-                                pp_volume[i]->num_params,
-                                NULL,  x, xdot, delta_s[0],
-                                path1[0], 1);
-     		}
+     	 evaluate_volume_integrals(exo, dpi, x, xdot, delta_s[0], path1[0], 1);
 
       } /* end of if converged block */
 
@@ -1159,7 +1150,14 @@ hunt_problem(Comm_Ex *cx,	/* array of communications structures */
 
 	switch (Continuation) {
 	case HUN_ZEROTH:
-	    vcopy(numProcUnknowns, &x[0], 1.0, &x_old[0]);
+	    if (cont->hunt_secant && nt > 1)
+	      {
+		r_secant = dhunt_par/dhunt_par_old;
+		v2sum(numProcUnknowns, &x[0], 1.0 + r_secant, &x_old[0],
+		      -r_secant, &x_older[0]);
+	      }
+	    else
+	      vcopy(numProcUnknowns, &x[0], 1.0, &x_old[0]);
 	    break;
 	case  HUN_FIRST:
 	    v2sum(numProcUnknowns, &x[0], 1.0, &x_old[0], dhunt_par, &x_sens[0]);
@@ -1357,6 +1355,8 @@ hunt_problem(Comm_Ex *cx,	/* array of communications structures */
     }
 
       if (step_fix != 0 && nt == step_fix) {
+        /* Every piece must be complete on disk before it is fixed */
+        wr_exo_session_close();
 #ifdef PARALLEL
         /* Barrier because fix needs both files to be finished printing
            and fix always occurs on the same timestep as printing */
@@ -1429,6 +1429,13 @@ hunt_problem(Comm_Ex *cx,	/* array of communications structures */
 
     switch (Continuation) {
     case HUN_ZEROTH:
+	/* x_older is the step before x_old only after two steps */
+	if (cont->hunt_secant && nt > 1)
+	  {
+	    r_secant = dhunt_par/dhunt_par_old;
+	    v2sum(numProcUnknowns, &x[0], 1.0 + r_secant, &x_old[0],
+		  -r_secant, &x_older[0]);
+	  }
 	break;
     case  HUN_FIRST:
 	v1add(numProcUnknowns, &x[0], dhunt_par, &x_sens[0]);
@@ -699,6 +699,7 @@ int do_loca (Comm_Ex *cx,  /* array of communications structures */
   matrix_systems_mask = 1;
   log_msg("sl_init()...");
   sl_init(matrix_systems_mask, ams, exo, dpi, cx);
+  trim_exo(exo);
 
   /* Make sure the solver was properly initialized on all processors */
 #ifdef PARALLEL
@@ -1090,6 +1091,7 @@ int do_loca (Comm_Ex *cx,  /* array of communications structures */
             con.eigen_info.Max_Iter   = eigen->Eigen_Maximum_Outer_Iterations;
             con.eigen_info.Every_n_Steps   = eigen->Eigen_Solve_Freq;
             con.eigen_info.sort            = TRUE;
+            con.eigen_info.Warm_Start      = eigen->Eigen_Warm_Start;
           }
         else EH(-1, "Number of eigenvalues must be specified!");
       }
@@ -1710,7 +1712,10 @@ int linear_solver_conwrap(double *x, int jac_flag, double *tmp)
  *                               when the matrix has been recalculated
  *                               at the same conditions as before.
  *               CHECK_JACOBIAN: Same matrix, but rebuild preconditioner anyway.
- *		  NOTE: For now, the preconditioner is always recalculated.
+ *		  NOTE: Only SAME_BUT_UNSCALED_JACOBIAN reuses anything: the
+ *		  rescaled matrix is the one factored by the previous solve,
+ *		  so UMFPACK and Amesos just resolve with those factors and
+ *		  Aztec reuses a kept (recalc) preconditioner.
  *    tmp        Work space array same length as x, only used for
  *               the SAME_BUT_UNSCALED_JACOBIAN option.
  *    rescale    Flag indicating if scale vector needs to be
@@ -1739,6 +1744,7 @@ int linear_solver_conwrap(double *x, int jac_flag, double *tmp)
   int   linear_solver_itns;     /* count cumulative linearsolver iterations */
   int   num_linear_solve_blks;  /* one pass for now */
   int   matrix_solved;          /* boolean */
+  int   reuse_factors;          /* matrix is the one factored last solve */
 
 /* Additional values for frontal solver */
 #ifdef HAVE_FRONT
@@ -1767,6 +1773,8 @@ int linear_solver_conwrap(double *x, int jac_flag, double *tmp)
       row_sum_scaling_scale(ams, xr, passdown.scale);
     }
 
+  reuse_factors = (jac_flag == SAME_BUT_UNSCALED_JACOBIAN);
+
 /* Call chosen linear solver */
 
       s_start = ut();
@@ -1777,7 +1785,7 @@ int linear_solver_conwrap(double *x, int jac_flag, double *tmp)
           if (strcmp(Matrix_Format, "msr"))
             EH(-1,"ERROR: umfpack solver needs msr matrix format");
 
-          Factor_Flag = 1;
+          Factor_Flag = (reuse_factors ? 3 : 1);
           if (Linear_Solver == UMFPACK2F) Factor_Flag = 0;
           /*  */
           matr_form = 1;
@@ -1832,7 +1840,7 @@ int linear_solver_conwrap(double *x, int jac_flag, double *tmp)
             }
           else if ( strcmp(Matrix_Factorization_Reuse, "recalc") == 0 )
             {
-              ams->options[AZ_pre_calc] = AZ_recalc;
+              ams->options[AZ_pre_calc] = (reuse_factors ? AZ_reuse : AZ_recalc);
             }
           else if ( strcmp(Matrix_Factorization_Reuse, "reuse") == 0 )
             {
@@ -1901,7 +1909,7 @@ int linear_solver_conwrap(double *x, int jac_flag, double *tmp)
         case AMESOS:
 
              if( strcmp( Matrix_Format,"msr" ) == 0 ) {
-                 amesos_solve_msr( Amesos_Package, ams, x, xr, 1 );
+                 amesos_solve_msr( Amesos_Package, ams, x, xr, !reuse_factors );
              } else if ( strcmp( Matrix_Format,"epetra" ) == 0 ) {
                  amesos_solve_epetra(Amesos_Package, ams, x, xr);
              } else {
@@ -2795,7 +2803,8 @@ void shifted_linear_solver_conwrap(double *x, double *y,
       break;
     case AMESOS:
       if( strcmp( Matrix_Format,"msr" ) == 0 ) {
-	amesos_solve_msr( Amesos_Package, ams, y, x, 1 );
+	amesos_solve_msr( Amesos_Package, ams, y, x,
+			  (jac_flag == NEW_JACOBIAN) );
       } else {
 	EH(-1," Sorry, only MSR  matrix format supported for loca eigenvalue");
       }
@@ -41,6 +41,7 @@ dbl Particle_Output_Time_Step;	/* Output every these units. */
 int Particle_Max_Time_Steps;	/* max number of particle time steps if steady solution. */
 enum Particle_Output_Format_t Particle_Output_Format; /* What kind of output file? */
 int Particle_Full_Output_Stride;         /* > 0 => full output every that many steps. */
+int Particle_Compaction_Stride;	/* > 0 => regroup particles by element every that many steps. */
 particle_filename_s Particle_Full_Output_Filename; /* where to put them. */
 int Particle_Number_Sample_Types; /* How many datasets to output? */
 int *Particle_Number_Samples_Existing; /* How many are tagged for each sample type?*/
@@ -67,7 +68,18 @@ int Particle_Number_PBCs;		/* Number of particle-related sideset BC's. */
 PBC_t *PBCs;			/* Particle boundary condition structures. */
 
 /* Global variables that reside entirely within this file. */
-static particle_t *particles_to_do, *particles_to_send;
+static particle_t *particles_to_send;
+
+/* Particles come out of blocks of PARTICLE_BLOCK_SIZE rather than one
+ * malloc() each; freed ones go on particle_free_list for reuse. */
+#define PARTICLE_BLOCK_SIZE 4096
+typedef struct particle_block_t {
+  struct particle_block_t *next;
+  particle_t *p;
+} particle_block_t;
+static particle_block_t *particle_blocks;
+static particle_t *particle_free_list;
+static dbl *el_min_side_length;	/* per element, when the mesh does not move */
 static particle_t **element_particle_list_head;
 static particle_t **backup_element_particle_list_head;
 static int num_particles;
@@ -100,6 +112,7 @@ element_particle_info_t *element_particle_info;
 
 static dbl my_volume;
 static dbl *el_volume;
+static dbl *el_volume_cdf;	/* running sum of el_volume, for sampling */
 static FILE **pa_fp;
 static FILE *pa_full_fp;
 
@@ -121,6 +134,18 @@ static void get_boundary_xi_newton(const dbl * const, const int, dbl *, const in
 
 static particle_t * obtain_particle_space(const int);
 
+static particle_t * new_particle(void);
+
+static void free_particle(particle_t *);
+
+static void compact_particle_lists(void);
+
+#ifdef PARALLEL
+static void finish_transferred_particle(particle_t *, const dbl, const dbl, const int, int *);
+
+static void exchange_transfer_particles(const dbl, const dbl, const int, int *);
+#endif
+
 static particle_t * create_a_particle(particle_t *, const int);
 
 static int rejection_sample_a_particle(void);
@@ -154,6 +179,9 @@ static int get_element_xi_newton(const int, const dbl * const, dbl *);
 static dbl get_element_minimum_side_length(const int);
 
 static void output_TECPLOT_zone_info(const dbl, const int, const int);
+static void output_BINARY_header(const int);
+static void output_sample_record(const int, const int, const dbl *, const dbl, const dbl *,
+				 const int);
 
 static void output_a_particle(particle_t * const, const dbl, const dbl, const int, const int, const int);
 
@@ -181,8 +209,6 @@ static void remove_from_element_particle_list(particle_t *, const int);
 
 static void add_to_send_list(particle_t *);
 
-static void add_to_do_list(particle_t *);
-
 static void couple_to_continuum(void);
 
 static void load_restart_file(void);
@@ -324,7 +350,9 @@ initialize_particles(const Exo_DB * exo,
 	    EH(-1, "Could not open a particle file for zeroing.");
 	  DPRINTF(stdout, "%s, ", Particle_Filename_Template[i]); fflush(stdout);
 	  Particle_Number_Samples_Existing[i] = 0;
-	  if(Particle_Output_Format == TECPLOT)
+	  if(Particle_Output_Format == BINARY)
+	    output_BINARY_header(i);
+	  else if(Particle_Output_Format == TECPLOT)
 	    {
 	      fprintf(pa_fp[i], "TITLE = \"Goma Particles\"\n");
 #ifdef PARALLEL
@@ -368,6 +396,12 @@ initialize_particles(const Exo_DB * exo,
       el_index_end = static_exo->eb_ptr[static_exo->num_elem_blocks];
       num_els = el_index_end - el_index_begin;
       el_volume = (dbl *)malloc(num_els * sizeof(dbl));
+      el_volume_cdf = (dbl *)malloc(num_els * sizeof(dbl));
+
+      /* Every processor draws its own stream.  Processor 0, like a
+       * serial run, keeps drand48()'s unseeded one. */
+      if(Num_Proc > 1)
+	srand48(0x1234ABCDL + ProcID);
   
       /* First get total element "volume" */
       total_volume = my_volume =  fill_element_volumes(el_index_begin, el_index_end);
@@ -1275,15 +1309,14 @@ compute_particles(const Exo_DB *exo,	/* mesh */
   particle_t *p, *p_tmp;
   int i, el_index;
 #ifdef PARALLEL
-  int mpi_byte_count, mpi_retval;
-  particle_t termination_p, send_p, recv_p;
-  int j, done, local_max_particle_iterations, local_max_newton_iterations;
+  int done, local_max_particle_iterations, local_max_newton_iterations;
   int local_num_particles, local_particle_transfers, particle_transfers;
   dbl local_total_accum_ust, local_particle_accum_ust, local_output_accum_ust, local_communication_accum_ust;
   int local_num_to_send, num_to_send;
-  MPI_Status mpi_status;
 #endif
   
+  timer_push("particles");
+
   total_accum_ust = 0.0;
   particle_accum_ust = 0.0;
   output_accum_ust = 0.0;
@@ -1304,6 +1337,9 @@ compute_particles(const Exo_DB *exo,	/* mesh */
   static_xdot_old = xdot_old;
   static_resid_vector = resid_vector;
 
+  if(Particle_Compaction_Stride > 0 && !(n % Particle_Compaction_Stride))
+    compact_particle_lists();
+
   if(Particle_Output_Format == TECPLOT)
     output_TECPLOT_zone_info(global_end_time, n, 0);
   output_accum_ust = MAX(ust() - start_ust, 0.0);
@@ -1381,7 +1417,7 @@ compute_particles(const Exo_DB *exo,	/* mesh */
 	    {
 	      num_particles--;
 	      remove_from_element_particle_list(p, el_index);
-	      free(p);	/* Bye bye */
+	      free_particle(p);	/* Bye bye */
 	      fprintf(stderr, "REMOVING A PARTICLE\n");
 	    }
 	  else if(p->state == ACTIVE && el_index != p->owning_elem_id) /* I moved elements on the same processor. */
@@ -1412,188 +1448,30 @@ compute_particles(const Exo_DB *exo,	/* mesh */
     }
 
 #ifdef PARALLEL
-  if(Num_Proc > 0)
+  if(Num_Proc > 1)
     {
-      /*
-	fprintf(stderr, "Proc %d wants to send %d particles.\n", ProcID, local_num_to_send);  fflush(stderr);
-      */
-      /* Now perform send/receives and advance_a_particle()'s for the
-       * particles that are moving across processors. */
+      /* Now exchange and advance the particles that are moving across
+       * processors.  Each round packs what is on the send list into one
+       * message per destination; the per-pair counts go around first, so
+       * everyone knows what to expect.  Each incoming batch is advanced as
+       * soon as it arrives, while the rest are still in flight.  Particles
+       * that move on again go on the send list for the next round.  The
+       * exchange is finished once a round has sent nothing on any
+       * processor. */
       MPI_Barrier(MPI_COMM_WORLD);
       num_to_send = 0;
       MPI_Allreduce(&local_num_to_send, &num_to_send, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
       local_particle_transfers += local_num_to_send;
-      if(!num_to_send)
-	done = 1;
-      else
-	done = 0;
+      done = !num_to_send;
 
-      zero_a_particle(&termination_p);
-      termination_p.state = TERMINATION_MARKER;
       while(!done)
 	{
-	  /* This next loop does a full all processor to all processor
-	   * exchange of particles.  This is done before any other moves are
-	   * completed. */
-	  for(i = 0; i < Num_Proc; i++)
-	    {
-	      if(i == ProcID) /* I'm the sender! */
-		{
-		  p = particles_to_send;
-		  particles_to_send = NULL;
-		  while(p)
-		    {
-		      p_tmp = p->next;
-		      /*
-			fprintf(stderr, "Proc %d is sending a particle to proc %d\n", i, p->owning_proc_id); fflush(stderr);
-		      */
-		      memcpy(&send_p, p, sizeof(particle_t));
-		      mpi_retval = MPI_Send(&send_p, sizeof(particle_t), MPI_BYTE, p->owning_proc_id, 0, MPI_COMM_WORLD);
-		      if(mpi_retval != MPI_SUCCESS)
-			{
-			  fprintf(stderr, "Proc %d failed on particle send (%d).\n", ProcID, mpi_retval);
-			  exit(-1);
-			}
-		      free(p);
-		      p = p_tmp;
-		    }
-		  for(j = 0; j < Num_Proc; j++)
-		    if(i == j)
-		      continue;
-		    else
-		      {
-			/*
-			  fprintf(stderr, "Proc %d is sending the TERMINATION_MARKER to proc %d\n", i, j); fflush(stderr);
-			*/
-			mpi_retval = MPI_Send(&termination_p, sizeof(particle_t), MPI_BYTE, j, 0, MPI_COMM_WORLD);
-			if(mpi_retval != MPI_SUCCESS)
-			  {
-			    fprintf(stderr, "Proc %d failed on TERMINATION_MARKER send (%d).\n", ProcID, mpi_retval);
-			    exit(-1);
-			  }
-		      }
-		}
-	      else
-		{
-		  recv_p.state = ACTIVE;
-		  while(recv_p.state != TERMINATION_MARKER)
-		    {
-		      mpi_retval = MPI_Recv(&recv_p, sizeof(particle_t), MPI_BYTE, i, 0, MPI_COMM_WORLD, &mpi_status);
-		      if(mpi_retval != MPI_SUCCESS)
-			{
-			  fprintf(stderr, "Proc %d failed on particle receive (%d).\n", ProcID, mpi_retval);
-			  exit(-1);
-			}
-		      MPI_Get_count(&mpi_status, MPI_BYTE, &mpi_byte_count);
-		  
-		      /*
-			fprintf(stderr, "Proc %d received a particle from proc %d with state = %d\n   MPI_SOURCE/TAG/ERROR = %d/%d/%d, MPI_Count = %d.\n", ProcID, i, recv_p.state, mpi_status.MPI_SOURCE, mpi_status.MPI_TAG, mpi_status.MPI_ERROR, mpi_byte_count);
-			fflush(stderr);
-		      */
-		      if(mpi_byte_count != sizeof(particle_t))
-			{
-			  fprintf(stderr, "Proc %d did not have proper incoming byte count!\n", ProcID); fflush(stderr);
-			  MPI_Finalize();
-			  exit(-1);
-			}
-
-		      if(recv_p.state != TERMINATION_MARKER)
-			{
-			  add_to_do_list(&recv_p);
-			  /*
-			    fprintf(stderr, "Proc %d is adding a particle to its to do list.\n", ProcID); fflush(stderr);
-			  */
-			  /*
-			    dump(NO_EXIT, &termination_p, "Rcvd by proc %d.\n", ProcID);
-			  */
-			}
-		    }
-		}
-	      mpi_retval = MPI_Barrier(MPI_COMM_WORLD);
-	      /*
-		fprintf(stderr, "Proc %d BARRIER\n", ProcID);
-	      */
-	      if(mpi_retval != MPI_SUCCESS)
-		{
-		  fprintf(stderr, "Proc %d failed on MPI_BARRIER (%d).\n", ProcID, mpi_retval);
-		  exit(-1);
-		}
-	    }
-
-	  /* Now we move the new particles. */
-	  local_num_to_send = 0;
-	  p = particles_to_do;
-	  particles_to_do = NULL;
-	  while(p)
-	    {
-	      /*
-		fprintf(stderr, "Proc %d is moving a particle.\n", ProcID); fflush(stderr);
-	      */
-	  
-	      p_tmp = p->next;
-
-	      /* This gets complicated as we need to simulate finishing
-	       * one of the particle's little timesteps... */
-	      if(get_element_xi_newton(p->owning_elem_id, p->x, p->xi) == -1)
-		dump1(EXIT, p, "New particle from other processor.");
-	      /*
-		dump(NO_EXIT, p, "Particle to be moved with new p->xi values.");
-	      */
-	  
-	      /* Find the particles that have moved out of their element.
-	       * Some of these have moved completely out of the computational
-	       * domain. */
-	      if(fabs(p->xi[0]) > 1.0 || fabs(p->xi[1]) > 1.0 || fabs(p->xi[2]) > 1.0)
-		{
-#ifdef SHOW_PARTICLE_MOVEMENT
-		  fprintf(stderr, "PA");
-#endif
-		  find_exit_wound(p->owning_elem_id, p, p->x_old, p->x, p->xi, 0, 0);
-		}
-
-	      if(p->state == ACTIVE) /* <= 0 -> it left our processor or hit a wall. */
-		{
-		  /* Save the requested data for output later. */
-		  if(p->output_sample_number != -1)
-		    store_particle_data(p);
-	  
-		  /*
-		    POSSIBLY NOT USED ANYMORE -- FROM CVS DIFF
-		  output_start_ust = ust();
-		  if(TimeIntegration == STEADY)
-		    {
-		      if(p->time == global_end_time)
-			output_a_particle(p, p->old_time, p->time, n, 1, 0);
-		    }
-		  else
-		    output_a_particle(p, p->old_time, p->time, n, (int)(p->time == global_end_time), 0);
-		  output_accum_ust += MAX(ust() - output_start_ust, 0.0);
-		  */
-		  
-		  advance_a_particle(p, global_start_time, global_end_time, n);
-		}
-
-	      if(p->state == PROC_TRANSFER) /* I need to go to yet another processor. */
-		{
-		  add_to_send_list(p);
-		  local_num_to_send++;
-		}
-	      else if(p->state == DEAD) /* Delete me */
-		free(p);	/* Bye bye */
-	      else
-		{
-		  create_a_particle(p, p->owning_elem_id); /* This num_particles++ already */
-		  free(p);
-		}
-	  
-	      p = p_tmp;
-	    }
+	  exchange_transfer_particles(global_start_time, global_end_time, n, &local_num_to_send);
 
 	  num_to_send = 0;
 	  MPI_Allreduce(&local_num_to_send, &num_to_send, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
 	  local_particle_transfers += local_num_to_send;
-	  if(!num_to_send)
-	    done = 1;
+	  done = !num_to_send;
 	}
     }
 #endif
@@ -1658,10 +1536,172 @@ compute_particles(const Exo_DB *exo,	/* mesh */
   if(Particle_Full_Output_Stride)
     fflush(pa_full_fp);
 
+  timer_pop("particles");
   return 0;
 }
 
 
+#ifdef PARALLEL
+/* Carry on with a particle that just arrived from another processor.
+ * This gets complicated as we need to simulate finishing one of the
+ * particle's little timesteps...  It ends up on this processor's
+ * element lists, on the send list again (counted in *num_to_send), or
+ * dead. */
+static void
+finish_transferred_particle(particle_t * p,
+			    const dbl global_start_time,
+			    const dbl global_end_time,
+			    const int n,
+			    int *num_to_send)
+{
+  if(get_element_xi_newton(p->owning_elem_id, p->x, p->xi) == -1)
+    dump1(EXIT, p, "New particle from other processor.");
+
+  /* Find the particles that have moved out of their element.  Some of
+   * these have moved completely out of the computational domain. */
+  if(fabs(p->xi[0]) > 1.0 || fabs(p->xi[1]) > 1.0 || fabs(p->xi[2]) > 1.0)
+    {
+#ifdef SHOW_PARTICLE_MOVEMENT
+      fprintf(stderr, "PA");
+#endif
+      find_exit_wound(p->owning_elem_id, p, p->x_old, p->x, p->xi, 0, 0);
+    }
+
+  if(p->state == ACTIVE) /* <= 0 -> it left our processor or hit a wall. */
+    {
+      /* Save the requested data for output later. */
+      if(p->output_sample_number != -1)
+	store_particle_data(p);
+      advance_a_particle(p, global_start_time, global_end_time, n);
+    }
+
+  if(p->state == PROC_TRANSFER) /* I need to go to yet another processor. */
+    {
+      add_to_send_list(p);
+      (*num_to_send)++;
+    }
+  else if(p->state == DEAD) /* Delete me */
+    free_particle(p);	/* Bye bye */
+  else
+    {
+      create_a_particle(p, p->owning_elem_id); /* This num_particles++ already */
+      free_particle(p);
+    }
+}
+
+
+/* One round of the exchange of particles between processors.  The send
+ * list goes out as one message per destination, the counts having been
+ * swapped first with MPI_Alltoall().  The receives are posted ahead, and
+ * each batch is advanced as soon as it completes, while the others (and
+ * the sends) are still in flight.  Particles are sent with a contiguous
+ * type of one particle_t, so the counts are particles, not bytes.
+ * Returns in *num_to_send how many particles this round put back on the
+ * send list. */
+static void
+exchange_transfer_particles(const dbl global_start_time,
+			    const dbl global_end_time,
+			    const int n,
+			    int *num_to_send)
+{
+  static MPI_Datatype particle_type = MPI_DATATYPE_NULL;
+  int i, k, idx, count;
+  int *send_count, *recv_count, *send_pos;
+  particle_t *p, *p_tmp, *q, *send_buf, **recv_buf;
+  MPI_Request *send_req, *recv_req;
+  MPI_Status mpi_status;
+
+  if(particle_type == MPI_DATATYPE_NULL)
+    {
+      MPI_Type_contiguous((int)sizeof(particle_t), MPI_BYTE, &particle_type);
+      MPI_Type_commit(&particle_type);
+    }
+
+  send_count = (int *)calloc((unsigned)Num_Proc, sizeof(int));
+  recv_count = (int *)calloc((unsigned)Num_Proc, sizeof(int));
+  send_pos = (int *)calloc((unsigned)Num_Proc, sizeof(int));
+  recv_buf = (particle_t **)calloc((unsigned)Num_Proc, sizeof(particle_t *));
+  send_req = (MPI_Request *)malloc(Num_Proc * sizeof(MPI_Request));
+  recv_req = (MPI_Request *)malloc(Num_Proc * sizeof(MPI_Request));
+  if(!send_count || !recv_count || !send_pos || !recv_buf || !send_req || !recv_req)
+    EH(-1, "Could not allocate the particle exchange.");
+
+  count = 0;
+  for(p = particles_to_send; p; p = p->next)
+    {
+      send_count[p->owning_proc_id]++;
+      count++;
+    }
+  MPI_Alltoall(send_count, 1, MPI_INT, recv_count, 1, MPI_INT, MPI_COMM_WORLD);
+
+  for(i = 0; i < Num_Proc; i++)
+    {
+      recv_req[i] = MPI_REQUEST_NULL;
+      if(!recv_count[i])
+	continue;
+      recv_buf[i] = (particle_t *)malloc(recv_count[i] * sizeof(particle_t));
+      if(!recv_buf[i])
+	EH(-1, "Could not allocate space for incoming particles.");
+      MPI_Irecv(recv_buf[i], recv_count[i], particle_type, i, 0, MPI_COMM_WORLD, &recv_req[i]);
+    }
+
+  /* Pack the send list by destination. */
+  send_buf = (particle_t *)malloc(MAX(count, 1) * sizeof(particle_t));
+  if(!send_buf)
+    EH(-1, "Could not allocate space for outgoing particles.");
+  for(k = 0, i = 0; i < Num_Proc; i++)
+    {
+      send_pos[i] = k;
+      k += send_count[i];
+    }
+  for(p = particles_to_send; p; p = p_tmp)
+    {
+      p_tmp = p->next;
+      memcpy(&send_buf[send_pos[p->owning_proc_id]++], p, sizeof(particle_t));
+      free_particle(p);
+    }
+  particles_to_send = NULL;
+
+  for(k = 0, i = 0; i < Num_Proc; i++)
+    {
+      send_req[i] = MPI_REQUEST_NULL;
+      if(send_count[i])
+	MPI_Isend(&send_buf[k], send_count[i], particle_type, i, 0, MPI_COMM_WORLD, &send_req[i]);
+      k += send_count[i];
+    }
+
+  *num_to_send = 0;
+  for(;;)
+    {
+      MPI_Waitany(Num_Proc, recv_req, &idx, &mpi_status);
+      if(idx == MPI_UNDEFINED)
+	break;
+      for(k = 0; k < recv_count[idx]; k++)
+	{
+	  q = new_particle();
+	  memcpy(q, &recv_buf[idx][k], sizeof(particle_t));
+	  q->last = NULL;
+	  q->next = NULL;
+	  q->state = ACTIVE;
+	  finish_transferred_particle(q, global_start_time, global_end_time, n, num_to_send);
+	}
+      free(recv_buf[idx]);
+      recv_buf[idx] = NULL;
+    }
+
+  MPI_Waitall(Num_Proc, send_req, MPI_STATUSES_IGNORE);
+
+  free(send_buf);
+  free(send_count);
+  free(recv_count);
+  free(send_pos);
+  free(recv_buf);
+  free(send_req);
+  free(recv_req);
+}
+#endif
+
+
 /* Fill the element_volume array with the volumes of each elements.
  * This can be called repeatedly (as in it doesn't allocate anything
  * internally).
@@ -1682,6 +1722,7 @@ fill_element_volumes(const int e_begin,
       if(DPI_ptr->elem_owner[i] != ProcID)
 	{
 	  el_volume[i] = 0.0;
+	  el_volume_cdf[i] = total_volume;
 	  continue;
 	}
 #endif
@@ -1710,6 +1751,7 @@ fill_element_volumes(const int e_begin,
 	}
       el_volume[i] = this_volume;
       total_volume += this_volume;
+      el_volume_cdf[i] = total_volume;
     }
   return total_volume;
 }
@@ -2001,6 +2043,117 @@ get_boundary_xi_newton(const dbl * const coeff,
 }
 
 
+/* Hand out space for one particle from the current block, starting a
+ * new block of PARTICLE_BLOCK_SIZE when the free list runs out.  The new
+ * block's particles go on the free list in address order so that
+ * particles created together sit together. */
+static particle_t *
+new_particle(void)
+{
+  particle_block_t *b;
+  particle_t *p;
+  int i;
+
+  if(!particle_free_list)
+    {
+      b = (particle_block_t *)malloc(sizeof(particle_block_t));
+      if(b)
+	b->p = (particle_t *)malloc(PARTICLE_BLOCK_SIZE * sizeof(particle_t));
+      if(!b || !b->p)
+	EH(-1, "Could not allocate a block of particles.");
+      b->next = particle_blocks;
+      particle_blocks = b;
+      for(i = PARTICLE_BLOCK_SIZE - 1; i >= 0; i--)
+	{
+	  b->p[i].next = particle_free_list;
+	  particle_free_list = &(b->p[i]);
+	}
+    }
+  p = particle_free_list;
+  particle_free_list = p->next;
+  return p;
+}
+
+
+/* Give a particle's space back. */
+static void
+free_particle(particle_t * p)
+{
+  p->next = particle_free_list;
+  particle_free_list = p;
+}
+
+
+/* Move every particle into one fresh block, element by element in
+ * element order, and free the old blocks.  After many steps of
+ * creation, death and moves between elements the particles of an
+ * element are scattered over all of the blocks; this puts each
+ * element's list back into consecutive memory for the element loop of
+ * compute_particles().  All particles must be on the element lists
+ * (nothing waiting to be sent), and there must be room for a
+ * second copy of them while this runs. */
+static void
+compact_particle_lists(void)
+{
+  particle_block_t *b, *b_next;
+  particle_t *block, *p, *q;
+  int i, count, size;
+
+  if(particles_to_send)
+    return;
+
+  count = 0;
+  for(i = 0; i < static_exo->num_elems; i++)
+    for(p = element_particle_list_head[i]; p; p = p->next)
+      count++;
+
+  size = count + PARTICLE_BLOCK_SIZE;
+  b = (particle_block_t *)malloc(sizeof(particle_block_t));
+  block = (b) ? (particle_t *)malloc(size * sizeof(particle_t)) : NULL;
+  if(!block)
+    {
+      if(b) free(b);
+      WH(-1, "Not enough memory to compact the particle lists, skipping.");
+      return;
+    }
+
+  count = 0;
+  for(i = 0; i < static_exo->num_elems; i++)
+    {
+      q = NULL;
+      for(p = element_particle_list_head[i]; p; p = p->next)
+	{
+	  memcpy(&block[count], p, sizeof(particle_t));
+	  block[count].last = q;
+	  block[count].next = NULL;
+	  if(q)
+	    q->next = &block[count];
+	  else
+	    element_particle_list_head[i] = &block[count];
+	  q = &block[count++];
+	}
+    }
+
+  for(b_next = particle_blocks; b_next; )
+    {
+      particle_block_t *b_old = b_next;
+      b_next = b_old->next;
+      free(b_old->p);
+      free(b_old);
+    }
+  b->p = block;
+  b->next = NULL;
+  particle_blocks = b;
+
+  particle_free_list = NULL;
+  for(i = size - 1; i >= count; i--)
+    {
+      block[i].next = particle_free_list;
+      particle_free_list = &block[i];
+    }
+}
+
+
 /* Create a new particle_t item in the current particle_head headed
  * link list.  This routine needs an elem_id to properly insert the
  * new particle.  It sets the p->owning_elem_id to this in case you
@@ -2011,25 +2164,17 @@ static particle_t *
 obtain_particle_space(const int elem_id)
 {
   particle_t * p;
-  char s[128];
   
   if(!element_particle_list_head[elem_id])
     {
-      element_particle_list_head[elem_id] = (particle_t *)malloc(sizeof(particle_t));
-      if(!element_particle_list_head[elem_id])
-	{
-	  sprintf(s, "Could not allocate %ld bytes of space for particle.\n", sizeof(particle_t));
-	  EH(-1, s);
-	}
+      element_particle_list_head[elem_id] = new_particle();
       p = element_particle_list_head[elem_id];
       p->last = NULL;
       p->next = NULL;
     }
   else
     {
-      p = (particle_t *)malloc(sizeof(particle_t));
-      if(!p)
-	EH(-1, "Could not allocate space for particle.");
+      p = new_particle();
       p->next = element_particle_list_head[elem_id];
       p->last = NULL;
       element_particle_list_head[elem_id]->last = p;
@@ -2104,19 +2249,30 @@ rejection_sample_a_particle(void)
 {
   particle_t p;
   int i, el_index, rejection, num_element_samples;
-  dbl r, current_volume;
+  int lo, hi, mid;
+  dbl r;
 
   r = drand48() * my_volume;
 
   /* This method of selecting an element to introduce a particle is
    * very sensitive to the DPI_ptr->elem_owner[i] array.  el_volume[i]
    * = 0 if that element is not owned by this processor, so don't try
-   * to create a particle there! */
-  el_index = 0;
-  current_volume = 0.0;
-  while(current_volume < r)
-    current_volume += el_volume[el_index++];
-  el_index--;
+   * to create a particle there!  The first element whose running
+   * volume passes r is found by bisection, which never lands on one
+   * of those, short of r rounding up to my_volume. */
+  lo = 0;
+  hi = static_exo->eb_ptr[static_exo->num_elem_blocks] - 1;
+  while(lo < hi)
+    {
+      mid = (lo + hi) / 2;
+      if(el_volume_cdf[mid] <= r)
+	lo = mid + 1;
+      else
+	hi = mid;
+    }
+  el_index = lo;
+  while(el_index > 0 && el_volume[el_index] == 0.0)
+    el_index--;
   
   /* return value is currently ignored... */
   zero_a_particle(&p);
@@ -3163,9 +3319,27 @@ get_element_xi_newton(const int elem_id,
 static dbl
 get_element_minimum_side_length(const int elem_id)
 {
-  int edge_id;
+  int edge_id, e, mn;
   dbl len = 1.0e+10;
 
+  /* Without mesh motion the lengths only need computing once. */
+  if(!el_min_side_length)
+    {
+      for(mn = 0; mn < upd->Num_Mat; mn++)
+	if(pd_glob[mn]->e[R_MESH1])
+	  break;
+      if(mn == upd->Num_Mat)
+	{
+	  el_min_side_length = (dbl *)malloc(static_exo->num_elems * sizeof(dbl));
+	  if(!el_min_side_length)
+	    EH(-1, "Could not allocate element side lengths.");
+	  for(e = 0; e < static_exo->num_elems; e++)
+	    el_min_side_length[e] = -1.0;
+	}
+    }
+  if(el_min_side_length && el_min_side_length[elem_id] >= 0.0)
+    return el_min_side_length[elem_id];
+
   load_element_node_coordinates(elem_id);
   if(mdim == 2)
     {
@@ -3187,6 +3361,8 @@ get_element_minimum_side_length(const int elem_id)
       len = MIN(len, my_distance(&(node_coord[5][0]), &(node_coord[6][0]), mdim));
       len = MIN(len, my_distance(&(node_coord[6][0]), &(node_coord[7][0]), mdim));
     }
+  if(el_min_side_length)
+    el_min_side_length[elem_id] = len;
   return len;
 }
 			    
@@ -3239,6 +3415,95 @@ output_TECPLOT_zone_info(const dbl end_time,
 }
 
 
+/* This routine starts a BINARY sample file.  The file is a header
+ * followed by fixed width records, one per particle output, so it can
+ * be read (or mmap'ed) as an array without any parsing:
+ *
+ *   char magic[8]            "GOMAPART"
+ *   int  version             1
+ *   int  pdim                coordinates per record
+ *   int  nvars               output variables per record
+ *   int  has_proc            1 if each record ends with the processor
+ *   int  record_length       doubles per record
+ *   char names[nvars][MAX_PARTICLE_OUTPUT_VARIABLE_LENGTH]
+ *
+ * and then records of record_length doubles (native byte order): the
+ * coordinates, the time, the output variables and the processor id.
+ * Every processor writes its own file, as for the text formats, and
+ * through one large stdio buffer.
+ */
+static void
+output_BINARY_header(const int sample)
+{
+  int header[5];
+  int nvars = Particle_Number_Output_Variables[sample];
+
+  if(setvbuf(pa_fp[sample], NULL, _IOFBF, PARTICLE_BINARY_BUFFER_SIZE))
+    WH(-1, "Could not enlarge the buffer of a BINARY particle file.");
+
+  header[0] = 1;
+  header[1] = pdim;
+  header[2] = nvars;
+#ifdef PARALLEL
+  header[3] = 1;
+#else
+  header[3] = 0;
+#endif
+  header[4] = pdim + 1 + nvars + header[3];
+
+  if(fwrite("GOMAPART", sizeof(char), 8, pa_fp[sample]) != 8 ||
+     fwrite(header, sizeof(int), 5, pa_fp[sample]) != 5 ||
+     (nvars > 0 &&
+      fwrite(Particle_Output_Variables[sample], sizeof(particle_variable_s),
+	     nvars, pa_fp[sample]) != (size_t)nvars))
+    EH(-1, "Could not write the header of a BINARY particle file.");
+}
+
+
+/* This routine writes one record of a sample file: the coordinates x,
+ * the time, the output variables data and, in parallel, the processor.
+ * The text records of strided output keep their wider coordinate
+ * columns.
+ */
+static void
+output_sample_record(const int sample,
+		     const int strided,
+		     const dbl *x,
+		     const dbl time,
+		     const dbl *data,
+		     const int proc)
+{
+  int i, n = 0;
+  int nvars = Particle_Number_Output_Variables[sample];
+  dbl record[DIM + 2 + MAX_DATA_REAL_VALUES];
+
+  if(Particle_Output_Format == BINARY)
+    {
+      for(i = 0; i < pdim; i++)
+	record[n++] = x[i];
+      record[n++] = time;
+      for(i = 0; i < nvars; i++)
+	record[n++] = data[i];
+#ifdef PARALLEL
+      record[n++] = (dbl)proc;
+#endif
+      if(fwrite(record, sizeof(dbl), n, pa_fp[sample]) != (size_t)n)
+	EH(-1, "Could not write to a BINARY particle file.");
+      return;
+    }
+
+  for(i = 0; i < pdim; i++)
+    fprintf(pa_fp[sample], strided ? " %12g " : " %12g", x[i]);
+  fprintf(pa_fp[sample], " %12g", time);
+  for(i = 0; i < nvars; i++)
+    fprintf(pa_fp[sample], " %12g", data[i]);
+#ifdef PARALLEL
+  fprintf(pa_fp[sample], " %d", proc);
+#endif
+  fprintf(pa_fp[sample], "\n");
+}
+
+
 /* This routine handles quite a lot.  There are two basic kinds of
  * output to be performed: stride-based, and time-based.  For
  * stride-based, the Goma successful timestep needs to be known.  For
@@ -3267,7 +3532,12 @@ output_a_particle(particle_t * const p,
   int output_n, start_n, end_n;
   int strided_output, last_goma_step;
   dbl time_fraction, output_time;
-  dbl x_time[DIM], real_data_time;
+  dbl x_time[DIM], real_data_time[MAX_DATA_REAL_VALUES];
+#ifdef PARALLEL
+  const int proc = p->owning_proc_id;
+#else
+  const int proc = ProcID;
+#endif
 
   
   /* The nice thing about strided output is that there is no
@@ -3279,17 +3549,8 @@ output_a_particle(particle_t * const p,
 	 && last_step)
 	{
 	  if((output_sample_number = p->output_sample_number) != -1)
-	    {
-	      for(i = 0; i < pdim; i++)
-		fprintf(pa_fp[output_sample_number], " %12g ", p->x_old[i]);
-	      fprintf(pa_fp[output_sample_number], " %12g", particle_time);
-	      for(i = 0; i < Particle_Number_Output_Variables[output_sample_number]; i++)
-		fprintf(pa_fp[output_sample_number], " %12g", p->real_data[i]);
-#ifdef PARALLEL
-	      fprintf(pa_fp[output_sample_number], " %d", p->owning_proc_id);
-#endif
-	      fprintf(pa_fp[output_sample_number], "\n");
-	    }
+	    output_sample_record(output_sample_number, TRUE, p->x_old, particle_time,
+				 p->real_data, proc);
 	}
     }
   else if((output_sample_number = p->output_sample_number) != -1 ||
@@ -3318,18 +3579,10 @@ output_a_particle(particle_t * const p,
 	    x_time[i] = (1.0-time_fraction) * p->x_old[i] + time_fraction * p->x[i]; 
 	  if(output_sample_number != -1)
 	    {
-	      for(i = 0; i < pdim; i++)
-		fprintf(pa_fp[output_sample_number], " %12g", x_time[i]);
-	      fprintf(pa_fp[output_sample_number], " %12g", output_time);
 	      for(i = 0; i < Particle_Number_Output_Variables[output_sample_number]; i++)
-		{
-		  real_data_time = (1.0-time_fraction) * p->real_data_old[i] + time_fraction * p->real_data[i];
-		  fprintf(pa_fp[output_sample_number], " %12g", real_data_time);
-		}
-#ifdef PARALLEL
-	      fprintf(pa_fp[output_sample_number], " %d", p->owning_proc_id);
-#endif
-	      fprintf(pa_fp[output_sample_number], "\n");
+		real_data_time[i] = (1.0-time_fraction) * p->real_data_old[i] + time_fraction * p->real_data[i];
+	      output_sample_record(output_sample_number, FALSE, x_time, output_time,
+				   real_data_time, proc);
 	    }
 	}
     }
@@ -4916,232 +5169,182 @@ add_to_send_list(particle_t * p)
 }
 
 
-/* This routine moves a particle to the incoming list.  Space needs to
- * be allocated, too. */
-static void
-add_to_do_list(particle_t * p)
-{
-  particle_t * p_recv;
-
-  if(!particles_to_do)
-    {
-      particles_to_do = (particle_t *)malloc(sizeof(particle_t));
-      if(!particles_to_do)
-	EH(-1, "Could not malloc particle space.");
-      p_recv = particles_to_do;
-      memcpy(p_recv, p, sizeof(particle_t));
-      p_recv->last = NULL;
-      p_recv->next = NULL;
-    }
-  else
-    {
-      p_recv = (particle_t *)malloc(sizeof(particle_t));
-      if(!p_recv)
-	EH(-1, "Could not malloc particle space.");
-      memcpy(p_recv, p, sizeof(particle_t));
-      particles_to_do->last = p_recv;
-      p_recv->next = particles_to_do;
-      particles_to_do = p_recv;
-      p_recv->last = NULL;
-    }
-  p_recv->state = ACTIVE;
-}
-
-
 /* This routine handles whatever needs to be saved off, etc., to
  * influence the continuum solution with repsect to the particles'
  * presence.  It assumes that all particles contribute (irresepective
- * of possible p->state settings). */
+ * of possible p->state settings).
+ *
+ * The particles of an element are deposited in one pass into a
+ * per-element accumulator, which is then added to the element's
+ * source_term.  Elements that are ghosted on other processors send
+ * that accumulated source, not their particles, so the communication
+ * scales with the number of boundary elements holding particles. */
+#define GHOST_SOURCE_LEN (MDE + 2) /* local elem id there, sum of phi, source[MDE] */
 static void
 couple_to_continuum()
 {
-  dbl source_mass = 0.0, total_particles = 0.0;
-  int source_eqn = -1;
+  dbl source_mass = 0.0, total_particles = 0.0, elem_weight;
+  dbl elem_source[MDE];
+  int source_eqn = -1, use_ghost_sources;
   int i, j;
   particle_t *p;
 
 #ifdef PARALLEL
-  double temp_ust, local_total_particles;
-  int recipient_proc, recipient_local_elem_id, local_num_particle_ghosts, use_ghost_particles;
-  int *num_particles_in_elem, *num_ghost_particles_to_send, *num_ghost_particles_to_recv, *num_ghost_particles_copied;
-  particle_t *p_tmp, **ghost_particles_to_send, *ghost_particles_to_recv;
+  int k;
+  double temp_ust, local_total_particles, *rec;
+  int local_num_particle_ghosts, recipient_proc;
+  int *num_ghost_sources_to_send, *num_ghost_sources_to_recv, *num_ghost_sources_copied;
+  dbl **ghost_sources_to_send, *ghost_sources_to_recv;
   MPI_Status mpi_status;
+#endif
 
-  use_ghost_particles = (Particle_Model == SWIMMER_EXPLICIT ||
-			 Particle_Model == SWIMMER_IMPLICIT);
+  use_ghost_sources = (Particle_Model == SWIMMER_EXPLICIT ||
+		       Particle_Model == SWIMMER_IMPLICIT);
 
-  /* Testing to see if we really do need to ghost particles, or if
-   * they already get summed properly in the source terms now,
-   * anyways.  After thinking about it I think that they might
-   * actually get summed properly, already!. */
-  use_ghost_particles = 1;
+  /* Model-specific initializations. */
+  if(use_ghost_sources)
+    {
+      source_eqn = R_MOMENTUM1 + pdim - 1;
+      if(mp->DensityModel != CONSTANT)
+	EH(-1, "Sorry, only handling CONSTANT density models right now.  Check back later.");
+      source_mass = 4.0/3.0 * M_PIE  * (Particle_Density - mp->density) * Particle_Radius * Particle_Radius * Particle_Radius * Particle_Ratio;
+    }
 
+#ifdef PARALLEL
   local_num_particle_ghosts = 0;
+  num_ghost_sources_to_send = (int *)calloc((unsigned)Num_Proc, sizeof(int));
+  num_ghost_sources_to_recv = (int *)calloc((unsigned)Num_Proc, sizeof(int));
+  num_ghost_sources_copied = (int *)calloc((unsigned)Num_Proc, sizeof(int));
+  ghost_sources_to_send = (dbl **)calloc((unsigned)Num_Proc, sizeof(dbl *));
 
-  if(use_ghost_particles)
-    {
-      /* Exchange ghost particles first! */
-      num_ghost_particles_to_send = (int *)calloc((unsigned)Num_Proc, sizeof(int));
-      num_ghost_particles_to_recv = (int *)calloc((unsigned)Num_Proc, sizeof(int));
-      ghost_particles_to_send = (particle_t **)calloc((unsigned)Num_Proc, sizeof(particle_t *));
-      num_particles_in_elem = (int *)calloc((unsigned)(static_exo->num_elems), sizeof(int));
-      num_ghost_particles_copied = (int *)calloc((unsigned)Num_Proc, sizeof(int));
- 
-      /* I should introduce a level of indirection into
-       * element_particle_info[i].ghost_proc[] if I want to speed things
-       * up.  I think it doesn't matter, really... */
-
-      /* First count the number of particles currently in each of the
-       * to-be-ghosted elements. */
-      for(i = 0; i < static_exo->num_elems; i++)
-	if(element_particle_info[i].num_ghost_target_elems)
-	  for(p = element_particle_list_head[i]; p; p = p->next)
-	    num_particles_in_elem[i]++;
-
-      /* Now count the number of particles going to each of the other
-       * processors. */
-      for(i = 0; i < static_exo->num_elems; i++)
+  /* Count the occupied to-be-ghosted elements going to each of the
+   * other processors, and the particles they stand in for. */
+  for(i = 0; i < static_exo->num_elems; i++)
+    if(element_particle_info[i].num_ghost_target_elems && element_particle_list_head[i])
+      {
+	k = 0;
+	for(p = element_particle_list_head[i]; p; p = p->next)
+	  k++;
 	for(j = 0; j < element_particle_info[i].num_ghost_target_elems; j++)
-	  num_ghost_particles_to_send[element_particle_info[i].ghost_proc[j]] += num_particles_in_elem[i];
-      for(i = 0; i < Num_Proc; i++)
-	local_num_particle_ghosts += num_ghost_particles_to_send[i];
+	  {
+	    num_ghost_sources_to_send[element_particle_info[i].ghost_proc[j]]++;
+	    local_num_particle_ghosts += k;
+	  }
+      }
 
-      /* Allocate the space for the outgoing particles. */
-      for(i = 0; i < Num_Proc; i++)
-	if(num_ghost_particles_to_send[i])
-	  ghost_particles_to_send[i] = (particle_t *)calloc((unsigned)num_ghost_particles_to_send[i], sizeof(particle_t));
-	else
-	  ghost_particles_to_send[i] = NULL;
-      
-      /* Now memcpy the particle info into the send buffer.  Set the
-       * owning element id, too! */
-      for(i = 0; i < static_exo->num_elems; i++)
-	if(element_particle_info[i].num_ghost_target_elems)
-	  for(p = element_particle_list_head[i]; p; p = p->next)
-	    for(j = 0; j < element_particle_info[i].num_ghost_target_elems; j++)
+  if(use_ghost_sources)
+    for(i = 0; i < Num_Proc; i++)
+      if(num_ghost_sources_to_send[i])
+	ghost_sources_to_send[i] = (dbl *)calloc((unsigned)(num_ghost_sources_to_send[i] * GHOST_SOURCE_LEN), sizeof(dbl));
+#endif
+
+  if(use_ghost_sources)
+    for(i = 0; i < static_exo->num_elems; i++)
+      {
+	if(!element_particle_list_head[i])
+	  continue;
+
+	memset(elem_source, 0, MDE * sizeof(dbl));
+	elem_weight = 0.0;
+	for(p = element_particle_list_head[i]; p; p = p->next)
+	  {
+	    load_field_variables_at_xi(i, p->xi);
+
+	    if(p->owning_elem_id != i)
 	      {
-		recipient_proc = element_particle_info[i].ghost_proc[j];
-		recipient_local_elem_id = element_particle_info[i].ghost_local_elem_id[j];
-		memcpy(&ghost_particles_to_send[recipient_proc][num_ghost_particles_copied[recipient_proc]], p, sizeof(particle_t));
-		ghost_particles_to_send[recipient_proc][num_ghost_particles_copied[recipient_proc]].owning_elem_id = recipient_local_elem_id;
-		num_ghost_particles_copied[recipient_proc]++;
+		fprintf(stderr, "PROC%d: UH-OH, THEY ARE NOT EQUAL!\n", ProcID);
+		fprintf(stderr, "PROC%d: \t\ti = %d, particle->owning_elem_id = %d\n", ProcID, i, p->owning_elem_id);
+		fprintf(stderr, "PROC%d: \t\tstate = %d\n", ProcID, p->state);
 	      }
 
-      /* Now we round-robin the information about... */
+	    for(j = 0; j < ei->dof[source_eqn]; j++)
+	      {
+		elem_source[j] += bf[source_eqn]->phi[j];
+		elem_weight += bf[source_eqn]->phi[j];
+	      }
+	  }
+
+	for(j = 0; j < MDE; j++)
+	  {
+	    elem_source[j] *= source_mass;
+	    element_particle_info[i].source_term[j] += elem_source[j];
+	  }
+	total_particles += elem_weight;
+
+#ifdef PARALLEL
+	/* Pack the element's source for the processors that ghost it. */
+	for(k = 0; k < element_particle_info[i].num_ghost_target_elems; k++)
+	  {
+	    recipient_proc = element_particle_info[i].ghost_proc[k];
+	    rec = &ghost_sources_to_send[recipient_proc][num_ghost_sources_copied[recipient_proc]++ * GHOST_SOURCE_LEN];
+	    rec[0] = (dbl)element_particle_info[i].ghost_local_elem_id[k];
+	    rec[1] = elem_weight;
+	    memcpy(&rec[2], elem_source, MDE * sizeof(dbl));
+	  }
+#endif
+      }
+
+#ifdef PARALLEL
+  if(use_ghost_sources)
+    {
+      /* Now we round-robin the accumulated element sources. */
       for(i = 0; i < Num_Proc; i++)
 	{
 	  if(i == ProcID)
 	    {
 	      temp_ust = ust();
-	      MPI_Bcast(num_ghost_particles_to_send, Num_Proc, MPI_INT, i, MPI_COMM_WORLD);
+	      MPI_Bcast(num_ghost_sources_to_send, Num_Proc, MPI_INT, i, MPI_COMM_WORLD);
 	      for(j = 0; j < Num_Proc; j++)
-		if(i != j && num_ghost_particles_to_send[j])
-		  MPI_Send(&ghost_particles_to_send[j][0], num_ghost_particles_to_send[j] * sizeof(particle_t), MPI_BYTE, j, 0, MPI_COMM_WORLD);
-	
+		if(i != j && num_ghost_sources_to_send[j])
+		  MPI_Send(ghost_sources_to_send[j], num_ghost_sources_to_send[j] * GHOST_SOURCE_LEN, MPI_DOUBLE, j, 0, MPI_COMM_WORLD);
 	      communication_accum_ust += MAX(ust() - temp_ust, 0.0);
 	    }
 	  else
 	    {
 	      temp_ust = ust();
-	      MPI_Bcast(num_ghost_particles_to_recv, Num_Proc, MPI_INT, i, MPI_COMM_WORLD);
+	      MPI_Bcast(num_ghost_sources_to_recv, Num_Proc, MPI_INT, i, MPI_COMM_WORLD);
 	      communication_accum_ust += MAX(ust() - temp_ust, 0.0);
-	      if(num_ghost_particles_to_recv[ProcID])
+	      if(num_ghost_sources_to_recv[ProcID])
 		{
-		  ghost_particles_to_recv = (particle_t *)calloc((unsigned)num_ghost_particles_to_recv[ProcID], sizeof(particle_t));
+		  ghost_sources_to_recv = (dbl *)calloc((unsigned)(num_ghost_sources_to_recv[ProcID] * GHOST_SOURCE_LEN), sizeof(dbl));
 		  temp_ust = ust();
-		  MPI_Recv(ghost_particles_to_recv, num_ghost_particles_to_recv[ProcID] * sizeof(particle_t), MPI_BYTE, i, 0, MPI_COMM_WORLD, &mpi_status);
+		  MPI_Recv(ghost_sources_to_recv, num_ghost_sources_to_recv[ProcID] * GHOST_SOURCE_LEN, MPI_DOUBLE, i, 0, MPI_COMM_WORLD, &mpi_status);
 		  communication_accum_ust += MAX(ust() - temp_ust, 0.0);
-		  for(j = 0; j < num_ghost_particles_to_recv[ProcID]; j++)
+		  for(j = 0; j < num_ghost_sources_to_recv[ProcID]; j++)
 		    {
-		      ghost_particles_to_recv[j].state = GHOST;
-		      p = create_a_particle(&ghost_particles_to_recv[j], ghost_particles_to_recv[j].owning_elem_id);
-		      num_particles--; /* Don't count these as new particles, they are counted as ghosts. */
+		      rec = &ghost_sources_to_recv[j * GHOST_SOURCE_LEN];
+		      for(k = 0; k < MDE; k++)
+			element_particle_info[(int)rec[0]].source_term[k] += rec[2 + k];
+		      total_particles += rec[1];
 		    }
-		  free(ghost_particles_to_recv);
+		  free(ghost_sources_to_recv);
 		}
 	    }
 	  MPI_Barrier(MPI_COMM_WORLD);
 	}
     }
-  
+
   total_num_particle_ghosts = 0;
   MPI_Reduce(&local_num_particle_ghosts, &total_num_particle_ghosts, 1, MPI_INT, MPI_SUM, 0, MPI_COMM_WORLD);
-#endif
-  
-  /* Model-specific initializations. */
-  if(Particle_Model == SWIMMER_EXPLICIT ||
-     Particle_Model == SWIMMER_IMPLICIT)
-    {
-      source_eqn = R_MOMENTUM1 + pdim - 1;
-      if(mp->DensityModel != CONSTANT)
-	EH(-1, "Sorry, only handling CONSTANT density models right now.  Check back later.");
-      source_mass = 4.0/3.0 * M_PIE  * (Particle_Density - mp->density) * Particle_Radius * Particle_Radius * Particle_Radius * Particle_Ratio;
-    }
 
-  for(i = 0; i < static_exo->num_elems; i++)
-    {
-      for(p = element_particle_list_head[i]; p; p = p->next)
-	{
-	  if(Particle_Model == SWIMMER_EXPLICIT ||
-	     Particle_Model == SWIMMER_IMPLICIT)
-	    {
-	      load_field_variables_at_xi(i, p->xi);
-		  
-	      if(p->owning_elem_id != i)
-		{
-		  fprintf(stderr, "PROC%d: UH-OH, THEY ARE NOT EQUAL!\n", ProcID);
-		  fprintf(stderr, "PROC%d: \t\ti = %d, particle->owning_elem_id = %d\n", ProcID, i, p->owning_elem_id);
-		  fprintf(stderr, "PROC%d: \t\tstate = %d\n", ProcID, p->state);
-		}
-
-	      for(j = 0; j < ei->dof[source_eqn]; j++)
-		{
-		  element_particle_info[p->owning_elem_id].source_term[j] += source_mass * bf[source_eqn]->phi[j];
-		  total_particles += bf[source_eqn]->phi[j];
-		}
-	    }
-	}
-    }
-
-#ifdef PARALLEL
   local_total_particles = total_particles;
   MPI_Reduce(&local_total_particles, &total_particles, 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
-#endif
 
-#ifdef PARALLEL
   /*
   if(ProcID == 0)
     fprintf(stderr, "    (TOTAL PARTICLES (+GHOSTS) = %g)\n", total_particles);
   */
-    
-  if(use_ghost_particles)
-    {
-      /* Currently there is no need to keep the ghost particles around,
-       * but there might be one day... */
-      for(i = 0; i < static_exo->num_elems; i++)
-	{
-	  p = element_particle_list_head[i];
-	  while(p)
-	    {
-	      p_tmp = p->next;
-	      if(p->state == GHOST)
-		{
-		  remove_from_element_particle_list(p, i);
-		  free(p);
-		}
-	      p = p_tmp;
-	    }
-	}
-      for(i = 0; i < Num_Proc; i++)
-	if(ghost_particles_to_send[i])
-	  free(ghost_particles_to_send[i]);
-      free(num_ghost_particles_to_send);
-      free(num_ghost_particles_to_recv);
-      free(num_ghost_particles_copied);
-      free(ghost_particles_to_send);
-    }
+
+  for(i = 0; i < Num_Proc; i++)
+    if(ghost_sources_to_send[i])
+      free(ghost_sources_to_send[i]);
+  free(num_ghost_sources_to_send);
+  free(num_ghost_sources_to_recv);
+  free(num_ghost_sources_copied);
+  free(ghost_sources_to_send);
 #endif
 }
+#undef GHOST_SOURCE_LEN
 
 /*
  * This routine is used to test the integrity of the element<->element
@@ -46,6 +46,46 @@ int LSA_3D_of_2D_pass = 0;
 dbl LSA_3D_of_2D_wave_number = -1.0;
 int LSA_number_wave_numbers = 0;
 dbl *LSA_wave_numbers = NULL;
+int LSA_wave_number_interpolation = FALSE;
+
+/* Every Jacobian and mass matrix entry of the 3D of 2D problem is a
+ * product of a weight function piece and a basis function piece, and
+ * modify_basis_and_weight_functions_for_LSA_3D_of_2D() makes each of
+ * those either independent of the wave number N or proportional to it.
+ * So the matrices are quadratics in N, and three (nonzero, distinct)
+ * wave numbers give them for all of the others.
+ *
+ * wave_number_fit() turns the matrices f[0..2] at N[0..2] into their
+ * divided differences, in place; wave_number_eval() then evaluates the
+ * quadratic at wn into out. */
+static void
+wave_number_fit(dbl *f[3],
+		const dbl N[3],
+		const int n)
+{
+  int i;
+  dbl d01;
+
+  for(i = 0; i < n; i++)
+    {
+      d01 = (f[1][i] - f[0][i]) / (N[1] - N[0]);
+      f[2][i] = ((f[2][i] - f[1][i]) / (N[2] - N[1]) - d01) / (N[2] - N[0]);
+      f[1][i] = d01;
+    }
+}
+
+static void
+wave_number_eval(dbl *f[3],
+		 const dbl N[3],
+		 const dbl wn,
+		 dbl *out,
+		 const int n)
+{
+  int i;
+
+  for(i = 0; i < n; i++)
+    out[i] = f[0][i] + (wn - N[0]) * (f[1][i] + (wn - N[1]) * f[2][i]);
+}
 
 /* Calculate matrices needed for stability analysis
  * and solve for spectrum is required.
@@ -163,6 +203,7 @@ int solve_full_stability_problem(struct Aztec_Linear_Solver_System *ams,
   double *jacobian_matrix;
   double *mass_matrix, *mass_matrix_tmpA, *mass_matrix_tmpB;
   int *ija = ams->bindx;	/* This structure is the same for ALL matrices... */
+  EGG_MASS mass;
 
   /* Initialize... */
   zero = calloc(NumUnknowns, sizeof(double));
@@ -355,12 +396,21 @@ int solve_full_stability_problem(struct Aztec_Linear_Solver_System *ams,
 	  dstuff[i] = -1.0;
 	}
       eggroll_init(NumUnknowns, NZeros, &istuff[0], &dstuff[0]);
+
+      /* eggroll only needs the nonzeros of B, so the full pattern copy
+       * goes before the solver allocates its own */
+      egg_mass_compress(NumUnknowns, ija, mass_matrix, &mass);
+      free(mass_matrix);
+      mass_matrix = NULL;
+      DPRINTF(stdout, "Mass matrix: %d of %d entries nonzero\n", mass.nnz,
+	      NZeros+1);
       
       /* Call eggroll solver */
-      eggrollwrap(istuff, dstuff, ija, jacobian_matrix, mass_matrix, x, ExoFileOut, ProblemType,
+      eggrollwrap(istuff, dstuff, ija, jacobian_matrix, &mass, x, ExoFileOut, ProblemType,
                   delta_t, theta, x_old, xdot, xdot_old, resid_vector, converged, nprint, tnv,
                   tnv_post, tev, tev_post, rd, gindex, p_gsize, gvec, gvec_elem, time_value, exo,
                   Num_Proc, dpi);
+      egg_mass_free(&mass);
     }
       
   /* Free space, and return ams->val to what it was when we came
@@ -424,6 +474,10 @@ int solve_3D_of_2D_stability_problem(struct Aztec_Linear_Solver_System *ams,
   int **e_save;
   dbl ***etm_save;
 
+  int k, use_fit, store_sample, num_samples = 0;
+  dbl N_sample[3], *J_sample[3], *M_sample[3];
+  EGG_MASS mass;
+
   /* Initialize... */
   zero = calloc(NumUnknowns, sizeof(double));
   init_vec_value(&zero[0], 0.0, NumUnknowns);
@@ -431,6 +485,25 @@ int solve_3D_of_2D_stability_problem(struct Aztec_Linear_Solver_System *ams,
   scale = calloc(NumUnknowns, sizeof(double));
   init_vec_value(scale, 0.0, NumUnknowns);
 
+  /* With more than three wave numbers, the matrices of the rest can be
+   * had from those of the first three distinct ones. */
+  use_fit = LSA_wave_number_interpolation && !LSA_COMPARE &&
+    LSA_number_wave_numbers > 3;
+  for(k = 0; k < 3; k++)
+    {
+      J_sample[k] = M_sample[k] = NULL;
+      if(use_fit)
+	{
+	  J_sample[k] = calloc((NZeros+5), sizeof(double));
+	  M_sample[k] = calloc((NZeros+5), sizeof(double));
+	  if(J_sample[k] == NULL || M_sample[k] == NULL)
+	    {
+	      WH(-1, "No room for the Eigen Wave Number Interpolation samples");
+	      use_fit = FALSE;
+	    }
+	}
+    }
+
   mass_matrix = mass_matrix_1 = mass_matrix_2 = mass_matrix_1_tmpA =
     mass_matrix_1_tmpB = mass_matrix_2_tmpA = mass_matrix_2_tmpB =
     NULL;
@@ -474,225 +547,258 @@ int solve_3D_of_2D_stability_problem(struct Aztec_Linear_Solver_System *ams,
       LSA_3D_of_2D_wave_number = LSA_wave_numbers[wn];
       printf("Solving for wave number %d out of %d.  WAVE NUMBER = %g\n", wn
 	     + 1, LSA_number_wave_numbers, LSA_3D_of_2D_wave_number); 
-      
-      /* Get the original pd_glob[mn]->e[i] and pd_glob[mn]->etm[i][*] 
-       * values back. */
-      TimeIntegration = STEADY;
-      theta = 0.0;
-      for(mn = 0; mn < upd->Num_Mat; mn++)
-	for(i = 0; i < MAX_EQNS; i++)
-	  {
-	    pd_glob[mn]->TimeIntegration = STEADY;
-	    pd_glob[mn]->e[i] = e_save[mn][i];
-	    for(j = 0; j < MAX_TERM_TYPES; j++)
-	      pd_glob[mn]->etm[i][j] = etm_save[mn][i][j];
-	  }
-      
-      /* Jacobian matrix, pass 1 */
-      printf("Assembling J (pass 1)...\n");
-      LSA_3D_of_2D_pass = 1;
-      ams->val = jacobian_matrix_1;
-      init_vec_value(&jacobian_matrix_1[0], 0.0, (NZeros+1));
-      af->Assemble_Residual = TRUE;
-      af->Assemble_Jacobian = TRUE;
-      af->Assemble_LSA_Jacobian_Matrix = TRUE;
-      af->Assemble_LSA_Mass_Matrix = FALSE;
-      
-      matrix_fill_full(ams, x, resid_vector, 
-		       x_old, x_older, xdot, xdot_old, x_update,
-		       &delta_t, &theta, First_Elem_Side_BC_Array, 
-		       &time_value, exo, dpi, 
-		       &num_total_nodes, &zero[0], &zero[0], NULL);
-
-      /* Jacobian matrix, pass 2 */
-      printf("Assembling J (pass 2)...\n");
-      LSA_3D_of_2D_pass = 2;
-      ams->val = jacobian_matrix_2;
-      init_vec_value(&jacobian_matrix_2[0], 0.0, (NZeros+1));
-      af->Assemble_Residual = TRUE;
-      af->Assemble_Jacobian = TRUE;
-      af->Assemble_LSA_Jacobian_Matrix = TRUE;
-      af->Assemble_LSA_Mass_Matrix = FALSE;
-      
-      matrix_fill_full(ams, x, resid_vector, 
-		       x_old, x_older, xdot, xdot_old, x_update,
-		       &delta_t, &theta, 
-		       First_Elem_Side_BC_Array, 
-		       &time_value, exo, dpi, 
-		       &num_total_nodes, &zero[0], &zero[0], NULL);
 
-      /* Add the two passes together to get the "real" Jacobian
-       * matrix. */
-      for(i = 0; i < NZeros+1; i++)
-	jacobian_matrix[i] = jacobian_matrix_1[i] +
-	  jacobian_matrix_2[i];
-
-      /* This call will fill in scale[] with the proper row scales.  I
-       * need to get this in terms of the Jacobian, and the apply it to
-       * the "mass" matrix, later... */
-      ams->val = jacobian_matrix;
-      row_sum_scaling_scale(ams, resid_vector, scale);
-
-      /* Now compute the mass matrix.  This is more complicated than
-       * it seems if we want to perform a comparison with the
-       * Subtractionism method.  There are, in fact, three different
-       * matrices with which we could compare along the way: mass
-       * matrix from pass 1, mass matrix from pass 2, and final
-       * (Additionism?) mass matrix.  I will construct comparisons
-       * for all three...
-       *
-       * There is an order restriction.  We cannot recover the
-       * pd_glob[mn]->e[i] (and pd_glob[mn]->etm[i][*]) values AFTER
-       * we compute the mass matrix with my method, because we set
-       * everything to 0 except the T_MASS-ish terms.  So we should
-       * compute all of the Subtractionism matrices,
-       * mass_matrix_[1,2]_tmp[A,b], first.  Then compute the two
-       * mass_matrix_[1,2] passes.  Since we save the pd_glob[mn]
-       * structures to reset things over multiple wave number
-       * computations, we could refer to the saved values to remove
-       * this restriction, but there's less code this way... */
-
-      /* theta = 0 makes the method implicit, so that we get the
-       * var_{}^{n+1} coefficient.  We want this for ALL mass matrix
-       * computations, but not for the jacobian computations (they
-       * should have the mass etm = 0, so it wouldn't matter...). */
-      theta = 0.0;
+      store_sample = use_fit && num_samples < 3;
+      for(k = 0; k < num_samples && store_sample; k++)
+	if(N_sample[k] == LSA_3D_of_2D_wave_number)
+	  store_sample = FALSE;
 
-      TimeIntegration = TRANSIENT;
-      for(mn = 0; mn < upd->Num_Mat; mn++) 
+      if(use_fit && num_samples == 3)
 	{
-	  pd_glob[mn]->TimeIntegration = TRANSIENT;
-	  for(i = 0; i < MAX_EQNS; i++)
-	    if(pd_glob[mn]->e[i])
-	      {
-		pd_glob[mn]->e[i] |= T_MASS;
-		pd_glob[mn]->etm[i][LOG2_MASS] = 1.0;
-	      }
+	  printf("Interpolating J and B in the wave number...\n");
+	  wave_number_eval(J_sample, N_sample, LSA_3D_of_2D_wave_number,
+			   jacobian_matrix, NZeros+1);
+	  wave_number_eval(M_sample, N_sample, LSA_3D_of_2D_wave_number,
+			   mass_matrix, NZeros+1);
+	  ams->val = jacobian_matrix;
+	  row_sum_scaling_scale(ams, resid_vector, scale);
 	}
-
-      /* Subtractionism method for mass matrix, passes 1 and 2. */
-      if(LSA_COMPARE)
+      else
 	{
-	  init_vec_value(&mass_matrix_1_tmpA[0], 0.0, (NZeros+1));
-	  init_vec_value(&mass_matrix_1_tmpB[0], 0.0, (NZeros+1));
-	  init_vec_value(&mass_matrix_2_tmpA[0], 0.0, (NZeros+1));
-	  init_vec_value(&mass_matrix_2_tmpB[0], 0.0, (NZeros+1));
-
-	  /* They all have the same action flag settings... */
-	  af->Assemble_Residual = TRUE;
-	  af->Assemble_Jacobian = TRUE;
-	  af->Assemble_LSA_Jacobian_Matrix = FALSE;
-	  af->Assemble_LSA_Mass_Matrix = FALSE;
-
-	  printf("Assembling B_tmpA (pass 1)...\n");
-	  LSA_3D_of_2D_pass = 1;
-	  ams->val = mass_matrix_1_tmpA;
-	  delta_t = 1.0;	/* To get the phi_i*phi_j terms
-				 * (transient soln.) */
-	  tran->delta_t = 1.0;  /*for Newmark-Beta terms in Lagrangian Solid*/
-	  matrix_fill_full(ams, x, resid_vector, x_old,
-			   x_older, xdot, xdot_old,
-			   x_update, &delta_t, &theta,
-			   First_Elem_Side_BC_Array, &time_value, exo,
-			   dpi, &num_total_nodes, &zero[0], &zero[0],
-			   NULL);
-	  
-	  printf("Assembling B_tmpB (pass 1)...\n");
-	  LSA_3D_of_2D_pass = 1;
-	  ams->val = mass_matrix_1_tmpB;
-	  delta_t = 1.0e+72;	/* To simulate steady-state soln. */
-	  tran->delta_t = 1.0e+72;   /*for Newmark-Beta terms in Lagrangian Solid*/
-	  matrix_fill_full(ams, x, resid_vector, x_old,
-			   x_older, xdot, xdot_old, x_update,
-			   &delta_t, &theta, First_Elem_Side_BC_Array,
-			   &time_value, exo, dpi, &num_total_nodes,
-			   &zero[0], &zero[0], NULL);
-	  
-	  printf("Assembling B_tmpA (pass 2)...\n");
-	  LSA_3D_of_2D_pass = 2;
-	  ams->val = mass_matrix_2_tmpA;
-	  delta_t = 1.0;	/* To get the phi_i*phi_j terms
-				 * (transient soln.) */
-	  tran->delta_t = 1.0;      /*for Newmark-Beta terms in Lagrangian Solid*/
-	  matrix_fill_full(ams, x, resid_vector, x_old,
-			   x_older, xdot, xdot_old,
-			   x_update, &delta_t, &theta,
-			   First_Elem_Side_BC_Array, &time_value, exo,
-			   dpi, &num_total_nodes, &zero[0], &zero[0],
-			   NULL);
-	  
-	  printf("Assembling B_tmpB (pass 2)...\n");
-	  LSA_3D_of_2D_pass = 2;
-	  ams->val = mass_matrix_2_tmpB;
-	  delta_t = 1.0e+72;	/* To simulate steady-state soln. */
-	  tran->delta_t = 1.0e+72;  /*for Newmark-Beta terms in Lagrangian Solid*/
-	  matrix_fill_full(ams, &x[0], &resid_vector[0], x_old,
-			   x_older, xdot, xdot_old, x_update,
-			   &delta_t, &theta, First_Elem_Side_BC_Array,
-			   &time_value, exo, dpi, &num_total_nodes,
-			   &zero[0], &zero[0], NULL);
-
-	  /* Now construct the actual Subtractionism versions of each
-	   * pass.  These are stored in mass_matrix_[1,2]_tmpA. */
-	  for(i = 0; i < NZeros+1; i++)
+	/* Get the original pd_glob[mn]->e[i] and pd_glob[mn]->etm[i][*] 
+	 * values back. */
+	TimeIntegration = STEADY;
+	theta = 0.0;
+	for(mn = 0; mn < upd->Num_Mat; mn++)
+	  for(i = 0; i < MAX_EQNS; i++)
 	    {
-	      mass_matrix_1_tmpA[i] = mass_matrix_1_tmpB[i] - mass_matrix_1_tmpA[i];
-	      mass_matrix_2_tmpA[i] = mass_matrix_2_tmpB[i] - mass_matrix_2_tmpA[i];
+	      pd_glob[mn]->TimeIntegration = STEADY;
+	      pd_glob[mn]->e[i] = e_save[mn][i];
+	      for(j = 0; j < MAX_TERM_TYPES; j++)
+		pd_glob[mn]->etm[i][j] = etm_save[mn][i][j];
 	    }
-	}
       
-      /* Now we want to compute both passes of our mass matrix using
-       * the action flag.  We already set some of the parameters
-       * correcetly above... */
+	/* Jacobian matrix, pass 1 */
+	printf("Assembling J (pass 1)...\n");
+	LSA_3D_of_2D_pass = 1;
+	ams->val = jacobian_matrix_1;
+	init_vec_value(&jacobian_matrix_1[0], 0.0, (NZeros+1));
+	af->Assemble_Residual = TRUE;
+	af->Assemble_Jacobian = TRUE;
+	af->Assemble_LSA_Jacobian_Matrix = TRUE;
+	af->Assemble_LSA_Mass_Matrix = FALSE;
+      
+	matrix_fill_full(ams, x, resid_vector, 
+			 x_old, x_older, xdot, xdot_old, x_update,
+			 &delta_t, &theta, First_Elem_Side_BC_Array, 
+			 &time_value, exo, dpi, 
+			 &num_total_nodes, &zero[0], &zero[0], NULL);
+
+	/* Jacobian matrix, pass 2 */
+	printf("Assembling J (pass 2)...\n");
+	LSA_3D_of_2D_pass = 2;
+	ams->val = jacobian_matrix_2;
+	init_vec_value(&jacobian_matrix_2[0], 0.0, (NZeros+1));
+	af->Assemble_Residual = TRUE;
+	af->Assemble_Jacobian = TRUE;
+	af->Assemble_LSA_Jacobian_Matrix = TRUE;
+	af->Assemble_LSA_Mass_Matrix = FALSE;
+      
+	matrix_fill_full(ams, x, resid_vector, 
+			 x_old, x_older, xdot, xdot_old, x_update,
+			 &delta_t, &theta, 
+			 First_Elem_Side_BC_Array, 
+			 &time_value, exo, dpi, 
+			 &num_total_nodes, &zero[0], &zero[0], NULL);
+
+	/* Add the two passes together to get the "real" Jacobian
+	 * matrix. */
+	for(i = 0; i < NZeros+1; i++)
+	  jacobian_matrix[i] = jacobian_matrix_1[i] +
+	    jacobian_matrix_2[i];
+	if(store_sample)
+	  memcpy(J_sample[num_samples], jacobian_matrix,
+		 (NZeros+1) * sizeof(double));
+
+	/* This call will fill in scale[] with the proper row scales.  I
+	 * need to get this in terms of the Jacobian, and the apply it to
+	 * the "mass" matrix, later... */
+	ams->val = jacobian_matrix;
+	row_sum_scaling_scale(ams, resid_vector, scale);
+
+	/* Now compute the mass matrix.  This is more complicated than
+	 * it seems if we want to perform a comparison with the
+	 * Subtractionism method.  There are, in fact, three different
+	 * matrices with which we could compare along the way: mass
+	 * matrix from pass 1, mass matrix from pass 2, and final
+	 * (Additionism?) mass matrix.  I will construct comparisons
+	 * for all three...
+	 *
+	 * There is an order restriction.  We cannot recover the
+	 * pd_glob[mn]->e[i] (and pd_glob[mn]->etm[i][*]) values AFTER
+	 * we compute the mass matrix with my method, because we set
+	 * everything to 0 except the T_MASS-ish terms.  So we should
+	 * compute all of the Subtractionism matrices,
+	 * mass_matrix_[1,2]_tmp[A,b], first.  Then compute the two
+	 * mass_matrix_[1,2] passes.  Since we save the pd_glob[mn]
+	 * structures to reset things over multiple wave number
+	 * computations, we could refer to the saved values to remove
+	 * this restriction, but there's less code this way... */
+
+	/* theta = 0 makes the method implicit, so that we get the
+	 * var_{}^{n+1} coefficient.  We want this for ALL mass matrix
+	 * computations, but not for the jacobian computations (they
+	 * should have the mass etm = 0, so it wouldn't matter...). */
+	theta = 0.0;
+
+	TimeIntegration = TRANSIENT;
+	for(mn = 0; mn < upd->Num_Mat; mn++) 
+	  {
+	    pd_glob[mn]->TimeIntegration = TRANSIENT;
+	    for(i = 0; i < MAX_EQNS; i++)
+	      if(pd_glob[mn]->e[i])
+		{
+		  pd_glob[mn]->e[i] |= T_MASS;
+		  pd_glob[mn]->etm[i][LOG2_MASS] = 1.0;
+		}
+	  }
 
-      /* Initialize */
-      for(mn = 0; mn < upd->Num_Mat; mn++) 
-	{
-	  for(i = 0; i < MAX_EQNS; i++)
-	    if(pd_glob[mn]->e[i])
+	/* Subtractionism method for mass matrix, passes 1 and 2. */
+	if(LSA_COMPARE)
+	  {
+	    init_vec_value(&mass_matrix_1_tmpA[0], 0.0, (NZeros+1));
+	    init_vec_value(&mass_matrix_1_tmpB[0], 0.0, (NZeros+1));
+	    init_vec_value(&mass_matrix_2_tmpA[0], 0.0, (NZeros+1));
+	    init_vec_value(&mass_matrix_2_tmpB[0], 0.0, (NZeros+1));
+
+	    /* They all have the same action flag settings... */
+	    af->Assemble_Residual = TRUE;
+	    af->Assemble_Jacobian = TRUE;
+	    af->Assemble_LSA_Jacobian_Matrix = FALSE;
+	    af->Assemble_LSA_Mass_Matrix = FALSE;
+
+	    printf("Assembling B_tmpA (pass 1)...\n");
+	    LSA_3D_of_2D_pass = 1;
+	    ams->val = mass_matrix_1_tmpA;
+	    delta_t = 1.0;	/* To get the phi_i*phi_j terms
+				   * (transient soln.) */
+	    tran->delta_t = 1.0;  /*for Newmark-Beta terms in Lagrangian Solid*/
+	    matrix_fill_full(ams, x, resid_vector, x_old,
+			     x_older, xdot, xdot_old,
+			     x_update, &delta_t, &theta,
+			     First_Elem_Side_BC_Array, &time_value, exo,
+			     dpi, &num_total_nodes, &zero[0], &zero[0],
+			     NULL);
+	  
+	    printf("Assembling B_tmpB (pass 1)...\n");
+	    LSA_3D_of_2D_pass = 1;
+	    ams->val = mass_matrix_1_tmpB;
+	    delta_t = 1.0e+72;	/* To simulate steady-state soln. */
+	    tran->delta_t = 1.0e+72;   /*for Newmark-Beta terms in Lagrangian Solid*/
+	    matrix_fill_full(ams, x, resid_vector, x_old,
+			     x_older, xdot, xdot_old, x_update,
+			     &delta_t, &theta, First_Elem_Side_BC_Array,
+			     &time_value, exo, dpi, &num_total_nodes,
+			     &zero[0], &zero[0], NULL);
+	  
+	    printf("Assembling B_tmpA (pass 2)...\n");
+	    LSA_3D_of_2D_pass = 2;
+	    ams->val = mass_matrix_2_tmpA;
+	    delta_t = 1.0;	/* To get the phi_i*phi_j terms
+				   * (transient soln.) */
+	    tran->delta_t = 1.0;      /*for Newmark-Beta terms in Lagrangian Solid*/
+	    matrix_fill_full(ams, x, resid_vector, x_old,
+			     x_older, xdot, xdot_old,
+			     x_update, &delta_t, &theta,
+			     First_Elem_Side_BC_Array, &time_value, exo,
+			     dpi, &num_total_nodes, &zero[0], &zero[0],
+			     NULL);
+	  
+	    printf("Assembling B_tmpB (pass 2)...\n");
+	    LSA_3D_of_2D_pass = 2;
+	    ams->val = mass_matrix_2_tmpB;
+	    delta_t = 1.0e+72;	/* To simulate steady-state soln. */
+	    tran->delta_t = 1.0e+72;  /*for Newmark-Beta terms in Lagrangian Solid*/
+	    matrix_fill_full(ams, &x[0], &resid_vector[0], x_old,
+			     x_older, xdot, xdot_old, x_update,
+			     &delta_t, &theta, First_Elem_Side_BC_Array,
+			     &time_value, exo, dpi, &num_total_nodes,
+			     &zero[0], &zero[0], NULL);
+
+	    /* Now construct the actual Subtractionism versions of each
+	     * pass.  These are stored in mass_matrix_[1,2]_tmpA. */
+	    for(i = 0; i < NZeros+1; i++)
 	      {
-		pd_glob[mn]->e[i] = T_MASS;
-		for (j = 0; j < MAX_TERM_TYPES; j++)
-		  pd_glob[mn]->etm[i][j] = 0.0;
-		pd_glob[mn]->etm[i][LOG2_MASS] = 1.0;
+		mass_matrix_1_tmpA[i] = mass_matrix_1_tmpB[i] - mass_matrix_1_tmpA[i];
+		mass_matrix_2_tmpA[i] = mass_matrix_2_tmpB[i] - mass_matrix_2_tmpA[i];
 	      }
-	}
-
-      init_vec_value(&mass_matrix[0], 0.0, (NZeros+1));
-      init_vec_value(&mass_matrix_1[0], 0.0, (NZeros+1));
-      init_vec_value(&mass_matrix_2[0], 0.0, (NZeros+1));
+	  }
       
-      /* These action flags and delta_t are the same for both
-       * passes. */ 
-      af->Assemble_Residual = TRUE;
-      af->Assemble_Jacobian = TRUE;
-      af->Assemble_LSA_Jacobian_Matrix = FALSE;
-      af->Assemble_LSA_Mass_Matrix = TRUE;
-      delta_t = 1.0;
-      tran->delta_t = 1.0;      /*for Newmark-Beta terms in Lagrangian Solid*/
+	/* Now we want to compute both passes of our mass matrix using
+	 * the action flag.  We already set some of the parameters
+	 * correcetly above... */
 
-      printf("Assembling B (pass 1)...\n"); 
-      LSA_3D_of_2D_pass = 1;
-      ams->val = mass_matrix_1;
-      matrix_fill_full(ams, x, resid_vector, x_old, x_older,
-		       xdot, xdot_old, x_update, &delta_t, &theta,
-		       First_Elem_Side_BC_Array, &time_value, exo,
-		       dpi, &num_total_nodes, &zero[0], &zero[0],
-		       NULL);
-
-      printf("Assembling B (pass 2)...\n"); 
-      LSA_3D_of_2D_pass = 2;
-      ams->val = mass_matrix_2;
-      matrix_fill_full(ams, x, resid_vector, x_old, x_older,
-		       xdot, xdot_old, x_update, &delta_t, &theta,
-		       First_Elem_Side_BC_Array, &time_value, exo,
-		       dpi, &num_total_nodes, &zero[0], &zero[0],
-		       NULL);
-
-      /* Get my mass matrix by adding the two passes together (don't
-       * forget the -! */
-      for(i = 0; i < NZeros+1; i++)
-	mass_matrix[i] = -(mass_matrix_1[i] + mass_matrix_2[i]);
+	/* Initialize */
+	for(mn = 0; mn < upd->Num_Mat; mn++) 
+	  {
+	    for(i = 0; i < MAX_EQNS; i++)
+	      if(pd_glob[mn]->e[i])
+		{
+		  pd_glob[mn]->e[i] = T_MASS;
+		  for (j = 0; j < MAX_TERM_TYPES; j++)
+		    pd_glob[mn]->etm[i][j] = 0.0;
+		  pd_glob[mn]->etm[i][LOG2_MASS] = 1.0;
+		}
+	  }
+
+	init_vec_value(&mass_matrix[0], 0.0, (NZeros+1));
+	init_vec_value(&mass_matrix_1[0], 0.0, (NZeros+1));
+	init_vec_value(&mass_matrix_2[0], 0.0, (NZeros+1));
+      
+	/* These action flags and delta_t are the same for both
+	 * passes. */ 
+	af->Assemble_Residual = TRUE;
+	af->Assemble_Jacobian = TRUE;
+	af->Assemble_LSA_Jacobian_Matrix = FALSE;
+	af->Assemble_LSA_Mass_Matrix = TRUE;
+	delta_t = 1.0;
+	tran->delta_t = 1.0;      /*for Newmark-Beta terms in Lagrangian Solid*/
+
+	printf("Assembling B (pass 1)...\n"); 
+	LSA_3D_of_2D_pass = 1;
+	ams->val = mass_matrix_1;
+	matrix_fill_full(ams, x, resid_vector, x_old, x_older,
+			 xdot, xdot_old, x_update, &delta_t, &theta,
+			 First_Elem_Side_BC_Array, &time_value, exo,
+			 dpi, &num_total_nodes, &zero[0], &zero[0],
+			 NULL);
+
+	printf("Assembling B (pass 2)...\n"); 
+	LSA_3D_of_2D_pass = 2;
+	ams->val = mass_matrix_2;
+	matrix_fill_full(ams, x, resid_vector, x_old, x_older,
+			 xdot, xdot_old, x_update, &delta_t, &theta,
+			 First_Elem_Side_BC_Array, &time_value, exo,
+			 dpi, &num_total_nodes, &zero[0], &zero[0],
+			 NULL);
+
+	/* Get my mass matrix by adding the two passes together (don't
+	 * forget the -! */
+	for(i = 0; i < NZeros+1; i++)
+	  mass_matrix[i] = -(mass_matrix_1[i] + mass_matrix_2[i]);
+
+	if(store_sample)
+	  {
+	    memcpy(M_sample[num_samples], mass_matrix,
+		   (NZeros+1) * sizeof(double));
+	    N_sample[num_samples++] = LSA_3D_of_2D_wave_number;
+	    if(num_samples == 3)
+	      {
+		wave_number_fit(J_sample, N_sample, NZeros+1);
+		wave_number_fit(M_sample, N_sample, NZeros+1);
+	      }
+	  }
+	} /* if(use_fit && num_samples == 3) */
 
       /* Scale all of the preliminary pieces for comparison, if we're
        * doing one.  Otherwise, just scale the above mass_matrix... */
@@ -758,13 +864,15 @@ int solve_3D_of_2D_stability_problem(struct Aztec_Linear_Solver_System *ams,
 	    }
 	  printf("Entering eggrollinit...\n"); fflush(stdout);
 	  eggroll_init(NumUnknowns, NZeros, &istuff[0], &dstuff[0]);
+	  egg_mass_compress(NumUnknowns, ija, mass_matrix, &mass);
 	  
 	  /* Call eggroll solver */
 	  printf("Entering eggrollwrap...\n"); fflush(stdout);
-          eggrollwrap(istuff, dstuff, ija, jacobian_matrix, mass_matrix, x, ExoFileOut, ProblemType,
+          eggrollwrap(istuff, dstuff, ija, jacobian_matrix, &mass, x, ExoFileOut, ProblemType,
                       delta_t, theta, x_old, xdot, xdot_old, resid_vector, converged, nprint, tnv,
                       tnv_post, tev, tev_post, rd, gindex, p_gsize, gvec, gvec_elem, time_value,
                       exo, Num_Proc, dpi);
+	  egg_mass_free(&mass);
       }
     } /* for(wn = 0; wn < LSA_num_wave_numbers; wn++) */
       
@@ -779,6 +887,11 @@ int solve_3D_of_2D_stability_problem(struct Aztec_Linear_Solver_System *ams,
       free(mass_matrix_1_tmpB);
       free(mass_matrix_1_tmpA);
     }
+  for(k = 0; k < 3; k++)
+    {
+      free(J_sample[k]);
+      free(M_sample[k]);
+    }
   free(mass_matrix_2);
   free(mass_matrix_1);
   free(mass_matrix);
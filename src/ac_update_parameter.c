@@ -1068,6 +1068,8 @@ update_MT_parameter(double lambda, /* Parameter value */
          { upd->Acoustic_Frequency = 2.*M_PIE*c_mm/lambda;}
       else
          { upd->Acoustic_Frequency = 2.*M_PIE*c_m/lambda;}
+      break;
+
     case TAGC_TFMP_REL_PERM_0:
       mp_glob[mn]->tfmp_rel_perm_const[0] = lambda;
       break;
@@ -156,8 +156,10 @@ apply_point_colloc_bc (
       err = load_bf_grad();
       EH( err, "load_bf_grad");
 
-      err = load_bf_mesh_derivs(); 
-      EH( err, "load_bf_mesh_derivs");
+      if (af->Assemble_Jacobian) {
+	err = load_bf_mesh_derivs(); 
+	EH( err, "load_bf_mesh_derivs");
+      }
       
       /* calculate the shape functions and their gradients */
 
@@ -3335,14 +3337,8 @@ bc_eqn_index(int id,               /* local node number                 */
   /*
    * check the processor node number, I, against BC_dup_nodes[]
    * to see if this node is at an intersection of side-sets
-   *
-   * HKM -> the search below seems like a time-waste. In lieu of
-   *        that, we could set up an added  bit field in
-   *        Node_Info struct or elsewhere where we could store the
-   *        results of this search (or just the need to do the
-   *        search).
    */
-  bc_node = in_list(I, 0, BC_dup_ptr+1, BC_dup_nodes);
+  bc_node = (BC_dup_index != NULL) ? BC_dup_index[I] : -1;
   if (bc_node != -1) {
     /* 
      * current node is in the BC_duplication list.
@@ -3619,14 +3615,8 @@ bc_eqn_index_stress(int id,               /* local node number                 *
   /*
    * check the processor node number, I, against BC_dup_nodes[]
    * to see if this node is at an intersection of side-sets
-   *
-   * HKM -> the search below seems like a time-waste. In lieu of
-   *        that, we could set up an added  bit field in
-   *        Node_Info struct or elsewhere where we could store the
-   *        results of this search (or just the need to do the
-   *        search).
    */
-  bc_node = in_list(I, 0, BC_dup_ptr+1, BC_dup_nodes);
+  bc_node = (BC_dup_index != NULL) ? BC_dup_index[I] : -1;
   if (bc_node != -1) {
     /* 
      * current node is in the BC_duplication list.
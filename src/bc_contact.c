@@ -1684,7 +1684,8 @@ assemble_embedded_bc (
 	  }
 	  break;
         case LS_CAP_CURVE_BC:
-          if( pd->e[R_NORMAL1] )
+          if( pd->e[R_NORMAL1] ||
+              ls->Curvature_Projection == LS_CURV_PROJ_LUMPED )
             assemble_curvature_with_normals_source () ;
           else
             assemble_curvature_source ();
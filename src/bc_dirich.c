@@ -18,6 +18,7 @@
 /* Standard include files */
 
 #include <stdio.h>
+#include <string.h>
 
 /* GOMA include files */
 
@@ -53,6 +54,152 @@
 /************************************************************************************/
 /************************************************************************************/
 
+static int
+dirichlet_row(const int i, const int k, int *offset, int *eqn, int *var,
+	      int *ldof_eqn)
+
+    /**************************************************************************
+     *
+     * dirichlet_row():
+     *
+     *  For the k'th compiled Dirichlet unknown of local node i of the
+     *  current element, find the local element row, (eqn, ldof_eqn), that
+     *  put_dirichlet_in_matrix() replaces, with the matching variable and
+     *  the unknown's offset at the node.
+     *
+     *  Return
+     * --------
+     *  the index of the boundary condition, or -1 when the row is left
+     *  alone (condition cleared, variable not in this material, or one of
+     *  the D*_NOTHING conditions)
+     *************************************************************************/
+{
+  int ibc, var_type, matID, j, ledof, matID_dof, found;
+  int I = Proc_Elem_Connect[ei->iconnect_ptr + i];
+  NODE_INFO_STRUCT *node = Nodes[I];
+  VARIABLE_DESCRIPTION_STRUCT *vd;
+
+  *offset = node->DBC_Dofs[k].offset;
+  ibc = node->DBC[*offset];
+  if (ibc == -1) return -1;
+
+  vd = node->Nodal_Vars_Info->Var_Desc_List[node->DBC_Dofs[k].lvdesc];
+  var_type = vd->Variable_Type;
+  matID = vd->MatID;
+
+  /*
+   * We are tacitly assuming here that all 
+   * lvdofs for the same variable type and subvariable
+   * type at the same node are grouped contiguously
+   * in the local element stiffness matrix lvdof
+   * ordering.
+   */
+  *ldof_eqn = ei->ln_to_first_dof[var_type][i];
+  for (j = 0, found = FALSE; j < Dolphin[I][var_type]; j++) {
+    ledof = ei->lvdof_to_ledof[var_type][*ldof_eqn];
+    matID_dof = ei->matID_ledof[ledof];
+    if (matID == matID_dof || matID == -1) {
+      found = TRUE;
+      break;
+    }
+    (*ldof_eqn)++;
+  }
+  if (!found) {
+    EH(-1,"ERROR");
+  }
+  if (var_type == MASS_FRACTION) {
+    *eqn = MAX_PROB_VAR + vd->Subvar_Index;
+    *var = *eqn;
+  } else {
+    *eqn = upd->ep[var_type];
+    *var = upd->vp[var_type];
+  }
+
+  /*Big test here.  We are no longer applying dirichlets from materials
+    that the variables isn't defined */
+  if (!pd->e[var_type]) return -1;
+
+  if (BC_Types[ibc].BC_Name == DX_NOTHING_BC ||
+      BC_Types[ibc].BC_Name == DY_NOTHING_BC ||
+      BC_Types[ibc].BC_Name == DZ_NOTHING_BC) return -1;
+
+  return ibc;
+}
+/******************************************************************************/
+
+void
+mark_dirichlet_rows(const int num_total_nodes,
+		    struct elem_side_bc_struct *elem_side_bc)
+
+    /**************************************************************************
+     *
+     * mark_dirichlet_rows():
+     *
+     *  Flag in lec->dirichlet_row[] the rows of the current element that
+     *  put_dirichlet_in_matrix() will overwrite, so that the volume
+     *  assembly routines can skip integrating them (LEC_DIRICHLET_ROW()).
+     *  Call after load_elem_dofptr() and before the volume assembly.
+     *
+     *  Rows are only flagged where nothing reads them before they are
+     *  replaced: not when the Jacobian is taken numerically, not in
+     *  elements with edge conditions, and not at nodes that are rotated
+     *  or lie on a side with a condition other than a weak integrated
+     *  one (strong and collocated conditions may move one row into
+     *  another, e.g. FLUID_SOLID).
+     *
+     *  elem_side_bc = first side boundary condition of the element
+     *************************************************************************/
+{
+  int i, k, I, id, ibc, offset, eqn, var, ldof_eqn, ib;
+  int skip_node[MDE];
+  NODE_INFO_STRUCT *node;
+  struct elem_side_bc_struct *side;
+
+  if (lec->num_dirichlet_rows > 0) {
+    memset(lec->dirichlet_row, 0,
+	   MAX_LOCAL_VAR_DESC * lec->max_dof * sizeof(int));
+    lec->num_dirichlet_rows = 0;
+  }
+
+  if (Debug_Flag < 0) return;
+  if (First_Elem_Edge_BC_Array != NULL &&
+      First_Elem_Edge_BC_Array[ei->ielem] != NULL) return;
+
+  for (i = 0; i < ei->num_local_nodes; i++) {
+    I = Proc_Elem_Connect[ei->iconnect_ptr + i];
+    skip_node[i] = (Nodes[I]->DBC == NULL || I >= num_total_nodes ||
+		    (mom_rotate_index != NULL && mom_rotate_index[I] != -1) ||
+		    (mesh_rotate_index != NULL && mesh_rotate_index[I] != -1) ||
+		    (Num_ROT > 0 && ROT_list[I] != NULL));
+  }
+
+  for (side = elem_side_bc; side != NULL; side = side->next_side_bc) {
+    for (ib = 0; ib < side->Num_BC; ib++) {
+      ibc = side->BC_input_id[ib];
+      if (BC_Types[ibc].desc->method != WEAK_INT_SURF &&
+	  BC_Types[ibc].desc->method != DIRICHLET) break;
+    }
+    if (ib < side->Num_BC) {
+      for (i = 0; i < side->num_nodes_on_side; i++) {
+	id = side->local_elem_node_id[i];
+	skip_node[id] = TRUE;
+      }
+    }
+  }
+
+  for (i = 0; i < ei->num_local_nodes; i++) {
+    if (skip_node[i]) continue;
+    node = Nodes[Proc_Elem_Connect[ei->iconnect_ptr + i]];
+    for (k = 0; k < node->Num_DBC_Dofs; k++) {
+      if (dirichlet_row(i, k, &offset, &eqn, &var, &ldof_eqn) != -1) {
+	lec->dirichlet_row[LEC_R_INDEX(eqn, ldof_eqn)] = TRUE;
+	lec->num_dirichlet_rows++;
+      }
+    }
+  }
+}
+/******************************************************************************/
+
 int
 put_dirichlet_in_matrix(double x[], const int num_total_nodes)
 
@@ -74,14 +221,11 @@ put_dirichlet_in_matrix(double x[], const int num_total_nodes)
 {
   int i, ieqn, ibc;		/* local node number in current element */
   int eqn, var;                 /* squished equation and variable number */
-  int var_type;
   int I;			/* processor node number */
   int ldof_eqn;                 /* conversion from node to local dof */
-  int offset, lvdesc, idof, matID, j, ledof, matID_dof, found;
+  int offset, k;
   double V_set;
   NODE_INFO_STRUCT *node;
-  NODAL_VARS_STRUCT *nv;
-  VARIABLE_DESCRIPTION_STRUCT *vd;
 
   /*
    * Return for numerical jacobian options.
@@ -92,71 +236,24 @@ put_dirichlet_in_matrix(double x[], const int num_total_nodes)
     I = Proc_Elem_Connect[ei->iconnect_ptr + i];
     node = Nodes[I];
     if (node->DBC && I < num_total_nodes) {
-      nv = node->Nodal_Vars_Info;
-      offset = 0;
-      for (lvdesc = 0; lvdesc < nv->Num_Var_Desc; lvdesc++) {
-	vd = nv->Var_Desc_List[lvdesc];
-	for (idof = 0; idof < vd->Ndof; idof++) { 
-	  if (node->DBC[offset] != -1) {
-	    ibc = node->DBC[offset];
-	    var_type = vd->Variable_Type;
-	    matID = vd->MatID;
-	    /*
-	     * We are tacitly assuming here that all 
-	     * lvdofs for the same variable type and subvariable
-	     * type at the same node are grouped contiguously
-	     * in the local element stiffness matrix lvdof
-	     * ordering.
-	     */
-	    ldof_eqn = ei->ln_to_first_dof[var_type][i];
-	    for (j = 0, found = FALSE; j < Dolphin[I][var_type]; j++) {
-	      ledof = ei->lvdof_to_ledof[var_type][ldof_eqn];
-	      matID_dof = ei->matID_ledof[ledof];
-	      if (matID == matID_dof || matID == -1) {
-		found = TRUE;
-		break;
-	      }
-	      ldof_eqn++;
-	    }
-	    if (!found) {
-	      EH(-1,"ERROR");
-	    }
-	    if (var_type == MASS_FRACTION) {
-	      eqn = MAX_PROB_VAR + vd->Subvar_Index;
-	      var = eqn;
-	    } else {
-	      eqn = upd->ep[var_type];
-	      var = upd->vp[var_type];
-	    }
-
-	    if (pd->e[var_type])  /*Big test here.  We are no longer applying 
-				   dirichlets from materials that the variables 
-				   isn't defined */
-	      {
-	       	// Add for F_DIODE_BC if((var_type != FILL) )
-		// Add for F_DIOD_BC  {
-
-                if(BC_Types[ibc].BC_Name != DX_NOTHING_BC &&
-                   BC_Types[ibc].BC_Name != DY_NOTHING_BC &&
-                   BC_Types[ibc].BC_Name != DZ_NOTHING_BC )
-                   {
-		    zero_lec_row(lec->J, eqn, ldof_eqn);
-		    if (!(af->Assemble_LSA_Mass_Matrix)) {
-                      lec->J[LEC_J_INDEX(eqn,var,ldof_eqn,ldof_eqn)] = DIRICHLET_PENALTY;
-		    }
-		    if (BC_Types[ibc].BC_relax == -1.0) {
-                      lec->R[LEC_R_INDEX(eqn,ldof_eqn)] = 0.0;
-		    } else {
-		      ieqn  = node->First_Unknown + offset;
-		      V_set = BC_Types[ibc].BC_Data_Float[0];
-                      lec->R[LEC_R_INDEX(eqn,ldof_eqn)] = DIRICHLET_PENALTY * (x[ieqn] - V_set);
-		    }
-                   }    /* end of DX_NOTHING test  */
-		    // Add for F_DIODE_BC   }
-	      }
-		
-	  } 
-	  offset++;
+      /*
+       * Only the unknowns find_and_set_Dirichlet() compiled into
+       * DBC_Dofs[] can carry a Dirichlet condition.
+       */
+      for (k = 0; k < node->Num_DBC_Dofs; k++) {
+	ibc = dirichlet_row(i, k, &offset, &eqn, &var, &ldof_eqn);
+	if (ibc == -1) continue;
+
+	zero_lec_row(lec->J, eqn, ldof_eqn);
+	if (!(af->Assemble_LSA_Mass_Matrix)) {
+	  lec->J[LEC_J_INDEX(eqn,var,ldof_eqn,ldof_eqn)] = DIRICHLET_PENALTY;
+	}
+	if (BC_Types[ibc].BC_relax == -1.0) {
+	  lec->R[LEC_R_INDEX(eqn,ldof_eqn)] = 0.0;
+	} else {
+	  ieqn  = node->First_Unknown + offset;
+	  V_set = BC_Types[ibc].BC_Data_Float[0];
+	  lec->R[LEC_R_INDEX(eqn,ldof_eqn)] = DIRICHLET_PENALTY * (x[ieqn] - V_set);
 	}
       }
     }
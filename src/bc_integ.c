@@ -111,8 +111,9 @@ apply_integrated_bc(double x[],           /* Solution vector for the current pro
   double v_attach; 
   double phi_i, tmp;
   double *phi_ptr, *jac_ptr;
-  double s, t, u;	      	/* Gaussian quadrature point locations  */
+  double s, t;	      	/* Gaussian quadrature point locations  */
   double xi[DIM];             /* Local element coordinates of Gauss point. */
+  const struct Surf_Quad_Side *sq = NULL; /* tabulated side quadrature */
   double x_dot[MAX_PDIM];
   double x_rs_dot[MAX_PDIM];
   double wt, weight, pb[DIM];
@@ -173,7 +174,9 @@ apply_integrated_bc(double x[],           /* Solution vector for the current pro
     }
   else
     {
-      ip_total = elem_info(NQUAD_SURF, ielem_type);
+      sq = surf_quad_side(ielem_type, (int) elem_side_bc->id_side,
+			  ei->ielem_dim);
+      ip_total = sq->nquad;
     }
 
   /*
@@ -223,11 +226,13 @@ apply_integrated_bc(double x[],           /* Solution vector for the current pro
     else
       {
         if ( ls != NULL ) ls->Elem_Sign = 0;
-	/* find the quadrature point locations (s, t) for current ip */
-	find_surf_st(ip, ielem_type, elem_side_bc->id_side,
-                     ei->ielem_dim, xi, &s, &t, &u);
-        /* find the quadrature weight for current surface ip */
-        wt = Gq_surf_weight(ip, ielem_type);
+	/* quadrature point locations (s, t) and weight for current ip */
+	xi[0] = sq->xi[ip][0];
+	xi[1] = sq->xi[ip][1];
+	xi[2] = sq->xi[ip][2];
+	s = sq->s[ip];
+	t = sq->t[ip];
+	wt = sq->wt[ip];
       } 
     
     err = load_basis_functions(xi, bfd);
@@ -248,8 +253,10 @@ apply_integrated_bc(double x[],           /* Solution vector for the current pro
     err = load_bf_grad();
     EH(err, "load_bf_grad");
 
-    err = load_bf_mesh_derivs(); 
-    EH(err, "load_bf_mesh_derivs");
+    if (af->Assemble_Jacobian) {
+      err = load_bf_mesh_derivs(); 
+      EH(err, "load_bf_mesh_derivs");
+    }
 
     /* calculate the determinant of the surface jacobian and the normal to 
      * the surface all at one time */
@@ -272,8 +279,10 @@ apply_integrated_bc(double x[],           /* Solution vector for the current pro
     err = load_fv_grads();
     EH( err, "load_fv_grads");
     
-    err = load_fv_mesh_derivs(1);
-    EH(err, "load_fv_mesh_derivs");
+    if (af->Assemble_Jacobian) {
+      err = load_fv_mesh_derivs(1);
+      EH(err, "load_fv_mesh_derivs");
+    }
     
     /*
      * Load up commonly used physical properties such as density at
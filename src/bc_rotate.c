@@ -150,7 +150,7 @@ apply_rotated_bc (
       I = Proc_Elem_Connect[iconnect_ptr + id]; /* Find global node */
       /* check to see if this global node is in the momentum rotation list and
        * make sure this nodal equation hasn't been rotated yet */
-      if (((irot = in_list(I, 0, num_mom_rotate, mom_rotate_node)) != -1) && 
+      if (((irot = mom_rotate_index[I]) != -1) && 
 	  mom_already_rotated[id] == 0) {
 	/* determine if SS for rotation is on this side */
 	ss_rot = mom_rotate_ss[irot];
@@ -185,7 +185,7 @@ apply_rotated_bc (
 	  }
       }
       
-      if (((irot = in_list(I, 0, num_mesh_rotate, mesh_rotate_node)) != -1) && 
+      if (((irot = mesh_rotate_index[I]) != -1) && 
 	  mesh_already_rotated[id] == 0) {
 	/* determine if SS for rotation is on this side */
 	ss_rot = mesh_rotate_ss[irot];
@@ -879,8 +879,8 @@ rotate_mesh_eqn (
              */
             for (j = 0; j < rot->d_vector_n; j++ )  {
               double sum_val;
-              int global_row;
-              int global_col;
+              goma_gid global_row;
+              goma_gid global_col;
 
               J = rot->d_vector_J[j];
               if (Dolphin[I][MESH_DISPLACEMENT1] > 0  &&
@@ -1236,8 +1236,8 @@ rotate_momentum_eqn (
 	        // Direct translation from MSR
                 for (j = 0; j < rotation[I][eq][kdir]->d_vector_n; j++) {
                   double sum_val;
-                  int global_row;
-                  int global_col;
+                  goma_gid global_row;
+                  goma_gid global_col;
                   int ktype, ndof, index_eqn, index_var;
                   J = rotation[I][eq][kdir]->d_vector_J[j];
                   if (Dolphin[I][R_MOMENTUM1] > 0
@@ -2114,6 +2114,30 @@ rotate_res_jac_mom (
 
 static int rotation_allocated = FALSE;
 
+/*
+ * The rotation vectors depend on x only through the mesh displacements,
+ * so where no material moves its mesh they are kept from one call to the
+ * next until rotation_vectors_invalidate() says the coordinates changed.
+ */
+static int rotation_current = FALSE;
+
+static int
+rotation_mesh_fixed(void)
+{
+  int m;
+
+  for (m = 0; m < upd->Num_Mat; m++) {
+    if (pd_glob[m]->e[R_MESH1]) return FALSE;
+  }
+  return TRUE;
+}
+
+void
+rotation_vectors_invalidate(void)
+{
+  rotation_current = FALSE;
+}
+
 
 void
 calculate_all_rotation_vectors (Exo_DB *exo,		/* the mesh */
@@ -2159,6 +2183,8 @@ calculate_all_rotation_vectors (Exo_DB *exo,		/* the mesh */
 
   /***************************************************************************/
   /* BEGIN EXECUTION */
+  if (rotation_current) return;
+
   if (Debug_Flag > 0) DPRINTF(stderr, "Starting to calculate rotation vectors\n");
 
   /* initialize the rotation_vector array of rotation structures */
@@ -2515,6 +2541,8 @@ calculate_all_rotation_vectors (Exo_DB *exo,		/* the mesh */
     }
   } /* end of ADJUST */
 
+  rotation_current = rotation_mesh_fixed();
+
   if (Debug_Flag > 0) DPRINTF(stderr, "Done calculating rotation vectors\n");
 
   return;
@@ -2548,6 +2576,8 @@ calculate_2D_rotation_vectors (Exo_DB *exo,		/* the mesh */
   int *gnn_side_list, local_node_side_list[MAX_NODES_PER_SIDE];
   int num_nodes_on_side, num_local_nodes, iconnect_ptr;
 	
+  if (rotation_current) return;
+
   num_total_nodes = Num_Internal_Nodes + Num_Border_Nodes + Num_External_Nodes;
   dim = pd_glob[0]->Num_Dim;
 
@@ -2733,6 +2763,7 @@ calculate_2D_rotation_vectors (Exo_DB *exo,		/* the mesh */
 	    }
 	}
     }
+  rotation_current = rotation_mesh_fixed();
   return;
 }
 
@@ -27,6 +27,8 @@
 #include "brkfix/fix.h"
 
 int Brk_Flag;
+int Brk_Num_Ranks = 1;
+int Brk_Partitioner = BRK_PART_CHACO;
 
 void
 check_for_brkfile(char* brkfile_name) {
@@ -155,6 +157,35 @@ write_brk_file(char* brkfile_name, Exo_DB *exo) {
   return;
 }
 
+/*
+ * With Brk_Num_Ranks > 1 the first Brk_Num_Ranks ranks share the work of
+ * breaking each file; otherwise rank 0 does it alone. Every rank calls
+ * this.
+ */
+
+static void
+brk_one_file(char *exo_file)
+{
+#ifdef PARALLEL
+  static MPI_Comm brk_comm = MPI_COMM_NULL;
+  int nranks = MIN(Brk_Num_Ranks, Num_Proc);
+
+  if (nranks > 1) {
+    if (brk_comm == MPI_COMM_NULL) {
+      MPI_Comm_split(MPI_COMM_WORLD, (ProcID < nranks) ? 0 : MPI_UNDEFINED,
+		     ProcID, &brk_comm);
+    }
+    if (ProcID < nranks) {
+      brk_exo_file_comm(Num_Proc, Brk_File, exo_file, brk_comm);
+    }
+    return;
+  }
+#endif
+  if (ProcID == 0) {
+    brk_exo_file(Num_Proc, Brk_File, exo_file);
+  }
+}
+
 void
 call_brk()
 {
@@ -164,7 +195,7 @@ call_brk()
     if (Debug_Flag) {
       DPRINTF(stdout, "Brking exodus file %s\n", ExoAuxFile);
     }
-    brk_exo_file(Num_Proc, Brk_File, ExoAuxFile);
+    brk_one_file(ExoAuxFile);
   }
 
   if( efv->Num_external_field != 0 ) {
@@ -172,13 +203,13 @@ call_brk()
       if (Debug_Flag) {
         DPRINTF(stdout, "Brking exodus file %s\n", efv->file_nm[i]);
       }
-      brk_exo_file(Num_Proc, Brk_File, efv->file_nm[i]);
+      brk_one_file(efv->file_nm[i]);
     }
   }
   if (Debug_Flag) {
     DPRINTF(stdout, "Brking exodus file %s\n", ExoFile);
   }
-  brk_exo_file(Num_Proc, Brk_File, ExoFile);
+  brk_one_file(ExoFile);
 }
 
 void
@@ -187,5 +218,6 @@ fix_output()
   if (Debug_Flag) {
     DPRINTF(stdout, "\nFixing exodus file pieces.\n");
   }
+  wr_exo_session_close();
   fix_exo_file(Num_Proc, ExoFileOutMono);
 }
@@ -131,6 +131,7 @@
 #include "rd_dpi.h"
 #include "rd_exo.h"
 #include "brkfix/brk.h"
+#include "brkfix/geom_part.h"
 
 /*
  * The general dependency matrix exists for each element block.
@@ -191,6 +192,19 @@ static int total_internal_dofweight = 0;
 static int total_boundary_dofweight = 0;
 static int total_external_dofweight = 0;
 
+/*
+ * Ranks sharing the work of one brk (see brk_exo_file_comm()). Every
+ * rank reads the monolith and builds the graph; rank 0 partitions it and
+ * broadcasts the assignment; then each rank builds and writes just the
+ * pieces s with s % Brk_Size == Brk_Rank.
+ */
+
+static int Brk_Rank = 0;
+static int Brk_Size = 1;
+#ifdef PARALLEL
+static MPI_Comm Brk_Comm;
+#endif
+
 const char program_description[] = "GOMA distributed problem decomposition tool";
 
 const char copyright[]="Copyright (c) 1999-2000 Sandia National Laboratories. All rights reserved.";
@@ -305,6 +319,11 @@ static int integer_compare	/* used internally by qsort() brk.c */
 PROTO((const void *, 
        const void *));
 
+static void apply_elem_cost	/* brk_exo_file.c */
+PROTO((char *,			/* filename - Element Cost File */
+       Exo_DB *,		/* mono - the whole mesh */
+       int *));			/* vwgts - vertex weights to scale */
+
 int 
 brk_exo_file(int num_pieces, char *Brk_File, char *Exo_File)
 {
@@ -599,6 +618,10 @@ brk_exo_file(int num_pieces, char *Brk_File, char *Exo_File)
 
 #endif /* CHACO */
 
+  total_internal_dofweight = 0;
+  total_boundary_dofweight = 0;
+  total_external_dofweight = 0;
+
   tmp = strcpy(in_file_name, Brk_File);
   
   tmp = strcpy(in_exodus_file_name, Exo_File);
@@ -639,7 +662,7 @@ brk_exo_file(int num_pieces, char *Brk_File, char *Exo_File)
       user_params_file_exists = ! ( errno == ENOENT );
     }
 
-  if ( ! user_params_file_exists )
+  if ( ! user_params_file_exists && Brk_Rank == 0 )
     {
       fs_up = fopen(user_params_filename, "w");
       if ( fs_up == NULL )
@@ -668,11 +691,28 @@ brk_exo_file(int num_pieces, char *Brk_File, char *Exo_File)
    * original.
    */
 
-  if ( preprocess_input_file )
+  if ( preprocess_input_file && Brk_Rank == 0 )
     {
       brk_pre_process(in_file_name);
     }
 
+#ifdef PARALLEL
+  /*
+   * The other ranks wait for rank 0 to write the filtered input file and
+   * the User_Params file, then use the same filtered file name.
+   */
+  if ( Brk_Size > 1 )
+    {
+      MPI_Barrier(Brk_Comm);
+      if ( preprocess_input_file && Brk_Rank != 0 )
+	{
+	  char filtered_name[FILENAME_MAX_ACK];
+	  sr = sprintf(filtered_name, "%s%s", TEMP_PREFIX, in_file_name);
+	  tmp = strcpy(in_file_name, filtered_name);
+	}
+    }
+#endif
+
 #ifdef DEBUG
   /*  err = sscanf(line, "%s", in_exodus_file_name); */
   fprintf(stderr, "monolith EXODUSII file = \"%s\"\n", in_exodus_file_name);
@@ -1197,6 +1237,16 @@ brk_exo_file(int num_pieces, char *Brk_File, char *Exo_File)
 	}
     }
 
+  /*
+   * When an earlier goma run measured the assembly cost of each element,
+   * let the measurement rather than the estimate decide the vertex weights.
+   */
+
+  if ( Elem_Cost_File[0] != '\0' )
+    {
+      apply_elem_cost(Elem_Cost_File, mono, vwgts);
+    }
+
 #ifdef DEBUG
   fprintf(stderr, "Verify start, nontrivial adjacency lists:\n");
 
@@ -1216,7 +1266,17 @@ brk_exo_file(int num_pieces, char *Brk_File, char *Exo_File)
    * This is the reference to the main routine for Chaco 2.0 usage.
    */
 
-  if ( num_pieces > 1 )
+  if ( num_pieces > 1 && Brk_Rank == 0 &&
+       Brk_Partitioner != BRK_PART_CHACO )
+    {
+      /*
+       * The built-in geometric cut of the node coordinates, weighed like
+       * the graph Chaco would have been given (Brk Partitioner card).
+       */
+      geom_partition(Brk_Partitioner, nvtxs, mono->num_dim, x, y, z,
+		     vwgts, num_pieces, assignment);
+    }
+  else if ( num_pieces > 1 && Brk_Rank == 0 )
     {
 #ifdef DEBUG
       fprintf(stderr, "interface() called with:\n");
@@ -1232,6 +1292,12 @@ brk_exo_file(int num_pieces, char *Brk_File, char *Exo_File)
 		      ndims_tot, mesh_dims, goal, global_method, local_method,
 		      rqi_flag, vmax, ndims, eigtol, seed);
     }
+  else if ( num_pieces > 1 )
+    {
+      /*
+       * Rank 0 partitions; the assignment is broadcast below.
+       */
+    }
   else if ( num_pieces == 1 )
     {
       /*
@@ -1254,6 +1320,13 @@ brk_exo_file(int num_pieces, char *Brk_File, char *Exo_File)
       EH(-1, "Problem return from Chaco interface().");
     }
 
+#ifdef PARALLEL
+  if ( Brk_Size > 1 )
+    {
+      MPI_Bcast(assignment, nvtxs, MPI_INT, 0, Brk_Comm);
+    }
+#endif
+
 #ifdef DEBUG
   fprintf(stderr, "Chaco interface() returns %d\n", err);
   fprintf(stderr, "assignments:\n");
@@ -1573,6 +1646,10 @@ brk_exo_file(int num_pieces, char *Brk_File, char *Exo_File)
 
   for ( s=0; s<num_pieces; s++)
     {
+      /*
+       * With several ranks sharing the brk, each makes only its own pieces.
+       */
+      if ( s % Brk_Size != Brk_Rank ) continue;
 
       init_exo_struct(E);
 
@@ -4600,7 +4677,12 @@ brk_exo_file(int num_pieces, char *Brk_File, char *Exo_File)
    * with information about the decomposition that was performed.
    */
 
-  if ( add_decomp_plot_vars )
+  /*
+   * The decomposition plot needs every piece, so only a single rank brk
+   * can make it.
+   */
+
+  if ( add_decomp_plot_vars && Brk_Size == 1 )
     {
       /*
        * Create a nodal variables that express for each node:
@@ -4986,17 +5068,31 @@ brk_exo_file(int num_pieces, char *Brk_File, char *Exo_File)
    * Print Sam's heuristic...
    */
 
+#ifdef PARALLEL
+  if ( Brk_Size > 1 )
+    {
+      int local_weight[3], global_weight[3];
+      local_weight[0] = total_internal_dofweight;
+      local_weight[1] = total_boundary_dofweight;
+      local_weight[2] = total_external_dofweight;
+      MPI_Allreduce(local_weight, global_weight, 3, MPI_INT, MPI_SUM, Brk_Comm);
+      total_internal_dofweight = global_weight[0];
+      total_boundary_dofweight = global_weight[1];
+      total_external_dofweight = global_weight[2];
+    }
+#endif
+
   numerator   = total_boundary_dofweight + total_external_dofweight;
   denominator = total_internal_dofweight + total_boundary_dofweight;
 
-  if ( denominator != 0 )
+  if ( denominator != 0 && Brk_Rank == 0 )
     {
       fprintf(stdout, 
 	      "Sam's dof weight figure of merit: (b+e)/(i+b) = %g\n",
 	      ((double)(numerator))/((double)(denominator)));
     }
 
-  fprintf(stdout, "-done.\n");
+  if ( Brk_Rank == 0 ) fprintf(stdout, "-done.\n");
 
   if ( tmp == NULL || sr < 0 ) exit(2);
 
@@ -5006,6 +5102,106 @@ brk_exo_file(int num_pieces, char *Brk_File, char *Exo_File)
   return(0);
 } /* end of main */
 
+#ifdef PARALLEL
+/* brk_exo_file_comm() -- brk_exo_file() shared by the ranks of comm
+ *
+ * Every rank of comm must call this with the same arguments. The ranks
+ * split the per-piece work (building and writing the little EXODUS II
+ * files and their distributed processing information) between them, so
+ * the time spent there drops with the number of ranks. Each rank still
+ * reads the whole monolith, so memory use per rank is unchanged.
+ */
+
+int
+brk_exo_file_comm(int num_pieces, char *Brk_File, char *Exo_File,
+		  MPI_Comm comm)
+{
+  int err;
+
+  Brk_Comm = comm;
+  MPI_Comm_rank(comm, &Brk_Rank);
+  MPI_Comm_size(comm, &Brk_Size);
+
+  err = brk_exo_file(num_pieces, Brk_File, Exo_File);
+
+  Brk_Rank = 0;
+  Brk_Size = 1;
+
+  return(err);
+}
+#endif
+
+
+/* apply_elem_cost() -- scale vertex weights by measured element cost
+ *
+ * The Element Cost File holds the mean time matrix_fill() took for each
+ * element in an earlier run. Each node's estimated weight is multiplied by
+ * the average cost of the elements around it, relative to the mean cost
+ * of all the measured elements. Elements missing from the file count as
+ * average. Nothing changes if the file does not exist yet.
+ */
+
+static void
+apply_elem_cost(char *filename,
+		Exo_DB *mono,
+		int *vwgts)
+{
+  int e, j, n;
+  int num_read;
+  int num_measured;
+  dbl *cost;
+  dbl mean_cost;
+  dbl factor;
+
+  cost = (dbl *) smalloc(MAX(1, mono->num_elems)*sizeof(dbl));
+
+  num_read = elem_cost_read(filename, mono->num_elems, cost);
+  if ( num_read < 1 )
+    {
+      free(cost);
+      return;
+    }
+
+  mean_cost    = 0;
+  num_measured = 0;
+  for ( e=0; e<mono->num_elems; e++)
+    {
+      if ( cost[e] >= 0 )
+	{
+	  mean_cost += cost[e];
+	  num_measured++;
+	}
+    }
+  mean_cost /= num_measured;
+
+  if ( mean_cost > 0 )
+    {
+      for ( n=0; n<mono->num_nodes; n++)
+	{
+	  if ( np[n+1] == np[n] ) continue;
+
+	  factor = 0;
+	  for ( j=np[n]; j<np[n+1]; j++)
+	    {
+	      e       = el[j];
+	      factor += ( cost[e] >= 0 ) ? cost[e]/mean_cost : 1.0;
+	    }
+	  factor /= (np[n+1] - np[n]);
+
+	  vwgts[n] = MAX(1, (int)(vwgts[n]*factor + 0.5));
+	}
+    }
+
+  if ( Brk_Rank == 0 )
+    {
+      fprintf(stdout, "Vertex weights scaled by %d measured element costs from \"%s\"\n",
+	      num_read, filename);
+    }
+
+  free(cost);
+
+  return;
+}
 
 /* integer_compare() -- comparison function used by qsort. which is greater?
  *
@@ -61,18 +61,31 @@
 static void setup_exo_res_desc	/* fix.c */
 PROTO((Exo_DB *));		/* exo - ptr to database */
 
+/*
+ * What the last fix in this run wrote: the monolith name, the number of
+ * pieces and the number of timeplanes. A later fix of the same monolith
+ * (Fix Frequency) only appends the newer timeplanes to it.
+ */
+
+static char Fixed_Name[FILENAME_MAX_ACK] = "";
+static int  Fixed_Procs = 0;
+static int  Fixed_Times = 0;
+
 
 int
 fix_exo_file(int num_procs, char* exo_mono_name)
 {
   int i;
   int p, pmax = 0, num_node_var_max=0;
-  int t;
+  int t, t_begin;
+  int status;
 
   Exo_DB *mono;			/* monolith mesh */
   Exo_DB *poly;			/* polylith mesh+dpi+results in */
+  Exo_DB **polys;		/* all of the polyliths, read once */
 
   Dpi *dpin;			/* polylith dpi in */
+  Dpi **dpins;
 
   char  monolith_file_name  [FILENAME_MAX_ACK]; /* original mesh */
 
@@ -113,119 +126,65 @@ fix_exo_file(int num_procs, char* exo_mono_name)
 
   ex_opts(EX_VERBOSE); 
 
-  /* Here we will loop through the pieces and find that which represents the most
-   * nodal variables to help with sizing of the monolith.  PRS-6/1/2010 
+  /*
+   * Read each polylith's mesh and dpi once and keep them for the whole
+   * fix; only their results are read again for each timeplane. While
+   * reading, find the piece with the most nodal variables to help with
+   * sizing of the monolith.  PRS-6/1/2010
    */
 
+  polys = (Exo_DB **) smalloc(num_procs * sizeof(Exo_DB *));
+  dpins = (Dpi **) smalloc(num_procs * sizeof(Dpi *));
+
+  strcpy(monolith_file_name, exo_mono_name);
+
   for ( p=0; p<num_procs; p++)
     { 
-      strcpy(polylith_name, exo_mono_name);
-
-      strcpy(monolith_file_name, polylith_name);
+      for ( i=0; i<FILENAME_MAX_ACK; i++)
+	{
+	  polylith_name[i] = '\0';
+	}
 
+      strcpy(polylith_name, exo_mono_name);
       multiname(polylith_name, p, num_procs);
 
 #ifdef DEBUG
-      /*  err = sscanf(line, "%s", in_exodus_file_name); */
-      fprintf(stderr, "monolith EXODUSII file = \"%s\"\n", monolith_file_name);
+      fprintf(stderr, "Fix: attempting to build a %d piece %s\n",
+	      num_procs, monolith_file_name);
 #endif
 
-      /*
-       * Make preliminary space for the monolithic database and the
-       * polylithic pieces.
-       *
-       * The strategy will be to look closely at the first polylithic piece
-       * in order to ascribe basic sizing information to the monolith.
-       *
-       * Then, the polyliths are traversed to slowly build the mesh and the
-       * results of the monolith. Several passes may be necessary...
-       */
-
-      poly = (Exo_DB *) smalloc(sizeof(Exo_DB));
-      dpin = (Dpi *) smalloc(sizeof(Dpi));
-
-      /*
-       * Open the first polylith to determine if there are many timeplanes
-       * of data.
-       *
-       * Assume that the first polylith is representative, that the number
-       * of nodal variables, the number of timeplanes, etc will be the same
-       * for each and every polylith encountered hereafter.
-       *
-       * The first polylith is important, too, in that much of the sizing
-       * information for the global problem will be derived from it.
-       */
+      poly = polys[p] = (Exo_DB *) smalloc(sizeof(Exo_DB));
+      dpin = dpins[p] = (Dpi *) smalloc(sizeof(Dpi));
 
       init_exo_struct(poly);
 
       init_dpi_struct(dpin);
 
       /*
-       * Some defaults are different for polylithic pieces - they have use these
-       * maps to relate themselves to the monolith...
-       *
-       * Now, these maps are part of the Dpi information and no longer piggybacked
-       * inside EXODUS II. Thus, don't attempt to read them if they aren't there.
-       */
-
-#ifdef DEBUG  
-      fprintf(stderr, "Fix: attempting to build a %d piece %s\n",
-	      num_procs, monolith_file_name);
-#endif
-
-      /*
-       * Read everything in the 1st polylith's EXODUS information except for
+       * Read everything in the polylith's EXODUS information except for
        * the results data per se...
        *
-       * Set to zero the variables that get used for allocating and writing...
+       * The maps that relate the polyliths to the monolith are part of the
+       * Dpi information, no longer piggybacked inside EXODUS II.
        */
 
       rd_exo(poly, polylith_name, 0, ( EXODB_ACTION_RD_INIT + 
 				       EXODB_ACTION_RD_MESH + 
 				       EXODB_ACTION_RD_RES0 ));
-
-      if (poly->num_node_vars > num_node_var_max) 
-	{
-	  num_node_var_max = poly->num_node_vars;
-	  pmax = p; 
-	}
-
       zero_base(poly);
 
       rd_dpi(dpin, polylith_name, 0);
-      free_dpi(dpin);
-      free(dpin);
 
+      /* The element block structures are not needed by fix. */
       free_element_blocks(poly);
 
-      free_exo(poly);
-      free(poly);
-   
+      if (poly->num_node_vars > num_node_var_max) 
+	{
+	  num_node_var_max = poly->num_node_vars;
+	  pmax = p; 
+	}
     }
 
-  /*
-   * Now that we know which piece to use, Build the monolithic skeleton...
-   */
-  strcpy(polylith_name, exo_mono_name);
-
-  strcpy(monolith_file_name, polylith_name);
-
-  multiname(polylith_name, pmax, num_procs);
-
-  poly = (Exo_DB *) smalloc(sizeof(Exo_DB));
-  dpin = (Dpi *) smalloc(sizeof(Dpi));
-
-  init_exo_struct(poly);
-
-  init_dpi_struct(dpin);
-
-  rd_exo(poly, polylith_name, 0, ( EXODB_ACTION_RD_INIT + 
-				       EXODB_ACTION_RD_MESH + 
-				       EXODB_ACTION_RD_RES0 ));
-  zero_base(poly);
-  rd_dpi(dpin, polylith_name, 0);
-
-
   mono = (Exo_DB *) smalloc(sizeof(Exo_DB));
   memset(mono, 0, sizeof(Exo_DB));
 
@@ -237,41 +196,12 @@ fix_exo_file(int num_procs, char* exo_mono_name)
    * the polylith sweep...
    */
 
-  build_big_bones(poly, dpin, mono);
-
-  free_dpi(dpin);
-  free(dpin);
-
-  free_element_blocks(poly);
-
-  free_exo(poly);
-  free(poly);
+  build_big_bones(polys[pmax], dpins[pmax], mono);
 
   for ( p=0; p<num_procs; p++)
     {
-      poly = (Exo_DB *) smalloc(sizeof(Exo_DB));
-      dpin = (Dpi *) smalloc(sizeof(Dpi));
-
-      init_dpi_struct(dpin);
-      init_exo_struct(poly);
-
-      for ( i=0; i<FILENAME_MAX_ACK; i++)
-	{
-	  polylith_name[i] = '\0';
-	}
-
-      strcpy(polylith_name, exo_mono_name);
-      multiname(polylith_name, p, num_procs);
-
-      /*
-       * Set actions...
-       */
-
-      rd_exo(poly, polylith_name, 0, ( EXODB_ACTION_RD_INIT + 
-				       EXODB_ACTION_RD_MESH ) );
-      zero_base(poly);
-
-      rd_dpi(dpin, polylith_name, 0);
+      poly = polys[p];
+      dpin = dpins[p];
 
       build_global_coords(poly, dpin, mono);
 
@@ -293,20 +223,48 @@ fix_exo_file(int num_procs, char* exo_mono_name)
        */
 
       build_global_ss(poly, dpin, mono);
+    }
 
-      free_element_blocks(poly);
+  /*
+   * If an earlier fix in this run already wrote the first timeplanes of
+   * this same monolith, and the file still holds exactly those, only the
+   * newer timeplanes are added. Otherwise write the monolith afresh.
+   */
 
-      free_exo(poly);
-      free(poly);
+  t_begin = 0;
+  if ( strcmp(Fixed_Name, monolith_file_name) == 0 &&
+       Fixed_Procs == num_procs &&
+       Fixed_Times > 0 && Fixed_Times <= mono->num_times )
+    {
+      int exoid, cpu_ws = sizeof(dbl), io_ws = 0, ri;
+      float version, rf;
+      char rc[MAX_STR_LENGTH+1];
 
-      free_dpi(dpin);
-      free(dpin);
+      exoid = ex_open(monolith_file_name, EX_WRITE, &cpu_ws, &io_ws, &version);
+      if ( exoid >= 0 )
+	{
+	  if ( ex_inquire(exoid, EX_INQ_TIME, &ri, &rf, rc) >= 0 &&
+	       ri == Fixed_Times )
+	    {
+	      for ( t=Fixed_Times; t<mono->num_times; t++)
+		{
+		  status = ex_put_time(exoid, t+1, &(mono->time_vals[t]));
+		  EH(status, "ex_put_time");
+		}
+	      t_begin = Fixed_Times;
+	    }
+	  status = ex_close(exoid);
+	  EH(status, "ex_close");
+	}
     }
 
-  one_base(mono);
-  wr_mesh_exo(mono, monolith_file_name, 0);
-  wr_resetup_exo(mono, monolith_file_name, 0);
-  zero_base(mono);
+  if ( t_begin == 0 )
+    {
+      one_base(mono);
+      wr_mesh_exo(mono, monolith_file_name, 0);
+      wr_resetup_exo(mono, monolith_file_name, 0);
+      zero_base(mono);
+    }
 
   /*
    * Now sweep through polyliths while there are timeplanes of results
@@ -323,19 +281,12 @@ fix_exo_file(int num_procs, char* exo_mono_name)
   fprintf(stderr, "mono->num_times = %d\n", mono->num_times);
 #endif
 
-  for ( t=0; t<mono->num_times; t++)
+  for ( t=t_begin; t<mono->num_times; t++)
     {
       for ( p=0; p<num_procs; p++)
 	{
-	  poly = (Exo_DB *) smalloc(sizeof(Exo_DB));
-	  dpin = (Dpi *) smalloc(sizeof(Dpi));
-
-	  /*
-	   * Initialize to semisanity...
-	   */
-
-	  init_dpi_struct(dpin);
-	  init_exo_struct(poly);
+	  poly = polys[p];
+	  dpin = dpins[p];
 
 	  for ( i=0; i<FILENAME_MAX_ACK; i++)
 	    {
@@ -345,16 +296,6 @@ fix_exo_file(int num_procs, char* exo_mono_name)
 	  strcpy(polylith_name, exo_mono_name);
 	  multiname(polylith_name, p, num_procs);
 
-	  /*
-	   * Set actions - what to fetch from the polylith databases.
-	   */
-	  
-	  rd_exo(poly, polylith_name, 0, ( EXODB_ACTION_RD_INIT +
-					   EXODB_ACTION_RD_MESH +
-					   EXODB_ACTION_RD_RES0 ));
-	  zero_base(poly);
-	  rd_dpi(dpin, polylith_name, 0);
-	  
 	  /*
 	   * Now indicate what variables and time planes to read from the
 	   * individual polyliths...
@@ -445,16 +386,6 @@ fix_exo_file(int num_procs, char* exo_mono_name)
 		  poly->nv_time_indeces[0]);
 #endif
 
-	  free_dpi(dpin);
-	  free(dpin);
-
-          free_element_blocks(poly);
-
-          free_exo_gv(poly);
-          free_exo_nv(poly);
-          free_exo_ev(poly);
-	  free_exo(poly);
-	  free(poly);
 	}
 
       /*
@@ -507,6 +438,24 @@ fix_exo_file(int num_procs, char* exo_mono_name)
       zero_base(mono);
     }
 
+  strcpy(Fixed_Name, monolith_file_name);
+  Fixed_Procs = num_procs;
+  Fixed_Times = mono->num_times;
+
+  for ( p=0; p<num_procs; p++)
+    {
+      free_dpi(dpins[p]);
+      free(dpins[p]);
+
+      free_exo_gv(polys[p]);
+      free_exo_nv(polys[p]);
+      free_exo_ev(polys[p]);
+      free_exo(polys[p]);
+      free(polys[p]);
+    }
+  free(polys);
+  free(dpins);
+
   free_exo_gv(mono);
   free_exo_nv(mono);
   free_exo_ev(mono);
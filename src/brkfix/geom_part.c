@@ -0,0 +1,337 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/* geom_partition() -- built-in geometric partition of the brk graph
+ *
+ * Notes:
+ *
+ *	[1]	An alternative to Chaco for the "Brk Partitioner" card. The
+ *		verteces of the brk graph are the finite element nodes, so
+ *		they are cut by the coordinates of the nodes and weighed with
+ *		the vertex weights of the graph (the assembled terms of each
+ *		node, or the measured element costs); the edges are not
+ *		looked at, which is what makes it fast.
+ *
+ *	[2]	rcb - recursive coordinate bisection; each box is cut
+ *		across its longest extent into two halves of weight in
+ *		proportion to the number of sets each half will hold.
+ *
+ *		hilbert - the verteces are put in the order of a Hilbert
+ *		curve through the bounding box and the curve is cut into
+ *		nsets pieces of equal weight. Cheaper than rcb, usually with
+ *		a few more cut edges.
+ *
+ *	[3]	assignment[] is filled the way Chaco fills it, with the set
+ *		0..nsets-1 of each vertex.
+ *
+ * Created: 2026/10/14
+ */
+
+#define _GEOM_PART_C
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+
+#include "goma.h"
+
+#include "brkfix/brkfix.h"
+#include "mm_eh.h"
+#include "rf_allo.h"
+#include "brkfix/geom_part.h"
+
+typedef struct
+{
+  uint64_t key;
+  int v;
+} Curve_Point;
+
+static flt *Sort_Coord;		/* qsort() key of coord_compare() */
+
+static int
+coord_compare(const void *a, const void *b)
+{
+  int ia = *((const int *)a);
+  int ib = *((const int *)b);
+
+  if ( Sort_Coord[ia] < Sort_Coord[ib] ) return(-1);
+  if ( Sort_Coord[ia] > Sort_Coord[ib] ) return(1);
+  return(ia - ib);
+}
+
+static int
+curve_compare(const void *a, const void *b)
+{
+  const Curve_Point *pa = (const Curve_Point *)a;
+  const Curve_Point *pb = (const Curve_Point *)b;
+
+  if ( pa->key < pb->key ) return(-1);
+  if ( pa->key > pb->key ) return(1);
+  return(pa->v - pb->v);
+}
+
+/*
+ * rcb_split() -- put the n verteces of perm[] into sets
+ * first_set..first_set+nsets-1.
+ */
+
+static void
+rcb_split(int *perm,
+	  const int n,
+	  const int first_set,
+	  const int nsets,
+	  flt *c[],
+	  const int ndim,
+	  const int *vwgts,
+	  int *assignment)
+{
+  int d, dcut, i, m, k1;
+  dbl lo, hi, extent, total, target, cum, w;
+
+  if ( n == 0 ) return;
+
+  if ( nsets == 1 )
+    {
+      for ( i=0; i<n; i++)
+	{
+	  assignment[perm[i]] = first_set;
+	}
+      return;
+    }
+
+  dcut   = 0;
+  extent = -1;
+  for ( d=0; d<ndim; d++)
+    {
+      lo = hi = c[d][perm[0]];
+      for ( i=1; i<n; i++)
+	{
+	  lo = MIN(lo, c[d][perm[i]]);
+	  hi = MAX(hi, c[d][perm[i]]);
+	}
+      if ( hi - lo > extent )
+	{
+	  extent = hi - lo;
+	  dcut   = d;
+	}
+    }
+
+  Sort_Coord = c[dcut];
+  qsort(perm, n, sizeof(int), coord_compare);
+
+  total = 0;
+  for ( i=0; i<n; i++)
+    {
+      total += ( vwgts == NULL ) ? 1 : vwgts[perm[i]];
+    }
+  if ( total <= 0 )
+    {
+      vwgts = NULL;		/* all lazy -- share them by count */
+      total = n;
+    }
+
+  k1     = nsets/2;
+  target = total * (dbl)k1 / (dbl)nsets;
+
+  cum = 0;
+  m   = 0;
+  while ( m < n )
+    {
+      w = ( vwgts == NULL ) ? 1 : vwgts[perm[m]];
+      if ( cum + 0.5*w > target ) break;
+      cum += w;
+      m++;
+    }
+
+  /*
+   * Leave at least one vertex for every set, when there are enough.
+   */
+
+  if ( n >= nsets )
+    {
+      m = MAX(k1, MIN(m, n - (nsets - k1)));
+    }
+
+  rcb_split(perm, m, first_set, k1, c, ndim, vwgts, assignment);
+  rcb_split(perm+m, n-m, first_set+k1, nsets-k1, c, ndim, vwgts, assignment);
+}
+
+/*
+ * hilbert_key() -- position along the Hilbert curve of the grid point X[]
+ * of b bits in each of n dimensions (Skilling, "Programming the Hilbert
+ * curve", AIP Conf. Proc. 707, 2004). X[] is overwritten.
+ */
+
+static uint64_t
+hilbert_key(unsigned int *X,
+	    const int b,
+	    const int n)
+{
+  unsigned int M = 1U << (b-1);
+  unsigned int P, Q, t;
+  uint64_t key = 0;
+  int i, j;
+
+  if ( n == 1 ) return((uint64_t)X[0]);
+
+  for ( Q=M; Q>1; Q>>=1)
+    {
+      P = Q - 1;
+      for ( i=0; i<n; i++)
+	{
+	  if ( X[i] & Q )
+	    {
+	      X[0] ^= P;
+	    }
+	  else
+	    {
+	      t = (X[0] ^ X[i]) & P;
+	      X[0] ^= t;
+	      X[i] ^= t;
+	    }
+	}
+    }
+
+  for ( i=1; i<n; i++)
+    {
+      X[i] ^= X[i-1];
+    }
+  t = 0;
+  for ( Q=M; Q>1; Q>>=1)
+    {
+      if ( X[n-1] & Q ) t ^= Q - 1;
+    }
+  for ( i=0; i<n; i++)
+    {
+      X[i] ^= t;
+    }
+
+  for ( j=b-1; j>=0; j--)
+    {
+      for ( i=0; i<n; i++)
+	{
+	  key = (key << 1) | ((X[i] >> j) & 1U);
+	}
+    }
+
+  return(key);
+}
+
+static void
+hilbert_split(const int nvtxs,
+	      flt *c[],
+	      const int ndim,
+	      const int *vwgts,
+	      const int nsets,
+	      int *assignment)
+{
+  int b, d, i, s;
+  unsigned int X[3];
+  dbl lo[3], scale[3], total, cum, w;
+  Curve_Point *curve;
+
+  b = ( ndim == 3 ) ? 21 : 31;	/* all of a 64 bit key */
+
+  for ( d=0; d<ndim; d++)
+    {
+      dbl hi;
+      lo[d] = hi = c[d][0];
+      for ( i=1; i<nvtxs; i++)
+	{
+	  lo[d] = MIN(lo[d], c[d][i]);
+	  hi    = MAX(hi, c[d][i]);
+	}
+      scale[d] = ( hi > lo[d] ) ? ((dbl)((1U << b) - 1)) / (hi - lo[d]) : 0;
+    }
+
+  curve = (Curve_Point *) smalloc(nvtxs*sizeof(Curve_Point));
+
+  for ( i=0; i<nvtxs; i++)
+    {
+      for ( d=0; d<ndim; d++)
+	{
+	  X[d] = (unsigned int)((c[d][i] - lo[d]) * scale[d]);
+	}
+      curve[i].key = hilbert_key(X, b, ndim);
+      curve[i].v   = i;
+    }
+
+  qsort(curve, nvtxs, sizeof(Curve_Point), curve_compare);
+
+  total = 0;
+  for ( i=0; i<nvtxs; i++)
+    {
+      total += ( vwgts == NULL ) ? 1 : vwgts[i];
+    }
+  if ( total <= 0 )
+    {
+      vwgts = NULL;
+      total = nvtxs;
+    }
+
+  /*
+   * Each vertex goes to the set its midpoint along the curve falls in.
+   */
+
+  cum = 0;
+  for ( i=0; i<nvtxs; i++)
+    {
+      w = ( vwgts == NULL ) ? 1 : vwgts[curve[i].v];
+      s = (int)((cum + 0.5*w) * nsets / total);
+      assignment[curve[i].v] = MIN(s, nsets-1);
+      cum += w;
+    }
+
+  free(curve);
+}
+
+void
+geom_partition(const int method,
+	       const int nvtxs,
+	       const int ndim,
+	       flt *x,
+	       flt *y,
+	       flt *z,
+	       const int *vwgts,
+	       const int nsets,
+	       int *assignment)
+{
+  int i;
+  int *perm;
+  flt *c[3];
+
+  if ( ndim < 1 || ndim > 3 || x == NULL )
+    {
+      EH(-1, "Geometric partition needs 1 to 3 coordinates.");
+    }
+
+  c[0] = x;
+  c[1] = y;
+  c[2] = z;
+
+  if ( method == BRK_PART_HILBERT )
+    {
+      hilbert_split(nvtxs, c, ndim, vwgts, nsets, assignment);
+    }
+  else
+    {
+      perm = (int *) smalloc(nvtxs*SZ_INT);
+      for ( i=0; i<nvtxs; i++)
+	{
+	  perm[i] = i;
+	}
+      rcb_split(perm, nvtxs, 0, nsets, c, ndim, vwgts, assignment);
+      free(perm);
+    }
+
+  return;
+}
@@ -40,69 +40,417 @@ static char rcsid[] = "$Id: dp_comm.c,v 5.1 2007-09-18 18:53:41 prschun Exp $";
 #define _DP_COMM_C
 #include "goma.h"
 
+/*
+ * Persistent halo exchange plans.
+ *
+ * exchange_dof() and exchange_node() are called many times per time step
+ * on the same communication pattern. Rather than allocating the message
+ * buffers and posting fresh Irecv/Isend pairs on every call, a plan is
+ * built the first time a pattern is used: pre-sized send and receive
+ * buffers plus persistent MPI requests (MPI_Send_init/MPI_Recv_init) for
+ * every neighbor. Each exchange then only packs, starts, waits and
+ * unpacks.
+ *
+ * One plan is kept for each kind of exchange (dof or node) and for each
+ * number of vectors moved together, 1..MAX_EXCHANGE_VECS. For nvec > 1,
+ * the message to a neighbor carries the nvec vectors one after the other,
+ * so all of them go out in a single round of messages. A plan is rebuilt
+ * if the send map it was built from changes.
+ */
+
+#define MAX_EXCHANGE_VECS 4
+
+#define EXCH_DOF  0
+#define EXCH_NODE 1
+
+#define EXCH_MTYPE 116		/* exchange_neighbor_proc_info() uses 115 */
+
+struct Exchange_Plan {
+  int     built;
+  int     num_neighbors;
+  int    *ptr_send;		/* send map the plan was built from */
+  int    *list_send;
+  int     total_send;
+  int     total_recv;
+  double *send_buf;		/* [nvec*total_send] */
+  double *recv_buf;		/* [nvec*total_recv] */
+#ifdef PARALLEL
+  MPI_Request *request;		/* [2*num_neighbors], recvs then sends */
+  MPI_Status  *status;
+#endif
+};
+
+static struct Exchange_Plan Exchange_Plans[2][MAX_EXCHANGE_VECS];
+
 /********************************************************************/
 /********************************************************************/
 /********************************************************************/
 
-void 
-exchange_dof(Comm_Ex *cx,  Dpi *dpi,  double *x)
+static void
+exchange_plan_free(struct Exchange_Plan *plan)
+{
+#ifdef PARALLEL
+  int p;
+
+  if (!plan->built) return;
+
+  for (p = 0; p < 2 * plan->num_neighbors; p++) {
+    MPI_Request_free(plan->request + p);
+  }
+  safer_free((void **) &plan->request);
+  safer_free((void **) &plan->status);
+#endif
+  safer_free((void **) &plan->send_buf);
+  safer_free((void **) &plan->recv_buf);
+  plan->built = FALSE;
+}
+/********************************************************************/
+/********************************************************************/
+/********************************************************************/
+
+static struct Exchange_Plan *
+exchange_plan(const int kind, const int nvec, Comm_Ex *cx, Dpi *dpi)
 
     /************************************************************
      *
-     *  exchange_dof():
+     *  exchange_plan():
      *
-     *  send/recv appropriate pieces of a dof-based double array
+     *  return the plan for moving nvec vectors of the given kind,
+     *  building (or rebuilding) it if necessary
      ************************************************************/
 {
-  COMM_NP_STRUCT *np_base, *np_ptr;
-  double *ptr_send_list, *ptr_recv_list;
-  register double *ptrd;
-  register int *ptr_int, i;
-  int p;
+  struct Exchange_Plan *plan = &Exchange_Plans[kind][nvec-1];
+  int *ptr_send  = (kind == EXCH_DOF) ? ptr_dof_send  : ptr_node_send;
+  int *list_send = (kind == EXCH_DOF) ? list_dof_send : list_node_send;
   int num_neighbors = dpi->num_neighbors;
-  int total_num_send_unknowns;
+#ifdef PARALLEL
+  int p, off_send, off_recv, nsend, nrecv;
+  char *yo = "exchange_plan";
+#endif
+
+  if (plan->built &&
+      plan->num_neighbors == num_neighbors &&
+      plan->ptr_send == ptr_send &&
+      plan->list_send == list_send &&
+      plan->total_send == ptr_send[num_neighbors]) {
+    return plan;
+  }
 
-  if (num_neighbors == 0) return;
+  exchange_plan_free(plan);
 
+  plan->num_neighbors = num_neighbors;
+  plan->ptr_send = ptr_send;
+  plan->list_send = list_send;
+  plan->total_send = ptr_send[num_neighbors];
+  plan->total_recv = 0;
 #ifdef PARALLEL
-  total_num_send_unknowns = ptr_dof_send[dpi->num_neighbors];
-  np_base = alloc_struct_1(COMM_NP_STRUCT, dpi->num_neighbors);
-  ptrd = (double *) alloc_dbl_1(total_num_send_unknowns, DBL_NOINIT);    
-  ptr_send_list = ptrd;
+  for (p = 0; p < num_neighbors; p++) {
+    plan->total_recv += (kind == EXCH_DOF) ? cx[p].num_dofs_recv :
+                                             cx[p].num_nodes_recv;
+  }
 
-  /*
-   * gather up the list of send unknowns
-   */
-  ptr_int = list_dof_send;
-  for (i = total_num_send_unknowns; i > 0; i--) {
-    *ptrd++ = x[*ptr_int++];
+  plan->send_buf = alloc_dbl_1(nvec * plan->total_send, DBL_NOINIT);
+  plan->recv_buf = alloc_dbl_1(nvec * plan->total_recv, DBL_NOINIT);
+  plan->request = (MPI_Request *)
+                  smalloc(2 * num_neighbors * sizeof(MPI_Request));
+  plan->status = (MPI_Status *)
+                 smalloc(2 * num_neighbors * sizeof(MPI_Status));
+
+  off_recv = 0;
+  for (p = 0; p < num_neighbors; p++) {
+    off_send = ptr_send[p];
+    nsend = (kind == EXCH_DOF) ? cx[p].num_dofs_send : cx[p].num_nodes_send;
+    nrecv = (kind == EXCH_DOF) ? cx[p].num_dofs_recv : cx[p].num_nodes_recv;
+
+    if (MPI_Recv_init(plan->recv_buf + nvec * off_recv, nvec * nrecv,
+		      MPI_DOUBLE, cx[p].neighbor_name, EXCH_MTYPE,
+		      MPI_COMM_WORLD, plan->request + p) != MPI_SUCCESS) {
+      EH(-1, "MPI_Recv_init failed");
+    }
+    if (MPI_Send_init(plan->send_buf + nvec * off_send, nvec * nsend,
+		      MPI_DOUBLE, cx[p].neighbor_name, EXCH_MTYPE,
+		      MPI_COMM_WORLD, plan->request + num_neighbors + p)
+	!= MPI_SUCCESS) {
+      EH(-1, "MPI_Send_init failed");
+    }
+    off_recv += nrecv;
+  }
+  log_msg("%s exchange with %d neighbors, %d vector(s)",
+	  (kind == EXCH_DOF) ? "dof" : "node", num_neighbors, nvec);
+#endif
+
+  plan->built = TRUE;
+  return plan;
+}
+/********************************************************************/
+/********************************************************************/
+/********************************************************************/
+
+/*
+ * An exchange that has been started but not yet finished. Only one can be
+ * outstanding; starting another finishes it first, since the two could
+ * share a plan and its buffers.
+ */
+
+static struct Exchange_Plan *Pending_Plan = NULL;
+static int      Pending_Kind;
+static int      Pending_Nvec;
+static Comm_Ex *Pending_cx;
+static Dpi     *Pending_dpi;
+static double  *Pending_xs[MAX_EXCHANGE_VECS];
+
+static void exchange_vectors_finish(void);
+
+/********************************************************************/
+/********************************************************************/
+/********************************************************************/
+
+static void
+exchange_vectors_start(const int kind, Comm_Ex *cx, Dpi *dpi,
+		       const int nvec, double **xs)
+
+    /************************************************************
+     *
+     *  exchange_vectors_start():
+     *
+     *  post the receives and send the halo pieces of nvec vectors
+     *  of the given kind; exchange_vectors_finish() completes it
+     ************************************************************/
+{
+#ifdef PARALLEL
+  struct Exchange_Plan *plan;
+  double *ptrd, *x;
+  int *ptr_int;
+  int i, p, v, n, off_send;
+  int num_neighbors = dpi->num_neighbors;
+
+  if (Pending_Plan != NULL) exchange_vectors_finish();
+
+  timer_push("halo exchange");
+  plan = exchange_plan(kind, nvec, cx, dpi);
+
+  if (MPI_Startall(num_neighbors, plan->request) != MPI_SUCCESS) {
+    EH(-1, "MPI_Startall failed on receives");
   }
 
   /*
-   * store base address for the start of the external degrees of freedom
-   * in this vector
+   * gather up the send unknowns, neighbor by neighbor, with the
+   * nvec vectors laid end to end within each neighbor's message
    */
-  ptr_recv_list = x + num_internal_dofs + num_boundary_dofs;
-  
-  np_ptr = np_base;
-  for (p = 0; p < dpi->num_neighbors; p++) {
-    np_ptr->neighbor_ProcID = cx[p].neighbor_name;
-    np_ptr->send_message_buf = (void *)
-	                       (ptr_send_list + ptr_dof_send[p]);
-    np_ptr->send_message_length = sizeof(double) * cx[p].num_dofs_send;
-    np_ptr->recv_message_buf = (void *) ptr_recv_list;
-    np_ptr->recv_message_length = sizeof(double) * cx[p].num_dofs_recv;
-    ptr_recv_list += cx[p].num_dofs_recv;
-    np_ptr++;
+  ptrd = plan->send_buf;
+  for (p = 0; p < num_neighbors; p++) {
+    off_send = plan->ptr_send[p];
+    n = plan->ptr_send[p+1] - off_send;
+    for (v = 0; v < nvec; v++) {
+      x = xs[v];
+      ptr_int = plan->list_send + off_send;
+      for (i = n; i > 0; i--) {
+	*ptrd++ = x[*ptr_int++];
+      }
+    }
+  }
+
+  if (MPI_Startall(num_neighbors, plan->request + num_neighbors)
+      != MPI_SUCCESS) {
+    EH(-1, "MPI_Startall failed on sends");
+  }
+  if (COMM_PROF_ON) {
+    for (p = 0; p < num_neighbors; p++) {
+      n = plan->ptr_send[p+1] - plan->ptr_send[p];
+      comm_prof_send(cx[p].neighbor_name, nvec * n * (int) sizeof(double));
+    }
+  }
+
+  Pending_Plan = plan;
+  Pending_Kind = kind;
+  Pending_Nvec = nvec;
+  Pending_cx   = cx;
+  Pending_dpi  = dpi;
+  for (v = 0; v < nvec; v++) {
+    Pending_xs[v] = xs[v];
+  }
+  timer_pop("halo exchange");
+#endif /* PARALLEL */
+}
+/********************************************************************/
+/********************************************************************/
+/********************************************************************/
+
+static void
+exchange_vectors_finish(void)
+
+    /************************************************************
+     *
+     *  exchange_vectors_finish():
+     *
+     *  wait for the outstanding exchange, if any, and scatter what
+     *  was received into the external entries of each vector
+     ************************************************************/
+{
+#ifdef PARALLEL
+  struct Exchange_Plan *plan = Pending_Plan;
+  Comm_Ex *cx = Pending_cx;
+  double *ptrd, *x;
+  int i, p, v, n, off_recv, recv_base;
+  int num_neighbors;
+
+  if (plan == NULL) return;
+  Pending_Plan = NULL;
+  timer_push("halo exchange");
+
+  num_neighbors = Pending_dpi->num_neighbors;
+
+  if (COMM_PROF_ON) {
+    /* the receives one by one, for the wait on each neighbor */
+    dbl t0 = MPI_Wtime();
+    MPI_Status status;
+    for (i = 0; i < num_neighbors; i++) {
+      if (MPI_Waitany(num_neighbors, plan->request, &p, &status) != MPI_SUCCESS) {
+	EH(-1, "MPI_Waitany failed");
+      }
+      if (p == MPI_UNDEFINED) break;
+      n = (Pending_Kind == EXCH_DOF) ? cx[p].num_dofs_recv :
+                                       cx[p].num_nodes_recv;
+      comm_prof_recv(cx[p].neighbor_name, Pending_Nvec * n * (int) sizeof(double),
+		     MPI_Wtime() - t0);
+    }
   }
-  exchange_neighbor_proc_info(dpi->num_neighbors, np_base);
-  safer_free((void **) &np_base);
-  safer_free((void **) &ptr_send_list);
+  if (MPI_Waitall(2 * num_neighbors, plan->request, plan->status)
+      != MPI_SUCCESS) {
+    EH(-1, "MPI_Waitall failed");
+  }
+
+  recv_base = (Pending_Kind == EXCH_DOF) ?
+              num_internal_dofs + num_boundary_dofs :
+              Pending_dpi->num_internal_nodes + Pending_dpi->num_boundary_nodes;
+
+  ptrd = plan->recv_buf;
+  off_recv = 0;
+  for (p = 0; p < num_neighbors; p++) {
+    n = (Pending_Kind == EXCH_DOF) ? cx[p].num_dofs_recv :
+                                     cx[p].num_nodes_recv;
+    for (v = 0; v < Pending_Nvec; v++) {
+      x = Pending_xs[v] + recv_base + off_recv;
+      for (i = n; i > 0; i--) {
+	*x++ = *ptrd++;
+      }
+    }
+    off_recv += n;
+  }
+  timer_pop("halo exchange");
 #endif /* PARALLEL */
 }
 /********************************************************************/
 /********************************************************************/
 /********************************************************************/
+
+static void
+exchange_vectors(const int kind, Comm_Ex *cx, Dpi *dpi,
+		 const int nvec, double **xs)
+
+    /************************************************************
+     *
+     *  exchange_vectors():
+     *
+     *  send/recv the halo pieces of nvec vectors of the given kind
+     *  in one round of messages
+     ************************************************************/
+{
+  exchange_vectors_start(kind, cx, dpi, nvec, xs);
+  exchange_vectors_finish();
+}
+/********************************************************************/
+/********************************************************************/
+/********************************************************************/
+
+void 
+exchange_dof(Comm_Ex *cx,  Dpi *dpi,  double *x)
+
+    /************************************************************
+     *
+     *  exchange_dof():
+     *
+     *  send/recv appropriate pieces of a dof-based double array
+     ************************************************************/
+{
+  if (dpi->num_neighbors == 0) return;
+
+  exchange_vectors(EXCH_DOF, cx, dpi, 1, &x);
+}
+/********************************************************************/
+/********************************************************************/
+/********************************************************************/
+
+void 
+exchange_dof_begin(Comm_Ex *cx,  Dpi *dpi,  double *x)
+
+    /************************************************************
+     *
+     *  exchange_dof_begin():
+     *
+     *  start exchange_dof() without waiting for it. The external
+     *  entries of x are not valid until exchange_dof_end(); the
+     *  internal and boundary entries may be read meanwhile, but
+     *  must not be changed.
+     ************************************************************/
+{
+  if (dpi->num_neighbors == 0) return;
+
+  exchange_vectors_start(EXCH_DOF, cx, dpi, 1, &x);
+}
+/********************************************************************/
+/********************************************************************/
+/********************************************************************/
+
+void 
+exchange_dof_end(void)
+
+    /************************************************************
+     *
+     *  exchange_dof_end():
+     *
+     *  finish the exchange started by exchange_dof_begin(), if it
+     *  is still outstanding
+     ************************************************************/
+{
+  exchange_vectors_finish();
+}
+/********************************************************************/
+/********************************************************************/
+/********************************************************************/
+
+int
+exchange_pending(void)
+{
+  return (Pending_Plan != NULL);
+}
+/********************************************************************/
+/********************************************************************/
+/********************************************************************/
+
+void 
+exchange_dof_multi(Comm_Ex *cx,  Dpi *dpi,  const int nvec,  double **xs)
+
+    /************************************************************
+     *
+     *  exchange_dof_multi():
+     *
+     *  exchange_dof() for nvec dof-based vectors at once, in a
+     *  single round of messages (up to MAX_EXCHANGE_VECS at a time)
+     ************************************************************/
+{
+  int v, n;
+
+  if (dpi->num_neighbors == 0) return;
+
+  for (v = 0; v < nvec; v += n) {
+    n = MIN(nvec - v, MAX_EXCHANGE_VECS);
+    exchange_vectors(EXCH_DOF, cx, dpi, n, xs + v);
+  }
+}
+/********************************************************************/
+/********************************************************************/
+/********************************************************************/
 /*    
 {
 #ifdef PARALLEL
@@ -146,57 +494,62 @@ exchange_node(Comm_Ex *cx,  Dpi *dpi,  double *x)
 
     /************************************************************
      *
-     *  exchange_dof():
+     *  exchange_node():
      *
      *  send/recv appropriate pieces of a node-based double array
      ************************************************************/
 {
-  COMM_NP_STRUCT *np_base, *np_ptr;
-  double *ptr_send_list, *ptr_recv_list;
-  register double *ptrd;
-  register int *ptr_int, i;
-  int p;
-  int num_neighbors = dpi->num_neighbors;
-  int total_num_send_unknowns;
+  if (dpi->num_neighbors == 0) return;
 
-  if (num_neighbors == 0) return;
+  exchange_vectors(EXCH_NODE, cx, dpi, 1, &x);
+}
+/********************************************************************/
+/********************************************************************/
+/********************************************************************/
 
-#ifdef PARALLEL
-  total_num_send_unknowns = ptr_node_send[dpi->num_neighbors];
-  np_base = alloc_struct_1(COMM_NP_STRUCT, dpi->num_neighbors);
-  ptrd = (double *) alloc_dbl_1(total_num_send_unknowns, DBL_NOINIT);    
-  ptr_send_list = ptrd;
+void 
+exchange_node_multi(Comm_Ex *cx,  Dpi *dpi,  const int nvec,  double **xs)
 
-  /*
-   * gather up the list of send unknowns
-   */
-  ptr_int = list_node_send;
-  for (i = total_num_send_unknowns; i > 0; i--) {
-    *ptrd++ = x[*ptr_int++];
+    /************************************************************
+     *
+     *  exchange_node_multi():
+     *
+     *  exchange_node() for nvec node-based vectors at once, in a
+     *  single round of messages (up to MAX_EXCHANGE_VECS at a time)
+     ************************************************************/
+{
+  int v, n;
+
+  if (dpi->num_neighbors == 0) return;
+
+  for (v = 0; v < nvec; v += n) {
+    n = MIN(nvec - v, MAX_EXCHANGE_VECS);
+    exchange_vectors(EXCH_NODE, cx, dpi, n, xs + v);
   }
+}
+/********************************************************************/
+/********************************************************************/
+/********************************************************************/
 
-  /*
-   * store base address for the start of the entries corresponding
-   * to external nodes in this vector
-   */
-  ptr_recv_list = x + dpi->num_internal_nodes +
-                      dpi->num_boundary_nodes;
-  
-  np_ptr = np_base;
-  for (p = 0; p < dpi->num_neighbors; p++) {
-    np_ptr->neighbor_ProcID = cx[p].neighbor_name;
-    np_ptr->send_message_buf = (void *)
-	                       (ptr_send_list + ptr_node_send[p]);
-    np_ptr->send_message_length = sizeof(double) * cx[p].num_nodes_send;
-    np_ptr->recv_message_buf = (void *) ptr_recv_list;
-    np_ptr->recv_message_length = sizeof(double) * cx[p].num_nodes_recv;
-    ptr_recv_list += cx[p].num_nodes_recv;
-    np_ptr++;
+void
+exchange_free(void)
+
+    /************************************************************
+     *
+     *  exchange_free():
+     *
+     *  release the persistent exchange buffers and requests
+     ************************************************************/
+{
+  int k, v;
+
+  exchange_vectors_finish();
+
+  for (k = 0; k < 2; k++) {
+    for (v = 0; v < MAX_EXCHANGE_VECS; v++) {
+      exchange_plan_free(&Exchange_Plans[k][v]);
+    }
   }
-  exchange_neighbor_proc_info(dpi->num_neighbors, np_base);
-  safer_free((void **) &np_base);
-  safer_free((void **) &ptr_send_list);
-#endif
 }
 /********************************************************************/
 /********************************************************************/
@@ -0,0 +1,434 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * Communication profile.
+ *
+ * With a Communication Report File named, every processor counts the
+ * messages and bytes it sends to and receives from each neighbor in the
+ * halo exchanges (exchange_dof(), exchange_node(), and
+ * exchange_neighbor_proc_info()), with the seconds it waited for each
+ * neighbor's message. Every MPI_Allreduce goes through std.h's macro to
+ * comm_allreduce_FL(), which counts the calls, bytes and seconds of each
+ * call site. The waits of a collective include the load imbalance ahead
+ * of it, which is the point: a site whose maximum is far above its
+ * average waits on a slow rank.
+ *
+ * comm_report() gathers it all on processor 0 at the end of the run and
+ * writes, as JSON, the communication matrix (one entry per processor and
+ * neighbor), the processors with the most halo volume and halo wait, and
+ * the call sites with the min, average and max of their times.
+ *
+ * The exchanges inside the linear solvers are not seen here.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define _DP_COMM_PROF_C
+#include "std.h"
+#include "rf_io_const.h"
+#include "rf_mp.h"
+#include "rf_allo.h"
+#include "mm_eh.h"
+#include "goma.h"
+
+char Comm_Report_File[MAX_FNL] = "";
+
+/*
+ * Counters of the traffic with one other processor, indexed by its rank
+ */
+struct comm_peer
+{
+  dbl msgs_sent;
+  dbl msgs_recv;
+  dbl bytes_sent;
+  dbl bytes_recv;
+  dbl wait;			/* seconds waited for its messages */
+};
+
+#define COMM_PEER_VALS	5
+
+static struct comm_peer *Peer = NULL;	/* [Num_Proc] */
+
+/*
+ * Counters of one MPI_Allreduce call site
+ */
+#define COMM_MAX_SITES	256
+#define COMM_SITE_LEN	64		/* "file:line" */
+#define COMM_SITE_VALS	3
+#define COMM_TOP	10		/* processors listed by volume and wait */
+
+struct comm_site
+{
+  const char *file;
+  int line;
+  dbl calls;
+  dbl bytes;
+  dbl time;
+};
+
+static struct comm_site Site[COMM_MAX_SITES];
+static int Num_Sites = 0;
+static int Sites_Dropped = FALSE;
+
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
+static struct comm_peer *
+comm_peer(const int rank)
+{
+  if (Peer == NULL) {
+    Peer = (struct comm_peer *) smalloc(Num_Proc * sizeof(struct comm_peer));
+    memset(Peer, 0, Num_Proc * sizeof(struct comm_peer));
+  }
+  return (Peer + rank);
+}
+/*****************************************************************************/
+
+void
+comm_prof_send(const int rank,
+	       const int bytes)
+{
+  struct comm_peer *q;
+
+  if (!COMM_PROF_ON || rank < 0 || rank >= Num_Proc) return;
+  q = comm_peer(rank);
+  q->msgs_sent += 1.;
+  q->bytes_sent += bytes;
+}
+/*****************************************************************************/
+
+void
+comm_prof_recv(const int rank,
+	       const int bytes,
+	       const dbl wait)
+{
+  struct comm_peer *q;
+
+  if (!COMM_PROF_ON || rank < 0 || rank >= Num_Proc) return;
+  q = comm_peer(rank);
+  q->msgs_recv += 1.;
+  q->bytes_recv += bytes;
+  q->wait += wait;
+}
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
+#ifdef PARALLEL
+int
+comm_allreduce_FL(const void *sendbuf,
+		  void *recvbuf,
+		  int count,
+		  MPI_Datatype datatype,
+		  MPI_Op op,
+		  MPI_Comm comm,
+		  const char *file,
+		  const int line)
+
+    /*************************************************************************
+     *
+     * comm_allreduce_FL():
+     *
+     *  MPI_Allreduce, with its calls, bytes and seconds charged to the
+     *  call site file:line when the profile is on.
+     *************************************************************************/
+{
+  int err, s, size;
+  dbl t0;
+
+  if (!COMM_PROF_ON) {
+    return (MPI_Allreduce((void *) sendbuf, recvbuf, count, datatype, op, comm));
+  }
+
+  t0 = MPI_Wtime();
+  err = MPI_Allreduce((void *) sendbuf, recvbuf, count, datatype, op, comm);
+  t0 = MPI_Wtime() - t0;
+
+  for (s = 0; s < Num_Sites; s++) {
+    if (Site[s].line == line &&
+	(Site[s].file == file || strcmp(Site[s].file, file) == 0)) break;
+  }
+  if (s == Num_Sites) {
+    if (Num_Sites == COMM_MAX_SITES) {
+      Sites_Dropped = TRUE;
+      return (err);
+    }
+    Site[s].file = file;
+    Site[s].line = line;
+    Site[s].calls = Site[s].bytes = Site[s].time = 0.;
+    Num_Sites++;
+  }
+  MPI_Type_size(datatype, &size);
+  Site[s].calls += 1.;
+  Site[s].bytes += (dbl) count * size;
+  Site[s].time += t0;
+
+  return (err);
+}
+/*****************************************************************************/
+
+static const char *
+comm_site_base(const char *file)
+{
+  const char *b = strrchr(file, '/');
+  return ((b == NULL) ? file : b + 1);
+}
+#endif
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
+void
+comm_report(void)
+
+    /*************************************************************************
+     *
+     * comm_report():
+     *
+     *  Write the counters of all the processors to the Communication
+     *  Report File. Must be called by every processor.
+     *************************************************************************/
+{
+#ifdef PARALLEL
+  int i, k, p, q, r, num_rows, total_rows, total_sites, nmerged;
+  int *row_counts, *row_displ, *site_counts, *site_displ, *tmp;
+  int top[COMM_TOP];
+  dbl *rows, *all_rows = NULL, *all_vals = NULL, *vals;
+  dbl *volume = NULL, *wait = NULL;
+  char *names, *all_names = NULL, *mname = NULL;
+  int *m_ranks = NULL, *m_max_rank = NULL;
+  dbl *m_calls = NULL, *m_bytes = NULL, *m_time = NULL;	/* [3*m]: min, sum, max */
+  FILE *fp;
+
+  if (!COMM_PROF_ON) return;
+
+  /*
+   * This processor's neighbors: rank and counters, and its call sites.
+   */
+  comm_peer(0);
+  num_rows = 0;
+  for (q = 0; q < Num_Proc; q++) {
+    if (Peer[q].msgs_sent > 0. || Peer[q].msgs_recv > 0.) num_rows++;
+  }
+  rows = (dbl *) smalloc(MAX(num_rows, 1) * (COMM_PEER_VALS + 1) * sizeof(dbl));
+  k = 0;
+  for (q = 0; q < Num_Proc; q++) {
+    if (Peer[q].msgs_sent == 0. && Peer[q].msgs_recv == 0.) continue;
+    rows[k++] = q;
+    rows[k++] = Peer[q].msgs_sent;
+    rows[k++] = Peer[q].msgs_recv;
+    rows[k++] = Peer[q].bytes_sent;
+    rows[k++] = Peer[q].bytes_recv;
+    rows[k++] = Peer[q].wait;
+  }
+
+  names = (char *) smalloc(MAX(Num_Sites, 1) * COMM_SITE_LEN * sizeof(char));
+  vals = (dbl *) smalloc(MAX(Num_Sites, 1) * COMM_SITE_VALS * sizeof(dbl));
+  memset(names, 0, MAX(Num_Sites, 1) * COMM_SITE_LEN * sizeof(char));
+  for (i = 0; i < Num_Sites; i++) {
+    snprintf(names + i * COMM_SITE_LEN, COMM_SITE_LEN, "%s:%d",
+	     comm_site_base(Site[i].file), Site[i].line);
+    vals[COMM_SITE_VALS*i]   = Site[i].calls;
+    vals[COMM_SITE_VALS*i+1] = Site[i].bytes;
+    vals[COMM_SITE_VALS*i+2] = Site[i].time;
+  }
+  if (Sites_Dropped) {
+    WH(-1, "Communication Report: more than COMM_MAX_SITES MPI_Allreduce sites, some not counted");
+  }
+
+  /*
+   * All of them on processor 0.
+   */
+  row_counts  = (int *) smalloc(4 * Num_Proc * sizeof(int));
+  row_displ   = row_counts + Num_Proc;
+  site_counts = row_displ + Num_Proc;
+  site_displ  = site_counts + Num_Proc;
+  MPI_Gather(&num_rows, 1, MPI_INT, row_counts, 1, MPI_INT, 0, MPI_COMM_WORLD);
+  MPI_Gather(&Num_Sites, 1, MPI_INT, site_counts, 1, MPI_INT, 0, MPI_COMM_WORLD);
+
+  total_rows = total_sites = 0;
+  tmp = (int *) smalloc(2 * Num_Proc * sizeof(int));
+  if (ProcID == 0) {
+    for (p = 0; p < Num_Proc; p++) {
+      row_displ[p] = total_rows * (COMM_PEER_VALS + 1);
+      total_rows += row_counts[p];
+      row_counts[p] *= COMM_PEER_VALS + 1;
+      site_displ[p] = total_sites;
+      total_sites += site_counts[p];
+    }
+    all_rows = (dbl *) smalloc(MAX(total_rows, 1) * (COMM_PEER_VALS + 1) * sizeof(dbl));
+    all_names = (char *) smalloc(MAX(total_sites, 1) * COMM_SITE_LEN * sizeof(char));
+    all_vals = (dbl *) smalloc(MAX(total_sites, 1) * COMM_SITE_VALS * sizeof(dbl));
+  }
+  MPI_Gatherv(rows, num_rows * (COMM_PEER_VALS + 1), MPI_DOUBLE, all_rows,
+	      row_counts, row_displ, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+  if (ProcID == 0) {
+    for (p = 0; p < Num_Proc; p++) {
+      tmp[p] = site_counts[p] * COMM_SITE_LEN;
+      tmp[Num_Proc+p] = site_displ[p] * COMM_SITE_LEN;
+    }
+  }
+  MPI_Gatherv(names, Num_Sites * COMM_SITE_LEN, MPI_CHAR, all_names,
+	      tmp, tmp + Num_Proc, MPI_CHAR, 0, MPI_COMM_WORLD);
+  if (ProcID == 0) {
+    for (p = 0; p < Num_Proc; p++) {
+      tmp[p] = site_counts[p] * COMM_SITE_VALS;
+      tmp[Num_Proc+p] = site_displ[p] * COMM_SITE_VALS;
+    }
+  }
+  MPI_Gatherv(vals, Num_Sites * COMM_SITE_VALS, MPI_DOUBLE, all_vals,
+	      tmp, tmp + Num_Proc, MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+  safer_free((void **) &rows);
+  safer_free((void **) &names);
+  safer_free((void **) &vals);
+  safer_free((void **) &tmp);
+
+  if (ProcID != 0) {
+    safer_free((void **) &row_counts);
+    return;
+  }
+
+  /*
+   * Halo volume (sent + received) and wait of each processor
+   */
+  volume = alloc_dbl_1(Num_Proc, 0.0);
+  wait = alloc_dbl_1(Num_Proc, 0.0);
+  r = 0;
+  for (p = 0; p < Num_Proc; p++) {
+    for (k = 0; k < row_counts[p] / (COMM_PEER_VALS + 1); k++, r++) {
+      dbl *v = all_rows + r * (COMM_PEER_VALS + 1);
+      volume[p] += v[3] + v[4];
+      wait[p] += v[5];
+    }
+  }
+
+  /*
+   * Merge the call sites by name, in the order processor 0 has them
+   */
+  mname      = (char *) smalloc(MAX(total_sites, 1) * COMM_SITE_LEN * sizeof(char));
+  m_ranks    = (int *) smalloc(MAX(total_sites, 1) * 2 * sizeof(int));
+  m_max_rank = m_ranks + MAX(total_sites, 1);
+  m_calls    = (dbl *) smalloc(MAX(total_sites, 1) * 9 * sizeof(dbl));
+  m_bytes    = m_calls + 3 * MAX(total_sites, 1);
+  m_time     = m_bytes + 3 * MAX(total_sites, 1);
+  nmerged = 0;
+  i = 0;
+  for (p = 0; p < Num_Proc; p++) {
+    for (k = 0; k < site_counts[p]; k++, i++) {
+      char *name = all_names + i * COMM_SITE_LEN;
+      dbl *v = all_vals + COMM_SITE_VALS * i;
+      for (r = 0; r < nmerged; r++) {
+	if (strcmp(mname + r * COMM_SITE_LEN, name) == 0) break;
+      }
+      if (r == nmerged) {
+	strcpy(mname + r * COMM_SITE_LEN, name);
+	m_ranks[r] = 0;
+	m_max_rank[r] = p;
+	m_calls[3*r] = m_calls[3*r+2] = v[0];
+	m_bytes[3*r] = m_bytes[3*r+2] = v[1];
+	m_time[3*r]  = m_time[3*r+2]  = v[2];
+	m_calls[3*r+1] = m_bytes[3*r+1] = m_time[3*r+1] = 0.;
+	nmerged++;
+      }
+      m_ranks[r]++;
+      m_calls[3*r]   = MIN(m_calls[3*r], v[0]);
+      m_calls[3*r+1] += v[0];
+      m_calls[3*r+2] = MAX(m_calls[3*r+2], v[0]);
+      m_bytes[3*r]   = MIN(m_bytes[3*r], v[1]);
+      m_bytes[3*r+1] += v[1];
+      m_bytes[3*r+2] = MAX(m_bytes[3*r+2], v[1]);
+      m_time[3*r]    = MIN(m_time[3*r], v[2]);
+      m_time[3*r+1]  += v[2];
+      if (v[2] > m_time[3*r+2]) m_max_rank[r] = p;
+      m_time[3*r+2]  = MAX(m_time[3*r+2], v[2]);
+    }
+  }
+
+  fp = fopen(Comm_Report_File, "w");
+  if (fp == NULL) {
+    WH(-1, "Could not open the Communication Report File for writing");
+  } else {
+    int n, t, nt;
+
+    fprintf(fp, "{\n  \"program\": \"goma\",\n  \"ranks\": %d,\n", Num_Proc);
+
+    /* The communication matrix, as each processor saw it */
+    fprintf(fp, "  \"neighbors\": [");
+    r = 0;
+    n = 0;
+    for (p = 0; p < Num_Proc; p++) {
+      for (k = 0; k < row_counts[p] / (COMM_PEER_VALS + 1); k++, r++) {
+	dbl *v = all_rows + r * (COMM_PEER_VALS + 1);
+	fprintf(fp, "%s\n    {\"rank\": %d, \"neighbor\": %d,"
+		" \"sent\": {\"messages\": %.0f, \"bytes\": %.0f},"
+		" \"received\": {\"messages\": %.0f, \"bytes\": %.0f,"
+		" \"wait\": %.6e}}", (n++ > 0) ? "," : "", p, (int) v[0],
+		v[1], v[3], v[2], v[4], v[5]);
+      }
+    }
+    fprintf(fp, "\n  ],\n");
+
+    /* The processors with the most halo volume, then the most wait */
+    for (t = 0; t < 2; t++) {
+      dbl *key = (t == 0) ? volume : wait;
+      nt = MIN(COMM_TOP, Num_Proc);
+      for (i = 0; i < nt; i++) {
+	top[i] = -1;
+	for (p = 0; p < Num_Proc; p++) {
+	  for (k = 0; k < i && top[k] != p; k++);
+	  if (k < i) continue;
+	  if (top[i] < 0 || key[p] > key[top[i]]) top[i] = p;
+	}
+      }
+      fprintf(fp, "  \"%s\": [", (t == 0) ? "top_halo_volume" : "top_halo_wait");
+      for (i = 0; i < nt; i++) {
+	fprintf(fp, "%s\n    {\"rank\": %d, \"bytes\": %.0f, \"wait\": %.6e}",
+		(i > 0) ? "," : "", top[i], volume[top[i]], wait[top[i]]);
+      }
+      fprintf(fp, "\n  ],\n");
+    }
+
+    /* The MPI_Allreduce call sites */
+    fprintf(fp, "  \"collectives\": [");
+    for (r = 0; r < nmerged; r++) {
+      fprintf(fp, "%s\n    {\"site\": \"%s\", \"ranks\": %d, \"calls\": %.6g,"
+	      " \"bytes\": %.6g,\n", (r > 0) ? "," : "",
+	      mname + r * COMM_SITE_LEN, m_ranks[r],
+	      m_calls[3*r+1] / m_ranks[r], m_bytes[3*r+1] / m_ranks[r]);
+      fprintf(fp, "     \"time\": {\"min\": %.6e, \"avg\": %.6e, \"max\": %.6e,"
+	      " \"max_rank\": %d}}", m_time[3*r], m_time[3*r+1] / m_ranks[r],
+	      m_time[3*r+2], m_max_rank[r]);
+    }
+    fprintf(fp, "\n  ]\n}\n");
+    fclose(fp);
+  }
+
+  safer_free((void **) &row_counts);
+  safer_free((void **) &all_rows);
+  safer_free((void **) &all_names);
+  safer_free((void **) &all_vals);
+  safer_free((void **) &volume);
+  safer_free((void **) &wait);
+  safer_free((void **) &mname);
+  safer_free((void **) &m_ranks);
+  safer_free((void **) &m_calls);
+#endif /* PARALLEL */
+}
+/*****************************************************************************/
+/* END of file dp_comm_prof.c */
+/*****************************************************************************/
@@ -284,6 +284,7 @@ exchange_neighbor_proc_info(int num_neighbors, COMM_NP_STRUCT *np_ptr)
 #ifdef PARALLEL
   int p, retn;
   COMM_NP_STRUCT *np_base = np_ptr;
+  dbl t0;
 
   /*
    * Post receives for all messages
@@ -313,6 +314,7 @@ exchange_neighbor_proc_info(int num_neighbors, COMM_NP_STRUCT *np_ptr)
 	      np_ptr->neighbor_ProcID, retn);
       EH(-1,"MPI failure");
     }
+    comm_prof_send(np_ptr->neighbor_ProcID, np_ptr->send_message_length);
     np_ptr++;    
   }
 
@@ -320,8 +322,11 @@ exchange_neighbor_proc_info(int num_neighbors, COMM_NP_STRUCT *np_ptr)
   *  Wait until all messages are sent and received.
   */
   np_ptr = np_base;
+  t0 = MPI_Wtime();
   for (p = 0; p < num_neighbors; p++) {
     retn = MPI_Wait(&(np_ptr->recv_request), &(np_ptr->recv_status));
+    comm_prof_recv(np_ptr->neighbor_ProcID, np_ptr->recv_message_length,
+		   MPI_Wtime() - t0);
     if (retn != MPI_SUCCESS) {
       fprintf(stderr,"%s Proc %d: Irecv to %d failed: %d\n", yo, ProcID,
 	      np_ptr->neighbor_ProcID, retn);
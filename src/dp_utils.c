@@ -131,6 +131,10 @@ ddd_alloc(void)
   p->block_count = (int *) calloc(n, sizeof(int));
   p->data_type   = (MPI_Datatype *) calloc(n, sizeof(MPI_Datatype));
   p->address     = (MPI_Aint *) calloc(n, sizeof(MPI_Aint));
+  p->byte_count  = NULL;
+#ifdef PARALLEL
+  p->new_type    = MPI_DATATYPE_NULL;
+#endif
 #ifdef DEBUG
   fprintf(stderr, "P_%d in ddd_alloc()\n", ProcID);
 #endif  
@@ -141,7 +145,10 @@ ddd_alloc(void)
 void 
 ddd_free(DDD p)
 {
-  MPI_Type_free(&p->new_type);
+#ifdef PARALLEL
+  if (p->new_type != MPI_DATATYPE_NULL) MPI_Type_free(&p->new_type);
+#endif
+  free(p->byte_count);
   free(p->block_count);
   free(p->data_type);
   free(p->address);
@@ -335,6 +342,90 @@ ddd_set_commit(DDD p)
 /************************************************************************/
 /************************************************************************/
 
+void
+ddd_set_pack(DDD p)
+
+    /*****************************************************************
+     *
+     * ddd_set_pack:
+     *
+     *   Alternative to ddd_set_commit() for a collection that is only
+     *   ever broadcast with ddd_bcast(): records the byte length of each
+     *   member instead of building and committing an MPI struct type
+     *   over all of them, which is slow for the many thousands of
+     *   members of the raven, ark and dove.
+     *****************************************************************/
+{
+#ifdef PARALLEL
+  int i, type_size;
+
+  p->byte_count = (int *) realloc(p->byte_count, 
+				  MAX(p->num_members, 1)*sizeof(int));
+  p->size = 0;
+  for (i = 0; i < p->num_members; i++)
+    {
+      MPI_Type_size(p->data_type[i], &type_size);
+      p->byte_count[i] = p->block_count[i] * type_size;
+      p->size += p->byte_count[i];
+    }
+  p->new_type = MPI_DATATYPE_NULL;
+#endif
+  return;
+}
+/************************************************************************/
+/************************************************************************/
+/************************************************************************/
+
+void
+ddd_bcast(DDD p, int root)
+
+    /*****************************************************************
+     *
+     * ddd_bcast:
+     *
+     *   Broadcast the members of a collection set with ddd_set_pack()
+     *   from processor root as one contiguous block of bytes: root
+     *   copies every member into it, the others copy them back out.
+     *   Like ddd_add_member2(), it assumes that all of the processors
+     *   share one data representation.
+     *****************************************************************/
+{
+#ifdef PARALLEL
+  int i, offset;
+  char *buffer;
+
+  if (p->byte_count == NULL && p->num_members > 0)
+    {
+      EH(-1, "ddd_bcast needs ddd_set_pack first");
+    }
+  buffer = (char *) malloc(MAX(p->size, 1));
+  if (buffer == NULL) EH(-1, "ddd_bcast could not allocate its buffer");
+
+  if (ProcID == root)
+    {
+      for (i = 0, offset = 0; i < p->num_members; offset += p->byte_count[i++])
+	{
+	  memcpy(buffer + offset, (void *) p->address[i], p->byte_count[i]);
+	}
+    }
+
+  MPI_Bcast(buffer, p->size, MPI_BYTE, root, MPI_COMM_WORLD);
+
+  if (ProcID != root)
+    {
+      for (i = 0, offset = 0; i < p->num_members; offset += p->byte_count[i++])
+	{
+	  memcpy((void *) p->address[i], buffer + offset, p->byte_count[i]);
+	}
+    }
+  free(buffer);
+#endif
+  return;
+}
+/************************************************************************/
+/************************************************************************/
+/************************************************************************/
+
 char *
 type2string(MPI_Datatype type)
 {
@@ -676,6 +767,38 @@ gsum_Int(const int value)
 /************************************************************************/
 /************************************************************************/
 
+goma_gid
+gsum_Gid(const goma_gid value)
+
+    /********************************************************************
+     *
+     * gsum_Gid
+     *
+     *   gsum_Int() for global ordinals, sums of local counts that may
+     *   pass the range of an int on large meshes.
+     *
+     *  Return
+     *  -------
+     *  Routine returns the sum.
+     ********************************************************************/
+{
+#ifdef PARALLEL
+  goma_gid out_buf;
+  int err;
+  err = MPI_Allreduce((void *) &value, (void *) &out_buf, 1, MPI_GOMA_GID,
+		      MPI_SUM, MPI_COMM_WORLD);
+  if (err != MPI_SUCCESS) {
+    EH(-1, "gsum_Gid: MPI_Allreduce returned an error");
+  }
+  return out_buf;
+#else
+  return value;
+#endif
+}
+/************************************************************************/
+/************************************************************************/
+/************************************************************************/
+
 double
 gavg_double(const double value)
 
@@ -770,3 +893,225 @@ sync_processors(void)
 /************************************************************************/
 /************************************************************************/
 /************************************************************************/
+
+/*
+ * Global status reduction.
+ *
+ * Flags and scalars that every processor needs the global value of are
+ * gathered into one packed buffer and reduced together, so that a group
+ * of checks costs one collective rather than one each. Usage:
+ *
+ *	gstatus_begin();
+ *	i = gstatus_add(GSTATUS_MAX, neg_elem_volume);
+ *	j = gstatus_add(GSTATUS_SUM, local_mass);
+ *	gstatus_start();	   nonblocking where MPI allows it
+ *	 ... local work ...
+ *	neg_elem_volume = (int) gstatus_get(i);   waits the first time
+ *
+ * A GSTATUS_MAXLOC value from gstatus_add_maxloc() also takes two
+ * slots, the value and the lowest numbered processor holding it, like
+ * MPI_MAXLOC.
+ *
+ * The whole buffer travels as one element of a contiguous derived
+ * datatype, so the user op always sees every slot and can apply each
+ * slot's own operation. Every processor must add the same slots in the
+ * same order.
+ */
+
+static int    Gstatus_Len = 0;
+static int    Gstatus_Kind[GSTATUS_MAX_SLOTS];
+static double Gstatus_Local[GSTATUS_MAX_SLOTS];
+static double Gstatus_Global[GSTATUS_MAX_SLOTS];
+static int    Gstatus_Pending = FALSE;
+
+#ifdef PARALLEL
+static MPI_Request  Gstatus_Request;
+static MPI_Datatype Gstatus_Type;
+static int          Gstatus_Type_Len = 0;
+static MPI_Op       Gstatus_Op;
+static int          Gstatus_Op_Made = FALSE;
+
+static void
+gstatus_op(void *in, void *inout, int *len, MPI_Datatype *type)
+{
+  double *a = (double *) in;
+  double *b = (double *) inout;
+  int i, k;
+
+  for (k = 0; k < *len; k++, a += Gstatus_Type_Len, b += Gstatus_Type_Len) {
+    for (i = 0; i < Gstatus_Type_Len; i++) {
+      if (Gstatus_Kind[i] == GSTATUS_SUM) {
+	b[i] += a[i];
+      } else if (Gstatus_Kind[i] == GSTATUS_MAXLOC) {
+	if (a[i] > b[i] || (a[i] == b[i] && a[i+1] < b[i+1])) {
+	  b[i]   = a[i];		/* the value and its processor */
+	  b[i+1] = a[i+1];
+	}
+	i++;
+      } else if (a[i] > b[i]) {
+	b[i] = a[i];		/* GSTATUS_MAX, and GSTATUS_MIN negated */
+      }
+    }
+  }
+}
+#endif
+/************************************************************************/
+/************************************************************************/
+/************************************************************************/
+
+void
+gstatus_begin(void)
+
+    /********************************************************************
+     *
+     * gstatus_begin
+     *
+     *   Start a new group of values to reduce. A reduction that is
+     *   still outstanding is completed first.
+     ********************************************************************/
+{
+  if (Gstatus_Pending) (void) gstatus_get(0);
+  Gstatus_Len = 0;
+}
+/************************************************************************/
+/************************************************************************/
+/************************************************************************/
+
+int
+gstatus_add(const int kind, const double value)
+
+    /********************************************************************
+     *
+     * gstatus_add
+     *
+     *   Add this processor's value to the group, to be combined by
+     *   kind (GSTATUS_SUM, GSTATUS_MAX or GSTATUS_MIN).
+     *
+     *  Return
+     *  -------
+     *  The slot to pass to gstatus_get().
+     ********************************************************************/
+{
+  if (Gstatus_Pending || Gstatus_Len >= GSTATUS_MAX_SLOTS) {
+    EH(-1, "gstatus_add: reduction in progress or too many values");
+  }
+
+  Gstatus_Kind[Gstatus_Len]  = kind;
+  Gstatus_Local[Gstatus_Len] = (kind == GSTATUS_MIN) ? -value : value;
+  return Gstatus_Len++;
+}
+/************************************************************************/
+/************************************************************************/
+/************************************************************************/
+
+int
+gstatus_add_maxloc(const double value)
+
+    /********************************************************************
+     *
+     * gstatus_add_maxloc
+     *
+     *   Add this processor's value to the group, to be combined like
+     *   MPI_MAXLOC.
+     *
+     *  Return
+     *  -------
+     *  The slot to pass to gstatus_get() for the maximum; the processor
+     *  holding it is (int) gstatus_get(slot + 1).
+     ********************************************************************/
+{
+  int slot;
+
+  if (Gstatus_Pending || Gstatus_Len + 1 >= GSTATUS_MAX_SLOTS) {
+    EH(-1, "gstatus_add_maxloc: reduction in progress or too many values");
+  }
+
+  slot = Gstatus_Len;
+  Gstatus_Kind[slot]      = GSTATUS_MAXLOC;
+  Gstatus_Local[slot]     = value;
+  Gstatus_Kind[slot + 1]  = GSTATUS_MAXLOC;
+  Gstatus_Local[slot + 1] = (double) ProcID;
+  Gstatus_Len += 2;
+  return slot;
+}
+/************************************************************************/
+/************************************************************************/
+/************************************************************************/
+
+void
+gstatus_start(void)
+
+    /********************************************************************
+     *
+     * gstatus_start
+     *
+     *   Start the reduction of the group. With MPI-3 it proceeds in the
+     *   background until the first gstatus_get().
+     ********************************************************************/
+{
+#ifdef PARALLEL
+  int err;
+
+  if (Gstatus_Len == 0) return;
+
+  if (!Gstatus_Op_Made) {
+    MPI_Op_create(gstatus_op, 1, &Gstatus_Op);
+    Gstatus_Op_Made = TRUE;
+  }
+  if (Gstatus_Type_Len != Gstatus_Len) {
+    if (Gstatus_Type_Len > 0) MPI_Type_free(&Gstatus_Type);
+    MPI_Type_contiguous(Gstatus_Len, MPI_DOUBLE, &Gstatus_Type);
+    MPI_Type_commit(&Gstatus_Type);
+    Gstatus_Type_Len = Gstatus_Len;
+  }
+
+#if MPI_VERSION >= 3
+  err = MPI_Iallreduce(Gstatus_Local, Gstatus_Global, 1, Gstatus_Type,
+		       Gstatus_Op, MPI_COMM_WORLD, &Gstatus_Request);
+#else
+  err = MPI_Allreduce(Gstatus_Local, Gstatus_Global, 1, Gstatus_Type,
+		      Gstatus_Op, MPI_COMM_WORLD);
+  Gstatus_Request = MPI_REQUEST_NULL;
+#endif
+  if (err != MPI_SUCCESS) {
+    EH(-1, "gstatus_start: MPI reduction returned an error");
+  }
+#else
+  memcpy(Gstatus_Global, Gstatus_Local, Gstatus_Len * sizeof(double));
+#endif
+  Gstatus_Pending = TRUE;
+}
+/************************************************************************/
+/************************************************************************/
+/************************************************************************/
+
+double
+gstatus_get(const int slot)
+
+    /********************************************************************
+     *
+     * gstatus_get
+     *
+     *   Return the global value in a slot, completing the reduction
+     *   started by gstatus_start() if necessary.
+     ********************************************************************/
+{
+  if (Gstatus_Pending) {
+#ifdef PARALLEL
+    if (MPI_Wait(&Gstatus_Request, MPI_STATUS_IGNORE) != MPI_SUCCESS) {
+      EH(-1, "gstatus_get: MPI_Wait returned an error");
+    }
+#endif
+    Gstatus_Pending = FALSE;
+  }
+
+  if (slot < 0 || slot >= Gstatus_Len) {
+    EH(-1, "gstatus_get: no such slot");
+  }
+
+  return (Gstatus_Kind[slot] == GSTATUS_MIN) ? -Gstatus_Global[slot]
+                                             : Gstatus_Global[slot];
+}
+/************************************************************************/
+/************************************************************************/
+/************************************************************************/
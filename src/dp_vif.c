@@ -136,6 +136,7 @@ noahs_raven()
   ddd_add_member(n, &num_ext_Tables, 1, MPI_INT);
   ddd_add_member(n, &Continuation, 1, MPI_INT);
   ddd_add_member(n, &nAC, 1, MPI_INT);
+  ddd_add_member(n, &AC_Sensitivity_Forward, 1, MPI_INT);
   ddd_add_member(n, &nCC, 1, MPI_INT);
   ddd_add_member(n, &nTC, 1, MPI_INT);
   ddd_add_member(n, &nHC, 1, MPI_INT);
@@ -167,7 +168,7 @@ noahs_raven()
   ddd_add_member(n, &TFMP_INV_PECLET, 1, MPI_INT);
   ddd_add_member(n, &TFMP_KRG, 1, MPI_INT);
 
-  ddd_set_commit(n);
+  ddd_set_pack(n);
  
 #endif
   return;
@@ -622,6 +623,37 @@ noahs_ark()
   ddd_add_member(n, &ExoTimePlane, 1, MPI_INT);
   ddd_add_member(n, &Write_Intermediate_Solutions, 1, MPI_INT);
   ddd_add_member(n, &Write_Initial_Solution, 1, MPI_INT);
+  ddd_add_member(n, &Exo_Flush_Interval, 1, MPI_INT);
+  ddd_add_member(n, &Async_Output_Memory, 1, MPI_INT);
+  ddd_add_member(n, Catalyst_Script, MAX_FNL, MPI_CHAR);
+  ddd_add_member(n, Catalyst_Implementation, MAX_FNL, MPI_CHAR);
+  ddd_add_member(n, ROM_Basis_File, MAX_FNL, MPI_CHAR);
+  ddd_add_member(n, Running_Statistics, MAX_CHAR_IN_INPUT, MPI_CHAR);
+  ddd_add_member(n, &Output_Compression_Level, 1, MPI_INT);
+  ddd_add_member(n, &Output_Compression_Shuffle, 1, MPI_INT);
+  ddd_add_member(n, &Output_Significant_Digits, 1, MPI_INT);
+  ddd_add_member(n, &Num_Output_Subsets, 1, MPI_INT);
+  ddd_add_member(n, Output_Subsets, sizeof(Output_Subsets), MPI_CHAR);
+  ddd_add_member(n, &Brk_Flag, 1, MPI_INT);
+  ddd_add_member(n, Brk_File, MAX_FNL, MPI_CHAR);
+  ddd_add_member(n, &Brk_Num_Ranks, 1, MPI_INT);
+  ddd_add_member(n, &Brk_Partitioner, 1, MPI_INT);
+  ddd_add_member(n, Elem_Cost_File, MAX_FNL, MPI_CHAR);
+  ddd_add_member(n, Perf_Report_File, MAX_FNL, MPI_CHAR);
+  ddd_add_member(n, &Perf_Report_Interval, 1, MPI_INT);
+  ddd_add_member(n, Perf_Log_File, MAX_FNL, MPI_CHAR);
+  ddd_add_member(n, Trace_File, MAX_FNL, MPI_CHAR);
+  ddd_add_member(n, &Trace_Depth, 1, MPI_INT);
+  ddd_add_member(n, Comm_Report_File, MAX_FNL, MPI_CHAR);
+  ddd_add_member(n, &Kernel_Bench_Reps, 1, MPI_INT);
+  ddd_add_member(n, Memory_Report_File, MAX_FNL, MPI_CHAR);
+  ddd_add_member(n, &Memory_Report_Top, 1, MPI_INT);
+  ddd_add_member(n, Matrix_Replay_Dump_File, MAX_FNL, MPI_CHAR);
+  ddd_add_member(n, &Matrix_Replay_Dump_Count, 1, MPI_INT);
+  ddd_add_member(n, Matrix_Replay_File, MAX_FNL, MPI_CHAR);
+  ddd_add_member(n, Checkpoint_File, MAX_FNL, MPI_CHAR);
+  ddd_add_member(n, &Checkpoint_Interval, 1, MPI_DOUBLE);
+  ddd_add_member(n, Checkpoint_Restart_File, MAX_FNL, MPI_CHAR);
   
   /*
    * rd_genl_specs()
@@ -682,6 +714,8 @@ noahs_ark()
 #endif
 
 
+  ddd_add_member(n, &Ext_Field_Donor_Mesh, 1, MPI_INT);
+
   if ( efv->ev != T_NOTHING )
     {
       ddd_add_member(n, &efv->TALE, 1, MPI_INT);
@@ -717,7 +751,18 @@ noahs_ark()
   ddd_add_member(n, &tran->Delta_t_max, 1, MPI_DOUBLE);
   ddd_add_member(n, &tran->TimeMax, 1, MPI_DOUBLE);
   ddd_add_member(n, &tran->theta, 1, MPI_DOUBLE);
+  ddd_add_member(n, &tran->bdf_max_order, 1, MPI_INT);
   ddd_add_member(n, &tran->eps, 1, MPI_DOUBLE);
+  ddd_add_member(n, &tran->ts_controller, 1, MPI_INT);
+  ddd_add_member(n, &tran->ts_reject_growth, 1, MPI_DOUBLE);
+  ddd_add_member(n, &tran->ts_newton_target, 1, MPI_INT);
+  ddd_add_member(n, &tran->multirate_subcycles, 1, MPI_INT);
+  ddd_add_member(n, &tran->multirate_num_blocks, 1, MPI_INT);
+  ddd_add_member(n, tran->multirate_block_id, MAX_MULTIRATE_BLOCKS, MPI_INT);
+  ddd_add_member(n, &tran->ptc_delta_t0, 1, MPI_DOUBLE);
+  ddd_add_member(n, &tran->ptc_delta_t_max, 1, MPI_DOUBLE);
+  ddd_add_member(n, &tran->ptc_max_steps, 1, MPI_INT);
+  ddd_add_member(n, &tran->explicit_cfl, 1, MPI_DOUBLE);
 
 /*
   for ( i=0; i<MAX_VARIABLE_TYPES; i++)
@@ -738,6 +783,8 @@ noahs_ark()
   ddd_add_member(n, &tran->print_delt2, 1, MPI_DOUBLE);
   ddd_add_member(n, &tran->init_time, 1, MPI_DOUBLE);
   ddd_add_member(n, &tran->const_dt_after_failure, 1, MPI_INT);
+  ddd_add_member(n, &tran->ckpt_depth, 1, MPI_INT);
+  ddd_add_member(n, &tran->ckpt_max_rollbacks, 1, MPI_INT);
   ddd_add_member(n, &tran->time_step_decelerator, 1, MPI_DOUBLE);
   ddd_add_member(n, &tran->resolved_delta_t_min, 1, MPI_DOUBLE);
   ddd_add_member(n, &tran->Courant_Limit, 1, MPI_DOUBLE);
@@ -785,6 +832,8 @@ noahs_ark()
   ddd_add_member(n, Matrix_Absolute_Threshold, MAX_CHAR_IN_INPUT, MPI_CHAR);
   ddd_add_member(n, Amesos_Package, MAX_CHAR_IN_INPUT, MPI_CHAR);
   ddd_add_member(n, Stratimikos_File, MAX_CHAR_IN_INPUT, MPI_CHAR);
+  ddd_add_member(n, &Krylov_Recycle, 1, MPI_INT);
+  ddd_add_member(n, &Krylov_Guess, 1, MPI_INT);
 
   ddd_add_member(n, &Linear_Solver, 1, MPI_INT);
 
@@ -803,6 +852,55 @@ noahs_ark()
   ddd_add_member(n, &modified_newton, 1, MPI_INT);
   ddd_add_member(n, &convergence_rate_tolerance, 1, MPI_DOUBLE);
   ddd_add_member(n, &modified_newt_norm_tol, 1, MPI_DOUBLE);
+  ddd_add_member(n, &Newton_Forcing, 1, MPI_INT);
+  ddd_add_member(n, &Newton_Forcing_Max, 1, MPI_DOUBLE);
+  ddd_add_member(n, &Autotune_Linear_Solver, 1, MPI_INT);
+  ddd_add_member(n, &Autotune_Degrade, 1, MPI_DOUBLE);
+  ddd_add_member(n, &Num_Fallback_Levels, 1, MPI_INT);
+  ddd_add_member(n, Fallback_Type, MAX_FALLBACK_LEVELS, MPI_INT);
+  ddd_add_member(n, Fallback_Fill, MAX_FALLBACK_LEVELS, MPI_DOUBLE);
+  ddd_add_member(n, &Direct_Refine_Tol, 1, MPI_DOUBLE);
+  ddd_add_member(n, &Direct_Refine_Steps, 1, MPI_INT);
+  ddd_add_member(n, &Jacobian_Reuse, 1, MPI_INT);
+  ddd_add_member(n, &Jacobian_Reuse_Rate, 1, MPI_DOUBLE);
+  ddd_add_member(n, &Jacobian_Reuse_Max_Age, 1, MPI_INT);
+  ddd_add_member(n, &Jacobian_Reuse_Dt_Tol, 1, MPI_DOUBLE);
+  ddd_add_member(n, &Jacobian_Reuse_Omega_Tol, 1, MPI_DOUBLE);
+  ddd_add_member(n, &Newton_Accel, 1, MPI_INT);
+  ddd_add_member(n, &Newton_Accel_Depth, 1, MPI_INT);
+  ddd_add_member(n, &Newton_Line_Search, 1, MPI_INT);
+  ddd_add_member(n, &Line_Search_Alpha, 1, MPI_DOUBLE);
+  ddd_add_member(n, &Line_Search_Max_Backtracks, 1, MPI_INT);
+  ddd_add_member(n, &Matrix_Free_Newton, 1, MPI_INT);
+  ddd_add_member(n, &Matrix_Free_Delta, 1, MPI_DOUBLE);
+  ddd_add_member(n, &Precond_Matrix, 1, MPI_INT);
+  ddd_add_member(n, &Num_Assembly_Threads, 1, MPI_INT);
+  ddd_add_member(n, &Elem_Scatter_Map, 1, MPI_INT);
+  ddd_add_member(n, &Selective_Reassembly_Tol, 1, MPI_DOUBLE);
+  ddd_add_member(n, &Selective_Reassembly_Refresh, 1, MPI_INT);
+  ddd_add_member(n, &Geom_Cache_Memory, 1, MPI_INT);
+  ddd_add_member(n, &Overlap_Exchange, 1, MPI_INT);
+  ddd_add_member(n, &Elem_FD_Jacobian, 1, MPI_INT);
+  ddd_add_member(n, Elem_FD_Eqn, MAX_VARIABLE_TYPES, MPI_INT);
+  ddd_add_member(n, Node_Reorder, MAX_CHAR_IN_INPUT, MPI_CHAR);
+  ddd_add_member(n, &Interior_Condensation, 1, MPI_INT);
+  ddd_add_member(n, &Fused_Post_Processing, 1, MPI_INT);
+  ddd_add_member(n, &Prune_Zero_Couplings, 1, MPI_INT);
+  ddd_add_member(n, &Memory_Lean, 1, MPI_INT);
+  ddd_add_member(n, Setup_Cache, MAX_FNL, MPI_CHAR);
+  ddd_add_member(n, &Num_Plugins, 1, MPI_INT);
+  ddd_add_member(n, &Plugin_Library[0][0], MAX_PLUGINS * MAX_FNL, MPI_CHAR);
+  ddd_add_member(n, &Plugin_Function[0][0], MAX_PLUGINS * MAX_FNL, MPI_CHAR);
+  ddd_add_member(n, &Reduced_Quadrature, 1, MPI_INT);
+  ddd_add_member(n, Reduced_Quad_Eqn, MAX_VARIABLE_TYPES, MPI_INT);
+  ddd_add_member(n, &Periodic_Native, 1, MPI_INT);
+  ddd_add_member(n, &Mesh_Stiffness_Lag, 1, MPI_INT);
+  ddd_add_member(n, &Mesh_Segregation_Tol, 1, MPI_DOUBLE);
+  ddd_add_member(n, &Reduced_Order_Model, 1, MPI_INT);
+  ddd_add_member(n, &ROM_Max_Modes, 1, MPI_INT);
+  ddd_add_member(n, &ROM_Energy, 1, MPI_DOUBLE);
+  ddd_add_member(n, &ROM_Max_Snapshots, 1, MPI_INT);
+  ddd_add_member(n, &ROM_Sample_Nodes, 1, MPI_INT);
   ddd_add_member(n, Epsilon, 3, MPI_DOUBLE);
 
   /*
@@ -820,6 +918,7 @@ noahs_ark()
   ddd_add_member(n, &eigen->Eigen_Matrix_Output, 1, MPI_INT);
   ddd_add_member(n, &eigen->Eigen_Solve_Freq, 1, MPI_INT);
   ddd_add_member(n, &eigen->Eigen_Write_Freq, 1, MPI_INT);
+  ddd_add_member(n, &eigen->Eigen_Warm_Start, 1, MPI_INT);
   ddd_add_member(n, &eigen->Eigen_Tolerance, 1, MPI_DOUBLE);
   ddd_add_member(n, &eigen->Eigen_IV_Wt, 1, MPI_DOUBLE);
   ddd_add_member(n, &eigen->Eigen_Shifts[0], 5, MPI_DOUBLE);
@@ -836,6 +935,7 @@ noahs_ark()
   ddd_add_member(n, &LSA_3D_of_2D_pass, 1, MPI_INT);
   ddd_add_member(n, &LSA_3D_of_2D_wave_number, 1, MPI_DOUBLE);
   ddd_add_member(n, &LSA_current_wave_number, 1, MPI_INT);
+  ddd_add_member(n, &LSA_wave_number_interpolation, 1, MPI_INT);
   for (i=0; i<LSA_number_wave_numbers; i++)
     {
       ddd_add_member(n, &(LSA_wave_numbers[i]), 1, MPI_DOUBLE);
@@ -853,7 +953,7 @@ noahs_ark()
 
   ddd_add_member(n, &NZeros, 1, MPI_INT);
 
-  ddd_add_member(n, &GNZeros, 1, MPI_INT);
+  ddd_add_member(n, &GNZeros, 1, MPI_GOMA_GID);
   ddd_add_member(n, &PSPG, 1, MPI_INT);
   ddd_add_member(n, &PSPP, 1, MPI_INT);
   ddd_add_member(n, &PS_scaling, 1, MPI_DOUBLE);
@@ -889,6 +989,7 @@ noahs_ark()
   ddd_add_member(n, Particle_Move_Domain_Filename, MAX_PARTICLE_FILENAME_LENGTH, MPI_CHAR);
   ddd_add_member(n, Particle_Move_Domain_Name, MAX_PARTICLE_STRING_LENGTH, MPI_CHAR);
   ddd_add_member(n, &Particle_Full_Output_Stride, 1, MPI_INT);
+  ddd_add_member(n, &Particle_Compaction_Stride, 1, MPI_INT);
   ddd_add_member(n, Particle_Full_Output_Filename, MAX_PARTICLE_FILENAME_LENGTH, MPI_CHAR);
   if(Particle_Number_Sample_Types)
     {
@@ -998,6 +1099,9 @@ noahs_ark()
       ddd_add_member(n, &(AC_Tables[i]->ngrid), 1, MPI_INT);
       ddd_add_member(n, &(AC_Tables[i]->yscale), 1, MPI_DOUBLE);
       ddd_add_member(n, &(AC_Tables[i]->Emin), 1, MPI_DOUBLE);
+      ddd_add_member(n, &(AC_Tables[i]->t_ascending), 1, MPI_INT);
+      ddd_add_member(n, &(AC_Tables[i]->t_spacing), 1, MPI_DOUBLE);
+      ddd_add_member(n, &(AC_Tables[i]->last_interval), 1, MPI_INT);
     }
 
   for ( i=0; i < num_BC_Tables; i++ )
@@ -1014,6 +1118,9 @@ noahs_ark()
       ddd_add_member(n, &(BC_Tables[i]->ngrid), 1, MPI_INT);
       ddd_add_member(n, &(BC_Tables[i]->yscale), 1, MPI_DOUBLE);
       ddd_add_member(n, &(BC_Tables[i]->Emin), 1, MPI_DOUBLE);
+      ddd_add_member(n, &(BC_Tables[i]->t_ascending), 1, MPI_INT);
+      ddd_add_member(n, &(BC_Tables[i]->t_spacing), 1, MPI_DOUBLE);
+      ddd_add_member(n, &(BC_Tables[i]->last_interval), 1, MPI_INT);
     }
      
   for ( i=0; i < num_MP_Tables; i++ )
@@ -1030,6 +1137,9 @@ noahs_ark()
       ddd_add_member(n, &(MP_Tables[i]->ngrid), 1, MPI_INT);
       ddd_add_member(n, &(MP_Tables[i]->yscale), 1, MPI_DOUBLE);
       ddd_add_member(n, &(MP_Tables[i]->Emin), 1, MPI_DOUBLE);
+      ddd_add_member(n, &(MP_Tables[i]->t_ascending), 1, MPI_INT);
+      ddd_add_member(n, &(MP_Tables[i]->t_spacing), 1, MPI_DOUBLE);
+      ddd_add_member(n, &(MP_Tables[i]->last_interval), 1, MPI_INT);
     }
      
   for ( i=0; i < num_ext_Tables; i++ )
@@ -1048,6 +1158,9 @@ noahs_ark()
       ddd_add_member(n, &(ext_Tables[i]->ngrid2), 1, MPI_INT);
       ddd_add_member(n, &(ext_Tables[i]->yscale), 1, MPI_DOUBLE);
       ddd_add_member(n, &(ext_Tables[i]->Emin), 1, MPI_DOUBLE);
+      ddd_add_member(n, &(ext_Tables[i]->t_ascending), 1, MPI_INT);
+      ddd_add_member(n, &(ext_Tables[i]->t_spacing), 1, MPI_DOUBLE);
+      ddd_add_member(n, &(ext_Tables[i]->last_interval), 1, MPI_INT);
     }
 
 #ifdef DEBUG
@@ -1216,6 +1329,10 @@ noahs_ark()
       ddd_add_member(n, &eqm->vol_low,      1, MPI_DOUBLE);
       ddd_add_member(n, &eqm->vol_count,    1, MPI_INT);
       ddd_add_member(n, &eqm->tol_type,    1, MPI_INT);
+      ddd_add_member(n, &eqm->incremental, 1, MPI_INT);
+      ddd_add_member(n, &eqm->inc_margin,  1, MPI_DOUBLE);
+      ddd_add_member(n, &eqm->inc_full_every, 1, MPI_INT);
+      ddd_add_member(n, &eqm->jac_low,     1, MPI_DOUBLE);
     }
 
   /*
@@ -1285,6 +1402,7 @@ noahs_ark()
       ddd_add_member(n,  cont->use_var_norm, MAX_VARIABLE_TYPES, MPI_INT);
       ddd_add_member(n, &cont->print_freq,        1, MPI_INT);
       ddd_add_member(n, &cont->fix_freq, 1, MPI_INT);
+      ddd_add_member(n, &cont->hunt_secant,       1, MPI_INT);
       ddd_add_member(n, &cont->print_delt,        1, MPI_DOUBLE);
       ddd_add_member(n, &cont->print_delt2_path,  1, MPI_DOUBLE);
       ddd_add_member(n, &cont->print_delt2,       1, MPI_DOUBLE);
@@ -1451,11 +1569,14 @@ noahs_ark()
       ddd_add_member(n, &ls->Control_Width, 1,      MPI_DOUBLE);
       ddd_add_member(n, &ls->Renorm_Tolerance, 1,   MPI_DOUBLE);
       ddd_add_member(n, &ls->Renorm_Method, 1,      MPI_INT);
+      ddd_add_member(n, &ls->Renorm_Band, 1,        MPI_DOUBLE);
       ddd_add_member(n, &ls->Search_Option, 1,      MPI_INT);
       ddd_add_member(n, &ls->Grid_Search_Depth, 1,  MPI_INT);
       ddd_add_member(n, &ls->Integration_Depth, 1,  MPI_INT);
       ddd_add_member(n, &ls->Interface_Output, 1,   MPI_INT);
       ddd_add_member(n, &ls->Renorm_Freq, 1,        MPI_INT);
+      ddd_add_member(n, &ls->Narrow_Band, 1,        MPI_INT);
+      ddd_add_member(n, &ls->Lumped_Courant, 1,     MPI_DOUBLE);
       ddd_add_member(n, &ls->Renorm_Countdown, 1,   MPI_INT);
       ddd_add_member(n, &ls->Force_Initial_Renorm, 1,   MPI_INT);
       ddd_add_member(n, &ls->Initial_LS_Displacement, 1,   MPI_DOUBLE);
@@ -1467,8 +1588,10 @@ noahs_ark()
       ddd_add_member(n, &ls->Solid_Sign, 1,         MPI_INT);
       ddd_add_member(n, &ls->Elem_Sign, 1,          MPI_INT);
       ddd_add_member(n, &ls->SubElemIntegration, 1,  MPI_INT);
+      ddd_add_member(n, &ls->SubElem_Cache_Tol, 1,  MPI_DOUBLE);
       ddd_add_member(n, &ls->AdaptIntegration, 1,  MPI_INT);
       ddd_add_member(n, &ls->Adaptive_Order, 1,  MPI_INT);
+      ddd_add_member(n, &ls->Curvature_Projection, 1,  MPI_INT);
       ddd_add_member(n, &ls->Ghost_Integ, 1,  MPI_INT);
       ddd_add_member(n, &ls->Ghost_Integ_Active, 1,  MPI_INT);
       ddd_add_member(n, &ls->CrossMeshQuadPoints, 1,  MPI_INT);
@@ -1498,6 +1621,7 @@ noahs_ark()
 	  ddd_add_member(n, &pfd->ls[i]->Control_Width, 1,      MPI_DOUBLE);
 	  ddd_add_member(n, &pfd->ls[i]->Renorm_Tolerance, 1,   MPI_DOUBLE);
 	  ddd_add_member(n, &pfd->ls[i]->Renorm_Method, 1,      MPI_INT);
+	  ddd_add_member(n, &pfd->ls[i]->Renorm_Band, 1,        MPI_DOUBLE);
 	  ddd_add_member(n, &pfd->ls[i]->Search_Option, 1,      MPI_INT);
 	  ddd_add_member(n, &pfd->ls[i]->Grid_Search_Depth, 1,  MPI_INT);
 	  ddd_add_member(n, &pfd->ls[i]->Integration_Depth, 1,  MPI_INT);
@@ -1514,6 +1638,7 @@ noahs_ark()
 	  ddd_add_member(n, &pfd->ls[i]->Solid_Sign, 1,         MPI_INT);
 	  ddd_add_member(n, &pfd->ls[i]->Elem_Sign, 1,          MPI_INT);
 	  ddd_add_member(n, &pfd->ls[i]->SubElemIntegration, 1,  MPI_INT);
+	  ddd_add_member(n, &pfd->ls[i]->SubElem_Cache_Tol, 1,  MPI_DOUBLE);
 	  ddd_add_member(n, &pfd->ls[i]->AdaptIntegration, 1,  MPI_INT);
 	  ddd_add_member(n, &pfd->ls[i]->Adaptive_Order, 1,  MPI_INT);
 	  ddd_add_member(n, &pfd->ls[i]->Ghost_Integ, 1,  MPI_INT);
@@ -1941,6 +2066,7 @@ noahs_ark()
       ddd_add_member(n, &mp_glob[i]->heat_capacity_tableid, 1, MPI_INT);
       ddd_add_member(n, &mp_glob[i]->diffusivity_tableid, 1, MPI_INT);
       ddd_add_member(n, &mp_glob[i]->saturation_tableid, 1, MPI_INT);
+      ddd_add_member(n, &mp_glob[i]->saturation_table_tol, 1, MPI_DOUBLE);
 
       /*
        * Material property constants that are vectors over the concentration
@@ -1980,6 +2106,7 @@ noahs_ark()
       ddd_add_member(n, mp_ptr->Volumetric_Dirichlet_Cond, MAX_CONC, MPI_INT);
  
       ddd_add_member(n, mp_glob[i]->DiffusivityModel, MAX_CONC, MPI_INT);
+      ddd_add_member(n, mp_glob[i]->Plugin, MAX_PLUGIN_SLOTS, MPI_INT);
       ddd_add_member(n, mp_glob[i]->LatentHeatFusionModel, MAX_CONC, MPI_INT);
       ddd_add_member(n, mp_glob[i]->LatentHeatVapModel, MAX_CONC, MPI_INT);
       ddd_add_member(n, mp_glob[i]->RefConcnModel,MAX_CONC, MPI_INT);
@@ -2723,7 +2850,7 @@ noahs_ark()
 */
 #endif
 
-  ddd_set_commit(n);
+  ddd_set_pack(n);
 
 #ifdef DEBUG
   printf("P_%d exiting noahs_ark()\n", ProcID);
@@ -3730,7 +3857,7 @@ noahs_dove()
      crdv( pp_volume[i]->num_params, pp_volume[i]->params);
     }
   
-  ddd_set_commit(n);
+  ddd_set_pack(n);
 
 #endif
   return;
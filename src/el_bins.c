@@ -0,0 +1,308 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * Uniform bins of element bounding boxes, for locating points in a mesh.
+ *
+ * The bins cover the bounding box of the elements binned and are sized so
+ * that there are about as many bins as elements.  A point then has a
+ * handful of candidate elements, the ones listed in its bin, and the
+ * element nearest to it by some reference point (the center, say) is
+ * found by searching outward ring by ring from its bin.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+
+#include "std.h"
+#include "rf_allo.h"
+#include "mm_eh.h"
+#include "exo_struct.h"
+
+#define _EL_BINS_C
+#include "goma.h"
+
+/*
+ * Bin index of coordinate v in direction d, clamped to the bins.
+ */
+
+static int
+bin_index(const ELEM_BINS *eb,
+	  const int d,
+	  const dbl v)
+{
+  int i;
+
+  if (eb->h[d] <= 0.) return 0;
+  i = (int) floor((v - eb->lo[d]) / eb->h[d]);
+  return MAX(0, MIN(i, eb->nb[d] - 1));
+}
+
+/*
+ * Bounding box of element e in the coordinates coor.
+ */
+
+static void
+elem_box(Exo_DB *exo,
+	 dbl **coor,
+	 const int dim,
+	 const int e,
+	 dbl lo[3],
+	 dbl hi[3])
+{
+  int d, k, node;
+
+  for (d = 0; d < 3; d++) {
+    lo[d] = 0.;
+    hi[d] = 0.;
+  }
+  for (k = exo->elem_node_pntr[e]; k < exo->elem_node_pntr[e+1]; k++) {
+    node = exo->elem_node_list[k];
+    for (d = 0; d < dim; d++) {
+      if (k == exo->elem_node_pntr[e] || coor[d][node] < lo[d]) {
+	lo[d] = coor[d][node];
+      }
+      if (k == exo->elem_node_pntr[e] || coor[d][node] > hi[d]) {
+	hi[d] = coor[d][node];
+      }
+    }
+  }
+}
+
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
+void
+elem_bins_build(ELEM_BINS *eb,
+		Exo_DB *exo,
+		dbl **coor,
+		const int dim,
+		const int e_start,
+		const int e_end)
+
+    /*************************************************************************
+     *
+     * elem_bins_build():
+     *
+     *  Bin the elements [e_start,e_end) by their bounding boxes in coor,
+     *  which is indexed like Coor[dim][node]. Any bins eb already held are
+     *  freed first (so eb must start out zeroed), which makes this also
+     *  the way to refit the bins after the mesh moves.
+     *************************************************************************/
+{
+  int d, e, i, j, k, n, nbins, b;
+  int ilo[3], ihi[3];
+  dbl lo[3], hi[3], top[3], ext[3], vol, h;
+
+  if (!exo->elem_node_conn_exists) {
+    EH(-1, "elem_bins_build: needs the elem->node connectivity");
+  }
+
+  elem_bins_free(eb);
+
+  eb->dim     = MAX(1, MIN(dim, 3));
+  eb->e_start = e_start;
+  eb->e_end   = e_end;
+  n = MAX(e_end - e_start, 1);
+
+  /*
+   * Bounding box of all of the elements.
+   */
+  for (d = 0; d < 3; d++) {
+    eb->lo[d] = 0.;
+    ext[d] = 0.;
+    top[d] = 0.;
+  }
+  for (e = e_start; e < e_end; e++) {
+    elem_box(exo, coor, eb->dim, e, lo, hi);
+    for (d = 0; d < eb->dim; d++) {
+      if (e == e_start || lo[d] < eb->lo[d]) eb->lo[d] = lo[d];
+      if (e == e_start || hi[d] > top[d]) top[d] = hi[d];
+    }
+  }
+  for (d = 0; d < eb->dim; d++) ext[d] = top[d] - eb->lo[d];
+
+  /*
+   * Cubic bins of about one element each; flat directions get one bin.
+   */
+  vol = 1.;
+  k = 0;
+  for (d = 0; d < eb->dim; d++) {
+    if (ext[d] > 0.) {
+      vol *= ext[d];
+      k++;
+    }
+  }
+  h = (k > 0) ? pow(vol / (dbl) n, 1. / (dbl) k) : 0.;
+
+  nbins = 1;
+  for (d = 0; d < 3; d++) {
+    eb->nb[d] = 1;
+    eb->h[d] = 0.;
+    if (d < eb->dim && ext[d] > 0. && h > 0.) {
+      eb->nb[d] = MAX(1, MIN((int) ceil(ext[d] / h), 4 * n));
+      eb->h[d] = ext[d] / (dbl) eb->nb[d];
+    }
+    nbins *= eb->nb[d];
+  }
+
+  /*
+   * Count, then fill, the elements overlapping each bin.
+   */
+  eb->bin_ptr = alloc_int_1(nbins + 1, 0);
+  for (b = 0; b < 2; b++) {
+    if (b == 1) {
+      for (i = 0; i < nbins; i++) eb->bin_ptr[i+1] += eb->bin_ptr[i];
+      eb->bin_list = alloc_int_1(MAX(eb->bin_ptr[nbins], 1), -1);
+    }
+    for (e = e_start; e < e_end; e++) {
+      elem_box(exo, coor, eb->dim, e, lo, hi);
+      for (d = 0; d < 3; d++) {
+	ilo[d] = bin_index(eb, d, lo[d]);
+	ihi[d] = bin_index(eb, d, hi[d]);
+      }
+      for (k = ilo[2]; k <= ihi[2]; k++) {
+	for (j = ilo[1]; j <= ihi[1]; j++) {
+	  for (i = ilo[0]; i <= ihi[0]; i++) {
+	    n = (k * eb->nb[1] + j) * eb->nb[0] + i;
+	    if (b == 0) {
+	      eb->bin_ptr[n+1]++;
+	    } else {
+	      eb->bin_list[eb->bin_ptr[n]++] = e;
+	    }
+	  }
+	}
+      }
+    }
+  }
+
+  /* the fill pass left each bin_ptr at the start of the next bin */
+  for (i = nbins; i > 0; i--) eb->bin_ptr[i] = eb->bin_ptr[i-1];
+  eb->bin_ptr[0] = 0;
+}
+
+/*****************************************************************************/
+
+void
+elem_bins_free(ELEM_BINS *eb)
+{
+  if (eb->bin_ptr != NULL) safe_free(eb->bin_ptr);
+  if (eb->bin_list != NULL) safe_free(eb->bin_list);
+  eb->bin_ptr = NULL;
+  eb->bin_list = NULL;
+}
+
+/*****************************************************************************/
+
+int
+elem_bins_at(const ELEM_BINS *eb,
+	     const dbl x[],
+	     int **elems)
+
+    /*************************************************************************
+     *
+     * elem_bins_at():
+     *
+     *  Return: the number of elements whose bounding box overlaps the bin
+     *          of x, with *elems pointing at them; 0 if x is outside the
+     *          bins. The list may include elements not holding x.
+     *************************************************************************/
+{
+  int d, i[3], n;
+
+  *elems = NULL;
+  for (d = 0; d < 3; d++) {
+    i[d] = 0;
+    if (d >= eb->dim) continue;
+    if (x[d] < eb->lo[d] || x[d] > eb->lo[d] + eb->nb[d] * eb->h[d]) return 0;
+    i[d] = bin_index(eb, d, x[d]);
+  }
+  n = (i[2] * eb->nb[1] + i[1]) * eb->nb[0] + i[0];
+  *elems = eb->bin_list + eb->bin_ptr[n];
+  return eb->bin_ptr[n+1] - eb->bin_ptr[n];
+}
+
+/*****************************************************************************/
+
+int
+elem_bins_nearest(const ELEM_BINS *eb,
+		  const dbl x[],
+		  dbl **ctr)
+
+    /*************************************************************************
+     *
+     * elem_bins_nearest():
+     *
+     *  Return: the binned element whose point ctr[e] is closest to x, the
+     *          lowest numbered one on a tie; -1 if no elements are binned.
+     *          ctr[e] must lie in the bounding box of e, as the center or
+     *          any node of the element does.
+     *
+     *  The bins are searched in square rings around the bin of x (x is
+     *  clamped into the bins when it is outside). Everything in ring r is
+     *  at least (r-1) bin widths away, which ends the search once the
+     *  best distance found so far is shorter.
+     *************************************************************************/
+{
+  int d, r, rmax, n, k, e, best = -1;
+  int c[3], i[3], on_ring;
+  dbl hmin, dist, best_dist = 0., lb;
+
+  if (eb->e_end <= eb->e_start) return -1;
+
+  rmax = 0;
+  hmin = -1.;
+  for (d = 0; d < 3; d++) {
+    c[d] = bin_index(eb, d, (d < eb->dim) ? x[d] : 0.);
+    rmax = MAX(rmax, MAX(c[d], eb->nb[d] - 1 - c[d]));
+    if (eb->h[d] > 0. && (hmin < 0. || eb->h[d] < hmin)) hmin = eb->h[d];
+  }
+  if (hmin < 0.) hmin = 0.;
+
+  for (r = 0; r <= rmax; r++) {
+    lb = (r - 1) * hmin;
+    if (best != -1 && r > 0 && best_dist < lb * lb) break;
+
+    for (i[2] = MAX(c[2] - r, 0); i[2] <= MIN(c[2] + r, eb->nb[2] - 1); i[2]++) {
+      for (i[1] = MAX(c[1] - r, 0); i[1] <= MIN(c[1] + r, eb->nb[1] - 1); i[1]++) {
+	for (i[0] = MAX(c[0] - r, 0); i[0] <= MIN(c[0] + r, eb->nb[0] - 1); i[0]++) {
+	  on_ring = FALSE;
+	  for (d = 0; d < 3; d++) {
+	    if (abs(i[d] - c[d]) == r) on_ring = TRUE;
+	  }
+	  if (!on_ring) continue;
+
+	  n = (i[2] * eb->nb[1] + i[1]) * eb->nb[0] + i[0];
+	  for (k = eb->bin_ptr[n]; k < eb->bin_ptr[n+1]; k++) {
+	    e = eb->bin_list[k];
+	    dist = 0.;
+	    for (d = 0; d < eb->dim; d++) {
+	      dist += (x[d] - ctr[e][d]) * (x[d] - ctr[e][d]);
+	    }
+	    if (best == -1 || dist < best_dist ||
+		(dist == best_dist && e < best)) {
+	      best = e;
+	      best_dist = dist;
+	    }
+	  }
+	}
+      }
+    }
+  }
+
+  return best;
+}
+/*****************************************************************************/
+/* END of file el_bins.c */
+/*****************************************************************************/
@@ -44,7 +44,8 @@ static char rcsid[] =
 *
 *  NAME                         TYPE            CALL_BY
 * ---------------               -------         ------------------------
-*  elem_info ()                 int             "mm_fill.c" matrix_fill 
+*  elem_info_switch ()          int             elem_info() in el_elm_info.h
+*  reduced_quad_type ()         int             "mm_fill.c" matrix_fill
 *  find_stu  ()                 void            "mm_fill.c" matrix_fill
 *  find_surf_st  ()             void            "mm_fill.c" matrix_fill
 *  Gq_weight ()                 double          "mm_fill.c" matrix_fill
@@ -56,8 +57,8 @@ static char rcsid[] =
 ******************************************************************************/
 
 int
-elem_info(const int info,
-          const int ielem_type )
+elem_info_switch(const int info,
+                 const int ielem_type )
      /*
       *        Function which returns the various parameters
       *       for the elements, e.g., polynomial order, number of
@@ -679,7 +680,34 @@ elem_info(const int info,
           break;
   }
   return answer;
-} /* END of routine elem_info   */
+} /* END of routine elem_info_switch   */
+/*****************************************************************************/
+
+int
+reduced_quad_type(const int ielem_type)
+     /*
+      *        Element type whose volume quadrature rule integrates
+      *       the equations selected by "Reduced Quadrature" on an
+      *       element of type ielem_type: the rule of the linear
+      *       element of the same shape for the quadratic quads, hexes
+      *       and triangles, ielem_type itself (no reduction) otherwise.
+      *       Use it in place of ielem_type in elem_info(NQUAD, ),
+      *       find_stu() and Gq_weight().
+      */
+{
+  switch (ielem_type) {
+  case QUAD_TRI:
+    return (LINEAR_TRI);
+  case S_BIQUAD_QUAD:
+  case BIQUAD_QUAD:
+    return (BILINEAR_QUAD);
+  case S_TRIQUAD_HEX:
+  case TRIQUAD_HEX:
+    return (TRILINEAR_HEX);
+  default:
+    return (ielem_type);
+  }
+} /* END of routine reduced_quad_type */
 /*****************************************************************************/
 
 #ifdef DEBUG_HKM
@@ -1681,7 +1709,7 @@ dof_lnode_interp_type(const int n, const int Element_Type,
  */
 
 int 
-type2shape(const int element_type)
+type2shape_switch(const int element_type)
 {
   int shape=-1;
 
@@ -1738,7 +1766,7 @@ type2shape(const int element_type)
  */
 
 int
-shape2sides(const int element_shape)
+shape2sides_switch(const int element_shape)
 {
   int num_sides=-1;
 
@@ -1787,7 +1815,7 @@ shape2sides(const int element_shape)
 /*******************************************************************************/
 
 int
-getdofs(const int element_shape, const int interpolation)
+getdofs_switch(const int element_shape, const int interpolation)
 
     /**************************************************************************
      *
@@ -2765,6 +2793,61 @@ find_surf_st(const int iquad,           /* current GQ index */
 
 /*****************************************************************************/
 
+#define SURF_QUAD_MAX_SIDE 6
+
+static struct Surf_Quad_Side
+Surf_Quad_Table[P0_SHELL + 1][SURF_QUAD_MAX_SIDE + 1][DIM + 1];
+
+const struct Surf_Quad_Side *
+surf_quad_side(const int ielem_type,	/* element type */
+	       const int iside,		/* side of element (1-based) */
+	       const int dim)		/* dimension of element */
+
+/*
+ *      Quadrature points, local coordinates and weights of one side of an
+ *      element type. The first request for a side fills its entry from
+ *      find_surf_st() and Gq_surf_weight(); after that the integrated
+ *      boundary conditions read the table instead of running through the
+ *      element switches at every gauss point of every side.
+ */
+{
+  struct Surf_Quad_Side *q;
+  int ip;
+
+  if (ielem_type < 0 || ielem_type > P0_SHELL ||
+      iside < 0 || iside > SURF_QUAD_MAX_SIDE || dim < 0 || dim > DIM) {
+    EH(-1, "surf_quad_side: element type, side or dimension out of range");
+  }
+
+  q = &Surf_Quad_Table[ielem_type][iside][dim];
+  if (!q->filled) {
+#ifdef _OPENMP
+#pragma omp critical (surf_quad_side)
+#endif
+    {
+      if (!q->filled) {
+	q->nquad = elem_info(NQUAD_SURF, ielem_type);
+	if (q->nquad > MAX_SURF_GP) {
+	  EH(-1, "surf_quad_side: too many surface quadrature points");
+	}
+	for (ip = 0; ip < q->nquad; ip++) {
+	  q->s[ip] = q->t[ip] = q->u[ip] = 0.;
+	  find_surf_st(ip, ielem_type, iside, dim, q->xi[ip],
+		       &q->s[ip], &q->t[ip], &q->u[ip]);
+	  q->wt[ip] = Gq_surf_weight(ip, ielem_type);
+	}
+#ifdef _OPENMP
+#pragma omp flush
+#endif
+	q->filled = TRUE;
+      }
+    }
+  }
+  return q;
+}
+
+/*****************************************************************************/
+
 int
 find_edge_s (const int iquad,                /* current GQ index  */
              const int ielem_type,           /* element type   */
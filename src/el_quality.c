@@ -36,6 +36,9 @@ static char rcsid[] =
  *  NAME				TYPE		CALL_BY
  * ---------------		-------		------------------------
  *  element_quality ()           int             solve_problem
+ *  quality_pass ()              double          element_quality
+ *  element_quality_jac_collect () void          matrix_fill
+ *  assembled_jacobian_metric () double          quality_pass
  *  jacobian_metric ()           double          element_quality
  *  angle_metric ()              double          element_quality
  *  triangle_metric ()           double          element_quality
@@ -52,6 +55,14 @@ PROTO((Exo_DB *,		/* Exodus database structure */
        int *));			/* proc_config array */
 static double volume_metric
 PROTO((int *));			/* proc_config array */
+static double assembled_jacobian_metric
+PROTO((int *));			/* proc_config array */
+static double quality_pass
+PROTO((Exo_DB *,		/* Exodus database structure */
+       double *,		/* Solution vector */
+       int *,			/* proc_config array */
+       int,			/* all metrics, from scratch */
+       int));			/* first check of the run */
 static double angle_metric
 PROTO((Exo_DB *,		/* Exodus database structure */
        double *,		/* Solution vector */
@@ -99,23 +110,78 @@ element_quality(Exo_DB *exo, double *x, int *proc_config)
       *      tri		Maximum distortion of sub-triangles
       *			(from El-Hamalawi, Comp & Struct 2000)
       *
+      *   With Element quality incremental, the Jacobian metric is the
+      *   one gathered from detJ during the last residual assembly and
+      *   the angle and triangle metrics are skipped, so a check needs no
+      *   pass over the mesh. Only when that quality comes within the
+      *   margin of the tolerance (or every inc_full_every checks) are
+      *   all of the metrics computed afresh, and that pass decides.
+      *
       */
 
 {
-  double mavg = 0.0, tavg = 0.0, quality = 0.0;
-  double qmin = 999.9, wt_sum = 0.0, wt_min = 0.0;
   static int first_call = TRUE;
+  static int checks = 0;
+  double quality;
+  int full = TRUE;
   
   /* Quick exit if no metrics were specified */
   if (nEQM == 0) return(TRUE);
 
+  if (eqm->incremental)
+    {
+      checks++;
+      full = first_call ||
+	(eqm->inc_full_every > 0 && checks % eqm->inc_full_every == 0);
+    }
+
+  quality = quality_pass(exo, x, proc_config, full, first_call);
+  if (!full && quality < eqm->inc_margin * eqm->eq_tol)
+    {
+      DPRINTF (stderr, "Element quality near tolerance, checking all metrics\n");
+      quality = quality_pass(exo, x, proc_config, TRUE, first_call);
+    }
+
+  /* Check quality against tolerance and return */
+  first_call = FALSE;
+  if (quality < eqm->eq_tol)
+    {
+      DPRINTF (stderr, "Element quality below tolerance of %g\n", eqm->eq_tol);
+      DPRINTF (stderr, "\tREMESHING IS REQUIRED!\n");
+      return(FALSE);
+    }
+  else
+    {
+      DPRINTF (stderr, "Element quality OK!\n");
+      return(TRUE);
+    }
+}  /* End of function "element_quality" */
+
+static double
+quality_pass(Exo_DB *exo, double *x, int *proc_config, int full,
+	     int first_call)
+
+     /*
+      *   One evaluation of the requested metrics, printed as a table.
+      *   A pass that is not full uses the assembled Jacobian metric
+      *   (when there is one) and skips the angle and triangle metrics.
+      *   Returns the quality to compare with the tolerance.
+      */
+
+{
+  double mavg = 0.0, tavg = 0.0, quality = 0.0;
+  double qmin = 999.9, wt_sum = 0.0, wt_min = 0.0;
+
   /* Output table header */
-  DPRINTF (stderr, "\n ELEMENT QUALITY METRIC         AVG              MIN\n");
+  DPRINTF (stderr, "\n ELEMENT QUALITY METRIC         AVG              MIN%s\n",
+	   full ? "" : "      (incremental)");
 
   /* Compute each requested metric */
   if (eqm->do_jac)
     {
-      mavg = jacobian_metric(exo, x, proc_config);
+      mavg = -1.0;
+      if (!full) mavg = assembled_jacobian_metric(proc_config);
+      if (mavg < 0.0) mavg = jacobian_metric(exo, x, proc_config);
       DPRINTF (stderr, "               Jacobian         %8g         %8g\n",
 	       mavg, eqm->eq_jac);
       tavg += eqm->wt_jac * mavg;  
@@ -133,7 +199,7 @@ element_quality(Exo_DB *exo, double *x, int *proc_config)
       wt_sum += eqm->wt_vol;
       if (eqm->eq_vol < qmin) qmin = eqm->eq_vol;
     }
-  if (eqm->do_ang)
+  if (eqm->do_ang && full)
     {
       mavg = angle_metric(exo, x, proc_config);
       DPRINTF (stderr, "               Angle            %8g         %8g\n",
@@ -143,7 +209,7 @@ element_quality(Exo_DB *exo, double *x, int *proc_config)
       wt_sum += eqm->wt_ang;
       if (eqm->eq_ang < qmin) qmin = eqm->eq_ang;
     }
-  if (eqm->do_tri)
+  if (eqm->do_tri && full)
     {
       mavg = triangle_metric(exo, x, proc_config);
       DPRINTF (stderr, "               Triangle         %8g         %8g\n",
@@ -155,8 +221,11 @@ element_quality(Exo_DB *exo, double *x, int *proc_config)
     }
 
   /* Combined metric based on each requested method */
-  tavg /= wt_sum;
-  wt_min /= wt_sum;
+  if (wt_sum > 0.0)
+    {
+      tavg /= wt_sum;
+      wt_min /= wt_sum;
+    }
   if (nEQM > 1)
     {
       DPRINTF (stderr, "               COMBINED         %8g         %8g     %8g\n", tavg, qmin, wt_min);
@@ -177,11 +246,11 @@ element_quality(Exo_DB *exo, double *x, int *proc_config)
     }
   else if (eqm->tol_type == EQM_ANG && eqm->do_ang)
     {
-      quality = eqm->eq_ang;
+      quality = full ? eqm->eq_ang : qmin;
     }
   else if (eqm->tol_type == EQM_TRI && eqm->do_tri)
     {
-      quality = eqm->eq_tri;
+      quality = full ? eqm->eq_tri : qmin;
     }
   else if (eqm->tol_type == EQM_WTMIN)
     {
@@ -191,21 +260,54 @@ element_quality(Exo_DB *exo, double *x, int *proc_config)
     {
       quality = qmin;
     }
+  return quality;
+}  /* End of function quality_pass */
 
-  /* Check quality against tolerance and return */
-  first_call = FALSE;
-  if (quality < eqm->eq_tol)
-    {
-      DPRINTF (stderr, "Element quality below tolerance of %g\n", eqm->eq_tol);
-      DPRINTF (stderr, "\tREMESHING IS REQUIRED!\n");
-      return(FALSE);
-    }
-  else
+void
+element_quality_jac_collect(const int ngp, const double Jw_min,
+			    const double Jw_sum)
+
+     /*
+      *   Add one element's Jacobian metric to the incremental sums, from
+      *   the |detJ| times Gauss weight of its ngp points in an assembly.
+      */
+
+{
+  double eq;
+
+  if (ngp <= 0 || Jw_sum <= 0.0) return;
+  eq = (double)ngp * Jw_min / Jw_sum;
+#ifdef _OPENMP
+#pragma omp critical (eqm_jac_collect)
+#endif
+  {
+    eqm->jac_sum += eq;
+    if (eq < eqm->jac_low) eqm->jac_low = eq;
+    eqm->jac_count++;
+  }
+}  /* End of function element_quality_jac_collect */
+
+static double assembled_jacobian_metric(int *proc_config)
+     /*
+      * Jacobian metric data collected during assembly, as for the volume
+      * change; -1 if the assembly collected none anywhere.
+      */
+{
+  double els = (double)eqm->jac_count;
+  double sum = eqm->jac_sum;
+  double low = eqm->jac_low;
+
+  if (Num_Proc > 1)
     {
-      DPRINTF (stderr, "Element quality OK!\n");
-      return(TRUE);
+      els = (double)AZ_gsum_int(eqm->jac_count, proc_config);
+      sum = AZ_gsum_double(eqm->jac_sum, proc_config);
+      low = AZ_gmin_double(eqm->jac_low, proc_config);
     }
-}  /* End of function "element_quality" */
+  if (els == 0.0) return -1.0;
+
+  eqm->eq_jac = low;
+  return sum / els;
+}  /* End of function assembled_jacobian_metric */
   
 static double jacobian_metric(Exo_DB *exo, double *x, int *proc_config)
 {
@@ -48,6 +48,10 @@
  *		    For now, serially, this will be the same as outer space,
  *		    but we can identify them easily as, say, elem name < 0.
  *
+ *		[5] Faces are matched through a hash table keyed by their
+ *		    sorted corner nodes, so that the element->element
+ *		    connectivity costs time linear in the number of faces.
+ *
  *
  *   "Dedicated to Bob Cochran, who inspired me to use pointers and lists
  *    to handle just about any kind of connectivity."
@@ -87,13 +91,27 @@ static char rcsid[] = "$Id: exo_conn.c,v 5.3 2009-11-13 23:20:07 prschun Exp $";
  * Prototype declarations of static functions defined in this file.
  */
 
-static int int_intersect
-PROTO((int *,			/* a - first integer list	        (in) */
-       int *,			/* b - second integer list              (in) */
-       const int ,		/* len_a - length of 1st integer list   (in) */
-       const int ,		/* len_b - length of 2nd  integer list  (in) */
-       int *,			/* ia - indeces intersections, 1st list (out)*/
-       int *));			/* ib - indeces intersections, 2nd list (out)*/
+/*
+ * One entry of the face table built by build_elem_elem().
+ */
+
+struct face_slot
+{
+  unsigned hash;		/* side_hash() of the face */
+  int elem;			/* -1 for an empty slot */
+  int face;			/* 0-based face number of elem */
+};
+
+static int sorted_side_node_list
+PROTO((const int ,		/* elem - element number                     */
+       const int ,		/* face - face number 0,1,...,num_faces-1    */
+       Exo_DB *,		/* exo - FE database                         */
+       int *));			/* snl - sorted node numbers on the face     */
+
+static unsigned side_hash
+PROTO((const int *,		/* snl - sorted node numbers on the face     */
+       const int ,		/* num_nodes - length of snl                 */
+       const int ));		/* num_faces - faces of the element          */
 
 static int sides2nodes
 PROTO((const int ,		/* face - face number 0,1,...,num_faces-1    */
@@ -247,6 +265,7 @@ build_node_node(Exo_DB *exo)
   int n_elem;
   
   int *list;
+  int *mark;
   /*
    * Don't even attempt to do this without adequate preparation.
    */
@@ -299,6 +318,13 @@ build_node_node(Exo_DB *exo)
 
   list = (int *) smalloc(max*sizeof(int));
 
+  /*
+   * mark[dude] == node once dude is in the list of node, so that the
+   * duplicates are dropped without searching the list.
+   */
+
+  mark = alloc_int_1(exo->num_nodes, -1);
+
   /*
    * Loop through each node and build a list of all the nodes to which it
    * is connected. Flatten the list by extracting duplicate entries. Finally,
@@ -314,13 +340,6 @@ build_node_node(Exo_DB *exo)
 
       exo->centroid_list[node] = -1;
 
-      /* Clear out any old garbage... */
-
-      for ( i=0; i<max; i++)
-	{
-	  list[i] = -1;
-	}
-
       curr_list_size = 0;
 
       for ( e=exo->node_elem_pntr[node]; e<exo->node_elem_pntr[node+1]; e++)
@@ -338,8 +357,9 @@ build_node_node(Exo_DB *exo)
 	       * suitably larger.
 	       */
 
-	      if ( -1 == in_list(dude, 0, curr_list_size, list) )
+	      if ( mark[dude] != node )
 		{
+		  mark[dude] = node;
 		  list[curr_list_size] = dude;
 		  curr_list_size++;
 		}
@@ -380,8 +400,9 @@ build_node_node(Exo_DB *exo)
 		      
 			  dude = exo->elem_node_list[ exo->elem_node_pntr[n_elem] + n ];
 			  
-			  if ( -1 == in_list(dude, 0, curr_list_size, list) )
+			  if ( mark[dude] != node )
 			    {
+			      mark[dude] = node;
 			      list[curr_list_size++] = dude;
 			    }
 			}
@@ -427,10 +448,87 @@ build_node_node(Exo_DB *exo)
 #endif
 
   safe_free(list);
+  safe_free(mark);
 
   return;
 }
 
+/*
+ * Rebuild the node -> node connectivity if trim_exo() freed it, for the
+ * few that use it after setup.
+ */
+
+void
+need_node_node(Exo_DB *exo)
+{
+  if ( ! exo->node_node_conn_exists )
+    {
+      build_node_node(exo);
+    }
+}
+
+/*
+ * With Memory Lean, once the matrix graph is built, free what the run
+ * needs no more:
+ *
+ *  o the node -> node connectivity (and centroid_list), unless level
+ *    sets or phase functions renormalize with it now and then; the graph
+ *    builders and the other users call need_node_node().
+ *
+ *  o the node set and side set distribution factors, which wr_mesh_exo()
+ *    reads back from the mesh file when it writes a new mesh.
+ *
+ *  o any results arrays read along with the mesh.
+ *
+ * The elem -> node, node -> elem and elem -> elem lists are kept, as the
+ * assembly and the boundary conditions use them throughout. Must be
+ * called by every processor.
+ */
+
+void
+trim_exo(Exo_DB *exo)
+{
+  dbl freed = 0.;
+
+  if ( ! Memory_Lean ) return;
+
+  if ( exo->node_node_conn_exists && ls == NULL && pfd == NULL )
+    {
+      freed += (dbl) (exo->node_node_pntr[exo->num_nodes] +
+		      2 * exo->num_nodes + 1) * sizeof(int);
+      safer_free((void **) &(exo->node_node_pntr));
+      safer_free((void **) &(exo->node_node_list));
+      safer_free((void **) &(exo->centroid_list));
+      exo->node_node_conn_exists = FALSE;
+    }
+
+  if ( ! exo->distfact_freed )
+    {
+      freed += (dbl) (exo->ns_distfact_len + exo->ss_distfact_len) * sizeof(dbl);
+      free_exo_distfacts(exo);
+    }
+
+  if ( exo->state & EXODB_STATE_NDVA )
+    {
+      freed += (dbl) exo->num_nv_time_indeces * exo->num_nv_indeces *
+	exo->num_nodes * sizeof(dbl);
+      free_exo_nv(exo);
+    }
+  if ( exo->state & EXODB_STATE_ELVA )
+    {
+      freed += (dbl) exo->num_ev_time_indeces * exo->num_elem_vars *
+	exo->num_elems * sizeof(dbl);
+      free_exo_ev(exo);
+    }
+  if ( exo->state & EXODB_STATE_GBVA )
+    {
+      free_exo_gv(exo);
+    }
+
+  freed = gavg_double(freed);
+  DPRINTF(stdout, "Memory Lean: %.3g MB of mesh data freed per processor\n",
+	  freed / (1024. * 1024.));
+}
 
 void
 build_node_elem(Exo_DB *exo)
@@ -560,41 +658,28 @@ build_node_elem(Exo_DB *exo)
 void
 build_elem_elem(Exo_DB *exo)
 {
-  int ce;
   int count;
   int e;
   int ebi;
   int elem;
-  int ename;
   int face;
-  //int his_dim, her_dim;
+  int first_shared;
   int i, j;
-  int index;
-  int len_curr;
-  int len_prev;
-  int len_intr;
   int length, length_new, num_faces;
   int iel;
   int ioffset;
   int n;
-  int neighbor_name = -1;
-  int node;
   int num_elem_sides;
   int num_nodes;
+  int num_shared;
   int snl[MAX_NODES_PER_SIDE];	/* Side Node List - NOT Saturday Night Live! */
+  int table_size;
+  unsigned hash;
+  unsigned slot;
+  unsigned table_mask;
+  struct face_slot *table;	/* every face, keyed by its corner nodes */
   char err_msg[MAX_CHAR_ERR_MSG];
 
-  /*
-   * Integer arrays used to find intersection sets of node->element lists.
-   */
-
-  int prev_set[MAX_EPN];	/* list of elements attached to previous node*/
-  int curr_set[MAX_EPN];	/* list of elements attached to "this" node */
-
-
-  int ip[MAX_EPN];		/* indeces of hits for prev_set[] */
-  int ic[MAX_EPN];		/* indeces of hits for curr_set[] */
-
   /*
    * If the element->node and node->element connectivities have not been
    * built, then we won't be able to do this task.
@@ -649,7 +734,9 @@ build_elem_elem(Exo_DB *exo)
  */
 
  /*
-  * Walk through the elements, block by block.
+  * Walk through the elements, block by block, laying out the face
+  * pointers and entering every face into the face table under its
+  * sorted corner nodes.
   */
 
  count = 0;
@@ -657,327 +744,145 @@ build_elem_elem(Exo_DB *exo)
  for ( ebi=0; ebi<exo->num_elem_blocks; ebi++)
    {
      num_elem_sides = get_num_faces(exo->eb_elem_type[ebi]);
-
      for ( e=0; e<exo->eb_num_elems[ebi]; e++,elem++)
        {
 	 exo->elem_elem_pntr[elem] = count;
 	 count += num_elem_sides;
-	 
-	 /*
-	  * Look at each side of the element, collecting a unique
-	  * list of integers corresponding to the minimum number of nodes
-	  * needed to identify an entire side. 
-	  *
-	  * Typically, the same number of nodes as space dimensions are
-	  * needed, with exceptions being the various "sides" of shells,
-	  * beams and trusses...
-	  */
+       }
+   }
+
+ for ( table_size=1; table_size < length + length/2 + 1; table_size *= 2 );
+ table_mask = (unsigned) (table_size - 1);
+ table = (struct face_slot *) smalloc(table_size*sizeof(struct face_slot));
+ for ( i=0; i<table_size; i++)
+   {
+     table[i].elem = -1;
+   }
 
+ elem = 0;
+ for ( ebi=0; ebi<exo->num_elem_blocks; ebi++)
+   {
+     num_elem_sides = get_num_faces(exo->eb_elem_type[ebi]);
+     for ( e=0; e<exo->eb_num_elems[ebi]; e++,elem++)
+       {
 	 for ( face=0; face<num_elem_sides; face++)
 	   {
+	     num_nodes = sorted_side_node_list(elem, face, exo, snl);
+	     hash = side_hash(snl, num_nodes, num_elem_sides);
+	     for ( slot=hash & table_mask; table[slot].elem != -1;
+		   slot=(slot+1) & table_mask );
+	     table[slot].hash = hash;
+	     table[slot].elem = elem;
+	     table[slot].face = face;
+	   }
+       }
+   }
 
-	     /*
-	      * Given the element and the face construct the
-	      * list of node numbers that determine that side.
-	      */
-
-	     /*
-	      * Later, we might not need *all* the nodes on a side,
-	      * particularly for high order elements. It may suffice
-	      * to check only as many nodes as space dimensions that
-	      * the element lives in...
-	      */
-
-	     num_nodes = build_side_node_list(elem, face, exo, snl);
-#ifdef DEBUG
-	     fprintf(stderr, "Elem %d, face %d has %d nodes: ", elem, face,
-		     num_nodes);
-	     for ( i=0; i<num_nodes; i++)
-	       {
-		 fprintf(stderr, " %d", snl[i]);
-	       }
-	     fprintf(stderr, "\n");
-#endif /* DEBUG */
-
-	     /*
-	      * Cross check: for each node in the side there is a list
-	      * of elements connected to it. Beginning with all the
-	      * elements connected to the first node (except for this given
-	      * element), cross check with all the elements connected with
-	      * the 2nd node to build an intersection set of one element.
-	      */
-
-	     for ( i=0; i<MAX_EPN; i++)
-	       {
-		 prev_set[i] = -1;
-		 curr_set[i] = -1;
-	       }
-	     len_prev  = 0;
-	     len_curr  = 0;
-	     len_intr  = 0;
-
-	     for ( n=0; n<num_nodes; n++)
-	       {
-		 /*
-		  * Copy this node's element list into a clean "curr_set" array
-		  * that will be intersected with any previously gathered
-		  * lists of elements that qualify as promiscuously in
-		  * contact with nodes...
-		  */
-
-		 node = snl[n];
-
-		 for ( i=0; i<MAX_EPN; i++)
-		   {
-		     curr_set[i] = -1;
-		   }
-
-		 len_curr  = 0;
-
-#ifdef DEBUG
-		 fprintf(stderr, "Traversing n->e connectivity of node %d\n",
-			 node);
-#endif /* DEBUG */
-		 for ( ce=exo->node_elem_pntr[node]; 
-		       ce<exo->node_elem_pntr[node+1]; ce++)
-		   {
-		     ename = exo->node_elem_list[ce];
-#ifdef DEBUG
-		     fprintf(stderr, "\telem %d\n", ename);
-#endif /* DEBUG */
-		     /*
-		      * Go ahead and accumulate the self element name
-		      * just as a consistency check....
-		      */
-
-		     /*
-		     if ( ename != e )
-		       {
-		       }
-		     */
-
-		     /*
-		      * PKN: The current Goma use of ->elem_elem...
-		      * is such that this connectivity should list
-		      * connections like QUAD-BAR or HEX-SHELL.
-		      * So, I'll add this dimension matching conditional
-		      */
-
-		     /* PRS (Summer 2012): Need to change this for shell stacks which 
-			have the same dim*/
-
-		     /* We need however to consider a special case (as of 8/30/2012
-		      * this is a SHELL-on-SHELL stack. Viz. two materials, each a shell material
-		      * which share not a side but a face.   Since faces of shells are sides
-		      * in patran speak, we need some special logic.   We need to avoid adding
-		      * the friend shell element (neighboring material) to the current shell element
-		      * even though each material has the same number of sides.   
-		      * Here goes   (BTW, I cannot find max-nodes-per-element anywhere!!!!)
-		      */
-		    
-		     int shell_on_shell = 0; int flippy_flop = 0; 
-		     int nbr_ebid; int nbr_num_elem_sides;
-		     nbr_ebid = fence_post(ename, exo->eb_ptr,
-                                           exo->num_elem_blocks+1);
-                     EH(nbr_ebid, "Bad element block ID!");
-                     nbr_num_elem_sides = get_num_faces(exo->eb_elem_type[nbr_ebid]);
-		     
-		     shell_on_shell = 0; 
-		     flippy_flop = 0;
-
-		     if (exo->eb_id[ebi] < 100 && exo->eb_id[nbr_ebid] >= 100) flippy_flop=1;
-		     if (exo->eb_id[ebi] >= 100 && exo->eb_id[nbr_ebid] < 100) flippy_flop=1;
-
-		     if ((nbr_ebid != ebi) && 
-			 (strstr(exo->eb_elem_type[nbr_ebid], "SHELL")) &&
-			 (strstr(exo->eb_elem_type[ebi],      "SHELL")) &&
-			 flippy_flop)  shell_on_shell = 1;
-
-		     // his_dim = elem_info(NDIM, exo->eb_elem_itype[ebi]);
-		     // her_dim = elem_info(NDIM, exo->eb_elem_itype[exo->elem_eb[ename]]);
-		     // if( his_dim == her_dim )
-		     if (nbr_num_elem_sides == num_elem_sides && !shell_on_shell)
-		       {
-			 curr_set[len_curr] = ename;
-			 len_curr++;
-		       }
-		   }
-		 
-		 /*
-		  * The first node is special - we'll just compare
-		  * it with itself by making the "previous set" just the
-		  * same as the current set...
-		  */
-		 
-
-		 if ( n == 0 )
-		   {
-		     for ( i=0; i<MAX_EPN; i++)
-		       {
-			 prev_set[i] = curr_set[i];
-		       }
-		     len_prev = len_curr;
-		   }
-
-#ifdef DEBUG
-		 fprintf(stderr, "\ncurr_set: ");
-		 for ( i=0; i<len_curr; i++)
-		   {
-		     fprintf(stderr, "%d ", curr_set[i]);
-		   }
-		 fprintf(stderr, "\nprev_set: ");
-		 for ( i=0; i<len_prev; i++)
-		   {
-		     fprintf(stderr, "%d ", prev_set[i]);
-		   }
-#endif /* DEBUG */
+ /*
+  * Now each face looks up the other faces with the same corner nodes.
+  * Only the table is shared and it is only read, so the elements may be
+  * shared out amongst the assembly threads.
+  *
+  * PKN: The current Goma use of ->elem_elem... is such that this
+  * connectivity should not list connections like QUAD-BAR or HEX-SHELL,
+  * so only neighbors with as many faces as this element qualify.
+  *
+  * PRS (Summer 2012): shell stacks have the same dim. Two shell materials
+  * (one with a block ID below 100, the other at or above) which share not
+  * a side but a face must not become neighbors of one another, even
+  * though each has the same number of sides.
+  */
 
-		 /*
-		  * First, clean the intersection list and the list of
-		  * hit indeces in the previous and current lists.
-		  *
-		  * Then find the intersection of the previous and current 
-		  * sets of elements attached to the previous and current
-		  * nodes...
-		  */
-
-		 for ( i=0; i<MAX_EPN; i++)
-		   {
-		     ip[i]       = -1;
-		     ic[i]       = -1;
-		   }
-		 len_intr = 0;
-
-		 len_intr = int_intersect(prev_set, curr_set, len_prev,
-					  len_curr, ip, ic);
+ num_shared = 0;
+ first_shared = -1;
 
-#ifdef DEBUG
-		 fprintf(stderr, "num_hits = %d\n", len_intr);
-#endif /* DEBUG */
-		 /*
-		  * Now, let's make the intersection set the next previous
-		  * set of elements, a standard for comparison. We should
-		  * eventually boil down to either one or zero elements
-		  * that qualify...
-		  */
-		 
-		 for ( i=0; i<MAX_EPN; i++)
-		   {
-		     prev_set[i] = -1;
-		   }
-
-		 for ( i=0; i<len_intr; i++)
-		   {
-		      prev_set[i] = curr_set[ic[i]];
-		   }
-
-		 len_prev = len_intr;
-	       }
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 1024) if (Num_Assembly_Threads > 1) num_threads(MAX(Num_Assembly_Threads, 1)) private(ebi, num_elem_sides, face, n, num_nodes, hash, slot, snl) reduction(+:num_shared)
+#endif
+ for ( elem=0; elem<exo->num_elems; elem++)
+   {
+     ebi = fence_post(elem, exo->eb_ptr, exo->num_elem_blocks+1);
+     num_elem_sides = get_num_faces(exo->eb_elem_type[ebi]);
 
-#ifdef DEBUG
-	     fprintf(stderr, "Element [%d], face [%d], local_node [%d]\n",
-		     elem, face, n);
-	     fprintf(stderr, "Intersection set length = %d\n", len_intr);
-#endif /* DEBUG */
+     for ( face=0; face<num_elem_sides; face++)
+       {
+	 int nbr_ebid, nbr_num_nodes, nbr_snl[MAX_NODES_PER_SIDE];
+	 int num_hits = 0;
+	 int match;
+	 int neighbor = -1;
 
-	     /*
-	      * Now consider the different cases.
-	      */
+	 num_nodes = sorted_side_node_list(elem, face, exo, snl);
+	 hash = side_hash(snl, num_nodes, num_elem_sides);
 
-	     if ( len_intr == 2 )
+	 for ( slot=hash & table_mask; table[slot].elem != -1;
+	       slot=(slot+1) & table_mask )
+	   {
+	     if ( table[slot].hash != hash ||
+		  table[slot].elem == elem ||
+		  table[slot].elem == neighbor ) continue;
+
+	     nbr_ebid = fence_post(table[slot].elem, exo->eb_ptr,
+				   exo->num_elem_blocks+1);
+	     if ( get_num_faces(exo->eb_elem_type[nbr_ebid]) != num_elem_sides )
+	       continue;
+
+	     if ( nbr_ebid != ebi &&
+		  strstr(exo->eb_elem_type[nbr_ebid], "SHELL") &&
+		  strstr(exo->eb_elem_type[ebi], "SHELL") &&
+		  ((exo->eb_id[ebi] < 100) != (exo->eb_id[nbr_ebid] < 100)) )
+	       continue;
+
+	     nbr_num_nodes = sorted_side_node_list(table[slot].elem,
+						   table[slot].face, exo,
+						   nbr_snl);
+	     match = ( nbr_num_nodes == num_nodes );
+	     for ( n=0; match && n<num_nodes; n++)
 	       {
-		 /*
-		  * The boiled list contains self and one other element.
-		  */
-
-		 if ( prev_set[0] == elem )
-		   {
-		     neighbor_name = prev_set[1];
-		   }
-		 else
-		   {
-		     neighbor_name = prev_set[0];
-		     if ( prev_set[1] != elem )
-		       {
-			 sr = sprintf(err_msg, 
-				      "2 elems ( %d %d ) 1 should be %d!",
-				      prev_set[0], prev_set[1], elem);
-			 EH(-1, err_msg);
-		       }
-		   }
+		 match = ( nbr_snl[n] == snl[n] );
 	       }
-	     else if ( len_intr == 1 &&  prev_set[0] == elem )
+	     if ( match )
 	       {
-		 /*
-		  * The boiled list has one member, this element.
-		  * 
-		  * The face must connect either to outer space or to
-		  * another processor.
-		  */
-		 if ( Num_Proc == 1 )
-		   {
-		     neighbor_name = -1;
-		   }
-		 else
-		   {
-		     neighbor_name = -1;
-
-		     /*
-		      * I am going to punt for now. Later, revisit this
-		      * condition and insert code to check for neighbor
-		      * processors containing all the same face nodes.
-		      *
-		      * EH(-1, "Not done yet..."); 
-		      *
-		      */
-
-		     /*
-		      * Check if ALL the nodes on this face belong
-		      * to another processors list of nodes. I.e., the
-		      * node must all be in the external node list of
-		      * and belong to the same external processor.
-		      */
-		   }
+		 neighbor = table[slot].elem;
+		 num_hits++;
 	       }
+	   }
 
-	     /*
-	      * Pathological cases that normally should not occur....
-	      */
+	 /*
+	  * No other element means the face connects either to outer
+	  * space or to another processor; more than one is a face shared
+	  * by three or more elements, which is left unconnected.
+	  */
 
-	     else if ( len_intr == 0 )
-	       {
-		 sr = sprintf(err_msg, "Elem %d, face %d should self contain!",
-			      elem, face);
-		 EH(-1, err_msg);
-	       }
-	     else if ( len_intr == 1 && prev_set[0] != elem )
-	       {
-		 sr = sprintf(err_msg, 
-			      "Elem %d, face %d only connects with elem %d ?",
-			      elem, face, prev_set[0]);
-		 EH(-1, err_msg);
-	       }
-	     else
+	 if ( num_hits > 1 )
+	   {
+	     neighbor = -1;
+	     num_shared++;
+#ifdef _OPENMP
+#pragma omp critical (elem_elem_shared)
+#endif
+	     if ( first_shared == -1 ||
+		  exo->elem_elem_pntr[elem] + face < first_shared )
 	       {
-		 sr = sprintf(err_msg, 
-   	         "Unknown elem-elem connection elem %d, face %d, len_intr=%d",
-			      elem, face, len_intr);
-		 WH(-1, err_msg);
+		 first_shared = exo->elem_elem_pntr[elem] + face;
 	       }
+	   }
 
-	     /*
-	      * Now we know how to assign the neighbor name for this face
-	      * of the element.
-	      */
+	 exo->elem_elem_list[exo->elem_elem_pntr[elem] + face] = neighbor;
 
-	     index = exo->elem_elem_pntr[elem] + face;
-	     exo->elem_elem_list[index] = neighbor_name;
-	     
-	   } /* end face loop this elem */
+       } /* end face loop this elem */
 
-       } /* end elem loop this elemblock */
+   } /* end elem loop */
 
-   } /* end elem block loop */
+ safe_free(table);
+
+ if ( num_shared > 0 )
+   {
+     elem = fence_post(first_shared, exo->elem_elem_pntr, exo->num_elems+1);
+     sr = sprintf(err_msg,
+		  "Unknown elem-elem connection at %d faces, first elem %d, face %d",
+		  num_shared, elem, first_shared - exo->elem_elem_pntr[elem]);
+     WH(-1, err_msg);
+   }
 
  exo->elem_elem_pntr[exo->num_elems] = count; /* last fencepost */
 
@@ -1465,72 +1370,59 @@ get_elem_dimension(char *elem_type)
 }
 #endif /* ................................. unused........................ */
 
-/* int_intersect - provide the number and the indeces of the intersections
- *                 of 2 lists
- *
- *		   Assume both lists are full of unique integers, that none
- *		   appear more than once. If so, you're responsible for what
- *		   happens.
- *
- *		   Adapted from Scott Hutchinson's find_inter.
+/*
+ * sorted_side_node_list - build_side_node_list() with the nodes in
+ *                         ascending order
  *
- * Revised: 1998/04/10 14:51 MDT pasacki@sandia.gov
+ *		   The two elements on either side of a face traverse its
+ *		   nodes in opposite directions and from different starting
+ *		   nodes, so the sorted list is what names the face.
  */
 static int
-int_intersect(int *a,		/* first integer list			(in) */
-	      int *b,		/* second integer list			(in) */
-	      const int len_a,	/* length of first integer list		(in) */
-	      const int len_b,	/* length of second integer list	(in) */
-	      int *ia,		/* indeces of intersections, first list (out)*/
-	      int *ib)		/* indeces of intersections, second list(out)*/
+sorted_side_node_list(const int elem,
+		      const int face,
+		      Exo_DB *exo,
+		      int *snl)
 {
   int i;
   int j;
-  int num_hit=0;
+  int node;
+  int num_nodes;
+
+  num_nodes = build_side_node_list(elem, face, exo, snl);
 
-  for ( i=0; i<len_a; i++)
+  for ( i=1; i<num_nodes; i++)
     {
-      for ( j=0; j<len_b; j++)
+      node = snl[i];
+      for ( j=i; j>0 && snl[j-1] > node; j--)
 	{
-	  if ( a[i] == b[j] )
-	    {
-	      ia[num_hit] = i;
-	      ib[num_hit] = j;
-	      num_hit++;
-	    }
+	  snl[j] = snl[j-1];
 	}
+      snl[j] = node;
     }
-#ifdef DEBUG
-  fprintf(stderr, "A is { ");
-  for ( i=0; i<len_a; i++)
-    {
-      fprintf(stderr, " %d", a[i]);
-    }
-  fprintf(stderr, "}\n");
-  fprintf(stderr, "B is { ");
-  for ( i=0; i<len_b; i++)
-    {
-      fprintf(stderr, " %d", b[i]);
-    }
-  fprintf(stderr, "}\n");
-  fprintf(stderr, "Number of hits = %d\n", num_hit);
 
-  fprintf(stderr, "A indeces { ");
-  for ( i=0; i<num_hit; i++)
-    {
-      fprintf(stderr, " %d", ia[i]);
-    }
-  fprintf(stderr, "}\n");
-  fprintf(stderr, "B indeces { ");
-  for ( i=0; i<num_hit; i++)
+  return(num_nodes);
+}
+
+/*
+ * side_hash - hash key of a face from its sorted corner nodes and the
+ *             number of faces of its element, which is part of the match
+ */
+static unsigned
+side_hash(const int *snl,
+	  const int num_nodes,
+	  const int num_faces)
+{
+  int i;
+  unsigned h = 2166136261u ^ (unsigned) num_faces;
+
+  for ( i=0; i<num_nodes; i++)
     {
-      fprintf(stderr, " %d", ib[i]);
+      h = (h ^ (unsigned) snl[i]) * 0x9e3779b1u;
+      h ^= h >> 15;
     }
-  fprintf(stderr, "}\n");
 
-#endif
-
-  return(num_hit);
+  return(h);
 }
 
 #if FALSE
@@ -1656,6 +1548,7 @@ brk_build_node_node(Exo_DB *exo)
   int total_list_size;
   
   int *list;
+  int *mark;
   /*
    * Don't even attempt to do this without adequate preparation.
    */
@@ -1707,6 +1600,13 @@ brk_build_node_node(Exo_DB *exo)
 
   list = (int *) smalloc(max*sizeof(int));
 
+  /*
+   * mark[dude] == node once dude is in the list of node, so that the
+   * duplicates are dropped without searching the list.
+   */
+
+  mark = alloc_int_1(exo->num_nodes, -1);
+
   /*
    * Loop through each node and build a list of all the nodes to which it
    * is connected. Flatten the list by extracting duplicate entries. Finally,
@@ -1720,13 +1620,6 @@ brk_build_node_node(Exo_DB *exo)
   for ( node=0; node<exo->num_nodes; node++)
     {
 
-      /* Clear out any old garbage... */
-
-      for ( i=0; i<max; i++)
-	{
-	  list[i] = -1;
-	}
-
       curr_list_size = 0;
 
       for ( e=exo->node_elem_pntr[node]; e<exo->node_elem_pntr[node+1]; e++)
@@ -1744,8 +1637,9 @@ brk_build_node_node(Exo_DB *exo)
 	       * suitably larger.
 	       */
 
-	      if ( -1 == in_list(dude, 0, curr_list_size, list) )
+	      if ( mark[dude] != node )
 		{
+		  mark[dude] = node;
 		  list[curr_list_size] = dude;
 		  curr_list_size++;
 		}
@@ -1788,6 +1682,7 @@ brk_build_node_node(Exo_DB *exo)
 #endif
 
   safe_free(list);
+  safe_free(mark);
 
   return;
 }
@@ -211,6 +211,10 @@ String_line AztecOO_Solver;
 
 String_line Stratimikos_File;
 
+int Krylov_Recycle = FALSE;	/* keep the Stratimikos solver between solves */
+
+int Krylov_Guess = FALSE;	/* extrapolated Newton update initial guess */
+
 /*
  * A new Aztec 2.0 option. There are more and difft options and our
  * previous options probably ought to be revised to reflect the newer
@@ -246,13 +250,52 @@ int Newt_Jacobian_Reformation_stride;/*Stride for reformation of jacobian for
 int Time_Jacobian_Reformation_stride;
 int modified_newton;            /*boolean flag for modified Newton */
 int save_old_A;                 /*boolean flag for saving old A matrix
-				 for resolve reasons with AZTEC.   There
-				 are at least four reasons, that you
-				 can see in sl_util.c */
+				 for resolve reasons with AZTEC: modified
+				 Newton and LOCA, see
+				 alloc_MSR_sparse_arrays() */
 double convergence_rate_tolerance; /* tolerance for jacobian reformation
                                        based on convergence rate */
 double modified_newt_norm_tol; /* tolerance for jacobian reformation
                                        based on residual norm */
+int Newton_Forcing;		/* NEWTON_FORCING_NONE, _EW1 or _EW2 */
+double Newton_Forcing_Max;	/* largest linear tolerance it may pick */
+int Jacobian_Reuse;		/* JACOBIAN_REUSE_FIXED, _ADAPTIVE or _CONSTANT */
+double Jacobian_Reuse_Rate;	/* reform when |R_k|/|R_k-1| reaches this */
+int Jacobian_Reuse_Max_Age;	/* reform after this many reuses regardless */
+double Jacobian_Reuse_Dt_Tol;	/* reform when dt changes by this fraction */
+double Jacobian_Reuse_Omega_Tol; /* reform when omega^2 changes by this fraction */
+int Newton_Accel;		/* NEWTON_ACCEL_NONE, _BROYDEN or _ANDERSON */
+int Newton_Accel_Depth;		/* steps of history it may use */
+int Newton_Line_Search;		/* NEWTON_LINE_SEARCH_NONE or _ARMIJO */
+double Line_Search_Alpha;	/* sufficient decrease fraction */
+int Line_Search_Max_Backtracks;	/* trial residuals per Newton step */
+int Matrix_Free_Newton;		/* difference residuals for J*v on reuse steps */
+double Matrix_Free_Delta;	/* relative size of the differencing step */
+int Precond_Matrix;		/* PRECOND_MATRIX_EXACT, _NO_MESH or _DECOUPLED */
+
+int Num_Assembly_Threads;	/* OpenMP threads used for element assembly */
+int Elem_Scatter_Map;		/* cache matrix positions per element in load_lec */
+double Selective_Reassembly_Tol; /* reuse element loads that drifted less, 0=off */
+int Selective_Reassembly_Refresh; /* Jacobian fills between full assemblies */
+int Geom_Cache_Memory;		/* MB for fixed-mesh Jacobians in beer_belly, 0=off */
+int Overlap_Exchange;		/* assemble interior elements during the x halo exchange */
+int Elem_FD_Jacobian;		/* difference element residuals for some Jacobian rows */
+int Elem_FD_Eqn[MAX_VARIABLE_TYPES]; /* TRUE for the equations it applies to */
+String_line Node_Reorder;	/* order the nodes get their unknowns in */
+int Interior_Condensation;	/* condense interior node dofs out of the element matrix */
+int Fused_Post_Processing;	/* nodal post processing fields from the last assembly */
+int Prune_Zero_Couplings;	/* assemblies before couplings that stayed zero go, 0=off */
+int Memory_Lean;		/* free setup-only mesh data once the matrix is set up */
+int Reduced_Quadrature;		/* some equations use the linear element's Gauss rule */
+int Reduced_Quad_Eqn[MAX_VARIABLE_TYPES]; /* TRUE for those equations */
+int Periodic_Native;		/* periodic ACs become links in the unknown map */
+int Mesh_Stiffness_Lag;		/* Jacobian fills an element mesh block is used for, <=1 off */
+double Mesh_Segregation_Tol;	/* segregated ALE coupling tolerance, 0 off */
+int Reduced_Order_Model;	/* ROM_NONE, ROM_COLLECT or ROM_SOLVE */
+int ROM_Max_Modes;		/* most POD modes of a basis */
+double ROM_Energy;		/* fraction of the snapshot energy they hold */
+int ROM_Max_Snapshots;		/* most solutions collected */
+int ROM_Sample_Nodes;		/* fewest nodes the reduced fills sample */
 
 double Epsilon[3];	/* Used for determining stopping criteria.     */
 
@@ -268,7 +311,7 @@ int nnz_total;			/* total number of nonzeroes in the matrix
 				 * entries for external unknowns that will
 				 * not be updated by this processor  */
 
-int GNZeros;            /* Number of nonzeros in global matrix         */
+goma_gid GNZeros;       /* Number of nonzeros in global matrix         */
 
 int fill_zeros;         /* number of nonzeros in fill matrix for this
 			  processor */
@@ -0,0 +1,226 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * Goma as a library, for design loops that solve one problem many times.
+ *
+ * goma_lib_init() runs what main() does before its solve: parallel start
+ * up, input file, mesh, decomposition and problem setup. The solves that
+ * follow go through solve_problem() with its state kept, as on the
+ * non-final calls of LIBRARY_MODE: the solution, the results description,
+ * the matrix graph and the linear solver set up on the first call are
+ * reused, and each solve starts from the solution of the one before. The
+ * parameters are changed with the routines of ac_update_parameter.c, by
+ * the same type and ids as the continuation cards.
+ *
+ * The continuation, hunting and LOCA drivers keep no state between calls;
+ * a problem that asks for one of them is run whole on each solve.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "std.h"
+#include "rf_allo.h"
+#include "rf_fem_const.h"
+#include "rf_fem.h"
+#include "rf_io_const.h"
+#include "rf_io.h"
+#include "rf_solver.h"
+#include "rf_bc_const.h"
+#include "mm_as_structs.h"
+#include "mm_as.h"
+#include "mm_eh.h"
+#include "exo_struct.h"
+#include "dpi.h"
+#include "user_continuation.h"
+
+#define _GOMA_LIB_C
+#include "goma.h"
+
+static int Lib_Active = FALSE;
+
+/*
+ * Whether solve_problem() alone solves this problem, and so may keep its
+ * state, as in main().
+ */
+
+static int
+lib_steady_or_transient(void)
+{
+  if (TimeIntegration == TRANSIENT) return (TRUE);
+  return (Continuation == ALC_NONE && loca_in->Cont_Alg != LOCA_LSA_ONLY);
+}
+
+int
+goma_lib_init(int argc,
+	      char **argv)
+
+     /*****************************************************************
+      * goma_lib_init()
+      *
+      *        read the input file and the mesh named on the command
+      *        line and set up the problem, without solving it.
+      *****************************************************************/
+{
+  if (Lib_Active) {
+    WH(-1, "goma_lib_init: goma is already initialized");
+    return (0);
+  }
+  if (goma_setup(argc, argv) < 0) return (-1);
+
+  if (TimeIntegration == TRANSIENT) Continuation = ALC_NONE;
+  solve_problem_keep_state(lib_steady_or_transient());
+  Lib_Active = TRUE;
+  return (0);
+}
+
+int
+goma_lib_set_parameter(const int type,
+		       const int id,
+		       const int tag,
+		       const int sub,
+		       const double value)
+
+     /*****************************************************************
+      * goma_lib_set_parameter()
+      *
+      *        set a parameter for the next solve, as a continuation
+      *        step of this type would.
+      *****************************************************************/
+{
+  double *x, *xdot;
+
+  switch (type) {
+  case GOMA_LIB_BC:
+    if (id < 0 || id >= Num_BC) break;
+    update_BC_parameter(value, id, tag, cx, EXO_ptr, DPI_ptr);
+    return (0);
+  case GOMA_LIB_MT:
+    if (id < 0 || id >= upd->Num_Mat) break;
+    update_MT_parameter(value, id, tag, sub, cx, EXO_ptr, DPI_ptr);
+    return (0);
+  case GOMA_LIB_AC:
+    if (id < 0 || id >= nAC) break;
+    update_AC_parameter(value, id, tag, cx, EXO_ptr, DPI_ptr);
+    return (0);
+  case GOMA_LIB_UM:
+    if (id < 0 || id >= upd->Num_Mat) break;
+    update_UM_parameter(value, id, tag, sub, cx, EXO_ptr, DPI_ptr);
+    return (0);
+  case GOMA_LIB_UF:
+    x = solve_problem_solution(&xdot);
+    update_user_parameter(value, x, xdot, NULL, cx, EXO_ptr, DPI_ptr);
+    return (0);
+  default:
+    break;
+  }
+
+  DPRINTF(stderr, "goma_lib_set_parameter: no parameter of type %d, id %d\n",
+	  type, id);
+  return (-1);
+}
+
+int
+goma_lib_get_parameter(const int type,
+		       const int id,
+		       const int tag,
+		       const int sub,
+		       double *value)
+{
+  switch (type) {
+  case GOMA_LIB_BC:
+    if (id < 0 || id >= Num_BC) break;
+    retrieve_BC_parameter(value, id, tag, cx, EXO_ptr, DPI_ptr);
+    return (0);
+  case GOMA_LIB_MT:
+    if (id < 0 || id >= upd->Num_Mat) break;
+    retrieve_MT_parameter(value, id, tag, cx, EXO_ptr, DPI_ptr);
+    return (0);
+  case GOMA_LIB_AC:
+    if (id < 0 || id >= nAC) break;
+    retrieve_AC_parameter(value, id, tag, cx, EXO_ptr, DPI_ptr);
+    return (0);
+  case GOMA_LIB_UM:
+    if (id < 0 || id >= upd->Num_Mat) break;
+    retrieve_UM_parameter(value, id, tag, sub, cx, EXO_ptr, DPI_ptr);
+    return (0);
+  default:
+    break;
+  }
+
+  DPRINTF(stderr, "goma_lib_get_parameter: no parameter of type %d, id %d\n",
+	  type, id);
+  return (-1);
+}
+
+int
+goma_lib_solve(void)
+
+     /*****************************************************************
+      * goma_lib_solve()
+      *
+      *        solve with the parameters as they are now, starting
+      *        from the last solution.
+      *****************************************************************/
+{
+  dbl te_out = 0.;
+  static const char yo[] = "goma_lib_solve";
+
+  if (!Lib_Active) EH(-1, "goma_lib_solve: call goma_lib_init first");
+
+  if (!lib_steady_or_transient()) return (goma_solve());
+
+  timer_push("solve");
+  log_msg("Solving problem");
+  solve_problem(EXO_ptr, DPI_ptr, &te_out);
+  timer_pop("solve");
+
+  return (0);
+}
+
+const double *
+goma_lib_solution(int *num_unknowns)
+
+     /*****************************************************************
+      * goma_lib_solution()
+      *
+      *        the solution of the last solve, the owned unknowns of
+      *        this processor first and then the external ones.
+      *****************************************************************/
+{
+  double *x = solve_problem_solution(NULL);
+
+  *num_unknowns = (x == NULL) ? 0 : NumUnknowns + NumExtUnknowns;
+  return (x);
+}
+
+int
+goma_lib_finalize(void)
+
+     /*****************************************************************
+      * goma_lib_finalize()
+      *
+      *        close the results, free the problem and shut down MPI.
+      *        The arrays solve_problem() kept go with the process.
+      *****************************************************************/
+{
+  if (!Lib_Active) return (0);
+
+  solve_problem_keep_state(FALSE);
+  Lib_Active = FALSE;
+  return (goma_finish());
+}
+/*****************************************************************************/
+/*  END of file goma_lib.c  */
+/*****************************************************************************/
@@ -1321,7 +1321,7 @@ void calc_rhs_continuation(int rhs_type, double *x, double *resid_vector,
 
     for (i=0; i< numUnks; i++) x_tmp[i] = x[i] + dc_p1 * ab_vec[i];
 
-    matrix_residual_fill_conwrap(x_tmp, resid_delta, RHS_MATRIX);
+    matrix_residual_fill_conwrap(x_tmp, resid_delta, MATRIX_ONLY);
 
     matvec_mult_conwrap(r_vec, resid_delta);
 
@@ -114,8 +114,18 @@ static int  eig_driver(char which[], char bmat[], int iparam[], int mode,
                        double sigma, double mu, double delta, double zeta,
                        int nev, int ncv, int info, double tol, double eta,
                        int printproc, int numOwnedUnks, int numUnks,
-                       int con_step_num, int jmax, int sort, MPI_Comm comm,
-                       double **saved_displacement);
+                       int con_step_num, int jmax, int sort, int warm_start,
+                       MPI_Comm comm, double **saved_displacement);
+
+/* What the last eigensolve leaves for the next one along the path: the
+ * sum of its converged (unit) Ritz vectors, which seeds the Arnoldi
+ * start, and the shifts poleze had moved to. */
+static double *Warm_Vec = NULL;
+static int     Warm_Len = 0;
+static int     Warm_Mode = -1;
+static double  Warm_Sigma, Warm_Mu;
+
+#define WARM_NOISE 1.0e-2  /* relative size of the random part of a warm start */
 #endif
 
 /*****************************************************************************/
@@ -234,8 +244,8 @@ void calc_eigenvalues_loca(struct con_struct *con, double **saved_displacement)
   az_fail_cnt = eig_driver(which, bmat, iparam, mode, sigma, mu, delta, zeta,
                            nev, ncv, info, tol, eta, cgi->printproc,
                            cgi->numOwnedUnks, cgi->numUnks,
-                           con->private_info.step_num, jmax, cei->sort, comm,
-                           saved_displacement);
+                           con->private_info.step_num, jmax, cei->sort,
+                           cei->Warm_Start, comm, saved_displacement);
 
   if( info != 0){
     if (cgi->printproc > 1) printf("  Error %d in eigensolver\n",info);
@@ -262,8 +272,8 @@ void calc_eigenvalues_loca(struct con_struct *con, double **saved_displacement)
 static int eig_driver(char which[], char bmat[], int iparam[], int mode,
    double sigma, double mu, double delta, double zeta, int nev, int ncv,
    int info, double tol, double eta, int printproc, int numOwnedUnks,
-   int numUnks, int con_step_num, int jmax, int sort, MPI_Comm comm,
-   double **saved_displacement)
+   int numUnks, int con_step_num, int jmax, int sort, int warm_start,
+   MPI_Comm comm, double **saved_displacement)
 
 /* matShifted is temp matrix, nnz is # nonzeros in matrix */
 {
@@ -273,7 +283,7 @@ static int eig_driver(char which[], char bmat[], int iparam[], int mode,
   int      ipntr[14];
   int      dummy1, dummy2, dummy3, dummy4;
   double   *rhs_orig;
-  double   norm_M;
+  double   norm_M, norm_x;
   char     string[4];
   int      az_fail_cnt=0;
   double   *v, *workl, *workd, *workev, *d, *resid, *vecx, *vecy, *rhs, *mxx;
@@ -283,6 +293,7 @@ static int eig_driver(char which[], char bmat[], int iparam[], int mode,
   double *trans=NULL; /* space for eigenvalues transformed to real system */
   double *workpol=NULL; /*space for eigenvales transformed in poleze*/
   double new_sigma=0.0, new_mu = 0.0, solve_tol;
+  double factored_sigma;  /* shift of the factored (J-sM) */
   int    temp_ncv=0, temp_nconv=0, info_p=0, nrows=nev;
 
    /******************************************************
@@ -351,6 +362,23 @@ static int eig_driver(char which[], char bmat[], int iparam[], int mode,
   if (printproc > 4) printf("\n\t    Eigensolver Initial Guess Generation\n");
   random_vector_conwrap(vecx, nloc);
 
+  /* Along a path the leading modes move slowly, so start from the last
+   * solve's Ritz vectors, with a little of the random vector to keep
+   * the modes they lack, and from the shifts that solve ended with. */
+  if (warm_start && Warm_Vec != NULL && Warm_Len == nloc) {
+    norm_x = sqrt(dp(vecx,vecx));
+    if (norm_x > 0.0) norm_x = WARM_NOISE / norm_x;
+    for (kk = 0 ; kk < nloc ; kk++)
+      vecx[kk] = Warm_Vec[kk] + norm_x * vecx[kk];
+    if (Warm_Mode == mode) {
+      sigma = Warm_Sigma;
+      mu    = Warm_Mu;
+    }
+    if (printproc > 4)
+      printf("\t    Warm start from the last eigensolve, sigma, mu = %g %g\n",
+             sigma, mu);
+  }
+
    /* Mx  = rhs */
   for (kk = 0 ; kk < nloc2 ; kk++)  rhs[kk] = 0.0;
   mass_matvec_mult_conwrap(vecx,rhs);
@@ -368,6 +396,7 @@ static int eig_driver(char which[], char bmat[], int iparam[], int mode,
 
   shifted_matrix_fill_conwrap(0.0);
   shifted_linear_solver_conwrap(rhs, vecx, NEW_JACOBIAN, solve_tol);
+  factored_sigma = 0.0;
 
   for (kk = 0 ; kk < nloc2 ; kk++) resid[kk] = vecx[kk];
 
@@ -448,11 +477,13 @@ static int eig_driver(char which[], char bmat[], int iparam[], int mode,
         solve_tol = eta * norm_M;
         if (printproc > 7) printf("\tLinear Solve Tol = %g\n",solve_tol);
 
-        /* After first iter, reuse preconditioner */
+        /* The factorization (or preconditioner) of J-sM is kept through
+         * the ARPACK restarts, and only redone when the shift moves */
 
-        if (count%ncv == 1) {
+        if (sigma != factored_sigma) {
           shifted_matrix_fill_conwrap(sigma);
           shifted_linear_solver_conwrap(rhs, vecx, NEW_JACOBIAN, solve_tol);
+          factored_sigma = sigma;
         }
         else {
           shifted_linear_solver_conwrap(rhs, vecx, OLD_JACOBIAN, solve_tol);
@@ -652,6 +683,27 @@ static int eig_driver(char which[], char bmat[], int iparam[], int mode,
         sort_by_real(nconv, ncv, ldv, d, v);
       }
 
+    /* Keep the converged Ritz vectors and shifts for the next solve */
+      if (warm_start && nconv > 0) {
+        if (Warm_Len != nloc) {
+          if (Warm_Vec != NULL) free_vec (&Warm_Vec);
+          Warm_Vec = (double *) malloc(nloc*sizeof(double));
+          Warm_Len = nloc;
+        }
+        for (kk = 0 ; kk < nloc ; kk++) {
+          Warm_Vec[kk] = 0.0;
+          for (j = 0; j < nconv ; j++ ) Warm_Vec[kk] += v[j*ldv+kk];
+        }
+        norm_x = sqrt(dp(Warm_Vec,Warm_Vec));
+        if (norm_x > 0.0) {
+          for (kk = 0 ; kk < nloc ; kk++) Warm_Vec[kk] /= norm_x;
+          Warm_Mode  = mode;
+          Warm_Sigma = sigma;
+          Warm_Mu    = mu;
+        }
+        else Warm_Len = 0;
+      }
+
       for (j = 0; j < nconv ; j++ ) {
 
             /*--------------------------
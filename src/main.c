@@ -151,6 +151,31 @@ int     Write_Initial_Solution = FALSE;
 				/* Flag to indicate whether to write the
 			         * initial solution to the ascii and exodus
 				 * output files */
+int     Exo_Flush_Interval = 1;	/* output steps between flushes of the
+				 * results file kept open across writes;
+				 * 0 = open/close it for every write */
+int     Async_Output_Memory = 0;	/* MB of results that may be queued for the
+				 * background output writer; 0 = write
+				 * synchronously */
+char    Catalyst_Script[MAX_FNL] = "";	/* in situ pipeline run at each
+					 * output step; "" = none */
+char    Catalyst_Implementation[MAX_FNL] = "";	/* Catalyst library to
+							 * load, "" = its default */
+char    ROM_Basis_File[MAX_FNL] = "rom_basis.dat";	/* POD basis written
+							 * or read */
+char    Mesh_Sequence_File[MAX_MESH_SEQUENCE][MAX_FNL];	/* coarse meshes
+							 * solved first */
+int     Mesh_Sequence_Length = 0;	/* how many, 0 = none */
+char    Running_Statistics[MAX_CHAR_IN_INPUT] = "";	/* nodal variables to
+							 * keep statistics of */
+int     Output_Compression_Level = 0;	/* deflate level 1-9 of a NetCDF-4
+					 * results file; 0 = classic */
+int     Output_Compression_Shuffle = FALSE;	/* byte shuffle before deflate */
+int     Output_Significant_Digits = 0;	/* decimal digits kept in results
+					 * values; 0 = all (lossless) */
+int     Num_Output_Subsets = 0;		/* results variables restricted to
+					 * a region and/or a stride */
+struct Output_Subset Output_Subsets[MAX_OUTPUT_SUBSETS];
 int     Num_Var_Init ;		/* number of variables to overwrite with
 				 * global initialization */
 int     Num_Var_LS_Init;        /* number of variables to overwirte with
@@ -248,43 +273,90 @@ double time_goma_started;	/* Save it here... */
 char **Argv;
 int Argc;
 
+/*
+ * The command line, kept from goma_setup() until goma_finish() frees it.
+ */
+
+static struct Command_line_command **clc = NULL; /* command line structure */
+static int nclc = 0;			/* number of command line commands */
+
+static void mesh_sequence_run
+(int ,				/* argc */
+ char **);			/* argv */
+
+static void
+mesh_sequence_run(int argc, char **argv)
+
+     /*
+      * Mesh Sequence: solve the problem on each of the coarser meshes in
+      * turn, coarsest first, each by a goma of its own (this command line
+      * with -ix, -ox and -noseq) that starts from the solution of the one
+      * before. This run then starts from the last of them. The solutions
+      * go onto the finer meshes through rd_vectors_from_exoII(), which
+      * interpolates a file of another mesh (rd_donor_field.c).
+      */
+{
+  char cmd[MAX_SYSTEM_COMMAND_LENGTH], out[MAX_FNL], prev[MAX_FNL];
+  int i, k, len, err;
+  static const char yo[] = "mesh_sequence_run";
+
+  if (Num_Proc > 1) {
+    EH(-1, "Mesh Sequence is only available in serial");
+  }
+  if (TimeIntegration == TRANSIENT) {
+    WH(-1, "Mesh Sequence is for steady problems, ignored");
+    return;
+  }
+
+  prev[0] = '\0';
+  for (k = 0; k < Mesh_Sequence_Length; k++) {
+    sprintf(out, "%s.seq%d", ExoFileOut, k + 1);
+    len = snprintf(cmd, sizeof(cmd), "'%s'", argv[0]);
+    for (i = 1; i < argc && len < (int) sizeof(cmd); i++) {
+      len += snprintf(cmd + len, sizeof(cmd) - len, " '%s'", argv[i]);
+    }
+    if (len < (int) sizeof(cmd)) {
+      len += snprintf(cmd + len, sizeof(cmd) - len, " -noseq -ix '%s' -ox '%s'",
+		      Mesh_Sequence_File[k], out);
+    }
+    if (len < (int) sizeof(cmd) && prev[0] != '\0') {
+      len += snprintf(cmd + len, sizeof(cmd) - len, " -gx '%s'", prev);
+    }
+    if (len >= (int) sizeof(cmd)) {
+      EH(-1, "Mesh Sequence command line too long");
+    }
+
+    log_msg("Mesh Sequence stage %d: %s", k + 1, Mesh_Sequence_File[k]);
+    fprintf(stdout, "\n%s: stage %d of %d on %s\n", yo, k + 1,
+	    Mesh_Sequence_Length, Mesh_Sequence_File[k]);
+    fflush(stdout);
+    fflush(stderr);
+    err = system(cmd);
+    if (err != 0) {
+      fprintf(stderr, "%s: stage %d failed: %s\n", yo, k + 1, cmd);
+      EH(-1, "Mesh Sequence stage failed");
+    }
+    strcpy(prev, out);
+  }
+
+  Guess_Flag = 6;
+  strcpy(ExoAuxFile, prev);
+  ExoTimePlane = INT_MAX;
+  fprintf(stdout, "\n%s: initial guess from %s\n", yo, ExoAuxFile);
+}
+
 int
-main(int argc, char **argv)
-     
+goma_setup(int argc, char **argv)
+
      /*
-      * Initial main driver for GOMA. Derived from a (1/93) release of
-      * the rf_salsa program by
-      *        
-      *        Original Authors: John  Shadid (1421)
-      *		                 Scott Hutchinson (1421)
-      *        		         Harry Moffat (1421)
-      *       
-      *        Date:		12/3/92
-      * 
-      *
-      *        Updates and Changes by:
-      *                           Randy Schunk (9111)
-      *                           P. A. Sackinger (9111)
-      *                           R. R. Rao       (9111)
-      *                           R. A. Cairncross (Univ. of Delaware)
-      *        Dates:           2/93 - 6/96
-      *
-      *       Modified for continuation
-      *                           Ian Gates
-      *       Dates:            2/98 - 10/98
-      *       Dates:            7/99 - 8/99
-      * 
-      * Last modified: Wed  June 26 14:21:35 MST 1994 prschun@sandia.gov
-      * Hello.
-      * 
-      * Note: Many modifications from an early 2/93 pre-release
-      *	      version of rf_salsa were made by various persons 
-      *       in order to test ideas about moving/deforming meshes...
-      */ 
+      * Everything before the solve: parallel start up, the input file and
+      * its broadcast, the mesh and its decomposition, the problem setup and
+      * the mesh of the results file. Returns -1 if a mesh file is missing.
+      */
 {
   /* Local Declarations */
 
-  double time_start, total_time;   /* timing variables */
+  double time_start;               /* timing variables */
 #ifndef PARALLEL
   /*  struct tm *tm_ptr;               additional serial timing variables */
   time_t now;
@@ -297,8 +369,9 @@ main(int argc, char **argv)
   char	**ptmp;
   char *yo;
 
-  struct Command_line_command **clc=NULL; /* point to command line structure */
-  int           nclc = 0;		/* number of command line commands */
+#if defined(PARALLEL) && defined(_OPENMP)
+  int mpi_thread_level = MPI_THREAD_SINGLE;
+#endif
 
 /********************** BEGIN EXECUTION ***************************************/
 
@@ -315,7 +388,12 @@ main(int argc, char **argv)
   yo = argv[0];
 
 #ifdef PARALLEL
+#ifdef _OPENMP
+  /* the master thread alone makes MPI calls, between parallel regions */
+  MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &mpi_thread_level);
+#else
   MPI_Init(&argc, &argv);
+#endif
   time_start = MPI_Wtime();
 #endif /* PARALLEL */
 #ifndef PARALLEL
@@ -495,6 +573,9 @@ main(int argc, char **argv)
       log_msg("Overriding any input file specs w/ any command line specs...");
       if (argc > 1) apply_command_line(clc, nclc);
 
+      /* the coarse solves of a Mesh Sequence come before this mesh */
+      if (Mesh_Sequence_Length > 0) mesh_sequence_run(argc, argv);
+
 #ifdef DEBUG
       DPRINTF(stderr, "apply_command_line() is done.\n");
 #endif
@@ -538,7 +619,7 @@ main(int argc, char **argv)
   error = MPI_Barrier(MPI_COMM_WORLD);
 #endif
 
-  MPI_Bcast(MPI_BOTTOM, 1, Noahs_Raven->new_type, 0, MPI_COMM_WORLD);
+  ddd_bcast(Noahs_Raven, 0);
 
 #ifdef DEBUG
   fprintf(stderr, "P_%d at barrier after Bcast/before raven_landing()\n", 
@@ -563,7 +644,7 @@ main(int argc, char **argv)
    */
 
   noahs_ark();
-  MPI_Bcast(MPI_BOTTOM, 1, Noahs_Ark->new_type, 0, MPI_COMM_WORLD);
+  ddd_bcast(Noahs_Ark, 0);
 
   /*
    * Chemkin was initialized on processor zero during the input file
@@ -584,11 +665,26 @@ main(int argc, char **argv)
   ark_landing();
 
   noahs_dove();
-  MPI_Bcast(MPI_BOTTOM, 1, Noahs_Dove->new_type, 0, MPI_COMM_WORLD);
+  ddd_bcast(Noahs_Dove, 0);
 
 
 #endif          /* End of ifdef PARALLEL */
 
+#ifdef PARALLEL
+#ifdef _OPENMP
+  assembly_threads_setup(mpi_thread_level >= MPI_THREAD_FUNNELED);
+#else
+  assembly_threads_setup(FALSE);
+#endif
+#else
+  assembly_threads_setup(TRUE);
+#endif
+
+  /*
+   * Charge allocations to their sites from here on, if a Memory Report
+   * File was named.
+   */
+  alloc_track_begin();
 
   /*
    * We sent the packed line to all processors that contained geometry
@@ -604,7 +700,7 @@ main(int argc, char **argv)
   check_parallel_error("Error encountered in check for brkfile");
 
   /* Now break the exodus files */
-  if (Num_Proc > 1 && ProcID == 0 && Brk_Flag == 1) {
+  if (Num_Proc > 1 && Brk_Flag == 1) {
     call_brk();
   }
   check_parallel_error("Error in brking exodus files");
@@ -652,15 +748,14 @@ main(int argc, char **argv)
   }
 
   /*
-   * All of the MPI_Type_commit() calls called behind the scenes that build
-   * the dove, ark and raven really allocated memory. Let's free it up now that
+   * The dove, ark and raven member lists are not needed again now that
    * the initial information has been communicated.
    */
 
 #ifdef PARALLEL
-  MPI_Type_free(&(Noahs_Raven->new_type));
-  MPI_Type_free(&(Noahs_Ark->new_type));
-  MPI_Type_free(&(Noahs_Dove->new_type));
+  ddd_free(Noahs_Raven);
+  ddd_free(Noahs_Ark);
+  ddd_free(Noahs_Dove);
 #endif   
 
   /*
@@ -731,6 +826,11 @@ main(int argc, char **argv)
           multiname(ExoAuxFile, ProcID, Num_Proc);
         }
 
+      if ( Reduced_Order_Model != ROM_NONE )
+	{
+	  multiname(ROM_Basis_File, ProcID, Num_Proc);
+	}
+
       if( efv->Num_external_field != 0 )
         {
           for( i=0; i<efv->Num_external_field; i++ )
@@ -876,6 +976,20 @@ main(int argc, char **argv)
     }
   }
 
+  return (0);
+} /* END of goma_setup() */
+
+int
+goma_solve(void)
+
+     /*
+      * Solve the problem goma_setup() read, with the driver that the
+      * continuation and time integration cards ask for.
+      */
+{
+  int error = 0;
+  char *yo = Argv[0];
+
   /***********************************************************************/
   /***********************************************************************/
   /***********************************************************************/
@@ -891,6 +1005,9 @@ main(int argc, char **argv)
     case  ALC_FIRST:
         P0PRINTF("%s: continue_problem (first order) ...\n", yo);
         break;
+    case  ALC_SECOND:
+        P0PRINTF("%s: continue_problem (second order) ...\n", yo);
+        break;
     case HUN_ZEROTH:
         P0PRINTF("%s: hunt_problem (zeroth order) ...\n", yo);
         break;
@@ -913,6 +1030,9 @@ main(int argc, char **argv)
   case  ALC_FIRST:
       DPRINTF(stderr, "%s: continue_problem (first order) ...\n", yo);
       break;
+  case  ALC_SECOND:
+      DPRINTF(stderr, "%s: continue_problem (second order) ...\n", yo);
+      break;
   case HUN_ZEROTH:
       DPRINTF(stderr, "%s: hunt_problem (zeroth order) ...\n", yo);
       break;
@@ -928,7 +1048,10 @@ main(int argc, char **argv)
   }
 #endif
 
-    
+
+  trace_open();
+  timer_push("solve");
+
   if( TimeIntegration == TRANSIENT)
         {
         Continuation = ALC_NONE;
@@ -944,6 +1067,7 @@ main(int argc, char **argv)
   switch (Continuation) {
   case ALC_ZEROTH:
   case ALC_FIRST:
+  case ALC_SECOND:
     log_msg("Solving continuation problem");
     continue_problem(cx, EXO_ptr, DPI_ptr);
     break;
@@ -968,7 +1092,33 @@ main(int argc, char **argv)
       }
     break;
   }
+  timer_pop("solve");
+
+  return (error);
+} /* END of goma_solve() */
+
+int
+goma_finish(void)
+
+     /*
+      * Close the results, report, free what goma_setup() built and shut
+      * down MPI.
+      */
+{
+  double total_time;
+#ifndef PARALLEL
+  time_t now;
+#endif
+  int i;
+  static const char yo[] = "goma_finish";
+
+
+  /* Every piece must be complete on disk before it is fixed */
+  wr_exo_session_close();
 
+  /* The POD basis of the snapshots of Reduced Order Model = collect */
+  rom_finish();
+  linear_fallback_report();
 #ifdef PARALLEL
    MPI_Barrier(MPI_COMM_WORLD);
 #endif
@@ -977,6 +1127,21 @@ main(int argc, char **argv)
     fix_output();
   }
   
+  /*
+   * Report the assembly load imbalance, and save the measured element
+   * costs for the next decomposition if an Element Cost File was named
+   */
+  elem_cost_report(EXO_ptr, DPI_ptr);
+
+  /*
+   * Region timer and communication reports, if their files were named
+   */
+  timer_report(-1);
+  trace_close();
+  comm_report();
+  perf_log_close();
+  alloc_report("end of run");
+
   /***********************************************************************/
   /***********************************************************************/
   /***********************************************************************/
@@ -1009,9 +1174,9 @@ main(int argc, char **argv)
    */
   if ( ProcID == 0 )
     {
-      if ( argc > 1 ) 
+      if ( Argc > 1 ) 
 	{
-	  for (i=0; i<argc; i++)
+	  for (i=0; i<Argc; i++)
 	    {
 #ifdef DEBUG
 	      fprintf(stderr, "clc[%d]->string &= 0x%x\n", i, clc[i]->string);
@@ -1021,9 +1186,17 @@ main(int argc, char **argv)
 	      safer_free((void **) (clc + i));
 	    }
 	  safer_free((void **) &clc);
+	  nclc = 0;
 	}
     }
 
+  /*
+   * Write out anything still queued, close the results file and shut
+   * down the in situ pipeline
+   */
+  wr_exo_output_finish();
+  insitu_finalize();
+
   /*
    * Free exodus database structures
    */
@@ -1041,6 +1214,8 @@ main(int argc, char **argv)
 
   safer_free((void **) &DPI_ptr);
 
+  exchange_free();
+
   /*
    * Remove front scratch file [/tmp/lu.'pid'.0]
    */
@@ -1052,20 +1227,63 @@ main(int argc, char **argv)
 
 
 #ifdef PARALLEL
-  total_time = ( MPI_Wtime() - time_start )/ 60. ;
+  total_time = ( MPI_Wtime() - time_goma_started )/ 60. ;
   DPRINTF(stderr, "\nProc 0 runtime: %10.2f Minutes.\n\n",total_time);
   MPI_Finalize();
 #endif  
 #ifndef PARALLEL
   (void)time(&now);
-  total_time = (double)(now) - time_start;
+  total_time = (double)(now) - time_goma_started;
   fprintf(stderr, "\nProc 0 runtime: %10.2f Minutes.\n\n",total_time/60);
 #endif  
   fflush(stdout);
   fflush(stderr);
   log_msg("GOMA ends normally.");
   return (0);
+} /* END of goma_finish() */
+
+#ifndef GOMA_LIBRARY
+int
+main(int argc, char **argv)
+     
+     /*
+      * Initial main driver for GOMA. Derived from a (1/93) release of
+      * the rf_salsa program by
+      *        
+      *        Original Authors: John  Shadid (1421)
+      *		                 Scott Hutchinson (1421)
+      *        		         Harry Moffat (1421)
+      *       
+      *        Date:		12/3/92
+      * 
+      *
+      *        Updates and Changes by:
+      *                           Randy Schunk (9111)
+      *                           P. A. Sackinger (9111)
+      *                           R. R. Rao       (9111)
+      *                           R. A. Cairncross (Univ. of Delaware)
+      *        Dates:           2/93 - 6/96
+      *
+      *       Modified for continuation
+      *                           Ian Gates
+      *       Dates:            2/98 - 10/98
+      *       Dates:            7/99 - 8/99
+      * 
+      * Last modified: Wed  June 26 14:21:35 MST 1994 prschun@sandia.gov
+      * Hello.
+      * 
+      * Note: Many modifications from an early 2/93 pre-release
+      *	      version of rf_salsa were made by various persons 
+      *       in order to test ideas about moving/deforming meshes...
+      */ 
+{
+  if (goma_setup(argc, argv) < 0) return (-1);
+
+  (void) goma_solve();
+
+  return (goma_finish());
 }
+#endif /* not GOMA_LIBRARY */
 /***********************************************************************/
 /***********************************************************************/
 /***********************************************************************/
@@ -18,6 +18,7 @@
 #include <stdio.h>
 #include <string.h>
 #include <stdlib.h>
+#include <strings.h>
 #include <unistd.h>
 
 #ifndef tflop
@@ -67,10 +68,74 @@
 #include <sys/times.h>
 #endif
 
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
 #define _MD_TIMER_C
 #include "std.h"
+#include "rf_io_const.h"
+#include "rf_mp.h"
+#include "rf_allo.h"
+#include "mm_eh.h"
 #include "goma.h"
 
+char Perf_Report_File[MAX_FNL] = "";
+int  Perf_Report_Interval = 0;
+char Perf_Log_File[MAX_FNL] = "";
+char Trace_File[MAX_FNL] = "";
+int  Trace_Depth = 2;
+
+/*
+ * Region timers.
+ *
+ * timer_push("name") and timer_pop("name") bracket a region of the code.
+ * A region is keyed by its name and the region it is nested in, so the
+ * same name under two parents is two regions; each keeps its call count
+ * and its inclusive wall and CPU seconds. The regions meant are coarse
+ * (an assembly, a linear solve, a halo exchange, one element's boundary
+ * conditions), so a push or pop is a short search of the parent's
+ * children and two clock reads. Nothing is recorded from inside an
+ * OpenMP parallel region.
+ *
+ * timer_report() writes the regions, with the min, average and max over
+ * the processors that entered them, to the Performance Report File.
+ */
+
+#define TIMER_MAX_REGIONS 256
+#define TIMER_MAX_DEPTH    32
+#define TIMER_NAME_LEN     40
+#define TIMER_PATH_LEN    256
+
+struct timer_region
+{
+  char name[TIMER_NAME_LEN];
+  int  parent;			/* -1 at the top */
+  int  first_child;
+  int  last_child;
+  int  next_sibling;
+  dbl  calls;
+  dbl  wall;			/* inclusive seconds */
+  dbl  cpu;
+  dbl  wall_start;		/* of the open call */
+  dbl  cpu_start;
+};
+
+static struct timer_region Region[TIMER_MAX_REGIONS];
+static int Num_Regions = 0;
+static int Top_First = -1;	/* first region at the top */
+static int Top_Last = -1;
+static int Region_Stack[TIMER_MAX_DEPTH];
+static int Region_Depth = 0;
+static int Region_Lost = 0;	/* open pushes that were not recorded */
+static int Region_Warned = FALSE;
+static int Csv_Reports = 0;	/* reports appended to a *.csv file */
+
+static void trace_event(const int, const int, const dbl);
+
 /*
  * ut -- return user time in seconds (double).
  */
@@ -126,6 +191,845 @@ ust(void)
 } /* END of routine ust */
 /*****************************************************************************/
 
+/*
+ * wall_time -- return elapsed seconds since an arbitrary origin (double).
+ */
+dbl
+wall_time(void)
+{
+#ifdef PARALLEL
+  return MPI_Wtime();
+#else
+  struct timeval tv;
+  gettimeofday(&tv, NULL);
+  return ((dbl) tv.tv_sec + 1.e-6 * (dbl) tv.tv_usec);
+#endif
+} /* END of routine wall_time */
+/*****************************************************************************/
+
+/*
+ * cpu_time -- return user and system time of the process in seconds, to
+ * the resolution of getrusage() rather than of the clock tick of ust().
+ */
+dbl
+cpu_time(void)
+{
+  struct rusage ru;
+
+  if (getrusage(RUSAGE_SELF, &ru) != 0) return ust();
+  return ((dbl) (ru.ru_utime.tv_sec + ru.ru_stime.tv_sec) +
+	  1.e-6 * (dbl) (ru.ru_utime.tv_usec + ru.ru_stime.tv_usec));
+} /* END of routine cpu_time */
+/*****************************************************************************/
+
+void
+timer_push(const char *name)
+
+    /*************************************************************************
+     *
+     * timer_push():
+     *
+     *  Open the region name inside the innermost open region.
+     *************************************************************************/
+{
+  int parent, r;
+
+#ifdef _OPENMP
+  if (omp_in_parallel()) return;
+#endif
+
+  if (Region_Lost > 0 || Region_Depth == TIMER_MAX_DEPTH) {
+    Region_Lost++;
+    return;
+  }
+
+  parent = (Region_Depth > 0) ? Region_Stack[Region_Depth-1] : -1;
+  r = (parent < 0) ? Top_First : Region[parent].first_child;
+  while (r != -1 && strcmp(Region[r].name, name) != 0) {
+    r = Region[r].next_sibling;
+  }
+
+  if (r == -1) {
+    if (Num_Regions == TIMER_MAX_REGIONS) {
+      Region_Lost++;
+      return;
+    }
+    r = Num_Regions++;
+    memset(&Region[r], 0, sizeof(struct timer_region));
+    strncpy(Region[r].name, name, TIMER_NAME_LEN - 1);
+    Region[r].parent = parent;
+    Region[r].first_child = Region[r].last_child = -1;
+    Region[r].next_sibling = -1;
+    if (parent < 0) {
+      if (Top_Last >= 0) Region[Top_Last].next_sibling = r;
+      else Top_First = r;
+      Top_Last = r;
+    } else {
+      if (Region[parent].last_child >= 0) {
+	Region[Region[parent].last_child].next_sibling = r;
+      } else {
+	Region[parent].first_child = r;
+      }
+      Region[parent].last_child = r;
+    }
+  }
+
+  Region_Stack[Region_Depth++] = r;
+  Region[r].calls += 1.;
+  Region[r].wall_start = wall_time();
+  Region[r].cpu_start  = cpu_time();
+  if (Region_Depth <= Trace_Depth) trace_event(r, 'B', Region[r].wall_start);
+}
+/*****************************************************************************/
+
+void
+timer_pop(const char *name)
+
+    /*************************************************************************
+     *
+     * timer_pop():
+     *
+     *  Close the innermost open region called name, and any open inside
+     *  it (left open by an early return on an error path).
+     *************************************************************************/
+{
+  int k, r;
+  dbl wall, cpu;
+
+#ifdef _OPENMP
+  if (omp_in_parallel()) return;
+#endif
+
+  if (Region_Lost > 0) {
+    Region_Lost--;
+    return;
+  }
+
+  for (k = Region_Depth - 1; k >= 0; k--) {
+    if (strcmp(Region[Region_Stack[k]].name, name) == 0) break;
+  }
+  if (k < 0) {
+    if (!Region_Warned) {
+      WH(-1, "timer_pop: region was not open, ignored");
+      Region_Warned = TRUE;
+    }
+    return;
+  }
+
+  wall = wall_time();
+  cpu  = cpu_time();
+  while (Region_Depth > k) {
+    if (Region_Depth <= Trace_Depth) {
+      trace_event(Region_Stack[Region_Depth-1], 'E', wall);
+    }
+    r = Region_Stack[--Region_Depth];
+    Region[r].wall += wall - Region[r].wall_start;
+    Region[r].cpu  += cpu - Region[r].cpu_start;
+  }
+}
+/*****************************************************************************/
+
+/*
+ * Path of region r, its names from the top joined by '/'.
+ */
+
+static void
+timer_path(const int r, char *path)
+{
+  char tail[TIMER_PATH_LEN];
+
+  if (Region[r].parent < 0) {
+    strncpy(path, Region[r].name, TIMER_PATH_LEN - 1);
+  } else {
+    timer_path(Region[r].parent, path);
+    strncpy(tail, path, TIMER_PATH_LEN - 1);
+    tail[TIMER_PATH_LEN - 1] = '\0';
+    snprintf(path, TIMER_PATH_LEN, "%s/%s", tail, Region[r].name);
+  }
+  path[TIMER_PATH_LEN - 1] = '\0';
+}
+
+/*
+ * Regions in depth first order from r and its later siblings.
+ */
+
+static int
+timer_order(int r, int *order, int n)
+{
+  for ( ; r != -1; r = Region[r].next_sibling) {
+    order[n++] = r;
+    n = timer_order(Region[r].first_child, order, n);
+  }
+  return n;
+}
+
+static int
+timer_depth(const char *path)
+{
+  int d = 0;
+
+  for ( ; *path != '\0'; path++) if (*path == '/') d++;
+  return d;
+}
+
+void
+timer_report(const int step)
+
+    /*************************************************************************
+     *
+     * timer_report():
+     *
+     *  Write every region, as the processors saw it so far, to the
+     *  Performance Report File; step is the time step, -1 at the end of
+     *  the run. A file named *.csv gets a row per region appended for
+     *  each report; any other name is rewritten as JSON. Regions still
+     *  open are charged up to now. Must be called by every processor.
+     *************************************************************************/
+{
+  int i, k, n, p, r, num, nmerged, order[TIMER_MAX_REGIONS];
+  int is_csv, len;
+  char *paths, *mpath;
+  dbl *vals, *all_vals, wall, cpu;
+  char *all_paths;
+  int *counts;
+  int  *m_ranks, *m_max_rank;
+  dbl  *m_calls, *m_wall, *m_cpu;	/* [3*m]: min, sum, max */
+  FILE *fp;
+
+  if (Perf_Report_File[0] == '\0') return;
+
+#ifdef _OPENMP
+  if (omp_in_parallel()) return;
+#endif
+
+  /*
+   * This processor's regions: path, calls, wall and CPU seconds.
+   */
+  num = timer_order(Top_First, order, 0);
+  paths = (char *) smalloc(MAX(num, 1) * TIMER_PATH_LEN * sizeof(char));
+  vals  = (dbl *) smalloc(MAX(num, 1) * 3 * sizeof(dbl));
+  memset(paths, 0, MAX(num, 1) * TIMER_PATH_LEN * sizeof(char));
+  wall = wall_time();
+  cpu  = cpu_time();
+  for (i = 0; i < num; i++) {
+    r = order[i];
+    timer_path(r, paths + i * TIMER_PATH_LEN);
+    vals[3*i]   = Region[r].calls;
+    vals[3*i+1] = Region[r].wall;
+    vals[3*i+2] = Region[r].cpu;
+    for (k = 0; k < Region_Depth; k++) {
+      if (Region_Stack[k] == r) {
+	vals[3*i+1] += wall - Region[r].wall_start;
+	vals[3*i+2] += cpu - Region[r].cpu_start;
+      }
+    }
+  }
+
+  /*
+   * All of them on processor 0.
+   */
+  all_paths = paths;
+  all_vals  = vals;
+  counts = (int *) smalloc(Num_Proc * sizeof(int));
+  counts[0] = num;
+#ifdef PARALLEL
+  if (Num_Proc > 1) {
+    int *pc = NULL, *pd = NULL, *vc = NULL, *vd = NULL, total = 0;
+
+    MPI_Gather(&num, 1, MPI_INT, counts, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (ProcID == 0) {
+      pc = (int *) smalloc(4 * Num_Proc * sizeof(int));
+      pd = pc + Num_Proc;
+      vc = pd + Num_Proc;
+      vd = vc + Num_Proc;
+      for (p = 0; p < Num_Proc; p++) {
+	pc[p] = counts[p] * TIMER_PATH_LEN;
+	pd[p] = total * TIMER_PATH_LEN;
+	vc[p] = counts[p] * 3;
+	vd[p] = total * 3;
+	total += counts[p];
+      }
+      all_paths = (char *) smalloc(MAX(total, 1) * TIMER_PATH_LEN * sizeof(char));
+      all_vals  = (dbl *) smalloc(MAX(total, 1) * 3 * sizeof(dbl));
+    }
+    MPI_Gatherv(paths, num * TIMER_PATH_LEN, MPI_CHAR, all_paths, pc, pd,
+		MPI_CHAR, 0, MPI_COMM_WORLD);
+    MPI_Gatherv(vals, num * 3, MPI_DOUBLE, all_vals, vc, vd, MPI_DOUBLE,
+		0, MPI_COMM_WORLD);
+    if (ProcID == 0) safer_free((void **) &pc);
+  }
+#endif
+
+  if (ProcID != 0) {
+    safer_free((void **) &paths);
+    safer_free((void **) &vals);
+    safer_free((void **) &counts);
+    return;
+  }
+
+  /*
+   * Merge by path, in the order processor 0 has them (then the order
+   * the others add).
+   */
+  n = 0;
+  for (p = 0; p < Num_Proc; p++) n += counts[p];
+  mpath      = (char *) smalloc(MAX(n, 1) * TIMER_PATH_LEN * sizeof(char));
+  m_ranks    = (int *) smalloc(MAX(n, 1) * 2 * sizeof(int));
+  m_max_rank = m_ranks + MAX(n, 1);
+  m_calls    = (dbl *) smalloc(MAX(n, 1) * 9 * sizeof(dbl));
+  m_wall     = m_calls + 3 * MAX(n, 1);
+  m_cpu      = m_wall + 3 * MAX(n, 1);
+  nmerged = 0;
+  i = 0;
+  for (p = 0; p < Num_Proc; p++) {
+    for (k = 0; k < counts[p]; k++, i++) {
+      char *path = all_paths + i * TIMER_PATH_LEN;
+      dbl *v = all_vals + 3 * i;
+      for (r = 0; r < nmerged; r++) {
+	if (strcmp(mpath + r * TIMER_PATH_LEN, path) == 0) break;
+      }
+      if (r == nmerged) {
+	strcpy(mpath + r * TIMER_PATH_LEN, path);
+	m_ranks[r] = 0;
+	m_max_rank[r] = p;
+	m_calls[3*r] = m_calls[3*r+2] = v[0];
+	m_wall[3*r]  = m_wall[3*r+2]  = v[1];
+	m_cpu[3*r]   = m_cpu[3*r+2]   = v[2];
+	m_calls[3*r+1] = m_wall[3*r+1] = m_cpu[3*r+1] = 0.;
+	nmerged++;
+      }
+      m_ranks[r]++;
+      m_calls[3*r]   = MIN(m_calls[3*r], v[0]);
+      m_calls[3*r+1] += v[0];
+      m_calls[3*r+2] = MAX(m_calls[3*r+2], v[0]);
+      m_wall[3*r]    = MIN(m_wall[3*r], v[1]);
+      m_wall[3*r+1]  += v[1];
+      if (v[1] > m_wall[3*r+2]) m_max_rank[r] = p;
+      m_wall[3*r+2]  = MAX(m_wall[3*r+2], v[1]);
+      m_cpu[3*r]     = MIN(m_cpu[3*r], v[2]);
+      m_cpu[3*r+1]   += v[2];
+      m_cpu[3*r+2]   = MAX(m_cpu[3*r+2], v[2]);
+    }
+  }
+
+  len = strlen(Perf_Report_File);
+  is_csv = (len > 4 && strcasecmp(Perf_Report_File + len - 4, ".csv") == 0);
+
+  fp = fopen(Perf_Report_File, (is_csv && Csv_Reports > 0) ? "a" : "w");
+  if (fp == NULL) {
+    WH(-1, "Could not open the Performance Report File for writing");
+  } else if (is_csv) {
+    if (Csv_Reports++ == 0) {
+      fprintf(fp, "step,region,depth,ranks,calls_avg,"
+	      "wall_min,wall_avg,wall_max,wall_max_rank,"
+	      "cpu_min,cpu_avg,cpu_max\n");
+    }
+    for (r = 0; r < nmerged; r++) {
+      char *path = mpath + r * TIMER_PATH_LEN;
+      if (step < 0) fprintf(fp, "end,");
+      else fprintf(fp, "%d,", step);
+      fprintf(fp, "%s,%d,%d,%.6g,%.6e,%.6e,%.6e,%d,%.6e,%.6e,%.6e\n",
+	      path, timer_depth(path), m_ranks[r],
+	      m_calls[3*r+1] / m_ranks[r],
+	      m_wall[3*r], m_wall[3*r+1] / m_ranks[r], m_wall[3*r+2],
+	      m_max_rank[r],
+	      m_cpu[3*r], m_cpu[3*r+1] / m_ranks[r], m_cpu[3*r+2]);
+    }
+    fclose(fp);
+  } else {
+    fprintf(fp, "{\n  \"program\": \"goma\",\n");
+    if (step < 0) fprintf(fp, "  \"step\": null,\n");
+    else fprintf(fp, "  \"step\": %d,\n", step);
+    fprintf(fp, "  \"ranks\": %d,\n  \"regions\": [", Num_Proc);
+    for (r = 0; r < nmerged; r++) {
+      char *path = mpath + r * TIMER_PATH_LEN;
+      fprintf(fp, "%s\n    {\"path\": \"%s\", \"depth\": %d, \"ranks\": %d,"
+	      " \"calls\": %.6g,\n", (r > 0) ? "," : "", path,
+	      timer_depth(path), m_ranks[r], m_calls[3*r+1] / m_ranks[r]);
+      fprintf(fp, "     \"wall\": {\"min\": %.6e, \"avg\": %.6e, \"max\": %.6e,"
+	      " \"max_rank\": %d},\n", m_wall[3*r], m_wall[3*r+1] / m_ranks[r],
+	      m_wall[3*r+2], m_max_rank[r]);
+      fprintf(fp, "     \"cpu\": {\"min\": %.6e, \"avg\": %.6e, \"max\": %.6e}}",
+	      m_cpu[3*r], m_cpu[3*r+1] / m_ranks[r], m_cpu[3*r+2]);
+    }
+    fprintf(fp, "\n  ]\n}\n");
+    fclose(fp);
+  }
+
+  if (all_paths != paths) safer_free((void **) &all_paths);
+  if (all_vals != vals) safer_free((void **) &all_vals);
+  safer_free((void **) &paths);
+  safer_free((void **) &vals);
+  safer_free((void **) &counts);
+  safer_free((void **) &mpath);
+  safer_free((void **) &m_ranks);
+  safer_free((void **) &m_calls);
+}
+/*****************************************************************************/
+
+void
+timer_report_step(const int step)
+{
+  if (Perf_Report_Interval > 0 && step > 0 &&
+      step % Perf_Report_Interval == 0) {
+    timer_report(step);
+  }
+}
+/*****************************************************************************/
+
+/*
+ * Event trace.
+ *
+ * With a Trace File named, every push and pop of a region no deeper than
+ * Trace_Depth is also an event, its region and the wall clock seconds
+ * since trace_open(), kept in a buffer of TRACE_BUF events that is
+ * written out to the processor's own binary file, <Trace File>.<rank>.trc,
+ * whenever it fills. trace_close() ends each file with the region names,
+ * and processor 0 then reads them all into one Chrome trace (JSON, one
+ * pid per processor, for chrome://tracing or Perfetto) named Trace File,
+ * removing the binary files. The clocks are lined up by a barrier in
+ * trace_open() only, so ranks drift apart in long runs by as much as
+ * their clocks do.
+ */
+
+#define TRACE_BUF 8192
+
+struct trace_rec
+{
+  dbl t;			/* seconds since trace_open() */
+  int region;
+  int phase;			/* 'B' or 'E' */
+};
+
+static struct trace_rec *Trace_Buf = NULL;
+static int   Trace_Num = 0;		/* events in the buffer */
+static int   Trace_Total = 0;		/* events written out */
+static dbl   Trace_T0 = 0.;
+static FILE *Trace_Fp = NULL;
+
+static void
+trace_bin_name(const int rank, char *name)
+{
+  snprintf(name, MAX_FNL, "%s.%d.trc", Trace_File, rank);
+  name[MAX_FNL - 1] = '\0';
+}
+
+static void
+trace_flush(void)
+{
+  if (Trace_Num > 0 &&
+      fwrite(Trace_Buf, sizeof(struct trace_rec), Trace_Num, Trace_Fp) !=
+      (size_t) Trace_Num) {
+    WH(-1, "Could not write the trace buffer, tracing stopped");
+    fclose(Trace_Fp);
+    Trace_Fp = NULL;
+    Trace_Num = 0;
+    return;
+  }
+  Trace_Total += Trace_Num;
+  Trace_Num = 0;
+}
+
+static void
+trace_event(const int region,
+	    const int phase,
+	    const dbl t)
+{
+  struct trace_rec *e;
+
+  if (Trace_Fp == NULL) return;
+  if (Trace_Num == TRACE_BUF) trace_flush();
+  if (Trace_Fp == NULL) return;
+  e = Trace_Buf + Trace_Num++;
+  e->t = t - Trace_T0;
+  e->region = region;
+  e->phase = phase;
+}
+
+void
+trace_open(void)
+
+    /*************************************************************************
+     *
+     * trace_open():
+     *
+     *  Start recording events, if a Trace File was named. Must be called
+     *  by every processor.
+     *************************************************************************/
+{
+  char name[MAX_FNL];
+
+  if (Trace_File[0] == '\0') return;
+
+  trace_bin_name(ProcID, name);
+  Trace_Fp = fopen(name, "wb");
+  if (Trace_Fp == NULL) {
+    WH(-1, "Could not open this processor's trace file, not traced");
+  } else {
+    Trace_Buf = (struct trace_rec *)
+      smalloc(TRACE_BUF * sizeof(struct trace_rec));
+  }
+#ifdef PARALLEL
+  MPI_Barrier(MPI_COMM_WORLD);
+#endif
+  Trace_T0 = wall_time();
+}
+
+/*
+ * Write processor p's events, from its binary file, to the Chrome trace.
+ */
+
+static int
+trace_convert(const int p,
+	      FILE *out,
+	      int first)
+{
+  int i, k, n, ntot, nnames, hdr[2];
+  char name[MAX_FNL], *names = NULL;
+  struct trace_rec *buf;
+  FILE *fp;
+
+  trace_bin_name(p, name);
+  fp = fopen(name, "rb");
+  if (fp == NULL) return first;
+
+  if (fseek(fp, -(long) sizeof(hdr), SEEK_END) != 0 ||
+      fread(hdr, sizeof(int), 2, fp) != 2 || hdr[0] < 0 || hdr[1] < 0 ||
+      fseek(fp, (long) hdr[1] * (long) sizeof(struct trace_rec), SEEK_SET) != 0) {
+    WH(-1, "A processor's trace file is incomplete, left out");
+    fclose(fp);
+    return first;
+  }
+  nnames = hdr[0];
+  ntot = hdr[1];
+  names = (char *) smalloc(MAX(nnames, 1) * TIMER_NAME_LEN * sizeof(char));
+  if (fread(names, TIMER_NAME_LEN, nnames, fp) != (size_t) nnames) {
+    WH(-1, "A processor's trace file is incomplete, left out");
+    safer_free((void **) &names);
+    fclose(fp);
+    return first;
+  }
+
+  fprintf(out, "%s\n{\"name\": \"process_name\", \"ph\": \"M\", \"pid\": %d,"
+	  " \"args\": {\"name\": \"rank %d\"}}", first ? "" : ",", p, p);
+  first = FALSE;
+
+  buf = (struct trace_rec *) smalloc(TRACE_BUF * sizeof(struct trace_rec));
+  rewind(fp);
+  for (i = 0; i < ntot; i += n) {
+    n = (int) fread(buf, sizeof(struct trace_rec), MIN(TRACE_BUF, ntot - i), fp);
+    if (n <= 0) break;
+    for (k = 0; k < n; k++) {
+      if (buf[k].region < 0 || buf[k].region >= nnames) continue;
+      fprintf(out, ",\n{\"name\": \"%s\", \"ph\": \"%c\", \"ts\": %.3f,"
+	      " \"pid\": %d, \"tid\": 0}",
+	      names + buf[k].region * TIMER_NAME_LEN, buf[k].phase,
+	      1.e6 * buf[k].t, p);
+    }
+  }
+
+  safer_free((void **) &buf);
+  safer_free((void **) &names);
+  fclose(fp);
+  remove(name);
+  return first;
+}
+
+void
+trace_close(void)
+
+    /*************************************************************************
+     *
+     * trace_close():
+     *
+     *  Close the regions still open in the trace, finish this processor's
+     *  binary file and, on processor 0, convert them all to the Chrome
+     *  trace. Must be called by every processor.
+     *************************************************************************/
+{
+  int k, p, first, hdr[2];
+  dbl wall;
+  FILE *out;
+
+  if (Trace_File[0] == '\0') return;
+
+  if (Trace_Fp != NULL) {
+    wall = wall_time();
+    for (k = MIN(Region_Depth, Trace_Depth) - 1; k >= 0; k--) {
+      trace_event(Region_Stack[k], 'E', wall);
+    }
+    trace_flush();
+  }
+  if (Trace_Fp != NULL) {
+    for (k = 0; k < Num_Regions; k++) {
+      fwrite(Region[k].name, TIMER_NAME_LEN, 1, Trace_Fp);
+    }
+    hdr[0] = Num_Regions;
+    hdr[1] = Trace_Total;
+    fwrite(hdr, sizeof(int), 2, Trace_Fp);
+    fclose(Trace_Fp);
+    Trace_Fp = NULL;
+  }
+  safer_free((void **) &Trace_Buf);
+
+#ifdef PARALLEL
+  MPI_Barrier(MPI_COMM_WORLD);
+#endif
+  if (ProcID != 0) return;
+
+  out = fopen(Trace_File, "w");
+  if (out == NULL) {
+    WH(-1, "Could not open the Trace File for writing");
+    return;
+  }
+  fprintf(out, "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [");
+  first = TRUE;
+  for (p = 0; p < Num_Proc; p++) first = trace_convert(p, out, first);
+  fprintf(out, "\n]}\n");
+  fclose(out);
+}
+/*****************************************************************************/
+
+/*
+ * Performance log.
+ *
+ * One JSON object per line in the Performance Log File, written by
+ * processor 0 with its own times: a "newton" record for every Newton
+ * iteration and a "step" record for every time step tried. Each record
+ * is flushed as it is written, so a run that dies still leaves a log.
+ */
+
+static FILE *Log_Fp = NULL;
+static int   Log_Step = 0;		/* time step the records belong to */
+static int   Log_Rejections = 0;	/* tries of this step rejected so far */
+static dbl   Log_Output = 0.;		/* output seconds since the last step */
+
+static FILE *
+perf_log_stream(void)
+{
+  if (ProcID != 0 || Perf_Log_File[0] == '\0') return NULL;
+  if (Log_Fp == NULL) {
+    Log_Fp = fopen(Perf_Log_File, "w");
+    if (Log_Fp == NULL) {
+      WH(-1, "Could not open the Performance Log File, no log written");
+      Perf_Log_File[0] = '\0';
+    }
+  }
+  return Log_Fp;
+}
+
+/* a number, or null when it was not measured (negative) */
+static void
+perf_log_value(FILE *fp, const char *key, const dbl v)
+{
+  if (v < 0.) fprintf(fp, ", \"%s\": null", key);
+  else fprintf(fp, ", \"%s\": %.6e", key, v);
+}
+
+void
+perf_log_begin_step(const int step)
+{
+  Log_Step = step;
+}
+
+void
+perf_log_output(const dbl seconds)
+{
+  Log_Output += seconds;
+}
+
+void
+perf_log_newton(const int iter,
+		const dbl time,
+		const dbl assembly,
+		const dbl solve,
+		const int krylov_its,
+		const char *precond,
+		const int jacobian_formed,
+		const dbl residual,
+		const dbl update,
+		const int converged)
+
+    /*************************************************************************
+     *
+     * perf_log_newton():
+     *
+     *  Record Newton iteration iter: seconds in the assembly and the linear
+     *  solve, Krylov iterations (-1 if not an iterative solve), how the
+     *  preconditioner was had (calc, recalc, reuse; NULL if not known),
+     *  whether the Jacobian was formed or the last one reused, and the L2
+     *  norms of the residual and of the update (-1 for no update).
+     *************************************************************************/
+{
+  FILE *fp = perf_log_stream();
+
+  if (fp == NULL) return;
+
+  fprintf(fp, "{\"type\": \"newton\", \"step\": %d, \"time\": %.10e, "
+	  "\"iter\": %d", Log_Step, time, iter);
+  perf_log_value(fp, "assembly_s", assembly);
+  perf_log_value(fp, "solve_s", solve);
+  if (krylov_its < 0) fprintf(fp, ", \"krylov_its\": null");
+  else fprintf(fp, ", \"krylov_its\": %d", krylov_its);
+  if (precond == NULL) fprintf(fp, ", \"precond\": null");
+  else fprintf(fp, ", \"precond\": \"%s\"", precond);
+  fprintf(fp, ", \"jacobian\": \"%s\"", jacobian_formed ? "formed" : "reused");
+  perf_log_value(fp, "residual_l2", residual);
+  perf_log_value(fp, "update_l2", update);
+  fprintf(fp, ", \"converged\": %s}\n", converged ? "true" : "false");
+  fflush(fp);
+}
+
+void
+perf_log_step(const dbl time,
+	      const dbl delta_t,
+	      const int accepted,
+	      const int newton_its)
+
+    /*************************************************************************
+     *
+     * perf_log_step():
+     *
+     *  Record a try of the current time step: the time reached, the step
+     *  size, whether it was accepted, its Newton iterations (-1 if the
+     *  iteration failed), the tries of this step rejected before it, and
+     *  the output seconds since the last record.
+     *************************************************************************/
+{
+  FILE *fp = perf_log_stream();
+
+  if (fp != NULL) {
+    fprintf(fp, "{\"type\": \"step\", \"step\": %d, \"time\": %.10e, "
+	    "\"dt\": %.6e, \"accepted\": %s, \"newton_its\": %d, "
+	    "\"rejections\": %d", Log_Step, time, delta_t,
+	    accepted ? "true" : "false", newton_its, Log_Rejections);
+    perf_log_value(fp, "output_s", Log_Output);
+    fprintf(fp, "}\n");
+    fflush(fp);
+  }
+
+  Log_Rejections = accepted ? 0 : Log_Rejections + 1;
+  Log_Output = 0.;
+}
+
+void
+perf_log_close(void)
+{
+  if (Log_Fp != NULL) fclose(Log_Fp);
+  Log_Fp = NULL;
+}
+/*****************************************************************************/
+
+/*
+ * Kernel benchmark.
+ *
+ * Given a Kernel Benchmark card, the first assembly of the run is done
+ * that many extra times on the same x, with the hot kernels of the
+ * matrix_fill() volume loop timed one call at a time. Processor 0 then
+ * prints, summed over the processors, the calls of each kernel and its
+ * time in ns per call, per element and per volume quadrature point.
+ * The per call timing costs a clock read on each side, which matters
+ * most for the smallest kernels; their figures are upper bounds.
+ */
+
+int Kernel_Bench_Reps = 0;
+int Kernel_Bench_Active = FALSE;
+dbl Kernel_Bench_Time[KB_NUM];
+dbl Kernel_Bench_Calls[KB_NUM];
+
+static int Kernel_Bench_Done = FALSE;
+
+static const char *Kernel_Bench_Name[KB_NUM] = {
+  "load_basis_functions",
+  "beer_belly",
+  "load_fv",
+  "load_fv_grads",
+  "load_fv_mesh_derivs",
+  "assemble_momentum",
+  "assemble_continuity",
+  "assemble_energy",
+  "assemble_stress_log_conf",
+  "load_lec"
+};
+
+int
+kernel_bench_pending(void)
+{
+  return (Kernel_Bench_Reps > 0 && !Kernel_Bench_Done);
+}
+
+void
+kernel_bench_begin(void)
+{
+  int k;
+
+  for (k = 0; k < KB_NUM; k++) {
+    Kernel_Bench_Time[k] = 0.;
+    Kernel_Bench_Calls[k] = 0.;
+  }
+  Kernel_Bench_Done = TRUE;
+  Kernel_Bench_Active = TRUE;
+}
+
+void
+kernel_bench_end(const dbl seconds)
+
+    /*************************************************************************
+     *
+     * kernel_bench_end():
+     *
+     *  Stop the kernel timing and print the table; seconds is this
+     *  processor's wall time for all of the repeated assemblies.
+     *  Elements are counted by the calls of load_lec() and quadrature
+     *  points by the calls of load_basis_functions().
+     *************************************************************************/
+{
+  dbl t[KB_NUM + 1], n[KB_NUM];
+  dbl per_elem, per_qp;
+  int k;
+
+  Kernel_Bench_Active = FALSE;
+
+  for (k = 0; k < KB_NUM; k++) {
+    t[k] = Kernel_Bench_Time[k];
+    n[k] = Kernel_Bench_Calls[k];
+  }
+  t[KB_NUM] = seconds;
+#ifdef PARALLEL
+  if (Num_Proc > 1) {
+    dbl st[KB_NUM + 1], sn[KB_NUM];
+    MPI_Reduce(t, st, KB_NUM + 1, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    MPI_Reduce(n, sn, KB_NUM, MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+    for (k = 0; k < KB_NUM; k++) {
+      t[k] = st[k];
+      n[k] = sn[k];
+    }
+    t[KB_NUM] = st[KB_NUM];
+  }
+#endif
+  if (ProcID != 0) return;
+
+  per_elem = (n[KB_LOAD_LEC] > 0.) ? 1.e9 / n[KB_LOAD_LEC] : 0.;
+  per_qp = (n[KB_LOAD_BASIS] > 0.) ? 1.e9 / n[KB_LOAD_BASIS] : 0.;
+
+  fprintf(stdout, "\nKernel Benchmark: %d assemblies, %.0f elements, "
+	  "%.0f volume quadrature points, %.6e s over %d processors\n",
+	  Kernel_Bench_Reps, n[KB_LOAD_LEC], n[KB_LOAD_BASIS],
+	  t[KB_NUM], Num_Proc);
+  fprintf(stdout, "  %-26s %14s %12s %12s %12s\n", "kernel", "calls",
+	  "ns/call", "ns/elem", "ns/qp");
+  for (k = 0; k < KB_NUM; k++) {
+    if (n[k] <= 0.) continue;
+    fprintf(stdout, "  %-26s %14.0f %12.1f %12.1f %12.1f\n",
+	    Kernel_Bench_Name[k], n[k], 1.e9 * t[k] / n[k],
+	    t[k] * per_elem, t[k] * per_qp);
+  }
+  fprintf(stdout, "  %-26s %14s %12s %12.1f %12.1f\n", "whole assembly", "",
+	  "", t[KB_NUM] * per_elem, t[KB_NUM] * per_qp);
+  fflush(stdout);
+}
+/*****************************************************************************/
+
 /*
  * get_date() -- fill a pre-allocated string with the date as "mm/dd/yy" 
  */
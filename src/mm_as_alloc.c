@@ -1321,7 +1321,12 @@ assembly_alloc(Exo_DB *exo)
   /*
    * Action_Flags______________________________________________________________
    */
-  af = alloc_struct_1(struct Action_Flags, 1);    
+  /*
+   * Shared by all assembly threads, so only the first caller allocates it.
+   */
+  if (af == NULL) {
+    af = alloc_struct_1(struct Action_Flags, 1);
+  }
   if (Debug_Flag) {
     P0PRINTF("%s: Action_Flags @ %p has %lu bytes", yo, af,
 	     (long unsigned int)sizeof(struct Action_Flags));
@@ -1584,6 +1589,17 @@ assembly_alloc(Exo_DB *exo)
 /***************************************************************************/
 /***************************************************************************/
 
+/*
+ * bf_mp_init() only points bf[] entries at bfd[], so calling it again for
+ * the same problem description and element shape changes nothing; it
+ * remembers its last call until bf_init() or bf_reset() touch bf[].
+ */
+static struct Problem_Description *Bf_Mp_Pd = NULL;
+static int Bf_Mp_Shape = -1;
+#ifdef _OPENMP
+#pragma omp threadprivate(Bf_Mp_Pd, Bf_Mp_Shape)
+#endif
+
 int 
 bf_init(Exo_DB *exo)
 
@@ -1616,6 +1632,8 @@ bf_init(Exo_DB *exo)
   fprintf(stderr, "bf_init\n");
 #endif
 
+  Bf_Mp_Pd = NULL;
+
   for ( ebi=0; ebi<Proc_Num_Elem_Blk; ebi++)
     {
       m = Matilda[ebi];
@@ -1693,6 +1711,8 @@ bf_mp_init(struct Problem_Description *pd)
    /* This is needed to check for matching element shapes */
    ishape = ei->ielem_shape;
 
+  if (pd == Bf_Mp_Pd && ishape == Bf_Mp_Shape) return(status);
+
   /*
    * For now, assume variable interpolations 
    * and equation weightings are the same.
@@ -1783,6 +1803,8 @@ bf_mp_init(struct Problem_Description *pd)
 	}
     }
 
+  Bf_Mp_Pd = pd;
+  Bf_Mp_Shape = ishape;
 
   return(status);
 }
@@ -1794,6 +1816,7 @@ void
 bf_reset(void) 
 {
   int  v;
+  Bf_Mp_Pd = NULL;
   for (v = 0; v < MAX_VARIABLE_TYPES; v++) 
     {
       bf[v] = NULL;
@@ -1900,6 +1923,7 @@ init_Generalized_Newtonian(struct Generalized_Newtonian *g)
   g->cure_species_no      = 0;
   g->DilViscModel         = 0;
   g->DilVisc0             = 0.0;
+  g->shear_viscosity      = NULL;
 
   return;
 }
@@ -96,6 +96,24 @@ static double getPositionAC
 PROTO((struct AC_Information *augc, double *cAC_iAC, double *soln, Exo_DB *exo
 ));
 
+static double *
+ac_base_residual
+PROTO((int,			/* numProcUnknowns */
+       MF_Args *));		/* mf_args - matrix_fill_full() arguments */
+
+/*
+ * Augmenting Conditions Sensitivity = forward: dR/dp of each AC is
+ * (R(p+dp) - R(p))/dp, with R(p) the residual at the unperturbed
+ * parameters, assembled once per Newton iteration for all the ACs,
+ * instead of the central (R(p+dp) - R(p-dp))/2dp, which costs two
+ * assemblies per AC.
+ */
+int AC_Sensitivity_Forward = FALSE;
+
+static double *AC_Res0 = NULL;		/* R(p), numProcUnknowns long */
+static int AC_Res0_Length = 0;
+static int AC_Res0_Valid = FALSE;	/* for this Newton iteration */
+
 /*
 
    AUGMENTING CONDITION UTILITY ROUTINES
@@ -1617,6 +1635,13 @@ user_aug_cond(int iAC,
       /* Compute bAC with numerical difference
        *
        */
+      double *res_0 = NULL;
+
+      if (AC_Sensitivity_Forward)
+	{
+	  res_0 = ac_base_residual(numProcUnknowns, mf_args);
+	  if (res_0 == NULL) return(-1);
+	}
      
       p_save = x_AC[iAC];
       /*  */
@@ -1654,43 +1679,51 @@ user_aug_cond(int iAC,
 			     mf_args->estifm);
 
       if (err == -1) return(err);
-      /*  */
-      x_AC[iAC] = p_save-dp_save;
+      if (res_0 != NULL)
+	{
+	  xm = 1.0/dp_save;
+	  v2sum(numProcUnknowns, &bAC[iAC][0], xm, &res_p[0], -xm, &res_0[0]);
+	}
+      else
+	{
+	  /*  */
+	  x_AC[iAC] = p_save-dp_save;
 
-      update_parameterAC(iAC, mf_args->x, mf_args->xdot, x_AC, 
-			 cx, mf_args->exo, mf_args->dpi);
+	  update_parameterAC(iAC, mf_args->x, mf_args->xdot, x_AC, 
+			     cx, mf_args->exo, mf_args->dpi);
 
-      init_vec_value (res_m, 0.0, numProcUnknowns);
+	  init_vec_value (res_m, 0.0, numProcUnknowns);
 	  
-      af->Assemble_Residual = TRUE;
-      af->Assemble_Jacobian = FALSE;
-      af->Assemble_LSA_Jacobian_Matrix = FALSE;
-      af->Assemble_LSA_Mass_Matrix = FALSE;
+	  af->Assemble_Residual = TRUE;
+	  af->Assemble_Jacobian = FALSE;
+	  af->Assemble_LSA_Jacobian_Matrix = FALSE;
+	  af->Assemble_LSA_Mass_Matrix = FALSE;
      
-      err = matrix_fill_full(mf_args->ams, 
-			     mf_args->x, 
-			     res_m, 
-			     mf_args->x_old,
-			     mf_args->x_older,
-			     mf_args->xdot,
-			     mf_args->xdot_old,
-			     mf_args->x_update,
-			     mf_args->delta_t,
-			     mf_args->theta_, 
-			     mf_args->first_elem_side_bc, 
-			     mf_args->time, 
-			     mf_args->exo,
-			     mf_args->dpi,
-			     mf_args->num_total_nodes,
-			     mf_args->h_elem_avg,
-			     mf_args->U_norm,
-			     mf_args->estifm);
+	  err = matrix_fill_full(mf_args->ams, 
+				 mf_args->x, 
+				 res_m, 
+				 mf_args->x_old,
+				 mf_args->x_older,
+				 mf_args->xdot,
+				 mf_args->xdot_old,
+				 mf_args->x_update,
+				 mf_args->delta_t,
+				 mf_args->theta_, 
+				 mf_args->first_elem_side_bc, 
+				 mf_args->time, 
+				 mf_args->exo,
+				 mf_args->dpi,
+				 mf_args->num_total_nodes,
+				 mf_args->h_elem_avg,
+				 mf_args->U_norm,
+				 mf_args->estifm);
 	  
-      if (err == -1) return(err);
-      /*  */
-      xm =0.5/dp_save;
-      /*  */
-      v2sum(numProcUnknowns, &bAC[iAC][0], xm, &res_p[0], -xm, &res_m[0]);
+	  if (err == -1) return(err);
+	  /*  */
+	  xm =0.5/dp_save;
+	  /*  */
+	  v2sum(numProcUnknowns, &bAC[iAC][0], xm, &res_p[0], -xm, &res_m[0]);
+	}
       /*  */
       x_AC[iAC] = p_save;
 	  
@@ -2500,6 +2533,74 @@ overlap_aug_cond ( int ija[],
   return;
 }  /* END of function overlap_aug_cond() */
 
+void
+ac_sensitivity_reset(void)
+
+    /*************************************************************************
+     *
+     * ac_sensitivity_reset():
+     *
+     *  The solution or the parameters have changed: the next forward
+     *  difference assembles the unperturbed residual again.
+     *************************************************************************/
+{
+  AC_Res0_Valid = FALSE;
+}
+
+static double *
+ac_base_residual(int numProcUnknowns,
+		 MF_Args *mf_args)
+
+    /*************************************************************************
+     *
+     * ac_base_residual():
+     *
+     *  The residual at the current solution and unperturbed parameters,
+     *  assembled on the first call after ac_sensitivity_reset(); NULL if
+     *  the assembly failed.
+     *************************************************************************/
+{
+  int err;
+
+  if (AC_Res0_Valid && AC_Res0_Length == numProcUnknowns) return AC_Res0;
+
+  if (AC_Res0_Length != numProcUnknowns)
+    {
+      safer_free((void **) &AC_Res0);
+      AC_Res0 = alloc_dbl_1(numProcUnknowns, 0.0);
+      AC_Res0_Length = numProcUnknowns;
+    }
+  init_vec_value(AC_Res0, 0.0, numProcUnknowns);
+
+  af->Assemble_Residual = TRUE;
+  af->Assemble_Jacobian = FALSE;
+  af->Assemble_LSA_Jacobian_Matrix = FALSE;
+  af->Assemble_LSA_Mass_Matrix = FALSE;
+
+  err = matrix_fill_full(mf_args->ams, 
+			 mf_args->x, 
+			 AC_Res0, 
+			 mf_args->x_old,
+			 mf_args->x_older,
+			 mf_args->xdot,
+			 mf_args->xdot_old,
+			 mf_args->x_update,
+			 mf_args->delta_t,
+			 mf_args->theta_, 
+			 mf_args->first_elem_side_bc, 
+			 mf_args->time, 
+			 mf_args->exo,
+			 mf_args->dpi,
+			 mf_args->num_total_nodes,
+			 mf_args->h_elem_avg,
+			 mf_args->U_norm,
+			 mf_args->estifm);
+  if (err == -1) return NULL;
+
+  AC_Res0_Valid = TRUE;
+  return AC_Res0;
+}
+
 static int
 estimate_bAC(  int iAC,
 	       double x_AC[],
@@ -2511,9 +2612,14 @@ estimate_bAC(  int iAC,
   double p_save, dp_save;
   double fd_factor=FD_FACTOR;
 
-  double *res_p, *res_m, xm;
+  double *res_p, *res_m, *res_0 = NULL, xm;
   int  err=-99;
 
+  if (AC_Sensitivity_Forward)
+    {
+      res_0 = ac_base_residual(numProcUnknowns, mf_args);
+      if (res_0 == NULL) return(-1);
+    }
 
   asdv(&res_p, numProcUnknowns);
   asdv(&res_m, numProcUnknowns);
@@ -2568,55 +2674,63 @@ estimate_bAC(  int iAC,
   
   if (err == -1) return(err);
 
-	  /*  */
-  x_AC[iAC] = p_save-dp_save;
+  if (res_0 != NULL)
+    {
+      xm = 1.0/dp_save;
+      v2sum(numProcUnknowns, &bAC[iAC][0], xm, &res_p[0], -xm, &res_0[0]);
+    }
+  else
+    {
+	      /*  */
+      x_AC[iAC] = p_save-dp_save;
 
-  update_parameterAC(iAC, mf_args->x, mf_args->xdot, x_AC, 
-		     cx, mf_args->exo, mf_args->dpi);
+      update_parameterAC(iAC, mf_args->x, mf_args->xdot, x_AC, 
+			 cx, mf_args->exo, mf_args->dpi);
 
-  af->Assemble_Residual = TRUE;
-  af->Assemble_Jacobian = FALSE;
-  af->Assemble_LSA_Jacobian_Matrix = FALSE;
-  af->Assemble_LSA_Mass_Matrix = FALSE;
+      af->Assemble_Residual = TRUE;
+      af->Assemble_Jacobian = FALSE;
+      af->Assemble_LSA_Jacobian_Matrix = FALSE;
+      af->Assemble_LSA_Mass_Matrix = FALSE;
 
-  if ( augc[iAC].Type == AC_VOLUME )
-    {
-	init_vec_value(augc[iAC].d_evol_dx, 0.0, numProcUnknowns);
-	augc[iAC].evol = 0.; 
-    }
+      if ( augc[iAC].Type == AC_VOLUME )
+	{
+	    init_vec_value(augc[iAC].d_evol_dx, 0.0, numProcUnknowns);
+	    augc[iAC].evol = 0.; 
+	}
 
-  if ( augc[iAC].Type == AC_LS_VEL )
-    {
-	init_vec_value(augc[iAC].d_lsvel_dx, 0.0, numProcUnknowns);
-	init_vec_value(augc[iAC].d_lsvol_dx, 0.0, numProcUnknowns);
-	augc[iAC].lsvel = 0.; 
-	augc[iAC].lsvol = 0.; 
-    }
+      if ( augc[iAC].Type == AC_LS_VEL )
+	{
+	    init_vec_value(augc[iAC].d_lsvel_dx, 0.0, numProcUnknowns);
+	    init_vec_value(augc[iAC].d_lsvol_dx, 0.0, numProcUnknowns);
+	    augc[iAC].lsvel = 0.; 
+	    augc[iAC].lsvol = 0.; 
+	}
       
-  err = matrix_fill_full(mf_args->ams, 
-			 mf_args->x, 
-			 res_m, 
-			 mf_args->x_old,
-			 mf_args->x_older,
-			 mf_args->xdot,
-			 mf_args->xdot_old,
-			 mf_args->x_update,
-			 mf_args->delta_t,
-			 mf_args->theta_, 
-			 mf_args->first_elem_side_bc, 
-			 mf_args->time, 
-			 mf_args->exo,
-			 mf_args->dpi,
-			 mf_args->num_total_nodes,
-			 mf_args->h_elem_avg,
-			 mf_args->U_norm,
-			 mf_args->estifm);
+      err = matrix_fill_full(mf_args->ams, 
+			     mf_args->x, 
+			     res_m, 
+			     mf_args->x_old,
+			     mf_args->x_older,
+			     mf_args->xdot,
+			     mf_args->xdot_old,
+			     mf_args->x_update,
+			     mf_args->delta_t,
+			     mf_args->theta_, 
+			     mf_args->first_elem_side_bc, 
+			     mf_args->time, 
+			     mf_args->exo,
+			     mf_args->dpi,
+			     mf_args->num_total_nodes,
+			     mf_args->h_elem_avg,
+			     mf_args->U_norm,
+			     mf_args->estifm);
       
-  if (err == -1) return(err);
+      if (err == -1) return(err);
 	  
-  xm = 0.5/dp_save;
+      xm = 0.5/dp_save;
 	    
-  v2sum(numProcUnknowns, &bAC[iAC][0], xm, &res_p[0], -xm, &res_m[0]);
+      v2sum(numProcUnknowns, &bAC[iAC][0], xm, &res_p[0], -xm, &res_m[0]);
+    }
 	  
   x_AC[iAC] = p_save;
 	  
@@ -3549,6 +3663,130 @@ assign_overlap_acs( double x[], Exo_DB *exo )
   return (-2);
 }  /* END of function assign_overlap_acs */
 
+int
+periodic_node_pairs(Exo_DB *exo,
+		    const int ssid1,
+		    const int ssid2,
+		    int **node_list1,
+		    int **node_list2match)
+/*
+ * Pair up the nodes of side sets ssid1 and ssid2 of a periodic boundary:
+ * node (*node_list1)[i] of the first and (*node_list2match)[i] of the
+ * second agree in all coordinates but one.
+ *
+ * Returns the number of pairs; both lists are smalloc'd here.
+ */
+{
+  int i, j, k;
+  int ss1 = -1, ss2 = -1;
+  int found = FALSE;
+  int num_nodes_on_side, max_sides, max_nodes;
+  int *node_list2;
+  int count1, count2, beg, end, n, node_num;
+  int dim_count, dim = pd->Num_Dim;
+  double scale;
+
+  found = FALSE;
+  for (i=0; i<exo->num_side_sets; i++)
+    {
+      if (!found && exo->ss_id[i] == ssid1)
+	{
+	  found = TRUE;
+	  ss1 = i;
+	}
+    }
+  if ( !found ) EH(-1,"SSID1 not found in mesh for periodic bc");
+
+  found = FALSE;
+  for (i=0; i<exo->num_side_sets; i++)
+    {
+      if (!found && exo->ss_id[i] == ssid2)
+	{
+	  found = TRUE;
+	  ss2 = i;
+	}
+    }
+  if ( !found ) EH(-1,"SSID2 not found in mesh for periodic bc");
+
+  /* require SS's match */
+  if ( exo->ss_num_sides[ss1] != exo->ss_num_sides[ss2] ) {
+    EH(-1,"Periodic bc's only supported for matching side sets!");
+  }
+
+  num_nodes_on_side = ( exo->ss_node_side_index[ss1][1] -
+			exo->ss_node_side_index[ss1][0] );
+  max_sides = exo->ss_num_sides[ss1];
+  max_nodes = max_sides * num_nodes_on_side;
+
+  /* allocate temp array to store list of nodes */
+  *node_list1 = (int *) smalloc(max_nodes * sizeof(int));
+  node_list2 = (int *) smalloc(max_nodes * sizeof(int));
+
+  count1 = 0;
+  beg = exo->ss_node_side_index[ss1][0];
+  end = exo->ss_node_side_index[ss1][exo->ss_num_sides[ss1]];
+  for (n = beg; n < end; n++) {
+    node_num = exo->ss_node_list[ss1][n];
+    found = FALSE;
+    for ( i = 0; i < count1 && !found; i++ ) {
+      if ( node_num == (*node_list1)[i] ) found = TRUE;
+    }
+    if ( !found ) {
+      (*node_list1)[count1++] = node_num;
+    }
+  }
+
+  count2 = 0;
+  beg = exo->ss_node_side_index[ss2][0];
+  end = exo->ss_node_side_index[ss2][exo->ss_num_sides[ss2]];
+  for (n = beg; n < end; n++) {
+    node_num = exo->ss_node_list[ss2][n];
+    found = FALSE;
+    for ( i = 0; i < count2 && !found; i++ ) {
+      if ( node_num == node_list2[i] ) found = TRUE;
+    }
+    if ( !found ) {
+      node_list2[count2++] = node_num;
+    }
+  }
+
+  if ( count1 != count2 ) {
+    EH(-1,"Periodic bc's only supported for matching side sets!");
+  }
+
+  /* now look to match nodes between lists */
+  *node_list2match = (int *) smalloc(max_nodes * sizeof(int));
+
+  /* to make comparisons, we need a length scale
+   * crude, but we'll get it from the distance between two points in list
+   */
+  scale = 0.;
+  for ( k = 0; k < dim; k++ )
+    scale += (Coor[k][(*node_list1)[1]] - Coor[k][(*node_list1)[0]]) *
+	     (Coor[k][(*node_list1)[1]] - Coor[k][(*node_list1)[0]]);
+  scale = sqrt(scale);
+
+  for ( i = 0; i < count1; i++ ) {
+    found = FALSE;
+    for ( j = 0; j < count1 && !found; j++ ) {
+      dim_count = 0;
+      for ( k = 0; k < dim; k++ ) {
+	if ( fabs(Coor[k][(*node_list1)[i]]-Coor[k][node_list2[j]]) < 1.e-5*scale ) dim_count++;
+      }
+      if ( dim_count == dim-1 ) {
+	found = TRUE;
+	(*node_list2match)[i] = node_list2[j];
+      }
+    }
+    if ( !found ) {
+      EH(-1,"Periodic bc's only supported for matching side sets!");
+    }
+  }
+
+  safe_free( node_list2 );
+  return count1;
+}
+
 int
 create_periodic_acs(Exo_DB *exo)
 /*
@@ -3564,14 +3802,10 @@ create_periodic_acs(Exo_DB *exo)
  */
 {
   int old_nAC, new_ACs, new_nAC, iAC;
-  int ac_count, i, j, k;
-  int ssid1 = 0, ssid2 = 0, ss1 = -1, ss2 = -1, var, ie;
-  int found = FALSE;
-  int num_nodes_on_side, max_sides, max_nodes;
-  int *node_list1, *node_list2, *node_list2match;
-  int count1, count2, beg, end, n, node_num;
-  int dim_count, dim = pd->Num_Dim;
-  double scale;
+  int ac_count, i;
+  int ssid1 = 0, ssid2 = 0, var, ie;
+  int *node_list1, *node_list2match;
+  int count1, count2;
 
 /* Save old nAC value */
   old_nAC = nAC;
@@ -3587,103 +3821,9 @@ create_periodic_acs(Exo_DB *exo)
       /* set vars to -1 for this entry */
       augc[iAC].fluid_eb = -1;
       augc[iAC].solid_eb = -1;
-  
-      found = FALSE;
-      for (i=0; i<exo->num_side_sets; i++)
-       {
-          if (!found && exo->ss_id[i] == ssid1)
-            {
-              found = TRUE;
-              ss1 = i;
-            }
-        }
-      if ( !found ) EH(-1,"SSID1 not found in mesh for periodic bc");
-  
-      found = FALSE;
-      for (i=0; i<exo->num_side_sets; i++)
-        {
-          if (!found && exo->ss_id[i] == ssid2)
-            {
-              found = TRUE;
-              ss2 = i;
-            }
-        }
-      if ( !found ) EH(-1,"SSID2 not found in mesh for periodic bc");
 
-      /* require SS's match */
-      if ( exo->ss_num_sides[ss1] != exo->ss_num_sides[ss2] ) {
-        EH(-1,"Periodic bc's only supported for matching side sets!");
-      }
-  
-      num_nodes_on_side = ( exo->ss_node_side_index[ss1][1] -
-                            exo->ss_node_side_index[ss1][0] );
-      max_sides = exo->ss_num_sides[ss1];
-      max_nodes = max_sides * num_nodes_on_side;
-  
-      /* allocate temp array to store list of nodes */
-      node_list1 = (int *) smalloc(max_nodes * sizeof(int));
-      node_list2 = (int *) smalloc(max_nodes * sizeof(int));
-  
-      count1 = 0;
-      beg = exo->ss_node_side_index[ss1][0];
-      end = exo->ss_node_side_index[ss1][exo->ss_num_sides[ss1]];
-      for (n = beg; n < end; n++) {
-        node_num = exo->ss_node_list[ss1][n];
-        found = FALSE;
-        for ( i = 0; i < count1 && !found; i++ ) {
-          if ( node_num == node_list1[i] ) found = TRUE;
-        }
-        if ( !found ) {
-         node_list1[count1++] = node_num;
-	}
-      }
-  
-      count2 = 0;
-      beg = exo->ss_node_side_index[ss2][0];
-      end = exo->ss_node_side_index[ss2][exo->ss_num_sides[ss2]];
-      for (n = beg; n < end; n++) {
-        node_num = exo->ss_node_list[ss2][n];
-        found = FALSE;
-        for ( i = 0; i < count2 && !found; i++ ) {
-          if ( node_num == node_list2[i] ) found = TRUE;
-        }
-        if ( !found ) {
-         node_list2[count2++] = node_num;
-        }
-      }
-  
-      if ( count1 != count2 ) {
-        EH(-1,"Periodic bc's only supported for matching side sets!");
-      }
-      
-      /* now look to match nodes between lists */
-      node_list2match = (int *) smalloc(max_nodes * sizeof(int));
-      
-      /* to make comparisons, we need a length scale 
-       * crude, but we'll get it from the distance between two points in list
-       */
-      scale = 0.;
-      for ( k = 0; k < dim; k++ ) 
-        scale += (Coor[k][node_list1[1]] - Coor[k][node_list1[0]]) *
-	         (Coor[k][node_list1[1]] - Coor[k][node_list1[0]]);
-      scale = sqrt(scale);
-      
-      for ( i = 0; i < count1; i++ ) {
-        found = FALSE;
-	for ( j = 0; j < count1 && !found; j++ ) {
-	  dim_count = 0;
-          for ( k = 0; k < dim; k++ ) {
-	    if ( fabs(Coor[k][node_list1[i]]-Coor[k][node_list2[j]]) < 1.e-5*scale ) dim_count++;
-	  }
-	  if ( dim_count == dim-1 ) {
-	    found = TRUE;
-	    node_list2match[i] = node_list2[j];
-	  }
-	}
-	if ( !found ) {
-          EH(-1,"Periodic bc's only supported for matching side sets!");
-        }
-      }
+      count1 = periodic_node_pairs(exo, ssid1, ssid2, &node_list1,
+				   &node_list2match);
       
       /* reuse count2 to keep track of how many nodes are there that have the
          desired variable defined
@@ -3745,7 +3885,6 @@ create_periodic_acs(Exo_DB *exo)
       DPRINTF(stderr, "\tCreated %d new AC's for periodic bc.\n", new_ACs);
 	
       safe_free( node_list1 );
-      safe_free( node_list2 );
       safe_free( node_list2match );
     }
   }
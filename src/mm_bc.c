@@ -80,6 +80,7 @@ double pressure_datum_value = 0.0; /* value of the pressure datum */
  * ------------------------       ---------------     -------------------
  *   find_and_set_Dirichlet ()		void	      rf_sol_nonlinear
  *       set_nodal_Dirichlet_BC() static void	      find_and_set_Dirichlet
+ *       compile_Dirichlet_dofs() static void	      find_and_set_Dirichlet
  *   alloc_First_Elem_BC()	 	void	      pre_process
  *   set_up_Surf_BC ()		 	void	      rf_sol_nonlinear
  *       setup_Elem_BC ()	 static void	      set_up_Surf_BC
@@ -101,6 +102,9 @@ set_nodal_Dirichlet_BC PROTO ((
 			       int
 			       ));
 
+static void
+compile_Dirichlet_dofs PROTO (( void ));
+
 static void
 setup_Elem_BC PROTO ((  struct elem_side_bc_struct **elem_side_bc, 
     			struct Boundary_Condition  *bc_type, 
@@ -486,12 +490,62 @@ find_and_set_Dirichlet(double x[],    /* solution vector at this processor */
       }
     }
   }
+
+  compile_Dirichlet_dofs();
   return;
 } /* END of ROUTINE find_and_set_Dirichlet ***********************************/
 /*****************************************************************************/
 /*****************************************************************************/
 /*****************************************************************************/
 
+static void
+compile_Dirichlet_dofs(void)
+
+     /********************************************************************
+      *    compile_Dirichlet_dofs:
+      *
+      *	Gather the unknowns that node->DBC[] flags at each node into
+      *  node->DBC_Dofs[], together with their variable descriptions, so
+      *  that put_dirichlet_in_matrix() loops over the Dirichlet unknowns
+      *  of an element's nodes only instead of over all of their unknowns.
+      *
+      ********************************************************************/
+{
+  int i, n, lvdesc, idof, offset;
+  int total_nodes = Num_Internal_Nodes + Num_Border_Nodes + Num_External_Nodes;
+  NODE_INFO_STRUCT *node;
+  NODAL_VARS_STRUCT *nv;
+
+  for (i = 0; i < total_nodes; i++) {
+    node = Nodes[i];
+    safer_free((void **) &(node->DBC_Dofs));
+    node->Num_DBC_Dofs = 0;
+    if (node->DBC == NULL) continue;
+    nv = node->Nodal_Vars_Info;
+
+    for (offset = 0, n = 0; offset < nv->Num_Unknowns; offset++) {
+      if (node->DBC[offset] != -1) n++;
+    }
+    if (n == 0) continue;
+    node->DBC_Dofs = alloc_struct_1(struct Dirichlet_Dof, n);
+
+    offset = 0;
+    for (lvdesc = 0; lvdesc < nv->Num_Var_Desc; lvdesc++) {
+      for (idof = 0; idof < nv->Var_Desc_List[lvdesc]->Ndof; idof++) {
+	if (node->DBC[offset] != -1) {
+	  node->DBC_Dofs[node->Num_DBC_Dofs].offset = (short int) offset;
+	  node->DBC_Dofs[node->Num_DBC_Dofs].lvdesc = (short int) lvdesc;
+	  node->Num_DBC_Dofs++;
+	}
+	offset++;
+      }
+    }
+  }
+}
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
 static int
 set_nodal_Dirichlet_BC(int inode, int ibc,
 		       struct Boundary_Condition *boundary_condition,
@@ -73,12 +73,15 @@ int num_BC_nodes = 0;
 int *BC_dup_nodes = NULL;
 int ***BC_dup_list = NULL;
 int BC_dup_ptr = 0;
+int *BC_dup_index = NULL;
 int *mesh_rotate_node = NULL;
 int *mesh_rotate_ss = NULL;
 int num_mesh_rotate = 0;
 int *mom_rotate_node = NULL;
 int *mom_rotate_ss = NULL;
 int num_mom_rotate = 0;
+int *mesh_rotate_index = NULL;
+int *mom_rotate_index = NULL;
 
 /********** R O U T I N E S   D E F I N E D   I N   T H I S   F I L E **********
 *
@@ -110,6 +113,7 @@ static int **alloc_bc_unk_list_node(int inode)
      *
      *          bc_list_node[nv->Num_Unknowns][MAX_NODAL_BCS]
      *
+     *  and is one block, bc_list_node[0], behind the row pointers.
      *  The elements of the array are initialized to the value of -1.
      *************************************************************************/
 {
@@ -125,8 +129,9 @@ static int **alloc_bc_unk_list_node(int inode)
     num = 1;
   }
   bc_unk_list_node = (int **) alloc_ptr_1(num);
-  for (unk = 0; unk < num; unk++) {
-    bc_unk_list_node[unk] = alloc_int_1(MAX_NODAL_BCS, -1);
+  bc_unk_list_node[0] = alloc_int_1(num * MAX_NODAL_BCS, -1);
+  for (unk = 1; unk < num; unk++) {
+    bc_unk_list_node[unk] = bc_unk_list_node[0] + unk * MAX_NODAL_BCS;
   }
   return bc_unk_list_node;
 }
@@ -150,14 +155,8 @@ static void free_bc_unk_list_node(int ***bc_list_node_ptr, int inode)
      *                     the function alloc_bc_list_node().
      *************************************************************************/
 {
-  int unk;
-  NODE_INFO_STRUCT *node = Nodes[inode];
-  NODAL_VARS_STRUCT *nv = node->Nodal_Vars_Info;
-  int num = nv->Num_Unknowns;
   int **bc_list_node = *bc_list_node_ptr;
-  for (unk = 0; unk < num; unk++) {
-    safer_free((void **) (bc_list_node + unk));
-  }
+  safer_free((void **) bc_list_node);
   safer_free((void **) bc_list_node_ptr);
 }
 /*****************************************************************************/
@@ -264,6 +263,26 @@ search_bc_dup_list(const int bc_item, int *list)
   } 
   return -1;
 }
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
+static void
+index_bc_dup_nodes(const int num_total_nodes)
+
+    /*
+     * BC_dup_index[inode] = position of inode in BC_dup_nodes[], -1 if it
+     * is not there, so the collocated BC's can tell a node with
+     * duplications without searching the list.
+     */
+{
+  int i;
+  safe_free((void *) BC_dup_index);
+  BC_dup_index = alloc_int_1(MAX(num_total_nodes, 1), -1);
+  for (i = 0; i < BC_dup_ptr; i++) {
+    BC_dup_index[BC_dup_nodes[i]] = i;
+  }
+}
 
 /*****************************************************************************/
 /*****************************************************************************/
@@ -655,7 +674,7 @@ check_for_bc_conflicts2D(Exo_DB *exo, Dpi *dpi)
 	 */
 	if (idup > 1) {
 	  /* initialize new entry in the duplications list, if not already listed */
-	  if (in_list(inode, 0, BC_dup_ptr, BC_dup_nodes) == -1) {
+	  if (BC_dup_ptr == 0 || BC_dup_nodes[BC_dup_ptr-1] != inode) {
 	    /* Put the node in the list */
 	    BC_dup_nodes[BC_dup_ptr] = inode;
 	    /* Put the pointer to the BC_Unk_List for the node
@@ -1970,6 +1989,23 @@ check_for_bc_conflicts2D(Exo_DB *exo, Dpi *dpi)
   mom_rotate_ss    = (int *)realloc(mom_rotate_ss, num_mom_rotate * sizeof(int));
   }
 
+  /* node -> position in the rotation lists, so the assembly can tell a
+   * rotated node without searching them */
+  safe_free((void *) mesh_rotate_index);
+  safe_free((void *) mom_rotate_index);
+  mesh_rotate_index = NULL;
+  mom_rotate_index = NULL;
+  if (num_total_nodes > 0) {
+    mesh_rotate_index = alloc_int_1(num_total_nodes, -1);
+    mom_rotate_index  = alloc_int_1(num_total_nodes, -1);
+    for (i = 0; i < num_mesh_rotate; i++) {
+      mesh_rotate_index[mesh_rotate_node[i]] = i;
+    }
+    for (i = 0; i < num_mom_rotate; i++) {
+      mom_rotate_index[mom_rotate_node[i]] = i;
+    }
+  }
+
 if( mesh_rotate_node != NULL || mom_rotate_node != NULL )
   {
 	int ebi=0;
@@ -2000,9 +2036,10 @@ if( mesh_rotate_node != NULL || mom_rotate_node != NULL )
   
   /* free memory associated with nodes that don't have duplicate BC's
    */
+  index_bc_dup_nodes(num_total_nodes);
   for (inode = 0; inode < num_total_nodes; inode++) {
     if (BC_Unk_List[inode] != NULL) {
-      if (in_list(inode, 0, BC_dup_ptr, BC_dup_nodes) == -1) {
+      if (BC_dup_index[inode] == -1) {
 	free_bc_unk_list_node(BC_Unk_List + inode, inode);
       }
     }
@@ -2532,7 +2569,7 @@ check_for_bc_conflicts3D(Exo_DB *exo, Dpi *dpi)
 	    /* initialize new entry in the duplications list, 
 	     * if not already listed 
 	     */
-	    if (in_list(inode, 0, BC_dup_ptr, BC_dup_nodes) == -1) {
+	    if (BC_dup_ptr == 0 || BC_dup_nodes[BC_dup_ptr-1] != inode) {
 	      BC_dup_nodes[BC_dup_ptr] = inode; /* put node in 
 						 * list 
 						 */
@@ -2738,7 +2775,7 @@ check_for_bc_conflicts3D(Exo_DB *exo, Dpi *dpi)
 	    /* initialize new entry in the duplications list,
 	     *  if not already listed 
 	     */
-	    if (in_list(inode, 0, BC_dup_ptr, BC_dup_nodes) == -1) {
+	    if (BC_dup_ptr == 0 || BC_dup_nodes[BC_dup_ptr-1] != inode) {
 	      BC_dup_nodes[BC_dup_ptr] = inode;
 	      BC_dup_list[BC_dup_ptr] = BC_Unk_List[inode];
 	      BC_dup_ptr++;
@@ -3024,9 +3061,10 @@ check_for_bc_conflicts3D(Exo_DB *exo, Dpi *dpi)
   if (Unlimited_Output) fprintf(ofbc, "\n");
 
   /* free memory associated with nodes that don't have duplicate BC's */
+  index_bc_dup_nodes(num_total_nodes);
   for (inode = 0; inode < num_total_nodes; inode++) {
     if (BC_Unk_List[inode] != NULL) {
-      if (in_list(inode, 0, BC_dup_ptr, BC_dup_nodes) == -1) {
+      if (BC_dup_index[inode] == -1) {
 	free_bc_unk_list_node(BC_Unk_List + inode, inode);
       }
     }
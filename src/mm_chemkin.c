@@ -30,11 +30,13 @@
  *    chemkin_mat_prop_init
  *    chemkin_not_linked
  *    chemkin_initialize_mp
+ *    ck_gas_source_cached
  ***************************************************************************/
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <math.h>
 
 #include "std.h"
 #include "rf_fem_const.h"
@@ -366,4 +368,119 @@ chemkin_initialize_mp(void)
 /*****************************************************************************/
 /*****************************************************************************/
 /*****************************************************************************/
+#ifdef USE_CHEMKIN
+
+/*
+ * Gas phase source terms reused between calls at the same state.
+ *
+ * The residual only fills of the numerical Jacobians and of the element
+ * Jacobian passes, the line search and the Newton iterations where the
+ * species and temperature no longer move all come back with the same
+ * (T, P, Y) at a Gauss point, and each of those calls would otherwise go
+ * through the whole NASA polynomial and rate evaluation in cpc again.
+ */
+
+#define CK_CACHE_SLOTS 64
+
+struct ck_source_cache {
+  int valid;
+  int have_jac;
+  int mn;
+  int num_species;
+  double P;
+  double T;
+  double c[MAX_CONC];
+  double source[MAX_CONC];
+  double jac[MAX_CONC * MAX_CONC];
+  double d_T[MAX_CONC];
+};
+
+static struct ck_source_cache CK_Cache[CK_CACHE_SLOTS];
+
+static int
+ck_cache_slot(const int mn, const double T, const double c[], const int n)
+{
+  unsigned long long h = (unsigned long long) mn * 0x9e3779b97f4a7c15ULL;
+  unsigned long long b;
+  int w;
+
+  memcpy(&b, &T, sizeof(b));
+  h ^= b + (h << 6) + (h >> 2);
+  for (w = 0; w < n; w++) {
+    memcpy(&b, &c[w], sizeof(b));
+    h ^= b + (h << 6) + (h >> 2);
+  }
+  return (int) (h % CK_CACHE_SLOTS);
+}
+
+int
+ck_gas_source_cached(const int mn,
+		     double pressureCGS,
+		     double T,
+		     double c[],
+		     const int num_species,
+		     const int want_jac,
+		     double source[],
+		     double jac_source[],
+		     double d_source_T[])
 
+    /*************************************************************************
+     *
+     * ck_gas_source_cached():
+     *
+     *  The gas phase species source terms (mol/cm**3/sec) from cpc, with
+     *  their Jacobian d_source_i/d_Y_j and d_source_i/d_T when want_jac is
+     *  set, as ck_VD_dsdy() and ck_VD_wyp() return them. A call at exactly
+     *  the state of an earlier one (material, P, T and every Y) is served
+     *  from CK_Cache instead.
+     *
+     *  Return: CPC_SUCCESS, or the failing cpc return value.
+     *************************************************************************/
+{
+  struct ck_source_cache *e;
+  int iopt[10];
+  int err, w;
+
+  if (num_species > MAX_CONC) EH(-1, "ck_gas_source_cached: too many species");
+
+  e = &CK_Cache[ck_cache_slot(mn, T, c, num_species)];
+  if (e->valid && e->mn == mn && e->num_species == num_species &&
+      e->P == pressureCGS && e->T == T &&
+      memcmp(e->c, c, num_species * sizeof(double)) == 0 &&
+      (e->have_jac || !want_jac)) {
+    memcpy(source, e->source, num_species * sizeof(double));
+    if (want_jac) {
+      memcpy(jac_source, e->jac, num_species * num_species * sizeof(double));
+      memcpy(d_source_T, e->d_T, num_species * sizeof(double));
+    }
+    return CPC_SUCCESS;
+  }
+
+  if (want_jac) {
+    memset(iopt, 0, sizeof(iopt));
+    iopt[0] = 1;
+    err = ck_VD_dsdy(mn, &pressureCGS, &T, c, NULL, jac_source, num_species,
+		     d_source_T, iopt, source);
+  } else {
+    err = ck_VD_wyp(mn, &pressureCGS, &T, c, NULL, source);
+  }
+  if (err != CPC_SUCCESS) return err;
+
+  e->valid = TRUE;
+  e->have_jac = want_jac;
+  e->mn = mn;
+  e->num_species = num_species;
+  e->P = pressureCGS;
+  e->T = T;
+  for (w = 0; w < num_species; w++) e->c[w] = c[w];
+  memcpy(e->source, source, num_species * sizeof(double));
+  if (want_jac) {
+    memcpy(e->jac, jac_source, num_species * num_species * sizeof(double));
+    memcpy(e->d_T, d_source_T, num_species * sizeof(double));
+  }
+  return CPC_SUCCESS;
+}
+#endif
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
@@ -0,0 +1,255 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * Measured element assembly cost.
+ *
+ * The time each processor spends in the element loop of matrix_fill_full()
+ * is always accumulated, and elem_cost_report() prints the maximum and the
+ * average over the processors at the end of the run.  Their ratio is the
+ * load imbalance of the assembly: the time the other processors sit idle
+ * in the MPI_Allreduce() that follows the element loop.
+ *
+ * If an "Element Cost File" is named in the FEM File Specifications, each
+ * matrix_fill() call is also timed and charged to its element.  The mean
+ * cost per fill of every owned element is written to that file at the end
+ * of the run, keyed by global element number.  The built-in brk reads the
+ * same file, when it exists, to weight the next decomposition by measured
+ * rather than estimated cost.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "std.h"
+#include "rf_fem_const.h"
+#include "rf_io_const.h"
+#include "rf_io.h"
+#include "rf_mp.h"
+#include "mm_eh.h"
+
+#include "exo_struct.h"
+#include "dpi.h"
+
+#define _MM_ELEM_COST_C
+#include "goma.h"
+
+char Elem_Cost_File[MAX_FNL] = "";
+dbl *Elem_Cost = NULL;
+
+static int Num_Cost_Elems = 0;	/* length of Elem_Cost[] */
+static int Num_Fills = 0;	/* element loops timed so far */
+static dbl Fill_Start = 0.0;
+static dbl Fill_Seconds = 0.0;	/* this processor's time in element loops */
+
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
+dbl
+elem_cost_clock(void)
+{
+#ifdef PARALLEL
+  return MPI_Wtime();
+#else
+  return ut();
+#endif
+}
+
+/*****************************************************************************/
+
+void
+elem_cost_fill_begin(Exo_DB *exo)
+
+    /*************************************************************************
+     *
+     * elem_cost_fill_begin():
+     *
+     *  Start the clock on one element loop of matrix_fill_full(), and
+     *  make sure Elem_Cost[] is there when per-element costs are wanted.
+     *************************************************************************/
+{
+  int e;
+
+  if (Elem_Cost_File[0] != '\0' && Num_Cost_Elems != exo->num_elems) {
+    safer_free((void **) &Elem_Cost);
+    Num_Cost_Elems = exo->num_elems;
+    Elem_Cost = (dbl *) smalloc(MAX(Num_Cost_Elems, 1) * sizeof(dbl));
+    for (e = 0; e < Num_Cost_Elems; e++) Elem_Cost[e] = 0.0;
+    Num_Fills = 0;
+    Fill_Seconds = 0.0;
+  }
+
+  Fill_Start = elem_cost_clock();
+}
+
+/*****************************************************************************/
+
+void
+elem_cost_fill_end(void)
+{
+  Fill_Seconds += elem_cost_clock() - Fill_Start;
+  Num_Fills++;
+}
+
+/*****************************************************************************/
+
+void
+elem_cost_report(Exo_DB *exo, Dpi *dpi)
+
+    /*************************************************************************
+     *
+     * elem_cost_report():
+     *
+     *  Print the assembly load imbalance and, if requested, write the
+     *  measured cost of each element to the Element Cost File.  Must be
+     *  called by every processor.
+     *************************************************************************/
+{
+  int e, i, n;
+  int num_owned;
+  int *gid;
+  dbl *cost;
+  dbl max_seconds, sum_seconds, avg_seconds;
+  FILE *fp;
+#ifdef PARALLEL
+  int *counts = NULL, *displs = NULL;
+  int *all_gid = NULL;
+  dbl *all_cost = NULL;
+#endif
+  static char yo[] = "elem_cost_report";
+
+  if (Num_Fills == 0) return;
+
+  max_seconds = sum_seconds = Fill_Seconds;
+#ifdef PARALLEL
+  MPI_Allreduce(&Fill_Seconds, &max_seconds, 1, MPI_DOUBLE, MPI_MAX,
+		MPI_COMM_WORLD);
+  MPI_Allreduce(&Fill_Seconds, &sum_seconds, 1, MPI_DOUBLE, MPI_SUM,
+		MPI_COMM_WORLD);
+#endif
+  avg_seconds = sum_seconds / Num_Proc;
+
+  DPRINTF(stdout, "\nAssembly time over %d fills: max %.4g s, avg %.4g s,"
+	  " load imbalance (max/avg) %.3f\n", Num_Fills, max_seconds,
+	  avg_seconds, (avg_seconds > 0.0) ? max_seconds / avg_seconds : 1.0);
+
+  if (Elem_Cost == NULL) return;
+
+  /*
+   * Mean cost per fill of the elements this processor owns.
+   */
+  gid  = (int *) smalloc(MAX(Num_Cost_Elems, 1) * sizeof(int));
+  cost = (dbl *) smalloc(MAX(Num_Cost_Elems, 1) * sizeof(dbl));
+  num_owned = 0;
+  for (e = 0; e < Num_Cost_Elems; e++) {
+    if (dpi->elem_owner[e] != ProcID) continue;
+    gid[num_owned]  = dpi->elem_index_global[e];
+    cost[num_owned] = Elem_Cost[e] / Num_Fills;
+    num_owned++;
+  }
+
+  n = num_owned;
+#ifdef PARALLEL
+  if (Num_Proc > 1) {
+    if (ProcID == 0) {
+      counts = (int *) smalloc(Num_Proc * sizeof(int));
+      displs = (int *) smalloc(Num_Proc * sizeof(int));
+    }
+    MPI_Gather(&num_owned, 1, MPI_INT, counts, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    if (ProcID == 0) {
+      n = 0;
+      for (i = 0; i < Num_Proc; i++) {
+	displs[i] = n;
+	n += counts[i];
+      }
+      all_gid  = (int *) smalloc(MAX(n, 1) * sizeof(int));
+      all_cost = (dbl *) smalloc(MAX(n, 1) * sizeof(dbl));
+    }
+    MPI_Gatherv(gid, num_owned, MPI_INT, all_gid, counts, displs, MPI_INT,
+		0, MPI_COMM_WORLD);
+    MPI_Gatherv(cost, num_owned, MPI_DOUBLE, all_cost, counts, displs,
+		MPI_DOUBLE, 0, MPI_COMM_WORLD);
+    if (ProcID == 0) {
+      safer_free((void **) &gid);
+      safer_free((void **) &cost);
+      gid  = all_gid;
+      cost = all_cost;
+      safer_free((void **) &counts);
+      safer_free((void **) &displs);
+    }
+  }
+#endif
+
+  if (ProcID == 0) {
+    fp = fopen(Elem_Cost_File, "w");
+    if (fp == NULL) {
+      WH(-1, "Could not open the Element Cost File for writing");
+    } else {
+      fprintf(fp, "# goma measured element assembly cost\n");
+      fprintf(fp, "# global element, seconds per fill (%d fills)\n",
+	      Num_Fills);
+      for (i = 0; i < n; i++) {
+	fprintf(fp, "%d %.6e\n", gid[i] + 1, cost[i]);
+      }
+      fclose(fp);
+      log_msg("Wrote %d element costs to %s", n, Elem_Cost_File);
+    }
+  }
+
+  safer_free((void **) &gid);
+  safer_free((void **) &cost);
+  safer_free((void **) &Elem_Cost);
+  Num_Cost_Elems = 0;
+}
+
+/*****************************************************************************/
+
+int
+elem_cost_read(char *filename, int num_elems, dbl *cost)
+
+    /*************************************************************************
+     *
+     * elem_cost_read():
+     *
+     *  Read an Element Cost File written by elem_cost_report().  Elements
+     *  that are not listed get a cost of -1.
+     *
+     *  Return: the number of element costs read, or -1 if the file could
+     *          not be opened.
+     *************************************************************************/
+{
+  int e, elem, count = 0;
+  dbl c;
+  char line[MAX_CHAR_IN_INPUT];
+  FILE *fp;
+
+  for (e = 0; e < num_elems; e++) cost[e] = -1.0;
+
+  fp = fopen(filename, "r");
+  if (fp == NULL) return -1;
+
+  while (fgets(line, MAX_CHAR_IN_INPUT, fp) != NULL) {
+    if (line[0] == '#') continue;
+    if (sscanf(line, "%d %lf", &elem, &c) != 2) continue;
+    if (elem < 1 || elem > num_elems || c < 0.0) continue;
+    cost[elem-1] = c;
+    count++;
+  }
+  fclose(fp);
+
+  return count;
+}
+/*****************************************************************************/
+/* END of file mm_elem_cost.c */
+/*****************************************************************************/
@@ -20,6 +20,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
 #include <math.h>
 
 /* GOMA include files */
@@ -93,6 +94,221 @@ PROTO(( Exo_DB*,                 /* Exodus database pointer */
 	double *));              /* element stiffness Matrix for frontal solver*/
 static void zero_lec(void);
 
+/*
+ * Preconditioner Matrix: while on, Jacobian assemblies build the
+ * simplified matrix the matrix-free Newton solve preconditions with.
+ */
+static int Precond_Fill = FALSE;
+static void precond_drop_lec(void);
+
+/*
+ * Mesh Segregation: the unknowns the fills of the Newton step in hand
+ * solve for. The rows of the others become x_i = const.
+ */
+static int Mesh_Seg_Phase = MESH_SEG_OFF;
+
+/*
+ * Contact angle conditions of the matrix_fill() assemblies: filled in by
+ * apply_special_bc() over the whole element loop, and checked once it is
+ * done by contact_angle_check().
+ */
+static int Fill_CA_id[MAX_CA];		/* array of CA conditions */
+static int Fill_CA_fselem[MAX_CA];	/* array of CA free surface elements */
+static int Fill_CA_sselem[MAX_CA];	/* array of CA solid surface elements */
+static int Fill_CA_proc[MAX_CA];	/* Processor which has each CA */
+static void contact_angle_check
+PROTO(( void ));
+
+/* Per element flags of the only elements matrix_fill_full() fills, NULL all */
+static const int *Fill_Elem_Subset = NULL;
+
+/* Per row flags of the unknowns the fills hold fixed, NULL none */
+static const int *Fill_Frozen_Rows = NULL;
+static void mesh_segregation_rows
+PROTO(( struct Aztec_Linear_Solver_System *,
+	double [] ));		/* resid_vector */
+static void frozen_rows_identity
+PROTO(( struct Aztec_Linear_Solver_System *,
+	double [] ));		/* resid_vector */
+
+/*
+ * Element scatter maps (Element Scatter Map = yes).
+ *
+ * For each element, the positions in the global matrix that load_lec()
+ * located with in_list() are recorded the first time the element is
+ * loaded and replayed thereafter, in the same order. A replayed position
+ * is only used if it still lies in the right row and column, so a map
+ * that has gone stale (new matrix graph, different dof traversal) just
+ * falls back to the search and re-records itself from that point on.
+ */
+typedef struct Elem_Scatter_Map {
+  int *index;			/* recorded ija[] or bindx[] positions */
+  int len;			/* number of valid recorded positions */
+  int size;			/* allocated length of index[] */
+} ELEM_SCATTER_MAP;
+
+static ELEM_SCATTER_MAP *Elem_Scatter_Maps = NULL;
+static int Num_Elem_Scatter_Maps = 0;
+
+static void elem_scatter_map_init
+PROTO(( Exo_DB * ));
+
+static int elem_scatter_lookup
+PROTO(( ELEM_SCATTER_MAP *,	/* map - element map, NULL if unused */
+	int *,			/* cursor - position in the map */
+	const int,		/* col - column (block column) to find */
+	const int,		/* start - first entry of the row */
+	const int,		/* end - one past the last entry of the row */
+	int * ));		/* list - ija[] or bindx[] */
+
+/*
+ * Selective Reassembly (MSR only).
+ *
+ * load_lec() records the residual and Jacobian values each element adds,
+ * with the rows and a[] positions they go to. While the unknowns at the
+ * element's nodes have moved less than Selective_Reassembly_Tol since, a
+ * Jacobian fill adds the recorded values again instead of calling
+ * matrix_fill() for it.
+ */
+typedef struct Elem_Fill_Cache {
+  int *row;			/* resid_vector[] rows */
+  double *R;			/* values added to them */
+  int nR;
+  int sizeR;
+  int *pos;			/* a[] positions */
+  double *J;			/* values added to them */
+  int nJ;
+  int sizeJ;
+  int valid;			/* holds the last complete load of the element */
+  double drift;			/* relative change of its unknowns since */
+} ELEM_FILL_CACHE;
+
+static ELEM_FILL_CACHE *Elem_Fill_Caches = NULL;
+static int Num_Elem_Fill_Caches = 0;
+static ELEM_FILL_CACHE *Fill_Record = NULL; /* what load_lec() records into */
+
+int Finite_Check_Elements = TRUE;	/* CHECKFINITE() after each assembly */
+static int any_nonfinite
+PROTO((const double *,
+       const int ));
+
+static int reassembly_begin
+PROTO(( struct Aztec_Linear_Solver_System *,
+	double [],		/* x */
+	double [],		/* xdot */
+	const double ,		/* delta_t */
+	const double ,		/* theta */
+	const double ,		/* time_value */
+	Exo_DB * ));
+
+static void elem_fill_cache_add
+PROTO(( ELEM_FILL_CACHE *,
+	const int ,		/* jac - TRUE for an a[] position */
+	const int ,		/* k - row or position */
+	const double ));	/* value */
+
+
+/*
+ * Elements that read the external (halo) part of x (Overlap Exchange = yes).
+ * Elem_Halo[e] is TRUE if element e has a node owned by another processor.
+ * While the halo exchange of x started by exchange_dof_begin() is in
+ * flight, matrix_fill_full() assembles the other elements, then finishes
+ * the exchange and assembles these.
+ */
+static int *Elem_Halo = NULL;
+static int Num_Elem_Halo = 0;
+
+static int *elem_halo_flags
+PROTO(( Exo_DB *,
+	Dpi * ));
+
+/*
+ * Element-local finite difference Jacobian (Element Numerical Jacobian).
+ *
+ * When matrix_fill() is asked for the Jacobian of an element, it first
+ * hands the element to elem_fd_columns(), which assembles it residual-only
+ * at x, and again with each local unknown perturbed in turn, and keeps the
+ * differences of the rows of the chosen equations. After the normal
+ * analytic assembly, elem_fd_load() writes them over those rows of lec->J
+ * just before load_lec(). The inner residual-only calls are flagged by
+ * Elem_FD_Pass and stop short of load_lec(). The cost is one residual
+ * assembly of the element per local unknown.
+ */
+static int Elem_FD_Pass = FALSE;	/* inside an elem_fd_columns() pass */
+static int Elem_FD_Ready = FALSE;	/* columns waiting for elem_fd_load() */
+static int Elem_FD_Nrow = 0;		/* rows being differenced */
+static int Elem_FD_Ncol = 0;		/* local unknowns perturbed */
+static int Elem_FD_Size = 0;		/* allocated length of Elem_FD_J */
+static int *Elem_FD_Row_Eqn = NULL;	/* [row] peqn, then local dof */
+static int *Elem_FD_Row_Dof = NULL;
+static int *Elem_FD_Col_Var = NULL;	/* [col] pvar, then local dof */
+static int *Elem_FD_Col_Dof = NULL;
+static int *Elem_FD_Col_Unk = NULL;	/* [col] processor unknown */
+static dbl *Elem_FD_Col_Scale = NULL;	/* [col] typical size of the unknown */
+static dbl *Elem_FD_R0 = NULL;		/* [row] unperturbed residual */
+static dbl *Elem_FD_J = NULL;		/* [col*Elem_FD_Nrow + row] */
+#ifdef _OPENMP
+#pragma omp threadprivate(Elem_FD_Pass, Elem_FD_Ready, Elem_FD_Nrow,	\
+			 Elem_FD_Ncol, Elem_FD_Size, Elem_FD_Row_Eqn,	\
+			 Elem_FD_Row_Dof, Elem_FD_Col_Var, Elem_FD_Col_Dof, \
+			 Elem_FD_Col_Unk, Elem_FD_Col_Scale, Elem_FD_R0, \
+			 Elem_FD_J)
+#endif
+
+/*
+ * Mesh Stiffness Lag.
+ *
+ * The mesh-mesh block that assemble_mesh() adds to the element Jacobian
+ * is kept for each element and, for Mesh_Stiffness_Lag - 1 Jacobian
+ * assemblies after the one that computed it, put back in place of a new
+ * one. The mesh residual is always exact, so only the Newton rate is
+ * affected; the couplings of the mesh equations to other variables are
+ * left out of the lagged Jacobians. A change of time step size, or any
+ * stability or LOCA fill, computes the block afresh.
+ */
+static int Mesh_Lag_Active = FALSE;	/* this fill lags the mesh stiffness */
+static int Mesh_Lag_Refresh = FALSE;	/* ... and computes it this time */
+static int Mesh_Lag_Fills = 0;		/* Jacobian fills since the refresh */
+static dbl Mesh_Lag_dt = 0.;
+static dbl **Mesh_Lag_J = NULL;		/* [ielem] mesh-mesh block or NULL */
+static int Mesh_Lag_Reuse = FALSE;	/* the element in hand uses its block */
+#ifdef _OPENMP
+#pragma omp threadprivate(Mesh_Lag_Reuse)
+#endif
+
+static void mesh_lag_begin
+PROTO(( Exo_DB *,
+	const dbl ));		/* delta_t */
+
+static void mesh_lag_element
+PROTO(( const int ));		/* ielem */
+
+static int elem_fd_active
+PROTO(( void ));
+
+static int elem_fd_columns
+PROTO(( struct Aztec_Linear_Solver_System *,
+	double [],		/* x - Solution vector */
+	double [],		/* resid_vector - Residual vector */
+	double [],		/* x_old */
+	double [],		/* x_older */
+	double [],		/* xdot */
+	double [],		/* xdot_old */
+	double [],		/* x_update */
+	double *,		/* ptr_delta_t */
+	double *,		/* ptr_theta */
+	struct elem_side_bc_struct *[],
+	double *,		/* ptr_time_value */
+	Exo_DB *,
+	Dpi *,
+	int *,			/* ptr_ielem */
+	int *,			/* ptr_num_total_nodes */
+	dbl *,			/* ptr_h_elem_avg */
+	dbl *,			/* ptr_U_norm */
+	dbl * ));		/* estifm */
+
+static void elem_fd_load
+PROTO(( void ));
 
 /*****************************************************************************/
 /*****************************************************************************/
@@ -137,8 +353,17 @@ int matrix_fill_full(struct Aztec_Linear_Solver_System *ams,
   int ielem=0, e_start=0, e_end=0, ebn=0 ;
   char yo[] = "matrix_fill_full";
   extern int PRS_mat_ielem;
-  int err, err_global;
-  
+  int err;
+  int i_neg, i_lub, i_detJ, i_err;
+  int pass;
+  int *halo = NULL;
+  dbl t_elem = 0.0;
+  int reassemble, num_reused = 0, k;
+  ELEM_FILL_CACHE *cache;
+#ifdef CHECK_FINITE
+  int fast_finite, nonfinite = FALSE, i_nonfinite;
+#endif
+
 #define debug_subelement_decomposition 0
 #if debug_subelement_decomposition
   if ( ls != NULL && ls->SubElemIntegration ) subelement_mesh_output(x, exo);
@@ -152,8 +377,28 @@ int matrix_fill_full(struct Aztec_Linear_Solver_System *ams,
     }
 #endif
 
+  /*
+   * Overlap the halo exchange of x with the assembly of the elements that
+   * do not need it, unless the first element needs it (it does the
+   * once-per-fill setup in matrix_fill()) or this problem reads x away
+   * from the element's own nodes.
+   */
+  if (exchange_pending()) {
+    if (Linear_Solver != FRONT && ls == NULL && pfd == NULL &&
+	xfem == NULL && num_shell_blocks == 0 &&
+	!assembly_threads_active(exo)) {
+      halo = elem_halo_flags(exo, dpi);
+      if (halo[exo->eb_ptr[0]]) halo = NULL;
+    }
+    if (halo == NULL) exchange_dof_end();
+  }
+
+  /* explicit curvature and normal of the level set, from this x */
+  if ( ls != NULL && ls->Curvature_Projection == LS_CURV_PROJ_LUMPED )
+    ls_project_curvature(exo, dpi, x);
+
   if ( xfem != NULL )
-    clear_xfem_contribution( ams->npu );
+    clear_xfem_contribution( ams->npu, x, exo );
     
 #define DEBUG_LS_INTEGRATION 0
 #if DEBUG_LS_INTEGRATION
@@ -174,35 +419,105 @@ int matrix_fill_full(struct Aztec_Linear_Solver_System *ams,
    * Loop over all of the elements one a time. Obtain their
    * element contributions to the global matrix
    *
-   * -> This would be a good spot to loop over each element block instead
-   *    Then allocate memory here for common data elements
+   * Elements are numbered block by block, so the block index just
+   * follows ielem; within a block bf_mp_init() keeps the basis pointers
+   * of the previous element.
    */
   neg_elem_volume = FALSE;
   neg_lub_height = FALSE;
   zero_detJ = FALSE;
 
+  if (Elem_Scatter_Map) elem_scatter_map_init(exo);
+  geom_cache_init(exo);
+  condense_record_init(exo);
+  h_elem_cache_init(exo);
+  mesh_lag_begin(exo, *ptr_delta_t);
+
   e_start = exo->eb_ptr[0];
   e_end   = exo->eb_ptr[exo->num_elem_blocks];
-  
+
+  elem_cost_fill_begin(exo);
+
+  reassemble = reassembly_begin(ams, x, xdot, *ptr_delta_t, *ptr_theta,
+				*ptr_time_value, exo);
+
+#ifdef CHECK_FINITE
+  fast_finite = (Linear_Solver != FRONT && strcmp(Matrix_Format, "msr") == 0);
+  if (fast_finite) Finite_Check_Elements = FALSE;
+#endif
+
+  /*
+   * Colored, thread-parallel element loop (Assembly Threads > 1)
+   */
+  err = 0;
+  if (assembly_threads_active(exo) && Fill_Elem_Subset == NULL && !reassemble) {
+    err = matrix_fill_threaded(ams, x, resid_vector, x_old, x_older, xdot, xdot_old,
+			       x_update, ptr_delta_t, ptr_theta, first_elem_side_BC_array,
+			       ptr_time_value, exo, dpi, ptr_num_total_nodes,
+			       ptr_h_elem_avg, ptr_U_norm, estifm);
+    e_end = e_start;
+  }
+
+  /*
+   * Without an exchange in flight this is one pass over all the elements.
+   * Otherwise the first pass does the elements without halo nodes and the
+   * second pass the rest, once the exchange is done.
+   */
+  for (pass = 0; pass < 2 && !err; pass++) {
+
   for (ielem = e_start, ebn = 0; ielem < e_end && !neg_elem_volume && !neg_lub_height && !zero_detJ; ielem++) {
 
+    if (halo != NULL && halo[ielem] != pass) continue;
+    if (Fill_Elem_Subset != NULL && !Fill_Elem_Subset[ielem]) continue;
+
     /*First we must calculate the material-referenced element
      *number so as to be compatible with the ElemStorage struct
      */
-    ebn = find_elemblock_index(ielem, exo);
+    while (ielem >= exo->eb_ptr[ebn+1]) ebn++;
     int mn = Matilda[ebn];
     if (mn < 0) {
       continue;
     }
 
     /*needed for saturation hyst. func. */
-    PRS_mat_ielem = ielem - exo->eb_ptr[ebn]; 
-    
+    PRS_mat_ielem = ielem - exo->eb_ptr[ebn];
+
+    /*
+     * Selective Reassembly: add what a quiescent element loaded last time.
+     * Elements with boundary conditions, and the first and last elements
+     * (matrix_fill() does its once-per-fill work on them), are always
+     * assembled.
+     */
+    cache = NULL;
+    if (reassemble) {
+      cache = Elem_Fill_Caches + ielem;
+      if (cache->valid && first_elem_side_BC_array[ielem] == NULL &&
+	  ielem != e_start && ielem != e_end - 1) {
+	for (k = 0; k < cache->nR; k++) resid_vector[cache->row[k]] += cache->R[k];
+	for (k = 0; k < cache->nJ; k++) ams->val[cache->pos[k]] += cache->J[k];
+	num_reused++;
+	continue;
+      }
+      cache->valid = FALSE;
+      cache->nR = cache->nJ = 0;
+      cache->drift = 0.0;
+      Fill_Record = cache;
+    }
+
+    if (Elem_Cost != NULL) t_elem = elem_cost_clock();
+
     err = matrix_fill(ams, x, resid_vector, x_old, x_older, xdot, xdot_old, x_update,
 		      ptr_delta_t, ptr_theta, first_elem_side_BC_array,
 		      ptr_time_value, exo, dpi, &ielem, ptr_num_total_nodes,
 		      ptr_h_elem_avg, ptr_U_norm, estifm, 0);
 
+    if (Elem_Cost != NULL) Elem_Cost[ielem] += elem_cost_clock() - t_elem;
+
+    Fill_Record = NULL;
+    if (cache != NULL && !err && !neg_elem_volume && !neg_lub_height && !zero_detJ) {
+      cache->valid = TRUE;
+    }
+
     if (err) break;
   
     if (neg_elem_volume) {
@@ -222,33 +537,69 @@ int matrix_fill_full(struct Aztec_Linear_Solver_System *ams,
 
   }
 
+  if (halo == NULL) break;
+  exchange_dof_end();
+  }
+
+  /* never leave the exchange outstanding, even after an early exit */
+  exchange_dof_end();
+
   /*
-   * Free memory allocated above
-   */
-  global_qp_storage_destroy();
-  
-  /*
-   * Now coordinate the processors so that they all know about a negative or zero
-   * volume in an element and negative lubrication height
+   * Only now are the contact angle conditions of all the elements in,
+   * whichever pass or thread assembled the last element.
    */
-#ifdef PARALLEL
-  MPI_Allreduce(&neg_elem_volume, &neg_elem_volume_global, 1,
-		MPI_INT, MPI_MAX, MPI_COMM_WORLD);
-  neg_elem_volume = neg_elem_volume_global;
+  {
+    int e_last = exo->eb_ptr[exo->num_elem_blocks] - 1;
+    if (Linear_Solver != FRONT && !err && !neg_elem_volume &&
+	!neg_lub_height && !zero_detJ && e_last >= 0 && Matilda[exo->num_elem_blocks-1] >= 0 &&
+	(Fill_Elem_Subset == NULL || Fill_Elem_Subset[e_last])) {
+      contact_angle_check();
+    }
+  }
 
-  MPI_Allreduce(&neg_lub_height, &neg_lub_height_global, 1,
-                MPI_INT, MPI_MAX, MPI_COMM_WORLD);
-  neg_lub_height = neg_lub_height_global;
+  elem_cost_fill_end();
 
-  MPI_Allreduce(&zero_detJ, &zero_detJ_global, 1,
-                MPI_INT, MPI_MAX, MPI_COMM_WORLD);
-  zero_detJ = zero_detJ_global;
+  if (reassemble && Debug_Flag) {
+    DPRINTF(stdout, "%s: %d of %d elements reused\n", yo, num_reused,
+	    e_end - e_start);
+  }
 
-  MPI_Allreduce(&err, &err_global, 1,
-                MPI_INT, MPI_SUM, MPI_COMM_WORLD);
-  err = err_global;
+#ifdef CHECK_FINITE
+  /* one sweep over everything assembled, instead of after each term */
+  if (fast_finite) {
+    Finite_Check_Elements = TRUE;
+    if (!err) {
+      nonfinite = (any_nonfinite(resid_vector, ams->npu) ||
+		   any_nonfinite(ams->val, ams->bindx[ams->npu]));
+    }
+  }
+#endif
 
+  /*
+   * Now coordinate the processors so that they all know about a negative or zero
+   * volume in an element and negative lubrication height. The four flags
+   * go out in one reduction, which completes while the quadrature point
+   * storage is freed.
+   */
+  gstatus_begin();
+  i_neg  = gstatus_add(GSTATUS_MAX, neg_elem_volume);
+  i_lub  = gstatus_add(GSTATUS_MAX, neg_lub_height);
+  i_detJ = gstatus_add(GSTATUS_MAX, zero_detJ);
+  i_err  = gstatus_add(GSTATUS_MAX, (err != 0));
+#ifdef CHECK_FINITE
+  i_nonfinite = gstatus_add(GSTATUS_MAX, nonfinite);
 #endif
+  gstatus_start();
+
+  /*
+   * Clear the quadrature point storage for the next fill
+   */
+  global_qp_storage_reset();
+
+  neg_elem_volume = neg_elem_volume_global = (int) gstatus_get(i_neg);
+  neg_lub_height  = neg_lub_height_global  = (int) gstatus_get(i_lub);
+  zero_detJ       = zero_detJ_global       = (int) gstatus_get(i_detJ);
+  err             = (int) gstatus_get(i_err);
 
   if (err) return -1;
   
@@ -272,6 +623,41 @@ int matrix_fill_full(struct Aztec_Linear_Solver_System *ams,
   if (neg_lub_height) return -1;
   if (zero_detJ) return -1;
 
+#ifdef CHECK_FINITE
+  if ((int) gstatus_get(i_nonfinite)) {
+    /*
+     * Assemble again, checking each element, to report the first one
+     * with a non-finite entry. None of it is kept.
+     */
+    if (nonfinite) {
+      e_end = exo->eb_ptr[exo->num_elem_blocks];
+      for (ielem = e_start, ebn = 0; ielem < e_end; ielem++) {
+	if (Fill_Elem_Subset != NULL && !Fill_Elem_Subset[ielem]) continue;
+	while (ielem >= exo->eb_ptr[ebn+1]) ebn++;
+	if (Matilda[ebn] < 0) continue;
+	PRS_mat_ielem = ielem - exo->eb_ptr[ebn];
+	err = matrix_fill(ams, x, resid_vector, x_old, x_older, xdot, xdot_old, x_update,
+			  ptr_delta_t, ptr_theta, first_elem_side_BC_array,
+			  ptr_time_value, exo, dpi, &ielem, ptr_num_total_nodes,
+			  ptr_h_elem_avg, ptr_U_norm, estifm, 0);
+	if (err || neg_elem_volume || neg_lub_height || zero_detJ) break;
+      }
+      if (ielem < e_end) {
+	log_msg("Non-finite entry assembled in element (%d)", ielem+1);
+      } else {
+	log_msg("Non-finite entry assembled, but not by any element alone");
+      }
+    }
+    for (k = 0; reassemble && k < Num_Elem_Fill_Caches; k++) {
+      Elem_Fill_Caches[k].valid = FALSE;
+    }
+    return -1;
+  }
+#endif
+
+  if (Periodic_Native) periodic_fold(ams, x, resid_vector);
+  if (Mesh_Seg_Phase != MESH_SEG_OFF) mesh_segregation_rows(ams, resid_vector);
+  if (Fill_Frozen_Rows != NULL) frozen_rows_identity(ams, resid_vector);
 
   return 0;
 }
@@ -332,11 +718,6 @@ matrix_fill(
 				/* iteration is not recommended*/
 #endif
 
-  static int CA_id[MAX_CA];            /*  array of CA conditions */
-  static int CA_fselem[MAX_CA];        /*  array of CA free surface elements  */
-  static int CA_sselem[MAX_CA];        /*  array of CA solid surface elements */
-  static int CA_proc[MAX_CA];          /*  Processor which has each CA */
-
   int mn;                     /* material block counter */
   int err;		      /* temp variable to hold diagnostic flags.      */
   int ip;                     /* ip is the local quadrature point index       */
@@ -393,6 +774,12 @@ matrix_fill(
   struct Petrov_Galerkin_Data pg_data;
 
   struct Porous_Media_Terms pm_terms;  /*Needed up here for Hysteresis switching criterion*/
+  int fuse_pp;			/* add this element to the fused post processing */
+  int eqm_jac, eqm_ngp;		/* incremental Jacobian quality metric */
+  int rq_type, rq_mesh, rq_cont; /* Reduced Quadrature rule and equations */
+  int ip_reduced;		/* quadrature points of rq_type, 0 if unused */
+  double eqm_Jw_min, eqm_Jw_sum;
+  dbl kb_t0 = 0.;		/* start of a Kernel Benchmark call */
 
   struct elem_side_bc_struct *elem_side_bc ;
   /* Pointer to an element side boundary condition
@@ -417,6 +804,7 @@ matrix_fill(
   int discontinuous_stress; /* flag that tells you if you are doing Discontinuous Galerkin 
 			       for the species equations */
   int ielem_type_mass = -1;	/* flag to give discontinuous interpolation type */
+  int condense;			/* element matrix may be condensed */
 
   int pspg_local = 0;
   
@@ -428,6 +816,9 @@ matrix_fill(
   struct Level_Set_Data *ls_old;
 
   static double mm_fill_start, mm_fill_end; /* Count CPU time this call. */
+#ifdef _OPENMP
+#pragma omp threadprivate(mm_fill_start, mm_fill_end)
+#endif
 
   static char yo[] = "matrix_fill"; /* My name to take blame... */
   
@@ -437,6 +828,22 @@ matrix_fill(
    * BEGINNING OF EXECUTABLE STATEMENTS 
    */
 
+  /*
+   * Element Numerical Jacobian: difference the element's residual first,
+   * its analytic Jacobian is then assembled as usual below
+   */
+  if (!Elem_FD_Pass && af->Assemble_Jacobian &&
+      !af->Assemble_LSA_Jacobian_Matrix && !af->Assemble_LSA_Mass_Matrix &&
+      elem_fd_active())
+    {
+      err = elem_fd_columns(ams, x, resid_vector, x_old, x_older, xdot,
+			    xdot_old, x_update, ptr_delta_t, ptr_theta,
+			    first_elem_side_BC_array, ptr_time_value, exo, dpi,
+			    ptr_ielem, ptr_num_total_nodes, ptr_h_elem_avg,
+			    ptr_U_norm, estifm);
+      if (err) return -1;
+    }
+
   mm_fill_start = ut();
 
   /*
@@ -504,10 +911,10 @@ matrix_fill(
                                                     (Linear_Solver == FRONT && ielem == exo->elem_order_map[0]-1))))
     {
       int nsp, nspk, count=-1;
-      memset( CA_fselem, -1, sizeof(int)*MAX_CA);
-      memset( CA_sselem, -1, sizeof(int)*MAX_CA);
-      memset( CA_id, -1, sizeof(int)*MAX_CA);
-      memset( CA_proc, -1, sizeof(int)*MAX_CA);
+      memset( Fill_CA_fselem, -1, sizeof(int)*MAX_CA);
+      memset( Fill_CA_sselem, -1, sizeof(int)*MAX_CA);
+      memset( Fill_CA_id, -1, sizeof(int)*MAX_CA);
+      memset( Fill_CA_proc, -1, sizeof(int)*MAX_CA);
       for (j = 0;j < Num_BC;j++)
 	{
 	  switch (BC_Types[j].BC_Name)
@@ -523,7 +930,7 @@ matrix_fill(
                  if(nsp != -1 && Nodes[nspk]->Proc == ProcID)
                      {
                        count++;
-                       CA_proc[count] = ProcID;
+                       Fill_CA_proc[count] = ProcID;
                      }
 	      break;
 	    }
@@ -562,6 +969,9 @@ matrix_fill(
   mn = ei->mn;
   pde = (int*) pd->e;
 
+  /* rows put_dirichlet_in_matrix() will overwrite need not be assembled */
+  mark_dirichlet_rows(num_total_nodes, first_elem_side_BC_array[ielem]);
+
   
   for ( mode=0; mode<vn->modes; mode++)
     {
@@ -1095,7 +1505,7 @@ matrix_fill(
 	   * we really need this information...
 	   */
       
-	  if ( pde[R_MESH1] )
+	  if ( pde[R_MESH1] && af->Assemble_Jacobian )
 	    {
 	      err = load_bf_mesh_derivs(); 
 	      EH( err, "load_bf_mesh_derivs");
@@ -1108,7 +1518,15 @@ matrix_fill(
 	  err = load_fv_grads();
 	  EH( err, "load_fv_grads");	  
             
-	  if ( pde[R_MESH1] )
+	  /*
+	   * The field variable mesh derivatives only reach the equations
+	   * other than the mesh, whose mesh columns the no_mesh_coupling
+	   * Preconditioner Matrix drops anyway, unless the mesh equation
+	   * is a solid's.
+	   */
+	  if ( pde[R_MESH1] && af->Assemble_Jacobian &&
+	       !(Precond_Fill && Precond_Matrix == PRECOND_MATRIX_NO_MESH &&
+		 cr->MeshMotion == ARBITRARY) )
 	    {
 	      err = load_fv_mesh_derivs(1);
 	      EH( err, "load_fv_mesh_derivs");
@@ -1178,6 +1596,7 @@ matrix_fill(
       /******************************************************************************/
     }
   /* END  for (ip = 0; ip < ip_total; ip++)                               */  
+  viscosity_qp_cache(FALSE);
   
   /******************************************************************************/
   /*                              BLOCK 2.0b                                    */
@@ -1185,6 +1604,33 @@ matrix_fill(
   /*                FOR EQNS THAT MIGHT DEPEND ON LEVEL SET FUNCTIONS           */
   /******************************************************************************/
 
+  timer_push("volume");
+
+  /*
+   * Fused Post Processing sums the nodal fields at the quadrature points
+   * of this loop; it has no porous media terms and no cut element rules,
+   * so such elements leave it to post_process_nodal().
+   */
+  fuse_pp = (!Elem_FD_Pass && fused_post_proc_active());
+  if (fuse_pp && ((ls != NULL && ls->elem_overlap_state) ||
+		  mp->PorousMediaType != CONTINUOUS))
+    {
+      fused_post_proc_skip();
+      fuse_pp = FALSE;
+    }
+
+  /*
+   * Element quality incremental takes the Jacobian metric of this
+   * element from the detJ of this loop, as jacobian_metric() would
+   * compute it, when the loop is the plain Gauss rule.
+   */
+  eqm_jac = (nEQM > 0 && eqm->do_jac && eqm->incremental &&
+	     af->Assemble_Residual && !Elem_FD_Pass && ielem_dim == 2 &&
+	     (ls == NULL || !ls->elem_overlap_state));
+  eqm_ngp = 0;
+  eqm_Jw_min = 0.0;
+  eqm_Jw_sum = 0.0;
+
   if ( ls == NULL || !ls->elem_overlap_state )
     {
       /* case 1: normal gauss integration */
@@ -1241,6 +1687,35 @@ matrix_fill(
     {
       EH(-1,"Unrecognized integration scheme!");
     }
+
+  /*
+   * Reduced Quadrature: the selected mesh and continuity equations of a
+   * quadratic element are left out of the loop below and integrated by
+   * the one after it, over the Gauss points of the linear element of the
+   * same shape. Only with plain Gauss integration, and not for models
+   * that keep state at the element's own quadrature points.
+   */
+  rq_type = reduced_quad_type(ielem_type);
+  rq_mesh = rq_cont = FALSE;
+  if (Reduced_Quadrature && rq_type != ielem_type &&
+      (ls == NULL || !ls->elem_overlap_state) && xfem == NULL &&
+      mp->PorousMediaType == CONTINUOUS)
+    {
+      rq_mesh = (Reduced_Quad_Eqn[R_MESH1] && pde[R_MESH1] &&
+		 !pde[R_SHELL_CURVATURE] && !pde[R_SHELL_TENSION] &&
+		 evpl->ConstitutiveEquation == NO_MODEL &&
+		 elc->thermal_expansion_model != SHRINKAGE);
+      rq_cont = (Reduced_Quad_Eqn[R_PRESSURE] && pde[R_PRESSURE]);
+    }
+  ip_reduced = (rq_mesh || rq_cont) ? elem_info(NQUAD, rq_type) : 0;
+
+  /* Mesh Stiffness Lag: reuse this element's mesh block if it has one */
+  Mesh_Lag_Reuse = (Mesh_Lag_Active && !Mesh_Lag_Refresh && af->Assemble_Jacobian &&
+		    pde[R_MESH1] && Mesh_Lag_J[ielem] != NULL);
+
+  /* Property Plugin: all the Gauss points of the element in one call */
+  plugin_element_begin((ls == NULL || !ls->elem_overlap_state) ? ip_total : 0,
+		       ielem_type, bfd, time_value);
   
   /* Loop over all the Volume Quadrature integration points */
 
@@ -1355,7 +1830,9 @@ matrix_fill(
        * of local element coordinates.
        */
 
+      KB_START(kb_t0);
       err = load_basis_functions(xi, bfd);
+      KB_STOP(KB_LOAD_BASIS, kb_t0);
       EH( err, "problem from load_basis_functions");
 
       /*
@@ -1368,10 +1845,20 @@ matrix_fill(
        * That is done in load_fv.
        */
       
+      KB_START(kb_t0);
       err = beer_belly();
+      KB_STOP(KB_BEER_BELLY, kb_t0);
       EH(err, "beer_belly");
       if (neg_elem_volume) return -1;
       if( zero_detJ ) return -1;
+
+      if (eqm_jac)
+	{
+	  double Jw = fabs(bf[pd->ShapeVar]->detJ) * wt;
+	  if (eqm_ngp == 0 || Jw < eqm_Jw_min) eqm_Jw_min = Jw;
+	  eqm_Jw_sum += Jw;
+	  eqm_ngp++;
+	}
       
       /*
        * Load up field variable values at this Gauss point, but not
@@ -1380,7 +1867,9 @@ matrix_fill(
        * grad_(e_a) tensor... which is nontrivial in cylindrical 
        * coordinates.
        */
+      KB_START(kb_t0);
       err = load_fv();
+      KB_STOP(KB_LOAD_FV, kb_t0);
       EH( err, "load_fv");
        
       /*
@@ -1401,7 +1890,8 @@ matrix_fill(
        * we really need this information...
        */
       
-      if (pde[R_MESH1] || pd->v[R_MESH1])
+      if ((pde[R_MESH1] || pd->v[R_MESH1]) && af->Assemble_Jacobian &&
+	  Mesh_Seg_Phase != MESH_SEG_FLOW)
 	{
 	  err = load_bf_mesh_derivs(); 
 	  EH( err, "load_bf_mesh_derivs");
@@ -1411,12 +1901,20 @@ matrix_fill(
        * Load up physical space gradients of field variables at this
        * Gauss point.
        */
+      KB_START(kb_t0);
       err = load_fv_grads();
+      KB_STOP(KB_LOAD_FV_GRADS, kb_t0);
       EH( err, "load_fv_grads");	  
             
-      if ( pde[R_MESH1] ||  pd->v[R_MESH1])
+      /*
+       * Neither are needed while segregated flow steps hold the mesh.
+       */
+      if ((pde[R_MESH1] || pd->v[R_MESH1]) && af->Assemble_Jacobian &&
+	  Mesh_Seg_Phase != MESH_SEG_FLOW)
 	{
+	  KB_START(kb_t0);
 	  err = load_fv_mesh_derivs(1);
+	  KB_STOP(KB_LOAD_FV_MESH, kb_t0);
 	  EH( err, "load_fv_mesh_derivs");
 	}
 
@@ -1465,6 +1963,13 @@ matrix_fill(
 	  compute_xfem_contribution( ams->npu );
 	}
 
+      if (fuse_pp)
+	{
+	  err = fused_post_proc_ip(delta_t, theta, ielem, ielem_type, ip,
+				   ip_total, time_value, exo, xi);
+	  EH(err, "fused_post_proc_ip");
+	}
+
       /* QUESTION
        * Since we are already at a gauss point and have calculated
        * all the field variables and their derivatives, shouldn't
@@ -1476,6 +1981,7 @@ matrix_fill(
        * ANSWER
        * Yes.  Write the source!
        */
+      viscosity_qp_cache(TRUE);
       computeCommonMaterialProps_gp(time_value);
       
       /*
@@ -1516,8 +2022,10 @@ matrix_fill(
 	}
       else if(vn->evssModel==LOG_CONF || vn->evssModel == LOG_CONF_GRADV)
         {
+          KB_START(kb_t0);
           err = assemble_stress_log_conf(theta, delta_t, pg_data.hsquared,
                                      pg_data.hhv, pg_data.dhv_dxnode, pg_data.v_avg, pg_data.dv_dnode);
+          KB_STOP(KB_STRESS_LOG_CONF, kb_t0);
 	  if (err) return -1;
           err = segregate_stress_update( x_update );
           EH(err, "assemble_stress_log_conf");
@@ -1559,7 +2067,8 @@ matrix_fill(
 #endif
 	}
 
-      if (pde[R_MESH1] && !pde[R_SHELL_CURVATURE] && !pde[R_SHELL_TENSION])
+      if (pde[R_MESH1] && !pde[R_SHELL_CURVATURE] && !pde[R_SHELL_TENSION] &&
+	  !rq_mesh && Mesh_Seg_Phase != MESH_SEG_FLOW)
 	{
 	  err = assemble_mesh(time_value, theta, delta_t, ielem, ip, ip_total);
 	  EH(err, "assemble_mesh");
@@ -1637,7 +2146,9 @@ matrix_fill(
       
       if( pde[R_ENERGY] )
 	{
+          KB_START(kb_t0);
           err = assemble_energy(time_value, theta, delta_t, &pg_data);
+          KB_STOP(KB_ENERGY, kb_t0);
 	  EH( err, "assemble_energy");
 #ifdef CHECK_FINITE
 	  err = CHECKFINITE("assemble_energy"); 
@@ -2342,7 +2853,9 @@ matrix_fill(
   }
       if( pde[R_MOMENTUM1] )
 	{
+          KB_START(kb_t0);
           err = assemble_momentum(time_value, theta, delta_t, h_elem_avg, &pg_data, xi, exo);
+          KB_STOP(KB_MOMENTUM, kb_t0);
           EH( err, "assemble_momentum");
 #ifdef CHECK_FINITE
 	  err = CHECKFINITE("assemble_momentum"); 
@@ -2407,9 +2920,11 @@ matrix_fill(
 #endif
 	}
 
-      if( pde[R_PRESSURE] )
+      if( pde[R_PRESSURE] && !rq_cont )
 	{
+	  KB_START(kb_t0);
 	  err = assemble_continuity(time_value, theta, delta_t, &pg_data);
+	  KB_STOP(KB_CONTINUITY, kb_t0);
 	  EH( err, "assemble_continuity");
 #ifdef CHECK_FINITE
 	  err = CHECKFINITE("assemble_continuity"); 
@@ -2518,6 +3033,100 @@ matrix_fill(
       /******************************************************************************/
     }
   /* END  for (ip = 0; ip < ip_total; ip++)                               */  
+  plugin_element_end();
+
+  /*
+   * The Reduced Quadrature equations, with everything they need at a
+   * quadrature point loaded as in the loop above.
+   */
+  for (ip = 0; ip < ip_reduced; ip++)
+    {
+      MMH_ip = ip;
+      find_stu(ip, rq_type, &s, &t, &u);
+      wt = Gq_weight(ip, rq_type);
+
+      xi[0] = s;
+      xi[1] = t;
+      xi[2] = u;
+
+      fv->wt = wt;
+
+      KB_START(kb_t0);
+      err = load_basis_functions(xi, bfd);
+      KB_STOP(KB_LOAD_BASIS, kb_t0);
+      EH( err, "problem from load_basis_functions");
+
+      KB_START(kb_t0);
+      err = beer_belly();
+      KB_STOP(KB_BEER_BELLY, kb_t0);
+      EH(err, "beer_belly");
+      if (neg_elem_volume) return -1;
+      if( zero_detJ ) return -1;
+
+      KB_START(kb_t0);
+      err = load_fv();
+      KB_STOP(KB_LOAD_FV, kb_t0);
+      EH( err, "load_fv");
+
+      err = load_bf_grad();
+      EH( err, "load_bf_grad");
+
+      if ((pde[R_MESH1] || pd->v[R_MESH1]) && af->Assemble_Jacobian &&
+	  Mesh_Seg_Phase != MESH_SEG_FLOW)
+	{
+	  err = load_bf_mesh_derivs(); 
+	  EH( err, "load_bf_mesh_derivs");
+	}
+
+      KB_START(kb_t0);
+      err = load_fv_grads();
+      KB_STOP(KB_LOAD_FV_GRADS, kb_t0);
+      EH( err, "load_fv_grads");	  
+
+      if ((pde[R_MESH1] || pd->v[R_MESH1]) && af->Assemble_Jacobian &&
+	  Mesh_Seg_Phase != MESH_SEG_FLOW)
+	{
+	  KB_START(kb_t0);
+	  err = load_fv_mesh_derivs(1);
+	  KB_STOP(KB_LOAD_FV_MESH, kb_t0);
+	  EH( err, "load_fv_mesh_derivs");
+	}
+
+      viscosity_qp_cache(TRUE);
+      computeCommonMaterialProps_gp(time_value);
+      do_LSA_mods(LSA_VOLUME);
+
+      if (rq_mesh && Mesh_Seg_Phase != MESH_SEG_FLOW)
+	{
+	  err = assemble_mesh(time_value, theta, delta_t, ielem, ip, ip_reduced);
+	  EH(err, "assemble_mesh");
+#ifdef CHECK_FINITE
+	  err = CHECKFINITE("assemble_mesh"); 
+	  if (err) return -1;
+#endif
+          if (neg_elem_volume) return -1;
+	}
+
+      if (rq_cont)
+	{
+	  KB_START(kb_t0);
+	  err = assemble_continuity(time_value, theta, delta_t, &pg_data);
+	  KB_STOP(KB_CONTINUITY, kb_t0);
+	  EH( err, "assemble_continuity");
+#ifdef CHECK_FINITE
+	  err = CHECKFINITE("assemble_continuity"); 
+	  if (err) return -1;
+#endif
+          if( neg_elem_volume ) return -1;
+	}
+    }
+  viscosity_qp_cache(FALSE);
+
+  if (Mesh_Lag_Active && af->Assemble_Jacobian && pde[R_MESH1]) {
+    mesh_lag_element(ielem);
+  }
+
+  if (eqm_jac) element_quality_jac_collect(eqm_ngp, eqm_Jw_min, eqm_Jw_sum);
 
   if ( pde[R_LEVEL_SET] && ls != NULL )
     apply_embedded_colloc_bc( ielem, x, delta_t, theta, time_value,
@@ -2614,6 +3223,8 @@ matrix_fill(
     }
 
 
+  timer_pop("volume");
+
   /**************************************************************************/
   /*                          BLOCK 2'                                      */
   /*                   START OF SURFACE INTEGRATION LOOP                    */
@@ -2679,6 +3290,8 @@ matrix_fill(
     }
 
 
+  timer_push("boundary conditions");
+
   /**************************************************************************
    *                          BLOCK 3 - Weak SURFACE Boundary Conditions
    *                   START OF SURFACE INTEGRATION LOOP                         
@@ -2886,9 +3499,9 @@ matrix_fill(
 	 */
 	I = Proc_Elem_Connect[iconnect_ptr + i]; 
 	if (I < (dpi->num_internal_nodes + dpi->num_boundary_nodes)) {
-	  if (in_list(I, 0, num_mom_rotate, mom_rotate_node) != -1) 
+	  if (mom_rotate_index != NULL && mom_rotate_index[I] != -1)
 	    call_rotate = 1;
-	  if (in_list(I, 0, num_mesh_rotate, mesh_rotate_node) != -1)
+	  if (mesh_rotate_index != NULL && mesh_rotate_index[I] != -1)
 	    call_rotate = 1;
 	}
       }
@@ -3090,7 +3703,7 @@ matrix_fill(
 				   ielem, ip_total, ielem_type, 
 				   num_local_nodes, ielem_dim, iconnect_ptr, 
 				   elem_side_bc, num_total_nodes, SPECIAL,
-				   CA_id, CA_fselem, CA_sselem, exo,
+				   Fill_CA_id, Fill_CA_fselem, Fill_CA_sselem, exo,
 				   time_value);
 	    EH( err, " apply_special_bc");
 #ifdef CHECK_FINITE
@@ -3376,7 +3989,32 @@ matrix_fill(
 
 
 
-  load_lec(exo, ielem, ams, x, resid_vector, estifm);
+  timer_pop("boundary conditions");
+
+  /* the element residual is all an elem_fd_columns() pass wants */
+  if (!Elem_FD_Pass)
+    {
+      if (Elem_FD_Ready) elem_fd_load();
+      condense = condense_lec_begin();
+      if (pd->e[POLYMER_STRESS11] && vn->dg_J_model == CONDENSED_DG)
+	{
+	  if (!discontinuous_stress)
+	    {
+	      EH(-1, "Discontinuous Jacobian Formulation = CONDENSED needs a discontinuous stress interpolation");
+	    }
+	  if (condense)
+	    {
+	      err = condense_stress_lec();
+	      EH(err, "condense_stress_lec");
+	    }
+	}
+      if (Interior_Condensation && condense) (void) condense_interior_lec();
+      if ((Precond_Fill || Mesh_Seg_Phase != MESH_SEG_OFF) &&
+	  af->Assemble_Jacobian) precond_drop_lec();
+      KB_START(kb_t0);
+      load_lec(exo, ielem, ams, x, resid_vector, estifm);
+      KB_STOP(KB_LOAD_LEC, kb_t0);
+    }
 
   /*  if( pfd != NULL && pfd->Use_Constraint == TRUE )
       {
@@ -3394,6 +4032,9 @@ matrix_fill(
    *  free any memory that was allocated on the element level
    */
   mm_fill_end = ut();
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
   mm_fill_total += mm_fill_end - mm_fill_start;
 
   /* 
@@ -3412,49 +4053,64 @@ matrix_fill(
     P0PRINTF("%s: ends\n", yo);
     MMH_ip = -1;
   }
-  if( (Linear_Solver != FRONT && ielem == exo->eb_ptr[exo->num_elem_blocks]-1) 
-      || (Linear_Solver == FRONT && ielem == exo->elem_order_map[exo->num_elem_blocks]-1))
+  /* matrix_fill_full() checks once both of its passes are done */
+  if (Linear_Solver == FRONT && ielem == exo->elem_order_map[exo->num_elem_blocks]-1 &&
+      zeroCA == 0)
     {
-      if (zeroCA == 0) {
-        int count = 0, Num_CAs_done = 0;
-	for (j = 0;j < MAX_CA;j++)
-	  {
-	    if (CA_id[j] == -2) Num_CAs_done++;
-	    if (CA_proc[j] == ProcID) count++;
-	  }
-	
-	if (count != Num_CAs_done)
-	  {
-	    WH(-1,"\nNot all contact angle conditions were applied!\n");
-	    for (j = 0;j < count;j++)
-	  	{
-	          fprintf(stderr,"CA:%d ID:%d fselem:%d sselem:%d Proc:%d\n",j,CA_id[j],CA_fselem[j],CA_sselem[j],CA_proc[j]);
-		}
-	    fprintf(stderr,"Count=%d  Done=%d\n",count,Num_CAs_done);
-	  }
-      }
+      contact_angle_check();
     }
 
   return 0;
 } /*   END OF matrix_fill                                                     */
 /******************************************************************************/
 
+static void
+contact_angle_check(void)
 
-/* matrix_fill_stress is called from numerical_jacobian_compute_stress function
- * and is mainly used for the log-conformation formulation for viscoelastic stress.
- * It is a copy of the matrix_fill function, but only calls assemble_stress.
- */
-int
-matrix_fill_stress(
-	    struct Aztec_Linear_Solver_System *ams,
-	    double x[],			/* Solution vector */
-	    double resid_vector[],		/* Residual vector */
-	    double x_old[],		/* Solution vector , previous last time step */
-	    double x_older[],		/* Solution vector , previous prev time step */
-	    double xdot[],			/* xdot of current solution                  */
-	    double xdot_old[],		/* xdot_old of current solution              */
-	    double x_update[],             /* last update vector */
-	    double *ptr_delta_t,		/* current time step size                    */
+     /**************************************************************************
+      *
+      * contact_angle_check()
+      *
+      *  Warn if a contact angle condition this processor has was not applied
+      *  by the element loop just finished.
+      **************************************************************************/
+{
+  int j, count = 0, Num_CAs_done = 0;
+
+  for (j = 0;j < MAX_CA;j++)
+    {
+      if (Fill_CA_id[j] == -2) Num_CAs_done++;
+      if (Fill_CA_proc[j] == ProcID) count++;
+    }
+
+  if (count != Num_CAs_done)
+    {
+      WH(-1,"\nNot all contact angle conditions were applied!\n");
+      for (j = 0;j < count;j++)
+	{
+	  fprintf(stderr,"CA:%d ID:%d fselem:%d sselem:%d Proc:%d\n",j,Fill_CA_id[j],Fill_CA_fselem[j],Fill_CA_sselem[j],Fill_CA_proc[j]);
+	}
+      fprintf(stderr,"Count=%d  Done=%d\n",count,Num_CAs_done);
+    }
+}
+/******************************************************************************/
+
+
+/* matrix_fill_stress is called from numerical_jacobian_compute_stress function
+ * and is mainly used for the log-conformation formulation for viscoelastic stress.
+ * It is a copy of the matrix_fill function, but only calls assemble_stress.
+ */
+int
+matrix_fill_stress(
+	    struct Aztec_Linear_Solver_System *ams,
+	    double x[],			/* Solution vector */
+	    double resid_vector[],		/* Residual vector */
+	    double x_old[],		/* Solution vector , previous last time step */
+	    double x_older[],		/* Solution vector , previous prev time step */
+	    double xdot[],			/* xdot of current solution                  */
+	    double xdot_old[],		/* xdot_old of current solution              */
+	    double x_update[],             /* last update vector */
+	    double *ptr_delta_t,		/* current time step size                    */
 	    double *ptr_theta,		/* parameter to vary time integration from 
 					 * explicit (theta = 1) to implicit 
 					 * (theta = 0) */
@@ -3567,6 +4223,9 @@ matrix_fill_stress(
   struct Level_Set_Data *ls_old;
 
   static double mm_fill_start, mm_fill_end; /* Count CPU time this call. */
+#ifdef _OPENMP
+#pragma omp threadprivate(mm_fill_start, mm_fill_end)
+#endif
 
   static char yo[] = "matrix_fill"; /* My name to take blame... */
   
@@ -3642,6 +4301,9 @@ matrix_fill_stress(
   mn = ei->mn;
   pde = (int*) pd->e;
 
+  /* rows put_dirichlet_in_matrix() will overwrite need not be assembled */
+  mark_dirichlet_rows(num_total_nodes, first_elem_side_BC_array[ielem]);
+
   
   for ( mode=0; mode<vn->modes; mode++)
     {
@@ -4044,7 +4706,7 @@ matrix_fill_stress(
       err = load_bf_grad();
       EH( err, "load_bf_grad");
       
-      if (pde[R_MESH1] || pd->v[R_MESH1])
+      if ((pde[R_MESH1] || pd->v[R_MESH1]) && af->Assemble_Jacobian)
 	{
 	  err = load_bf_mesh_derivs(); 
 	  EH( err, "load_bf_mesh_derivs");
@@ -4057,12 +4719,13 @@ matrix_fill_stress(
       err = load_fv_grads();
       EH( err, "load_fv_grads");	  
             
-      if ( pde[R_MESH1] ||  pd->v[R_MESH1])
+      if ((pde[R_MESH1] || pd->v[R_MESH1]) && af->Assemble_Jacobian)
 	{
 	  err = load_fv_mesh_derivs(1);
 	  EH( err, "load_fv_mesh_derivs");
 	}
 
+      viscosity_qp_cache(TRUE);
       computeCommonMaterialProps_gp(time_value);
       
       /*
@@ -4219,6 +4882,7 @@ matrix_fill_stress(
       /******************************************************************************/
     }
   /* END  for (ip = 0; ip < ip_total; ip++)                               */  
+  viscosity_qp_cache(FALSE);
 
 
   /**************************************************************************/
@@ -4481,9 +5145,9 @@ matrix_fill_stress(
 	 */
 	I = Proc_Elem_Connect[iconnect_ptr + i]; 
 	if (I < (dpi->num_internal_nodes + dpi->num_boundary_nodes)) {
-	  if (in_list(I, 0, num_mom_rotate, mom_rotate_node) != -1) 
+	  if (mom_rotate_index != NULL && mom_rotate_index[I] != -1)
 	    call_rotate = 1;
-	  if (in_list(I, 0, num_mesh_rotate, mesh_rotate_node) != -1)
+	  if (mesh_rotate_index != NULL && mesh_rotate_index[I] != -1)
 	    call_rotate = 1;
 	}
       }
@@ -4886,6 +5550,9 @@ matrix_fill_stress(
    *  free any memory that was allocated on the element level
    */
   mm_fill_end = ut();
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
   mm_fill_total += mm_fill_end - mm_fill_start;
 
   /* 
@@ -4961,6 +5628,8 @@ load_lec(Exo_DB *exo,		/* ptr to EXODUS II finite element mesh db */
   int je_new;
   NODAL_VARS_STRUCT *nv;
   struct Element_Indices *ei_ptr;
+  ELEM_SCATTER_MAP *map = NULL;
+  int cursor = 0;
 #ifdef DEBUG_LEC
   char lec_name[256], ler_name[256];
   FILE *llll, *rrrr;
@@ -5182,6 +5851,12 @@ load_lec(Exo_DB *exo,		/* ptr to EXODUS II finite element mesh db */
     if (strcmp(Matrix_Format, "msr") == 0) {
       double *a = ams->val;
       int   *ija = ams->bindx;
+      ELEM_FILL_CACHE *rec = Fill_Record;
+
+      if (Elem_Scatter_Maps != NULL && ielem < Num_Elem_Scatter_Maps &&
+	  af->Assemble_Jacobian) {
+	map = Elem_Scatter_Maps + ielem;
+      }
 	  
       for (e = V_FIRST; e < V_LAST; e++) {
 	pe = upd->ep[e];
@@ -5206,6 +5881,7 @@ load_lec(Exo_DB *exo,		/* ptr to EXODUS II finite element mesh db */
 				      ei->matID_ledof[ledof]);
   
                   resid_vector[ie] += lec->R[LEC_R_INDEX(MAX_PROB_VAR + ke,i)];
+                  if (rec != NULL) elem_fill_cache_add(rec, FALSE, ie, lec->R[LEC_R_INDEX(MAX_PROB_VAR + ke,i)]);
 #ifdef DEBUG_LEC
 		  {
                     if (fabs(lec->R[LEC_R_INDEX(MAX_PROB_VAR + ke,i)]) > DBL_SMALL
@@ -5251,10 +5927,11 @@ load_lec(Exo_DB *exo,		/* ptr to EXODUS II finite element mesh db */
 				}
 			      }
 			      EH(je, "Bad var index.");
-			      ja = (ie == je) ?
-				ie : in_list(je, ija[ie], ija[ie+1], ija);
+			      ja = (ie == je) ? ie :
+				elem_scatter_lookup(map, &cursor, je, ija[ie], ija[ie+1], ija);
 			      EH(ja, "Could not find vbl in sparse matrix.");
                               a[ja] += lec->J[LEC_J_INDEX(pe,pv,i,j)];
+                              if (rec != NULL) elem_fill_cache_add(rec, TRUE, ja, lec->J[LEC_J_INDEX(pe,pv,i,j)]);
 
 #ifdef DEBUG_LEC
 			      {
@@ -5285,9 +5962,10 @@ load_lec(Exo_DB *exo,		/* ptr to EXODUS II finite element mesh db */
 			    }
 			    EH(je, "Bad var index.");
 			    ja  = (ie == je) ? ie :
-			      in_list(je, ija[ie], ija[ie+1], ija);
+			      elem_scatter_lookup(map, &cursor, je, ija[ie], ija[ie+1], ija);
 			    EH(ja, "Could not find vbl in sparse matrix.");
                             a[ja] += lec->J[LEC_J_INDEX(pe,pv,i,j)];
+                            if (rec != NULL) elem_fill_cache_add(rec, TRUE, ja, lec->J[LEC_J_INDEX(pe,pv,i,j)]);
 #ifdef DEBUG_LEC
 			    {
                               if (fabs(lec->J[LEC_J_INDEX(pe,pv,i,j)]) > DBL_SMALL ||
@@ -5320,6 +5998,7 @@ load_lec(Exo_DB *exo,		/* ptr to EXODUS II finite element mesh db */
 	      if (ei->owned_ledof[ledof]) {
 		ie = ei->gun_list[e][i];
                 resid_vector[ie] += lec->R[LEC_R_INDEX(pe,i)];
+                if (rec != NULL) elem_fill_cache_add(rec, FALSE, ie, lec->R[LEC_R_INDEX(pe,i)]);
 #ifdef DEBUG_LEC
 		{
                   if (fabs(lec->R[LEC_R_INDEX(pe,i)]) > DBL_SMALL ||
@@ -5368,9 +6047,11 @@ load_lec(Exo_DB *exo,		/* ptr to EXODUS II finite element mesh db */
 			      }
 			    }
 			    EH(je, "Bad var index.");
-			    ja = (ie == je) ? ie : in_list(je, ija[ie], ija[ie+1], ija);
+			    ja = (ie == je) ? ie :
+			      elem_scatter_lookup(map, &cursor, je, ija[ie], ija[ie+1], ija);
 			    EH(ja, "Could not find vbl in sparse matrix.");  
                             a[ja] += lec->J[LEC_J_INDEX(pe,pv,i,j)];
+                            if (rec != NULL) elem_fill_cache_add(rec, TRUE, ja, lec->J[LEC_J_INDEX(pe,pv,i,j)]);
 
 #ifdef DEBUG_LEC
 			    {
@@ -5411,9 +6092,10 @@ load_lec(Exo_DB *exo,		/* ptr to EXODUS II finite element mesh db */
 			  }
 			  EH(je, "Bad var index.");
 			  ja = (ie == je) ? ie :
-			    in_list(je, ija[ie], ija[ie+1], ija);
+			    elem_scatter_lookup(map, &cursor, je, ija[ie], ija[ie+1], ija);
 			  EH(ja, "Could not find vbl in sparse matrix.");
                           a[ja] += lec->J[LEC_J_INDEX(pe,pv,i,j)];
+                          if (rec != NULL) elem_fill_cache_add(rec, TRUE, ja, lec->J[LEC_J_INDEX(pe,pv,i,j)]);
 #ifdef DEBUG_LEC
 			  {
                             if (fabs(lec->J[LEC_J_INDEX(pe,pv,i,j)]) > DBL_SMALL ||
@@ -5450,6 +6132,11 @@ load_lec(Exo_DB *exo,		/* ptr to EXODUS II finite element mesh db */
 	int lec_row, lec_col;
 	double *a_ptr;
 
+	if (Elem_Scatter_Maps != NULL && ielem < Num_Elem_Scatter_Maps &&
+	  af->Assemble_Jacobian) {
+	  map = Elem_Scatter_Maps + ielem;
+	}
+
 	for (i = 0; i < ei->num_local_nodes; i++)
 	  {
 	    /* I is the global row block index, also global node number */
@@ -5495,7 +6182,7 @@ load_lec(Exo_DB *exo,		/* ptr to EXODUS II finite element mesh db */
 						for (j = 0; j < ei_ptr->num_local_nodes; j++)
 						  {
 						    J = Proc_Elem_Connect[ei_ptr->iconnect_ptr + j]; /* J is the global column block index */  
-						    K = in_list(J, bpntr[I], bpntr[I+1], bindx);  /* K is the block index */
+						    K = elem_scatter_lookup(map, &cursor, J, bpntr[I], bpntr[I+1], bindx);  /* K is the block index */
 						    EH(K, " Can't locate column index in bindx ");
 						    a_ptr = a + indx[K]; /* a_ptr points to first entry in val of Kth block */
 			       
@@ -5557,7 +6244,7 @@ load_lec(Exo_DB *exo,		/* ptr to EXODUS II finite element mesh db */
 					    for (j = 0; j < ei_ptr->num_local_nodes; j++)
 					      {
 						J =  Proc_Elem_Connect[ei_ptr->iconnect_ptr + j]; /* J is the global column block index */
-						K = in_list(J, bpntr[I], bpntr[I+1], bindx);  /* K is the block index */
+						K = elem_scatter_lookup(map, &cursor, J, bpntr[I], bpntr[I+1], bindx);  /* K is the block index */
 						EH(K, " Can't locate column index in bindx ");
 						a_ptr = a + indx[K]; /* a_ptr points to first entry in val of Kth block */
 				
@@ -5614,6 +6301,738 @@ load_lec(Exo_DB *exo,		/* ptr to EXODUS II finite element mesh db */
 }
 /****************************************************************************/
 
+static int *
+elem_halo_flags(Exo_DB *exo, Dpi *dpi)
+
+     /**************************************************************************
+      *
+      * elem_halo_flags()
+      *
+      *  Flag the elements with a node past the internal and boundary nodes
+      *  of this processor, i.e. whose x entries come from the halo exchange.
+      **************************************************************************/
+{
+  int e, j;
+  int num_owned_nodes = dpi->num_internal_nodes + dpi->num_boundary_nodes;
+
+  if (Elem_Halo != NULL && Num_Elem_Halo == exo->num_elems) return Elem_Halo;
+
+  safer_free((void **) &Elem_Halo);
+  Num_Elem_Halo = exo->num_elems;
+  Elem_Halo = (int *) smalloc(MAX(Num_Elem_Halo, 1)*sizeof(int));
+
+  for (e = 0; e < Num_Elem_Halo; e++) {
+    Elem_Halo[e] = FALSE;
+    for (j = exo->elem_node_pntr[e]; j < exo->elem_node_pntr[e+1]; j++) {
+      if (exo->elem_node_list[j] >= num_owned_nodes) {
+	Elem_Halo[e] = TRUE;
+	break;
+      }
+    }
+  }
+
+  return Elem_Halo;
+}
+/****************************************************************************/
+
+static void
+elem_scatter_map_init(Exo_DB *exo)
+
+     /**************************************************************************
+      *
+      * elem_scatter_map_init()
+      *
+      *  Allocate the (empty) per-element scatter maps. They are filled in
+      *  by load_lec() on the first Jacobian assembly of each element.
+      **************************************************************************/
+{
+  if (Elem_Scatter_Maps != NULL) return;
+  Num_Elem_Scatter_Maps = exo->num_elems;
+  Elem_Scatter_Maps = (ELEM_SCATTER_MAP *)
+      smalloc(MAX(Num_Elem_Scatter_Maps, 1)*sizeof(ELEM_SCATTER_MAP));
+  memset(Elem_Scatter_Maps, 0, MAX(Num_Elem_Scatter_Maps, 1)*sizeof(ELEM_SCATTER_MAP));
+}
+/****************************************************************************/
+
+static int
+elem_scatter_lookup(ELEM_SCATTER_MAP *map,
+		    int *cursor,
+		    const int col,
+		    const int start,
+		    const int end,
+		    int *list)
+
+     /**************************************************************************
+      *
+      * elem_scatter_lookup()
+      *
+      *  Return the position of col in list[start:end-1], or -1, like
+      *  in_list(). With a map, the next recorded position is tried first;
+      *  it is used only if it still holds col within the row. Otherwise the
+      *  row is searched and the result recorded at the cursor.
+      **************************************************************************/
+{
+  int k;
+
+  if (map == NULL) return in_list(col, start, end, list);
+
+  if (*cursor < map->len) {
+    k = map->index[*cursor];
+    if (k >= start && k < end && list[k] == col) {
+      (*cursor)++;
+      return k;
+    }
+    map->len = *cursor;
+  }
+
+  k = in_list(col, start, end, list);
+  if (k < 0) return k;
+
+  if (map->len >= map->size) {
+    map->size = MAX(2*map->size, 64);
+    map->index = (int *) realloc(map->index, map->size*sizeof(int));
+    if (map->index == NULL) EH(-1, "Out of memory for element scatter map");
+  }
+  map->index[map->len++] = k;
+  (*cursor)++;
+  return k;
+}
+/****************************************************************************/
+
+static int
+reassembly_begin(struct Aztec_Linear_Solver_System *ams,
+		 double x[],
+		 double xdot[],
+		 const double delta_t,
+		 const double theta,
+		 const double time_value,
+		 Exo_DB *exo)
+
+     /**************************************************************************
+      *
+      * reassembly_begin()
+      *
+      *  TRUE if this fill is a Selective Reassembly one: a Jacobian fill of
+      *  the whole MSR matrix, by the serial element loop, that is not one of
+      *  the modified (preconditioner, segregated, LSA) assemblies. Not with
+      *  continuation, hunting or augmenting conditions either, since they
+      *  change parameters that the drift of x cannot see.
+      *
+      *  Each element's drift grows by the largest relative change of x, and
+      *  of delta_t*xdot, at its nodes since the previous such fill; a cache
+      *  whose drift passes the tolerance is dropped, so the element is
+      *  assembled again. All of them are dropped every Refresh fills, and
+      *  when the time, the time step, theta or the matrix graph has changed.
+      **************************************************************************/
+{
+  static double *x_ref = NULL, *xdot_ref = NULL, *node_change = NULL;
+  static double delta_t_ref = 0.0, theta_ref = 0.0, time_ref = 0.0;
+  static int *bindx_ref = NULL, nnz_ref = -1, fills = 0;
+  int nx = NumUnknowns + NumExtUnknowns;
+  int full, e, n, i, k, first, nunks;
+  double d, change;
+
+  if (Selective_Reassembly_Tol <= 0.0) return FALSE;
+  if (Linear_Solver == FRONT || strcmp(Matrix_Format, "msr") != 0 ||
+      !af->Assemble_Jacobian || af->Assemble_LSA_Jacobian_Matrix ||
+      af->Assemble_LSA_Mass_Matrix || Precond_Fill ||
+      Mesh_Seg_Phase != MESH_SEG_OFF || Fill_Elem_Subset != NULL ||
+      xfem != NULL || fused_post_proc_active()) return FALSE;
+  if (Continuation != ALC_NONE || nHC > 0 || nAC > 0) return FALSE;
+
+  full = (Elem_Fill_Caches == NULL);
+  if (full) {
+    Num_Elem_Fill_Caches = exo->num_elems;
+    Elem_Fill_Caches = (ELEM_FILL_CACHE *)
+	smalloc(MAX(Num_Elem_Fill_Caches, 1)*sizeof(ELEM_FILL_CACHE));
+    memset(Elem_Fill_Caches, 0, MAX(Num_Elem_Fill_Caches, 1)*sizeof(ELEM_FILL_CACHE));
+    x_ref = alloc_dbl_1(MAX(nx, 1), 0.0);
+    xdot_ref = alloc_dbl_1(MAX(nx, 1), 0.0);
+    node_change = alloc_dbl_1(MAX(exo->num_nodes, 1), 0.0);
+  }
+
+  if (Selective_Reassembly_Refresh > 0 && ++fills >= Selective_Reassembly_Refresh) {
+    full = TRUE;
+  }
+  if (time_value != time_ref || delta_t != delta_t_ref || theta != theta_ref ||
+      ams->bindx != bindx_ref || ams->nnz != nnz_ref) full = TRUE;
+
+  if (full) {
+    fills = 0;
+    for (e = 0; e < Num_Elem_Fill_Caches; e++) Elem_Fill_Caches[e].valid = FALSE;
+  } else {
+    for (n = 0; n < exo->num_nodes; n++) {
+      first = Nodes[n]->First_Unknown;
+      nunks = Nodes[n]->Nodal_Vars_Info->Num_Unknowns;
+      change = 0.0;
+      for (k = 0; k < nunks; k++) {
+	i = first + k;
+	d = fabs(x[i] - x_ref[i]);
+	if (xdot != NULL) d += fabs(delta_t*(xdot[i] - xdot_ref[i]));
+	change = MAX(change, d/(1.0 + fabs(x[i])));
+      }
+      node_change[n] = change;
+    }
+    for (e = 0; e < Num_Elem_Fill_Caches; e++) {
+      change = 0.0;
+      for (k = exo->elem_node_pntr[e]; k < exo->elem_node_pntr[e+1]; k++) {
+	change = MAX(change, node_change[exo->elem_node_list[k]]);
+      }
+      Elem_Fill_Caches[e].drift += change;
+      if (Elem_Fill_Caches[e].drift > Selective_Reassembly_Tol) {
+	Elem_Fill_Caches[e].valid = FALSE;
+      }
+    }
+  }
+
+  memcpy(x_ref, x, nx*sizeof(double));
+  if (xdot != NULL) memcpy(xdot_ref, xdot, nx*sizeof(double));
+  time_ref = time_value;
+  delta_t_ref = delta_t;
+  theta_ref = theta;
+  bindx_ref = ams->bindx;
+  nnz_ref = ams->nnz;
+
+  return TRUE;
+}
+/****************************************************************************/
+
+static void
+elem_fill_cache_add(ELEM_FILL_CACHE *cache,
+		    const int jac,
+		    const int k,
+		    const double value)
+
+     /**************************************************************************
+      *
+      * elem_fill_cache_add()
+      *
+      *  Record that load_lec() added value to resid_vector[k], or to a[k]
+      *  if jac.
+      **************************************************************************/
+{
+  int **index = jac ? &cache->pos : &cache->row;
+  double **val = jac ? &cache->J : &cache->R;
+  int *len = jac ? &cache->nJ : &cache->nR;
+  int *size = jac ? &cache->sizeJ : &cache->sizeR;
+
+  if (*len >= *size) {
+    *size = MAX(2*(*size), 64);
+    *index = (int *) realloc(*index, (*size)*sizeof(int));
+    *val = (double *) realloc(*val, (*size)*sizeof(double));
+    if (*index == NULL || *val == NULL) EH(-1, "Out of memory for Selective Reassembly");
+  }
+  (*index)[*len] = k;
+  (*val)[*len] = value;
+  (*len)++;
+}
+/****************************************************************************/
+
+static int
+elem_fd_active(void)
+
+     /**************************************************************************
+      *
+      * elem_fd_active()
+      *
+      *  TRUE if Element Numerical Jacobian is on and usable for this problem.
+      *  Level sets, phase functions and XFEM set up per-element integration
+      *  state in matrix_fill() that a nested call would clobber, and the
+      *  contact angle conditions are applied once per fill, so those
+      *  problems keep their analytic Jacobian.
+      **************************************************************************/
+{
+  static int active = -1;
+  int ibc;
+
+  if (active >= 0) return active;
+
+  active = Elem_FD_Jacobian;
+  if (!active) return active;
+
+  if (ls != NULL || pfd != NULL || xfem != NULL) active = FALSE;
+  for (ibc = 0; active && ibc < Num_BC; ibc++) {
+    switch (BC_Types[ibc].BC_Name) {
+    case CA_BC:
+    case CA_MOMENTUM_BC:
+    case VELO_THETA_HOFFMAN_BC:
+    case VELO_THETA_TPL_BC:
+    case VELO_THETA_COX_BC:
+    case VELO_THETA_SHIK_BC:
+      active = FALSE;
+      break;
+    default:
+      break;
+    }
+  }
+
+  if (!active) {
+    WH(-1, "Element Numerical Jacobian ignored, not available with level sets, phase functions, XFEM or contact angle conditions");
+  }
+  return active;
+}
+/****************************************************************************/
+
+static int
+elem_fd_columns(struct Aztec_Linear_Solver_System *ams,
+		double x[],
+		double resid_vector[],
+		double x_old[],
+		double x_older[],
+		double xdot[],
+		double xdot_old[],
+		double x_update[],
+		double *ptr_delta_t,
+		double *ptr_theta,
+		struct elem_side_bc_struct *first_elem_side_BC_array[],
+		double *ptr_time_value,
+		Exo_DB *exo,
+		Dpi *dpi,
+		int *ptr_ielem,
+		int *ptr_num_total_nodes,
+		dbl *ptr_h_elem_avg,
+		dbl *ptr_U_norm,
+		dbl *estifm)
+
+     /**************************************************************************
+      *
+      * elem_fd_columns()
+      *
+      *  Difference the residual of element *ptr_ielem with respect to each
+      *  of its local unknowns, for the rows of the equations chosen on the
+      *  Element Numerical Jacobian card. The unknowns are perturbed in x[]
+      *  (and xdot[] for transients) and put back exactly afterwards.
+      *
+      *  Columns of variables owned by another element (discontinuous
+      *  interfaces) are not differenced and keep their analytic entries.
+      *
+      *  Return: 0, or -1 if one of the residual assemblies failed.
+      **************************************************************************/
+{
+  int e, v, i, j, k, c, r, pe, ledof, gi, c_first;
+  int ielem = *ptr_ielem;
+  int err = 0;
+  int max_rows = MAX_LOCAL_VAR_DESC * lec->max_dof;
+  dbl dx, x_save, xdot_save = 0., xdot_fac = 0.;
+  dbl scale;
+  dbl *R;
+
+  if (Elem_FD_Row_Eqn == NULL) {
+    Elem_FD_Row_Eqn = (int *) smalloc(max_rows*sizeof(int));
+    Elem_FD_Row_Dof = (int *) smalloc(max_rows*sizeof(int));
+    Elem_FD_Col_Var = (int *) smalloc(max_rows*sizeof(int));
+    Elem_FD_Col_Dof = (int *) smalloc(max_rows*sizeof(int));
+    Elem_FD_Col_Unk = (int *) smalloc(max_rows*sizeof(int));
+    Elem_FD_Col_Scale = (dbl *) smalloc(max_rows*sizeof(dbl));
+    Elem_FD_R0 = (dbl *) smalloc(max_rows*sizeof(dbl));
+  }
+  Elem_FD_Ready = FALSE;
+
+  Elem_FD_Pass = TRUE;
+  af->Assemble_Jacobian = FALSE;
+
+  /* unperturbed residual, this also loads ei for the element */
+  err = matrix_fill(ams, x, resid_vector, x_old, x_older, xdot, xdot_old,
+		    x_update, ptr_delta_t, ptr_theta, first_elem_side_BC_array,
+		    ptr_time_value, exo, dpi, ptr_ielem, ptr_num_total_nodes,
+		    ptr_h_elem_avg, ptr_U_norm, estifm, -1);
+  if (err) goto done;
+
+  Elem_FD_Nrow = 0;
+  for (e = V_FIRST; e < V_LAST; e++) {
+    if (!Elem_FD_Eqn[e] || upd->ep[e] == -1 || ei->dof[e] <= 0) continue;
+    for (k = 0; k < ((e == R_MASS) ? upd->Max_Num_Species_Eqn : 1); k++) {
+      pe = (e == R_MASS) ? MAX_PROB_VAR + k : upd->ep[e];
+      for (i = 0; i < ei->dof[e] && Elem_FD_Nrow < max_rows; i++) {
+	Elem_FD_Row_Eqn[Elem_FD_Nrow] = pe;
+	Elem_FD_Row_Dof[Elem_FD_Nrow] = i;
+	Elem_FD_R0[Elem_FD_Nrow] = lec->R[LEC_R_INDEX(pe,i)];
+	Elem_FD_Nrow++;
+      }
+    }
+  }
+  if (Elem_FD_Nrow == 0) goto done;
+
+  /*
+   * Local unknowns, and a size for their perturbation: the element rms of
+   * the variable, or the element size for displacements that are still
+   * zero, or one.
+   */
+  Elem_FD_Ncol = 0;
+  for (v = V_FIRST; v < V_LAST; v++) {
+    if (upd->vp[v] == -1 || ei->dof[v] <= 0) continue;
+    if (ei->owningElementForColVar[v] != ielem &&
+	ei->owningElementForColVar[v] != -1) continue;
+    scale = 0.;
+    c_first = Elem_FD_Ncol;
+    for (k = 0; k < ((v == MASS_FRACTION) ? upd->Max_Num_Species_Eqn : 1); k++) {
+      for (j = 0; j < ei->dof[v] && Elem_FD_Ncol < max_rows; j++) {
+	if (v == MASS_FRACTION) {
+	  ledof = ei->lvdof_to_ledof[v][j];
+	  gi = Index_Solution(ei->gnn_list[v][j], v, k, ei->Baby_Dolphin[v][j],
+			      ei->matID_ledof[ledof]);
+	} else {
+	  gi = ei->gun_list[v][j];
+	}
+	if (gi < 0) continue;
+	Elem_FD_Col_Var[Elem_FD_Ncol] = (v == MASS_FRACTION) ? MAX_PROB_VAR + k : upd->vp[v];
+	Elem_FD_Col_Dof[Elem_FD_Ncol] = j;
+	Elem_FD_Col_Unk[Elem_FD_Ncol] = gi;
+	Elem_FD_Ncol++;
+	scale += x[gi]*x[gi];
+      }
+    }
+    scale = sqrt(scale / MAX(Elem_FD_Ncol - c_first, 1));
+    if (scale == 0.) {
+      scale = 1.;
+      if ((v >= MESH_DISPLACEMENT1 && v <= MESH_DISPLACEMENT3) ||
+	  (v >= SOLID_DISPLACEMENT1 && v <= SOLID_DISPLACEMENT3)) {
+	dbl lo, hi, h = 0.;
+	int d, n, I;
+	for (d = 0; d < ei->ielem_dim; d++) {
+	  lo = hi = Coor[d][Proc_Elem_Connect[ei->iconnect_ptr]];
+	  for (n = 1; n < ei->num_local_nodes; n++) {
+	    I = Proc_Elem_Connect[ei->iconnect_ptr + n];
+	    lo = MIN(lo, Coor[d][I]);
+	    hi = MAX(hi, Coor[d][I]);
+	  }
+	  h = MAX(h, hi - lo);
+	}
+	if (h > 0.) scale = h;
+      }
+    }
+    for (c = c_first; c < Elem_FD_Ncol; c++) Elem_FD_Col_Scale[c] = scale;
+  }
+
+  if (Elem_FD_Nrow*Elem_FD_Ncol > Elem_FD_Size) {
+    safer_free((void **) &Elem_FD_J);
+    Elem_FD_Size = Elem_FD_Nrow*Elem_FD_Ncol;
+    Elem_FD_J = (dbl *) smalloc(Elem_FD_Size*sizeof(dbl));
+  }
+
+  if (pd_glob[0]->TimeIntegration != STEADY) {
+    xdot_fac = (1.0 + 2.0 * *ptr_theta) / *ptr_delta_t;
+  }
+
+  R = lec->R;
+  for (c = 0; c < Elem_FD_Ncol; c++) {
+    gi = Elem_FD_Col_Unk[c];
+    x_save = x[gi];
+    dx = FD_DELTA_UNKNOWN * MAX(fabs(x_save), Elem_FD_Col_Scale[c]);
+    if (dx < 1.0E-15) dx = 1.0E-7;
+    x[gi] = x_save + dx;
+    dx = x[gi] - x_save;
+    if (xdot_fac != 0.) {
+      xdot_save = xdot[gi];
+      xdot[gi] += dx * xdot_fac;
+    }
+
+    err = matrix_fill(ams, x, resid_vector, x_old, x_older, xdot, xdot_old,
+		      x_update, ptr_delta_t, ptr_theta, first_elem_side_BC_array,
+		      ptr_time_value, exo, dpi, ptr_ielem, ptr_num_total_nodes,
+		      ptr_h_elem_avg, ptr_U_norm, estifm, -1);
+
+    x[gi] = x_save;
+    if (xdot_fac != 0.) xdot[gi] = xdot_save;
+    if (err) goto done;
+
+    for (r = 0; r < Elem_FD_Nrow; r++) {
+      Elem_FD_J[c*Elem_FD_Nrow + r] =
+	(R[LEC_R_INDEX(Elem_FD_Row_Eqn[r], Elem_FD_Row_Dof[r])] - Elem_FD_R0[r]) / dx;
+    }
+  }
+  Elem_FD_Ready = TRUE;
+
+ done:
+  af->Assemble_Jacobian = TRUE;
+  Elem_FD_Pass = FALSE;
+  return err ? -1 : 0;
+}
+/****************************************************************************/
+
+static void
+elem_fd_load(void)
+
+     /**************************************************************************
+      *
+      * elem_fd_load()
+      *
+      *  Replace the analytic entries of the differenced rows of lec->J by
+      *  the ones from elem_fd_columns().
+      **************************************************************************/
+{
+  int c, r;
+
+  for (c = 0; c < Elem_FD_Ncol; c++) {
+    for (r = 0; r < Elem_FD_Nrow; r++) {
+      lec->J[LEC_J_INDEX(Elem_FD_Row_Eqn[r], Elem_FD_Col_Var[c],
+			 Elem_FD_Row_Dof[r], Elem_FD_Col_Dof[c])] =
+	Elem_FD_J[c*Elem_FD_Nrow + r];
+    }
+  }
+  Elem_FD_Ready = FALSE;
+}
+/****************************************************************************/
+
+static void
+mesh_lag_begin(Exo_DB *exo,
+	       const dbl delta_t)
+
+     /**************************************************************************
+      *
+      * mesh_lag_begin()
+      *
+      *  Decide, once per fill, whether this fill lags the mesh stiffness and
+      *  whether it is the one that computes the blocks afresh.
+      **************************************************************************/
+{
+  Mesh_Lag_Active = (Mesh_Stiffness_Lag > 1 && af->Assemble_Jacobian &&
+		     !af->Assemble_LSA_Jacobian_Matrix &&
+		     !af->Assemble_LSA_Mass_Matrix && Continuation != LOCA);
+
+  /* a segregated flow step leaves the mesh, and so the blocks, alone */
+  if (Mesh_Lag_Active && Mesh_Seg_Phase == MESH_SEG_FLOW) {
+    Mesh_Lag_Active = FALSE;
+    return;
+  }
+  if (!Mesh_Lag_Active) {
+    Mesh_Lag_Fills = 0;
+    return;
+  }
+
+  if (Mesh_Lag_J == NULL) {
+    Mesh_Lag_J = (dbl **) smalloc(MAX(exo->num_elems, 1) * sizeof(dbl *));
+    memset(Mesh_Lag_J, 0, MAX(exo->num_elems, 1) * sizeof(dbl *));
+  }
+
+  Mesh_Lag_Refresh = (Mesh_Lag_Fills % Mesh_Stiffness_Lag == 0 ||
+		      delta_t != Mesh_Lag_dt);
+  if (Mesh_Lag_Refresh) {
+    Mesh_Lag_Fills = 0;
+    Mesh_Lag_dt = delta_t;
+  }
+  Mesh_Lag_Fills++;
+}
+/****************************************************************************/
+
+static void
+mesh_lag_element(const int ielem)
+
+     /**************************************************************************
+      *
+      * mesh_lag_element()
+      *
+      *  After the volume integrals of element ielem, either add its kept
+      *  mesh-mesh block to lec->J (assemble_mesh() left it out), or keep
+      *  the block just assembled for the fills to come.
+      **************************************************************************/
+{
+  int a, b, i, j, n, ndof, peqn, pvar;
+  int dim = pd->Num_Dim;
+  dbl *J;
+
+  ndof = ei->dof[MESH_DISPLACEMENT1];
+  for (a = 0; a < dim; a++) {
+    if (upd->ep[R_MESH1+a] == -1 || upd->vp[MESH_DISPLACEMENT1+a] == -1 ||
+	ei->dof[MESH_DISPLACEMENT1+a] != ndof) return;
+  }
+
+  if (Mesh_Lag_J[ielem] == NULL) {
+    Mesh_Lag_J[ielem] = (dbl *) smalloc(MAX(dim*ndof*dim*ndof, 1) * sizeof(dbl));
+  }
+  J = Mesh_Lag_J[ielem];
+
+  n = 0;
+  for (a = 0; a < dim; a++) {
+    peqn = upd->ep[R_MESH1+a];
+    for (i = 0; i < ndof; i++) {
+      for (b = 0; b < dim; b++) {
+	pvar = upd->vp[MESH_DISPLACEMENT1+b];
+	for (j = 0; j < ndof; j++, n++) {
+	  if (Mesh_Lag_Reuse) {
+	    lec->J[LEC_J_INDEX(peqn,pvar,i,j)] += J[n];
+	  } else {
+	    J[n] = lec->J[LEC_J_INDEX(peqn,pvar,i,j)];
+	  }
+	}
+      }
+    }
+  }
+  Mesh_Lag_Reuse = FALSE;
+}
+
+int
+mesh_stiffness_lagged(void)
+{
+  return Mesh_Lag_Reuse;
+}
+/****************************************************************************/
+
+void
+precond_fill_set(const int on)
+{
+  Precond_Fill = on;
+}
+
+static int
+precond_keep_block(const int e, const int v)
+
+     /*
+      * Whether the Preconditioner Matrix keeps the Jacobian block of
+      * equation e against variable v. The flow and the mesh
+      * equations count as one equation each for the decoupled one.
+      * Segregated mesh and flow steps keep the blocks within each group.
+      */
+{
+  int e_mesh = (e >= R_MESH1 && e <= R_MESH3);
+  int v_mesh = (v >= MESH_DISPLACEMENT1 && v <= MESH_DISPLACEMENT3);
+
+  if (Mesh_Seg_Phase != MESH_SEG_OFF) {
+    return (e_mesh == v_mesh);
+  }
+
+  if (Precond_Matrix == PRECOND_MATRIX_NO_MESH) {
+    return (e_mesh || !v_mesh);
+  }
+
+  if (Precond_Matrix == PRECOND_MATRIX_DECOUPLED) {
+    if (e_mesh || v_mesh) return (e_mesh && v_mesh);
+    if ((e >= R_MOMENTUM1 && e <= R_MOMENTUM3) || e == R_PRESSURE) {
+      return ((v >= VELOCITY1 && v <= VELOCITY3) || v == PRESSURE);
+    }
+    return (e == v);
+  }
+  return TRUE;
+}
+
+static void
+precond_drop_lec(void)
+
+     /**************************************************************************
+      *
+      * precond_drop_lec()
+      *
+      *  Zero the blocks of lec->J that the Preconditioner Matrix leaves out,
+      *  for the element just assembled. Equation and variable numbers line
+      *  up (R_MOMENTUM1 with VELOCITY1, R_MASS with MASS_FRACTION, ...),
+      *  and the species blocks go with MASS_FRACTION.
+      **************************************************************************/
+{
+  int e, v, k, w, i, pe, pv, nw, nk;
+
+  for (e = V_FIRST; e < V_LAST; e++) {
+    if (upd->ep[e] == -1 || ei->dof[e] <= 0) continue;
+    for (v = V_FIRST; v < V_LAST; v++) {
+      if (upd->vp[v] == -1 || precond_keep_block(e, v)) continue;
+      nw = (e == R_MASS) ? upd->Max_Num_Species_Eqn : 1;
+      nk = (v == MASS_FRACTION) ? upd->Max_Num_Species_Eqn : 1;
+      for (w = 0; w < nw; w++) {
+	pe = (e == R_MASS) ? MAX_PROB_VAR + w : upd->ep[e];
+	for (k = 0; k < nk; k++) {
+	  pv = (v == MASS_FRACTION) ? MAX_PROB_VAR + k : upd->vp[v];
+	  for (i = 0; i < ei->dof[e] && i < lec->max_dof; i++) {
+	    memset(&lec->J[LEC_J_INDEX(pe, pv, i, 0)], 0,
+		   lec->max_dof*sizeof(dbl));
+	  }
+	}
+      }
+    }
+  }
+}
+/****************************************************************************/
+
+void
+mesh_segregation_set(const int phase)
+{
+  Mesh_Seg_Phase = phase;
+}
+
+void
+fill_element_subset(const int *mask)
+
+     /**************************************************************************
+      *
+      * fill_element_subset()
+      *
+      *  Limit the fills that follow to the elements flagged in mask, one
+      *  flag per element; NULL fills them all again. The rows of the
+      *  elements left out are incomplete; the caller reads only those it
+      *  sampled. The first and last elements should stay in, for the
+      *  once-per-fill work matrix_fill() does on them.
+      **************************************************************************/
+{
+  Fill_Elem_Subset = mask;
+}
+
+void
+fill_frozen_rows(const int *mask)
+
+     /**************************************************************************
+      *
+      * fill_frozen_rows()
+      *
+      *  Hold the unknowns flagged in mask, one flag per row, at their
+      *  values in x for the fills that follow: their rows become identity
+      *  rows with a zero residual. NULL frees them all again.
+      **************************************************************************/
+{
+  Fill_Frozen_Rows = mask;
+}
+
+static void
+mesh_segregation_rows(struct Aztec_Linear_Solver_System *ams,
+		      double resid_vector[])
+
+     /**************************************************************************
+      *
+      * mesh_segregation_rows()
+      *
+      *  After a fill for a segregated Newton step, turn the rows of the
+      *  unknowns the step holds fixed into identity rows with a zero
+      *  residual, so that their update is zero. Only the owned rows; the
+      *  external ones are hidden from the solve anyway.
+      **************************************************************************/
+{
+  int row, k, v, mesh;
+  int *ija = ams->bindx;
+  double *a = ams->val;
+
+  for (row = 0; row < NumUnknowns; row++) {
+    v = idv[row][0];
+    mesh = (v >= MESH_DISPLACEMENT1 && v <= MESH_DISPLACEMENT3);
+    if (mesh == (Mesh_Seg_Phase == MESH_SEG_MESH)) continue;
+    resid_vector[row] = 0.0;
+    if (!af->Assemble_Jacobian || a == NULL) continue;
+    a[row] = 1.0;
+    for (k = ija[row]; k < ija[row+1]; k++) a[k] = 0.0;
+  }
+}
+
+static void
+frozen_rows_identity(struct Aztec_Linear_Solver_System *ams,
+		     double resid_vector[])
+
+     /**************************************************************************
+      *
+      * frozen_rows_identity()
+      *
+      *  As mesh_segregation_rows(), for the rows fill_frozen_rows() flagged.
+      **************************************************************************/
+{
+  int row, k;
+  int *ija = ams->bindx;
+  double *a = ams->val;
+
+  for (row = 0; row < NumUnknowns; row++) {
+    if (!Fill_Frozen_Rows[row]) continue;
+    resid_vector[row] = 0.0;
+    if (!af->Assemble_Jacobian || a == NULL) continue;
+    a[row] = 1.0;
+    for (k = ija[row]; k < ija[row+1]; k++) a[k] = 0.0;
+  }
+}
+/****************************************************************************/
+
 static void
 zero_lec(void)
 
@@ -5622,14 +7041,91 @@ zero_lec(void)
       * zero_lec()
       *
       *  This routine zeroes the local element stiffness vector and Jacobian.
+      *
+      *  Only the parts of lec->J that load_lec() (and the frontal and
+      *  numerical Jacobian paths) can read back are cleared: the
+      *  (peqn, pvar) blocks of equations with dofs in this element against
+      *  every variable active somewhere in the problem, and within each
+      *  block only the rows of those dofs. Everything else is left as is,
+      *  which for typical problems is most of the array.
       **************************************************************************/
 {
+  int e, v, k, r, c, ncol = 0, nrows = 0;
+  int pvar[MAX_LOCAL_VAR_DESC+1], peqn[MAX_LOCAL_VAR_DESC+1];
+  int dofs[MAX_LOCAL_VAR_DESC+1];
+  size_t row_len;
+
   memset(lec->R, 0, MAX_LOCAL_VAR_DESC*lec->max_dof*sizeof(dbl));
-  memset(lec->J, 0, MAX_LOCAL_VAR_DESC*MAX_LOCAL_VAR_DESC*lec->max_dof*lec->max_dof*sizeof(dbl));
-  memset(lec->J_stress_neighbor, 0, 4*lec->max_dof*MAX_LOCAL_VAR_DESC*lec->max_dof*sizeof(dbl));
+
+  /* lec->J is never read back by residual-only assemblies */
+  if (!af->Assemble_Jacobian) return;
+
+  for (v = V_FIRST; v < V_LAST; v++) {
+    if (upd->vp[v] == -1) continue;
+    pvar[ncol++] = upd->vp[v];
+    if (v == MASS_FRACTION) {
+      for (k = 0; k < upd->Max_Num_Species_Eqn && ncol <= MAX_LOCAL_VAR_DESC; k++) {
+	if (MAX_PROB_VAR + k != upd->vp[v]) pvar[ncol++] = MAX_PROB_VAR + k;
+      }
+    }
+    if (ncol > MAX_LOCAL_VAR_DESC) break;
+  }
+
+  for (e = V_FIRST; e < V_LAST && nrows <= MAX_LOCAL_VAR_DESC; e++) {
+    if (upd->ep[e] == -1 || ei->dof[e] <= 0) continue;
+    dofs[nrows] = MIN(ei->dof[e], lec->max_dof);
+    peqn[nrows++] = upd->ep[e];
+    if (e == R_MASS) {
+      for (k = 0; k < upd->Max_Num_Species_Eqn && nrows <= MAX_LOCAL_VAR_DESC; k++) {
+	if (MAX_PROB_VAR + k == upd->ep[e]) continue;
+	dofs[nrows] = dofs[nrows-1];
+	peqn[nrows++] = MAX_PROB_VAR + k;
+      }
+    }
+  }
+
+  if (ncol > MAX_LOCAL_VAR_DESC || nrows > MAX_LOCAL_VAR_DESC) {
+    /* more slots than the layout has room for; should not happen */
+    memset(lec->J, 0, MAX_LOCAL_VAR_DESC*MAX_LOCAL_VAR_DESC*lec->max_dof*lec->max_dof*sizeof(dbl));
+  } else {
+    for (r = 0; r < nrows; r++) {
+      row_len = dofs[r]*lec->max_dof*sizeof(dbl);
+      for (c = 0; c < ncol; c++) {
+	memset(&(lec->J[LEC_J_INDEX(peqn[r],pvar[c],0,0)]), 0, row_len);
+      }
+    }
+  }
+
+  /*
+   * The neighbor blocks are only filled (and zeroed again) for
+   * discontinuous stress interpolations.
+   */
+  if (upd->vp[POLYMER_STRESS11] != -1) {
+    memset(lec->J_stress_neighbor, 0, 4*lec->max_dof*MAX_LOCAL_VAR_DESC*lec->max_dof*sizeof(dbl));
+  }
 }
 /****************************************************************************/
 
+/*
+ * TRUE if any of the n values is a NaN or an infinity, the ones with all
+ * their exponent bits set. There is no branch in the loop, so it
+ * vectorizes.
+ */
+static int
+any_nonfinite(const double *v,
+	      const int n)
+{
+  const uint64_t exponent = 0x7ff0000000000000ULL;
+  uint64_t b;
+  int i, bad = 0;
+
+  for (i = 0; i < n; i++) {
+    memcpy(&b, v + i, sizeof(b));
+    bad |= ((b & exponent) == exponent);
+  }
+  return bad;
+}
+
 int
 checkfinite(const char *file, const int line, const char *message)
 {
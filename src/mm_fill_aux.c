@@ -937,6 +937,89 @@ element_velocity(dbl v_avg[DIM], dbl dv_dnode[DIM][MDE],
 /*************************************************************************/
 /*************************************************************************/
 
+/*
+ * Element sizes of h_elem_siz() for elements whose size does not follow
+ * the solution, i.e. is computed from Coor[] alone. They are kept per
+ * element from the first time they are asked for until the coordinates
+ * change, together with the global average of global_h_elem_siz() when
+ * no element of the mesh depends on the solution there. The surface
+ * determinant and normal of surface_determinant_and_normal() at the side
+ * quadrature points of such elements are kept the same way.
+ */
+struct H_Elem_Surf_Point
+{
+  int id_side;
+  dbl xi[DIM];
+  dbl sdet;
+  dbl snormal[DIM];
+};
+
+#define H_ELEM_MAX_SURF_POINTS (6 * MAX_SURF_GP)
+
+struct H_Elem_Cache
+{
+  int filled;
+  dbl hsquared[DIM];
+  dbl hh[DIM][DIM];
+  int num_surf;			/* surface points of this element with */
+  struct H_Elem_Surf_Point *surf; /* fv->sdet and fv->snormal */
+};
+
+static struct H_Elem_Cache *H_Elem = NULL;
+static int H_Elem_Num_Elems = 0;
+static dbl H_Elem_Global = -1.0;	/* < 0 until computed */
+
+void
+h_elem_cache_init(const Exo_DB *exo)
+
+     /************************************************************************
+      *
+      * h_elem_cache_init():
+      *
+      *    Set up the (empty) element size cache of h_elem_siz(). Must be
+      * called before any parallel element loop.
+      *
+      ************************************************************************/
+{
+  if (H_Elem != NULL) return;
+  H_Elem_Num_Elems = exo->num_elems;
+  H_Elem = alloc_struct_1(struct H_Elem_Cache, MAX(H_Elem_Num_Elems, 1));
+}
+/*************************************************************************/
+
+void
+h_elem_cache_invalidate(const Exo_DB *exo,
+			const int moved[])
+
+     /************************************************************************
+      *
+      * h_elem_cache_invalidate():
+      *
+      *    Forget the cached size of every element with a node whose
+      * coordinates moved[] flags, or of all of them when moved is NULL,
+      * and the cached global average.
+      *
+      ************************************************************************/
+{
+  int e, n;
+
+  H_Elem_Global = -1.0;
+  if (H_Elem == NULL) return;
+  for (e = 0; e < H_Elem_Num_Elems; e++)
+    {
+      if (moved != NULL)
+	{
+	  for (n = exo->elem_node_pntr[e];
+	       n < exo->elem_node_pntr[e+1] && !moved[exo->elem_node_list[n]];
+	       n++);
+	  if (n == exo->elem_node_pntr[e+1]) continue;
+	}
+      H_Elem[e].filled = FALSE;
+      H_Elem[e].num_surf = 0;
+    }
+}
+/*************************************************************************/
+
 void 
 h_elem_siz(dbl hsquared[DIM], dbl hh[DIM][DIM],
 	   dbl dhh_dxnode[DIM][MDE], const int DeformingMesh)
@@ -981,6 +1064,7 @@ h_elem_siz(dbl hsquared[DIM], dbl hh[DIM][DIM],
   int elem_type = ei->ielem_type;
   int elem_shape = type2shape(elem_type);
   int DeformingMeshShell = 0;
+  struct H_Elem_Cache *cache = NULL;
 
   /* initialize xnode */
   for (i = 0; i < DIM; i++) {
@@ -998,6 +1082,19 @@ h_elem_siz(dbl hsquared[DIM], dbl hh[DIM][DIM],
       mp->FSIModel == FSI_REALSOLID_CONTINUUM ||
       mp->FSIModel == FSI_SHELL_ONLY_MESH) DeformingMeshShell = 1;
 
+  if (!DeformingMesh && !DeformingMeshShell &&
+      H_Elem != NULL && ei->ielem < H_Elem_Num_Elems) {
+    cache = H_Elem + ei->ielem;
+    if (cache->filled) {
+      memcpy(hsquared, cache->hsquared, DIM*sizeof(dbl));
+      memcpy(hh, cache->hh, DIM*DIM*sizeof(dbl));
+      if (af->Assemble_Jacobian) {
+	memset((void *)dhh_dxnode, 0, dim*MDE*sizeof(double));
+      }
+      return;
+    }
+  }
+
   j = Proc_Connect_Ptr[ei->ielem];
   for (p = 0; p < dim; p++) {
     if (DeformingMesh || DeformingMeshShell) {
@@ -1167,6 +1264,12 @@ h_elem_siz(dbl hsquared[DIM], dbl hh[DIM][DIM],
     {
       EH(-1,"SUPG not allowed for tetrahedral elements yet, or whatever weird element you have");
     }
+
+  if (cache != NULL) {
+    memcpy(cache->hsquared, hsquared, DIM*sizeof(dbl));
+    memcpy(cache->hh, hh, DIM*DIM*sizeof(dbl));
+    cache->filled = TRUE;
+  }
 }
 /*************************************************************************/
 /*************************************************************************/
@@ -1234,7 +1337,7 @@ global_h_elem_siz(dbl x[], dbl x_old[], dbl xdot[], dbl resid_vector[],
  * Revised: 1999/10/01 07:48 MDT pasacki@sandia.gov
  */
 {
-  int e, dim, p;
+  int e, dim, p, m, fixed;
   dbl h, h_elem, hsquared[DIM], hhv[DIM][DIM], dhv_dxnode[DIM][MDE];
   dbl weight;                   /* 1 usually, except for multiprocessing */
   dbl smele_mun;                /* (1/num_elems) */
@@ -1249,6 +1352,20 @@ global_h_elem_siz(dbl x[], dbl x_old[], dbl xdot[], dbl resid_vector[],
    */
   smele_mun = 1.0 / (double) dpi->num_elems_global;
 
+  /*
+   * The element sizes are taken from Coor[] alone here, unless a material
+   * lets h_elem_siz() move its nodes with the shell mesh. Otherwise the
+   * average is that of the last call until the coordinates change.
+   */
+  fixed = TRUE;
+  for (m = 0; m < upd->Num_Mat; m++) {
+    if (mp_glob[m]->FSIModel == FSI_MESH_CONTINUUM ||
+	mp_glob[m]->FSIModel == FSI_REALSOLID_CONTINUUM ||
+	mp_glob[m]->FSIModel == FSI_SHELL_ONLY_MESH) fixed = FALSE;
+  }
+  if (fixed && H_Elem_Global >= 0.0) return(H_Elem_Global);
+  h_elem_cache_init(exo);
+
   /*
    * Look through each element block, then at each element in each block.
    *
@@ -1279,6 +1396,7 @@ global_h_elem_siz(dbl x[], dbl x_old[], dbl xdot[], dbl resid_vector[],
                 MPI_COMM_WORLD);
   h = h_global_really_i_mean_it;
 #endif
+  if (fixed) H_Elem_Global = h;
   return(h);
 }
 /****************************************************************************/
@@ -1341,6 +1459,8 @@ surface_determinant_and_normal(
   double        signID;
   double tmp;
   int dim =  pd->Num_Dim;
+  struct H_Elem_Cache *cache = NULL;
+  struct H_Elem_Surf_Point *sp;
 
   DeformingMesh = pd->e[R_MESH1];
   ShapeVar = pd->ShapeVar;
@@ -1357,6 +1477,29 @@ surface_determinant_and_normal(
 
   map_bf = bf[ShapeVar];
 
+  /*
+   * When the element cannot move, sdet and snormal depend only on the
+   * side and the point on it; look for them in the element's cache.
+   */
+  if (ielem_surf_dim > 0 && !DeformingMesh && !ei->deforming_mesh &&
+      H_Elem != NULL && ielem >= 0 && ielem < H_Elem_Num_Elems)
+    {
+      cache = H_Elem + ielem;
+      for (p = 0; p < cache->num_surf; p++)
+	{
+	  sp = cache->surf + p;
+	  if (sp->id_side == id_side && sp->xi[0] == map_bf->xi[0] &&
+	      sp->xi[1] == map_bf->xi[1] && sp->xi[2] == map_bf->xi[2])
+	    {
+	      fv->sdet = sp->sdet;
+	      fv->snormal[0] = sp->snormal[0];
+	      fv->snormal[1] = sp->snormal[1];
+	      fv->snormal[2] = sp->snormal[2];
+	      return;
+	    }
+	}
+    }
+
   if (ielem_surf_dim == 0)
     {
       /*
@@ -1708,6 +1851,25 @@ surface_determinant_and_normal(
             }
         }
     } 
+
+  if (cache != NULL && cache->num_surf < H_ELEM_MAX_SURF_POINTS)
+    {
+      if (cache->surf == NULL)
+	{
+	  cache->surf = alloc_struct_1(struct H_Elem_Surf_Point,
+				       H_ELEM_MAX_SURF_POINTS);
+	}
+      sp = cache->surf + cache->num_surf;
+      sp->id_side = id_side;
+      sp->xi[0] = map_bf->xi[0];
+      sp->xi[1] = map_bf->xi[1];
+      sp->xi[2] = map_bf->xi[2];
+      sp->sdet = fv->sdet;
+      sp->snormal[0] = fv->snormal[0];
+      sp->snormal[1] = fv->snormal[1];
+      sp->snormal[2] = fv->snormal[2];
+      cache->num_surf++;
+    }
 }
 
 /****************************************************************************/
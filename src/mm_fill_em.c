@@ -933,6 +933,19 @@ int assemble_ewave_curlcurl(double time, // present time
   //double rmass_etm;
   //double imass_etm;
   double stab_scale = 4.0;
+
+  /*
+   * The real and imaginary parts of E normally share one basis; then each
+   * complex entry curl.curl - k^2 phi.phi is formed once and its parts go
+   * to the four blocks of the real form.
+   */
+  int shared_basis = TRUE;
+  for (int a = 0; a < DIM; a++) {
+    if (pd->e[R_EM_E1_REAL+a] &&
+        (bf[EM_E1_REAL+a] != bf[eqn] || bf[EM_E1_IMAG+a] != bf[eqn])) {
+      shared_basis = FALSE;
+    }
+  }
   if ( af->Assemble_Residual ) {
     for (int i = 0; i < ei->dof[eqn]; i++) {
       for (int a = 0; a < DIM; a++) {
@@ -1034,7 +1047,68 @@ int assemble_ewave_curlcurl(double time, // present time
       }
     }
   }
-  if ( af->Assemble_Jacobian ) {
+  if ( af->Assemble_Jacobian && shared_basis ) {
+    struct Basis_Functions *bfe = bf[eqn];
+    double wt_det = bfe->detJ * fv->wt * fv->h3;
+    int stab_on = !(pd->v[R_EM_CONT_REAL] && pd->v[R_EM_CONT_IMAG]);
+    for (int i = 0; i < ei->dof[eqn]; i++) {
+      for (int a = 0; a < DIM; a++) {
+        if ( ! pd->e[R_EM_E1_REAL+a] ) continue;
+        reqn = R_EM_E1_REAL + a;
+        ieqn = R_EM_E1_IMAG + a;
+        radvection_etm = pd->etm[reqn][(LOG2_ADVECTION)];
+        rdiffusion_etm = pd->etm[reqn][(LOG2_DIFFUSION)];
+        iadvection_etm = pd->etm[ieqn][(LOG2_ADVECTION)];
+        idiffusion_etm = pd->etm[ieqn][(LOG2_DIFFUSION)];
+        int peqn_real = upd->ep[EM_E1_REAL+a];
+        int peqn_imag = upd->ep[EM_E1_IMAG+a];
+
+        for (int b = 0; b < DIM; b++) {
+          if ( ! pd->e[R_EM_E1_REAL+b] ) continue;
+          int pvar_real = upd->vp[EM_E1_REAL+b];
+          int pvar_imag = upd->vp[EM_E1_IMAG+b];
+          for (int j = 0; j < ei->dof[EM_E1_REAL+b]; j++) {
+            double curlcurl = 0.0;
+            for (int q = 0; q < DIM; q++) {
+              curlcurl += bfe->curl_phi_e[i][a][q] * bfe->curl_phi_e[j][b][q];
+            }
+            double stab = 0.0;
+            if (stab_on) {
+              stab = stab_scale * bfe->grad_phi[i][a] * (bfe->grad_phi_e[j][b][0][0] +
+                  bfe->grad_phi_e[j][b][1][1] + bfe->grad_phi_e[j][b][2][2]);
+            }
+            double mass = (a == b) ? bfe->phi[i] * bfe->phi[j] : 0.0;
+
+            lec->J[LEC_J_INDEX(peqn_real,pvar_real,i,j)] += (curlcurl*rdiffusion_etm
+                                                   - mass*re_coeff*radvection_etm
+                                                   + stab) * wt_det;
+            lec->J[LEC_J_INDEX(peqn_imag,pvar_imag,i,j)] += (curlcurl*idiffusion_etm
+                                                   - mass*re_coeff*iadvection_etm
+                                                   + stab) * wt_det;
+            if (a == b) {
+              lec->J[LEC_J_INDEX(peqn_imag,pvar_real,i,j)] -= mass*im_coeff*iadvection_etm * wt_det;
+              lec->J[LEC_J_INDEX(peqn_real,pvar_imag,i,j)] += mass*im_coeff*radvection_etm * wt_det;
+            }
+          }
+        }
+
+        if (pd->e[EM_CONT_REAL]) {
+          int pvar = upd->vp[EM_CONT_REAL];
+          for (int j = 0; j < ei->dof[EM_CONT_REAL]; j++) {
+            lec->J[LEC_J_INDEX(peqn_real,pvar,i,j)] +=
+                bfe->grad_phi[i][a] * bf[EM_CONT_REAL]->phi[j] * wt_det;
+          }
+        }
+        if (pd->e[EM_CONT_IMAG]) {
+          int pvar = upd->vp[EM_CONT_IMAG];
+          for (int j = 0; j < ei->dof[EM_CONT_IMAG]; j++) {
+            lec->J[LEC_J_INDEX(peqn_imag,pvar,i,j)] +=
+                bfe->grad_phi[i][a] * bf[EM_CONT_IMAG]->phi[j] * wt_det;
+          }
+        }
+      }
+    }
+  } else if ( af->Assemble_Jacobian ) {
     for (int i = 0; i < ei->dof[eqn]; i++) {
       for (int a = 0; a < DIM; a++) {
         reqn = R_EM_E1_REAL + a;
@@ -18,6 +18,7 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <math.h>
+#include <float.h>
 
 #include "std.h"		/* This needs to be here. */
 
@@ -79,6 +80,12 @@
  */
 
 
+#ifndef COUPLED_FILL
+static void assemble_fill_lumped_mass
+PROTO((double [],		/* rf - lumped mass of the fill unknowns      */
+       int []));		/* node_to_fill                              */
+#endif
+
 static int neighbor_fill
 PROTO((Exo_DB *,                /* exo                                       */
        dbl [],                  /* x                                         */
@@ -107,6 +114,13 @@ PROTO((Exo_DB *,                /* exo - ptr to exodus ii mesh information   */
        dbl **));                /* x_n                                       */
 
 
+#ifndef COUPLED_FILL
+/*
+ * Elements fill_matrix() assembles, set by integrate_explicit_eqn() for
+ * a Level Set Narrow Band; NULL means every element.
+ */
+static int *Fill_Band_Elem = NULL;
+#endif
 
 /*
  * Prototype declarations of static functions.
@@ -3513,6 +3527,82 @@ assemble_fill_gradf(double afill[],	/* Jacobian matrix for fill equation  */
 
 
 #ifndef COUPLED_FILL
+/******************************************************************************/
+/******************************************************************************/
+/******************************************************************************/
+/*
+ * fill_narrow_band -- the elements within layers layers of the ones the
+ * zero contour of xf crosses.
+ *
+ * band_elem[e] is set for the elements of the band and band_node[I] to 1.
+ * for the nodes they touch. The node marks of the owners are sent to the
+ * ghosts after each layer, as the owner holds every element around its
+ * nodes and the band then grows alike on every processor.
+ *
+ * Return: the number of elements in the band.
+ */
+static int
+fill_narrow_band(const int layers,
+		 double xf[],
+		 int node_to_fill[],
+		 Exo_DB *exo,
+		 Dpi *dpi,
+		 Comm_Ex *cx,
+		 int band_elem[],
+		 double band_node[])
+{
+  int e, k, I, layer, n, num_band = 0;
+  int num_nodes = dpi->num_universe_nodes;
+  double f, fmin = 0., fmax = 0.;
+
+  for ( e = 0; e < exo->num_elems; e++ )
+    {
+      n = 0;
+      for ( k = exo->elem_node_pntr[e]; k < exo->elem_node_pntr[e+1]; k++ )
+	{
+	  I = exo->elem_node_list[k];
+	  if ( Dolphin[I][R_FILL] <= 0 ) continue;
+	  f = xf[node_to_fill[I]];
+	  if ( n == 0 || f < fmin ) fmin = f;
+	  if ( n == 0 || f > fmax ) fmax = f;
+	  n++;
+	}
+      band_elem[e] = ( n > 0 && fmin <= 0. && fmax >= 0. );
+    }
+
+  for ( layer = 0; ; layer++ )
+    {
+      for ( I = 0; I < num_nodes; I++ ) band_node[I] = 0.;
+      for ( e = 0; e < exo->num_elems; e++ )
+	{
+	  if ( !band_elem[e] ) continue;
+	  for ( k = exo->elem_node_pntr[e]; k < exo->elem_node_pntr[e+1]; k++ )
+	    {
+	      band_node[exo->elem_node_list[k]] = 1.;
+	    }
+	}
+      exchange_node(cx, dpi, band_node);
+
+      if ( layer == layers ) break;
+
+      for ( e = 0; e < exo->num_elems; e++ )
+	{
+	  if ( band_elem[e] ) continue;
+	  for ( k = exo->elem_node_pntr[e]; k < exo->elem_node_pntr[e+1]; k++ )
+	    {
+	      if ( band_node[exo->elem_node_list[k]] != 0. )
+		{
+		  band_elem[e] = 1;
+		  break;
+		}
+	    }
+	}
+    }
+
+  for ( e = 0; e < exo->num_elems; e++ ) num_band += band_elem[e];
+  return num_band;
+}
+
 /******************************************************************************/
 /******************************************************************************/
 /******************************************************************************/
@@ -3643,11 +3733,11 @@ integrate_explicit_eqn(
 				 * are owned by this processor */
   int local_nnz_plus;		/* and if the external rows are included */
 
-  int global_order;		/* order of the global system */
-  int global_order_plus;	/* and if the external rows are overincluded */
-  int global_nnz;		/* a sum of the number of nonzero matrix 
+  goma_gid global_order;	/* order of the global system */
+  goma_gid global_order_plus; /* and if the external rows are overincluded */
+  goma_gid global_nnz;		/* a sum of the number of nonzero matrix 
 				 * entries owned by each processor */
-  int global_nnz_plus;		/* a sum that overincludes the external rows */
+  goma_gid global_nnz_plus; /* a sum that overincludes the external rows */
 
   double *scale = NULL; 	/* scale vector for row sum scaling */
 
@@ -3667,6 +3757,9 @@ integrate_explicit_eqn(
 
   extern struct elem_side_bc_struct **First_Elem_Side_BC_Array;
 
+  int      *band_elem = NULL;	/* elements of the narrow band */
+  double   *band_node = NULL;	/* 1. at the nodes they touch */
+
 /*
  * Begin executable statements...
  */
@@ -3710,8 +3803,9 @@ integrate_explicit_eqn(
 #ifdef DEBUG
   fprintf(stderr, "P_%d: lo=%d, lo+=%d, lnnz=%d, lnnz+=%d\n", ProcID,
 	  local_order, local_order_plus, local_nnz, local_nnz_plus);
-  fprintf(stderr, "P_%d: go=%d, go+=%d, gnnz=%d, gnnz+=%d\n", ProcID,
-	  global_order, global_order_plus, global_nnz, global_nnz_plus);
+  fprintf(stderr, "P_%d: go=%lld, go+=%lld, gnnz=%lld, gnnz+=%lld\n", ProcID,
+	  (long long) global_order, (long long) global_order_plus,
+	  (long long) global_nnz, (long long) global_nnz_plus);
 #endif /* DEBUG */
 
 
@@ -3747,6 +3841,29 @@ integrate_explicit_eqn(
   put_fill_vector(num_total_nodes, xdot, xfdot, node_to_fill);
   exchange_dof(cx, dpi, xdot);  
 
+  /*
+   * Narrow band: only the elements near the zero contour are assembled,
+   * and the fill unknowns away from it are held at their values through
+   * identity rows.
+   */
+  if ( ls != NULL && ls->Narrow_Band > 0 )
+    {
+      int num_band;
+
+      if ( !exo->elem_node_conn_exists )
+	{
+	  EH(-1, "Level Set Narrow Band needs the elem->node connectivity");
+	}
+      band_elem = alloc_int_1(exo->num_elems, 0);
+      band_node = alloc_dbl_1(num_total_nodes, 0.);
+      num_band = fill_narrow_band(ls->Narrow_Band, xf, node_to_fill, exo, dpi,
+				  cx, band_elem, band_node);
+      Fill_Band_Elem = band_elem;
+
+      if (printing) DPRINTF(stderr, "\n\t Narrow band: %d of %d elements",
+			    num_band, exo->num_elems);
+    }
+
   if (printing) {
     DPRINTF(stderr, "\n\t   L_2 in R   L_2 in dx   lis \n");
     DPRINTF(stderr, "\t ---------  ---------   -----\n");
@@ -3802,6 +3919,23 @@ integrate_explicit_eqn(
 			    First_Elem_Side_BC_Array, exo, dpi);
 	  a_end = ut();
 	  EH( err, "fill_matrix");
+
+	  if ( band_node != NULL )
+	    {
+	      int I, ki, k;
+
+	      for ( I = 0; I < num_total_nodes; I++ )
+		{
+		  if ( band_node[I] != 0. ) continue;
+		  for ( ki = 0; ki < Dolphin[I][R_FILL]; ki++ )
+		    {
+		      i = node_to_fill[I] + ki;
+		      rf[i] = 0.;
+		      afill[i] = 1.;
+		      for ( k = ijaf[i]; k < ijaf[i+1]; k++ ) afill[k] = 0.;
+		    }
+		}
+	    }
           
           /* Scale matrix first to get rid of problems with 
              penalty parameter. */
@@ -4066,11 +4200,235 @@ integrate_explicit_eqn(
   safe_free( (void *) delta_x);
   safe_free( (void *) scale);
 
+  if ( band_elem != NULL )
+    {
+      Fill_Band_Elem = NULL;
+      safe_free( (void *) band_elem);
+      safe_free( (void *) band_node);
+    }
   
   return(return_value);
 /*****************************************************************************/
 }   /*   END OF integrate_explicit_eqn                                       */
 
+/******************************************************************************/
+/******************************************************************************/
+/******************************************************************************/
+
+int
+integrate_explicit_lumped(
+     struct Aztec_Linear_Solver_System *ams,       /* cf "sl_util_structs.h" */
+     double rf[],                                  /* residual for fill
+						      equation only     */
+     double xf[],                                  /* vector with fill at
+						      nodes only     */
+     double xf_old[],
+     double xfdot[],
+     double x[],		                   /* Solution vector for
+						      the current processor */
+     double x_old[],                               /* Solution vector at last
+						      time step            */
+     double xdot[],                                /* time derivative of
+						      solution vector */
+     dbl delta_t,		                   /* time step size */
+     int node_to_fill[],
+     Exo_DB *exo,
+     Dpi *dpi,
+     Comm_Ex *cx )
+
+/******************************************************************************
+  Function which advances the fill equation over one subcycle step without
+  a linear solve (Level Set Lumped Explicit). The fill mass is lumped onto
+  the diagonal and the step is the three stage SSP (TVD) Runge-Kutta scheme
+  of Shu and Osher,
+
+     F1 = F0 + dt L(F0)
+     F2 = 3/4 F0 + 1/4 (F1 + dt L(F1))
+     F  = 1/3 F0 + 2/3 (F2 + dt L(F2)),   L(F) = -R(F) / M_lumped,
+
+  where R is the fill residual of fill_matrix() with the time derivative
+  left out. Dirichlet rows have R = 0 and keep their values. The lumped
+  mass is assembled once, and again every step if the mesh moves.
+
+  Returns the number of residual evaluations.
+*******************************************************************************/
+{
+  static double *mass = NULL;		/* lumped fill mass */
+  static int mass_size = 0;
+  static const double w_F0[3] = { 0.0, 0.75, 1.0/3.0 };
+
+  int i, stage;
+  int num_total_nodes = dpi->num_universe_nodes;
+  int save_residual = af->Assemble_Residual;
+  int save_jacobian = af->Assemble_Jacobian;
+  double *zero;
+
+  extern struct elem_side_bc_struct **First_Elem_Side_BC_Array;
+
+  af->Assemble_Residual = TRUE;
+  af->Assemble_Jacobian = FALSE;
+  af->Assemble_LSA_Jacobian_Matrix = FALSE;
+  af->Assemble_LSA_Mass_Matrix = FALSE;
+
+  /*
+   * The residual is wanted without the F_dot term, so the fill part of
+   * xdot[] is zeroed for the stages.
+   */
+  zero = alloc_dbl_1(num_fill_unknowns, 0.0);
+  put_fill_vector(num_total_nodes, xdot, zero, node_to_fill);
+  exchange_dof(cx, dpi, xdot);
+
+  if ( mass == NULL || mass_size != num_fill_unknowns ||
+       Num_Var_In_Type[MESH_DISPLACEMENT1] )
+    {
+      if ( mass_size != num_fill_unknowns )
+	{
+	  safer_free((void **) &mass);
+	  mass = alloc_dbl_1(num_fill_unknowns, 0.0);
+	  mass_size = num_fill_unknowns;
+	}
+      init_vec_value(mass, 0.0, num_fill_unknowns);
+      fill_matrix(ams->val, ams->bindx, mass, xf, x, x_old, xdot, delta_t,
+		  0.0, LUMP, node_to_fill, First_Elem_Side_BC_Array, exo, dpi);
+    }
+
+  dcopy1(num_fill_unknowns, xf_old, xf);
+
+  for ( stage = 0; stage < 3; stage++ )
+    {
+      put_fill_vector(num_total_nodes, x, xf, node_to_fill);
+      exchange_dof(cx, dpi, x);
+
+      init_vec_value(rf, 0.0, num_fill_unknowns);
+      fill_matrix(ams->val, ams->bindx, rf, xf, x, x_old, xdot, delta_t,
+		  0.0, ADVECT, node_to_fill, First_Elem_Side_BC_Array, exo, dpi);
+
+      for ( i = 0; i < num_fill_unknowns; i++ )
+	{
+	  double F_step = xf[i];
+
+	  if ( mass[i] > 0.0 ) F_step -= delta_t * rf[i] / mass[i];
+	  xf[i] = w_F0[stage] * xf_old[i] + (1.0 - w_F0[stage]) * F_step;
+	}
+    }
+
+  /*
+   * The unknowns this processor does not own were only partly assembled;
+   * take them from their owners.
+   */
+  put_fill_vector(num_total_nodes, x, xf, node_to_fill);
+  exchange_dof(cx, dpi, x);
+  get_fill_vector(num_total_nodes, x, xf, node_to_fill);
+
+  for ( i = 0; i < num_fill_unknowns; i++ )
+    {
+      xfdot[i] = (xf[i] - xf_old[i]) / delta_t;
+    }
+  put_fill_vector(num_total_nodes, xdot, xfdot, node_to_fill);
+  exchange_dof(cx, dpi, xdot);
+
+  af->Assemble_Residual = save_residual;
+  af->Assemble_Jacobian = save_jacobian;
+  safe_free((void *) zero);
+
+  return(3);
+}   /*   END OF integrate_explicit_lumped                                    */
+
+/******************************************************************************/
+
+double
+explicit_fill_time_step(double x[],
+			double x_old[],
+			double xdot[],
+			double xdot_old[],
+			double resid_vector[],
+			Exo_DB *exo)
+
+/******************************************************************************
+  Smallest h/|v| over the elements of the fill equation, from the element
+  size of h_elem_siz() and the nodal (extension) velocities, for the
+  substeps of Level Set Lumped Explicit. This is the estimate of
+  Courant_Time_Step() taken over every element instead of those on the
+  interface: an explicit update is only stable if it is stable everywhere.
+  Returns 0 when nothing moves.
+*******************************************************************************/
+{
+  int ebi, ielem, e_start, e_end;
+  int a, i, wim;
+  double dt, min_dt = DBL_MAX;
+  double v_mag2, h_elem;
+  double hsquared[DIM];
+  double hhv[DIM][DIM];
+  double dhv_dxnode[DIM][MDE];
+#ifdef PARALLEL
+  double min_dt_local;
+#endif
+
+  for ( ebi = 0; ebi < exo->num_elem_blocks; ebi++ )
+    {
+      pd  = pd_glob[Matilda[ebi]];
+      mp  = mp_glob[Matilda[ebi]];
+      if ( !pd->e[R_FILL] ) continue;
+
+      e_start = exo->eb_ptr[ebi];
+      e_end   = exo->eb_ptr[ebi+1];
+
+      wim = pd->Num_Dim;
+      if (pd->CoordinateSystem == SWIRLING ||
+          pd->CoordinateSystem == PROJECTED_CARTESIAN ||
+          pd->CoordinateSystem == CARTESIAN_2pt5D)
+        wim = wim+1;
+
+      for ( ielem = e_start; ielem < e_end; ielem++ )
+	{
+	  load_elem_dofptr(ielem, exo, x, x_old, xdot, xdot_old,
+			   resid_vector, 0);
+
+	  h_elem_siz(hsquared, hhv, dhv_dxnode, pd->e[R_MESH1]);
+
+	  h_elem = 0.;
+	  for ( a = 0; a < ei->ielem_dim; a++ ) h_elem += hsquared[a];
+	  h_elem = sqrt(h_elem / ((double) ei->ielem_dim));
+
+	  if ( pd->v[EXT_VELOCITY] )
+	    {
+	      for ( i = 0; i < ei->dof[EXT_VELOCITY]; i++ )
+		{
+		  if ( *esp->ext_v[i] != 0. )
+		    {
+		      dt = fabs(h_elem / *esp->ext_v[i]);
+		      if ( dt < min_dt ) min_dt = dt;
+		    }
+		}
+	    }
+	  if ( pd->v[VELOCITY1] && tran->Fill_Equation != FILL_EQN_EXT_V )
+	    {
+	      for ( i = 0; i < ei->dof[VELOCITY1]; i++ )
+		{
+		  v_mag2 = 0.;
+		  for ( a = 0; a < wim; a++ )
+		    {
+		      v_mag2 += *esp->v[a][i] * *esp->v[a][i];
+		    }
+		  if ( v_mag2 != 0. )
+		    {
+		      dt = h_elem / sqrt(v_mag2);
+		      if ( dt < min_dt ) min_dt = dt;
+		    }
+		}
+	    }
+	}
+    }
+
+#ifdef PARALLEL
+  min_dt_local = min_dt;
+  MPI_Allreduce(&min_dt_local, &min_dt, 1, MPI_DOUBLE, MPI_MIN, MPI_COMM_WORLD);
+#endif
+
+  return ( min_dt == DBL_MAX ? 0. : min_dt );
+}   /*   END OF explicit_fill_time_step                                      */
+
+
    
 
 #endif /* not COUPLED_FILL */
@@ -4129,6 +4487,35 @@ assemble_fill_fake( double tt, double dt)
 /******************************************************************************/
 #ifndef COUPLED_FILL
 
+static void
+assemble_fill_lumped_mass(double rf[],	/* lumped mass of the fill unknowns */
+			  int node_to_fill[])
+
+/*
+ * Add this quadrature point's share of the integral of each fill basis
+ * function, i.e. the row sum of the consistent fill mass, into rf[].
+ */
+{
+  int i, I, ki, nvdofi, idof;
+  int eqn = R_FILL;
+  dbl wt_det;
+
+  if ( ! pd->e[eqn] ) return;
+
+  wt_det = fv->wt * bf[eqn]->detJ * fv->h3;
+
+  for ( i = 0; i < ei->num_local_nodes; i++ )
+    {
+      I = Proc_Elem_Connect[ei->iconnect_ptr + i];
+      nvdofi = get_nv_ndofs(Nodes[I]->Nodal_Vars_Info, eqn);
+      for ( ki = 0; ki < nvdofi; ki++ )
+	{
+	  idof = ei->ln_to_first_dof[eqn][i] + ki;
+	  rf[node_to_fill[I] + ki] += bf[eqn]->phi[idof] * wt_det;
+	}
+    }
+}
+
 int
 fill_matrix(double afill[],	/* matrix for fill variables only      */
 	    int ijaf[],		/* pointer to nonzeros in fill matrix  */
@@ -4315,6 +4702,8 @@ fill_matrix(double afill[],	/* matrix for fill variables only      */
 
 	      ielem = iel;
 
+	      if ( Fill_Band_Elem != NULL && !Fill_Band_Elem[iel] ) continue;
+
 	      /*
 	       * For each variable there are generally different degrees of
 	       * freedom that they and their equations contribute to.
@@ -4472,6 +4861,9 @@ fill_matrix(double afill[],	/* matrix for fill variables only      */
                                                      theta, node_to_fill);
 		      EH( err, "assemble_level_project");
 		      break;
+		    case LUMP:
+		      assemble_fill_lumped_mass(rf, node_to_fill);
+		      break;
 		    default:
 		      EH(-1,"Unknown equation in fill_matrix.\n");
 		    }
@@ -4485,7 +4877,7 @@ fill_matrix(double afill[],	/* matrix for fill variables only      */
 /********************************************************************************/
 	      /* Loop over all the surface Quadrature integration points */
 	      
-	      if(discontinuous)
+	      if( discontinuous && eqntype != LUMP )
 		{
 
 		  int neighbor;   /* element number of current elements neighbor  */
@@ -4554,7 +4946,7 @@ fill_matrix(double afill[],	/* matrix for fill variables only      */
 /*                   BOUNDARY CONDITIONS                                        */
 /********************************************************************************/
 
-	      if ( ls != NULL )
+	      if ( ls != NULL && eqntype != LUMP )
 		{
 
 		  struct elem_side_bc_struct *elem_side_bc = first_elem_side_BC_array[iel];
@@ -80,6 +80,14 @@ PROTO(( int ,
 	double *,
 	double ** ));
 
+static void fast_march_renormalization
+PROTO(( double *,
+	const int,
+	Exo_DB *,
+	Comm_Ex *,
+	Dpi *,
+	const double ));
+
 static struct LS_Surf_List * create_surfs_from_ns
 PROTO (( int, 
          double *,
@@ -130,7 +138,36 @@ PROTO(( const Exo_DB *,
 	const double *,
 	double       *,
 	double      [],
-	int ));
+	int ,
+	double       * ));
+static double find_LS_mass_local
+PROTO(( const Exo_DB *,
+	const Dpi    *,
+	const double *,
+	double       *,
+	double      [],
+	int ,
+	double       * ));
+
+static int ls_bulk_elems
+PROTO(( const Exo_DB *,
+	const Dpi    *,
+	const double *,
+	const int     ,
+	double      [],
+	double       * ));
+
+static void ls_sum_global
+PROTO(( double       *,
+	const int ));
+
+static int facet_distance_2d
+PROTO(( const double *,
+	const double *,
+	const double *,
+	double       *,
+	double       *,
+	double       * ));
 
 static void find_quad_facets
 PROTO (( struct LS_Surf_List *,
@@ -347,6 +384,89 @@ PROTO(( double *,
 
 
 #ifndef COUPLED_FILL
+/*
+ * The facets of the last interface as a flat array of end points, for the
+ * departure point distances of semi_lagrange_step(); NULL unless the list
+ * is the one isosurface of 2D facets it is built with.
+ */
+
+static double *
+sl_facet_points ( struct LS_Surf_List *list,
+		  int *num_facets )
+{
+  struct LS_Surf *surf;
+  double *p;
+  int n = 0;
+
+  if ( list == NULL || list->start == NULL || list->start->next != NULL ||
+       list->start->type != LS_SURF_ISOSURFACE ||
+       list->start->subsurf_list == NULL ||
+       list->start->subsurf_list->start == NULL ) return (NULL);
+
+  for ( surf = list->start->subsurf_list->start; surf != NULL; surf = surf->next )
+    {
+      if ( surf->type != LS_SURF_FACET ||
+	   ((struct LS_Surf_Facet_Data *) surf->data)->num_points != 2 ) return (NULL);
+      n++;
+    }
+
+  p = alloc_dbl_1( 4*n, DBL_NOINIT );
+
+  for ( surf = list->start->subsurf_list->start, n = 0; surf != NULL; surf = surf->next, n++ )
+    {
+      struct LS_Surf_Point_Data *s1 = (struct LS_Surf_Point_Data *) 
+                                      surf->subsurf_list->start->data;
+      struct LS_Surf_Point_Data *s2 = (struct LS_Surf_Point_Data *) 
+                                      surf->subsurf_list->start->next->data;
+
+      p[4*n]   = s1->x[0];
+      p[4*n+1] = s1->x[1];
+      p[4*n+2] = s2->x[0];
+      p[4*n+3] = s2->x[1];
+    }
+
+  *num_facets = n;
+  return (p);
+}
+
+/*
+ * closest_surf() over the facets of sl_facet_points(), with the same choice
+ * among nearly equidistant facets, but for the distance only and without
+ * writing into the surfaces.
+ */
+
+static double
+sl_facet_distance ( const double *p,
+		    const int num_facets,
+		    const double *r )
+{
+  int k;
+  double distance, fraction, confidence;
+  double closest_distance, closest_confidence;
+  double tol=1.e-5;
+
+  facet_distance_2d( p, p+2, r, &closest_distance, &fraction, &closest_confidence );
+
+  for ( k = 1; k < num_facets; k++ )
+    {
+      double abs_closest_distance, abs_distance;
+
+      facet_distance_2d( p+4*k, p+4*k+2, r, &distance, &fraction, &confidence );
+
+      abs_closest_distance = fabs( closest_distance );
+      abs_distance = fabs( distance );
+      if ( (( confidence == closest_confidence ) && ( abs_distance < abs_closest_distance )) ||
+           (( confidence < closest_confidence ) && ( abs_distance < (1.-tol)*abs_closest_distance )) ||
+           (( confidence > closest_confidence ) && ( abs_distance < (1.+tol)*abs_closest_distance )) )
+        {
+          closest_distance = distance;
+          closest_confidence = confidence;
+        }
+    }
+
+  return (closest_distance);
+}
+
 void
 semi_lagrange_step( const int num_total_nodes,
 		          int num_total_unknowns,
@@ -365,16 +485,18 @@ semi_lagrange_step( const int num_total_nodes,
 
 {
 
-  int inode, i;
+  int inode, i, k;
   int eqn = LS;
   int dim = pd->Num_Dim;
 
   int global_fill_unknowns;
 
-  int *ie_to_fill, *ext_dof;
-  double *F_, *R, *b, *dC;
+  int *ie_to_fill = NULL, *ext_dof = NULL;
+  double *F_ = NULL, *R = NULL, *b = NULL, *dC = NULL, *r_last = NULL;
+  double *facets;
+  int num_facets = 0;
 
-  double M0 = 0.0, global_LS_flux, M;
+  double M0 = 0.0, global_LS_flux, M = 0.0;
 
   double R_lamda, lamda, d_lamda, R_norm = 1.0, delta_norm = 1.0;
 
@@ -383,9 +505,6 @@ semi_lagrange_step( const int num_total_nodes,
 #ifdef PARALLEL
   int local_fill_unknowns = num_fill_unknowns;
 
-  double local_bTb, local_bTR, local_RTR ;
-  double global_bTb=0.0, global_bTR=0.0, global_RTR=0.0;
-
   exchange_dof( cx, dpi, x );
 
 #endif
@@ -405,22 +524,24 @@ semi_lagrange_step( const int num_total_nodes,
   dalloc( num_fill_unknowns, R );
   dalloc( num_fill_unknowns, b );
   dalloc( num_total_unknowns, dC );
+  dalloc( 2*num_fill_unknowns, r_last );
+
+  /*
+   * The departure point of each fill node first, then all their distances
+   * to the last interface - on the assembly threads when its facets can be
+   * searched without closest_surf(), which keeps its answer in the surfaces.
+   * The interface is the whole one on every processor (create_subsurfs()),
+   * so a departure point off this processor's elements needs no other.
+   */
 
   for( inode = 0 ; inode < num_total_nodes; inode++ )
     {
 
-      double r_node[DIM];
       double v_node[DIM];
-      double r_last[DIM];
-
-      struct LS_Surf *closest;
-
-      double distance; 
 
       if ( num_varType_at_node( inode, eqn ) == 1 )
 	{
-	  r_node[0] = Coor[0][inode];
-	  r_node[1] = Coor[1][inode];
+	  k = node_to_fill[inode];
 
 	  if ( ( num_varType_at_node( inode, VELOCITY1) == 1 ) && 
 	       ( num_varType_at_node( inode, VELOCITY2) == 1 )  )
@@ -433,17 +554,10 @@ semi_lagrange_step( const int num_total_nodes,
 	      EH(-1, "Need equal interpolation order LS and VELOCITY1, VELOCITY2 for SEMI_LAGRANGE.\n" );
 	    }
 
-	  r_last[0] = r_node[0] - v_node[0]* delta_t;
-	  r_last[1] = r_node[1] - v_node[1]* delta_t;
+	  r_last[2*k]   = Coor[0][inode] - v_node[0]* delta_t;
+	  r_last[2*k+1] = Coor[1][inode] - v_node[1]* delta_t;
 
-
-	  closest = closest_surf ( ls->last_surf_list, x, exo, r_last );
-
-	  distance = closest->closest_point->distance;
-
-	  F_[ node_to_fill[inode] ] = distance;
-
-	  ie_to_fill[ node_to_fill[inode] ] =  Index_Solution( inode, ls->var, 0,  0, -2);
+	  ie_to_fill[k] =  Index_Solution( inode, ls->var, 0,  0, -2);
 
 #ifdef PARALLEL
 	  /* Here we set up the array ext_dof which tells me whether this dof belong to me or no */
@@ -451,7 +565,7 @@ semi_lagrange_step( const int num_total_nodes,
 	    {
 	      if (inode >  ( dpi->num_internal_nodes + dpi->num_boundary_nodes - 1 ) ) 
 		{
-		  ext_dof[ node_to_fill[inode] ] = TRUE; 
+		  ext_dof[k] = TRUE; 
 		  local_fill_unknowns -= 1;
 		}
 	    }
@@ -460,6 +574,37 @@ semi_lagrange_step( const int num_total_nodes,
 	}
       
     }
+
+  facets = sl_facet_points( ls->last_surf_list, &num_facets );
+
+  if ( facets != NULL )
+    {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 256) if (Num_Assembly_Threads > 1) num_threads(MAX(Num_Assembly_Threads, 1))
+#endif
+      for ( k = 0; k < num_fill_unknowns; k++ )
+	{
+	  F_[k] = sl_facet_distance( facets, num_facets, &r_last[2*k] );
+	}
+      safer_free( (void **) &facets );
+    }
+  else
+    {
+      for ( k = 0; k < num_fill_unknowns; k++ )
+	{
+	  double r[DIM];
+	  struct LS_Surf *closest;
+
+	  r[0] = r_last[2*k];
+	  r[1] = r_last[2*k+1];
+	  r[2] = 0.0;
+
+	  closest = closest_surf ( ls->last_surf_list, x, exo, r );
+
+	  F_[k] = closest->closest_point->distance;
+	}
+    }
+
 #ifdef PARALLEL
   if ( Num_Proc > 1 )
     {
@@ -477,125 +622,96 @@ semi_lagrange_step( const int num_total_nodes,
 		      NULL,
 		      dC,
 		      x,
-		      num_total_unknowns );
-
-  global_LS_flux = find_LS_global_flux ( exo,
-					 dpi,
-					 NULL,
-					 NULL,
-					 x,
-					 num_total_unknowns );
-
-
+		      num_total_unknowns,
+		      &global_LS_flux );
 
   M0 -= global_LS_flux * delta_t;
 
 
 
 
-  R_lamda = lamda = 0.0;
+  R_lamda = lamda = d_lamda = 0.0;
 
   max_its = 10;
 
   DPRINTF(stderr, "\n\t   L_2 in R   L_2 in dx   |dM| \n");
   DPRINTF(stderr, "\t  ---------  ---------   --------\n");
 
+  /*
+   * Each pass sums, in one reduction, the dot products of the next update
+   * together with the size of the last one and the mass it left, which
+   * decide whether there is to be a next one.
+   */
+
+  delta_norm = 0.0;
 
-  while (delta_norm >= 1.e-5 && max_its > 0 )
+  for ( ;; )
     {
-      int k;
-      double bTb, bTR, RTR;
+      double dots[5];
 
-      for ( k=0, bTb=bTR=RTR=0.0; k<num_fill_unknowns; k++ )
+      for ( k=0, dots[0]=dots[1]=dots[2]=0.0; k<num_fill_unknowns; k++ )
 	{
 	  b[k] = dC[ ie_to_fill[k] ];
 	  R[k] = 2.0 * ( F[k] - F_[k] ) + lamda*b[k];
 
 	  if ( ext_dof[k] == FALSE )
 	    {
-	      bTb += b[k]*b[k];
-	      bTR += b[k]*R[k];
-	      RTR += R[k]*R[k];
+	      dots[0] += b[k]*b[k];
+	      dots[1] += b[k]*R[k];
+	      dots[2] += R[k]*R[k];
 	    }
 	}
 
+      dots[3] = delta_norm;
+      dots[4] = M;
 
-#ifdef PARALLEL
-
+      ls_sum_global( dots, 5 );
 
-      if( Num_Proc > 1 )
+      if ( max_its < 10 )
 	{
+	  delta_norm = sqrt(dots[3])/global_fill_unknowns + sqrt( d_lamda*d_lamda );
 
-	  local_bTb = bTb; 
-	  local_bTR = bTR; 
-	  local_RTR = RTR; 
-
+	  R_lamda = dots[4] - M0;
 
-	  MPI_Allreduce( &local_bTb, &global_bTb, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-	  bTb = global_bTb;
+	  DPRINTF(stderr, "%10.2e   %10.2e \n",delta_norm, fabs( R_lamda ) );   
 
- 	  MPI_Allreduce( &local_bTR, &global_bTR, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD); 
- 	  bTR = global_bTR;
-
- 	  MPI_Allreduce( &local_RTR, &global_RTR, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD); 
-
- 	  RTR = global_RTR;
-	  
+	  if ( delta_norm < 1.e-5 || max_its == 0 ) break;
 	}
 
-#endif
-
-      R_norm = sqrt( fabs(RTR) )/global_fill_unknowns + fabs(R_lamda);
+      R_norm = sqrt( fabs(dots[2]) )/global_fill_unknowns + fabs(R_lamda);
 
       DPRINTF(stderr, "\t%10.2e ", R_norm);
 
-      d_lamda = ( 2.0*R_lamda - bTR )/bTb;
+      d_lamda = ( 2.0*R_lamda - dots[1] )/dots[0];
 
  
       for ( k = 0, delta_norm = 0.0 ; k< num_fill_unknowns; k++)
 	{
-	  F[k] += -0.5*R[k] - 0.5*b[k]*d_lamda;
+	  double dF = -0.5*R[k] - 0.5*b[k]*d_lamda;
+
+	  F[k] += dF;
 
 	  x[ ie_to_fill[k] ] = F[k];
 
-	  if( ext_dof[k] == FALSE ) delta_norm += pow( -0.5*R[k] - 0.5*b[k]*d_lamda, 2.0 );
+	  if( ext_dof[k] == FALSE ) delta_norm += dF*dF;
 	}
 
       lamda += d_lamda;
 
-
 #ifdef PARALLEL
-      if ( Num_Proc > 1 )
-	{
-	  double global_delta_norm=0.0, local_delta_norm;
-
-	  local_delta_norm = delta_norm;
-
-	  MPI_Allreduce( &local_delta_norm, &global_delta_norm, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-	  delta_norm = global_delta_norm;
-	}
-
       exchange_dof( cx, dpi, x );
 #endif
-	  
-      
-      delta_norm = sqrt(delta_norm)/global_fill_unknowns + sqrt( d_lamda*d_lamda );
-
-
-      M = find_LS_mass ( exo,
-			 dpi,
-			 NULL,
-			 dC,
-			 x,
-			 num_total_unknowns);
-
 
-      R_lamda = M - M0;
+      M = find_LS_mass_local ( exo,
+			       dpi,
+			       NULL,
+			       dC,
+			       x,
+			       num_total_unknowns,
+			       NULL );
 
       max_its--;
 
-      DPRINTF(stderr, "%10.2e   %10.2e \n",delta_norm, fabs( M - M0) );   
-
     }
 
   if( max_its == 0 ) 
@@ -609,6 +725,13 @@ semi_lagrange_step( const int num_total_nodes,
 	2.0 * theta * Fdot_old[i];
     }
 
+  safer_free( (void **) &ext_dof );
+  safer_free( (void **) &ie_to_fill );
+  safer_free( (void **) &F_ );
+  safer_free( (void **) &R );
+  safer_free( (void **) &b );
+  safer_free( (void **) &dC );
+  safer_free( (void **) &r_last );
 }
       
 #endif /* COUPLED_FILL */
@@ -929,6 +1052,8 @@ huygens_renormalization ( double *x,
   int status = 1;
   double renorm_width = ls->Length_Scale*ls->Control_Width;
 
+  timer_push("ls renormalization");
+
   if ( ls->Length_Scale == 0. )
     {
       renorm_width =
@@ -983,6 +1108,10 @@ huygens_renormalization ( double *x,
 		  Hrenorm_constrain( exo, cx, dpi, x, list, num_total_nodes, 
 								num_ls_unkns, num_total_unkns, time );
 	  }
+	  else if ( ls->Renorm_Method == FAST_MARCH )
+	  {
+		  fast_march_renormalization( x, num_total_nodes, exo, cx, dpi, s->isoval );
+	  }
 	  else
 	  {
 		  EH(-1,"You shouldn't actually be here. \n");
@@ -1017,9 +1146,318 @@ huygens_renormalization ( double *x,
 			   ls_err, tolerance);
   }
   
+  timer_pop("ls renormalization");
   return(status);
 
 }
+
+/******************************************************************************
+ * Fast marching redistancing (Level Set Renormalization Method =
+ * Fast_Marching).
+ *
+ * Rather than the distance of every node to every facet of a gathered
+ * isosurface, each node carries the closest point on the interface found
+ * so far and hands it to its neighbors in order of increasing distance,
+ * a Dijkstra sweep over the node->node graph with the distance to the
+ * handed-on point as the key.  The nodes of the elements the interface
+ * crosses are seeded from a linear fit of the level set on the element.
+ * With a band, marching stops there and farther nodes get +/- band.
+ *
+ * In parallel each processor marches its own nodes and ghosts; the
+ * closest points of the owned nodes are then sent to their ghosts and
+ * the sweep resumed from any ghost that improved, until none does.  Only
+ * the halo moves, no surface is gathered.
+ ******************************************************************************/
+
+static void
+fm_heap_up(int *heap, int *pos, const double *d, int k)
+{
+  int node = heap[k], parent;
+
+  while (k > 0) {
+    parent = (k - 1) / 2;
+    if (d[heap[parent]] <= d[node]) break;
+    heap[k] = heap[parent];
+    pos[heap[k]] = k;
+    k = parent;
+  }
+  heap[k] = node;
+  pos[node] = k;
+}
+
+static void
+fm_heap_down(int *heap, int *pos, const double *d, const int n, int k)
+{
+  int node = heap[k], child;
+
+  while ((child = 2 * k + 1) < n) {
+    if (child + 1 < n && d[heap[child+1]] < d[heap[child]]) child++;
+    if (d[node] <= d[heap[child]]) break;
+    heap[k] = heap[child];
+    pos[heap[k]] = k;
+    k = child;
+  }
+  heap[k] = node;
+  pos[node] = k;
+}
+
+/*
+ * Put node I on the heap, or move it up after its key went down.
+ */
+static void
+fm_heap_push(int *heap, int *pos, const double *d, int *n, const int I)
+{
+  if (pos[I] < 0) {
+    heap[*n] = I;
+    pos[I] = (*n)++;
+  }
+  fm_heap_up(heap, pos, d, pos[I]);
+}
+
+/*
+ * Sweep out from the nodes on the heap until it is empty. Returns the
+ * number of nodes whose distance went down.
+ */
+static int
+fm_sweep(Exo_DB *exo, const double *r, const int *ie_ls, const double band,
+	 double *d, double *cp, int *heap, int *pos, int *n)
+{
+  int I, J, k, a, changed = 0;
+  double dist;
+
+  while (*n > 0) {
+    I = heap[0];
+    pos[I] = -1;
+    (*n)--;
+    if (*n > 0) {
+      heap[0] = heap[*n];
+      pos[heap[0]] = 0;
+      fm_heap_down(heap, pos, d, *n, 0);
+    }
+
+    for (k = exo->node_node_pntr[I]; k < exo->node_node_pntr[I+1]; k++) {
+      J = exo->node_node_list[k];
+      if (J == I || ie_ls[J] == -1) continue;
+      dist = 0.;
+      for (a = 0; a < 3; a++) {
+	dist += (r[3*J+a] - cp[3*I+a]) * (r[3*J+a] - cp[3*I+a]);
+      }
+      dist = sqrt(dist);
+      if (dist >= d[J] * (1. - 1.e-12) || (band > 0. && dist > band)) continue;
+      d[J] = dist;
+      for (a = 0; a < 3; a++) cp[3*J+a] = cp[3*I+a];
+      fm_heap_push(heap, pos, d, n, J);
+      changed++;
+    }
+  }
+  return changed;
+}
+
+/*
+ * Closest points for the nodes of the elements the interface crosses, from
+ * the least squares linear fit phi = c + g.(r - rc) over the element.
+ */
+static void
+fm_seed(Exo_DB *exo, const double *r, const double *phi, const int *ie_ls,
+	double *d, double *cp)
+{
+  int e, k, I, a, b, m, n, dim = pd->Num_Dim;
+  int nodes[MDE];
+  int piv;
+  double rc[3], A[4][5], g[3], g2, f, dist;
+
+  for (e = 0; e < exo->num_elems; e++) {
+    double pmin = 0., pmax = 0.;
+
+    n = 0;
+    for (k = exo->elem_node_pntr[e]; k < exo->elem_node_pntr[e+1] && n < MDE; k++) {
+      I = exo->elem_node_list[k];
+      if (ie_ls[I] == -1) continue;
+      if (n == 0 || phi[I] < pmin) pmin = phi[I];
+      if (n == 0 || phi[I] > pmax) pmax = phi[I];
+      nodes[n++] = I;
+    }
+    if (n < dim + 1 || pmin > 0. || pmax < 0. || pmin == pmax) continue;
+
+    for (a = 0; a < 3; a++) {
+      rc[a] = 0.;
+      for (k = 0; k < n; k++) rc[a] += r[3*nodes[k]+a] / n;
+    }
+
+    /* normal equations for (c, g) */
+    m = dim + 1;
+    memset(A, 0, sizeof(A));
+    for (k = 0; k < n; k++) {
+      double b_k[4];
+      I = nodes[k];
+      b_k[0] = 1.;
+      for (a = 0; a < dim; a++) b_k[a+1] = r[3*I+a] - rc[a];
+      for (a = 0; a < m; a++) {
+	for (b = 0; b < m; b++) A[a][b] += b_k[a] * b_k[b];
+	A[a][m] += b_k[a] * phi[I];
+      }
+    }
+    for (a = 0; a < m; a++) {
+      for (piv = a, b = a + 1; b < m; b++) {
+	if (fabs(A[b][a]) > fabs(A[piv][a])) piv = b;
+      }
+      if (piv != a) {
+	for (b = 0; b <= m; b++) {
+	  f = A[a][b];
+	  A[a][b] = A[piv][b];
+	  A[piv][b] = f;
+	}
+      }
+      if (fabs(A[a][a]) < 1.e-300) break;
+      for (b = a + 1; b < m; b++) {
+	f = A[b][a] / A[a][a];
+	for (k = a; k <= m; k++) A[b][k] -= f * A[a][k];
+      }
+    }
+    if (a < m) continue;
+    for (a = m - 1; a >= 0; a--) {
+      for (b = a + 1; b < m; b++) A[a][m] -= A[a][b] * A[b][m];
+      A[a][m] /= A[a][a];
+    }
+
+    g2 = 0.;
+    for (a = 0; a < 3; a++) {
+      g[a] = (a < dim) ? A[a+1][m] : 0.;
+      g2 += g[a] * g[a];
+    }
+    if (g2 <= 0.) continue;
+
+    for (k = 0; k < n; k++) {
+      I = nodes[k];
+      dist = fabs(phi[I]) / sqrt(g2);
+      if (dist >= d[I]) continue;
+      d[I] = dist;
+      for (a = 0; a < 3; a++) cp[3*I+a] = r[3*I+a] - phi[I] * g[a] / g2;
+    }
+  }
+}
+
+static void
+fast_march_renormalization ( double *x,
+			     const int num_total_nodes,
+			     Exo_DB *exo,
+			     Comm_Ex *cx,
+			     Dpi *dpi,
+			     const double isoval )
+{
+  int I, n = 0;
+  int *ie_ls, *heap, *pos;
+  double *r, *phi, *d, *cp, band = ls->Renorm_Band;
+
+  if ( !exo->node_node_conn_exists )
+    {
+      EH(-1, "Fast_Marching renormalization needs the node->node connectivity");
+    }
+
+  ie_ls = alloc_int_1(num_total_nodes, -1);
+  heap  = alloc_int_1(num_total_nodes, -1);
+  pos   = alloc_int_1(num_total_nodes, -1);
+  r     = alloc_dbl_1(3*num_total_nodes, 0.);
+  cp    = alloc_dbl_1(3*num_total_nodes, 0.);
+  phi   = alloc_dbl_1(num_total_nodes, 0.);
+  d     = alloc_dbl_1(num_total_nodes, BIG_PENALTY);
+
+  for ( I = 0; I < num_total_nodes; I++ )
+    {
+      ie_ls[I] = Index_Solution( I, ls->var, 0, 0, -2 );
+      if ( ie_ls[I] == -1 ) continue;
+      retrieve_node_coordinates( I, x, r + 3*I, NULL );
+      phi[I] = x[ie_ls[I]] - isoval;
+    }
+
+  fm_seed( exo, r, phi, ie_ls, d, cp );
+
+  for ( I = 0; I < num_total_nodes; I++ )
+    {
+      if ( d[I] < BIG_PENALTY ) fm_heap_push( heap, pos, d, &n, I );
+    }
+  fm_sweep( exo, r, ie_ls, band, d, cp, heap, pos, &n );
+
+#ifdef PARALLEL
+  if ( Num_Proc > 1 )
+    {
+      int a, changed, iter;
+      int num_owned = dpi->num_internal_nodes + dpi->num_boundary_nodes;
+      int num_ext = num_total_nodes - num_owned;
+      double *d_ext  = alloc_dbl_1(MAX(num_ext, 1), 0.);
+      double *cp_ext = alloc_dbl_1(MAX(3*num_ext, 1), 0.);
+      double *cpa[3], *vecs[4];
+
+      for ( a = 0; a < 3; a++ ) cpa[a] = alloc_dbl_1(num_total_nodes, 0.);
+      vecs[0] = d;
+      vecs[1] = cpa[0];
+      vecs[2] = cpa[1];
+      vecs[3] = cpa[2];
+
+      for ( iter = 0; iter < 100; iter++ )
+	{
+	  int global_changed = 0;
+
+	  for ( I = 0; I < num_total_nodes; I++ )
+	    {
+	      for ( a = 0; a < 3; a++ ) cpa[a][I] = cp[3*I+a];
+	    }
+	  for ( I = num_owned; I < num_total_nodes; I++ )
+	    {
+	      d_ext[I-num_owned] = d[I];
+	      for ( a = 0; a < 3; a++ ) cp_ext[3*(I-num_owned)+a] = cp[3*I+a];
+	    }
+
+	  exchange_node_multi( cx, dpi, 4, vecs );
+
+	  /* keep the better of the ghost's own value and its owner's */
+	  changed = 0;
+	  for ( I = num_owned; I < num_total_nodes; I++ )
+	    {
+	      if ( ie_ls[I] == -1 ) continue;
+	      if ( d[I] < d_ext[I-num_owned] * (1. - 1.e-12) )
+		{
+		  for ( a = 0; a < 3; a++ ) cp[3*I+a] = cpa[a][I];
+		  fm_heap_push( heap, pos, d, &n, I );
+		  changed++;
+		}
+	      else
+		{
+		  d[I] = d_ext[I-num_owned];
+		  for ( a = 0; a < 3; a++ ) cp[3*I+a] = cp_ext[3*(I-num_owned)+a];
+		}
+	    }
+	  changed += fm_sweep( exo, r, ie_ls, band, d, cp, heap, pos, &n );
+
+	  MPI_Allreduce(&changed, &global_changed, 1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+	  if ( global_changed == 0 ) break;
+	}
+
+      /* and the ghosts end up with exactly their owners' values */
+      exchange_node( cx, dpi, d );
+
+      for ( a = 0; a < 3; a++ ) safe_free( cpa[a] );
+      safe_free( d_ext );
+      safe_free( cp_ext );
+    }
+#endif
+
+  for ( I = 0; I < num_total_nodes; I++ )
+    {
+      if ( ie_ls[I] == -1 ) continue;
+      if ( band > 0. && d[I] > band ) d[I] = band;
+      x[ie_ls[I]] = ( phi[I] < 0. ) ? -d[I] : d[I];
+    }
+
+  safe_free( ie_ls );
+  safe_free( heap );
+  safe_free( pos );
+  safe_free( r );
+  safe_free( cp );
+  safe_free( phi );
+  safe_free( d );
+}
+
 #ifndef COUPLED_FILL 
 /***************************************************************************************/
 /***************************************************************************************/
@@ -2066,6 +2504,85 @@ closest_surf ( struct LS_Surf_List *list,
 return ( closest );
 }
 
+/*
+ * Signed distance from r to the 2D facet p1 -> p2, the fraction of the way
+ * along it of the closest point and the confidence in the sign; only reads
+ * its arguments, so it may be called from several threads at once.
+ *
+ * Return: 1 if the closest point is p1, 2 if it is p2, 0 if in between
+ */
+
+static int
+facet_distance_2d ( const double *p1,
+		    const double *p2,
+		    const double *r,
+		    double *distance,
+		    double *fraction,
+		    double *confidence )
+{
+  int end = 0;
+  double ray[2], d[2], ray_normal[2];
+  double ray_mag_squared, d_dot_ray, d_dot_n;
+
+  ray[0] = p2[0] - p1[0];
+  ray[1] = p2[1] - p1[1];
+  ray_mag_squared = ray[0]*ray[0] + ray[1]*ray[1];
+
+  /* if the points p1 and p2 are oriented correctly
+     (i.e. proceeding counterclockwise around body),
+     ray_normal points toward positive distance
+     (in my view this is an outward facing normal)
+  */
+
+  ray_normal[0] = ray[1];
+  ray_normal[1] = -ray[0];
+  normalize_really_simple_vector( ray_normal, 2 );
+
+  d[0] = r[0] - p1[0];
+  d[1] = r[1] - p1[1];
+
+  d_dot_ray = dot_product( 2, d, ray );
+
+  if (d_dot_ray <= 0.) /* we are closest to point p1 */
+    {
+      *fraction = 0.;
+      end = 1;
+    }
+  else
+    {
+      if (d_dot_ray >= ray_mag_squared) /* we are closest to point p2 */
+	{
+	  *fraction = 1.;
+	  d[0] -= ray[0];
+	  d[1] -= ray[1];
+	  end = 2;
+	}
+      else /* we are closest to some point on the segment */
+	{
+	  *fraction = d_dot_ray / ray_mag_squared;
+	  d[0] -= *fraction * ray[0];
+	  d[1] -= *fraction * ray[1];
+	}
+    }
+
+  *distance = sqrt(d[0]*d[0] + d[1]*d[1]);
+  d_dot_n = dot_product( 2, d, ray_normal );
+  if (d_dot_n < 0) *distance *= -1.;
+
+  /* confidence based on angle between ray_normal and d */
+  if ( ( *distance == 0. ) ||
+       (( *fraction > 0.) && ( *fraction < 1. )) )
+    {
+      *confidence = 1.;
+    }
+  else
+    {
+      *confidence = d_dot_n / *distance;
+    }
+
+  return (end);
+}
+
 void
 find_surf_closest_point ( struct LS_Surf *surf,
 		          double *x,
@@ -2191,10 +2708,8 @@ find_surf_closest_point ( struct LS_Surf *surf,
       
     case LS_SURF_FACET :
       {
-	int a;
-	double ray[2], d[2], ray_normal[2], fraction;
-        double ray_mag_squared, d_dot_ray, d_dot_n;
-        double distance;
+	int a, end;
+	double fraction;
 
         struct LS_Surf_Facet_Data *s = (struct LS_Surf_Facet_Data *) surf->data;
         
@@ -2204,54 +2719,22 @@ find_surf_closest_point ( struct LS_Surf *surf,
                                             surf->subsurf_list->start->data;
             struct LS_Surf_Point_Data *s2 = (struct LS_Surf_Point_Data *) 
                                             surf->subsurf_list->start->next->data;
-            double *p1 = s1->x;
-            double *p2 = s2->x;
-        
-            ray[0] = p2[0] - p1[0];
-            ray[1] = p2[1] - p1[1];
-            ray_mag_squared = ray[0]*ray[0] + ray[1]*ray[1];
- 
-            /* if the points p1 and p2 are oriented correctly
-               (i.e. proceeding counterclockwise around body),
-               ray_normal points toward positive distance
-               (in my view this is an outward facing normal)
-             */
- 
-            ray_normal[0] = ray[1];
-            ray_normal[1] = -ray[0];
-            normalize_really_simple_vector( ray_normal, 2 );
- 
-            d[0] = r[0] - p1[0];
-            d[1] = r[1] - p1[1];
- 
-            d_dot_ray = dot_product( 2, d, ray );
- 
-            if (d_dot_ray <= 0.) /* we are closest to point p1 */
+
+            end = facet_distance_2d( s1->x, s2->x, r, &cp->distance,
+				     &fraction, &cp->confidence );
+
+            if ( end == 1 )
               {
-                fraction = 0.;
                 cp->inflection = s1->inflection;
               }
-            else
+            else if ( end == 2 )
               {
-                if (d_dot_ray >= ray_mag_squared) /* we are closest to point p2 */
-                  {
-                    fraction = 1.;
-                    d[0] -= ray[0];
-                    d[1] -= ray[1];
-                    cp->inflection = s2->inflection;
-                  }
-                else /* we are closest to some point on the segment */
-                  {
-                    fraction = d_dot_ray / ray_mag_squared;
-                    d[0] -= fraction * ray[0];
-                    d[1] -= fraction * ray[1];
-                    if ( s1->inflection && s2->inflection ) cp->inflection = TRUE;
-                  }
+                cp->inflection = s2->inflection;
+              }
+            else if ( s1->inflection && s2->inflection )
+              {
+                cp->inflection = TRUE;
               }
-	      
-	    distance = sqrt(d[0]*d[0] + d[1]*d[1]);
-	    d_dot_n = dot_product( 2, d, ray_normal );
-	    if (d_dot_n < 0) distance *= -1.;
  
             /* put together the mapping for this facet
              */
@@ -2265,17 +2748,6 @@ find_surf_closest_point ( struct LS_Surf *surf,
                 cp->xi[a] = (1.-fraction)*s1->xi[a] + fraction*s2->xi[a];
               }
  
-            /* confidence based on angle between ray_normal and d */
-            if ( ( distance == 0. ) ||
-	         (( fraction > 0.) && ( fraction < 1. )) )
-              {
-                cp->confidence = 1.;
-              }
-            else
-              {
-                cp->confidence = d_dot_n / distance;
-              }
-            cp->distance = distance;
           }
 	else
 	  {
@@ -2707,11 +3179,8 @@ create_surfs_from_iso (int isovar,
 			{
 			  SGRID *sgrid;
 			  
-			  if ( ntree == NULL ) 
-			    {
-			      ntree = create_shape_fcn_tree ( ls->Grid_Search_Depth );
-/* 			      print_shape_fcn_tree ( ntree ); */
-			    }
+			  ntree = shape_fcn_tree_for_elem ( ls->Grid_Search_Depth );
+/* 			  print_shape_fcn_tree ( ntree ); */
 
 			  sgrid = create_search_grid ( ntree  );
 
@@ -2748,12 +3217,6 @@ create_surfs_from_iso (int isovar,
 	}
     }
 
-  if ( ntree != NULL ) 
-    {
-      free_shape_fcn_tree( ntree );
-      ntree = NULL;
-    }
-
 	isosurf_exists = ( list->size == 0 ) ? FALSE : TRUE;
 
 	if( Num_Proc > 1 )
@@ -3416,13 +3879,6 @@ Hrenorm_constrain( Exo_DB *exo,
   int global_ls_unkns = num_ls_unkns;
 #ifdef PARALLEL
   int *ext_dof = NULL; 
-  double local_bTb = 0.;
-  double local_bTR = 0.;
-  double local_RTR = 0.;
-
-  double global_bTb = 0.;
-  double global_bTR = 0.;
-  double global_RTR = 0.;
 
   MPI_Allreduce( &num_ls_unkns, &global_ls_unkns, 1, MPI_INT, MPI_SUM,  MPI_COMM_WORLD);
 
@@ -3487,7 +3943,8 @@ Hrenorm_constrain( Exo_DB *exo,
 		      NULL,
 		      dC,
 		      x,
-		      num_total_unkns);
+		      num_total_unkns,
+		      NULL );
 
   if( ls->Mass_Value != 0.0) M0 = ls->Mass_Value;
 
@@ -3521,28 +3978,20 @@ Hrenorm_constrain( Exo_DB *exo,
 
 
 
-#ifdef PARALLEL
-      if( Num_Proc > 1 )
-	{
-	  local_bTb = bTb; 
-	  local_bTR = bTR; 
-	  local_RTR = RTR; 
-
-
-	  MPI_Allreduce( &local_bTb, &global_bTb, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
-	  bTb = global_bTb;
-
- 	  MPI_Allreduce( &local_bTR, &global_bTR, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD); 
- 	  bTR = global_bTR;
+      {
+	double dots[3];
 
- 	  MPI_Allreduce( &local_RTR, &global_RTR, 1, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD); 
+	dots[0] = bTb;
+	dots[1] = bTR;
+	dots[2] = RTR;
 
- 	  RTR = global_RTR;
-	  
-	}
+	ls_sum_global( dots, 3 );
 
+	bTb = dots[0];
+	bTR = dots[1];
+	RTR = dots[2];
+      }
 
-#endif
       norm = sqrt( fabs(RTR) )/global_ls_unkns + fabs(R_lamda);
 
       d_lamda = ( 2.0*R_lamda - bTR )/bTb;
@@ -3565,7 +4014,8 @@ Hrenorm_constrain( Exo_DB *exo,
 			 NULL,
 			 dC,
 			 x,
-			 num_total_unkns);
+			 num_total_unkns,
+			 NULL );
 
 
 
@@ -3587,16 +4037,203 @@ Hrenorm_constrain( Exo_DB *exo,
   return (TRUE);
 }
 
+/*
+ * The mass of the level set corrections is wanted ten times or more per
+ * correction, with F changing each time, but only the elements near the
+ * interface need the quadrature: one lying more than alpha/2 on the
+ * positive side has H = 1 at every point and so adds just its volume to
+ * I_POS_FILL and nothing to I_NEG_FILL, the other way round on the
+ * negative side, and neither adds to the sensitivities. ls_bulk_elems()
+ * flags those elements in LS_Bulk and returns in *bulk what they add to
+ * quantity, from the element volumes it keeps in LS_Elem_Vol. It returns
+ * FALSE, and flags nothing, where a volume can change between calls
+ * (moving mesh, lubrication height) or the integration weights depend on
+ * F (adaptive integration).
+ */
+
+static int *LS_Bulk = NULL;
+static double *LS_Elem_Vol = NULL;
+
+static int
+ls_bulk_elems ( const Exo_DB *exo,
+		const Dpi *dpi,
+		const double *params,
+		const int quantity,
+		double x[],
+		double *bulk )
+{
+  int eb, mn, elem, i, I, err;
+  double alpha = 0.5 * ( params == NULL ? ls->Length_Scale : 2.0*params[0] );
+
+  *bulk = 0.0;
+
+  if ( ls->AdaptIntegration ) return (FALSE);
+
+  for ( eb = 0; eb < exo->num_elem_blocks; eb++ )
+    {
+      mn = Matilda[eb];
+      if ( mn < 0 || !pd_glob[mn]->e[ls->var] ) continue;
+      if ( pd_glob[mn]->v[MESH_DISPLACEMENT1] || pd_glob[mn]->v[LUBP] ||
+	   pd_glob[mn]->v[LUBP_2] ) return (FALSE);
+    }
+
+  if ( LS_Bulk == NULL )
+    {
+      LS_Bulk = (int *) smalloc( exo->num_elems*sizeof(int) );
+      LS_Elem_Vol = (double *) smalloc( exo->num_elems*sizeof(double) );
+      for ( elem = 0; elem < exo->num_elems; elem++ ) LS_Elem_Vol[elem] = -1.0;
+    }
+
+  for ( eb = 0; eb < exo->num_elem_blocks; eb++ )
+    {
+      int interp, dofs;
+      double margin;
+
+      mn = Matilda[eb];
+      interp = mn < 0 ? I_NOTHING : pd_glob[mn]->i[ls->var];
+
+      /*
+       * Nodal values bound a linear F over the element; a quadratic one
+       * can overshoot them, but by less than their spread.
+       */
+      if ( interp == I_Q1 ) margin = 0.0;
+      else if ( interp == I_Q2 || interp == I_S2 ) margin = 1.0;
+      else margin = -1.0;
+
+      for ( elem = exo->eb_ptr[eb]; elem < exo->eb_ptr[eb+1]; elem++ )
+	{
+	  double f, fmin, fmax;
+
+	  LS_Bulk[elem] = 0;
+	  if ( margin < 0.0 || !pd_glob[mn]->e[ls->var] ) continue;
+
+	  dofs = getdofs( type2shape( Elem_Type( exo, elem ) ), interp );
+
+	  fmin = DBL_MAX;
+	  fmax = -DBL_MAX;
+	  for ( i = 0; i < dofs; i++ )
+	    {
+	      I = exo->node_list[ exo->elem_ptr[elem] + i ];
+	      f = x[ Index_Solution( I, ls->var, 0, 0, -2 ) ];
+	      fmin = MIN( fmin, f );
+	      fmax = MAX( fmax, f );
+	    }
+	  f = margin * ( fmax - fmin );
+
+	  if ( fmin - f > alpha && fmin - f > 0.0 ) LS_Bulk[elem] = 1;
+	  else if ( fmax + f < -alpha && fmax + f < 0.0 ) LS_Bulk[elem] = -1;
+	  else continue;
+
+	  if ( ( LS_Bulk[elem] > 0 ) != ( quantity == I_POS_FILL ) ) continue;
+#ifdef PARALLEL
+	  if ( Num_Proc > 1 && dpi->elem_owner[elem] != ProcID ) continue;
+#endif
+
+	  if ( LS_Elem_Vol[elem] < 0.0 )
+	    {
+	      int ip, ip_total;
+	      double xi[3], vol = 0.0;
+
+	      ei->ielem = elem;
+	      err = load_elem_dofptr( elem, (Exo_DB *) exo, x, x, x, x, x, 0 );
+	      EH( err, "load_elem_dofptr" );
+
+	      err = bf_mp_init( pd );
+	      EH( err, "bf_mp_init" );
+
+	      ip_total = elem_info( NQUAD, ei->ielem_type );
+	      for ( ip = 0; ip < ip_total; ip++ )
+		{
+		  find_stu( ip, ei->ielem_type, &xi[0], &xi[1], &xi[2] );
+		  fv->wt = Gq_weight( ip, ei->ielem_type );
+
+		  err = load_basis_functions( xi, bfd );
+		  EH( err, "problem from load_basis_functions" );
+
+		  err = beer_belly();
+		  EH( err, "beer_belly" );
+
+		  err = load_fv();
+		  EH( err, "load_fv" );
+
+		  compute_volume_integrand( I_VOLUME, elem, 0, NULL, 0, &vol, NULL,
+					    FALSE, 0.0, 0.0, xi, exo );
+		}
+	      LS_Elem_Vol[elem] = vol;
+	    }
+	  *bulk += LS_Elem_Vol[elem];
+	}
+    }
+
+  return (TRUE);
+}
+
+/*
+ * Sum n of this processor's values over all of them, in one reduction.
+ */
+
+static void
+ls_sum_global ( double *v,
+		const int n )
+{
+#ifdef PARALLEL
+  if ( Num_Proc > 1 )
+    {
+      int i;
+      double w[8];
+
+      if ( n > 8 ) EH( -1, "ls_sum_global: too many sums." );
+
+      MPI_Allreduce( v, w, n, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD );
+      for ( i = 0; i < n; i++ ) v[i] = w[i];
+    }
+#endif
+}
+
+/*
+ * Level set mass, from the elements near the interface and the volumes of
+ * the rest, and - if flux is not NULL - the level set flux through the
+ * boundary with it, all in one reduction.
+ */
+
 static double
 find_LS_mass ( const Exo_DB *exo,
 	       const Dpi *dpi,
 	       const double *params,
 	       double *dC,
 	       double x[],
-	       int num_total_unkns)
+	       int num_total_unkns,
+	       double *flux )
 {
-  double M = 0.0;
-  int eb, blk_id;
+  double M[2];
+
+  M[1] = 0.0;
+  M[0] = find_LS_mass_local( exo, dpi, params, dC, x, num_total_unkns,
+			     flux == NULL ? NULL : &M[1] );
+
+  ls_sum_global( M, flux == NULL ? 1 : 2 );
+
+  if ( flux != NULL ) *flux = M[1];
+
+  return (M[0]);
+}
+
+/*
+ * This processor's part of find_LS_mass(), for a caller that sums it with
+ * other values of its own; the flux only if flux is not NULL.
+ */
+
+static double
+find_LS_mass_local ( const Exo_DB *exo,
+		     const Dpi *dpi,
+		     const double *params,
+		     double *dC,
+		     double x[],
+		     int num_total_unkns,
+		     double *flux )
+{
+  double M[2];
+  int eb, blk_id, band;
   int num_params = params == NULL ? 0 : 1;
 
   if ( dC != NULL)
@@ -3604,15 +4241,19 @@ find_LS_mass ( const Exo_DB *exo,
       memset( dC, 0, num_total_unkns*sizeof(double) );
     }
 
+  band = ls_bulk_elems( exo, dpi, params, ls->Mass_Sign, x, &M[0] );
+  M[1] = 0.0;
+
+  integrals_local( TRUE, band ? LS_Bulk : NULL );
 
-   for( eb=0, M = 0.0 ; eb< dpi->num_elem_blocks_global; eb++) 
+   for( eb=0 ; eb< dpi->num_elem_blocks_global; eb++) 
      { 
        int mn;
        blk_id = dpi->eb_id_global[eb];
        mn = map_mat_index(blk_id);
 
        if( pd_glob[mn]->e[ls->var] ) 
-            M += evaluate_volume_integral ( exo,
+            M[0] += evaluate_volume_integral ( exo,
 				      dpi,
 				      ls->Mass_Sign,
 				      NULL,
@@ -3628,9 +4269,38 @@ find_LS_mass ( const Exo_DB *exo,
 				      0.0,
 				      0 );
 
-     } 
+     } 
+
+  if ( flux != NULL )
+    {
+      integrals_local( TRUE, NULL );
+
+      for( eb=0 ; eb< dpi->num_elem_blocks_global; eb++) 
+	{ 
+	  int mn;
+	  blk_id = dpi->eb_id_global[eb];
+	  mn = map_mat_index(blk_id);
+
+	  if( pd_glob[mn]->e[ls->var] ) 
 
-  return (M);
+	    M[1] += evaluate_global_flux ( exo,
+					   dpi, 
+					   ( ls->Mass_Sign == I_NEG_FILL ? NEG_LS_FLUX : POS_LS_FLUX ),
+					   blk_id,
+					   0,
+					   NULL,
+					   NULL,
+					   x,
+					   0.0,
+					   0 );
+	}
+    }
+
+  integrals_local( FALSE, NULL );
+
+  if ( flux != NULL ) *flux = M[1];
+
+  return (M[0]);
 }
 
 double
@@ -3648,6 +4318,7 @@ find_LS_global_flux ( const Exo_DB *exo,
 
   if ( dC != NULL )  memset( dC, 0, num_total_unkns*sizeof(double) );
 
+  integrals_local( TRUE, NULL );
 
   for( eb=0, M = 0.0 ; eb< dpi->num_elem_blocks_global; eb++) 
     { 
@@ -3669,6 +4340,10 @@ find_LS_global_flux ( const Exo_DB *exo,
 				    0 );
     }
 
+  integrals_local( FALSE, NULL );
+
+  ls_sum_global( &M, 1 );
+
   return (M);
 }
 
@@ -3704,8 +4379,8 @@ find_LS_vel(const Exo_DB *exo,
 	    double x[],
 	    int num_total_unkns)
 {
-  double Vel, Vol;
-  int eb, blk_id, mn, phase;
+  double VV[2];			/* velocity and volume integrals */
+  int eb, blk_id, mn, phase, band;
   int num_params = params == NULL ? 0 : 1;
 
   if ( chosen_vel == I_NEG_VX || chosen_vel == I_NEG_VY || chosen_vel == I_NEG_VZ )
@@ -3713,8 +4388,8 @@ find_LS_vel(const Exo_DB *exo,
   else
     phase = I_POS_FILL;
 
-  Vel = 0.0;
-  Vol = 0.0;
+  VV[0] = 0.0;
+  integrals_local( TRUE, NULL );
   for( eb=0 ; eb< dpi->num_elem_blocks_global; eb++) 
     { 
       blk_id = dpi->eb_id_global[eb];
@@ -3722,7 +4397,7 @@ find_LS_vel(const Exo_DB *exo,
       
       if( pd_glob[mn]->e[R_LEVEL_SET] )
 	{
-	  Vel += evaluate_volume_integral(exo,
+	  VV[0] += evaluate_volume_integral(exo,
 					  dpi,
 					  chosen_vel,
 					  NULL,
@@ -3737,7 +4412,19 @@ find_LS_vel(const Exo_DB *exo,
 					  0.0,
 					  0.0,
 					  0);
-	  Vol += evaluate_volume_integral(exo,
+	}
+    }
+
+  band = ls_bulk_elems( exo, dpi, params, phase, x, &VV[1] );
+  integrals_local( TRUE, band ? LS_Bulk : NULL );
+  for( eb=0 ; eb< dpi->num_elem_blocks_global; eb++) 
+    { 
+      blk_id = dpi->eb_id_global[eb];
+      mn     = map_mat_index(blk_id);
+      
+      if( pd_glob[mn]->e[R_LEVEL_SET] )
+	{
+	  VV[1] += evaluate_volume_integral(exo,
 					  dpi,
 					  phase,
 					  NULL,
@@ -3754,8 +4441,194 @@ find_LS_vel(const Exo_DB *exo,
 					  0);
 	}
     } 
+  integrals_local( FALSE, NULL );
+
+  ls_sum_global( VV, 2 );
   
-  return (Vel / Vol);
+  return (VV[0] / VV[1]);
+}
+
+/*
+ * Explicit projections of the level set curvature and normal, for
+ * Level Set Curvature Projection = lumped. In place of the CURVATURE and
+ * NORMAL equations, matrix_fill_full() calls ls_project_curvature() with
+ * each new x, which takes
+ *
+ *      H_I = - int( grad(phi_I) . n ) / int( phi_I ),   n = grad(F)/|grad(F)|
+ *      n_I =   int( phi_I n )         / int( phi_I )
+ *
+ * on the basis of the level set - the weak forms of assemble_curvature()
+ * and assemble_normals() with a lumped mass matrix - and load_fv() takes
+ * fv->H and fv->n from these nodal values through ls_projected_fv(). The
+ * Jacobian then has no entries for them; the surface tension source
+ * lags F by one Newton iteration through them, but the system has no
+ * curvature and normal unknowns at all.
+ */
+
+static double *LS_Proj_Mass = NULL;
+static double *LS_Proj_H = NULL;
+static double *LS_Proj_N[DIM];
+static int LS_Proj_Valid = FALSE;
+
+void
+ls_project_curvature ( Exo_DB *exo,
+		       Dpi *dpi,
+		       double x[] )
+{
+  int eb, mn, elem, ip, ip_total, i, a, I, ldof, err;
+  int dim = exo->num_dim;
+  int N = exo->num_nodes;
+  double xi[3], w, phi, div;
+  struct Basis_Functions *bfv;
+
+  if ( ls == NULL || ls->Curvature_Projection != LS_CURV_PROJ_LUMPED ) return;
+
+  if ( pfd != NULL )
+    EH( -1, "Level Set Curvature Projection = lumped is not available with phase functions." );
+
+  if ( LS_Proj_H == NULL )
+    {
+      LS_Proj_Mass = (double *) smalloc( N*sizeof(double) );
+      LS_Proj_H = (double *) smalloc( N*sizeof(double) );
+      for ( a = 0; a < dim; a++ )
+	LS_Proj_N[a] = (double *) smalloc( N*sizeof(double) );
+    }
+
+  LS_Proj_Valid = FALSE;
+  memset( LS_Proj_Mass, 0, N*sizeof(double) );
+  memset( LS_Proj_H, 0, N*sizeof(double) );
+  for ( a = 0; a < dim; a++ ) memset( LS_Proj_N[a], 0, N*sizeof(double) );
+
+  for ( eb = 0; eb < exo->num_elem_blocks; eb++ )
+    {
+      mn = Matilda[eb];
+      if ( mn < 0 || !pd_glob[mn]->e[ls->var] ) continue;
+
+      if ( pd_glob[mn]->e[R_CURVATURE] || pd_glob[mn]->e[R_NORMAL1] )
+	EH( -1, "Level Set Curvature Projection = lumped replaces the curvature and normal equations, remove them." );
+
+      for ( elem = exo->eb_ptr[eb]; elem < exo->eb_ptr[eb+1]; elem++ )
+	{
+	  ei->ielem = elem;
+	  err = load_elem_dofptr( elem, exo, x, x, x, x, x, 0 );
+	  EH( err, "load_elem_dofptr" );
+
+	  err = bf_mp_init( pd );
+	  EH( err, "bf_mp_init" );
+
+	  bfv = bf[ls->var];
+
+	  ip_total = elem_info( NQUAD, ei->ielem_type );
+	  for ( ip = 0; ip < ip_total; ip++ )
+	    {
+	      find_stu( ip, ei->ielem_type, &xi[0], &xi[1], &xi[2] );
+	      fv->wt = Gq_weight( ip, ei->ielem_type );
+
+	      err = load_basis_functions( xi, bfd );
+	      EH( err, "problem from load_basis_functions" );
+
+	      err = beer_belly();
+	      EH( err, "beer_belly" );
+
+	      err = load_fv();
+	      EH( err, "load_fv" );
+
+	      err = load_bf_grad();
+	      EH( err, "load_bf_grad" );
+
+	      err = load_fv_grads();
+	      EH( err, "load_fv_grads" );
+
+	      load_lsi( ls->Length_Scale );
+
+	      w = fv->wt * bfv->detJ * fv->h3;
+
+	      for ( i = 0; i < ei->num_local_nodes; i++ )
+		{
+		  ldof = ei->ln_to_dof[ls->var][i];
+		  if ( ldof < 0 ) continue;
+		  I = Proc_Elem_Connect[ ei->iconnect_ptr + i ];
+		  phi = bfv->phi[ldof];
+
+		  div = 0.0;
+		  for ( a = 0; a < dim; a++ )
+		    {
+		      div += bfv->grad_phi[ldof][a] * lsi->normal[a];
+		      LS_Proj_N[a][I] += phi * lsi->normal[a] * w;
+		    }
+		  LS_Proj_H[I] -= div * w;
+		  LS_Proj_Mass[I] += phi * w;
+		}
+	    }
+	}
+    }
+
+  /*
+   * Each processor has every element around the nodes it owns, so their
+   * sums are complete; the owners send the values of the others.
+   */
+
+  for ( I = 0; I < N; I++ )
+    {
+      double minv = LS_Proj_Mass[I] > 0.0 ? 1.0 / LS_Proj_Mass[I] : 0.0;
+
+      LS_Proj_H[I] *= minv;
+      for ( a = 0; a < dim; a++ ) LS_Proj_N[a][I] *= minv;
+    }
+
+  if ( Num_Proc > 1 )
+    {
+      double *v[DIM+1];
+
+      v[0] = LS_Proj_H;
+      for ( a = 0; a < dim; a++ ) v[a+1] = LS_Proj_N[a];
+      exchange_node_multi( cx, dpi, dim+1, v );
+    }
+
+  LS_Proj_Valid = TRUE;
+}
+
+/*
+ * fv->H and, without a NORMAL equation, fv->n at the current point from
+ * the nodal values of ls_project_curvature(). Called from load_fv().
+ */
+
+void
+ls_projected_fv ( void )
+{
+  int i, a, I, ldof;
+  int dim = pd->Num_Dim;
+  int normals = !pd->v[NORMAL1];
+  double phi;
+  struct Basis_Functions *bfv;
+
+  if ( !LS_Proj_Valid || !pd->v[ls->var] ) return;
+
+  bfv = bf[ls->var];
+
+  fv->H = 0.0;
+  if ( normals ) for ( a = 0; a < dim; a++ ) fv->n[a] = 0.0;
+
+  for ( i = 0; i < ei->num_local_nodes; i++ )
+    {
+      ldof = ei->ln_to_dof[ls->var][i];
+      if ( ldof < 0 ) continue;
+      I = Proc_Elem_Connect[ ei->iconnect_ptr + i ];
+      phi = bfv->phi[ldof];
+
+      fv->H += phi * LS_Proj_H[I];
+      if ( normals )
+	for ( a = 0; a < dim; a++ ) fv->n[a] += phi * LS_Proj_N[a][I];
+    }
+
+  fv_old->H = fv->H;
+  fv_dot->H = 0.0;
+  if ( normals )
+    for ( a = 0; a < dim; a++ )
+      {
+	fv_old->n[a] = fv->n[a];
+	fv_dot->n[a] = 0.0;
+      }
 }
 
 void 
@@ -6058,6 +6931,36 @@ load_xfem_for_stu( const double xi[] )
     }
 }
 
+/*
+ * The nodes with a variable that has an extended interpolation in some
+ * material, the only ones xfem_predict() and xfem_correct() change.
+ */
+static void
+list_xfem_nodes( int num_total_nodes )
+{
+  int I, lvdesc, m, var_type;
+  NODAL_VARS_STRUCT *nv;
+
+  if ( xfem->num_xnodes >= 0 ) return;
+
+  xfem->num_xnodes = 0;
+  xfem->xnodes = alloc_int_1(num_total_nodes + 1, 0);
+  for (I = 0; I < num_total_nodes; I++)
+    {
+      int has_xfem = FALSE;
+      nv = Nodes[I]->Nodal_Vars_Info;
+      for (lvdesc = 0; lvdesc < nv->Num_Var_Desc && !has_xfem; lvdesc++)
+        {
+          var_type = nv->Var_Desc_List[lvdesc]->Variable_Type;
+          for (m = 0; m < upd->Num_Mat && !has_xfem; m++)
+            {
+              has_xfem = is_xfem_interp( pd_glob[m]->i[var_type] );
+            }
+        }
+      if ( has_xfem ) xfem->xnodes[xfem->num_xnodes++] = I;
+    }
+}
+
 void
 xfem_correct( int num_total_nodes,
               double x[],
@@ -6071,12 +6974,14 @@ xfem_correct( int num_total_nodes,
   NODE_INFO_STRUCT *node;
   NODAL_VARS_STRUCT *nv;
   VARIABLE_DESCRIPTION_STRUCT *vd;
-  int I, ie, idof, lvdesc, var_type;
+  int I, k, ie, idof, lvdesc, var_type;
   int interp;
   int ioffset;
   
-  for (I = 0; I < num_total_nodes; I++)
+  list_xfem_nodes( num_total_nodes );
+  for (k = 0; k < xfem->num_xnodes; k++)
     {
+      I = xfem->xnodes[k];
       node = Nodes[I];
       nv = node->Nodal_Vars_Info;
       ioffset = 0;
@@ -6277,7 +7182,7 @@ xfem_predict( int num_total_nodes,
   NODE_INFO_STRUCT *node;
   NODAL_VARS_STRUCT *nv;
   VARIABLE_DESCRIPTION_STRUCT *vd;
-  int I, ie, lvdesc, var_type;
+  int I, k, ie, lvdesc, var_type;
   int interp;
   double c1, c2, c3 = 0.0;
   int ioffset;
@@ -6295,8 +7200,10 @@ xfem_predict( int num_total_nodes,
     c2 = theta_arg * (delta_t * delta_t) / (delta_t_old);
   }
 
-  for (I = 0; I < num_total_nodes; I++)
+  list_xfem_nodes( num_total_nodes );
+  for (k = 0; k < xfem->num_xnodes; k++)
     {
+      I = xfem->xnodes[k];
       node = Nodes[I];
       nv = node->Nodal_Vars_Info;
       ioffset = 0;
@@ -7311,7 +8218,7 @@ current_elem_xfem_state ( int node_var_state[],
      return = 1 -> at least one of the nodes of this element have node_var_state == 1 or elem_vars_state == 1
      return = 2 -> at least one of the nodes of this element have node_var_state == 2
    */
-  int i, j, e, I;
+  int i, I;
   int elem_state = 0;
   
   /* turn everything off by default */
@@ -7338,19 +8245,12 @@ current_elem_xfem_state ( int node_var_state[],
 	{
 	  /* element vars are *NOT* active */
 	  *elem_var_state = 0;
-	  /* nodal vars still might be active */
+	  /* nodal vars still might be active, if a neighboring element
+	     spans the interface (counted by clear_xfem_contribution) */
 	  for (i = 0; i < ei->num_local_nodes; i++ )
 	    {
-	      /* check all neighboring elements to see if any span the interface */
 	      I = Proc_Elem_Connect[ei->iconnect_ptr + i];
-	      for(j = exo->node_elem_pntr[I]; j < exo->node_elem_pntr[I+1]  && !node_var_state[i]; j++)
-		{
-		  e = exo->node_elem_list[j];
-		  if ( elem_overlaps_interface( e, x, exo, ls->Length_Scale ) )
-		    {
-		      node_var_state[i] = 2;
-		    }
-		}
+	      if ( xfem->node_cross[I] > 0 ) node_var_state[i] = 2;
 	    }
 	}
     }
@@ -7371,20 +8271,11 @@ current_elem_xfem_state ( int node_var_state[],
 	{
 	  /* element vars are *NOT* active */
 	  *elem_var_state = 0;
-	  /* nodal vars still might be active */
-
+	  /* nodal vars still might be active, as above */
 	  for (i = 0; i < ei->num_local_nodes; i++ )
 	    {
-	      /* check all neighboring elements */
 	      I = Proc_Elem_Connect[ei->iconnect_ptr + i];
-	      for(j = exo->node_elem_pntr[I]; j < exo->node_elem_pntr[I+1]  && !node_var_state[i]; j++)
-		{
-		  e = exo->node_elem_list[j];
-		  if (elem_on_isosurface( e, x, exo, ls->var, 0. ))
-		    {
-		      node_var_state[i] = 2;
-		    }
-		}
+	      if ( xfem->node_cross[I] > 0 ) node_var_state[i] = 2;
 	    }
 	}
     }
@@ -8588,6 +9479,67 @@ free_shape_fcn_tree ( NTREE *tree )
   return;
 }
 
+/*
+ * Shape function trees depend only on the element type, the level set
+ * interpolation and the depth, and are costly to build (see above), so
+ * one is kept for each combination met.  They belong to the cache and are
+ * freed by free_shape_fcn_tree_cache().
+ */
+
+#define MAX_TREE_CACHE 16
+
+static struct
+{
+  int ielem_type;
+  int interp;
+  int var;
+  int max_level;
+  NTREE *tree;
+} Tree_Cache[MAX_TREE_CACHE];
+
+static int Tree_Cache_Size = 0;
+
+NTREE *
+shape_fcn_tree_for_elem ( int max_level )
+{
+  int i;
+
+  for ( i = 0; i < Tree_Cache_Size; i++ )
+    {
+      if ( Tree_Cache[i].ielem_type == ei->ielem_type &&
+	   Tree_Cache[i].interp == pd->i[ls->var] &&
+	   Tree_Cache[i].var == ls->var &&
+	   Tree_Cache[i].max_level == max_level ) return Tree_Cache[i].tree;
+    }
+
+  if ( Tree_Cache_Size == MAX_TREE_CACHE )
+    {
+      EH(-1, "shape_fcn_tree_for_elem: increase MAX_TREE_CACHE");
+    }
+
+  Tree_Cache[i].ielem_type = ei->ielem_type;
+  Tree_Cache[i].interp = pd->i[ls->var];
+  Tree_Cache[i].var = ls->var;
+  Tree_Cache[i].max_level = max_level;
+  Tree_Cache[i].tree = create_shape_fcn_tree ( max_level );
+  Tree_Cache_Size++;
+
+  return Tree_Cache[i].tree;
+}
+
+void
+free_shape_fcn_tree_cache ( void )
+{
+  int i;
+
+  for ( i = 0; i < Tree_Cache_Size; i++ )
+    {
+      free_shape_fcn_tree ( Tree_Cache[i].tree );
+      Tree_Cache[i].tree = NULL;
+    }
+  Tree_Cache_Size = 0;
+}
+
 /*
 static void
 print_shape_fcn_tree( NTREE *tree)
@@ -10110,6 +11062,7 @@ subelement_mesh_output (double x[],
   /* no attempt to form true connectivity */
   DPRINTF(stderr,"Creating sublement file %s for %d nodes and %d elements.\n",filename,nnodes,nvelems);
 
+  wr_exo_session_close();	/* no EXODUS II calls while output is queued */
   exoid = ex_create( filename, EX_CLOBBER, &comp_ws, &io_ws );
   ex_put_init( exoid, description, 2, nnodes, nvelems+nselems, 2, 2, 0 );
   
@@ -10579,6 +11532,146 @@ Courant_Time_Step( double x[], double x_old[], double x_older[],
 }
 #endif
 
+/*
+ * Subelement integration points of the elements on the interface, kept
+ * from one call of get_subelement_integration_pts() to the next.  They
+ * depend only on the element type and the level set dofs of the element
+ * (plus isoval, gpt_type and sign), so an element asks again with the
+ * same dofs for every residual and Jacobian evaluation in which the level
+ * set has not moved, the assembly of all other variables, the boundary
+ * conditions and numerical Jacobian perturbations of other unknowns.
+ * With a Subelement Integration cache tolerance the points are also
+ * kept while every dof stays within that fraction of the element's
+ * largest |dof| and no dof changes sign.
+ *
+ * Each element gets up to SUBELEM_CACHE_WAYS sets, allocated when the
+ * element is first decomposed.
+ */
+
+#define SUBELEM_CACHE_WAYS 4
+
+struct Subelem_Cache_Entry
+{
+  int var;
+  int ielem_type;
+  int gpt_type;
+  int sign;
+  int num_f;
+  double isoval;
+  double f[MDE];
+  int num_gpts;
+  double (*s)[DIM];
+  double *wt;
+  int *ip_sign;
+};
+
+struct Subelem_Cache
+{
+  int next;				/* way to replace next */
+  struct Subelem_Cache_Entry way[SUBELEM_CACHE_WAYS];
+};
+
+static struct Subelem_Cache **Subelem_Cache_Elem = NULL;
+static int Subelem_Cache_Num_Elems = 0;
+
+static struct Subelem_Cache_Entry *
+subelement_cache_lookup ( double isoval, int gpt_type, int sign, int store )
+{
+  int i, k, num_f, elem = ei->ielem;
+  double f[MDE], fmax, tol = ls->SubElem_Cache_Tol;
+  struct Subelem_Cache *c;
+  struct Subelem_Cache_Entry *w;
+
+  if ( EXO_ptr == NULL || elem < 0 || elem >= EXO_ptr->num_elems ) return NULL;
+
+  if ( Subelem_Cache_Elem == NULL )
+    {
+      Subelem_Cache_Num_Elems = EXO_ptr->num_elems;
+      Subelem_Cache_Elem = (struct Subelem_Cache **)
+	calloc ( Subelem_Cache_Num_Elems, sizeof(struct Subelem_Cache *) );
+    }
+
+  num_f = MIN( ei->dof[ls->var], MDE );
+  for ( i = 0; i < num_f; i++ )
+    {
+      f[i] = x_static[ei->ieqn_ledof[ei->lvdof_to_ledof[ls->var][i]]];
+    }
+
+  c = Subelem_Cache_Elem[elem];
+  if ( c == NULL )
+    {
+      if ( !store ) return NULL;
+      c = Subelem_Cache_Elem[elem] = (struct Subelem_Cache *)
+	calloc ( 1, sizeof(struct Subelem_Cache) );
+    }
+
+  for ( k = 0; !store && k < SUBELEM_CACHE_WAYS; k++ )
+    {
+      w = &c->way[k];
+      if ( w->s == NULL || w->var != ls->var || w->ielem_type != ei->ielem_type ||
+	   w->gpt_type != gpt_type || w->sign != sign ||
+	   w->isoval != isoval || w->num_f != num_f ) continue;
+
+      fmax = 0.;
+      for ( i = 0; i < num_f; i++ ) fmax = MAX( fmax, fabs(w->f[i]) );
+      for ( i = 0; i < num_f; i++ )
+	{
+	  if ( tol <= 0. ) 
+	    {
+	      if ( f[i] != w->f[i] ) break;
+	    }
+	  else if ( fabs( f[i] - w->f[i] ) > tol * fmax ||
+		    ( f[i] < isoval ) != ( w->f[i] < isoval ) ) break;
+	}
+      if ( i == num_f ) return w;
+    }
+
+  if ( !store ) return NULL;
+
+  w = &c->way[c->next];
+  c->next = ( c->next + 1 ) % SUBELEM_CACHE_WAYS;
+  if ( w->s != NULL ) safe_free( (void *) w->s );
+  if ( w->wt != NULL ) safe_free( (void *) w->wt );
+  if ( w->ip_sign != NULL ) safe_free( (void *) w->ip_sign );
+  w->s = NULL;
+  w->wt = NULL;
+  w->ip_sign = NULL;
+
+  w->var = ls->var;
+  w->ielem_type = ei->ielem_type;
+  w->gpt_type = gpt_type;
+  w->sign = sign;
+  w->isoval = isoval;
+  w->num_f = num_f;
+  for ( i = 0; i < num_f; i++ ) w->f[i] = f[i];
+  return w;
+}
+
+void
+free_subelement_cache ( void )
+{
+  int e, k;
+  struct Subelem_Cache_Entry *w;
+
+  if ( Subelem_Cache_Elem == NULL ) return;
+
+  for ( e = 0; e < Subelem_Cache_Num_Elems; e++ )
+    {
+      if ( Subelem_Cache_Elem[e] == NULL ) continue;
+      for ( k = 0; k < SUBELEM_CACHE_WAYS; k++ )
+	{
+	  w = &Subelem_Cache_Elem[e]->way[k];
+	  if ( w->s != NULL ) safe_free( (void *) w->s );
+	  if ( w->wt != NULL ) safe_free( (void *) w->wt );
+	  if ( w->ip_sign != NULL ) safe_free( (void *) w->ip_sign );
+	}
+      safe_free( (void *) Subelem_Cache_Elem[e] );
+    }
+  safe_free( (void *) Subelem_Cache_Elem );
+  Subelem_Cache_Elem = NULL;
+  Subelem_Cache_Num_Elems = 0;
+}
+
 int
 get_subelement_integration_pts ( double (**s)[DIM], double **weight, int **ip_sign, 
                                  double isoval, int gpt_type, int sign )
@@ -10586,6 +11679,7 @@ get_subelement_integration_pts ( double (**s)[DIM], double **weight, int **ip_si
 
   Integ_Elem * e;
   int num_gpts;
+  struct Subelem_Cache_Entry *w;
 
   if(pd->v[LS]) 
     {
@@ -10598,10 +11692,6 @@ get_subelement_integration_pts ( double (**s)[DIM], double **weight, int **ip_si
 
   if ( neg_elem_volume ) return (0);
 
-  e = create_integ_elements( isoval );
-
-  num_gpts = num_subelement_integration_pts( e, gpt_type, sign );
-
   if( *s != NULL )
     {
       safe_free ( ( void * ) *s );
@@ -10618,21 +11708,54 @@ get_subelement_integration_pts ( double (**s)[DIM], double **weight, int **ip_si
       *ip_sign = NULL;
     }
 
-  *s = (double (*)[DIM]) smalloc ( DIM*num_gpts*sizeof(double));
+  w = subelement_cache_lookup( isoval, gpt_type, sign, FALSE );
 
-  *weight = (double *) smalloc ( num_gpts * sizeof(double) );
+  if ( w == NULL )
+    {
+      e = create_integ_elements( isoval );
+
+      num_gpts = num_subelement_integration_pts( e, gpt_type, sign );
+
+      w = subelement_cache_lookup( isoval, gpt_type, sign, TRUE );
+      if ( w != NULL )
+	{
+	  w->num_gpts = num_gpts;
+	  w->s = (double (*)[DIM]) smalloc ( DIM*MAX(num_gpts,1)*sizeof(double));
+	  w->wt = (double *) smalloc ( MAX(num_gpts,1) * sizeof(double) );
+	  w->ip_sign = (int *) smalloc ( MAX(num_gpts,1) * sizeof(int) );
+	  gather_subelement_integration_pts( e, w->s, w->wt, w->ip_sign, gpt_type, sign, 0 );
+	}
+      else
+	{
+	  *s = (double (*)[DIM]) smalloc ( DIM*num_gpts*sizeof(double));
+	  *weight = (double *) smalloc ( num_gpts * sizeof(double) );
+	  if ( ip_sign != NULL )
+	    {
+	      *ip_sign = (int *) smalloc ( num_gpts * sizeof(int) );
+	      gather_subelement_integration_pts( e, *s, *weight, *ip_sign, gpt_type, sign, 0 );
+	    }
+	  else
+	    {
+	      gather_subelement_integration_pts( e, *s, *weight, NULL, gpt_type, sign, 0 );
+	    }
+	  free_integ_elements( e );
+	  return ( num_gpts );
+	}
+
+      free_integ_elements( e );
+    }
+
+  num_gpts = w->num_gpts;
 
+  *s = (double (*)[DIM]) smalloc ( DIM*num_gpts*sizeof(double));
+  *weight = (double *) smalloc ( num_gpts * sizeof(double) );
+  memcpy( *s, w->s, DIM*num_gpts*sizeof(double) );
+  memcpy( *weight, w->wt, num_gpts*sizeof(double) );
   if ( ip_sign != NULL )
     {
       *ip_sign = (int *) smalloc ( num_gpts * sizeof(int) );
-      gather_subelement_integration_pts( e, *s, *weight, *ip_sign, gpt_type, sign, 0 );
+      memcpy( *ip_sign, w->ip_sign, num_gpts*sizeof(int) );
     }
-  else
-    {
-      gather_subelement_integration_pts( e, *s, *weight, NULL, gpt_type, sign, 0 );
-    }
-
-  free_integ_elements( e );
 
   return ( num_gpts );
 }
@@ -11953,22 +13076,68 @@ gather_subelement_integration_pts( Integ_Elem * e,
 
 }
 
+#define XFEM_ROW_BIT(ie)	(1u << ((ie) & 31))
+
 void
-clear_xfem_contribution( int N )
+update_xfem_elem_state( double x[],
+			const Exo_DB *exo )
 {
-  int ie;
-  
-/*	memset( &(xfem->active_vol[0]), 0, sizeof(double)*N);
-	memset( &(xfem->tot_vol[0]), 0, sizeof(double)*N);
-	
-*/
-	
-  for (ie = 0; ie < N; ie++)
+  /*
+   * Bring the interface state of the elements, and the count of elements
+   * spanning the interface around each node, up to x. Only the elements
+   * the interface entered or left change the node counts.
+   */
+  int k, e, cross;
+
+  for (e = 0; e < exo->num_elems; e++)
+    {
+      if ( ls->Length_Scale != 0. )
+	cross = elem_overlaps_interface( e, x, exo, ls->Length_Scale );
+      else
+	cross = elem_on_isosurface( e, x, exo, ls->var, 0. );
+      cross = (cross != 0);
+      if ( cross != xfem->elem_cross[e] )
+	{
+	  xfem->elem_cross[e] = cross;
+	  for (k = exo->elem_ptr[e]; k < exo->elem_ptr[e+1]; k++)
+	    {
+	      xfem->node_cross[exo->node_list[k]] += cross ? 1 : -1;
+	    }
+	}
+    }
+  /* the element state load_xfem_for_elem() kept is stale */
+  xfem->ielem = -1;
+}
+
+void
+clear_xfem_contribution( int N,
+			 double x[],
+			 const Exo_DB *exo )
+{
+  /* zero the rows the last fill added to */
+  int k, ie;
+
+  for (k = 0; k < xfem->num_rows; k++)
     {
+      ie = xfem->rows[k];
       xfem->active_vol[ie] = 0.;
       xfem->tot_vol[ie] = 0.;
+      xfem->row_bits[ie >> 5] &= ~XFEM_ROW_BIT(ie);
+    }
+  xfem->num_rows = 0;
+
+  update_xfem_elem_state( x, exo );
+}
+
+/* ie of this fill has a volume contribution */
+static void
+xfem_touch_row( int ie )
+{
+  if ( !(xfem->row_bits[ie >> 5] & XFEM_ROW_BIT(ie)) )
+    {
+      xfem->row_bits[ie >> 5] |= XFEM_ROW_BIT(ie);
+      xfem->rows[xfem->num_rows++] = ie;
     }
-	 
 }
 
 void
@@ -12007,6 +13176,7 @@ compute_xfem_contribution( int N )
 			          EH(-1,"compute_xfem_contrib, ie out of bounds\n");
 			        }
                   
+		              xfem_touch_row( ie );
 		              xfem->active_vol[ie] += bf[eqn]->phi[i] * dV;
 		              xfem->tot_vol[ie] += dV;
 			    }
@@ -12021,6 +13191,7 @@ compute_xfem_contribution( int N )
 			      EH(-1,"compute_xfem_contrib, ie out of bounds\n");
 			    }
                   
+		          xfem_touch_row( ie );
 		          xfem->active_vol[ie] += bf[eqn]->phi[i] * dV;
 		          xfem->tot_vol[ie] += dV;
 			}
@@ -12038,7 +13209,7 @@ check_xfem_contribution( int N,
                          double x[],
 			 Exo_DB * exo )
 {
-  int irow;
+  int irow, r;
   double eps_standard = 1.e-4;
   double eps_diffusive = 1.e-10;
   double eps;
@@ -12047,10 +13218,12 @@ check_xfem_contribution( int N,
   int eqn;
   int *ija = ams->bindx;
   double *a = ams->val;
-  
+
+  /* only the rows of the fill's volume contributions can be partial */
   if (strcmp(Matrix_Format, "msr") == 0) {
-    for (irow = 0; irow < N; irow++)
+    for (r = 0; r < xfem->num_rows; r++)
       {
+        irow = xfem->rows[r];
         eqn = idv[irow][0];
         if ( eqn == R_MASS || eqn == R_ENERGY )
           eps = eps_diffusive;
@@ -12095,7 +13268,8 @@ check_xfem_contribution( int N,
           }
       }
   } else if (strcmp(Matrix_Format, "epetra") == 0) {
-    for (irow = 0; irow < N; irow++) {
+    for (r = 0; r < xfem->num_rows; r++) {
+      irow = xfem->rows[r];
       eqn = idv[irow][0];
       if (eqn == R_MASS || eqn == R_ENERGY) {
         eps = eps_diffusive;
@@ -5427,6 +5427,181 @@ load_shell_permeability_tensor(void)
 /*****************************************************************************/
 
 
+/*
+ * Tabulated VAN_GENUCHTEN saturation curve.
+ *
+ * With "Saturation Table Tolerance" set in the material file, the curve
+ * S(suction) is interpolated from a table in x = ln(suction) instead of
+ * being evaluated with pow() at every point. Each interval is a cubic
+ * Hermite polynomial on the exact S and dS/dx at its ends; the nodes are
+ * doubled until S and dS/dx at every interval midpoint are within the
+ * tolerance of the exact curve. Suctions outside the table fall back to
+ * the exact curve. A table is rebuilt whenever the constants it was made
+ * from change, e.g. under continuation.
+ */
+
+#define SAT_TABLE_X_MIN  (-9.210340371976184)	/* ln(1.e-4) */
+#define SAT_TABLE_X_MAX  ( 9.210340371976184)	/* ln(1.e+4) */
+#define SAT_TABLE_MAX_NODES 1048577
+
+struct Saturation_Table
+{
+  dbl u[4];			/* u_saturation it was built from */
+  dbl tol;
+  int n;			/* nodes */
+  dbl dx;			/* node spacing in ln(suction) */
+  dbl *S;			/* [n] saturation at the nodes */
+  dbl *S_x;			/* [n] dS/d(ln suction) at the nodes */
+};
+
+static struct Saturation_Table Sat_Table[MAX_NUMBER_MATLS];	/* [ei->mn] */
+
+static void
+vg_saturation_exact(const dbl u[4], const dbl suction,
+		    dbl *S, dbl *S_s)
+
+    /*
+     * VAN_GENUCHTEN saturation and its derivative with respect to
+     * suction, as load_saturation() has them.
+     */
+{
+  dbl expon2 = - (u[2] - 1.) / u[2];
+  dbl c = 1.0 - u[0] - u[1];
+  dbl base = 1.0 + pow(suction, u[2]);
+
+  *S = u[0] + c * pow(base, expon2);
+  *S_s = c * expon2 * pow(base, expon2 - 1.0) * u[2] * pow(suction, u[2] - 1.0);
+}
+
+static void
+sat_table_hermite(const struct Saturation_Table *tab, const dbl x,
+		  dbl *S, dbl *S_x, dbl *S_xx)
+{
+  dbl t, h = tab->dx;
+  dbl y0, y1, m0, m1;
+  int k;
+
+  t = (x - SAT_TABLE_X_MIN) / h;
+  k = (int) t;
+  if (k > tab->n - 2) k = tab->n - 2;
+  if (k < 0) k = 0;
+  t -= (dbl) k;
+
+  y0 = tab->S[k];
+  y1 = tab->S[k+1];
+  m0 = tab->S_x[k] * h;
+  m1 = tab->S_x[k+1] * h;
+
+  *S = (1. + 2.*t) * (1. - t) * (1. - t) * y0 + t * (1. - t) * (1. - t) * m0
+    + t * t * (3. - 2.*t) * y1 + t * t * (t - 1.) * m1;
+
+  *S_x = (6. * t * (t - 1.) * (y0 - y1) + (1. - t) * (1. - 3.*t) * m0
+	  + t * (3.*t - 2.) * m1) / h;
+
+  if (S_xx != NULL) {
+    *S_xx = ((12. * t - 6.) * (y0 - y1) + (6. * t - 4.) * m0
+	     + (6. * t - 2.) * m1) / (h * h);
+  }
+}
+
+static void
+sat_table_build(struct Saturation_Table *tab, const dbl u[4], const dbl tol)
+
+    /*
+     * Threads only read a table whose u and tol match their material, so
+     * these are set last.
+     */
+{
+  dbl x, S, S_s, Si, Si_x, err;
+  int i, n;
+
+  for (n = 257; ; n = 2 * n - 1) {
+    tab->n = n;
+    tab->dx = (SAT_TABLE_X_MAX - SAT_TABLE_X_MIN) / (dbl) (n - 1);
+    tab->S = (dbl *) realloc(tab->S, n * sizeof(dbl));
+    tab->S_x = (dbl *) realloc(tab->S_x, n * sizeof(dbl));
+    if (tab->S == NULL || tab->S_x == NULL) {
+      EH(-1, "Out of memory for the saturation table");
+    }
+    for (i = 0; i < n; i++) {
+      x = SAT_TABLE_X_MIN + i * tab->dx;
+      vg_saturation_exact(u, exp(x), &tab->S[i], &S_s);
+      tab->S_x[i] = S_s * exp(x);
+    }
+
+    err = 0.0;
+    for (i = 0; i < n - 1; i++) {
+      x = SAT_TABLE_X_MIN + (i + 0.5) * tab->dx;
+      vg_saturation_exact(u, exp(x), &S, &S_s);
+      sat_table_hermite(tab, x, &Si, &Si_x, NULL);
+      err = MAX(err, fabs(Si - S));
+      err = MAX(err, fabs(Si_x - S_s * exp(x)));
+    }
+    if (err <= tol) break;
+    if (2 * n - 1 > SAT_TABLE_MAX_NODES) {
+      DPRINTF(stderr,
+	      "Saturation table stops at %d nodes with error %g > %g\n",
+	      n, err, tol);
+      break;
+    }
+  }
+
+#ifdef _OPENMP
+#pragma omp flush
+#endif
+  for (i = 0; i < 4; i++) tab->u[i] = u[i];
+  tab->tol = tol;
+#ifdef _OPENMP
+#pragma omp flush
+#endif
+}
+
+static int
+sat_table_current(const struct Saturation_Table *tab)
+{
+  int k;
+
+  for (k = 0; k < 4 && tab->u[k] == mp->u_saturation[k]; k++);
+  return (k == 4 && tab->tol == mp->saturation_table_tol);
+}
+
+static int
+vg_saturation_table(const dbl suction, dbl *S, dbl *S_s, dbl *S_ss)
+
+    /*
+     * Saturation and its suction derivatives from the table of the
+     * current material; FALSE when it has none or suction is off it.
+     */
+{
+  struct Saturation_Table *tab;
+  dbl x, S_x, S_xx;
+
+  if (mp->saturation_table_tol <= 0.0 || suction <= 0.0) return FALSE;
+  if (ei->mn < 0 || ei->mn >= MAX_NUMBER_MATLS) return FALSE;
+  x = log(suction);
+  if (x < SAT_TABLE_X_MIN || x > SAT_TABLE_X_MAX) return FALSE;
+
+  tab = Sat_Table + ei->mn;
+  if (!sat_table_current(tab)) {
+#ifdef _OPENMP
+#pragma omp critical (saturation_table)
+#endif
+    {
+      if (!sat_table_current(tab)) {
+	sat_table_build(tab, mp->u_saturation, mp->saturation_table_tol);
+      }
+    }
+  }
+
+  sat_table_hermite(tab, x, S, &S_x, (S_ss != NULL) ? &S_xx : NULL);
+  *S_s = S_x / suction;
+  if (S_ss != NULL) *S_ss = (S_xx - S_x) / (suction * suction);
+  return TRUE;
+}
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
 double 
 load_saturation(double porosity, double cap_pres, double d_cap_pres[2])
 
@@ -5468,6 +5643,10 @@ load_saturation(double porosity, double cap_pres, double d_cap_pres[2])
   int ip, mat_ielem;
   extern int PRS_mat_ielem;
 
+  /* tabulated VAN_GENUCHTEN */
+  double S_tab = 0.0, S_s_tab = 0.0, S_ss_tab = 0.0;
+  int sat_tab;
+
 
 
   /*
@@ -5498,9 +5677,15 @@ load_saturation(double porosity, double cap_pres, double d_cap_pres[2])
       mp->d_d_saturation[POR_LIQ_PRES][POR_LIQ_PRES] = 0.0;
     } else {
       suction = cap_pres * mp->u_saturation[3];
+      sat_tab = vg_saturation_table(suction, &S_tab, &S_s_tab,
+				    af->Assemble_Jacobian ? &S_ss_tab : NULL);
+      if (sat_tab) {
+	saturation = mp->saturation = S_tab;
+      } else {
       saturation = mp->saturation = mp->u_saturation[0] + 
 	(1.0 - mp->u_saturation[0] - mp->u_saturation[1]) *
 	pow((1.0 + pow(suction, mp->u_saturation[2])), expon2);
+      }
       
       if (saturation > 1.0) {
 	saturation = mp->saturation = 1.0;
@@ -5521,11 +5706,15 @@ load_saturation(double porosity, double cap_pres, double d_cap_pres[2])
        * ****Further NOTE----PRS added a negative here due to the redefinition
        * of capillary pressure to p_gas-p_liq for UNSATURATED case, from p_liq
        */
+      if (sat_tab) {
+	mp->d_saturation[POR_LIQ_PRES] = -S_s_tab * mp->u_saturation[3];
+      } else {
       mp->d_saturation[POR_LIQ_PRES] = 
 	-(1. - mp->u_saturation[0] - mp->u_saturation[1]) *
 	expon2 * pow((1. + pow(suction, mp->u_saturation[2])), expon2 - 1.0)
 	* mp->u_saturation[2] * mp->u_saturation[3] 
 	* pow(suction, mp->u_saturation[2] - 1);
+      }
       if (pd->e[R_POR_GAS_PRES]) {
 	mp->d_saturation[POR_GAS_PRES] = -mp->d_saturation[POR_LIQ_PRES];
       }
@@ -5537,6 +5726,10 @@ load_saturation(double porosity, double cap_pres, double d_cap_pres[2])
 	 */
 	/*n.g. this negative sign here is in question. Check out
 	  as I think it should be positive due to double derivative..*/
+	if (sat_tab) {
+	  mp->d_d_saturation[POR_LIQ_PRES][POR_LIQ_PRES] =
+	    -S_ss_tab * pow(mp->u_saturation[3], 2.0);
+	} else {
 	mp->d_d_saturation[POR_LIQ_PRES][POR_LIQ_PRES] = 
 	  -(1. - mp->u_saturation[0] - mp->u_saturation[1]) * expon2 
 	  * mp->u_saturation[2] 
@@ -5548,6 +5741,7 @@ load_saturation(double porosity, double cap_pres, double d_cap_pres[2])
 	   + pow((1. + pow(suction, mp->u_saturation[2])), expon2 - 1.0)
 	   * (mp->u_saturation[2] - 1.) *
 	   pow(suction, mp->u_saturation[2] - 2.0));
+	}
 	if (pd->e[R_POR_GAS_PRES]) {
 	  mp->d_d_saturation[POR_GAS_PRES][POR_LIQ_PRES] = -
 	    mp->d_d_saturation[POR_GAS_PRES][POR_GAS_PRES];
@@ -5570,6 +5764,10 @@ load_saturation(double porosity, double cap_pres, double d_cap_pres[2])
 	mp_old->d_saturation[POR_GAS_PRES] = 0.0;
       } else {
 	suction_old = pmv_old->cap_pres * mp->u_saturation[3];
+	if (vg_saturation_table(suction_old, &S_tab, &S_s_tab, NULL)) {
+	  mp_old->saturation = S_tab;
+	  mp_old->d_saturation[POR_LIQ_PRES] = -S_s_tab * mp->u_saturation[3];
+	} else {
 	
 	mp_old->saturation = mp->u_saturation[0] + 
 	  (1. - mp->u_saturation[0] - mp->u_saturation[1]) *
@@ -5580,6 +5778,7 @@ load_saturation(double porosity, double cap_pres, double d_cap_pres[2])
 	  expon2 * pow((1.0 + pow(suction_old, mp->u_saturation[2])), expon2 - 1.0)
 	  * mp->u_saturation[2] * mp->u_saturation[3] 
 	  * pow(suction_old, mp->u_saturation[2] - 1.0);
+	}
 	if (pd->e[R_POR_GAS_PRES]) {
 	  mp_old->d_saturation[POR_GAS_PRES] = 
 	    -mp_old->d_saturation[POR_LIQ_PRES];
@@ -6291,14 +6490,14 @@ load_saturation(double porosity, double cap_pres, double d_cap_pres[2])
     /*Load up con_a and con_b from element storage array */
     
  
-    if(Element_Blocks[ei->elem_blk_index].ElemStorage[mat_ielem].sat_curve_type[ip] == 1.0) 
+    if(ES_QP(Element_Blocks + ei->elem_blk_index, sat_curve_type, mat_ielem, ip) == 1.0) 
       {
 	alpha_drain = mp->u_saturation[7];
 	beta_drain  = mp->u_saturation[6];
 	s_min       = mp->u_saturation[4];
 	
-	sat_switch = Element_Blocks[ei->elem_blk_index].ElemStorage[mat_ielem].Sat_QP_tn[ip];
-	pc_switch = Element_Blocks[ei->elem_blk_index].ElemStorage[mat_ielem].p_cap_QP[ip];
+	sat_switch = ES_QP(Element_Blocks + ei->elem_blk_index, Sat_QP_tn, mat_ielem, ip);
+	pc_switch = ES_QP(Element_Blocks + ei->elem_blk_index, p_cap_QP, mat_ielem, ip);
 
 
 	if (pc_switch <= 0.0) {
@@ -6330,8 +6529,8 @@ load_saturation(double porosity, double cap_pres, double d_cap_pres[2])
 	beta_wet  = mp->u_saturation[2];
 	s_max    = mp->u_saturation[0];
 	
-	sat_switch = Element_Blocks[ei->elem_blk_index].ElemStorage[mat_ielem].Sat_QP_tn[ip];
-	pc_switch = Element_Blocks[ei->elem_blk_index].ElemStorage[mat_ielem].p_cap_QP[ip];
+	sat_switch = ES_QP(Element_Blocks + ei->elem_blk_index, Sat_QP_tn, mat_ielem, ip);
+	pc_switch = ES_QP(Element_Blocks + ei->elem_blk_index, p_cap_QP, mat_ielem, ip);
 
 
 	if (pc_switch <= 0.0) {
@@ -6366,7 +6565,7 @@ load_saturation(double porosity, double cap_pres, double d_cap_pres[2])
      *
      */
     
-    if(Element_Blocks[ei->elem_blk_index].ElemStorage[mat_ielem].sat_curve_type[ip] == 1.0)
+    if(ES_QP(Element_Blocks + ei->elem_blk_index, sat_curve_type, mat_ielem, ip) == 1.0)
       {
 	mp->d_saturation[POR_LIQ_PRES] = -con_b*alpha_drain/cap_pres_clip/cap_pres_clip*
 	  (1-pow(tanh(beta_drain-alpha_drain/cap_pres_clip),2.0));
@@ -6385,7 +6584,7 @@ load_saturation(double porosity, double cap_pres, double d_cap_pres[2])
 
     if (pd->e[R_SHELL_SAT_OPEN])
       {
-	if(Element_Blocks[ei->elem_blk_index].ElemStorage[mat_ielem].sat_curve_type[ip] == 1.0)
+	if(ES_QP(Element_Blocks + ei->elem_blk_index, sat_curve_type, mat_ielem, ip) == 1.0)
 	  {
 	    mp->d_saturation[SHELL_PRESS_OPEN] = -con_b*alpha_drain/cap_pres_clip/cap_pres_clip*
 	      (1-pow(tanh(beta_drain-alpha_drain/cap_pres_clip),2.0));	   
@@ -6399,7 +6598,7 @@ load_saturation(double porosity, double cap_pres, double d_cap_pres[2])
 
     if (pd->e[R_SHELL_SAT_OPEN_2])
       {
-	if(Element_Blocks[ei->elem_blk_index].ElemStorage[mat_ielem].sat_curve_type[ip] == 1.0)
+	if(ES_QP(Element_Blocks + ei->elem_blk_index, sat_curve_type, mat_ielem, ip) == 1.0)
 	  {
 	    mp->d_saturation[SHELL_PRESS_OPEN_2] = -con_b*alpha_drain/cap_pres_clip/cap_pres_clip*
 	      (1-pow(tanh(beta_drain-alpha_drain/cap_pres_clip),2.0));
@@ -6418,7 +6617,7 @@ load_saturation(double porosity, double cap_pres, double d_cap_pres[2])
        */
       /*n.g. this negative sign here is in question. Check out
 	as I think it should be positive due to double derivative..*/
-      if(Element_Blocks[ei->elem_blk_index].ElemStorage[mat_ielem].sat_curve_type[ip] == 1.0)
+      if(ES_QP(Element_Blocks + ei->elem_blk_index, sat_curve_type, mat_ielem, ip) == 1.0)
 	{
 	  mp->d_d_saturation[POR_LIQ_PRES][POR_LIQ_PRES] = 
 	    (2.0*con_b*alpha_drain*alpha_drain/pow(cap_pres_clip,4.0)*
@@ -6447,7 +6646,7 @@ load_saturation(double porosity, double cap_pres, double d_cap_pres[2])
 
     if (pd->e[R_SHELL_SAT_OPEN])
 	{
-	  if(Element_Blocks[ei->elem_blk_index].ElemStorage[mat_ielem].sat_curve_type[ip] == 1.0)
+	  if(ES_QP(Element_Blocks + ei->elem_blk_index, sat_curve_type, mat_ielem, ip) == 1.0)
 	    {
 	      mp->d_d_saturation[SHELL_PRESS_OPEN][SHELL_PRESS_OPEN] = 
 		(2.0*con_b*alpha_drain*alpha_drain/pow(cap_pres_clip,4.0)*
@@ -6469,7 +6668,7 @@ load_saturation(double porosity, double cap_pres, double d_cap_pres[2])
 
       if (pd->e[R_SHELL_SAT_OPEN_2])
 	{
-	  if(Element_Blocks[ei->elem_blk_index].ElemStorage[mat_ielem].sat_curve_type[ip] == 1.0)
+	  if(ES_QP(Element_Blocks + ei->elem_blk_index, sat_curve_type, mat_ielem, ip) == 1.0)
 	    {
 	      mp->d_d_saturation[SHELL_PRESS_OPEN_2][SHELL_PRESS_OPEN_2] = 
 		(2.0*con_b*alpha_drain*alpha_drain/pow(cap_pres_clip,4.0)*
@@ -6501,7 +6700,7 @@ load_saturation(double porosity, double cap_pres, double d_cap_pres[2])
 	cap_pres_clip=pmv_old->cap_pres;
       }
       
-      if(Element_Blocks[ei->elem_blk_index].ElemStorage[mat_ielem].sat_curve_type[ip] == 1.0)
+      if(ES_QP(Element_Blocks + ei->elem_blk_index, sat_curve_type, mat_ielem, ip) == 1.0)
 	{
 	  mp_old->saturation =con_a+con_b*tanh(beta_drain-alpha_drain/cap_pres_clip);
 	  mp_old->d_saturation[POR_LIQ_PRES] = con_b*alpha_drain/cap_pres_clip/cap_pres_clip*
@@ -11116,7 +11315,14 @@ interpolate_table_sat(struct Data_Table *table, double x[])
 	table->slope[0] = ( f[1+Np1*iad] - f[0+Np1*iad] ) / ( t[1] - t[0] );
 	func = f[0+Np1*iad] +  ( table->slope[0]) * ( x[0] - t[0] );
       }
-      
+
+      i = (x[0] >= t[0] && x[0] < t[N]) ? table_interval(table, x[0]) : -1;
+      if ( i >= 0 )
+      {
+	table->slope[0] = ( f[i+1+Np1*iad] - f[i+Np1*iad] ) / ( t[i+1] - t[i] );
+	func  = f[i+Np1*iad] + ( table->slope[0]) * ( x[0] - t[i] );
+      }
+      else
       for( i=0; x[0] >= t[i] &&  i < N ; i++)
       {
 	if ( x[0] >= t[i] && x[0] < t[i+1] )
@@ -11244,36 +11450,36 @@ evaluate_sat_hyst_criterion(int ip,
      */
 
     if(liq_inv_dot > 0.0 && 
-       Element_Blocks[ei->elem_blk_index].ElemStorage[ielem].sat_curve_type[ip] == 0.0)
+       ES_QP(Element_Blocks + ei->elem_blk_index, sat_curve_type, ielem, ip) == 0.0)
       {
 	/* We were on a wetting curve, and will remain so */
       }
     else if (liq_inv_dot <= 0.0 && 
-	     Element_Blocks[ei->elem_blk_index].ElemStorage[ielem].sat_curve_type[ip] == 1.0)
+	     ES_QP(Element_Blocks + ei->elem_blk_index, sat_curve_type, ielem, ip) == 1.0)
       {
 	/* We were on a drying/draining curve, and will remain so */
       }
     else if (liq_inv_dot > 0.0 && 
-	     Element_Blocks[ei->elem_blk_index].ElemStorage[ielem].sat_curve_type[ip] == 1.0)
+	     ES_QP(Element_Blocks + ei->elem_blk_index, sat_curve_type, ielem, ip) == 1.0)
       {
 	/* We were on a drying/draining curve but now may potentially switch to a wetting curve */
 	if(fabs(liq_inv_dot) > mp->u_saturation[9] && 
 	   mp->saturation <= 0.9999 )
 	  {
-	    Element_Blocks[ei->elem_blk_index].ElemStorage[ielem].sat_curve_type[ip] = 0.0;
-	    Element_Blocks[ei->elem_blk_index].ElemStorage[ielem].Sat_QP_tn[ip] = mp->saturation;
-	    Element_Blocks[ei->elem_blk_index].ElemStorage[ielem].p_cap_QP[ip] = cap_press;
+	    ES_QP(Element_Blocks + ei->elem_blk_index, sat_curve_type, ielem, ip) = 0.0;
+	    ES_QP(Element_Blocks + ei->elem_blk_index, Sat_QP_tn, ielem, ip) = mp->saturation;
+	    ES_QP(Element_Blocks + ei->elem_blk_index, p_cap_QP, ielem, ip) = cap_press;
 	  }
       }
     else if (liq_inv_dot <= 0.0 && 
-	     Element_Blocks[ei->elem_blk_index].ElemStorage[ielem].sat_curve_type[ip] == 0.0)
+	     ES_QP(Element_Blocks + ei->elem_blk_index, sat_curve_type, ielem, ip) == 0.0)
       {
 	/* We were on a wetting curve but now may potentially switch to a drying curve */
 	if(fabs(liq_inv_dot) > mp->u_saturation[9])
 	  {
-	    Element_Blocks[ei->elem_blk_index].ElemStorage[ielem].sat_curve_type[ip] = 1.0;
-	    Element_Blocks[ei->elem_blk_index].ElemStorage[ielem].Sat_QP_tn[ip] = mp->saturation;
-	    Element_Blocks[ei->elem_blk_index].ElemStorage[ielem].p_cap_QP[ip] = cap_press;
+	    ES_QP(Element_Blocks + ei->elem_blk_index, sat_curve_type, ielem, ip) = 1.0;
+	    ES_QP(Element_Blocks + ei->elem_blk_index, Sat_QP_tn, ielem, ip) = mp->saturation;
+	    ES_QP(Element_Blocks + ei->elem_blk_index, p_cap_QP, ielem, ip) = cap_press;
 	  }
       }
   }
@@ -7043,7 +7043,7 @@ assemble_lubrication(const int EQN,     /* equation type: either R_LUBP or R_LUB
 {
   int eqn, var, peqn, pvar, p, a, b, k, jk;
   int i = -1, j, status; //, err;
-  int *n_dof = NULL;
+  int n_dof[MAX_VARIABLE_TYPES];
   int dof_map[MDE];
   
   // dbl toggle_dh_dependence = 0.;
@@ -7081,7 +7081,6 @@ assemble_lubrication(const int EQN,     /* equation type: either R_LUBP or R_LUB
   /*
    * Prepare geometry
    */
-  n_dof = (int *)array_alloc (1, MAX_VARIABLE_TYPES, sizeof(int));
   lubrication_shell_initialize(n_dof, dof_map, -1, xi, exo, 0);
                                                                  
   /* Load proper FEM weights */
@@ -7646,7 +7645,6 @@ assemble_lubrication(const int EQN,     /* equation type: either R_LUBP or R_LUB
   
     /* clean-up */
   fv->wt = wt;  /* load_neighbor_var_data screws this up */
-  safe_free((void *) n_dof);
   return(status);
 } /* end of assemble_lubrication */
 
@@ -7688,7 +7686,7 @@ assemble_shell_energy(double time,	/* present time value */
 		      const Exo_DB *exo)  
 {
   int eqn, var, peqn, pvar, dim, p, a, b, k, jk;
-  int *n_dof = NULL;
+  int n_dof[MAX_VARIABLE_TYPES];
   int dof_map[MDE];
   int i = -1, ii;
   int j, jj, status;
@@ -7802,7 +7800,6 @@ assemble_shell_energy(double time,	/* present time value */
   /*
    * Prepare geometry
    */
-  n_dof = (int *)array_alloc (1, MAX_VARIABLE_TYPES, sizeof(int));
   /* NOT SURE THIS IS NEEDED like in assemble lubrication */
   lubrication_shell_initialize(n_dof, dof_map, -1, xi, exo, 0);
                                                                  
@@ -8778,7 +8775,6 @@ assemble_shell_energy(double time,	/* present time value */
   
     /* clean-up */
   fv->wt = wt;  /* load_neighbor_var_data screws this up */
-  safe_free((void *) n_dof);
   return(status);
 } /* end of assemble_shell_energy */
 
@@ -8823,7 +8819,7 @@ assemble_film( double time,	/* present time value */
   int var, peqn, pvar, dim, p;
   int i = -1, ii;
   int j, status;
-  int *n_dof = NULL;
+  int n_dof[MAX_VARIABLE_TYPES];
   int dof_map[MDE];
 
   dbl grad_II_P[DIM];  /* Lubrication pressure gradient. */
@@ -8867,7 +8863,6 @@ assemble_film( double time,	/* present time value */
   /*
    * Prepare geometry
    */
-  n_dof = (int *)array_alloc (1, MAX_VARIABLE_TYPES, sizeof(int));
   lubrication_shell_initialize(n_dof, dof_map, -1, xi, exo, 0);
 
 
@@ -9354,7 +9349,6 @@ assemble_film( double time,	/* present time value */
 
     } /* end of Assemble_Jacobian */
 
-  safe_free((void *) n_dof);
 
   return(status);
 } /* end of assemble_film */
@@ -13240,9 +13234,7 @@ assemble_lubrication_power_law( double time,    /* present time value */
   dbl H, H_U, dH_U_dtime, H_L, dH_L_dtime, dH_dtime, dH_U_ddh;
   dbl dH_U_dX[DIM],dH_L_dX[DIM], dH_U_dp;
   dbl shear_top, shear_bot, cross_shear, gradP_mag;
-  dbl *grad_P, *grad_II_P;
-  grad_P = (double *) malloc(DIM * sizeof(double));
-  grad_II_P = (double *) malloc(DIM * sizeof(double));
+  dbl *grad_P, grad_II_P[DIM];
   dbl mu, mu0, nexp;
   dbl veloU[DIM], veloL[DIM];
 
@@ -13254,16 +13246,14 @@ assemble_lubrication_power_law( double time,    /* present time value */
    */
   dbl phi_i;
   dbl grad_phi_i[DIM];
-  dbl *grad_II_phi_i;
-  grad_II_phi_i = (double *) malloc(DIM * sizeof(double));
+  dbl grad_II_phi_i[DIM];
 
   /*
    * Interpolation functions for variables and some of their derivatives.
    */
   dbl phi_j;
   dbl grad_phi_j[DIM];
-  dbl *grad_II_phi_j;
-  grad_II_phi_j = (double *) malloc(DIM * sizeof(double));
+  dbl grad_II_phi_j[DIM];
 
 
   dbl h3;                       /* Volume element (scale factors). */
@@ -13294,9 +13284,7 @@ assemble_lubrication_power_law( double time,    /* present time value */
 
   /* Tangent vectors to the lubrication plane */
   dbl tangent1_init[DIM], tangent2_init[DIM];
-  dbl *tangent1, *tangent2;
-  tangent1 = (double *) malloc(DIM * sizeof(double));
-  tangent2 = (double *) malloc(DIM * sizeof(double));
+  dbl tangent1[DIM], tangent2[DIM];
   dbl tangent1_mag, tangent2_mag;
 
   shell_determinant_and_normal(ei->ielem, ei->iconnect_ptr, ei->num_local_nodes,
@@ -3253,7 +3253,7 @@ mesh_stress_tensor(dbl TT[DIM][DIM],
       if(elc->thermal_expansion_model == SHRINKAGE)
 	{
 	  if((fv->external_field[0] >= 1.63 && fv->external_field[0] <= 1.7) ||
-	     Element_Blocks[ei->elem_blk_index].ElemStorage[mat_ielem].solidified[ip])
+	     ES_QP(Element_Blocks + ei->elem_blk_index, solidified, mat_ielem, ip))
 	    {
 	      for ( p=0; p<VIM; p++)
 		{
@@ -3262,7 +3262,7 @@ mesh_stress_tensor(dbl TT[DIM][DIM],
 		      TT[p][q] -=  (2.* mu + 3.*lambda) * (-0.04) * delta(p,q);
 		    }
 		}
-	      Element_Blocks[ei->elem_blk_index].ElemStorage[mat_ielem].solidified[ip] = 1.0;
+	      ES_QP(Element_Blocks + ei->elem_blk_index, solidified, mat_ielem, ip) = 1.0;
 	    }
 	}
  
@@ -63,6 +63,19 @@
 #include "sl_aux.h"
 #include "goma.h"
 
+/*
+ * Fickian flux terms of one species, with the diffusivities already
+ * evaluated, so that get_continuous_species_terms() evaluates them once
+ * per quadrature point rather than once per species.
+ */
+static int fickian_flux_terms
+PROTO((struct Species_Conservation_Terms *, /* st                            */
+       int ));			/* w                                         */
+
+static int generalized_fickian_flux_terms
+PROTO((struct Species_Conservation_Terms *, /* st                            */
+       int ));			/* w                                         */
+
 /*********** R O U T I N E S   I N   T H I S   F I L E *************************
 *
 *						-All routines in this
@@ -472,6 +485,7 @@ assemble_mass_transport(double time, /* present time valuel; KSC             */
 	       *  ldof pertaining to the same variable type.
 	       */
 	      ii = ei->lvdof_to_row_lvdof[eqn][i];
+	      if (LEC_DIRICHLET_ROW(MAX_PROB_VAR + w, ii)) continue;
 
 		  phi_i = bf[eqn]->phi[i];
 
@@ -710,6 +724,7 @@ assemble_mass_transport(double time, /* present time valuel; KSC             */
 	       *  ldof pertaining to the same variable type.
 	       */
 	      ii = ei->lvdof_to_row_lvdof[eqn][i];		  
+	      if (LEC_DIRICHLET_ROW(MAX_PROB_VAR + w, ii)) continue;
 	      phi_i = bf[eqn]->phi[i];
 	
 		  wt_func = bf[eqn]->phi[i];
@@ -10225,15 +10240,16 @@ get_continuous_species_terms(struct Species_Conservation_Terms *st,
 	  
       for ( w=0; w<pd->Num_Species_Eqn; w++)
 	{
-	  err = fickian_flux(st,w);
+	  err = fickian_flux_terms(st,w);
 	}
     }
   else if ( cr->MassFluxModel == GENERALIZED_FICKIAN )
     {
+      if ( Generalized_Diffusivity() )  EH( -1, "Error in Diffusivity.");
 	  
       for ( w=0; w<pd->Num_Species_Eqn; w++)
 	{
-	  err = generalized_fickian_flux(st,w);
+	  err = generalized_fickian_flux_terms(st,w);
 	}
     }
   else if ( cr->MassFluxModel == FICKIAN_CHARGED)     /* Fickian diffusion of charged species, KSC: 9/2000 */ 
@@ -10268,7 +10284,7 @@ get_continuous_species_terms(struct Species_Conservation_Terms *st,
 	    case CONSTANT:
 	    case USER:
 	    case POROUS:
-	      fickian_flux(st, w);
+	      fickian_flux_terms(st, w);
 	      break;
 	      
 	    case HYDRO:
@@ -10458,19 +10474,23 @@ get_continuous_species_terms(struct Species_Conservation_Terms *st,
      *         field in th upd structure. We do not consider the pressure field
      *         from the calculation itself, yet.
      */
+    double pressureCGS;
+    double *jac_Species_Source, *d_species_source_T;
+    int num_species = pd->Num_Species;
+    double dtmp, mw;
+
     pressureCGS = upd->Pressure_Datum;
     if (af->Assemble_Jacobian) {
       jac_Species_Source = mp->Jac_Species_Source;
       d_species_source_T = mp->d_species_source;
-      iopt[0] = 1;
       if (mp->Species_Var_Type == SPECIES_MASS_FRACTION) {
 	/*
 	 * Calculate the Jacobian d_source_i / d_MF_j under the
 	 * conditions of constant other MF_l, l = 1, ..., Num_species
 	 */
-	err = ck_VD_dsdy(ei->mn, &pressureCGS, &(fv->T), fv->c, NULL,
-			 jac_Species_Source, num_species,
-			 d_species_source_T, iopt, st->MassSource);
+	err = ck_gas_source_cached(ei->mn, pressureCGS, fv->T, fv->c,
+				   num_species, TRUE, st->MassSource,
+				   jac_Species_Source, d_species_source_T);
 	/*
          * We need to fix the conditions up to account for Goma's
          * usage of n-1 equations. Thus, Goma requires the following
@@ -10507,8 +10527,8 @@ get_continuous_species_terms(struct Species_Conservation_Terms *st,
       }
 
     } else {
-    err = ck_VD_wyp(ei->mn, &pressureCGS, &(fv->T), fv->c, NULL,
-		    st->MassSource);
+    err = ck_gas_source_cached(ei->mn, pressureCGS, fv->T, fv->c,
+			       num_species, FALSE, st->MassSource, NULL, NULL);
     for (w = 0; w < pd->Num_Species_Eqn; w++) {
       st->MassSource[w] *= mp->molecular_weight[w];
     }
@@ -12654,10 +12674,13 @@ fickian_charged_flux (struct Species_Conservation_Terms *st, int w)
   if (af->Assemble_Jacobian) { 
     var = MASS_FRACTION;
     for (a = 0; a < VIM; a++) {
-      for (j = 0; j < ei->dof[var]; j++) {
-	for (w1 = 0; w1 < pd->Num_Species_Eqn; w1++) {
+      for (w1 = 0; w1 < pd->Num_Species_Eqn; w1++) {
+	if (w1 == w) continue;
+	for (j = 0; j < ei->dof[var]; j++) {
 	  st->d_diff_flux_dc[w][a][w1][j] = 0.0;
 	}
+      }
+      for (j = 0; j < ei->dof[var]; j++) {
 	st->d_diff_flux_dc[w][a][w][j] = - coeff_rho * 
 	    (mp->diffusivity[w] * bf[var]->grad_phi[j][a] +
 	     FRTzD * bf[var]->phi[j] * fv->grad_V[a]);
@@ -12667,8 +12690,8 @@ fickian_charged_flux (struct Species_Conservation_Terms *st, int w)
     for (q = 0; q < pd->Num_Dim; q++) {
       var = MESH_DISPLACEMENT1 + q;
       if (pd->v[var]) {
-	for (j = 0; j < ei->dof[var]; j++) {
-	  for (a = 0; a < VIM; a++) {
+	for (a = 0; a < VIM; a++) {
+	  for (j = 0; j < ei->dof[var]; j++) {
 	    st->d_diff_flux_dmesh[w][a] [q][j] = - coeff_rho *
 		(mp->diffusivity[w] * fv->d_grad_c_dmesh[a][w] [q][j] +
 		FRTzD * fv->c[w] * fv->d_grad_V_dmesh[a][q][j]);
@@ -12932,14 +12955,21 @@ fickian_flux (struct Species_Conservation_Terms *st, int w)
      * the velocity being the mass-averaged velocity.
      **************************************************************************/
 {
-  int w1, a, j, q, var;
-  double tmp, avg_molec_weight, coeff_rho, rhoD, *phi_ptr;
-
   /*
    *  Get diffusivity and Jacobian dependence on the diffusivity
    */
   if (Diffusivity()) EH(-1, "Error in Diffusivity.");
 
+  return (fickian_flux_terms(st, w));
+} /* END of routine fickian_flux */
+/*******************************************************************************/
+
+static int
+fickian_flux_terms (struct Species_Conservation_Terms *st, int w)
+{
+  int w1, a, j, q, var;
+  double tmp, avg_molec_weight, coeff_rho, rhoD, *phi_ptr;
+
   /*
    *  Add in rho or C depending upon species variable type
    */
@@ -12996,7 +13026,7 @@ fickian_flux (struct Species_Conservation_Terms *st, int w)
     }
   }
   return (0);
-} /* END of routine fickian_flux */
+} /* END of routine fickian_flux_terms */
 /*******************************************************************************/
 /*******************************************************************************/
 /*******************************************************************************/
@@ -13041,13 +13071,31 @@ generalized_fickian_flux (struct Species_Conservation_Terms *st, int w)
      *            coeff_rho = 1.0
      **************************************************************************/
 {
-  int w1, w2, a, j, q, var, status = 0;
-  double tmp, avg_molec_weight, coeff_rho, *phi_ptr;
   /*
    * Get diffusivity and derivatives 
    */
   if (Generalized_Diffusivity())  EH(-1, "Error in Diffusivity.");
 
+  return (generalized_fickian_flux_terms(st, w));
+} /* END of routine generalized_fickian_flux */
+/*******************************************************************************/
+
+static int
+generalized_fickian_flux_terms (struct Species_Conservation_Terms *st, int w)
+
+    /*
+     * The diffusivity sensitivities are contracted with grad_Y first,
+     *
+     *   g[w1] = sum_w2 dD(w,w2)/dY(w1) grad_Y(w2),
+     *
+     * so that each row of d_diff_flux_dc[w][a][w1][] is one pass over the
+     * dofs instead of one per species w2.
+     */
+{
+  int w1, w2, a, j, q, var, status = 0;
+  double tmp, avg_molec_weight, coeff_rho, *phi_ptr, *dgc_ptr;
+  double g, D;
+
   /*
    *  Add in rho or C depending upon species variable type
    */
@@ -13072,16 +13120,17 @@ generalized_fickian_flux (struct Species_Conservation_Terms *st, int w)
     var = MASS_FRACTION;
     phi_ptr =  bf[var]->phi;
     for (a = 0; a < VIM; a++) {
-      for (j = 0; j < ei->dof[var]; j++) {
-	tmp = coeff_rho * phi_ptr[j];
-	for (w1 = 0; w1 < pd->Num_Species; w1++) {
-	  for (w2 = 0; w2 < pd->Num_Species; w2++) {
-	    st->d_diff_flux_dc[w][a] [w1][j] -= 
-		mp->d_diffusivity_gf[w][w2][MAX_VARIABLE_TYPES + w1]
-		* tmp * st->grad_Y[w2][a];
-	  }
+      for (w1 = 0; w1 < pd->Num_Species; w1++) {
+	g = 0.;
+	for (w2 = 0; w2 < pd->Num_Species; w2++) {
+	  g += mp->d_diffusivity_gf[w][w2][MAX_VARIABLE_TYPES + w1]
+	    * st->grad_Y[w2][a];
+	}
+	g *= coeff_rho;
+	D = mp->diffusivity_gen_fick[w][w1];
+	for (j = 0; j < ei->dof[var]; j++) {
 	  st->d_diff_flux_dc[w][a] [w1][j] -= 
-	      mp->diffusivity_gen_fick[w][w1] * bf[var]->grad_phi[j][a];
+	      g * phi_ptr[j] + D * bf[var]->grad_phi[j][a];
 	}
       }
     }
@@ -13089,12 +13138,12 @@ generalized_fickian_flux (struct Species_Conservation_Terms *st, int w)
     for (q = 0; q < pd->Num_Dim; q++) {
       var = MESH_DISPLACEMENT1 + q;
       if (pd->v[var]) {
-	for (j = 0; j < ei->dof[var]; j++) {
-	  for (a = 0; a < VIM; a++) {
-	    for (w1 = 0; w1 < pd->Num_Species; w1++) {
-	      st->d_diff_flux_dmesh[w][a] [q][j] -=
-		  coeff_rho * mp->diffusivity_gen_fick[w][w1]
-		  * fv->d_grad_c_dmesh[a][w1][q][j];
+	for (a = 0; a < VIM; a++) {
+	  for (w1 = 0; w1 < pd->Num_Species; w1++) {
+	    D = coeff_rho * mp->diffusivity_gen_fick[w][w1];
+	    dgc_ptr = fv->d_grad_c_dmesh[a][w1][q];
+	    for (j = 0; j < ei->dof[var]; j++) {
+	      st->d_diff_flux_dmesh[w][a] [q][j] -= D * dgc_ptr[j];
 	    }
 	  }
 	}
@@ -13104,19 +13153,18 @@ generalized_fickian_flux (struct Species_Conservation_Terms *st, int w)
     var = TEMPERATURE;
     phi_ptr = bf[var]->phi;
     for (a = 0; a < VIM; a++) {
+      g = 0.;
+      for (w1 = 0; w1 < pd->Num_Species; w1++) { 
+	g += mp->d_diffusivity_gf[w][w1][var] * st->grad_Y[w1][a];
+      }
+      tmp = - coeff_rho * g;
       for (j = 0; j < ei->dof[var]; j++) {
-	tmp = coeff_rho * phi_ptr[j];
-	st->d_diff_flux_dT[w][a] [j] = 0.;
-	for (w1 = 0; w1 < pd->Num_Species; w1++) { 
-	  st->d_diff_flux_dT[w][a][j] -=  
-	      mp->d_diffusivity_gf[w][w1][var] 
-	      * tmp * st->grad_Y[w1][a];
-	}
+	st->d_diff_flux_dT[w][a] [j] = tmp * phi_ptr[j];
       }
     }
   }
   return (status);
-} /* END of routine generalized_fickian_flux */
+} /* END of routine generalized_fickian_flux_terms */
 /*******************************************************************************/
 /*******************************************************************************/
 /*******************************************************************************/
@@ -23,6 +23,7 @@
 #include <strings.h>
 #include <string.h>
 #include <math.h>
+#include <float.h>
 
 /* GOMA include files */
 #include "std.h"
@@ -54,12 +55,99 @@
 #define _MM_FILL_STRESS_C
 #include "goma.h"
 
-extern struct Boundary_Condition *inlet_BC[MAX_VARIABLE_TYPES+MAX_CONC];
+/*
+ * Upwind face data of the discontinuous Galerkin stress terms, one entry
+ * per element face (indexed like exo->elem_elem_list) and filled in by
+ * assemble_surface_stress() the first time it needs it. None of it
+ * depends on the solution:
+ *
+ *   - whether TABLE_BC inlet stresses cover the element,
+ *   - at the upwind neighbor's surface quadrature points, their positions,
+ *     the stress basis functions and the solution indices of the
+ *     neighbor's stress dofs (or the inlet table stresses),
+ *   - which of those points each point of this face matches,
+ *   - the matrix positions of the neighbor stress columns (FULL_DG).
+ *
+ * An entry only ever belongs to the element that owns the face, so the
+ * threads of a colored assembly never share one.
+ */
+struct DG_Stress_Face {
+  int filled;			/* table scan done */
+  int num_zeros;		/* stress components without an inlet table */
+  int *table_ibc;		/* [MAX_MODES*DIM*DIM], inlet faces only */
+  int nqp;			/* > 0 once the upwind data below is set */
+  int ndof;			/* stress dofs in phi_v */
+  dbl *x_n;			/* [nqp*DIM] upwind quadrature points */
+  dbl *phi_v;			/* [nqp*ndof] stress basis at those points */
+  dbl *stress_table;		/* [nqp*MAX_MODES*DIM*DIM] inlet faces */
+  int *gather_ptr;		/* [MAX_MODES*DIM*DIM+1] into gather_* */
+  int *gather_ie;		/* neighbor stress unknowns ... */
+  int *gather_j;		/* ... and the basis function each goes with */
+  int *match;			/* [nqp] upwind point of each point, -2 unknown */
+  dbl *J_base;			/* matrix the offsets below are into */
+  int *J_off[MAX_MODES];	/* neighbor column positions (FULL_DG) */
+};
+
+static struct DG_Stress_Face *DG_Face = NULL;
+static int DG_Face_Len = 0;
+
+static struct DG_Stress_Face *dg_stress_face
+PROTO((Exo_DB *,		/* exo                                       */
+       const int ,		/* ielem                                     */
+       const int ));		/* id_side                                   */
+
+static int dg_stress_table_ibc
+PROTO((Exo_DB *,		/* exo                                       */
+       const int ,		/* ielem                                     */
+       int [MAX_MODES][DIM][DIM])); /* table_ibc - (out)                 */
+
+static void dg_face_record_neighbor
+PROTO((struct DG_Stress_Face *,
+       const int ,		/* ip_total                                  */
+       const int ,		/* neighbor                                  */
+       const int ,		/* num_local_nodes                           */
+       dbl **,			/* x_n                                       */
+       dbl [][MDE],		/* phi_v                                     */
+       int [MAX_MODES][DIM][DIM])); /* v_s                               */
+
+static void dg_face_restore
+PROTO((const struct DG_Stress_Face *,
+       dbl [][MAX_MODES][DIM][DIM], /* stress_neighbor                   */
+       dbl [][MDE],		/* phi_v                                     */
+       dbl **));		/* x_n                                       */
+
+static void dg_face_gather_neighbor
+PROTO((const struct DG_Stress_Face *,
+       const dbl [],		/* x                                         */
+       const dbl [],		/* x_update                                  */
+       dbl [][MAX_MODES][DIM][DIM], /* stress_neighbor                   */
+       dbl [][MDE],		/* phi_v                                     */
+       dbl **));		/* x_n                                       */
+
+static void dg_face_record_table
+PROTO((struct DG_Stress_Face *,
+       const int ,		/* ip_total                                  */
+       dbl **,			/* x_n                                       */
+       dbl [][MAX_MODES][DIM][DIM])); /* stress_neighbor                 */
+
+static void dg_face_gather_table
+PROTO((const struct DG_Stress_Face *,
+       dbl [][MAX_MODES][DIM][DIM], /* stress_neighbor                   */
+       dbl [][MDE],		/* phi_v                                     */
+       dbl **));		/* x_n                                       */
+
+static void dg_face_neighbor_pointers
+PROTO((struct DG_Stress_Face *,
+       Exo_DB *,
+       struct Aztec_Linear_Solver_System *,
+       const int ,		/* neighbor                                  */
+       const int ,		/* etype                                     */
+       const int ,		/* mode                                      */
+       int [MAX_MODES][DIM][DIM], /* R_s                                 */
+       int [MAX_MODES][DIM][DIM], /* v_s                                 */
+       dbl *[DIM][DIM][MDE][DIM][DIM][MDE])); /* J_S_S                   */
 
-// direct call to a fortran LAPACK eigenvalue routine
-extern FSUB_TYPE dsyev_(char *JOBZ, char *UPLO, int *N, double *A, int *LDA,
-			double *W, double *WORK, int *LWORK, int *INFO,
-			int len_jobz, int len_uplo);
+extern struct Boundary_Condition *inlet_BC[MAX_VARIABLE_TYPES+MAX_CONC];
 
 /*  _______________________________________________________________________  */
 
@@ -4352,7 +4440,6 @@ assemble_surface_stress (Exo_DB *exo,	/* ptr to basic exodus ii mesh information
   int v_s[MAX_MODES][DIM][DIM];
   int S_map[MAX_MODES][DIM][DIM]; /* map var index to stress mode component */
 
-  int ibc, ins, side_index;
   int table_ibc[MAX_MODES][DIM][DIM]; /* maps table boundary condition index for each stress mode */
   int num_zeros; 
 
@@ -4365,7 +4452,9 @@ assemble_surface_stress (Exo_DB *exo,	/* ptr to basic exodus ii mesh information
   dbl stress_update_v[MAX_SURF_GP][MAX_MODES][DIM][DIM];
   dbl s_n[MAX_MODES][DIM][DIM];
   dbl d_grad_s_dmesh[DIM][DIM][DIM][DIM][MDE];
-  dbl **x_neighbor;
+  dbl x_neighbor_buf[MAX_SURF_GP][DIM];
+  dbl *x_neighbor[MAX_SURF_GP];
+  struct DG_Stress_Face *face;
 
   dbl *J_S_S_v[MAX_MODES][DIM][DIM][MDE][DIM][DIM][MDE];
   dbl phi_neighbor[MAX_SURF_GP][MDE];
@@ -4392,10 +4481,10 @@ assemble_surface_stress (Exo_DB *exo,	/* ptr to basic exodus ii mesh information
   err = stress_eqn_pointer(v_s);
   err = stress_eqn_pointer(R_s);
 
-  /* initialization of the neighbor stress pointers array */
-
-
-  memset( J_S_S_v, 0,  MAX_MODES*DIM*DIM*MDE*DIM*DIM*MDE);
+  /*
+   * J_S_S_v is only read where load_neighbor_pointers() or the face
+   * cache has set it.
+   */
 
   /********************************************************************************/
   /*     START OF SURFACE LOOPS THAT REQUIRE INTEGRATION (WEAK SENSE)             */
@@ -4408,195 +4497,26 @@ assemble_surface_stress (Exo_DB *exo,	/* ptr to basic exodus ii mesh information
   dim =  pd->Num_Dim;
 
 
-  /* allocate space for x_neighbor */
-
-  /*  x_neighbor = (double **) array_alloc(2, ip_total, DIM, sizeof(double)); */
-  /*  manually allocate space to correct (seeming) misalignment for HPUX */
-
-   x_neighbor = (double **) smalloc( ip_total*sizeof(double*) );
-     for( i=0; i<DIM; i++ )
-      {
-        x_neighbor[i] = ( double * ) smalloc( DIM * sizeof(double) );
-      }
-
-
-
-/* If no neighbor element found, check for table boundary condition on inlet */
-
-     for(mode=0; mode<vn->modes; mode++) 
-       {
-	 for(a=0; a<VIM; a++)
-	   {
-	     for(b=0; b<VIM; b++)
-	       {
-		 table_ibc[mode][a][b]=-1;
-	       }
-	   }
-       }
-
-     for(ibc=0; ibc<Num_BC; ibc++)
-       { 
-	 if(BC_Types[ibc].BC_Name == TABLE_BC)
-	   {
-	     /*Loop over all side sets to find a match */
-	     for(ins=0; ins<exo->num_side_sets; ins++)
-	       {
-		 if(Proc_SS_Ids[ins]==BC_Types[ibc].BC_ID)
-		   {
-		     
-		     
-		     /* Does it contain the element? */
-		     for(side_index=0;side_index<exo->ss_num_sides[ins];side_index++)
-		       {
-			 
-			 if(ielem==exo->ss_elem_list[exo->ss_elem_index[ins]+side_index])
-			   {
-			     /* which variable is the table for? */
-			     switch(BC_Types[ibc].table->f_index)
-			       {
-			       case POLYMER_STRESS11:
-				 {
-				   table_ibc[0][0][0]=ibc;
-				   break;
-				 }
-			       case POLYMER_STRESS12:
-				 {
-				   table_ibc[0][0][1]=ibc;
-				   break;
-				 }
-			       case POLYMER_STRESS22:
-				 {
-				   table_ibc[0][1][1]=ibc;
-				   break;
-				 }
-			       case POLYMER_STRESS11_1:
-				 {
-				   table_ibc[1][0][0]=ibc;
-				   break;
-				 }
-			       case POLYMER_STRESS12_1:
-				 {
-				   table_ibc[1][0][1]=ibc;
-				   break;
-				 }
-			       case POLYMER_STRESS22_1:
-				 {
-				   table_ibc[1][1][1]=ibc;
-				   break;
-				 }
-			       case POLYMER_STRESS11_2:
-				 {
-				   table_ibc[2][0][0]=ibc;
-				   break;
-				 }
-			       case POLYMER_STRESS12_2:
-				 {
-				   table_ibc[2][0][1]=ibc;
-				   break;
-				 }
-			       case POLYMER_STRESS22_2:
-				 {
-				   table_ibc[2][1][1]=ibc;
-				   break;
-				 }
-			       case POLYMER_STRESS11_3:
-				 {
-				   table_ibc[3][0][0]=ibc;
-				   break;
-				 }
-			       case POLYMER_STRESS12_3:
-				 {
-				   table_ibc[3][0][1]=ibc;
-				   break;
-				 }
-			       case POLYMER_STRESS22_3:
-				 {
-				   table_ibc[3][1][1]=ibc;
-				   break;
-				 }
-			       case POLYMER_STRESS11_4:
-				 {
-				   table_ibc[4][0][0]=ibc;
-				   break;
-				 }
-			       case POLYMER_STRESS12_4:
-				 {
-				   table_ibc[4][0][1]=ibc;
-				   break;
-				 }
-			       case POLYMER_STRESS22_4:
-				 {
-				   table_ibc[4][1][1]=ibc;
-				   break;
-				 }
-			       case POLYMER_STRESS11_5:
-				 {
-				   table_ibc[5][0][0]=ibc;
-				   break;
-				 }
-			       case POLYMER_STRESS12_5:
-				 {
-				   table_ibc[5][0][1]=ibc;
-				   break;
-				 }
-			       case POLYMER_STRESS22_5:
-				 {
-				   table_ibc[5][1][1]=ibc;
-				   break;
-				 }
-			       case POLYMER_STRESS11_6:
-				 {
-				   table_ibc[6][0][0]=ibc;
-				   break;
-				 }
-			       case POLYMER_STRESS12_6:
-				 {
-				   table_ibc[6][0][1]=ibc;
-				   break;
-				 }
-			       case POLYMER_STRESS22_6:
-				 {
-				   table_ibc[6][1][1]=ibc;
-				   break;
-				 }
-			       case POLYMER_STRESS11_7:
-				 {
-				   table_ibc[7][0][0]=ibc;
-				   break;
-				 }
-			       case POLYMER_STRESS12_7:
-				 {
-				   table_ibc[7][0][1]=ibc;
-				   break;
-				 }
-			       case POLYMER_STRESS22_7:
-				 {
-				   table_ibc[7][1][1]=ibc;
-				   break;
-				 }
-			       default:
-				 {
-				   break;
-				 }
-			       }
-			   } /* end check for right element */
-		       } /* end loop over sides of ins */
-		   } /*close if loop for BC_ID check */
-	       } /*close loop over all side sets */
-	   } /* end if loop over tables */
-       } /* end loop over all bc's */
+  for (i = 0; i < MAX_SURF_GP; i++) x_neighbor[i] = x_neighbor_buf[i];
 
-     num_zeros = 0;
+  /* If no neighbor element found, check for table boundary condition on inlet */
 
-     for(mode=0; mode<vn->modes; mode++) {
-       for(a=0; a<VIM; a++){
-	 for(b=0; b<VIM; b++)
-	   {
-	     if((a <= b)&&(table_ibc[mode][a][b] == -1)) 
-	       { num_zeros++; }
-	   }
-       }
-     }
+  face = dg_stress_face(exo, ielem, id_side);
+  if (!face->filled)
+    {
+      face->num_zeros = dg_stress_table_ibc(exo, ielem, table_ibc);
+      if (neighbor == -1 && face->num_zeros == 0)
+	{
+	  face->table_ibc = alloc_int_1(MAX_MODES*DIM*DIM, -1);
+	  memcpy(face->table_ibc, table_ibc, MAX_MODES*DIM*DIM*sizeof(int));
+	}
+      face->filled = TRUE;
+    }
+  else if (face->table_ibc != NULL)
+    {
+      memcpy(table_ibc, face->table_ibc, MAX_MODES*DIM*DIM*sizeof(int));
+    }
+  num_zeros = face->num_zeros;
 
      /* if num_zeros == 0, then table bc's exist for all stress modes
 	if num_zeros == vn->modes*(VIM!), then no table bc's exist
@@ -4662,23 +4582,43 @@ assemble_surface_stress (Exo_DB *exo,	/* ptr to basic exodus ii mesh information
 	{
  	  if(neighbor != -1 )
 	    {
-	      err =  neighbor_stress(exo, x, x_update, ielem, neighbor, stress_neighbor, 
-				     stress_update_v, phi_neighbor,
-				     num_local_nodes, nodes_per_side,
-				     local_elem_node_id, ielem_type, 
-				     ielem_type_fill,  x_neighbor, S_map);
-	      EH( err, "neighbor_stress");
+	      if (face->nqp == 0)
+		{
+		  err =  neighbor_stress(exo, x, x_update, ielem, neighbor, stress_neighbor, 
+					 stress_update_v, phi_neighbor,
+					 num_local_nodes, nodes_per_side,
+					 local_elem_node_id, ielem_type, 
+					 ielem_type_fill,  x_neighbor, S_map);
+		  EH( err, "neighbor_stress");
+		  dg_face_record_neighbor(face, ip_total, neighbor,
+					  num_local_nodes, x_neighbor,
+					  phi_neighbor, S_map);
+		}
+	      else
+		{
+		  dg_face_gather_neighbor(face, x, x_update, stress_neighbor,
+					  phi_neighbor, x_neighbor);
+		}
 	    }
  	  else if((neighbor==-1)&&(num_zeros==0))
 	    {
 	      /* inlet table boundary consitions exist for the stress components */
 
-	      err =  neighbor_stress_table(exo, x, x_update, ielem, stress_neighbor,  
-				     stress_update_v, phi_neighbor,
-				     num_local_nodes, nodes_per_side,
-				     local_elem_node_id, ielem_type, 
-				     ielem_type_fill,  x_neighbor, S_map, table_ibc);
-	      EH( err, "neighbor_stress_table");
+	      if (face->nqp == 0)
+		{
+		  err =  neighbor_stress_table(exo, x, x_update, ielem, stress_neighbor,  
+					       stress_update_v, phi_neighbor,
+					       num_local_nodes, nodes_per_side,
+					       local_elem_node_id, ielem_type, 
+					       ielem_type_fill,  x_neighbor, S_map, table_ibc);
+		  EH( err, "neighbor_stress_table");
+		  dg_face_record_table(face, ip_total, x_neighbor, stress_neighbor);
+		}
+	      else
+		{
+		  dg_face_gather_table(face, stress_neighbor, phi_neighbor,
+				       x_neighbor);
+		}
 	    }
  	  else
 	    {
@@ -4749,26 +4689,35 @@ assemble_surface_stress (Exo_DB *exo,	/* ptr to basic exodus ii mesh information
 	  if((neighbor != -1)||(num_zeros==0))
 	    {
 	      found_it = 0; 
-	      for (ip1 = 0; ip1 < ip_total && (!found_it); ip1++) 
+	      if (face->match[ip] == -2)
 		{
-		  if(  (fabs(fv->x0[0]-x_neighbor[ip1][0])<1.e-7)
-		       &&(fabs(fv->x0[1]-x_neighbor[ip1][1])<1.e-7)
-		       &&(fabs(fv->x0[2]-x_neighbor[ip1][2])<1.e-7))
+		  face->match[ip] = -1;
+		  for (ip1 = 0; ip1 < ip_total && face->match[ip] < 0; ip1++) 
 		    {
-		      found_it = 1;
-		      phi_v = phi_neighbor[ip1];
+		      if(  (fabs(fv->x0[0]-x_neighbor[ip1][0])<1.e-7)
+			   &&(fabs(fv->x0[1]-x_neighbor[ip1][1])<1.e-7)
+			   &&(fabs(fv->x0[2]-x_neighbor[ip1][2])<1.e-7))
+			{
+			  face->match[ip] = ip1;
+			}
+		    }
+		}
+	      ip1 = face->match[ip];
+	      if (ip1 >= 0)
+		{
+		  found_it = 1;
+		  phi_v = phi_neighbor[ip1];
 
-		      for ( mode=0; mode<vn->modes; mode++)
+		  for ( mode=0; mode<vn->modes; mode++)
+		    {
+		      for ( a=0; a<VIM; a++)
 			{
-			  for ( a=0; a<VIM; a++)
+			  for ( b=0; b<VIM; b++)
 			    {
-			      for ( b=0; b<VIM; b++)
+			      /* since the stress tensor is symmetric, only assemble the upper half */ 
+			      if(a <= b)
 				{
-				  /* since the stress tensor is symmetric, only assemble the upper half */ 
-				  if(a <= b)
-				    {
-				      s_n[mode][a][b] = stress_neighbor[ip1][mode][a][b];
-				    }
+				  s_n[mode][a][b] = stress_neighbor[ip1][mode][a][b];
 				}
 			    }
 			}
@@ -4798,9 +4747,11 @@ assemble_surface_stress (Exo_DB *exo,	/* ptr to basic exodus ii mesh information
 		{
 		  load_modal_pointers(mode, t_, delta_t, s, s_dot, grad_s, d_grad_s_dmesh);
 
-		  if( vn->dg_J_model == FULL_DG && Linear_Solver != FRONT)
+		  if( vn->dg_J_model == FULL_DG && Linear_Solver != FRONT &&
+		      neighbor != -1 && af->Assemble_Jacobian)
 		    {
-		      load_neighbor_pointers( exo, ams, neighbor, ielem_type, mode, R_s, v_s, J_S_S_v[mode] );
+		      dg_face_neighbor_pointers(face, exo, ams, neighbor, ielem_type,
+						mode, R_s, v_s, J_S_S_v[mode]);
 		    }
 
 		  if ( af->Assemble_Residual )
@@ -4870,7 +4821,8 @@ assemble_surface_stress (Exo_DB *exo,	/* ptr to basic exodus ii mesh information
 						advection; 
 
 					       advection = 0;
-					      if ( vn->dg_J_model == FULL_DG && found_it)
+					      if ( vn->dg_J_model == FULL_DG && found_it &&
+						   (neighbor != -1 || Linear_Solver == FRONT))
 						{
 						    advection = wt * fv->sdet * vdotn *
 						      ve[mode]->time_const *
@@ -4963,51 +4915,504 @@ assemble_surface_stress (Exo_DB *exo,	/* ptr to basic exodus ii mesh information
 	}
     }
 		      
-  for (i=0; i<ip_total; i++) {
-    safer_free(( void ** ) &x_neighbor[i] );
-    }
-
-  safer_free( (void **) &x_neighbor);
-
   return 0;
 }
 /*****************************************************************************/
 /* END of routine assemble_surface_stress */
 /*****************************************************************************/
 
+static struct DG_Stress_Face *
+dg_stress_face(Exo_DB *exo, const int ielem, const int id_side)
 
+    /*
+     * The face cache entry of side id_side of element ielem; the cache is
+     * allocated, empty, by whichever thread gets here first.
+     */
+{
+  int len = exo->elem_elem_pntr[exo->num_elems];
 
-int 
-neighbor_stress(Exo_DB *exo,	/* ptr to basic exodus ii mesh information */
-		dbl x[],
-		dbl x_update[],
-		int current_elem,
-		int neighbor_elem,
-		dbl stress_neighbor[][MAX_MODES][DIM][DIM],
-		dbl snv[][MAX_MODES][DIM][DIM],
-		dbl phi_v[][MDE],
-		int num_local_nodes,
-		int nodes_per_side,
-		int local_elem_node_id[],
-		int ielem_type,
-		int ielem_type_fill,
-		dbl **x_n,
-		int v_s[MAX_MODES][DIM][DIM])
-/*   
- *   This function take the current element and side and 
- *   knowing who the neighboring element is, finds the value
- *   of the fill function at the current gauss point location
- *   in the neighboring element.
- *
+  if (DG_Face_Len != len)
+    {
+#ifdef _OPENMP
+#pragma omp critical (dg_stress_faces)
+#endif
+      {
+	if (DG_Face_Len != len)
+	  {
+	    DG_Face = alloc_struct_1(struct DG_Stress_Face, MAX(len, 1));
+#ifdef _OPENMP
+#pragma omp flush
+#endif
+	    DG_Face_Len = len;
+	  }
+      }
+    }
+  return (DG_Face + exo->elem_elem_pntr[ielem] + id_side - 1);
+}
 
- *  TAB certifies that this function conforms to the exo/patran side numbering convention 11/9/98.
- */
+static int
+dg_stress_table_ibc(Exo_DB *exo, const int ielem,
+		    int table_ibc[MAX_MODES][DIM][DIM])
 
+    /*
+     * Which TABLE_BC gives the inlet value of each stress component of
+     * element ielem, or -1. Returns the number of components a <= b of
+     * all modes without one.
+     */
 {
-  int gnn, ledof, i, j, mode;
-  int iconnect_ptr;
-  int id_side, id;
-  int id_local_elem_coord[MAX_NODES_PER_SIDE];
+  int mode, a, b, ibc, ins, side_index, num_zeros;
+
+
+     for(mode=0; mode<vn->modes; mode++) 
+       {
+	 for(a=0; a<VIM; a++)
+	   {
+	     for(b=0; b<VIM; b++)
+	       {
+		 table_ibc[mode][a][b]=-1;
+	       }
+	   }
+       }
+
+     for(ibc=0; ibc<Num_BC; ibc++)
+       { 
+	 if(BC_Types[ibc].BC_Name == TABLE_BC)
+	   {
+	     /*Loop over all side sets to find a match */
+	     for(ins=0; ins<exo->num_side_sets; ins++)
+	       {
+		 if(Proc_SS_Ids[ins]==BC_Types[ibc].BC_ID)
+		   {
+		     
+		     
+		     /* Does it contain the element? */
+		     for(side_index=0;side_index<exo->ss_num_sides[ins];side_index++)
+		       {
+			 
+			 if(ielem==exo->ss_elem_list[exo->ss_elem_index[ins]+side_index])
+			   {
+			     /* which variable is the table for? */
+			     switch(BC_Types[ibc].table->f_index)
+			       {
+			       case POLYMER_STRESS11:
+				 {
+				   table_ibc[0][0][0]=ibc;
+				   break;
+				 }
+			       case POLYMER_STRESS12:
+				 {
+				   table_ibc[0][0][1]=ibc;
+				   break;
+				 }
+			       case POLYMER_STRESS22:
+				 {
+				   table_ibc[0][1][1]=ibc;
+				   break;
+				 }
+			       case POLYMER_STRESS11_1:
+				 {
+				   table_ibc[1][0][0]=ibc;
+				   break;
+				 }
+			       case POLYMER_STRESS12_1:
+				 {
+				   table_ibc[1][0][1]=ibc;
+				   break;
+				 }
+			       case POLYMER_STRESS22_1:
+				 {
+				   table_ibc[1][1][1]=ibc;
+				   break;
+				 }
+			       case POLYMER_STRESS11_2:
+				 {
+				   table_ibc[2][0][0]=ibc;
+				   break;
+				 }
+			       case POLYMER_STRESS12_2:
+				 {
+				   table_ibc[2][0][1]=ibc;
+				   break;
+				 }
+			       case POLYMER_STRESS22_2:
+				 {
+				   table_ibc[2][1][1]=ibc;
+				   break;
+				 }
+			       case POLYMER_STRESS11_3:
+				 {
+				   table_ibc[3][0][0]=ibc;
+				   break;
+				 }
+			       case POLYMER_STRESS12_3:
+				 {
+				   table_ibc[3][0][1]=ibc;
+				   break;
+				 }
+			       case POLYMER_STRESS22_3:
+				 {
+				   table_ibc[3][1][1]=ibc;
+				   break;
+				 }
+			       case POLYMER_STRESS11_4:
+				 {
+				   table_ibc[4][0][0]=ibc;
+				   break;
+				 }
+			       case POLYMER_STRESS12_4:
+				 {
+				   table_ibc[4][0][1]=ibc;
+				   break;
+				 }
+			       case POLYMER_STRESS22_4:
+				 {
+				   table_ibc[4][1][1]=ibc;
+				   break;
+				 }
+			       case POLYMER_STRESS11_5:
+				 {
+				   table_ibc[5][0][0]=ibc;
+				   break;
+				 }
+			       case POLYMER_STRESS12_5:
+				 {
+				   table_ibc[5][0][1]=ibc;
+				   break;
+				 }
+			       case POLYMER_STRESS22_5:
+				 {
+				   table_ibc[5][1][1]=ibc;
+				   break;
+				 }
+			       case POLYMER_STRESS11_6:
+				 {
+				   table_ibc[6][0][0]=ibc;
+				   break;
+				 }
+			       case POLYMER_STRESS12_6:
+				 {
+				   table_ibc[6][0][1]=ibc;
+				   break;
+				 }
+			       case POLYMER_STRESS22_6:
+				 {
+				   table_ibc[6][1][1]=ibc;
+				   break;
+				 }
+			       case POLYMER_STRESS11_7:
+				 {
+				   table_ibc[7][0][0]=ibc;
+				   break;
+				 }
+			       case POLYMER_STRESS12_7:
+				 {
+				   table_ibc[7][0][1]=ibc;
+				   break;
+				 }
+			       case POLYMER_STRESS22_7:
+				 {
+				   table_ibc[7][1][1]=ibc;
+				   break;
+				 }
+			       default:
+				 {
+				   break;
+				 }
+			       }
+			   } /* end check for right element */
+		       } /* end loop over sides of ins */
+		   } /*close if loop for BC_ID check */
+	       } /*close loop over all side sets */
+	   } /* end if loop over tables */
+       } /* end loop over all bc's */
+
+     num_zeros = 0;
+
+     for(mode=0; mode<vn->modes; mode++) {
+       for(a=0; a<VIM; a++){
+	 for(b=0; b<VIM; b++)
+	   {
+	     if((a <= b)&&(table_ibc[mode][a][b] == -1)) 
+	       { num_zeros++; }
+	   }
+       }
+     }
+
+  return (num_zeros);
+}
+
+static void
+dg_face_record_neighbor(struct DG_Stress_Face *face, const int ip_total,
+			const int neighbor, const int num_local_nodes,
+			dbl **x_n, dbl phi_v[][MDE],
+			int v_s[MAX_MODES][DIM][DIM])
+
+    /*
+     * Keep what neighbor_stress() just worked out for this face, and the
+     * neighbor stress unknowns in the order it sums them.
+     */
+{
+  int ip, p, j, i, n, mode, a, b, v, gnn, nvdof, ledof, ie;
+  int iconnect_ptr = Proc_Connect_Ptr[neighbor];
+
+  face->ndof = ei->dof[POLYMER_STRESS11];
+  face->x_n = alloc_dbl_1(ip_total * DIM, 0.0);
+  face->phi_v = alloc_dbl_1(MAX(ip_total * face->ndof, 1), 0.0);
+  face->match = alloc_int_1(ip_total, -2);
+  for (ip = 0; ip < ip_total; ip++) {
+    for (p = 0; p < DIM; p++) face->x_n[ip * DIM + p] = x_n[ip][p];
+    for (j = 0; j < face->ndof; j++) {
+      face->phi_v[ip * face->ndof + j] = phi_v[ip][j];
+    }
+  }
+
+  face->gather_ptr = alloc_int_1(MAX_MODES*DIM*DIM + 1, 0);
+  for (n = 0; n < 2; n++) {
+    int k = 0;
+    for (mode = 0; mode < vn->modes; mode++) {
+      for (a = 0; a < VIM; a++) {
+	for (b = 0; b < VIM; b++) {
+	  if (n == 0) face->gather_ptr[(mode * DIM + a) * DIM + b] = k;
+	  v = v_s[mode][a][b];
+	  if (a <= b && pd->v[v]) {
+	    for (i = 0; i < num_local_nodes; i++) {
+	      gnn = Proc_Elem_Connect[iconnect_ptr + i];
+	      nvdof = Dolphin[gnn][v];
+	      for (j = 0; j < nvdof; j++) {
+		if (n == 1) {
+		  ledof = ei->lvdof_to_ledof[v][j];
+		  ie = Index_Solution(gnn, v, 0, j, ei->matID_ledof[ledof]);
+		  EH(ie, "Could not find vbl in sparse matrix.");
+		  face->gather_ie[k] = ie;
+		  face->gather_j[k] = j;
+		}
+		k++;
+	      }
+	    }
+	  }
+	}
+      }
+    }
+    for (i = vn->modes * DIM * DIM; i <= MAX_MODES*DIM*DIM; i++) {
+      face->gather_ptr[i] = k;
+    }
+    if (n == 0) {
+      face->gather_ie = alloc_int_1(MAX(k, 1), -1);
+      face->gather_j = alloc_int_1(MAX(k, 1), 0);
+    }
+  }
+  face->nqp = ip_total;
+}
+
+static void
+dg_face_restore(const struct DG_Stress_Face *face,
+		dbl stress_neighbor[][MAX_MODES][DIM][DIM],
+		dbl phi_v[][MDE],
+		dbl **x_n)
+
+    /*
+     * Positions and basis functions of the recorded upwind points, with
+     * the stresses zeroed, as neighbor_stress() leaves them.
+     */
+{
+  int ip, p, j, mode, a, b;
+
+  for (ip = 0; ip < face->nqp; ip++) {
+    for (p = 0; p < DIM; p++) x_n[ip][p] = face->x_n[ip * DIM + p];
+    for (j = 0; j < MDE; j++) {
+      phi_v[ip][j] = (j < face->ndof) ? face->phi_v[ip * face->ndof + j] : 0.;
+    }
+    for (mode = 0; mode < vn->modes; mode++) {
+      for (a = 0; a < VIM; a++) {
+	for (b = 0; b < VIM; b++) {
+	  stress_neighbor[ip][mode][a][b] = 0.;
+	}
+      }
+    }
+  }
+}
+
+static void
+dg_face_gather_neighbor(const struct DG_Stress_Face *face,
+			const dbl x[], const dbl x_update[],
+			dbl stress_neighbor[][MAX_MODES][DIM][DIM],
+			dbl phi_v[][MDE],
+			dbl **x_n)
+
+    /*
+     * neighbor_stress() through the recorded face data: the upwind
+     * stresses gathered from the neighbor's unknowns.
+     */
+{
+  int ip, k, mode, a, b, c, ie;
+  int lagged = (vn->dg_J_model == EXPLICIT_DG ||
+		vn->dg_J_model == SEGREGATED ||
+		vn->dg_J_model == CONDENSED_DG);
+  dbl arg_j, wt = vn->dg_J_model_wt[0];
+
+  dg_face_restore(face, stress_neighbor, phi_v, x_n);
+
+  for (ip = 0; ip < face->nqp; ip++) {
+    for (mode = 0; mode < vn->modes; mode++) {
+      for (a = 0; a < VIM; a++) {
+	for (b = a; b < VIM; b++) {
+	  c = (mode * DIM + a) * DIM + b;
+	  for (k = face->gather_ptr[c]; k < face->gather_ptr[c+1]; k++) {
+	    ie = face->gather_ie[k];
+	    arg_j = lagged ? x[ie] - wt * x_update[ie] : x[ie];
+	    stress_neighbor[ip][mode][a][b] += arg_j * phi_v[ip][face->gather_j[k]];
+	  }
+	}
+      }
+    }
+  }
+}
+
+static void
+dg_face_record_table(struct DG_Stress_Face *face, const int ip_total,
+		     dbl **x_n,
+		     dbl stress_neighbor[][MAX_MODES][DIM][DIM])
+
+    /*
+     * Keep the inlet table stresses neighbor_stress_table() just
+     * interpolated at this face's points.
+     */
+{
+  int ip, p, mode, a, b;
+
+  face->ndof = 0;
+  face->x_n = alloc_dbl_1(ip_total * DIM, 0.0);
+  face->match = alloc_int_1(ip_total, -2);
+  face->stress_table = alloc_dbl_1(ip_total * MAX_MODES*DIM*DIM, 0.0);
+  for (ip = 0; ip < ip_total; ip++) {
+    for (p = 0; p < DIM; p++) face->x_n[ip * DIM + p] = x_n[ip][p];
+    for (mode = 0; mode < vn->modes; mode++) {
+      for (a = 0; a < VIM; a++) {
+	for (b = 0; b < VIM; b++) {
+	  face->stress_table[((ip * MAX_MODES + mode) * DIM + a) * DIM + b] =
+	    stress_neighbor[ip][mode][a][b];
+	}
+      }
+    }
+  }
+  face->nqp = ip_total;
+}
+
+static void
+dg_face_gather_table(const struct DG_Stress_Face *face,
+		     dbl stress_neighbor[][MAX_MODES][DIM][DIM],
+		     dbl phi_v[][MDE],
+		     dbl **x_n)
+{
+  int ip, mode, a, b;
+
+  dg_face_restore(face, stress_neighbor, phi_v, x_n);
+  for (ip = 0; ip < face->nqp; ip++) {
+    for (mode = 0; mode < vn->modes; mode++) {
+      for (a = 0; a < VIM; a++) {
+	for (b = 0; b < VIM; b++) {
+	  stress_neighbor[ip][mode][a][b] =
+	    face->stress_table[((ip * MAX_MODES + mode) * DIM + a) * DIM + b];
+	}
+      }
+    }
+  }
+}
+
+static void
+dg_face_neighbor_pointers(struct DG_Stress_Face *face, Exo_DB *exo,
+			  struct Aztec_Linear_Solver_System *ams,
+			  const int neighbor, const int etype, const int mode,
+			  int R_s[MAX_MODES][DIM][DIM],
+			  int v_s[MAX_MODES][DIM][DIM],
+			  dbl *J_S_S[DIM][DIM][MDE][DIM][DIM][MDE])
+
+    /*
+     * load_neighbor_pointers() for one mode, from the matrix positions
+     * recorded the first time (or again if the matrix has moved).
+     */
+{
+  int n, k, a, b, i, j, eqn, var;
+
+  if (face->J_off[mode] == NULL || face->J_base != ams->val) {
+    if (face->J_base != ams->val) {
+      for (n = 0; n < MAX_MODES; n++) safer_free((void **) &(face->J_off[n]));
+      face->J_base = ams->val;
+    }
+    load_neighbor_pointers(exo, ams, neighbor, etype, mode, R_s, v_s, J_S_S);
+    for (n = 0; n < 2; n++) {
+      k = 0;
+      for (a = 0; a < VIM; a++) {
+	for (b = a; b < VIM; b++) {
+	  eqn = R_s[mode][a][b];
+	  var = v_s[mode][a][b];
+	  if (pd->e[eqn] && pd->v[var]) {
+	    for (i = 0; i < ei->dof[eqn]; i++) {
+	      for (j = 0; j < ei->dof[var]; j++) {
+		if (n == 1) face->J_off[mode][k] = J_S_S[a][b][i][a][b][j] - ams->val;
+		k++;
+	      }
+	    }
+	  }
+	}
+      }
+      if (n == 0) face->J_off[mode] = alloc_int_1(MAX(k, 1), 0);
+    }
+    return;
+  }
+
+  k = 0;
+  for (a = 0; a < VIM; a++) {
+    for (b = a; b < VIM; b++) {
+      eqn = R_s[mode][a][b];
+      var = v_s[mode][a][b];
+      if (pd->e[eqn] && pd->v[var]) {
+	for (i = 0; i < ei->dof[eqn]; i++) {
+	  for (j = 0; j < ei->dof[var]; j++) {
+	    J_S_S[a][b][i][a][b][j] = ams->val + face->J_off[mode][k++];
+	  }
+	}
+      }
+    }
+  }
+}
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
+
+
+int 
+neighbor_stress(Exo_DB *exo,	/* ptr to basic exodus ii mesh information */
+		dbl x[],
+		dbl x_update[],
+		int current_elem,
+		int neighbor_elem,
+		dbl stress_neighbor[][MAX_MODES][DIM][DIM],
+		dbl snv[][MAX_MODES][DIM][DIM],
+		dbl phi_v[][MDE],
+		int num_local_nodes,
+		int nodes_per_side,
+		int local_elem_node_id[],
+		int ielem_type,
+		int ielem_type_fill,
+		dbl **x_n,
+		int v_s[MAX_MODES][DIM][DIM])
+/*   
+ *   This function take the current element and side and 
+ *   knowing who the neighboring element is, finds the value
+ *   of the fill function at the current gauss point location
+ *   in the neighboring element.
+ *
+
+ *  TAB certifies that this function conforms to the exo/patran side numbering convention 11/9/98.
+ */
+
+{
+  int gnn, ledof, i, j, mode;
+  int iconnect_ptr;
+  int id_side, id;
+  int id_local_elem_coord[MAX_NODES_PER_SIDE];
   int ie;
   int ielem_shape;
   int inode[MAX_NODES_PER_SIDE];
@@ -5134,7 +5539,8 @@ neighbor_stress(Exo_DB *exo,	/* ptr to basic exodus ii mesh information */
 					ei->matID_ledof[ledof]);
 		    EH(ie, "Could not find vbl in sparse matrix.");
 		    if ( vn->dg_J_model == EXPLICIT_DG ||
-			 vn->dg_J_model == SEGREGATED) {
+			 vn->dg_J_model == SEGREGATED ||
+			 vn->dg_J_model == CONDENSED_DG) {
 		      arg_j =  x[ie] -  vn->dg_J_model_wt[0] * x_update[ie];
 		    } else {
 		      arg_j =  x[ie] ;
@@ -5566,6 +5972,60 @@ segregate_stress_update ( double x_update[] )
     }
  return(status);
 }
+/***************************************************************************/
+/***************************************************************************/
+/***************************************************************************/
+int
+condense_stress_lec(void)
+
+/*
+ * Static condensation of discontinuous polymer stress in the element
+ * matrix (Discontinuous Jacobian Formulation = CONDENSED).
+ *
+ * With the upwind neighbor stress lagged, as for EXPLICIT, the stress rows
+ * of a discontinuous interpolation are assembled entirely in their own
+ * element, so the stress block of each mode can be eliminated from the
+ * other rows with condense_lec_block(). The momentum and other rows then
+ * no longer reference the stress unknowns: the global system is block
+ * triangular in the stress, and the stress rows only give back the local
+ * stress update once the rest is solved.
+ *
+ * Return: 0, or -1 if a stress block is singular.
+ */
+{
+  int s_peqn[CONDENSE_MAX_DOF];
+  int s_pvar[CONDENSE_MAX_DOF];
+  int s_ldof[CONDENSE_MAX_DOF];
+  int v_s[MAX_MODES][DIM][DIM];
+  int mode, a, b, i, n, v;
+
+  if (vn->dg_J_model != CONDENSED_DG) return (0);
+  if (af->Assemble_LSA_Jacobian_Matrix || af->Assemble_LSA_Mass_Matrix) return (0);
+
+  (void) stress_eqn_pointer(v_s);
+
+  for (mode = 0; mode < vn->modes; mode++)
+    {
+      n = 0;
+      for (a = 0; a < VIM; a++)
+	{
+	  for (b = a; b < VIM; b++)
+	    {
+	      v = v_s[mode][a][b];
+	      if (!pd->e[v] || !pd->v[v]) continue;
+	      for (i = 0; i < ei->dof[v]; i++)
+		{
+		  s_peqn[n] = upd->ep[v];
+		  s_pvar[n] = upd->vp[v];
+		  s_ldof[n] = i;
+		  n++;
+		}
+	    }
+	}
+      if (condense_lec_block(n, s_peqn, s_pvar, s_ldof) == -1) return (-1);
+    }
+  return (0);
+}
 		  
 /* This routine calculates the adaptive viscosity from Sun et al., 1999.
  * The adaptive viscosity term multiplies the continuous and discontinuous
@@ -5770,46 +6230,112 @@ stress_eqn_pointer(int v_s[MAX_MODES][DIM][DIM])
 
 
 void
-compute_exp_s(double s[DIM][DIM],
-	      double exp_s[DIM][DIM],
-              double eig_values[DIM],
-              double R[DIM][DIM])
-{
+sym_eigen_jacobi(const int n,
+		 double s[DIM][DIM],
+		 double eig[DIM],
+		 double R[DIM][DIM])
 
-  int N = VIM;
-  int LDA = N;
-  int i,j,k;
+/*
+ * Eigenvalues (ascending) and orthonormal eigenvectors (the columns of R)
+ * of the symmetric n x n tensor (n <= DIM) whose upper triangle is in s, by
+ * cyclic Jacobi sweeps. A 2x2 takes a single rotation and a 3x3 is down
+ * to round off in a handful of sweeps, with no workspace and no call out
+ * to LAPACK for a tensor this small.
+ */
+{
+  int i, j, k, p, q, sweep;
+  double a[DIM][DIM];
+  double off, diag, theta, t, c, sn, apq, arp, arq, tmp;
+
+  memset(a, 0, sizeof(double)*DIM*DIM);
+  memset(R, 0, sizeof(double)*DIM*DIM);
+  memset(eig, 0, sizeof(double)*DIM);
+  for (i = 0; i < n; i++) {
+    R[i][i] = 1.;
+    for (j = i; j < n; j++) {
+      a[i][j] = a[j][i] = s[i][j];
+    }
+  }
 
-  int INFO;
-  int LWORK = 20;
-  double WORK[LWORK];
+  for (sweep = 0; sweep < 50; sweep++) {
+    off = 0.;
+    diag = 0.;
+    for (p = 0; p < n; p++) {
+      diag += a[p][p]*a[p][p];
+      for (q = p+1; q < n; q++) off += a[p][q]*a[p][q];
+    }
+    if (off <= DBL_EPSILON*DBL_EPSILON*diag || off == 0.) break;
+
+    for (p = 0; p < n; p++) {
+      for (q = p+1; q < n; q++) {
+	apq = a[p][q];
+	if (apq == 0.) continue;
+	theta = (a[q][q] - a[p][p])/(2.*apq);
+	if (fabs(theta) > 1.e150) {
+	  t = 0.5/theta;
+	} else {
+	  t = 1./(fabs(theta) + sqrt(theta*theta + 1.));
+	  if (theta < 0.) t = -t;
+	}
+	c = 1./sqrt(t*t + 1.);
+	sn = t*c;
+
+	a[p][p] -= t*apq;
+	a[q][q] += t*apq;
+	a[p][q] = a[q][p] = 0.;
+	for (k = 0; k < n; k++) {
+	  if (k != p && k != q) {
+	    arp = a[k][p];
+	    arq = a[k][q];
+	    a[k][p] = a[p][k] = c*arp - sn*arq;
+	    a[k][q] = a[q][k] = sn*arp + c*arq;
+	  }
+	  arp = R[k][p];
+	  arq = R[k][q];
+	  R[k][p] = c*arp - sn*arq;
+	  R[k][q] = sn*arp + c*arq;
+	}
+      }
+    }
+  }
 
-  double A[VIM*VIM];
-  double EIGEN_MAX = sqrt(sqrt(DBL_MAX));
-  double eig_S[DIM];
-  memset(eig_values, 0.0, sizeof(double)*DIM);
-  memset(WORK, 0, sizeof(double)*LWORK);
+  for (i = 0; i < n; i++) eig[i] = a[i][i];
 
-  // convert to column major
-  for (i = 0; i < VIM; i++) {
-    for (j = 0; j < VIM; j++) {
-      A[i*VIM + j] = s[j][i];
+  // ascending order, as dsyev_ returned them
+  for (i = 1; i < n; i++) {
+    for (j = i; j > 0 && eig[j] < eig[j-1]; j--) {
+      tmp = eig[j]; eig[j] = eig[j-1]; eig[j-1] = tmp;
+      for (k = 0; k < n; k++) {
+	tmp = R[k][j]; R[k][j] = R[k][j-1]; R[k][j-1] = tmp;
+      }
     }
   }
+} // End sym_eigen_jacobi
+
+void
+compute_sym_eigen(double s[DIM][DIM],
+		  double eig[DIM],
+		  double R[DIM][DIM])
 
+/*
+ * sym_eigen_jacobi() of the VIM x VIM part of s.
+ */
+{
+  sym_eigen_jacobi(VIM, s, eig, R);
+} // End compute_sym_eigen
 
-  // eig solver
-  dsyev_("V", "U", &N, A, &LDA, eig_S, WORK, &LWORK, &INFO, 1, 1);
-  if( INFO > 0) fprintf(stderr,"eigsolver not converged %d\n",INFO);
-  if( INFO < 0) fprintf(stderr,"eigsolver illegal entry %d\n",INFO);
+void
+compute_exp_s(double s[DIM][DIM],
+	      double exp_s[DIM][DIM],
+              double eig_values[DIM],
+              double R[DIM][DIM])
+{
+  int i,j,k;
 
+  double EIGEN_MAX = sqrt(sqrt(DBL_MAX));
+  double eig_S[DIM];
 
-  // transpose (revert to row major)
-  for (i = 0; i < VIM; i++) {
-    for (j = 0; j < VIM; j++) {
-      R[i][j] = A[j*VIM + i];
-    }
-  }
+  compute_sym_eigen(s, eig_S, R);
 
   // exponentiate diagonal
   for (i = 0; i < VIM; i++) {
@@ -6063,55 +6589,65 @@ void
 compute_d_exp_s_ds(dbl s[DIM][DIM],                   //s - stress
 		   dbl exp_s[DIM][DIM],
 		   dbl d_exp_s_ds[DIM][DIM][DIM][DIM])
+
+/*
+ * Derivative of exp(s) with respect to the symmetric pair s[i][j], s[j][i]
+ * (both move together, so d_exp_s_ds[p][q][i][j] == d_exp_s_ds[p][q][j][i]).
+ * With s = R diag(l) R^T, the Daleckii-Krein formula gives
+ *
+ *   d exp(s) = R ( (R^T ds R) o F ) R^T,  F[a][b] = (e^l_a - e^l_b)/(l_a - l_b)
+ *
+ * and F[a][b] = e^((l_a + l_b)/2) for (nearly) equal eigenvalues.
+ */
 {
-  double s_p[DIM][DIM], s_n[DIM][DIM];
-  double exp_s_p[DIM][DIM], exp_s_n[DIM][DIM];
-  double eig_values[DIM];
-  double R1[DIM][DIM];
-  int i,j,p,q;
-  double ds, ds_den, fd = FD_FACTOR;
+  double eig_S[DIM], e[DIM];
+  double R[DIM][DIM], F[DIM][DIM], X[DIM][DIM];
+  double EIGEN_MAX = sqrt(sqrt(DBL_MAX));
+  double dl, d;
+  int i,j,a,b,p,q;
 
   memset(d_exp_s_ds, 0, sizeof(double)*DIM*DIM*DIM*DIM);
- 
-  for (i = 0; i < VIM; i++) {
-    for (j = 0; j < VIM; j++) {
-      s_p[i][j] = s_n[i][j] = s[i][j];
+
+  compute_sym_eigen(s, eig_S, R);
+
+  for (a = 0; a < VIM; a++) e[a] = MIN(exp(eig_S[a]), EIGEN_MAX);
+  for (a = 0; a < VIM; a++) {
+    for (b = 0; b < VIM; b++) {
+      dl = eig_S[a] - eig_S[b];
+      if (fabs(dl) > 1.e-8*MAX(1., fabs(eig_S[a]))) {
+	F[a][b] = (e[a] - e[b])/dl;
+      } else {
+	F[a][b] = MIN(exp(0.5*(eig_S[a] + eig_S[b])), EIGEN_MAX);
+      }
     }
   }
 
   for (i = 0; i < VIM; i++) {
     for (j = i; j < VIM; j++) {
 
-      // perturb s
-      ds = fd*s[i][j];
-      ds = (fabs(ds) < fd ? fd : ds);
-      s_p[i][j] += ds;
-      s_n[i][j] -= ds;
-      if( i != j) {
-        s_p[j][i] = s_p[i][j];
-        s_n[j][i] = s_n[i][j];
-        }  
-
-      ds_den = 0.5/ds;
-
-      // find exp_s at perturbed value
-      compute_exp_s(s_p, exp_s_p, eig_values, R1);
-      compute_exp_s(s_n, exp_s_n, eig_values, R1);
+      // (R^T ds R) o F for the unit perturbation of the pair
+      for (a = 0; a < VIM; a++) {
+	for (b = 0; b < VIM; b++) {
+	  X[a][b] = R[i][a]*R[j][b];
+	  if (i != j) X[a][b] += R[j][a]*R[i][b];
+	  X[a][b] *= F[a][b];
+	}
+      }
 
-      // approximate derivative
       for (p = 0; p < VIM; p++) {
 	for (q = 0; q < VIM; q++) {
-	  d_exp_s_ds[p][q][i][j] = ds_den*(exp_s_p[p][q] - exp_s_n[p][q]);
-	  if(i != j)d_exp_s_ds[p][q][j][i] = d_exp_s_ds[p][q][i][j];
+	  d = 0.;
+	  for (a = 0; a < VIM; a++) {
+	    for (b = 0; b < VIM; b++) {
+	      d += R[p][a]*X[a][b]*R[q][b];
+	    }
 	  }
-        }  
-      s_p[i][j] = s_n[i][j] = s[i][j];
-      if( i != j) {
-         s_p[j][i] = s_n[j][i] = s[j][i];
-         } 
+	  d_exp_s_ds[p][q][i][j] = d;
+	  if (i != j) d_exp_s_ds[p][q][j][i] = d;
+	}
+      }
     }
   }
-
 }
 
 dbl
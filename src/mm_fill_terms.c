@@ -305,6 +305,9 @@ assemble_mesh (double time,
   dbl d_area;
   
   dbl * _J;
+
+  /* no Jacobian while the Mesh Stiffness Lag reuses the element's */
+  int jac = af->Assemble_Jacobian && !mesh_stiffness_lagged();
   
 
 
@@ -383,7 +386,7 @@ assemble_mesh (double time,
    */
   /* initialize some arrays */
   memset( TT, 0, sizeof(double)*DIM*DIM);
-  if (af->Assemble_Jacobian) {
+  if (jac) {
     memset( dTT_dx,         0, sizeof(double)*DIM*DIM*DIM*MDE);
     memset( dTT_dp,         0, sizeof(double)*DIM*DIM*MDE);
     memset( dTT_dc,         0, sizeof(double)*DIM*DIM*MAX_CONC*MDE);
@@ -487,6 +490,7 @@ assemble_mesh (double time,
 
 	  for ( i=0; i<ei->dof[eqn]; i++)
 	    {
+	      if (LEC_DIRICHLET_ROW(peqn, i)) continue;
 	      phi_i = bfm->phi[i];
 
 	      grad_phi_i_e_a = bfm->grad_phi_e[i][a] ;
@@ -572,7 +576,7 @@ assemble_mesh (double time,
    * Jacobian terms...
    */
 
-  if ( af->Assemble_Jacobian )
+  if ( jac )
     {
       for ( a=0; a<dim; a++)
 	{
@@ -593,6 +597,7 @@ assemble_mesh (double time,
 
 	  for ( i=0; i<ei->dof[eqn]; i++)
 	    {
+	      if (LEC_DIRICHLET_ROW(peqn, i)) continue;
 	      phi_i = bfm->phi[i];
 	      grad_phi_i_e_a = bfm->grad_phi_e[i][a] ;
 	      dgradphi_i_e_a_dmesh = bfm->d_grad_phi_e_dmesh[i][a];
@@ -1468,6 +1473,7 @@ assemble_energy(double time,	/* present time value */
       for ( i=0; i<ei->dof[eqn]; i++)
 	{
 	  
+	  if (LEC_DIRICHLET_ROW(peqn, i)) continue;
 #if 1
           /* this is an optimization for xfem */
 	  if ( xfem != NULL )
@@ -1559,6 +1565,7 @@ assemble_energy(double time,	/* present time value */
       peqn = upd->ep[eqn];
       for ( i=0; i<ei->dof[eqn]; i++)
 	{
+	  if (LEC_DIRICHLET_ROW(peqn, i)) continue;
 #if 1
           /* this is an optimization for xfem */
 	  if ( xfem != NULL )
@@ -2820,6 +2827,7 @@ assemble_momentum(dbl time,       /* current time */
 	       *  ldof pertaining to the same variable type.
 	       */
 	      ii = ei->lvdof_to_row_lvdof[eqn][i];
+	      if (LEC_DIRICHLET_ROW(peqn, ii)) continue;
 
 
 	      phi_i = phi_i_vector[i];
@@ -3036,6 +3044,7 @@ assemble_momentum(dbl time,       /* current time */
 	       *  ldof pertaining to the same variable type.
 	       */
 	      ii = ei->lvdof_to_row_lvdof[eqn][i];
+	      if (LEC_DIRICHLET_ROW(peqn, ii)) continue;
 
 	      phi_i = phi_i_vector[i];
 
@@ -3423,6 +3432,74 @@ assemble_momentum(dbl time,       /* current time */
 
 		      phi_j_vector = bf[var]->phi;
 
+		      /*
+		       * Without Brinkman, particle, SUPG or continuity
+		       * stabilization terms nothing in the sum depends on j
+		       * beyond the basis and stress derivatives, so the
+		       * coefficients are formed once and each term is a
+		       * straight pass over j the compiler can vectorize.
+		       */
+		      if ( !porous_brinkman_on && !particle_momentum_on &&
+			   supg == 0. && !Cont_GLS )
+			{
+			  dbl mass_c = 0., adv_c = 0., diff_c, src_c;
+			  dbl vrel[DIM];
+			  dbl *d_Pi_qpb, *df_ab;
+
+			  if ( transient_run && mass_on && (a == b) )
+			    {
+			      mass_c = - (1.+2.*tt)/dt * phi_i * rho * d_area * mass_etm;
+			    }
+
+			  if ( mass_c != 0. || advection_on )
+			    {
+			      if ( advection_on )
+				{
+				  adv_c = - rho * wt_func * d_area * advection_etm;
+				}
+			      for ( p=0; p<DIM; p++)
+				{
+				  vrel[p] = (p < wim) ? v[p] - x_dot[p] : 0.;
+				}
+			      for ( j=0; j<ei->dof[var]; j++)
+				{
+				  advection_a = phi_j_vector[j] * grad_v[b][a];
+				  for ( p=0; p<wim; p++)
+				    {
+				      advection_a += vrel[p] * bf[var]->grad_phi_e[j][b][p][a];
+				    }
+				  J[j] += mass_c * phi_j_vector[j] + adv_c * advection_a;
+				}
+			    }
+
+			  if ( diffusion_on )
+			    {
+			      for ( p=0; p<VIM; p++)
+				{
+				  for ( q=0; q<VIM; q++)
+				    {
+				      diff_c = - grad_phi_i_e_a[p][q] * d_area * diffusion_etm;
+				      d_Pi_qpb = d_Pi->v[q][p][b];
+				      for ( j=0; j<ei->dof[var]; j++)
+					{
+					  J[j] += diff_c * d_Pi_qpb[j];
+					}
+				    }
+				}
+			    }
+
+			  if ( source_on )
+			    {
+			      src_c = phi_i * d_area * source_etm;
+			      df_ab = df->v[a][b];
+			      for ( j=0; j<ei->dof[var]; j++)
+				{
+				  J[j] += src_c * df_ab[j];
+				}
+			    }
+			}
+		      else
+
 		      for ( j=0; j<ei->dof[var]; j++)
 			{
 
@@ -7540,6 +7617,8 @@ load_fv(void)
 
   status = 0;
 
+  /* whatever viscosity() kept for the last Gauss point is stale now */
+  viscosity_qp_cache(FALSE);
 
   /* load eqn and variable number in tensor form */
   if( pdv[POLYMER_STRESS11] ) {
@@ -7815,6 +7894,16 @@ load_fv(void)
       {
       fv->n[2] = fv_dot->n[2] = fv_old->n[2] = 0.0;
       } */
+
+  /*
+   * ... or their explicit projections (Level Set Curvature Projection)
+   */
+
+  if ( ls != NULL && ls->Curvature_Projection == LS_CURV_PROJ_LUMPED &&
+       !pdv[CURVATURE] )
+    {
+      ls_projected_fv();
+    }
     
   /* 
    *  shell element orientation angles
@@ -9590,7 +9679,7 @@ load_fv_grads(void)
 		  for (i = 0; i < dofs; i++)
 		    {
 		      fv->grad_v[p][q] += (*esp->v[r][i]) * bf[v]->grad_phi_e[i][r] [p][q];
-		      if ( pd->TimeIntegration != STEADY )
+		      if ( transient_run && pd->old_grad[v] )
 			{
 			  fv_old->grad_v[p][q] += (*esp_old->v[r][i]) * bf[v]->grad_phi_e[i][r][p][q];
 			}
@@ -9690,8 +9779,9 @@ load_fv_grads(void)
 		    {
 		      fv->grad_n[p][q] +=
 			*(esp->n[r][i]) * bf[v]->grad_phi_e[i][r][p][q];
-		      fv_old->grad_n[p][q] +=
-			*(esp_old->n[r][i]) * bf[v]->grad_phi_e[i][r][p][q];
+		      if (pd->old_grad[v])
+			fv_old->grad_n[p][q] +=
+			  *(esp_old->n[r][i]) * bf[v]->grad_phi_e[i][r][p][q];
 		    }
 		}
 	    }
@@ -9942,7 +10032,7 @@ load_fv_grads(void)
 			  {
 				  fv->grad_c[w][p] += 
 				  *esp->c[w][i] * bf[v]->grad_phi[i][p];
-				  if ( pd->TimeIntegration != STEADY )
+				  if ( pd->TimeIntegration != STEADY && pd->old_grad[v] )
 				  {
 					  /* keep this only for VOF/Taylor-Galerkin stuff */
 					  fv_old->grad_c[w][p] += 
@@ -9981,7 +10071,7 @@ load_fv_grads(void)
 		  {
 			  fv->grad_p_liq[p] +=
 			  *esp->p_liq[i] * bf[v]->grad_phi[i][p];
-			  if ( pd->TimeIntegration != STEADY )
+			  if ( pd->TimeIntegration != STEADY && pd->old_grad[v] )
 			  {
 				  /* keep this only for VOF/Taylor-Galerkin stuff */
 				  fv_old->grad_p_liq[p] +=
@@ -10012,7 +10102,7 @@ load_fv_grads(void)
 		  {
 			  fv->grad_p_gas[p] +=
 			  *esp->p_gas[i] * bf[v]->grad_phi[i][p];
-			  if ( pd->TimeIntegration != STEADY )
+			  if ( pd->TimeIntegration != STEADY && pd->old_grad[v] )
 			  {
 				  /* keep this only for VOF/Taylor-Galerkin stuff */
 				  fv_old->grad_p_gas[p] +=
@@ -10040,7 +10130,7 @@ load_fv_grads(void)
 	  for (i = 0; i < dofs; i++)
 	    {
 	      fv->grad_porosity[p] += *esp->porosity[i] * bf[v]->grad_phi[i][p];
-	      if (pd->TimeIntegration != STEADY)
+	      if (pd->TimeIntegration != STEADY && pd->old_grad[v])
 		{
 		  /* keep this only for VOF/Taylor-Galerkin stuff */
 		  fv_old->grad_porosity[p] += *esp_old->porosity[i] * bf[v]->grad_phi[i][p];
@@ -10070,7 +10160,7 @@ load_fv_grads(void)
 	    {
 	      fv->grad_T[p] +=
 		*esp->T[i] * bf[v]->grad_phi[i][p];
-	      if ( pd->TimeIntegration != STEADY )
+	      if ( pd->TimeIntegration != STEADY && pd->old_grad[v] )
 		{
 		  /* keep this only for VOF/Taylor-Galerkin stuff */
 		  fv_old->grad_T[p] +=
@@ -10642,7 +10732,8 @@ load_fv_grads(void)
 	  for ( i=0; i<dofs; i++)
 	    {
 	      fv->grad_lubp_2[p] += *esp->lubp_2[i] * bf[v]->grad_phi[i] [p];
-	      fv_old->grad_lubp_2[p] += *esp_old->lubp_2[i] * bf[v]->grad_phi[i] [p];
+	      if (pd->old_grad[v])
+	        fv_old->grad_lubp_2[p] += *esp_old->lubp_2[i] * bf[v]->grad_phi[i] [p];
 	    }
 	}
     }
@@ -10693,7 +10784,8 @@ load_fv_grads(void)
 	  for ( i=0; i<dofs; i++)
 	    {
 	      fv->grad_sh_p_open[p] += *esp->sh_p_open[i] * bf[v]->grad_phi[i] [p];
-	      fv_old->grad_sh_p_open[p] += *esp_old->sh_p_open[i] * bf[v]->grad_phi[i] [p];
+	      if (pd->old_grad[v])
+	        fv_old->grad_sh_p_open[p] += *esp_old->sh_p_open[i] * bf[v]->grad_phi[i] [p];
 	    }
 	}
     } 
@@ -10712,7 +10804,8 @@ load_fv_grads(void)
 	   for ( i=0; i<dofs; i++)
 	     {
 	       fv->grad_sh_p_open_2[p] += *esp->sh_p_open_2[i] * bf[v]->grad_phi[i] [p];
-	       fv_old->grad_sh_p_open_2[p] += *esp_old->sh_p_open_2[i] * bf[v]->grad_phi[i] [p];
+	       if (pd->old_grad[v])
+	         fv_old->grad_sh_p_open_2[p] += *esp_old->sh_p_open_2[i] * bf[v]->grad_phi[i] [p];
 	     }
 	 }
      } 
@@ -10924,7 +11017,7 @@ load_fv_grads(void)
               for (r = 0; r < dim; r++) {
                   for (i = 0; i < dofs; i++) {
                       fv->grad_em_er[p][q] += (*esp->em_er[r][i]) * bf[v]->grad_phi_e[i][r] [p][q];
-                      if ( pd->TimeIntegration != STEADY ) {
+                      if ( pd->TimeIntegration != STEADY && pd->old_grad[v] ) {
                           fv_old->grad_em_er[p][q] += (*esp_old->em_er[r][i]) * bf[v]->grad_phi_e[i][r][p][q];
                         }
                     }
@@ -10956,7 +11049,7 @@ load_fv_grads(void)
               for (r = 0; r < dim; r++) {
                   for (i = 0; i < dofs; i++) {
                       fv->grad_em_ei[p][q] += (*esp->em_ei[r][i]) * bf[v]->grad_phi_e[i][r] [p][q];
-                      if ( pd->TimeIntegration != STEADY ) {
+                      if ( pd->TimeIntegration != STEADY && pd->old_grad[v] ) {
                           fv_old->grad_em_ei[p][q] += (*esp_old->em_ei[r][i]) * bf[v]->grad_phi_e[i][r][p][q];
                         }
                     }
@@ -10988,7 +11081,7 @@ load_fv_grads(void)
               for (r = 0; r < wim; r++) {
                   for (i = 0; i < dofs; i++) {
                       fv->grad_em_hr[p][q] += (*esp->em_hr[r][i]) * bf[v]->grad_phi_e[i][r] [p][q];
-                      if ( pd->TimeIntegration != STEADY ) {
+                      if ( pd->TimeIntegration != STEADY && pd->old_grad[v] ) {
                           fv_old->grad_em_hr[p][q] += (*esp_old->em_hr[r][i]) * bf[v]->grad_phi_e[i][r][p][q];
                         }
                     }
@@ -11020,7 +11113,7 @@ load_fv_grads(void)
               for (r = 0; r < wim; r++) {
                   for (i = 0; i < dofs; i++) {
                       fv->grad_em_hi[p][q] += (*esp->em_hi[r][i]) * bf[v]->grad_phi_e[i][r] [p][q];
-                      if ( pd->TimeIntegration != STEADY ) {
+                      if ( pd->TimeIntegration != STEADY && pd->old_grad[v] ) {
                           fv_old->grad_em_hi[p][q] += (*esp_old->em_hi[r][i]) * bf[v]->grad_phi_e[i][r][p][q];
                         }
                     }
@@ -14868,7 +14961,10 @@ density(DENSITY_DEPENDENCE_STRUCT *d_rho, double time)
   if (mp->DensityModel == CONSTANT) {
     rho   = mp->density;
   } else if (mp->DensityModel == USER)  {
-    (void) usr_density(mp->u_density);      
+    if (mp->Plugin[GOMA_PLUGIN_DENSITY] >= 0)
+      (void) plugin_property(GOMA_PLUGIN_DENSITY, -1, tran->time_value);
+    else
+      (void) usr_density(mp->u_density);
     rho   = mp->density;
 
     if ( d_rho != NULL )
@@ -15570,7 +15666,10 @@ conductivity( CONDUCTIVITY_DEPENDENCE_STRUCT *d_k,
   if(mp->ConductivityModel == USER )
     {
 
-      usr_thermal_conductivity(mp->u_thermal_conductivity,time);
+      if (mp->Plugin[GOMA_PLUGIN_THERMAL_CONDUCTIVITY] >= 0)
+	plugin_property(GOMA_PLUGIN_THERMAL_CONDUCTIVITY, -1, time);
+      else
+	usr_thermal_conductivity(mp->u_thermal_conductivity,time);
 
       k   = mp->thermal_conductivity;
 
@@ -17562,8 +17661,93 @@ apply_table_mp( double *func, struct Data_Table *table)
 /***************************************************************************/
 /***************************************************************************/
 
+void
+table_interval_setup(struct Data_Table *table)
+  /*
+   *  Find out whether the abscissa t[] of a table is strictly increasing
+   *  and evenly spaced, so that table_interval() can locate a point
+   *  without scanning the table. Called once the table is read (and
+   *  sorted).
+   */
+{
+  int i, N;
+  double *t, dt;
+
+  N = table->tablelength - 1;
+  t = table->t;
+  table->t_ascending = (N >= 1 && t != NULL);
+  table->t_spacing = 0.0;
+  table->last_interval = 0;
+
+  for ( i=0; table->t_ascending && i < N; i++)
+    {
+      if ( !(t[i+1] > t[i]) ) table->t_ascending = FALSE;
+    }
+  if ( !table->t_ascending ) return;
+
+  dt = ( t[N] - t[0] ) / N;
+  for ( i=0; i < N; i++)
+    {
+      if ( fabs(t[i+1] - t[i] - dt) > 1.e-8 * dt ) return;
+    }
+  table->t_spacing = dt;
+}
+
+/***************************************************************************/
+
+int
+table_interval(struct Data_Table *table,
+	       const double x)
+  /*
+   *  Return: i such that t[i] <= x < t[i+1], for t[0] <= x < t[N] in a
+   *          strictly increasing table; -1 if the table is not one and
+   *          the caller has to search it for itself.
+   *
+   *  The interval found last is tried first, since successive calls
+   *  (the Gauss points of an element, Newton iterations) tend to stay
+   *  put. Otherwise evenly spaced tables are indexed directly and the
+   *  others are bisected.
+   */
+{
+  int i, lo, hi, mid, N;
+  double *t;
+
+  if ( !table->t_ascending ) return -1;
+
+  N = table->tablelength - 1;
+  t = table->t;
+
+  i = table->last_interval;
+  if ( i >= 0 && i < N && t[i] <= x && x < t[i+1] ) return i;
+
+  if ( table->t_spacing > 0.0 )
+    {
+      i = (int) ( (x - t[0]) / table->t_spacing );
+      i = MAX(0, MIN(i, N-1));
+      while ( i > 0 && x < t[i] ) i--;
+      while ( i < N-1 && x >= t[i+1] ) i++;
+    }
+  else
+    {
+      lo = 0;
+      hi = N;
+      while ( hi - lo > 1 )
+	{
+	  mid = (lo + hi) / 2;
+	  if ( x >= t[mid] ) lo = mid;
+	  else               hi = mid;
+	}
+      i = lo;
+    }
+
+  table->last_interval = i;
+  return i;
+}
+
+/***************************************************************************/
+
 double
-interpolate_table( struct Data_Table *table, 
+interpolate_table( struct Data_Table *table,
 			double x[], 
 			double *sloper,
 			double dfunc_dx[])
@@ -17628,7 +17812,14 @@ interpolate_table( struct Data_Table *table,
 	  table->slope[0] = ( f[1] - f[0] ) / ( t[1] - t[0] );
 	  func = f[0] +  (table->slope[0]) * ( x[0] - t[0] );
 	}
-      
+
+	i = (x[0] >= t[0] && x[0] < t[N]) ? table_interval(table, x[0]) : -1;
+	if ( i >= 0 )
+	{
+	  table->slope[0] = ( f[i+1] - f[i] ) / ( t[i+1] - t[i] );
+	  func  = f[i] + (table->slope[0]) * ( x[0] - t[i] );
+	}
+	else
 	for( i=0; x[0] >= t[i] &&  i < N ; i++)
 	{
 	  if ( x[0] >= t[i] && x[0] < t[i+1] )
@@ -20289,7 +20480,9 @@ apply_distributed_sources ( int elem, double width,
                   assemble_csf_tensor();
                   break;
                 case LS_CAP_CURVE_BC:
-		  if( pd->e[R_NORMAL1] ) assemble_curvature_with_normals_source () ;
+		  if( pd->e[R_NORMAL1] ||
+		      ls->Curvature_Projection == LS_CURV_PROJ_LUMPED )
+		    assemble_curvature_with_normals_source () ;
                   else                   assemble_curvature_source ();
                   break;
 		case LS_CAP_DIV_N_BC:
@@ -21998,7 +22191,7 @@ assemble_curvature_with_normals_source ( )
   /* Bail out with an error if CURVATURE equation not define 
    */
 
-  if (!pd->e[R_CURVATURE]  )
+  if (!pd->e[R_CURVATURE] && ls->Curvature_Projection != LS_CURV_PROJ_LUMPED )
     {
       EH(-1,"Error: Level set curvature equation needs to be activated to use LS_CAP_CURVE\n");
     }
@@ -22199,7 +22392,7 @@ assemble_curvature_source ( )
   /* Bail out with an error if CURVATURE equation not define 
    */
 
-  if (! pd->e[R_CURVATURE] )
+  if (! pd->e[R_CURVATURE] && ls->Curvature_Projection != LS_CURV_PROJ_LUMPED )
     {
       EH(-1,"Error: Level set curvature equation needs to be activated to use LS_CAP_CURVE\n");
     }	
@@ -30623,7 +30816,10 @@ double heat_source( HEAT_SOURCE_DEPENDENCE_STRUCT *d_h,
 
   if(mp->HeatSourceModel == USER )
     {
-      usr_heat_source(mp->u_heat_source,time);
+      if (mp->Plugin[GOMA_PLUGIN_HEAT_SOURCE] >= 0)
+	plugin_property(GOMA_PLUGIN_HEAT_SOURCE, -1, time);
+      else
+	usr_heat_source(mp->u_heat_source,time);
       h = mp->heat_source;
 
       var = TEMPERATURE;
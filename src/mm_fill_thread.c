@@ -0,0 +1,524 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * Threaded element assembly for matrix_fill_full().
+ *
+ * The elements on this processor are greedily colored over the
+ * node->element connectivity so that two elements of the same color never
+ * share a node.  Since matrix_fill() only scatters into the rows of the
+ * element's own nodes, the elements of one color can be assembled
+ * concurrently without any locking of the MSR/Epetra rows or the residual.
+ *
+ * Each OpenMP thread other than the master gets its own copies of the
+ * per-element scratch structures from assembly_alloc() and bf_init(),
+ * plus a private copy of the material property structures, which are
+ * written at every quadrature point.  The copies are refreshed from the
+ * master's at the start of every fill, so that parameter updates from
+ * continuation, hunting or augmenting conditions reach all the threads.
+ * Everything else is shared.
+ *
+ * Threaded assembly is opt-in through "Assembly Threads = <n>" (or auto)
+ * in the Solver Specifications and only takes effect when goma is compiled
+ * with OpenMP.  Capabilities that keep per-element state outside of the
+ * private scratch (level sets, phase functions, XFEM, shells, the frontal
+ * solver, Element Numerical Jacobian, contact angle conditions) silently
+ * fall back to the serial element loop.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "std.h"
+#include "rf_fem_const.h"
+#include "rf_fem.h"
+#include "rf_io_const.h"
+#include "rf_io.h"
+#include "rf_mp.h"
+#include "rf_solver_const.h"
+#include "rf_solver.h"
+#include "el_geom.h"
+
+#include "mm_as_const.h"
+#include "mm_as_structs.h"
+#include "mm_as.h"
+#include "mm_mp_const.h"
+#include "mm_mp_structs.h"
+#include "mm_mp.h"
+#include "mm_eh.h"
+
+#include "exo_struct.h"
+#include "dpi.h"
+
+#define _MM_FILL_THREAD_C
+#include "goma.h"
+
+int Num_Elem_Colors = 0;
+int *Elem_Color_Ptr = NULL;
+int *Elem_Color_List = NULL;
+
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
+int
+elem_color_setup(Exo_DB *exo)
+
+    /*************************************************************************
+     *
+     * elem_color_setup():
+     *
+     *  Greedy distance-1 coloring of the element->node->element graph.
+     *  Only elements in active materials are colored. On return,
+     *  Elem_Color_List[Elem_Color_Ptr[c]..Elem_Color_Ptr[c+1]-1] holds the
+     *  elements of color c in ascending order.
+     *
+     *  Return: the number of colors.
+     *************************************************************************/
+{
+  int e, ebi, i, j, n, node, nbr, c;
+  int e_start, e_end;
+  int max_colors = 0;
+  int *color, *mark, *count;
+
+  if (!exo->elem_node_conn_exists || !exo->node_elem_conn_exists) {
+    EH(-1, "elem_color_setup needs elem->node and node->elem connectivity");
+  }
+
+  elem_color_free();
+
+  e_start = exo->eb_ptr[0];
+  e_end   = exo->eb_ptr[exo->num_elem_blocks];
+
+  color = alloc_int_1(exo->num_elems, -1);
+
+  /*
+   * No element has more neighbors than the sum of the node degrees of its
+   * nodes, so that is an upper bound on the number of colors we can need.
+   */
+  for (e = e_start; e < e_end; e++) {
+    int deg = 0;
+    for (i = exo->elem_node_pntr[e]; i < exo->elem_node_pntr[e+1]; i++) {
+      node = exo->elem_node_list[i];
+      deg += exo->node_elem_pntr[node+1] - exo->node_elem_pntr[node];
+    }
+    if (deg > max_colors) max_colors = deg;
+  }
+  max_colors++;
+  mark = alloc_int_1(max_colors, -1);
+
+  for (ebi = 0; ebi < exo->num_elem_blocks; ebi++) {
+    if (Matilda[ebi] < 0) continue;
+    for (e = exo->eb_ptr[ebi]; e < exo->eb_ptr[ebi+1]; e++) {
+      for (i = exo->elem_node_pntr[e]; i < exo->elem_node_pntr[e+1]; i++) {
+	node = exo->elem_node_list[i];
+	for (j = exo->node_elem_pntr[node]; j < exo->node_elem_pntr[node+1]; j++) {
+	  nbr = exo->node_elem_list[j];
+	  if (color[nbr] >= 0) mark[color[nbr]] = e;
+	}
+      }
+      for (c = 0; mark[c] == e; c++);
+      color[e] = c;
+      if (c + 1 > Num_Elem_Colors) Num_Elem_Colors = c + 1;
+    }
+  }
+
+  /*
+   * Bucket sort the colored elements.
+   */
+  count = alloc_int_1(Num_Elem_Colors + 1, 0);
+  Elem_Color_Ptr = alloc_int_1(Num_Elem_Colors + 1, 0);
+  for (e = e_start; e < e_end; e++) {
+    if (color[e] >= 0) Elem_Color_Ptr[color[e]+1]++;
+  }
+  for (c = 0; c < Num_Elem_Colors; c++) {
+    Elem_Color_Ptr[c+1] += Elem_Color_Ptr[c];
+  }
+  n = Elem_Color_Ptr[Num_Elem_Colors];
+  Elem_Color_List = alloc_int_1(MAX(n, 1), -1);
+  for (e = e_start; e < e_end; e++) {
+    c = color[e];
+    if (c >= 0) Elem_Color_List[Elem_Color_Ptr[c] + count[c]++] = e;
+  }
+
+  safer_free((void **) &count);
+  safer_free((void **) &mark);
+  safer_free((void **) &color);
+
+  return Num_Elem_Colors;
+}
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
+void
+elem_color_free(void)
+{
+  safer_free((void **) &Elem_Color_Ptr);
+  safer_free((void **) &Elem_Color_List);
+  Num_Elem_Colors = 0;
+}
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
+#ifdef _OPENMP
+static void
+assembly_thread_copy_mp(MATRL_PROP_STRUCT **mp_master)
+
+    /*************************************************************************
+     *
+     * assembly_thread_copy_mp():
+     *
+     *  Copy the master's material property structures over this thread's
+     *  private ones. The continuation, hunting and augmenting condition
+     *  updates, and the per-step property updates, only change the master
+     *  copies, so this is done by every non-master thread before each fill.
+     *************************************************************************/
+{
+  int mn;
+
+  for (mn = 0; mn < upd->Num_Mat; mn++) {
+    memcpy(mp_glob[mn], mp_master[mn], sizeof(MATRL_PROP_STRUCT));
+  }
+  mp = mp_glob[0];
+}
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
+static void
+assembly_thread_alloc(Exo_DB *exo,
+		      MATRL_PROP_STRUCT **mp_master,
+		      const int max_dof)
+
+    /*************************************************************************
+     *
+     * assembly_thread_alloc():
+     *
+     *  Called once by every non-master thread to build its private copies
+     *  of the threadprivate assembly pointers. The material property
+     *  structures are shallow copies; tables and model parameter arrays
+     *  hanging off of them stay shared and are only read during assembly.
+     *************************************************************************/
+{
+  int mn, err;
+
+  mp_glob = (MATRL_PROP_STRUCT **) alloc_ptr_1(MAX_NUMBER_MATLS);
+  for (mn = 0; mn < upd->Num_Mat; mn++) {
+    mp_glob[mn] = (MATRL_PROP_STRUCT *) smalloc(sizeof(MATRL_PROP_STRUCT));
+  }
+  assembly_thread_copy_mp(mp_master);
+
+  ve = (struct Viscoelastic_Constitutive **)
+      smalloc(MAX_MODES*sizeof(struct Viscoelastic_Constitutive *));
+
+  err = assembly_alloc(exo);
+  EH(err, "Problem from assembly_alloc on assembly thread");
+
+  /* sized like the master copy in setup_problem() */
+  lec->max_dof = max_dof;
+  lec->R = (dbl*)smalloc(MAX_LOCAL_VAR_DESC*max_dof*sizeof(dbl));
+  lec->J = (dbl*)smalloc(MAX_LOCAL_VAR_DESC*MAX_LOCAL_VAR_DESC*max_dof*max_dof*sizeof(dbl));
+  lec->J_stress_neighbor = (dbl*)smalloc(4*max_dof*MAX_LOCAL_VAR_DESC*max_dof*sizeof(dbl));
+  lec->dirichlet_row = alloc_int_1(MAX_LOCAL_VAR_DESC*max_dof, 0);
+  lec->num_dirichlet_rows = 0;
+
+  err = bf_init(exo);
+  EH(err, "Problem from bf_init on assembly thread");
+}
+#endif
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
+void
+assembly_threads_setup(const int mpi_threads_ok)
+
+    /*************************************************************************
+     *
+     * assembly_threads_setup():
+     *
+     *  Settle the thread count on each rank once the input has landed.
+     *  "auto" (Num_Assembly_Threads == 0) takes OMP_NUM_THREADS when it is
+     *  set, else shares the processors of the node evenly among the ranks
+     *  running on it, so that a few ranks per node with threads neither
+     *  oversubscribe nor idle cores. Threads need MPI to allow at least
+     *  MPI_THREAD_FUNNELED (mpi_threads_ok).
+     *************************************************************************/
+{
+  int ranks_on_node = 1;
+
+#if defined(PARALLEL) && defined(MPI_VERSION) && MPI_VERSION >= 3
+  MPI_Comm node_comm;
+  MPI_Comm_split_type(MPI_COMM_WORLD, MPI_COMM_TYPE_SHARED, ProcID,
+		      MPI_INFO_NULL, &node_comm);
+  MPI_Comm_size(node_comm, &ranks_on_node);
+  MPI_Comm_free(&node_comm);
+#endif
+
+  if (Num_Assembly_Threads == 0) {
+#ifdef _OPENMP
+    if (getenv("OMP_NUM_THREADS") != NULL) {
+      Num_Assembly_Threads = omp_get_max_threads();
+    } else {
+      Num_Assembly_Threads = MAX(1, omp_get_num_procs() / ranks_on_node);
+    }
+#else
+    Num_Assembly_Threads = 1;
+#endif
+  }
+
+  if (Num_Assembly_Threads > 1 && !mpi_threads_ok) {
+    WH(-1, "MPI does not support MPI_THREAD_FUNNELED, using 1 assembly thread");
+    Num_Assembly_Threads = 1;
+  }
+
+  if (Num_Proc > 1) {
+    DPRINTF(stderr, "Hybrid layout: %d ranks on the node of P_0, %d assembly threads per rank\n",
+	    ranks_on_node, Num_Assembly_Threads);
+  }
+
+  /*
+   * The large arrays are first touched in blocks by thread (alloc_dbl_1_ft),
+   * which only keeps them local if the threads do not migrate.
+   */
+#if defined(_OPENMP) && _OPENMP >= 201307
+  if (Num_Assembly_Threads > 1 && omp_get_proc_bind() == omp_proc_bind_false) {
+    WH(-1, "Assembly threads are not pinned; set OMP_PROC_BIND=close and OMP_PLACES=cores to keep their memory local");
+  }
+#endif
+}
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
+int
+assembly_threads_active(Exo_DB *exo)
+
+    /*************************************************************************
+     *
+     * assembly_threads_active():
+     *
+     *  Decide, once, whether matrix_fill_full() should use the colored
+     *  threaded element loop. The first call that answers yes also builds
+     *  the element coloring and the per-thread scratch structures.
+     *************************************************************************/
+{
+#ifdef _OPENMP
+  static int active = -1;
+  MATRL_PROP_STRUCT **mp_master;
+  int max_dof, i;
+
+  if (active >= 0) return active;
+
+  active = FALSE;
+  if (Num_Assembly_Threads <= 1) return active;
+
+  /* Element Numerical Jacobian toggles the shared af flags per element */
+  if (Linear_Solver == FRONT || ls != NULL || pfd != NULL ||
+      xfem != NULL || num_shell_blocks > 0 || Elem_FD_Jacobian) {
+    DPRINTF(stderr, "Assembly Threads = %d ignored, this problem needs the serial element loop\n",
+	    Num_Assembly_Threads);
+    return active;
+  }
+
+  /*
+   * The contact angle bookkeeping in matrix_fill() pairs the free and solid
+   * surface elements of a contact line through shared tables, in element
+   * order.
+   */
+  for (i = 0; i < Num_BC; i++) {
+    switch (BC_Types[i].BC_Name) {
+    case CA_BC:
+    case CA_MOMENTUM_BC:
+    case CA_OR_FIX_BC:
+    case MOVING_CA_BC:
+    case VELO_THETA_HOFFMAN_BC:
+    case VELO_THETA_TPL_BC:
+    case VELO_THETA_COX_BC:
+    case VELO_THETA_SHIK_BC:
+      DPRINTF(stderr, "Assembly Threads = %d ignored, contact angle conditions need the serial element loop\n",
+	      Num_Assembly_Threads);
+      return active;
+    default:
+      break;
+    }
+  }
+
+  omp_set_dynamic(0);
+  omp_set_num_threads(Num_Assembly_Threads);
+
+  elem_color_setup(exo);
+
+  /*
+   * threadprivate pointers are fetched through the master copy before
+   * entering the parallel region.
+   */
+  mp_master = mp_glob;
+  max_dof = lec->max_dof;
+
+#pragma omp parallel
+  {
+    if (omp_get_thread_num() != 0) {
+      /* assembly_alloc() also touches some shared bookkeeping */
+#pragma omp critical (assembly_thread_alloc)
+      assembly_thread_alloc(exo, mp_master, max_dof);
+    }
+  }
+
+  DPRINTF(stderr, "Threaded assembly: %d threads, %d element colors\n",
+	  Num_Assembly_Threads, Num_Elem_Colors);
+
+  active = TRUE;
+  return active;
+#else
+  static int warned = FALSE;
+  if (Num_Assembly_Threads > 1 && !warned) {
+    WH(-1, "Assembly Threads > 1 needs goma built with OpenMP, using 1 thread");
+    warned = TRUE;
+  }
+  return FALSE;
+#endif
+}
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
+void
+assembly_threads_refresh(void)
+
+    /*************************************************************************
+     *
+     * assembly_threads_refresh():
+     *
+     *  Bring the private material property copies of all the assembly
+     *  threads up to date with the master's. Called before every threaded
+     *  element loop; a no-op until assembly_threads_active() said yes.
+     *************************************************************************/
+{
+#ifdef _OPENMP
+  MATRL_PROP_STRUCT **mp_master;
+
+  if (Num_Elem_Colors == 0) return;
+
+  mp_master = mp_glob;
+#pragma omp parallel
+  {
+    if (omp_get_thread_num() != 0) assembly_thread_copy_mp(mp_master);
+  }
+#endif
+}
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
+int
+matrix_fill_threaded(struct Aztec_Linear_Solver_System *ams,
+		     double x[],
+		     double resid_vector[],
+		     double x_old[],
+		     double x_older[],
+		     double xdot[],
+		     double xdot_old[],
+		     double x_update[],
+		     double *ptr_delta_t,
+		     double *ptr_theta,
+		     struct elem_side_bc_struct *first_elem_side_BC_array[],
+		     double *ptr_time_value,
+		     Exo_DB *exo,
+		     Dpi *dpi,
+		     int *ptr_num_total_nodes,
+		     dbl *ptr_h_elem_avg,
+		     dbl *ptr_U_norm,
+		     dbl *estifm)
+
+    /*************************************************************************
+     *
+     * matrix_fill_threaded():
+     *
+     *  Colored element loop used by matrix_fill_full(). The worker copies
+     *  of the material properties are refreshed first. exo->eb_ptr[0],
+     *  on which matrix_fill() does its once-per-fill initialization, is
+     *  assembled by the master thread on its own; being the lowest
+     *  numbered element it is always the first one of color 0 when it
+     *  is active. The remaining elements of every color are shared out
+     *  amongst the threads, with a barrier between colors.
+     *
+     *  Return: the number of elements whose matrix_fill() failed.
+     *************************************************************************/
+{
+  int c, k, k_start;
+  int err = 0;
+  static char yo[] = "matrix_fill_threaded";
+
+  if (Num_Elem_Colors == 0) return 0;
+
+  assembly_threads_refresh();
+
+  k_start = Elem_Color_Ptr[0];
+  if (Elem_Color_List[k_start] == exo->eb_ptr[0]) {
+    int ielem = exo->eb_ptr[0];
+    dbl t_elem = (Elem_Cost != NULL) ? elem_cost_clock() : 0.0;
+    /* needed for saturation hyst. func. */
+    PRS_mat_ielem = 0;
+    err = matrix_fill(ams, x, resid_vector, x_old, x_older, xdot, xdot_old,
+		      x_update, ptr_delta_t, ptr_theta, first_elem_side_BC_array,
+		      ptr_time_value, exo, dpi, &ielem, ptr_num_total_nodes,
+		      ptr_h_elem_avg, ptr_U_norm, estifm, 0);
+    if (Elem_Cost != NULL) Elem_Cost[ielem] += elem_cost_clock() - t_elem;
+    if (err) return 1;
+    k_start++;
+  }
+
+  for (c = 0; c < Num_Elem_Colors; c++) {
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 16) reduction(+:err)
+#endif
+    for (k = k_start; k < Elem_Color_Ptr[c+1]; k++) {
+      int ielem = Elem_Color_List[k];
+      dbl t_elem;
+      if (neg_elem_volume || neg_lub_height || zero_detJ) continue;
+      PRS_mat_ielem = ielem - exo->eb_ptr[find_elemblock_index(ielem, exo)];
+      t_elem = (Elem_Cost != NULL) ? elem_cost_clock() : 0.0;
+      if (matrix_fill(ams, x, resid_vector, x_old, x_older, xdot, xdot_old,
+		      x_update, ptr_delta_t, ptr_theta, first_elem_side_BC_array,
+		      ptr_time_value, exo, dpi, &ielem, ptr_num_total_nodes,
+		      ptr_h_elem_avg, ptr_U_norm, estifm, 0)) {
+	err++;
+      }
+      if (Elem_Cost != NULL) Elem_Cost[ielem] += elem_cost_clock() - t_elem;
+      if (neg_elem_volume) {
+	log_msg("Negative elem det J in element (%d)", ielem+1);
+      }
+      if (neg_lub_height) {
+	log_msg("Negative lubrication height in element (%d)", ielem+1);
+      }
+      if (zero_detJ) {
+	log_msg("Zero determinant of Jacobian of transformation (%d)", ielem+1);
+      }
+    }
+
+    if (err || neg_elem_volume || neg_lub_height || zero_detJ) break;
+    k_start = Elem_Color_Ptr[c+1];
+  }
+
+  return err;
+}
+/*****************************************************************************/
+/* END of file mm_fill_thread.c */
+/*****************************************************************************/
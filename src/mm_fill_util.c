@@ -111,6 +111,74 @@ PROTO ((   int *[],
 	   int  ,
 	   Exo_DB * ));
 
+static struct Geom_Cache_Point *
+geom_cache_find
+PROTO(( struct Basis_Functions *, /* MapBf - mapping basis function          */
+	struct Basis_Functions *, /* ShapeBf - basis function used for J     */
+	int * ));		/* found - (out) TRUE if the point is stored */
+
+static void
+geom_cache_unfind
+PROTO(( void ));
+
+static struct Basis_Function_Cache_Entry *
+bf_cache_lookup
+PROTO(( BASIS_FUNCTIONS_STRUCT *, /* bf_ptr - basis function of interest     */
+	const double [],	/* xi - reference coordinates                */
+	const int,		/* v - representative variable               */
+	const int,		/* dim - number of coordinates that matter   */
+	int * ));		/* hash - (out) slot to store a new entry at */
+
+static void
+bf_cache_store
+PROTO(( BASIS_FUNCTIONS_STRUCT *, /* bf_ptr - basis function of interest     */
+	const double [],	/* xi - reference coordinates                */
+	const int,		/* v - representative variable               */
+	const int,		/* dim - number of coordinates that matter   */
+	const int ));		/* hash - slot from bf_cache_lookup()        */
+
+static void
+triquad_hex_tensor
+PROTO(( const double [],	/* xi - reference coordinates                */
+	const int,		/* inode - node of the TRIQUAD_HEX           */
+	double *,		/* phi - (out) basis function                */
+	double [DIM] ));	/* dphidxi - (out) its reference derivatives */
+
+/*
+ * Geometry cache for elements whose mesh does not deform (see
+ * "Geometry Cache Memory"). For each element, the mapping Jacobian, its
+ * inverse and determinant, and the physical coordinates computed by
+ * beer_belly() are kept for every reference point at which the element has
+ * been integrated. Points are identified by the xi that the basis
+ * functions were last loaded at. They are usually revisited in the same
+ * order, so the point just past the previous hit is tried first; otherwise
+ * the exact bits of xi are hashed into the element's slot table, as in
+ * bf_cache_lookup(), so neither hits nor misses scan the element's points.
+ */
+struct Geom_Cache_Point
+{
+  dbl xi[DIM];
+  dbl J[DIM][DIM];
+  dbl B[DIM][DIM];
+  dbl detJ;
+  dbl x[DIM];
+};
+
+struct Geom_Cache_Elem
+{
+  int num_pts;			/* points stored */
+  int size;			/* points allocated, a power of 2 */
+  int next;			/* the point to try first */
+  int last_slot;		/* slot of the last point added */
+  struct Geom_Cache_Point *pt;
+  int *slot;			/* [2*size] hash on xi -> point, -1 if empty */
+};
+
+static struct Geom_Cache_Elem *Geom_Cache = NULL;
+static int Geom_Cache_Num_Elems = 0;
+static double Geom_Cache_Bytes = 0.0;	/* memory held by all the points */
+static int Geom_Cache_Full = FALSE;	/* budget reached, stop adding */
+
 /*****************************************************************************/
 /*****************************************************************************/
 /*****************************************************************************/
@@ -149,12 +217,17 @@ int
 beer_belly(void)
 {
   int status = 0, i, j, k, n, t, dim, pdim, mdof, index, node, si;
-  int DeformingMesh, ShapeVar;
+  int DeformingMesh, MeshDerivs, ShapeVar;
   struct Basis_Functions *MapBf;
+  struct Geom_Cache_Point *gp = NULL;
+  int found;
   size_t v_length;
   dbl f, g, sum;
   static int is_initialized = FALSE;
   static int elem_blk_id_save = -123;
+#ifdef _OPENMP
+#pragma omp threadprivate(is_initialized, elem_blk_id_save)
+#endif
   
   dim = ei->ielem_dim;
   pdim = pd->Num_Dim;
@@ -171,6 +244,12 @@ beer_belly(void)
    */
   DeformingMesh = ei->deforming_mesh;
 
+  /*
+   * The mesh derivatives of J, B and detJ only feed Jacobian entries, so
+   * residual-only assemblies skip them.
+   */
+  MeshDerivs = DeformingMesh && af->Assemble_Jacobian;
+
   if (( si = in_list(pd->IntegrationMap, 0, Num_Interpolations, 
 		     Unique_Interpolations)) == -1)
     {
@@ -211,6 +290,31 @@ beer_belly(void)
     is_initialized = TRUE;
     elem_blk_id_save = ei->elem_blk_id;
   }
+
+  /*
+   * Fixed geometry: reuse what was computed at this point before. For
+   * shells the stored J carries the fake last row put in below, which is
+   * what every basis function ends up with, so they are cached as well.
+   */
+  if (Geom_Cache != NULL && !DeformingMesh &&
+      mp->ehl_integration_kind != SIK_S)
+    {
+      gp = geom_cache_find(MapBf, bf[ShapeVar], &found);
+      if (found)
+	{
+	  for (t = 0; t < Num_Basis_Functions; t++)
+	    {
+	      bfd[t]->detJ = gp->detJ;
+	      memcpy(&(bfd[t]->J[0][0]), &(gp->J[0][0]), DIM*DIM*sizeof(double));
+	      memcpy(&(bfd[t]->B[0][0]), &(gp->B[0][0]), DIM*DIM*sizeof(double));
+	    }
+	  for (i = 0; i < VIM; i++)
+	    {
+	      fv->x[i] = fv_old->x[i] = (i < DIM) ? gp->x[i] : 0.0;
+	    }
+	  return(status);
+	}
+    }
 	  
   /* 
    * For convenience, while we are here, interpolate to find physical space 
@@ -376,6 +480,7 @@ beer_belly(void)
 #else
          fprintf(stderr,"\n Uh-oh, detJ =  %e\n",fabs(MapBf->detJ));
 #endif
+         if (gp != NULL) geom_cache_unfind();
          return(2);
         }
 
@@ -409,7 +514,7 @@ beer_belly(void)
 	}
       MapBf->detJ = sqrt(sum);
 
-      if (DeformingMesh)
+      if (MeshDerivs)
 	{
 	  for (j = 0; j < pdim; j++)
 	    {
@@ -445,7 +550,7 @@ beer_belly(void)
        * to each degree of freedom for mesh displacement components.
        */
 	      
-      if (DeformingMesh)
+      if (MeshDerivs)
 	{
 	  for (i = 0; i < dim; i++)
 	    {
@@ -556,7 +661,7 @@ beer_belly(void)
 			 -MapBf->J[1][0] * MapBf->J[0][1])
 	/(MapBf->detJ);
 
-      if ( DeformingMesh )
+      if ( MeshDerivs )
 	{
 	  /*
 	   * Derivatives of elemental Jacobian matrix with respect
@@ -717,7 +822,7 @@ beer_belly(void)
 		{
 		  bfd[t]->B[i][j]=  MapBf->B[i][j];
 
-		  if (DeformingMesh)
+		  if (MeshDerivs)
 		    {
 		      for (k = 0; k < pdim; k++)
 			{
@@ -735,10 +840,191 @@ beer_belly(void)
 	}
     }
 
+  if (gp != NULL)
+    {
+      gp->detJ = MapBf->detJ;
+      memcpy(&(gp->J[0][0]), &(MapBf->J[0][0]), DIM*DIM*sizeof(double));
+      memcpy(&(gp->B[0][0]), &(MapBf->B[0][0]), DIM*DIM*sizeof(double));
+      for (i = 0; i < DIM; i++) gp->x[i] = fv->x[i];
+    }
+
 
   return(status);
 }     
 /*****************************************************************************/
+
+void
+geom_cache_init(Exo_DB *exo)
+
+     /************************************************************************
+      *
+      * geom_cache_init():
+      *
+      *    Set up the (empty) per-element geometry cache used by beer_belly()
+      * for elements without mesh motion, unless Geometry Cache Memory is
+      * zero. Must be called before any parallel element loop.
+      *
+      ************************************************************************/
+{
+  if (Geom_Cache != NULL || Geom_Cache_Memory <= 0) return;
+  Geom_Cache_Num_Elems = exo->num_elems;
+  Geom_Cache = alloc_struct_1(struct Geom_Cache_Elem,
+			      MAX(Geom_Cache_Num_Elems, 1));
+  Geom_Cache_Bytes = (double) (MAX(Geom_Cache_Num_Elems, 1)
+			       * sizeof(struct Geom_Cache_Elem));
+}
+/*****************************************************************************/
+
+void
+geom_cache_invalidate(const Exo_DB *exo,
+		      const int moved[])
+
+     /************************************************************************
+      *
+      * geom_cache_invalidate():
+      *
+      *    Forget the cached geometry of every element with a node whose
+      * coordinates moved[] flags, or of all of them when moved is NULL,
+      * e.g. after the mesh has been annealed in memory. The points stay
+      * allocated and are refilled on the next assembly.
+      *
+      ************************************************************************/
+{
+  int e, n;
+
+  if (Geom_Cache == NULL) return;
+  for (e = 0; e < Geom_Cache_Num_Elems; e++)
+    {
+      if (moved != NULL)
+	{
+	  for (n = exo->elem_node_pntr[e];
+	       n < exo->elem_node_pntr[e+1] && !moved[exo->elem_node_list[n]];
+	       n++);
+	  if (n == exo->elem_node_pntr[e+1]) continue;
+	}
+      Geom_Cache[e].num_pts = 0;
+      Geom_Cache[e].next = 0;
+      for (n = 0; n < 2*Geom_Cache[e].size; n++) Geom_Cache[e].slot[n] = -1;
+    }
+}
+/*****************************************************************************/
+
+static struct Geom_Cache_Point *
+geom_cache_find(struct Basis_Functions *MapBf,
+		struct Basis_Functions *ShapeBf,
+		int *found)
+
+     /************************************************************************
+      *
+      * geom_cache_find():
+      *
+      *    Look up the geometry of the current element at the current
+      * reference point. On a hit, *found is TRUE. On a miss, a new point is
+      * returned for beer_belly() to fill in, or NULL if the memory budget
+      * is used up.
+      *
+      ************************************************************************/
+{
+  struct Geom_Cache_Elem *ge;
+  struct Geom_Cache_Point *gp;
+  unsigned long h = 2166136261UL;
+  unsigned char *byte;
+  int a, k, s, need, mask;
+  size_t grow;
+
+  *found = FALSE;
+  if (ei->ielem < 0 || ei->ielem >= Geom_Cache_Num_Elems) return NULL;
+  for (a = 0; a < DIM; a++) {
+    if (MapBf->xi[a] != ShapeBf->xi[a]) return NULL;
+  }
+
+  ge = Geom_Cache + ei->ielem;
+  if (ge->next < ge->num_pts) {
+    gp = ge->pt + ge->next;
+    for (a = 0; a < DIM && gp->xi[a] == ShapeBf->xi[a]; a++);
+    if (a == DIM) {
+      ge->next = (ge->next + 1) % ge->num_pts;
+      *found = TRUE;
+      return gp;
+    }
+  }
+
+  byte = (unsigned char *) ShapeBf->xi;
+  for (k = 0; k < DIM*(int)sizeof(dbl); k++) {
+    h = (h ^ byte[k]) * 16777619UL;
+  }
+
+  mask = 2*ge->size - 1;
+  s = -1;
+  if (ge->size > 0) {
+    for (s = (int)(h & mask); ge->slot[s] != -1; s = (s + 1) & mask) {
+      gp = ge->pt + ge->slot[s];
+      for (a = 0; a < DIM && gp->xi[a] == ShapeBf->xi[a]; a++);
+      if (a == DIM) {
+	ge->next = (ge->slot[s] + 1) % ge->num_pts;
+	*found = TRUE;
+	return gp;
+      }
+    }
+  }
+
+  if (ge->num_pts == ge->size) {
+    need = MAX(2*ge->size, 8);
+    grow = (need - ge->size)*(sizeof(struct Geom_Cache_Point) + 2*sizeof(int));
+    if (Geom_Cache_Full ||
+	Geom_Cache_Bytes + grow > Geom_Cache_Memory*1048576.0) {
+      Geom_Cache_Full = TRUE;
+      return NULL;
+    }
+#ifdef _OPENMP
+#pragma omp atomic
+#endif
+    Geom_Cache_Bytes += grow;
+    ge->pt = (struct Geom_Cache_Point *)
+	realloc(ge->pt, need*sizeof(struct Geom_Cache_Point));
+    ge->slot = (int *) realloc(ge->slot, 2*need*sizeof(int));
+    if (ge->pt == NULL || ge->slot == NULL) EH(-1, "Out of memory for geometry cache");
+    ge->size = need;
+
+    /* rehash what is there into the bigger table */
+    mask = 2*need - 1;
+    for (s = 0; s < 2*need; s++) ge->slot[s] = -1;
+    for (k = 0; k < ge->num_pts; k++) {
+      unsigned long hk = 2166136261UL;
+      byte = (unsigned char *) ge->pt[k].xi;
+      for (a = 0; a < DIM*(int)sizeof(dbl); a++) {
+	hk = (hk ^ byte[a]) * 16777619UL;
+      }
+      for (s = (int)(hk & mask); ge->slot[s] != -1; s = (s + 1) & mask);
+      ge->slot[s] = k;
+    }
+    for (s = (int)(h & mask); ge->slot[s] != -1; s = (s + 1) & mask);
+  }
+
+  ge->slot[s] = ge->num_pts;
+  ge->last_slot = s;
+  gp = ge->pt + ge->num_pts++;
+  for (a = 0; a < DIM; a++) gp->xi[a] = ShapeBf->xi[a];
+  ge->next = ge->num_pts % ge->size;
+  return gp;
+}
+
+static void
+geom_cache_unfind(void)
+
+     /*
+      * Take back the point the last geom_cache_find() miss handed out,
+      * when beer_belly() gives up before filling it in.
+      */
+{
+  struct Geom_Cache_Elem *ge = Geom_Cache + ei->ielem;
+
+  /* nothing was added after it, so no probe runs through its slot */
+  ge->slot[ge->last_slot] = -1;
+  ge->num_pts--;
+  ge->next = 0;
+}
+/*****************************************************************************/
 /*****************************************************************************/
 /*****************************************************************************/
 
@@ -2805,10 +3091,11 @@ load_basis_functions(const double xi[],             /*  [DIM]               */
       *
       ************************************************************************/
 {
-  int b, i, v, jdof, ledof;
+  int b, i, v, jdof, ledof, hash;
   int mn = ei->mn;
 
   BASIS_FUNCTIONS_STRUCT *bf_ptr;
+  struct Basis_Function_Cache_Entry *entry;
   /*
    * Load basis functions and derivatives in the unit elements for each
    * kind of unique basis function that we have...
@@ -2829,6 +3116,22 @@ load_basis_functions(const double xi[],             /*  [DIM]               */
      *  OR if element shape doesn't match the current element block.
      */
     if (v != -1 && bf_ptr->element_shape == ei->ielem_shape) {
+      /*
+       * The reference values only depend on the point, the element type
+       * and the local dof layout, so most calls can copy them out of the
+       * table built up by earlier elements.
+       */
+      for (i = 0; i < DIM; i++) {
+	bf_ptr->xi[i] = (i < pd->Num_Dim) ? xi[i] : 0.0;
+      }
+
+      entry = bf_cache_lookup(bf_ptr, xi, v, pd->Num_Dim, &hash);
+      if (entry != NULL) {
+	memcpy(bf_ptr->phi, entry->phi, entry->ndof*sizeof(dbl));
+	memcpy(bf_ptr->dphidxi, entry->dphidxi, entry->ndof*sizeof(dbl)*DIM);
+	continue;
+      }
+
       /*
        * Now, case the dimensionality and look up basis functions
        * and their derivatives at the quadrature point
@@ -2879,7 +3182,14 @@ load_basis_functions(const double xi[],             /*  [DIM]               */
       case 3:
 	for (i = 0; i < ei->dof[v]; i++) {
 	  ledof = ei->lvdof_to_ledof[v][i];
-	  if (ei->active_interp_ledof[ledof]) {
+	  if (ei->active_interp_ledof[ledof] &&
+	      bf_ptr->element_shape == HEXAHEDRON &&
+	      ei->ielem_type == TRIQUAD_HEX &&
+	      bf_ptr->interpolation == I_Q2) {
+	    triquad_hex_tensor(xi, ei->dof_list[v][i],
+			       &bf_ptr->phi[i], bf_ptr->dphidxi[i]);
+	    jdof++;
+	  } else if (ei->active_interp_ledof[ledof]) {
 	    bf_ptr->phi[i] =        newshape(xi, ei->ielem_type, PSI, 
 					     ei->dof_list[v][i], bf_ptr->element_shape,
 					     bf_ptr->interpolation, jdof); 	       
@@ -2902,11 +3212,176 @@ load_basis_functions(const double xi[],             /*  [DIM]               */
 	}
 	break;
       }
+
+      bf_cache_store(bf_ptr, xi, v, pd->Num_Dim, hash);
     }
   }
   return (0);
 } /* END of routine load_basis_functions */
 /******************************************************************************/
+
+/*
+ * 1-D quadratic factor of each TRIQUAD_HEX node in s, t and u:
+ * 0 for the node at -1, 1 for the node at +1 and 2 for the midpoint.
+ * This is the numbering shape() uses for the 27 node brick.
+ */
+static const int Triquad_Hex_Factor[27][3] = {
+  {0,0,0}, {1,0,0}, {1,1,0}, {0,1,0}, {0,0,1}, {1,0,1}, {1,1,1}, {0,1,1},
+  {2,0,0}, {1,2,0}, {2,1,0}, {0,2,0}, {0,0,2}, {1,0,2}, {1,1,2}, {0,1,2},
+  {2,0,1}, {1,2,1}, {2,1,1}, {0,2,1}, {2,2,2}, {2,2,0}, {2,2,1}, {0,2,2},
+  {1,2,2}, {2,0,2}, {2,1,2}
+};
+
+static void
+triquad_hex_tensor(const double xi[],
+		   const int inode,
+		   double *phi,
+		   double dphidxi[DIM])
+
+     /************************************************************************
+      *
+      * triquad_hex_tensor():
+      *
+      *    The triquadratic brick basis function of node inode and its
+      * reference derivatives as products of the 1-D quadratic Lagrange
+      * polynomials in s, t and u, rather than the expanded polynomials of
+      * shape(). The 1-D factors are the only thing that depends on xi, so
+      * they are remade only when xi changes from the previous call.
+      *
+      ************************************************************************/
+{
+  static double xi_last[DIM] = { 2.0, 2.0, 2.0 }; /* off the element */
+  static double L[DIM][3], dL[DIM][3];
+#ifdef _OPENMP
+#pragma omp threadprivate(xi_last, L, dL)
+#endif
+  const int *f = Triquad_Hex_Factor[inode];
+  int p;
+
+  if (xi[0] != xi_last[0] || xi[1] != xi_last[1] || xi[2] != xi_last[2]) {
+    for (p = 0; p < DIM; p++) {
+      xi_last[p] = xi[p];
+      L[p][0]  = 0.5 * xi[p] * (xi[p] - 1.0);
+      L[p][1]  = 0.5 * xi[p] * (xi[p] + 1.0);
+      L[p][2]  = 1.0 - xi[p] * xi[p];
+      dL[p][0] = xi[p] - 0.5;
+      dL[p][1] = xi[p] + 0.5;
+      dL[p][2] = -2.0 * xi[p];
+    }
+  }
+
+  *phi       =  L[0][f[0]] *  L[1][f[1]] *  L[2][f[2]];
+  dphidxi[0] = dL[0][f[0]] *  L[1][f[1]] *  L[2][f[2]];
+  dphidxi[1] =  L[0][f[0]] * dL[1][f[1]] *  L[2][f[2]];
+  dphidxi[2] =  L[0][f[0]] *  L[1][f[1]] * dL[2][f[2]];
+}
+/******************************************************************************/
+
+static struct Basis_Function_Cache_Entry *
+bf_cache_lookup(BASIS_FUNCTIONS_STRUCT *bf_ptr,
+		const double xi[],
+		const int v,
+		const int dim,
+		int *hash)
+
+     /************************************************************************
+      *
+      * bf_cache_lookup():
+      *
+      *    Find the tabulated phi and dphidxi of bf_ptr at xi for the current
+      * element type and dof layout, or return NULL. The cache is keyed on
+      * the exact bits of xi, which is safe because the quadrature routines
+      * always hand back the same reference points. On a miss, *hash is the
+      * empty slot that bf_cache_store() should use, or -1 if the point
+      * should not be tabulated.
+      *
+      ************************************************************************/
+{
+  struct Basis_Function_Cache *c;
+  struct Basis_Function_Cache_Entry *entry;
+  unsigned long h = 2166136261UL;
+  unsigned char *byte;
+  int a, i, k, s, ndof = ei->dof[v];
+
+  *hash = -1;
+  if (ndof > MDE) return NULL;
+
+  c = bf_ptr->cache;
+  if (c == NULL) {
+    c = bf_ptr->cache = alloc_struct_1(struct Basis_Function_Cache, 1);
+    for (s = 0; s < BF_CACHE_SLOTS; s++) c->slot[s] = -1;
+    c->entry = alloc_struct_1(struct Basis_Function_Cache_Entry, BF_CACHE_MAX);
+  }
+
+  byte = (unsigned char *) xi;
+  for (k = 0; k < dim*(int)sizeof(double); k++) {
+    h = (h ^ byte[k]) * 16777619UL;
+  }
+  h ^= (unsigned long) ei->ielem_type;
+
+  for (s = (int)(h & (BF_CACHE_SLOTS-1)); c->slot[s] != -1;
+       s = (s + 1) & (BF_CACHE_SLOTS-1)) {
+    entry = c->entry + c->slot[s];
+    if (entry->ielem_type != ei->ielem_type || entry->ndof != ndof) continue;
+    for (a = 0; a < dim && entry->xi[a] == xi[a]; a++);
+    if (a < dim) continue;
+    for (i = 0; i < ndof; i++) {
+      if (entry->node[i] != ei->dof_list[v][i] ||
+	  entry->active[i] != ei->active_interp_ledof[ei->lvdof_to_ledof[v][i]])
+	break;
+    }
+    if (i == ndof) return entry;
+  }
+
+  /*
+   * Once full (e.g., after point searches at arbitrary xi), start the
+   * table over so the quadrature points in use get tabulated again.
+   */
+  if (c->num_entries >= BF_CACHE_MAX) {
+    for (s = 0; s < BF_CACHE_SLOTS; s++) c->slot[s] = -1;
+    c->num_entries = 0;
+    s = (int)(h & (BF_CACHE_SLOTS-1));
+  }
+  *hash = s;
+  return NULL;
+}
+/******************************************************************************/
+
+static void
+bf_cache_store(BASIS_FUNCTIONS_STRUCT *bf_ptr,
+	       const double xi[],
+	       const int v,
+	       const int dim,
+	       const int hash)
+
+     /************************************************************************
+      *
+      * bf_cache_store():
+      *
+      *    Tabulate the phi and dphidxi just computed by load_basis_functions()
+      * in the slot found by bf_cache_lookup().
+      *
+      ************************************************************************/
+{
+  struct Basis_Function_Cache *c = bf_ptr->cache;
+  struct Basis_Function_Cache_Entry *entry;
+  int a, i, ndof = ei->dof[v];
+
+  if (hash < 0 || c == NULL) return;
+
+  c->slot[hash] = c->num_entries;
+  entry = c->entry + c->num_entries++;
+  entry->ielem_type = ei->ielem_type;
+  entry->ndof = ndof;
+  for (a = 0; a < DIM; a++) entry->xi[a] = (a < dim) ? xi[a] : 0.0;
+  for (i = 0; i < ndof; i++) {
+    entry->node[i] = ei->dof_list[v][i];
+    entry->active[i] = ei->active_interp_ledof[ei->lvdof_to_ledof[v][i]];
+  }
+  memcpy(entry->phi, bf_ptr->phi, ndof*sizeof(dbl));
+  memcpy(entry->dphidxi, bf_ptr->dphidxi, ndof*sizeof(dbl)*DIM);
+}
+/******************************************************************************/
 /******************************************************************************/
 /******************************************************************************/
 /* asdv() -- allocate, set a double vector
@@ -2924,16 +3399,7 @@ void
 asdv(double **v,		/* vector to be allocated */
      const int n)		/* number of elements in vector */
 {
-  int i;
-  double *p;
-  const double zero=(double)0;
-
-  *v = (double *) smalloc(n*sizeof(double));
-
-  for ( i=0, p=*v; i<n ; i++, p++)
-    {
-      *p = zero;
-    }
+  *v = alloc_dbl_1_ft(n, 0.0);	/* first touch in parallel blocks */
 }
 
 /*****************************************************************************/
@@ -3055,8 +3521,13 @@ alloc_MSR_sparse_arrays(int **ptr_ija,	/* column pointer array */
    */
   /* ija = (int *) array_alloc(1, nnz, sizeof(int)); */
 
-  ija = alloc_int_1(nnz, INT_NOINIT);
-  memcpy(ija, ija_temp, nnz*sizeof(int));
+  if (Fill) {
+    ija = alloc_int_1(nnz, INT_NOINIT);
+    memcpy(ija, ija_temp, nnz*sizeof(int));
+  } else {
+    ija = ija_temp;		/* already exactly nnz long */
+    ija_temp = NULL;
+  }
   
 #ifdef DEBUG_IJA
   /*
@@ -3078,27 +3549,24 @@ alloc_MSR_sparse_arrays(int **ptr_ija,	/* column pointer array */
   /* 
    * Allocate the nonzero storage vector and initialize it to zero
    */
-  a = alloc_dbl_1(nnz, 0.0);
+  a = alloc_dbl_1_ft(nnz, 0.0);
 
   /*   num_fill_unknowns  = dpi->num_universe_nodes; */
 
   num_total_unknowns = num_universe_dofs;
 
-  /* set boolean for save old A matrix for data sensitivities,
-     flux sensitivities, modified newton schemes, augmenting conditions,
-     and continuation */
-
-  save_old_A = FALSE;
-  if (modified_newton ||
-      nAC > 0         ||
-      nn_post_data_sens > 0 ||
-      nn_post_fluxes_sens > 0 ||
-      Continuation > 0) {
-    save_old_A = TRUE;
-  }
+  /*
+   * The backup copy of A is only ever read back by the modified Newton
+   * Jacobian reuse in solve_nonlinear_problem() and by the LOCA
+   * RECOVER_MATRIX fill.  Sensitivities, augmenting conditions and the
+   * other continuation methods never look at it, so they do not get a
+   * second matrix.
+   */
+
+  save_old_A = (modified_newton || Continuation == LOCA);
 
   if (save_old_A) {
-    a_old = alloc_dbl_1(nnz, 0.0);
+    a_old = alloc_dbl_1_ft(nnz, 0.0);
   } else {
     a_old = NULL;
   }
@@ -3192,19 +3660,9 @@ alloc_VBR_sparse_arrays (struct Aztec_Linear_Solver_System *ams ,
   ams->npu = ams->rpntr[row_nodes];
   ams->npu_plus = ams->cpntr[col_nodes];
 
-  /* set boolean for save old A matrix for data sensitivities,
-     flux sensitivities, modified newton schemes, augmenting conditions,
-     and continuation */
+  /* same rule as for MSR, see alloc_MSR_sparse_arrays() */
 
-  save_old_A = FALSE;
-  if (modified_newton ||
-      nAC > 0         ||
-      nn_post_data_sens > 0 ||
-      nn_post_fluxes_sens > 0 ||
-      Continuation > 0)
-    {
-      save_old_A = TRUE;
-    }
+  save_old_A = (modified_newton || Continuation == LOCA);
 
   if( save_old_A )
     {
@@ -3265,6 +3723,7 @@ find_problem_graph_fill(
    * Allocate arrays and initialize...
    * start allocating ija to a small estimate - reallocate later 
    */
+  need_node_node(exo);
   nz_temp = num_fill_unknowns*Max_NP_Elem;
   *ija = alloc_int_1(nz_temp, -1);
 #ifdef DEBUG
@@ -3379,232 +3838,343 @@ find_problem_graph_fill(
 /******************************************************************************/
 
 static int
-find_MSR_problem_graph(int *ija[],	   /* column pointer array            */
-		       int itotal_nodes,   /* number nodes this processor     */
-		       Exo_DB *exo)        /* ptr to FE db                    */
+graph_col_compare(const void *c1, const void *c2)
+{
+  return *((const int *) c1) - *((const int *) c2);
+}
 
+/*
+ * The columns of the row of unknown iunknown of node inode (the
+ * irow'th row), in cols[] when that is not NULL; returns how many.
+ * vt_ptr[] and vt[] hold the variable types of the unknowns of each
+ * node, as fill_variable_vector() lists them.
+ */
+
+static int
+graph_row_columns(Exo_DB *exo,
+		  const int inode,
+		  const int iunknown,
+		  const int irow,
+		  const int skip_diag,
+		  const int *vt_ptr,
+		  const int *vt,
+		  int *cols)
 {
-  int j, itmp, inode, i1, i2, eb1;
-  int iunknown, inter_unknown, inter_node, row_num_unknowns, col_num_unknowns;
-  int nz_ptr, irow_index = 0;
-  int icol_index, rowVarType, colVarType;
-  int *ija_ptr;
-  int  add_var=0, nz_temp;
-  NODE_INFO_STRUCT *nodeCol;
-  NODAL_VARS_STRUCT *nv, *nvCol;
-  double avgVarPerNode, avgNodeToNodeConn;
-
-  int *inode_varType, *inode_matID;
-  int *inter_node_varType, *inter_node_matID;
-#ifdef DEBUG_GRAPH
-  char *yo = "find_MSR_problem_graph: ";
-#endif
-#ifdef DEBUG_GRAPH
-  FILE *ifp = NULL;
-  ifp = fopen("msr_format.txt", "w");
-#endif /* DEBUG_GRAPH */
-  
-  /*
-   * Calculate the average number of degrees of freedom per node
-   */
-  avgVarPerNode =(double) num_universe_dofs / (double) itotal_nodes;
-  /*
-   * Estimate the average connectivity of a node
-   */
-  avgNodeToNodeConn = (double) exo->node_node_pntr[itotal_nodes] /
-    (double) itotal_nodes;
+  int j, inter_node, inter_unknown, col_num_unknowns;
+  int icol_index, rowVarType, colVarType, add_var, eb1, i1, i2;
+  int n = 0, num_links, end;
+  const int *links = NULL;
+
+  rowVarType = vt[vt_ptr[inode] + iunknown];
+
   /*
-   *  Start allocating ija to a slightly larger value than
-   *  needed by a good estimate.
-   *  -> Check for null pointer because this is a large 
-   *     allocation
+   * Loop over the nodes which are determined to have an interaction
+   * with the current row node, element neighbors first and then the
+   * ones periodic links add
    */
-  nz_temp = num_universe_dofs * avgNodeToNodeConn * 
-    avgVarPerNode * 1.1;
+  num_links = periodic_graph_links(inode, &links);
+  end = exo->node_node_pntr[inode+1];
+  for (j = exo->node_node_pntr[inode]; j < end + num_links; j++) {
+    inter_node = (j < end) ? exo->node_node_list[j] : links[j - end];
+    col_num_unknowns = vt_ptr[inter_node+1] - vt_ptr[inter_node];
 
+    for (inter_unknown = 0; inter_unknown < col_num_unknowns;
+	 inter_unknown++) {
+      colVarType = vt[vt_ptr[inter_node] + inter_unknown];
+
+      /*
+       * Query the Interaction mask to determine if a jacobian entry
+       * should be created
+       */
+      add_var = Inter_Mask[rowVarType][colVarType];
+
+      /* The following code should be activated when solving DG viscoelastic problems
+       * with full Jacobian treatment of upwind element stress terms
+       */
+      if ( exo->centroid_list[ inode ] != -1 &&
+	   inode != inter_node &&
+	   exo->centroid_list[inter_node] != -1)
+	{
+	  eb1 = exo->elem_eb[ exo->centroid_list[ inode ] ] ;
 
-  *ija = ija_ptr = alloc_int_1(nz_temp, -1);
-  if (*ija == NULL) {
-    EH(-1, "No space for ija_temp");
+	  if (vn_glob[ Matilda[eb1] ]->dg_J_model == FULL_DG) {
+	    i1 = pd_glob[ Matilda[eb1] ]->i[rowVarType];
+	    i2 = pd_glob[ Matilda[eb1] ]->i[colVarType];
+
+	    if ((rowVarType == colVarType) &&
+		(i1 == I_P0 || i1 == I_P1 || i1 == I_PQ1 || i1 == I_PQ2) &&
+		(i2 == I_P0 || i2 == I_P1 || i2 == I_PQ1 || i2 == I_PQ2) &&
+		(rowVarType != PRESSURE) &&
+		(rowVarType > VELOCITY_GRADIENT33 || rowVarType < VELOCITY_GRADIENT11))
+	      {
+		add_var = Inter_Mask[rowVarType][colVarType];
+	      } else {
+		add_var = 0;
+	      }
+	  }
+	}
+
+      if (Debug_Flag < 0) add_var = TRUE;  /* add all vars for checking jacobian */
+
+      if (add_var) {
+	icol_index = Nodes[inter_node]->First_Unknown + inter_unknown;
+	if (skip_diag && icol_index == irow) continue;
+	if (cols != NULL) cols[n] = icol_index;
+	n++;
+      }
+    }
   }
+  return n;
+}
+
+int *
+problem_graph_build(Exo_DB *exo,
+		    const int num_nodes,
+		    const int skip_diag,
+		    int *len)
+
+    /*************************************************************************
+     *
+     * problem_graph_build():
+     *
+     *  The nonzero pattern of the unknowns of nodes [0,num_nodes), in the
+     *  layout of MSR's bindx: for the n rows, g[0..n] are where the
+     *  columns of each row start (g[0] = n+1) and the columns follow,
+     *  sorted in each row. With skip_diag the diagonal is left out, as
+     *  MSR keeps it apart.
+     *
+     *  The rows are counted first, then filled into the exactly sized
+     *  array; both passes run over the nodes in parallel with
+     *  Num_Assembly_Threads OpenMP threads.
+     *
+     *  Return: g, *len of them, from alloc_int_1()
+     *************************************************************************/
+{
+  int inode, iunknown, i, n, row, *vt_ptr, *vt, *row0, *cnt, *g;
+#ifdef _OPENMP
+  int num_threads = MAX(Num_Assembly_Threads, 1);
+#endif
+  int *inode_matID;
 
-  inode_varType      = alloc_int_1(MaxVarPerNode, INT_NOINIT);
-  inode_matID        = alloc_int_1(MaxVarPerNode, INT_NOINIT);
-  inter_node_varType = alloc_int_1(MaxVarPerNode, INT_NOINIT);
-  inter_node_matID   = alloc_int_1(MaxVarPerNode, INT_NOINIT);
+  need_node_node(exo);
 
   /*
-   * Initialize the pointer into the jacobian, nz_ptr, 
-   * corresponding to the
-   * start of off-diagonal entries for a particular row.
-   * Row zero will have its first entry at position  
-   * num_universe_dofs + 1, because the diagonal is storred first
-   * and then the total number of entries is storred at
-   * ija[num_universe_dofs].
+   * The variable types of the unknowns of each node, listed once
+   * instead of for each neighbor.
    */
-  nz_ptr = num_universe_dofs + 1;
-#ifdef DEBUG_GRAPH
-  fprintf(ifp, "P_%d: nz_ptr = %d\n", ProcID, nz_ptr);
-#endif  
+  vt_ptr = alloc_int_1(num_nodes + 1, 0);
+  row0 = alloc_int_1(num_nodes + 1, 0);
+  for (inode = 0; inode < num_nodes; inode++) {
+    vt_ptr[inode+1] = vt_ptr[inode] + Nodes[inode]->Nodal_Vars_Info->Num_Unknowns;
+  }
+  vt = alloc_int_1(MAX(vt_ptr[num_nodes], 1), INT_NOINIT);
+  inode_matID = alloc_int_1(MaxVarPerNode, INT_NOINIT);
+  for (inode = 0; inode < num_nodes; inode++) {
+    if (fill_variable_vector(inode, vt + vt_ptr[inode], inode_matID) !=
+	vt_ptr[inode+1] - vt_ptr[inode]) {
+      EH( -1, "Inconsistency counting unknowns.");
+    }
+    row0[inode] = vt_ptr[inode];
+  }
+  n = vt_ptr[num_nodes];
+  row0[num_nodes] = n;
 
   /*
-   * loop over all of the nodes on this processor
+   * Pass 1: the length of each row
    */
-  for (inode = 0; inode < itotal_nodes; inode++) {
-    nv = Nodes[inode]->Nodal_Vars_Info;
-    /* 
-     * Fill the vector list which points to the unknowns defined at this
-     * node...
-     */
-    row_num_unknowns = fill_variable_vector(inode, inode_varType,
-					    inode_matID);
-    /*
-     * Do a check against the number of unknowns at this
-     * node stored in the global array
-     */
-    if (row_num_unknowns != nv->Num_Unknowns) { 
-      EH( -1, "Inconsistency counting unknowns.");
+  cnt = alloc_int_1(n + 1, 0);
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 256) if (num_threads > 1) num_threads(num_threads) private(iunknown, row)
+#endif
+  for (inode = 0; inode < num_nodes; inode++) {
+    for (iunknown = 0; iunknown < vt_ptr[inode+1] - vt_ptr[inode]; iunknown++) {
+      row = row0[inode] + iunknown;
+      cnt[row+1] = graph_row_columns(exo, inode, iunknown, row, skip_diag,
+				     vt_ptr, vt, NULL);
     }
-    
+  }
+
+  cnt[0] = n + 1;
+  for (i = 0; i < n; i++) cnt[i+1] += cnt[i];
+  *len = cnt[n];
+
+  g = alloc_int_1(*len, INT_NOINIT);
+  memcpy(g, cnt, (n + 1) * sizeof(int));
+  safer_free((void **) &cnt);
+
+  /*
+   * Pass 2: the columns of each row, sorted. Static blocks of nodes, so
+   * that the pages of the columns (first written here) go with the
+   * threads that later take those rows, cf. alloc_dbl_1_ft().
+   */
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static) if (num_threads > 1) num_threads(num_threads) private(iunknown, row)
+#endif
+  for (inode = 0; inode < num_nodes; inode++) {
+    for (iunknown = 0; iunknown < vt_ptr[inode+1] - vt_ptr[inode]; iunknown++) {
+      row = row0[inode] + iunknown;
+      graph_row_columns(exo, inode, iunknown, row, skip_diag,
+			vt_ptr, vt, g + g[row]);
+      qsort(g + g[row], g[row+1] - g[row], sizeof(int), graph_col_compare);
+    }
+  }
+
+  safer_free((void **) &vt_ptr);
+  safer_free((void **) &vt);
+  safer_free((void **) &row0);
+  safer_free((void **) &inode_matID);
+  return g;
+}
+
+/******************************************************************************/
+
+static int
+find_MSR_problem_graph(int *ija[],	   /* column pointer array            */
+		       int itotal_nodes,   /* number nodes this processor     */
+		       Exo_DB *exo)        /* ptr to FE db                    */
+
     /*
-     * Loop over the unknowns defined at this row node 
-     */    
-    for (iunknown = 0; iunknown < row_num_unknowns; iunknown++) {
-      /*
-       * Retrieve the var type of the current unknown
-       */
-      rowVarType = inode_varType[iunknown];
+     * The MSR ija of the unknowns of all of the nodes of this processor,
+     * exactly as long as the value returned.
+     */
+{
+  int nnz;
+
+  /*
+   * The graph a previous launch on the same problem kept (Setup Cache).
+   */
+  if ((*ija = setup_cache_read_graph(exo, itotal_nodes, TRUE, &nnz)) == NULL) {
+    *ija = problem_graph_build(exo, itotal_nodes, TRUE, &nnz);
+    setup_cache_write_graph(exo, itotal_nodes, TRUE, *ija, nnz);
+  }
 
-      /*
-       * Store the beginning location for off-diagonal jacobian
-       * entries for the current unknown
-       */
-      ija_ptr[irow_index] = nz_ptr;
 #ifdef DEBUG_GRAPH
-      fprintf(ifp,"node = %d, unk = %d, irow_index = %d, nz_ptr = %d\n",
-	      inode, iunknown, irow_index, nz_ptr);
+  printf("find_MSR_problem_graph: Final size of ija is %d\n", nnz);
 #endif
-      /*
-       * Loop over the nodes which are determined to have an interaction
-       * with the current row node
-       */
-      for (j = exo->node_node_pntr[inode];
-	   j < exo->node_node_pntr[inode+1]; j++) {
-	inter_node = exo->node_node_list[j];
-	nodeCol = Nodes[inter_node];
-	nvCol = nodeCol->Nodal_Vars_Info;
-	      
-	/* 
-	 * fill the vector list which points to the unknowns 
-	 * defined at this interaction node 
-	 */	    
-	col_num_unknowns = fill_variable_vector(inter_node, inter_node_varType,
-						inter_node_matID);
-	if (col_num_unknowns != nvCol->Num_Unknowns) {
-	  EH( -1, "Inconsistency counting unknowns.");
-	}
-	    
-	/* 
-	 * Loop over the unknowns associated with the 
-	 * interacting node and see if there should be an interaction. 
-	 */
+  return(nnz);
+}
+/****************************************************************************/
 
-	for (inter_unknown = 0; inter_unknown < col_num_unknowns; 
-	     inter_unknown++) {
-		      
-	  /*
-	   * HKM ->
-	   *  The entire process below is designed to find out
-	   *  what unknown we are processing. This coding is very
-	   *  convoluted and fraught with pitfalls. It should
-	   *  be rewritten using the structured approach in MPSalsa
-	   *  to variable indentification.
-	   */		  
-	  colVarType = inter_node_varType[inter_unknown];
-	  
-	  /*
-	   * Query the Interaction mask to determine if a jacobian entry
-	   * should be created 
-	   */
-	  add_var = Inter_Mask[rowVarType][colVarType];
+/*
+ * Couplings that stay zero (Prune Zero Couplings = n).
+ *
+ * The graph couples each equation at a node to every variable at the
+ * neighboring nodes that Inter_Mask allows, and Inter_Mask allows
+ * whatever the equation may depend on in some material of the problem.
+ * For the models actually in use, many of those entries are never
+ * anything but zero. Over the first n Jacobian assemblies the (equation,
+ * variable) type pairs with a nonzero entry on any processor are noted;
+ * after the n'th the other pairs are cleared from Inter_Mask, which keeps
+ * assembly off them from then on, and their entries are squeezed out of
+ * the MSR matrix in place.
+ */
 
-	  /* The following code should be activated when solving DG viscoelastic problems
-	   * with full Jacobian treatment of upwind element stress terms
-	   */
-	  if ( exo->centroid_list[ inode ] != -1 && 
-	       inode != inter_node &&
-	       exo->centroid_list[inter_node] != -1) 
-	    {
-	      eb1 = exo->elem_eb[ exo->centroid_list[ inode ] ] ;
+static int *Prune_Dof_Type = NULL;	/* [num_universe_dofs] variable type */
+static int Prune_Used[MAX_VARIABLE_TYPES][MAX_VARIABLE_TYPES];
+static int Prune_Assemblies = 0;	/* assemblies seen, -1 once pruned */
 
-	      if (vn_glob[ Matilda[eb1] ]->dg_J_model == FULL_DG) {
-		i1 = pd_glob[ Matilda[eb1] ]->i[rowVarType];
-		i2 = pd_glob[ Matilda[eb1] ]->i[colVarType];
-			  
-		if ((rowVarType == colVarType) &&
-		    (i1 == I_P0 || i1 == I_P1 || i1 == I_PQ1 || i1 == I_PQ2) &&
-		    (i2 == I_P0 || i2 == I_P1 || i2 == I_PQ1 || i2 == I_PQ2) &&
-		    (rowVarType != PRESSURE) &&
-		    (rowVarType > VELOCITY_GRADIENT33 || rowVarType < VELOCITY_GRADIENT11))
-		  {
-		    add_var = Inter_Mask[rowVarType][colVarType];
-		  } else {
-		    add_var = 0;
-		  }
-	      }
-	    }
+int
+prune_zero_couplings(struct Aztec_Linear_Solver_System *ams,
+		     Dpi *dpi)
+
+    /*************************************************************************
+     *
+     * prune_zero_couplings():
+     *
+     *  Call after each Jacobian assembly, on all processors. Notes which
+     *  coupling types were nonzero and, on the Prune_Zero_Couplings'th
+     *  call, drops the ones that never were.
+     *
+     *  Return: TRUE if the matrix was pruned by this call
+     *************************************************************************/
+{
+  int inode, i, k, w, end, e, v, nrows, num_pruned, num_dropped;
+  int *ija = ams->bindx;
+  double *a = ams->val, *a_old = ams->val_old;
+  int *inode_matID;
+  int pruned[MAX_VARIABLE_TYPES][MAX_VARIABLE_TYPES];
+
+  if (Prune_Assemblies < 0 || Prune_Zero_Couplings <= 0 || Debug_Flag < 0) return FALSE;
+
+  if (Prune_Dof_Type == NULL) {
+    Prune_Dof_Type = alloc_int_1(MAX(num_universe_dofs, 1), INT_NOINIT);
+    inode_matID = alloc_int_1(MaxVarPerNode, INT_NOINIT);
+    for (inode = 0; inode < dpi->num_universe_nodes; inode++) {
+      fill_variable_vector(inode, Prune_Dof_Type + Nodes[inode]->First_Unknown,
+			   inode_matID);
+    }
+    safer_free((void **) &inode_matID);
+    memset(Prune_Used, 0, sizeof(Prune_Used));
+  }
 
-          if (Debug_Flag < 0) add_var = TRUE;  /* add all vars for checking jacobian */
-			  
-	  if (add_var) {
-	    /*
-	     * Determine the equation number of the current unknown
-	     */
-	    icol_index = nodeCol->First_Unknown + inter_unknown;
+  /*
+   * Only the rows this processor owns are assembled.
+   */
+  nrows = num_internal_dofs + num_boundary_dofs;
+  for (i = 0; i < nrows; i++) {
+    e = Prune_Dof_Type[i];
+    for (k = ija[i]; k < ija[i+1]; k++) {
+      if (a[k] != 0.0) Prune_Used[e][Prune_Dof_Type[ija[k]]] = TRUE;
+    }
+  }
 
-	    if (icol_index != irow_index) {
-	      /*
-	       * Check to See if we need to increase storage
-	       */
-	      if (nz_ptr + 1 == nz_temp) {
+  if (++Prune_Assemblies < Prune_Zero_Couplings) return FALSE;
 
-		/* reallocate ija larger */
-		nz_temp += (int) (2.0 * (itotal_nodes - inode) * 
-				  ((double) nz_ptr/ (double) inode));
-#ifdef DEBUG_GRAPH
-		printf("%s Reallocate ija size to %d from %d\n", yo,
-		       nz_temp, nz_ptr + 1);
+#ifdef PARALLEL
+  if (Num_Proc > 1) {
+    MPI_Allreduce(MPI_IN_PLACE, Prune_Used, MAX_VARIABLE_TYPES*MAX_VARIABLE_TYPES,
+		  MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+  }
 #endif
-		*ija = ija_ptr = 
-		  (int *) realloc((void *) *ija, nz_temp * sizeof(int));
-		if (*ija == NULL) EH(-1, "No space for ija_temp");
-		for (itmp = nz_ptr; itmp < nz_temp; ija_ptr[itmp++] = -1);
-	      }
-	      ija_ptr[nz_ptr++] = icol_index;		      
-	    }
-	  }
-	}
+
+  /*
+   * A variable's coupling to its own equation stays, whatever it was.
+   */
+  num_pruned = 0;
+  for (e = 0; e < MAX_VARIABLE_TYPES; e++) {
+    for (v = 0; v < MAX_VARIABLE_TYPES; v++) {
+      pruned[e][v] = (e != v && Inter_Mask[e][v] && !Prune_Used[e][v]);
+      if (pruned[e][v]) {
+	Inter_Mask[e][v] = 0;
+	num_pruned++;
       }
-      irow_index++;
     }
   }
 
-  ija_ptr[irow_index] = nz_ptr;
- 
-#ifdef DEBUG_GRAPH
-  printf("%s Final size of ija is %d\n", yo, nz_ptr);
-#endif
+  /*
+   * Squeeze every row, external ones included, so that the matrix stays
+   * the graph of the new Inter_Mask. The arrays keep their length.
+   */
+  num_dropped = 0;
+  if (num_pruned > 0) {
+    w = ija[0];
+    k = ija[0];
+    for (i = 0; i < num_universe_dofs; i++) {
+      e = Prune_Dof_Type[i];
+      end = ija[i+1];
+      for (; k < end; k++) {
+	if (pruned[e][Prune_Dof_Type[ija[k]]]) {
+	  num_dropped++;
+	  continue;
+	}
+	ija[w] = ija[k];
+	a[w] = a[k];
+	if (a_old != NULL) a_old[w] = a_old[k];
+	w++;
+      }
+      ija[i+1] = w;
+    }
+    ams->nnz = ija[nrows] - 1;
+    ams->nnz_plus = ija[num_universe_dofs];
+  }
 
-  safer_free((void **) &inode_varType);
-  safer_free((void **) &inode_matID);
-  safer_free((void **) &inter_node_varType);
-  safer_free((void **) &inter_node_matID);
-  
-#ifdef DEBUG_GRAPH
-  fclose(ifp);
-#endif
-  return(nz_ptr);
+  num_dropped = gsum_Int(num_dropped);
+  DPRINTF(stdout, "Prune Zero Couplings: %d equation-variable couplings, %d matrix entries dropped\n",
+	  num_pruned, num_dropped);
 
+  safer_free((void **) &Prune_Dof_Type);
+  Prune_Assemblies = -1;
+  return (num_pruned > 0);
 }
 /****************************************************************************/
 /****************************************************************************/
@@ -3627,6 +4197,7 @@ find_VBR_problem_graph(int *indx[], int *bindx[], int *bpntr[],
   FILE *of;
 #endif
 
+  need_node_node(exo);
   *bpntr = alloc_int_1(row_nodes + 1, INT_NOINIT);
   *rpntr = alloc_int_1(row_nodes + 1, INT_NOINIT);
   *cpntr = alloc_int_1(col_nodes + 1, INT_NOINIT);
@@ -3802,6 +4373,336 @@ zero_lec_column(double *local_J,
 /*****************************************************************************/
 /*****************************************************************************/
 /*****************************************************************************/
+
+/*
+ * What the condensations of each element's last Jacobian fill did to its
+ * residual: lec->R[dst[k]] -= y[k]*lec->R[src[k]], in order. A residual-only
+ * fill has no element matrix to condense with, so it replays these instead
+ * and so stays consistent with the condensed Jacobian.
+ */
+struct Condense_Record
+{
+  int valid;			/* filled in by a Jacobian fill */
+  int num;			/* updates stored */
+  int size;			/* updates allocated */
+  int *dst;
+  int *src;
+  dbl *y;
+};
+
+static struct Condense_Record *Condense_Records = NULL;
+static int Condense_Num_Elems = 0;
+static struct Condense_Record *Condense_Current = NULL;	/* being recorded */
+#ifdef _OPENMP
+#pragma omp threadprivate(Condense_Current)
+#endif
+
+void
+condense_record_init(Exo_DB *exo)
+
+     /************************************************************************
+      *
+      * condense_record_init():
+      *
+      *    Set up the (empty) per-element condensation records when any
+      * element matrix is condensed. Must be called before any parallel
+      * element loop.
+      *
+      ************************************************************************/
+{
+  int mn, condensed = Interior_Condensation;
+
+  if (Condense_Records != NULL) return;
+  for (mn = 0; mn < upd->Num_Mat; mn++) {
+    if (vn_glob[mn]->dg_J_model == CONDENSED_DG) condensed = TRUE;
+  }
+  if (!condensed) return;
+
+  Condense_Num_Elems = exo->num_elems;
+  Condense_Records = alloc_struct_1(struct Condense_Record,
+				    MAX(Condense_Num_Elems, 1));
+}
+/*****************************************************************************/
+
+int
+condense_lec_begin(void)
+
+     /************************************************************************
+      *
+      * condense_lec_begin():
+      *
+      *    Called for the current element before its condensations. On a
+      * Jacobian fill, start a new record for condense_lec_block() to write.
+      * On a residual-only fill lec->J is not assembled, so instead condense
+      * lec->R with the record of the element's last Jacobian fill (none if
+      * it has not had one yet).
+      *
+      * Return: TRUE if the condensations are to be done on lec.
+      *
+      ************************************************************************/
+{
+  struct Condense_Record *cr_e;
+  int k;
+
+  Condense_Current = NULL;
+  if (af->Assemble_LSA_Jacobian_Matrix || af->Assemble_LSA_Mass_Matrix) return (FALSE);
+
+  if (Condense_Records == NULL || ei->ielem < 0 ||
+      ei->ielem >= Condense_Num_Elems) return (af->Assemble_Jacobian);
+  cr_e = Condense_Records + ei->ielem;
+
+  if (af->Assemble_Jacobian) {
+    cr_e->valid = TRUE;
+    cr_e->num = 0;
+    Condense_Current = cr_e;
+    return (TRUE);
+  }
+
+  if (cr_e->valid) {
+    for (k = 0; k < cr_e->num; k++) {
+      lec->R[cr_e->dst[k]] -= cr_e->y[k] * lec->R[cr_e->src[k]];
+    }
+  }
+  return (FALSE);
+}
+/*****************************************************************************/
+
+static void
+condense_record_add(const int dst,
+		    const int src,
+		    const dbl y)
+{
+  struct Condense_Record *cr_e = Condense_Current;
+
+  if (cr_e == NULL) return;
+  if (cr_e->num == cr_e->size) {
+    cr_e->size = MAX(2*cr_e->size, 32);
+    cr_e->dst = (int *) realloc(cr_e->dst, cr_e->size*sizeof(int));
+    cr_e->src = (int *) realloc(cr_e->src, cr_e->size*sizeof(int));
+    cr_e->y = (dbl *) realloc(cr_e->y, cr_e->size*sizeof(dbl));
+    if (cr_e->dst == NULL || cr_e->src == NULL || cr_e->y == NULL) {
+      EH(-1, "Out of memory for condensation records");
+    }
+  }
+  cr_e->dst[cr_e->num] = dst;
+  cr_e->src[cr_e->num] = src;
+  cr_e->y[cr_e->num] = y;
+  cr_e->num++;
+}
+/*****************************************************************************/
+
+/*
+ * Block Gaussian elimination of n local dofs out of the element matrix.
+ *
+ * The dofs are the rows (peqn[k], ldof[k]) and the columns (pvar[k],
+ * ldof[k]). Their rows must be assembled entirely in this element. Each
+ * other row m of lec is replaced by m - (m_b Kbb^-1) [block rows], where
+ * m_b is its part in the block columns. The linear system keeps the same
+ * solution, but only the block rows still reference the block unknowns.
+ * Those rows give the block unknowns back once the rest is solved. The
+ * updates of lec->R go to the record condense_lec_begin() started.
+ *
+ * Return: 0, or -1 with lec untouched if the block is singular.
+ */
+int
+condense_lec_block(const int n,
+		   const int peqn[],	/* row of each dof              */
+		   const int pvar[],	/* column of each dof           */
+		   const int ldof[])	/* its local dof number         */
+{
+  static double Kbb[CONDENSE_MAX_DOF][CONDENSE_MAX_DOF];	/* too big for the stack */
+  static double *K[CONDENSE_MAX_DOF];
+#ifdef _OPENMP
+#pragma omp threadprivate(Kbb, K)
+#endif
+  int indx[CONDENSE_MAX_DOF];
+  double y[CONDENSE_MAX_DOF];
+  int i, j, k, l, ve, vv, w, wv, kt, kv, pe, pv, in_block, nonzero;
+  double d, rk;
+
+  if (n <= 0) return (0);
+  if (n > CONDENSE_MAX_DOF) EH(-1, "condense_lec_block: too many dofs");
+
+  for (k = 0; k < n; k++) K[k] = Kbb[k];
+
+  /* factor the transpose, the multipliers solve Kbb^T y = m_b */
+  for (k = 0; k < n; k++)
+    {
+      for (l = 0; l < n; l++)
+	{
+	  K[k][l] = lec->J[LEC_J_INDEX(peqn[l],pvar[k],ldof[l],ldof[k])];
+	}
+    }
+  if (lu_decomp(K, n, indx, &d) == -1) return (-1);
+
+  for (ve = 0; ve < MAX_VARIABLE_TYPES; ve++)
+    {
+      kt = (ve == MASS_FRACTION) ? upd->Max_Num_Species_Eqn : 1;
+      for (w = 0; w < kt; w++)
+	{
+	  pe = upd->ep[ve];
+	  if (pe == -1) continue;
+	  if (ve == MASS_FRACTION) pe = MAX_PROB_VAR + w;
+
+	  for (i = 0; i < ei->dof[ve]; i++)
+	    {
+	      in_block = FALSE;
+	      for (k = 0; k < n; k++)
+		{
+		  if (peqn[k] == pe && ldof[k] == i) in_block = TRUE;
+		}
+	      if (in_block) continue;
+
+	      nonzero = FALSE;
+	      for (k = 0; k < n; k++)
+		{
+		  y[k] = lec->J[LEC_J_INDEX(pe,pvar[k],i,ldof[k])];
+		  if (y[k] != 0.) nonzero = TRUE;
+		}
+	      if (!nonzero) continue;
+
+	      lu_backsub(K, n, indx, y);
+
+	      for (k = 0; k < n; k++)
+		{
+		  rk = y[k];
+		  if (rk == 0.) continue;
+		  lec->R[LEC_R_INDEX(pe,i)] -= rk * lec->R[LEC_R_INDEX(peqn[k],ldof[k])];
+		  condense_record_add(LEC_R_INDEX(pe,i),
+				      LEC_R_INDEX(peqn[k],ldof[k]), rk);
+
+		  for (vv = 0; vv < MAX_VARIABLE_TYPES; vv++)
+		    {
+		      kv = (vv == MASS_FRACTION) ? upd->Max_Num_Species_Eqn : 1;
+		      for (wv = 0; wv < kv; wv++)
+			{
+			  pv = upd->vp[vv];
+			  if (pv == -1) continue;
+			  if (vv == MASS_FRACTION) pv = MAX_PROB_VAR + wv;
+			  for (j = 0; j < ei->dof[vv]; j++)
+			    {
+			      lec->J[LEC_J_INDEX(pe,pv,i,j)] -=
+				rk * lec->J[LEC_J_INDEX(peqn[k],pv,ldof[k],j)];
+			    }
+			}
+		    }
+		}
+
+	      /* exactly zero, not just to round off */
+	      for (k = 0; k < n; k++)
+		{
+		  lec->J[LEC_J_INDEX(pe,pvar[k],i,ldof[k])] = 0.;
+		}
+	    }
+	}
+    }
+  return (0);
+} /* END of routine condense_lec_block                                   */
+/*****************************************************************************/
+
+/*
+ * Local node that no other element shares, -1 for element types without one.
+ */
+static int
+interior_lnode(const int ielem_type)
+{
+  switch (ielem_type)
+    {
+    case C_BILINEAR_QUAD:
+      return (4);
+    case BIQUAD_QUAD:
+    case BIQUAD_QUAD_LS:
+      return (8);
+    case C_TRILINEAR_HEX:
+      return (8);
+    case TRIQUAD_HEX:
+      return (26);
+    default:
+      return (-1);
+    }
+}
+/*****************************************************************************/
+
+int
+condense_interior_lec(void)
+
+    /*************************************************************************
+     *
+     * condense_interior_lec():
+     *
+     *  Static condensation of the dofs at the element's interior node
+     *  (Interior Condensation = yes): the centroid dofs of Q2, the
+     *  P0/P1/PQ1/PQ2 element dofs, bubble nodes of C_ elements. Nothing
+     *  else in the mesh references those dofs and their rows come from
+     *  this element alone, so condense_lec_block() can eliminate them
+     *  from the other rows before load_lec().
+     *
+     *  Left alone are the pressure (the incompressible pressure block is
+     *  zero), stress and mass fraction rows that take neighbor element
+     *  columns in their discontinuous Galerkin form, and stress that the
+     *  CONDENSED formulation has already taken out.
+     *
+     *  Return: the number of dofs condensed. A block that turns out
+     *          singular, all variables together and then each on its own,
+     *          is just left in place.
+     *************************************************************************/
+{
+  int peqn[CONDENSE_MAX_DOF], pvar[CONDENSE_MAX_DOF], ldof[CONDENSE_MAX_DOF];
+  int ln, v, w, kt, i, n, start, nvar, m, done = 0;
+  int var_start[MAX_VARIABLE_TYPES + MAX_CONC + 1];
+
+  if (af->Assemble_LSA_Jacobian_Matrix || af->Assemble_LSA_Mass_Matrix) return (0);
+
+  ln = interior_lnode(ei->ielem_type);
+  if (ln < 0 || ln >= ei->num_local_nodes) return (0);
+
+  n = 0;
+  nvar = 0;
+  for (v = V_FIRST; v < V_LAST; v++)
+    {
+      if (!pd->e[v] || !pd->v[v] || upd->ep[v] == -1) continue;
+      if (v == PRESSURE) continue;
+      if (ei->ln_to_first_dof[v][ln] == -1) continue;
+      if (((v >= POLYMER_STRESS11 && v <= POLYMER_STRESS33) ||
+	   (v >= POLYMER_STRESS11_1 && v <= POLYMER_STRESS33_7)) &&
+	  (vn->dg_J_model == FULL_DG || vn->dg_J_model == CONDENSED_DG)) continue;
+      if (v == MASS_FRACTION &&
+	  (pd->i[v] == I_P0 || pd->i[v] == I_P1 ||
+	   pd->i[v] == I_PQ1 || pd->i[v] == I_PQ2)) continue;
+
+      kt = (v == MASS_FRACTION) ? upd->Max_Num_Species_Eqn : 1;
+      for (w = 0; w < kt; w++)
+	{
+	  var_start[nvar++] = n;
+	  for (i = ei->ln_to_first_dof[v][ln]; i <= ei->ln_to_dof[v][ln]; i++)
+	    {
+	      if (n >= CONDENSE_MAX_DOF) break;
+	      peqn[n] = (v == MASS_FRACTION) ? MAX_PROB_VAR + w : upd->ep[v];
+	      pvar[n] = (v == MASS_FRACTION) ? MAX_PROB_VAR + w : upd->vp[v];
+	      ldof[n] = i;
+	      n++;
+	    }
+	}
+    }
+  var_start[nvar] = n;
+
+  if (n == 0) return (0);
+  if (condense_lec_block(n, peqn, pvar, ldof) == 0) return (n);
+
+  for (m = 0; m < nvar; m++)
+    {
+      start = var_start[m];
+      if (condense_lec_block(var_start[m+1] - start, peqn + start,
+			     pvar + start, ldof + start) == 0)
+	{
+	  done += var_start[m+1] - start;
+	}
+    }
+  return (done);
+} /* END of routine condense_interior_lec                                */
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
 /*
  * Function the returns the index in the VBR a array of the block
  * associated with the Ith block row and Jth block column */
@@ -4416,6 +4416,101 @@ evaluate_flux(
  *            And that's it.  What could be easier ?  Use and enjoy your new volume integral.
  */
 
+/*
+ * While integrals_local() is on, evaluate_volume_integral() and
+ * evaluate_global_flux() leave out the elements flagged in skip (if not
+ * NULL) and return this processor's share of the sum without reducing
+ * it, so that a caller can add several integrals up and reduce them all
+ * together.
+ */
+
+static int Integrals_Local = FALSE;
+static const int *Integrals_Skip = NULL;
+
+void
+integrals_local(const int local,
+		const int *skip)
+{
+  Integrals_Local = local;
+  Integrals_Skip = local ? skip : NULL;
+}
+
+/*
+ * Time stamp ahead of a volume integral in its output file.
+ */
+
+static void
+volume_integral_stamp(const char *quantity_str,
+		      const int blk_id,
+		      const int species_id,
+		      const char *filenm,
+		      const double time_value,
+		      const int print_flag)
+{
+  if (print_flag && ProcID == 0) {
+    FILE  *jfp;
+    if( (jfp=fopen(filenm,"a")) != NULL) {
+      if ( ppvi_type == PPVI_VERBOSE ) {
+	fprintf(jfp,"Time/iteration = %e \n", time_value);
+	fprintf(jfp,"\t  (%s) Volume Integral for block %d species %d\n", 
+		quantity_str,blk_id, species_id);
+      }
+      if ( ppvi_type == PPVI_CSV ) {
+	fprintf(jfp,"%e,", time_value);
+      }
+      fflush(jfp);
+      fclose(jfp);
+    }
+  }
+}
+
+/*
+ * Book keeping and output for a finished (global) volume integral sum.
+ */
+
+static void
+volume_integral_report(const int quantity,
+		       const int species_id,
+		       const char *filenm,
+		       const int mn,
+		       const double sum,
+		       const int shell_sat_open,
+		       const double delta_t,
+		       const double time_value,
+		       const int print_flag)
+{
+  if (quantity == I_SPECIES_SOURCE)
+      { 
+       if(time_value <= tran->init_time+delta_t)
+ 	    { 
+             Spec_source_inventory[mn][species_id] = sum;
+	    }	else	{
+            Spec_source_inventory[mn][species_id] += 0.5*sum*(delta_t+tran->delta_t);
+	    }
+      }
+  if( print_flag && ProcID == 0 )
+    {
+      FILE *jfp;
+      
+      if( (jfp = fopen( filenm, "a")) != NULL )	{
+	if (ppvi_type == PPVI_VERBOSE) {
+           if(quantity == I_SPECIES_SOURCE)
+	      {fprintf(jfp,"   volume= %10.7e \n", Spec_source_inventory[mn][species_id] );}
+              else
+	      {fprintf(jfp,"   volume= %10.7e \n", sum );}
+	}
+	if (ppvi_type == PPVI_CSV) {
+	  fprintf(jfp,"%10.7e\n", sum );
+	}
+  	fclose(jfp);
+      }
+    }
+
+  // Kind of a hack to keep track of the porous liquid inventory for a time-dependent BC
+					      
+  if(shell_sat_open) Porous_liq_inventory = sum; 
+}
+
 double
 evaluate_volume_integral(const Exo_DB *exo, /* ptr to basic exodus ii mesh information */
 			 const Dpi *dpi, /* distributed processing info */
@@ -4530,26 +4625,13 @@ evaluate_volume_integral(const Exo_DB *exo, /* ptr to basic exodus ii mesh infor
 				         ( quantity == I_LS_ARC_LENGTH ||
 				           quantity == I_MAG_GRAD_FILL_ERROR ) );
                                    
-  if( subgrid_integration_active )  start_tree = create_shape_fcn_tree( ls->Integration_Depth );
+  if( subgrid_integration_active )  start_tree = shape_fcn_tree_for_elem( ls->Integration_Depth );
 
 
   /* first write time stamp or run stamp to separate the sets */
 
-  if (print_flag && ProcID == 0) {
-    FILE  *jfp;
-    if( (jfp=fopen(filenm,"a")) != NULL) {
-      if ( ppvi_type == PPVI_VERBOSE ) {
-	fprintf(jfp,"Time/iteration = %e \n", time_value);
-	fprintf(jfp,"\t  (%s) Volume Integral for block %d species %d\n", 
-		quantity_str,blk_id, species_id);
-      }
-      if ( ppvi_type == PPVI_CSV ) {
-	fprintf(jfp,"%e,", time_value);
-      }
-      fflush(jfp);
-      fclose(jfp);
-    }
-  }
+  volume_integral_stamp(quantity_str, blk_id, species_id, filenm,
+			time_value, print_flag);
 
   mn = map_mat_index(blk_id);
   if( ( eb = in_list(blk_id, 0, exo->num_elem_blocks, exo->eb_id) ) != -1 )
@@ -4567,6 +4649,8 @@ evaluate_volume_integral(const Exo_DB *exo, /* ptr to basic exodus ii mesh infor
           double wt, xi[3];
 	  double (*s)[DIM] = NULL, *weight = NULL;
 
+	  if ( Integrals_Skip != NULL && Integrals_Skip[elem] ) continue;
+
           ei->ielem = elem;
 
 	  /*needed for saturation hyst. func. */
@@ -4815,7 +4899,9 @@ evaluate_volume_integral(const Exo_DB *exo, /* ptr to basic exodus ii mesh infor
     }
 
 #ifdef PARALLEL
-  if( Num_Proc > 1 ) {
+  if( Num_Proc > 1 && Integrals_Local ) {
+    sum = proc_sum;
+  } else if( Num_Proc > 1 ) {
     MPI_Allreduce( &proc_sum, &global_sum, 1, MPI_DOUBLE, MPI_SUM, 
 		   MPI_COMM_WORLD);
 
@@ -4824,45 +4910,213 @@ evaluate_volume_integral(const Exo_DB *exo, /* ptr to basic exodus ii mesh infor
   }
 #endif
 
-  if ( subgrid_integration_active ) 
-  {
-	  free_shape_fcn_tree( start_tree );
-  }
-  
   if ( ls != NULL ) ls->on_sharp_surf = FALSE;
 
-  if (quantity == I_SPECIES_SOURCE)
-      { 
-       if(time_value <= tran->init_time+delta_t)
- 	    { 
-             Spec_source_inventory[mn][species_id] = sum;
-	    }	else	{
-            Spec_source_inventory[mn][species_id] += 0.5*sum*(delta_t+tran->delta_t);
+  volume_integral_report(quantity, species_id, filenm, mn, sum,
+			 pd->e[R_SHELL_SAT_OPEN], delta_t, time_value, print_flag);
+
+  return (sum); 
+}
+/*************************************************************************************/
+
+/*
+ * Volume integrals that take only the usual Gauss points - no level set
+ * subgrid, subelement or adaptive weights and not one of the SURF_
+ * quantities. Those are the ones evaluate_volume_integrals() can share
+ * an element pass between.
+ */
+
+static int
+volume_integral_is_plain(const pp_Volume *v)
+{
+  int q = v->volume_type;
+
+  if (q == I_SURF_SPECIES || q == I_SURF_TEMP) return FALSE;
+  if (ls == NULL) return TRUE;
+
+  return !( q == I_POS_FILL || q == I_NEG_FILL ||
+	    q == I_POS_VOLPLANE || q == I_NEG_VOLPLANE ||
+	    q == I_POS_CENTER_X || q == I_POS_CENTER_Y || q == I_POS_CENTER_Z ||
+	    q == I_NEG_CENTER_X || q == I_NEG_CENTER_Y || q == I_NEG_CENTER_Z ||
+	    q == I_POS_VX || q == I_POS_VY || q == I_POS_VZ ||
+	    q == I_NEG_VX || q == I_NEG_VY || q == I_NEG_VZ ||
+	    q == I_LS_ARC_LENGTH || q == I_MAG_GRAD_FILL_ERROR );
+}
+/*************************************************************************************/
+
+void
+evaluate_volume_integrals(const Exo_DB *exo, /* ptr to basic exodus ii mesh information */
+			  const Dpi *dpi, /* distributed processing info */
+			  const double x[],	/* solution vector */
+			  const double xdot[],	/* dx/dt vector */
+			  const double delta_t, /* time-step size */
+			  const double time_value, /* current time */
+			  const int print_flag)     /*  flag for printing results,1=print*/
+
+    /*
+     * All of the Volume Integral cards (pp_volume[]) at once.
+     *
+     * The plain ones (see volume_integral_is_plain()) on the same block
+     * share one pass over its elements: each Gauss point is loaded once
+     * and then handed to compute_volume_integrand() for every one of them.
+     * Their sums go through a single MPI reduction. The others still
+     * get their own evaluate_volume_integral(). The output is the same as
+     * calling evaluate_volume_integral() for each card in turn.
+     */
+{
+  int i, k, eb, e_start, e_end, elem, ip, ip_total, err, n_plain = 0;
+  int *plain, *group;
+  double *sum, wt, xi[3];
+  extern int PRS_mat_ielem;
+  extern int MMH_ip;
+#ifdef PARALLEL
+  double *proc_sum, *global_sum, sum0;
+#endif
+
+  if (nn_volume <= 0) return;
+
+  plain = alloc_int_1(nn_volume, FALSE);
+  group = alloc_int_1(nn_volume, -1);
+  sum   = alloc_dbl_1(nn_volume, 0.);
+#ifdef PARALLEL
+  proc_sum   = alloc_dbl_1(nn_volume, 0.);
+  global_sum = alloc_dbl_1(nn_volume, 0.);
+#endif
+
+  for (i = 0; i < nn_volume; i++) {
+    plain[i] = volume_integral_is_plain(pp_volume[i]);
+    if (plain[i]) n_plain++;
+  }
+
+  for (i = 0; i < nn_volume; i++) {
+    if (!plain[i] || group[i] != -1) continue;
+    for (k = i; k < nn_volume; k++) {
+      if (plain[k] && pp_volume[k]->blk_id == pp_volume[i]->blk_id) group[k] = i;
+    }
+
+    if ((eb = in_list(pp_volume[i]->blk_id, 0, exo->num_elem_blocks,
+		      exo->eb_id)) != -1) {
+      e_start = exo->eb_ptr[eb];
+      e_end   = exo->eb_ptr[eb+1];
+
+      for (elem = e_start; elem < e_end; elem++) {
+	ei->ielem = elem;
+
+	/*needed for saturation hyst. func. */
+	PRS_mat_ielem = ei->ielem - exo->eb_ptr[find_elemblock_index(ei->ielem, exo)];
+
+	err = load_elem_dofptr(elem, (Exo_DB*) exo,
+			       (dbl *) x, (dbl *) x, (dbl *) xdot,
+			       (dbl *) xdot, (dbl *) x, 0);
+	EH(err, "load_elem_dofptr");
+
+	err = bf_mp_init(pd);
+	EH(err, "bf_mp_init");
+
+	ip_total = elem_info(NQUAD, ei->ielem_type);
+
+	for (ip = 0; ip < ip_total; ip++) {
+	  MMH_ip = ip;
+
+	  find_stu (ip, ei->ielem_type, &xi[0], &xi[1], &xi[2]);
+	  fv->wt = wt = Gq_weight (ip, ei->ielem_type);
+
+	  err = load_basis_functions( xi, bfd );
+	  EH( err, "problem from load_basis_functions");
+
+	  err = beer_belly();
+	  EH( err, "beer_belly");
+
+	  err = load_fv();
+	  EH( err, "load_fv");
+
+	  err = load_bf_grad();
+	  EH( err, "load_bf_grad");
+
+	  if ( pd->e[R_MESH1] ) {
+	    err = load_bf_mesh_derivs();
+	    EH( err, "load_bf_mesh_derivs");
+	  }
+
+	  err = load_fv_grads();
+	  EH( err, "load_fv_grads");
+
+	  if ( pd->e[R_MESH1] ) {
+	    err = load_fv_mesh_derivs(1);
+	    EH( err, "load_fv_mesh_derivs");
+	  }
+
+	  if (mp->PorousMediaType != CONTINUOUS) {
+	    err = load_porous_properties();
+	    EH( err, "load_porous_properties");
+	  }
+	  do_LSA_mods(LSA_VOLUME);
+
+	  for (k = i; k < nn_volume; k++) {
+	    if (group[k] != i) continue;
+#ifdef PARALLEL
+	    sum0 = sum[k];
+#endif
+	    compute_volume_integrand(pp_volume[k]->volume_type, elem,
+				     pp_volume[k]->species_no,
+				     pp_volume[k]->params,
+				     pp_volume[k]->num_params, &sum[k], NULL,
+				     FALSE, time_value, delta_t, xi, exo);
+#ifdef PARALLEL
+	    if (Num_Proc > 1 && dpi->elem_owner[ ei->ielem ] == ProcID) {
+	      proc_sum[k] += sum[k] - sum0;
 	    }
-      }
-  if( print_flag && ProcID == 0 )
-    {
-      FILE *jfp;
-      
-      if( (jfp = fopen( filenm, "a")) != NULL )	{
-	if (ppvi_type == PPVI_VERBOSE) {
-           if(quantity == I_SPECIES_SOURCE)
-	      {fprintf(jfp,"   volume= %10.7e \n", Spec_source_inventory[mn][species_id] );}
-              else
-	      {fprintf(jfp,"   volume= %10.7e \n", sum );}
-	}
-	if (ppvi_type == PPVI_CSV) {
-	  fprintf(jfp,"%10.7e\n", sum );
+#endif
+	  }
 	}
-  	fclose(jfp);
       }
     }
+  }
 
-  // Kind of a hack to keep track of the porous liquid inventory for a time-dependent BC
-					      
-  if(pd->e[R_SHELL_SAT_OPEN]) Porous_liq_inventory = sum; 
-  
-  return (sum); 
+#ifdef PARALLEL
+  if (Num_Proc > 1 && n_plain > 0) {
+    MPI_Allreduce(proc_sum, global_sum, nn_volume, MPI_DOUBLE, MPI_SUM,
+		  MPI_COMM_WORLD);
+    for (k = 0; k < nn_volume; k++) {
+      if (plain[k]) sum[k] = global_sum[k];
+    }
+  }
+#endif
+
+  for (k = 0; k < nn_volume; k++) {
+    int mn;
+
+    if (!plain[k]) {
+      evaluate_volume_integral(exo, dpi,
+			       pp_volume[k]->volume_type,
+			       pp_volume[k]->volume_name,
+			       pp_volume[k]->blk_id,
+			       pp_volume[k]->species_no,
+			       pp_volume[k]->volume_fname,
+			       pp_volume[k]->params,
+			       pp_volume[k]->num_params,
+			       NULL, x, xdot, delta_t,
+			       time_value, print_flag);
+      continue;
+    }
+
+    mn = map_mat_index(pp_volume[k]->blk_id);
+    volume_integral_stamp(pp_volume[k]->volume_name, pp_volume[k]->blk_id,
+			  pp_volume[k]->species_no, pp_volume[k]->volume_fname,
+			  time_value, print_flag);
+    volume_integral_report(pp_volume[k]->volume_type, pp_volume[k]->species_no,
+			   pp_volume[k]->volume_fname, mn, sum[k],
+			   (mn >= 0 && pd_glob[mn]->e[R_SHELL_SAT_OPEN]),
+			   delta_t, time_value, print_flag);
+  }
+
+  safe_free(plain);
+  safe_free(group);
+  safe_free(sum);
+#ifdef PARALLEL
+  safe_free(proc_sum);
+  safe_free(global_sum);
+#endif
 }
 /*************************************************************************************/
 /*************************************************************************************/
@@ -6057,6 +6311,8 @@ evaluate_global_flux (const Exo_DB *exo,
 	  int nodes_per_side;
   
 
+	  if ( Integrals_Skip != NULL && Integrals_Skip[elem] ) continue;
+
 	  if (( num_exterior_faces = get_exterior_faces( elem, exterior_faces, exo, dpi ) ) > 0 ) /* and if it has exterior */
 	    {
 
@@ -6133,7 +6389,11 @@ evaluate_global_flux (const Exo_DB *exo,
     }
 
 #ifdef PARALLEL
-  if( Num_Proc > 1 ) 
+  if( Num_Proc > 1 && Integrals_Local )
+    {
+	sum = proc_sum;
+    }
+  else if( Num_Proc > 1 ) 
     {
 
 	MPI_Allreduce( &proc_sum, &global_sum, 1, MPI_DOUBLE, MPI_SUM, 
@@ -6991,7 +7251,10 @@ evaluate_flux_sens(const Exo_DB *exo, /* ptr to basic exodus ii mesh information
 		/* but first evaluate properties if variable */
 		if (mp->ConductivityModel == USER)
 		  {
-		    err = usr_thermal_conductivity(mp->u_thermal_conductivity, time_value);
+		    if (mp->Plugin[GOMA_PLUGIN_THERMAL_CONDUCTIVITY] >= 0)
+		      err = plugin_property(GOMA_PLUGIN_THERMAL_CONDUCTIVITY, -1, time_value);
+		    else
+		      err = usr_thermal_conductivity(mp->u_thermal_conductivity, time_value);
 		  }
 		/*  heat capacity  */
 		if(mp->HeatCapacityModel == USER )
@@ -9470,13 +9733,137 @@ load_fv_grads_sens(void)
   return(status);
 }/*  end of load_fv_grads_sens  */
 
+/*
+ * Adaptive integration weights of the elements on the interface, kept
+ * from one call of adaptive_weight() to the next. They depend only on
+ * the level set values handed in (plus the element type, the number of
+ * points, the interval, alpha, wt_type and the Chebyshev order), which
+ * are the same for the residual and the Jacobian, for every equation's
+ * assembly and for numerical Jacobian perturbations of the other
+ * unknowns - so the crossings, Chebyshev coefficients and moments are
+ * worked out again only once the level set has moved. Each element
+ * gets up to ADAPT_CACHE_WAYS sets (the two phases, the sides being
+ * integrated), allocated when the element is first asked for.
+ */
+
+#define ADAPT_CACHE_WAYS	4
+#define ADAPT_CACHE_F		9	/* values of a BIQUAD_QUAD */
+
+struct Adapt_Cache_Entry
+{
+  int ngp;				/* 0 for an empty way */
+  int dim;
+  int wt_type;
+  int elem_type;
+  int order;
+  double alpha;
+  double f[ADAPT_CACHE_F];
+  double w[ADAPT_CACHE_F];
+  int status;
+};
+
+struct Adapt_Cache
+{
+  int next;				/* way to replace next */
+  struct Adapt_Cache_Entry way[ADAPT_CACHE_WAYS];
+};
+
+static struct Adapt_Cache **Adapt_Cache_Elem = NULL;
+static int Adapt_Cache_Num_Elems = 0;
+
+static int adaptive_weight_eval
+PROTO((double *, const int, const int, const double *, const double,
+       const int, const int));
+
+int
+adaptive_weight(double w[],
+		const int ngp,
+		const int dim,
+		const double ls_F[],
+		const double alpha,
+		const int wt_type,
+		const int elem_type)
+{
+  int i, k, nf, order = 0, elem = ei->ielem;
+  struct Adapt_Cache *c;
+  struct Adapt_Cache_Entry *e;
+
+#ifndef NO_CHEBYSHEV_PLEASE
+  order = ls->Adaptive_Order;
+#endif
+
+  nf = dim == 1 ? 3 : 9;
+  if ( EXO_ptr == NULL || elem < 0 || elem >= EXO_ptr->num_elems ||
+       dim < 1 || dim > 2 || ngp > ADAPT_CACHE_F )
+    {
+      return ( adaptive_weight_eval(w, ngp, dim, ls_F, alpha, wt_type, elem_type) );
+    }
+
+  if ( Adapt_Cache_Elem == NULL )
+    {
+      Adapt_Cache_Num_Elems = EXO_ptr->num_elems;
+      Adapt_Cache_Elem = (struct Adapt_Cache **)
+	calloc( Adapt_Cache_Num_Elems, sizeof(struct Adapt_Cache *) );
+    }
+  if ( (c = Adapt_Cache_Elem[elem]) == NULL )
+    {
+      c = Adapt_Cache_Elem[elem] = (struct Adapt_Cache *)
+	calloc( 1, sizeof(struct Adapt_Cache) );
+    }
+
+  for ( k = 0; k < ADAPT_CACHE_WAYS; k++ )
+    {
+      e = &c->way[k];
+      if ( e->ngp != ngp || e->dim != dim || e->wt_type != wt_type ||
+	   e->elem_type != elem_type || e->order != order ||
+	   e->alpha != alpha ) continue;
+      for ( i = 0; i < nf && e->f[i] == ls_F[i]; i++ );
+      if ( i < nf ) continue;
+
+      for ( i = 0; i < ngp; i++ ) w[i] = e->w[i];
+      return ( e->status );
+    }
+
+  e = &c->way[c->next];
+  c->next = ( c->next + 1 ) % ADAPT_CACHE_WAYS;
+
+  e->status = adaptive_weight_eval(w, ngp, dim, ls_F, alpha, wt_type, elem_type);
+
+  e->ngp = ngp;
+  e->dim = dim;
+  e->wt_type = wt_type;
+  e->elem_type = elem_type;
+  e->order = order;
+  e->alpha = alpha;
+  for ( i = 0; i < nf; i++ ) e->f[i] = ls_F[i];
+  for ( i = 0; i < ngp; i++ ) e->w[i] = w[i];
+
+  return ( e->status );
+}
+
+void
+free_adaptive_weight_cache(void)
+{
+  int e;
+
+  if ( Adapt_Cache_Elem == NULL ) return;
+
+  for ( e = 0; e < Adapt_Cache_Num_Elems; e++ )
+    {
+      if ( Adapt_Cache_Elem[e] != NULL ) safe_free( (void *) Adapt_Cache_Elem[e] );
+    }
+  safe_free( (void *) Adapt_Cache_Elem );
+  Adapt_Cache_Elem = NULL;
+  Adapt_Cache_Num_Elems = 0;
+}
+
 /*
 	ADAPTIVE INTEGRATION WEIGHT ROUTINE
  */
 
 
  
-int adaptive_weight (
+static int adaptive_weight_eval (
 			double w[],
  			const int ngp,
  			const int dim,
@@ -10051,7 +10438,7 @@ switch(dim)
 	}
 
 return(return_val);
-} /* end of function adaptive_weight */
+} /* end of function adaptive_weight_eval */
 /**********************************************************************/
 
 int solve_quadratic( 
@@ -19,13 +19,14 @@ static char rcsid[] =
 "$Id: mm_input.c,v 5.36 2010-06-29 22:23:42 prschun Exp $";
 #endif
 
-#define _XOPEN_SOURCE /* POSIX WEXITSTATUS */
+#define _XOPEN_SOURCE 700 /* POSIX WEXITSTATUS, popen, fmemopen */
 
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
 #include <strings.h> /* strcasecmp and strncasecmp moved here for POSIX.1 */
 #include <math.h>
+#include <limits.h>
 #include <unistd.h>
 
 #include <ctype.h>		/* for toupper(), isspace() */
@@ -101,6 +102,18 @@ struct Phase_Function_Data *pfd;
 
 static char aprepro_command[1024];
 
+/*
+ * Files run through aprepro by fopen_aprepro(), and what it made of them.
+ */
+struct Aprepro_File
+{
+  char name[MAX_FNL];
+  char *text;
+  size_t len;
+};
+static int Num_Aprepro_Files = 0;
+static struct Aprepro_File *Aprepro_Files = NULL;
+
 static Spfrtn sr;
 
 
@@ -250,6 +263,7 @@ read_input_file(struct Command_line_command **clc,
       rd_post_process_specs(ifp, input);
     
       fclose(ifp);
+      input_index_free(NULL);
 	  echo_compiler_settings();
 	  ECHO( "CLOSE", echo);	
 
@@ -346,6 +360,19 @@ look_for(FILE  *ifp,
 */
 {
   char *yo = "look_for ERROR exit: ";
+  int found;
+
+  if ((found = input_index_find(ifp, string, ch_term, FALSE)) != 0) {
+    if (found == 1) {
+      strcpy(input, string);
+      return;
+    }
+    fprintf(stderr,"%sEOF found in input file while searching for:\n",
+	    yo);
+    fprintf(stderr,"%s\n",string);
+    exit(-1);
+  }
+
   if (read_string(ifp,input,ch_term) == -1) {
     fprintf(stderr,"%sEOF found in input file while searching for:\n",
 	    yo);
@@ -512,7 +539,18 @@ look_for_optional(FILE *ifp,
 		  character is read, or the end-of-file is read.
 */
 {
+  int found;
+
   rewind(ifp);
+  if ((found = input_index_find(ifp, string, ch_term, TRUE)) != 0) {
+    if (found == 1) {
+      strcpy(input, string);
+      return 1;
+    }
+    rewind(ifp);
+    return(-1);
+  }
+
   if (read_string(ifp, input, ch_term) == -1) {
     /*
      * fprintf(stderr,"Didn't find \"%s\"; defaulting.\n", string);
@@ -580,6 +618,13 @@ look_forward_optional(FILE *ifp, const char *string, char input[],
 {
   int status = 1;
   fpos_t file_position;  /* position in file at start of search */
+
+  if ((status = input_index_find(ifp, string, ch_term, FALSE)) != 0) {
+    if (status == 1) strcpy(input, string);
+    return(status);
+  }
+  status = 1;
+
 #ifndef tflop
   fgetpos(ifp, &file_position);
 #else
@@ -706,6 +751,218 @@ rd_file_specs(FILE *ifp,
     SPF(echo_string, eoformat, "Brk file", Brk_File); ECHO(echo_string, echo_file);
   }
 
+  /*
+   * Number of ranks that share the work of the built-in brk.
+   */
+  if (look_for_optional(ifp, "Brk Ranks", input, '=') == 1) {
+    if (fscanf(ifp, "%d", &Brk_Num_Ranks) != 1 || Brk_Num_Ranks < 1)
+      {
+	EH( -1, "ERROR reading Brk Ranks card, expected a positive integer");
+      }
+    SPF(echo_string, "%s = %d", "Brk Ranks", Brk_Num_Ranks);
+    ECHO(echo_string, echo_file);
+  }
+
+  /*
+   * How the built-in brk partitions the mesh: Chaco, or one of the
+   * geometric cuts of the node coordinates.
+   */
+  if (look_for_optional(ifp, "Brk Partitioner", input, '=') == 1) {
+    read_string(ifp, input, '\n');
+    strip(input);
+    if (!strcasecmp(input, "chaco")) {
+      Brk_Partitioner = BRK_PART_CHACO;
+    } else if (!strcasecmp(input, "rcb")) {
+      Brk_Partitioner = BRK_PART_RCB;
+    } else if (!strcasecmp(input, "hilbert")) {
+      Brk_Partitioner = BRK_PART_HILBERT;
+    } else {
+      EH(-1, "Expected Brk Partitioner = {chaco | rcb | hilbert}");
+    }
+    SPF(echo_string, eoformat, "Brk Partitioner", input);
+    ECHO(echo_string, echo_file);
+  }
+
+  /*
+   * Coarser meshes to solve on first, coarsest first. Each solution is
+   * the initial guess of the next mesh, and the last one of this one.
+   */
+  Mesh_Sequence_Length = 0;
+  if (look_for_optional(ifp, "Mesh Sequence", input, '=') == 1) {
+    char *tok;
+    read_string(ifp, input, '\n');
+    strip(input);
+    SPF(echo_string, eoformat, "Mesh Sequence", input);
+    for (tok = strtok(input, " \t"); tok != NULL; tok = strtok(NULL, " \t")) {
+      if (Mesh_Sequence_Length == MAX_MESH_SEQUENCE) {
+	EH(-1, "Too many meshes on the Mesh Sequence card");
+      }
+      strcpy(Mesh_Sequence_File[Mesh_Sequence_Length++], tok);
+    }
+    if (Mesh_Sequence_Length == 0) {
+      EH(-1, "Expected Mesh Sequence = <coarsest mesh> [<finer mesh> ...]");
+    }
+    ECHO(echo_string, echo_file);
+  }
+
+  /*
+   * Optional file for the measured assembly cost of each element. It is
+   * written at the end of the run and read by the built-in brk.
+   */
+  Elem_Cost_File[0] = '\0';
+  if (look_for_optional(ifp, "Element Cost File", input, '=') == 1) {
+    read_string(ifp, input, '\n');
+    strip(input);
+    if (strcasecmp(input, "NONE") && strcasecmp(input, "NO")) {
+      strcpy(Elem_Cost_File, input);
+    }
+    SPF(echo_string, eoformat, "Element Cost File", Elem_Cost_File);
+    ECHO(echo_string, echo_file);
+  }
+
+  /*
+   * Optional file for the region timers, written at the end of the run
+   * and, given an interval, every that many time steps.
+   */
+  Perf_Report_File[0] = '\0';
+  Perf_Report_Interval = 0;
+  if (look_for_optional(ifp, "Performance Report File", input, '=') == 1) {
+    char fname[MAX_FNL];
+    read_string(ifp, input, '\n');
+    strip(input);
+    fname[0] = '\0';
+    if (sscanf(input, "%s %d", fname, &Perf_Report_Interval) < 1 ||
+	Perf_Report_Interval < 0) {
+      EH( -1, "ERROR reading Performance Report File card, expected a file name and an optional interval");
+    }
+    if (strcasecmp(fname, "NONE") && strcasecmp(fname, "NO")) {
+      strcpy(Perf_Report_File, fname);
+    }
+    SPF(echo_string, "%s = %s %d", "Performance Report File",
+	Perf_Report_File, Perf_Report_Interval);
+    ECHO(echo_string, echo_file);
+  }
+
+  /*
+   * Optional file for a record of every Newton iteration and time step.
+   */
+  Perf_Log_File[0] = '\0';
+  if (look_for_optional(ifp, "Performance Log File", input, '=') == 1) {
+    read_string(ifp, input, '\n');
+    strip(input);
+    if (strcasecmp(input, "NONE") && strcasecmp(input, "NO")) {
+      strcpy(Perf_Log_File, input);
+    }
+    SPF(echo_string, eoformat, "Performance Log File", Perf_Log_File);
+    ECHO(echo_string, echo_file);
+  }
+
+  /*
+   * Optional timeline of the regions down to the given depth, as a
+   * Chrome trace.
+   */
+  Trace_File[0] = '\0';
+  Trace_Depth = 2;
+  if (look_for_optional(ifp, "Trace File", input, '=') == 1) {
+    char fname[MAX_FNL];
+    read_string(ifp, input, '\n');
+    strip(input);
+    fname[0] = '\0';
+    if (sscanf(input, "%s %d", fname, &Trace_Depth) < 1 || Trace_Depth < 1) {
+      EH( -1, "ERROR reading Trace File card, expected a file name and an optional depth of at least 1");
+    }
+    if (strcasecmp(fname, "NONE") && strcasecmp(fname, "NO")) {
+      strcpy(Trace_File, fname);
+    }
+    SPF(echo_string, "%s = %s %d", "Trace File", Trace_File, Trace_Depth);
+    ECHO(echo_string, echo_file);
+  }
+
+  /*
+   * Optional report of the halo traffic with each neighbor and of the
+   * reductions at each call site.
+   */
+  Comm_Report_File[0] = '\0';
+  if (look_for_optional(ifp, "Communication Report File", input, '=') == 1) {
+    read_string(ifp, input, '\n');
+    strip(input);
+    if (strcasecmp(input, "NONE") && strcasecmp(input, "NO")) {
+      strcpy(Comm_Report_File, input);
+    }
+    SPF(echo_string, eoformat, "Communication Report File", Comm_Report_File);
+    ECHO(echo_string, echo_file);
+  }
+
+  /*
+   * Optional timing of the assembly kernels over repeated assemblies.
+   */
+  Kernel_Bench_Reps = 0;
+  if (look_for_optional(ifp, "Kernel Benchmark", input, '=') == 1) {
+    if (fscanf(ifp, "%d", &Kernel_Bench_Reps) != 1 || Kernel_Bench_Reps < 0) {
+      EH( -1, "ERROR reading Kernel Benchmark card, expected a number of assemblies");
+    }
+    SPF(echo_string, "%s = %d", "Kernel Benchmark", Kernel_Bench_Reps);
+    ECHO(echo_string, echo_file);
+  }
+
+  /*
+   * Optional per processor report of the allocation sites holding the
+   * most memory and making the most calls, at the end of the run or on
+   * running out of memory.
+   */
+  Memory_Report_File[0] = '\0';
+  Memory_Report_Top = 10;
+  if (look_for_optional(ifp, "Memory Report File", input, '=') == 1) {
+    char fname[MAX_FNL];
+    read_string(ifp, input, '\n');
+    strip(input);
+    fname[0] = '\0';
+    if (sscanf(input, "%s %d", fname, &Memory_Report_Top) < 1 ||
+	Memory_Report_Top < 1) {
+      EH( -1, "ERROR reading Memory Report File card, expected a file name and an optional number of sites");
+    }
+    if (strcasecmp(fname, "NONE") && strcasecmp(fname, "NO")) {
+      strcpy(Memory_Report_File, fname);
+    }
+    SPF(echo_string, "%s = %s %d", "Memory Report File",
+	Memory_Report_File, Memory_Report_Top);
+    ECHO(echo_string, echo_file);
+  }
+
+  /*
+   * Optional binary dump of the N-th linear system solved, and the
+   * replay of such a dump with the solver of this deck.
+   */
+  Matrix_Replay_Dump_File[0] = '\0';
+  Matrix_Replay_Dump_Count = 1;
+  if (look_for_optional(ifp, "Matrix Replay Dump", input, '=') == 1) {
+    char fname[MAX_FNL];
+    read_string(ifp, input, '\n');
+    strip(input);
+    fname[0] = '\0';
+    if (sscanf(input, "%s %d", fname, &Matrix_Replay_Dump_Count) < 1 ||
+	Matrix_Replay_Dump_Count < 1) {
+      EH( -1, "ERROR reading Matrix Replay Dump card, expected a file name and an optional positive solve number");
+    }
+    if (strcasecmp(fname, "NONE") && strcasecmp(fname, "NO")) {
+      strcpy(Matrix_Replay_Dump_File, fname);
+    }
+    SPF(echo_string, "%s = %s %d", "Matrix Replay Dump",
+	Matrix_Replay_Dump_File, Matrix_Replay_Dump_Count);
+    ECHO(echo_string, echo_file);
+  }
+
+  Matrix_Replay_File[0] = '\0';
+  if (look_for_optional(ifp, "Matrix Replay File", input, '=') == 1) {
+    read_string(ifp, input, '\n');
+    strip(input);
+    if (strcasecmp(input, "NONE") && strcasecmp(input, "NO")) {
+      strcpy(Matrix_Replay_File, input);
+    }
+    SPF(echo_string, eoformat, "Matrix Replay File", Matrix_Replay_File);
+    ECHO(echo_string, echo_file);
+  }
+
   /*
    *   look_for Optional Domain mapping file, the usage of the default
    *   will be indicated by the null character string in the name.
@@ -755,6 +1012,192 @@ rd_file_specs(FILE *ifp,
       EH( -1, "Bad specification for intermediate results");
     }
   }
+
+  /*
+   * The results file is kept open between writes and flushed every
+   * Exo_Flush_Interval output steps; 0 opens and closes it on every write.
+   */
+  if (look_for_optional(ifp, "Exodus Flush Interval", input, '=') == 1) {
+    if (fscanf(ifp, "%d", &Exo_Flush_Interval) != 1 || Exo_Flush_Interval < 0)
+      {
+	EH( -1, "ERROR reading Exodus Flush Interval card, expected a non-negative integer");
+      }
+    SPF(echo_string, "%s = %d", "Exodus Flush Interval", Exo_Flush_Interval);
+    ECHO(echo_string, echo_file);
+  }
+
+  /*
+   * Results may be handed to a background writer thread, with at most
+   * Async_Output_Memory MB waiting to be written; 0 writes them in line.
+   */
+  if (look_for_optional(ifp, "Asynchronous Output Memory", input, '=') == 1) {
+    if (fscanf(ifp, "%d", &Async_Output_Memory) != 1 || Async_Output_Memory < 0)
+      {
+	EH( -1, "ERROR reading Asynchronous Output Memory card, expected a non-negative integer (MB)");
+      }
+#ifndef GOMA_ASYNC_OUTPUT
+    if (Async_Output_Memory > 0) {
+      WH(-1, "Asynchronous Output Memory needs goma built with GOMA_ASYNC_OUTPUT, writing synchronously");
+      Async_Output_Memory = 0;
+    }
+#endif
+    SPF(echo_string, "%s = %d", "Asynchronous Output Memory", Async_Output_Memory);
+    ECHO(echo_string, echo_file);
+  }
+
+  /*
+   * Each output step may also go to an in situ Catalyst pipeline, run by
+   * the named script in the Catalyst implementation chosen.
+   */
+  if (look_for_optional(ifp, "Catalyst Script", input, '=') == 1) {
+    if (fscanf(ifp, "%s", Catalyst_Script) != 1)
+      {
+	EH( -1, "ERROR reading Catalyst Script card, expected a file name");
+      }
+#ifndef GOMA_CATALYST
+    WH(-1, "Catalyst Script needs goma built with GOMA_CATALYST, no in situ output");
+#endif
+    SPF(echo_string, "%s = %s", "Catalyst Script", Catalyst_Script);
+    ECHO(echo_string, echo_file);
+#ifndef GOMA_CATALYST
+    Catalyst_Script[0] = '\0';
+#endif
+  }
+
+  if (look_for_optional(ifp, "Catalyst Implementation", input, '=') == 1) {
+    if (fscanf(ifp, "%s", Catalyst_Implementation) != 1)
+      {
+	EH( -1, "ERROR reading Catalyst Implementation card, expected a name");
+      }
+    SPF(echo_string, "%s = %s", "Catalyst Implementation", Catalyst_Implementation);
+    ECHO(echo_string, echo_file);
+  }
+
+  /*
+   * Running Statistics = <name> ... : time averages, variances and
+   * extrema of these nodal solution variables, kept over every step.
+   */
+  if (look_for_optional(ifp, "Running Statistics", input, '=') == 1) {
+    (void) read_string(ifp, input, '\n');
+    strip(input);
+    if (input[0] == '\0')
+      {
+	EH( -1, "ERROR reading Running Statistics card, expected nodal variable names");
+      }
+    strncpy(Running_Statistics, input, MAX_CHAR_IN_INPUT - 1);
+    SPF(echo_string, "%s = %s", "Running Statistics", Running_Statistics);
+    ECHO(echo_string, echo_file);
+  }
+
+  /*
+   * A results file written as NetCDF-4 (HDF5) may be deflated, optionally
+   * after a byte shuffle; keeping fewer significant digits in the values
+   * trades precision for a much better ratio.
+   */
+  if (look_for_optional(ifp, "Output Compression Level", input, '=') == 1) {
+    if (fscanf(ifp, "%d", &Output_Compression_Level) != 1 ||
+	Output_Compression_Level < 0 || Output_Compression_Level > 9)
+      {
+	EH( -1, "ERROR reading Output Compression Level card, expected an integer 0-9");
+      }
+    (void) read_string(ifp, input, '\n');
+    strip(input);
+    Output_Compression_Shuffle = (strcasecmp(input, "shuffle") == 0);
+    SPF(echo_string, "%s = %d %s", "Output Compression Level", Output_Compression_Level,
+	Output_Compression_Shuffle ? "shuffle" : "");
+    ECHO(echo_string, echo_file);
+  }
+
+  if (look_for_optional(ifp, "Output Significant Digits", input, '=') == 1) {
+    if (fscanf(ifp, "%d", &Output_Significant_Digits) != 1 ||
+	Output_Significant_Digits < 0 || Output_Significant_Digits > 15)
+      {
+	EH( -1, "ERROR reading Output Significant Digits card, expected an integer 0-15");
+      }
+    SPF(echo_string, "%s = %d", "Output Significant Digits", Output_Significant_Digits);
+    ECHO(echo_string, echo_file);
+  }
+
+  /*
+   * Output subsets, one card per results variable:
+   *
+   *   Output Subset = <name> [STRIDE <n>] [BLOCK <id> ... | NODESET <id> ... |
+   *                           BOX <xmin> <xmax> <ymin> <ymax> [<zmin> <zmax>]]
+   */
+  Num_Output_Subsets = 0;
+  if (look_for_optional(ifp, "Number of Output Subsets", input, '=') == 1) {
+    char *tok, subset_err[MAX_CHAR_IN_INPUT];
+    struct Output_Subset *os;
+    int nsub, ibox;
+
+    if (fscanf(ifp, "%d", &nsub) != 1)
+      {
+	EH( -1, "ERROR reading Number of Output Subsets card");
+      }
+    if (nsub == -1) {
+      nsub = count_list(ifp, "Output Subset", input, '=', "END OF OUTPUT SUBSETS");
+    }
+    if (nsub < 0 || nsub > MAX_OUTPUT_SUBSETS) {
+      SPF(subset_err, "Number of Output Subsets must be 0-%d", MAX_OUTPUT_SUBSETS);
+      EH( -1, subset_err);
+    }
+    SPF(echo_string, "%s = %d", "Number of Output Subsets", nsub);
+    ECHO(echo_string, echo_file);
+
+    for (Num_Output_Subsets = 0; Num_Output_Subsets < nsub; Num_Output_Subsets++) {
+      os = Output_Subsets + Num_Output_Subsets;
+      memset(os, 0, sizeof(struct Output_Subset));
+      os->stride = 1;
+      os->region = OUTPUT_SUBSET_ALL;
+
+      look_for(ifp, "Output Subset", input, '=');
+      (void) read_string(ifp, input, '\n');
+      strip(input);
+      SPF(echo_string, "%s = %s", "Output Subset", input);
+
+      tok = strtok(input, " \t");
+      if (tok == NULL) EH( -1, "ERROR reading Output Subset card, expected a variable name");
+      strncpy(os->var_name, tok, MAX_VAR_NAME_LNGTH-1);
+      ibox = 0;
+      for (tok = strtok(NULL, " \t"); tok != NULL; tok = strtok(NULL, " \t")) {
+	if (strcasecmp(tok, "STRIDE") == 0) {
+	  tok = strtok(NULL, " \t");
+	  if (tok == NULL || (os->stride = atoi(tok)) < 1) {
+	    EH( -1, "ERROR reading Output Subset card, STRIDE needs a positive integer");
+	  }
+	} else if (strcasecmp(tok, "BLOCK") == 0) {
+	  os->region = OUTPUT_SUBSET_BLOCK;
+	} else if (strcasecmp(tok, "NODESET") == 0) {
+	  os->region = OUTPUT_SUBSET_NODESET;
+	} else if (strcasecmp(tok, "BOX") == 0) {
+	  os->region = OUTPUT_SUBSET_BOX;
+	  os->box[4] = -1.e+300;
+	  os->box[5] = 1.e+300;
+	} else if (os->region == OUTPUT_SUBSET_BOX && ibox < 6) {
+	  os->box[ibox++] = atof(tok);
+	} else if ((os->region == OUTPUT_SUBSET_BLOCK ||
+		    os->region == OUTPUT_SUBSET_NODESET) && os->num_ids < MAX_SUBSET_IDS) {
+	  os->ids[os->num_ids++] = atoi(tok);
+	} else {
+	  SPF(subset_err, "ERROR reading Output Subset card for %s at \"%s\"",
+	      os->var_name, tok);
+	  EH( -1, subset_err);
+	}
+      }
+      if (os->region == OUTPUT_SUBSET_BOX && ibox != 4 && ibox != 6) {
+	SPF(subset_err, "Output Subset %s: BOX needs 4 (2D) or 6 (3D) coordinates",
+	    os->var_name);
+	EH( -1, subset_err);
+      }
+      if ((os->region == OUTPUT_SUBSET_BLOCK || os->region == OUTPUT_SUBSET_NODESET) &&
+	  os->num_ids == 0) {
+	SPF(subset_err, "Output Subset %s: BLOCK or NODESET needs at least one id",
+	    os->var_name);
+	EH( -1, subset_err);
+      }
+      ECHO(echo_string, echo_file);
+    }
+  }
   
 
 }
@@ -1200,6 +1643,29 @@ rd_genl_specs(FILE *ifp,
   efv->Num_external_field = Num_Var_External;
   efv->Num_external_pixel_field = Num_Var_External_pix;
 
+  /*
+   * Interpolate the External Fields from their own meshes even when they
+   * have as many nodes as this one. The cards around this one are read
+   * in order, so the search leaves the file where it was.
+   */
+  Ext_Field_Donor_Mesh = FALSE;
+  {
+    fpos_t file_position;
+    fgetpos(ifp, &file_position);
+    if (look_for_optional(ifp, "External Field Donor Mesh", input, '=') == 1) {
+      read_string(ifp, input, '\n');
+      strip(input);
+      if (strcasecmp(input, "yes") == 0 || strcasecmp(input, "on") == 0) {
+	Ext_Field_Donor_Mesh = TRUE;
+      } else if (strcasecmp(input, "no") && strcasecmp(input, "off")) {
+	EH(-1, "Expected External Field Donor Mesh = {yes | no}");
+      }
+      SPF(echo_string, eoformat, "External Field Donor Mesh", input);
+      ECHO(echo_string, echo_file);
+    }
+    fsetpos(ifp, &file_position);
+  }
+
 
   /*
    * Read export variable cards
@@ -1390,6 +1856,37 @@ rd_timeint_specs(FILE *ifp,
      stab problems.  Needed once PRS started using tran
      structure as a global variable for poroelastic probs */
   tran->theta = 0.0;
+  tran->bdf_max_order = 0;
+  tran->ts_controller = TS_CONTROL_ELEMENTARY;
+  tran->ts_reject_growth = TIME_STEP_GROWTH_CAP;
+  tran->ts_newton_target = 0;
+  tran->multirate_subcycles = 1;
+  tran->multirate_num_blocks = 0;
+  tran->ptc_delta_t0 = 0.0;
+  tran->ptc_delta_t_max = 1.e12;
+  tran->ptc_max_steps = 100;
+  tran->explicit_cfl = 0.0;
+
+  /*
+   * Pseudo Transient = <delta_t0> [<max steps> [<delta_t max>]]
+   *
+   * Steady problems only: pseudo time steps, grown by switched evolution
+   * relaxation, lead the steady Newton solve in.
+   */
+  if (TimeIntegration == STEADY &&
+      look_for_optional(ifp, "Pseudo Transient", input, '=') == 1) {
+    (void) read_string(ifp, input, '\n');
+    strip(input);
+    i = sscanf(input, "%lf %d %lf", &tran->ptc_delta_t0, &tran->ptc_max_steps,
+	       &tran->ptc_delta_t_max);
+    if (i < 1 || tran->ptc_delta_t0 <= 0.0 || tran->ptc_max_steps < 1 ||
+	tran->ptc_delta_t_max < tran->ptc_delta_t0) {
+      EH( -1, "Expected Pseudo Transient = <delta_t0> [<max steps> [<delta_t max>]]");
+    }
+    SPF(echo_string, "%s = %g %d %g", "Pseudo Transient", tran->ptc_delta_t0,
+	tran->ptc_max_steps, tran->ptc_delta_t_max);
+    ECHO(echo_string, echo_file);
+  }
 
   /* set default frequency to 0 */
   tran->fix_freq = 0;
@@ -1459,6 +1956,15 @@ rd_timeint_specs(FILE *ifp,
 
     SPF(echo_string,"%s = %.4g", "Time step parameter",tran->theta); ECHO(echo_string, echo_file);
 
+    iread = look_for_optional(ifp,"BDF Maximum Order",input,'=');
+    if (iread == 1) {
+      tran->bdf_max_order = read_int(ifp, "BDF Maximum Order");
+      if (tran->bdf_max_order < 0 || tran->bdf_max_order > MAX_BDF_ORDER) {
+	EH(-1, "BDF Maximum Order must be from 1 to 5, or 0 for the Time step parameter");
+      }
+      SPF(echo_string,"%s = %d", "BDF Maximum Order", tran->bdf_max_order); ECHO(echo_string, echo_file);
+    }
+
     look_for(ifp,"Time step error",input,'=');
     if(fscanf(ifp, "%le", &eps) != 1 )
       {
@@ -1496,6 +2002,76 @@ rd_timeint_specs(FILE *ifp,
 	tran->use_var_norm[5], tran->use_var_norm[7],
 	tran->use_var_norm[8], tran->use_var_norm[9]); ECHO(echo_string, echo_file);
 
+    /*
+     * Time Step Controller = {elementary | pi | h211b}
+     *                        [<dt ratio after a rejection> [<Newton steps>]]
+     */
+    iread = look_for_optional(ifp,"Time Step Controller",input,'=');
+    if (iread == 1) {
+      char ts_name[MAX_CHAR_IN_INPUT];
+      int ns;
+
+      read_line(ifp, input, FALSE);
+      ns = sscanf(input, "%s %le %d", ts_name, &tran->ts_reject_growth,
+		  &tran->ts_newton_target);
+      if (ns < 1) {
+	EH(-1, "error reading Time Step Controller, expected elementary, pi or h211b");
+      }
+      if (strcasecmp(ts_name, "elementary") == 0) {
+	tran->ts_controller = TS_CONTROL_ELEMENTARY;
+      } else if (strcasecmp(ts_name, "pi") == 0) {
+	tran->ts_controller = TS_CONTROL_PI;
+      } else if (strcasecmp(ts_name, "h211b") == 0) {
+	tran->ts_controller = TS_CONTROL_H211B;
+      } else {
+	EH(-1, "Time Step Controller must be elementary, pi or h211b");
+      }
+      if (ns < 2) {
+	tran->ts_reject_growth = (tran->ts_controller == TS_CONTROL_ELEMENTARY) ?
+	  TIME_STEP_GROWTH_CAP : 1.0;
+      }
+      if (ns < 3) tran->ts_newton_target = 0;
+      if (tran->ts_reject_growth <= 0.) {
+	EH(-1, "Time Step Controller: the dt ratio after a rejection must be positive");
+      }
+      SPF(echo_string,"%s = %s %.4g %d", "Time Step Controller", ts_name,
+	  tran->ts_reject_growth, tran->ts_newton_target); ECHO(echo_string, echo_file);
+    }
+
+    /*
+     * Multirate Subcycles = <substeps> {shell | <block id> ...}
+     *   the unknowns that live only in these element blocks take this
+     *   many substeps per time step, after the others have taken it
+     */
+    iread = look_for_optional(ifp,"Multirate Subcycles",input,'=');
+    if (iread == 1) {
+      char *tok;
+
+      read_line(ifp, input, FALSE);
+      tok = strtok(input, " \t");
+      if (tok == NULL || sscanf(tok, "%d", &tran->multirate_subcycles) != 1 ||
+	  tran->multirate_subcycles < 1) {
+	EH(-1, "error reading Multirate Subcycles, expected a positive number of substeps");
+      }
+      SPF(echo_string,"%s = %d", "Multirate Subcycles", tran->multirate_subcycles);
+      while ((tok = strtok(NULL, " \t")) != NULL) {
+	if (tran->multirate_num_blocks == MAX_MULTIRATE_BLOCKS) {
+	  EH(-1, "Multirate Subcycles: too many element blocks, raise MAX_MULTIRATE_BLOCKS");
+	}
+	if (strcasecmp(tok, "shell") == 0) {
+	  tran->multirate_block_id[tran->multirate_num_blocks] = MULTIRATE_SHELL;
+	} else if (sscanf(tok, "%d", &tran->multirate_block_id[tran->multirate_num_blocks]) != 1) {
+	  EH(-1, "Multirate Subcycles: expected shell or element block ids after the substeps");
+	}
+	tran->multirate_num_blocks++;
+	SPF(endofstring(echo_string)," %s", tok);
+      }
+      if (tran->multirate_num_blocks == 0) {
+	EH(-1, "Multirate Subcycles: name the fast element blocks, or shell");
+      }
+      ECHO(echo_string, echo_file);
+    }
+
     look_for(ifp,"Printing Frequency",input,'=');
     print_freq = read_int(ifp, "Printing Frequency");
     tran->print_freq = print_freq;
@@ -1563,6 +2139,22 @@ rd_timeint_specs(FILE *ifp,
 	}
       SPF(echo_string,"%s = %.4g","Courant Number Limit",tran->Courant_Limit); ECHO(echo_string, echo_file);
     }
+
+    /*
+     * Explicit Dynamics = <fraction of the stable step>
+     *
+     * Central differences with a lumped mass for dynamic Lagrangian
+     * solids, in place of Newmark and the Newton iteration.
+     */
+    iread = look_for_optional(ifp,"Explicit Dynamics",input,'=');
+    if (iread == 1) {
+      if ( fscanf(ifp,"%le",&tran->explicit_cfl) != 1 ||
+	   tran->explicit_cfl <= 0. || tran->explicit_cfl > 1.)
+	{
+	  EH( -1, "Expected Explicit Dynamics = <fraction of the stable step, 0 to 1>");
+	}
+      SPF(echo_string,"%s = %.4g","Explicit Dynamics",tran->explicit_cfl); ECHO(echo_string, echo_file);
+    }
     
     tran->Restart_Time_Integ_After_Renorm = TRUE;
     iread = look_for_optional(ifp,"Restart Time Integration After Renormalization",input,'=');
@@ -1630,16 +2222,73 @@ rd_timeint_specs(FILE *ifp,
       SPF(echo_string,"%s = %.4g", "Time step decelerator",tran->time_step_decelerator);ECHO(echo_string, echo_file);
     }
 
-#ifndef COUPLED_FILL
-    tran->exp_subcycle = 10;
-    iread = look_for_optional(ifp,"Fill Subcycle",input,'=');
-    if (iread == 1) {   
-      if ( fscanf(ifp,"%d",&(tran->exp_subcycle) ) != 1)
-	{
-	  EH( -1, "error reading Fill Subcycle");
-	}
-      SPF(echo_string,"%s = %d","Fill Subcycle", tran->exp_subcycle); ECHO(echo_string, echo_file);
-    }
+    /*
+     * Keep the last few accepted time steps in memory, so that a time
+     * step that cannot be taken even at the minimum time step can be
+     * retried from an earlier one.
+     */
+    tran->ckpt_depth = 0;
+    tran->ckpt_max_rollbacks = 0;
+    iread = look_for_optional(ifp,"Checkpoint Ring",input,'=');
+    if (iread == 1) {
+      read_string(ifp,input,'\n');
+      strip(input);
+      if (sscanf(input, "%d %d", &tran->ckpt_depth,
+		 &tran->ckpt_max_rollbacks) < 1 || tran->ckpt_depth < 0) {
+	EH(-1, "Expected Checkpoint Ring = <depth> [max_rollbacks]");
+      }
+      if (tran->ckpt_depth > 0 && tran->ckpt_max_rollbacks <= 0) {
+	tran->ckpt_max_rollbacks = tran->ckpt_depth;
+      }
+      SPF(echo_string,"%s = %d %d", "Checkpoint Ring", tran->ckpt_depth,
+	  tran->ckpt_max_rollbacks); ECHO(echo_string, echo_file);
+    }
+
+    /*
+     * Write the same state to a file every so many wall seconds, and
+     * start from such a file.
+     */
+    Checkpoint_File[0] = '\0';
+    Checkpoint_Interval = 3600.;
+    iread = look_for_optional(ifp,"Checkpoint File",input,'=');
+    if (iread == 1) {
+      char fname[MAX_FNL];
+      read_string(ifp,input,'\n');
+      strip(input);
+      fname[0] = '\0';
+      if (sscanf(input, "%s %lf", fname, &Checkpoint_Interval) < 1 ||
+	  Checkpoint_Interval < 0.) {
+	EH(-1, "Expected Checkpoint File = <file> [interval_seconds]");
+      }
+      if (strcasecmp(fname, "NONE") && strcasecmp(fname, "NO")) {
+	strcpy(Checkpoint_File, fname);
+      }
+      SPF(echo_string,"%s = %s %g", "Checkpoint File", Checkpoint_File,
+	  Checkpoint_Interval); ECHO(echo_string, echo_file);
+    }
+
+    Checkpoint_Restart_File[0] = '\0';
+    iread = look_for_optional(ifp,"Checkpoint Restart File",input,'=');
+    if (iread == 1) {
+      read_string(ifp,input,'\n');
+      strip(input);
+      if (strcasecmp(input, "NONE") && strcasecmp(input, "NO")) {
+	strcpy(Checkpoint_Restart_File, input);
+      }
+      SPF(echo_string, eoformat, "Checkpoint Restart File",
+	  Checkpoint_Restart_File); ECHO(echo_string, echo_file);
+    }
+
+#ifndef COUPLED_FILL
+    tran->exp_subcycle = 10;
+    iread = look_for_optional(ifp,"Fill Subcycle",input,'=');
+    if (iread == 1) {   
+      if ( fscanf(ifp,"%d",&(tran->exp_subcycle) ) != 1)
+	{
+	  EH( -1, "error reading Fill Subcycle");
+	}
+      SPF(echo_string,"%s = %d","Fill Subcycle", tran->exp_subcycle); ECHO(echo_string, echo_file);
+    }
 #endif /* not COUPLED_FILL */
 
     tran->Fill_Weight_Fcn = FILL_WEIGHT_TG;
@@ -2035,6 +2684,24 @@ rd_levelset_specs(FILE *ifp,
                   ls->Mass_Sign  = I_NEG_FILL;
                 }                 
             }
+          else if  ( strcmp( input,"Fast_Marching") == 0 )
+            {
+              ls->Renorm_Method = FAST_MARCH;
+
+	      strcat(echo_string, "Fast_Marching");
+
+              if( fscanf( ifp,"%lf", &(ls->Renorm_Band)) == 1) 
+                {
+		  char *s = endofstring(echo_string);
+
+                  ls->Renorm_Band = fabs( ls->Renorm_Band );
+		  SPF(s," %.4g",ls->Renorm_Band);
+                }
+              else
+                {
+                  ls->Renorm_Band = 0.0;
+                }
+            }
           else if  ( ( strcmp( input,"None") == 0 ) ||  (strcmp( input,"No") == 0) )
             {
               ls->Renorm_Method = FALSE;
@@ -2125,6 +2792,21 @@ rd_levelset_specs(FILE *ifp,
 
 	  SPF(echo_string,eoformat,"Force Initial Level Set Renormalization", input); ECHO(echo_string,echo_file);
         }
+
+      ls->Narrow_Band = 0;  /* Default is to assemble every element */
+      iread = look_for_optional(ifp,"Level Set Narrow Band",input,'=');
+      if ( iread == 1 )
+        {
+          if( fscanf( ifp,"%d", &(ls->Narrow_Band) ) != 1 || ls->Narrow_Band < 0 )
+            {
+              EH(-1,"Error reading Level Set Narrow Band layers.\n");
+            }
+#ifdef COUPLED_FILL
+          WH(-1,"Level Set Narrow Band only applies to the segregated fill solve.\n");
+#endif
+
+	  SPF(echo_string,"%s = %d","Level Set Narrow Band", ls->Narrow_Band); ECHO(echo_string,echo_file);
+        }
 	
       ls->Initial_LS_Displacement = 0.;
       iread = look_for_optional(ifp,"Initial Level Set Displacement",input,'=');
@@ -2284,6 +2966,35 @@ rd_levelset_specs(FILE *ifp,
 	  SPF(echo_string,eoformat,"Level Set Semi_Lagrange", input); ECHO(echo_string,echo_file);
         }
 
+      ls->Lumped_Courant = 0.5;
+      iread = look_for_optional(ifp,"Level Set Lumped Explicit",input,'=');
+      if (iread == 1)
+        {
+          char yes_no[MAX_CHAR_IN_INPUT];
+
+          (void) read_string(ifp, input, '\n');
+          strip(input);
+          if ( sscanf(input, "%s %lf", yes_no, &(ls->Lumped_Courant) ) < 1 ||
+               ls->Lumped_Courant <= 0.0 )
+            {
+              EH(-1, "Need YES/NO and an optional positive Courant number for Level Set Lumped Explicit card.\n");
+            }
+          stringup(yes_no);
+
+          if( strcmp(yes_no, "YES" ) == 0 ||
+              strcmp(yes_no, "ON"  ) == 0 ||
+              strcmp(yes_no, "TRUE" ) == 0)
+            {
+#ifdef COUPLED_FILL
+	      EH(-1, "Level Set Lumped Explicit not supported for COUPLED_FILL.");
+#else
+              ls->Evolution = LS_EVOLVE_ADVECT_LUMPED;
+#endif
+            }
+	  SPF(echo_string,"%s = %s %.4g","Level Set Lumped Explicit", yes_no,
+	      ls->Lumped_Courant); ECHO(echo_string,echo_file);
+        }
+
       ls->Search_Option = SEGMENT_SEARCH;
       ls->Grid_Search_Depth = 0;
 
@@ -2336,6 +3047,7 @@ rd_levelset_specs(FILE *ifp,
       }
 
       ls->SubElemIntegration = FALSE;
+      ls->SubElem_Cache_Tol = 0.;
       iread = look_for_optional(ifp,"Level Set Subelement Integration",input,'=');
       if (iread == 1)
         {
@@ -2354,7 +3066,14 @@ rd_levelset_specs(FILE *ifp,
                 EH(-1,"I don't think it makes sense to have subelement integration and non-zero length scale.");
             }
 
-	  SPF(echo_string,eoformat,"Level Set Subelement Integration", input); ECHO(echo_string,echo_file);
+	  SPF(echo_string,eoformat,"Level Set Subelement Integration", input);
+
+          if ( ls->SubElemIntegration &&
+               fscanf( ifp, "%lf", &(ls->SubElem_Cache_Tol) ) == 1 )
+            {
+              SPF(endofstring(echo_string)," %.4g", ls->SubElem_Cache_Tol);
+            }
+          ECHO(echo_string,echo_file);
         }
 
       ls->AdaptIntegration = FALSE;
@@ -2392,6 +3111,31 @@ rd_levelset_specs(FILE *ifp,
 	SPF(echo_string,"%s = %d", "Level Set Adaptive Order", ls->Adaptive_Order); ECHO(echo_string,echo_file);
       }
 
+      /*
+       * Curvature and normal of the level set as unknowns of their own
+       * equations, or projected explicitly from F each iteration.
+       */
+      ls->Curvature_Projection = LS_CURV_PROJ_COUPLED;
+      iread = look_for_optional(ifp,"Level Set Curvature Projection",input,'=');
+      if (iread == 1)
+        {
+          if (fscanf(ifp, "%s", input ) != 1 )
+             {
+               EH(-1, "Error reading Level Set Curvature Projection.");
+             }
+          strip(input); stringup(input);
+
+          if (strcmp(input,"LUMPED") == 0)
+            {
+              ls->Curvature_Projection = LS_CURV_PROJ_LUMPED;
+            }
+          else if (strcmp(input,"COUPLED") != 0)
+            {
+              EH(-1,"Expected Level Set Curvature Projection = {coupled | lumped}");
+            }
+	  SPF(echo_string,eoformat,"Level Set Curvature Projection", input); ECHO(echo_string,echo_file);
+        }
+
         
       ls->CrossMeshQuadPoints = 0;
       iread = look_for_optional(ifp,"Overlap Quadrature Points",input,'=');
@@ -2487,6 +3231,7 @@ rd_levelset_specs(FILE *ifp,
 	      if (ls) {
 		pfd->ls[i]->Integration_Depth = ls->Integration_Depth;
 		pfd->ls[i]->SubElemIntegration = ls->SubElemIntegration;
+		pfd->ls[i]->SubElem_Cache_Tol = ls->SubElem_Cache_Tol;
 		pfd->ls[i]->AdaptIntegration = ls->AdaptIntegration;   	   
 		pfd->ls[i]->Contact_Inflection = ls->Contact_Inflection;
 		pfd->ls[i]->Ignore_F_deps = ls->Ignore_F_deps;
@@ -2664,7 +3409,7 @@ if( pfd != NULL ) {
 	if (iread == 1) 
 	{   
 		int method=0, Mass_Sign = I_NEG_FILL;
-		double Mass_Value = 0;
+		double Mass_Value = 0, Band = 0;
 		
 		if ( fscanf(ifp,"%s",input) != 1)
 		{
@@ -2679,6 +3424,12 @@ if( pfd != NULL ) {
 		{
 			method = HUYGENS_C;
 		}
+		else if ( strcmp( input,"Fast_Marching") == 0 )
+		{
+			method = FAST_MARCH;
+			if ( fscanf(ifp,"%lf", &Band) != 1 ) Band = 0.;
+			Band = fabs(Band);
+		}
 		else if ( ( strcmp( input,"No") == 0) || ( strcmp( input,"None") == 0) )
 		{
 			method = FALSE;
@@ -2698,6 +3449,7 @@ if( pfd != NULL ) {
 			pfd->ls[i]->Renorm_Method = method;
 			pfd->ls[i]->Mass_Value = Mass_Value;
 			pfd->ls[i]->Mass_Sign = Mass_Sign;
+			pfd->ls[i]->Renorm_Band = Band;
 		}
 		SPF(echo_string,eoformat,"Phase Function Renormalization Method", input); ECHO(echo_string,echo_file);
 	}
@@ -2798,6 +3550,8 @@ rd_elem_quality_specs(FILE *ifp,
                       char *input )
 {
   const char yo[] = "rd_elem_quality_specs";
+  char echo_string[MAX_CHAR_ECHO_INPUT]="\0";
+  char *echo_file = Echo_Input_File;
   
   int iread;
   nEQM = 0;
@@ -2943,6 +3697,27 @@ rd_elem_quality_specs(FILE *ifp,
     {
       eqm->tol_type = EQM_MIN;
     }
+
+  eqm->incremental = FALSE;
+  eqm->inc_margin = 1.2;
+  eqm->inc_full_every = 0;
+  eqm->jac_sum = 0.0;
+  eqm->jac_low = 9999.9;
+  eqm->jac_count = 0;
+  iread = look_for_optional(ifp,"Element quality incremental",input,'=');
+  if (iread == 1)
+    {
+      (void) read_string(ifp,input,'\n');
+      strip(input);
+      eqm->incremental = TRUE;
+      if ( sscanf(input, "%lf %d", &eqm->inc_margin, &eqm->inc_full_every) < 1 ||
+	   eqm->inc_margin < 1.0 || eqm->inc_full_every < 0 )
+        {
+          EH( -1, "Expected Element quality incremental = <margin >= 1> [full_every]");
+        }
+      SPF(echo_string,"%s = %g %d", "Element quality incremental",
+	  eqm->inc_margin, eqm->inc_full_every); ECHO(echo_string, echo_file);
+    }
 }
 
 /*
@@ -3262,6 +4037,17 @@ rd_track_specs(FILE *ifp,
 	}
       cont->Delta_s_max = Delta_s_max;
 	  SPF(echo_string,"%s = %.4g", input, Delta_s_max); ECHO(echo_string,echo_file);
+
+      /* Predictor error target of the path step control (0 = off) */
+      iread = look_for_optional(ifp,"Path Step Error",input,'=');
+      if (iread == 1)
+	{
+	  if ( fscanf(ifp,"%le",&cont->eps) != 1 || cont->eps < 0.)
+	    {
+	      EH( -1, "error reading Path Step Error, expected a value >= 0");
+	    }
+	  SPF(echo_string,"%s = %.4g", input, cont->eps); ECHO(echo_string,echo_file);
+	}
       
       look_for(ifp,"Continuation Printing Frequency",input,'=');
       if ( fscanf(ifp,"%d",&print_freq) != 1)
@@ -4659,6 +5445,25 @@ rd_hunt_specs(FILE *ifp,
       cont->Delta_s_max = hunt[0].Delta_s_max;
     }
 
+  /* Zeroth order hunting can start each step from the secant through
+   * the last two converged solutions instead of the last one */
+  cont->hunt_secant = FALSE;
+  iread = look_for_optional(ifp, "Hunt Secant Predictor", input, '=');
+  if (iread == 1)
+    {
+      SPF(echo_string,"%s =", input);
+      (void) read_string(ifp, input, '\n');
+      strip(input);
+      if (strcmp(input, "yes") == 0)
+        {
+          cont->hunt_secant = TRUE;
+        }
+      else if (strcmp(input, "no") != 0)
+        {
+          EH(-1, "Hunt Secant Predictor must be yes or no");
+        }
+      SPF(endofstring(echo_string)," %s", input); ECHO(echo_string,echo_file);
+    }
 }
 /* rd_hunt_specs -- read input file for hunting specifications */
 /*****************************************************************************/
@@ -4698,6 +5503,7 @@ rd_ac_specs(FILE *ifp,
   int nAC1;
   int do_alc = FALSE;
   char string[MAX_FNL];
+  fpos_t ac_pos;
 
   double z[MAX_CONC];        /* species charge number       */
   const double F = 96487.0;  /* Faraday's constant in C/mol */
@@ -4797,6 +5603,29 @@ rd_ac_specs(FILE *ifp,
     SPF(echo_string,eoformat, "Augmenting Conditions Initial Guess", input); ECHO(echo_string,echo_file);
     }
 
+  /* anywhere in the file, without moving on from where the ACs are read */
+  AC_Sensitivity_Forward = FALSE;
+  fgetpos(ifp, &ac_pos);
+  iread = look_for_optional(ifp,"Augmenting Conditions Sensitivity",input,'=');
+  if(iread == 1)
+    {
+      if ( fscanf( ifp,"%s",string) != 1 )
+	{
+	  EH(-1, "error reading Augmenting Conditions Sensitivity");
+	}
+      strip(string);
+      if ( strcmp(string,"forward") == 0 )
+	{
+	  AC_Sensitivity_Forward = TRUE;
+	}
+      else if ( strcmp(string,"central") != 0 )
+	{
+	  EH(-1, "Augmenting Conditions Sensitivity must be central or forward");
+	}
+      SPF(echo_string,"%s = %s", "Augmenting Conditions Sensitivity", string); ECHO(echo_string,echo_file);
+    }
+  fsetpos(ifp, &ac_pos);
+
 
   augc = alloc_struct_1(struct AC_Information, nAC );
 
@@ -5931,6 +6760,45 @@ rd_solver_specs(FILE *ifp,
     ECHO(echo_string, echo_file);
   }
 
+  /*
+   * Carry the Stratimikos solver, and a recycling Krylov method's
+   * deflation space, from one Newton solve to the next.
+   *   Krylov Recycling = {yes | no}
+   */
+  Krylov_Recycle = FALSE;
+  strcpy(search_string, "Krylov Recycling");
+  iread = look_for_optional(ifp, search_string, input, '=');
+  if (iread == 1) {
+    read_string(ifp, input, '\n');
+    strip(input);
+    if (strcasecmp(input, "yes") == 0 || strcasecmp(input, "on") == 0) {
+      Krylov_Recycle = TRUE;
+    } else if (strcasecmp(input, "no") != 0 && strcasecmp(input, "off") != 0) {
+      EH(-1, "ERROR reading Krylov Recycling card, expected yes or no");
+    }
+    SPF(echo_string, eoformat, search_string, input);
+    ECHO(echo_string, echo_file);
+  }
+
+  /*
+   * Initial guess of the Newton update for Stratimikos solves.
+   *   Krylov Initial Guess = {zero | extrapolate}
+   */
+  Krylov_Guess = FALSE;
+  strcpy(search_string, "Krylov Initial Guess");
+  iread = look_for_optional(ifp, search_string, input, '=');
+  if (iread == 1) {
+    read_string(ifp, input, '\n');
+    strip(input);
+    if (strcasecmp(input, "extrapolate") == 0) {
+      Krylov_Guess = TRUE;
+    } else if (strcasecmp(input, "zero") != 0) {
+      EH(-1, "ERROR reading Krylov Initial Guess card, expected zero or extrapolate");
+    }
+    SPF(echo_string, eoformat, search_string, input);
+    ECHO(echo_string, echo_file);
+  }
+
   strcpy(search_string, "Preconditioner");
 
   iread = look_for_optional(ifp, search_string, input, '=');
@@ -6017,6 +6885,120 @@ rd_solver_specs(FILE *ifp,
     {
       SPF(echo_string, def_form,search_string, Matrix_Factorization_Reuse , default_string); ECHO(echo_string,echo_file);
     }
+
+  /*
+   * Try a few Aztec methods and preconditioners on the first matrix.
+   *   Linear Solver Autotune = {yes | no} [degrade]
+   */
+  Autotune_Linear_Solver = FALSE;
+  Autotune_Degrade = 3.;
+  iread = look_for_optional(ifp, "Linear Solver Autotune", input, '=');
+  if (iread == 1) {
+    char tune_name[MAX_CHAR_IN_INPUT];
+    (void) read_string(ifp, input, '\n');
+    strip(input);
+    if (sscanf(input, "%s %le", tune_name, &Autotune_Degrade) < 1)
+      {
+	EH( -1, "ERROR reading Linear Solver Autotune card");
+      }
+    if (strcasecmp(tune_name, "yes") == 0 || strcasecmp(tune_name, "on") == 0) {
+      Autotune_Linear_Solver = TRUE;
+    } else if (strcasecmp(tune_name, "no") != 0 &&
+	       strcasecmp(tune_name, "off") != 0) {
+      EH( -1, "ERROR reading Linear Solver Autotune card, expected yes or no");
+    }
+    if (Autotune_Degrade <= 1.)
+      {
+	EH( -1, "ERROR reading Linear Solver Autotune card, degrade must exceed 1");
+      }
+    SPF(echo_string, "%s = %s %.4g", "Linear Solver Autotune", tune_name,
+	Autotune_Degrade);
+    ECHO(echo_string,echo_file);
+  }
+
+  /*
+   * Stronger linear solvers to try, in order, when an Aztec solve fails.
+   *   Linear Solver Fallback = <level> [<level> ...]
+   * with each level one of ilu<k>, ilut<fill>, lu or amesos.
+   */
+  Num_Fallback_Levels = 0;
+  iread = look_for_optional(ifp, "Linear Solver Fallback", input, '=');
+  if (iread == 1) {
+    char *level_name;
+    (void) read_string(ifp, input, '\n');
+    strip(input);
+    SPF(echo_string, "%s = %s", "Linear Solver Fallback", input);
+    for (level_name = strtok(input, " \t"); level_name != NULL;
+	 level_name = strtok(NULL, " \t")) {
+      int t = Num_Fallback_Levels;
+      if (t == MAX_FALLBACK_LEVELS)
+	{
+	  EH( -1, "ERROR reading Linear Solver Fallback card, too many levels");
+	}
+      if (strncasecmp(level_name, "ilut", 4) == 0) {
+	Fallback_Type[t] = FALLBACK_ILUT;
+	if (sscanf(level_name + 4, "%le", &Fallback_Fill[t]) != 1 ||
+	    Fallback_Fill[t] <= 0.)
+	  {
+	    EH( -1, "ERROR reading Linear Solver Fallback card, expected ilut<fill>");
+	  }
+      } else if (strncasecmp(level_name, "ilu", 3) == 0) {
+	int k;
+	Fallback_Type[t] = FALLBACK_ILU;
+	if (sscanf(level_name + 3, "%d", &k) != 1 || k < 0)
+	  {
+	    EH( -1, "ERROR reading Linear Solver Fallback card, expected ilu<k>");
+	  }
+	Fallback_Fill[t] = (dbl) k;
+      } else if (strcasecmp(level_name, "lu") == 0) {
+	Fallback_Type[t] = FALLBACK_LU;
+	Fallback_Fill[t] = 0.;
+      } else if (strcasecmp(level_name, "amesos") == 0) {
+#if !(defined(ENABLE_AMESOS) && defined(TRILINOS))
+	EH( -1, "Linear Solver Fallback: amesos needs a build with ENABLE_AMESOS");
+#endif
+	Fallback_Type[t] = FALLBACK_AMESOS;
+	Fallback_Fill[t] = 0.;
+      } else {
+	EH( -1, "ERROR reading Linear Solver Fallback card, unknown level");
+      }
+      Num_Fallback_Levels++;
+    }
+    if (Num_Fallback_Levels == 0)
+      {
+	EH( -1, "ERROR reading Linear Solver Fallback card, no levels");
+      }
+    ECHO(echo_string,echo_file);
+  }
+
+  /*
+   * Reuse the last UMFPACK factors with iterative refinement.
+   *   Direct Solve Refinement = <tolerance> [max steps]
+   */
+  Direct_Refine_Tol = 0.;
+  Direct_Refine_Steps = 5;
+  iread = look_for_optional(ifp, "Direct Solve Refinement", input, '=');
+  if (iread == 1) {
+    (void) read_string(ifp, input, '\n');
+    strip(input);
+    if (sscanf(input, "%le %d", &Direct_Refine_Tol, &Direct_Refine_Steps) < 1)
+      {
+	EH( -1, "ERROR reading Direct Solve Refinement card");
+      }
+    if (Direct_Refine_Tol < 0. || Direct_Refine_Tol >= 1. ||
+	Direct_Refine_Steps < 1)
+      {
+	EH( -1, "ERROR reading Direct Solve Refinement card, need 0 <= tolerance < 1 and steps > 0");
+      }
+    if (Direct_Refine_Tol > 0. &&
+	Linear_Solver != UMFPACK2 && Linear_Solver != UMFPACK2F)
+      {
+	WH( -1, "Direct Solve Refinement only applies to the umf solver");
+      }
+    SPF(echo_string, "%s = %.4g %d", "Direct Solve Refinement",
+	Direct_Refine_Tol, Direct_Refine_Steps);
+    ECHO(echo_string,echo_file);
+  }
   
   strcpy(search_string, "Matrix graph fillin");
   iread = look_for_optional(ifp, search_string, input, '=');
@@ -6282,65 +7264,682 @@ rd_solver_specs(FILE *ifp,
   /* first initialize modified newton parameter to false */
   modified_newton = FALSE;
 
-  look_for(ifp, "Number of Newton Iterations", input, '=');
-  if (fscanf(ifp, "%d", &Max_Newton_Steps) != 1)
-    {
-      EH( -1, "error reading Number of Newton Iterations");
+  look_for(ifp, "Number of Newton Iterations", input, '=');
+  if (fscanf(ifp, "%d", &Max_Newton_Steps) != 1)
+    {
+      EH( -1, "error reading Number of Newton Iterations");
+    }
+  SPF(echo_string,"%s = %d", "Number of Newton Iterations", Max_Newton_Steps);
+
+  if (fscanf(ifp, "%d", &Newt_Jacobian_Reformation_stride) == 1)
+    {
+      if(Newt_Jacobian_Reformation_stride > 1) modified_newton = TRUE;
+
+      SPF(endofstring(echo_string), " %d", Newt_Jacobian_Reformation_stride );
+    }
+  else
+    {
+       Newt_Jacobian_Reformation_stride = 1;
+    }
+
+  ECHO(echo_string,echo_file);
+    
+  iread = look_for_optional(ifp, "Modified Newton Tolerance", input, '=');
+  if (iread == 1) { 
+    if (fscanf(ifp, "%le %le", &convergence_rate_tolerance, &modified_newt_norm_tol) != 2)
+      {
+	EH( -1, "ERROR reading Modified Newton Tolerance card");
+      }
+    else
+      {
+        if (convergence_rate_tolerance != 0. && modified_newt_norm_tol != 0.)
+	  {
+	    modified_newton=TRUE;
+	  }
+	SPF(echo_string,"%s = %.4g %.4g", "Modified Newton Tolerance",convergence_rate_tolerance , modified_newt_norm_tol ); 
+	ECHO(echo_string,echo_file);
+      }
+  }
+  else
+    {
+      convergence_rate_tolerance = 0.;
+      modified_newt_norm_tol = 0.;
+    }
+
+  /*
+   * Inexact Newton: let the linear tolerance follow the nonlinear residual.
+   *   Newton Forcing Term = {none | EW1 | EW2} [eta_max]
+   */
+  Newton_Forcing = NEWTON_FORCING_NONE;
+  Newton_Forcing_Max = 0.9;
+  iread = look_for_optional(ifp, "Newton Forcing Term", input, '=');
+  if (iread == 1) {
+    char forcing_name[MAX_CHAR_IN_INPUT];
+    (void) read_string(ifp, input, '\n');
+    strip(input);
+    if (sscanf(input, "%s %le", forcing_name, &Newton_Forcing_Max) < 1)
+      {
+	EH( -1, "ERROR reading Newton Forcing Term card");
+      }
+    if (strcasecmp(forcing_name, "EW1") == 0) {
+      Newton_Forcing = NEWTON_FORCING_EW1;
+    } else if (strcasecmp(forcing_name, "EW2") == 0) {
+      Newton_Forcing = NEWTON_FORCING_EW2;
+    } else if (strcasecmp(forcing_name, "none") != 0) {
+      EH( -1, "ERROR reading Newton Forcing Term card, expected none, EW1 or EW2");
+    }
+    if (Newton_Forcing_Max <= 0. || Newton_Forcing_Max >= 1.)
+      {
+	EH( -1, "ERROR reading Newton Forcing Term card, eta_max must lie in (0,1)");
+      }
+    SPF(echo_string, "%s = %s %.4g", "Newton Forcing Term", forcing_name,
+	Newton_Forcing_Max);
+    ECHO(echo_string,echo_file);
+  }
+
+  iread = look_for_optional(ifp, "Jacobian Reform Time Stride", input, '=');
+  if (iread == 1) { 
+    if (fscanf(ifp, "%d", &Time_Jacobian_Reformation_stride) != 1)
+      {
+	EH( -1, "ERROR reading Jacobian Reform Stride card");
+      }
+    else
+      {
+	if(Time_Jacobian_Reformation_stride > 1) modified_newton = TRUE;
+	SPF(echo_string, "%s = %d", "Jacobian Reform Time Stride", Time_Jacobian_Reformation_stride);
+	ECHO(echo_string,echo_file);
+      }
+  } 
+  else
+    {
+      Time_Jacobian_Reformation_stride = 0;
+    }
+
+  /*
+   * Adaptive modified Newton: keep the factored Jacobian while it still
+   * contracts the residual well enough.
+   *   Jacobian Reuse = {fixed | adaptive} [rate_max] [max_age] [dt_tol]
+   *                    [omega_tol]
+   * or, when the Jacobian is constant, for as long as the time step is.
+   *   Jacobian Reuse = constant [dt_tol]
+   */
+  Jacobian_Reuse = JACOBIAN_REUSE_FIXED;
+  Jacobian_Reuse_Rate = 0.5;
+  Jacobian_Reuse_Max_Age = 20;
+  Jacobian_Reuse_Dt_Tol = 0.2;
+  Jacobian_Reuse_Omega_Tol = 0.2;
+  iread = look_for_optional(ifp, "Jacobian Reuse", input, '=');
+  if (iread == 1) {
+    char reuse_name[MAX_CHAR_IN_INPUT];
+    (void) read_string(ifp, input, '\n');
+    strip(input);
+    if (sscanf(input, "%s %le %d %le %le", reuse_name, &Jacobian_Reuse_Rate,
+	       &Jacobian_Reuse_Max_Age, &Jacobian_Reuse_Dt_Tol,
+	       &Jacobian_Reuse_Omega_Tol) < 1)
+      {
+	EH( -1, "ERROR reading Jacobian Reuse card");
+      }
+    if (strcasecmp(reuse_name, "adaptive") == 0) {
+      Jacobian_Reuse = JACOBIAN_REUSE_ADAPTIVE;
+      modified_newton = TRUE;
+    } else if (strcasecmp(reuse_name, "constant") == 0) {
+      Jacobian_Reuse = JACOBIAN_REUSE_CONSTANT;
+      modified_newton = TRUE;
+      Jacobian_Reuse_Rate = 0.5;
+      Jacobian_Reuse_Dt_Tol = 1.e-8;
+      (void) sscanf(input, "%s %le", reuse_name, &Jacobian_Reuse_Dt_Tol);
+    } else if (strcasecmp(reuse_name, "fixed") != 0) {
+      EH( -1, "ERROR reading Jacobian Reuse card, expected fixed, adaptive or constant");
+    }
+    if (Jacobian_Reuse_Rate <= 0. || Jacobian_Reuse_Rate >= 1.)
+      {
+	EH( -1, "ERROR reading Jacobian Reuse card, rate_max must lie in (0,1)");
+      }
+    if (Jacobian_Reuse_Max_Age < 1 || Jacobian_Reuse_Dt_Tol < 0. ||
+	Jacobian_Reuse_Omega_Tol < 0.)
+      {
+	EH( -1, "ERROR reading Jacobian Reuse card, need max_age >= 1, dt_tol >= 0 and omega_tol >= 0");
+      }
+    if (Jacobian_Reuse == JACOBIAN_REUSE_CONSTANT) {
+      SPF(echo_string, "%s = %s %.4g", "Jacobian Reuse", reuse_name,
+	  Jacobian_Reuse_Dt_Tol);
+    } else {
+      SPF(echo_string, "%s = %s %.4g %d %.4g %.4g", "Jacobian Reuse", reuse_name,
+	  Jacobian_Reuse_Rate, Jacobian_Reuse_Max_Age, Jacobian_Reuse_Dt_Tol,
+	  Jacobian_Reuse_Omega_Tol);
+    }
+    ECHO(echo_string,echo_file);
+  }
+
+  /*
+   * Quasi-Newton correction of the steps taken with a reused Jacobian.
+   *   Newton Acceleration = {none | broyden | anderson} [m]
+   */
+  Newton_Accel = NEWTON_ACCEL_NONE;
+  Newton_Accel_Depth = 5;
+  iread = look_for_optional(ifp, "Newton Acceleration", input, '=');
+  if (iread == 1) {
+    char accel_name[MAX_CHAR_IN_INPUT];
+    (void) read_string(ifp, input, '\n');
+    strip(input);
+    if (sscanf(input, "%s %d", accel_name, &Newton_Accel_Depth) < 1)
+      {
+	EH( -1, "ERROR reading Newton Acceleration card");
+      }
+    if (strcasecmp(accel_name, "broyden") == 0) {
+      Newton_Accel = NEWTON_ACCEL_BROYDEN;
+    } else if (strcasecmp(accel_name, "anderson") == 0) {
+      Newton_Accel = NEWTON_ACCEL_ANDERSON;
+    } else if (strcasecmp(accel_name, "none") != 0) {
+      EH( -1, "ERROR reading Newton Acceleration card, expected none, broyden or anderson");
+    }
+    if (Newton_Accel_Depth < 1 || Newton_Accel_Depth > MAX_NEWTON_ACCEL_DEPTH)
+      {
+	EH( -1, "ERROR reading Newton Acceleration card, m must lie in 1..10");
+      }
+    if (Newton_Accel != NEWTON_ACCEL_NONE && !modified_newton)
+      {
+	WH( -1, "Newton Acceleration has no effect unless the Jacobian is reused");
+      }
+    SPF(echo_string, "%s = %s %d", "Newton Acceleration", accel_name,
+	Newton_Accel_Depth);
+    ECHO(echo_string,echo_file);
+  }
+
+  /*
+   * Backtracking on the residual norm within each Newton step.
+   *   Newton Line Search = {none | armijo} [alpha] [max_backtracks]
+   */
+  Newton_Line_Search = NEWTON_LINE_SEARCH_NONE;
+  Line_Search_Alpha = 1.e-4;
+  Line_Search_Max_Backtracks = 6;
+  iread = look_for_optional(ifp, "Newton Line Search", input, '=');
+  if (iread == 1) {
+    char search_name[MAX_CHAR_IN_INPUT];
+    (void) read_string(ifp, input, '\n');
+    strip(input);
+    if (sscanf(input, "%s %le %d", search_name, &Line_Search_Alpha,
+	       &Line_Search_Max_Backtracks) < 1)
+      {
+	EH( -1, "ERROR reading Newton Line Search card");
+      }
+    if (strcasecmp(search_name, "armijo") == 0) {
+      Newton_Line_Search = NEWTON_LINE_SEARCH_ARMIJO;
+    } else if (strcasecmp(search_name, "none") != 0) {
+      EH( -1, "ERROR reading Newton Line Search card, expected none or armijo");
+    }
+    if (Line_Search_Alpha <= 0. || Line_Search_Alpha >= 0.5)
+      {
+	EH( -1, "ERROR reading Newton Line Search card, alpha must lie in (0,0.5)");
+      }
+    if (Line_Search_Max_Backtracks < 1)
+      {
+	EH( -1, "ERROR reading Newton Line Search card, need max_backtracks >= 1");
+      }
+    SPF(echo_string, "%s = %s %.4g %d", "Newton Line Search", search_name,
+	Line_Search_Alpha, Line_Search_Max_Backtracks);
+    ECHO(echo_string,echo_file);
+  }
+
+  /*
+   * Jacobian-free products on the steps that reuse a Jacobian.
+   *   Matrix-Free Newton = {no | yes} [delta]
+   */
+  Matrix_Free_Newton = FALSE;
+  Matrix_Free_Delta = 1.e-7;
+  iread = look_for_optional(ifp, "Matrix-Free Newton", input, '=');
+  if (iread == 1) {
+    char jfnk_name[MAX_CHAR_IN_INPUT];
+    (void) read_string(ifp, input, '\n');
+    strip(input);
+    if (sscanf(input, "%s %le", jfnk_name, &Matrix_Free_Delta) < 1)
+      {
+	EH( -1, "ERROR reading Matrix-Free Newton card");
+      }
+    if (strcasecmp(jfnk_name, "yes") == 0 || strcasecmp(jfnk_name, "on") == 0) {
+      Matrix_Free_Newton = TRUE;
+    } else if (strcasecmp(jfnk_name, "no") != 0 && strcasecmp(jfnk_name, "off") != 0) {
+      EH( -1, "ERROR reading Matrix-Free Newton card, expected yes or no");
+    }
+    if (Matrix_Free_Delta <= 0.)
+      {
+	EH( -1, "ERROR reading Matrix-Free Newton card, delta must be positive");
+      }
+    if (Matrix_Free_Newton &&
+	(Linear_Solver != AZTEC || strcmp(Matrix_Format, "msr") != 0))
+      {
+	WH( -1, "Matrix-Free Newton applies only to Solver Type = aztec with msr matrices");
+      }
+    if (Matrix_Free_Newton && !modified_newton)
+      {
+	WH( -1, "Matrix-Free Newton has no effect unless the Jacobian is reused");
+      }
+    SPF(echo_string, "%s = %s %.4g", "Matrix-Free Newton", jfnk_name,
+	Matrix_Free_Delta);
+    ECHO(echo_string,echo_file);
+  }
+
+  /*
+   * A cheaper matrix to precondition the matrix-free products with.
+   *   Preconditioner Matrix = {exact | no_mesh_coupling | decoupled}
+   */
+  Precond_Matrix = PRECOND_MATRIX_EXACT;
+  iread = look_for_optional(ifp, "Preconditioner Matrix", input, '=');
+  if (iread == 1) {
+    char precond_name[MAX_CHAR_IN_INPUT];
+    if (fscanf(ifp, "%s", precond_name) != 1)
+      {
+	EH( -1, "ERROR reading Preconditioner Matrix card");
+      }
+    if (strcasecmp(precond_name, "exact") == 0) {
+      Precond_Matrix = PRECOND_MATRIX_EXACT;
+    } else if (strcasecmp(precond_name, "no_mesh_coupling") == 0) {
+      Precond_Matrix = PRECOND_MATRIX_NO_MESH;
+    } else if (strcasecmp(precond_name, "decoupled") == 0) {
+      Precond_Matrix = PRECOND_MATRIX_DECOUPLED;
+    } else {
+      EH( -1, "ERROR reading Preconditioner Matrix card, expected exact, no_mesh_coupling or decoupled");
+    }
+    if (Precond_Matrix != PRECOND_MATRIX_EXACT && !Matrix_Free_Newton)
+      {
+	EH( -1, "Preconditioner Matrix other than exact needs Matrix-Free Newton = yes");
+      }
+    SPF(echo_string, "%s = %s", "Preconditioner Matrix", precond_name);
+    ECHO(echo_string,echo_file);
+  }
+
+  iread = look_for_optional(ifp, "Assembly Threads", input, '=');
+  if (iread == 1) {
+    char threads_name[MAX_CHAR_IN_INPUT];
+    if (fscanf(ifp, "%s", threads_name) != 1)
+      {
+	EH( -1, "ERROR reading Assembly Threads card, expected a positive integer or auto");
+      }
+    if (strcasecmp(threads_name, "auto") == 0) {
+      Num_Assembly_Threads = 0;	/* settled on each rank, assembly_threads_setup */
+    } else if (sscanf(threads_name, "%d", &Num_Assembly_Threads) != 1 ||
+	       Num_Assembly_Threads < 1) {
+      EH( -1, "ERROR reading Assembly Threads card, expected a positive integer or auto");
+    }
+    SPF(echo_string, "%s = %s", "Assembly Threads", threads_name);
+    ECHO(echo_string,echo_file);
+  }
+  else
+    {
+      Num_Assembly_Threads = 1;
+    }
+
+  iread = look_for_optional(ifp, "Element Scatter Map", input, '=');
+  Elem_Scatter_Map = FALSE;
+  if (iread == 1) {
+    (void) read_string(ifp, input, '\n');
+    strip(input);
+    if (strcasecmp(input, "yes") == 0) {
+      Elem_Scatter_Map = TRUE;
+    } else if (strcasecmp(input, "no") != 0) {
+      EH( -1, "ERROR reading Element Scatter Map card, expected yes or no");
+    }
+    SPF(echo_string, "%s = %s", "Element Scatter Map",
+	Elem_Scatter_Map ? "yes" : "no");
+    ECHO(echo_string,echo_file);
+  }
+
+  /*
+   * Selective Reassembly = <drift tolerance> [<refresh interval>]
+   */
+  iread = look_for_optional(ifp, "Selective Reassembly", input, '=');
+  Selective_Reassembly_Tol = 0.0;
+  Selective_Reassembly_Refresh = 10;
+  if (iread == 1) {
+    (void) read_string(ifp, input, '\n');
+    strip(input);
+    k = sscanf(input, "%lf %d", &Selective_Reassembly_Tol,
+	       &Selective_Reassembly_Refresh);
+    if (k < 1 || Selective_Reassembly_Tol < 0.0 ||
+	(k == 2 && Selective_Reassembly_Refresh < 0)) {
+      EH( -1, "ERROR reading Selective Reassembly card, expected a tolerance and optional refresh interval");
+    }
+    SPF(echo_string, "%s = %g %d", "Selective Reassembly",
+	Selective_Reassembly_Tol, Selective_Reassembly_Refresh);
+    ECHO(echo_string,echo_file);
+  }
+
+  iread = look_for_optional(ifp, "Geometry Cache Memory", input, '=');
+  if (iread == 1) {
+    if (fscanf(ifp, "%d", &Geom_Cache_Memory) != 1 || Geom_Cache_Memory < 0)
+      {
+	EH( -1, "ERROR reading Geometry Cache Memory card, expected a non-negative integer (MB)");
+      }
+    SPF(echo_string, "%s = %d", "Geometry Cache Memory", Geom_Cache_Memory);
+    ECHO(echo_string,echo_file);
+  }
+  else
+    {
+      Geom_Cache_Memory = 0;
+    }
+
+  iread = look_for_optional(ifp, "Overlap Exchange", input, '=');
+  Overlap_Exchange = FALSE;
+  if (iread == 1) {
+    (void) read_string(ifp, input, '\n');
+    strip(input);
+    if (strcasecmp(input, "yes") == 0) {
+      Overlap_Exchange = TRUE;
+    } else if (strcasecmp(input, "no") != 0) {
+      EH( -1, "ERROR reading Overlap Exchange card, expected yes or no");
+    }
+    SPF(echo_string, "%s = %s", "Overlap Exchange",
+	Overlap_Exchange ? "yes" : "no");
+    ECHO(echo_string,echo_file);
+  }
+
+  /*
+   * Element Numerical Jacobian = {no | yes | <equation> [<equation> ...]}
+   *   yes differences every equation, otherwise only the ones listed
+   *   (R_ENERGY or its short name T, etc.)
+   */
+  iread = look_for_optional(ifp, "Element Numerical Jacobian", input, '=');
+  Elem_FD_Jacobian = FALSE;
+  memset(Elem_FD_Eqn, 0, MAX_VARIABLE_TYPES*sizeof(int));
+  if (iread == 1) {
+    char *tok, fd_err[MAX_CHAR_IN_INPUT];
+    (void) read_string(ifp, input, '\n');
+    strip(input);
+    SPF(echo_string, "%s = %s", "Element Numerical Jacobian", input);
+    if (strcasecmp(input, "yes") == 0) {
+      Elem_FD_Jacobian = TRUE;
+      for (i = V_FIRST; i < V_LAST; i++) Elem_FD_Eqn[i] = TRUE;
+    } else if (strcasecmp(input, "no") != 0) {
+      for (tok = strtok(input, " \t"); tok != NULL; tok = strtok(NULL, " \t")) {
+	for (i = 0; i < Num_EQ_Names; i++) {
+	  if (!strcmp(tok, EQ_Name[i].name1) || !strcmp(tok, EQ_Name[i].name2)) break;
+	}
+	if (i == Num_EQ_Names || EQ_Name[i].Index < V_FIRST ||
+	    EQ_Name[i].Index >= V_LAST) {
+	  SPF(fd_err, "ERROR reading Element Numerical Jacobian card, unknown equation %s", tok);
+	  EH( -1, fd_err);
+	}
+	Elem_FD_Eqn[EQ_Name[i].Index] = TRUE;
+	Elem_FD_Jacobian = TRUE;
+      }
+    }
+    ECHO(echo_string,echo_file);
+  }
+
+  /*
+   * Node Reorder = {none | rcm | morton}
+   *   order in which the nodes have their unknowns numbered
+   */
+  iread = look_for_optional(ifp, "Node Reorder", input, '=');
+  strcpy(Node_Reorder, "none");
+  if (iread == 1) {
+    (void) read_string(ifp, input, '\n');
+    strip(input);
+    if (strcasecmp(input, "none") != 0 && strcasecmp(input, "rcm") != 0 &&
+	strcasecmp(input, "morton") != 0) {
+      EH( -1, "ERROR reading Node Reorder card, expected none, rcm or morton");
+    }
+    strcpy(Node_Reorder, input);
+    for (i = 0; Node_Reorder[i] != '\0'; i++) {
+      Node_Reorder[i] = tolower(Node_Reorder[i]);
+    }
+    SPF(echo_string, "%s = %s", "Node Reorder", Node_Reorder);
+    ECHO(echo_string,echo_file);
+  }
+
+  /*
+   * Interior Condensation = {no | yes}
+   *   eliminate the element interior node dofs in each element matrix
+   */
+  iread = look_for_optional(ifp, "Interior Condensation", input, '=');
+  Interior_Condensation = FALSE;
+  if (iread == 1) {
+    (void) read_string(ifp, input, '\n');
+    strip(input);
+    if (strcasecmp(input, "yes") == 0) {
+      Interior_Condensation = TRUE;
+    } else if (strcasecmp(input, "no") != 0) {
+      EH( -1, "ERROR reading Interior Condensation card, expected yes or no");
+    }
+    SPF(echo_string, "%s = %s", "Interior Condensation",
+	Interior_Condensation ? "yes" : "no");
+    ECHO(echo_string,echo_file);
+  }
+
+  /*
+   * Fused Post Processing = {no | yes}
+   *   accumulate the nodal post processing fields in the last assembly
+   */
+  iread = look_for_optional(ifp, "Fused Post Processing", input, '=');
+  Fused_Post_Processing = FALSE;
+  if (iread == 1) {
+    (void) read_string(ifp, input, '\n');
+    strip(input);
+    if (strcasecmp(input, "yes") == 0) {
+      Fused_Post_Processing = TRUE;
+    } else if (strcasecmp(input, "no") != 0) {
+      EH( -1, "ERROR reading Fused Post Processing card, expected yes or no");
+    }
+    SPF(echo_string, "%s = %s", "Fused Post Processing",
+	Fused_Post_Processing ? "yes" : "no");
+    ECHO(echo_string,echo_file);
+  }
+
+  /*
+   * Prune Zero Couplings = <n>
+   *   after the n'th Jacobian assembly, drop the equation-variable
+   *   couplings that were zero in all of them from the MSR matrix
+   */
+  iread = look_for_optional(ifp, "Prune Zero Couplings", input, '=');
+  Prune_Zero_Couplings = 0;
+  if (iread == 1) {
+    if (fscanf(ifp, "%d", &Prune_Zero_Couplings) != 1 || Prune_Zero_Couplings < 0) {
+      EH( -1, "ERROR reading Prune Zero Couplings card, expected a non-negative integer");
+    }
+    if (Prune_Zero_Couplings > 0 && strcmp(Matrix_Format, "msr") != 0) {
+      WH(-1, "Prune Zero Couplings needs the msr matrix format, ignored");
+      Prune_Zero_Couplings = 0;
+    }
+    SPF(echo_string, "%s = %d", "Prune Zero Couplings", Prune_Zero_Couplings);
+    ECHO(echo_string,echo_file);
+  }
+
+  /*
+   * Memory Lean = {no | yes}
+   *   free the node->node connectivity, distribution factors and results
+   *   arrays of the mesh once the matrix is set up, rebuilt if needed
+   */
+  iread = look_for_optional(ifp, "Memory Lean", input, '=');
+  Memory_Lean = FALSE;
+  if (iread == 1) {
+    (void) read_string(ifp, input, '\n');
+    strip(input);
+    if (strcasecmp(input, "yes") == 0) {
+      Memory_Lean = TRUE;
+    } else if (strcasecmp(input, "no") != 0) {
+      EH( -1, "ERROR reading Memory Lean card, expected yes or no");
+    }
+    SPF(echo_string, "%s = %s", "Memory Lean", Memory_Lean ? "yes" : "no");
+    ECHO(echo_string,echo_file);
+  }
+
+  /*
+   * Setup Cache = {no | <file prefix>}
+   *   keep the matrix graph in <file prefix>.<nproc>.<proc> and take it
+   *   from there on a later launch of the same problem
+   */
+  iread = look_for_optional(ifp, "Setup Cache", input, '=');
+  Setup_Cache[0] = '\0';
+  if (iread == 1) {
+    (void) read_string(ifp, input, '\n');
+    strip(input);
+    if (strcasecmp(input, "NONE") && strcasecmp(input, "NO")) {
+      strcpy(Setup_Cache, input);
+    }
+    SPF(echo_string, "%s = %s", "Setup Cache",
+	Setup_Cache[0] ? Setup_Cache : "no");
+    ECHO(echo_string,echo_file);
+  }
+
+  /*
+   * Reduced Quadrature = {no | <equation> [<equation> ...]}
+   *   integrate the mesh (any of R_MESH1-3 selects all three) and/or
+   *   continuity (R_PRESSURE) equations of quadratic elements with the
+   *   Gauss rule of the linear element of the same shape
+   */
+  iread = look_for_optional(ifp, "Reduced Quadrature", input, '=');
+  Reduced_Quadrature = FALSE;
+  memset(Reduced_Quad_Eqn, 0, MAX_VARIABLE_TYPES*sizeof(int));
+  if (iread == 1) {
+    char *tok, rq_err[MAX_CHAR_IN_INPUT];
+    (void) read_string(ifp, input, '\n');
+    strip(input);
+    SPF(echo_string, "%s = %s", "Reduced Quadrature", input);
+    if (strcasecmp(input, "no") != 0) {
+      for (tok = strtok(input, " \t"); tok != NULL; tok = strtok(NULL, " \t")) {
+	for (i = 0; i < Num_EQ_Names; i++) {
+	  if (!strcmp(tok, EQ_Name[i].name1) || !strcmp(tok, EQ_Name[i].name2)) break;
+	}
+	if (i < Num_EQ_Names &&
+	    (EQ_Name[i].Index == R_MESH1 || EQ_Name[i].Index == R_MESH2 ||
+	     EQ_Name[i].Index == R_MESH3)) {
+	  Reduced_Quad_Eqn[R_MESH1] = TRUE;
+	  Reduced_Quad_Eqn[R_MESH2] = TRUE;
+	  Reduced_Quad_Eqn[R_MESH3] = TRUE;
+	} else if (i < Num_EQ_Names && EQ_Name[i].Index == R_PRESSURE) {
+	  Reduced_Quad_Eqn[R_PRESSURE] = TRUE;
+	} else {
+	  SPF(rq_err, "ERROR reading Reduced Quadrature card, %s is not a mesh or continuity equation", tok);
+	  EH( -1, rq_err);
+	}
+	Reduced_Quadrature = TRUE;
+      }
+    }
+    ECHO(echo_string,echo_file);
+  }
+
+  /*
+   * Periodic Constraints = {augmenting | native}
+   *   native: the PERIODIC augmenting condition cards tie the unknowns
+   *   of the matched nodes together in the matrix, with no AC at all
+   */
+  iread = look_for_optional(ifp, "Periodic Constraints", input, '=');
+  Periodic_Native = FALSE;
+  if (iread == 1) {
+    (void) read_string(ifp, input, '\n');
+    strip(input);
+    if (strcasecmp(input, "native") == 0) {
+      Periodic_Native = TRUE;
+    } else if (strcasecmp(input, "augmenting") != 0) {
+      EH( -1, "ERROR reading Periodic Constraints card, expected augmenting or native");
+    }
+    if (Periodic_Native &&
+	(strcmp(Matrix_Format, "msr") != 0 || Linear_Solver == FRONT)) {
+      EH( -1, "Periodic Constraints = native needs the msr matrix format");
+    }
+    SPF(echo_string, "%s = %s", "Periodic Constraints",
+	Periodic_Native ? "native" : "augmenting");
+    ECHO(echo_string,echo_file);
+  }
+
+  /*
+   * Mesh Stiffness Lag = <n>
+   *   compute the mesh-mesh element blocks of the Jacobian on every n'th
+   *   Jacobian assembly only and reuse them in between
+   */
+  iread = look_for_optional(ifp, "Mesh Stiffness Lag", input, '=');
+  Mesh_Stiffness_Lag = 0;
+  if (iread == 1) {
+    if (fscanf(ifp, "%d", &Mesh_Stiffness_Lag) != 1 || Mesh_Stiffness_Lag < 0) {
+      EH( -1, "ERROR reading Mesh Stiffness Lag card, expected a non-negative integer");
+    }
+    SPF(echo_string, "%s = %d", "Mesh Stiffness Lag", Mesh_Stiffness_Lag);
+    ECHO(echo_string,echo_file);
+  }
+
+  /*
+   * Mesh Segregation = <coupling tolerance>
+   *   solve an ALE problem by alternating flow solves on a fixed mesh
+   *   with mesh solves for a fixed flow, until a mesh solve changes the
+   *   mesh by less than the tolerance (relative L2 norm)
+   */
+  iread = look_for_optional(ifp, "Mesh Segregation", input, '=');
+  Mesh_Segregation_Tol = 0.;
+  if (iread == 1) {
+    if (fscanf(ifp, "%lf", &Mesh_Segregation_Tol) != 1 || Mesh_Segregation_Tol < 0.) {
+      EH( -1, "ERROR reading Mesh Segregation card, expected a non-negative coupling tolerance");
     }
-  SPF(echo_string,"%s = %d", "Number of Newton Iterations", Max_Newton_Steps);
+    SPF(echo_string, "%s = %g", "Mesh Segregation", Mesh_Segregation_Tol);
+    ECHO(echo_string,echo_file);
+  }
 
-  if (fscanf(ifp, "%d", &Newt_Jacobian_Reformation_stride) == 1)
-    {
-      if(Newt_Jacobian_Reformation_stride > 1) modified_newton = TRUE;
+  /*
+   * Reduced Order Model = {none | collect | solve} [<basis file>]
+   *   collect: keep the solutions written and save their POD basis
+   *   solve: Newton in that basis, filling sampled elements only
+   * ROM Basis Size = <max modes> [<energy fraction>]
+   * ROM Snapshots = <max snapshots>
+   * ROM Sample Nodes = <min sample nodes>
+   */
+  iread = look_for_optional(ifp, "Reduced Order Model", input, '=');
+  Reduced_Order_Model = ROM_NONE;
+  ROM_Max_Modes = 20;
+  ROM_Energy = 0.99999;
+  ROM_Max_Snapshots = 200;
+  ROM_Sample_Nodes = 0;
+  if (iread == 1) {
+    char rom_mode[MAX_CHAR_IN_INPUT], rom_file[MAX_CHAR_IN_INPUT];
+    (void) read_string(ifp, input, '\n');
+    strip(input);
+    rom_file[0] = '\0';
+    if (sscanf(input, "%s %s", rom_mode, rom_file) < 1) {
+      EH( -1, "ERROR reading Reduced Order Model card, expected none, collect or solve");
+    }
+    if (strcasecmp(rom_mode, "collect") == 0) {
+      Reduced_Order_Model = ROM_COLLECT;
+    } else if (strcasecmp(rom_mode, "solve") == 0) {
+      Reduced_Order_Model = ROM_SOLVE;
+    } else if (strcasecmp(rom_mode, "none") != 0) {
+      EH( -1, "ERROR reading Reduced Order Model card, expected none, collect or solve");
+    }
+    if (rom_file[0] != '\0') strcpy(ROM_Basis_File, rom_file);
+    if (Reduced_Order_Model == ROM_SOLVE &&
+	(strcmp(Matrix_Format, "msr") != 0 || Linear_Solver == FRONT)) {
+      EH( -1, "Reduced Order Model = solve needs the msr matrix format");
+    }
+    SPF(echo_string, "%s = %s %s", "Reduced Order Model", rom_mode, ROM_Basis_File);
+    ECHO(echo_string,echo_file);
+  }
 
-      SPF(endofstring(echo_string), " %d", Newt_Jacobian_Reformation_stride );
-    }
-  else
-    {
-       Newt_Jacobian_Reformation_stride = 1;
+  iread = look_for_optional(ifp, "ROM Basis Size", input, '=');
+  if (iread == 1) {
+    (void) read_string(ifp, input, '\n');
+    strip(input);
+    if (sscanf(input, "%d %lf", &ROM_Max_Modes, &ROM_Energy) < 1 ||
+	ROM_Max_Modes < 1 || ROM_Energy <= 0. || ROM_Energy > 1.) {
+      EH( -1, "ERROR reading ROM Basis Size card, expected a positive integer and an energy fraction in (0,1]");
     }
-
-  ECHO(echo_string,echo_file);
-    
-  iread = look_for_optional(ifp, "Modified Newton Tolerance", input, '=');
-  if (iread == 1) { 
-    if (fscanf(ifp, "%le %le", &convergence_rate_tolerance, &modified_newt_norm_tol) != 2)
-      {
-	EH( -1, "ERROR reading Modified Newton Tolerance card");
-      }
-    else
-      {
-        if (convergence_rate_tolerance != 0. && modified_newt_norm_tol != 0.)
-	  {
-	    modified_newton=TRUE;
-	  }
-	SPF(echo_string,"%s = %.4g %.4g", "Modified Newton Tolerance",convergence_rate_tolerance , modified_newt_norm_tol ); 
-	ECHO(echo_string,echo_file);
-      }
+    SPF(echo_string, "%s = %d %g", "ROM Basis Size", ROM_Max_Modes, ROM_Energy);
+    ECHO(echo_string,echo_file);
   }
-  else
-    {
-      convergence_rate_tolerance = 0.;
-      modified_newt_norm_tol = 0.;
+
+  iread = look_for_optional(ifp, "ROM Snapshots", input, '=');
+  if (iread == 1) {
+    if (fscanf(ifp, "%d", &ROM_Max_Snapshots) != 1 || ROM_Max_Snapshots < 1) {
+      EH( -1, "ERROR reading ROM Snapshots card, expected a positive integer");
     }
+    SPF(echo_string, "%s = %d", "ROM Snapshots", ROM_Max_Snapshots);
+    ECHO(echo_string,echo_file);
+  }
 
-  iread = look_for_optional(ifp, "Jacobian Reform Time Stride", input, '=');
-  if (iread == 1) { 
-    if (fscanf(ifp, "%d", &Time_Jacobian_Reformation_stride) != 1)
-      {
-	EH( -1, "ERROR reading Jacobian Reform Stride card");
-      }
-    else
-      {
-	if(Time_Jacobian_Reformation_stride > 1) modified_newton = TRUE;
-	SPF(echo_string, "%s = %d", "Jacobian Reform Time Stride", Time_Jacobian_Reformation_stride);
-	ECHO(echo_string,echo_file);
-      }
-  } 
-  else
-    {
-      Time_Jacobian_Reformation_stride = 0;
+  iread = look_for_optional(ifp, "ROM Sample Nodes", input, '=');
+  if (iread == 1) {
+    if (fscanf(ifp, "%d", &ROM_Sample_Nodes) != 1 || ROM_Sample_Nodes < 0) {
+      EH( -1, "ERROR reading ROM Sample Nodes card, expected a non-negative integer");
     }
+    SPF(echo_string, "%s = %d", "ROM Sample Nodes", ROM_Sample_Nodes);
+    ECHO(echo_string,echo_file);
+  }
 
 
 
@@ -7044,6 +8643,35 @@ fprintf(stderr,"HUN %d %d %d\n",nHC,hunt[0].Type,hunt[0].BCID);
 	 }
   ECHO(echo_string,echo_file);
 
+/* WARM START FROM THE PREVIOUS SOLVE [eggroll or ARPACK] */
+
+  iread = look_for_optional(ifp, "Eigen Warm Start", input, '=');
+  if (iread == 1)
+    {
+	  SPF(echo_string,"%s =", input);
+      (void) read_string(ifp, input, '\n');
+      strip(input);
+      if ( strcmp(input, "no") == 0)
+        {
+          eigen->Eigen_Warm_Start = 0;
+        }
+      else if ( strcmp(input, "yes") == 0)
+        {
+          eigen->Eigen_Warm_Start = 1;
+        }
+      else
+        {
+          EH(-1, "Eigen Warm Start must be yes or no");
+        }
+	  SPF(endofstring(echo_string)," %s",input);
+    }
+  else
+    {
+      eigen->Eigen_Warm_Start = 1;
+      SPF(echo_string, "\t(%s = %s)","Eigen Warm Start","yes");
+    }
+  ECHO(echo_string,echo_file);
+
 
 /* CAYLEY SIGMA AND MU [ARPACK only] */
 
@@ -7248,6 +8876,32 @@ fprintf(stderr,"HUN %d %d %d\n",nHC,hunt[0].Type,hunt[0].BCID);
     EH(-1, "3D stability of 2D flow requested, but missing \"Eigen Wave Numbers\" card");
   
   ECHO(echo_string,echo_file);
+
+  /* Get the matrices of all but three of the wave numbers from a
+   * quadratic in the wave number [eggroll only] */
+  LSA_wave_number_interpolation = FALSE;
+  iread = look_for_optional(ifp, "Eigen Wave Number Interpolation", input, '=');
+  if (iread == 1)
+    {
+      SPF(echo_string,"%s =", input);
+      (void) read_string(ifp, input, '\n');
+      strip(input);
+      if (strcmp(input, "yes") == 0)
+        {
+          LSA_wave_number_interpolation = TRUE;
+        }
+      else if (strcmp(input, "no") != 0)
+        {
+          EH(-1, "Eigen Wave Number Interpolation must be yes or no");
+        }
+      SPF(endofstring(echo_string)," %s",input);
+    }
+  else
+    {
+      SPF(echo_string, "\t(%s = %s)","Eigen Wave Number Interpolation","no");
+    }
+
+  ECHO(echo_string,echo_file);
 }  /* End of rd_eigen_specs */
 
 
@@ -7276,17 +8930,15 @@ rd_matl_blk_specs(FILE *ifp,
 		  char *input)
 {
   char err_msg[MAX_CHAR_IN_INPUT];
-  int	err, mn, i;
+  int	mn, i;
   FILE *imp;
   char MatFile[MAX_FNL];	/* Raw material database file. */
-  char TmpMatFile[MAX_FNL];	/* Temporary copy of mat db after APREPRO. */
 
   char echo_string[MAX_CHAR_ECHO_INPUT]="\0";
   char *echo_input_file = Echo_Input_File;
   char echo_mat_file[MAX_FNL]="\0";
 
   static char MatFileSuffix[] = ".mat";
-  static char System_Command[MAX_SYSTEM_COMMAND_LENGTH];
 
   /*
    * Identify section containing equation specification...
@@ -7443,10 +9095,8 @@ rd_matl_blk_specs(FILE *ifp,
 
       /*
        * If the "-a" or "-aprepro" flag was specified on the command line,
-       * then assume that the MAT files will also be so preprocessed...
-       *
-       * Need to make up some temporary file names...
-       *
+       * then assume that the MAT files will also be so preprocessed,
+       * once per file however many materials share it.
        */
 
        if ( (imp=fopen(MatFile,"r")) != NULL )
@@ -7455,36 +9105,11 @@ rd_matl_blk_specs(FILE *ifp,
 	 if ( run_aprepro == 1 )
 	   {
 	     fclose(imp);
-	     /* 
-	      * Start fresh for each matl, build up command and temporary
-	      * file name from available information...
-	      */
-	     System_Command[0] = '\0';
-	     TmpMatFile[0] = '\0';
-	     strcat(TmpMatFile, "tmp.");
-	     strcat(TmpMatFile, MatFile);
-	     sprintf(System_Command, "%s %s %s", aprepro_command,
-		     MatFile, TmpMatFile);
-#ifndef tflop
-	     err = system(System_Command);
-	     EH(err, "system() choked on mat file.");
-
-	     if (WEXITSTATUS(err) == 127)
-	       {
-		 EH(-1, "System call failed, aprepro not found");
-	       }
-
-#else
-             EH(-1, "aprepro the mat file prior to running goma.");
-#endif
-	     if ( Debug_Flag > 0 )
-	       {
-		 fprintf(stdout, "system: %s\n", System_Command);
-	       }
-	     imp = fopen(TmpMatFile, "r");
+	     imp = fopen_aprepro(MatFile, "r");
 	     if ( imp == NULL )
 	       {
-		 EH(-1, "Problem opening temporary mat file.");	       }
+		 EH(-1, "Problem opening preprocessed mat file.");
+	       }
 	   }
 
          /*
@@ -8091,6 +9716,7 @@ rd_eq_specs(FILE *ifp,
 #ifndef COUPLED_FILL
       /* set explicit flag for fill equation and turn on level set switch*/
       if (ls->Evolution == LS_EVOLVE_ADVECT_EXPLICIT  ||
+          ls->Evolution == LS_EVOLVE_ADVECT_LUMPED    ||
           ls->Evolution == LS_EVOLVE_SEMILAGRANGIAN ) Explicit_Fill = 1;
 #endif /* not COUPLED_FILL */
     } else if (!strcasecmp(ts, "curvature") ) {
@@ -11130,6 +12756,10 @@ usage(const int exit_flag)
 	  "\t-i FILE,    -input FILE         Input from FILE.\n");
   fprintf(stdout, 
 	  "\t-ix FILE,   -inexoII FILE       Read FEM from FILE.\n");
+  fprintf(stdout, 
+	  "\t-gx FILE,   -guess_exoII FILE   Initial guess from the last solution in FILE.\n");
+  fprintf(stdout, 
+	  "\t-noseq                          Ignore the Mesh Sequence card.\n");
   fprintf(stdout, 
 	  "\t-n INT,     -newton INT         Change # of Newton it'ns to INT.\n");
   fprintf(stdout, 
@@ -11449,6 +13079,27 @@ translate_command_line( int argc,
 	      clc[*nclc]->r_val = strtod(argv[istr], NULL);
 	      istr++;
 	    }
+/* 
+ * OPTION -guess_exoII: initial guess from the last solution in a file,
+ * interpolated if that file has another mesh
+ */
+	  else if(strcmp(argv[istr], "-guess_exoII") == 0 || strcmp(argv[istr], "-gx") == 0)
+	    {
+	      (*nclc)++;
+	      istr++;
+	      clc[*nclc]->type = GUESS_EXOII_FILE;
+	      strcpy_rtn = strcpy(clc[*nclc]->string, argv[istr]);
+	      istr++;
+	    }
+/* 
+ * OPTION -noseq: solve on the FEM file alone, as the Mesh Sequence stages do
+ */
+	  else if(strcmp(argv[istr], "-noseq") == 0)
+	    {
+	      (*nclc)++;
+	      istr++;
+	      clc[*nclc]->type = NO_MESH_SEQUENCE;
+	    }
 /*
  * OPTION -relax: override newton update factor in 'input'
  */
@@ -11851,6 +13502,17 @@ apply_command_line(struct Command_line_command **clc,
 		 b, "Initial Time", clc[i]->r_val);
 	 tran->init_time = clc[i]->r_val;
        }
+       else if (clc[i]->type == GUESS_EXOII_FILE) {
+	 fprintf(stdout, "%s%40s= %s\n%s%40s= %s %s\n",
+		 a, "Initial Guess", ExoAuxFile,
+		 b, "Initial Guess", "read_exoII_file", clc[i]->string);
+	 Guess_Flag = 6;
+	 strcpy_rtn = strcpy(ExoAuxFile, clc[i]->string);
+	 ExoTimePlane = INT_MAX;
+       }
+       else if (clc[i]->type == NO_MESH_SEQUENCE) {
+	 Mesh_Sequence_Length = 0;
+       }
        else if (clc[i]->type == TIME_END) {
 	 fprintf(stdout, "%s%40s= %g ...\n%s%40s= %g ...\n",
 		 a, "Maximum Time", tran->TimeMax,
@@ -12683,7 +14345,7 @@ setup_table_BC(FILE *ifp,
 	  
       strip(input);
 	  
-      if ( ( datafile = fopen_aprepro( input, "r") ) == NULL )
+      if ( ( datafile = fopen_table( input ) ) == NULL )
 	  {
 		  sprintf(err_msg, "\n%s,\tError opening TABLE data file %s\n",yo,input);
 		  EH(-1,err_msg);
@@ -12922,10 +14584,12 @@ fopen_aprepro( const char *filename, const char *format )
 {
   /*     Front end function for fopen.  If aprepro is not being
 	 used, it simply calls fopen and returns.  If aprepro is
-	 enabled, it assembles a temporary filename, preprocesses
-	 the file specified in filename with APREPRO, and opens
-	 the resulting file.  It returns a pointer to a file in 
-	 either case.
+	 enabled, the file specified in filename is run through
+	 APREPRO, whose output is read straight from its pipe and
+	 kept, so a file that several cards name (a table file,
+	 a material file shared by blocks) is preprocessed once.
+	 The stream returned reads the kept text, no temporary file
+	 is written. It returns a pointer to a file in either case.
 
 	 Author: Thomas A. Baer, Org. 9111
 	 Date  : July 14, 1998
@@ -12942,39 +14606,77 @@ fopen_aprepro( const char *filename, const char *format )
 
    */
     
-  int err;
   FILE *file;
-  char Tmpfilename[MAX_FNL];
+  int i;
   static char System_Command[MAX_SYSTEM_COMMAND_LENGTH];
 
   if( run_aprepro == 1)
     {
-      System_Command[0] = '\0';
-      Tmpfilename[0] = '\0';
-      (void) strcat(Tmpfilename, "tmp.");
-      (void) strcat(Tmpfilename, filename);
-      sprintf(System_Command, "%s %s %s", aprepro_command, filename, Tmpfilename);
+      for (i = 0; i < Num_Aprepro_Files; i++)
+	{
+	  if (strcmp(Aprepro_Files[i].name, filename) == 0) break;
+	}
 
+      if (i == Num_Aprepro_Files)
+	{
 #ifndef tflop
-      err = system( System_Command);
+	  FILE *pipe;
+	  struct Aprepro_File *af_new;
+	  size_t n, size = 0, len = 0;
+	  char *text = NULL;
+	  int err;
 
-      EH(err, "System call failed in fopen_aprepro.");
+	  sprintf(System_Command, "%s %s", aprepro_command, filename);
+	  if ( Debug_Flag > 0 )
+	    {
+	      fprintf(stdout, "system: %s\n", System_Command);
+	    }
+	  pipe = popen(System_Command, "r");
+	  if (pipe == NULL)
+	    {
+	      EH(-1, "System call failed in fopen_aprepro.");
+	      return NULL;
+	    }
+	  do {
+	    if (len + BUFSIZ + 1 > size)
+	      {
+		size = 2 * size + BUFSIZ + 1;
+		text = (char *) realloc(text, size);
+		if (text == NULL) EH(-1, "Out of memory for aprepro output");
+	      }
+	    n = fread(text + len, 1, BUFSIZ, pipe);
+	    len += n;
+	  } while (n > 0);
+	  text[len] = '\0';
+	  err = pclose(pipe);
 
-      if (WEXITSTATUS(err) == 127)
-	{
-	  EH(-1, "System call failed, aprepro not found");
-	  return NULL;
-	}
+	  EH(err, "System call failed in fopen_aprepro.");
+
+	  if (WEXITSTATUS(err) == 127)
+	    {
+	      EH(-1, "System call failed, aprepro not found");
+	      return NULL;
+	    }
+
+	  af_new = (struct Aprepro_File *)
+	    realloc(Aprepro_Files, (Num_Aprepro_Files + 1) * sizeof(struct Aprepro_File));
+	  if (af_new == NULL) EH(-1, "Out of memory for aprepro output");
+	  Aprepro_Files = af_new;
+	  strncpy(Aprepro_Files[i].name, filename, MAX_FNL - 1);
+	  Aprepro_Files[i].name[MAX_FNL - 1] = '\0';
+	  Aprepro_Files[i].text = text;
+	  Aprepro_Files[i].len = len;
+	  Num_Aprepro_Files++;
 #else
-      EH(-1, "aprepro the input file prior to running goma");
+	  EH(-1, "aprepro the input file prior to running goma");
 #endif
-
-      if ( Debug_Flag > 0 )
-	{
-	  fprintf(stdout, "system: %s\n", System_Command);
 	}
 
-      file = fopen( Tmpfilename, format); 
+      /* fmemopen() will not take an empty buffer */
+      if (Aprepro_Files[i].len == 0)
+	file = tmpfile();
+      else
+	file = fmemopen(Aprepro_Files[i].text, Aprepro_Files[i].len, "r");
     }
   else
     {
@@ -12985,6 +14687,51 @@ return (file);
 
 }
 
+/*
+ * The header of a binary table file: TABLE_FILE_MAGIC, then the number of
+ * points and of columns; the points follow, one row of columns after
+ * another, as doubles in the byte order of the machine that wrote them.
+ */
+
+#define TABLE_FILE_MAGIC   "GOMATAB"
+#define TABLE_FILE_VERSION 1
+
+struct Table_File_Header
+{
+  char magic[8];
+  int version;
+  int one;			/* 1, to catch a byte order change */
+  int num_pnts;
+  int columns;
+};
+
+FILE *
+fopen_table( const char *filename )
+{
+  /*
+   * Open a table data file (FILE = of a TABLE card). A binary table file
+   * is opened as it is, so that aprepro does not see it; a text one goes
+   * through fopen_aprepro() like any other.
+   */
+  FILE *file;
+  char magic[8];
+
+  if ( ( file = fopen( filename, "rb" ) ) == NULL )
+    {
+      return ( fopen_aprepro( filename, "r" ) );
+    }
+
+  if ( fread( magic, 1, sizeof(magic), file ) == sizeof(magic) &&
+       strncmp( magic, TABLE_FILE_MAGIC, sizeof(magic) ) == 0 )
+    {
+      rewind( file );
+      return (file);
+    }
+  fclose( file );
+
+  return ( fopen_aprepro( filename, "r" ) );
+}
+
 
 
 struct Data_Table *
@@ -13105,7 +14852,7 @@ setup_gd_table_BC(
 		  
 		  strip(input);
 		  
-		  if ( ( datafile = fopen_aprepro( input, "r") ) == NULL )
+		  if ( ( datafile = fopen_table( input ) ) == NULL )
 		  {
 			  sprintf(err_msg, "\n%s:\tError opening TABLE data file %s\n",yo,input);
 			  EH(-1,err_msg);
@@ -13391,7 +15138,7 @@ setup_table_MP (FILE *imp, struct Data_Table * table, char *search_string)
 
       strip(line);
 
-      if ( ( datafile = fopen_aprepro( line, "r") ) == NULL )
+      if ( ( datafile = fopen_table( line ) ) == NULL )
 	{
 	  sprintf(err_msg, "\n%s,\tError opening TABLE data file for material property \n",yo);
 	  EH(-1,err_msg);
@@ -13479,6 +15226,127 @@ setup_table_MP (FILE *imp, struct Data_Table * table, char *search_string)
 }
 
 
+/*
+ * Where column c of the points of a table goes, laid out the way
+ * scan_table_columns() lays out the columns of a text table.
+ */
+
+static void
+table_column_bases(struct Data_Table *table,
+		   int table_dim,
+		   double *base[])
+{
+  int N = table->tablelength;
+  int saturation = (strcmp(table->f_name, "Saturation") == 0);
+
+  base[0] = table->t;
+  if ( table->columns == 2 )
+    {
+      base[1] = table->f;
+    }
+  else if ( table->columns == 3 && table_dim == 2 )
+    {
+      base[1] = table->t2; base[2] = table->f;
+    }
+  else if ( table->columns == 3 && !saturation )
+    {
+      base[1] = table->f; base[2] = table->f + N;
+    }
+  else if ( table->columns == 3 && table_dim == 1 )
+    {
+      base[1] = table->f + N; base[2] = table->f;
+    }
+  else if ( table->columns == 4 && table_dim == 2 && saturation )
+    {
+      base[1] = table->t2; base[2] = table->f + N; base[3] = table->f;
+    }
+  else if ( table->columns == 4 && table_dim == 3 )
+    {
+      base[1] = table->t2; base[2] = table->t3; base[3] = table->f;
+    }
+  else if ( table->columns == 5 && table_dim == 2 )
+    {
+      base[1] = table->t2;
+      base[2] = table->f; base[3] = table->f + N; base[4] = table->f + 2*N;
+    }
+  else
+    {
+      EH(-1,"invalid table column, dimension combination.");
+    }
+}
+
+/*
+ * If ifp is a binary table file (see fopen_table()), read its header and
+ * set the table length; otherwise leave ifp where it was and return FALSE.
+ */
+
+static int
+rd_table_binary_header(FILE *ifp, struct Data_Table *table)
+{
+  struct Table_File_Header h;
+  fpos_t file_position;
+  char err_msg[MAX_CHAR_IN_INPUT];
+
+  fgetpos(ifp, &file_position);
+  if ( fread(&h, sizeof(h), 1, ifp) != 1 ||
+       strncmp(h.magic, TABLE_FILE_MAGIC, sizeof(h.magic)) != 0 )
+    {
+      fsetpos(ifp, &file_position);
+      return(FALSE);
+    }
+
+  if ( h.one != 1 || h.version != TABLE_FILE_VERSION )
+    {
+      sprintf(err_msg, "Binary table file for %s is of another version or byte order",
+	      table->f_name);
+      EH(-1, err_msg);
+    }
+  if ( h.columns != table->columns )
+    {
+      sprintf(err_msg, "Binary table file for %s has %d columns, expected %d",
+	      table->f_name, h.columns, table->columns);
+      EH(-1, err_msg);
+    }
+  table->tablelength = h.num_pnts;
+  return(TRUE);
+}
+
+/*
+ * The points of a binary table file, a block of rows at a time.
+ */
+
+static void
+rd_table_binary_points(FILE *ifp, struct Data_Table *table, int table_dim)
+{
+#define TABLE_FILE_BLOCK 4096
+  double *base[5], *row;
+  int c, k, n, nc = table->columns, N = table->tablelength;
+  char err_msg[MAX_CHAR_IN_INPUT];
+
+  table_column_bases(table, table_dim, base);
+  row = (double *) smalloc(sizeof(double) * nc * TABLE_FILE_BLOCK);
+
+  for ( k = 0; k < N; k += n )
+    {
+      n = MIN(TABLE_FILE_BLOCK, N - k);
+      if ( fread(row, sizeof(double) * nc, n, ifp) != (size_t) n )
+	{
+	  sprintf(err_msg, "\nBinary table file for %s ends after %d of %d points\n",
+		  table->f_name, k, N);
+	  EH(-1, err_msg);
+	}
+      for ( c = 0; c < nc; c++ )
+	{
+	  double *b = base[c] + k;
+	  const double *r = row + c;
+	  int i;
+	  for ( i = 0; i < n; i++ ) b[i] = r[i*nc];
+	}
+    }
+  safe_free((void *) row);
+#undef TABLE_FILE_BLOCK
+}
+
 void
 rd_table_data(FILE *ifp, char *input, struct Data_Table *table , char *endlist)
 {
@@ -13508,6 +15376,7 @@ rd_table_data(FILE *ifp, char *input, struct Data_Table *table , char *endlist)
   double p,p2=0.0,p3,p4=0.0;
   int  i,j,k, Num_Pnts,ibegin,iend;
   int table_dim=0;
+  int binary;
   char echo_string[MAX_CHAR_IN_INPUT]="\0";	
   char *echo_file = Echo_Input_File;
 
@@ -13517,7 +15386,15 @@ rd_table_data(FILE *ifp, char *input, struct Data_Table *table , char *endlist)
    * Count the number of PNTs in the TABLE
    */
 
-  table->tablelength = Num_Pnts = count_datalines(ifp,input, endlist);
+  binary = ( endlist == NULL && rd_table_binary_header(ifp, table) );
+  if ( binary )
+    {
+      Num_Pnts = table->tablelength;
+    }
+  else
+    {
+      table->tablelength = Num_Pnts = count_datalines(ifp,input, endlist);
+    }
       
   if( table->tablelength == 0 )
     EH( -1, "Error reading tabular data . Can't find any points ");   
@@ -13575,7 +15452,12 @@ rd_table_data(FILE *ifp, char *input, struct Data_Table *table , char *endlist)
    * Now read all yer points
    */
 
-  if ( endlist != NULL )  /* read data from input deck */
+  if ( binary )  /* points of a binary table file */
+  {
+	  rd_table_binary_points(ifp, table, table_dim);
+	  k = Num_Pnts;
+  }
+  else if ( endlist != NULL )  /* read data from input deck */
   {
 	  
 	  size_t len = strlen(endlist);
@@ -14023,6 +15905,8 @@ if((table_dim == 1 || table->interp_method == BILINEAR) && strcmp(table->f_name,
  		    }
 		}
 	}
+
+  table_interval_setup(table);
 }    
 
 
@@ -14844,7 +16728,7 @@ setup_table_external(
 	}
 
 
-  if ( ( datafile = fopen_aprepro( filename, "r") ) == NULL )
+  if ( ( datafile = fopen_table( filename ) ) == NULL )
 	{
 	  sprintf(err_msg, "\n%s,\tError opening TABLE data file %s\n",yo,filename);
 	  EH(-1,err_msg);
@@ -14989,7 +16873,7 @@ setup_table_AC(
       EH(-1,err_msg);
     }
 
-  if ( ( datafile = fopen_aprepro( filename, "r") ) == NULL )
+  if ( ( datafile = fopen_table( filename ) ) == NULL )
 	{
 	  sprintf(err_msg, "\n%s,\tError opening TABLE data file %s\n",yo,filename);
 	  EH(-1,err_msg);
@@ -0,0 +1,326 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * Index of the cards of an input file, for the card searches.
+ *
+ * A search reads strings with read_string(ifp, input, ch_term), strips
+ * them and compares them with the card name, so what it can match are
+ * the pieces of the file between one '\n' or ch_term and the next. The
+ * index holds those pieces, stripped and hashed, with where each one
+ * starts and where the one after it does, one such split per ch_term.
+ *
+ * A search from the start of the file, or from a spot just after a
+ * '\n' or ch_term (where reading would split the file the same way), is
+ * then a hash lookup for the first piece at or after that spot, stopping
+ * where read_string() would have failed: at a piece MAX_CHAR_IN_INPUT
+ * long or more, or at the end of the file. Searches from other spots,
+ * e.g. the middle of a line after an fscanf(), are left to the scan.
+ *
+ * The file is tied to its index by the FILE pointer and by the device,
+ * inode, size and modification time of what it has open.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include "std.h"
+#include "rf_allo.h"
+#include "rf_io_const.h"
+#include "mm_eh.h"
+
+#define _MM_INPUT_INDEX_C
+#include "goma.h"
+
+#define INPUT_INDEX_MAX_FILES 16
+#define INPUT_INDEX_MAX_SPLITS 4
+
+struct input_split {
+  char ch_term;
+  int n;			/* pieces */
+  long *start;			/* [n] offset of each piece */
+  long *next;			/* [n] offset just past its terminator */
+  int *text;			/* [n] its stripped text in arena */
+  int *chain;			/* [n] next piece in its hash bucket */
+  int nbucket;
+  int *bucket;			/* [nbucket] first piece, -1 if none */
+  int nfail;
+  long *fail;			/* [nfail] pieces read_string() fails on */
+  char *arena;
+};
+
+struct input_index {
+  FILE *ifp;
+  dev_t dev;
+  ino_t ino;
+  off_t size;
+  time_t mtime;
+  char *buf;			/* the whole file */
+  long len;
+  int nsplit;
+  struct input_split split[INPUT_INDEX_MAX_SPLITS];
+};
+
+static struct input_index *Index[INPUT_INDEX_MAX_FILES];
+static int Index_Next = 0;	/* slot to reuse when all are taken */
+
+static unsigned int
+hash_string(const char *s)
+{
+  unsigned int h = 5381;
+
+  while (*s != '\0') h = h * 33 + (unsigned char) *s++;
+  return h;
+}
+
+static void
+split_free(struct input_split *sp)
+{
+  safe_free(sp->start);
+  safe_free(sp->next);
+  safe_free(sp->text);
+  safe_free(sp->chain);
+  safe_free(sp->bucket);
+  safe_free(sp->fail);
+  safe_free(sp->arena);
+}
+
+static void
+index_free(struct input_index *ix)
+{
+  int s;
+
+  if (ix == NULL) return;
+  for (s = 0; s < ix->nsplit; s++) split_free(&ix->split[s]);
+  safe_free(ix->buf);
+  safe_free(ix);
+}
+
+/*
+ * Split ix->buf the way read_string(.., ch_term) reads it.
+ */
+
+static void
+split_build(struct input_index *ix,
+	    struct input_split *sp,
+	    const char ch_term)
+{
+  char piece[MAX_CHAR_IN_INPUT + 1];
+  long p, q, *last;
+  int i, k, n, used, nmax;
+  unsigned int h;
+
+  sp->ch_term = ch_term;
+
+  /* at most one piece per terminator, and the tail */
+  nmax = 1;
+  for (p = 0; p < ix->len; p++) {
+    if (ix->buf[p] == '\n' || ix->buf[p] == ch_term) nmax++;
+  }
+
+  sp->start = (long *) smalloc(nmax * sizeof(long));
+  sp->next = (long *) smalloc(nmax * sizeof(long));
+  sp->text = (int *) smalloc(nmax * sizeof(int));
+  sp->fail = (long *) smalloc(nmax * sizeof(long));
+  sp->arena = (char *) smalloc(ix->len + nmax + 1);
+
+  n = 0;
+  used = 0;
+  sp->nfail = 0;
+  p = 0;
+  while (p < ix->len) {
+    for (q = p; q < ix->len && ix->buf[q] != '\n' && ix->buf[q] != ch_term; q++);
+    if (q == ix->len) break;			/* no terminator: EOF */
+    if (q - p >= MAX_CHAR_IN_INPUT) {
+      sp->fail[sp->nfail++] = p;
+    } else {
+      memcpy(piece, ix->buf + p, q - p);
+      piece[q - p] = '\0';
+      strip(piece);
+      k = strlen(piece);
+      memcpy(sp->arena + used, piece, k + 1);
+      sp->start[n] = p;
+      sp->next[n] = q + 1;
+      sp->text[n] = used;
+      used += k + 1;
+      n++;
+    }
+    p = q + 1;
+  }
+  sp->fail[sp->nfail++] = p;			/* the end of the file */
+  sp->n = n;
+
+  /* buckets hold their pieces in file order */
+  sp->nbucket = 1;
+  while (sp->nbucket < 2 * MAX(n, 1)) sp->nbucket *= 2;
+  sp->bucket = alloc_int_1(sp->nbucket, -1);
+  sp->chain = alloc_int_1(MAX(n, 1), -1);
+  last = (long *) smalloc(sp->nbucket * sizeof(long));
+  for (i = 0; i < n; i++) {
+    h = hash_string(sp->arena + sp->text[i]) & (sp->nbucket - 1);
+    if (sp->bucket[h] < 0) {
+      sp->bucket[h] = i;
+    } else {
+      sp->chain[last[h]] = i;
+    }
+    last[h] = i;
+  }
+  safe_free(last);
+}
+
+/*
+ * The index of ifp, built when it is not there or is out of date;
+ * NULL when ifp is not a regular file.
+ */
+
+static struct input_index *
+index_of(FILE *ifp)
+{
+  struct input_index *ix;
+  struct stat st;
+  long here;
+  int i, slot = -1;
+
+  if (fstat(fileno(ifp), &st) != 0 || !S_ISREG(st.st_mode)) return NULL;
+
+  for (i = 0; i < INPUT_INDEX_MAX_FILES; i++) {
+    ix = Index[i];
+    if (ix == NULL) {
+      if (slot < 0) slot = i;
+      continue;
+    }
+    if (ix->ifp != ifp) continue;
+    if (ix->dev == st.st_dev && ix->ino == st.st_ino &&
+	ix->size == st.st_size && ix->mtime == st.st_mtime) {
+      return ix;
+    }
+    index_free(ix);
+    Index[i] = NULL;
+    slot = i;
+  }
+  if (slot < 0) {
+    slot = Index_Next;
+    Index_Next = (Index_Next + 1) % INPUT_INDEX_MAX_FILES;
+    index_free(Index[slot]);
+    Index[slot] = NULL;
+  }
+
+  if ((here = ftell(ifp)) < 0) return NULL;
+
+  ix = (struct input_index *) smalloc(sizeof(struct input_index));
+  memset(ix, 0, sizeof(struct input_index));
+  ix->ifp = ifp;
+  ix->dev = st.st_dev;
+  ix->ino = st.st_ino;
+  ix->size = st.st_size;
+  ix->mtime = st.st_mtime;
+  ix->buf = (char *) smalloc(st.st_size + 1);
+  rewind(ifp);
+  ix->len = (long) fread(ix->buf, 1, st.st_size, ifp);
+  ix->buf[ix->len] = '\0';
+  fseek(ifp, here, SEEK_SET);
+  if (ix->len != (long) st.st_size) {
+    index_free(ix);
+    return NULL;
+  }
+
+  Index[slot] = ix;
+  return ix;
+}
+
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
+int
+input_index_find(FILE *ifp,
+		 const char *string,
+		 const char ch_term,
+		 const int from_start)
+
+    /*************************************************************************
+     *
+     * input_index_find():
+     *
+     *  Find the card string the way reading ifp with read_string(..,
+     *  ch_term) and strip() from its start (or from where it is) would.
+     *
+     *  Return:  1 found, ifp left just past the ch_term of the card
+     *          -1 not found, ifp left where it was
+     *           0 the index cannot answer this one; scan for it instead
+     *************************************************************************/
+{
+  struct input_index *ix;
+  struct input_split *sp = NULL;
+  long from, stop;
+  int s, i, lo, hi;
+
+  if (ifp == NULL || string == NULL) return 0;
+  if ((ix = index_of(ifp)) == NULL) return 0;
+
+  from = 0;
+  if (!from_start) {
+    if ((from = ftell(ifp)) < 0 || from > ix->len) return 0;
+    if (from > 0 && ix->buf[from-1] != '\n' && ix->buf[from-1] != ch_term) {
+      return 0;
+    }
+  }
+
+  for (s = 0; s < ix->nsplit; s++) {
+    if (ix->split[s].ch_term == ch_term) sp = &ix->split[s];
+  }
+  if (sp == NULL) {
+    if (ix->nsplit == INPUT_INDEX_MAX_SPLITS) return 0;
+    sp = &ix->split[ix->nsplit++];
+    split_build(ix, sp, ch_term);
+  }
+
+  /* the first failing piece at or after from ends the search */
+  lo = 0;
+  hi = sp->nfail - 1;
+  while (lo < hi) {
+    i = (lo + hi) / 2;
+    if (sp->fail[i] < from) lo = i + 1; else hi = i;
+  }
+  stop = sp->fail[lo];
+
+  i = sp->bucket[hash_string(string) & (sp->nbucket - 1)];
+  for (; i >= 0 && sp->start[i] < stop; i = sp->chain[i]) {
+    if (sp->start[i] < from) continue;
+    if (strcmp(sp->arena + sp->text[i], string) == 0) {
+      fseek(ifp, sp->next[i], SEEK_SET);
+      return 1;
+    }
+  }
+  return -1;
+}
+
+/*****************************************************************************/
+
+void
+input_index_free(FILE *ifp)
+{
+  int i;
+
+  for (i = 0; i < INPUT_INDEX_MAX_FILES; i++) {
+    if (Index[i] != NULL && (ifp == NULL || Index[i]->ifp == ifp)) {
+      index_free(Index[i]);
+      Index[i] = NULL;
+    }
+  }
+}
+/*****************************************************************************/
+/* END of file mm_input_index.c */
+/*****************************************************************************/
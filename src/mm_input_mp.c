@@ -2741,6 +2741,21 @@ rd_mp_specs(FILE *imp, char input[], int mn, char *echo_file)
 	      SPF_DBL_VEC(endofstring(es), num_const, vn_glob[mn]->dg_J_model_wt );
 
 	    }
+	  else  if ( !strcmp(model_name, "CONDENSED"))
+	    {
+	      vn_glob[mn]->dg_J_model = CONDENSED_DG;
+
+	      num_const = read_constants(imp, &( vn_glob[mn]->dg_J_model_wt),
+					 NO_SPECIES);
+	      if ( num_const < 1)
+		{
+		 log_err(
+                 "Matl %s expected at least 1 constants for %s model.\n",
+		 pd_glob[mn]->MaterialName, "CONDENSED weighting factor");
+		}
+	      vn_glob[mn]->len_dg_J_model_wt = num_const;
+	      SPF_DBL_VEC(endofstring(es), num_const, vn_glob[mn]->dg_J_model_wt );
+	    }
 	  else  if ( !strcmp(model_name, "SEGREGATED"))
 	    {
 	      vn_glob[mn]->dg_J_model = SEGREGATED;
@@ -5464,6 +5479,26 @@ ECHO("\n----Acoustic Properties\n", echo_file);
 	}
       ECHO(es,echo_file);   
 
+      /* optional, anywhere after Saturation; tabulates VAN_GENUCHTEN */
+      mat_ptr->saturation_table_tol = 0.0;
+      if (mat_ptr->SaturationModel == VAN_GENUCHTEN) {
+	char input[MAX_CHAR_IN_INPUT] = "zilch\0";
+	fpos_t sat_pos;
+	fgetpos(imp, &sat_pos);
+	model_read = look_for_optional(imp, "Saturation Table Tolerance",
+				       input, '=');
+	if (model_read == 1) {
+	  if (fscanf(imp, "%lf", &(mat_ptr->saturation_table_tol)) != 1 ||
+	      mat_ptr->saturation_table_tol <= 0.0) {
+	    EH(-1, "Saturation Table Tolerance needs one positive value");
+	  }
+	  SPF(es, "%s = %g", "Saturation Table Tolerance",
+	      mat_ptr->saturation_table_tol);
+	  ECHO(es, echo_file);
+	}
+	fsetpos(imp, &sat_pos);
+      }
+
       if (pd_glob[mn]->e[R_POR_ENERGY]) {
       /*
        * Density of solid matrix
@@ -10720,7 +10755,82 @@ ECHO("\n----Acoustic Properties\n", echo_file);
       ECHO(es, echo_file);
     }
   }
-  
+
+  /*
+   * Property Plugin = <property> [species] <library> <function>
+   *
+   * The USER model of the property is computed by the function of
+   * the shared library, with the model's constants, in place of its
+   * usr_ routine; see goma_plugin.h.
+   */
+  for (i = 0; i < MAX_PLUGIN_SLOTS; i++) mat_ptr->Plugin[i] = -1;
+  rewind(imp);
+  while (look_forward_optional(imp, "Property Plugin", input, '=') == 1)
+    {
+      char library[MAX_FNL], function[MAX_FNL];
+      int prop, model = NO_MODEL;
+
+      if (fscanf(imp, "%80s", model_name) != 1)
+	{
+	  EH(-1, "Error reading the property of a Property Plugin card");
+	}
+      prop = plugin_property_id(model_name);
+      species_no = 0;
+      if (prop == GOMA_PLUGIN_DIFFUSIVITY &&
+	  (fscanf(imp, "%d", &species_no) != 1 ||
+	   species_no < 0 || species_no >= mat_ptr->Num_Species))
+	{
+	  sprintf(err_msg, "Property Plugin DIFFUSIVITY in material %s needs a species number",
+		  pd_glob[mn]->MaterialName);
+	  EH(-1, err_msg);
+	}
+      if (fscanf(imp, "%127s %127s", library, function) != 2)
+	{
+	  sprintf(err_msg, "Property Plugin %s in material %s needs a library and a function",
+		  model_name, pd_glob[mn]->MaterialName);
+	  EH(-1, err_msg);
+	}
+
+      switch (prop)
+	{
+	case GOMA_PLUGIN_VISCOSITY:
+	  model = mat_ptr->ViscosityModel;
+	  break;
+	case GOMA_PLUGIN_DENSITY:
+	  model = mat_ptr->DensityModel;
+	  break;
+	case GOMA_PLUGIN_THERMAL_CONDUCTIVITY:
+	  model = mat_ptr->ConductivityModel;
+	  break;
+	case GOMA_PLUGIN_HEAT_SOURCE:
+	  model = mat_ptr->HeatSourceModel;
+	  break;
+	case GOMA_PLUGIN_DIFFUSIVITY:
+	  model = mat_ptr->DiffusivityModel[species_no];
+	  break;
+	default:
+	  sprintf(err_msg, "Property Plugin: unknown property %s in material %s",
+		  model_name, pd_glob[mn]->MaterialName);
+	  EH(-1, err_msg);
+	}
+      if (model != USER)
+	{
+	  sprintf(err_msg, "Property Plugin %s in material %s needs a USER model of the property",
+		  model_name, pd_glob[mn]->MaterialName);
+	  EH(-1, err_msg);
+	}
+
+      mat_ptr->Plugin[(prop == GOMA_PLUGIN_DIFFUSIVITY) ? prop + species_no : prop] =
+	plugin_register(library, function);
+
+      if (prop == GOMA_PLUGIN_DIFFUSIVITY)
+	SPF(es, "%s = %s %d %s %s", "Property Plugin", model_name, species_no,
+	    library, function);
+      else
+	SPF(es, "%s = %s %s %s", "Property Plugin", model_name, library, function);
+      ECHO(es, echo_file);
+    }
+
   /*********************************************************************/
 
 
@@ -303,6 +303,8 @@ rd_particle_specs(FILE *ifp, char *input)
 	Particle_Output_Format = TECPLOT;
       else if(!strncmp("FLAT_TEXT", s_tmp, 9))
 	Particle_Output_Format = FLAT_TEXT;
+      else if(!strncmp("BINARY", s_tmp, 6))
+	Particle_Output_Format = BINARY;
       else
 	{
 	  sprintf(s_tmp_save, "Unknown Output format: %s\n", s_tmp);
@@ -453,6 +455,17 @@ rd_particle_specs(FILE *ifp, char *input)
       sprintf(Particle_Full_Output_Filename, "<not active>");
     }
 
+  /* Regroup the particles by element in memory every this many steps;
+   * 0 never does. */
+  if(look_for_optional(ifp, "Compaction stride", input, '=') == 1)
+    {
+      if(fscanf(ifp, "%d", &Particle_Compaction_Stride) != 1 || Particle_Compaction_Stride < 0)
+	EH(-1, "Problem reading Compaction stride card.");
+      printf("Compacting the particle lists every %d steps\n", Particle_Compaction_Stride);
+    }
+  else
+    Particle_Compaction_Stride = 0;
+
   /* General description for number of particles to track, and how
    * many of them.  Can specify multiple selections, and the particles
    * will be separate samples.  Subject to total number of particles,
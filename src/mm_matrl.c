@@ -482,7 +482,10 @@ calc_density(MATRL_PROP_STRUCT *matrl, int doJac,
   } 
   else if (matrl->DensityModel == USER )  
     {
-    (void) usr_density(matrl->u_density);      
+    if (matrl->Plugin[GOMA_PLUGIN_DENSITY] >= 0)
+      (void) plugin_property(GOMA_PLUGIN_DENSITY, -1, tran->time_value);
+    else
+      (void) usr_density(matrl->u_density);
     rho = matrl->density;
 
   } 
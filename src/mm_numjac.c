@@ -120,15 +120,51 @@ static void free_int_linked_list(IntLinkedList *list)
   free(list);
 }
 
-/* Find the matrix coloring for finite difference
+/* Collect the columns sharing a row with column j, other than j itself.
+ * These are the neighbors of j in the column intersection graph, i.e. the
+ * columns within distance 2 of j in the bipartite row/column graph.
+ * mark[] must not hold stamp on entry for any column. */
+static int column_neighbors(const int j,
+			    const int bindx[],
+			    const int colptr[],
+			    const int rowidx[],
+			    int mark[],
+			    const int stamp,
+			    int nbr[])
+{
+  int i, k, r, c;
+  int n = 0;
+
+  mark[j] = stamp;
+  for (i = colptr[j]; i < colptr[j+1]; i++) {
+    r = rowidx[i];
+    if (mark[r] != stamp) {
+      mark[r] = stamp;
+      nbr[n++] = r;
+    }
+    for (k = bindx[r]; k < bindx[r+1]; k++) {
+      c = bindx[k];
+      if (mark[c] != stamp) {
+	mark[c] = stamp;
+	nbr[n++] = c;
+      }
+    }
+  }
+  return n;
+}
 
-   Coloring is determined in a greedy fashion,
-   might be useful to use actual algorithms in the future
-   or an external library (ColPack)
+/* Find the matrix coloring for finite difference
 
    Color each coloumn such that all columns
    with the same color share no rows containing
    nonzeros in that column
+
+   This is a distance-2 coloring of the bipartite row/column graph,
+   done greedily in smallest-last order (Matula and Beck): columns
+   are repeatedly removed at minimum remaining degree and then colored
+   in the reverse of the removal order, so the densely coupled columns
+   get the first pick of the colors.  This usually needs noticeably
+   fewer colors, and so residual fills, than coloring in unknown order.
 */
 Coloring* find_coloring(struct Aztec_Linear_Solver_System *ams,
 			int num_unknowns,
@@ -142,7 +178,7 @@ Coloring* find_coloring(struct Aztec_Linear_Solver_System *ams,
   int *row = calloc(sizeof(int), ams->bindx[num_unknowns]);
   int *colptr = calloc(sizeof(int), num_unknowns+1);
   int *rowidx;
-  int *has_row;
+  int *color_taken;
   int *column_color;
   Coloring *coloring = malloc(sizeof(Coloring));
 #ifdef DEBUG_FD_COLORING
@@ -198,47 +234,108 @@ Coloring* find_coloring(struct Aztec_Linear_Solver_System *ams,
 
   column_color = malloc(sizeof(int) * num_unknowns);
 
+  /* smallest-last ordering
+   *
+   * Columns sit in doubly linked buckets by their degree among the
+   * columns not yet removed.  Removing a column only lowers the degree
+   * of its neighbors by one, so the minimum degree bucket is found by
+   * stepping down at most one from the last one.
+   */
+  int *mark = malloc(sizeof(int) * num_unknowns);
+  int *nbr = malloc(sizeof(int) * num_unknowns);
+  int *degree = malloc(sizeof(int) * num_unknowns);
+  int *order = malloc(sizeof(int) * num_unknowns);
+  int *next = malloc(sizeof(int) * num_unknowns);
+  int *prev = malloc(sizeof(int) * num_unknowns);
+  int *bucket;
+  int stamp = 0;
+  int max_degree = 0;
+  int min_degree, n, k, pos;
+
   for (j = 0; j < num_unknowns; j++) {
+    mark[j] = -1;
     column_color[j] = -1;
   }
 
-  /* greedy coloring
+  for (j = 0; j < num_unknowns; j++) {
+    degree[j] = column_neighbors(j, ams->bindx, colptr, rowidx, mark, stamp++, nbr);
+    if (degree[j] > max_degree) max_degree = degree[j];
+  }
+
+  bucket = malloc(sizeof(int) * (max_degree + 1));
+  for (k = 0; k <= max_degree; k++) {
+    bucket[k] = -1;
+  }
+  for (j = 0; j < num_unknowns; j++) {
+    prev[j] = -1;
+    next[j] = bucket[degree[j]];
+    if (next[j] != -1) prev[next[j]] = j;
+    bucket[degree[j]] = j;
+  }
+
+  /* column_color[] marks removed columns with -2 until coloring */
+  min_degree = 0;
+  for (pos = num_unknowns - 1; pos >= 0; pos--) {
+    while (bucket[min_degree] == -1) min_degree++;
+    j = bucket[min_degree];
+    bucket[min_degree] = next[j];
+    if (next[j] != -1) prev[next[j]] = -1;
+    order[pos] = j;
+    column_color[j] = -2;
+
+    n = column_neighbors(j, ams->bindx, colptr, rowidx, mark, stamp++, nbr);
+    for (k = 0; k < n; k++) {
+      int c = nbr[k];
+      if (column_color[c] == -2) continue;
+      /* move c down one bucket */
+      if (prev[c] != -1) {
+	next[prev[c]] = next[c];
+      } else {
+	bucket[degree[c]] = next[c];
+      }
+      if (next[c] != -1) prev[next[c]] = prev[c];
+      degree[c]--;
+      prev[c] = -1;
+      next[c] = bucket[degree[c]];
+      if (next[c] != -1) prev[next[c]] = c;
+      bucket[degree[c]] = c;
+    }
+    if (min_degree > 0) min_degree--;
+  }
+
+  /* greedy coloring in that order
    *
-   * Assign column to a color only if that
-   * color is not already associated with rows
-   * in the column
+   * Give each column the lowest color not
+   * already taken by one of its neighbors
    */
-  int num_colored = 0;
   int num_colors = 0;
-  has_row = calloc(num_unknowns, sizeof(int));
-  // until all columns have a color
-  while (num_colored < num_unknowns) {
-    // Color ever column we can with the current color
-    for (j = 0; j < num_unknowns; j++) {
-      if (column_color[j] == -1) {
-	// Only valid if all rows are not in this color
-	int valid = TRUE;
-	for (i = colptr[j]; i < colptr[j+1]; i++) {
-	  if (has_row[rowidx[i]]) {
-	    valid = FALSE;
-	    break;
-	  }
-	}
-
-	// We can add this column to the current color
-	if (valid) {
-	  for (i = colptr[j]; i < colptr[j+1]; i++) {
-	    has_row[rowidx[i]] = TRUE;
-	  }
-	  column_color[j] = num_colors;
-	  num_colored++;
-	}
-      }
+  color_taken = malloc(sizeof(int) * (max_degree + 1));
+  for (k = 0; k <= max_degree; k++) {
+    color_taken[k] = -1;
+  }
+  for (j = 0; j < num_unknowns; j++) {
+    column_color[j] = -1;
+  }
+  for (pos = 0; pos < num_unknowns; pos++) {
+    int c;
+    j = order[pos];
+    n = column_neighbors(j, ams->bindx, colptr, rowidx, mark, stamp++, nbr);
+    for (k = 0; k < n; k++) {
+      if (column_color[nbr[k]] >= 0) color_taken[column_color[nbr[k]]] = j;
     }
-    memset(has_row, 0, sizeof(int) * num_unknowns);
-    num_colors++;
+    for (c = 0; color_taken[c] == j; c++);
+    column_color[j] = c;
+    if (c + 1 > num_colors) num_colors = c + 1;
   }
 
+  free(bucket);
+  free(prev);
+  free(next);
+  free(order);
+  free(degree);
+  free(nbr);
+  free(mark);
+
   coloring->num_colors = num_colors;
   coloring->column_color = column_color;
 #ifdef DEBUG_FD_COLORING
@@ -276,7 +373,7 @@ Coloring* find_coloring(struct Aztec_Linear_Solver_System *ams,
   coloring->colptr = colptr;
   coloring->rowptr = rowidx;
   coloring->nnz = nnz;
-  free(has_row);
+  free(color_taken);
   return coloring;
 }
 
@@ -287,6 +384,279 @@ void free_coloring(Coloring *coloring) {
   free(coloring);
 }
 
+/* TRUE if the colors of the stress numerical jacobian may be filled
+ * concurrently: on top of what threaded assembly needs, none of the
+ * boundary conditions may keep state between elements, i.e. the side
+ * quadrature point storage and the static contact angle tables of
+ * matrix_fill_stress()
+ */
+static int numjac_threads_active(Exo_DB *exo)
+{
+  int ibc;
+
+  if (!assembly_threads_active(exo)) return FALSE;
+
+  for (ibc = 0; ibc < Num_BC; ibc++) {
+    switch (BC_Types[ibc].BC_Name) {
+    case VL_EQUIL_PRXN_BC:
+    case IS_EQUIL_PRXN_BC:
+    case CA_BC:
+    case CA_MOMENTUM_BC:
+    case VELO_THETA_HOFFMAN_BC:
+    case VELO_THETA_TPL_BC:
+    case VELO_THETA_COX_BC:
+    case VELO_THETA_SHIK_BC:
+      return FALSE;
+    default:
+      break;
+    }
+  }
+  return TRUE;
+}
+
+/* Finite difference the columns of one color
+
+   Perturbs x_1[] and xdot[] at every column of the color, fills the
+   residual resid_vector_1[] over the elements the perturbations reach,
+   stores the differences into nj[] and puts x_1[] and xdot[] back.
+   The columns of different colors are disjoint, so different colors may
+   run concurrently given their own x_1[], xdot[] and resid_vector_1[].
+*/
+static void numjac_color_fill(struct Aztec_Linear_Solver_System *ams,
+			      const Coloring *coloring,
+			      const int color,
+			      double x[],
+			      double x_1[],
+			      double resid_vector[],
+			      double resid_vector_1[],
+			      double xdot[],
+			      double dx_col[],
+			      double nj[],
+			      const double x_scale[],
+			      int v_s[MAX_MODES][DIM][DIM],
+			      const int num_modes,
+			      const int em_on,
+			      double delta_t,
+			      double theta,
+			      double x_old[],
+			      double x_older[],
+			      double xdot_old[],
+			      double x_update[],
+			      int num_total_nodes,
+			      struct elem_side_bc_struct *first_elem_side_BC_array[],
+			      double time_value,
+			      Exo_DB *exo,
+			      Dpi *dpi,
+			      double *h_elem_avg,
+			      double *U_norm,
+			      const int zeroCA)
+{
+  int i, j, idx, mode;
+  int var_i, var_j;
+  int my_elem_num, my_node_num;
+  int numProcUnknowns = NumUnknowns + NumExtUnknowns;
+  int zero_CA = zeroCA;
+  double dx;
+  char errstring[256];
+  IntLinkedList *elem_list = NULL;
+#ifdef DEBUG_FD_COLORING
+  double t1, t2, t3, t4;
+  t1 = MPI_Wtime();
+#endif
+  memset(resid_vector_1, 0, NumUnknowns*sizeof(dbl));
+  /*
+   * Perturb many variables
+   */
+#ifdef DEBUG_FD_COLORING
+  int count = 0;
+  int elem_count = 0;
+#endif
+  for (j = 0; j < numProcUnknowns; j++) {
+    if (coloring->column_color[j] == color) {
+      dx = x_scale[idv[j][0]] * FD_DELTA_UNKNOWN;
+      if(dx < 1.0E-15) dx = 1.0E-7;
+      x_1[j] = x[j] + dx;
+
+      if (pd_glob[0]->TimeIntegration != STEADY) {
+	xdot[j] += (x_1[j] - x[j])  * (1.0 + 2 * theta) / delta_t;
+      }
+
+      dx_col[j] = dx;
+#ifdef DEBUG_FD_COLORING
+      count++;
+#endif
+      my_node_num = idv[j][2];
+
+      for(i = exo->node_elem_pntr[my_node_num];
+	  i < exo->node_elem_pntr[my_node_num+1]; i++) {
+	my_elem_num = exo->node_elem_list[i];
+	if (elem_list == NULL) {
+	  elem_list = malloc(sizeof(IntLinkedList));
+	  elem_list->val = my_elem_num;
+	  elem_list->next = NULL;
+#ifdef DEBUG_FD_COLORING
+	  elem_count++;
+#endif
+	} else if (item_in_int_linked_list(elem_list, my_elem_num)) {
+	  EH(-1, "Jacobian elem coloring error, trying to assemble already accounted for element");
+	} else {
+	  int_linked_list_prepend(elem_list, my_elem_num);
+#ifdef DEBUG_FD_COLORING
+	  elem_count++;
+#endif
+	}
+      }
+
+      for(i = exo->node_elem_pntr[my_node_num];
+	  i < exo->node_elem_pntr[my_node_num+1]; i++) {
+	my_elem_num = exo->node_elem_list[i];
+	int k;
+	for(k = exo->elem_node_pntr[my_elem_num];
+	    k < exo->elem_node_pntr[my_elem_num+1]; k++) {
+	  int node_num = exo->elem_node_list[k];
+	  int l;
+	  for(l = exo->node_elem_pntr[node_num];
+	      l < exo->node_elem_pntr[node_num+1]; l++) {
+	    int elem_num = exo->node_elem_list[l];
+	    if(elem_num == -1) {
+	      continue;
+	    }
+	    if(!item_in_int_linked_list(elem_list, elem_num)) {
+	      int_linked_list_prepend(elem_list, elem_num);
+#ifdef DEBUG_FD_COLORING
+	      elem_count++;
+#endif
+	    }
+	  }
+	}
+      }
+    }
+  }
+
+#ifdef DEBUG_FD_COLORING
+  printf("ColorStats %d [elem = %d], [count = %d]\n", color, elem_count, count);
+  t2 = MPI_Wtime();
+  printf( "%d Color0 time is %f\n", ProcID, t2 - t1 );
+#endif
+
+  IntLinkedList *elptr;
+  for (elptr = elem_list; elptr != NULL; elptr = elptr->next) {
+    int ielem = elptr->val;
+    int ebn;
+    /*First we must calculate the material-referenced element
+     *number so as to be compatible with the ElemStorage struct
+     */
+    ebn = find_elemblock_index(ielem, exo);
+    int mn = Matilda[ebn];
+    if (mn < 0) {
+      continue;
+    }
+
+    /*needed for saturation hyst. func. */
+    PRS_mat_ielem = ielem - exo->eb_ptr[ebn];
+
+    matrix_fill_stress(ams, x_1, resid_vector_1,
+		       x_old, x_older,  xdot, xdot_old, x_update,
+		       &delta_t, &theta,
+		       first_elem_side_BC_array,
+		       &time_value, exo, dpi,
+		       &ielem, &num_total_nodes,
+		       h_elem_avg, U_norm, NULL, zero_CA);
+    zero_CA = -1;
+
+  }
+
+#ifdef DEBUG_FD_COLORING
+  t3 = MPI_Wtime();
+  printf( "%d Color1 time is %f\n", ProcID, t3 - t2 );
+#endif
+
+  for (j = 0; j < numProcUnknowns; j++) {
+    if (color == coloring->column_color[j]) {
+      for (idx = coloring->colptr[j]; idx < coloring->colptr[j + 1];
+	   idx++) {
+	i = coloring->rowptr[idx];
+	var_i = idv[i][0];
+	var_j = idv[j][0];
+	int gnode;
+	int ivd;
+	int i_offset;
+	int idof;
+	Index_Solution_Inv(i, &gnode, &ivd, &i_offset, &idof);
+
+	if (em_on) {
+	  if (Inter_Mask[var_i][var_j]) {
+	    int ja = (i == j) ? j
+			      : in_list(j, ams->bindx[i], ams->bindx[i + 1],
+					ams->bindx);
+	    if (ja == -1) {
+	      sprintf(errstring,
+		      "Index not found (%d, %d) for interaction (%d, %d)",
+		      i, j, idv[i][0], idv[j][0]);
+	      EH(ja, errstring);
+	    }
+	    if (Nodes[gnode]->DBC && Nodes[gnode]->DBC[i_offset] != -1 &&
+		i == j) {
+	      nj[ja] = 1.0;
+	    } else if (Nodes[gnode]->DBC &&
+		       Nodes[gnode]->DBC[i_offset] != -1) {
+	      nj[ja] = 0.0;
+	    } else {
+	      nj[ja] = (resid_vector_1[i] - resid_vector[i]) / (dx_col[j]);
+	    }
+	  }
+	}
+
+	for (mode = 0; mode < num_modes; mode++) {
+	  /* Only for stress terms */
+	  if (idv[i][0] >= v_s[mode][0][0] &&
+	      idv[i][0] <= v_s[mode][2][2]) {
+
+	    if (Inter_Mask[var_i][var_j]) {
+
+	      int ja = (i == j) ? j
+				: in_list(j, ams->bindx[i],
+					  ams->bindx[i + 1], ams->bindx);
+	      if (ja == -1) {
+		sprintf(errstring,
+			"Index not found (%d, %d) for interaction (%d, %d)",
+			i, j, idv[i][0], idv[j][0]);
+		EH(ja, errstring);
+	      }
+	      if (Nodes[gnode]->DBC && Nodes[gnode]->DBC[i_offset] != -1 &&
+		  i == j) {
+		nj[ja] = 1.0;
+	      } else if (Nodes[gnode]->DBC &&
+			 Nodes[gnode]->DBC[i_offset] != -1) {
+		nj[ja] = 0.0;
+	      } else {
+		nj[ja] = (resid_vector_1[i] - resid_vector[i]) / (dx_col[j]);
+	      }
+	    }
+	  }
+	} // Loop over modes
+      }
+    }
+  }
+
+  /*
+   * return solution vector to its original state
+   */
+  for (j = 0; j < numProcUnknowns; j++) {
+    if (coloring->column_color[j] == color) {
+      if (pd_glob[0]->TimeIntegration != STEADY) {
+	xdot[j] -= (x_1[j] - x[j])  * (1.0 + 2 * theta) / delta_t;
+      }
+      x_1[j] = x[j];
+    }
+  }
+  free_int_linked_list(elem_list);
+#ifdef DEBUG_FD_COLORING
+  t4 = MPI_Wtime();
+  printf( "%d Color2 time is %f\n", ProcID, t4 - t3 );
+#endif
+}
+
 void
 numerical_jacobian_compute_stress(struct Aztec_Linear_Solver_System *ams,
 		   double x[],	/* Solution vector for the current processor */
@@ -348,22 +718,18 @@ numerical_jacobian_compute_stress(struct Aztec_Linear_Solver_System *ams,
   between the two solution points.
 ******************************************************************************/
 {
-  int i, j, nnonzero;
-  int idx, color;
+  int i, nnonzero;
+  int color, num_serial_colors, threaded;
   int zeroCA = 1;
   double *resid_vector_1, *x_1;
-  double dx;
   int *irow, *jcolumn, *nelem;
   int v_s[MAX_MODES][DIM][DIM];
-  int mode;
-  int my_elem_num, my_node_num;
-  IntLinkedList *elem_list = NULL;
-  int var_i, var_j;
+  int num_modes, em_on;
+  int var_i;
   double *dx_col;
   double x_scale[MAX_VARIABLE_TYPES];
   int count[MAX_VARIABLE_TYPES];
   double *nj;
-  char errstring[256];
   double *resid_vector_save;
   int numProcUnknowns = NumUnknowns + NumExtUnknowns;
   // assuming we are only computing coloring once, and that the matrix does not change
@@ -445,223 +811,80 @@ numerical_jacobian_compute_stress(struct Aztec_Linear_Solver_System *ams,
   // Coloring is made the default as the cost of coloring is small
   coloring = find_coloring(ams, numProcUnknowns, num_total_nodes, exo, dpi);
 
+  af->Assemble_Residual = TRUE;
+  af->Assemble_LSA_Jacobian_Matrix = FALSE;
+  af->Assemble_LSA_Mass_Matrix = FALSE;
+  af->Assemble_Jacobian = FALSE;
+  neg_elem_volume = FALSE;
+  neg_lub_height = FALSE;
+  zero_detJ = FALSE;
+
   /*
-   *  now calculate analytical and numerical jacobians at perturbed values
-   *  check that the perturbed residuals are consistent with range possible
-   *  for range of analytical jacobian values
+   * the threads' own pd and vn are not set until their first fill,
+   * so take these from the master's
+   */
+  em_on = pd->v[EM_E1_REAL];
+  num_modes = vn->modes;
+
+  /*
+   *  now calculate the numerical jacobian one color at a time; with
+   *  threads only the first color is done here, since matrix_fill_stress()
+   *  does its once-per-fill initialization on the first call
    */
-  for (color = 0; color < coloring->num_colors; color++)       /* loop over each color */
+  threaded = numjac_threads_active(exo);
+  num_serial_colors = threaded ? MIN(1, coloring->num_colors) : coloring->num_colors;
+  for (color = 0; color < num_serial_colors; color++)       /* loop over each color */
     {
-#ifdef DEBUG_FD_COLORING
-      double t1, t2, t3, t4;
-      t1 = MPI_Wtime();
-#endif
-      memset(resid_vector_1, 0, NumUnknowns*sizeof(dbl));
+      numjac_color_fill(ams, coloring, color, x, x_1, resid_vector,
+			resid_vector_1, xdot, dx_col, nj, x_scale, v_s,
+			num_modes, em_on, delta_t, theta, x_old, x_older,
+			xdot_old, x_update, num_total_nodes,
+			first_elem_side_BC_array, time_value, exo, dpi,
+			h_elem_avg, U_norm, zeroCA);
+      zeroCA = -1;
       /*
-       * Perturb many variables
+       * Clear the quadrature point storage for the next fill
        */
-#ifdef DEBUG_FD_COLORING
-      int count = 0;
-      int elem_count = 0;
-#endif
-      for (j = 0; j < numProcUnknowns; j++) {
-	if (coloring->column_color[j] == color) {
-	  dx = x_scale[idv[j][0]] * FD_DELTA_UNKNOWN;
-	  if(dx < 1.0E-15) dx = 1.0E-7;
-	  x_1[j] = x[j] + dx;
-
-	  if (pd_glob[0]->TimeIntegration != STEADY) {
-	    xdot[j] += (x_1[j] - x[j])  * (1.0 + 2 * theta) / delta_t;
-	  }
-
-	  dx_col[j] = dx;
-#ifdef DEBUG_FD_COLORING
-	  count++;
-#endif
-	  my_node_num = idv[j][2];
-
-	  for(i = exo->node_elem_pntr[my_node_num];
-	      i < exo->node_elem_pntr[my_node_num+1]; i++) {
-	    my_elem_num = exo->node_elem_list[i];
-	    if (elem_list == NULL) {
-	      elem_list = malloc(sizeof(IntLinkedList));
-	      elem_list->val = my_elem_num;
-	      elem_list->next = NULL;
-#ifdef DEBUG_FD_COLORING
-	      elem_count++;
-#endif
-	    } else if (item_in_int_linked_list(elem_list, my_elem_num)) {
-	      EH(-1, "Jacobian elem coloring error, trying to assemble already accounted for element");
-	    } else {
-	      int_linked_list_prepend(elem_list, my_elem_num);
-#ifdef DEBUG_FD_COLORING
-	      elem_count++;
-#endif
-	    }
-	  }
-
-	  for(i = exo->node_elem_pntr[my_node_num];
-	      i < exo->node_elem_pntr[my_node_num+1]; i++) {
-	    my_elem_num = exo->node_elem_list[i];
-	    int k;
-	    for(k = exo->elem_node_pntr[my_elem_num];
-		k < exo->elem_node_pntr[my_elem_num+1]; k++) {
-	      int node_num = exo->elem_node_list[k];
-	      int l;
-	      for(l = exo->node_elem_pntr[node_num];
-		  l < exo->node_elem_pntr[node_num+1]; l++) {
-		int elem_num = exo->node_elem_list[l];
-		if(elem_num == -1) {
-		  continue;
-		}
-		if(!item_in_int_linked_list(elem_list, elem_num)) {
-		  int_linked_list_prepend(elem_list, elem_num);
-#ifdef DEBUG_FD_COLORING
-		  elem_count++;
-#endif
-		}
-	      }
-	    }
-	  }
-	}
-      }
-
-#ifdef DEBUG_FD_COLORING
-      printf("ColorStats %d [elem = %d], [count = %d]\n", color, elem_count, count);
-      t2 = MPI_Wtime();
-      printf( "%d Color0 time is %f\n", ProcID, t2 - t1 );
-#endif
-
-      af->Assemble_Residual = TRUE;
-      af->Assemble_LSA_Jacobian_Matrix = FALSE;
-      af->Assemble_LSA_Mass_Matrix = FALSE;
-      af->Assemble_Jacobian = FALSE;
-      neg_elem_volume = FALSE;
-      neg_lub_height = FALSE;
-      zero_detJ = FALSE;
+      global_qp_storage_reset();
+    }
 
-      IntLinkedList *elptr;
-      for (elptr = elem_list; elptr != NULL; elptr = elptr->next) {
-	int ielem = elptr->val;
-	int ebn;
-	/*First we must calculate the material-referenced element
-	 *number so as to be compatible with the ElemStorage struct
-	 */
-	ebn = find_elemblock_index(ielem, exo);
-	int mn = Matilda[ebn];
-	if (mn < 0) {
-	  continue;
+#ifdef _OPENMP
+  /*
+   * remaining colors shared out amongst the assembly threads, each
+   * with its own perturbed copy of x and xdot and its own residual
+   */
+  if (threaded && num_serial_colors < coloring->num_colors)
+    {
+      /* the caller may have changed parameters since the last fill */
+      assembly_threads_refresh();
+
+#pragma omp parallel
+      {
+	double *x_t = malloc(numProcUnknowns*sizeof(double));
+	double *xdot_t = malloc(numProcUnknowns*sizeof(double));
+	double *resid_t = calloc(numProcUnknowns, sizeof(double));
+	int c;
+
+	memcpy(x_t, x, numProcUnknowns*(sizeof(double)));
+	memcpy(xdot_t, xdot, numProcUnknowns*(sizeof(double)));
+
+#pragma omp for schedule(dynamic, 1)
+	for (c = num_serial_colors; c < coloring->num_colors; c++) {
+	  if (neg_elem_volume || neg_lub_height || zero_detJ) continue;
+	  numjac_color_fill(ams, coloring, c, x, x_t, resid_vector,
+			    resid_t, xdot_t, dx_col, nj, x_scale, v_s,
+			    num_modes, em_on, delta_t, theta, x_old, x_older,
+			    xdot_old, x_update, num_total_nodes,
+			    first_elem_side_BC_array, time_value, exo, dpi,
+			    h_elem_avg, U_norm, -1);
 	}
 
-	/*needed for saturation hyst. func. */
-	PRS_mat_ielem = ielem - exo->eb_ptr[ebn];
-
-	matrix_fill_stress(ams, x_1, resid_vector_1,
-			   x_old, x_older,  xdot, xdot_old, x_update,
-			   &delta_t, &theta,
-			   first_elem_side_BC_array,
-			   &time_value, exo, dpi,
-			   &ielem, &num_total_nodes,
-			   h_elem_avg, U_norm, NULL, zeroCA);
-	zeroCA = -1;  
-
-      }
-
-#ifdef DEBUG_FD_COLORING
-      t3 = MPI_Wtime();
-      printf( "%d Color1 time is %f\n", ProcID, t3 - t2 );
-#endif
-      /*
-       * Free memory allocated above
-       */
-      global_qp_storage_destroy();
-
-      for (j = 0; j < numProcUnknowns; j++) {
-        if (color == coloring->column_color[j]) {
-          for (idx = coloring->colptr[j]; idx < coloring->colptr[j + 1];
-               idx++) {
-            i = coloring->rowptr[idx];
-            var_i = idv[i][0];
-            var_j = idv[j][0];
-            int gnode;
-            int ivd;
-            int i_offset;
-            int idof;
-            Index_Solution_Inv(i, &gnode, &ivd, &i_offset, &idof);
-
-            if (pd->v[EM_E1_REAL]) {
-              if (Inter_Mask[var_i][var_j]) {
-                int ja = (i == j) ? j
-                                  : in_list(j, ams->bindx[i], ams->bindx[i + 1],
-                                            ams->bindx);
-                if (ja == -1) {
-                  sprintf(errstring,
-                          "Index not found (%d, %d) for interaction (%d, %d)",
-                          i, j, idv[i][0], idv[j][0]);
-                  EH(ja, errstring);
-                }
-                if (Nodes[gnode]->DBC && Nodes[gnode]->DBC[i_offset] != -1 &&
-                    i == j) {
-                  nj[ja] = 1.0;
-                } else if (Nodes[gnode]->DBC &&
-                           Nodes[gnode]->DBC[i_offset] != -1) {
-                  nj[ja] = 0.0;
-                } else {
-                  nj[ja] = (resid_vector_1[i] - resid_vector[i]) / (dx_col[j]);
-                }
-              }
-            }
-
-            for (mode = 0; mode < vn->modes; mode++) {
-              /* Only for stress terms */
-              if (idv[i][0] >= v_s[mode][0][0] &&
-                  idv[i][0] <= v_s[mode][2][2]) {
-
-                if (Inter_Mask[var_i][var_j]) {
-
-                  int ja = (i == j) ? j
-                                    : in_list(j, ams->bindx[i],
-                                              ams->bindx[i + 1], ams->bindx);
-                  if (ja == -1) {
-                    sprintf(errstring,
-                            "Index not found (%d, %d) for interaction (%d, %d)",
-                            i, j, idv[i][0], idv[j][0]);
-                    EH(ja, errstring);
-                  }
-                  if (Nodes[gnode]->DBC && Nodes[gnode]->DBC[i_offset] != -1 &&
-                      i == j) {
-                    nj[ja] = 1.0;
-                  } else if (Nodes[gnode]->DBC &&
-                             Nodes[gnode]->DBC[i_offset] != -1) {
-                    nj[ja] = 0.0;
-                  } else {
-                    nj[ja] = (resid_vector_1[i] - resid_vector[i]) / (dx_col[j]);
-                  }
-                }
-              }
-            } // Loop over modes
-          }
-        }
+	free(resid_t);
+	free(xdot_t);
+	free(x_t);
       }
-
-      /*
-       * return solution vector to its original state
-       */
-      for (j = 0; j < numProcUnknowns; j++) {
-	if (coloring->column_color[j] == color) {
-	  if (pd_glob[0]->TimeIntegration != STEADY) {
-	    xdot[j] -= (x_1[j] - x[j])  * (1.0 + 2 * theta) / delta_t;
-	  }
-	}
-      }
-      memcpy(x_1, x, numProcUnknowns*(sizeof(double)));
-      free_int_linked_list(elem_list);
-      elem_list = NULL;
-#ifdef DEBUG_FD_COLORING
-      t4 = MPI_Wtime();
-      printf( "%d Color2 time is %f\n", ProcID, t4 - t3 );
+    }
 #endif
-    }                          /* End of for (j=0; j<numProcUnknowns; j++) */
 
 #ifdef PARALLEL
   neg_elem_volume_global = FALSE;
@@ -1134,7 +1357,7 @@ numerical_jacobian(struct Aztec_Linear_Solver_System *ams,
       }
 
       if ( xfem != NULL )
-        clear_xfem_contribution( ams->npu );
+        clear_xfem_contribution( ams->npu, x_1, exo );
 
       for (i = 0; i < num_elems; i++) {
 	load_ei(elem_list[i], exo, 0);
@@ -1155,9 +1378,9 @@ numerical_jacobian(struct Aztec_Linear_Solver_System *ams,
         check_xfem_contribution( ams->npu, ams, resid_vector_1, x_1, exo );
 
       /*
-       * Free memory allocated above
+       * Clear the quadrature point storage for the next fill
        */
-      global_qp_storage_destroy();
+      global_qp_storage_reset();
 
 #ifdef PARALLEL
       neg_elem_volume_global = FALSE;
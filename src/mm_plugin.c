@@ -0,0 +1,489 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * Property plugins (Property Plugin card of the material file).
+ *
+ * A USER viscosity, density, thermal conductivity, heat source or
+ * diffusivity can be computed by a function in a shared library in place
+ * of the usr_ routine of user_mp.c, with the interface of goma_plugin.h.
+ * Before the volume quadrature loop of an element, the state at all its
+ * Gauss points is interpolated and each plugin property of the material
+ * is evaluated for all the points in one call. At a point, the property
+ * is then copied out into mp exactly as the usr_ routine would have set
+ * it. Where the state differs from that of the batch -- surface and
+ * other quadratures, cut level set elements, finite difference
+ * perturbations -- the plugin is called for the single point instead.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <dlfcn.h>
+
+#include "std.h"
+#include "rf_fem_const.h"
+#include "rf_fem.h"
+#include "rf_io_const.h"
+#include "rf_io.h"
+#include "rf_mp.h"
+#include "el_elm.h"
+#include "el_geom.h"
+#include "rf_vars_const.h"
+#include "mm_mp_const.h"
+#include "mm_as_const.h"
+#include "mm_as_structs.h"
+#include "mm_as.h"
+#include "mm_mp_structs.h"
+#include "mm_mp.h"
+#include "mm_eh.h"
+
+#define _MM_PLUGIN_C
+#include "goma.h"
+
+#define PLUGIN_SAME(a, b) \
+  ((a) == (b) || fabs((a) - (b)) <= 1.e-12 * (fabs(a) + fabs(b)))
+
+static goma_plugin_fn Plugin_Fn[MAX_PLUGINS];
+
+/* state at the Gauss points of the element being assembled */
+static struct
+{
+  int n;			/* 0 if there is no batch */
+  int ielem;
+  struct Material_Properties *mp;
+  dbl time;
+  dbl x[3][MAX_PLUGIN_QP];
+  dbl T[MAX_PLUGIN_QP];
+  dbl P[MAX_PLUGIN_QP];
+  dbl v[3][MAX_PLUGIN_QP];
+  dbl C[MAX_CONC * MAX_PLUGIN_QP];
+} Batch;
+
+/* results of a property at the points of the batch */
+struct plugin_results
+{
+  dbl value[MAX_PLUGIN_QP];
+  dbl d_T[MAX_PLUGIN_QP];
+  dbl d_P[MAX_PLUGIN_QP];
+  dbl d_x[3][MAX_PLUGIN_QP];
+  dbl d_v[3][MAX_PLUGIN_QP];
+  dbl d_C[MAX_CONC * MAX_PLUGIN_QP];
+};
+
+static struct plugin_results *Results[MAX_PLUGIN_SLOTS];
+static int Have_Results[MAX_PLUGIN_SLOTS];
+
+int
+plugin_register(const char *library,
+		const char *function)
+{
+  int k;
+
+  for (k = 0; k < Num_Plugins; k++)
+    {
+      if (strcmp(Plugin_Library[k], library) == 0 &&
+	  strcmp(Plugin_Function[k], function) == 0) return k;
+    }
+  if (Num_Plugins == MAX_PLUGINS)
+    {
+      EH(-1, "Too many Property Plugin functions, increase MAX_PLUGINS");
+    }
+  strncpy(Plugin_Library[k], library, MAX_FNL - 1);
+  strncpy(Plugin_Function[k], function, MAX_FNL - 1);
+  Num_Plugins++;
+  return k;
+}
+
+int
+plugin_property_id(const char *name)
+{
+  if (strcmp(name, "VISCOSITY") == 0) return GOMA_PLUGIN_VISCOSITY;
+  if (strcmp(name, "DENSITY") == 0) return GOMA_PLUGIN_DENSITY;
+  if (strcmp(name, "THERMAL_CONDUCTIVITY") == 0)
+    return GOMA_PLUGIN_THERMAL_CONDUCTIVITY;
+  if (strcmp(name, "HEAT_SOURCE") == 0) return GOMA_PLUGIN_HEAT_SOURCE;
+  if (strcmp(name, "DIFFUSIVITY") == 0) return GOMA_PLUGIN_DIFFUSIVITY;
+  return -1;
+}
+
+/* the function of plugin k, opening its library the first time */
+static goma_plugin_fn
+plugin_function(const int k)
+{
+  void *handle;
+  int *abi;
+  char err_msg[MAX_CHAR_IN_INPUT];
+
+  if (Plugin_Fn[k] != NULL) return Plugin_Fn[k];
+
+  handle = dlopen(Plugin_Library[k], RTLD_NOW | RTLD_LOCAL);
+  if (handle == NULL)
+    {
+      snprintf(err_msg, MAX_CHAR_IN_INPUT, "Property Plugin: %s", dlerror());
+      EH(-1, err_msg);
+    }
+  abi = (int *) dlsym(handle, "goma_plugin_abi_version");
+  if (abi != NULL && *abi != GOMA_PLUGIN_ABI_VERSION)
+    {
+      snprintf(err_msg, MAX_CHAR_IN_INPUT,
+	       "Property Plugin: %s is built for version %d of goma_plugin.h, not %d",
+	       Plugin_Library[k], *abi, GOMA_PLUGIN_ABI_VERSION);
+      EH(-1, err_msg);
+    }
+  *(void **) (&Plugin_Fn[k]) = dlsym(handle, Plugin_Function[k]);
+  if (Plugin_Fn[k] == NULL)
+    {
+      snprintf(err_msg, MAX_CHAR_IN_INPUT, "Property Plugin: %s", dlerror());
+      EH(-1, err_msg);
+    }
+  return Plugin_Fn[k];
+}
+
+static int
+plugin_slot(const int property,
+	    const int species)
+{
+  return (property == GOMA_PLUGIN_DIFFUSIVITY) ? property + species : property;
+}
+
+/* the constants of the property's USER model */
+static void
+plugin_params(const int property,
+	      const int species,
+	      const dbl **params,
+	      int *num_params)
+{
+  switch (property)
+    {
+    case GOMA_PLUGIN_VISCOSITY:
+      *params = mp->u_viscosity;
+      *num_params = mp->len_u_viscosity;
+      break;
+    case GOMA_PLUGIN_DENSITY:
+      *params = mp->u_density;
+      *num_params = mp->len_u_density;
+      break;
+    case GOMA_PLUGIN_THERMAL_CONDUCTIVITY:
+      *params = mp->u_thermal_conductivity;
+      *num_params = mp->len_u_thermal_conductivity;
+      break;
+    case GOMA_PLUGIN_HEAT_SOURCE:
+      *params = mp->u_heat_source;
+      *num_params = mp->len_u_heat_source;
+      break;
+    default:
+      *params = mp->u_diffusivity[species];
+      *num_params = mp->len_u_diffusivity[species];
+    }
+}
+
+/*
+ * Call the plugin of the property on n points of state, the results
+ * going to r, with the same point stride n.
+ */
+static void
+plugin_call(const int property,
+	    const int species,
+	    const int n,
+	    const dbl time,
+	    const dbl *x[3],
+	    const dbl *T,
+	    const dbl *P,
+	    const dbl *v[3],
+	    const dbl *C,
+	    struct plugin_results *r)
+{
+  int a, err;
+  goma_plugin_batch b;
+  char err_msg[MAX_CHAR_IN_INPUT];
+  int k = mp->Plugin[plugin_slot(property, species)];
+
+  memset(r->value, 0, n * sizeof(dbl));
+  memset(r->d_T, 0, n * sizeof(dbl));
+  memset(r->d_P, 0, n * sizeof(dbl));
+  for (a = 0; a < 3; a++)
+    {
+      memset(r->d_x[a], 0, n * sizeof(dbl));
+      memset(r->d_v[a], 0, n * sizeof(dbl));
+    }
+  memset(r->d_C, 0, pd->Num_Species_Eqn * n * sizeof(dbl));
+
+  b.abi_version = GOMA_PLUGIN_ABI_VERSION;
+  b.property = property;
+  b.species = (property == GOMA_PLUGIN_DIFFUSIVITY) ? species : -1;
+  b.n = n;
+  b.dim = pd->Num_Dim;
+  b.num_species = pd->Num_Species_Eqn;
+  plugin_params(property, species, &b.params, &b.num_params);
+  b.time = time;
+  b.T = T;
+  b.P = P;
+  b.C = C;
+  b.value = r->value;
+  b.d_T = r->d_T;
+  b.d_P = r->d_P;
+  b.d_C = r->d_C;
+  for (a = 0; a < 3; a++)
+    {
+      b.x[a] = x[a];
+      b.v[a] = v[a];
+      b.d_x[a] = r->d_x[a];
+      b.d_v[a] = r->d_v[a];
+    }
+
+  err = plugin_function(k)(&b);
+  if (err)
+    {
+      snprintf(err_msg, MAX_CHAR_IN_INPUT,
+	       "Property Plugin %s of %s returned %d in material %s",
+	       Plugin_Function[k], Plugin_Library[k], err, mp->Material_Name);
+      EH(-1, err_msg);
+    }
+}
+
+void
+plugin_element_begin(const int ip_total,
+		     const int ielem_type,
+		     struct Basis_Functions **bfd,
+		     const dbl time)
+
+    /*************************************************************************
+     *
+     * plugin_element_begin():
+     *
+     *  Before the volume quadrature loop of the current element: when the
+     *  loop is the ip_total points of the element's Gauss rule, interpolate
+     *  the state at all of them and evaluate each plugin property of the
+     *  material there. Otherwise there is no batch for the element.
+     *************************************************************************/
+{
+  int ip, i, a, w, s, node, index, var, dofs, nsp;
+  int props[MAX_PLUGIN_SLOTS], species[MAX_PLUGIN_SLOTS], num_props = 0;
+  dbl xi[DIM], phi;
+  const dbl *x[3], *v[3];
+
+  Batch.n = 0;
+  memset(Have_Results, 0, sizeof(Have_Results));
+  if (ip_total <= 0 || ip_total > MAX_PLUGIN_QP) return;
+
+  for (s = 0; s < MAX_PLUGIN_SLOTS; s++)
+    {
+      if (mp->Plugin[s] < 0) continue;
+      props[num_props] = (s < GOMA_PLUGIN_DIFFUSIVITY) ? s : GOMA_PLUGIN_DIFFUSIVITY;
+      species[num_props] = s - props[num_props];
+      if (props[num_props] == GOMA_PLUGIN_DIFFUSIVITY &&
+	  species[num_props] >= pd->Num_Species) continue;
+      num_props++;
+    }
+  if (num_props == 0) return;
+
+  nsp = pd->Num_Species_Eqn;
+  memset(&Batch.x[0][0], 0, sizeof(Batch.x));
+  memset(Batch.T, 0, ip_total * sizeof(dbl));
+  memset(Batch.P, 0, ip_total * sizeof(dbl));
+  memset(&Batch.v[0][0], 0, sizeof(Batch.v));
+  memset(Batch.C, 0, nsp * ip_total * sizeof(dbl));
+
+  for (ip = 0; ip < ip_total; ip++)
+    {
+      find_stu(ip, ielem_type, &xi[0], &xi[1], &xi[2]);
+      load_basis_functions(xi, bfd);
+
+      /* as load_fv() */
+      var = pd->ShapeVar;
+      dofs = ei->dof[var];
+      for (a = 0; a < pd->Num_Dim; a++)
+	{
+	  for (i = 0; i < dofs; i++)
+	    {
+	      node = ei->dof_list[ei->deforming_mesh ? R_MESH1 : var][i];
+	      index = Proc_Elem_Connect[Proc_Connect_Ptr[ei->ielem] + node];
+	      phi = bf[var]->phi[i];
+	      Batch.x[a][ip] += (ei->deforming_mesh ?
+				 Coor[a][index] + *esp->d[a][i] :
+				 Coor[a][index]) * phi;
+	    }
+	}
+      if (pd->v[TEMPERATURE])
+	{
+	  for (i = 0; i < ei->dof[TEMPERATURE]; i++)
+	    Batch.T[ip] += *esp->T[i] * bf[TEMPERATURE]->phi[i];
+	}
+      if (pd->v[PRESSURE])
+	{
+	  for (i = 0; i < ei->dof[PRESSURE]; i++)
+	    Batch.P[ip] += *esp->P[i] * bf[PRESSURE]->phi[i];
+	}
+      for (a = 0; a < pd->Num_Dim; a++)
+	{
+	  var = VELOCITY1 + a;
+	  if (!pd->v[var]) continue;
+	  for (i = 0; i < ei->dof[var]; i++)
+	    Batch.v[a][ip] += *esp->v[a][i] * bf[var]->phi[i];
+	}
+      if (pd->v[MASS_FRACTION])
+	{
+	  for (w = 0; w < nsp; w++)
+	    {
+	      for (i = 0; i < ei->dof[MASS_FRACTION]; i++)
+		Batch.C[w * ip_total + ip] += *esp->c[w][i] * bf[MASS_FRACTION]->phi[i];
+	    }
+	}
+    }
+
+  Batch.n = ip_total;
+  Batch.ielem = ei->ielem;
+  Batch.mp = mp;
+  Batch.time = time;
+
+  for (a = 0; a < 3; a++)
+    {
+      x[a] = Batch.x[a];
+      v[a] = Batch.v[a];
+    }
+  for (i = 0; i < num_props; i++)
+    {
+      s = plugin_slot(props[i], species[i]);
+      if (Results[s] == NULL)
+	{
+	  Results[s] = (struct plugin_results *)
+	    smalloc(sizeof(struct plugin_results));
+	}
+      plugin_call(props[i], species[i], ip_total, time, x, Batch.T, Batch.P,
+		  v, Batch.C, Results[s]);
+      Have_Results[s] = TRUE;
+    }
+}
+
+void
+plugin_element_end(void)
+{
+  Batch.n = 0;
+}
+
+/* TRUE if the state of the current point is the state of batch point ip */
+static int
+plugin_batch_point(const int ip,
+		   const dbl time)
+{
+  int a, w;
+
+  if (Batch.n == 0 || ip < 0 || ip >= Batch.n || Batch.ielem != ei->ielem ||
+      Batch.mp != mp || Batch.time != time) return FALSE;
+
+  for (a = 0; a < pd->Num_Dim; a++)
+    {
+      if (!PLUGIN_SAME(Batch.x[a][ip], fv->x[a])) return FALSE;
+      if (pd->v[VELOCITY1 + a] && !PLUGIN_SAME(Batch.v[a][ip], fv->v[a]))
+	return FALSE;
+    }
+  if (pd->v[TEMPERATURE] && !PLUGIN_SAME(Batch.T[ip], fv->T)) return FALSE;
+  if (pd->v[PRESSURE] && !PLUGIN_SAME(Batch.P[ip], fv->P)) return FALSE;
+  if (pd->v[MASS_FRACTION])
+    {
+      for (w = 0; w < pd->Num_Species_Eqn; w++)
+	{
+	  if (!PLUGIN_SAME(Batch.C[w * Batch.n + ip], fv->c[w])) return FALSE;
+	}
+    }
+  return TRUE;
+}
+
+int
+plugin_property(const int property,
+		const int species,
+		const dbl time)
+
+    /*************************************************************************
+     *
+     * plugin_property():
+     *
+     *  Set the property, and its derivatives, in mp at the current point,
+     *  as the usr_ routine of a USER model does: from the element's batch
+     *  if the point is one of its points, from a call on the point alone
+     *  if not.
+     *************************************************************************/
+{
+  int a, w, ip, n;
+  int s = plugin_slot(property, species);
+  dbl *value, *d;
+  dbl T, P, C[MAX_CONC], xp[3], vp[3];
+  const dbl *x[3], *v[3];
+  struct plugin_results one, *r;
+
+  if (Have_Results[s] && plugin_batch_point(MMH_ip, time))
+    {
+      r = Results[s];
+      ip = MMH_ip;
+      n = Batch.n;
+    }
+  else
+    {
+      T = pd->v[TEMPERATURE] ? fv->T : 0.;
+      P = pd->v[PRESSURE] ? fv->P : 0.;
+      for (a = 0; a < 3; a++)
+	{
+	  xp[a] = (a < pd->Num_Dim) ? fv->x[a] : 0.;
+	  vp[a] = (a < pd->Num_Dim && pd->v[VELOCITY1 + a]) ? fv->v[a] : 0.;
+	  x[a] = &xp[a];
+	  v[a] = &vp[a];
+	}
+      for (w = 0; w < pd->Num_Species_Eqn; w++)
+	C[w] = pd->v[MASS_FRACTION] ? fv->c[w] : 0.;
+      plugin_call(property, species, 1, time, x, &T, &P, v, C, &one);
+      r = &one;
+      ip = 0;
+      n = 1;
+    }
+
+  switch (property)
+    {
+    case GOMA_PLUGIN_VISCOSITY:
+      value = &mp->viscosity;
+      d = mp->d_viscosity;
+      break;
+    case GOMA_PLUGIN_DENSITY:
+      value = &mp->density;
+      d = mp->d_density;
+      break;
+    case GOMA_PLUGIN_THERMAL_CONDUCTIVITY:
+      value = &mp->thermal_conductivity;
+      d = mp->d_thermal_conductivity;
+      break;
+    case GOMA_PLUGIN_HEAT_SOURCE:
+      value = &mp->heat_source;
+      d = mp->d_heat_source;
+      break;
+    default:
+      value = &mp->diffusivity[species];
+      d = mp->d_diffusivity[species];
+    }
+
+  *value = r->value[ip];
+  d[TEMPERATURE] = r->d_T[ip];
+  d[PRESSURE] = r->d_P[ip];
+  for (a = 0; a < DIM; a++)
+    {
+      d[MESH_DISPLACEMENT1 + a] = r->d_x[a][ip];
+      d[VELOCITY1 + a] = r->d_v[a][ip];
+    }
+  for (w = 0; w < pd->Num_Species_Eqn; w++)
+    {
+      d[MAX_VARIABLE_TYPES + w] = r->d_C[w * n + ip];
+    }
+  return 0;
+}
+/*****************************************************************************/
+/* END of file mm_plugin.c */
+/*****************************************************************************/
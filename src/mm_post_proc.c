@@ -110,6 +110,36 @@ pp_Global       **pp_global;
 static int error_presence_key[3]; /* Truth key (dim 3) as to which error 
 				   * measure elem sizes are being done */
 
+/*
+ * Workspace kept by calc_zz_error_vel() between calls. The gauss point
+ * coordinates, detJ*weight and momentum basis functions of the elements,
+ * and the factored least squares system of every node patch, only depend
+ * on the mesh; when it cannot move they are built once per error variable
+ * and each later call only evaluates tau and back substitutes.
+ */
+#define ZZ_MAX_TERMS 10		/* 3D quadratic patch fit */
+#define ZZ_MAX_COMP  6		/* upper triangle of a 3x3 tau */
+
+struct ZZ_Patch_Cache
+{
+  int built;			/* TRUE once the arrays below are filled */
+  int fixed;			/* FALSE: geometry follows the solution */
+  int ev_indx;			/* error variable they were built for */
+  int num_elems;
+  int num_nodes;		/* owned nodes, one patch each */
+  int *elem_ok;			/* [num_elems] element enters the error */
+  int *gp_ptr;			/* [num_elems+1] first gauss point of each */
+  int *phi_ptr;			/* [num_elems+1] first basis function value */
+  dbl *xg;			/* [DIM*gauss points] global coordinates */
+  dbl *dw;			/* [gauss points] detJ * weight */
+  dbl *phi;			/* [gauss point][local node] momentum phi */
+  int *nterms;			/* [num_nodes] patch system size, 0 if empty */
+  dbl ***lu;			/* [num_nodes] factored patch matrix */
+  int **indx;			/* [num_nodes] its row permutation */
+};
+
+static struct ZZ_Patch_Cache ZZ_Patches;
+
 int Num_Nodal_Post_Proc_Var = 0;
 int Num_Elem_Post_Proc_Var = 0;
 
@@ -317,6 +347,24 @@ double *u_post_proc = 0;       	/* user-provided values used in calculating
  */
 static int *listel;
 
+/*
+ * Nodal post processing fields accumulated during an assembly
+ * (Fused Post Processing card), see fused_post_proc_begin().
+ */
+#define FUSED_PP_NONE  0	/* nothing held */
+#define FUSED_PP_ACCUM 1	/* accumulating in matrix_fill() */
+#define FUSED_PP_STALE 2	/* an element could not be accumulated */
+#define FUSED_PP_READY 3	/* complete, for the stamped state */
+
+static int     Fused_PP_State = FUSED_PP_NONE;
+static int     Fused_PP_Nvar = 0;
+static int     Fused_PP_Nnodes = 0;
+static double  **Fused_PP_Vect = NULL;
+static double  **Fused_PP_Mass = NULL;
+static RESULTS_DESCRIPTION_STRUCT *Fused_PP_Rd = NULL;
+static double  *Fused_PP_X = NULL;
+static double  Fused_PP_Xsum, Fused_PP_Time, Fused_PP_Dt;
+
 /**********************************************************************/
 /**********************************************************************/
 /**********************************************************************/
@@ -360,24 +408,23 @@ PROTO((double [],		/* x - Soln vector for the current processor */
        Dpi * const,		/* dpi                                       */
        int ));			/* compute_elem_size                         */
 
-static int abs_error_at_elem	/* mm_post_proc.c                            */
-PROTO((int ,			/* i_elem                                    */
-       double *** ,		/* tau_nodal_lsp                             */
-       double * ,		/* gvec_elem                                 */
-       double * ,		/* velocity_norm                             */
-       double * ));		/* ielem_area                                */
-
-static int fill_lhs_lspatch	/* mm_post_proc.c                            */
-PROTO((double * ,		/* i_node_coords                             */
-       double * ,		/* wt_gp_loc                                 */
-       double * ,		/* xgp_loc                                   */
-       double * ,		/* ygp_loc                                   */
-       double * ,		/* zgp_loc                                   */
-       double * ,		/* det_gp_loc                                */
-       int ,			/* max_terms                                 */
-       double **,		/* s_lhs                                     */
-       int ,			/* elem                                      */
-       double **** ));		/* tau_gp_ptch                               */
+static void zz_patches_free	/* mm_post_proc.c                            */
+PROTO((struct ZZ_Patch_Cache *));
+
+static void zz_patches_setup	/* mm_post_proc.c                            */
+PROTO((struct ZZ_Patch_Cache *,
+       const int ,		/* ev_indx                                   */
+       Exo_DB *,		/* exo                                       */
+       Dpi *));			/* dpi                                       */
+
+static void zz_patch_terms	/* mm_post_proc.c                            */
+PROTO((const int ,		/* nterms                                    */
+       const dbl [DIM],		/* r - point relative to the patch node      */
+       dbl [ZZ_MAX_TERMS]));	/* P - polynomial terms at r                 */
+
+static int zz_patches_factor	/* mm_post_proc.c                            */
+PROTO((struct ZZ_Patch_Cache *,
+       Exo_DB *));		/* exo                                       */
 
 static int calc_stream_fcn	/* mm_post_proc.c                            */
 PROTO((double [],		/* x                             soln vector */
@@ -403,6 +450,16 @@ static int midsid
 PROTO((double [],		/* stream_fcn_vect */
        Exo_DB *));		/* exo */
 
+static int stream_fcn_poisson	/* mm_post_proc.c                            */
+PROTO((double [],		/* x - soln vector                           */
+       double [],		/* x_old                                     */
+       double [],		/* xdot                                      */
+       double [],		/* xdot_old                                  */
+       double [],		/* resid_vector                              */
+       double [],		/* psi - (out) stream function at the nodes  */
+       Exo_DB *,		/* exo                                       */
+       Dpi *));			/* dpi                                       */
+
 
 /*
  * Prototypes of functions defined in other files that are needed here.
@@ -1396,7 +1453,10 @@ calc_standard_fields(double **post_proc_vect, /* rhs vector now called
     {
       if(mp->ConductivityModel == USER )
       {
-	err = usr_thermal_conductivity(mp->u_thermal_conductivity, time);
+	if (mp->Plugin[GOMA_PLUGIN_THERMAL_CONDUCTIVITY] >= 0)
+	  err = plugin_property(GOMA_PLUGIN_THERMAL_CONDUCTIVITY, -1, time);
+	else
+	  err = usr_thermal_conductivity(mp->u_thermal_conductivity, time);
       }
 
 
@@ -3236,6 +3296,340 @@ calc_standard_fields(double **post_proc_vect, /* rhs vector now called
 /*****************************************************************************/
 /*****************************************************************************/
 
+/*
+ * Weighted sum of the owned unknowns, to tell whether x changed since the
+ * fields were accumulated.
+ */
+
+static double
+fused_post_proc_xsum(double x[])
+{
+  int i;
+  double sum = 0.;
+
+  for (i = 0; i < NumUnknowns; i++) sum += (double) (i + 1) * x[i];
+  return sum;
+}
+
+void
+fused_post_proc_begin(RESULTS_DESCRIPTION_STRUCT *rd,
+		      Dpi *dpi)
+
+    /*************************************************************************
+     *
+     * fused_post_proc_begin():
+     *
+     *  Start accumulating the nodal post processing fields of rd in the
+     *  assembly that follows. matrix_fill() hands each quadrature point
+     *  to fused_post_proc_ip() with the state it has already loaded, and
+     *  fused_post_proc_end() then keeps the sums for post_process_nodal(),
+     *  which skips its own pass over the elements when the solution it is
+     *  given is the one the sums were made for.
+     *************************************************************************/
+{
+  int j, I, n = dpi->num_universe_nodes;
+
+  if (rd->TotalNVPostOutput == 0) {
+    Fused_PP_State = FUSED_PP_NONE;
+    return;
+  }
+
+  if (Fused_PP_Nvar != rd->TotalNVPostOutput || Fused_PP_Nnodes != n) {
+    for (j = 0; j < Fused_PP_Nvar; j++) {
+      safe_free(Fused_PP_Vect[j]);
+      safe_free(Fused_PP_Mass[j]);
+    }
+    if (Fused_PP_Vect != NULL) safe_free(Fused_PP_Vect);
+    if (Fused_PP_Mass != NULL) safe_free(Fused_PP_Mass);
+    Fused_PP_Nvar   = rd->TotalNVPostOutput;
+    Fused_PP_Nnodes = n;
+    Fused_PP_Vect = (double **) smalloc(Fused_PP_Nvar * sizeof(double *));
+    Fused_PP_Mass = (double **) smalloc(Fused_PP_Nvar * sizeof(double *));
+    for (j = 0; j < Fused_PP_Nvar; j++) {
+      Fused_PP_Vect[j] = (double *) smalloc(n * sizeof(double));
+      Fused_PP_Mass[j] = (double *) smalloc(n * sizeof(double));
+    }
+  }
+
+  for (j = 0; j < Fused_PP_Nvar; j++) {
+    for (I = 0; I < n; I++) {
+      Fused_PP_Vect[j][I] = 0.;
+      Fused_PP_Mass[j][I] = 0.;
+    }
+  }
+  Fused_PP_Rd = rd;
+  Fused_PP_State = FUSED_PP_ACCUM;
+}
+
+int
+fused_post_proc_active(void)
+{
+  return (Fused_PP_State == FUSED_PP_ACCUM);
+}
+
+void
+fused_post_proc_skip(void)
+{
+  if (Fused_PP_State == FUSED_PP_ACCUM) Fused_PP_State = FUSED_PP_STALE;
+}
+
+int
+fused_post_proc_ip(double delta_t,
+		   double theta,
+		   int ielem,
+		   const int ielem_type,
+		   int ip,
+		   int ip_total,
+		   double time,
+		   Exo_DB *exo,
+		   double xi[DIM])
+
+    /*************************************************************************
+     *
+     * fused_post_proc_ip():
+     *
+     *  Add this quadrature point to the accumulated fields. The basis
+     *  functions and fv must be loaded as for calc_standard_fields() in
+     *  post_process_nodal(); porous media elements are not accumulated.
+     *************************************************************************/
+{
+  struct Porous_Media_Terms pm_terms;
+
+  memset(&pm_terms, 0, sizeof(struct Porous_Media_Terms));
+  return calc_standard_fields(Fused_PP_Vect, Fused_PP_Mass, delta_t, theta,
+			      ielem, ielem_type, ip, ip_total, Fused_PP_Rd,
+			      &pm_terms, time, exo, xi);
+}
+
+void
+fused_post_proc_end(const int keep,
+		    double x[],
+		    const double time,
+		    const double delta_t)
+
+    /*************************************************************************
+     *
+     * fused_post_proc_end():
+     *
+     *  Keep the fields accumulated since fused_post_proc_begin() for the
+     *  solution x at time, or drop them.
+     *************************************************************************/
+{
+  if (keep && Fused_PP_State == FUSED_PP_ACCUM) {
+    Fused_PP_State = FUSED_PP_READY;
+    Fused_PP_X     = x;
+    Fused_PP_Xsum  = fused_post_proc_xsum(x);
+    Fused_PP_Time  = time;
+    Fused_PP_Dt    = delta_t;
+  } else {
+    Fused_PP_State = FUSED_PP_NONE;
+  }
+}
+
+/*
+ * Copy the accumulated fields to post_proc_vect and lumped_mass when they
+ * were made for this x, rd and time; they are used up either way.
+ */
+
+static int
+fused_post_proc_take(double x[],
+		     RESULTS_DESCRIPTION_STRUCT *rd,
+		     const double time,
+		     const double delta_t,
+		     const int num_nodes,
+		     double **post_proc_vect,
+		     double **lumped_mass)
+{
+  int j, I, ok;
+
+  ok = (Fused_PP_State == FUSED_PP_READY && x == Fused_PP_X &&
+	rd == Fused_PP_Rd && Fused_PP_Nvar == rd->TotalNVPostOutput &&
+	Fused_PP_Nnodes == num_nodes && time == Fused_PP_Time &&
+	delta_t == Fused_PP_Dt && fused_post_proc_xsum(x) == Fused_PP_Xsum);
+  Fused_PP_State = FUSED_PP_NONE;
+  if (!ok) return FALSE;
+
+  for (j = 0; j < Fused_PP_Nvar; j++) {
+    for (I = 0; I < num_nodes; I++) {
+      post_proc_vect[j][I] = Fused_PP_Vect[j][I];
+      lumped_mass[j][I]    = Fused_PP_Mass[j][I];
+    }
+  }
+  return TRUE;
+}
+
+/*
+ * The volume contributions of ielem (in the block starting at e_start) to
+ * the projected nodal fields, for the material pointers already set.
+ */
+
+static int
+post_proc_nodal_elem(const int ielem,
+		     const int e_start,
+		     double x[],
+		     double x_old[],
+		     double xdot[],
+		     double xdot_old[],
+		     double resid_vector[],
+		     double **post_proc_vect,
+		     double **lumped_mass,
+		     const double delta_t,
+		     const double theta,
+		     const double time,
+		     RESULTS_DESCRIPTION_STRUCT *rd,
+		     Exo_DB *exo)
+{
+  int err, ip, ip_total, ielem_type;
+  double xi[DIM];
+  struct Porous_Media_Terms pm_terms;
+  extern int PRS_mat_ielem;
+
+  memset(&pm_terms, 0, sizeof(struct Porous_Media_Terms));
+
+  PRS_mat_ielem = ielem - e_start;  /*added for hysteretic saturation func*/
+
+  err = load_elem_dofptr(ielem, exo, x, x_old, xdot, xdot_old,
+			 resid_vector, 0);
+  EH(err, "load_elem_dofptr");
+  err = bf_mp_init(pd);
+  EH(err, "bf_mp_init");
+  ielem_type = ei->ielem_type;
+  ip_total   = elem_info(NQUAD, ielem_type); /* number of quadrature pts */
+
+  for (ip = 0; ip < ip_total; ip++) {
+
+    MMH_ip = ip;   /*Added for hysteretic saturation func.*/
+
+    find_stu(ip, ielem_type, &xi[0], &xi[1], &xi[2]);
+    fv->wt = Gq_weight(ip, ielem_type);
+
+    err = load_basis_functions(xi, bfd);
+    EH(err, "problem from load_basis_functions");
+
+    err = beer_belly();
+    EH(err, "beer_belly");
+
+    err = load_fv();
+    EH(err, "load_fv");
+
+    err = load_bf_grad();
+    EH(err, "load_bf_grad");
+
+    err = load_fv_grads();
+    EH(err, "load_fv_grads");
+
+    /*
+     * Load up porous media variables and properties, if needed 
+     */
+    if (mp->PorousMediaType == POROUS_UNSATURATED || 
+	mp->PorousMediaType == POROUS_SATURATED ||
+	mp->PorousMediaType == POROUS_TWO_PHASE ) {
+      err = load_porous_properties(); 
+      EH(err, "load_porous_properties");
+    }
+    if (mp->PorousMediaType == POROUS_SATURATED) {
+      err = get_porous_fully_sat_terms(&pm_terms, time, delta_t);
+      EH(err,"problem in getting the saturated porous darcy  terms");
+    } else if (mp->PorousMediaType == POROUS_UNSATURATED ||
+	       mp->PorousMediaType == POROUS_TWO_PHASE) {
+      err = get_porous_part_sat_terms(&pm_terms, time, delta_t);
+      EH(err,"problem in getting the partially-saturated porous  terms");
+    }
+
+    /*
+     * Calculate the contribution from this element of the
+     * projection of the standard field variables unto the
+     * node variables
+     */
+    err = calc_standard_fields(post_proc_vect, lumped_mass,
+			       delta_t, theta, ielem, ielem_type, ip,
+			       ip_total, rd, &pm_terms, time, exo, xi);
+    EH(err, "calc_standard_fields");
+  }
+
+  return 0;
+}
+
+/*
+ * Point the material pointers at those of material mn.
+ */
+
+static void
+post_proc_set_matl(const int mn)
+{
+  int mode;
+
+  pd  = pd_glob[mn];
+  cr  = cr_glob[mn];
+  elc = elc_glob[mn];
+  elc_rs = elc_rs_glob[mn];
+  gn  = gn_glob[mn];
+  mp  = mp_glob[mn];
+  vn  = vn_glob[mn];
+  evpl = evpl_glob[mn];
+
+  for ( mode=0; mode<vn->modes; mode++)
+    {
+      ve[mode]  = ve_glob[mn][mode];
+    }
+}
+
+/*
+ * The volume contributions to the nodal fields on the assembly threads,
+ * color by color: elements of one color share no node, so their scatter
+ * into post_proc_vect and lumped_mass needs no locking. Porous media
+ * keep the hysteresis element and point (PRS_mat_ielem, MMH_ip) in
+ * shared globals and stay serial, as does anything the threaded
+ * assembly will not take.
+ */
+
+static int
+post_proc_nodal_threaded(double x[],
+			 double x_old[],
+			 double xdot[],
+			 double xdot_old[],
+			 double resid_vector[],
+			 double **post_proc_vect,
+			 double **lumped_mass,
+			 const double delta_t,
+			 const double theta,
+			 const double time,
+			 RESULTS_DESCRIPTION_STRUCT *rd,
+			 Exo_DB *exo)
+{
+#ifdef _OPENMP
+  int c, k, mn;
+
+  if (!assembly_threads_active(exo)) return FALSE;
+  for (mn = 0; mn < upd->Num_Mat; mn++) {
+    if (mp_glob[mn]->PorousMediaType != CONTINUOUS) return FALSE;
+  }
+
+  for (c = 0; c < Num_Elem_Colors; c++) {
+#pragma omp parallel for schedule(dynamic, 16)
+    for (k = Elem_Color_Ptr[c]; k < Elem_Color_Ptr[c+1]; k++) {
+      int ielem = Elem_Color_List[k];
+      int eb_index = find_elemblock_index(ielem, exo);
+
+      post_proc_set_matl(Matilda[eb_index]);
+      post_proc_nodal_elem(ielem, exo->eb_ptr[eb_index], x, x_old, xdot,
+			   xdot_old, resid_vector, post_proc_vect,
+			   lumped_mass, delta_t, theta, time, rd, exo);
+    }
+  }
+
+  /* leave the master's pointers as the serial loop does */
+  post_proc_set_matl(Matilda[exo->num_elem_blocks-1]);
+  return TRUE;
+#else
+  return FALSE;
+#endif
+}
+
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
 void 
 post_process_nodal(double x[],	 /* Solution vector for the current processor */
 		   double **x_sens_p,   /* solution sensitivities */
@@ -3277,9 +3671,6 @@ post_process_nodal(double x[],	 /* Solution vector for the current processor */
   int   mesh_exoid, cpu_word_size, io_word_size;  
   float version;
   int err;                    /* temp variable to hold diagnostic flags. */
-  int ip;                     /* ip is the local quadrature point index      */
-  int ip_total;               /* ip_total is the total number of volume
-                                 quadrature points in the element            */
   int j, k, l;			/* local index loop counter                  */
   int i, id;			/* Index for the local node number - row     */
   int I;			/* Indeces for global node number - row      */
@@ -3294,7 +3685,6 @@ post_process_nodal(double x[],	 /* Solution vector for the current processor */
   int var;                      /* variable name (TEMPERATURE, etc) */
   int w;                       /* species counter */
 
-  double s, t, u;              /* Gaussian-quadrature point locations        */
   int *bloated_node_list;      /* temporary used to point to raw SS node list
 				* that replicates nodes needlessly */
   int num_universe_nodes;      /* alias for dpi->num_universe_nodes */
@@ -3315,8 +3705,6 @@ post_process_nodal(double x[],	 /* Solution vector for the current processor */
 /* __________________________________________________________________________*/
 
   double xi[DIM];               /* Local element coordinates of Gauss point. */
-  double wt;                  /* Quadrature weights
-                                 units - ergs/(sec*cm*K) = g*cm/(sec^3*K)    */
   dbl *pressure_elem_vect=NULL;	/* vector to hold nodal pressure*/
   /* PRS Cludge for remeshing guys */
 
@@ -3325,7 +3713,6 @@ post_process_nodal(double x[],	 /* Solution vector for the current processor */
   double **post_proc_vect;
 
   double **lumped_mass;         /* vector to hold lumped mass matrix         */
-  int    *listnd=NULL;
   int    *listndm[MAX_CONC];             /*  */
   int    *listnde=NULL;
   int    check, e_start, e_end, mn;
@@ -3333,7 +3720,7 @@ post_process_nodal(double x[],	 /* Solution vector for the current processor */
                                  calculated by routine calc_stream_fcn       */
   double vel[MAX_PDIM][MDE];  /* array for local nodal velocity values */
 
-  int ii, kount=0;
+  int ii;
   int kounte=0, kountm[MAX_CONC];
 
   /* side-post stuff */
@@ -3348,7 +3735,6 @@ post_process_nodal(double x[],	 /* Solution vector for the current processor */
   int *node_list;
   int *ss_ids;
   int id_side, iss=0, p, q, dim, ldof, jd, iapply, ss_index;
-  int mode;
   int id_local_elem_coord[MAX_NODES_PER_SIDE];
 
   /*  particle tracking stuff  */
@@ -3367,8 +3753,9 @@ post_process_nodal(double x[],	 /* Solution vector for the current processor */
   static char yo[] = "post_process_nodal"; /* My name to take blame... */
 #endif
 
-  struct Porous_Media_Terms pm_terms;   /*added for POROUS_LIQUID_ACCUM_RATE*/
   extern int PRS_mat_ielem;             /*Added for hysteretic saturation model */
+  int fused;                            /* fields summed in matrix_fill() */
+  int threaded = FALSE;                 /* ... or on the assembly threads */
 
   /* 
    * BEGINNING OF EXECUTABLE STATEMENTS
@@ -3399,6 +3786,9 @@ post_process_nodal(double x[],	 /* Solution vector for the current processor */
     listel = alloc_int_1(Num_Internal_Elems, 0);
     cpu_word_size = sizeof(dbl);
     io_word_size  = 0;
+    wr_exo_session_close();	/* ExoFile may also be the output file,
+				 * and no EXODUS II calls while output
+				 * is queued */
     mesh_exoid    = ex_open(ExoFile, EX_READ, &cpu_word_size, &io_word_size, 
 			    &version);
     EH(mesh_exoid, "ex_open");
@@ -3459,6 +3849,8 @@ post_process_nodal(double x[],	 /* Solution vector for the current processor */
    */
   if (rd->TotalNVPostOutput == 0) return;
 
+  if ( xfem != NULL ) update_xfem_elem_state( x, exo );
+
   /* Allocate memory for requested function vectors */
 
   post_proc_vect = (double **)
@@ -3470,13 +3862,6 @@ post_process_nodal(double x[],	 /* Solution vector for the current processor */
     }
 
 
-  if ( Num_Proc == 1 )
-    {
-      if (STREAM != -1 && Num_Var_In_Type[R_MOMENTUM1])
-	{
-	  listnd = (int *) smalloc (num_universe_nodes * sizeof(int));
-	}
-    }
 
   check = 0;
   for (i = 0; i < upd->Num_Mat; i++)
@@ -3547,13 +3932,6 @@ post_process_nodal(double x[],	 /* Solution vector for the current processor */
   /*Initialize */
    if ( Num_Proc == 1 )
      {
-       if(STREAM != -1 && Num_Var_In_Type[R_MOMENTUM1])
-	 {
-	   for (I = 0; I < num_universe_nodes; I++)
-	     {
-	       listnd[I] = 0 ;
-	     }
-	 }
        if(ENERGY_FLUXLINES != -1 &&  Num_Var_In_Type[R_ENERGY])
 	 {
 	   for (I = 0; I < num_universe_nodes; I++)
@@ -3584,6 +3962,12 @@ post_process_nodal(double x[],	 /* Solution vector for the current processor */
 
    /*  af->Assemble_Jacobian = FAE; */
 
+   /*
+    * The fields may already be summed in the last Newton assembly.
+    */
+   fused = fused_post_proc_take(x, rd, *time_ptr, delta_t, num_universe_nodes,
+				post_proc_vect, lumped_mass);
+
 /******************************************************************************/
 /*                                BLOCK 1                                     */
 /*          LOOP OVER THE ELEMENTS DEFINED ON THE CURRENT PROCESSOR           */
@@ -3610,23 +3994,18 @@ post_process_nodal(double x[],	 /* Solution vector for the current processor */
     * from Matilda[]. 
     */
 
-   for ( eb_index=0; eb_index<exo->num_elem_blocks; eb_index++)
+   if (!fused) {
+     threaded = post_proc_nodal_threaded(x, x_old, xdot, xdot_old,
+					 resid_vector, post_proc_vect,
+					 lumped_mass, delta_t, theta,
+					 *time_ptr, rd, exo);
+   }
+
+   for ( eb_index=0; !fused && !threaded && eb_index<exo->num_elem_blocks; eb_index++)
      {
        mn  = Matilda[eb_index];
 
-       pd  = pd_glob[mn];
-       cr  = cr_glob[mn];
-       elc = elc_glob[mn];
-       elc_rs = elc_rs_glob[mn];
-       gn  = gn_glob[mn];
-       mp  = mp_glob[mn];	  
-       vn  = vn_glob[mn];
-       evpl = evpl_glob[mn];
-
-       for ( mode=0; mode<vn->modes; mode++)
-	 {
-	   ve[mode]  = ve_glob[mn][mode];
-	 }
+       post_proc_set_matl(mn);
        
        e_start = exo->eb_ptr[eb_index];
        e_end   = exo->eb_ptr[eb_index+1];
@@ -3635,145 +4014,10 @@ post_process_nodal(double x[],	 /* Solution vector for the current processor */
 	 {
 	   ielem = iel;
 
-	   PRS_mat_ielem = ielem - e_start;  /*added for hysteretic saturation func*/
-
-	      /*
-	       * For each variable there are generally different degrees of
-	       * freedom that they and their equations contribute to.
-	       *
-	       * For this element, load up arrays that tell, for each variable,
-	       *
-	       *        (i) how many degrees of freedom they contribute towords
-	       *        (ii) the local node number associated with each degree of
-	       *             freedom
-	       *        (iii) pointers in the "esp" structure that tell where
-	       *              things are located in the global scheme...
-	       *                (a) nodal unknowns in this element...
-	       *                (b) Residual equations receiving contributions in
-	       *                    this element.
-	       *                (c) where the Jacobian entries go in the global
-	       *                    "a" matrix in its MSR format...
-	       */
-	      
-	  
-	   err = load_elem_dofptr(ielem, exo, x, x_old, xdot, xdot_old,
-				  resid_vector, 0);
-	   EH(err, "load_elem_dofptr");
-	   err = bf_mp_init(pd);
-	   EH(err, "bf_mp_init");
-	   ielem_type      = ei->ielem_type;
-	   ip_total        = elem_info(NQUAD, ielem_type); /* number of
-							    * quadrature pts */
-	      
-	   num_local_nodes = ei->num_local_nodes; /* number of 
-							     * local basis 
-							     * functions */
-	      
-	   ielem_dim       = ei->ielem_dim; /* physical 
-							   * dimension of this
-							   * element */
-	      
-	   iconnect_ptr    = ei->iconnect_ptr;	/* pointer to 
-							 * beginning of this 
-							 * element's
-							 * connectivity list */
-	      
-      
-/******************************************************************************/
-/*                              BLOCK 1A                                      */
-/*                   START OF VOLUME INTEGRATION LOOP                         */
-/*                LOOP OVER THE NUMBER OF QUADRATURE POINTS                   */
-/*    Here we are doing a L2 projection onto the grid points of selected      */
-/*    quantities                                                              */
-/******************************************************************************/
-	   /* Loop over all the Volume Quadrature integration points */
-	      
-	   for (ip = 0; ip < ip_total; ip++) {
-
-	     MMH_ip = ip;   /*Added for hysteretic saturation func.*/
-
-	     find_stu (ip, ielem_type, &s, &t, &u);
-	     xi[0] = s;
-	     xi[1] = t;
-	     xi[2] = u;
-	     
-	     /*
-	      * find quadrature weights for current ip
-	      */
-	     wt = Gq_weight (ip, ielem_type);
-	     fv->wt = wt;
-		  
-	     /*
-	      * Load up basis function information for ea variable...
-	      * Old usage: fill_shape
-	      */  
-	     err = load_basis_functions( xi, bfd);
-	     EH( err, "problem from load_basis_functions");
-		  
-	     /*
-	      * This has elemental Jacobian transformation and some 
-	      * basic mesh derivatives...
-	      * Old usage: calc_Jac, jelly_belly
-	      */  
-	     err = beer_belly();
-	     EH( err, "beer_belly");
-		  
-	     /*
-	      * Load up field variable values at this Gauss point.
-	      */
-	     err = load_fv();
-	     EH( err, "load_fv");
-		  
-	     /*
-	      * Here, load in the final part of the necessary basis function
-	      * information derivatives in the physical space coordinates...
-	      *
-	      *			grad(phi_i)
-	      *
-	      *			grad(phi_i e_a)
-	      * where:
-	      *		phi_i is the basis function at i-th dof
-	      *		e_a   is a unit vector in the coordinate system
-	      *
-	      * 		grad() operator depends on the coordinate system.
-	      */  
-	     err = load_bf_grad();
-	     EH(err, "load_bf_grad");
-		  
-	     /*
-	      * Load up physical space gradients of field variables at this
-	      * Gauss point.
-	      */
-	     err = load_fv_grads();
-	     EH(err, "load_fv_grads");	  
-		  
-	     /*
-	      * Load up porous media variables and properties, if needed 
-	      */
-	     if (mp->PorousMediaType == POROUS_UNSATURATED || 
-		 mp->PorousMediaType == POROUS_SATURATED ||
-	         mp->PorousMediaType == POROUS_TWO_PHASE ) {
-	       err = load_porous_properties(); 
-	       EH(err, "load_porous_properties");
-	     }
-	     if (mp->PorousMediaType == POROUS_SATURATED) {
-	       err = get_porous_fully_sat_terms(&pm_terms, *time_ptr, delta_t);
-	       EH(err,"problem in getting the saturated porous darcy  terms");
-	     } else if (mp->PorousMediaType == POROUS_UNSATURATED ||
-			mp->PorousMediaType == POROUS_TWO_PHASE) {
-	       err = get_porous_part_sat_terms(&pm_terms, *time_ptr, delta_t);
-	       EH(err,"problem in getting the partially-saturated porous  terms");
-	     }
-	     /*
-	      * Calculate the contribution from this element of the
-	      * projection of the standard field variables unto the
-	      * node variables
-	      */
-	     err = calc_standard_fields(post_proc_vect, lumped_mass,
-					delta_t, theta, ielem, ielem_type, ip,
-					ip_total, rd, &pm_terms, *time_ptr, exo, xi);
-	     EH(err, "calc_standard_fields");
-	   } /* END  for (ip = 0; ip < ip_total; ip++)                      */
+	   err = post_proc_nodal_elem(ielem, e_start, x, x_old, xdot, xdot_old,
+				      resid_vector, post_proc_vect, lumped_mass,
+				      delta_t, theta, *time_ptr, rd, exo);
+	   EH(err, "post_proc_nodal_elem");
 	 } /* END  for (iel = 0; iel < num_internal_elem; iel++)            */
      }  /* END for (ieb loop) */
 
@@ -3864,7 +4108,6 @@ post_process_nodal(double x[],	 /* Solution vector for the current processor */
 	       EH(err, "load_elem_dofptr");
 	       iconnect_ptr    = ei->iconnect_ptr;
 	       ielem_type      = ei->ielem_type;
-	       ip_total        = elem_info(NQUAD_SURF, ielem_type);
 	       num_local_nodes = ei->num_local_nodes;
 	       ielem_dim       = ei->ielem_dim;
 	       dim             = ielem_dim;
@@ -4059,7 +4302,7 @@ post_process_nodal(double x[],	 /* Solution vector for the current processor */
 
    if ( Num_Proc == 1 )
      {
-       if (STREAM != -1 || FLUXLINES != -1  || ENERGY_FLUXLINES != -1 ) 
+       if (FLUXLINES != -1  || ENERGY_FLUXLINES != -1 ) 
 	 {
 	   /* 
 	    * Loop over all the elements, in the "optimal" order.
@@ -4097,7 +4340,6 @@ post_process_nodal(double x[],	 /* Solution vector for the current processor */
 	       iconnect_ptr    = ei->iconnect_ptr;
       
 	       ielem_type      = ei->ielem_type;
-	       ip_total        = elem_info(NQUAD_SURF, ielem_type);
 	       num_local_nodes = ei->num_local_nodes;
       
 	       ielem_dim       = ei->ielem_dim;
@@ -4115,41 +4357,6 @@ post_process_nodal(double x[],	 /* Solution vector for the current processor */
 		     }
 		 }
 	
-	       /* get convection velocity at the nodal points */
-	
-	       if (STREAM != -1  &&  Num_Var_In_Type[VELOCITY1] && ei->ielem_dim == 2)
-		 {
-		   /* Go for it -- Calculate the stream function at the nodes 
-		    * of this element 
-		    */
-
-		   /*	if (ei->ielem_dim == 2 && ei->num_local_nodes == 9) { */
-
-		   if (ei->ielem_dim == 2) 
-		     {
-		       if (pd->e[R_MOMENTUM1]) 
-			 {
-			   for ( i=0; i<ei->ielem_dim; i++)
-			     {
-			       var = VELOCITY1+i;
-			       for ( j=0; j<ei->dof[var]; j++)
-				 {
-				   vel[i][j] = *esp->v[i][j];
-				 }
-			     }
-			 }
-		       err = calc_stream_fcn(x, del_stream_fcn, vel); 
-		     }
-		   else
-		     {
-#if 1
-		       EH(-1,"No stream function in 3D ");
-#endif
-		     }
-		   err = correct_stream_fcn(&kount, iel, del_stream_fcn, 
-					    post_proc_vect[STREAM], listnd);
-	    
-		 }  /* END of if(STREAM) */
 	
 	       check = 0;
 	       for (i = 0; i < upd->Num_Mat; i++)
@@ -4270,7 +4477,7 @@ post_process_nodal(double x[],	 /* Solution vector for the current processor */
 	    
 	     } /* END of loop over elements */ 
 
-	 }  /* END of if(STREAM or FLUXLINES) */
+	 }  /* END of if(FLUXLINES) */
 
 
   /*
@@ -4278,21 +4485,9 @@ post_process_nodal(double x[],	 /* Solution vector for the current processor */
    */
 
    if (STREAM != -1 &&  Num_Var_In_Type[VELOCITY1]) {
-     /* First process global vector to recover average value at nodes*/
-     for (I = 0; I < num_universe_nodes; I++) {
-       ii = listnd[I];
-       if (ii != 0) {
-         post_proc_vect[STREAM][I] /= (double) ii;
-       }
-     }
-
-     /* Compute value at midside nodes if these exist */
-     if ( ei->num_local_nodes == 9)
-       {
-	 err = midsid(post_proc_vect[STREAM], exo);
-       }
-
-     free(listnd);
+     err = stream_fcn_poisson(x, x_old, xdot, xdot_old, resid_vector,
+			      post_proc_vect[STREAM], exo, dpi);
+     EH(err, "stream_fcn_poisson");
    }
 
   if (FLUXLINES != -1 && Num_Var_In_Type[R_MASS]) {
@@ -4451,6 +4646,8 @@ post_process_nodal(double x[],	 /* Solution vector for the current processor */
           wr_nodal_result_exo(exo, filename, post_proc_vect[i],
 			      rd->TotalNVSolnOutput + i + 1, ts, *time_ptr);
         }
+      insitu_nodal_field(rd->nvname[rd->TotalNVSolnOutput + i],
+			 post_proc_vect[i], INSITU_SHARE);
     }
 
       /* 
@@ -4914,6 +5111,10 @@ printf(" Pointer check of x_pp: %p\n", x_pp);
 /*   err = usr_print(NULL,0.,x,post_proc_vect, PRESSURE_CONT);  
    err = usr_print(NULL,0.,x,post_proc_vect, STRESS_TENSOR);  */
 
+  /* An open in situ step points at post_proc_vect, run it before the
+     vectors go */
+  insitu_step_execute();
+
   for (j = 0; j < rd->TotalNVPostOutput; j++)
     {
       safe_free(post_proc_vect[j]);
@@ -4971,6 +5172,8 @@ post_process_elem(double x[], /* soln vector */
 
   if (Num_Elem_Post_Proc_Var == 0) return;
 
+  if ( xfem != NULL ) update_xfem_elem_state( x, exo );
+
   /* Initialize  - NOTE ONLY initialize the members that have been malloc'd */
   i = 0;
   if ( tev_post > 0 ) {
@@ -5036,7 +5239,7 @@ post_process_elem(double x[], /* soln vector */
 		    for(ielem=0; ielem < eb_ptr->Num_Elems_In_Block; ielem++)
 		      {
 			gvec_elem[eb_indx][ev_indx][ielem] += 
-			  eb_ptr->ElemStorage[ielem].sat_curve_type[ip];
+			  ES_QP(eb_ptr, sat_curve_type, ielem, ip);
 		      }
 		    ev_indx++;
 		  }
@@ -5045,7 +5248,7 @@ post_process_elem(double x[], /* soln vector */
 		    for(ielem=0; ielem < eb_ptr->Num_Elems_In_Block; ielem++)
 		      {
 			gvec_elem[eb_indx][ev_indx][ielem] += 
-			  eb_ptr->ElemStorage[ielem].Sat_QP_tn[ip];
+			  ES_QP(eb_ptr, Sat_QP_tn, ielem, ip);
 		      }
 		    ev_indx++;
 		  }
@@ -5054,7 +5257,7 @@ post_process_elem(double x[], /* soln vector */
 		    for(ielem=0; ielem < eb_ptr->Num_Elems_In_Block; ielem++)
 		      {
 			gvec_elem[eb_indx][ev_indx][ielem] += 
-			  eb_ptr->ElemStorage[ielem].p_cap_QP[ip];
+			  ES_QP(eb_ptr, p_cap_QP, ielem, ip);
 		      }
 		    ev_indx++;
 		  }
@@ -5111,1609 +5314,654 @@ post_process_global(double *x,	 /* Solution vector for the current processor */
 /********************************************************************************/
 /********************************************************************************/
 
-static int
-calc_zz_error_vel(double x[], /* Solution vector                       */
-		  double x_old[], double xdot[], 
-		  double xdot_old[],
-		  double resid_vector[], 
-		  int ev_indx,	/* Variable index for zz_error               */
-		  double ***gvec_elem, /* evar vals[eb_indx][ev_indx][elem]  */
-		  Exo_DB * const exo,
-		  Dpi * const dpi,
-		  int compute_elem_size)
+static void
+zz_patches_free(struct ZZ_Patch_Cache *zp)
+{
+  int n;
 
-     /*
-       Function which calculates the Zienkiewicz-Zhu error indicator for each
-       appropriate element in the model
+  if (zp->lu != NULL) {
+    for (n = 0; n < zp->num_nodes; n++) {
+      if (zp->lu[n] != NULL) {
+	free(zp->lu[n][0]);
+	free(zp->lu[n]);
+      }
+      free(zp->indx[n]);
+    }
+  }
+  free(zp->lu);
+  free(zp->indx);
+  free(zp->nterms);
+  free(zp->elem_ok);
+  free(zp->gp_ptr);
+  free(zp->phi_ptr);
+  free(zp->xg);
+  free(zp->dw);
+  free(zp->phi);
+  memset(zp, 0, sizeof(struct ZZ_Patch_Cache));
+}
 
-       Author:          R. R. Lober (9113)
-       Date:            9 September 1998
-       Revised          
+static void
+zz_patches_setup(struct ZZ_Patch_Cache *zp,
+		 const int ev_indx,
+		 Exo_DB *exo,
+		 Dpi *dpi)
 
+     /*
+       Decide which elements enter the ZZ velocity error and lay out the
+       gauss point arrays for them. Momentum must be solved and velocity
+       on for every dimension of the element, and ev_indx must exist in
+       its block.
      */
-
 {
-  int status, i_node, i_elem, i_start, i_end, i, j, k, kk, elem_id, max_gp, min_gp;
-  int num_elems_in_patch, i_elem_type, i_elem_gp, i_elem_dim, mat_num;
-  int max_dim, valid_count, max_terms, last_interp, i_eb_indx;
-  int do_the_lu_decomp, *indx, max_velocity_norm_i_elem=0, max_velocity_err_i_elem=0;
-  int *valid_elem_mask, num_local_proc_nodes, err, global_node_num;
-  int remesh_status;
-  double **xgp_loc, **ygp_loc, **zgp_loc, **det_gp_loc, **s_lhs, *rhs, ***tau_lsp;
-  double ****tau_gp_ptch, *i_node_coords, **wt_gp_loc, tau, xgp, ygp, zgp, det, wt;
-  double max_velocity_norm, max_velocity_norm_tmp, *elem_areas=NULL, h1, h2, error_ratio;
-  double expansion_rate, reduction_rate, elem_size_min, elem_size_max, target_error;
-  double max_velocity_err, max_x=0, max_y=0, max_z=0, total_volume, pct_over_target, volume_tmp;
-  double pct_over_tolerance;
+  int e, k, valid_count, i_elem_type, i_elem_dim, i_eb_indx, ngp, nphi;
+  PROBLEM_DESCRIPTION_STRUCT *pd_e;
 
-  status = 0;
+  zz_patches_free(zp);
 
-  /* Sanity check for mesh topology data */
-  if ( ! exo->node_elem_conn_exists ) {
-    EH(-1, "Attempt to access undeveloped node->elem connectivity.");
-  }  
+  zp->ev_indx = ev_indx;
+  zp->fixed = (Num_Var_In_Type[MESH_DISPLACEMENT1] == 0);
+  zp->num_elems = exo->num_elems;
+  zp->num_nodes = dpi->num_internal_nodes + dpi->num_boundary_nodes;
 
-  i_node_coords = (double *) smalloc (3*sizeof(double));
-
-  num_local_proc_nodes = dpi->num_internal_nodes + dpi->num_external_nodes;
-  /* Per conversation with PAS 9/15, in the parallel world of goma, each node
-     has a unique and unambiguous owning proc, while each proc has elements that
-     are shared and termed boundary elements. To ensure our data requests are
-     appropriately on proc, we will use node indices as follows:
-     our local view of all the nodes will be from 
-        node index 0 to ( dpi->num_internal_nodes + dpi->num_external_nodes )
-     and this index will be used to count into the Exodus Struct arrays. */
-
-  /* Setup memory to hold least square projected derivatives for the fluid
-     shear stress tensor. For 2D, this will entail storing t11, t12, & t22
-     for each node. For 3D, it will be t11 t12, t13, t22, t23, & t33 for 
-     each node. Access will be (for t12) tau_lsp[0][1][node]. The reason
-     this looks a little complicated is because tau is symetric, and we
-     don't want to waste space for unneeded components*num_nodes. */
-  /* VIM is used here instead of exo->num_dim because for certain 2D models
-     that were specified to be solved in cylindrical or swirling coordinate
-     systems, they contain 3D tensors (thus tau_* must contain 3D comps) */
-  /* MMH: PROJECTED_CARTESIAN coordinate systems are similar to
-   * SWIRLING in this respect, too.
-   */
+  zp->elem_ok = (int *) smalloc(zp->num_elems * sizeof(int));
+  zp->gp_ptr  = (int *) smalloc((zp->num_elems + 1) * sizeof(int));
+  zp->phi_ptr = (int *) smalloc((zp->num_elems + 1) * sizeof(int));
 
-  tau_lsp = (double ***) smalloc (VIM*sizeof(double **));
-  for ( i = 0; i < VIM; i++ ) {
-    tau_lsp[i] = (double **) smalloc (VIM*sizeof(double *));
-    for ( j = 0; j < VIM; j++ ) {
-      if ( j < i ) {
-	tau_lsp[i][j] = tau_lsp[j][i];
-      }
-      else {
-	tau_lsp[i][j] = (double *) smalloc (exo->num_nodes*sizeof(double));
-	for ( k = 0; k < num_local_proc_nodes; k++ ) {
-	  tau_lsp[i][j][k] = 0.;
-	}
+  ngp = 0;
+  nphi = 0;
+  for (e = 0; e < zp->num_elems; e++) {
+    i_elem_type = Elem_Type(exo, e);
+    i_elem_dim  = elem_info(NDIM, i_elem_type);
+    i_eb_indx   = exo->elem_eb[e];
+    pd_e        = pd_glob[Matilda[i_eb_indx]];
+
+    valid_count = 0;
+    for (k = 0; k < i_elem_dim; k++) {
+      if (pd_e->e[R_MOMENTUM1 + k] && pd_e->v[VELOCITY1 + k]) {
+	valid_count++;
       }
     }
+    zp->elem_ok[e] = (valid_count == i_elem_dim &&
+		      exo->elem_var_tab[i_eb_indx*exo->num_elem_vars + ev_indx] == 1);
+
+    zp->gp_ptr[e]  = ngp;
+    zp->phi_ptr[e] = nphi;
+    if (zp->elem_ok[e]) {
+      ngp  += elem_info(NQUAD, i_elem_type);
+      nphi += elem_info(NQUAD, i_elem_type) * elem_info(NNODES, i_elem_type);
+    }
   }
+  zp->gp_ptr[zp->num_elems]  = ngp;
+  zp->phi_ptr[zp->num_elems] = nphi;
 
-  /* Complete node loop for LS patch construction @ each node */
-  for ( i_node = 0; i_node < num_local_proc_nodes; i_node++ ) {
+  zp->xg  = (dbl *) smalloc(MAX(DIM*ngp, 1) * sizeof(dbl));
+  zp->dw  = (dbl *) smalloc(MAX(ngp, 1) * sizeof(dbl));
+  zp->phi = (dbl *) smalloc(MAX(nphi, 1) * sizeof(dbl));
+}
 
-#ifdef RRL_DEBUG
-#ifdef DBG_1
-    fprintf( stdout, 
-	     "At node %d and seeing elements:\n",
-	     i_node+1);
-#endif
-#endif
+static void
+zz_patch_terms(const int nterms,
+	       const dbl r[DIM],
+	       dbl P[ZZ_MAX_TERMS])
 
-    if ( exo->num_dim == 3 ) {
-      i_node_coords[0] = exo->x_coord[i_node];
-      i_node_coords[1] = exo->y_coord[i_node];
-      i_node_coords[2] = exo->z_coord[i_node];
-    } else {
-      i_node_coords[0] = exo->x_coord[i_node];
-      i_node_coords[1] = exo->y_coord[i_node];
-      i_node_coords[2] = 0.;
-    }
-
-    i_start = exo->node_elem_pntr[i_node];
-    i_end   = exo->node_elem_pntr[i_node + 1];
+     /*
+       Polynomial terms of the least squares patch fit at a point r
+       relative to the patch node, in the order the patch systems use.
+     */
+{
+  P[0] = 1.0;
+  P[1] = r[0];
+  P[2] = r[1];
+  switch (nterms) {
+  case 3:  /* 2D with linear elements    */
+    break;
+  case 6:  /* 2D with quadratic elements */
+    P[3] = r[0]*r[0];
+    P[4] = r[0]*r[1];
+    P[5] = r[1]*r[1];
+    break;
+  case 4:  /* 3D with linear elements    */
+    P[3] = r[2];
+    break;
+  case 10: /* 3D with quadratic elements */
+    P[3] = r[2];
+    P[4] = r[0]*r[0];
+    P[5] = r[0]*r[1];
+    P[6] = r[0]*r[2];
+    P[7] = r[1]*r[1];
+    P[8] = r[1]*r[2];
+    P[9] = r[2]*r[2];
+    break;
+  default:
+    EH(-1, "Unsupported size of least squares patch for error");
+    break;
+  }
+}
 
-    num_elems_in_patch = i_end - i_start;
+static int
+zz_patches_factor(struct ZZ_Patch_Cache *zp,
+		  Exo_DB *exo)
 
-    /* Build mask for this patch and initialize */
-    valid_elem_mask = (int *) smalloc (num_elems_in_patch*sizeof(int));
-    for (i = 0; i < num_elems_in_patch; i++ ) valid_elem_mask[i] = 0;
+     /*
+       Build and LU factor the least squares system of the patch of
+       elements about every owned node. The fit is done in coordinates
+       relative to the patch node since these systems tend to be
+       ill-conditioned in the usual polynomial basis (Reference
+       D. Pelletier's report n0 1, "Implementation of Error Analysis and
+       Norms to Computational Fluid Dynamics Applications, (Bilinear
+       Finite Elements)" for SNL, dated 6/97.)
+     */
+{
+  int n, k, e, g, m, l, nt, min_gp, max_dim, last_interp, num_valid;
+  int i_elem_type, i_elem_gp, i_elem_dim;
+  dbl r[DIM], P[ZZ_MAX_TERMS], d, **a;
+
+  zp->nterms = (int *) smalloc(MAX(zp->num_nodes, 1) * sizeof(int));
+  zp->lu     = (dbl ***) smalloc(MAX(zp->num_nodes, 1) * sizeof(dbl **));
+  zp->indx   = (int **) smalloc(MAX(zp->num_nodes, 1) * sizeof(int *));
+  for (n = 0; n < zp->num_nodes; n++) {
+    zp->nterms[n] = 0;
+    zp->lu[n]     = NULL;
+    zp->indx[n]   = NULL;
+  }
 
-    max_gp     = -1;
-    min_gp     = 1000;
-    max_dim    = -1;
+  for (n = 0; n < zp->num_nodes; n++) {
+    min_gp      = 1000;
+    max_dim     = -1;
     last_interp = -1;
-    j = 0;
-    /* Loop over elems in this patch about node i_node
-      ( initial scoping loop over this patch ) */
-    for ( i_elem = i_start; i_elem < i_end; i_elem++) {
-
-      /* Check elem_type for each elem (for appropriate interp)
-	 and check pd_glob for the block of this elem to check for
-	 velocity existance and for variable interp for the material.
-         This data will be applied to the patch mask to indicate
-         which neighbor elems can be appropriately employed in the
-         least square fit for this patch. */
-
-      elem_id          = exo->node_elem_list[i_elem];
-      i_elem_type      = Elem_Type( exo, 
-				    elem_id);     /* element type */
-      i_elem_gp        = elem_info( NQUAD, 
-				    i_elem_type); /* number of
-						     quadrature points */
-      i_elem_dim       = elem_info( NDIM, 
-				    i_elem_type); /* element dimension
-						     (of course!) */
-      /* Save this dimension if first time through - subsequent passes
-	 test if dimension ever changes. This is a no no. */
-      if ( i_elem == i_start ) max_dim = i_elem_dim;
-      if ( i_elem_dim != max_dim || 
-	   i_elem_dim != exo->num_dim ) {
-	EH (-1,
-	    "Cannot mix element dimensionality for error computation");
-      }
-
-      if ( i_elem_gp > max_gp ) {
-	max_gp = i_elem_gp;
-      }
-
-      if ( i_elem_gp < min_gp ) {
-	min_gp = i_elem_gp;
-      }
-
-      i_eb_indx        = exo->elem_eb[elem_id];
-      mat_num          = Matilda[i_eb_indx];
-      pd               = pd_glob[mat_num];
-
-      /* Confirm momentum is being solved in this material & velocity is
-	 turned on for each dimension that the element occupies. */
-      valid_count = 0;
-      for ( k = 0; k < i_elem_dim; k++ ) {
-	if ( pd->e[R_MOMENTUM1 + k] &&
-	     pd->v[VELOCITY1 + k] ) {
-	  valid_count++;
+    num_valid   = 0;
+    for (k = exo->node_elem_pntr[n]; k < exo->node_elem_pntr[n + 1]; k++) {
+      e           = exo->node_elem_list[k];
+      i_elem_type = Elem_Type(exo, e);
+      i_elem_gp   = elem_info(NQUAD, i_elem_type);
+      i_elem_dim  = elem_info(NDIM, i_elem_type);
+
+      if (k == exo->node_elem_pntr[n]) max_dim = i_elem_dim;
+      if (i_elem_dim != max_dim || i_elem_dim != exo->num_dim) {
+	EH(-1, "Cannot mix element dimensionality for error computation");
+      }
+      if (i_elem_gp < min_gp) min_gp = i_elem_gp;
+
+      if (zp->elem_ok[e]) {
+	if (last_interp == -1) {
+	  last_interp = pd_glob[Matilda[exo->elem_eb[e]]]->i[VELOCITY1];
 	}
-      }
-
-      /* Only include element if every dimension was valid, and if this
-         ev_indx exists for this i_eb_indx */
-      if ( valid_count == i_elem_dim &&
-	   exo->elem_var_tab[i_eb_indx*exo->num_elem_vars + ev_indx] == 1 ) {
-	valid_elem_mask[j] = 1;
-
-	/* Save this interpolation if first time through - subsequent passes
-	 test if interpolation ever changes. This is a no no. */
-	if ( i_elem == i_start ) last_interp = pd->i[VELOCITY1];
-	if ( pd->i[VELOCITY1] != last_interp ) {
-	  EH (-1,
-	      "Cannot mix velocity interpolation levels for error computation");
+	if (pd_glob[Matilda[exo->elem_eb[e]]]->i[VELOCITY1] != last_interp) {
+	  EH(-1, "Cannot mix velocity interpolation levels for error computation");
 	}
-      }
-
-#ifdef RRL_DEBUG
-#ifdef DBG_1
-      fprintf( stdout,
-	       "       %d (blk %d, type %d, gp %d)\n", 
-	       elem_id+1,
-	       exo->eb_id[exo->elem_eb[elem_id]],
-	       i_elem_type,
-	       i_elem_gp );
-#endif
-#endif
-      
-      j++;
-    } /* End initial scoping loop over this patch about node i_node */
-
-    /* Need to build local arrays to store working local gp coords */
-    xgp_loc    = (double **) smalloc ( num_elems_in_patch*sizeof(double *));
-    ygp_loc    = (double **) smalloc ( num_elems_in_patch*sizeof(double *));
-    zgp_loc    = (double **) smalloc ( num_elems_in_patch*sizeof(double *));
-    det_gp_loc = (double **) smalloc ( num_elems_in_patch*sizeof(double *));
-    wt_gp_loc  = (double **) smalloc ( num_elems_in_patch*sizeof(double *));
-
-    for (k = 0; k < num_elems_in_patch; k++ ) {
-      xgp_loc[k]    = (double *) smalloc ( max_gp*sizeof(double));
-      ygp_loc[k]    = (double *) smalloc ( max_gp*sizeof(double));
-      zgp_loc[k]    = (double *) smalloc ( max_gp*sizeof(double));
-      det_gp_loc[k] = (double *) smalloc ( max_gp*sizeof(double));
-      wt_gp_loc[k]  = (double *) smalloc ( max_gp*sizeof(double));
-
-      /* Initialize the arrays for this patch */
-      for (kk = 0; kk < max_gp; kk++ ) {
-	xgp_loc[k][kk]    = 0.;
-	ygp_loc[k][kk]    = 0.;
-	zgp_loc[k][kk]    = 0.;
-	det_gp_loc[k][kk] = 0.;
-	wt_gp_loc[k][kk]  = 0.;
+	num_valid++;
       }
     }
+    if (num_valid == 0) continue;
 
-    /* Determine size of LS system to be solved for this patch */
-    if ( max_dim > 2 &&
-	 min_gp > 9 ) {
-      max_terms = 10; /* 3D with quadratic elements */
-    }
-    else if ( max_dim > 2 && 
-	      min_gp <= 9 ) {
-      max_terms = 4; /* 3D with linear elements */
-    }
-    else if ( max_dim <= 2 &&
-	      min_gp > 5 ) {
-      max_terms = 6; /* 2D with quadratic elements */
-    }
-    else {
-      max_terms = 3; /* 2D with linear elements */
-    }
-
-    s_lhs = (double **) smalloc (max_terms*sizeof(double *));
-    for (k = 0; k < max_terms; k++) {
-      s_lhs[k] = (double *) smalloc (max_terms*sizeof(double));
-      for (kk = 0; kk < max_terms; kk++ ) {
-	s_lhs[k][kk]    = 0.;
-      }
-    }
-    rhs = (double *) smalloc (max_terms*sizeof(double));
-    for (kk = 0; kk < max_terms; kk++ ) {
-      rhs[kk]    = 0.;
-    }
-
-    /* Setup memory to hold least squares' projected derivatives for the
-       fluid shear stress tensor at the gauss points for elements in this
-       patch.  For 2D, this will entail storing t11, t12, & t22 for each
-       gauss point. For 3D, it will be t11 t12, t13, t22, t23, & t33 for each
-       gauss point. Access will be (for t12) tau_gp_ptch[0][1][elem][gp]. The
-       reason this looks a little complicated is because tau is symetric, and
-       we don't want to waste space for unneeded components. */
-    /* VIM is used here instead of exo->num_dim because for certain 2D models
-       that were specified to be solved in cylindrical or swirling coordinate
-       systems, they contain 3D tensors (thus tau_* must contain 3D comps) */
-    /* MMH: PROJECTED_CARTESIAN coordinate systems are similar to
-     * SWIRLING in this respect, too.
-     */
-
-    tau_gp_ptch = (double ****) smalloc (VIM*sizeof(double ***));
-    for ( i = 0; i < VIM; i++ ) {
-      tau_gp_ptch[i] = (double ***) smalloc (VIM*sizeof(double **));
-      for ( j = 0; j < VIM; j++ ) {
-	if ( j < i ) {
-	  tau_gp_ptch[i][j] = tau_gp_ptch[j][i];
-	}
-	else {
-	  tau_gp_ptch[i][j] = (double **) smalloc (num_elems_in_patch*sizeof(double *));
-	  for ( k = 0; k < num_elems_in_patch; k++ ) {
-	    tau_gp_ptch[i][j][k] = (double *) smalloc ( max_gp*sizeof(double));
-	    for (kk = 0; kk < max_gp; kk++) {
-	      tau_gp_ptch[i][j][k][kk] = 0.0;
-	    }
+    /* Size of the LS system for this patch, from the element dimension and
+       interpolation rather than VIM (per conversation with RRR, 9/21/98) */
+    if (max_dim > 2 && min_gp > 9) {
+      nt = 10; /* 3D with quadratic elements */
+    } else if (max_dim > 2) {
+      nt = 4;  /* 3D with linear elements */
+    } else if (min_gp > 5) {
+      nt = 6;  /* 2D with quadratic elements */
+    } else {
+      nt = 3;  /* 2D with linear elements */
+    }
+
+    a = (dbl **) smalloc(nt * sizeof(dbl *));
+    a[0] = (dbl *) smalloc(nt * nt * sizeof(dbl));
+    for (m = 0; m < nt; m++) {
+      a[m] = a[0] + m * nt;
+      for (l = 0; l < nt; l++) a[m][l] = 0.;
+    }
+
+    for (k = exo->node_elem_pntr[n]; k < exo->node_elem_pntr[n + 1]; k++) {
+      e = exo->node_elem_list[k];
+      if (!zp->elem_ok[e]) continue;
+      for (g = zp->gp_ptr[e]; g < zp->gp_ptr[e + 1]; g++) {
+	r[0] = zp->xg[DIM*g]     - exo->x_coord[n];
+	r[1] = zp->xg[DIM*g + 1] - exo->y_coord[n];
+	r[2] = (exo->num_dim > 2) ? zp->xg[DIM*g + 2] - exo->z_coord[n] : 0.;
+	zz_patch_terms(nt, r, P);
+	for (m = 0; m < nt; m++) {
+	  for (l = 0; l < nt; l++) {
+	    a[m][l] += P[m] * P[l] * zp->dw[g];
 	  }
 	}
       }
     }
 
-    i_start = exo->node_elem_pntr[i_node];
-    i_end   = exo->node_elem_pntr[i_node + 1];
-    /* Actual workhorse LHS loop over the elems in this patch */
-    for (k = 0, i_elem = i_start; i_elem < i_end; k++, i_elem++) {
-      /* Only employ element if it has been deemed worthy from above scoping loop */
-      if (valid_elem_mask[k] == 1) {
-
-	/* Extract the info for this elem of the patch */
-	elem_id          = exo->node_elem_list[i_elem];
-
-	err = load_elem_dofptr(elem_id, exo, x, x_old, xdot, 
-			       xdot_old, resid_vector, 0);
-	EH(err, "load_elem_dofptr");     
- 
-	err = bf_mp_init(pd);
-	EH(err, "bf_mp_init");
-
-	mat_num = ei->mn;
-
-	i_elem_type      = ei->ielem_type;     /* element type */
-	i_elem_gp        = elem_info( NQUAD, 
-				      i_elem_type); /* number of
-						       quadrature points */
-	i_elem_dim       = ei->ielem_dim; /* element dimension
-						       (of course!) */
-
-	err = fill_lhs_lspatch ( i_node_coords,
-				 wt_gp_loc[k],
-				 xgp_loc[k],
-				 ygp_loc[k],
-				 zgp_loc[k],
-				 det_gp_loc[k],
-				 max_terms,
-				 s_lhs,
-				 k,
-				 tau_gp_ptch );
-
-      } /* End of treating worthy nodes with valid_elem_mask values */
-    } /* End workhorse LHS loop over this patch */
-
-    /* Now loop over needed components in tau_lsp for node i_node,
-       again over the elements in the patch this time filling the rhs
-       vector and solving via lu decomp and back sub for each
-       component in tau_lsp in turn.*/
-    /* NOTE: We're computing the needed tau components using VIM since
-       that will pick up the necessary 3D components for cylindrical
-       or swirling coordinate systems. The size of the system (least squares)
-       being solved will be determined by the max_terms calculation, since
-       that mechanism will result in the most high fidelity LS patch fitted.
-       For example, if we were to take a 2D mesh of quadratic elements with
-       a cylindrical coord system, and call it 3D, the best patch fit it could
-       get would be linear 3D. By solving a 2D system on quadratic elements,
-       the system fidelity goes up to 6 terms for the same problem. We can
-       always solve for the additional tau terms with either system, so we're
-       dictating the number of tau terms via VIM, and the max_terms via the
-       actual element dimension and interpolation levels. Per conversation with
-       RRR, 9/21/98 */
-    /* MMH: PROJECTED_CARTESIAN coordinate systems are similar to
-     * SWIRLING in this respect, too.
-     */
-    do_the_lu_decomp = 1;
-    indx = (int *) smalloc (max_terms * sizeof(int));
-    for ( i = 0; i < VIM; i++ ) {
-      for ( j = 0; j < VIM; j++ ) {
-	if ( j < i ) {
-	  tau_lsp[i][j][i_node] = tau_lsp[j][i][i_node];
-	}
-	else {
-	  for ( kk = 0; kk < max_terms; kk++ ) {
-	    rhs[kk]    = 0.;
-	  }
-
-	  for ( k = 0, i_elem = i_start; i_elem < i_end; k++, i_elem++) {
-	    /* Only employ element if it has been deemed worthy from 
-	     * above scoping loop */
-	    if ( valid_elem_mask[k] == 1 ) {
-	      elem_id          = exo->node_elem_list[i_elem];
-	      i_elem_type      = Elem_Type( exo, 
-					    elem_id);     /* element type */
-	      i_elem_gp        = elem_info( NQUAD, 
-					    i_elem_type); /* number of
-							     quadrature points */
-	      for ( kk = 0; kk < i_elem_gp; kk++ ) {
-		tau = tau_gp_ptch[i][j][k][kk];
-		xgp = xgp_loc[k][kk];
-		ygp = ygp_loc[k][kk];
-		zgp = zgp_loc[k][kk];
-		det = det_gp_loc[k][kk];
-		wt  = wt_gp_loc[k][kk];
-		switch ( max_terms ) {
-		case 3:  /* 2D with linear elements    */
-		  rhs[0] += 1.0 *     tau * det * wt;
-		  rhs[1] += xgp *     tau * det * wt;
-		  rhs[2] += ygp *     tau * det * wt;
-		  break;
-		case 6:  /* 2D with quadratic elements */
-		  rhs[0] += 1.0 *     tau * det * wt;
-		  rhs[1] += xgp *     tau * det * wt;
-		  rhs[2] += ygp *     tau * det * wt;
-		  rhs[3] += xgp*xgp * tau * det * wt;
-		  rhs[4] += xgp*ygp * tau * det * wt;
-		  rhs[5] += ygp*ygp * tau * det * wt;
-		  break;
-		case 4:  /* 3D with linear elements    */
-		  rhs[0] += 1.0 *     tau * det * wt;
-		  rhs[1] += xgp *     tau * det * wt;
-		  rhs[2] += ygp *     tau * det * wt;
-		  rhs[3] += zgp *     tau * det * wt;
-		  break;
-		case 10: /* 3D with quadratic elements */
-		  rhs[0] += 1.0 *     tau * det * wt;
-		  rhs[1] += xgp *     tau * det * wt;
-		  rhs[2] += ygp *     tau * det * wt;
-		  rhs[3] += zgp *     tau * det * wt;
-		  rhs[4] += xgp*xgp * tau * det * wt;
-		  rhs[5] += xgp*ygp * tau * det * wt;
-		  rhs[6] += xgp*zgp * tau * det * wt;
-		  rhs[7] += ygp*ygp * tau * det * wt;
-		  rhs[8] += ygp*zgp * tau * det * wt;
-		  rhs[9] += zgp*zgp * tau * det * wt;
-		  break;
-		default:
-		  EH(-1, "Unsupported size in building RHS of least"
-		     " squares patch for error");
-		  break;
-		}
-	      }
-	    }
-	  }
+    zp->nterms[n] = nt;
+    zp->lu[n]     = a;
+    zp->indx[n]   = (int *) smalloc(nt * sizeof(int));
+    if (lu_decomp(a, nt, zp->indx[n], &d) == -1) {
+      EH(-1, " Error occurred in calc_zz_error_vel");
+      return (-1);
+    }
+  }
 
-	  /* Now solve the system for this patch. The first time through perform
-	     the LU decomposition and the back substitution. All subsequent loop
-	     iterations for this patch need only back substitute. */
+  return (0);
+}
 
-	  if (lu_decomp_backsub_driver(s_lhs, rhs, indx, max_terms,
-				       do_the_lu_decomp) == -1) {
-	    EH(-1, " Error occurred in calc_zz_error_vel" );
-	    status = -1;
-	    return (status);
-	  }
+static int
+calc_zz_error_vel(double x[], /* Solution vector                       */
+		  double x_old[], double xdot[],
+		  double xdot_old[],
+		  double resid_vector[],
+		  int ev_indx,	/* Variable index for zz_error               */
+		  double ***gvec_elem, /* evar vals[eb_indx][ev_indx][elem]  */
+		  Exo_DB * const exo,
+		  Dpi * const dpi,
+		  int compute_elem_size)
 
-	  /* Next time just do the back sub */
-	  if ( do_the_lu_decomp == 1 ) do_the_lu_decomp = 0;
+     /*
+       Function which calculates the Zienkiewicz-Zhu error indicator for each
+       appropriate element in the model
 
-	  tau_lsp[i][j][i_node] = rhs[0]; /* This works since we solved the system on a local
-					     coord basis */
+       Author:          R. R. Lober (9113)
+       Date:            9 September 1998
+       Revised
 
-#ifdef RRL_DEBUG
-#ifdef DBG_2
-	  fprintf ( stdout,
-		    "Just computed lsp tau%d%d for node %d = %6.4lf\n",
-		    i + 1,
-		    j + 1,
-		    i_node + 1,
-		    tau_lsp[i][j][i_node] );
-#endif
-#endif
+       The fluid shear stress is evaluated once at the gauss points of each
+       element, projected onto the owned nodes by least squares fits over
+       the node patches, and the nodal values exchanged with the
+       neighbouring processors before the element errors are integrated.
+       Patch systems stay factored in ZZ_Patches between calls.
+     */
 
-	}
-      }
-    }
+{
+  struct ZZ_Patch_Cache *zp = &ZZ_Patches;
+  int status, e, g, n, k, j, m, a, b, c, ip, nn, nt, ncomp, err, I, i_eb_indx;
+  int build, remesh_status, max_velocity_norm_i_elem, max_velocity_err_i_elem;
+  int slot_vn, slot_err, slot_vol, slot_over, slot_evn, slot_eerr, slot_ctr[DIM];
+  int owner_vn, owner_err;
+  int *conn;
+  dbl xi[DIM], gamma[DIM][DIM], mu, mup, cw[ZZ_MAX_COMP];
+  dbl rhs[ZZ_MAX_COMP][ZZ_MAX_TERMS], P[ZZ_MAX_TERMS], r[DIM], t, lsp, fem;
+  dbl err_sum, vel_sum, area, err_gp, vel_gp, *phi_g;
+  dbl *tau_gp, **tau_lsp, *elem_err, *elem_vel, *elem_areas;
+  dbl max_velocity_norm, max_velocity_err, max_ctr[DIM], total_volume;
+  dbl volume_tmp, pct_over_target, pct_over_tolerance, h1, h2, error_ratio;
+  dbl expansion_rate=0, reduction_rate=0, elem_size_min=0, elem_size_max=0;
+  dbl target_error=0;
 
-#ifdef RRL_DEBUG
-#ifdef DBG_1
-    fprintf( stdout,
-	     "\n  node    t11       t12       t13       t21       t22       t23       t31      t32      t33\n" ); 
-    if (ei->ielem_dim > 2) {
-      fprintf( stdout,
-	       "  %2d   %6.4lf   %6.4lf   %6.4lf   %6.4lf   %6.4lf   %6.4lf   %6.4lf   %6.4lf   %6.4lf\n",
-	       i_node + 1,
-	       tau_lsp[0][0][i_node],
-	       tau_lsp[0][1][i_node],
-	       tau_lsp[0][2][i_node],
-	       tau_lsp[1][0][i_node],
-	       tau_lsp[1][1][i_node],
-	       tau_lsp[1][2][i_node],
-	       tau_lsp[2][0][i_node],
-	       tau_lsp[2][1][i_node],
-	       tau_lsp[2][2][i_node] ); 
-    } else {
-      fprintf( stdout,
-	       "  %2d   %6.4lf   %6.4lf   < NA >   %6.4lf   %6.4lf   < NA >   < NA >   < NA >   < NA >\n",
-	       i_node + 1,
-	       tau_lsp[0][0][i_node],
-	       tau_lsp[0][1][i_node],
-	       tau_lsp[1][0][i_node],
-	       tau_lsp[1][1][i_node] ); 
-    }  
-#endif
-#endif
+  status = 0;
 
-    /* Clean up memory for this patch */
-    for (k = 0; k < num_elems_in_patch; k++ ) {
-      free (xgp_loc[k]);
-      free (ygp_loc[k]);
-      free (zgp_loc[k]);
-      free (det_gp_loc[k]);
-      free (wt_gp_loc[k]);
-    }
-    free (xgp_loc);
-    free (ygp_loc);
-    free (zgp_loc);
-    free (det_gp_loc);
-    free (wt_gp_loc);
-
-    free (valid_elem_mask);
-
-    for (k = 0; k < max_terms; k++ ) {
-      free (s_lhs[k]);
-    }
-    free (s_lhs);
-    free (rhs);
-    free (indx);
-
-    for ( i = 0; i < VIM; i++ ) {
-      for ( j = 0; j < VIM; j++ ) {
-	/* Only the upper tri diag members were malloc'd, so only free those */
-	if ( j >= i ) {
-	  for ( k = 0; k < num_elems_in_patch; k++ ) {
-	    free (tau_gp_ptch[i][j][k]);
-	  } 
-	  free (tau_gp_ptch[i][j]);
-	}
-      }
-      free (tau_gp_ptch[i]);
-    }
-    free (tau_gp_ptch);
+  /* Sanity check for mesh topology data */
+  if ( ! exo->node_elem_conn_exists ) {
+    EH(-1, "Attempt to access undeveloped node->elem connectivity.");
+  }
 
-#ifdef RRL_DEBUG
-#ifdef DBG_1
-    fprintf( stdout,
-	     "\n" );      
-#endif
-#endif
+  build = (!zp->built || !zp->fixed || zp->ev_indx != ev_indx);
+  if (build) zz_patches_setup(zp, ev_indx, exo, dpi);
 
-  }  /* End of loop building LHS for the patch about node i_node */
-
-  /* Loop over each element in the model for the following. */
-  /* Now have tau_lsp at the nodes, and tau at the gauss points (via fv)
-     To get tau_lsp back at the gauss points, we will interpolate with
-     shape functions. With both quantities back at the gauss points, we will
-     cycle over the gauss points, computing the gfem/lsp difference for
-     each tau component at each gauss point, then using these to compute
-     the elemental error. Then store this absolute error val for the 
-     currrent element into gvec_elem for now. */
-
-  valid_elem_mask = (int *) smalloc (exo->num_elems*sizeof(int));
-  for (i = 0; i < exo->num_elems; i++ ) valid_elem_mask[i] = 0;
-
-  /* First do scoping loop to set up the valid_elem_mask for the entire model
-     this time (valid to compute zz error based on velocity)  */
-  for (i_elem = 0; i_elem < exo->num_elems; i_elem++ ) {
-    elem_id          = exo->node_elem_list[i_elem];
-    i_elem_type      = Elem_Type(exo, elem_id); /* element type */
-    i_elem_gp        = elem_info(NQUAD, i_elem_type); /* number of quadrature points */
-    i_elem_dim       = elem_info(NDIM, i_elem_type); /* element dimension  */
-    i_eb_indx        = exo->elem_eb[i_elem];
-    mat_num          = Matilda[i_eb_indx];
-    pd               = pd_glob[mat_num];
-
-    /* Confirm momentum is being solved in this material & velocity is
-       turned on for each dimension that the element occupies. */
-    valid_count = 0;
-    for ( k = 0; k < i_elem_dim; k++ ) {
-      if ( pd->e[R_MOMENTUM1 + k] &&
-	   pd->v[VELOCITY1 + k] ) {
-	valid_count++;
-      }
+  /* tau is symmetric, so only its upper triangle (component c for a <= b)
+     is fitted. VIM is used here instead of exo->num_dim because for
+     certain 2D models that were specified to be solved in cylindrical or
+     swirling coordinate systems, they contain 3D tensors. MMH:
+     PROJECTED_CARTESIAN coordinate systems are similar to SWIRLING in
+     this respect, too. Off diagonal terms occur twice in the norms. */
+  ncomp = 0;
+  for (a = 0; a < VIM; a++) {
+    for (b = a; b < VIM; b++) {
+      cw[ncomp++] = (b > a) ? 2.0 : 1.0;
     }
-
-    /* Only include element if every dimension was valid, and if this
-       ev_indx exists for this i_eb_indx */
-    if ( valid_count == i_elem_dim &&
-	 exo->elem_var_tab[i_eb_indx*exo->num_elem_vars + ev_indx] == 1 ) {
-      valid_elem_mask[i_elem] = 1;
-    }
-  } /* End scoping loop for element error integration */
-
-  /* Now do real loop for element error integration over entire model */
-  /* Set up values to find max's and do the elem size stuff */
-  if ( compute_elem_size != 0 ) {
-    elem_areas = (double *) smalloc(exo->num_elems * sizeof (double));
-    for (i = 0; i < exo->num_elems; i++ ) elem_areas[i] = 0;
   }
-  max_velocity_norm  = 0.;
-  max_velocity_err   = 0.;
-  total_volume       = 0.;
-  pct_over_target    = 0.;
-  pct_over_tolerance = 0.;
-  volume_tmp         = 0.;
-  remesh_status      = -1;
-
-  for (i_elem = 0; i_elem < exo->num_elems; i_elem++) {
-    /* Only employ element if it has been deemed worthy from above scoping loop */
-
-    if (valid_elem_mask[i_elem] == 1) {
-      err = load_elem_dofptr(i_elem, exo, x, x_old, xdot, xdot_old,
-			     resid_vector, 0);
-      EH(err, "load_elem_dofptr"); 
 
-      err = bf_mp_init(pd);
-      EH(err, "bf_mp_init");
+  tau_gp = (dbl *) smalloc(MAX(ncomp*zp->gp_ptr[zp->num_elems], 1) * sizeof(dbl));
 
-      /* Extract the info for this elem of the patch */
+  /* One pass over the elements for tau = mu * gamma at their gauss points,
+     with the gauss point geometry as well when it has to be rebuilt */
+  for (e = 0; e < zp->num_elems; e++) {
+    if (!zp->elem_ok[e]) continue;
 
-      mat_num = ei->mn;
-      i_elem_type      = ei->ielem_type;      /* element type */
-      i_elem_gp        = elem_info( NQUAD, 
-				    i_elem_type); /* number of quadrature points */
-      i_elem_dim       = ei->ielem_dim; /* element dimension
-						     (of course!) */
+    err = load_elem_dofptr(e, exo, x, x_old, xdot, xdot_old,
+			   resid_vector, 0);
+    EH(err, "load_elem_dofptr");
 
-      i_eb_indx           = exo->elem_eb[i_elem];
+    err = bf_mp_init(pd);
+    EH(err, "bf_mp_init");
 
-#ifdef RRL_DEBUG
-#ifdef DBG_1
-      fprintf( stdout,
-	       "\n\n About to integrate zz error on the worthy element %d (blk %d)\n", 
-	       i_elem+1,
-	       exo->eb_id[i_eb_indx] );
-#endif
-#endif
+    nn = ei->num_local_nodes;
+    for (g = zp->gp_ptr[e]; g < zp->gp_ptr[e + 1]; g++) {
+      ip = g - zp->gp_ptr[e];
+      find_stu(ip, ei->ielem_type, &xi[0], &xi[1], &xi[2]);
+      fv->wt = Gq_weight(ip, ei->ielem_type);
 
-      /* Now interpolate the LS projected values of tau back to the gauss points,
-	 extract the fem values of tau at the same gauss points, 
-	 and compute the error (absolute indicator) for elem i_elem */
-      err = abs_error_at_elem(i_elem, tau_lsp, gvec_elem[i_eb_indx][ev_indx],
-			      &max_velocity_norm_tmp, &elem_areas[i_elem]);
+      err = load_basis_functions(xi, bfd);
+      EH(err, "problem from load_basis_functions");
 
-      /* sum the total area/vol of the elems being used for error computation */
-      total_volume += elem_areas[i_elem];
+      err = beer_belly();
+      EH(err, "beer_belly");
 
-      if (max_velocity_norm_tmp > max_velocity_norm) {
-	max_velocity_norm = max_velocity_norm_tmp;
-	max_velocity_norm_i_elem = i_elem;
-      }
+      err = load_fv();
+      EH(err, "load_fv");
 
-      if (gvec_elem[i_eb_indx][ev_indx][i_elem] > max_velocity_err) {
-	max_velocity_err = gvec_elem[i_eb_indx][ev_indx][i_elem];
-	max_velocity_err_i_elem = i_elem;
+      /* NOTE: load_bf_grad MUST be called before load_fv_grads as this
+	 call depends on it! - RRL 10/30/98 */
+      err = load_bf_grad();
+      EH(err, "load_bf_grad");
 
-	max_x = 0;
-	max_y = 0;
-	max_z = 0;
+      err = load_fv_grads();
+      EH(err, "load_fv_grads");
 
-	for ( j = 0; j < ei->num_local_nodes; j++ ) {
-	  /* also convert from node number to dof number */
-	  global_node_num = Proc_Elem_Connect[ei->iconnect_ptr + j];
-	  max_x += exo->x_coord[global_node_num];
-	  max_y += exo->y_coord[global_node_num];
-	  if (exo->num_dim > 2 ) max_z += exo->z_coord[global_node_num];
+      /* In Cartesian coordinates grad_v[a][b] = d v_b / d x_a */
+      for (a = 0; a < VIM; a++) {
+	for (b = 0; b < VIM; b++) {
+	  gamma[a][b] = fv->grad_v[a][b] + fv->grad_v[b][a];
 	}
-	max_x /= ei->num_local_nodes;
-	max_y /= ei->num_local_nodes;
-	if (exo->num_dim > 2 ) max_z /= ei->num_local_nodes;
       }
-
-    } /* End of treating worthy elems with valid_elem_mask values */
-  } /* End of real loop for element error integration over entire model */
-
-#ifdef RRL_DEBUG
-#ifdef DBG_1
-      fprintf( stdout,
-	       "\n\n About to integrate zz error on the worthy element %d (blk %d)\n", 
-	       i_elem+1,
-	       exo->eb_id[i_eb_indx] );
-#endif
-#endif
-
-  fprintf( stdout,
-	   "\n Max energy norm of the velocity vector ( element %d ) \t= %6.4f\n", 
-	   max_velocity_norm_i_elem+1,
-	   max_velocity_norm );
-  fprintf( stdout,
-	   " Max ZZ error (velocity based)          ( element %d ) \t= %6.4f\n", 
-	   max_velocity_err_i_elem+1,
-	   max_velocity_err );
-  fprintf( stdout,
-	   "   x centroid = %6.4f\n", 
-	   max_x );
-  fprintf( stdout,
-	   "   y centroid = %6.4f\n", 
-	   max_y );
-  fprintf( stdout,
-	   "   z centroid = %6.4f\n", 
-	   max_z );
-
-  /* Now compute recommended elem sizes if needed */
-  if ( compute_elem_size != 0 ) {
-    /* First grab user supplied params */
-    reduction_rate     = pp_error_data[0].error_params[0];
-    expansion_rate     = pp_error_data[0].error_params[1];
-    elem_size_min      = pp_error_data[0].error_params[2];
-    elem_size_max      = pp_error_data[0].error_params[3];
-    target_error       = pp_error_data[0].error_params[4];
-    pct_over_tolerance = pp_error_data[0].error_params[5];
-
-    for (i_elem = 0; i_elem < exo->num_elems; i_elem++ ) {
-      /* Only employ element if it has been deemed worthy from above scoping loop */
-      if ( valid_elem_mask[i_elem] == 1 ) {
-	i_eb_indx                              = exo->elem_eb[i_elem];
-
-	/* Determine typical element length scale - sqrt if 2D, cube root if 3D */
-	if ( exo->num_dim == 3 ) {
-	  h1 = pow ( elem_areas[i_elem],
-		     0.3333333333 );
-	} else {
-	  h1 = sqrt ( elem_areas[i_elem] );
+      mu = viscosity(gn, gamma, NULL);
+      if (pd->v[POLYMER_STRESS11]) {
+	/* get polymer viscosity */
+	mup = viscosity(gn, gamma, NULL);
+	mu = mu + mup;
+      }
+      c = 0;
+      for (a = 0; a < VIM; a++) {
+	for (b = a; b < VIM; b++) {
+	  tau_gp[ncomp*g + c++] = mu*gamma[a][b];
 	}
+      }
 
-	error_ratio = gvec_elem[i_eb_indx][ev_indx][i_elem]/target_error;
-
-	if ( error_ratio <= 1.0 ) {
-	  h2 = ( pow ( error_ratio,
-		       -1./expansion_rate ) ) * h1;
-	} else {
-	  h2 = ( pow ( error_ratio,
-		       -1./reduction_rate ) ) * h1;
-	  /* This element needs refinement - add into the volume over calculation */
-	  volume_tmp += elem_areas[i_elem];
+      if (build) {
+	phi_g = zp->phi + zp->phi_ptr[e] + ip*nn;
+	for (k = 0; k < DIM; k++) zp->xg[DIM*g + k] = 0.;
+	for (j = 0; j < nn; j++) {
+	  m = ei->ln_to_dof[R_MOMENTUM1][j];
+	  phi_g[j] = (m >= 0) ? bf[R_MOMENTUM1]->phi[m] : 0.;
+	  I = Proc_Elem_Connect[ei->iconnect_ptr + j];
+	  for (k = 0; k < ei->ielem_dim; k++) {
+	    zp->xg[DIM*g + k] += phi_g[j]*Coor[k][I];
+	  }
 	}
-
-	/* Now ensure that the elem size floors & ceilings are observed */
-	if ( h2 < elem_size_min ) h2 = elem_size_min;
-	if ( h2 > elem_size_max ) h2 = elem_size_max;
-
-	/* Store into gvec array - note that we store into the next ev_indx place
-	   since this value always follows the error measure that it applies to */
-	gvec_elem[i_eb_indx][ev_indx + 1][i_elem] = h2;
+	zp->dw[g] = bf[R_MOMENTUM1]->detJ * fv->wt;
       }
     }
-
-    pct_over_target = volume_tmp/(total_volume*0.01); /* Builds % of volume over error
-							target */
-
-    fprintf( stdout,
-	     "\n Target error                                        \t= %6.4f\n", 
-	     target_error );
-    fprintf( stdout,
-	     " Problem volume (area) considered for error          \t= %6.4f\n", 
-	     total_volume );
-    fprintf( stdout,
-	     " Percent of problem volume over error target         \t= %6.2f [%%]\n", 
-	     pct_over_target );
-    fprintf( stdout,
-	     " Tolerance for percent of problem volume over value  \t= %6.2f [%%]\n", 
-	     pct_over_tolerance );
-
-    if ( pct_over_target > pct_over_tolerance ) {
-      /* Need to remesh the problem and run it again using sizing data */
-      remesh_status = 2;
-      fprintf( stdout,
-	       " Remeshing status                                    \t= %d\n", 
-	       remesh_status );
-      fprintf( stdout,
-	       "\n (Recommend remeshing model using the *ELSIZE element variable)\n" );
-    } else if ( pct_over_target <= pct_over_tolerance &&
-		max_velocity_err > target_error ) {
-      remesh_status = 1;
-      fprintf( stdout,
-	       " Remeshing status                                    \t= %d\n", 
-	       remesh_status );
-      fprintf( stdout,
-	       "\n (Max error > target error, but volume < target error within tolerance)\n" );
-    }  else if ( max_velocity_err <= target_error ) {
-      remesh_status = 0;
-      fprintf( stdout,
-	       " Remeshing status                                    \t= %d\n", 
-	       remesh_status );
-      fprintf( stdout,
-	       "\n (Max error < target error, error reduction objective met)\n" );
-    } else {
-      EH( -1, 
-	  "Undetermined state encountered during error/remeshing size data calculation\n" );
-    }
-      
-    fprintf( stdout,
-	     "\n Current number of nodes (resolution)                \t= %d\n", 
-	     exo->num_nodes );
-    fprintf( stdout,
-	     " Current number of elements                          \t= %d\n", 
-	     exo->num_elems );
-
-    /* Free memory */
-    free ( elem_areas );
   }
 
-  /* Now normalize the raw values of ZZ velocity based error */
-  for (i_elem = 0; i_elem < exo->num_elems; i_elem++ ) {
-    /* Only employ element if it has been deemed worthy from above scoping loop */
-    if ( valid_elem_mask[i_elem] == 1 ) {
-      i_eb_indx                              = exo->elem_eb[i_elem];
-      gvec_elem[i_eb_indx][ev_indx][i_elem] /= (max_velocity_norm*0.01); /* NOTE: converting to % */
+  if (build) {
+    if (zz_patches_factor(zp, exo) == -1) {
+      free(tau_gp);
+      return (-1);
     }
+    zp->built = TRUE;
   }
 
-  /* Final memory cleanup */
-  for ( i = 0; i < VIM; i++ ) {
-    for ( j = 0; j < VIM; j++ ) {
-      /* Only the upper tri diag members were malloc'd, so only free those */
-      if ( j >= i ) {
-	free (tau_lsp[i][j]);
-      }
-    }
-    free (tau_lsp[i]);
+  /* Least squares projection of tau onto the owned nodes; each patch
+     system is already factored, so only the rhs is assembled. The fit
+     is in coordinates local to the node, so the nodal value is the
+     constant term. */
+  tau_lsp = (dbl **) smalloc(ncomp * sizeof(dbl *));
+  for (c = 0; c < ncomp; c++) {
+    tau_lsp[c] = (dbl *) smalloc(MAX(exo->num_nodes, 1) * sizeof(dbl));
+    for (n = 0; n < exo->num_nodes; n++) tau_lsp[c][n] = 0.;
   }
-  free (tau_lsp);
-  free (i_node_coords);
-  free (valid_elem_mask);
-
-  return (status);
-}
-
-static int
-abs_error_at_elem ( int i_elem,
-		    double *** tau_nodal_lsp,
-		    double * gvec_elem,
-		    double * velocity_norm,
-		    double * ielem_area ) 
-/******************************************************************************
-  Function which interpolates the LS projected values of tau back to the gauss 
-  points, extracts the fem values of tau at the same gauss points, then using
-  the differences between the two, computes the velocity based error norm
-  (the absolute indicator value) for the element.
-
-  Author:          R. R. Lober (9113)
-  Date:            30 September 1998
-  Revised          
 
-******************************************************************************/
-{
-  int status = 0;
-  int i, j, i_elem_gp, eqn, global_node_num, a, b;
-  int err;                    /* temp variable to hold diagnostic flags. */
-  double sum_tau, phi_i, ***tau_gp_fem, ***tau_gp_lsp, ***tau_gp_ext;
-  double xi[DIM];             /* Local element coordinates of Gauss point. */
-  double det, wt;
-  double gamma[DIM][DIM];     /* shrearrate tensor based on velocity */
-
-  double mu, elem_error, error_norm_tmp, elem_area, velocity_norm_tmp, elem_vel_norm;
-
-  /* polymer viscosity */
-  double mup;
-
-  i_elem_gp            = elem_info( NQUAD, 
-				    ei->ielem_type); /* number of
-						        quadrature points */
-  eqn = R_MOMENTUM1; /* We depend on this eqn for the velocity based error measure */
-
-  /* Grab memory to hold the fem & lsp values of tau, only malloc the upper tri-diag
-     portion of these symetric tensors */
-  tau_gp_fem = (double ***) smalloc (VIM*sizeof(double **));
-  tau_gp_lsp = (double ***) smalloc (VIM*sizeof(double **));
-  tau_gp_ext = (double ***) smalloc (VIM*sizeof(double **));
-  for ( i = 0; i < VIM; i++ ) {
-    tau_gp_fem[i] = (double **) smalloc (VIM*sizeof(double *));
-    tau_gp_lsp[i] = (double **) smalloc (VIM*sizeof(double *));
-    tau_gp_ext[i] = (double **) smalloc (VIM*sizeof(double *));
-    for ( j = 0; j < VIM; j++ ) {
-      if ( j < i ) {
-	tau_gp_fem[i][j] = tau_gp_fem[j][i];
-	tau_gp_lsp[i][j] = tau_gp_lsp[j][i];
-	tau_gp_ext[i][j] = tau_gp_ext[j][i];
-      }
-      else {
-	tau_gp_fem[i][j] = (double *) smalloc (i_elem_gp*sizeof(double));
-	tau_gp_lsp[i][j] = (double *) smalloc (i_elem_gp*sizeof(double));
-	tau_gp_ext[i][j] = (double *) smalloc (i_elem_gp*sizeof(double));
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 256) if (Num_Assembly_Threads > 1) num_threads(MAX(Num_Assembly_Threads, 1)) private(nt, c, m, k, e, g, r, P, t, rhs)
+#endif
+  for (n = 0; n < zp->num_nodes; n++) {
+    nt = zp->nterms[n];
+    if (nt == 0) continue;
+
+    for (c = 0; c < ncomp; c++) {
+      for (m = 0; m < nt; m++) rhs[c][m] = 0.;
+    }
+    for (k = exo->node_elem_pntr[n]; k < exo->node_elem_pntr[n + 1]; k++) {
+      e = exo->node_elem_list[k];
+      if (!zp->elem_ok[e]) continue;
+      for (g = zp->gp_ptr[e]; g < zp->gp_ptr[e + 1]; g++) {
+	r[0] = zp->xg[DIM*g]     - exo->x_coord[n];
+	r[1] = zp->xg[DIM*g + 1] - exo->y_coord[n];
+	r[2] = (exo->num_dim > 2) ? zp->xg[DIM*g + 2] - exo->z_coord[n] : 0.;
+	zz_patch_terms(nt, r, P);
+	for (c = 0; c < ncomp; c++) {
+	  t = tau_gp[ncomp*g + c] * zp->dw[g];
+	  for (m = 0; m < nt; m++) rhs[c][m] += P[m] * t;
+	}
       }
     }
+    for (c = 0; c < ncomp; c++) {
+      lu_backsub(zp->lu[n], nt, zp->indx[n], rhs[c]);
+      tau_lsp[c][n] = rhs[c][0];
+    }
   }
 
-  elem_error = 0.;
-  elem_vel_norm = 0.;
-  elem_area = 0.;
+  exchange_node_multi(cx, dpi, ncomp, tau_lsp);
 
-  /* Now loop over all the gauss points for this elem */
-  for ( i = 0; i < i_elem_gp; i++ ) {
-    find_stu ( i,
-	       ei->ielem_type,
-	       &xi[0], 
-	       &xi[1], 
-	       &xi[2] ); /* find quadrature point */
+  /* Interpolate tau_lsp back to the gauss points and integrate the
+     difference from the fem tau over each element -- for 3D
+     = {(tau11)**2 + 2(tau12)**2 + 2(tau13)**2 + (tau22)**2 +
+        2(tau23)**2 + (tau33)**2} */
+  elem_err   = (dbl *) smalloc(MAX(zp->num_elems, 1) * sizeof(dbl));
+  elem_vel   = (dbl *) smalloc(MAX(zp->num_elems, 1) * sizeof(dbl));
+  elem_areas = (dbl *) smalloc(MAX(zp->num_elems, 1) * sizeof(dbl));
 
-    fv->wt = Gq_weight(i, ei->ielem_type); /* find quadrature weights for
-					      current ip */
-    wt = fv->wt;
-
-    err = load_basis_functions(xi, bfd);
-    EH( err, 
-	"problem from load_basis_functions" );
-
-    /* This has elemental Jacobian transformation and some 
-       basic mesh derivatives...
-       Old usage: calc_Jac, jelly_belly */
-    /* NOTE: this call also updates the value of detJ inside the bf struct
-       for the point xi[] in the element pointed to by the ei struct */
-		  
-    err = beer_belly();
-    EH( err,
-	"beer_belly" );
-		  
-    /* Load up field variable values at this Gauss point. */
-    /* Now fill fv with tau goodies, and cycle over the gauss points 
-       filling the tau components into tau_gp_fem */
-    err = load_fv();
-    EH( err, "load_fv");
-		  
-    /* Load up physical space gradients of field variables at this
-       Gauss point. */
-    /* NOTE: load_bf_grad MUST be called before load_fv_grads as this
-       call depends on it! - RRL 10/30/98 */
-    err = load_bf_grad();
-    EH( err, "load_bf_grad");
-
-    err = load_fv_grads();
-    EH( err, "load_fv_grads");
-
-    /* Now generate & save the tau shear stress tensor components for this
-       gauss point. */
-    /* In Cartesian coordinates, this velocity gradient tensor will
-       have components that are...
-      
-       			grad_v[a][b] = d v_b
-      				       -----
-      				       d x_a                         */
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 256) if (Num_Assembly_Threads > 1) num_threads(MAX(Num_Assembly_Threads, 1)) private(nn, conn, err_sum, vel_sum, area, g, phi_g, err_gp, vel_gp, c, lsp, fem, j)
+#endif
+  for (e = 0; e < zp->num_elems; e++) {
+    elem_err[e]   = 0.;
+    elem_vel[e]   = 0.;
+    elem_areas[e] = 0.;
+    if (!zp->elem_ok[e]) continue;
+
+    nn   = (zp->phi_ptr[e + 1] - zp->phi_ptr[e]) / (zp->gp_ptr[e + 1] - zp->gp_ptr[e]);
+    conn = Proc_Elem_Connect + exo->elem_ptr[e];
+    err_sum = 0.;
+    vel_sum = 0.;
+    area    = 0.;
+    for (g = zp->gp_ptr[e]; g < zp->gp_ptr[e + 1]; g++) {
+      phi_g = zp->phi + zp->phi_ptr[e] + (g - zp->gp_ptr[e])*nn;
+      err_gp = 0.;
+      vel_gp = 0.;
+      for (c = 0; c < ncomp; c++) {
+	lsp = 0.;
+	for (j = 0; j < nn; j++) lsp += phi_g[j]*tau_lsp[c][conn[j]];
+	fem = tau_gp[ncomp*g + c];
+	err_gp += cw[c]*(lsp - fem)*(lsp - fem);
+	vel_gp += cw[c]*fem*fem;
+      }
+      err_sum += err_gp*zp->dw[g];
+      vel_sum += vel_gp*zp->dw[g];
+      area    += zp->dw[g];
+    }
+    elem_err[e]   = sqrt(err_sum/area);
+    elem_vel[e]   = sqrt(vel_sum/area);
+    elem_areas[e] = area;
+  }
 
-    for ( a = 0; a < VIM; a++ ) {
-      for ( b = 0; b < VIM; b++ ) {
-	gamma[a][b] = fv->grad_v[a][b] + fv->grad_v[b][a];
+  if (compute_elem_size != 0) {
+    /* First grab user supplied params */
+    reduction_rate     = pp_error_data[0].error_params[0];
+    expansion_rate     = pp_error_data[0].error_params[1];
+    elem_size_min      = pp_error_data[0].error_params[2];
+    elem_size_max      = pp_error_data[0].error_params[3];
+    target_error       = pp_error_data[0].error_params[4];
+  }
+  pct_over_tolerance = pp_error_data[0].error_params[5];
+
+  /* Maxima and volumes over the owned elements only, ghost elements are
+     counted by their owners */
+  max_velocity_norm = 0.;
+  max_velocity_err  = 0.;
+  max_velocity_norm_i_elem = -1;
+  max_velocity_err_i_elem  = -1;
+  total_volume = 0.;
+  volume_tmp   = 0.;
+  for (e = 0; e < zp->num_elems; e++) {
+    if (!zp->elem_ok[e]) continue;
+    i_eb_indx = exo->elem_eb[e];
+    gvec_elem[i_eb_indx][ev_indx][e - exo->eb_ptr[i_eb_indx]] = elem_err[e];
+
+    if (compute_elem_size != 0) {
+      /* Determine typical element length scale - sqrt if 2D, cube root if 3D */
+      if (exo->num_dim == 3) {
+	h1 = pow(elem_areas[e], 0.3333333333);
+      } else {
+	h1 = sqrt(elem_areas[e]);
       }
-    }
 
-    mu = viscosity( gn, gamma, NULL );
+      error_ratio = elem_err[e]/target_error;
 
-    if ( pd->v[POLYMER_STRESS11] ) {
-      /* get polymer viscosity */
-      mup = viscosity( gn, gamma, NULL );
-      mu = mu + mup;
-    }
-    
-    for ( a = 0; a < VIM; a++ ) {
-      for ( b = 0; b < VIM; b++ ) {
-	tau_gp_fem[a][b][i] = mu*gamma[a][b];
+      if (error_ratio <= 1.0) {
+	h2 = (pow(error_ratio, -1./expansion_rate)) * h1;
+      } else {
+	h2 = (pow(error_ratio, -1./reduction_rate)) * h1;
+	/* This element needs refinement - add into the volume over calculation */
+	if (dpi->elem_owner[e] == ProcID) volume_tmp += elem_areas[e];
       }
-    }
 
-#ifdef RRL_DEBUG
-#ifdef DBG_0
-    /* The following code segment is to compute the exact velocity solution
-       and fluid shear stress norm for the poisuelle flow problem          */
-/*     sumx = 0.; */
-/*     sumy = 0.; */
-/*     sumz = 0.; */
-/*     for (j = 0; j < ei->num_local_nodes; j++ ) { */
-/*       phi_i = bf[eqn]->phi[ei->ln_to_dof[eqn][j]]; */
-/*       local_i = Proc_Elem_Connect[ei->iconnect_ptr + j]; */
-/*       sumx += phi_i*Coor[0][local_i]; */
-/*       sumy += phi_i*Coor[1][local_i]; */
-/*       if (ei->ielem_dim > 2) { */
-/* 	sumz += phi_i*Coor[2][local_i];	 */
-/*       } */
-/*     } */
-
-/*     gamma_ext[0][0] = 0.; */
-/*     gamma_ext[0][1] = -4.*sumy; */
-/*     gamma_ext[0][2] = 0.; */
-/*     gamma_ext[1][0] = gamma_ext[0][1]; */
-/*     gamma_ext[1][1] = 0.; */
-/*     gamma_ext[1][2] = 0.; */
-/*     gamma_ext[2][0] = gamma_ext[0][2]; */
-/*     gamma_ext[2][1] = gamma_ext[1][2]; */
-/*     gamma_ext[2][2] = 0.; */
-
-/*     for ( a = 0; a < VIM; a++ ) { */
-/*       for ( b = 0; b < VIM; b++ ) { */
-/* 	tau_gp_ext[a][b][i] = mu*gamma_ext[a][b]; */
-/*       } */
-/*     } */
+      /* Now ensure that the elem size floors & ceilings are observed */
+      if (h2 < elem_size_min) h2 = elem_size_min;
+      if (h2 > elem_size_max) h2 = elem_size_max;
 
-#endif
-#endif
-
-    det = bf[eqn]->detJ;
-
-    /* Now have all fem tau components for this elem, and gauss point i.
-       Now interpolate the tau_lsp values back to gauss point i as well. */
-    for ( a = 0; a < VIM; a++ ) {
-      for ( b = 0; b < VIM; b++ ) {
-	/* Calculate this symetrically (that's how its being stored) */
-	if ( b >= a ) {
-	  sum_tau = 0.;
-	  for ( j = 0; j < ei->num_local_nodes; j++ ) {
-	    /* also convert from node number to dof number */
-	    phi_i = bf[eqn]->phi[ei->ln_to_dof[eqn][j]];
-	    global_node_num = Proc_Elem_Connect[ei->iconnect_ptr + j];
-	    sum_tau += phi_i*tau_nodal_lsp[a][b][global_node_num];
-	  }
-	  tau_gp_lsp[a][b][i] = sum_tau;
-#ifdef RRL_DEBUG
-#ifdef DBG_1
-	  fprintf( stdout,
-		   "          LS \ttau%d%d at gp %d = %8.6lf (x=%6.4lf\ty=%6.4lf\tz=%6.4lf)\n",
-		   a + 1,
-		   b + 1,
-		   i,
-		   tau_gp_lsp[a][b][i],
-		   sumx,
-		   sumy,
-		   sumz );    
-#endif
-#endif
-	}
-      }
+      /* Store into gvec array - note that we store into the next ev_indx place
+	 since this value always follows the error measure that it applies to */
+      gvec_elem[i_eb_indx][ev_indx + 1][e - exo->eb_ptr[i_eb_indx]] = h2;
     }
 
-    /* Now integrate the error over the elem - this is essentially
+    if (dpi->elem_owner[e] != ProcID) continue;
 
-       -- for 2D ---------------
-       = {(tau11)**2 + 2(tau12)**2 + (tau22)**2}
- 
-       -- for 3D ---------------
-       = {(tau11)**2 + 2(tau12)**2 + 2(tau13)**2 + (tau22)**2 +
-       2(tau23)**2 + (tau33)**2} 
-       
-       Note that each off diagonal term occurs twice    */
-
-    error_norm_tmp = 0.;
-    velocity_norm_tmp = 0.;
-    for ( a = 0; a < VIM; a++ ) {
-      for ( b = 0; b < VIM; b++ ) {
-	if ( b > a ) { /* Off axis symmetric term (upper tri only) */
-	  error_norm_tmp += 2*((tau_gp_lsp[a][b][i] - tau_gp_fem[a][b][i]) * 
-			       (tau_gp_lsp[a][b][i] - tau_gp_fem[a][b][i]) );
-	  velocity_norm_tmp += 2*(tau_gp_fem[a][b][i] * tau_gp_fem[a][b][i]);
-#ifdef RRL_DEBUG
-#ifdef DBG_1
-	  fprintf( stdout,
-		   "\n    computed off diag error component \t2*(tau%d%d)**2 at gp %d = %8.6lf\n",
-		   a + 1,
-		   b + 1,
-		   i,
-		   2*((tau_gp_lsp[a][b][i] - tau_gp_fem[a][b][i]) * 
-		      (tau_gp_lsp[a][b][i] - tau_gp_fem[a][b][i]) ));  
-	  fprintf( stdout,
-		   "    computed LS             component \t(tau_gp_lsp%d%d)  gp %d = %8.6lf\n",
-		   a + 1,
-		   b + 1,
-		   i,
-		   tau_gp_lsp[a][b][i] );   
-	  fprintf( stdout,
-		   "    computed FEM            component \t(tau_gp_fem%d%d)  gp %d = %8.6lf\n",
-		   a + 1,
-		   b + 1,
-		   i,
-		   tau_gp_fem[a][b][i] );   
-
-	  fprintf( stdout,
-		   "    computed EXACT          component \t(tau%d%d exact)   gp %d = %8.6lf\n",
-		   a + 1,
-		   b + 1,
-		   i,
-		   tau_gp_ext[a][b][i] ); 
-
-	  fprintf( stdout,
-		   "    gp %d is at \tx=%6.4lf\ty=%6.4lf\tz=%6.4lf\n",
-		   i,
-		   sumx,
-		   sumy,
-		   sumz );      
-	  fprintf( stdout,
-		   "    computed FEM          u component \t                gp %d = %8.6lf\n",
-		   i,
-		   fv->v[0] );   
-	  fprintf( stdout,
-		   "    computed EXACT        u component \t                gp %d = %8.6lf\n",
-		   i,
-		   2. - 2.*(sumy*sumy) );   
-#endif
-#endif
-	} else if ( b == a ) { /* diagonal term */
-	  error_norm_tmp += ((tau_gp_lsp[a][b][i] - tau_gp_fem[a][b][i]) *
-			     (tau_gp_lsp[a][b][i] - tau_gp_fem[a][b][i]) );
-	  velocity_norm_tmp += (tau_gp_fem[a][b][i] * tau_gp_fem[a][b][i]);	  
-#ifdef RRL_DEBUG
-#ifdef DBG_1
-	  fprintf( stdout,
-		   "\n    computed     diag error component \t  (tau%d%d)**2 at gp %d = %8.6lf\n",
-		   a + 1,
-		   b + 1,
-		   i,
-		   ((tau_gp_lsp[a][b][i] - tau_gp_fem[a][b][i]) *
-		    (tau_gp_lsp[a][b][i] - tau_gp_fem[a][b][i])) );
-	  fprintf( stdout,
-		   "    computed LS             component \t(tau_gp_lsp%d%d)  gp %d = %8.6lf\n",
-		   a + 1,
-		   b + 1,
-		   i,
-		   tau_gp_lsp[a][b][i] );   
-	  fprintf( stdout,
-		   "    computed FEM            component \t(tau_gp_fem%d%d)  gp %d = %8.6lf\n",
-		   a + 1,
-		   b + 1,
-		   i,
-		   tau_gp_fem[a][b][i] );   
-	  fprintf( stdout,
-		   "    computed EXACT          component \t(tau%d%d exact)   gp %d = %8.6lf\n",
-		   a + 1,
-		   b + 1,
-		   i,
-		   tau_gp_ext[a][b][i] );  
-	  fprintf( stdout,
-		   "    gp %d is at \tx=%6.4lf\ty=%6.4lf\tz=%6.4lf\n",
-		   i,
-		   sumx,
-		   sumy,
-		   sumz );      
-	  fprintf( stdout,
-		   "    computed FEM          u component \t                gp %d = %8.6lf\n",
-		   i,
-		   fv->v[0] );   
-	  fprintf( stdout,
-		   "    computed EXACT        u component \t                gp %d = %8.6lf\n",
-		   i,
-		   2. - 2.*(sumy*sumy) );   
-#endif
-#endif
-	}
-      }
+    /* sum the total area/vol of the elems being used for error computation */
+    total_volume += elem_areas[e];
+    if (elem_vel[e] > max_velocity_norm) {
+      max_velocity_norm = elem_vel[e];
+      max_velocity_norm_i_elem = e;
     }
-    elem_error += error_norm_tmp*det*wt;
-    elem_vel_norm += velocity_norm_tmp*det*wt;
-    elem_area  += det*wt;;
-  }
-
-  *ielem_area = elem_area;
-
-  /* Now its almost revealed!! */
-  gvec_elem[i_elem] = sqrt(elem_error/elem_area);
-  *velocity_norm = sqrt(elem_vel_norm/elem_area);
-  
-#ifdef RRL_DEBUG
-#ifdef DBG_1
-  fprintf( stdout,
-	   "\n==> ZZ velocity err for element %d = %8.6lf <==\n",
-	   ei->ielem + 1,
-	   gvec_elem[i_elem] ); 
-  fprintf( stdout,
-	   "    Velocity norm for element %d = %8.6lf <==\n",
-	   ei->ielem + 1,
-	   *velocity_norm );    
-#endif
-#endif
-
-  for ( i = 0; i < VIM; i++ ) {
-    for ( j = 0; j < VIM; j++ ) {
-      /* Only the upper tri diag members were malloc'd, so only free those */
-      if ( j >= i ) {
-	free (tau_gp_fem[i][j]);
-	free (tau_gp_lsp[i][j]);
-      }
+    if (elem_err[e] > max_velocity_err) {
+      max_velocity_err = elem_err[e];
+      max_velocity_err_i_elem = e;
     }
-    free (tau_gp_fem[i]);
-    free (tau_gp_lsp[i]);
   }
-  free (tau_gp_fem);
-  free (tau_gp_lsp);
-
-  return (status);
-}
-
-
-static int 
-fill_lhs_lspatch(double * i_node_coords,
-		 double * wt_gp_loc,
-		 double * xgp_loc,
-		 double * ygp_loc,
-		 double * zgp_loc,
-		 double * det_gp_loc,
-		 int      max_terms,
-		 double ** s_lhs,
-		 int      elem,
-		 double **** tau_gp_ptch )	
-/******************************************************************************
-  Function which calculates the local coords for an element participating in a
-  patch about a given node, then fills the contributions from that element into
-  the LHS matrix of the least squares patch system being formed about the given 
-  node.
-
-  Author:          R. R. Lober (9113)
-  Date:            15 September 1998
-  Revised          
 
-******************************************************************************/
-
-{
-  int i, j, i_elem_gp, eqn, local_i, a, b;
-  int status = 0;
-  int err;                    /* temp variable to hold diagnostic flags. */
-  double sumx, sumy, sumz, phi_i;
-  double xi[DIM];             /* Local element coordinates of Gauss point. */
-  double xgp, ygp, zgp, det, wt;
-  double gamma[DIM][DIM];     /* shrearrate tensor based on velocity */
-
-  /* viscosity */
-  double mu;
-
-  /* polymer viscosity */
-  double mup;
-
-  i_elem_gp            = elem_info( NQUAD, 
-				    ei->ielem_type); /* number of
-							quadrature points */
-  eqn = R_MOMENTUM1; /* We depend on this eqn for the velocity based error measure */
-
-  /* First build local coord system for the gauss points of this
-     element about the node in the center of this patch. This is important
-     since these least-squares systems tend to be ill-conditioned when the
-     usual poloynomial basis are used (Reference D. Pelletier's report n0
-     1, "Implementation of Error Analysis and Norms to Computational Fluid
-     Dynamics Applications, (Bilinear Finite Elements)" for SNL, dated
-     6/97. (or Randy Lober for copy)). The introduction of a local coord
-     system alleviates this ill-conditioning. */
-
-  for (i = 0; i < i_elem_gp; i++) {
-    find_stu ( i,
-	       ei->ielem_type,
-	       &xi[0], 
-	       &xi[1], 
-	       &xi[2] ); /* find quadrature point */
-
-    wt_gp_loc[i] = Gq_weight (i,
-			      ei->ielem_type); /* find quadrature weights for
-						  current ip */
-    fv->wt = wt_gp_loc[i];
-
-    err = load_basis_functions( xi,
-				bfd );
-    EH( err, 
-	"problem from load_basis_functions" );
-
-    /*
-      This has elemental Jacobian transformation and some 
-      basic mesh derivatives...
-      Old usage: calc_Jac, jelly_belly */
-
-    /* NOTE: this call also updates the value of detJ inside the bf struct
-       for the point xi[] in the element pointed to by the ei struct */
-		  
-    err = beer_belly();
-    EH( err,
-	"beer_belly" );
-		  
-    /*
-     * Load up field variable values at this Gauss point.
-     */
-    /* Now fill fv with tau goodies, and cycle over the gauss points 
-       filling the tau components into tau_gp_ptch */
-    err = load_fv();
-    EH( err, "load_fv");
-		  		  
-    /*
-     * Load up physical space gradients of field variables at this
-     * Gauss point.
-     */
-    /* NOTE: load_bf_grad MUST be called before load_fv_grads as this
-       call depends on it! - RRL 10/30/98 */
-    err = load_bf_grad();
-    EH( err, "load_bf_grad");
+  gstatus_begin();
+  slot_vn   = gstatus_add_maxloc(max_velocity_norm);
+  slot_err  = gstatus_add_maxloc(max_velocity_err);
+  slot_vol  = gstatus_add(GSTATUS_SUM, total_volume);
+  slot_over = gstatus_add(GSTATUS_SUM, volume_tmp);
+  gstatus_start();
+  max_velocity_norm = gstatus_get(slot_vn);
+  owner_vn          = (int) gstatus_get(slot_vn + 1);
+  max_velocity_err  = gstatus_get(slot_err);
+  owner_err         = (int) gstatus_get(slot_err + 1);
+  total_volume      = gstatus_get(slot_vol);
+  volume_tmp        = gstatus_get(slot_over);
+
+  /* The owners of the two maxima report the global element numbers and
+     the centroid of the worst element */
+  for (k = 0; k < DIM; k++) max_ctr[k] = 0.;
+  e = max_velocity_err_i_elem;
+  if (ProcID == owner_err && e != -1) {
+    nn = elem_info(NNODES, Elem_Type(exo, e));
+    for (j = 0; j < nn; j++) {
+      I = Proc_Elem_Connect[exo->elem_ptr[e] + j];
+      max_ctr[0] += exo->x_coord[I];
+      max_ctr[1] += exo->y_coord[I];
+      if (exo->num_dim > 2) max_ctr[2] += exo->z_coord[I];
+    }
+    for (k = 0; k < DIM; k++) max_ctr[k] /= nn;
+  }
 
-    err = load_fv_grads();
-    EH( err, "load_fv_grads");
+  gstatus_begin();
+  slot_evn  = gstatus_add(GSTATUS_SUM,
+			  (ProcID == owner_vn && max_velocity_norm_i_elem != -1) ?
+			  (dbl) dpi->elem_index_global[max_velocity_norm_i_elem] : 0.);
+  slot_eerr = gstatus_add(GSTATUS_SUM,
+			  (ProcID == owner_err && max_velocity_err_i_elem != -1) ?
+			  (dbl) dpi->elem_index_global[max_velocity_err_i_elem] : 0.);
+  for (k = 0; k < DIM; k++) {
+    slot_ctr[k] = gstatus_add(GSTATUS_SUM, max_ctr[k]);
+  }
+  gstatus_start();
+  max_velocity_norm_i_elem = (int) gstatus_get(slot_evn);
+  max_velocity_err_i_elem  = (int) gstatus_get(slot_eerr);
+  for (k = 0; k < DIM; k++) max_ctr[k] = gstatus_get(slot_ctr[k]);
 
-    /* Now generate & save the tau shear stress tensor components for this
-       gauss point. */
-    /*
-     * In Cartesian coordinates, this velocity gradient tensor will
-     * have components that are...
-     *
-     * 			grad_v[a][b] = d v_b
-     *				       -----
-     *				       d x_a
-     */
-    for ( a = 0; a < VIM; a++) {
-      for ( b = 0; b < VIM; b++) {
-	gamma[a][b] = fv->grad_v[a][b] + fv->grad_v[b][a];
-      }
-    }
-    mu = viscosity( gn, gamma, NULL );
+  if (ProcID == 0) {
+    fprintf( stdout,
+	     "\n Max energy norm of the velocity vector ( element %d ) \t= %6.4f\n",
+	     max_velocity_norm_i_elem+1,
+	     max_velocity_norm );
+    fprintf( stdout,
+	     " Max ZZ error (velocity based)          ( element %d ) \t= %6.4f\n",
+	     max_velocity_err_i_elem+1,
+	     max_velocity_err );
+    fprintf( stdout,
+	     "   x centroid = %6.4f\n",
+	     max_ctr[0] );
+    fprintf( stdout,
+	     "   y centroid = %6.4f\n",
+	     max_ctr[1] );
+    fprintf( stdout,
+	     "   z centroid = %6.4f\n",
+	     max_ctr[2] );
+  }
 
-    if ( pd->v[POLYMER_STRESS11] ) {
-      /* get polymer viscosity */
-      mup = viscosity( gn, gamma, NULL );
-      mu = mu + mup;
-    }
+  /* Now report the recommended elem sizes if needed */
+  if ( compute_elem_size != 0 ) {
+    pct_over_target = volume_tmp/(total_volume*0.01); /* Builds % of volume over error
+							target */
 
-    for ( a = 0; a < VIM; a++) {
-      for ( b = 0; b < VIM; b++) {
-	tau_gp_ptch[a][b][elem][i] = mu*gamma[a][b];
-      }
+    if ( pct_over_target > pct_over_tolerance ) {
+      /* Need to remesh the problem and run it again using sizing data */
+      remesh_status = 2;
+    } else if ( max_velocity_err > target_error ) {
+      remesh_status = 1;
+    } else {
+      remesh_status = 0;
     }
 
-#ifdef RRL_DEBUG
-#ifdef DBG_2
-    if (i == 0) {
+    if (ProcID == 0) {
       fprintf( stdout,
-	       "\n   gp     t11      t12      t13      t21      t22      t23      t31      t32      t33      mu\n" );
-    }
-    if (ei->ielem_dim > 2) {
+	       "\n Target error                                        \t= %6.4f\n",
+	       target_error );
       fprintf( stdout,
-	       "  %2d   %6.4lf   %6.4lf   %6.4lf   %6.4lf   %6.4lf   %6.4lf   %6.4lf   %6.4lf   %6.4lf   %6.4lf\n",
-	       i + 1,
-	       tau_gp_ptch[0][0][elem][i],
-	       tau_gp_ptch[0][1][elem][i],
-	       tau_gp_ptch[0][2][elem][i],
-	       tau_gp_ptch[1][0][elem][i],
-	       tau_gp_ptch[1][1][elem][i],
-	       tau_gp_ptch[1][2][elem][i],
-	       tau_gp_ptch[2][0][elem][i],
-	       tau_gp_ptch[2][1][elem][i],
-	       tau_gp_ptch[2][2][elem][i],
-	       mu ); 
-    } else {
+	       " Problem volume (area) considered for error          \t= %6.4f\n",
+	       total_volume );
       fprintf( stdout,
-	       "  %2d   %6.4lf   %6.4lf   < NA >   %6.4lf   %6.4lf   < NA >   < NA >   < NA >   < NA >   %6.4lf\n",
-	       i + 1,
-	       tau_gp_ptch[0][0][elem][i],
-	       tau_gp_ptch[0][1][elem][i],
-	       tau_gp_ptch[1][0][elem][i],
-	       tau_gp_ptch[1][1][elem][i],
-	       mu ); 
-    }  
-#endif
-#endif
-
-    /* Now generate & save the relative coords between this gauss point and
-       this patch node */
-    sumx = 0.;
-    sumy = 0.;
-    sumz = 0.;
-    for (j = 0; j < ei->num_local_nodes; j++ ) {
-      /* also convert from node number to dof number */
-      phi_i = bf[eqn]->phi[ei->ln_to_dof[eqn][j]];
-      local_i = Proc_Elem_Connect[ei->iconnect_ptr + j];
-      sumx += phi_i*Coor[0][local_i];
-      sumy += phi_i*Coor[1][local_i];
-      if (ei->ielem_dim > 2) {
-	sumz += phi_i*Coor[2][local_i];	
+	       " Percent of problem volume over error target         \t= %6.2f [%%]\n",
+	       pct_over_target );
+      fprintf( stdout,
+	       " Tolerance for percent of problem volume over value  \t= %6.2f [%%]\n",
+	       pct_over_tolerance );
+      fprintf( stdout,
+	       " Remeshing status                                    \t= %d\n",
+	       remesh_status );
+      if ( remesh_status == 2 ) {
+	fprintf( stdout,
+		 "\n (Recommend remeshing model using the *ELSIZE element variable)\n" );
+      } else if ( remesh_status == 1 ) {
+	fprintf( stdout,
+		 "\n (Max error > target error, but volume < target error within tolerance)\n" );
+      } else {
+	fprintf( stdout,
+		 "\n (Max error < target error, error reduction objective met)\n" );
       }
+      fprintf( stdout,
+	       "\n Current number of nodes (resolution)                \t= %d\n",
+	       dpi->num_nodes_global );
+      fprintf( stdout,
+	       " Current number of elements                          \t= %d\n",
+	       dpi->num_elems_global );
     }
-    xgp_loc[i] = sumx - i_node_coords[0];
-    ygp_loc[i] = sumy - i_node_coords[1];
-    if (ei->ielem_dim > 2) {
-      zgp_loc[i] = sumz - i_node_coords[2];
-    }
-    det_gp_loc[i] = bf[eqn]->detJ;
   }
 
-#ifdef RRL_DEBUG
-#ifdef DBG_2
-  fprintf( stdout,
-	   "   gp     x        y       z        det       wt\n" );    
-  for (i = 0; i < i_elem_gp; i++ ) {
-    fprintf( stdout,
-	     "  %2d   %6.4lf   %6.4lf   %6.4lf   %6.4lf   %6.4lf\n",
-	     i + 1,
-	     xgp_loc[i],
-	     ygp_loc[i],
-	     zgp_loc[i],
-	     det_gp_loc[i],
-	     wt_gp_loc[i] );   
+  /* Now normalize the raw values of ZZ velocity based error */
+  for (e = 0; e < zp->num_elems; e++) {
+    if (!zp->elem_ok[e]) continue;
+    i_eb_indx = exo->elem_eb[e];
+    gvec_elem[i_eb_indx][ev_indx][e - exo->eb_ptr[i_eb_indx]] /= (max_velocity_norm*0.01); /* NOTE: converting to % */
   }
-#endif
-#endif
 
-  /* Now Populate the contributions to s_lhs from this element
-     for each gauss point */
-  for (i = 0; i < i_elem_gp; i++) {
-    switch ( max_terms ) {
-    case 3:  /* 2D with linear elements    */
-#ifdef RRL_DEBUG
-#ifdef DBG_2
-      fprintf( stdout,
-	       "fill_lhs_lspatch using max_terms = %d (2D linear case)\n",
-	       max_terms );    
-#endif
-#endif
-      xgp = xgp_loc[i];
-      ygp = ygp_loc[i];
-      det = det_gp_loc[i];
-      wt  = wt_gp_loc[i];
-      s_lhs[0][0] += 1.0 *             det*wt;
-      s_lhs[0][1] += xgp *             det*wt;
-      s_lhs[0][2] += ygp *             det*wt;
-		                              
-      s_lhs[1][0] += xgp *             det*wt;
-      s_lhs[1][1] += xgp*xgp *         det*wt;
-      s_lhs[1][2] += xgp*ygp *         det*wt;
-		                              
-      s_lhs[2][0] += ygp *             det*wt;
-      s_lhs[2][1] += xgp*ygp *         det*wt;
-      s_lhs[2][2] += ygp*ygp *         det*wt;
-      break;
-    case 6:  /* 2D with quadratic elements */
-#ifdef RRL_DEBUG
-#ifdef DBG_2
-      fprintf( stdout,
-	       "fill_lhs_lspatch using max_terms = %d (2D quadratic case)\n",
-	       max_terms );    
-#endif
-#endif
-      xgp = xgp_loc[i];
-      ygp = ygp_loc[i];
-      det = det_gp_loc[i];
-      wt  = wt_gp_loc[i];
-      s_lhs[0][0] += 1.0 *             det*wt;
-      s_lhs[0][1] += xgp *             det*wt;
-      s_lhs[0][2] += ygp *             det*wt;
-      s_lhs[0][3] += xgp*xgp *         det*wt;
-      s_lhs[0][4] += xgp*ygp *         det*wt;
-      s_lhs[0][5] += ygp*ygp *         det*wt;
-		                              
-      s_lhs[1][0] += xgp *             det*wt;
-      s_lhs[1][1] += xgp*xgp *         det*wt;
-      s_lhs[1][2] += xgp*ygp *         det*wt;
-      s_lhs[1][3] += xgp*xgp*xgp *     det*wt;
-      s_lhs[1][4] += xgp*xgp*ygp *     det*wt;
-      s_lhs[1][5] += xgp*ygp*ygp *     det*wt;
-		                              
-      s_lhs[2][0] += ygp *             det*wt;
-      s_lhs[2][1] += ygp*xgp *         det*wt;
-      s_lhs[2][2] += ygp*ygp *         det*wt;
-      s_lhs[2][3] += ygp*xgp*xgp *     det*wt;
-      s_lhs[2][4] += ygp*ygp*xgp *     det*wt;
-      s_lhs[2][5] += ygp*ygp*ygp *     det*wt;
-		                              
-      s_lhs[3][0] += xgp*xgp *         det*wt;
-      s_lhs[3][1] += xgp*xgp*xgp *     det*wt;
-      s_lhs[3][2] += xgp*xgp*ygp *     det*wt;
-      s_lhs[3][3] += xgp*xgp*xgp*xgp * det*wt;
-      s_lhs[3][4] += xgp*xgp*xgp*ygp * det*wt;
-      s_lhs[3][5] += xgp*xgp*ygp*ygp * det*wt;
-		                              
-      s_lhs[4][0] += xgp*ygp *         det*wt;
-      s_lhs[4][1] += xgp*xgp*ygp *     det*wt;
-      s_lhs[4][2] += xgp*ygp*ygp *     det*wt;
-      s_lhs[4][3] += xgp*xgp*xgp*ygp * det*wt;
-      s_lhs[4][4] += xgp*xgp*ygp*ygp * det*wt;
-      s_lhs[4][5] += xgp*ygp*ygp*ygp * det*wt;
-		                              
-      s_lhs[5][0] += ygp*ygp *         det*wt;
-      s_lhs[5][1] += ygp*ygp*xgp *     det*wt;
-      s_lhs[5][2] += ygp*ygp*ygp *     det*wt;
-      s_lhs[5][3] += ygp*ygp*xgp*xgp * det*wt;
-      s_lhs[5][4] += ygp*ygp*ygp*xgp * det*wt;
-      s_lhs[5][5] += ygp*ygp*ygp*ygp * det*wt;
-      break;
-    case 4:  /* 3D with linear elements    */
-#ifdef RRL_DEBUG
-#ifdef DBG_2
-      fprintf( stdout,
-	       "fill_lhs_lspatch using max_terms = %d (3D linear case)\n",
-	       max_terms );    
-#endif
-#endif
-      xgp = xgp_loc[i];
-      ygp = ygp_loc[i];
-      zgp = zgp_loc[i];
-      det = det_gp_loc[i];
-      wt  = wt_gp_loc[i];
-      s_lhs[0][0] += 1.0 *             det*wt;
-      s_lhs[0][1] += xgp *             det*wt;
-      s_lhs[0][2] += ygp *             det*wt;
-      s_lhs[0][3] += zgp *             det*wt;
-
-      s_lhs[1][0] += xgp *             det*wt;
-      s_lhs[1][1] += xgp*xgp *         det*wt;
-      s_lhs[1][2] += xgp*ygp *         det*wt;
-      s_lhs[1][3] += xgp*zgp *         det*wt;
-
-      s_lhs[2][0] += ygp *             det*wt;
-      s_lhs[2][1] += ygp*xgp *         det*wt;
-      s_lhs[2][2] += ygp*ygp *         det*wt;
-      s_lhs[2][3] += ygp*zgp *         det*wt;
-
-      s_lhs[3][0] += zgp *             det*wt;
-      s_lhs[3][1] += zgp*xgp *         det*wt;
-      s_lhs[3][2] += zgp*ygp *         det*wt;
-      s_lhs[3][3] += zgp*zgp *         det*wt;
-      break;
-    case 10: /* 3D with quadratic elements */
-#ifdef RRL_DEBUG
-#ifdef DBG_2
-      fprintf( stdout,
-	       "fill_lhs_lspatch using max_terms = %d (3D quadratic case)\n",
-	       max_terms );    
-#endif
-#endif
-      xgp = xgp_loc[i];
-      ygp = ygp_loc[i];
-      zgp = zgp_loc[i];
-      det = det_gp_loc[i];
-      wt  = wt_gp_loc[i];
-      s_lhs[0][0] += 1.0 *             det*wt;
-      s_lhs[0][1] += xgp *             det*wt;
-      s_lhs[0][2] += ygp *             det*wt;
-      s_lhs[0][3] += zgp *             det*wt;
-      s_lhs[0][4] += xgp*xgp *         det*wt;
-      s_lhs[0][5] += xgp*ygp *         det*wt;
-      s_lhs[0][6] += xgp*zgp *         det*wt;
-      s_lhs[0][7] += ygp*ygp *         det*wt;
-      s_lhs[0][8] += ygp*zgp *         det*wt;
-      s_lhs[0][9] += zgp*zgp *         det*wt;
-
-      s_lhs[1][0] += xgp *             det*wt;
-      s_lhs[1][1] += xgp*xgp *         det*wt;
-      s_lhs[1][2] += xgp*ygp *         det*wt;
-      s_lhs[1][3] += xgp*zgp *         det*wt;
-      s_lhs[1][4] += xgp*xgp*xgp *     det*wt;
-      s_lhs[1][5] += xgp*xgp*ygp *     det*wt;
-      s_lhs[1][6] += xgp*xgp*zgp *     det*wt;
-      s_lhs[1][7] += xgp*ygp*ygp *     det*wt;
-      s_lhs[1][8] += xgp*ygp*zgp *     det*wt;
-      s_lhs[1][9] += xgp*zgp*zgp *     det*wt;
-
-      s_lhs[2][0] += ygp *             det*wt;
-      s_lhs[2][1] += ygp*xgp *         det*wt;
-      s_lhs[2][2] += ygp*ygp *         det*wt;
-      s_lhs[2][3] += ygp*zgp *         det*wt;
-      s_lhs[2][4] += ygp*xgp*xgp *     det*wt;
-      s_lhs[2][5] += ygp*ygp*xgp *     det*wt;
-      s_lhs[2][6] += ygp*xgp*zgp *     det*wt;
-      s_lhs[2][7] += ygp*ygp*ygp *     det*wt;
-      s_lhs[2][8] += ygp*ygp*zgp *     det*wt;
-      s_lhs[2][9] += ygp*zgp*zgp *     det*wt;
-
-      s_lhs[3][0] += zgp *             det*wt;
-      s_lhs[3][1] += zgp*xgp *         det*wt;
-      s_lhs[3][2] += zgp*ygp *         det*wt;
-      s_lhs[3][3] += zgp*zgp *         det*wt;
-      s_lhs[3][4] += zgp*xgp*xgp *     det*wt;
-      s_lhs[3][5] += zgp*xgp*ygp *     det*wt;
-      s_lhs[3][6] += zgp*zgp*xgp *     det*wt;
-      s_lhs[3][7] += zgp*ygp*ygp *     det*wt;
-      s_lhs[3][8] += zgp*zgp*ygp *     det*wt;
-      s_lhs[3][9] += zgp*zgp*zgp *     det*wt;
-
-      s_lhs[4][0] += xgp*xgp *         det*wt;
-      s_lhs[4][1] += xgp*xgp*xgp *     det*wt;
-      s_lhs[4][2] += xgp*xgp*ygp *     det*wt;
-      s_lhs[4][3] += xgp*xgp*zgp *     det*wt;
-      s_lhs[4][4] += xgp*xgp*xgp*xgp * det*wt;
-      s_lhs[4][5] += xgp*xgp*xgp*ygp * det*wt;
-      s_lhs[4][6] += xgp*xgp*xgp*zgp * det*wt;
-      s_lhs[4][7] += xgp*xgp*ygp*ygp * det*wt;
-      s_lhs[4][8] += xgp*xgp*ygp*zgp * det*wt;
-      s_lhs[4][9] += xgp*xgp*zgp*zgp * det*wt;
-
-      s_lhs[5][0] += xgp*ygp *         det*wt;
-      s_lhs[5][1] += xgp*xgp*ygp *     det*wt;
-      s_lhs[5][2] += xgp*ygp*ygp *     det*wt;
-      s_lhs[5][3] += xgp*ygp*zgp *     det*wt;
-      s_lhs[5][4] += xgp*xgp*xgp*ygp * det*wt;
-      s_lhs[5][5] += xgp*xgp*ygp*ygp * det*wt;
-      s_lhs[5][6] += xgp*xgp*ygp*zgp * det*wt;
-      s_lhs[5][7] += xgp*ygp*ygp*ygp * det*wt;
-      s_lhs[5][8] += xgp*ygp*ygp*zgp * det*wt;
-      s_lhs[5][9] += xgp*ygp*zgp*zgp * det*wt;
-
-      s_lhs[6][0] += xgp*zgp *         det*wt;
-      s_lhs[6][1] += xgp*xgp*zgp *     det*wt;
-      s_lhs[6][2] += xgp*ygp*zgp *     det*wt;
-      s_lhs[6][3] += xgp*zgp*zgp *     det*wt;
-      s_lhs[6][4] += xgp*xgp*xgp*zgp * det*wt;
-      s_lhs[6][5] += xgp*xgp*ygp*zgp * det*wt;
-      s_lhs[6][6] += xgp*xgp*zgp*zgp * det*wt;
-      s_lhs[6][7] += xgp*ygp*ygp*zgp * det*wt;
-      s_lhs[6][8] += xgp*ygp*zgp*zgp * det*wt;
-      s_lhs[6][9] += xgp*zgp*zgp*zgp * det*wt;
-
-      s_lhs[7][0] += ygp*ygp *         det*wt;
-      s_lhs[7][1] += ygp*ygp*xgp *     det*wt;
-      s_lhs[7][2] += ygp*ygp*ygp *     det*wt;
-      s_lhs[7][3] += ygp*ygp*zgp *     det*wt;
-      s_lhs[7][4] += ygp*ygp*xgp*xgp * det*wt;
-      s_lhs[7][5] += ygp*ygp*ygp*xgp * det*wt;
-      s_lhs[7][6] += ygp*ygp*xgp*zgp * det*wt;
-      s_lhs[7][7] += ygp*ygp*ygp*ygp * det*wt;
-      s_lhs[7][8] += ygp*ygp*ygp*zgp * det*wt;
-      s_lhs[7][9] += ygp*ygp*zgp*zgp * det*wt;
-
-      s_lhs[8][0] += ygp*zgp *         det*wt;
-      s_lhs[8][1] += ygp*xgp*zgp *     det*wt;
-      s_lhs[8][2] += ygp*ygp*zgp *     det*wt;
-      s_lhs[8][3] += ygp*zgp*zgp *     det*wt;
-      s_lhs[8][4] += ygp*xgp*xgp*zgp * det*wt;
-      s_lhs[8][5] += ygp*ygp*xgp*zgp * det*wt;
-      s_lhs[8][6] += ygp*xgp*zgp*zgp * det*wt;
-      s_lhs[8][7] += ygp*ygp*ygp*zgp * det*wt;
-      s_lhs[8][8] += ygp*ygp*zgp*zgp * det*wt;
-      s_lhs[8][9] += ygp*zgp*zgp*zgp * det*wt;
-
-      s_lhs[9][0] += zgp*zgp *         det*wt;
-      s_lhs[9][1] += zgp*zgp*xgp *     det*wt;
-      s_lhs[9][2] += zgp*zgp*ygp *     det*wt;
-      s_lhs[9][3] += zgp*zgp*zgp *     det*wt;
-      s_lhs[9][4] += zgp*zgp*xgp*xgp * det*wt;
-      s_lhs[9][5] += zgp*zgp*xgp*ygp * det*wt;
-      s_lhs[9][6] += zgp*zgp*zgp*xgp * det*wt;
-      s_lhs[9][7] += zgp*zgp*ygp*ygp * det*wt;
-      s_lhs[9][8] += zgp*zgp*zgp*ygp * det*wt;
-      s_lhs[9][9] += zgp*zgp*zgp*zgp * det*wt;
+  /* Final memory cleanup */
+  for (c = 0; c < ncomp; c++) free(tau_lsp[c]);
+  free(tau_lsp);
+  free(tau_gp);
+  free(elem_err);
+  free(elem_vel);
+  free(elem_areas);
+  if (!zp->fixed) zz_patches_free(zp);
 
-      break;
-    default:
-      EH( -1, 
-	  "Unsupported size in building LHS of least squares patch for error" );
-      break;
-    }
-  }    
   return (status);
 }
 
@@ -7079,6 +6327,271 @@ correct_stream_fcn(int *kount,	/* a counter for element connectivity ??     */
 /******************************************************************************/
 /******************************************************************************/
 /******************************************************************************/
+
+static int
+stream_fcn_poisson(double x[],
+		   double x_old[],
+		   double xdot[],
+		   double xdot_old[],
+		   double resid_vector[],
+		   double psi[],
+		   Exo_DB *exo,
+		   Dpi *dpi)
+
+/******************************************************************************
+  Function which calculates the 2D stream function as the solution of
+
+	div grad(psi) = div g = -omega		in the fluid
+	grad(psi) . n = g . n			on its boundary
+
+  with g = (-v, u) in Cartesian coordinates and g = (r v, -r u) in
+  cylindrical ones, the gradient whose side integrals calc_stream_fcn()
+  marches from element to element.  The Galerkin form
+
+	int grad(phi_i) . grad(psi) = int grad(phi_i) . g
+
+  on the velocity basis is solved by Jacobi preconditioned conjugate
+  gradients.  Every processor holds whole rows for the nodes it owns, so
+  the products are formed from the element matrices on each processor
+  and only the external node values are exchanged, with no ordering of
+  the elements and no restriction to one processor.  psi is zero at the
+  first velocity node of the lowest numbered processor holding one.
+  Elements that are not 2D (shells) are left out.
+******************************************************************************/
+{
+  int num_owned = dpi->num_internal_nodes + dpi->num_boundary_nodes;
+  int num_universe_nodes = dpi->num_universe_nodes;
+  int e, ip, ip_total, i, j, a, nd, nel, its, max_its, err;
+  int *elem_ptr, *elem_node, *k_ptr, size_node, size_k;
+  int ref_node = -1, ref_proc, slot[2];
+  double *k_mat, *diag, *rhs, *r, *z, *p, *ap;
+  double kl[MDE][MDE], g[DIM], dA, rz, rz_old, pap, alpha, rnorm, bnorm;
+  double xi[DIM], ref_value = 0.;
+  char *on;
+
+  nel = 0;
+  size_node = MAX(exo->num_elems, 1) * 9;
+  size_k = MAX(exo->num_elems, 1) * 81;
+  elem_ptr = alloc_int_1(exo->num_elems + 1, 0);
+  k_ptr = alloc_int_1(exo->num_elems + 1, 0);
+  elem_node = alloc_int_1(size_node, 0);
+  k_mat = alloc_dbl_1(size_k, 0.);
+  diag = alloc_dbl_1(num_universe_nodes, 0.);
+  rhs = alloc_dbl_1(num_universe_nodes, 0.);
+  on = (char *) array_alloc(1, MAX(num_universe_nodes, 1), sizeof(char));
+  memset(on, 0, MAX(num_universe_nodes, 1));
+
+  /*
+   * Element matrices and the right hand side
+   */
+  for (e = 0; e < exo->num_elems; e++)
+    {
+      err = load_elem_dofptr(e, exo, x, x_old, xdot, xdot_old,
+			     resid_vector, 0);
+      EH(err, "load_elem_dofptr");
+      if (!pd->e[R_MOMENTUM1] || ei->ielem_dim != 2) continue;
+      err = bf_mp_init(pd);
+      EH(err, "bf_mp_init");
+
+      nd = ei->dof[VELOCITY1];
+      if (elem_ptr[nel] + nd > size_node)
+	{
+	  size_node = 2 * size_node + nd;
+	  elem_node = (int *) realloc(elem_node, size_node * sizeof(int));
+	}
+      if (k_ptr[nel] + nd * nd > size_k)
+	{
+	  size_k = 2 * size_k + nd * nd;
+	  k_mat = (double *) realloc(k_mat, size_k * sizeof(double));
+	}
+      if (elem_node == NULL || k_mat == NULL)
+	{
+	  EH(-1, "Out of memory for the stream function");
+	}
+
+      for (i = 0; i < nd; i++)
+	{
+	  for (j = 0; j < nd; j++) kl[i][j] = 0.;
+	}
+
+      ip_total = elem_info(NQUAD, ei->ielem_type);
+      for (ip = 0; ip < ip_total; ip++)
+	{
+	  find_stu(ip, ei->ielem_type, &xi[0], &xi[1], &xi[2]);
+	  fv->wt = Gq_weight(ip, ei->ielem_type);
+
+	  err = load_basis_functions(xi, bfd);
+	  EH(err, "problem from load_basis_functions");
+	  err = beer_belly();
+	  EH(err, "beer_belly");
+	  err = load_fv();
+	  EH(err, "load_fv");
+	  err = load_bf_grad();
+	  EH(err, "load_bf_grad");
+
+	  if (pd->CoordinateSystem == CARTESIAN ||
+	      pd->CoordinateSystem == CARTESIAN_2pt5D)
+	    {
+	      g[0] = -fv->v[1];
+	      g[1] =  fv->v[0];
+	    }
+	  else if (pd->CoordinateSystem == CYLINDRICAL ||
+		   pd->CoordinateSystem == SWIRLING)
+	    {
+	      g[0] =  fv->x[1] * fv->v[1];
+	      g[1] = -fv->x[1] * fv->v[0];
+	    }
+	  else
+	    {
+	      EH(-1, "Stream function routine called with incompatible coord system");
+	    }
+
+	  dA = fv->wt * bf[VELOCITY1]->detJ;
+	  for (i = 0; i < nd; i++)
+	    {
+	      double *gi = bf[VELOCITY1]->grad_phi[i];
+	      for (j = 0; j < nd; j++)
+		{
+		  double *gj = bf[VELOCITY1]->grad_phi[j];
+		  kl[i][j] += (gi[0] * gj[0] + gi[1] * gj[1]) * dA;
+		}
+	      rhs[ei->gnn_list[VELOCITY1][i]] += (gi[0] * g[0] + gi[1] * g[1]) * dA;
+	    }
+	}
+
+      for (i = 0; i < nd; i++)
+	{
+	  elem_node[elem_ptr[nel] + i] = ei->gnn_list[VELOCITY1][i];
+	  on[ei->gnn_list[VELOCITY1][i]] = 1;
+	  diag[ei->gnn_list[VELOCITY1][i]] += kl[i][i];
+	  for (j = 0; j < nd; j++) k_mat[k_ptr[nel] + i * nd + j] = kl[i][j];
+	}
+      if (ref_node == -1) ref_node = ei->gnn_list[VELOCITY1][0];
+      elem_ptr[nel + 1] = elem_ptr[nel] + nd;
+      k_ptr[nel + 1] = k_ptr[nel] + nd * nd;
+      nel++;
+    }
+
+  /*
+   * Conjugate gradients on the owned nodes
+   */
+  r = alloc_dbl_1(num_universe_nodes, 0.);
+  z = alloc_dbl_1(num_universe_nodes, 0.);
+  p = alloc_dbl_1(num_universe_nodes, 0.);
+  ap = alloc_dbl_1(num_universe_nodes, 0.);
+  for (i = 0; i < num_universe_nodes; i++) psi[i] = 0.;
+
+  rz = bnorm = 0.;
+  for (i = 0; i < num_owned; i++)
+    {
+      if (!on[i] || diag[i] == 0.) continue;
+      r[i] = rhs[i];
+      z[i] = r[i] / diag[i];
+      p[i] = z[i];
+      rz += r[i] * z[i];
+      bnorm += r[i] * r[i];
+    }
+  gstatus_begin();
+  slot[0] = gstatus_add(GSTATUS_SUM, rz);
+  slot[1] = gstatus_add(GSTATUS_SUM, bnorm);
+  gstatus_start();
+  rz = gstatus_get(slot[0]);
+  bnorm = sqrt(gstatus_get(slot[1]));
+  rnorm = bnorm;
+
+  max_its = MAX(1000, 4 * (int) sqrt((double) gsum_Int(num_owned)) + 100);
+  for (its = 0; its < max_its && rnorm > 1.e-12 * bnorm && bnorm > 0.; its++)
+    {
+      exchange_node(cx, dpi, p);
+      for (i = 0; i < num_universe_nodes; i++) ap[i] = 0.;
+      for (e = 0; e < nel; e++)
+	{
+	  int *node = elem_node + elem_ptr[e];
+	  double *ke = k_mat + k_ptr[e];
+	  nd = elem_ptr[e + 1] - elem_ptr[e];
+	  for (i = 0; i < nd; i++)
+	    {
+	      if (node[i] >= num_owned) continue;
+	      for (a = 0; a < nd; a++) ap[node[i]] += ke[i * nd + a] * p[node[a]];
+	    }
+	}
+
+      pap = 0.;
+      for (i = 0; i < num_owned; i++)
+	{
+	  if (on[i] && diag[i] != 0.) pap += p[i] * ap[i];
+	}
+      gstatus_begin();
+      slot[0] = gstatus_add(GSTATUS_SUM, pap);
+      gstatus_start();
+      pap = gstatus_get(slot[0]);
+      if (pap <= 0.) break;
+      alpha = rz / pap;
+
+      rz_old = rz;
+      rz = rnorm = 0.;
+      for (i = 0; i < num_owned; i++)
+	{
+	  if (!on[i] || diag[i] == 0.) continue;
+	  psi[i] += alpha * p[i];
+	  r[i] -= alpha * ap[i];
+	  z[i] = r[i] / diag[i];
+	  rz += r[i] * z[i];
+	  rnorm += r[i] * r[i];
+	}
+      gstatus_begin();
+      slot[0] = gstatus_add(GSTATUS_SUM, rz);
+      slot[1] = gstatus_add(GSTATUS_SUM, rnorm);
+      gstatus_start();
+      rz = gstatus_get(slot[0]);
+      rnorm = sqrt(gstatus_get(slot[1]));
+
+      for (i = 0; i < num_owned; i++)
+	{
+	  if (on[i] && diag[i] != 0.) p[i] = z[i] + (rz / rz_old) * p[i];
+	}
+    }
+  if (rnorm > 1.e-8 * bnorm)
+    {
+      WH(-1, "stream_fcn_poisson: conjugate gradients did not converge");
+    }
+
+  /*
+   * Fix the level of psi
+   */
+  exchange_node(cx, dpi, psi);
+  gstatus_begin();
+  slot[0] = gstatus_add(GSTATUS_MIN, (ref_node != -1) ? ProcID : Num_Proc);
+  gstatus_start();
+  ref_proc = (int) gstatus_get(slot[0]);
+  if (ref_proc == ProcID) ref_value = psi[ref_node];
+#ifdef PARALLEL
+  if (ref_proc < Num_Proc && Num_Proc > 1)
+    {
+      MPI_Bcast(&ref_value, 1, MPI_DOUBLE, ref_proc, MPI_COMM_WORLD);
+    }
+#endif
+  for (i = 0; i < num_universe_nodes; i++)
+    {
+      if (on[i]) psi[i] -= ref_value;
+    }
+
+  safer_free((void **) &elem_ptr);
+  safer_free((void **) &k_ptr);
+  safer_free((void **) &elem_node);
+  safer_free((void **) &k_mat);
+  safer_free((void **) &diag);
+  safer_free((void **) &rhs);
+  safer_free((void **) &on);
+  safer_free((void **) &r);
+  safer_free((void **) &z);
+  safer_free((void **) &p);
+  safer_free((void **) &ap);
+  return 0;
+}
+/******************************************************************************/
+/******************************************************************************/
+/******************************************************************************/
 /*
  * rd_post_process_specs -- read post processing specification section of input file
  *
@@ -7791,7 +7304,7 @@ rd_post_process_specs(FILE *ifp,
 	    {
 	      pp_fluxes_sens[i]->vector_id=sens_vec_ct;
 	      
-	      if(Continuation == ALC_FIRST)
+	      if(Continuation == ALC_FIRST || Continuation == ALC_SECOND)
 		{
 		  if( cont->upType == pp_fluxes_sens[i]->sens_type )
 		    {
@@ -8255,7 +7768,7 @@ rd_post_process_specs(FILE *ifp,
 
 	      */
 
-	      if(Continuation == ALC_FIRST)
+	      if(Continuation == ALC_FIRST || Continuation == ALC_SECOND)
 		{
 		  if( cont->upType == pp_data_sens[i]->sens_type )
 		    {
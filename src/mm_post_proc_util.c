@@ -44,6 +44,7 @@
  
 #include "mm_eh.h"
 #include "mm_post_def.h"
+#include "el_bins.h"
 
 #define _MM_FLUX_C
 #define _MM_POST_PROC_UTIL_C
@@ -51,6 +52,137 @@
 
 
 
+/*
+ * Element centroid bins for find_id_elem().
+ *
+ * When no node of the searched element range carries mesh displacement
+ * unknowns, the centroids depend on Coor[] alone; they are then computed
+ * once and looked up through element bins (el_bins.c) instead of scanning
+ * the whole range for every point, e.g. every gauss point of a solid
+ * boundary looking for its fluid element in overlap AC problems.
+ */
+
+#define ELEM_CENTERS_MAX_RANGES 4
+
+struct Elem_Centers
+{
+  int e_start, e_end;
+  int fixed;			/* FALSE: centroids move with the solution */
+  ELEM_BINS bins;
+  dbl **ctr;			/* [elem][DIM], set for [e_start,e_end) */
+};
+
+static struct Elem_Centers Elem_Centers_Table[ELEM_CENTERS_MAX_RANGES];
+static int Elem_Centers_Used = 0;
+static int Elem_Centers_Next = 0;
+
+static void
+elem_centers_free(struct Elem_Centers *ec)
+{
+  elem_bins_free(&ec->bins);
+  if (ec->ctr != NULL)
+    {
+      safer_free((void **) &ec->ctr[ec->e_start]);
+      safer_free((void **) &ec->ctr);
+    }
+  ec->e_start = ec->e_end = 0;
+  ec->fixed = FALSE;
+}
+
+static struct Elem_Centers *
+elem_centers(const Exo_DB *exo, const int e_start, const int e_end)
+
+     /*
+      * The centroids and bins of element range [e_start, e_end), made
+      * on first use in the same way find_id_elem() takes them. Ranges
+      * holding mesh displacement unknowns or subparametric elements
+      * are left unbinned.
+      */
+{
+  struct Elem_Centers *ec;
+  int k, e, id, I, ebn, iconn_ptr, num_local_nodes;
+
+  for (k = 0; k < Elem_Centers_Used; k++)
+    {
+      ec = Elem_Centers_Table + k;
+      if (ec->e_start == e_start && ec->e_end == e_end) return ec;
+    }
+
+  if (Elem_Centers_Used < ELEM_CENTERS_MAX_RANGES)
+    {
+      ec = Elem_Centers_Table + Elem_Centers_Used++;
+    }
+  else
+    {
+      ec = Elem_Centers_Table + Elem_Centers_Next;
+      Elem_Centers_Next = (Elem_Centers_Next + 1) % ELEM_CENTERS_MAX_RANGES;
+      elem_centers_free(ec);
+    }
+  ec->e_start = e_start;
+  ec->e_end = e_end;
+  ec->fixed = (e_end > e_start);
+
+  for (e = e_start; e < e_end && ec->fixed; e++)
+    {
+      ebn = find_elemblock_index(e, exo);
+      if (pd_glob[Matilda[ebn]]->IntegrationMap == SUBPARAMETRIC)
+	{
+	  ec->fixed = FALSE;
+	}
+      iconn_ptr = exo->elem_ptr[e];
+      num_local_nodes = elem_info(NNODES, Elem_Type(exo, e));
+      for (id = 0; id < num_local_nodes; id++)
+	{
+	  I = exo->node_list[iconn_ptr + id];
+	  if (Index_Solution(I, MESH_DISPLACEMENT1, 0, 0, -1) != -1)
+	    {
+	      ec->fixed = FALSE;
+	    }
+	}
+    }
+  if (!ec->fixed) return ec;
+
+  ec->ctr = (dbl **) smalloc(e_end * sizeof(dbl *));
+  ec->ctr[e_start] = alloc_dbl_1(DIM * (e_end - e_start), 0.);
+  for (e = e_start; e < e_end; e++)
+    {
+      ec->ctr[e] = ec->ctr[e_start] + DIM * (e - e_start);
+      iconn_ptr = exo->elem_ptr[e];
+      num_local_nodes = elem_info(NNODES, Elem_Type(exo, e));
+      for (id = 0; id < num_local_nodes; id++)
+	{
+	  I = exo->node_list[iconn_ptr + id];
+	  ec->ctr[e][0] += Coor[0][I];
+	  ec->ctr[e][1] += Coor[1][I];
+	  if (exo->num_dim > 2) ec->ctr[e][2] += Coor[2][I];
+	}
+      for (k = 0; k < DIM; k++) ec->ctr[e][k] /= num_local_nodes;
+    }
+
+  memset(&ec->bins, 0, sizeof(ELEM_BINS));
+  elem_bins_build(&ec->bins, (Exo_DB *) exo, Coor, MIN(exo->num_dim, DIM),
+		  e_start, e_end);
+
+  return ec;
+}
+
+void
+find_id_elem_invalidate(void)
+
+     /*
+      * The coordinates have changed: remake the centroids and bins of
+      * find_id_elem() on their next use.
+      */
+{
+  int k;
+  for (k = 0; k < Elem_Centers_Used; k++)
+    {
+      elem_centers_free(Elem_Centers_Table + k);
+    }
+  Elem_Centers_Used = 0;
+  Elem_Centers_Next = 0;
+}
+
 /* find_id_elem() -- Find global element id given the global coordinates 
  *                   of a point.   
  *
@@ -88,6 +220,19 @@ find_id_elem(const double x,	  /* x-coordinate */
 
 if(!mode)  
   {
+    struct Elem_Centers *ec;
+    dbl xp[DIM];
+
+#ifdef _OPENMP
+#pragma omp critical (find_id_elem)
+#endif
+    ec = elem_centers(exo, e_start, e_end);
+    if (ec->fixed)
+      {
+	xp[0] = x; xp[1] = y; xp[2] = z;
+	return(elem_bins_nearest(&ec->bins, xp, ec->ctr));
+      }
+
     element_no = -1; 
     closest_distance = 1.e30;
     
@@ -12,6 +12,7 @@
  
 
 #include <stdio.h>
+#include <string.h>
 
 #include "std.h"
 #include "rf_fem_const.h"
@@ -99,6 +100,29 @@ setup_pd()
       pd_glob[mn]->TimeIntegration  = TimeIntegration; 	/* from "rf_fem.h" */
       if(pd_glob[mn]->CoordinateSystem != CoordinateSystem)
 	EH(-1, "Not all materials have the same coordinate system!");
+
+      /* Function pointers are not broadcast, so every processor sets them */
+      set_shear_viscosity(gn_glob[mn]);
+      for(i = 0; i < MAX_MODES; i++)
+	{
+	  set_shear_viscosity(ve_glob[mn][i]->gn);
+	}
+
+      /*
+       * Old time gradients somebody reads: fill and level set advection,
+       * belly_flop(), get_convection_velocity() and the species terms,
+       * divergence_particle_stress() of the suspension balance model,
+       * and the lubrication and film shells.
+       */
+      memset(pd_glob[mn]->old_grad, 0, MAX_VARIABLE_TYPES*sizeof(int));
+      pd_glob[mn]->old_grad[FILL]               = TRUE;
+      pd_glob[mn]->old_grad[MESH_DISPLACEMENT1] = TRUE;
+      pd_glob[mn]->old_grad[MASS_FRACTION]      = TRUE;
+      pd_glob[mn]->old_grad[VELOCITY1]          =
+	(cr_glob[mn]->MassFluxModel == DM_SUSPENSION_BALANCE);
+      pd_glob[mn]->old_grad[LUBP]               = TRUE;
+      pd_glob[mn]->old_grad[SHELL_FILMP]        = TRUE;
+      pd_glob[mn]->old_grad[SHELL_FILMH]        = TRUE;
     }
 
   if(CoordinateSystem == CYLINDRICAL || CoordinateSystem == SWIRLING)
@@ -42,65 +42,107 @@
 #include "rd_mesh.h"
 #include "el_elm_info.h"
 #include "mm_eh.h"
+#include "rf_fem.h"
+
+
+/*
+ * The element sides that have a storage block, for the reset and the
+ * destroy at the end.
+ */
+static ELEM_SIDE_BC_STRUCT **QPS_Side = NULL;
+static int QPS_Num_Side = 0;
+static int QPS_Max_Side = 0;
 
 /******************************************************************************/
 /******************************************************************************/
 /******************************************************************************/
 
-void
-elem_qp_storage_free(ELEM_SIDE_BC_STRUCT *elem_side_bc)
+static int
+qp_storage_slot(const int storageType)
 
     /*************************************************************************
      *
-     * elem_qp_storage_free():
+     * qp_storage_slot():
      *
-     *  Frees all of the malloced memory associated with storage of 
-     *  bc calculations at quadrature points on the sides of elements. 
+     *  The place of a storage type within the block of a quadrature point.
+     *************************************************************************/
+{
+  switch (storageType) {
+  case VL_EQUIL_PRXN_BC:
+      return 0;
+  case IS_EQUIL_PRXN_BC:
+      return 1;
+  case SDC_SURFRXN_BC:
+      return 2;
+  default:
+      EH(-1, "qp_storage_slot: storage type has no slot");
+      break;
+  }
+  return -1;
+}
+/******************************************************************************/
+/******************************************************************************/
+/******************************************************************************/
+
+static int
+side_num_qp(const ELEM_SIDE_BC_STRUCT *elem_side_bc)
+{
+  return elem_info(NQUAD_SURF, Elem_Type(EXO_ptr, elem_side_bc->ielem));
+}
+/******************************************************************************/
+/******************************************************************************/
+/******************************************************************************/
+
+static void
+qp_storage_reset(QP_STORAGE_STRUCT *qps)
+
+    /*************************************************************************
      *
+     * qp_storage_reset()
+     *
+     *    Mark the storage of one quadrature point as holding no results,
+     * keeping its memory for the next fill.
      *************************************************************************/
 {
-  int i, ielem_type, num_qp;
-  QP_STORAGE_STRUCT **qps;
-  if (elem_side_bc == NULL) return;
-  do {
-    qps = elem_side_bc->Side_QP_Storage;
-    if (qps) {
-      ielem_type = Elem_Type(EXO_ptr, elem_side_bc->ielem);
-      num_qp = elem_info(NQUAD_SURF, ielem_type);
-      for (i = 0; i < num_qp; i++) {
-	qp_storage_list_destroy(qps + i);
+  int i;
+  INTERFACE_SOURCE_STRUCT *is;
+  if (qps->Storage == NULL) return;
+  switch (qps->StorageType) {
+  case VL_EQUIL_PRXN_BC:
+  case IS_EQUIL_PRXN_BC:
+  case SDC_SURFRXN_BC:
+      is = (INTERFACE_SOURCE_STRUCT *) qps->Storage;
+      for (i = 0; i < Num_Interface_Srcs; i++) {
+	if (is[i].Processed != NULL) {
+	  interface_source_zero(is + i);
+	  is[i].SpeciesVT = SPECIES_UNDEFINED_FORM;
+	}
       }
-      safer_free((void **) &elem_side_bc->Side_QP_Storage);
-    }
-  } while ( (elem_side_bc = elem_side_bc->next_side_bc) != NULL );
-  return;
+      break;
+  default:
+      safer_free(&(qps->Storage));
+      break;
+  }
 }
 /******************************************************************************/
 /******************************************************************************/
 /******************************************************************************/
 
-void
-qp_storage_list_destroy(QP_STORAGE_STRUCT **qps_hdl)
+static void
+qp_storage_destroy(QP_STORAGE_STRUCT *qps)
 
     /*************************************************************************
      *
-     * qp_storage_list_destroy()
+     * qp_storage_destroy()
      *
-     *    Frees storage associated with a linked list of quadrature point
-     * storage structures. It does this by first going to the end of the list
-     * and working backwards through recursive calls.
-     *
-     * This routine needs to know the name of a function that destroys the
-     * malloced memory for each type of malloced memory structure. If 
-     * it doesn't know about a storage type, then the default is to try to
-     * free the address of the storage.
+     *    Frees the storage of one quadrature point. This routine needs to
+     * know the name of a function that destroys the malloced memory for
+     * each type of malloced memory structure. If it doesn't know about a
+     * storage type, then the default is to try to free the address of the
+     * storage.
      *************************************************************************/
 {
-  QP_STORAGE_STRUCT *qps = *qps_hdl;
-  if (!qps) return;
-  if (qps->next) {
-    qp_storage_list_destroy(&(qps->next));
-  }
+  if (qps->Storage == NULL) return;
   switch (qps->StorageType) {
   case VL_EQUIL_PRXN_BC:
   case IS_EQUIL_PRXN_BC:
@@ -111,7 +153,36 @@ qp_storage_list_destroy(QP_STORAGE_STRUCT **qps_hdl)
       safer_free(&(qps->Storage));
       break;
   }
-  safer_free((void **) qps_hdl);
+}
+/******************************************************************************/
+/******************************************************************************/
+/******************************************************************************/
+
+void
+elem_qp_storage_free(ELEM_SIDE_BC_STRUCT *elem_side_bc)
+
+    /*************************************************************************
+     *
+     * elem_qp_storage_free():
+     *
+     *  Frees all of the malloced memory associated with storage of 
+     *  bc calculations at quadrature points on the sides of elements. 
+     *
+     *************************************************************************/
+{
+  int i, num_qps;
+  QP_STORAGE_STRUCT *qps;
+  if (elem_side_bc == NULL) return;
+  do {
+    qps = elem_side_bc->Side_QP_Storage;
+    if (qps) {
+      num_qps = side_num_qp(elem_side_bc) * QP_STORAGE_NUM_TYPES;
+      for (i = 0; i < num_qps; i++) {
+	qp_storage_destroy(qps + i);
+      }
+      safer_free((void **) &elem_side_bc->Side_QP_Storage);
+    }
+  } while ( (elem_side_bc = elem_side_bc->next_side_bc) != NULL );
   return;
 }
 /******************************************************************************/
@@ -131,69 +202,72 @@ void **side_qp_storage_findalloc(const int storageType, const int iquad,
      *   point on the surface. The boundary condition is associated via a
      *   storage type integer, storageType. The quadrature point is associated
      *   via its number.
-     *   If it can't find the storage, then this function mallocs space for
-     *   the storage structure on the surface and returns
-     *   the handle to the storage location.
+     *   The first time a side asks, this function mallocs the block of
+     *   storage structures for all of its quadrature points; the block is
+     *   kept until global_qp_storage_destroy().
      *
      **************************************************************************/
 
 {
-  QP_STORAGE_STRUCT **qpsv;
-  int ielem_type, nqp;
+  QP_STORAGE_STRUCT *qps;
+  int nqp, i, slot;
 #ifdef DEBUG_HKM
   if (elem_side_bc == NULL) return NULL;
 #endif
-  qpsv = elem_side_bc->Side_QP_Storage;
-  /*
-   * Check to see if we have malloced the vector of pointers for this
-   * element side that will base the linked lists on
-   */
-  if (!qpsv) {
-    ielem_type = Elem_Type(EXO_ptr, elem_side_bc->ielem);
-    nqp = elem_info(NQUAD_SURF, ielem_type);
-    elem_side_bc->Side_QP_Storage = qpsv = 
-	(QP_STORAGE_STRUCT **) alloc_ptr_1(nqp);
+  slot = qp_storage_slot(storageType);
+  qps = elem_side_bc->Side_QP_Storage;
+  if (!qps) {
+    nqp = side_num_qp(elem_side_bc);
+    qps = alloc_struct_1(QP_STORAGE_STRUCT, nqp * QP_STORAGE_NUM_TYPES);
+    for (i = 0; i < nqp * QP_STORAGE_NUM_TYPES; i++) {
+      qps[i].LocalQPNum = i / QP_STORAGE_NUM_TYPES;
+    }
+    for (i = 0; i < nqp; i++) {
+      qps[i * QP_STORAGE_NUM_TYPES + 0].StorageType = VL_EQUIL_PRXN_BC;
+      qps[i * QP_STORAGE_NUM_TYPES + 1].StorageType = IS_EQUIL_PRXN_BC;
+      qps[i * QP_STORAGE_NUM_TYPES + 2].StorageType = SDC_SURFRXN_BC;
+    }
+    elem_side_bc->Side_QP_Storage = qps;
+#ifdef _OPENMP
+#pragma omp critical (qp_storage_sides)
+#endif
+    {
+      if (QPS_Num_Side == QPS_Max_Side) {
+	realloc_ptr_1((void ***) &QPS_Side, 2 * QPS_Max_Side + 64,
+		      QPS_Max_Side);
+	QPS_Max_Side = 2 * QPS_Max_Side + 64;
+      }
+      QPS_Side[QPS_Num_Side++] = elem_side_bc;
+    }
   }
-  return (qp_storage_findalloc(storageType, iquad, qpsv + iquad));
+  return (&(qps[iquad * QP_STORAGE_NUM_TYPES + slot].Storage));
 }
 /******************************************************************************/
 /******************************************************************************/
 /******************************************************************************/
 
-void **qp_storage_findalloc(const int storageType, const int iquad, 
-			    QP_STORAGE_STRUCT **qpsh)
+void
+global_qp_storage_reset(void)
 
-    /**************************************************************************
-     * 
-     * qp_storage_findalloc()
-     *
-     *   Given a handle to the start of QP_STORAGE linked list,
-     *   this routine will return the 
-     *   address of the pointer to the storage (i.e., the handle)
-     *   associated with a boundary condition's calculations at a gauss 
-     *   point on the surface. The boundary condition is associated via a
-     *   storage type integer, storageType. The quadrature point is associated
-     *   via its number.
-     *   If it can't find the storage, then this function mallocs space for
-     *   the storage structure at the end of the linked list and returns
-     *   the address of the pointer to the storage (i.e., the handle).
-     *
-     **************************************************************************/
+   /**************************************************************************
+    * 
+    * global_qp_storage_reset()
+    *
+    *   Called at the end of a fill: mark the qp storage of all elements
+    *   as holding no results, keeping the memory for the next fill.
+    *
+    **************************************************************************/
 {
+  int s, i, num_qps;
   QP_STORAGE_STRUCT *qps;
-  if (! *qpsh) { 
-    qps = *qpsh = alloc_struct_1(QP_STORAGE_STRUCT, 1);
-  } else {
-    for (qps = *qpsh; qps != NULL; qps = qps->next) {
-      if (qps->StorageType == storageType) {
-	return (&(qps->Storage));
-      }
+  for (s = 0; s < QPS_Num_Side; s++) {
+    qps = QPS_Side[s]->Side_QP_Storage;
+    if (qps == NULL) continue;
+    num_qps = side_num_qp(QPS_Side[s]) * QP_STORAGE_NUM_TYPES;
+    for (i = 0; i < num_qps; i++) {
+      qp_storage_reset(qps + i);
     }
-    qps = alloc_struct_1(QP_STORAGE_STRUCT, 1);
   }
-  qps->StorageType = storageType;
-  qps->LocalQPNum = iquad;
-  return  (&(qps->Storage));
 }
 /******************************************************************************/
 /******************************************************************************/
@@ -211,14 +285,20 @@ global_qp_storage_destroy(void)
     *
     **************************************************************************/
 {
-  int ielem, e_start, e_end;  
-  e_start = EXO_ptr->eb_ptr[0];
-  e_end   = EXO_ptr->eb_ptr[EXO_ptr->num_elem_blocks];
-  for (ielem = e_start; ielem < e_end; ielem++) {
-    if (First_Elem_Side_BC_Array[ielem]) {
-      elem_qp_storage_free(First_Elem_Side_BC_Array[ielem]);
+  int s, i, num_qps;
+  QP_STORAGE_STRUCT *qps;
+  for (s = 0; s < QPS_Num_Side; s++) {
+    qps = QPS_Side[s]->Side_QP_Storage;
+    if (qps) {
+      num_qps = side_num_qp(QPS_Side[s]) * QP_STORAGE_NUM_TYPES;
+      for (i = 0; i < num_qps; i++) {
+	qp_storage_destroy(qps + i);
+      }
+      safer_free((void **) &(QPS_Side[s]->Side_QP_Storage));
     }
   }
+  safer_free((void **) &QPS_Side);
+  QPS_Num_Side = QPS_Max_Side = 0;
 }
 /******************************************************************************/
 /******************************************************************************/
@@ -52,6 +52,7 @@ static char rcsid[] = "$Id: mm_qtensor_model.c,v 5.2 2009-05-20 15:31:33 hkmoffa
 
 #include "mm_fill_species.h"
 #include "mm_std_models.h"
+#include "mm_fill_stress.h"
 
 #define _MM_QTENSOR_MODEL_C
 #include "goma.h"
@@ -93,6 +94,14 @@ static char rcsid[] = "$Id: mm_qtensor_model.c,v 5.2 2009-05-20 15:31:33 hkmoffa
 static int get_local_qtensor
 PROTO((double [][DIM]));
 
+static int qtensor_eigen
+PROTO((dbl [DIM][DIM],		/* T - symmetric tensor */
+       dbl [DIM],		/* z - eigenvalues, ascending */
+       dbl [DIM][DIM]));	/* R - eigenvectors in the columns */
+
+static void qtensor_eigenvector
+PROTO((dbl [DIM][DIM], int, dbl *));
+
 #define MAX_GAUSS_POINTS 12
 
 /*
@@ -2576,6 +2585,41 @@ find_eigenvector(dbl AA[3][3],
 }
 
 
+/* Eigenpairs of the symmetric 3x3 tensor T, ascending in z with the
+ * eigenvectors in the columns of R, from the same Jacobi kernel as the
+ * log-conformation stress. Eigenvalues within QTENSOR_SMALL_DBL of zero
+ * are set to zero; the number of them is returned. */
+static int
+qtensor_eigen(dbl T[DIM][DIM],
+	      dbl z[DIM],
+	      dbl R[DIM][DIM])
+{
+  int i, j;
+  dbl A[DIM][DIM];
+
+  memset(A, 0, DIM * DIM * sizeof(dbl));
+  for(i = 0; i < 3; i++)
+    for(j = i; j < 3; j++)
+      A[i][j] = 0.5 * (T[i][j] + T[j][i]);
+
+  sym_eigen_jacobi(3, A, z, R);
+
+  /* Try to catch some roundoff errors. */
+  for(i = 0; i < 3; i++)
+    if(fabs(z[i]) < QTENSOR_SMALL_DBL) z[i] = 0.0;
+  return (z[0] == 0.0) + (z[1] == 0.0) + (z[2] == 0.0);
+}
+
+/* Column j of R into v. */
+static void
+qtensor_eigenvector(dbl R[DIM][DIM], int j, dbl *v)
+{
+  int i;
+
+  for(i = 0; i < 3; i++)
+    v[i] = R[i][j];
+}
+
 /* This routine returns the eigenvalue of smallest absolute value and
  * its associated eigenvector.
  *
@@ -2593,173 +2637,24 @@ find_super_special_eigenvector(dbl T[DIM][DIM],
 			       int print)
 {
   int num_zero_eigenvalues;
-  int i,j;
-  dbl A[3][3];
-  dbl a0, a2, a1;
-  dbl q, r, d, m, theta, z1, z2, z3;
-  dbl eig1=0., eig2=0., eig3=0.;
+  dbl z[DIM], R[DIM][DIM];
 
   memset(v, 0, DIM * sizeof(dbl));
-  memset(v1, 0, DIM * sizeof(dbl));
-  memset(v2, 0, DIM * sizeof(dbl));
-  memset(v3, 0, DIM * sizeof(dbl));
- 
   *eigenvalue = 0.0;
 
-  memset(A, 0, 9 * sizeof(dbl));
-  for (i=0; i < DIM; i++)
-    {
-      for (j=0; j < DIM; j++)
-	{
-	  A[i][j] = T[i][j];
-	}
-    }
-
-  /* Now find the zeros of the cubic polynomial characteristic
-   * equation.  This requires some complex number mumbo-jubmo, which I
-   * have significantly simplified on some assumptions (symmetric
-   * tensor, etc.).
-   */
-
-  /* Note that if T really is a rate of deformation tensor, then a2 =
-   * 0 because it is just the trace, and the trace should be zero if
-   * the flow is incompressible. */
-  get_characteristic_eq_coeffs(A, &a0, &a1, &a2);
-
-  q = (3.0 * a1 - a2 * a2) / 9.0;
-  /* q will only be > 0 due to roundoff. */
-  if(q > 0.0)
-    q = 0.0;
-  r = (a1 * a2 - 3.0 * a0) / 6.0 - a2 * a2 *a2 / 27.0;
-#ifdef DEBUG_DIAGONALIZATION
-  if(print)
-    {
-      printf( "q = % 10.4g, r = % 10.4g ", q, r);
-      fflush(stdout);
-    }
-#endif
-  /* This will only fail if q and r are corrupted by roundoff. */
-  d = -q*q*q - r*r;
-  if(d < 0.0)
-    d = 0.0;
-  else
-    d = sqrt(d);
-#ifdef DEBUG_DIAGONALIZATION
-  if(print)
-    printf( "d = % 10.4g\n", d);
-#endif
-  theta = atan2(d, r) / 3.0;
-#ifdef DEBUG_DIAGONALIZATION
-  if(print)
-    {
-      printf( "theta = % 10.4g, ", theta);
-      fflush(stdout);
-    }
-#endif
-  if(q == 0.0)
-    m = 0.0;
-  else
-    m = sqrt(-q);
-#ifdef DEBUG_DIAGONALIZATION
-  if(print)
-    printf( "m = % 10.4g\n", m);
-#endif
-  z1 = 2.0 * m * cos(theta) - a2 / 3.0;
-  z2 = -m * (cos(theta) + sqrt(3.0) * sin(theta)) - a2 / 3.0;
-  z3 = -m * (cos(theta) - sqrt(3.0) * sin(theta)) - a2 / 3.0;
-#ifdef DEBUG_DIAGONALIZATION
-  if(print)
-    printf( "z1 = % 16.14g, z2 = % 16.14g, z3 = % 16.14g\n", z1, z2, z3);
-  fflush(stdout);
-#endif
-
-  /* Try to catch some roundoff errors. */
-  if(fabs(z1) < QTENSOR_SMALL_DBL) z1 = 0.0;
-  if(fabs(z2) < QTENSOR_SMALL_DBL) z2 = 0.0;
-  if(fabs(z3) < QTENSOR_SMALL_DBL) z3 = 0.0;
-
-  num_zero_eigenvalues = (z1 == 0.0) + (z2 == 0.0) + (z3 == 0.0);
-  if(print)
-    {
-#ifdef DEBUG_QTENSOR
-      printf( "EIGENVALUES = %g, %g, %g\n", z1, z2, z3);
-#endif
-#ifdef DEBUG_DIAGONALIZATION
-      printf( "Before entering find_eigenvector(), A = \n");
-      for(i = 0; i < 3; i++)
-	{
-	  for(j = 0; j < 3; j++)
-	    printf( "% 10.4g ", A[i][j]);
-	  printf( "\n");
-	}
-      fflush(stdout);
-#endif
-    }
+  num_zero_eigenvalues = qtensor_eigen(T, z, R);
 
   /* Arrange eigenvalues as tension, compression, vorticity */
   /* eig(compression) < eig(vorticity) < eig(tension)       */
-  
+  qtensor_eigenvector(R, 2, v1);
+  qtensor_eigenvector(R, 0, v2);
+  qtensor_eigenvector(R, 1, v3);
+
   if(num_zero_eigenvalues <= 1)
     {
       /* Good, there must be a "largest" and "smallest" eigenvalue. */
-      if(z1 > z2)
-	if(z2 > z3)
-	  { 
-	    /* z3 < z2 < z1 */
-	    find_eigenvector(A, z2, v, print);
-	    *eigenvalue = z2;
-	    eig1 = z1;
-	    eig2 = z3;
-	    eig3 = z2;
-	  }
-	else
-	  if(z3 > z1)
-	    {
-	      /* z2 < z1 < z3 */
-	      find_eigenvector(A, z1, v, print);
-	      *eigenvalue = z1;
-	      eig1 = z3;
-	      eig2 = z2;
-	      eig3 = z1;
-	    }
-	  else
-	    {
-	      /* z2 < z3 < z1 */
-	      find_eigenvector(A, z3, v, print);
-	      *eigenvalue = z3;
-	      eig1 = z1;
-	      eig2 = z2;
-	      eig3 = z3;
-	    }
-      else
-	if(z2 > z3)
-	  if(z3 > z1)
-	    {
-	      /* z1 < z3 < z2 */
-	      find_eigenvector(A, z3, v, print);
-	      *eigenvalue = z3;
-	      eig1 = z2;
-	      eig2 = z1;
-	      eig3 = z3;
-	    }
-	  else
-	    {
-	      /* z3 < z1 < z2 */
-	      find_eigenvector(A, z1, v, print);
-	      *eigenvalue = z1;
-	      eig1 = z2;
-	      eig2 = z3;
-	      eig3 = z1;
-	    }
-	else
-	  {
-	    /* z1 < z2 < z3 */
-	    find_eigenvector(A, z2, v, print);
-	    *eigenvalue = z2;
-	    eig1 = z3;
-	    eig2 = z1;
-	    eig3 = z2;
-	  }
+      qtensor_eigenvector(R, 1, v);
+      *eigenvalue = z[1];
 
       if(print)
 	{
@@ -2772,9 +2667,6 @@ find_super_special_eigenvector(dbl T[DIM][DIM],
     {
       /* At least 2 zeros => all 3 are zero (symmetry) */
     }
-  find_eigenvector(A, eig1, v1, print);
-  find_eigenvector(A, eig2, v2, print);
-  find_eigenvector(A, eig3, v3, print);
   /* Try to catch some roundoff errors. */
   if(fabs(v[0]) < QTENSOR_SMALL_DBL) v[0] = 0.0;
   if(fabs(v[1]) < QTENSOR_SMALL_DBL) v[1] = 0.0;
@@ -2788,183 +2680,24 @@ find_eigenvalues_eigenvectors(dbl T[DIM][DIM],
 			       dbl *v2,
 			       dbl *v3)
 {
-  int num_zero_eigenvalues;
-  int i,j, print=0;
-  dbl A[3][3];
-  dbl a0, a2, a1;
-  dbl q, r, d, m, theta, z1, z2, z3;
-  dbl eig1=0., eig2=0., eig3=0.;
-  dbl v[3];
-
-  memset(v, 0, DIM * sizeof(dbl));
-  memset(v1, 0, DIM * sizeof(dbl));
-  memset(v2, 0, DIM * sizeof(dbl));
-  memset(v3, 0, DIM * sizeof(dbl));
-
-  memset(A, 0, 9 * sizeof(dbl));
-  for (i=0; i < DIM; i++)
-    {
-      for (j=0; j < DIM; j++)
-	{
-	  A[i][j] = T[i][j];
-	}
-    }
-
-  /* Now find the zeros of the cubic polynomial characteristic
-   * equation.  This requires some complex number mumbo-jubmo, which I
-   * have significantly simplified on some assumptions (symmetric
-   * tensor, etc.).
-   */
-
-  /* Note that if T really is a rate of deformation tensor, then a2 =
-   * 0 because it is just the trace, and the trace should be zero if
-   * the flow is incompressible. */
-  get_characteristic_eq_coeffs(A, &a0, &a1, &a2);
-
-  q = (3.0 * a1 - a2 * a2) / 9.0;
-  /* q will only be > 0 due to roundoff. */
-  if(q > 0.0)
-    q = 0.0;
-  r = (a1 * a2 - 3.0 * a0) / 6.0 - a2 * a2 *a2 / 27.0;
-#ifdef DEBUG_DIAGONALIZATION
-  if(print)
-    {
-      printf( "q = % 10.4g, r = % 10.4g ", q, r);
-      fflush(stdout);
-    }
-#endif
-  /* This will only fail if q and r are corrupted by roundoff. */
-  d = -q*q*q - r*r;
-  if(d < 0.0)
-    d = 0.0;
-  else
-    d = sqrt(d);
-#ifdef DEBUG_DIAGONALIZATION
-  if(print)
-    printf( "d = % 10.4g\n", d);
-#endif
-  theta = atan2(d, r) / 3.0;
-#ifdef DEBUG_DIAGONALIZATION
-  if(print)
-    {
-      printf( "theta = % 10.4g, ", theta);
-      fflush(stdout);
-    }
-#endif
-  if(q == 0.0)
-    m = 0.0;
-  else
-    m = sqrt(-q);
-#ifdef DEBUG_DIAGONALIZATION
-  if(print)
-    printf( "m = % 10.4g\n", m);
-#endif
-  z1 = 2.0 * m * cos(theta) - a2 / 3.0;
-  z2 = -m * (cos(theta) + sqrt(3.0) * sin(theta)) - a2 / 3.0;
-  z3 = -m * (cos(theta) - sqrt(3.0) * sin(theta)) - a2 / 3.0;
-#ifdef DEBUG_DIAGONALIZATION
-  if(print)
-    printf( "z1 = % 16.14g, z2 = % 16.14g, z3 = % 16.14g\n", z1, z2, z3);
-  fflush(stdout);
-#endif
-
-  /* Try to catch some roundoff errors. */
-  if(fabs(z1) < QTENSOR_SMALL_DBL) z1 = 0.0;
-  if(fabs(z2) < QTENSOR_SMALL_DBL) z2 = 0.0;
-  if(fabs(z3) < QTENSOR_SMALL_DBL) z3 = 0.0;
-
-  num_zero_eigenvalues = (z1 == 0.0) + (z2 == 0.0) + (z3 == 0.0);
-  if(print)
-    {
-#ifdef DEBUG_QTENSOR
-      printf( "EIGENVALUES = %g, %g, %g\n", z1, z2, z3);
-#endif
-#ifdef DEBUG_DIAGONALIZATION
-      printf( "Before entering find_eigenvector(), A = \n");
-      for(i = 0; i < 3; i++)
-	{
-	  for(j = 0; j < 3; j++)
-	    printf( "% 10.4g ", A[i][j]);
-	  printf( "\n");
-	}
-      fflush(stdout);
-#endif
-    }
+  dbl z[DIM], R[DIM][DIM];
 
   /* Arrange eigenvalues as tension, compression, vorticity */
   /* eig(compression) < eig(vorticity) < eig(tension)       */
-  
-  if(num_zero_eigenvalues <= 1)
+  if(qtensor_eigen(T, z, R) <= 1)
     {
-      /* Good, there must be a "largest" and "smallest" eigenvalue. */
-      if(z1 > z2)
-	if(z2 > z3)
-	  { 
-	    /* z3 < z2 < z1 */
-	    find_eigenvector(A, z2, v, print);
-	    eig1 = z1;
-	    eig2 = z3;
-	    eig3 = z2;
-	  }
-	else
-	  if(z3 > z1)
-	    {
-	      /* z2 < z1 < z3 */
-	      find_eigenvector(A, z1, v, print);
-	      eig1 = z3;
-	      eig2 = z2;
-	      eig3 = z1;
-	    }
-	  else
-	    {
-	      /* z2 < z3 < z1 */
-	      find_eigenvector(A, z3, v, print);
-	      eig1 = z1;
-	      eig2 = z2;
-	      eig3 = z3;
-	    }
-      else
-	if(z2 > z3)
-	  if(z3 > z1)
-	    {
-	      /* z1 < z3 < z2 */
-	      find_eigenvector(A, z3, v, print);
-	      eig1 = z2;
-	      eig2 = z1;
-	      eig3 = z3;
-	    }
-	  else
-	    {
-	      /* z3 < z1 < z2 */
-	      find_eigenvector(A, z1, v, print);
-	      eig1 = z2;
-	      eig2 = z3;
-	      eig3 = z1;
-	    }
-	else
-	  {
-	    /* z1 < z2 < z3 */
-	    find_eigenvector(A, z2, v, print);
-	    eig1 = z3;
-	    eig2 = z1;
-	    eig3 = z2;
-	  }
+      *e1 = z[2];
+      *e2 = z[0];
+      *e3 = z[1];
     }
   else
     {
       /* At least 2 zeros => all 3 are zero (symmetry) */
+      *e1 = *e2 = *e3 = 0.0;
     }
-  find_eigenvector(A, eig1, v1, print);
-  find_eigenvector(A, eig2, v2, print);
-  find_eigenvector(A, eig3, v3, print);
-  /* Try to catch some roundoff errors. */
-  if(fabs(v[0]) < QTENSOR_SMALL_DBL) v[0] = 0.0;
-  if(fabs(v[1]) < QTENSOR_SMALL_DBL) v[1] = 0.0;
-  if(fabs(v[2]) < QTENSOR_SMALL_DBL) v[2] = 0.0;
-
-  *e1 = eig1;
-  *e2 = eig2;
-  *e3 = eig3;
+  qtensor_eigenvector(R, 2, v1);
+  qtensor_eigenvector(R, 0, v2);
+  qtensor_eigenvector(R, 1, v3);
 }
 
 
@@ -2991,213 +2724,34 @@ diagonalize_symmetric_tensor(dbl T[DIM][DIM],
 {
   int i, j, k;
   int num_zero_eigenvalues;
-  dbl A[3][3];
-  dbl a0, a2, a1;
-  dbl q, r, d, m, theta, z1, z2, z3;
-  dbl tmp1, vfnorm;
+  dbl z[DIM], R[DIM][DIM];
 
   memset(v0, 0, DIM * sizeof(dbl));
   memset(v1, 0, DIM * sizeof(dbl));
   memset(v2, 0, DIM * sizeof(dbl));
   memset(eigenvalues, 0, DIM * sizeof(dbl));
 
-  /* First, get a copy of the shear rate tensor. */
-  memcpy(A, T, DIM * DIM * sizeof(dbl));
-
-  /* Now find the zeros of the cubic polynomial characteristic
-   * equation.  This requires some complex number mumbo-jubmo, which I
-   * have significantly simplified on some assumptions (symmetric
-   * tensor, etc.).
-   */
-
-  /* Note that if T really is a rate of deformation tensor, then a2 =
-   * 0 because it is just the trace, and the trace should be zero if
-   * the flow is incompressible. */
-  a2 = -A[0][0] - A[1][1] - A[2][2];
-  a1 = A[1][1] * A[2][2] + A[0][0] * A[2][2] + A[0][0] * A[1][1] -
-    A[0][1] * A[1][0] - A[0][2] * A[2][0] - A[1][2] * A[2][1];
-  a0 = -A[0][0] * A[1][1] * A[2][2] + A[0][1] * A[0][1] * A[2][2] +
-    A[0][0] * A[1][2] * A[1][2] + A[0][2] * A[0][2] * A[1][1] -
-    A[0][1] * A[2][0] * A[1][2] - A[0][2] * A[1][0] * A[2][1];
-
-  q = (3.0 * a1 - a2 * a2) / 9.0;
-  /* q will only be > 0 due to roundoff. */
-  if(q > 0.0)
-    q = 0.0;
-  r = (a1 * a2 - 3.0 * a0) / 6.0 - a2 * a2 *a2 / 27.0;
-#ifdef DEBUG_DIAGONALIZATION
-  if(print)
-    {
-      printf( "q = % 10.4g, r = % 10.4g ", q, r);
-      fflush(stdout);
-    }
-#endif
-  /* This will only fail if q and r are corrupted by roundoff. */
-  d = -q*q*q - r*r;
-  if(d < 0.0)
-    d = 0.0;
-  else
-    d = sqrt(d);
-#ifdef DEBUG_DIAGONALIZATION
-  if(print)
-    printf( "d = % 10.4g\n", d);
-#endif
-  theta = atan2(d, r) / 3.0;
-#ifdef DEBUG_DIAGONALIZATION
-  if(print)
-    {
-      printf( "theta = % 10.4g, ", theta);
-      fflush(stdout);
-    }
-#endif
-  if(q == 0.0)
-    m = 0.0;
-  else
-    m = sqrt(-q);
-#ifdef DEBUG_DIAGONALIZATION
-  if(print)
-    printf( "m = % 10.4g\n", m);
-#endif
-  z1 = 2.0 * m * cos(theta) - a2 / 3.0;
-  z2 = -m * (cos(theta) + sqrt(3.0) * sin(theta)) - a2 / 3.0;
-  z3 = -m * (cos(theta) - sqrt(3.0) * sin(theta)) - a2 / 3.0;
-#ifdef DEBUG_DIAGONALIZATION
-  if(print)
-    printf( "z1 = % 16.14g, z2 = % 16.14g, z3 = % 16.14g\n", z1, z2, z3);
-  fflush(stdout);
-#endif
-
-  /* Try to catch some roundoff errors. */
-  if(fabs(z1) < QTENSOR_SMALL_DBL) z1 = 0.0;
-  if(fabs(z2) < QTENSOR_SMALL_DBL) z2 = 0.0;
-  if(fabs(z3) < QTENSOR_SMALL_DBL) z3 = 0.0;
-
-  num_zero_eigenvalues = (z1 == 0.0) + (z2 == 0.0) + (z3 == 0.0);
-  if(print)
-    {
+  num_zero_eigenvalues = qtensor_eigen(T, z, R);
 #ifdef DEBUG_QTENSOR
-      printf( "EIGENVALUES = %g, %g, %g\n", z1, z2, z3);
-#endif
-#ifdef DEBUG_DIAGONALIZATION
-      printf( "Before entering find_eigenvector(), A = \n");
-      for(i = 0; i < 3; i++)
-	{
-	  for(j = 0; j < 3; j++)
-	    printf( "% 10.4g ", A[i][j]);
-	  printf( "\n");
-	}
-      fflush(stdout);
+  if(print)
+    printf( "EIGENVALUES = %g, %g, %g\n", z[0], z[1], z[2]);
 #endif
-    }
 
   if(num_zero_eigenvalues <= 1)
     {
-      /* Good, there must be a "largest" and "smallest" eigenvalue. */
-      if(z1 > z2)
-	if(z2 > z3)
-	  { 
-	    /* z3 < z2 < z1 */
-	    find_eigenvector(A, z3, v0, print);
-	    find_eigenvector(A, z1, v2, print);
-	    eigenvalues[0] = z3;
-	    eigenvalues[1] = z2;
-	    eigenvalues[2] = z1;
-	  }
-	else
-	  if(z3 > z1)
-	    {
-	      /* z2 < z1 < z3 */
-	      find_eigenvector(A, z2, v0, print);
-	      find_eigenvector(A, z3, v2, print);
-	      eigenvalues[0] = z2;
-	      eigenvalues[1] = z1;
-	      eigenvalues[2] = z3;
-	    }
-	  else
-	    {
-	      /* z2 < z3 < z1 */
-	      find_eigenvector(A, z2, v0, print);
-	      find_eigenvector(A, z1, v2, print);
-	      eigenvalues[0] = z2;
-	      eigenvalues[1] = z3;
-	      eigenvalues[2] = z1;
-	    }
-      else
-	if(z2 > z3)
-	  if(z3 > z1)
-	    {
-	      /* z1 < z3 < z2 */
-	      find_eigenvector(A, z1, v0, print);
-	      find_eigenvector(A, z2, v2, print);
-	      eigenvalues[0] = z1;
-	      eigenvalues[1] = z3;
-	      eigenvalues[2] = z2;
-	    }
-	  else
-	    {
-	      /* z3 < z1 < z2 */
-	      find_eigenvector(A, z3, v0, print);
-	      find_eigenvector(A, z2, v2, print);
-	      eigenvalues[0] = z3;
-	      eigenvalues[1] = z1;
-	      eigenvalues[2] = z2;
-	    }
-	else
-	  {
-	    /* z1 < z2 < z3 */
-	    find_eigenvector(A, z1, v0, print);
-	    find_eigenvector(A, z3, v2, print);
-	    eigenvalues[0] = z1;
-	    eigenvalues[1] = z2;
-	    eigenvalues[2] = z3;
-	  }
-      /*
-      if(print)
-	for(i = 0; i < DIM; i++)
-	  {
-	    printf( "v0[%d] = %g\n", i, v0[i]);
-	    printf( "v2[%d] = %g\n", i, v2[i]);
-	  }
-      */
-
-      /* tmp1 holds the value of v0 . v2.  It is used to subtract the
-       * part of v2 that is in the v0 direction.  We dot first, then
-       * convert v0 into a unit vector.  Once v2 is orthogonal to v0
-       * we normalize v2.  The cross product of these two othronormal
-       * directions is the third eigenvector (assuming the incoming
-       * matrix was real symmetric).
-       *
-       * I'm assuming that I don't compute the eigenvector for the
-       * minimum eigenvalue (in absolute value) directly because of
-       * stability issues.  Check this sometime.
-       */
-      tmp1 = 0.0;
-      for(i = 0; i < DIM; i++)
-	tmp1 += v0[i] * v2[i];
-      vfnorm = normalize_really_simple_vector(v0, DIM);
-      if(vfnorm > 1.0e-16)
-	tmp1 /= vfnorm;
+      /* Good, there must be a "largest" and "smallest" eigenvalue.
+       * The Jacobi eigenvectors are orthonormal already; the cross
+       * product of the outer two gives the third (assuming the
+       * incoming matrix was real symmetric) with a right-handed
+       * orientation. */
       for(i = 0; i < DIM; i++)
-	{
-	  /* was (10/18/00):
-	  v1[i] -= tmp1 * v0[i];
-	  */
-	  v2[i] -= tmp1 * v0[i];
-	  /*
-	  if(print)
-	    printf( "Setting v2[%d] = %g\n", i, v2[i]);
-	  */
-	}
-      normalize_really_simple_vector(v2, DIM);
+	eigenvalues[i] = z[i];
+      qtensor_eigenvector(R, 0, v0);
+      qtensor_eigenvector(R, 2, v2);
       for(i = 0; i < DIM; i++)
 	for(j = 0; j < DIM; j++)
 	  for(k = 0; k < DIM; k++)
 	    v1[k] += permute(i,j,k) * v0[i] * v2[j];
-      /*
-      if(print)
-	for(i = 0; i < DIM; i++)
-	  printf( "v1[%d] = %g\n", i, v1[i]);
-      */
     }
   else
     {
@@ -3229,198 +2783,39 @@ diagonalize_rate_of_deformation_tensor(dbl T[3][3],
   int i, j, k;
   int num_zero_eigenvalues;
   dbl A[3][3];
-  dbl a0, a1, a2;		/* a2 is ignored b/c tr(T) = 0 */
-  dbl q, r, d, m, theta, costheta, sintheta, z1, z2, z3;
-  dbl tmp1, vfnorm;
+  dbl z[DIM], R[DIM][DIM];
+  dbl trace;
 
   memset(v0, 0, DIM * sizeof(dbl));
   memset(v1, 0, DIM * sizeof(dbl));
   memset(v2, 0, DIM * sizeof(dbl));
   memset(eigenvalues, 0, DIM * sizeof(dbl));
 
-  /* First, get a copy of the shear rate tensor. */
+  /* The trace is zero for an incompressible flow, so it is removed
+   * to leave the eigenvalues of the deviatoric part, as solving the
+   * characteristic equation without its a2 term did. */
   memcpy(A, T, DIM * DIM * sizeof(dbl));
+  trace = (A[0][0] + A[1][1] + A[2][2]) / 3.0;
+  for(i = 0; i < 3; i++)
+    A[i][i] -= trace;
 
-  /* Now find the zeros of the cubic polynomial characteristic
-   * equation.  This requires some complex number mumbo-jubmo, which I
-   * have significantly simplified on some assumptions (symmetric
-   * tensor, etc.).
-   */
-  get_characteristic_eq_coeffs(A, &a0, &a1, &a2);
-
-  q = a1 / 3.0;
-  /* q will only be > 0 due to roundoff. */
-  if(q > 0.0)
-    q = 0.0;
-  r = -a0 / 2.0;
-#ifdef DEBUG_DIAGONALIZATION
-  if(print)
-    {
-      printf( "q = % 10.4g, r = % 10.4g ", q, r);
-      fflush(stdout);
-    }
-#endif
-  /* This will only fail if q and r are corrupted by roundoff. */
-  d = -q*q*q - r*r;
-  if(d < 0.0)
-    d = 0.0;
-  else
-    d = sqrt(d);
-#ifdef DEBUG_DIAGONALIZATION
-  if(print)
-    printf( "d = % 10.4g\n", d);
-#endif
-  theta = atan2(d, r) / 3.0;
-#ifdef DEBUG_DIAGONALIZATION
-  if(print)
-    {
-      printf( "theta = % 10.4g, ", theta);
-      fflush(stdout);
-    }
-#endif
-  if(q == 0.0)
-    m = 0.0;
-  else
-    m = sqrt(-q);
-#ifdef DEBUG_DIAGONALIZATION
-  if(print)
-    printf( "m = % 10.4g\n", m);
-#endif
-  costheta = cos(theta);
-  sintheta = sin(theta);
-  z1 = 2.0 * m * costheta;
-  z2 = -m * (costheta + sqrt(3.0) * sintheta);
-  z3 = -m * (costheta - sqrt(3.0) * sintheta);
-#ifdef DEBUG_DIAGONALIZATION
-  if(print)
-    printf( "z1 = % 16.14g, z2 = % 16.14g, z3 = % 16.14g\n", z1, z2, z3);
-  fflush(stdout);
-#endif
-
-  /* Try to catch some roundoff errors. */
-  if(fabs(z1) < QTENSOR_SMALL_DBL) z1 = 0.0;
-  if(fabs(z2) < QTENSOR_SMALL_DBL) z2 = 0.0;
-  if(fabs(z3) < QTENSOR_SMALL_DBL) z3 = 0.0;
-
-  num_zero_eigenvalues = (z1 == 0.0) + (z2 == 0.0) + (z3 == 0.0);
-  if(print)
-    {
+  num_zero_eigenvalues = qtensor_eigen(A, z, R);
 #ifdef DEBUG_QTENSOR
-      printf( "EIGENVALUES = %g, %g, %g\n", z1, z2, z3);
-#endif
-#ifdef DEBUG_DIAGONALIZATION
-      printf( "Before entering find_eigenvector(), A = \n");
-      for(i = 0; i < 3; i++)
-	{
-	  for(j = 0; j < 3; j++)
-	    printf( "% 10.4g ", A[i][j]);
-	  printf( "\n");
-	}
-      fflush(stdout);
+  if(print)
+    printf( "EIGENVALUES = %g, %g, %g\n", z[0], z[1], z[2]);
 #endif
-    }
 
   if(num_zero_eigenvalues <= 1)
     {
-      /* Good, there must be a "largest" and "smallest" eigenvalue. */
-      if(z1 > z2)
-	if(z2 > z3)
-	  { 
-	    /* z3 < z2 < z1 */
-	    find_eigenvector(A, z3, v0, print);
-	    find_eigenvector(A, z1, v2, print);
-	    eigenvalues[0] = z3;
-	    eigenvalues[1] = z2;
-	    eigenvalues[2] = z1;
-	  }
-	else
-	  if(z3 > z1)
-	    {
-	      /* z2 < z1 < z3 */
-	      find_eigenvector(A, z2, v0, print);
-	      find_eigenvector(A, z3, v2, print);
-	      eigenvalues[0] = z2;
-	      eigenvalues[1] = z1;
-	      eigenvalues[2] = z3;
-	    }
-	  else
-	    {
-	      /* z2 < z3 < z1 */
-	      find_eigenvector(A, z2, v0, print);
-	      find_eigenvector(A, z1, v2, print);
-	      eigenvalues[0] = z2;
-	      eigenvalues[1] = z3;
-	      eigenvalues[2] = z1;
-	    }
-      else
-	if(z2 > z3)
-	  if(z3 > z1)
-	    {
-	      /* z1 < z3 < z2 */
-	      find_eigenvector(A, z1, v0, print);
-	      find_eigenvector(A, z2, v2, print);
-	      eigenvalues[0] = z1;
-	      eigenvalues[1] = z3;
-	      eigenvalues[2] = z2;
-	    }
-	  else
-	    {
-	      /* z3 < z1 < z2 */
-	      find_eigenvector(A, z3, v0, print);
-	      find_eigenvector(A, z2, v2, print);
-	      eigenvalues[0] = z3;
-	      eigenvalues[1] = z1;
-	      eigenvalues[2] = z2;
-	    }
-	else
-	  {
-	    /* z1 < z2 < z3 */
-	    find_eigenvector(A, z1, v0, print);
-	    find_eigenvector(A, z3, v2, print);
-	    eigenvalues[0] = z1;
-	    eigenvalues[1] = z2;
-	    eigenvalues[2] = z3;
-	  }
-
-      /* Before gramm-schmidt'ing them ... */
-      /*
-      if(print)
-	for(i = 0; i < DIM; i++)
-	  {
-	    printf( "v0[%d] = %g\n", i, v0[i]);
-	    printf( "v2[%d] = %g\n", i, v2[i]);
-	  }
-      */
-
-      /* tmp1 holds the value of v0 . v2.  It is used to subtract the
-       * part of v2 that is in the v0 direction.  We dot first, then
-       * convert v0 into a unit vector.  Once v2 is orthogonal to v0
-       * we normalize v2.  The cross product of these two othronormal
-       * directions is the third eigenvector (assuming the incoming
-       * matrix was real symmetric).
-       *
-       * I'm assuming that I don't compute the eigenvector for the
-       * minimum eigenvalue (in absolute value) directly because of
-       * stability issues.  Check this sometime.
-       */
-      tmp1 = 0.0;
+      /* Good, there must be a "largest" and "smallest" eigenvalue.
+       * The Jacobi eigenvectors are orthonormal already; the cross
+       * product of the outer two gives the third (assuming the
+       * incoming matrix was real symmetric) with a right-handed
+       * orientation. */
       for(i = 0; i < DIM; i++)
-	tmp1 += v0[i] * v2[i];
-      vfnorm = normalize_really_simple_vector(v0, DIM);
-      if(vfnorm > 1.0e-16)
-	tmp1 /= vfnorm;
-      for(i = 0; i < DIM; i++)
-	{
-	  /* was (10/18/00):
-	  v1[i] -= tmp1 * v0[i];
-	  */
-	  v2[i] -= tmp1 * v0[i];
-	  /*
-	  if(print)
-	    printf( "Setting v2[%d] = %g\n", i, v2[i]);
-	  */
-	}
-      normalize_really_simple_vector(v2, DIM);
+	eigenvalues[i] = z[i];
+      qtensor_eigenvector(R, 0, v0);
+      qtensor_eigenvector(R, 2, v2);
       for(i = 0; i < DIM; i++)
 	for(j = 0; j < DIM; j++)
 	  for(k = 0; k < DIM; k++)
@@ -901,9 +901,10 @@ solve_3x3(double a[DIM][DIM], double b[DIM], double x[DIM])
   return 0;
 }
 
-int
-bulk_side_id_and_stu(const int bulk_elem, const int shell_elem,
-                     const double xi[DIM], double xi2[DIM], const Exo_DB *exo)
+static int
+match_bulk_side_and_stu(const int bulk_elem, const int shell_elem,
+			const double xi[DIM], double xi2[DIM],
+			const Exo_DB *exo)
      /*
       * Determines which bulk element nodes are shared with the shell element,
       * then deduces the corresponding bulk side ID and converts the shell
@@ -1313,6 +1314,110 @@ bulk_side_id_and_stu(const int bulk_elem, const int shell_elem,
   return id;
 }
 
+/*
+ * The bulk stu from match_bulk_side_and_stu() are an affine function of
+ * the shell stu fixed by the connectivity of the two elements, so each
+ * bulk/shell pair gets its side and that map once, kept in a table
+ * hashed on the pair, and later points are a look-up and a product.
+ */
+struct shell_bulk_map {
+  int bulk;			/* -1 marks an empty slot */
+  int shell;
+  int id;			/* bulk side id */
+  int set[DIM];			/* bulk stu components the side sets */
+  double a[DIM][DIM];		/* xi2 = a xi + c */
+  double c[DIM];
+};
+
+#define UNSET_STU 1.0e30
+
+static struct shell_bulk_map *Shell_Bulk_Map = NULL;
+static int Shell_Bulk_Map_Size = 0;	/* slots, a power of two */
+static int Shell_Bulk_Map_Used = 0;
+
+static int
+shell_bulk_slot(const struct shell_bulk_map *table, const int size,
+		const int bulk_elem, const int shell_elem)
+{
+  unsigned int h;
+  int k;
+
+  h = (unsigned int) bulk_elem * 2654435761u ^ (unsigned int) shell_elem;
+  k = (int) (h & (unsigned int) (size - 1));
+  while (table[k].bulk != -1 &&
+	 (table[k].bulk != bulk_elem || table[k].shell != shell_elem)) {
+    k = (k + 1) & (size - 1);
+  }
+  return k;
+}
+
+static void
+shell_bulk_map_grow(void)
+{
+  struct shell_bulk_map *old = Shell_Bulk_Map;
+  int old_size = Shell_Bulk_Map_Size;
+  int i, k;
+
+  Shell_Bulk_Map_Size = (old_size > 0) ? 2 * old_size : 1024;
+  Shell_Bulk_Map = (struct shell_bulk_map *)
+    smalloc(Shell_Bulk_Map_Size * sizeof(struct shell_bulk_map));
+  for (i = 0; i < Shell_Bulk_Map_Size; i++) Shell_Bulk_Map[i].bulk = -1;
+  for (i = 0; i < old_size; i++) {
+    if (old[i].bulk == -1) continue;
+    k = shell_bulk_slot(Shell_Bulk_Map, Shell_Bulk_Map_Size,
+			old[i].bulk, old[i].shell);
+    Shell_Bulk_Map[k] = old[i];
+  }
+  safe_free((void *) old);
+}
+
+int
+bulk_side_id_and_stu(const int bulk_elem, const int shell_elem,
+                     const double xi[DIM], double xi2[DIM], const Exo_DB *exo)
+     /*
+      * Bulk side id shared with the shell element and the bulk stu
+      * coordinates of shell stu point xi, see match_bulk_side_and_stu().
+      * Components of xi2 the side does not set are left as they are.
+      */
+{
+  struct shell_bulk_map *m;
+  double probe[DIM], at[DIM+1][DIM];
+  int i, j, k;
+
+  if (2 * (Shell_Bulk_Map_Used + 1) > Shell_Bulk_Map_Size) shell_bulk_map_grow();
+
+  k = shell_bulk_slot(Shell_Bulk_Map, Shell_Bulk_Map_Size, bulk_elem, shell_elem);
+  m = Shell_Bulk_Map + k;
+
+  if (m->bulk == -1) {
+    /* the map at the origin and at each unit stu gives c and a */
+    for (j = 0; j <= DIM; j++) {
+      for (i = 0; i < DIM; i++) {
+	probe[i] = (i == j - 1) ? 1.0 : 0.0;
+	at[j][i] = UNSET_STU;
+      }
+      m->id = match_bulk_side_and_stu(bulk_elem, shell_elem, probe, at[j], exo);
+    }
+    for (i = 0; i < DIM; i++) {
+      m->set[i] = (at[0][i] != UNSET_STU);
+      m->c[i] = at[0][i];
+      for (j = 0; j < DIM; j++) m->a[i][j] = at[j+1][i] - at[0][i];
+    }
+    m->bulk = bulk_elem;
+    m->shell = shell_elem;
+    Shell_Bulk_Map_Used++;
+  }
+
+  if (m->id == -1) return -1;
+
+  for (i = 0; i < DIM; i++) {
+    if (!m->set[i]) continue;
+    xi2[i] = m->c[i];
+    for (j = 0; j < DIM; j++) xi2[i] += m->a[i][j] * xi[j];
+  }
+  return m->id;
+}
+
 /****************************************************************************************
  * load_neighbor_var_data:
  *
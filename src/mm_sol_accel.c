@@ -0,0 +1,355 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * Acceleration of modified Newton steps (Newton Acceleration card).
+ *
+ * While solve_nonlinear_problem() reuses a factored Jacobian J0, each
+ * linear solve returns d_k = J0^-1 R(x_k) and the iteration converges only
+ * linearly.  Both methods here improve d_k using nothing but the iterates
+ * and the solves already done, so the one factorization is all they cost:
+ *
+ *  broyden  - Good Broyden.  H_k, the k-th Broyden approximation of
+ *             J^-1, is kept as J0^-1 plus k rank one terms, in the form
+ *             that needs no transposes:
+ *                H_j+1 z = H_j z + (s_j - w_j) (s_j.H_j z) / (s_j.w_j),
+ *             with s_j = x_j+1 - x_j the step actually taken (so damping
+ *             is accounted for) and w_j = H_j (R_j+1 - R_j).  The update
+ *             returned is H_k R(x_k).  When m steps are stored, the
+ *             history restarts from J0.
+ *
+ *  anderson - Anderson mixing of the fixed point map x - J0^-1 R(x) over
+ *             the last m steps (Walker and Ni, SIAM J. Numer. Anal. 49
+ *             (2011) 1715-1735).
+ *
+ * A reformed Jacobian starts a new history.  All dot products are over
+ * the unknowns owned by each processor, summed over the processors.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "std.h"
+#include "rf_fem_const.h"
+#include "rf_io_const.h"
+#include "rf_io.h"
+#include "rf_mp.h"
+#include "rf_solver_const.h"
+#include "rf_solver.h"
+#include "mm_eh.h"
+
+#define _MM_SOL_ACCEL_C
+#include "goma.h"
+
+static int     Accel_Depth = 0;	/* m, the vectors allocated below */
+static int     Accel_Count = 0;	/* history pairs now stored */
+static int     Accel_Next  = 0;	/* anderson: slot replaced next */
+static int     Accel_Have_Prev = FALSE; /* x_prev etc. are set */
+static double  **Accel_S = NULL; /* [m] steps s_j (anderson: dx_j) */
+static double  **Accel_W = NULL; /* [m] w_j (anderson: df_j) */
+static double  *Accel_SW = NULL; /* [m] broyden: s_j.w_j */
+static double  *Accel_X_Prev = NULL; /* x_k-1 */
+static double  *Accel_D_Prev = NULL; /* broyden: H_k-1 R_k-1, anderson: d_k-1 */
+static double  *Accel_D_Raw = NULL; /* broyden: J0^-1 R_k, for a restart */
+
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
+static void
+accel_gsum(double *v, const int n)
+{
+#ifdef PARALLEL
+  int i;
+  double local[MAX_NEWTON_ACCEL_DEPTH*(MAX_NEWTON_ACCEL_DEPTH+1)];
+
+  if (Num_Proc == 1) return;
+  for (i = 0; i < n; i++) local[i] = v[i];
+  MPI_Allreduce(local, v, n, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+#endif
+}
+
+static double
+accel_dot(const double *a, const double *b, const int nloc)
+{
+  int i;
+  double sum = 0.;
+
+  for (i = 0; i < nloc; i++) sum += a[i] * b[i];
+  accel_gsum(&sum, 1);
+  return sum;
+}
+
+/*
+ * Solve the small symmetric system g y = b (g is n x n, row major) by
+ * Gaussian elimination with partial pivoting.  Return -1 if it is
+ * singular to working precision.
+ */
+
+static int
+accel_solve_small(double *g, double *b, const int n)
+{
+  int i, j, k, p;
+  double t, big;
+
+  big = 0.;
+  for (i = 0; i < n; i++) big = MAX(big, fabs(g[i*n+i]));
+  if (big <= 0.) return -1;
+
+  for (k = 0; k < n; k++) {
+    p = k;
+    for (i = k+1; i < n; i++) if (fabs(g[i*n+k]) > fabs(g[p*n+k])) p = i;
+    if (fabs(g[p*n+k]) <= 1.e-14 * big) return -1;
+    if (p != k) {
+      for (j = 0; j < n; j++) {
+	t = g[k*n+j]; g[k*n+j] = g[p*n+j]; g[p*n+j] = t;
+      }
+      t = b[k]; b[k] = b[p]; b[p] = t;
+    }
+    for (i = k+1; i < n; i++) {
+      t = g[i*n+k] / g[k*n+k];
+      for (j = k; j < n; j++) g[i*n+j] -= t * g[k*n+j];
+      b[i] -= t * b[k];
+    }
+  }
+  for (k = n-1; k >= 0; k--) {
+    for (j = k+1; j < n; j++) b[k] -= g[k*n+j] * b[j];
+    b[k] /= g[k*n+k];
+  }
+  return 0;
+}
+
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
+void
+newton_accel_begin(const int nloc)
+
+    /*************************************************************************
+     *
+     * newton_accel_begin():
+     *
+     *  Allocate the history for one call of solve_nonlinear_problem().
+     *  Does nothing unless a Newton Acceleration was asked for.
+     *************************************************************************/
+{
+  int j;
+
+  newton_accel_end();
+  if (Newton_Accel == NEWTON_ACCEL_NONE) return;
+
+  Accel_Depth = Newton_Accel_Depth;
+  Accel_S  = (double **) smalloc(Accel_Depth * sizeof(double *));
+  Accel_W  = (double **) smalloc(Accel_Depth * sizeof(double *));
+  Accel_SW = (double *)  smalloc(Accel_Depth * sizeof(double));
+  for (j = 0; j < Accel_Depth; j++) {
+    Accel_S[j] = (double *) smalloc(MAX(nloc, 1) * sizeof(double));
+    Accel_W[j] = (double *) smalloc(MAX(nloc, 1) * sizeof(double));
+  }
+  Accel_X_Prev = (double *) smalloc(MAX(nloc, 1) * sizeof(double));
+  Accel_D_Prev = (double *) smalloc(MAX(nloc, 1) * sizeof(double));
+  Accel_D_Raw  = (double *) smalloc(MAX(nloc, 1) * sizeof(double));
+}
+
+/*****************************************************************************/
+
+void
+newton_accel_end(void)
+{
+  int j;
+
+  for (j = 0; j < Accel_Depth; j++) {
+    safer_free((void **) &Accel_S[j]);
+    safer_free((void **) &Accel_W[j]);
+  }
+  safer_free((void **) &Accel_S);
+  safer_free((void **) &Accel_W);
+  safer_free((void **) &Accel_SW);
+  safer_free((void **) &Accel_X_Prev);
+  safer_free((void **) &Accel_D_Prev);
+  safer_free((void **) &Accel_D_Raw);
+  Accel_Depth = 0;
+  Accel_Count = 0;
+  Accel_Next  = 0;
+  Accel_Have_Prev = FALSE;
+}
+
+/*****************************************************************************/
+
+static void
+broyden_step(double *x, double *delta_x, const int nloc)
+{
+  int i, j;
+  double *s, *w, sw, c;
+  static char yo[] = "broyden_step";
+
+  if (Accel_Count == Accel_Depth) {
+    /* take this step as it comes, and let it begin the new history */
+    log_msg("Broyden history full (%d), restarting from J0", Accel_Depth);
+    Accel_Count = 0;
+    for (i = 0; i < nloc; i++) Accel_X_Prev[i] = x[i];
+    for (i = 0; i < nloc; i++) Accel_D_Prev[i] = delta_x[i];
+    return;
+  }
+
+  for (i = 0; i < nloc; i++) Accel_D_Raw[i] = delta_x[i];
+
+  /* delta_x <- H_k-1 R_k */
+  for (j = 0; j < Accel_Count; j++) {
+    c = accel_dot(Accel_S[j], delta_x, nloc) / Accel_SW[j];
+    for (i = 0; i < nloc; i++) delta_x[i] += c * (Accel_S[j][i] - Accel_W[j][i]);
+  }
+
+  s = Accel_S[Accel_Count];
+  w = Accel_W[Accel_Count];
+  for (i = 0; i < nloc; i++) {
+    s[i] = x[i] - Accel_X_Prev[i];
+    w[i] = delta_x[i] - Accel_D_Prev[i];
+  }
+  sw = accel_dot(s, w, nloc);
+
+  if (fabs(sw) <= 1.e-12 * sqrt(accel_dot(s, s, nloc) * accel_dot(w, w, nloc))) {
+    /* keep H_k-1 R_k as this step; the new history starts from J0^-1 R_k */
+    log_msg("Broyden update singular, restarting from J0");
+    Accel_Count = 0;
+    for (i = 0; i < nloc; i++) Accel_X_Prev[i] = x[i];
+    for (i = 0; i < nloc; i++) Accel_D_Prev[i] = Accel_D_Raw[i];
+    return;
+  }
+
+  /* delta_x <- H_k R_k */
+  c = accel_dot(s, delta_x, nloc) / sw;
+  for (i = 0; i < nloc; i++) delta_x[i] += c * (s[i] - w[i]);
+  Accel_SW[Accel_Count++] = sw;
+
+  for (i = 0; i < nloc; i++) Accel_X_Prev[i] = x[i];
+  for (i = 0; i < nloc; i++) Accel_D_Prev[i] = delta_x[i];
+
+  log_msg("Broyden update with %d pairs", Accel_Count);
+}
+
+/*****************************************************************************/
+
+static void
+anderson_step(double *x, double *delta_x, const int nloc)
+{
+  int i, j, k, n, slot;
+  double *dx, *df;
+  double g[MAX_NEWTON_ACCEL_DEPTH*MAX_NEWTON_ACCEL_DEPTH];
+  double b[MAX_NEWTON_ACCEL_DEPTH];
+  double sums[MAX_NEWTON_ACCEL_DEPTH*(MAX_NEWTON_ACCEL_DEPTH+1)];
+  double trace;
+  static char yo[] = "anderson_step";
+
+  /*
+   * With f = -d, the fixed point residual, the newest differences are
+   * dx = x_k - x_k-1 and df = f_k - f_k-1 = d_k-1 - d_k.
+   */
+  slot = Accel_Next;
+  dx = Accel_S[slot];
+  df = Accel_W[slot];
+  for (i = 0; i < nloc; i++) {
+    dx[i] = x[i] - Accel_X_Prev[i];
+    df[i] = Accel_D_Prev[i] - delta_x[i];
+  }
+  Accel_Next = (Accel_Next + 1) % Accel_Depth;
+  if (Accel_Count < Accel_Depth) Accel_Count++;
+
+  for (i = 0; i < nloc; i++) Accel_X_Prev[i] = x[i];
+  for (i = 0; i < nloc; i++) Accel_D_Prev[i] = delta_x[i];
+
+  /*
+   * min || f_k - DF gamma ||: the normal equations, all their sums in
+   * a single reduction.
+   */
+  n = Accel_Count;
+  for (j = 0; j < n; j++) {
+    for (k = 0; k <= j; k++) {
+      sums[j*(j+1)/2 + k] = 0.;
+      for (i = 0; i < nloc; i++) sums[j*(j+1)/2 + k] += Accel_W[j][i] * Accel_W[k][i];
+    }
+  }
+  for (j = 0; j < n; j++) {
+    sums[n*(n+1)/2 + j] = 0.;
+    for (i = 0; i < nloc; i++) sums[n*(n+1)/2 + j] -= Accel_W[j][i] * delta_x[i];
+  }
+  accel_gsum(sums, n*(n+1)/2 + n);
+
+  trace = 0.;
+  for (j = 0; j < n; j++) {
+    for (k = 0; k <= j; k++) {
+      g[j*n+k] = g[k*n+j] = sums[j*(j+1)/2 + k];
+    }
+    b[j] = sums[n*(n+1)/2 + j];
+    trace += g[j*n+j];
+  }
+  /* a little regularization keeps nearly dependent differences harmless */
+  for (j = 0; j < n; j++) g[j*n+j] += 1.e-10 * trace / n;
+
+  if (accel_solve_small(g, b, n) != 0) {
+    log_msg("Anderson least squares singular, taking the plain step");
+    Accel_Count = 0;
+    Accel_Next  = 0;
+    return;
+  }
+
+  /* x_k+1 = x_k + f_k - (DX + DF) gamma, so d <- d + (DX + DF) gamma */
+  for (j = 0; j < n; j++) {
+    for (i = 0; i < nloc; i++) {
+      delta_x[i] += b[j] * (Accel_S[j][i] + Accel_W[j][i]);
+    }
+  }
+
+  log_msg("Anderson mixing over %d steps", n);
+}
+
+/*****************************************************************************/
+
+void
+newton_accel_step(double x[], double delta_x[], const int nloc,
+		  const int reused)
+
+    /*************************************************************************
+     *
+     * newton_accel_step():
+     *
+     *  Called once per Newton step, after the linear solve and before x
+     *  is updated.  If J0 was reused, replace delta_x = J0^-1 R by the
+     *  accelerated update; if it was reformed, delta_x is a Newton step
+     *  and begins a new history.
+     *************************************************************************/
+{
+  int i;
+
+  if (Accel_Depth == 0) return;
+
+  if (reused && Accel_Have_Prev) {
+    if (Newton_Accel == NEWTON_ACCEL_BROYDEN) {
+      broyden_step(x, delta_x, nloc);
+    } else {
+      anderson_step(x, delta_x, nloc);
+    }
+    return;
+  }
+
+  Accel_Count = 0;
+  Accel_Next  = 0;
+  for (i = 0; i < nloc; i++) Accel_X_Prev[i] = x[i];
+  for (i = 0; i < nloc; i++) Accel_D_Prev[i] = delta_x[i];
+  Accel_Have_Prev = TRUE;
+}
+/*****************************************************************************/
+/* END of file mm_sol_accel.c */
+/*****************************************************************************/
@@ -68,6 +68,19 @@ static char rcsid[] =
 
 static int first_linear_solver_call=TRUE;
 
+/*
+ * State of the adaptive Jacobian reuse policy (Jacobian Reuse = adaptive
+ * or constant).
+ * It outlives one call of solve_nonlinear_problem() so that a factored
+ * Jacobian can be carried from one time step into the next.
+ */
+
+static int    Jac_Reuse_Valid = FALSE;	/* a factored Jacobian is on hand */
+static int    Jac_Reuse_Age   = 0;	/* linear solves it has been used for */
+static double Jac_Reuse_Dt    = 0.;	/* delta_t it was formed with */
+static double Jac_Reuse_Omega = 0.;	/* Acoustic Frequency it was formed with */
+static double Jac_Reuse_Theta = 0.;	/* theta it was formed with */
+
 
 /*
  * Default: do not attempt to use Harwell MA28 linear solver. Kundert's is
@@ -101,6 +114,143 @@ static int first_linear_solver_call=TRUE;
 extern int continuation_hook
 PROTO((double *, double *, void *, double, double));
 
+static double newton_forcing_term /* mm_sol_nonlinear.c                       */
+PROTO((const int ,		/* inewton - Newton iteration                */
+       const double ,		/* res_norm - ||F|| now                      */
+       const double ,		/* res_norm_old - ||F|| one step back        */
+       const double ,		/* lin_rel_resid - achieved by last solve    */
+       const double ,		/* eta_old - last forcing term               */
+       const double ));		/* eta_min - Residual Ratio Tolerance        */
+
+static int jacobian_reuse_keep	/* mm_sol_nonlinear.c                        */
+PROTO((const int ,		/* inewton - Newton iteration                */
+       const double ,		/* rate - ||F_k|| / ||F_k-1||, <0 if unknown  */
+       const double ,		/* delta_t - current time step size          */
+       const double ));		/* theta - current time integration parameter */
+
+static double line_search_merit	/* mm_sol_nonlinear.c                        */
+PROTO((struct Aztec_Linear_Solver_System *,
+       double [],		/* x - trial solution vector                 */
+       double [],		/* res - residual out (scratch)              */
+       double [],		/* x_old                                     */
+       double [],		/* x_older                                   */
+       double [],		/* xdot - trial xdot                         */
+       double [],		/* xdot_old                                  */
+       double [],		/* x_update                                  */
+       double *,		/* delta_t                                   */
+       double *,		/* theta                                     */
+       double *,		/* time_value                                */
+       double [],		/* scale - row scaling of the Jacobian       */
+       Exo_DB *,		/* exo                                       */
+       Dpi *,			/* dpi                                       */
+       int *,			/* num_total_nodes                           */
+       dbl *,			/* h_elem_avg                                */
+       dbl *));			/* U_norm                                    */
+
+static void jfnk_solve		/* mm_sol_nonlinear.c                        */
+PROTO((struct Aztec_Linear_Solver_System *,
+       double [],		/* delta_x - Newton update (out)             */
+       double [],		/* resid_vector - scaled residual at x       */
+       double [],		/* x                                         */
+       double [],		/* x_old                                     */
+       double [],		/* x_older                                   */
+       double [],		/* xdot                                      */
+       double [],		/* xdot_old                                  */
+       double [],		/* x_update                                  */
+       double *,		/* delta_t                                   */
+       double *,		/* theta                                     */
+       double *,		/* time_value                                */
+       double [],		/* scale - row scaling of the Jacobian       */
+       double [],		/* work - 3*numProcUnknowns scratch          */
+       Exo_DB *,		/* exo                                       */
+       Dpi *,			/* dpi                                       */
+       int *,			/* num_total_nodes                           */
+       dbl *,			/* h_elem_avg                                */
+       dbl *,			/* U_norm                                    */
+       Comm_Ex *));		/* cx                                        */
+
+static void gstatus_add_norms	/* mm_sol_nonlinear.c                        */
+PROTO((double *,		/* vector                                    */
+       double *,		/* vecscal - NULL for unscaled norms         */
+       int ,			/* nloc                                      */
+       int [3],			/* slot - for the L_1, L_2 and L_oo values   */
+       int *));			/* loc - (out) local position of the L_oo    */
+
+static double gstatus_get_loo	/* mm_sol_nonlinear.c                        */
+PROTO((const int [3],		/* slot - from gstatus_add_norms()           */
+       const int ,		/* loc - from gstatus_add_norms()            */
+       int *,			/* num_unk - as Loo_norm() has it            */
+       char *));		/* dofname - as Loo_norm() has it            */
+
+/*
+ * One parameter sensitivity to compute, for soln_sens_multi().
+ */
+struct sens_param
+{
+  double value;			/* the parameter, unperturbed */
+  int vector_id;		/* x_sens_p[] vector it goes to */
+  int type, id, flt, flt2;	/* which parameter (sens_type etc.) */
+};
+
+static int sens_rhs		/* mm_sol_nonlinear.c                        */
+PROTO((double ,			/* lambda - parameter                        */
+       double [],		/* x - soln vector                           */
+       double [],		/* xdot                                      */
+       double ,			/* delta_s - step                            */
+       Exo_DB *,		/* exo                                       */
+       Dpi *,			/* dpi                                       */
+       Comm_Ex *,		/* cx                                        */
+       double [],		/* res_p - scratch                           */
+       double [],		/* res_m - scratch                           */
+       int ,			/* numProcUnknowns                           */
+       double [],		/* x_old                                     */
+       double [],		/* x_older                                   */
+       double [],		/* xdot_old                                  */
+       double [],		/* x_update                                  */
+       double ,			/* delta_t                                   */
+       double ,			/* theta                                     */
+       double ,			/* time_value                                */
+       int ,			/* num_total_nodes                           */
+       struct Aztec_Linear_Solver_System *, /* ams                           */
+       int ,			/* vector_id - -1 for the continuation one   */
+       int ,			/* sens_type                                 */
+       int ,			/* sens_id                                   */
+       int ,			/* sens_flt                                  */
+       int ,			/* sens_flt2                                 */
+       double *,		/* h_elem_avg                                */
+       double *,		/* U_norm                                    */
+       double []));		/* resid_vector_sens - (out) dR/dp           */
+
+static int soln_sens_batched	/* mm_sol_nonlinear.c                        */
+PROTO((int ));			/* nsens - number of sensitivities           */
+
+static int soln_sens_multi	/* mm_sol_nonlinear.c                        */
+PROTO((struct sens_param *,	/* sp - the sensitivities                    */
+       int ,			/* nsens                                     */
+       double [],		/* x - soln vector                           */
+       double [],		/* xdot                                      */
+       Exo_DB *,		/* exo                                       */
+       Dpi *,			/* dpi                                       */
+       Comm_Ex *,		/* cx                                        */
+       double [],		/* res_p - scratch                           */
+       double [],		/* res_m - scratch                           */
+       int ,			/* numProcUnknowns                           */
+       double [],		/* x_old                                     */
+       double [],		/* x_older                                   */
+       double [],		/* xdot_old                                  */
+       double [],		/* x_update                                  */
+       double ,			/* delta_t                                   */
+       double ,			/* theta                                     */
+       double ,			/* time_value                                */
+       int ,			/* num_total_nodes                           */
+       double [],		/* x_sens - (out) the last sensitivity       */
+       double **,		/* x_sens_p - (out) all of them              */
+       double [],		/* scale                                     */
+       struct Aztec_Linear_Solver_System *, /* ams                           */
+       double *,		/* h_elem_avg                                */
+       double *,		/* U_norm                                    */
+       char []));		/* calling purpose                           */
+
 static int soln_sens		/* mm_sol_nonlinear.c                        */
 PROTO((double ,			/* lambda - parameter                        */
        double [],		/* x - soln vector                           */
@@ -277,7 +427,7 @@ int solve_nonlinear_problem(struct Aztec_Linear_Solver_System *ams,
 				  * sees (internal+boundary+external) but no
 				  * more. */
 
-  int           GNumUnknowns;		/* Global number of unknowns in the */
+  goma_gid      GNumUnknowns;		/* Global number of unknowns in the */
 					/* system    */
   int 		inewton;		/* Newton iteration counter */
 
@@ -316,9 +466,14 @@ int solve_nonlinear_problem(struct Aztec_Linear_Solver_System *ams,
   int           Norm_below_tolerance;    /* Boolean for modified newton test*/
   int           Rate_above_tolerance;    /* Boolean for modified newton test*/
   int           step_reform;             /* counter for Jacobian reformation */
+  int           reuse_reforms = 0;       /* adaptive reuse: Jacobians formed */
+  int           reuse_kept = 0;          /* adaptive reuse: Jacobians reused */
 
   double Reltol = 1.0e-2, Abstol = 1.0e-6;  /* LOCA convergence criteria */
   int continuation_converged = TRUE;
+  int fuse_pp = FALSE;		/* this assembly accumulates the post processing */
+  int jac_formed = TRUE;	/* this iteration assembled the Jacobian */
+  dbl wall_start = 0., asm_wall = 0., slv_wall = -1.;	/* Performance Log */
   int num_total_nodes = dpi->num_universe_nodes;
 				/* Number of nodes that each processor is
 				 * responsible for                           */
@@ -343,6 +498,44 @@ int solve_nonlinear_problem(struct Aztec_Linear_Solver_System *ams,
 
   int error, why;
   int num_unk_r, num_unk_x; 
+  int norm_slot[3], norm_r_slot[3];
+  int loo_loc, loo_r_loc;
+
+  /*
+   * Newton Forcing Term: the linear tolerance of each Newton step
+   */
+  int    forcing_active;
+  int    forcing_its = 0;	/* linear iterations this Newton solve */
+  double forcing_eta = 0.;
+  double forcing_tol_base = 0.;	/* the Residual Ratio Tolerance */
+  double forcing_res_old = 0.;
+  double forcing_lin_rel = -1.;
+  double forcing_saved = 0.;	/* estimate of linear iterations saved */
+
+  /*
+   * Newton Line Search: backtrack along the Newton update
+   */
+  int    line_search_active;
+  int    lsearch_back;		/* backtracks in this Newton step */
+  int    lsearch_total = 0;	/* backtracks in this Newton solve */
+  double lsearch_lambda, lsearch_new, lsearch_merit, lsearch_merit0;
+  double *lsearch_dx = NULL, *lsearch_dxdot = NULL, *lsearch_res = NULL;
+
+  /*
+   * Matrix-Free Newton: difference residuals for J*v on reuse steps
+   */
+  int    jfnk_active;
+  int    precond_simple;	/* assembled matrix is a Preconditioner Matrix */
+  double *jfnk_work = NULL;
+
+  /*
+   * Mesh Segregation: alternating flow and mesh Newton solves
+   */
+  int    mesh_seg;
+  int    seg_phase;		/* MESH_SEG_FLOW or _MESH while mesh_seg */
+  int    seg_reform;		/* the Jacobian on hand is the other phase's */
+  double seg_move = 0.;		/* mesh correction of this mesh solve */
+  static int seg_warned = FALSE;
 
   char dofname_r[80];
   char dofname_nr[80];
@@ -383,13 +576,14 @@ int solve_nonlinear_problem(struct Aztec_Linear_Solver_System *ams,
 				 * are owned by this processor */
   int local_nnz_plus;		/* and if the external rows are included */
 
-  int global_order;		/* order of the global system */
-  int global_order_plus;	/* and if the external rows are overincluded */
-  int global_nnz;		/* a sum of the number of nonzero matrix 
+  goma_gid global_order;	/* order of the global system */
+  goma_gid global_order_plus; /* and if the external rows are overincluded */
+  goma_gid global_nnz;		/* a sum of the number of nonzero matrix 
 				 * entries owned by each processor */
-  int global_nnz_plus;		/* a sum that overincludes the external rows */
+  goma_gid global_nnz_plus; /* a sum that overincludes the external rows */
 
   char		stringer[80];	/* holding format of num linear solve itns */
+  int		refine_steps = -1; /* Direct Solve Refinement solves */
   char		stringer_AC[80];/* holding format of num AC linear solve itns */
 
   dbl		a_start;	/* mark start of assembly */
@@ -421,6 +615,7 @@ int solve_nonlinear_problem(struct Aztec_Linear_Solver_System *ams,
   double slv_time;
 
   int           iAC, jAC;
+  int           ac_block;		/* all the AC solves in one call */
   int           num_unk_g, num_unk_y;
   dbl           *res_p, *res_m;
   dbl           *gAC, *hAC, *tAC, *yAC;
@@ -450,10 +645,14 @@ int solve_nonlinear_problem(struct Aztec_Linear_Solver_System *ams,
 
   double param_val;
   int sens_vec_ct;
+  int nsens;			/* new flux and data sensitivity vectors */
+  struct sens_param *sens = NULL;
   char sens_caller[40];    /* string containing caller of soln_sens */
 
   int	linear_solver_blk;	/* count calls to AZ_solve() */
   int	linear_solver_itns;	/* count cumulative linearsolver iterations */
+  int	fallback_chain;		/* Linear Solver Fallback on this solve */
+  int	fallback_direct;	/* ... and its level solved it directly */
   int   total_ls_its = 0;       /* linear solver iteration counter */
   int	num_linear_solve_blks;	/* one pass for now */
   int	matrix_solved;		/* boolean */
@@ -483,6 +682,15 @@ int solve_nonlinear_problem(struct Aztec_Linear_Solver_System *ams,
   return_value = 0;		/* Set the return value to failure
 				 * until convergence is achieved */
 
+  /*
+   * Reduced Order Model = solve: Newton in the POD basis instead
+   */
+  if (Reduced_Order_Model == ROM_SOLVE && nAC == 0 && con_ptr == NULL)
+    {
+      return (rom_solve(ams, x, delta_t, theta, x_old, x_older, xdot, xdot_old,
+			resid_vector, x_update, converged, time_value, exo, dpi, cx));
+    }
+
   /*
    * INITIALIZE
    */
@@ -528,8 +736,9 @@ int solve_nonlinear_problem(struct Aztec_Linear_Solver_System *ams,
   if (Debug_Flag) {
     DPRINTF(stderr, "%s: NumUnknowns  = %d\n", yo, NumUnknowns);
     DPRINTF(stderr, "%s: NZeros       = %d\n", yo, NZeros);
-    DPRINTF(stderr, "%s: GNZeros      = %d\n", yo, GNZeros);
-    DPRINTF(stderr, "%s: GNumUnknowns = %d\n", yo, GNumUnknowns);
+    DPRINTF(stderr, "%s: GNZeros      = %lld\n", yo, (long long) GNZeros);
+    DPRINTF(stderr, "%s: GNumUnknowns = %lld\n", yo,
+	    (long long) GNumUnknowns);
   }      
 
   /*
@@ -538,8 +747,9 @@ int solve_nonlinear_problem(struct Aztec_Linear_Solver_System *ams,
 #ifdef DEBUG
   fprintf(stderr, "P_%d: lo=%d, lo+=%d, lnnz=%d, lnnz+=%d\n", ProcID,
 	  local_order, local_order_plus, local_nnz, local_nnz_plus);
-  fprintf(stderr, "P_%d: go=%d, go+=%d, gnnz=%d, gnnz+=%d\n", ProcID,
-	  global_order, global_order_plus, global_nnz, global_nnz_plus);
+  fprintf(stderr, "P_%d: go=%lld, go+=%lld, gnnz=%lld, gnnz+=%lld\n", ProcID,
+	  (long long) global_order, (long long) global_order_plus,
+	  (long long) global_nnz, (long long) global_nnz_plus);
 #endif /* DEBUG */
 	}
 
@@ -587,6 +797,76 @@ int solve_nonlinear_problem(struct Aztec_Linear_Solver_System *ams,
   inewton    = 0;
   if(Max_Newton_Steps <= 0) *converged = TRUE;
 
+  forcing_active = ( Newton_Forcing != NEWTON_FORCING_NONE &&
+		     ( Linear_Solver == AZTEC || Linear_Solver == AZTECOO ||
+		       Linear_Solver == STRATIMIKOS ) );
+  forcing_tol_base = ams->params[AZ_tol];
+
+  /* the Schur complement and LOCA bordering rework delta_x themselves */
+  if (nAC == 0 && con_ptr == NULL) newton_accel_begin(NumUnknowns);
+
+  /*
+   * The line search moves x and xdot back along the update; unknowns that
+   * are updated by other means (augmenting conditions, LOCA, XFEM fixups,
+   * slaved level sets, Newmark-beta solids) would fall out of step.
+   */
+  line_search_active = ( Newton_Line_Search == NEWTON_LINE_SEARCH_ARMIJO &&
+			 Linear_Solver != FRONT && nAC == 0 && con_ptr == NULL &&
+			 xfem == NULL && pfd == NULL &&
+			 (TimeIntegration == STEADY || !tran->solid_inertia) &&
+			 !(ls != NULL && ls->Evolution == LS_EVOLVE_SLAVE) );
+  if (line_search_active) {
+    asdv(&lsearch_dx, numProcUnknowns);
+    asdv(&lsearch_dxdot, numProcUnknowns);
+    asdv(&lsearch_res, numProcUnknowns);
+  }
+
+  /*
+   * Matrix-Free Newton: while a Jacobian is being reused, Aztec iterates
+   * on the true Jacobian, applied by differencing residuals, with the
+   * reused matrix only as the preconditioner. The same restrictions as
+   * the line search apply, as both evaluate trial residuals.
+   */
+  jfnk_active = ( Matrix_Free_Newton && Linear_Solver == AZTEC &&
+		  strcmp(Matrix_Format, "msr") == 0 && nAC == 0 &&
+		  con_ptr == NULL && xfem == NULL && pfd == NULL &&
+		  (TimeIntegration == STEADY || !tran->solid_inertia) &&
+		  !(ls != NULL && ls->Evolution == LS_EVOLVE_SLAVE) );
+  if (jfnk_active) {
+    asdv(&jfnk_work, 3 * numProcUnknowns);
+  }
+
+  /*
+   * Preconditioner Matrix: then every Aztec solve is matrix-free, as the
+   * assembled matrix is no longer the Jacobian. Sensitivities and
+   * continuation need the Jacobian itself, so not with those.
+   */
+  precond_simple = ( jfnk_active && Precond_Matrix != PRECOND_MATRIX_EXACT &&
+		     Continuation == ALC_NONE &&
+		     nn_post_fluxes_sens == 0 && nn_post_data_sens == 0 );
+
+  /*
+   * Mesh Segregation: the flow is first solved on the mesh as it is, the
+   * mesh then for that flow, and so on until a mesh solve moves the mesh
+   * by less than the coupling tolerance. For ALE pseudo-solid meshes
+   * only, and not where the Jacobian itself is wanted afterwards.
+   */
+  mesh_seg = ( Mesh_Segregation_Tol > 0. && Num_Var_In_Type[MESH_DISPLACEMENT1] &&
+	       Linear_Solver != FRONT && strcmp(Matrix_Format, "msr") == 0 &&
+	       nAC == 0 && Continuation == ALC_NONE && !jfnk_active &&
+	       nn_post_fluxes_sens == 0 && nn_post_data_sens == 0 );
+  for (i = 0; mesh_seg && i < upd->Num_Mat; i++) {
+    if (pd_glob[i]->e[R_MESH1] && cr_glob[i]->MeshMotion != ARBITRARY) {
+      mesh_seg = FALSE;
+    }
+  }
+  if (Mesh_Segregation_Tol > 0. && !mesh_seg && !seg_warned) {
+    WH(-1, "Mesh Segregation needs ARBITRARY mesh motion, msr, and no ACs, continuation or sensitivities");
+    seg_warned = TRUE;
+  }
+  seg_phase  = mesh_seg ? MESH_SEG_FLOW : MESH_SEG_OFF;
+  seg_reform = mesh_seg;
+
   if (Linear_Solver == FRONT) {
     init_vec_value(scale, 1.0, numProcUnknowns);
   }
@@ -625,6 +905,13 @@ int solve_nonlinear_problem(struct Aztec_Linear_Solver_System *ams,
       Rate_above_tolerance = FALSE;
     }
 
+  if (Jacobian_Reuse != JACOBIAN_REUSE_FIXED)
+    {
+      Norm_below_tolerance = jacobian_reuse_keep(0, -1., delta_t, theta);
+      Rate_above_tolerance = Norm_below_tolerance;
+      if (!Norm_below_tolerance) init_vec_value(scale, 1.0, numProcUnknowns);
+    }
+
   Norm_old             = 1.e+30;
   Norm_new             = 1.e+30;
   step_reform          = Newt_Jacobian_Reformation_stride;
@@ -683,6 +970,8 @@ int solve_nonlinear_problem(struct Aztec_Linear_Solver_System *ams,
        */
 
       asmslv_start = ut(); asmslv_end = asmslv_start;
+      asm_wall = 0.;
+      slv_wall = -1.;
 
       log_msg("%s: Newton iteration %d", yo, inewton);
 
@@ -787,6 +1076,14 @@ int solve_nonlinear_problem(struct Aztec_Linear_Solver_System *ams,
       else
 	{
 
+	  if (seg_reform)
+	    {
+	      Norm_below_tolerance = FALSE;
+	      Rate_above_tolerance = FALSE;
+	      seg_reform = FALSE;
+	    }
+	  mesh_segregation_set(seg_phase);
+
           if (!Norm_below_tolerance || !Rate_above_tolerance)
 	    {
 	      init_vec_value (resid_vector, 0.0, numProcUnknowns);
@@ -816,6 +1113,12 @@ int solve_nonlinear_problem(struct Aztec_Linear_Solver_System *ams,
               eqm->vol_low = 9999.9;
               eqm->vol_count = 0;
             }
+          if (nEQM>0 && eqm->incremental && af->Assemble_Residual)
+            {
+              eqm->jac_sum = 0.0;
+              eqm->jac_low = 9999.9;
+              eqm->jac_count = 0;
+            }
 
 	  /*
 	   * NORMAL, TANGENT and OTHER Vectors required for ROTATION are calculated
@@ -841,8 +1144,14 @@ int solve_nonlinear_problem(struct Aztec_Linear_Solver_System *ams,
 	  }
 
           /* Exchange dof before matrix fill so parallel information
-             is properly communicated */
-          exchange_dof(cx,dpi, x);
+             is properly communicated. With Overlap Exchange the
+             exchange is finished inside matrix_fill_full(), after the
+             elements that do not need it have been assembled. */
+          if (Overlap_Exchange && Linear_Solver != FRONT) {
+            exchange_dof_begin(cx, dpi, x);
+          } else {
+            exchange_dof(cx,dpi, x);
+          }
 
 	  if (Linear_Solver == FRONT)
 	    {
@@ -911,9 +1220,9 @@ int solve_nonlinear_problem(struct Aztec_Linear_Solver_System *ams,
 								&h_elem_avg,
 								&U_norm);
 	      /*
-	       * Free memory allocated above
+	       * Clear the quadrature point storage for the next fill
 	       */
-	      global_qp_storage_destroy();
+	      global_qp_storage_reset();
 
 	      if (neg_elem_volume) err = -1;
 	      if (err == -1) {
@@ -935,7 +1244,70 @@ EH(-1,"version not compiled with frontal solver");
 	    }
 	  else
 	    {
+	      /*
+	       * Matrix Replay File: a dumped system, already scaled, stands
+	       * in for the assembly and is solved once.
+	       */
+	      if (Matrix_Replay_File[0] != '\0')
+		{
+		  err = matrix_replay_load(ams, resid_vector);
+		  EH(err, "matrix_replay_load");
+		  s_start = ut();
+		  goto replay_solve;
+		}
+
+	      /*
+	       * Kernel Benchmark: the first assembly is first done that many
+	       * times over with the kernels timed, then once more for real.
+	       */
+	      if (kernel_bench_pending() && !assembly_threads_active(exo))
+		{
+		  kernel_bench_begin();
+		  wall_start = wall_time();
+		  for (i = 0; i < Kernel_Bench_Reps; i++)
+		    {
+		      init_vec_value(resid_vector, 0.0, numProcUnknowns);
+		      if (strcmp(Matrix_Format, "epetra") == 0) {
+			EpetraPutScalarRowMatrix(ams->RowMatrix, 0.0);
+		      } else {
+			init_vec_value(a, 0.0, ams->nnz);
+		      }
+		      err = matrix_fill_full(ams, x, resid_vector, 
+					     x_old, x_older, xdot, xdot_old,
+					     x_update, &delta_t, &theta, 
+					     First_Elem_Side_BC_Array, 
+					     &time_value, exo, dpi,
+					     &num_total_nodes,
+					     &h_elem_avg, &U_norm, NULL);
+		      EH(err, "matrix_fill_full in the Kernel Benchmark");
+		    }
+		  kernel_bench_end(wall_time() - wall_start);
+		  init_vec_value(resid_vector, 0.0, numProcUnknowns);
+		  if (strcmp(Matrix_Format, "epetra") == 0) {
+		    EpetraPutScalarRowMatrix(ams->RowMatrix, 0.0);
+		  } else {
+		    init_vec_value(a, 0.0, ams->nnz);
+		  }
+		}
 
+	      /*
+	       * Fused Post Processing: after an update that met the update
+	       * tolerance, this assembly also sums the nodal post processing
+	       * fields, for x as it stands. Whether they are kept depends on
+	       * the residual, below.
+	       */
+	      fuse_pp = (Fused_Post_Processing && rd->TotalNVPostOutput > 0 &&
+			 inewton > 0 && nAC == 0 && !mesh_seg &&
+			 Continuation == ALC_NONE &&
+			 nn_post_fluxes_sens == 0 && nn_post_data_sens == 0 &&
+			 !assembly_threads_active(exo) &&
+			 (Norm_r[0][2] + Norm_r[1][2]) < Epsilon[2]);
+	      if (fuse_pp) fused_post_proc_begin(rd, dpi);
+
+	      timer_push("assembly");
+	      wall_start = wall_time();
+	      jac_formed = af->Assemble_Jacobian;
+	      precond_fill_set(precond_simple && af->Assemble_Jacobian);
 	      err = matrix_fill_full(ams, x, resid_vector, 
 				     x_old, x_older, xdot, xdot_old, x_update,
 				     &delta_t, &theta, 
@@ -943,6 +1315,9 @@ EH(-1,"version not compiled with frontal solver");
 				     &time_value, exo, dpi,
 				     &num_total_nodes,
 				     &h_elem_avg, &U_norm, NULL);
+	      precond_fill_set(FALSE);
+
+	      if (fuse_pp) fused_post_proc_end(err == 0, x, time_value, delta_t);
 
               if( ( (vn->evssModel == LOG_CONF || vn->evssModel == LOG_CONF_GRADV)
                  && pd->v[POLYMER_STRESS11] && af->Assemble_Jacobian == TRUE)
@@ -954,6 +1329,8 @@ EH(-1,"version not compiled with frontal solver");
                                      Debug_Flag, time_value, exo, dpi, 
                                      &h_elem_avg, &U_norm);
                 }
+	      timer_pop("assembly");
+	      asm_wall = wall_time() - wall_start;
  
 	      a_end = ut();
 	      if (err == -1) {
@@ -961,6 +1338,16 @@ EH(-1,"version not compiled with frontal solver");
                 goto free_and_clear;
               }
 
+	      /*
+	       * Prune Zero Couplings squeezes the matrix in place; the
+	       * solvers then start over on the new graph.
+	       */
+	      if (Prune_Zero_Couplings > 0 && jac_formed && !precond_simple &&
+		  prune_zero_couplings(ams, dpi)) {
+		NZeros = ams->nnz;
+		first_linear_solver_call = TRUE;
+	      }
+
 	      /* Scale matrix first to get rid of problems with 
 	       * penalty parameter. In front option this is done
 	       * within the solver
@@ -1067,6 +1454,7 @@ EH(-1,"version not compiled with frontal solver");
 	  mf_args.estifm = NULL;
 
 	ac_start = ut();
+	ac_sensitivity_reset();
 
 	for (iAC = 0; iAC < nAC ; iAC++)
 	  {  
@@ -1221,9 +1609,12 @@ EH(-1,"version not compiled with frontal solver");
 
       print_damp_factor = FALSE;
       print_visc_sens = FALSE;
-      Norm[0][0] = Loo_norm(resid_vector, NumUnknowns, &num_unk_r, dofname_r);
-      Norm[0][1] = L1_norm (resid_vector, NumUnknowns);
-      Norm[0][2] = L2_norm (resid_vector, NumUnknowns);
+      gstatus_begin();
+      gstatus_add_norms(resid_vector, NULL, NumUnknowns, norm_slot, &loo_loc);
+      gstatus_start();
+      Norm[0][0] = gstatus_get_loo(norm_slot, loo_loc, &num_unk_r, dofname_r);
+      Norm[0][1] = gstatus_get(norm_slot[0]);
+      Norm[0][2] = sqrt(gstatus_get(norm_slot[1]));
 
       log_msg("%-38s = %23.16e", "residual norm (L_oo)", Norm[0][0]);
       log_msg("%-38s = %23.16e", "residual norm (L_1)", Norm[0][1]);
@@ -1237,6 +1628,18 @@ EH(-1,"version not compiled with frontal solver");
 		*converged = Epsilon[2] > 1.0 ? TRUE : FALSE ;
 #endif
 	   }
+
+      /*
+       * The update that led to this x met its tolerance, so a residual
+       * that meets its own ends the iteration here, without the solve.
+       * The post processing fields summed in this assembly are then for
+       * the final solution.
+       */
+      if (fuse_pp)
+	{
+	  *converged = (Norm[0][2] < Epsilon[0]);
+	  if (!(*converged)) fused_post_proc_end(FALSE, x, time_value, delta_t);
+	}
       
 #ifdef DEBUG_NORM
       if (fabs(resid_vector[num_unk_r]) == fabs(Norm[0][0])) {
@@ -1292,6 +1695,21 @@ EH(-1,"version not compiled with frontal solver");
       s_start = ut(); s_end = s_start;
 	   
 	  if( Linear_Solver != FRONT && *converged ) goto skip_solve;
+
+      matrix_replay_dump(ams, exo, dpi, resid_vector);
+
+    replay_solve:
+      timer_push("linear solve");
+      wall_start = wall_time();
+
+      if (forcing_active) {
+	forcing_eta = newton_forcing_term(inewton, Norm[0][2], forcing_res_old,
+					  forcing_lin_rel, forcing_eta,
+					  forcing_tol_base);
+	forcing_res_old = Norm[0][2];
+	ams->params[AZ_tol] = forcing_eta;
+	log_msg("%-38s = %23.16e", "Newton forcing term (linear tol)", forcing_eta);
+      }
 	   
       switch (Linear_Solver)
       {
@@ -1317,12 +1735,26 @@ EH(-1,"version not compiled with frontal solver");
 	  }
 	  matr_form = 1;
 
-	  UMF_system_id = SL_UMF(UMF_system_id,
-				 &first_linear_solver_call,
-				 &Factor_Flag, &matr_form,
-				 &NumUnknowns, &NZeros, &ija[0],
-				 &ija[0], &a[0], &resid_vector[0],
-				 &delta_x[0]);
+	  /*
+	   * Direct Solve Refinement: try the factors of the last
+	   * factored matrix on this one first, refining against it, and
+	   * factor it only when that does not reach the tolerance.
+	   */
+	  refine_steps = -1;
+	  if (Direct_Refine_Tol > 0. && Factor_Flag == 1) {
+	    refine_steps = SL_UMF_refine(UMF_system_id, NumUnknowns, NZeros,
+					 &ija[0], &a[0], &resid_vector[0],
+					 &delta_x[0]);
+	  }
+
+	  if (refine_steps < 0) {
+	    UMF_system_id = SL_UMF(UMF_system_id,
+				   &first_linear_solver_call,
+				   &Factor_Flag, &matr_form,
+				   &NumUnknowns, &NZeros, &ija[0],
+				   &ija[0], &a[0], &resid_vector[0],
+				   &delta_x[0]);
+	  }
 
 	  first_linear_solver_call = FALSE;
 
@@ -1332,7 +1764,11 @@ EH(-1,"version not compiled with frontal solver");
 	      Factor_Flag = 3;
 
           LOCA_UMF_ID = UMF_system_id;
-	  strcpy(stringer, " 1 ");
+	  if (refine_steps > 0) {
+	    sprintf(stringer, "%2dr", MIN(refine_steps, 99));
+	  } else {
+	    strcpy(stringer, " 1 ");
+	  }
 	  break;
 
       case SPARSE13a:
@@ -1364,6 +1800,11 @@ EH(-1,"version not compiled with frontal solver");
 	   */
 	  if (first_linear_solver_call) {
 	    ams->options[AZ_pre_calc] = AZ_calc;
+	  } else if (Jacobian_Reuse != JACOBIAN_REUSE_FIXED &&
+		     Norm_below_tolerance && Rate_above_tolerance &&
+		     ams->options[AZ_keep_info]) {
+	    /* same matrix as last time: keep its preconditioner too */
+	    ams->options[AZ_pre_calc] = AZ_reuse;
 	  } else {
 	    if (strcmp(Matrix_Factorization_Reuse, "calc") == 0) {
 	      /*
@@ -1392,10 +1833,15 @@ EH(-1,"version not compiled with frontal solver");
 	    }
 	  }
 
+	  /* Linear Solver Autotune: pick the options on this matrix */
+	  if (aztec_autotune_pending()) aztec_autotune(ams, delta_x, resid_vector);
+
 	  linear_solver_blk     = 0; /* count calls to AZ_solve() */
 	  num_linear_solve_blks = 1; /* upper limit to AZ_solve() calls */
 	  linear_solver_itns    = 0; /* cumulative number of iterations */
 	  matrix_solved         = FALSE; 
+	  fallback_chain        = ( Num_Fallback_Levels > 0 && !precond_simple &&
+				    !jfnk_active );
 	  while ( ( ! matrix_solved                            ) && 
 		  ( linear_solver_blk < num_linear_solve_blks  ) ) {
 	    /* 
@@ -1422,19 +1868,40 @@ EH(-1,"version not compiled with frontal solver");
 			ams->bindx[num_internal_dofs+num_boundary_dofs],
 			"ijA", type_int, ProcID);
 #endif /* DEBUG */
-	    if(!Norm_below_tolerance || !Rate_above_tolerance) {
-	      /* Save old A before Aztec rescales it */
-	      if ( save_old_A ) dcopy1(NZeros,ams->val, ams->val_old);
-	    } else {
-	      /*Recover last A*/
-	      if (save_old_A) dcopy1(NZeros,ams->val_old, ams->val);
+	    if (linear_solver_blk == 0) {
+	      if(!Norm_below_tolerance || !Rate_above_tolerance) {
+		/* Save old A before Aztec rescales it */
+		if ( save_old_A ) dcopy1(NZeros,ams->val, ams->val_old);
+	      } else {
+		/*Recover last A*/
+		if (save_old_A) dcopy1(NZeros,ams->val_old, ams->val);
+
+	      }
+	    }
 
+	    /* Linear Solver Fallback: the next level on the same system */
+	    fallback_direct = FALSE;
+	    if (fallback_chain) {
+	      if (linear_solver_blk == 0) {
+		num_linear_solve_blks = linear_fallback_begin(ams, resid_vector);
+	      } else {
+		fallback_direct = linear_fallback_next(ams, linear_solver_blk,
+						       delta_x, resid_vector);
+	      }
 	    }
 
-	    AZ_solve(delta_x, resid_vector, ams->options, ams->params, 
-		     ams->indx, ams->bindx, ams->rpntr, ams->cpntr, 
-		     ams->bpntr, ams->val, ams->data_org, ams->status, 
-		     ams->proc_config);
+	    if (precond_simple ||
+		(jfnk_active && Norm_below_tolerance && Rate_above_tolerance)) {
+	      jfnk_solve(ams, delta_x, resid_vector, x, x_old, x_older,
+			 xdot, xdot_old, x_update, &delta_t, &theta,
+			 &time_value, scale, jfnk_work, exo, dpi,
+			 &num_total_nodes, &h_elem_avg, &U_norm, cx);
+	    } else if (!fallback_direct) {
+	      AZ_solve(delta_x, resid_vector, ams->options, ams->params, 
+		       ams->indx, ams->bindx, ams->rpntr, ams->cpntr, 
+		       ams->bpntr, ams->val, ams->data_org, ams->status, 
+		       ams->proc_config);
+	    }
 
 	    first_linear_solver_call = FALSE;
 
@@ -1450,6 +1917,10 @@ EH(-1,"version not compiled with frontal solver");
 	    linear_solver_blk++;
 	    linear_solver_itns += ams->status[AZ_its];
 	  } 
+	  if (fallback_chain) {
+	    linear_fallback_end(ams, linear_solver_blk, matrix_solved);
+	  }
+	  aztec_autotune_check(ams);
 
 	  /* Necessary anymore?
 	   * 	  if (options[AZ_pre_calc] == AZ_calc) {
@@ -1464,7 +1935,9 @@ EH(-1,"version not compiled with frontal solver");
       case AMESOS:
 
         if( strcmp( Matrix_Format,"msr" ) == 0 ) {
-          amesos_solve_msr( Amesos_Package, ams, delta_x, resid_vector, 1 );
+          /* a reused Jacobian is still factored from last time */
+          amesos_solve_msr( Amesos_Package, ams, delta_x, resid_vector,
+                            (!Norm_below_tolerance || !Rate_above_tolerance) );
         } else if ( strcmp( Matrix_Format,"epetra" ) == 0 ) {
           amesos_solve_epetra(Amesos_Package, ams, delta_x, resid_vector);
         } else {
@@ -1487,7 +1960,9 @@ EH(-1,"version not compiled with frontal solver");
       case STRATIMIKOS:
         if ( strcmp( Matrix_Format,"epetra" ) == 0 ) {
           int iterations;
-          int err = stratimikos_solve(ams, delta_x, resid_vector, &iterations, Stratimikos_File);
+          stratimikos_next_solve(inewton, delta_t);
+          int err = stratimikos_solve(ams, delta_x, resid_vector, &iterations, Stratimikos_File,
+                                      forcing_active ? ams->params[AZ_tol] : -1.0);
           if (err) {
 	    EH(err, "Error in stratimikos solve");
 	    check_parallel_error("Error in solve - stratimikos");
@@ -1496,6 +1971,7 @@ EH(-1,"version not compiled with frontal solver");
 	    strcpy(stringer, "err");
 	  } else {
 	    aztec_stringer(AZ_normal, iterations, &stringer[0]);
+	    ams->status[AZ_its] = iterations;
 	  }
         } else {
           EH(-1, "Sorry, only Epetra matrix formats are currently supported with the Stratimikos interface\n");
@@ -1524,7 +2000,35 @@ EH(-1,"version not compiled with frontal solver");
 	  EH(-1, "That linear solver package is not implemented.");
 	  break;
       }
+      timer_pop("linear solve");
+      slv_wall = wall_time() - wall_start;
       s_end = ut();
+
+      if (Matrix_Replay_File[0] != '\0')
+	{
+	  matrix_replay_report(slv_wall, s_end - s_start,
+			       (Linear_Solver == AZTEC) ? linear_solver_itns : -1);
+	  P0PRINTF("\n-done\n\n");
+#ifdef PARALLEL
+	  MPI_Finalize();
+#endif
+	  exit(0);
+	}
+
+      if (forcing_active) {
+	/*
+	 * Back to the base tolerance for the AC and sensitivity solves. A
+	 * Krylov method needs roughly log(tol) iterations, which gives an
+	 * estimate of what the base tolerance would have cost.
+	 */
+	int its = (int) ams->status[AZ_its];
+	ams->params[AZ_tol] = forcing_tol_base;
+	forcing_lin_rel = ams->status[AZ_scaled_r];
+	forcing_its += its;
+	if (forcing_eta > forcing_tol_base && forcing_tol_base > 0. && its > 0) {
+	  forcing_saved += its * (log(forcing_tol_base) / log(forcing_eta) - 1.);
+	}
+      }
       /**************************************************************************
        *        END OF LINEAR SYSTEM SOLVE SECTION
        **************************************************************************/
@@ -1537,10 +2041,43 @@ EH(-1,"version not compiled with frontal solver");
       if (nAC > 0) {
 	sc_start = ut();
 
+	/*
+	 * Amesos and Stratimikos take all the augmenting conditions at
+	 * once, with the factorization (or preconditioner) of the solve
+	 * above.
+	 */
+	ac_block = FALSE;
+	if (Linear_Solver == AMESOS) {
+	  if( strcmp( Matrix_Format,"msr" ) == 0 ) {
+	    amesos_solve_msr_multi( Amesos_Package, ams, wAC, bAC, nAC, 0 );
+	  } else if ( strcmp( Matrix_Format,"epetra" ) == 0 ) {
+	    amesos_solve_epetra_multi( Amesos_Package, ams, wAC, bAC, nAC, 0 );
+	  } else {
+	    EH(-1," Sorry, only MSR and Epetra matrix formats are currently supported with the Amesos solver suite\n");
+	  }
+	  strcpy(stringer_AC, " 1 ");
+	  ac_block = TRUE;
+	} else if (Linear_Solver == STRATIMIKOS) {
+	  if ( strcmp( Matrix_Format,"epetra" ) == 0 ) {
+	    int iterations;
+	    err = stratimikos_solve_multi(ams, wAC, bAC, nAC, &iterations,
+					  Stratimikos_File, -1.0);
+	    EH(err, "Error in stratimikos solve");
+	    if (iterations == -1) {
+	      strcpy(stringer_AC, "err");
+	    } else {
+	      aztec_stringer(AZ_normal, iterations, &stringer_AC[0]);
+	    }
+	  } else {
+	    EH(-1, "Sorry, only Epetra matrix formats are currently supported with the Stratimikos interface\n");
+	  }
+	  ac_block = TRUE;
+	}
+
 	/*
 	 * LOOP OVER NUMBER OF AUGMENTING CONDITIONS
 	 */
-	for (iAC = 0;iAC < nAC;iAC++) {
+	for (iAC = 0;iAC < nAC && !ac_block;iAC++) {
 
 	  switch (Linear_Solver) {
 	  case UMFPACK2:
@@ -1588,17 +2125,6 @@ EH(-1,"version not compiled with frontal solver");
 	      strcpy(stringer_AC, " 1 ");
 	      break;
 		  
-	  case AMESOS: 
-            if( strcmp( Matrix_Format,"msr" ) == 0 ) {
-              amesos_solve_msr( Amesos_Package, ams, &wAC[iAC][0], &bAC[iAC][0], 0 );
-            } else if ( strcmp( Matrix_Format,"epetra" ) == 0 ) {
-              amesos_solve_epetra(Amesos_Package, ams, &wAC[iAC][0], &bAC[iAC][0]);
-            } else {
-              EH(-1," Sorry, only MSR and Epetra matrix formats are currently supported with the Amesos solver suite\n");
-            }
-            strcpy(stringer_AC, " 1 ");
-	    break;
-
 	  case AZTEC:
 	      /*
 	       * Initialization is now performed up in
@@ -1685,20 +2211,6 @@ EH(-1,"version not compiled with frontal solver");
               EH(-1, "Sorry, only Epetra matrix formats are currently supported with the AztecOO solver suite\n");
             }
             break;
-          case STRATIMIKOS:
-            if ( strcmp( Matrix_Format,"epetra" ) == 0 ) {
-              int iterations;
-              int err = stratimikos_solve(ams, &wAC[iAC][0], &bAC[iAC][0], &iterations, Stratimikos_File);
-              EH(err, "Error in stratimikos solve");
-	      if (iterations == -1) {
-		strcpy(stringer, "err");
-	      } else {
-		aztec_stringer(AZ_normal, iterations, &stringer[0]);
-	      }
-            } else {
-              EH(-1, "Sorry, only Epetra matrix formats are currently supported with the Stratimikos interface\n");
-            }
-            break;
 
 	  case FRONT:
 
@@ -1738,9 +2250,9 @@ EH(-1,"version not compiled with frontal solver");
                                     &h_elem_avg,
                                     &U_norm);
 	      /*
-	       * Free memory allocated above
+	       * Clear the quadrature point storage for the next fill
 	       */
-	      global_qp_storage_destroy();
+	      global_qp_storage_reset();
 
 	      if( neg_elem_volume ) err = -1;
 	      if (err == -1) {
@@ -1909,13 +2421,21 @@ EH(-1,"version not compiled with frontal solver");
       /**************************************************************************
        *         END OF AUGMENTED SYSTEM SOLVE SECTION
        **************************************************************************/
+
+      newton_accel_step(x, delta_x, NumUnknowns,
+			(Norm_below_tolerance && Rate_above_tolerance));
       
-      Norm[1][0] = Loo_norm(delta_x, NumUnknowns, &num_unk_x, dofname_x);
-      Norm[1][1] = L1_norm (delta_x, NumUnknowns);
-      Norm[1][2] = L2_norm (delta_x, NumUnknowns);
-      Norm_r[0][0] = Loo_norm_r(delta_x, x, NumUnknowns, &num_unk_x,dofname_nr);
-      Norm_r[0][1] = L1_norm_r (delta_x, x, NumUnknowns);
-      Norm_r[0][2] = L2_norm_r (delta_x, x, NumUnknowns);
+      gstatus_begin();
+      gstatus_add_norms(delta_x, NULL, NumUnknowns, norm_slot, &loo_loc);
+      gstatus_add_norms(delta_x, x, NumUnknowns, norm_r_slot, &loo_r_loc);
+      gstatus_start();
+      Norm[1][0] = gstatus_get_loo(norm_slot, loo_loc, &num_unk_x, dofname_x);
+      Norm_r[0][0] = gstatus_get_loo(norm_r_slot, loo_r_loc, &num_unk_x,
+				     dofname_nr);
+      Norm[1][1] = gstatus_get(norm_slot[0]);
+      Norm[1][2] = sqrt(gstatus_get(norm_slot[1]));
+      Norm_r[0][1] = gstatus_get(norm_r_slot[0]);
+      Norm_r[0][2] = sqrt(gstatus_get(norm_r_slot[1]));
       
       if (nAC > 0) {
         Norm[3][0] = Loo_norm_1p(yAC, nAC, &num_unk_y, dofname_y);
@@ -1973,6 +2493,30 @@ EH(-1,"version not compiled with frontal solver");
 	  /* do nothing different*/
 	}
 
+      if (Jacobian_Reuse != JACOBIAN_REUSE_FIXED)
+	{
+	  /* account for the solve just done, then decide on the next one */
+	  if (!Norm_below_tolerance || !Rate_above_tolerance)
+	    {
+	      Jac_Reuse_Valid = TRUE;
+	      Jac_Reuse_Age   = 1;
+	      Jac_Reuse_Dt    = delta_t;
+	      Jac_Reuse_Omega = upd->Acoustic_Frequency;
+	      Jac_Reuse_Theta = theta;
+	      reuse_reforms++;
+	    }
+	  else
+	    {
+	      Jac_Reuse_Age++;
+	      reuse_kept++;
+	    }
+	  Norm_below_tolerance =
+	    jacobian_reuse_keep(inewton + 1,
+				(inewton > 0 && Norm_old > 0.) ?
+				Norm_new / Norm_old : -1., delta_t, theta);
+	  Rate_above_tolerance = Norm_below_tolerance;
+	}
+
 
       log_msg("%-38s = %23.16e", "correction norm (L_oo)", Norm[1][0]);
       log_msg("%-38s = %23.16e", "correction norm (L_1)", Norm[1][1]);
@@ -2099,19 +2643,30 @@ EH(-1,"version not compiled with frontal solver");
 	    continuation_hook(x, delta_x, con_ptr, Reltol, Abstol);
         }
 
+      if (line_search_active) {
+	dcopy1(NumUnknowns, x, lsearch_dx);
+	dcopy1(NumUnknowns, xdot, lsearch_dxdot);
+      }
+
       /*******************************************************************
        *
        *   UPDATE GOMA UNKNOWNS
        *
        *******************************************************************/
-      for (i = 0; i < NumUnknowns; i++) {
-	x[i] -= damp_factor * var_damp[idv[i][0]] * delta_x[i];
-      }
-      exchange_dof(cx, dpi, x);
       if (pd->TimeIntegration != STEADY) {
+	double dx, xdot_fac = (1.0 + 2 * theta) / delta_t;
+	for (i = 0; i < NumUnknowns; i++) {
+	  dx = damp_factor * var_damp[idv[i][0]] * delta_x[i];
+	  x[i] -= dx;
+	  xdot[i] -= dx * xdot_fac;
+	}
+      } else {
 	for (i = 0; i < NumUnknowns; i++) {
-	  xdot[i] -= damp_factor * var_damp[idv[i][0]] * delta_x[i] * (1.0 + 2 * theta) / delta_t;
+	  x[i] -= damp_factor * var_damp[idv[i][0]] * delta_x[i];
 	}
+      }
+      exchange_dof(cx, dpi, x);
+      if (pd->TimeIntegration != STEADY) {
         exchange_dof(cx, dpi, xdot);
 		
 	/* Now go back and correct all those dofs in solid regions undergoing newmark-beta
@@ -2158,6 +2713,58 @@ EH(-1,"version not compiled with frontal solver");
 	  }
       }
 
+      /*
+       * Armijo backtracking: unless the update lowers the (scaled) residual
+       * by the fraction Line_Search_Alpha of what the linear model
+       * promises, pull it back along the same direction, to the minimum of
+       * the quadratic through ||R(0)||^2, its slope and ||R(lambda)||^2
+       * (kept within [0.1, 0.5] lambda). Each trial costs one residual-only
+       * assembly; a trial on which an element inverts counts as a failure.
+       */
+      if (line_search_active && Norm[0][2] > Epsilon[0]) {
+	for (i = 0; i < NumUnknowns; i++) {
+	  lsearch_dx[i]    = x[i] - lsearch_dx[i];
+	  lsearch_dxdot[i] = xdot[i] - lsearch_dxdot[i];
+	}
+	lsearch_merit0 = Norm[0][2];
+	lsearch_lambda = 1.0;
+	lsearch_back   = 0;
+	lsearch_merit  = line_search_merit(ams, x, lsearch_res, x_old, x_older, xdot,
+				      xdot_old, x_update, &delta_t, &theta,
+				      &time_value, scale, exo, dpi,
+				      &num_total_nodes, &h_elem_avg, &U_norm);
+	while ((lsearch_merit < 0. ||
+		lsearch_merit > (1. - Line_Search_Alpha * lsearch_lambda) * lsearch_merit0) &&
+	       lsearch_back < Line_Search_Max_Backtracks) {
+	  if (lsearch_merit < 0.) {
+	    lsearch_new = 0.25 * lsearch_lambda;
+	  } else {
+	    lsearch_new = lsearch_lambda * lsearch_lambda * lsearch_merit0 * lsearch_merit0 /
+	      (lsearch_merit * lsearch_merit - lsearch_merit0 * lsearch_merit0 +
+	       2. * lsearch_lambda * lsearch_merit0 * lsearch_merit0);
+	    lsearch_new = MIN(MAX(lsearch_new, 0.1 * lsearch_lambda), 0.5 * lsearch_lambda);
+	  }
+	  for (i = 0; i < NumUnknowns; i++) {
+	    x[i]    -= (lsearch_lambda - lsearch_new) * lsearch_dx[i];
+	    xdot[i] -= (lsearch_lambda - lsearch_new) * lsearch_dxdot[i];
+	  }
+	  exchange_dof(cx, dpi, x);
+	  if (pd->TimeIntegration != STEADY) exchange_dof(cx, dpi, xdot);
+	  lsearch_lambda = lsearch_new;
+	  lsearch_back++;
+	  lsearch_merit  = line_search_merit(ams, x, lsearch_res, x_old, x_older, xdot,
+					xdot_old, x_update, &delta_t, &theta,
+					&time_value, scale, exo, dpi,
+					&num_total_nodes, &h_elem_avg, &U_norm);
+	}
+	log_msg("Newton line search: lambda %.4g after %d backtracks, "
+		"||R|| %.4e -> %.4e", lsearch_lambda, lsearch_back, lsearch_merit0, lsearch_merit);
+	if (lsearch_back > 0) {
+	  lsearch_total += lsearch_back;
+	  for (i = 0; i < numProcUnknowns; i++) x_update[i] *= lsearch_lambda;
+	}
+      }
+
 
       /* implicit embedded level set surfaces*/
       if ( ls != NULL && ls->Evolution == LS_EVOLVE_SLAVE )
@@ -2308,6 +2915,27 @@ EH(-1,"version not compiled with frontal solver");
 		    ((Norm_r[0][2] + Norm_r[1][2]) < Epsilon[2]) &&
 		    (continuation_converged));
 
+      /*
+       * Mesh Segregation: a converged flow solve hands over to the mesh,
+       * a converged mesh solve back to the flow unless it moved the mesh
+       * by less than the coupling tolerance. Only the mesh unknowns
+       * change in a mesh solve, so its relative correction is the move.
+       */
+      if (mesh_seg)
+	{
+	  if (seg_phase == MESH_SEG_MESH) seg_move += Norm_r[0][2];
+	  if (*converged &&
+	      !(seg_phase == MESH_SEG_MESH && seg_move < Mesh_Segregation_Tol))
+	    {
+	      seg_phase  = (seg_phase == MESH_SEG_FLOW) ? MESH_SEG_MESH : MESH_SEG_FLOW;
+	      seg_reform = TRUE;
+	      if (seg_phase == MESH_SEG_MESH) seg_move = 0.;
+	      *converged = FALSE;
+	      log_msg("Mesh Segregation, Newton step %d: %s solve follows",
+		      inewton, (seg_phase == MESH_SEG_MESH) ? "mesh" : "flow");
+	    }
+	}
+
       /********************************************************************
        *
        *    OPTIONALLY, 
@@ -2462,11 +3090,26 @@ skip_solve:
 	DPRINTF(stderr, "%7.1e/%7.1e\n", (ac_end-ac_start), (sc_end-sc_start)); 
       }
 
+      if (Perf_Log_File[0] != '\0') {
+	const char *pc = NULL;
+	if (Linear_Solver == AZTEC && slv_wall >= 0.) {
+	  if (ams->options[AZ_pre_calc] == AZ_calc) pc = "calc";
+	  else if (ams->options[AZ_pre_calc] == AZ_recalc) pc = "recalc";
+	  else if (ams->options[AZ_pre_calc] == AZ_reuse) pc = "reuse";
+	}
+	perf_log_newton(inewton, time_value, asm_wall, MAX(slv_wall, 0.),
+			(Linear_Solver == AZTEC && slv_wall >= 0.) ?
+			linear_solver_itns : -1, pc, jac_formed, Norm[0][2],
+			(slv_wall >= 0.) ? Norm[1][2] : -1., *converged);
+      }
+
       inewton++;
       af->Sat_hyst_reevaluate = FALSE; /*only want this true
 					 for first iteration*/
     } /* End of loop over newton iterations */
 
+  mesh_segregation_set(MESH_SEG_OFF);
+
   /**********************************************************************/
   /**********************************************************************
    *
@@ -2487,6 +3130,22 @@ skip_solve:
   /**  return number of newton iterations  **/
   return_value = inewton;
 
+  if (Jacobian_Reuse != JACOBIAN_REUSE_FIXED) {
+    log_msg("Jacobian reuse: %d formed, %d reused", reuse_reforms, reuse_kept);
+  }
+
+  if (line_search_active) {
+    log_msg("Newton line search: %d backtracks", lsearch_total);
+  }
+
+  if (forcing_active) {
+    ams->params[AZ_tol] = forcing_tol_base;
+    DPRINTF(stderr, "Newton forcing term: %d linear iterations, about %.0f saved\n",
+	    forcing_its, forcing_saved);
+    log_msg("Newton forcing term: %d linear iterations, about %.0f saved",
+	    forcing_its, forcing_saved);
+  }
+
 
   if (! *converged) {
     if (Debug_Flag) { 
@@ -2502,9 +3161,12 @@ skip_solve:
 /**
   *     Solution vector norms for detecting turning points
   */
-      Norm[4][0] = Loo_norm(x, NumUnknowns, &num_unk_x, dofname_x);
-      Norm[4][1] = L1_norm (x, NumUnknowns)/((double)NumUnknowns);
-      Norm[4][2] = L2_norm (x, NumUnknowns)/sqrt((double)NumUnknowns);
+      gstatus_begin();
+      gstatus_add_norms(x, NULL, NumUnknowns, norm_slot, &loo_loc);
+      gstatus_start();
+      Norm[4][0] = gstatus_get_loo(norm_slot, loo_loc, &num_unk_x, dofname_x);
+      Norm[4][1] = gstatus_get(norm_slot[0])/((double)NumUnknowns);
+      Norm[4][2] = sqrt(gstatus_get(norm_slot[1]))/sqrt((double)NumUnknowns);
 
       DPRINTF(stderr, "scaled solution norms  %13.6e %13.6e %13.6e \n", 
 	      Norm[4][0], Norm[4][1], Norm[4][2]);
@@ -2534,121 +3196,170 @@ skip_solve:
     scaling_max = 0.;
   }
 
-  for (i=0;i<nn_post_fluxes_sens;i++) {
-    if (pp_fluxes_sens[i]->vector_id > sens_vec_ct) {
-      /*
-       *
-       *	GET SENSITIVITY PARAMETER VALUE
-       *
-       */
-      retrieve_parameterS(&param_val, x, xdot, 
-			  pp_fluxes_sens[i]->sens_type,
-			  pp_fluxes_sens[i]->sens_id,
-			  pp_fluxes_sens[i]->sens_flt,
-			  pp_fluxes_sens[i]->sens_flt2,
-			  cx, exo, dpi);
-
-      strcat(sens_caller,"Flux Sensitivity");
-
-      err = soln_sens(param_val, x, xdot, delta_t, exo, dpi,
-		      cx, res_p, numProcUnknowns, ija, a,
-		      x_old, x_older, xdot_old, x_update,
-		      delta_t, theta, time_value, num_total_nodes,
-		      res_m, 3, matr_form, resid_vector_sens,
-		      x_sens,  x_sens_p, scale, ams,
-		      first_linear_solver_call,  Norm_below_tolerance,
-		      Rate_above_tolerance,
-		      pp_fluxes_sens[i]->vector_id,
-		      pp_fluxes_sens[i]->sens_type,
-		      pp_fluxes_sens[i]->sens_id,
-		      pp_fluxes_sens[i]->sens_flt,
-		      pp_fluxes_sens[i]->sens_flt2,
-		      &mf_resolve, ncod,  bc,  &smallpiv, 
-		      &singpiv,  &iautopiv,   &iscale,
-		      &scaling_max, &h_elem_avg, &U_norm,
-		      UMF_system_id, sens_caller);
-      sens_vec_ct++;
-    }
-  }
-
   /*
-   *
-   *    DATA SENSITIVITIES
-   *
+   * With more than one new sensitivity vector and a solver that can
+   * reuse its factorization or preconditioner, they are all assembled
+   * and then solved together; otherwise one at a time.
    */
-
-  for (i=0;i<nn_post_data_sens;i++) {
-    if (pp_data_sens[i]->vector_id > sens_vec_ct) {
-      /*
-       *
-       *	GET SENSITIVITY PARAMETER VALUE
-       *
-       */
-      retrieve_parameterS(&param_val, x, xdot,
-			  pp_data_sens[i]->sens_type,
-			  pp_data_sens[i]->sens_id,
-			  pp_data_sens[i]->sens_flt,
-			  pp_data_sens[i]->sens_flt2,
-			  cx, exo, dpi);
-
-      strcat(sens_caller,"Data Sensitivity");
-
-      err = soln_sens(param_val,
-		      x,
-		      xdot,
-		      delta_s,
-		      exo,
-		      dpi,
-		      cx,
-		      res_p,
-		      numProcUnknowns,
-		      ija,
-		      a,
-		      x_old,
-		      x_older,
-		      xdot_old,
-		      x_update,
-		      delta_t,
-		      theta,
-		      time_value,
-		      num_total_nodes,
-		      res_m,
-		      3,
-		      matr_form,
-		      resid_vector_sens,
-		      x_sens,
-		      x_sens_p,
-		      scale,
-		      ams,
-		      first_linear_solver_call,
-		      Norm_below_tolerance,
-		      Rate_above_tolerance,
-		      pp_data_sens[i]->vector_id,
-		      pp_data_sens[i]->sens_type,
-		      pp_data_sens[i]->sens_id,
-		      pp_data_sens[i]->sens_flt,
-		      pp_data_sens[i]->sens_flt2,
-		      &mf_resolve, /* frontal solver variables */
-		      ncod, 
-		      bc, 
-		      &smallpiv, 
-		      &singpiv, 
-		      &iautopiv, 
-		      &iscale,
-		      &scaling_max, 
-		      &h_elem_avg,
-		      &U_norm,
-		      UMF_system_id,
-		      sens_caller );
-
-      sens_vec_ct++;
+  nsens = 0;
+  sens = (struct sens_param *)
+    smalloc(MAX(nn_post_fluxes_sens + nn_post_data_sens, 1) *
+	    sizeof(struct sens_param));
+  for (i = 0, j = -1; i < nn_post_fluxes_sens + nn_post_data_sens; i++) {
+    struct sens_param *sp = sens + nsens;
+
+    if (i < nn_post_fluxes_sens) {
+      sp->vector_id = pp_fluxes_sens[i]->vector_id;
+      sp->type = pp_fluxes_sens[i]->sens_type;
+      sp->id   = pp_fluxes_sens[i]->sens_id;
+      sp->flt  = pp_fluxes_sens[i]->sens_flt;
+      sp->flt2 = pp_fluxes_sens[i]->sens_flt2;
+    } else {
+      sp->vector_id = pp_data_sens[i - nn_post_fluxes_sens]->vector_id;
+      sp->type = pp_data_sens[i - nn_post_fluxes_sens]->sens_type;
+      sp->id   = pp_data_sens[i - nn_post_fluxes_sens]->sens_id;
+      sp->flt  = pp_data_sens[i - nn_post_fluxes_sens]->sens_flt;
+      sp->flt2 = pp_data_sens[i - nn_post_fluxes_sens]->sens_flt2;
     }
+    if (sp->vector_id <= j) continue;
+    j++;
+    nsens++;
   }
-  /*
-   *        OUTPUT DATA TO FILES
-   */
-
-/*  only if converged */
+
+  if (soln_sens_batched(nsens)) {
+    for (i = 0; i < nsens; i++) {
+      retrieve_parameterS(&sens[i].value, x, xdot,
+			  sens[i].type, sens[i].id,
+			  sens[i].flt, sens[i].flt2,
+			  cx, exo, dpi);
+    }
+    strcat(sens_caller,"Flux and Data Sensitivity");
+    err = soln_sens_multi(sens, nsens, x, xdot, exo, dpi, cx,
+			  res_p, res_m, numProcUnknowns,
+			  x_old, x_older, xdot_old, x_update,
+			  delta_t, theta, time_value, num_total_nodes,
+			  x_sens, x_sens_p, scale, ams,
+			  &h_elem_avg, &U_norm, sens_caller);
+    sens_vec_ct += nsens;
+  } else {
+    for (i=0;i<nn_post_fluxes_sens;i++) {
+      if (pp_fluxes_sens[i]->vector_id > sens_vec_ct) {
+	/*
+	 *
+	 *        GET SENSITIVITY PARAMETER VALUE
+	 *
+	 */
+	retrieve_parameterS(&param_val, x, xdot, 
+			    pp_fluxes_sens[i]->sens_type,
+			    pp_fluxes_sens[i]->sens_id,
+			    pp_fluxes_sens[i]->sens_flt,
+			    pp_fluxes_sens[i]->sens_flt2,
+			    cx, exo, dpi);
+
+	strcat(sens_caller,"Flux Sensitivity");
+
+	err = soln_sens(param_val, x, xdot, delta_t, exo, dpi,
+			cx, res_p, numProcUnknowns, ija, a,
+			x_old, x_older, xdot_old, x_update,
+			delta_t, theta, time_value, num_total_nodes,
+			res_m, 3, matr_form, resid_vector_sens,
+			x_sens,  x_sens_p, scale, ams,
+			first_linear_solver_call,  Norm_below_tolerance,
+			Rate_above_tolerance,
+			pp_fluxes_sens[i]->vector_id,
+			pp_fluxes_sens[i]->sens_type,
+			pp_fluxes_sens[i]->sens_id,
+			pp_fluxes_sens[i]->sens_flt,
+			pp_fluxes_sens[i]->sens_flt2,
+			&mf_resolve, ncod,  bc,  &smallpiv, 
+			&singpiv,  &iautopiv,   &iscale,
+			&scaling_max, &h_elem_avg, &U_norm,
+			UMF_system_id, sens_caller);
+	sens_vec_ct++;
+      }
+    }
+
+    /*
+     *
+     *    DATA SENSITIVITIES
+     *
+     */
+
+    for (i=0;i<nn_post_data_sens;i++) {
+      if (pp_data_sens[i]->vector_id > sens_vec_ct) {
+	/*
+	 *
+	 *        GET SENSITIVITY PARAMETER VALUE
+	 *
+	 */
+	retrieve_parameterS(&param_val, x, xdot,
+			    pp_data_sens[i]->sens_type,
+			    pp_data_sens[i]->sens_id,
+			    pp_data_sens[i]->sens_flt,
+			    pp_data_sens[i]->sens_flt2,
+			    cx, exo, dpi);
+
+	strcat(sens_caller,"Data Sensitivity");
+
+	err = soln_sens(param_val,
+			x,
+			xdot,
+			delta_s,
+			exo,
+			dpi,
+			cx,
+			res_p,
+			numProcUnknowns,
+			ija,
+			a,
+			x_old,
+			x_older,
+			xdot_old,
+			x_update,
+			delta_t,
+			theta,
+			time_value,
+			num_total_nodes,
+			res_m,
+			3,
+			matr_form,
+			resid_vector_sens,
+			x_sens,
+			x_sens_p,
+			scale,
+			ams,
+			first_linear_solver_call,
+			Norm_below_tolerance,
+			Rate_above_tolerance,
+			pp_data_sens[i]->vector_id,
+			pp_data_sens[i]->sens_type,
+			pp_data_sens[i]->sens_id,
+			pp_data_sens[i]->sens_flt,
+			pp_data_sens[i]->sens_flt2,
+			&mf_resolve, /* frontal solver variables */
+			ncod, 
+			bc, 
+			&smallpiv, 
+			&singpiv, 
+			&iautopiv, 
+			&iscale,
+			&scaling_max, 
+			&h_elem_avg,
+			&U_norm,
+			UMF_system_id,
+			sens_caller );
+
+	sens_vec_ct++;
+      }
+    }
+  }
+  safer_free((void **) &sens);
+
+  /*
+   *        OUTPUT DATA TO FILES
+   */
+
+/*  only if converged */
 
 if( *converged )
   {
@@ -2687,6 +3398,7 @@ if( *converged )
 
     switch (Continuation) {
     case  ALC_FIRST:
+    case  ALC_SECOND:
 
 	if(cont->sensvec_id != -1)
 	{
@@ -2808,6 +3520,18 @@ if( *converged )
   LOCA_UMF_ID = UMF_system_id;
 
 free_and_clear:  
+  mesh_segregation_set(MESH_SEG_OFF);
+  /*
+   * Never carry a Jacobian out of a failed Newton solve: the caller
+   * backs up, usually with a smaller step. Augmenting conditions,
+   * continuation and sensitivities refactor for systems of their own.
+   */
+  if (return_value < 0 || !*converged || nAC > 0 || Continuation > 0 ||
+      nn_post_data_sens > 0 || nn_post_fluxes_sens > 0)
+    {
+      Jac_Reuse_Valid = FALSE;
+    }
+
 /*
  * If using LOCA, there may be another resolve after exiting the
  * nonlinear solver, so defer restoring external matrix rows
@@ -2825,6 +3549,12 @@ free_and_clear:
         }
     }
 
+  newton_accel_end();
+
+  safe_free( (void *) lsearch_dx);
+  safe_free( (void *) lsearch_dxdot);
+  safe_free( (void *) lsearch_res);
+  safe_free( (void *) jfnk_work);
   safe_free( (void *) delta_x);
   safe_free( (void *) res_p);
   safe_free( (void *) res_m);
@@ -2853,6 +3583,455 @@ free_and_clear:
 /***********************************************************************/
 /***********************************************************************/
 /***********************************************************************/
+/* newton_forcing_term -- Eisenstat-Walker linear tolerance for a Newton step
+ *
+ * S. C. Eisenstat and H. F. Walker, "Choosing the forcing terms in an
+ * inexact Newton method", SIAM J. Sci. Comput. 17 (1996) 16-32.
+ *
+ * Choice 1 compares the new residual with what the last linear model
+ * predicted, ||F_k|| / ||F_k-1|| against the relative linear residual the
+ * last solve achieved. Choice 2 uses gamma (||F_k|| / ||F_k-1||)^alpha,
+ * with gamma = 0.9 and alpha = 2. Both are safeguarded against dropping
+ * too quickly, kept below Newton_Forcing_Max, and never asked to beat
+ * the Residual Ratio Tolerance, or to solve more accurately than the
+ * Newton convergence test on ||F|| (Epsilon[0]) needs. Choice 1 falls
+ * back to choice 2 when the solver does not report its relative residual.
+ * The first Newton step uses 0.5 (or eta_max if that is smaller).
+ */
+
+static double
+newton_forcing_term(const int inewton,
+		    const double res_norm,
+		    const double res_norm_old,
+		    const double lin_rel_resid,
+		    const double eta_old,
+		    const double eta_min)
+{
+  static const double gamma = 0.9;
+  static const double alpha = 2.0;
+  static const double phi   = 1.6180339887498949; /* (1+sqrt(5))/2 */
+  double eta, ratio, safe;
+
+  if (inewton == 0 || res_norm_old <= 0.) return MAX(MIN(0.5, Newton_Forcing_Max), eta_min);
+
+  ratio = res_norm / res_norm_old;
+
+  if (Newton_Forcing == NEWTON_FORCING_EW1 && lin_rel_resid >= 0.) {
+    eta  = fabs(ratio - lin_rel_resid);
+    safe = pow(eta_old, phi);
+  } else {
+    eta  = gamma * pow(ratio, alpha);
+    safe = gamma * pow(eta_old, alpha);
+  }
+  if (safe > 0.1) eta = MAX(eta, safe);
+
+  eta = MIN(eta, Newton_Forcing_Max);
+  if (res_norm > 0.) eta = MAX(eta, 0.5 * Epsilon[0] / res_norm);
+  eta = MIN(eta, Newton_Forcing_Max);
+  eta = MAX(eta, eta_min);
+
+  return eta;
+}
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/* jacobian_reuse_keep -- adaptive modified Newton: may the next Newton
+ * step use the Jacobian (and its factorization or preconditioner) that
+ * is already on hand?
+ *
+ * Yes while the residual keeps contracting faster than Jacobian_Reuse_Rate
+ * per step, the Jacobian has been used fewer than Jacobian_Reuse_Max_Age
+ * times, and the time step is within Jacobian_Reuse_Dt_Tol of the one it
+ * was formed with (dt enters the mass terms of the Jacobian directly).
+ * Likewise omega^2 must be within Jacobian_Reuse_Omega_Tol of its value
+ * then, so that a zeroth order sweep over the Acoustic Frequency keeps one
+ * factored K - omega^2 M for a run of nearby frequencies.
+ * A poor rate only forces a reform if it was measured on a reused
+ * Jacobian; a fresh one that contracts slowly would not do better.
+ *
+ * Jacobian Reuse = constant is for problems whose Jacobian does not
+ * depend on the solution (constant property conduction, Stokes flow on a
+ * fixed mesh): there is no age limit, and the one factorization lasts
+ * until the time derivative coefficient (1 + 2 theta) / delta_t moves by
+ * more than Jacobian_Reuse_Dt_Tol, so every time step at a fixed dt is a
+ * residual assembly and a back substitution. The rate test stays on as a
+ * guard against a problem that is not linear after all.
+ * Every decision is written to the log.
+ */
+
+static int
+jacobian_reuse_keep(const int inewton,
+		    const double rate,
+		    const double delta_t,
+		    const double theta)
+{
+  double c_now, c_then;
+  const char *why = NULL;
+  static char yo[] = "jacobian_reuse_keep";
+
+  if (Jacobian_Reuse == JACOBIAN_REUSE_CONSTANT) {
+    c_now  = (delta_t  != 0.) ? (1. + 2. * theta) / delta_t : 0.;
+    c_then = (Jac_Reuse_Dt != 0.) ?
+      (1. + 2. * Jac_Reuse_Theta) / Jac_Reuse_Dt : 0.;
+  } else {
+    c_now = c_then = 0.;
+  }
+
+  if (!Jac_Reuse_Valid || first_linear_solver_call)
+    why = "none on hand";
+  else if (Jacobian_Reuse == JACOBIAN_REUSE_CONSTANT &&
+	   fabs(c_now - c_then) > Jacobian_Reuse_Dt_Tol * fabs(c_then))
+    why = "time step changed";
+  else if (Jacobian_Reuse == JACOBIAN_REUSE_ADAPTIVE &&
+	   Jac_Reuse_Dt != 0. &&
+	   fabs(delta_t / Jac_Reuse_Dt - 1.) > Jacobian_Reuse_Dt_Tol)
+    why = "time step changed";
+  else if (Jac_Reuse_Omega != 0. &&
+	   fabs(SQUARE(upd->Acoustic_Frequency / Jac_Reuse_Omega) - 1.) >
+	   Jacobian_Reuse_Omega_Tol)
+    why = "frequency changed";
+  else if (rate >= Jacobian_Reuse_Rate && Jac_Reuse_Age > 2)
+    why = "contraction rate degraded";
+  else if (Jacobian_Reuse == JACOBIAN_REUSE_ADAPTIVE &&
+	   Jac_Reuse_Age >= Jacobian_Reuse_Max_Age)
+    why = "maximum age reached";
+
+  if (why != NULL) {
+    log_msg("Jacobian reuse, Newton step %d: reform (%s, age %d, rate %.3g)",
+	    inewton, why, Jac_Reuse_Age, rate);
+    return FALSE;
+  }
+
+  log_msg("Jacobian reuse, Newton step %d: reuse (age %d, rate %.3g)",
+	  inewton, Jac_Reuse_Age, rate);
+  return TRUE;
+}
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/* line_search_merit -- ||R(x)||_2 for a trial x of the Newton line search,
+ * from a residual-only assembly and scaled like the residual of the
+ * Newton step. Returns -1 if the assembly fails (say, an inverted
+ * element), which the line search treats as too long a step.
+ */
+
+static double
+line_search_merit(struct Aztec_Linear_Solver_System *ams,
+		  double x[],
+		  double res[],
+		  double x_old[],
+		  double x_older[],
+		  double xdot[],
+		  double xdot_old[],
+		  double x_update[],
+		  double *delta_t,
+		  double *theta,
+		  double *time_value,
+		  double scale[],
+		  Exo_DB *exo,
+		  Dpi *dpi,
+		  int *num_total_nodes,
+		  dbl *h_elem_avg,
+		  dbl *U_norm)
+{
+  int err;
+  int save_residual = af->Assemble_Residual;
+  int save_jacobian = af->Assemble_Jacobian;
+
+  init_vec_value(res, 0.0, NumUnknowns + NumExtUnknowns);
+  af->Assemble_Residual = TRUE;
+  af->Assemble_Jacobian = FALSE;
+  af->Assemble_LSA_Jacobian_Matrix = FALSE;
+  af->Assemble_LSA_Mass_Matrix = FALSE;
+
+  if (nEQM > 0 && eqm->do_vol)
+    {
+      eqm->vol_sum = 0.0;
+      eqm->vol_low = 9999.9;
+      eqm->vol_count = 0;
+    }
+  if (nEQM > 0 && eqm->incremental)
+    {
+      eqm->jac_sum = 0.0;
+      eqm->jac_low = 9999.9;
+      eqm->jac_count = 0;
+    }
+  if (Num_ROT > 0) calculate_all_rotation_vectors(exo, x);
+  else if (Use_2D_Rotation_Vectors == TRUE) calculate_2D_rotation_vectors(exo, x);
+
+  err = matrix_fill_full(ams, x, res, x_old, x_older, xdot, xdot_old, x_update,
+			 delta_t, theta, First_Elem_Side_BC_Array, time_value,
+			 exo, dpi, num_total_nodes, h_elem_avg, U_norm, NULL);
+
+  af->Assemble_Residual = save_residual;
+  af->Assemble_Jacobian = save_jacobian;
+
+  if (err == -1) return -1.;
+
+  vector_scaling(NumUnknowns, res, scale);
+  return L2_norm(res, NumUnknowns);
+}
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
+/* jfnk_solve -- the Newton update of a Jacobian reuse step, or of any
+ * step with a Preconditioner Matrix, from AZ_iterate() on the current
+ * Jacobian, which is never formed: its
+ * product with v is the difference
+ *
+ *      J v = ( R(x + h v) - R(x) ) / h,   h = Matrix_Free_Delta (1 + |x|) / |v|
+ *
+ * of scaled residuals from line_search_merit(), xdot moving with x as in
+ * the update. The matrix in ams stands in as the preconditioner,
+ * with whatever factors Aztec kept from it. Aztec scaling is off, the
+ * residuals being row scaled already.
+ */
+
+static struct
+{
+  struct Aztec_Linear_Solver_System *ams;
+  double *x, *x_old, *x_older, *xdot, *xdot_old, *x_update;
+  double *res0, *xp, *xdotp, *resp;
+  double *delta_t, *theta, *time_value, *scale;
+  Exo_DB *exo;
+  Dpi *dpi;
+  Comm_Ex *cx;
+  int *num_total_nodes;
+  dbl *h_elem_avg, *U_norm;
+  int num_fail;			/* products whose trial residual failed */
+} Jfnk;
+
+static void
+jfnk_matvec(double v[], double y[], AZ_MATRIX *Amat, int proc_config[])
+{
+  int i;
+  double v_norm, h, h_dot = 0.;
+  double *xdotp = Jfnk.xdot;
+
+  v_norm = L2_norm(v, NumUnknowns);
+  if (v_norm == 0.)
+    {
+      init_vec_value(y, 0.0, NumUnknowns);
+      return;
+    }
+  h = Matrix_Free_Delta * (1. + L2_norm(Jfnk.x, NumUnknowns)) / v_norm;
+
+  for (i = 0; i < NumUnknowns; i++) Jfnk.xp[i] = Jfnk.x[i] + h * v[i];
+  exchange_dof(Jfnk.cx, Jfnk.dpi, Jfnk.xp);
+  if (pd->TimeIntegration != STEADY)
+    {
+      h_dot = h * (1.0 + 2 * *Jfnk.theta) / *Jfnk.delta_t;
+      for (i = 0; i < NumUnknowns; i++) Jfnk.xdotp[i] = Jfnk.xdot[i] + h_dot * v[i];
+      exchange_dof(Jfnk.cx, Jfnk.dpi, Jfnk.xdotp);
+      xdotp = Jfnk.xdotp;
+    }
+
+  if (line_search_merit(Jfnk.ams, Jfnk.xp, Jfnk.resp, Jfnk.x_old,
+			Jfnk.x_older, xdotp, Jfnk.xdot_old, Jfnk.x_update,
+			Jfnk.delta_t, Jfnk.theta, Jfnk.time_value, Jfnk.scale,
+			Jfnk.exo, Jfnk.dpi, Jfnk.num_total_nodes,
+			Jfnk.h_elem_avg, Jfnk.U_norm) < 0.)
+    {
+      Jfnk.num_fail++;
+      init_vec_value(y, 0.0, NumUnknowns);
+      return;
+    }
+
+  for (i = 0; i < NumUnknowns; i++) y[i] = (Jfnk.resp[i] - Jfnk.res0[i]) / h;
+}
+
+static void
+jfnk_solve(struct Aztec_Linear_Solver_System *ams,
+	   double delta_x[],
+	   double resid_vector[],
+	   double x[],
+	   double x_old[],
+	   double x_older[],
+	   double xdot[],
+	   double xdot_old[],
+	   double x_update[],
+	   double *delta_t,
+	   double *theta,
+	   double *time_value,
+	   double scale[],
+	   double work[],
+	   Exo_DB *exo,
+	   Dpi *dpi,
+	   int *num_total_nodes,
+	   dbl *h_elem_avg,
+	   dbl *U_norm,
+	   Comm_Ex *cx)
+{
+  int n = NumUnknowns + NumExtUnknowns;
+  int save_scaling = ams->options[AZ_scaling];
+  AZ_MATRIX *Amat, *Pmat;
+  AZ_PRECOND *Prec;
+
+  Jfnk.ams  = ams;
+  Jfnk.x    = x;
+  Jfnk.x_old = x_old;
+  Jfnk.x_older = x_older;
+  Jfnk.xdot = xdot;
+  Jfnk.xdot_old = xdot_old;
+  Jfnk.x_update = x_update;
+  Jfnk.xp    = work;
+  Jfnk.xdotp = work + n;
+  Jfnk.resp  = work + 2 * n;
+  Jfnk.res0  = resid_vector;
+  Jfnk.delta_t = delta_t;
+  Jfnk.theta = theta;
+  Jfnk.time_value = time_value;
+  Jfnk.scale = scale;
+  Jfnk.exo  = exo;
+  Jfnk.dpi  = dpi;
+  Jfnk.cx   = cx;
+  Jfnk.num_total_nodes = num_total_nodes;
+  Jfnk.h_elem_avg = h_elem_avg;
+  Jfnk.U_norm = U_norm;
+  Jfnk.num_fail = 0;
+
+  dcopy1(n, x, Jfnk.xp);
+  dcopy1(n, xdot, Jfnk.xdotp);
+
+  Amat = AZ_matrix_create(NumUnknowns);
+  AZ_set_MATFREE(Amat, NULL, jfnk_matvec);
+
+  Pmat = AZ_matrix_create(NumUnknowns);
+  AZ_set_MSR(Pmat, ams->bindx, ams->val, ams->data_org, 0, NULL, AZ_LOCAL);
+  Prec = AZ_precond_create(Pmat, AZ_precondition, NULL);
+
+  ams->options[AZ_scaling] = AZ_none;
+  AZ_iterate(delta_x, resid_vector, ams->options, ams->params, ams->status,
+	     ams->proc_config, Amat, Prec, NULL);
+  ams->options[AZ_scaling] = save_scaling;
+
+  AZ_precond_destroy(&Prec);
+  AZ_matrix_destroy(&Pmat);
+  AZ_matrix_destroy(&Amat);
+
+  if (Jfnk.num_fail > 0)
+    {
+      WH(-1, "Matrix-Free Newton: a trial residual failed in J*v");
+    }
+}
+/***********************************************************************/
+/***********************************************************************/
+/* gstatus_add_norms -- the L1, L2 and Loo norms of a distributed vector
+ * in the current gstatus group, from one pass over it. The L1 norm is
+ * gstatus_get(slot[0]), the L2 norm sqrt(gstatus_get(slot[1])) and the
+ * Loo norm gstatus_get_loo(slot, *loc, ...); with vecscal they are the
+ * relative norms of L1_norm_r(), L2_norm_r() and Loo_norm_r(). All of
+ * them share the one reduction of the group. Long vectors are split over
+ * the assembly threads; the pieces are combined in thread order, so the
+ * sums do not change from one run to the next.
+ */
+
+#define NORM_MAX_THREADS 64
+#define NORM_MIN_PER_THREAD 16384
+
+static void
+gstatus_add_norms(double *vector, double *vecscal, int nloc, int slot[3],
+		  int *loc)
+{
+  int		i, t, nthr = 1;
+  double	sum1 = 0., sum2 = 0., big;
+  double	part_sum1[NORM_MAX_THREADS], part_sum2[NORM_MAX_THREADS];
+  double	part_big[NORM_MAX_THREADS];
+  int		part_loc[NORM_MAX_THREADS];
+
+  big = (vecscal == NULL) ? -1.0 : -1.0E200;
+  *loc = 0;
+
+#ifdef _OPENMP
+  nthr = MIN(MAX(Num_Assembly_Threads, 1), NORM_MAX_THREADS);
+  nthr = MAX(MIN(nthr, nloc / NORM_MIN_PER_THREAD), 1);
+#endif
+
+  for (t = 0; t < nthr; t++)
+    {
+      part_sum1[t] = part_sum2[t] = 0.;
+      part_big[t] = big;
+      part_loc[t] = -1;
+    }
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) if (nthr > 1) num_threads(nthr) private(i)
+#endif
+  for (t = 0; t < nthr; t++)
+    {
+      int lo = (int) (((long) nloc * t) / nthr);
+      int hi = (int) (((long) nloc * (t + 1)) / nthr);
+      double s1 = 0., s2 = 0., m = part_big[t], a;
+      int at = -1;
+
+      if (vecscal == NULL)
+	{
+	  for (i = lo; i < hi; i++)
+	    {
+	      a = fabs(vector[i]);
+	      s1 += a;
+	      s2 += vector[i] * vector[i];
+	      if (a > m) { m = a; at = i; }
+	    }
+	}
+      else
+	{
+	  for (i = lo; i < hi; i++)
+	    {
+	      a = fabs(vector[i]) / (1 + fabs(vecscal[i]));
+	      s1 += a;
+	      s2 += vector[i] * vector[i] / (1 + vecscal[i] * vecscal[i]);
+	      if (a > m) { m = a; at = i; }
+	    }
+	}
+      part_sum1[t] = s1;
+      part_sum2[t] = s2;
+      part_big[t] = m;
+      part_loc[t] = at;
+    }
+
+  for (t = 0; t < nthr; t++)
+    {
+      sum1 += part_sum1[t];
+      sum2 += part_sum2[t];
+      if (part_big[t] > big)
+	{
+	  big = part_big[t];
+	  *loc = part_loc[t];
+	}
+    }
+
+  slot[0] = gstatus_add(GSTATUS_SUM, sum1);
+  slot[1] = gstatus_add(GSTATUS_SUM, sum2);
+  slot[2] = gstatus_add_maxloc(big);
+}
+
+static double
+gstatus_get_loo(const int slot[3], const int loc, int *num_unk,
+		char *dofname)
+
+    /*
+     * The Loo norm of gstatus_add_norms(), setting num_unk and dofname
+     * on the processor holding it as Loo_norm() does.
+     */
+{
+  double value = gstatus_get(slot[2]);
+
+  *num_unk = loc;
+#ifdef PARALLEL
+  if ((int) gstatus_get(slot[2] + 1) != ProcID)
+    {
+      *num_unk = -1;
+      if (dofname != NULL) dofname[0] = '\0';
+      return value;
+    }
+#endif /* PARALLEL */
+  dofname40(*num_unk, dofname);
+  return value;
+}
+/***********************************************************************/
+/***********************************************************************/
+/***********************************************************************/
 /* L2_norm -- compute L2 norm of a vector scattered across multiple procs */
 
 double 
@@ -3325,88 +4504,45 @@ print_array(const void *array,
 
 */
 
-static int
-soln_sens ( double lambda,  /*  parameter */
-	    double x[],	/* soln vector */
-	    double xdot[],	/*  dxdt predicted for new time */
-	    double delta_s,	/* step */
-	    Exo_DB *exo,
-	    Dpi *dpi,
-	    Comm_Ex *cx,
-	    double res_p[],
-	    int numProcUnknowns,
-	    int ija[],
-	    double a[],
-	    double x_old[],
-	    double x_older[],
-	    double xdot_old[],
-	    double x_update[],
-	    double delta_t,
-	    double theta,
-	    double time_value,
-	    int num_total_nodes,
-	    double res_m[],
-	    int Factor_Flag,
-	    int matr_form,
-	    double resid_vector_sens[],
-	    double x_sens[],
-	    double **x_sens_p,
-	    double scale[],
-	    struct Aztec_Linear_Solver_System *ams, /* ptrs to
-						     * Aztec 
-						     * linear
-						     * systems
-						     */
-	    int first_linear_solver_call,
-	    int Norm_below_tolerance,
-	    int Rate_above_tolerance,
-	    int vector_id,
-	    int sens_type,
-	    int sens_id,
-	    int sens_flt,
-	    int sens_flt2,
-            int *mf_resolve, /* frontal solver variables */
-            int *fsncod, 
-            double *fsbc, 
-            double *smallpiv, 
-            double *singpiv, 
-            int *iautopiv, 
-	    int *iscale,
-	    double *scaling_max, 
-	    double *ptr_h_elem_avg,
-            double *ptr_U_norm,
-	    int UMF_system_id,
-            char* sens_caller)
+/*
+ * sens_rhs -- dR/dp by central differences of the residual in the
+ * parameter, for soln_sens() and soln_sens_multi(). res_p and res_m are
+ * scratch; the parameter is left at lambda.
+ */
 
+static int
+sens_rhs(double lambda,		/* parameter */
+	 double x[],
+	 double xdot[],
+	 double delta_s,
+	 Exo_DB *exo,
+	 Dpi *dpi,
+	 Comm_Ex *cx,
+	 double res_p[],
+	 double res_m[],
+	 int numProcUnknowns,
+	 double x_old[],
+	 double x_older[],
+	 double xdot_old[],
+	 double x_update[],
+	 double delta_t,
+	 double theta,
+	 double time_value,
+	 int num_total_nodes,
+	 struct Aztec_Linear_Solver_System *ams,
+	 int vector_id,
+	 int sens_type,
+	 int sens_id,
+	 int sens_flt,
+	 int sens_flt2,
+	 double *ptr_h_elem_avg,
+	 double *ptr_U_norm,
+	 double resid_vector_sens[])
 {
   double dlambda, lambda_tmp, hunt_val;
-
-  int i,iHC,iAC;
-  dbl          a_start;        /* mark start of assembly */
-  dbl          a_end;          /* mark end of assembly */
-  int       err;
-
-  int	linear_solver_blk;	/* count calls to AZ_solve() */
-  int	linear_solver_itns;	/* count cumulative linearsolver iterations */
-  int	num_linear_solve_blks;	/* one pass for now */
-  int	matrix_solved;		/* boolean */
-  char		stringer[80];	/* holding format of num linear solve itns */
-
-  double h_elem_avg = *ptr_h_elem_avg;
-  double U_norm = *ptr_U_norm;
-
-  double time_local =0.0;
-  double time_global=0.0;
-
+  int iHC, iAC, err;
   double fd_factor=FD_FACTOR;	/*  finite difference step */
 
-  /*
-  static int first_soln_sens_linear_solver_call = 1;
-  */
-  /*  static int UMF_system_id = -1; *//* We'll give soln_sens it's own UMF
-				  * system space, since it does its own
-				  * matrix_fill's. */
-
   exchange_dof(cx, dpi, x);
 
   /*
@@ -3414,8 +4550,7 @@ soln_sens ( double lambda,  /*  parameter */
    * GET SENSITIVITY OF RESIDUAL TO NATURAL PARAMETER
    *
    */
-	err = 0;
-  a_start = ut();
+  err = 0;
 
   dlambda = fd_factor*lambda;
   dlambda = (fabs(dlambda) < fd_factor ? fd_factor : dlambda);
@@ -3431,6 +4566,7 @@ soln_sens ( double lambda,  /*  parameter */
 	switch (Continuation)
 		{
 		case ALC_FIRST:
+		case ALC_SECOND:
       		update_parameterC(0, lambda_tmp, x, xdot, NULL, delta_s, cx, exo, dpi);
 		break;
 		case HUN_FIRST:
@@ -3474,7 +4610,7 @@ soln_sens ( double lambda,  /*  parameter */
 			 First_Elem_Side_BC_Array, 
 			 &time_value, exo, dpi,
 			 &num_total_nodes,
-			 &h_elem_avg, &U_norm, NULL);
+			 ptr_h_elem_avg, ptr_U_norm, NULL);
   if (err == -1) return(err);
 
   lambda_tmp = lambda-dlambda;
@@ -3483,6 +4619,7 @@ soln_sens ( double lambda,  /*  parameter */
 	switch (Continuation)
 		{
 		case ALC_FIRST:
+		case ALC_SECOND:
 		  update_parameterC(0, lambda_tmp, x, xdot, NULL, delta_s, 
 				    cx, exo, dpi);
 		break;
@@ -3527,7 +4664,7 @@ soln_sens ( double lambda,  /*  parameter */
 			 First_Elem_Side_BC_Array, 
 			 &time_value, exo, dpi,
 			 &num_total_nodes,
-			 &h_elem_avg, &U_norm, NULL);
+			 ptr_h_elem_avg, ptr_U_norm, NULL);
   
   if (err == -1) return(err);
 
@@ -3540,6 +4677,7 @@ soln_sens ( double lambda,  /*  parameter */
 	switch (Continuation)
 		{
 		case ALC_FIRST:
+		case ALC_SECOND:
 		  update_parameterC(0, lambda, x, xdot, NULL, delta_s, cx, exo, dpi);
 		break;
 		case HUN_FIRST:
@@ -3572,6 +4710,100 @@ soln_sens ( double lambda,  /*  parameter */
 	 lambda_tmp, &res_p[0], 
 	-lambda_tmp, &res_m[0]);
 
+  return(err);
+} /* end of sens_rhs() */
+/*****************************************************************************/
+
+static int
+soln_sens ( double lambda,  /*  parameter */
+	    double x[],	/* soln vector */
+	    double xdot[],	/*  dxdt predicted for new time */
+	    double delta_s,	/* step */
+	    Exo_DB *exo,
+	    Dpi *dpi,
+	    Comm_Ex *cx,
+	    double res_p[],
+	    int numProcUnknowns,
+	    int ija[],
+	    double a[],
+	    double x_old[],
+	    double x_older[],
+	    double xdot_old[],
+	    double x_update[],
+	    double delta_t,
+	    double theta,
+	    double time_value,
+	    int num_total_nodes,
+	    double res_m[],
+	    int Factor_Flag,
+	    int matr_form,
+	    double resid_vector_sens[],
+	    double x_sens[],
+	    double **x_sens_p,
+	    double scale[],
+	    struct Aztec_Linear_Solver_System *ams, /* ptrs to
+						     * Aztec 
+						     * linear
+						     * systems
+						     */
+	    int first_linear_solver_call,
+	    int Norm_below_tolerance,
+	    int Rate_above_tolerance,
+	    int vector_id,
+	    int sens_type,
+	    int sens_id,
+	    int sens_flt,
+	    int sens_flt2,
+            int *mf_resolve, /* frontal solver variables */
+            int *fsncod, 
+            double *fsbc, 
+            double *smallpiv, 
+            double *singpiv, 
+            int *iautopiv, 
+	    int *iscale,
+	    double *scaling_max, 
+	    double *ptr_h_elem_avg,
+            double *ptr_U_norm,
+	    int UMF_system_id,
+            char* sens_caller)
+
+{
+  int i;
+  dbl          a_start;        /* mark start of assembly */
+  dbl          a_end;          /* mark end of assembly */
+  int       err;
+
+  int	linear_solver_blk;	/* count calls to AZ_solve() */
+  int	linear_solver_itns;	/* count cumulative linearsolver iterations */
+  int	num_linear_solve_blks;	/* one pass for now */
+  int	matrix_solved;		/* boolean */
+  char		stringer[80];	/* holding format of num linear solve itns */
+
+  double h_elem_avg = *ptr_h_elem_avg;
+  double U_norm = *ptr_U_norm;
+
+  double time_local =0.0;
+  double time_global=0.0;
+
+  /*
+  static int first_soln_sens_linear_solver_call = 1;
+  */
+  /*  static int UMF_system_id = -1; *//* We'll give soln_sens it's own UMF
+				  * system space, since it does its own
+				  * matrix_fill's. */
+
+  a_start = ut();
+
+  /*
+   * GET SENSITIVITY OF RESIDUAL TO NATURAL PARAMETER
+   */
+  err = sens_rhs(lambda, x, xdot, delta_s, exo, dpi, cx, res_p, res_m,
+		 numProcUnknowns, x_old, x_older, xdot_old, x_update,
+		 delta_t, theta, time_value, num_total_nodes, ams,
+		 vector_id, sens_type, sens_id, sens_flt, sens_flt2,
+		 &h_elem_avg, &U_norm, resid_vector_sens);
+  if (err == -1) return(err);
+
   if(vector_id != -1) {
     for(i=0;i<numProcUnknowns;i++) {
       x_sens_p[vector_id+1][i] = resid_vector_sens[i]; 
@@ -3671,9 +4903,12 @@ soln_sens ( double lambda,  /*  parameter */
       /*
        * Initialization is now performed up in
        * solve_problem() in rf_solve.c, not here in the
-       * midst of the Newton iteration.
+       * midst of the Newton iteration. The matrix is the one the
+       * Newton iteration solved last, so a kept preconditioner
+       * serves for the sensitivity too, as it does for the ACs.
        */
-      ams->options[AZ_pre_calc] = AZ_calc;
+      ams->options[AZ_pre_calc] =
+	((ams->options[AZ_keep_info] && !first_linear_solver_call) ? AZ_reuse : AZ_calc);
       
       linear_solver_blk     = 0; /* count calls to AZ_solve() */
       num_linear_solve_blks = 1; /* upper limit to AZ_solve() calls */
@@ -3739,7 +4974,7 @@ soln_sens ( double lambda,  /*  parameter */
     case STRATIMIKOS:
       if ( strcmp( Matrix_Format,"epetra" ) == 0 ) {
         int iterations;
-        int err = stratimikos_solve(ams,  x_sens, resid_vector_sens, &iterations, Stratimikos_File);
+        int err = stratimikos_solve(ams,  x_sens, resid_vector_sens, &iterations, Stratimikos_File, -1.0);
         EH(err, "Error in stratimikos solve");
 	if (iterations == -1) {
 	  strcpy(stringer, "err");
@@ -3802,9 +5037,9 @@ soln_sens ( double lambda,  /*  parameter */
                                     &h_elem_avg,
                                     &U_norm);
 	      /*
-	       * Free memory allocated above
+	       * Clear the quadrature point storage for the next fill
 	       */
-	      global_qp_storage_destroy();
+	      global_qp_storage_reset();
 
 	      if( neg_elem_volume ) err = -1;
 	      if (err == -1) return(err);
@@ -3851,4 +5086,185 @@ soln_sens ( double lambda,  /*  parameter */
 
 	return(err);
 } /*   end of routine soln_sens()   */
+/*****************************************************************************/
+
+static int
+soln_sens_batched(int nsens)
+
+    /*************************************************************************
+     *
+     * soln_sens_batched():
+     *
+     *  Whether soln_sens_multi() can take nsens sensitivities at once with
+     *  the linear solver in use.
+     *************************************************************************/
+{
+  if (nsens < 2) return FALSE;
+  switch (Linear_Solver)
+    {
+    case AMESOS:
+      return (strcmp(Matrix_Format, "msr") == 0 ||
+	      strcmp(Matrix_Format, "epetra") == 0);
+    case STRATIMIKOS:
+      return (strcmp(Matrix_Format, "epetra") == 0);
+    case AZTEC:
+      return TRUE;
+    default:
+      return FALSE;
+    }
+}
+/*****************************************************************************/
+
+static int
+soln_sens_multi(struct sens_param *sp,
+		int nsens,
+		double x[],
+		double xdot[],
+		Exo_DB *exo,
+		Dpi *dpi,
+		Comm_Ex *cx,
+		double res_p[],
+		double res_m[],
+		int numProcUnknowns,
+		double x_old[],
+		double x_older[],
+		double xdot_old[],
+		double x_update[],
+		double delta_t,
+		double theta,
+		double time_value,
+		int num_total_nodes,
+		double x_sens[],
+		double **x_sens_p,
+		double scale[],
+		struct Aztec_Linear_Solver_System *ams,
+		double *ptr_h_elem_avg,
+		double *ptr_U_norm,
+		char *sens_caller)
+
+    /*************************************************************************
+     *
+     * soln_sens_multi():
+     *
+     *  soln_sens() for nsens parameters at once: all the dR/dp are
+     *  assembled first, then J dq/dp = -dR/dp is solved for all of them
+     *  with the factorization (Amesos) or preconditioner (Stratimikos,
+     *  Aztec) of the Newton solve, in one block call where the solver
+     *  takes one. Each dq/dp goes to x_sens_p[vector_id].
+     *************************************************************************/
+{
+  int i, k, err = 0, iterations, keep_info;
+  dbl a_start, a_end;
+  double **rhs, **sol;
+  double h_elem_avg = *ptr_h_elem_avg;
+  double U_norm = *ptr_U_norm;
+  double time_local = 0.0;
+  double time_global = 0.0;
+  char stringer[80];
+
+  a_start = ut();
+
+  rhs = Dmatrix_birth(nsens, numProcUnknowns);
+  sol = Dmatrix_birth(nsens, numProcUnknowns);
+
+  for (k = 0; k < nsens && err != -1; k++)
+    {
+      err = sens_rhs(sp[k].value, x, xdot, delta_t, exo, dpi, cx,
+		     res_p, res_m, numProcUnknowns, x_old, x_older,
+		     xdot_old, x_update, delta_t, theta, time_value,
+		     num_total_nodes, ams, sp[k].vector_id, sp[k].type,
+		     sp[k].id, sp[k].flt, sp[k].flt2, &h_elem_avg, &U_norm,
+		     rhs[k]);
+      vector_scaling(NumUnknowns, rhs[k], scale);
+    }
+  if (err == -1)
+    {
+      Dmatrix_death(rhs, nsens, numProcUnknowns);
+      Dmatrix_death(sol, nsens, numProcUnknowns);
+      return(err);
+    }
+
+  strcpy(stringer, " 1 ");
+  switch (Linear_Solver)
+    {
+    case AMESOS:
+      if( strcmp( Matrix_Format,"msr" ) == 0 ) {
+        amesos_solve_msr_multi( Amesos_Package, ams, sol, rhs, nsens, 0 );
+      } else {
+        amesos_solve_epetra_multi( Amesos_Package, ams, sol, rhs, nsens, 0 );
+      }
+      break;
+
+    case STRATIMIKOS:
+      err = stratimikos_solve_multi(ams, sol, rhs, nsens, &iterations,
+				    Stratimikos_File, -1.0);
+      EH(err, "Error in stratimikos solve");
+      if (iterations == -1) {
+	strcpy(stringer, "err");
+      } else {
+	aztec_stringer(AZ_normal, iterations, &stringer[0]);
+      }
+      break;
+
+    case AZTEC:
+      /*
+       * No block solve: one preconditioner, built for the first right
+       * hand side and kept for the rest.
+       */
+      keep_info = ams->options[AZ_keep_info];
+      ams->options[AZ_keep_info] = 1;
+      for (k = 0; k < nsens; k++)
+	{
+	  ams->options[AZ_pre_calc] = (k == 0) ? AZ_calc : AZ_reuse;
+	  AZ_solve(sol[k], rhs[k], ams->options, ams->params, 
+		   ams->indx, ams->bindx, ams->rpntr, ams->cpntr, 
+		   ams->bpntr, ams->val, ams->data_org, ams->status, 
+		   ams->proc_config);
+	  if ( Debug_Flag > 0 )
+	    {
+	      dump_aztec_status(ams->status);
+	    }
+	  aztec_stringer( (int)ams->status[AZ_why],
+			  ams->status[AZ_its], &stringer[0]);
+	}
+      ams->options[AZ_keep_info] = keep_info;
+      ams->options[AZ_pre_calc] = AZ_calc;
+      break;
+
+    default:
+      EH(-1, "That linear solver package does not take several sensitivities at once.");
+      break;
+    }
+
+  /*
+   * GET RIGHT SIGN FOR dx/dlambda;
+   * ABOVE WE SOLVED:  J dx/d* = dR/d*
+   */
+  for (k = 0; k < nsens; k++)
+    {
+      vchange_sign(numProcUnknowns, sol[k]);
+      exchange_dof(cx, dpi, sol[k]);
+      for (i = 0; i < numProcUnknowns; i++)
+	{
+	  x_sens_p[sp[k].vector_id][i] = sol[k][i];
+	}
+    }
+  dcopy1(numProcUnknowns, sol[nsens-1], x_sens);
+
+  Dmatrix_death(rhs, nsens, numProcUnknowns);
+  Dmatrix_death(sol, nsens, numProcUnknowns);
+
+  a_end = ut();
+  time_local = a_end - a_start;
+#ifdef PARALLEL
+  MPI_Allreduce(&time_local, &time_global, 1,
+                MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+  time_local = time_global;
+#endif
+  DPRINTF(stderr,"\n\n%s (%d at once, %s) resolve time:  %7.1e\n",
+	  sens_caller, nsens, stringer, time_local );
+  sens_caller[0] = '\0';
+
+  return(err);
+} /* end of soln_sens_multi() */
 /* end of file mm_sol_nonlinear.c */
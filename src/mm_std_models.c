@@ -2441,7 +2441,10 @@ Diffusivity (void)
       break;
 
     case USER:     
-      err = usr_diffusivity(w, mp->u_diffusivity[w]);  
+      if (mp->Plugin[GOMA_PLUGIN_DIFFUSIVITY + w] >= 0)
+	err = plugin_property(GOMA_PLUGIN_DIFFUSIVITY, w, tran->time_value);
+      else
+	err = usr_diffusivity(w, mp->u_diffusivity[w]);
       break;
 
     case POROUS:
@@ -158,6 +158,35 @@ int Num_Var_In_Type[MAX_VARIABLE_TYPES] = { 0 };
  */
 int *First_Unknown = NULL;
 
+/*
+ * Unknown_Node_Order:
+ *     The node whose unknowns come k-th in the solution vector, and
+ *     Unknown_Node_Pos its inverse; both NULL when it is the node order
+ *     (see the Node Reorder card).
+ */
+static int *Unknown_Node_Order = NULL;
+static int *Unknown_Node_Pos = NULL;
+
+#define UNKNOWN_NODE(k) \
+  ((Unknown_Node_Order == NULL) ? (k) : Unknown_Node_Order[k])
+
+/*
+ * Periodic links (Periodic Constraints = native):
+ *     the nodes matched across the side sets of the PERIODIC cards of a
+ *     variable form classes. Periodic_Root[k][inode] is the lowest node
+ *     of the class of inode for variable Periodic_Var[k], -1 if inode is
+ *     not periodic in it. Periodic_Link_List holds, node by node, the
+ *     extra graph neighbors the classes need, and Periodic_Fold the
+ *     (slave, root) unknown pairs periodic_fold() works on.
+ */
+static int Num_Periodic_Vars = 0;
+static int Periodic_Var[MAX_VARIABLE_TYPES];
+static int *Periodic_Root[MAX_VARIABLE_TYPES];
+static int *Periodic_Link_Pntr = NULL;
+static int *Periodic_Link_List = NULL;
+static int Num_Periodic_Folds = 0;
+static int *Periodic_Fold = NULL;
+
 /*
  * dofname -- holds strings telling the name of the variable (u1, T, P, etc)
  *            and the global node number associated with a particular gdof.
@@ -1022,8 +1051,19 @@ set_unknown_map(Exo_DB *exo, Dpi *dpi)
    * unknowns at each node. 
    */
   
+  safer_free((void **) &Unknown_Node_Order);
+  safer_free((void **) &Unknown_Node_Pos);
+  Unknown_Node_Order = node_unknown_order(Node_Reorder, exo, dpi);
+  if (Unknown_Node_Order != NULL) {
+    Unknown_Node_Pos = alloc_int_1(total_nodes, -1);
+    for (ii = 0; ii < total_nodes; ii++) {
+      Unknown_Node_Pos[Unknown_Node_Order[ii]] = ii;
+    }
+  }
+
   index = 0;
-  for(i = 0; i < total_nodes; i++) {
+  for(ii = 0; ii < total_nodes; ii++) {
+    i = UNKNOWN_NODE(ii);
     First_Unknown[i] = index;
     Nodes[i]->First_Unknown = index;
     nv = Nodes[i]->Nodal_Vars_Info;
@@ -1179,6 +1219,8 @@ set_unknown_map(Exo_DB *exo, Dpi *dpi)
     print_vars_at_nodes();
   }
 
+  index_solution_tables();
+
   /* Now that the dust has settled, let us translate these quantities
    * into Hoodian frontal solver form if the front method has been requested.
    * While you are at it, run prefront and also load up the element sweep map
@@ -3931,6 +3973,107 @@ set_interaction_masks(Exo_DB *exo)
 /**************************************************************************/
 /**************************************************************************/
 
+static int
+index_table_key(const int varType, const int subvarIndex, const int matID)
+
+    /*
+     * Position of (varType, subvarIndex, matID) in a Nodal_Vars
+     * Index_Table: one row per variable type, then one row per species
+     * for MASS_FRACTION, each with a column for matID = -2 .. Num_Mat-1.
+     */
+{
+  int row = (varType == MASS_FRACTION) ? V_LAST + subvarIndex : varType;
+  return row * (upd->Num_Mat + 2) + matID + 2;
+}
+
+static int
+index_solution_match(NODAL_VARS_STRUCT *nv, const int varType,
+		     const int subvarIndex, const int matID)
+
+    /*
+     * The Var_Desc_List[] entry that Index_Solution() wants for these
+     * arguments, or -1: the first one of the type (and species) with
+     * this MatID, or any MatID for -2, else the last one with MatID -1.
+     */
+{
+  int index, i_match = -1, i, ifound = 0;
+  VARIABLE_DESCRIPTION_STRUCT *vd;
+
+  if (varType == MASS_FRACTION) {
+    index = nv->Num_Var_Desc_Per_Type[varType] / upd->Max_Num_Species_Eqn;
+    for (i = 0; i < nv->Num_Var_Desc; i++) {
+      vd = nv->Var_Desc_List[i];
+      if ((vd->Variable_Type == MASS_FRACTION) &&
+	  (vd->Subvar_Index  == subvarIndex)) {
+	if (vd->MatID == matID || matID == -2) {
+	  i_match = i;
+	  break;
+	} else if (vd->MatID == -1) {
+	  i_match = i;
+	}
+	ifound++;
+	if (ifound == index) break;
+      }
+    }
+  } else {
+    for (i = 0; i < nv->Num_Var_Desc; i++) {
+      vd = nv->Var_Desc_List[i];
+      if (vd->Variable_Type == varType) {
+	if (vd->MatID == matID || matID == -2) {
+	  i_match = i;
+	  break;
+	} else if (vd->MatID == -1) {
+	  i_match = i;
+	}
+	ifound++;
+	if (ifound == (int) nv->Num_Var_Desc_Per_Type[varType]) break;
+      }
+    }
+  }
+  return i_match;
+}
+
+void
+index_solution_tables(void)
+
+    /********************************************************************
+     *
+     * index_solution_tables():
+     *
+     *   Tabulate the Index_Solution() match for every variable type,
+     *   species and material in each unique Nodal_Vars structure, so
+     *   that lookups no longer search Var_Desc_List. Called once the
+     *   nodal variable patterns are final, at the end of
+     *   set_unknown_map(); until then Index_Solution() searches.
+     ********************************************************************/
+{
+  int n, v, k, m, len;
+  NODAL_VARS_STRUCT *nv;
+
+  len = index_table_key(MASS_FRACTION, upd->Max_Num_Species_Eqn, -2);
+  for (n = 0; n < Nodal_Vars_List_Length; n++) {
+    nv = Nodal_Vars_List[n];
+    safer_free((void **) &(nv->Index_Table));
+    nv->Index_Table = (short int *) smalloc(len * sizeof(short int));
+    for (v = V_FIRST; v < V_LAST; v++) {
+      for (m = -2; m < upd->Num_Mat; m++) {
+	if (v == MASS_FRACTION) {
+	  for (k = 0; k < upd->Max_Num_Species_Eqn; k++) {
+	    nv->Index_Table[index_table_key(v, k, m)] =
+	      (nv->Num_Var_Desc_Per_Type[v] == 0) ? -1 :
+	      index_solution_match(nv, v, k, m);
+	  }
+	} else {
+	  nv->Index_Table[index_table_key(v, 0, m)] =
+	    (nv->Num_Var_Desc_Per_Type[v] == 0) ? -1 :
+	    index_solution_match(nv, v, 0, m);
+	}
+      }
+    }
+  }
+}
+/**************************************************************************/
+
 int Index_Solution(
     const int nodeNum, const int varType, const int subvarIndex, const int iNdof, const int matID)
 
@@ -3980,13 +4123,13 @@ int Index_Solution(
  *   and residual fills.
  **********************************************************************/
 {
-  int dofp, index, i_match = -1, i, ifound;
+  int dofp, index, i_match;
   /*
    * Pointer to the node info struct for this node
    */
   NODE_INFO_STRUCT *node_ptr = Nodes[nodeNum];
   NODAL_VARS_STRUCT *nv = node_ptr->Nodal_Vars_Info;
-  VARIABLE_DESCRIPTION_STRUCT *vd_match = NULL, *vd;
+  VARIABLE_DESCRIPTION_STRUCT *vd_match;
   /*
    * Do extra debugging of argument list when in debug mode
    */
@@ -4014,52 +4157,25 @@ int Index_Solution(
    */
   if (nv->Num_Var_Desc_Per_Type[varType] == 0) return -1;
 
-  if (varType == MASS_FRACTION) {
-    ifound = 0;
-    if (subvarIndex >= upd->Max_Num_Species_Eqn) {
-	printf("ERROR Index_Solution: subvarIndex is bad: %d\n", 
-	       subvarIndex);
-	EH(-1,"ERROR Index_Solution: subvarIndex is bad");
-    }
-    index = nv->Num_Var_Desc_Per_Type[varType] / upd->Max_Num_Species_Eqn;
-    for (i = 0; i < nv->Num_Var_Desc; i++) {
-      vd = nv->Var_Desc_List[i];
-      if ((vd->Variable_Type == MASS_FRACTION) &&
-	  (vd->Subvar_Index  == subvarIndex)) {
-	if (vd->MatID == matID || matID == -2) {
-	  vd_match = vd;
-	  i_match = i;
-	  break;
-	} else if (vd->MatID == -1) {
-	  vd_match = vd;
-	  i_match = i;
-	}
-	ifound++;
-	if (ifound == index) break;
-      }
-    }
+  if (varType == MASS_FRACTION && subvarIndex >= upd->Max_Num_Species_Eqn) {
+    printf("ERROR Index_Solution: subvarIndex is bad: %d\n", 
+	   subvarIndex);
+    EH(-1,"ERROR Index_Solution: subvarIndex is bad");
+  }
+
+  /*
+   * The match only depends on the nodal variable pattern, so it comes
+   * out of the pattern's table when there is one.
+   */
+  if (nv->Index_Table != NULL && matID >= -2 && matID < upd->Num_Mat) {
+    i_match = nv->Index_Table[index_table_key(varType, subvarIndex, matID)];
   } else {
-    ifound = 0;
-    for (i = 0; i < nv->Num_Var_Desc; i++) {
-      vd = nv->Var_Desc_List[i];
-      if (vd->Variable_Type == varType) {
-	if (vd->MatID == matID || matID == -2) {
-	  vd_match = vd;
-	  i_match = i;
-	  break;
-	} else if (vd->MatID == -1) {
-	  vd_match = vd;
-	  i_match = i;
-	}
-	ifound++;
-	if (ifound == (int) nv->Num_Var_Desc_Per_Type[varType]) break;
-      }
-    }
+    i_match = index_solution_match(nv, varType, subvarIndex, matID);
   }
-  
-  if (vd_match == NULL) {
+  if (i_match < 0) {
     return -1;
   }
+  vd_match = nv->Var_Desc_List[i_match];
   
   /*
    * Gather the local number of degrees of this variable type at this
@@ -4256,11 +4372,13 @@ Index_Solution_Inv(const int gindex, int *inode, int *i_Var_Desc,
   /*
    * Do a modified binary search to find the global node number
    * This assumes that First_Unknown is a unique, monotonically,
-   * increasing function of the processor node number.
+   * increasing function of the position of the node in the unknown
+   * order, which is the processor node number unless the nodes were
+   * reordered.
    *  Note: log(N) cost so this is well worth it.
    */
   top = DPI_ptr->num_owned_nodes + DPI_ptr->num_external_nodes - 1;
-  val_top = Nodes[top]->First_Unknown;
+  val_top = Nodes[UNKNOWN_NODE(top)]->First_Unknown;
   if (gindex >= val_top) {
     Inode = top;
     goto found_node;
@@ -4273,14 +4391,17 @@ Index_Solution_Inv(const int gindex, int *inode, int *i_Var_Desc,
 
   if (inode) {
     middle = (int)(*inode);
+    if (Unknown_Node_Pos != NULL && middle >= 0 && middle <= top) {
+      middle = Unknown_Node_Pos[middle];
+    }
     if (middle >= 0 && middle < top) {
-      if (gindex < Nodes[middle+1]->First_Unknown) {
-        if (gindex >= Nodes[middle]->First_Unknown) {
+      if (gindex < Nodes[UNKNOWN_NODE(middle+1)]->First_Unknown) {
+        if (gindex >= Nodes[UNKNOWN_NODE(middle)]->First_Unknown) {
           Inode = middle;
 	  goto found_node;
 	}
-      } else {
-        if (gindex < Nodes[middle+2]->First_Unknown) {
+      } else if (middle + 2 <= top) {
+        if (gindex < Nodes[UNKNOWN_NODE(middle+2)]->First_Unknown) {
           Inode = middle + 1;
 	  goto found_node;
 	}
@@ -4293,7 +4414,7 @@ Index_Solution_Inv(const int gindex, int *inode, int *i_Var_Desc,
   bottom = 0;
   while ( (diff = top - bottom) > 1) {
     middle = bottom + diff/2;
-    val_mid = Nodes[middle]->First_Unknown;
+    val_mid = Nodes[UNKNOWN_NODE(middle)]->First_Unknown;
     if (gindex > val_mid) {
       bottom = middle;
     } else if (gindex < val_mid) {
@@ -4317,11 +4438,12 @@ Index_Solution_Inv(const int gindex, int *inode, int *i_Var_Desc,
    * until we hit a node with unknowns.
    */
   
-  nv = Nodes[Inode]->Nodal_Vars_Info;
+  nv = Nodes[UNKNOWN_NODE(Inode)]->Nodal_Vars_Info;
   while (nv->Num_Unknowns == 0) {
     Inode++;
-    nv = Nodes[Inode]->Nodal_Vars_Info;
+    nv = Nodes[UNKNOWN_NODE(Inode)]->Nodal_Vars_Info;
   }
+  Inode = UNKNOWN_NODE(Inode);
   /*
    * OK, we found the global node number, Inode.
    */
@@ -4422,3 +4544,493 @@ dofname40(const int unknown, char *str)
 /*****************************************************************************/
 /*****************************************************************************/
 /*****************************************************************************/
+
+int
+var_type_dof_sets(const int num_rows,
+		  int **set_var,
+		  int **set_ptr,
+		  int **set_list)
+
+    /*********************************************************************
+     *
+     * var_type_dof_sets():
+     *
+     *  Group the processor unknowns 0 .. num_rows-1 by variable type, so
+     *  that solvers can build block (field-split) preconditioners. All
+     *  species unknowns go into the one MASS_FRACTION set.
+     *
+     *  Output (allocated here, free with safer_free())
+     * ---------
+     *  set_var[s]  -> variable type of set s
+     *  set_list[set_ptr[s]] .. set_list[set_ptr[s+1]-1]
+     *              -> unknowns of set s, in increasing order
+     *
+     *  Returns the number of sets.
+     *********************************************************************/
+{
+  int i, s, v, num_sets = 0;
+  int *count, *set_of_var;
+
+  if (idv == NULL) EH(-1, "var_type_dof_sets called before set_unknown_map");
+
+  count = alloc_int_1(MAX_VARIABLE_TYPES, 0);
+  set_of_var = alloc_int_1(MAX_VARIABLE_TYPES, -1);
+
+  for (i = 0; i < num_rows; i++) {
+    v = idv[i][0];
+    if (v < 0 || v >= MAX_VARIABLE_TYPES) EH(-1, "Bad variable type in idv");
+    count[v]++;
+  }
+
+  *set_var = alloc_int_1(MAX_VARIABLE_TYPES, -1);
+  *set_ptr = alloc_int_1(MAX_VARIABLE_TYPES + 1, 0);
+  for (v = 0; v < MAX_VARIABLE_TYPES; v++) {
+    if (count[v] > 0) {
+      set_of_var[v] = num_sets;
+      (*set_var)[num_sets] = v;
+      (*set_ptr)[num_sets+1] = (*set_ptr)[num_sets] + count[v];
+      num_sets++;
+    }
+  }
+
+  *set_list = alloc_int_1(MAX(num_rows, 1), -1);
+  for (s = 0; s < num_sets; s++) count[s] = (*set_ptr)[s];
+  for (i = 0; i < num_rows; i++) {
+    s = set_of_var[idv[i][0]];
+    (*set_list)[count[s]++] = i;
+  }
+
+  safer_free((void **) &count);
+  safer_free((void **) &set_of_var);
+  return num_sets;
+}
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
+int
+node_dof_blocks(const int num_rows,
+		int **block_of_row)
+
+    /*********************************************************************
+     *
+     * node_dof_blocks():
+     *
+     *  Group the processor unknowns 0 .. num_rows-1 by the node they
+     *  belong to, so that solvers can build point-block preconditioners
+     *  with one dense block per node. The unknowns of a node are
+     *  contiguous in the solution vector, so the blocks are numbered in
+     *  the order their first unknown appears.
+     *
+     *  Output (allocated here, free with safer_free())
+     * ---------
+     *  block_of_row[i] -> node block of unknown i
+     *
+     *  Returns the number of blocks.
+     *********************************************************************/
+{
+  int i, num_blocks = 0;
+
+  if (idv == NULL) EH(-1, "node_dof_blocks called before set_unknown_map");
+
+  *block_of_row = alloc_int_1(MAX(num_rows, 1), -1);
+  for (i = 0; i < num_rows; i++) {
+    if (i == 0 || idv[i][2] != idv[i-1][2]) num_blocks++;
+    (*block_of_row)[i] = num_blocks - 1;
+  }
+  return num_blocks;
+}
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
+int
+near_null_space(const int num_rows,
+		double **vectors)
+
+    /*********************************************************************
+     *
+     * near_null_space():
+     *
+     *  Near null space of the processor unknowns 0 .. num_rows-1 for
+     *  smoothed aggregation multigrid: the rigid body modes, from the
+     *  node coordinates, of the mesh displacements and, separately, of
+     *  the real-solid displacements (Num_Dim translations and 1 or 3
+     *  rotations each), then one constant vector for each other
+     *  variable type present.
+     *
+     *  Output (allocated here, free with safer_free())
+     * ---------
+     *  vectors[k*num_rows + i] -> unknown i of vector k
+     *
+     *  Returns the number of vectors.
+     *********************************************************************/
+{
+  int i, k, v, g, c, node, num_vectors = 0, num_rot;
+  int first[2] = {MESH_DISPLACEMENT1, SOLID_DISPLACEMENT1};
+  int have[MAX_VARIABLE_TYPES], vector_of_var[MAX_VARIABLE_TYPES];
+  int group_vector[2];
+  double *z, xyz[3];
+
+  if (idv == NULL) EH(-1, "near_null_space called before set_unknown_map");
+
+  for (v = 0; v < MAX_VARIABLE_TYPES; v++) {
+    have[v] = FALSE;
+    vector_of_var[v] = -1;
+  }
+  for (i = 0; i < num_rows; i++) have[idv[i][0]] = TRUE;
+
+  num_rot = (Num_Dim == 3) ? 3 : 1;
+  for (g = 0; g < 2; g++) {
+    group_vector[g] = -1;
+    for (c = 0; c < Num_Dim; c++) {
+      if (have[first[g] + c]) group_vector[g] = 0;
+    }
+    if (group_vector[g] == 0) {
+      group_vector[g] = num_vectors;
+      num_vectors += Num_Dim + num_rot;
+    }
+    for (c = 0; c < Num_Dim; c++) have[first[g] + c] = FALSE;
+  }
+  for (v = 0; v < MAX_VARIABLE_TYPES; v++) {
+    if (have[v]) vector_of_var[v] = num_vectors++;
+  }
+
+  *vectors = alloc_dbl_1(MAX(num_vectors * num_rows, 1), 0.);
+  z = *vectors;
+
+  for (i = 0; i < num_rows; i++) {
+    v = idv[i][0];
+    if (vector_of_var[v] >= 0) {
+      z[vector_of_var[v] * num_rows + i] = 1.;
+      continue;
+    }
+    for (g = 0; g < 2; g++) {
+      c = v - first[g];
+      if (c >= 0 && c < Num_Dim) break;
+    }
+    if (g == 2) continue;
+
+    node = idv[i][2];
+    xyz[2] = 0.;
+    for (k = 0; k < Num_Dim; k++) xyz[k] = Coor[k][node];
+
+    /* translation along c */
+    k = group_vector[g];
+    z[(k + c) * num_rows + i] = 1.;
+
+    /* rotations: in 2D about z, in 3D about x, y and z */
+    k += Num_Dim;
+    if (Num_Dim == 3) {
+      if (c == 1) z[k * num_rows + i] = -xyz[2];
+      if (c == 2) z[k * num_rows + i] =  xyz[1];
+      k++;
+      if (c == 0) z[k * num_rows + i] =  xyz[2];
+      if (c == 2) z[k * num_rows + i] = -xyz[0];
+      k++;
+    }
+    if (c == 0) z[k * num_rows + i] = -xyz[1];
+    if (c == 1) z[k * num_rows + i] =  xyz[0];
+  }
+  return num_vectors;
+}
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
+static int
+periodic_root_find(const int *root, int inode)
+{
+  while (root[inode] >= 0 && root[inode] != inode) inode = root[inode];
+  return inode;
+}
+
+/*
+ * The extra graph neighbors of node inode, in links[] when that is not
+ * NULL; returns how many. These are the other members of its class in
+ * class_root[] and all of their element neighbors, so that any member's
+ * row can be folded into any other's. mark[] must not hold inode+1
+ * anywhere on entry.
+ */
+
+static int
+periodic_node_links(Exo_DB *exo,
+		    const int inode,
+		    const int *class_root,
+		    const int *member_ptr,
+		    const int *member,
+		    int *mark,
+		    int *links)
+{
+  int j, m, c, nbr, n = 0;
+
+  if (class_root[inode] < 0) return 0;
+
+  mark[inode] = inode + 1;
+  for (j = exo->node_node_pntr[inode]; j < exo->node_node_pntr[inode+1]; j++) {
+    mark[exo->node_node_list[j]] = inode + 1;
+  }
+
+  for (m = member_ptr[class_root[inode]]; m < member_ptr[class_root[inode]+1]; m++) {
+    c = member[m];
+    if (mark[c] != inode + 1) {
+      mark[c] = inode + 1;
+      if (links != NULL) links[n] = c;
+      n++;
+    }
+    for (j = exo->node_node_pntr[c]; j < exo->node_node_pntr[c+1]; j++) {
+      nbr = exo->node_node_list[j];
+      if (mark[nbr] != inode + 1) {
+	mark[nbr] = inode + 1;
+	if (links != NULL) links[n] = nbr;
+	n++;
+      }
+    }
+  }
+  return n;
+}
+
+int
+periodic_links_setup(Exo_DB *exo,
+		     Dpi *dpi)
+
+    /*********************************************************************
+     *
+     * periodic_links_setup():
+     *
+     *  With Periodic Constraints = native, turn the PERIODIC augmenting
+     *  conditions into periodic links and take them out of augc[]. A
+     *  node matched on several cards of the same variable (the corners
+     *  of a doubly periodic cell) ends up in a single class. Call once
+     *  the unknown map is set and before the matrix graph is built.
+     *
+     *  The matched nodes of a class must either all be owned by this
+     *  processor or all be external to it.
+     *
+     *  Returns the number of linked unknowns on all processors.
+     *********************************************************************/
+{
+  int iAC, jAC, k, i, m, a, b, r, rs, rr, npairs, num_links;
+  int num_nodes = exo->num_nodes;
+  int owned_nodes = dpi->num_internal_nodes + dpi->num_boundary_nodes;
+  int *list1, *list2, *mark, *class_root, *member_ptr, *member;
+
+  if (!Periodic_Native || nAC == 0 || Periodic_Link_Pntr != NULL) return 0;
+
+  /*
+   * class_root[] joins the classes of all the variables; the graph is
+   * built from it.
+   */
+  class_root = alloc_int_1(MAX(num_nodes, 1), -1);
+
+  for (iAC = 0; iAC < nAC; iAC++) {
+    if (augc[iAC].Type != AC_PERIODIC) continue;
+    for (k = 0; k < Num_Periodic_Vars; k++) {
+      if (Periodic_Var[k] == augc[iAC].VAR) break;
+    }
+    if (k == Num_Periodic_Vars) {
+      Periodic_Var[k] = augc[iAC].VAR;
+      Periodic_Root[k] = alloc_int_1(MAX(num_nodes, 1), -1);
+      Num_Periodic_Vars++;
+    }
+    npairs = periodic_node_pairs(exo, augc[iAC].SSID, augc[iAC].SSID2,
+				 &list1, &list2);
+    for (i = 0; i < npairs; i++) {
+      if (Index_Solution(list1[i], Periodic_Var[k], 0, 0, -1) < 0 ||
+	  Index_Solution(list2[i], Periodic_Var[k], 0, 0, -1) < 0) continue;
+      a = periodic_root_find(Periodic_Root[k], list1[i]);
+      b = periodic_root_find(Periodic_Root[k], list2[i]);
+      if (a != b) {
+	Periodic_Root[k][MIN(a, b)] = MIN(a, b);
+	Periodic_Root[k][MAX(a, b)] = MIN(a, b);
+      }
+      a = periodic_root_find(class_root, list1[i]);
+      b = periodic_root_find(class_root, list2[i]);
+      if (a != b) {
+	class_root[MIN(a, b)] = MIN(a, b);
+	class_root[MAX(a, b)] = MIN(a, b);
+      }
+    }
+    safe_free(list1);
+    safe_free(list2);
+  }
+
+  /*
+   * The PERIODIC cards have done their job
+   */
+  for (iAC = 0, jAC = 0; iAC < nAC; iAC++) {
+    if (augc[iAC].Type == AC_PERIODIC) continue;
+    if (jAC != iAC) augc[jAC] = augc[iAC];
+    jAC++;
+  }
+  nAC = jAC;
+  for (iAC = 0; iAC < nAC; iAC++) augc[iAC].nAC = nAC;
+
+  /*
+   * Point every node straight at its root and pair up the unknowns to
+   * fold, slave into root.
+   */
+  for (k = 0; k < Num_Periodic_Vars; k++) {
+    for (i = 0; i < num_nodes; i++) {
+      if (Periodic_Root[k][i] >= 0) {
+	Periodic_Root[k][i] = periodic_root_find(Periodic_Root[k], i);
+      }
+    }
+  }
+  for (i = 0; i < num_nodes; i++) {
+    if (class_root[i] >= 0) class_root[i] = periodic_root_find(class_root, i);
+    r = class_root[i];
+    if (r >= 0 && (i < owned_nodes) != (r < owned_nodes)) {
+      EH(-1, "Periodic Constraints = native: a periodic pair is split between processors");
+    }
+  }
+
+  Num_Periodic_Folds = 0;
+  for (k = 0; k < Num_Periodic_Vars; k++) {
+    for (i = 0; i < owned_nodes; i++) {
+      r = Periodic_Root[k][i];
+      if (r >= 0 && r != i) Num_Periodic_Folds++;
+    }
+  }
+  Periodic_Fold = alloc_int_1(MAX(2*Num_Periodic_Folds, 1), -1);
+  m = 0;
+  for (k = 0; k < Num_Periodic_Vars; k++) {
+    for (i = 0; i < owned_nodes; i++) {
+      r = Periodic_Root[k][i];
+      if (r < 0 || r == i) continue;
+      rs = Index_Solution(i, Periodic_Var[k], 0, 0, -1);
+      rr = Index_Solution(r, Periodic_Var[k], 0, 0, -1);
+      if (rs < 0 || rr < 0) continue;
+      Periodic_Fold[2*m] = rs;
+      Periodic_Fold[2*m+1] = rr;
+      m++;
+    }
+  }
+  Num_Periodic_Folds = m;
+
+  /*
+   * The members of each class by root, then the extra graph neighbors
+   * of every node, counted and listed.
+   */
+  member_ptr = alloc_int_1(num_nodes + 1, 0);
+  for (i = 0; i < num_nodes; i++) {
+    if (class_root[i] >= 0) member_ptr[class_root[i]+1]++;
+  }
+  for (i = 0; i < num_nodes; i++) member_ptr[i+1] += member_ptr[i];
+  member = alloc_int_1(MAX(member_ptr[num_nodes], 1), -1);
+  mark = alloc_int_1(MAX(num_nodes, 1), 0);
+  for (i = 0; i < num_nodes; i++) {
+    r = class_root[i];
+    if (r >= 0) member[member_ptr[r] + mark[r]++] = i;
+  }
+
+  memset(mark, 0, num_nodes * sizeof(int));
+  Periodic_Link_Pntr = alloc_int_1(num_nodes + 1, 0);
+  for (i = 0; i < num_nodes; i++) {
+    Periodic_Link_Pntr[i+1] = Periodic_Link_Pntr[i] +
+      periodic_node_links(exo, i, class_root, member_ptr, member, mark, NULL);
+  }
+  memset(mark, 0, num_nodes * sizeof(int));
+  Periodic_Link_List = alloc_int_1(MAX(Periodic_Link_Pntr[num_nodes], 1), -1);
+  for (i = 0; i < num_nodes; i++) {
+    periodic_node_links(exo, i, class_root, member_ptr, member, mark,
+			Periodic_Link_List + Periodic_Link_Pntr[i]);
+  }
+  safer_free((void **) &mark);
+  safer_free((void **) &member_ptr);
+  safer_free((void **) &member);
+  safer_free((void **) &class_root);
+
+  num_links = gsum_Int(Num_Periodic_Folds);
+  DPRINTF(stderr, "\tLinked %d periodic unknowns to their partners.\n", num_links);
+  return num_links;
+}
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
+int
+periodic_graph_links(const int inode,
+		     const int **links)
+
+    /*********************************************************************
+     *
+     * periodic_graph_links():
+     *
+     *  The nodes that node inode must be coupled to in the matrix graph
+     *  on top of its own element neighbors, because of periodic links.
+     *
+     *  Returns how many, listed in (*links)[].
+     *********************************************************************/
+{
+  if (Periodic_Link_Pntr == NULL) return 0;
+  *links = Periodic_Link_List + Periodic_Link_Pntr[inode];
+  return Periodic_Link_Pntr[inode+1] - Periodic_Link_Pntr[inode];
+}
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
+static int
+periodic_msr_entry(const int *ija,
+		   const int row,
+		   const int col)
+{
+  int k;
+
+  if (col == row) return row;
+  k = in_list(col, ija[row], ija[row+1], (int *) ija);
+  EH(k, "Periodic link coupling missing from the sparse matrix.");
+  return k;
+}
+
+void
+periodic_fold(struct Aztec_Linear_Solver_System *ams,
+	      const double x[],
+	      double resid_vector[])
+
+    /*********************************************************************
+     *
+     * periodic_fold():
+     *
+     *  After an assembly, add the residual and Jacobian rows of every
+     *  linked slave unknown into those of its root, then make the slave
+     *  row read x_slave - x_root = 0. For the stability mass matrix the
+     *  slave row is just cleared. Pairs where either unknown carries a
+     *  Dirichlet condition are left alone: the Dirichlet row wins.
+     *********************************************************************/
+{
+  int l, k, rs, rr, node;
+  int *ija = ams->bindx;
+  double *a = ams->val;
+  int jac = (af->Assemble_Jacobian || af->Assemble_LSA_Mass_Matrix) && a != NULL;
+
+  for (l = 0; l < Num_Periodic_Folds; l++) {
+    rs = Periodic_Fold[2*l];
+    rr = Periodic_Fold[2*l+1];
+    node = idv[rs][2];
+    if (Nodes[node]->DBC != NULL &&
+	Nodes[node]->DBC[rs - Nodes[node]->First_Unknown] != -1) continue;
+    node = idv[rr][2];
+    if (Nodes[node]->DBC != NULL &&
+	Nodes[node]->DBC[rr - Nodes[node]->First_Unknown] != -1) continue;
+
+    resid_vector[rr] += resid_vector[rs];
+    resid_vector[rs] = x[rs] - x[rr];
+    if (!jac) continue;
+
+    a[periodic_msr_entry(ija, rr, rs)] += a[rs];
+    a[rs] = 0.0;
+    for (k = ija[rs]; k < ija[rs+1]; k++) {
+      a[periodic_msr_entry(ija, rr, ija[k])] += a[k];
+      a[k] = 0.0;
+    }
+    if (!af->Assemble_LSA_Mass_Matrix) {
+      a[rs] = 1.0;
+      a[periodic_msr_entry(ija, rs, rr)] = -1.0;
+    }
+  }
+}
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
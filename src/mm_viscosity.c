@@ -47,6 +47,7 @@
 #include "mm_mp.h"
 
 #include "mm_eh.h"
+#include "mm_dual.h"
 
 #define _MM_VISCOSITY_C
 #include "goma.h"
@@ -57,8 +58,10 @@
  *     viscosity()
  *      (then submodels for viscosity called by viscosity:)
  *        power_law_viscosity()
+ *          power_law_viscosity_batch()
  *        herschel_buckley_viscosity()
  *        carreau_viscosity()
+ *          carreau_viscosity_batch()
  *        bingham_viscosity()
  *        bingham_wlf_viscosity()
  *        carreau_wlf_viscosity()
@@ -77,6 +80,216 @@
  *        ls_modulate_viscosity()
  *     copy_pF_to_F()
  */
+/*
+ * Helpers for the models written on dual numbers (mm_dual.h), which get
+ * all of their dependence on the Gauss point shear rate, temperature and
+ * level set parameters from the arithmetic instead of by hand.
+ */
+
+/* A model parameter: a constant, or, for a LEVEL_SET model, a dual in its
+ * own slot, with the parameter's FILL dependence kept for visc_dual_load()
+ */
+static DUAL
+visc_dual_param(const int model,
+		const dbl value,
+		const dbl *u_value,
+		const int slot,
+		const int want_deriv,
+		int ls_slot[],
+		int *n_ls,
+		dbl d_par_dF[][MDE])
+{
+  dbl p;
+
+  if (model != LEVEL_SET) return dual_const(value);
+
+  memset(d_par_dF[*n_ls], 0, MDE*sizeof(dbl));
+  level_set_property(u_value[0], u_value[1], u_value[2], &p,
+		     want_deriv ? d_par_dF[*n_ls] : NULL);
+  ls_slot[(*n_ls)++] = slot;
+  return dual_var(p, slot);
+}
+
+/* Fill d_mu from the slot derivatives of mu by the chain rule through the
+ * shear rate (velocity and mesh), the temperature and the level set
+ * parameters. slot_T is -1 for models without temperature dependence.
+ */
+static void
+visc_dual_load(const DUAL *mu,
+	       const int slot_gd,
+	       const int slot_T,
+	       const dbl gammadot,
+	       dbl d_gd_dv[DIM][MDE],
+	       dbl d_gd_dmesh[DIM][MDE],
+	       const int n_ls,
+	       const int ls_slot[],
+	       dbl d_par_dF[][MDE],
+	       VISCOSITY_DEPENDENCE_STRUCT *d_mu)
+{
+  int a, b, i, j, k;
+  int shear_sens = (gammadot != 0.0 && Include_Visc_Sens);
+  dbl dmudT;
+
+  d_mu->gd = mu->d[slot_gd];
+
+  if ( slot_T >= 0 && pd->e[TEMPERATURE] )
+    {
+      dmudT = mu->d[slot_T];
+      if(!isfinite(dmudT)) { dmudT = DBL_MAX; }
+      for ( j=0; j<ei->dof[TEMPERATURE]; j++)
+	{
+	  d_mu->T[j]= dmudT * bf[TEMPERATURE]->phi[j];
+	}
+    }
+
+  if ( pd->e[R_MESH1] )
+    {
+      for ( b=0; b<VIM; b++)
+	{
+	  for ( j=0; j<ei->dof[R_MESH1]; j++)
+	    {
+	      d_mu->X[b][j] = shear_sens ? d_mu->gd * d_gd_dmesh[b][j] : 0.0;
+	    }
+	}
+    }
+
+  if ( pd->e[R_MOMENTUM1] )
+    {
+      for ( a=0; a<VIM; a++)
+	{
+	  for ( i=0; i<ei->dof[VELOCITY1]; i++)
+	    {
+	      d_mu->v[a][i] = shear_sens ? d_mu->gd * d_gd_dv[a][i] : 0.0;
+	    }
+	}
+    }
+
+  if ( n_ls > 0 )
+    {
+      for ( j=0; j<ei->dof[ls->var]; j++)
+	{
+	  d_mu->F[j] = 0.;
+	  for ( k=0; k<n_ls; k++)
+	    {
+	      d_mu->F[j] += mu->d[ls_slot[k]] * d_par_dF[k][j];
+	    }
+	}
+    }
+}
+
+/*
+ * Viscosities already worked out at the current Gauss point. The momentum,
+ * continuity (PSPG), energy and stress assembly all ask for the viscosity
+ * there, with the same field variables. matrix_fill() switches the cache
+ * on once a Gauss point is loaded, and every load_fv() switches it off
+ * again. Only the shear rate models of set_shear_viscosity() are kept:
+ * they depend on nothing but their parameters, the strain rate passed in,
+ * the temperature and the level set, and they have no side effects on mp.
+ */
+
+#define VISC_QP_CACHE_SLOTS 4	/* the solvent and a few polymer modes */
+
+static struct {
+  int on;
+  int num;
+  GEN_NEWT_STRUCT *gn[VISC_QP_CACHE_SLOTS];
+  struct Level_Set_Data *ls[VISC_QP_CACHE_SLOTS];
+  dbl T[VISC_QP_CACHE_SLOTS];
+  dbl gamma_dot[VISC_QP_CACHE_SLOTS][DIM][DIM];
+  int have_d_mu[VISC_QP_CACHE_SLOTS];
+  dbl mu[VISC_QP_CACHE_SLOTS];
+  VISCOSITY_DEPENDENCE_STRUCT d_mu[VISC_QP_CACHE_SLOTS];
+} Visc_QP_Cache;
+
+void
+viscosity_qp_cache(const int on)
+{
+  Visc_QP_Cache.on = on;
+  Visc_QP_Cache.num = 0;
+}
+
+static int
+visc_qp_cache_find(GEN_NEWT_STRUCT *gn_local,
+		   dbl gamma_dot[DIM][DIM],
+		   const int want_d_mu)
+{
+  int k;
+
+  for ( k=0; k<Visc_QP_Cache.num; k++)
+    {
+      if ( Visc_QP_Cache.gn[k] == gn_local &&
+	   Visc_QP_Cache.ls[k] == ls &&
+	   Visc_QP_Cache.T[k] == fv->T &&
+	   (Visc_QP_Cache.have_d_mu[k] || !want_d_mu) &&
+	   memcmp(Visc_QP_Cache.gamma_dot[k], gamma_dot,
+		  DIM*DIM*sizeof(dbl)) == 0 ) return k;
+    }
+  return -1;
+}
+
+static void
+visc_qp_cache_store(GEN_NEWT_STRUCT *gn_local,
+		    dbl gamma_dot[DIM][DIM],
+		    const dbl mu,
+		    const VISCOSITY_DEPENDENCE_STRUCT *d_mu)
+{
+  int k = Visc_QP_Cache.num;
+
+  if ( k == VISC_QP_CACHE_SLOTS ) return;
+  Visc_QP_Cache.gn[k] = gn_local;
+  Visc_QP_Cache.ls[k] = ls;
+  Visc_QP_Cache.T[k] = fv->T;
+  memcpy(Visc_QP_Cache.gamma_dot[k], gamma_dot, DIM*DIM*sizeof(dbl));
+  Visc_QP_Cache.mu[k] = mu;
+  Visc_QP_Cache.have_d_mu[k] = (d_mu != NULL);
+  if ( d_mu != NULL )
+    {
+      memcpy(&Visc_QP_Cache.d_mu[k], d_mu, sizeof(VISCOSITY_DEPENDENCE_STRUCT));
+    }
+  Visc_QP_Cache.num++;
+}
+
+/*******************************************************************************
+ * set_shear_viscosity(): Pick the routine for the shear rate models that only
+ *              need the Generalized_Newtonian parameters, so viscosity() does
+ *              not walk its chain of model tests at every Gauss point. The
+ *              remaining models leave it NULL.
+ *******************************************************************************/
+void
+set_shear_viscosity(struct Generalized_Newtonian *gn_local)
+{
+  switch (gn_local->ConstitutiveEquation)
+    {
+    case POWER_LAW:
+      gn_local->shear_viscosity = power_law_viscosity;
+      break;
+    case CARREAU:
+      gn_local->shear_viscosity = carreau_viscosity;
+      break;
+    case BINGHAM:
+      gn_local->shear_viscosity = bingham_viscosity;
+      break;
+    case BINGHAM_WLF:
+      gn_local->shear_viscosity = bingham_wlf_viscosity;
+      break;
+    case CARREAU_WLF:
+      gn_local->shear_viscosity = carreau_wlf_viscosity;
+      break;
+    case CARREAU_SUSPENSION:
+      gn_local->shear_viscosity = carreau_suspension_viscosity;
+      break;
+    case POWERLAW_SUSPENSION:
+      gn_local->shear_viscosity = powerlaw_suspension_viscosity;
+      break;
+    case HERSCHEL_BULKLEY:
+      gn_local->shear_viscosity = herschel_buckley_viscosity;
+      break;
+    default:
+      gn_local->shear_viscosity = NULL;
+      break;
+    }
+}
+
 /*******************************************************************************
  * viscosity(): Calculate the viscosity and derivatives of viscosity
  *              with respect to solution unknowns at the Gauss point. Most 
@@ -129,16 +342,37 @@ viscosity(struct Generalized_Newtonian *gn_local,
 
   struct Level_Set_Data *ls_old;
 
+  int cache = (Visc_QP_Cache.on && gn_local->shear_viscosity != NULL);
+
+  if ( cache && (i = visc_qp_cache_find(gn_local, gamma_dot, d_mu != NULL)) >= 0 )
+    {
+      if ( d_mu != NULL )
+	{
+	  memcpy(d_mu, &Visc_QP_Cache.d_mu[i], sizeof(VISCOSITY_DEPENDENCE_STRUCT));
+	}
+      return(Visc_QP_Cache.mu[i]);
+    }
+
   /* Zero out sensitivities */
   zeroStructures(d_mu, 1);
  
+  /* the shear rate models resolved by set_shear_viscosity() */
+
+  if (gn_local->shear_viscosity != NULL)
+    {
+      mu = gn_local->shear_viscosity(gn_local, gamma_dot, d_mu);
+    }
+
   /* this section is for all Newtonian models */
 
-  if (gn_local->ConstitutiveEquation == NEWTONIAN) 
+  else if (gn_local->ConstitutiveEquation == NEWTONIAN) 
     {
       if (mp->ViscosityModel == USER )
 	{
-	  err = usr_viscosity(mp->u_viscosity);
+	  if (mp->Plugin[GOMA_PLUGIN_VISCOSITY] >= 0)
+	    err = plugin_property(GOMA_PLUGIN_VISCOSITY, -1, tran->time_value);
+	  else
+	    err = usr_viscosity(mp->u_viscosity);
 	  mu = mp->viscosity;
 	  
 	  var = TEMPERATURE;
@@ -759,11 +993,74 @@ viscosity(struct Generalized_Newtonian *gn_local,
       }
      mu *= thixotropic;
     }
+  if ( cache ) visc_qp_cache_store(gn_local, gamma_dot, mu, d_mu);
+
   return(mu);
 }
 
 
 
+/*
+ * Batch kernels for the shear thinning models with constant parameters.
+ * They take the strain rate invariant at n points (the Gauss points of an
+ * element, say) as a contiguous array and return the viscosity and its
+ * derivative with respect to the strain rate in arrays of their own.
+ * Nothing in the loops depends on the element or the Gauss point
+ * structures, so the compiler is free to vectorize them.
+ */
+
+void
+power_law_viscosity_batch(const struct Generalized_Newtonian *gn_local,
+			  const int n,
+			  const dbl gd[],
+			  dbl mu[],
+			  dbl dmu_dgd[])
+{
+  int k;
+  const dbl mu0 = gn_local->mu0;
+  const dbl nexp = gn_local->nexp;
+  const dbl offset = 0.00001;
+  dbl g;
+
+  for ( k=0; k<n; k++)
+    {
+      g = gd[k] + offset;
+      mu[k] = mu0 * pow(g, nexp-1.);
+      dmu_dgd[k] = (nexp-1.) * mu[k] / g;
+    }
+}
+
+void
+carreau_viscosity_batch(const struct Generalized_Newtonian *gn_local,
+			const int n,
+			const dbl gd[],
+			dbl mu[],
+			dbl dmu_dgd[])
+
+  /*
+   * mu = muinf + (mu0 - muinf) * (1 + (lambda*gammadot)^aexp)^((nexp-1)/aexp)
+   */
+{
+  int k;
+  const dbl mu0 = gn_local->mu0;
+  const dbl muinf = gn_local->muinf;
+  const dbl nexp = gn_local->nexp;
+  const dbl aexp = gn_local->aexp;
+  const dbl lambda = gn_local->lam;
+  const dbl p = (nexp-1.) / aexp;
+  dbl x, xa, base;
+
+  for ( k=0; k<n; k++)
+    {
+      x = lambda * gd[k];
+      xa = (gd[k] != 0.) ? pow(x, aexp) : 0.;
+      base = 1. + xa;
+      mu[k] = muinf + (mu0 - muinf) * pow(base, p);
+      dmu_dgd[k] = (gd[k] != 0.)
+	? (mu[k] - muinf) * p * aexp * xa / (base * gd[k]) : 0.;
+    }
+}
+
 double
 power_law_viscosity(struct Generalized_Newtonian *gn_local,
 		    dbl gamma_dot[DIM][DIM], /* strain rate tensor */
@@ -783,9 +1080,6 @@ power_law_viscosity(struct Generalized_Newtonian *gn_local,
 				   wrt mesh */
 
   dbl val;
-  dbl mu0;
-  dbl nexp;
-  dbl offset;
   dbl mu = 0.;
 
   vdofs = ei->dof[VELOCITY1];
@@ -800,22 +1094,15 @@ power_law_viscosity(struct Generalized_Newtonian *gn_local,
 
   /* calculate power law viscosity
      mu = mu0 * (offset + gammadot)**(nexp-1))                 */
-  mu0 = gn_local->mu0;
-  nexp = gn_local->nexp;
-  offset = 0.00001;
+  power_law_viscosity_batch(gn_local, 1, &gammadot, &mu, &val);
 
-  val = pow( gammadot + offset, nexp-1.);
-  mu = mu0 * val;
   /*
    * d( mu )/dmesh
    */
 
-  val = pow( gammadot+offset, nexp-2.);
-
-
   if (d_mu != NULL)
     {
-     d_mu->gd = mu0*(nexp - 1.0)*val;
+     d_mu->gd = val;
     }
 
   if ( d_mu != NULL && pd->e[R_MESH1] )
@@ -978,12 +1265,7 @@ carreau_viscosity(struct Generalized_Newtonian *gn_local,
 		  dbl gamma_dot[DIM][DIM], /* strain rate tensor */
 		  VISCOSITY_DEPENDENCE_STRUCT *d_mu)
 {
-
-    int a, b;
-  int mdofs=0,vdofs;
-
-
-  int i, j;
+  enum { S_GD, S_MU0, S_NEXP, S_MUINF, S_AEXP, S_LAM, N_SLOTS };
 
   dbl gammadot;	                /* strain rate invariant */ 
 
@@ -992,172 +1274,63 @@ carreau_viscosity(struct Generalized_Newtonian *gn_local,
   dbl d_gd_dmesh[DIM][MDE];     /* derivative of strain rate invariant 
 				   wrt mesh */ 
 
-  dbl val, val1, val2;
-  dbl mu = 0.;
-  dbl mu0;
-  dbl muinf;
-  dbl nexp;
-  dbl aexp;
-  dbl lambda;
+  DUAL gd, mu0, muinf, nexp, aexp, lambda;
+  DUAL val, val2, mu;
 
-  vdofs = ei->dof[VELOCITY1];
-  
-  if ( pd->e[R_MESH1] )
-    {
-      mdofs = ei->dof[R_MESH1];
-    }
-  
-  calc_shearrate(&gammadot, gamma_dot, d_gd_dv, d_gd_dmesh);
+  int n_ls = 0;			/* parameters varying across a level set */
+  int ls_slot[N_SLOTS];
+  dbl d_par_dF[N_SLOTS][MDE];
 
-  mu0 = gn_local->mu0;
-  nexp = gn_local->nexp;
-  muinf = gn_local->muinf;
-  aexp = gn_local->aexp;
-  lambda = gn_local->lam;
-
- if(gn_local->mu0Model == LEVEL_SET)
-   {
-     if(d_mu != NULL)
-       {
-	 level_set_property(gn_local->u_mu0[0], gn_local->u_mu0[1], 
-			    gn_local->u_mu0[2], &mu0, d_mu->F);
-       }
-     else
-       {
-	 level_set_property(gn_local->u_mu0[0], gn_local->u_mu0[1], 
-			    gn_local->u_mu0[2], &mu0, NULL);
-       }
-   }
-
- if(gn_local->nexpModel == LEVEL_SET)
-   {
-     if(d_mu != NULL)
-       {
-	 level_set_property(gn_local->u_nexp[0], gn_local->u_nexp[1], 
-			    gn_local->u_nexp[2], &nexp, d_mu->F);
-       }
-     else
-       {
-	 level_set_property(gn_local->u_nexp[0], gn_local->u_nexp[1], 
-			    gn_local->u_nexp[2], &nexp, NULL);
-       }
-   }
+  calc_shearrate(&gammadot, gamma_dot, d_gd_dv, d_gd_dmesh);
 
- if(gn_local->muinfModel == LEVEL_SET)
-   {
-     if(d_mu != NULL)
-       {
-	 level_set_property(gn_local->u_muinf[0], gn_local->u_muinf[1], 
-			    gn_local->u_muinf[2], &muinf, d_mu->F);
-       }
-     else
-       {
-	 level_set_property(gn_local->u_muinf[0], gn_local->u_muinf[1], 
-			    gn_local->u_muinf[2], &muinf, NULL);
-       }
-   }
+  if ( gn_local->mu0Model != LEVEL_SET && gn_local->nexpModel != LEVEL_SET &&
+       gn_local->muinfModel != LEVEL_SET && gn_local->aexpModel != LEVEL_SET &&
+       gn_local->lamModel != LEVEL_SET )
+    {
+      mu = dual_const(0.);
+      carreau_viscosity_batch(gn_local, 1, &gammadot, &mu.v, &mu.d[S_GD]);
+      if ( d_mu != NULL )
+	{
+	  visc_dual_load(&mu, S_GD, -1, gammadot, d_gd_dv, d_gd_dmesh,
+			 0, ls_slot, d_par_dF, d_mu);
+	}
+      return(mu.v);
+    }
 
- if(gn_local->aexpModel == LEVEL_SET)
-   {
-     if(d_mu != NULL)
-       {
-	 level_set_property(gn_local->u_aexp[0], gn_local->u_aexp[1], 
-			    gn_local->u_aexp[2], &aexp, d_mu->F);
-       }
-     else
-       {
-	 level_set_property(gn_local->u_aexp[0], gn_local->u_aexp[1], 
-			    gn_local->u_aexp[2], &aexp, NULL);
-       }
-   }
-	  
+  gd = dual_var(gammadot, S_GD);
 
- if(gn_local->lamModel == LEVEL_SET)
-   {
-     if(d_mu != NULL)
-       {
-	 level_set_property(gn_local->u_lam[0], gn_local->u_lam[1], 
-			    gn_local->u_lam[2], &lambda, d_mu->F);
-       }
-     else
-       {
-	 level_set_property(gn_local->u_lam[0], gn_local->u_lam[1], 
-			    gn_local->u_lam[2], &lambda, NULL);
-       }
-   }  
+  mu0 = visc_dual_param(gn_local->mu0Model, gn_local->mu0, gn_local->u_mu0,
+			S_MU0, d_mu != NULL, ls_slot, &n_ls, d_par_dF);
+  nexp = visc_dual_param(gn_local->nexpModel, gn_local->nexp, gn_local->u_nexp,
+			 S_NEXP, d_mu != NULL, ls_slot, &n_ls, d_par_dF);
+  muinf = visc_dual_param(gn_local->muinfModel, gn_local->muinf, gn_local->u_muinf,
+			  S_MUINF, d_mu != NULL, ls_slot, &n_ls, d_par_dF);
+  aexp = visc_dual_param(gn_local->aexpModel, gn_local->aexp, gn_local->u_aexp,
+			 S_AEXP, d_mu != NULL, ls_slot, &n_ls, d_par_dF);
+  lambda = visc_dual_param(gn_local->lamModel, gn_local->lam, gn_local->u_lam,
+			   S_LAM, d_mu != NULL, ls_slot, &n_ls, d_par_dF);
 
-  
-  if(gammadot != 0.)
-    {
-      val2 = pow( lambda*gammadot, aexp);
-    }
-  else
-    {
-      val2 = 0.;
-    }
-  val = pow(1. + val2,(nexp-1.)/aexp);
-  mu = muinf + (mu0 - muinf)* val;
-  
-  /* gammadot = 0.0; */
-  /* this effectively turns off the viscosity Jac terms */
-  
+  /*
+   * mu = muinf + (mu0 - muinf) * (1 + (lambda*gammadot)^aexp)^((nexp-1)/aexp)
+   */
   if(gammadot != 0.)
     {
-      val = pow( lambda*gammadot, aexp-1.);
+      val2 = dual_pow(dual_mul(lambda, gd), aexp);
     }
   else
     {
-      val = 0.;
-    }
-  val1 = pow(1. + val2,(nexp-1.-aexp)/aexp);
-  
-  if ( d_mu != NULL ) d_mu->gd = (mu0 - muinf)* (nexp-1.) * lambda * val * val1 ;
-  
-  /*
-   * d( mu )/dmesh
-   */
-  if ( d_mu != NULL && pd->e[R_MESH1] )
-    {
-      for ( b=0; b<VIM; b++)
-	{
-	  for ( j=0; j<mdofs; j++)
-	    {
-	      if(gammadot != 0.0 && Include_Visc_Sens )
-		{
-		  d_mu->X [b][j] =
-		    d_mu->gd * d_gd_dmesh [b][j] ;
-		}
-	      else
-		{
-		  /* printf("\ngammadot is zero in viscosity function");*/
-		  d_mu->X [b][j] = 0.0;
-		}
-	    }
-	}
+      val2 = dual_const(0.);
     }
-  
-  /*
-   * d( mu )/dv
-   */
-  if ( d_mu != NULL && pd->e[R_MOMENTUM1] )
+  val = dual_pow(dual_add_c(val2, 1.), dual_div(dual_add_c(nexp, -1.), aexp));
+  mu = dual_add(muinf, dual_mul(dual_sub(mu0, muinf), val));
+
+  if ( d_mu != NULL )
     {
-      for ( a=0; a<VIM; a++)
-        {
-          for ( i=0; i<vdofs; i++)
-	    {
-	      if(gammadot != 0.0 && Include_Visc_Sens )
-	        {
-	          d_mu->v[a][i] =
-		    d_mu->gd * d_gd_dv[a][i] ;
-	        }
-	      else
-	        {
-	          d_mu->v[a][i] = 0.0 ;
-	        }
-	    }
-        }
+      visc_dual_load(&mu, S_GD, -1, gammadot, d_gd_dv, d_gd_dmesh,
+		     n_ls, ls_slot, d_par_dF, d_mu);
     }
-  return(mu);
+
+  return(mu.v);
 }
 
 #define MELTING_BINGHAM FALSE
@@ -1611,13 +1784,8 @@ carreau_wlf_viscosity(struct Generalized_Newtonian *gn_local,
 		  dbl gamma_dot[DIM][DIM], /* strain rate tensor */
 		  VISCOSITY_DEPENDENCE_STRUCT *d_mu)
 {
-
-  int a, b;
-
-  int var;
-  int mdofs=0,vdofs;
-
-  int i, j;
+  enum { S_GD, S_T, S_MU0, S_NEXP, S_MUINF, S_AEXP, S_ATEXP, S_WLFC2, S_LAM,
+	 N_SLOTS };
 
   dbl gammadot;	                /* strain rate invariant */ 
 
@@ -1626,243 +1794,73 @@ carreau_wlf_viscosity(struct Generalized_Newtonian *gn_local,
   dbl d_gd_dmesh[DIM][MDE];     /* derivative of strain rate invariant 
 				   wrt mesh */ 
 
-  dbl val1;
-  dbl shear, visc_cy;
-  dbl d_shear, d_visc_cy, d_shear_d_at;
-  dbl mu = 0.;
-  dbl mu0;
-  dbl muinf;
-  dbl dmudT;
-  dbl nexp;
-  dbl atexp;
-  dbl aexp;
-  dbl at_shift;
-  dbl lambda;
-  dbl wlf_denom = 0.0;
-  dbl wlfc2;
-  dbl temp;
+  DUAL gd, temp, mu0, muinf, nexp, aexp, atexp, wlfc2, lambda;
+  DUAL at_shift, wlf_denom, shear, visc_cy, mu;
+  dbl T_ref = mp->reference[TEMPERATURE];
+
+  int n_ls = 0;			/* parameters varying across a level set */
+  int ls_slot[N_SLOTS];
+  dbl d_par_dF[N_SLOTS][MDE];
 
   calc_shearrate(&gammadot, gamma_dot, d_gd_dv, d_gd_dmesh);
 
-  mu0 = gn_local->mu0;
-  nexp = gn_local->nexp;
-  muinf = gn_local->muinf;
-  aexp = gn_local->aexp;
-  atexp = gn_local->atexp;
-  wlfc2 = gn_local->wlfc2;
-  lambda = gn_local->lam;
+  gd = dual_var(gammadot, S_GD);
 
   if ( pd->e[TEMPERATURE] )
-       {temp = fv->T;}
+       {temp = dual_var(fv->T, S_T);}
   else
-       {temp = upd->Process_Temperature;}
-
- if(gn_local->mu0Model == LEVEL_SET)
-   {
-     if(d_mu != NULL)
-       {
-	 level_set_property(gn_local->u_mu0[0], gn_local->u_mu0[1], 
-			    gn_local->u_mu0[2], &mu0, d_mu->F);
-       }
-     else
-       {
-	 level_set_property(gn_local->u_mu0[0], gn_local->u_mu0[1], 
-			    gn_local->u_mu0[2], &mu0, NULL);
-       }
-   }
-
- if(gn_local->nexpModel == LEVEL_SET)
-   {
-     if(d_mu != NULL)
-       {
-	 level_set_property(gn_local->u_nexp[0], gn_local->u_nexp[1], 
-			    gn_local->u_nexp[2], &nexp, d_mu->F);
-       }
-     else
-       {
-	 level_set_property(gn_local->u_nexp[0], gn_local->u_nexp[1], 
-			    gn_local->u_nexp[2], &nexp, NULL);
-       }
-   }
-
- if(gn_local->muinfModel == LEVEL_SET)
-   {
-     if(d_mu != NULL)
-       {
-	 level_set_property(gn_local->u_muinf[0], gn_local->u_muinf[1], 
-			    gn_local->u_muinf[2], &muinf, d_mu->F);
-       }
-     else
-       {
-	 level_set_property(gn_local->u_muinf[0], gn_local->u_muinf[1], 
-			    gn_local->u_muinf[2], &muinf, NULL);
-       }
-   }
-
- if(gn_local->aexpModel == LEVEL_SET)
-   {
-     if(d_mu != NULL)
-       {
-	 level_set_property(gn_local->u_aexp[0], gn_local->u_aexp[1], 
-			    gn_local->u_aexp[2], &aexp, d_mu->F);
-       }
-     else
-       {
-	 level_set_property(gn_local->u_aexp[0], gn_local->u_aexp[1], 
-			    gn_local->u_aexp[2], &aexp, NULL);
-       }
-   }
-	  
- if(gn_local->atexpModel == LEVEL_SET)
-   {
-     if(d_mu != NULL)
-       {
-	 level_set_property(gn_local->u_atexp[0], gn_local->u_atexp[1], 
-			    gn_local->u_atexp[2], &atexp, d_mu->F);
-       }
-     else
-       {
-	 level_set_property(gn_local->u_atexp[0], gn_local->u_atexp[1], 
-			    gn_local->u_atexp[2], &atexp, NULL);
-       }
-   }
-
- if(gn_local->wlfc2Model == LEVEL_SET)
-   {
-     if(d_mu != NULL)
-       {
-	 level_set_property(gn_local->u_wlfc2[0], gn_local->u_wlfc2[1], 
-			    gn_local->u_wlfc2[2], &wlfc2, d_mu->F);
-       }
-     else
-       {
-	 level_set_property(gn_local->u_wlfc2[0], gn_local->u_wlfc2[1], 
-			    gn_local->u_wlfc2[2], &wlfc2, NULL);
-       }
-   }
-
- if(gn_local->lamModel == LEVEL_SET)
-   {
-     if(d_mu != NULL)
-       {
-	 level_set_property(gn_local->u_lam[0], gn_local->u_lam[1], 
-			    gn_local->u_lam[2], &lambda, d_mu->F);
-       }
-     else
-       {
-	 level_set_property(gn_local->u_lam[0], gn_local->u_lam[1], 
-			    gn_local->u_lam[2], &lambda, NULL);
-       }
-   }  
+       {temp = dual_const(upd->Process_Temperature);}
+
+  mu0 = visc_dual_param(gn_local->mu0Model, gn_local->mu0, gn_local->u_mu0,
+			S_MU0, d_mu != NULL, ls_slot, &n_ls, d_par_dF);
+  nexp = visc_dual_param(gn_local->nexpModel, gn_local->nexp, gn_local->u_nexp,
+			 S_NEXP, d_mu != NULL, ls_slot, &n_ls, d_par_dF);
+  muinf = visc_dual_param(gn_local->muinfModel, gn_local->muinf, gn_local->u_muinf,
+			  S_MUINF, d_mu != NULL, ls_slot, &n_ls, d_par_dF);
+  aexp = visc_dual_param(gn_local->aexpModel, gn_local->aexp, gn_local->u_aexp,
+			 S_AEXP, d_mu != NULL, ls_slot, &n_ls, d_par_dF);
+  atexp = visc_dual_param(gn_local->atexpModel, gn_local->atexp, gn_local->u_atexp,
+			  S_ATEXP, d_mu != NULL, ls_slot, &n_ls, d_par_dF);
+  wlfc2 = visc_dual_param(gn_local->wlfc2Model, gn_local->wlfc2, gn_local->u_wlfc2,
+			  S_WLFC2, d_mu != NULL, ls_slot, &n_ls, d_par_dF);
+  lambda = visc_dual_param(gn_local->lamModel, gn_local->lam, gn_local->u_lam,
+			   S_LAM, d_mu != NULL, ls_slot, &n_ls, d_par_dF);
 
-  vdofs = ei->dof[VELOCITY1];
-  
-  if ( pd->e[R_MESH1] )
+  /*
+   * WLF shift, at = exp(atexp*(T_ref - T)/(wlfc2 + T - T_ref))
+   */
+  at_shift = dual_const(1.);
+  wlf_denom = dual_add_c(dual_add(wlfc2, temp), -T_ref);
+  if(wlf_denom.v != 0.)
     {
-      mdofs = ei->dof[R_MESH1];
+      at_shift = dual_exp(dual_div(dual_mul(atexp, dual_add_c(dual_scale(temp, -1.), T_ref)),
+				   wlf_denom));
+      if(!isfinite(at_shift.v)) { at_shift = dual_const(DBL_MAX); }
     }
 
-  at_shift = 1.;
-      wlf_denom = wlfc2 + temp - mp->reference[TEMPERATURE];
-      if(wlf_denom != 0.)
-	{
-	  at_shift=exp(atexp*(mp->reference[TEMPERATURE]-temp)/wlf_denom);
-	  if(!isfinite(at_shift)) { at_shift = DBL_MAX; }
-	}
-  
-  if(gammadot != 0.)
-    {
-      shear = pow( at_shift* lambda * gammadot, aexp);
-      val1 = pow(at_shift * lambda * gammadot, aexp-1.);
-      d_shear = aexp * at_shift * lambda * val1;
-      d_shear_d_at = aexp * gammadot * lambda * val1; 
-    }
-  else
-    {
-      shear = 0.;
-      d_shear = 0.;
-      d_shear_d_at = 0.;
-    }
-  
-  
-  visc_cy = pow(1. + shear,(nexp-1.)/aexp);
-  d_visc_cy = (nexp-1.)/aexp * pow(1. + shear,(nexp-1.-aexp)/aexp);
-  
-  mu = at_shift * (muinf + (mu0 - muinf) * visc_cy);
-  
-  if ( d_mu != NULL ) d_mu->gd =  at_shift * ((mu0 - muinf) * d_visc_cy *d_shear);
-  
   /*
-   * d( mu )/dT
+   * mu = at * (muinf + (mu0 - muinf) * (1 + (at*lambda*gammadot)^aexp)^((nexp-1)/aexp))
    */
-  
-  var = TEMPERATURE;
-  if ( d_mu != NULL && pd->e[var] )
+  if(gammadot != 0.)
     {
-      if(wlf_denom != 0.)
-	{
-	  dmudT = mu +
-	  at_shift * at_shift * (mu0 - muinf) * d_visc_cy * d_shear_d_at;
-	  dmudT *= - atexp*wlfc2/(wlf_denom*wlf_denom);
-	  if(!isfinite(dmudT)) { dmudT = DBL_MAX; }
-	}
-      else
-	{
-	  dmudT = 0.;
-	}
-      
-      for ( j=0; j<ei->dof[var]; j++)
-	{
-	  d_mu->T[j]= dmudT * bf[var]->phi[j];
-	}
+      shear = dual_pow(dual_mul(dual_mul(at_shift, lambda), gd), aexp);
     }
-  
-  /*
-   * d( mu )/dmesh
-   */
-  if ( d_mu != NULL && pd->e[R_MESH1] )
+  else
     {
-      for ( b=0; b<VIM; b++)
-	{
-	  for ( j=0; j<mdofs; j++)
-	    {
-	      if(gammadot != 0.0 && Include_Visc_Sens )
-		{
-		  d_mu->X [b][j] =
-		    d_mu->gd * d_gd_dmesh [b][j] ;
-		}
-	      else
-		{
-		  /* printf("\ngammadot is zero in viscosity function");*/
-		  d_mu->X [b][j] = 0.0;
-		}
-	    }
-	}
+      shear = dual_const(0.);
     }
-  
-  /*
-   * d( mu )/dv
-   */
-  if ( d_mu != NULL && pd->e[R_MOMENTUM1] )
+
+  visc_cy = dual_pow(dual_add_c(shear, 1.), dual_div(dual_add_c(nexp, -1.), aexp));
+
+  mu = dual_mul(at_shift, dual_add(muinf, dual_mul(dual_sub(mu0, muinf), visc_cy)));
+
+  if ( d_mu != NULL )
     {
-      for ( a=0; a<VIM; a++)
-        {
-          for ( i=0; i<vdofs; i++)
-	    {
-	      if(gammadot != 0.0 && Include_Visc_Sens )
-	        {
-	          d_mu->v[a][i] =
-		    d_mu->gd * d_gd_dv[a][i] ;
-	        }
-	      else
-	        {
-	          d_mu->v[a][i] = 0.0 ;
-	        }
-	    }
-        }
+      visc_dual_load(&mu, S_GD, S_T, gammadot, d_gd_dv, d_gd_dmesh,
+		     n_ls, ls_slot, d_par_dF, d_mu);
     }
 
-  return(mu);
+  return(mu.v);
 }
 
 
@@ -0,0 +1,367 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * External fields from a donor mesh that does not match the problem mesh.
+ *
+ * The donor mesh is read from the external field file itself, straight
+ * through the EXODUS II library (rd_exo() would overwrite Element_Blocks),
+ * and its elements are binned by bounding box (el_bins.c). Each node of
+ * the problem mesh is then located in a donor element among the few in
+ * its bin, by a Newton inversion of the donor element's isoparametric
+ * map, and the donor nodal field is interpolated there with the donor
+ * element's shape functions. A node outside of the donor mesh takes the
+ * value of the closest donor node of the element with the closest center.
+ *
+ * The nodes are independent of each other and are done in parallel with
+ * OpenMP threads when the code is built with them.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "std.h"
+#include "exodusII.h"
+#include "rf_allo.h"
+#include "rf_fem_const.h"
+#include "rf_fem.h"
+#include "rf_mp.h"
+#include "rf_io_const.h"
+#include "rf_io.h"
+#include "mm_eh.h"
+#include "exo_struct.h"
+#include "el_elm.h"
+
+#define _RD_DONOR_FIELD_C
+#include "goma.h"
+
+#define DONOR_NEWTON_ITS 25
+#define DONOR_XI_TOL     1.e-6	/* how far outside an element still counts */
+
+int Ext_Field_Donor_Mesh = FALSE;
+
+struct donor_mesh {
+  int dim;
+  int num_nodes;
+  int num_elems;
+  dbl *coor[3];			/* [dim][node] */
+  int *itype;			/* [elem] element type */
+  Exo_DB exo;			/* just the elem->node lists, for the bins */
+  dbl **ctr;			/* [elem][3] element centers */
+};
+
+static dbl
+shape_fn(const dbl xi[3],
+	 const int itype,
+	 const int quant,
+	 const int i)
+{
+  return shape(xi[0], xi[1], xi[2], itype, quant, i);
+}
+
+static void
+donor_free(struct donor_mesh *dm)
+{
+  int d;
+
+  for (d = 0; d < 3; d++) safe_free(dm->coor[d]);
+  safe_free(dm->itype);
+  safe_free(dm->exo.elem_node_pntr);
+  safe_free(dm->exo.elem_node_list);
+  if (dm->ctr != NULL) {
+    safe_free(dm->ctr[0]);
+    safe_free(dm->ctr);
+  }
+}
+
+/*
+ * Read the coordinates and the connectivity of the donor mesh in exoid.
+ */
+
+static int
+donor_read(const int exoid,
+	   struct donor_mesh *dm)
+{
+  char title[MAX_LINE_LENGTH + 1], elem_type[MAX_STR_LENGTH + 1];
+  int err, d, e, i, b, k, n, nb, nns, nss, nel, npe, nattr;
+  int *ids, *conn;
+
+  memset(dm, 0, sizeof(struct donor_mesh));
+  err = ex_get_init(exoid, title, &dm->dim, &dm->num_nodes, &dm->num_elems,
+		    &nb, &nns, &nss);
+  EH(err, "ex_get_init donor mesh");
+  if (dm->dim < 1 || dm->dim > 3 || dm->num_elems < 1) return -1;
+
+  for (d = 0; d < 3; d++) {
+    dm->coor[d] = alloc_dbl_1(MAX(dm->num_nodes, 1), 0.);
+  }
+  err = ex_get_coord(exoid, dm->coor[0], dm->coor[1], dm->coor[2]);
+  EH(err, "ex_get_coord donor mesh");
+
+  dm->itype = alloc_int_1(dm->num_elems, -1);
+  dm->exo.num_elems = dm->num_elems;
+  dm->exo.elem_node_pntr = alloc_int_1(dm->num_elems + 1, 0);
+
+  ids = alloc_int_1(MAX(nb, 1), 0);
+  err = ex_get_ids(exoid, EX_ELEM_BLOCK, ids);
+  EH(err, "ex_get_ids donor mesh");
+
+  /* sizes first, then the connectivity */
+  e = 0;
+  for (b = 0; b < nb; b++) {
+    err = ex_get_block(exoid, EX_ELEM_BLOCK, ids[b], elem_type, &nel, &npe,
+		       0, 0, &nattr);
+    EH(err, "ex_get_block donor mesh");
+    for (i = 0; i < nel; i++, e++) {
+      dm->itype[e] = get_type(elem_type, npe, nattr);
+      dm->exo.elem_node_pntr[e+1] = dm->exo.elem_node_pntr[e] + npe;
+    }
+  }
+  dm->exo.elem_node_list = alloc_int_1(MAX(dm->exo.elem_node_pntr[e], 1), 0);
+  e = 0;
+  for (b = 0; b < nb; b++) {
+    err = ex_get_block(exoid, EX_ELEM_BLOCK, ids[b], elem_type, &nel, &npe,
+		       0, 0, &nattr);
+    EH(err, "ex_get_block donor mesh");
+    if (nel * npe > 0) {
+      conn = dm->exo.elem_node_list + dm->exo.elem_node_pntr[e];
+      err = ex_get_conn(exoid, EX_ELEM_BLOCK, ids[b], conn, 0, 0);
+      EH(err, "ex_get_conn donor mesh");
+      for (k = 0; k < nel * npe; k++) conn[k]--;	/* zero based */
+    }
+    e += nel;
+  }
+  safe_free(ids);
+  dm->exo.elem_node_conn_exists = TRUE;
+
+  dm->ctr = (dbl **) smalloc(dm->num_elems * sizeof(dbl *));
+  dm->ctr[0] = alloc_dbl_1(3 * dm->num_elems, 0.);
+  for (e = 0; e < dm->num_elems; e++) {
+    dm->ctr[e] = dm->ctr[0] + 3 * e;
+    n = dm->exo.elem_node_pntr[e+1] - dm->exo.elem_node_pntr[e];
+    for (k = dm->exo.elem_node_pntr[e]; k < dm->exo.elem_node_pntr[e+1]; k++) {
+      for (d = 0; d < dm->dim; d++) {
+	dm->ctr[e][d] += dm->coor[d][dm->exo.elem_node_list[k]] / (dbl) n;
+      }
+    }
+  }
+  return 0;
+}
+
+/*
+ * Is xi in the master element of shape?
+ */
+
+static int
+xi_inside(const int shape,
+	  const int dim,
+	  const dbl xi[3])
+{
+  const dbl tol = DONOR_XI_TOL;
+  int d;
+
+  if (shape == TRIANGLE || shape == TETRAHEDRON) {
+    dbl sum = 0.;
+    for (d = 0; d < dim; d++) {
+      if (xi[d] < -tol) return FALSE;
+      sum += xi[d];
+    }
+    return (sum <= 1. + tol);
+  }
+  for (d = 0; d < dim; d++) {
+    if (fabs(xi[d]) > 1. + tol) return FALSE;
+  }
+  return TRUE;
+}
+
+/*
+ * Local coordinates xi of x in element e, by Newton on its isoparametric
+ * map. Returns FALSE if the element is not handled or Newton fails.
+ */
+
+static int
+donor_xi(const struct donor_mesh *dm,
+	 const int e,
+	 const dbl x[3],
+	 dbl xi[3])
+{
+  static const int dpsi[3] = { DPSI_S, DPSI_T, DPSI_U };
+  int it, i, k, a, b, node, shape, n;
+  dbl r[3], J[3][3], det, dxi[3], norm;
+  const int *conn;
+
+  shape = type2shape(dm->itype[e]);
+  if (elem_info(NDIM, dm->itype[e]) != dm->dim) return FALSE;
+
+  conn = dm->exo.elem_node_list + dm->exo.elem_node_pntr[e];
+  n = dm->exo.elem_node_pntr[e+1] - dm->exo.elem_node_pntr[e];
+
+  xi[0] = xi[1] = xi[2] = 0.;
+  if (shape == TRIANGLE || shape == TETRAHEDRON) {
+    xi[0] = xi[1] = (shape == TRIANGLE) ? 1. / 3. : 0.25;
+    if (shape == TETRAHEDRON) xi[2] = 0.25;
+  }
+
+  for (it = 0; it < DONOR_NEWTON_ITS; it++) {
+    for (a = 0; a < 3; a++) {
+      r[a] = (a < dm->dim) ? x[a] : 0.;
+      for (b = 0; b < 3; b++) J[a][b] = (a == b && a >= dm->dim) ? 1. : 0.;
+    }
+    for (i = 0; i < n; i++) {
+      node = conn[i];
+      for (a = 0; a < dm->dim; a++) {
+	r[a] -= dm->coor[a][node] * shape_fn(xi, dm->itype[e], PSI, i);
+	for (b = 0; b < dm->dim; b++) {
+	  J[a][b] += dm->coor[a][node] * shape_fn(xi, dm->itype[e], dpsi[b], i);
+	}
+      }
+    }
+
+    det = J[0][0] * (J[1][1] * J[2][2] - J[1][2] * J[2][1])
+      - J[0][1] * (J[1][0] * J[2][2] - J[1][2] * J[2][0])
+      + J[0][2] * (J[1][0] * J[2][1] - J[1][1] * J[2][0]);
+    if (det == 0.) return FALSE;
+
+    /* Cramer's rule */
+    for (k = 0; k < 3; k++) {
+      dbl M[3][3];
+      for (a = 0; a < 3; a++) {
+	for (b = 0; b < 3; b++) M[a][b] = (b == k) ? r[a] : J[a][b];
+      }
+      dxi[k] = (M[0][0] * (M[1][1] * M[2][2] - M[1][2] * M[2][1])
+		- M[0][1] * (M[1][0] * M[2][2] - M[1][2] * M[2][0])
+		+ M[0][2] * (M[1][0] * M[2][1] - M[1][1] * M[2][0])) / det;
+    }
+
+    norm = 0.;
+    for (a = 0; a < dm->dim; a++) {
+      xi[a] += dxi[a];
+      norm += dxi[a] * dxi[a];
+    }
+    if (norm < 1.e-20) return TRUE;
+    /* far outside: it is not this element */
+    for (a = 0; a < dm->dim; a++) {
+      if (fabs(xi[a]) > 10.) return FALSE;
+    }
+  }
+  return FALSE;
+}
+
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
+int
+rd_donor_nodal_field(const int exoid,
+		     const int time_step,
+		     const int var_index,
+		     const Exo_DB *exo,
+		     dbl *val)
+
+    /*************************************************************************
+     *
+     * rd_donor_nodal_field():
+     *
+     *  Interpolate nodal variable var_index (1 based) at time_step of the
+     *  open EXODUS II file exoid, whose mesh need not match exo, to the
+     *  nodes of exo, into val[exo->num_nodes].
+     *
+     *  Return: the number of nodes of exo outside of the donor mesh, or -1
+     *          if the donor mesh could not be used
+     *************************************************************************/
+{
+  struct donor_mesh dm;
+  ELEM_BINS bins;
+  dbl *dval, start = ut();
+  int err, n, num_donor_nodes, num_outside = 0;
+
+  if (Num_Proc > 1) {
+    EH(-1, "External fields from a non-matching donor mesh are not yet available in parallel");
+    return -1;
+  }
+
+  if (donor_read(exoid, &dm) < 0) {
+    donor_free(&dm);
+    WH(-1, "External field donor mesh has no elements");
+    return -1;
+  }
+
+  dval = alloc_dbl_1(MAX(dm.num_nodes, 1), 0.);
+  err = ex_get_var(exoid, time_step, EX_NODAL, var_index, 1, dm.num_nodes,
+		   dval);
+  EH(err, "ex_get_var donor mesh");
+
+  memset(&bins, 0, sizeof(ELEM_BINS));
+  elem_bins_build(&bins, &dm.exo, dm.coor, dm.dim, 0, dm.num_elems);
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(dynamic, 64) reduction(+:num_outside)
+#endif
+  for (n = 0; n < exo->num_nodes; n++) {
+    dbl x[3], xi[3], dist, best_dist;
+    int d, c, ncand, e, i, k, node, found = FALSE;
+    int *cand;
+
+    for (d = 0; d < 3; d++) {
+      x[d] = (d < exo->num_dim && d < dm.dim) ? Coor[d][n] : 0.;
+    }
+
+    ncand = elem_bins_at(&bins, x, &cand);
+    for (c = 0; c < ncand && !found; c++) {
+      e = cand[c];
+      if (!donor_xi(&dm, e, x, xi)) continue;
+      if (!xi_inside(type2shape(dm.itype[e]), dm.dim, xi)) continue;
+      val[n] = 0.;
+      for (i = 0, k = dm.exo.elem_node_pntr[e]; k < dm.exo.elem_node_pntr[e+1];
+	   i++, k++) {
+	val[n] += dval[dm.exo.elem_node_list[k]] *
+	  shape_fn(xi, dm.itype[e], PSI, i);
+      }
+      found = TRUE;
+    }
+    if (found) continue;
+
+    /* outside: the nearest node of the nearest element */
+    num_outside++;
+    e = elem_bins_nearest(&bins, x, dm.ctr);
+    best_dist = -1.;
+    for (k = dm.exo.elem_node_pntr[e]; k < dm.exo.elem_node_pntr[e+1]; k++) {
+      node = dm.exo.elem_node_list[k];
+      dist = 0.;
+      for (d = 0; d < dm.dim; d++) {
+	dist += (x[d] - dm.coor[d][node]) * (x[d] - dm.coor[d][node]);
+      }
+      if (best_dist < 0. || dist < best_dist) {
+	best_dist = dist;
+	val[n] = dval[node];
+      }
+    }
+  }
+
+  num_donor_nodes = dm.num_nodes;
+  elem_bins_free(&bins);
+  safe_free(dval);
+  donor_free(&dm);
+
+  DPRINTF(stdout, "External field interpolated from a %d node donor mesh in %g s",
+	  num_donor_nodes, ut() - start);
+  if (num_outside > 0) {
+    DPRINTF(stdout, ", %d nodes outside of it", num_outside);
+  }
+  DPRINTF(stdout, "\n");
+  return num_outside;
+}
+/*****************************************************************************/
+/* END of file rd_donor_field.c */
+/*****************************************************************************/
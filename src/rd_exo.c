@@ -98,6 +98,120 @@ static const int spi = sizeof(int *);
 static const int spd = sizeof(dbl *);
 
 static Spfrtn sr;			/* sprintf() return type */
+
+/*
+ * The local nodes (1-based) on each side of the element types whose side
+ * node lists ss_node_list_from_conn() builds, in the order
+ * ex_get_side_set_node_list() gives them.
+ */
+static const int quad_side_nodes[4][3] = {
+  {1, 2, 5}, {2, 3, 6}, {3, 4, 7}, {4, 1, 8} };
+static const int tri_side_nodes[3][3] = {
+  {1, 2, 4}, {2, 3, 5}, {3, 1, 6} };
+static const int hex8_side_nodes[6][4] = {
+  {1, 2, 6, 5}, {2, 3, 7, 6}, {3, 4, 8, 7},
+  {1, 5, 8, 4}, {1, 4, 3, 2}, {5, 6, 7, 8} };
+static const int tet4_side_nodes[4][3] = {
+  {1, 2, 4}, {2, 3, 4}, {1, 4, 3}, {1, 3, 2} };
+
+/*
+ * side_nodes -- the local nodes of side (1-based) of an element of block
+ *		 ebi; the count, or -1 for an element type not handled here.
+ */
+
+static int
+side_nodes(const Exo_DB *x,
+	   const int ebi,
+	   const int side,
+	   const int **nodes)
+{
+  const char *type = x->eb_elem_type[ebi];
+  int npe = x->eb_num_nodes_per_elem[ebi];
+
+  if ( strstr(type, "SHELL") != NULL || strstr(type, "shell") != NULL )
+    {
+      return(-1);
+    }
+
+  if ( x->num_dim == 2 && strncasecmp(type, "QUAD", 4) == 0 &&
+       side >= 1 && side <= 4 )
+    {
+      *nodes = quad_side_nodes[side-1];
+      if ( npe == 4 ) return(2);
+      if ( npe == 8 || npe == 9 ) return(3);
+    }
+  else if ( x->num_dim == 2 && strncasecmp(type, "TRI", 3) == 0 &&
+	    side >= 1 && side <= 3 )
+    {
+      *nodes = tri_side_nodes[side-1];
+      if ( npe == 3 ) return(2);
+      if ( npe == 6 ) return(3);
+    }
+  else if ( x->num_dim == 3 && strncasecmp(type, "HEX", 3) == 0 &&
+	    npe == 8 && side >= 1 && side <= 6 )
+    {
+      *nodes = hex8_side_nodes[side-1];
+      return(4);
+    }
+  else if ( x->num_dim == 3 && strncasecmp(type, "TET", 3) == 0 &&
+	    npe == 4 && side >= 1 && side <= 4 )
+    {
+      *nodes = tet4_side_nodes[side-1];
+      return(3);
+    }
+  return(-1);
+}
+
+/*
+ * ss_node_list_from_conn -- fill in the node count and node lists of side
+ *			     set ssi from the connectivity already in memory
+ *
+ *	ex_get_side_set_node_list() reads the side set again and then the
+ *	whole connectivity of each element block the set touches, for every
+ *	side set. For the common linear and quadratic 2D elements and the
+ *	linear 3D ones the lists are made here instead. Returns FALSE, with
+ *	nothing changed, when the set has an element of any other type or
+ *	its node count differs from its distribution factor count; the
+ *	caller then asks the library.
+ */
+
+static int
+ss_node_list_from_conn(Exo_DB *x,
+		       const int ssi)
+{
+  int j, k, n, elem, ebi, len = 0;
+  const int *nodes = NULL;
+  const int *conn;
+  int first = x->ss_elem_index[ssi];
+
+  for ( j=0; j<x->ss_num_sides[ssi]; j++)
+    {
+      elem = x->ss_elem_list[first+j] - 1;
+      if ( elem < 0 || elem >= x->num_elems ) return(FALSE);
+      ebi = x->elem_eb[elem];
+      if ( ebi < 0 || x->eb_conn[ebi] == NULL ) return(FALSE);
+      n = side_nodes(x, ebi, x->ss_side_list[first+j], &nodes);
+      if ( n < 0 ) return(FALSE);
+      len += n;
+    }
+  if ( len != x->ss_num_distfacts[ssi] ) return(FALSE);
+
+  len = 0;
+  for ( j=0; j<x->ss_num_sides[ssi]; j++)
+    {
+      elem = x->ss_elem_list[first+j] - 1;
+      ebi  = x->elem_eb[elem];
+      n    = side_nodes(x, ebi, x->ss_side_list[first+j], &nodes);
+      conn = x->eb_conn[ebi] +
+	(elem - x->eb_ptr[ebi]) * x->eb_num_nodes_per_elem[ebi];
+      x->ss_node_cnt_list[ssi][j] = n;
+      for ( k=0; k<n; k++)
+	{
+	  x->ss_node_list[ssi][len++] = conn[nodes[k]-1];
+	}
+    }
+  return(TRUE);
+}
 int 
 rd_exo(Exo_DB *x,		/* def'd in exo_struct.h */
        const char *fn,
@@ -698,10 +812,13 @@ rd_exo(Exo_DB *x,		/* def'd in exo_struct.h */
 
 	      x->ss_node_list[i] = (int *) smalloc(x->ss_num_distfacts[i] * si);
 
-	      status = ex_get_side_set_node_list(x->exoid,
-						 x->ss_id[i],
-						 x->ss_node_cnt_list[i],
-						 x->ss_node_list[i]);
+	      if ( ! ss_node_list_from_conn(x, i) )
+		{
+		  status = ex_get_side_set_node_list(x->exoid,
+						     x->ss_id[i],
+						     x->ss_node_cnt_list[i],
+						     x->ss_node_list[i]);
+		}
 #ifdef DEBUG
 	      fprintf(stderr,"P_%d, SSID=%d has %d dfs/nds on -> %d <- sides.\n", 
                       ProcID,
@@ -1921,6 +2038,7 @@ init_exo_struct(Exo_DB *x)
   x->elem_map_exists       = FALSE;
   x->elem_order_map_exists = FALSE;
   x->ss_node_list_exists   = FALSE;
+  x->distfact_freed        = FALSE;
 
   x->num_elem_vars         = 0;
   x->num_node_vars         = 0;
@@ -1945,6 +2063,72 @@ init_exo_struct(Exo_DB *x)
   x->exoid                 = -1;
   return;
 }
+
+/* free_exo_distfacts() -- free the node set and side set distribution
+ * factors, which only writing the mesh out needs after setup; the set
+ * counts and indices stay.
+ */
+
+void
+free_exo_distfacts(Exo_DB *x)
+{
+  if ( x->distfact_freed ) return;
+
+  safer_free((void **) &(x->ns_distfact_list));
+  safer_free((void **) &(x->ss_distfact_list));
+  Proc_NS_Dist_Fact = NULL;
+  Proc_SS_Dist_Fact = NULL;
+  x->distfact_freed = TRUE;
+}
+
+/* rd_exo_distfacts() -- read the distribution factors freed by
+ * free_exo_distfacts() back from the file the mesh came from.
+ */
+
+void
+rd_exo_distfacts(Exo_DB *x)
+{
+  int i, exoid, status;
+  int comp_ws = x->comp_wordsize;
+  int io_ws = x->io_wordsize;
+  flt version;
+
+  if ( ! x->distfact_freed ) return;
+
+  exoid = ex_open(x->path, EX_READ, &comp_ws, &io_ws, &version);
+  EH(exoid, "ex_open, to read the distribution factors back");
+
+  if ( x->ns_distfact_len > 0 )
+    {
+      x->ns_distfact_list = (dbl *) smalloc(x->ns_distfact_len * sizeof(dbl));
+      for ( i=0; i<x->num_node_sets; i++)
+	{
+	  if ( x->ns_num_distfacts[i] == 0 ) continue;
+	  status = ex_get_set_dist_fact(exoid, EX_NODE_SET, x->ns_id[i],
+			  x->ns_distfact_list + x->ns_distfact_index[i]);
+	  EH(status, "ex_get_set_dist_fact node set");
+	}
+    }
+
+  if ( x->ss_distfact_len > 0 )
+    {
+      x->ss_distfact_list = (dbl *) smalloc(x->ss_distfact_len * sizeof(dbl));
+      for ( i=0; i<x->num_side_sets; i++)
+	{
+	  if ( x->ss_num_distfacts[i] == 0 ) continue;
+	  status = ex_get_set_dist_fact(exoid, EX_SIDE_SET, x->ss_id[i],
+			  x->ss_distfact_list + x->ss_distfact_index[i]);
+	  EH(status, "ex_get_set_dist_fact side set");
+	}
+    }
+
+  status = ex_close(exoid);
+  EH(status, "ex_close");
+
+  Proc_NS_Dist_Fact = x->ns_distfact_list;
+  Proc_SS_Dist_Fact = x->ss_distfact_list;
+  x->distfact_freed = FALSE;
+}
   
 void 
 free_exo_ev(Exo_DB *x)
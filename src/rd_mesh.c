@@ -242,7 +242,16 @@ read_mesh_exoII(Exo_DB *exo,
   if ( max > MDE )
     {
       log_msg("The mesh has elements with %d nodes.", max);
-      log_err("Edit \"rf_fem_const.h\" to set MDE to %d; rebuld GOMA.", max);
+      log_err("Rebuild GOMA with MDE set to %d (the MDE build option).", max);
+    }
+
+  /*
+   * The element workspaces are sized by MDE whatever the mesh is; say
+   * so when a smaller build would do.
+   */
+  if ( max > 0 && 2 * max <= MDE )
+    {
+      DPRINTF(stdout, "Note: elements have at most %d nodes; GOMA built with MDE = %d. Unless extra dofs per element are used (e.g. phase jumps), a build with MDE = %d would use smaller element workspaces.\n", max, MDE, max);
     }
 
 
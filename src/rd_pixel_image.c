@@ -52,6 +52,7 @@
 #include "rd_mesh.h"
 #include "mm_eh.h"
 #include "el_elm_info.h"
+#include "el_bins.h"
 #include "mm_fill_util.h"
 #include "sl_util_structs.h"
 #include "sl_amesos_interface.h"
@@ -98,7 +99,7 @@ rd_image_to_mesh(int N_ext, Exo_DB *exo)
   int e_start, e_end;
 
   /* variables for processing the image data */
-  double minsepar, separ; // minimum separation, and separation to match data point to element center
+  ELEM_BINS elem_bins;    // element bounding box bins to match data points to element centers
 
   /* Least square fit variables and arrays */
   double *bf_mat, *f_rhs, *x_fit, *Atranspose_f_rhs;
@@ -241,26 +242,26 @@ rd_image_to_mesh(int N_ext, Exo_DB *exo)
   ElemID_data = (int *) calloc(txt_num_pts, sizeof(int));
   e_start = exo->eb_ptr[ipix_blkid]; e_end = exo->eb_ptr[ipix_blkid+1];
 
+  /*
+   * The element with the nearest center, found through bins of the element
+   * bounding boxes rather than by measuring every element for every point.
+   * The search only reads the bins, so the points are shared out among
+   * threads.
+   */
+  memset(&elem_bins, 0, sizeof(ELEM_BINS));
+  elem_bins_build(&elem_bins, exo, Coor, pd->Num_Dim, e_start, e_end);
+
+#ifdef _OPENMP
+#pragma omp parallel for private(elem_loc) schedule(dynamic, 256)
+#endif
   for (i = 0; i < txt_num_pts; i++)
     {
-        minsepar = 1.0e+30; // initialize minimum separation
-        elem_loc = -1; // initialize element ID location
-	for (ielem = e_start; ielem < e_end; ielem++)
-          {
-            separ =  sqrt(  (xyz_data[i][0] - elmctrs[ielem][0]) * (xyz_data[i][0] - elmctrs[ielem][0]) 
-                          + (xyz_data[i][1] - elmctrs[ielem][1]) * (xyz_data[i][1] - elmctrs[ielem][1])
-                          + (xyz_data[i][2] - elmctrs[ielem][2]) * (xyz_data[i][2] - elmctrs[ielem][2]) );
-
-            if (separ < minsepar)
-              {
-                minsepar = separ;
-                elem_loc = ielem + 1;
-              }
-          }
-
-        ElemID_data[i] = elem_loc;            
+      elem_loc = elem_bins_nearest(&elem_bins, xyz_data[i], elmctrs);
+      ElemID_data[i] = elem_loc + 1;
     }
 
+  elem_bins_free(&elem_bins);
+
   /* Find local coordinates */
   xi_data = (double **) malloc(txt_num_pts * sizeof(double*) );
   for (i = 0; i < txt_num_pts; i++)
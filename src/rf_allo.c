@@ -37,6 +37,8 @@ static char rcsid[] =
 #endif
 */
 #include <stdarg.h>
+#include <sys/time.h>
+#include <sys/resource.h>
 /*
  * Default behavior on out of memory is to print an error message and return
  */
@@ -44,11 +46,15 @@ static int ALLO_errorOption = 1;
 #include "std.h"
 
 #include "mm_eh.h"
+#include "rf_io_const.h"
 #include "rf_io.h"
 
+#define _RF_ALLO_C
 #include "rf_allo.h"
 
 extern int ProcID;
+extern int Num_Proc;
+extern int Num_Assembly_Threads;
 
 #ifndef ALLIGNMENT_BOUNDARY
 #define ALLIGNMENT_BOUNDARY  8
@@ -261,6 +267,299 @@ fprint_location(const char *filename, const int line)
 /*****************************************************************************/
 /*****************************************************************************/
 /*****************************************************************************/
+/*
+ * Allocation tracking (Memory Report File card).
+ *
+ * Once alloc_track_begin() has been called every block handed out by
+ * safe_malloc() is entered in a table keyed by its address, charged to
+ * the file and line that asked for it. safe_free() and safer_free() take
+ * it back out. Each site keeps the bytes it has live, the most it ever
+ * had live at once and the number of calls, and the whole processor keeps
+ * the same totals; alloc_report() writes the sites with the largest peaks
+ * and the most calls.
+ *
+ * Blocks released with a bare free() stay charged to their site until
+ * their address is handed out again, and blocks from before tracking
+ * began are not seen at all. Both only make the picture coarser.
+ */
+
+#define ALLOC_MAX_SITES 4096
+
+struct alloc_site {
+  const char *file;
+  int line;
+  long calls;
+  size_t live;
+  size_t peak;
+};
+
+struct alloc_block {
+  void *ptr;			/* NULL for an empty slot */
+  size_t bytes;
+  int site;			/* -1 for a slot freed since */
+};
+
+char Memory_Report_File[MAX_FNL] = "";
+int Memory_Report_Top = 10;
+
+static int Alloc_Tracking = FALSE;
+static struct alloc_site *Alloc_Sites = NULL;
+static int Alloc_Num_Sites = 0;
+static struct alloc_block *Alloc_Blocks = NULL;
+static size_t Alloc_Table_Size = 0;	/* a power of two */
+static size_t Alloc_Table_Used = 0;	/* occupied slots, freed ones included */
+static size_t Alloc_Live = 0;
+static size_t Alloc_Peak = 0;
+static long Alloc_Calls = 0;
+
+static size_t
+alloc_hash(const void *ptr)
+{
+  size_t h = (size_t) ptr;
+  h ^= h >> 17;
+  h *= (size_t) 0x9e3779b97f4a7c15ULL;
+  return h ^ (h >> 29);
+}
+
+static int
+alloc_site_index(const char *file, const int line)
+{
+  int i, h;
+
+  h = (int) ((alloc_hash(file) + (size_t) line * 31) % ALLOC_MAX_SITES);
+  for (i = 0; i < ALLOC_MAX_SITES; i++) {
+    struct alloc_site *s = Alloc_Sites + (h + i) % ALLOC_MAX_SITES;
+    if (s->file == NULL) {
+      s->file = file;
+      s->line = line;
+      Alloc_Num_Sites++;
+      return (h + i) % ALLOC_MAX_SITES;
+    }
+    if (s->line == line && s->file == file) return (h + i) % ALLOC_MAX_SITES;
+  }
+  return -1;
+}
+
+/*
+ * Slot of ptr in the block table, or the empty slot it would go in.
+ */
+
+static struct alloc_block *
+alloc_block_slot(const void *ptr)
+{
+  size_t h = alloc_hash(ptr) & (Alloc_Table_Size - 1);
+
+  while (Alloc_Blocks[h].ptr != NULL && Alloc_Blocks[h].ptr != ptr) {
+    h = (h + 1) & (Alloc_Table_Size - 1);
+  }
+  return Alloc_Blocks + h;
+}
+
+static void
+alloc_table_grow(void)
+{
+  struct alloc_block *old = Alloc_Blocks, *b;
+  size_t i, old_size = Alloc_Table_Size;
+
+  Alloc_Table_Size = (old_size == 0) ? 65536 : 2 * old_size;
+  Alloc_Blocks = (struct alloc_block *)
+      calloc(Alloc_Table_Size, sizeof(struct alloc_block));
+  if (Alloc_Blocks == NULL) {
+    /* no room to keep track, so quietly stop */
+    Alloc_Blocks = old;
+    Alloc_Table_Size = old_size;
+    Alloc_Tracking = FALSE;
+    return;
+  }
+  Alloc_Table_Used = 0;
+  for (i = 0; i < old_size; i++) {
+    if (old[i].ptr == NULL || old[i].site < 0) continue;
+    b = alloc_block_slot(old[i].ptr);
+    *b = old[i];
+    Alloc_Table_Used++;
+  }
+  free(old);
+}
+
+static void
+alloc_untrack_locked(const void *ptr)
+{
+  struct alloc_block *b = alloc_block_slot(ptr);
+
+  if (b->ptr == NULL || b->site < 0) return;
+  Alloc_Sites[b->site].live -= b->bytes;
+  Alloc_Live -= b->bytes;
+  b->site = -1;
+}
+
+static void
+alloc_track(void *ptr, const size_t bytes, const char *filename,
+	    const int line)
+{
+  struct alloc_block *b;
+  struct alloc_site *s;
+  int site;
+
+#ifdef _OPENMP
+#pragma omp critical (alloc_track)
+#endif
+  {
+    if (2 * (Alloc_Table_Used + 1) > Alloc_Table_Size) alloc_table_grow();
+    site = alloc_site_index(filename, line);
+    if (Alloc_Tracking && site >= 0) {
+      b = alloc_block_slot(ptr);
+      if (b->ptr != NULL && b->site >= 0) {
+	/* an address given back by a bare free() */
+	alloc_untrack_locked(ptr);
+      }
+      if (b->ptr == NULL) Alloc_Table_Used++;
+      b->ptr = ptr;
+      b->bytes = bytes;
+      b->site = site;
+
+      s = Alloc_Sites + site;
+      s->calls++;
+      s->live += bytes;
+      if (s->live > s->peak) s->peak = s->live;
+      Alloc_Calls++;
+      Alloc_Live += bytes;
+      if (Alloc_Live > Alloc_Peak) Alloc_Peak = Alloc_Live;
+    }
+  }
+}
+
+static void
+alloc_untrack(const void *ptr)
+{
+#ifdef _OPENMP
+#pragma omp critical (alloc_track)
+#endif
+  {
+    if (Alloc_Blocks != NULL) alloc_untrack_locked(ptr);
+  }
+}
+
+void
+alloc_track_begin(void)
+
+    /*************************************************************************
+     *
+     * alloc_track_begin():
+     *
+     *  Start charging the blocks from safe_malloc() to their sites, if a
+     *  Memory Report File was named. Called on every processor once the
+     *  input has been broadcast.
+     *************************************************************************/
+{
+  if (Memory_Report_File[0] == '\0' || Alloc_Tracking) return;
+  Alloc_Sites = (struct alloc_site *)
+      calloc(ALLOC_MAX_SITES, sizeof(struct alloc_site));
+  if (Alloc_Sites == NULL) return;
+  Alloc_Tracking = TRUE;
+  alloc_table_grow();
+}
+
+static int
+alloc_by_peak(const void *a, const void *b)
+{
+  const struct alloc_site *sa = *(const struct alloc_site * const *) a;
+  const struct alloc_site *sb = *(const struct alloc_site * const *) b;
+
+  if (sa->peak != sb->peak) return (sa->peak > sb->peak) ? -1 : 1;
+  return sa->line - sb->line;
+}
+
+static int
+alloc_by_calls(const void *a, const void *b)
+{
+  const struct alloc_site *sa = *(const struct alloc_site * const *) a;
+  const struct alloc_site *sb = *(const struct alloc_site * const *) b;
+
+  if (sa->calls != sb->calls) return (sa->calls > sb->calls) ? -1 : 1;
+  return sa->line - sb->line;
+}
+
+static void
+alloc_report_sites(FILE *fp,
+		   struct alloc_site **list,
+		   const int n,
+		   const char *heading)
+{
+  int i;
+
+  fprintf(fp, "\n%s\n", heading);
+  fprintf(fp, "  %14s %14s %12s  %s\n", "peak bytes", "live bytes",
+	  "calls", "site");
+  for (i = 0; i < n; i++) {
+    fprintf(fp, "  %14lu %14lu %12ld  %s:%d\n",
+	    (unsigned long) list[i]->peak, (unsigned long) list[i]->live,
+	    list[i]->calls, list[i]->file, list[i]->line);
+  }
+}
+
+void
+alloc_report(const char *when)
+
+    /*************************************************************************
+     *
+     * alloc_report():
+     *
+     *  Write this processor's allocation totals and its top
+     *  Memory_Report_Top sites by peak bytes and by number of calls to
+     *  Memory_Report_File, with the processor number appended in parallel.
+     *  when says what prompted it ("end of run", "out of memory").
+     *************************************************************************/
+{
+  char fname[MAX_FNL + 16];
+  struct alloc_site **list;
+  struct rusage ru;
+  FILE *fp;
+  int i, n, top;
+
+  if (!Alloc_Tracking) return;
+  Alloc_Tracking = FALSE;	/* nothing below is to be charged */
+
+  if (Num_Proc > 1) {
+    sprintf(fname, "%s.%d", Memory_Report_File, ProcID);
+  } else {
+    strcpy(fname, Memory_Report_File);
+  }
+  fp = fopen(fname, "w");
+  if (fp == NULL) {
+    fprintf(stderr, "P_%d: cannot open Memory Report File %s\n",
+	    ProcID, fname);
+    return;
+  }
+
+  list = (struct alloc_site **)
+      malloc(MAX(Alloc_Num_Sites, 1) * sizeof(struct alloc_site *));
+  n = 0;
+  for (i = 0; i < ALLOC_MAX_SITES && list != NULL; i++) {
+    if (Alloc_Sites[i].file != NULL) list[n++] = Alloc_Sites + i;
+  }
+  top = MIN(n, MAX(Memory_Report_Top, 1));
+
+  fprintf(fp, "Goma allocations on processor %d of %d at %s\n",
+	  ProcID, Num_Proc, when);
+  fprintf(fp, "  tracked live bytes  %lu\n", (unsigned long) Alloc_Live);
+  fprintf(fp, "  tracked peak bytes  %lu\n", (unsigned long) Alloc_Peak);
+  fprintf(fp, "  tracked calls       %ld at %d sites\n", Alloc_Calls, n);
+  if (getrusage(RUSAGE_SELF, &ru) == 0) {
+    fprintf(fp, "  max resident KB     %ld\n", (long) ru.ru_maxrss);
+  }
+
+  if (list != NULL) {
+    qsort(list, n, sizeof(struct alloc_site *), alloc_by_peak);
+    alloc_report_sites(fp, list, top, "Sites by peak bytes");
+    qsort(list, n, sizeof(struct alloc_site *), alloc_by_calls);
+    alloc_report_sites(fp, list, top, "Sites by calls");
+    free(list);
+  }
+  fclose(fp);
+}
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
 
 void *
 safe_malloc(const int n, const char *filename, const int line)
@@ -311,8 +610,10 @@ safe_malloc(const int n, const char *filename, const int line)
 	      "smalloc ERROR P_%d:  Memory allocation failure for %ld bytes", 
 	      ProcID, (long int)nn);
       fprint_location(filename, line);
+      alloc_report("out of memory");
       exit(-1);
     }
+    if (Alloc_Tracking) alloc_track(pntr, nn, filename, line);
 #ifdef DEBUG_MEMORY
     if ((int) pntr == ALLOC_PROBLEM_ADDRESS) {
       (void) fprintf(stderr,
@@ -349,6 +650,7 @@ safe_free(void *ptr)
   }
 #endif
   if (ptr != NULL) {
+    if (Alloc_Blocks != NULL) alloc_untrack(ptr);
     free(ptr);
   }
 #if DEBUG_LEVEL > 1
@@ -426,6 +728,7 @@ safer_free(void **ptr)
       fprintf(stderr, "safer_free: FOUND IT!\n");
     }
 #endif
+    if (Alloc_Blocks != NULL) alloc_untrack(*ptr);
     free (*ptr);
     *ptr = NULL;
   }
@@ -706,6 +1009,98 @@ alloc_dbl_1_FL(const int nvalues, const double val, const char *filename,
 /*****************************************************************************/
 /*****************************************************************************/
 
+/*
+ * First touch allocation. A page of a large array lands on the NUMA domain
+ * of the thread that first writes it, so an array zeroed by the master
+ * thread alone sits on one socket. These allocate without touching and
+ * then set the values in Num_Assembly_Threads contiguous blocks,
+ * block t by thread t: the split of the threaded vector loops, which
+ * cut [0,n) at n*t/nthr. With threads pinned (OMP_PROC_BIND) each block
+ * then stays local to the thread that works on it.
+ */
+
+static int
+first_touch_threads(const int nvalues)
+{
+  int nthr = 1;
+#ifdef _OPENMP
+  nthr = Num_Assembly_Threads;
+  if (nthr < 1 || nvalues < FIRST_TOUCH_MIN * nthr) nthr = 1;
+#endif
+  return nthr;
+}
+
+double *
+alloc_dbl_1_ft_FL(const int nvalues, const double val, const char *filename,
+		  const int line)
+
+  /**************************************************************************
+   *
+   *  alloc_dbl_1_ft_FL:
+   *  alloc_dbl_1_ft(const int nvalues, const double val):
+   *
+   *    alloc_dbl_1(), with the values set in parallel blocks. DBL_NOINIT
+   *    leaves the pages to whoever writes them first.
+   ***************************************************************************/
+{
+  int t, nthr = first_touch_threads(nvalues), nval1 = MAX(nvalues, 1);
+  double *array;
+
+  if (nthr == 1 || val == DBL_NOINIT) {
+    return (alloc_dbl_1_FL(nvalues, val, filename, line));
+  }
+  array = alloc_dbl_1_FL(nval1, DBL_NOINIT, filename, line);
+  if (array == NULL) return array;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) num_threads(nthr)
+#endif
+  for (t = 0; t < nthr; t++) {
+    int i;
+    int lo = (int) (((long) nval1 * t) / nthr);
+    int hi = (int) (((long) nval1 * (t + 1)) / nthr);
+    for (i = lo; i < hi; i++) array[i] = val;
+  }
+  return array;
+}
+/*****************************************************************************/
+
+int *
+alloc_int_1_ft_FL(const int nvalues, const int val, const char *filename,
+		  const int line)
+
+  /**************************************************************************
+   *
+   *  alloc_int_1_ft_FL:
+   *  alloc_int_1_ft(const int nvalues, const int val):
+   *
+   *    alloc_int_1(), with the values set in parallel blocks.
+   ***************************************************************************/
+{
+  int t, nthr = first_touch_threads(nvalues), nval1 = MAX(nvalues, 1);
+  int *array;
+
+  if (nthr == 1 || val == INT_NOINIT) {
+    return (alloc_int_1_FL(nvalues, val, filename, line));
+  }
+  array = alloc_int_1_FL(nval1, INT_NOINIT, filename, line);
+  if (array == NULL) return array;
+
+#ifdef _OPENMP
+#pragma omp parallel for schedule(static, 1) num_threads(nthr)
+#endif
+  for (t = 0; t < nthr; t++) {
+    int i;
+    int lo = (int) (((long) nval1 * t) / nthr);
+    int hi = (int) (((long) nval1 * (t + 1)) / nthr);
+    for (i = lo; i < hi; i++) array[i] = val;
+  }
+  return array;
+}
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
 double **
 alloc_dbl_2_FL(const int ndim1, const int ndim2, const double val,
 	       const char *filename, const int line)
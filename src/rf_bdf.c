@@ -0,0 +1,448 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * Variable-order, variable-step BDF time integration (BDF Maximum Order
+ * card).
+ *
+ * The last k+1 accepted solutions x_n, x_n-1, ... and their times are
+ * kept here.  The BDF formula of order k is the derivative, at t_n+1, of
+ * the polynomial through x_n+1 and the k solutions before it:
+ *
+ *      xdot_n+1 = alpha_0 x_n+1 + sum_j=1..k alpha_j x_n+1-j
+ *
+ * with coefficients recomputed every step for unequal steps.  Since
+ * alpha_0 plays the part of (1 + 2 theta)/dt in the element assembly and
+ * in the Newton update of xdot, a step is taken by handing
+ * solve_nonlinear_problem() the equivalent time step parameter
+ *
+ *      theta = (alpha_0 dt - 1) / 2
+ *
+ * (0 for BDF1, 1/4 for equal step BDF2), and a predicted xdot that is the
+ * BDF derivative of the predicted x.  The predictor is the polynomial of
+ * degree k through x_n ... x_n-k.
+ *
+ * The local truncation error of order q is estimated by Milne's device,
+ * the predictor-corrector difference times
+ *
+ *      1 / (1 + alpha_0,q (t_n+1 - t_n-q)),
+ *
+ * which is the factor time_step_control() has always used for order 1.
+ * The order is decided after each accepted step from the estimates at
+ * k-1 (predictor of degree k-1) and k+1 (the change in the correction
+ * since the last step), and only after k+1 steps at order k.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "std.h"
+#include "rf_fem_const.h"
+#include "rf_io_const.h"
+#include "rf_io.h"
+#include "rf_mp.h"
+#include "rf_allo.h"
+#include "mm_eh.h"
+
+#define _RF_BDF_C
+#include "goma.h"
+
+/*
+ * Another order is taken only if it allows a step this much larger.
+ */
+#define BDF_ORDER_SWITCH (1.2)
+
+static int     Bdf_N = 0;	/* length of the history vectors */
+static int     Bdf_Max = 0;	/* maximum order, 0 if BDF is not used */
+static int     Bdf_K = 1;	/* order of the current step */
+static int     Bdf_Next_K = 1;	/* order chosen for the step after it */
+static int     Bdf_Steps_At_K = 0; /* steps accepted at order Bdf_K */
+static int     Bdf_Num_Hist = 0; /* solutions held in Bdf_X */
+static double *Bdf_X[MAX_BDF_ORDER+1]; /* Bdf_X[0] = x_n, [1] = x_n-1, ... */
+static double  Bdf_T[MAX_BDF_ORDER+1]; /* times of Bdf_X */
+static double  Bdf_T_New = 0.;	/* t_n+1 */
+static double  Bdf_Alpha[MAX_BDF_ORDER+1]; /* BDF coefficients, order Bdf_K */
+static double  Bdf_Ext[MAX_BDF_ORDER+1][MAX_BDF_ORDER+1]; /* extrapolants */
+static double *Bdf_E = NULL;	/* x - x_pred of the last accepted step */
+static double  Bdf_E_Dt = 0.;	/* and its step */
+static int     Bdf_E_K = 0;	/* and its order, 0 if none */
+static double  Bdf_E_Scale = 0.; /* (dt/Bdf_E_Dt)^(k+1) */
+
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
+void
+bdf_init(const int N, const int max_order)
+{
+  int j;
+
+  bdf_free();
+  if (max_order <= 0) return;
+
+  Bdf_N   = N;
+  Bdf_Max = MIN(max_order, MAX_BDF_ORDER);
+  for (j = 0; j <= Bdf_Max; j++) Bdf_X[j] = alloc_dbl_1(MAX(N, 1), 0.0);
+  Bdf_E = alloc_dbl_1(MAX(N, 1), 0.0);
+  Bdf_Num_Hist = 0;
+  Bdf_K = Bdf_Next_K = 1;
+  Bdf_Steps_At_K = 0;
+  Bdf_E_K = 0;
+}
+
+void
+bdf_free(void)
+{
+  int j;
+
+  for (j = 0; j <= Bdf_Max; j++) safer_free((void **) &Bdf_X[j]);
+  safer_free((void **) &Bdf_E);
+  Bdf_Max = 0;
+  Bdf_N = 0;
+  Bdf_Num_Hist = 0;
+}
+
+int
+bdf_active(void)
+{
+  return (Bdf_Max > 0);
+}
+
+int
+bdf_order(void)
+{
+  return Bdf_K;
+}
+
+/*****************************************************************************/
+
+void
+bdf_restart(const double time, const double x[])
+
+    /*************************************************************************
+     *
+     * bdf_restart():
+     *
+     *  Start the integration over from x[] at time, at order 1, as at the
+     *  first step and after anything that discards the previous steps.
+     *************************************************************************/
+{
+  if (Bdf_Max == 0) return;
+
+  dcopy1(Bdf_N, x, Bdf_X[0]);
+  Bdf_T[0] = time;
+  Bdf_Num_Hist = 1;
+  Bdf_K = Bdf_Next_K = 1;
+  Bdf_Steps_At_K = 0;
+  Bdf_E_K = 0;
+}
+
+/*****************************************************************************/
+
+double
+bdf_prepare(const double delta_t)
+
+    /*************************************************************************
+     *
+     * bdf_prepare():
+     *
+     *  Compute the predictor and BDF coefficients for a step of delta_t
+     *  from the newest solution held.
+     *
+     *  Return: the time step parameter that makes (1 + 2 theta)/delta_t
+     *          equal to alpha_0.
+     *************************************************************************/
+{
+  int j, m, q, qmax, k;
+  double l, num, den;
+  double tau[MAX_BDF_ORDER+1];
+
+  Bdf_T_New = Bdf_T[0] + delta_t;
+  Bdf_K = MAX(1, MIN(Bdf_K, Bdf_Num_Hist));
+  k = Bdf_K;
+
+  /*
+   * Lagrange extrapolants of degree q through Bdf_X[0..q], at t_n+1.
+   */
+  qmax = MIN(Bdf_Num_Hist - 1, Bdf_Max);
+  for (q = 0; q <= qmax; q++) {
+    for (j = 0; j <= q; j++) {
+      l = 1.0;
+      for (m = 0; m <= q; m++) {
+	if (m != j) l *= (Bdf_T_New - Bdf_T[m]) / (Bdf_T[j] - Bdf_T[m]);
+      }
+      Bdf_Ext[q][j] = l;
+    }
+  }
+
+  /*
+   * Derivative at tau_0 = t_n+1 of the polynomial through tau_0 and
+   * tau_j = t_n+1-j, j = 1..k.
+   */
+  tau[0] = Bdf_T_New;
+  for (j = 1; j <= k; j++) tau[j] = Bdf_T[j-1];
+
+  Bdf_Alpha[0] = 0.0;
+  for (j = 1; j <= k; j++) Bdf_Alpha[0] += 1.0 / (tau[0] - tau[j]);
+  for (j = 1; j <= k; j++) {
+    num = 1.0;
+    den = 1.0;
+    for (m = 0; m <= k; m++) {
+      if (m == j) continue;
+      if (m > 0) num *= tau[0] - tau[m];
+      den *= tau[j] - tau[m];
+    }
+    Bdf_Alpha[j] = num / den;
+  }
+
+  Bdf_E_Scale = 0.0;
+  if (Bdf_E_K == k && Bdf_E_Dt > 0.0) {
+    Bdf_E_Scale = pow(delta_t / Bdf_E_Dt, (double) (k + 1));
+  }
+
+  if (k == 1) return 0.0;
+  return 0.5 * (Bdf_Alpha[0] * delta_t - 1.0);
+}
+
+/*****************************************************************************/
+
+int
+bdf_predict(const int N, double x[], double xdot[])
+
+    /*************************************************************************
+     *
+     * bdf_predict():
+     *
+     *  Predict x[] at t_n+1 by the extrapolant of degree k, and set xdot[]
+     *  to the BDF derivative there.  If fewer than k+1 solutions are held
+     *  (just after a restart) nothing is done and FALSE is returned; the
+     *  caller then uses predict_solution() with theta = 0.
+     *************************************************************************/
+{
+  int i, j, k = Bdf_K;
+  double sum;
+
+  if (Bdf_Num_Hist < k + 1) return FALSE;
+
+  for (i = 0; i < N; i++) {
+    sum = 0.0;
+    for (j = 0; j <= k; j++) sum += Bdf_Ext[k][j] * Bdf_X[j][i];
+    x[i] = sum;
+  }
+
+  for (i = 0; i < N; i++) {
+    sum = Bdf_Alpha[0] * x[i];
+    for (j = 1; j <= k; j++) sum += Bdf_Alpha[j] * Bdf_X[j-1][i];
+    xdot[i] = sum;
+  }
+
+  return TRUE;
+}
+
+/*****************************************************************************/
+
+void
+bdf_error_orders(int *q_lo, int *q_hi)
+
+    /*************************************************************************
+     *
+     * bdf_error_orders():
+     *
+     *  The orders besides the current one whose error time_step_control()
+     *  should estimate for this step, -1 if none.
+     *************************************************************************/
+{
+  int k = Bdf_K;
+
+  *q_lo = (k > 1) ? k - 1 : -1;
+  *q_hi = -1;
+  if (k < Bdf_Max && Bdf_Steps_At_K >= k + 1 &&
+      Bdf_E_K == k && Bdf_Num_Hist >= k + 1) {
+    *q_hi = k + 1;
+  }
+}
+
+double
+bdf_extrapolate(const int q, const int i)
+{
+  int j;
+  double sum = 0.0;
+
+  for (j = 0; j <= q; j++) sum += Bdf_Ext[q][j] * Bdf_X[j][i];
+  return sum;
+}
+
+double
+bdf_prev_correction(const int i)
+
+    /*************************************************************************
+     *
+     * bdf_prev_correction():
+     *
+     *  The correction x - x_pred of the previous step, scaled to this step.
+     *  Its difference from the present correction is of order k+2 and
+     *  estimates the error of the BDF formula of order k+1.
+     *************************************************************************/
+{
+  return Bdf_E_Scale * Bdf_E[i];
+}
+
+double
+bdf_error_factor(const int q)
+
+    /*************************************************************************
+     *
+     * bdf_error_factor():
+     *
+     *  Milne's factor turning the predictor-corrector difference into
+     *  the local truncation error of the order q formula.  For q = k + 1
+     *  (estimated from the change in the correction) the equal step
+     *  factor (k+1)/(k+2)^2 is used.
+     *************************************************************************/
+{
+  int j;
+  double alpha0 = 0.0;
+
+  if (q > Bdf_K) return ((double) q) / ((double) ((q + 1) * (q + 1)));
+
+  /* just after a restart: forward Euler predictor */
+  if (q >= Bdf_Num_Hist) return 0.5;
+
+  for (j = 0; j < q; j++) alpha0 += 1.0 / (Bdf_T_New - Bdf_T[j]);
+  return 1.0 / (1.0 + alpha0 * (Bdf_T_New - Bdf_T[q]));
+}
+
+/*****************************************************************************/
+
+static double
+bdf_step_for(const double delta_t, const double eps, const double err,
+	     const int q)
+{
+  if (err <= 0.0) return TIME_STEP_GROWTH_CAP * delta_t;
+  return delta_t * pow(eps / err, 1.0 / (q + 1));
+}
+
+double
+bdf_select_order(const double delta_t, const double delta_t_new,
+		 const double eps, const double err_lo, const double err,
+		 const double err_hi, const int const_delta_t)
+
+    /*************************************************************************
+     *
+     * bdf_select_order():
+     *
+     *  Choose the order of the next step from the error estimates of the
+     *  step just taken, err_lo and err_hi being negative when they were
+     *  not computed.  The order that allows the largest step is taken, if
+     *  that step is BDF_ORDER_SWITCH times the one at the current order.
+     *  With a constant step the order is simply raised while it can be.
+     *
+     *  Return: the step to use next.
+     *************************************************************************/
+{
+  int k = Bdf_K, q = Bdf_K;
+  double best, dt_q;
+  static char yo[] = "bdf_select_order";
+
+  if (const_delta_t) {
+    if (err_hi >= 0.0) q = k + 1;
+    Bdf_Next_K = q;
+    return delta_t_new;
+  }
+
+  best = bdf_step_for(delta_t, eps, err, k);
+  if (err_lo >= 0.0) {
+    dt_q = bdf_step_for(delta_t, eps, err_lo, k - 1);
+    if (dt_q > BDF_ORDER_SWITCH * best) {
+      q = k - 1;
+      best = dt_q;
+    }
+  }
+  if (err_hi >= 0.0) {
+    dt_q = bdf_step_for(delta_t, eps, err_hi, k + 1);
+    if (dt_q > BDF_ORDER_SWITCH * best) {
+      q = k + 1;
+      best = dt_q;
+    }
+  }
+
+  Bdf_Next_K = q;
+  if (q == k) return delta_t_new;
+
+  log_msg("BDF order %d -> %d: errors %g, %g, %g", k, q, err_lo, err, err_hi);
+  return best;
+}
+
+/*****************************************************************************/
+
+void
+bdf_push(const double time, const double x[], const double x_pred[])
+
+    /*************************************************************************
+     *
+     * bdf_push():
+     *
+     *  Add the solution accepted at time to the history and move to the
+     *  order chosen for the next step.
+     *************************************************************************/
+{
+  int i, j;
+  double *oldest;
+
+  if (Bdf_Max == 0) return;
+
+  for (i = 0; i < Bdf_N; i++) Bdf_E[i] = x[i] - x_pred[i];
+  Bdf_E_Dt = time - Bdf_T[0];
+  Bdf_E_K  = Bdf_K;
+
+  oldest = Bdf_X[Bdf_Max];
+  for (j = Bdf_Max; j > 0; j--) {
+    Bdf_X[j] = Bdf_X[j-1];
+    Bdf_T[j] = Bdf_T[j-1];
+  }
+  Bdf_X[0] = oldest;
+  dcopy1(Bdf_N, x, Bdf_X[0]);
+  Bdf_T[0] = time;
+  Bdf_Num_Hist = MIN(Bdf_Num_Hist + 1, Bdf_Max + 1);
+
+  if (Bdf_Next_K != Bdf_K) {
+    Bdf_K = Bdf_Next_K;
+    Bdf_Steps_At_K = 0;
+  } else {
+    Bdf_Steps_At_K++;
+  }
+  Bdf_K = MAX(1, MIN(Bdf_K, Bdf_Num_Hist - 1));
+  Bdf_Next_K = Bdf_K;
+}
+
+void
+bdf_step_failed(void)
+
+    /*************************************************************************
+     *
+     * bdf_step_failed():
+     *
+     *  A step was rejected; retry it, and restart the order count, one
+     *  order lower.
+     *************************************************************************/
+{
+  if (Bdf_Max == 0) return;
+
+  if (Bdf_K > 1) Bdf_K--;
+  Bdf_Next_K = Bdf_K;
+  Bdf_Steps_At_K = 0;
+}
+/*****************************************************************************/
+/* END of file rf_bdf.c */
+/*****************************************************************************/
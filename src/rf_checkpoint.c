@@ -0,0 +1,1001 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * In-memory checkpoint ring (Checkpoint Ring card).
+ *
+ * solve_problem() registers every piece of memory that makes up the state
+ * carried from one time step to the next: the solution history, the AC
+ * history, the element storage blocks and its own step size and counter
+ * scalars.  ckpt_save() copies all of it into the next of depth slots
+ * after each accepted step; ckpt_restore(back) copies a slot back and
+ * drops the newer ones.  Both are plain memcpy()s, so a rollback costs a
+ * copy of the state and nothing is recomputed.
+ *
+ * Every processor keeps the slots of its own unknowns (ghosts included),
+ * so a restore needs no communication.
+ *
+ * The same registered state can also go to a file (Checkpoint File card):
+ * ckpt_write_file() writes every processor's state, as it lies in memory,
+ * into one file, and ckpt_read_file() puts it back for a restart
+ * (Checkpoint Restart File card). The file is a header, the kind of every
+ * region, the size of every region and map of every processor, then each
+ * processor's regions and maps one after the other, in processor order.
+ * The maps give the global node and element numbers of the nodal and
+ * element regions, so a restart on another number of processors, or
+ * another partition of the mesh, redistributes the state in memory
+ * instead of going back through fix and brk. In parallel the file is
+ * written and read with MPI-IO, each processor at its own offset. It is
+ * written to <file>.tmp and renamed when complete, so a run killed while
+ * writing leaves the previous checkpoint in place.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "std.h"
+#include "rf_fem_const.h"
+#include "rf_io_const.h"
+#include "rf_io.h"
+#include "rf_mp.h"
+#include "rf_allo.h"
+#include "mm_eh.h"
+
+#define _RF_CHECKPOINT_C
+#include "goma.h"
+
+#define MAX_CKPT_REGIONS 64
+
+#define CKPT_MAGIC   "GOMACKP"
+#define CKPT_VERSION 2
+
+/* kinds of region */
+#define CKPT_WHOLE 0		/* the same on every processor */
+#define CKPT_NODAL 1		/* a vector over the unknowns of the local nodes */
+#define CKPT_ELEM  2		/* the element storage of a block */
+
+struct ckpt_file_header {
+  char magic[8];
+  int version;
+  int one;			/* 1, to catch a byte order change */
+  int num_proc;
+  int num_regions;
+};
+
+char Checkpoint_File[MAX_FNL] = "";
+dbl Checkpoint_Interval = 3600.;
+char Checkpoint_Restart_File[MAX_FNL] = "";
+
+static int     Ckpt_Depth = 0;	/* slots in the ring, 0 if not used */
+static int     Ckpt_Count = 0;	/* slots holding a snapshot */
+static int     Ckpt_Head = -1;	/* slot of the newest snapshot */
+static char  **Ckpt_Slot = NULL; /* [Ckpt_Depth] snapshots */
+static int     Ckpt_Num_Regions = 0;
+static void   *Ckpt_Ptr[MAX_CKPT_REGIONS];   /* registered memory */
+static size_t  Ckpt_Bytes[MAX_CKPT_REGIONS]; /* and its size */
+static int     Ckpt_Kind[MAX_CKPT_REGIONS];  /* CKPT_WHOLE, ... */
+static int     Ckpt_Block[MAX_CKPT_REGIONS]; /* element block of CKPT_ELEM */
+static size_t  Ckpt_Total = 0;	/* bytes in one snapshot */
+static int     Ckpt_Open = FALSE; /* ckpt_init() called, regions accepted */
+
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
+void
+ckpt_init(const int depth)
+{
+  ckpt_free();
+  Ckpt_Depth = MAX(depth, 0);
+  Ckpt_Open = TRUE;
+}
+
+static void
+ckpt_add(void *p, const size_t nbytes, const int kind, const int eb)
+{
+  if (Ckpt_Slot != NULL) {
+    EH(-1, "ckpt_register: the checkpoint ring is already in use");
+  }
+  if (Ckpt_Num_Regions == MAX_CKPT_REGIONS) {
+    EH(-1, "ckpt_register: increase MAX_CKPT_REGIONS");
+  }
+  Ckpt_Ptr[Ckpt_Num_Regions]   = p;
+  Ckpt_Bytes[Ckpt_Num_Regions] = nbytes;
+  Ckpt_Kind[Ckpt_Num_Regions]  = kind;
+  Ckpt_Block[Ckpt_Num_Regions] = eb;
+  Ckpt_Num_Regions++;
+  Ckpt_Total += nbytes;
+}
+
+void
+ckpt_register(void *p, const size_t nbytes)
+
+    /*************************************************************************
+     *
+     * ckpt_register():
+     *
+     *  Add nbytes at p to the state.  All of the state must be registered
+     *  before the first ckpt_save(), which sizes the slots.  Memory
+     *  registered here must be the same on every processor (AC unknowns,
+     *  time step scalars); the solution vectors go in with
+     *  ckpt_register_nodal() and the element storage with
+     *  ckpt_register_elem(), so that a checkpoint file can be read on
+     *  another decomposition.
+     *************************************************************************/
+{
+  if (!Ckpt_Open || p == NULL || nbytes == 0) return;
+  ckpt_add(p, nbytes, CKPT_WHOLE, -1);
+}
+
+void
+ckpt_register_nodal(dbl *p, const size_t nbytes)
+
+    /*************************************************************************
+     *
+     * ckpt_register_nodal():
+     *
+     *  Add a vector over the unknowns of all of the local nodes, external
+     *  ones included, laid out as the solution vector is.
+     *************************************************************************/
+{
+  if (!Ckpt_Open || p == NULL || nbytes == 0) return;
+  ckpt_add(p, nbytes, CKPT_NODAL, -1);
+}
+
+void
+ckpt_register_elem(const int eb)
+
+    /*************************************************************************
+     *
+     * ckpt_register_elem():
+     *
+     *  Add the element storage of element block index eb. A block without
+     *  any is added too, empty, so that every processor has the same
+     *  regions.
+     *************************************************************************/
+{
+  int len;
+  dbl *es;
+
+  if (!Ckpt_Open) return;
+  es = elemStorage_block(Element_Blocks + eb, &len);
+  ckpt_add(es, (es == NULL) ? 0 : len * sizeof(dbl), CKPT_ELEM, eb);
+}
+
+/*****************************************************************************/
+
+void
+ckpt_save(void)
+{
+  int i;
+  char *dest;
+
+  if (Ckpt_Depth == 0) return;
+
+  if (Ckpt_Slot == NULL) {
+    Ckpt_Slot = (char **) smalloc(Ckpt_Depth * sizeof(char *));
+    for (i = 0; i < Ckpt_Depth; i++) {
+      Ckpt_Slot[i] = (char *) smalloc(MAX(Ckpt_Total, 1));
+    }
+    DPRINTF(stdout, "Checkpoint ring: %d snapshots of %.4g MB\n",
+	    Ckpt_Depth, (double) Ckpt_Total / (1024. * 1024.));
+  }
+
+  Ckpt_Head = (Ckpt_Head + 1) % Ckpt_Depth;
+  dest = Ckpt_Slot[Ckpt_Head];
+  for (i = 0; i < Ckpt_Num_Regions; i++) {
+    if (Ckpt_Bytes[i] > 0) memcpy(dest, Ckpt_Ptr[i], Ckpt_Bytes[i]);
+    dest += Ckpt_Bytes[i];
+  }
+  Ckpt_Count = MIN(Ckpt_Count + 1, Ckpt_Depth);
+}
+
+/*****************************************************************************/
+
+int
+ckpt_restore(const int back)
+
+    /*************************************************************************
+     *
+     * ckpt_restore():
+     *
+     *  Put back the snapshot taken back saves before the newest one, which
+     *  then becomes the newest.
+     *
+     *  Return: TRUE, or FALSE (and nothing is changed) if the ring does
+     *          not reach back that far.
+     *************************************************************************/
+{
+  int i, slot;
+  char *src;
+
+  if (Ckpt_Depth == 0 || back < 0 || back >= Ckpt_Count) return FALSE;
+
+  slot = (Ckpt_Head - back + Ckpt_Depth) % Ckpt_Depth;
+  src = Ckpt_Slot[slot];
+  for (i = 0; i < Ckpt_Num_Regions; i++) {
+    if (Ckpt_Bytes[i] > 0) memcpy(Ckpt_Ptr[i], src, Ckpt_Bytes[i]);
+    src += Ckpt_Bytes[i];
+  }
+  Ckpt_Head = slot;
+  Ckpt_Count -= back;
+  return TRUE;
+}
+
+/*****************************************************************************/
+
+void
+ckpt_free(void)
+{
+  int i;
+
+  if (Ckpt_Slot != NULL) {
+    for (i = 0; i < Ckpt_Depth; i++) safer_free((void **) &Ckpt_Slot[i]);
+    safer_free((void **) &Ckpt_Slot);
+  }
+  Ckpt_Depth = 0;
+  Ckpt_Count = 0;
+  Ckpt_Head = -1;
+  Ckpt_Num_Regions = 0;
+  Ckpt_Total = 0;
+  Ckpt_Open = FALSE;
+}
+
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
+/*
+ * File access at byte offsets, with MPI-IO in parallel. Counts go in
+ * pieces of at most CKPT_IO_CHUNK bytes so that no count passes an int.
+ */
+
+#define CKPT_IO_CHUNK ((int64_t) 1 << 30)
+
+#ifdef PARALLEL
+typedef MPI_File ckpt_fh;
+#else
+typedef FILE *ckpt_fh;
+#endif
+
+static int
+ckpt_write_at(ckpt_fh fh, int64_t off, const void *buf, int64_t nbytes)
+{
+  const char *p = (const char *) buf;
+  int n, ok = TRUE;
+
+  while (nbytes > 0 && ok) {
+    n = (int) MIN(nbytes, CKPT_IO_CHUNK);
+#ifdef PARALLEL
+    {
+      MPI_Status status;
+      int nwrote;
+      ok &= (MPI_File_write_at(fh, (MPI_Offset) off, (void *) p, n, MPI_BYTE,
+			       &status) == MPI_SUCCESS);
+      MPI_Get_count(&status, MPI_BYTE, &nwrote);
+      ok &= (nwrote == n);
+    }
+#else
+    ok &= (fseek(fh, (long) off, SEEK_SET) == 0);
+    ok &= (fwrite(p, 1, n, fh) == (size_t) n);
+#endif
+    p += n;
+    off += n;
+    nbytes -= n;
+  }
+  return ok;
+}
+
+static int
+ckpt_read_at(ckpt_fh fh, int64_t off, void *buf, int64_t nbytes)
+{
+  char *p = (char *) buf;
+  int n, ok = TRUE;
+
+  while (nbytes > 0 && ok) {
+    n = (int) MIN(nbytes, CKPT_IO_CHUNK);
+#ifdef PARALLEL
+    {
+      MPI_Status status;
+      int nread;
+      ok &= (MPI_File_read_at(fh, (MPI_Offset) off, p, n, MPI_BYTE,
+			      &status) == MPI_SUCCESS);
+      MPI_Get_count(&status, MPI_BYTE, &nread);
+      ok &= (nread == n);
+    }
+#else
+    ok &= (fseek(fh, (long) off, SEEK_SET) == 0);
+    ok &= (fread(p, 1, n, fh) == (size_t) n);
+#endif
+    p += n;
+    off += n;
+    nbytes -= n;
+  }
+  return ok;
+}
+
+/* are all processors fine? */
+static int
+ckpt_all_ok(int ok)
+{
+#ifdef PARALLEL
+  int all_ok;
+  MPI_Allreduce(&ok, &all_ok, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+  ok = all_ok;
+#endif
+  return ok;
+}
+
+/*****************************************************************************/
+
+/*
+ * The maps that tie the nodal and element regions to global numbers, so
+ * that a file can be read back on another decomposition.
+ *
+ * Node map: (global node, first unknown, unknowns) of the first nnodes
+ * local nodes. Element map: for each element region in order, the number
+ * of elements of its block, the values per element in each field, then
+ * the global numbers of the elements.
+ */
+static int *
+ckpt_node_map(const int nnodes, int64_t *nbytes)
+{
+  int *map, i;
+  NODE_INFO_STRUCT *node;
+
+  map = (int *) smalloc(MAX(3 * nnodes, 1) * sizeof(int));
+  for (i = 0; i < nnodes; i++) {
+    node = Nodes[i];
+    map[3*i]   = DPI_ptr->node_index_global[i];
+    map[3*i+1] = node->First_Unknown;
+    map[3*i+2] = node->Nodal_Vars_Info->Num_Unknowns;
+  }
+  *nbytes = (int64_t) 3 * nnodes * (int64_t) sizeof(int);
+  return map;
+}
+
+static int *
+ckpt_elem_map(int64_t *nbytes)
+{
+  int *map, n = 0, r, k, eb, ne;
+  ELEMENT_STORAGE_STRUCT *s_ptr;
+
+  for (r = 0; r < Ckpt_Num_Regions; r++) {
+    if (Ckpt_Kind[r] == CKPT_ELEM) {
+      n += 2 + Element_Blocks[Ckpt_Block[r]].Num_Elems_In_Block;
+    }
+  }
+  map = (int *) smalloc(MAX(n, 1) * sizeof(int));
+  n = 0;
+  for (r = 0; r < Ckpt_Num_Regions; r++) {
+    if (Ckpt_Kind[r] != CKPT_ELEM) continue;
+    eb = Ckpt_Block[r];
+    ne = Element_Blocks[eb].Num_Elems_In_Block;
+    s_ptr = Element_Blocks[eb].ElemStorage;
+    map[n++] = ne;
+    map[n++] = (s_ptr == NULL) ? 0 : s_ptr->Num_Storage;
+    for (k = 0; k < ne; k++) {
+      map[n++] = DPI_ptr->elem_index_global[EXO_ptr->eb_ptr[eb] + k];
+    }
+  }
+  *nbytes = (int64_t) n * (int64_t) sizeof(int);
+  return map;
+}
+
+/*
+ * The sizes of every region of every processor, and of its maps,
+ * [num_proc][num_regions + 2], gathered on all of them. NULL if the
+ * processors have different numbers of regions.
+ */
+static int64_t *
+ckpt_file_table(const int64_t *mine, const int ncol)
+{
+  int64_t *all;
+
+  all = (int64_t *) smalloc(MAX(Num_Proc * ncol, 1) * sizeof(int64_t));
+#ifdef PARALLEL
+  {
+    int nmin, nmax;
+    MPI_Allreduce((void *) &ncol, &nmin, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+    MPI_Allreduce((void *) &ncol, &nmax, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    if (nmin != nmax) {
+      safe_free(all);
+      return NULL;
+    }
+    MPI_Allgather((void *) mine, ncol * (int) sizeof(int64_t), MPI_BYTE,
+		  all, ncol * (int) sizeof(int64_t), MPI_BYTE, MPI_COMM_WORLD);
+  }
+#else
+  memcpy(all, mine, ncol * sizeof(int64_t));
+#endif
+  return all;
+}
+
+/* where the data of processor proc starts in the file */
+static int64_t
+ckpt_proc_offset(const int64_t *table, const int ncol, const int proc,
+		 const int64_t head)
+{
+  int64_t off = head;
+  int p, i;
+
+  for (p = 0; p < proc; p++) {
+    for (i = 0; i < ncol; i++) off += table[p * ncol + i];
+  }
+  return off;
+}
+
+/*****************************************************************************/
+
+/*
+ * A nodal or element region on one processor seen as a list of keys:
+ * key i has global number gid[i] and nblk[i] pieces of len[i] doubles,
+ * the first at start[i] and each next one stride[i] doubles further on.
+ */
+struct ckpt_view {
+  int n;
+  int *gid, *start, *len, *nblk, *stride;
+};
+
+static void
+ckpt_view_alloc(struct ckpt_view *v, const int n)
+{
+  v->n = 0;
+  v->gid    = (int *) smalloc(MAX(n, 1) * sizeof(int));
+  v->start  = (int *) smalloc(MAX(n, 1) * sizeof(int));
+  v->len    = (int *) smalloc(MAX(n, 1) * sizeof(int));
+  v->nblk   = (int *) smalloc(MAX(n, 1) * sizeof(int));
+  v->stride = (int *) smalloc(MAX(n, 1) * sizeof(int));
+}
+
+static void
+ckpt_view_free(struct ckpt_view *v)
+{
+  safe_free(v->gid);
+  safe_free(v->start);
+  safe_free(v->len);
+  safe_free(v->nblk);
+  safe_free(v->stride);
+}
+
+/* the number of keys of region r */
+static int
+ckpt_view_count(const int r, const int64_t nmap_bytes, const int *emap)
+{
+  int q;
+
+  if (Ckpt_Kind[r] == CKPT_NODAL) return (int) (nmap_bytes / (3 * sizeof(int)));
+  for (q = 0; q < r; q++) {
+    if (Ckpt_Kind[q] == CKPT_ELEM) emap += 2 + emap[0];
+  }
+  return emap[0];
+}
+
+/*
+ * Add to v the keys of region r, of nvals doubles starting at double base
+ * of the values, from the maps of the processor it is on. A nodal region
+ * takes its keys from the node map; an element region from its part of
+ * the element map, with the fields of the block one after the other,
+ * Num_Elems * Num_Storage each.
+ */
+static void
+ckpt_view_add(struct ckpt_view *v, const int r, const int base,
+	      const int64_t nvals, const int *nmap, const int64_t nmap_bytes,
+	      const int *emap)
+{
+  int i, k, q, n, ne, ns, nf;
+
+  if (Ckpt_Kind[r] == CKPT_NODAL) {
+    n = (int) (nmap_bytes / (3 * sizeof(int)));
+    for (i = 0; i < n; i++, v->n++) {
+      v->gid[v->n]    = nmap[3*i];
+      v->start[v->n]  = base + nmap[3*i+1];
+      v->len[v->n]    = nmap[3*i+2];
+      v->nblk[v->n]   = 1;
+      v->stride[v->n] = 0;
+    }
+    return;
+  }
+
+  for (q = 0; q < r; q++) {
+    if (Ckpt_Kind[q] == CKPT_ELEM) emap += 2 + emap[0];
+  }
+  ne = emap[0];
+  ns = emap[1];
+  nf = (ne * ns > 0) ? (int) (nvals / ((int64_t) ne * ns)) : 0;
+  for (k = 0; k < ne; k++, v->n++) {
+    v->gid[v->n]    = emap[2 + k];
+    v->start[v->n]  = base + k * ns;
+    v->len[v->n]    = ns;
+    v->nblk[v->n]   = nf;
+    v->stride[v->n] = ne * ns;
+  }
+}
+
+/*
+ * The all-to-all exchange of doubles: scount[p] of sbuf (packed by
+ * destination) go to processor p; *rbuf gets rcount[p] from each p, packed
+ * by source.
+ */
+static void
+ckpt_exchange(const dbl *sbuf, int *scount, dbl **rbuf, int *rcount)
+{
+#ifdef PARALLEL
+  int *sdispl, *rdispl, p, nrecv = 0;
+
+  MPI_Alltoall(scount, 1, MPI_INT, rcount, 1, MPI_INT, MPI_COMM_WORLD);
+  sdispl = (int *) smalloc(Num_Proc * sizeof(int));
+  rdispl = (int *) smalloc(Num_Proc * sizeof(int));
+  for (p = 0; p < Num_Proc; p++) {
+    sdispl[p] = (p == 0) ? 0 : sdispl[p-1] + scount[p-1];
+    rdispl[p] = nrecv;
+    nrecv += rcount[p];
+  }
+  *rbuf = (dbl *) smalloc(MAX(nrecv, 1) * sizeof(dbl));
+  MPI_Alltoallv((void *) sbuf, scount, sdispl, MPI_DOUBLE,
+		*rbuf, rcount, rdispl, MPI_DOUBLE, MPI_COMM_WORLD);
+  safe_free(sdispl);
+  safe_free(rdispl);
+#else
+  rcount[0] = scount[0];
+  *rbuf = (dbl *) smalloc(MAX(rcount[0], 1) * sizeof(dbl));
+  memcpy(*rbuf, sbuf, rcount[0] * sizeof(dbl));
+#endif
+}
+
+/*
+ * Move the values of a region from the processors that have them (hval,
+ * laid out as in have) to the ones that want them (into wval, laid out as
+ * in want). A key may be wanted by several processors, ghosts included.
+ * Global number g is looked up on processor g % Num_Proc: the wanting
+ * processors send it their requests, the having ones their values, and it
+ * answers each request in the order it came. Collective.
+ *
+ * Return: TRUE if every wanted key was found with the expected length.
+ */
+static int
+ckpt_route(const struct ckpt_view *have, const dbl *hval,
+	   const struct ckpt_view *want, dbl *wval)
+{
+  int *scount, *qcount, *rcount, *cur, *slot;
+  dbl *sbuf, *d, *req, *rec, *ans;
+  int i, b, j, k, p, n, g, nslot, ngid = 0, nrec = 0;
+  int rlen, ok = TRUE;
+
+  for (i = 0; i < have->n; i++) ngid = MAX(ngid, have->gid[i] + 1);
+  for (i = 0; i < want->n; i++) ngid = MAX(ngid, want->gid[i] + 1);
+  ngid = gmax_int(ngid);
+  nslot = ngid / Num_Proc + 1;
+
+  scount = (int *) smalloc(Num_Proc * sizeof(int));
+  qcount = (int *) smalloc(Num_Proc * sizeof(int));
+  rcount = (int *) smalloc(Num_Proc * sizeof(int));
+  cur    = (int *) smalloc(Num_Proc * sizeof(int));
+
+  /* requests, in want order for each directory processor */
+  memset(scount, 0, Num_Proc * sizeof(int));
+  for (i = 0; i < want->n; i++) scount[want->gid[i] % Num_Proc]++;
+  for (p = 0, n = 0; p < Num_Proc; p++) { cur[p] = n; n += scount[p]; }
+  sbuf = (dbl *) smalloc(MAX(n, 1) * sizeof(dbl));
+  for (i = 0; i < want->n; i++) {
+    sbuf[cur[want->gid[i] % Num_Proc]++] = (dbl) want->gid[i];
+  }
+  ckpt_exchange(sbuf, scount, &req, qcount);
+  safe_free(sbuf);
+
+  /* records (gid, length, values) to the directory */
+  memset(scount, 0, Num_Proc * sizeof(int));
+  for (i = 0; i < have->n; i++) {
+    scount[have->gid[i] % Num_Proc] += 2 + have->nblk[i] * have->len[i];
+  }
+  for (p = 0, n = 0; p < Num_Proc; p++) { cur[p] = n; n += scount[p]; }
+  sbuf = (dbl *) smalloc(MAX(n, 1) * sizeof(dbl));
+  for (i = 0; i < have->n; i++) {
+    d = sbuf + cur[have->gid[i] % Num_Proc];
+    *d++ = (dbl) have->gid[i];
+    *d++ = (dbl) (have->nblk[i] * have->len[i]);
+    for (b = 0; b < have->nblk[i]; b++) {
+      for (j = 0; j < have->len[i]; j++) {
+	*d++ = hval[have->start[i] + b * have->stride[i] + j];
+      }
+    }
+    cur[have->gid[i] % Num_Proc] += 2 + have->nblk[i] * have->len[i];
+  }
+  ckpt_exchange(sbuf, scount, &rec, rcount);
+  for (p = 0; p < Num_Proc; p++) nrec += rcount[p];
+  safe_free(sbuf);
+
+  slot = (int *) smalloc(nslot * sizeof(int));
+  for (i = 0; i < nslot; i++) slot[i] = -1;
+  for (i = 0; i < nrec; i += 2 + (int) rec[i+1]) {
+    slot[(int) rec[i] / Num_Proc] = i;
+  }
+
+  /* answers, in request order for each wanting processor */
+  for (p = 0, k = 0, n = 0; p < Num_Proc; p++) {
+    for (j = 0; j < qcount[p]; j++, k++) {
+      g = (int) req[k];
+      n += 2 + ((slot[g / Num_Proc] < 0) ? 0 : (int) rec[slot[g / Num_Proc] + 1]);
+    }
+  }
+  sbuf = (dbl *) smalloc(MAX(n, 1) * sizeof(dbl));
+  for (p = 0, k = 0, n = 0; p < Num_Proc; p++) {
+    scount[p] = 0;
+    for (j = 0; j < qcount[p]; j++, k++) {
+      g = (int) req[k];
+      if (slot[g / Num_Proc] < 0) {
+	sbuf[n]   = (dbl) g;
+	sbuf[n+1] = -1.;
+	rlen = 2;
+      } else {
+	rlen = 2 + (int) rec[slot[g / Num_Proc] + 1];
+	memcpy(sbuf + n, rec + slot[g / Num_Proc], rlen * sizeof(dbl));
+      }
+      n += rlen;
+      scount[p] += rlen;
+    }
+  }
+  safe_free(req);
+  safe_free(rec);
+  safe_free(slot);
+  ckpt_exchange(sbuf, scount, &ans, rcount);
+  safe_free(sbuf);
+
+  /* each directory answered in the order it was asked */
+  for (p = 0, n = 0; p < Num_Proc; p++) { cur[p] = n; n += rcount[p]; }
+  for (i = 0; i < want->n && ok; i++) {
+    d = ans + cur[want->gid[i] % Num_Proc];
+    rlen = (int) d[1];
+    if ((int) d[0] != want->gid[i] || rlen != want->nblk[i] * want->len[i]) {
+      ok = FALSE;
+      continue;
+    }
+    d += 2;
+    for (b = 0; b < want->nblk[i]; b++) {
+      for (j = 0; j < want->len[i]; j++) {
+	wval[want->start[i] + b * want->stride[i] + j] = *d++;
+      }
+    }
+    cur[want->gid[i] % Num_Proc] += 2 + rlen;
+  }
+  safe_free(ans);
+  safe_free(scount);
+  safe_free(qcount);
+  safe_free(rcount);
+  safe_free(cur);
+  return ckpt_all_ok(ok);
+}
+
+/*****************************************************************************/
+
+/*
+ * Restart from a file written on another decomposition (np processors).
+ * The regions kept whole (AC state, time step scalars, ...) are the same
+ * on every processor and come from the first one of the old run. The
+ * old processors are shared out to read, old processor q to q % Num_Proc,
+ * and the nodal and element regions go to their new places by global
+ * node and element number with ckpt_route(), ghosts included.
+ *
+ * Return: TRUE, or FALSE if the file does not fit this problem.
+ */
+static int
+ckpt_redistribute(ckpt_fh fh, const int np, const int *fkind,
+		  const int64_t *ftable, const int64_t head)
+{
+  struct ckpt_view have, want;
+  int ncol = Ckpt_Num_Regions + 2;
+  int nchunk, c, q, r, k, n, base, ok = TRUE;
+  int *lnmap, *lemap;
+  int64_t lnmap_bytes, lemap_bytes, off, len;
+  char **chunk;
+  dbl *hval;
+
+  for (r = 0; r < Ckpt_Num_Regions; r++) ok &= (fkind[r] == Ckpt_Kind[r]);
+
+  off = ckpt_proc_offset(ftable, ncol, 0, head);
+  for (r = 0; r < Ckpt_Num_Regions && ok; r++) {
+    if (Ckpt_Kind[r] == CKPT_WHOLE) {
+      ok &= (ftable[r] == (int64_t) Ckpt_Bytes[r]);
+      ok &= ckpt_read_at(fh, off, Ckpt_Ptr[r], ftable[r]);
+    }
+    off += ftable[r];
+  }
+  if (!ckpt_all_ok(ok)) return FALSE;
+
+  nchunk = (ProcID < np) ? (np - ProcID + Num_Proc - 1) / Num_Proc : 0;
+  chunk = (char **) smalloc(MAX(nchunk, 1) * sizeof(char *));
+  for (c = 0; c < nchunk; c++) {
+    q = ProcID + c * Num_Proc;
+    for (len = 0, k = 0; k < ncol; k++) len += ftable[q * ncol + k];
+    chunk[c] = (char *) smalloc(MAX(len, 1));
+    ok &= ckpt_read_at(fh, ckpt_proc_offset(ftable, ncol, q, head),
+		       chunk[c], len);
+  }
+  ok = ckpt_all_ok(ok);
+
+  lnmap = ckpt_node_map(DPI_ptr->num_universe_nodes, &lnmap_bytes);
+  lemap = ckpt_elem_map(&lemap_bytes);
+
+  for (r = 0; r < Ckpt_Num_Regions && ok; r++) {
+    if (Ckpt_Kind[r] == CKPT_WHOLE) continue;
+
+    /* what the old processors read here have, one after the other */
+    for (n = 0, len = 0, c = 0; c < nchunk; c++) {
+      q = ProcID + c * Num_Proc;
+      for (off = 0, k = 0; k < Ckpt_Num_Regions; k++) off += ftable[q * ncol + k];
+      n += ckpt_view_count(r, ftable[q * ncol + Ckpt_Num_Regions],
+			   (int *) (chunk[c] + off + ftable[q * ncol + Ckpt_Num_Regions]));
+      len += ftable[q * ncol + r] / (int64_t) sizeof(dbl);
+    }
+    ckpt_view_alloc(&have, n);
+    hval = (dbl *) smalloc(MAX(len, 1) * sizeof(dbl));
+    for (base = 0, c = 0; c < nchunk; c++) {
+      int64_t nmap_bytes;
+      q = ProcID + c * Num_Proc;
+      for (off = 0, k = 0; k < r; k++) off += ftable[q * ncol + k];
+      memcpy(hval + base, chunk[c] + off, ftable[q * ncol + r]);
+      for (off = 0, k = 0; k < Ckpt_Num_Regions; k++) off += ftable[q * ncol + k];
+      nmap_bytes = ftable[q * ncol + Ckpt_Num_Regions];
+      ckpt_view_add(&have, r, base, ftable[q * ncol + r] / (int64_t) sizeof(dbl),
+		    (int *) (chunk[c] + off), nmap_bytes,
+		    (int *) (chunk[c] + off + nmap_bytes));
+      base += (int) (ftable[q * ncol + r] / (int64_t) sizeof(dbl));
+    }
+
+    /* and what this processor needs */
+    ckpt_view_alloc(&want, ckpt_view_count(r, lnmap_bytes, lemap));
+    ckpt_view_add(&want, r, 0, (int64_t) (Ckpt_Bytes[r] / sizeof(dbl)),
+		  lnmap, lnmap_bytes, lemap);
+
+    ok = ckpt_route(&have, hval, &want, (dbl *) Ckpt_Ptr[r]);
+
+    ckpt_view_free(&have);
+    ckpt_view_free(&want);
+    safe_free(hval);
+  }
+
+  for (c = 0; c < nchunk; c++) safe_free(chunk[c]);
+  safe_free(chunk);
+  safe_free(lnmap);
+  safe_free(lemap);
+  return ok;
+}
+
+/*****************************************************************************/
+
+int
+ckpt_write_file(const char *fname)
+
+    /*************************************************************************
+     *
+     * ckpt_write_file():
+     *
+     *  Write the registered state of all processors to the checkpoint file
+     *  fname, with the maps that let it be read on another decomposition.
+     *  Collective.
+     *
+     *  Return: 0, or -1 (with a warning, and any previous file left as it
+     *          was) if it could not be written
+     *************************************************************************/
+{
+  struct ckpt_file_header h;
+  char tmp[MAX_FNL + 8];
+  int64_t *mine, *table, off, head, nmap_bytes, emap_bytes;
+  int *nmap, *emap;
+  int i, ncol = Ckpt_Num_Regions + 2, ok = TRUE;
+  ckpt_fh fh;
+  dbl start = ut();
+
+  if (!Ckpt_Open || fname == NULL || fname[0] == '\0') return -1;
+
+  nmap = ckpt_node_map(DPI_ptr->num_owned_nodes, &nmap_bytes);
+  emap = ckpt_elem_map(&emap_bytes);
+  mine = (int64_t *) smalloc(ncol * sizeof(int64_t));
+  for (i = 0; i < Ckpt_Num_Regions; i++) mine[i] = (int64_t) Ckpt_Bytes[i];
+  mine[Ckpt_Num_Regions]     = nmap_bytes;
+  mine[Ckpt_Num_Regions + 1] = emap_bytes;
+  table = ckpt_file_table(mine, ncol);
+  safe_free(mine);
+  if (table == NULL) {
+    safe_free(nmap);
+    safe_free(emap);
+    WH(-1, "Checkpoint File: processors disagree on the state, nothing written");
+    return -1;
+  }
+
+  memset(&h, 0, sizeof(h));
+  strcpy(h.magic, CKPT_MAGIC);
+  h.version     = CKPT_VERSION;
+  h.one         = 1;
+  h.num_proc    = Num_Proc;
+  h.num_regions = Ckpt_Num_Regions;
+  head = (int64_t) sizeof(h) + Ckpt_Num_Regions * (int64_t) sizeof(int) +
+    (int64_t) Num_Proc * ncol * (int64_t) sizeof(int64_t);
+  off = ckpt_proc_offset(table, ncol, ProcID, head);
+  sprintf(tmp, "%s.tmp", fname);
+
+#ifdef PARALLEL
+  if (MPI_File_open(MPI_COMM_WORLD, tmp, MPI_MODE_CREATE | MPI_MODE_WRONLY,
+		    MPI_INFO_NULL, &fh) != MPI_SUCCESS) {
+    ok = FALSE;
+  } else {
+    MPI_File_set_size(fh, 0);
+  }
+#else
+  ok = ((fh = fopen(tmp, "wb")) != NULL);
+#endif
+  if (!ok) {
+    safe_free(table);
+    safe_free(nmap);
+    safe_free(emap);
+    WH(-1, "Could not open the Checkpoint File, nothing written");
+    return -1;
+  }
+
+  if (ProcID == 0) {
+    ok &= ckpt_write_at(fh, 0, &h, sizeof(h));
+    ok &= ckpt_write_at(fh, sizeof(h), Ckpt_Kind,
+			Ckpt_Num_Regions * (int64_t) sizeof(int));
+    ok &= ckpt_write_at(fh, sizeof(h) + Ckpt_Num_Regions * (int64_t) sizeof(int),
+			table, Num_Proc * ncol * (int64_t) sizeof(int64_t));
+  }
+  for (i = 0; i < Ckpt_Num_Regions && ok; i++) {
+    ok &= ckpt_write_at(fh, off, Ckpt_Ptr[i], Ckpt_Bytes[i]);
+    off += (int64_t) Ckpt_Bytes[i];
+  }
+  ok &= ckpt_write_at(fh, off, nmap, nmap_bytes);
+  ok &= ckpt_write_at(fh, off + nmap_bytes, emap, emap_bytes);
+#ifdef PARALLEL
+  ok &= (MPI_File_close(&fh) == MPI_SUCCESS);
+#else
+  ok &= (fclose(fh) == 0);
+#endif
+  safe_free(table);
+  safe_free(nmap);
+  safe_free(emap);
+
+  ok = ckpt_all_ok(ok);
+  if (ok && ProcID == 0) ok = (rename(tmp, fname) == 0);
+  ok = ckpt_all_ok(ok);
+  if (!ok) {
+    WH(-1, "Error writing the Checkpoint File, previous one kept");
+    return -1;
+  }
+  DPRINTF(stdout, "Checkpoint written to %s in %g s\n", fname, ut() - start);
+  return 0;
+}
+
+/*****************************************************************************/
+
+int
+ckpt_read_file(const char *fname)
+
+    /*************************************************************************
+     *
+     * ckpt_read_file():
+     *
+     *  Put the state saved in the checkpoint file fname back into the
+     *  registered memory. A file written on the same decomposition is read
+     *  back as it lies; one from any other number of processors, or
+     *  another partition, is redistributed by global node and element
+     *  number. Files of the first version can only be read on the same
+     *  decomposition. Collective.
+     *
+     *  Return: 0, or -1 (with a message, and the state possibly changed)
+     *************************************************************************/
+{
+  struct ckpt_file_header h;
+  int64_t *ftable = NULL, head = 0, off, len, nmap_bytes, emap_bytes;
+  int *fkind = NULL, *nmap = NULL, *emap = NULL, *fmap;
+  int i, n, ncol = 0, ok = TRUE, same;
+  ckpt_fh fh;
+
+  if (!Ckpt_Open) return -1;
+
+#ifdef PARALLEL
+  ok = (MPI_File_open(MPI_COMM_WORLD, (char *) fname, MPI_MODE_RDONLY,
+		      MPI_INFO_NULL, &fh) == MPI_SUCCESS);
+#else
+  ok = ((fh = fopen(fname, "rb")) != NULL);
+#endif
+  if (!ok) {
+    EH(-1, "Could not open the Checkpoint Restart File");
+    return -1;
+  }
+
+  memset(&h, 0, sizeof(h));
+  ok &= ckpt_read_at(fh, 0, &h, sizeof(h));
+  ok &= (strcmp(h.magic, CKPT_MAGIC) == 0 && h.one == 1 &&
+	 (h.version == 1 || h.version == CKPT_VERSION) && h.num_proc > 0 &&
+	 h.num_regions == Ckpt_Num_Regions);
+  if (ok) {
+    ncol = (h.version == 1) ? Ckpt_Num_Regions : Ckpt_Num_Regions + 2;
+    head = sizeof(h);
+    fkind = (int *) smalloc(MAX(Ckpt_Num_Regions, 1) * sizeof(int));
+    if (h.version == 1) {
+      memcpy(fkind, Ckpt_Kind, Ckpt_Num_Regions * sizeof(int));
+    } else {
+      ok &= ckpt_read_at(fh, head, fkind, Ckpt_Num_Regions * (int64_t) sizeof(int));
+      head += Ckpt_Num_Regions * (int64_t) sizeof(int);
+    }
+    n = h.num_proc * ncol;
+    ftable = (int64_t *) smalloc(MAX(n, 1) * sizeof(int64_t));
+    ok &= ckpt_read_at(fh, head, ftable, n * (int64_t) sizeof(int64_t));
+    head += n * (int64_t) sizeof(int64_t);
+  }
+  ok = ckpt_all_ok(ok);
+
+  /*
+   * The same decomposition when every processor finds its own region
+   * sizes and, in files that have them, its own maps in the file
+   */
+  same = ok && h.num_proc == Num_Proc;
+  for (i = 0; i < Ckpt_Num_Regions && same; i++) {
+    same &= (ftable[ProcID * ncol + i] == (int64_t) Ckpt_Bytes[i] &&
+	     fkind[i] == Ckpt_Kind[i]);
+  }
+  off = same ? ckpt_proc_offset(ftable, ncol, ProcID, head) : 0;
+  if (same && h.version > 1) {
+    nmap = ckpt_node_map(DPI_ptr->num_owned_nodes, &nmap_bytes);
+    emap = ckpt_elem_map(&emap_bytes);
+    for (len = 0, i = 0; i < Ckpt_Num_Regions; i++) len += ftable[ProcID * ncol + i];
+    same &= (ftable[ProcID * ncol + Ckpt_Num_Regions] == nmap_bytes &&
+	     ftable[ProcID * ncol + Ckpt_Num_Regions + 1] == emap_bytes);
+    if (same) {
+      fmap = (int *) smalloc(MAX(nmap_bytes + emap_bytes, 1));
+      same &= ckpt_read_at(fh, off + len, fmap, nmap_bytes + emap_bytes);
+      same &= (memcmp(fmap, nmap, nmap_bytes) == 0 &&
+	       memcmp((char *) fmap + nmap_bytes, emap, emap_bytes) == 0);
+      safe_free(fmap);
+    }
+    safe_free(nmap);
+    safe_free(emap);
+  }
+  same = ckpt_all_ok(same);
+
+  if (same) {
+    for (i = 0; i < Ckpt_Num_Regions && ok; i++) {
+      ok &= ckpt_read_at(fh, off, Ckpt_Ptr[i], Ckpt_Bytes[i]);
+      off += (int64_t) Ckpt_Bytes[i];
+    }
+  } else if (ok && h.version > 1) {
+    ok = ckpt_redistribute(fh, h.num_proc, fkind, ftable, head);
+  } else {
+    ok = FALSE;
+  }
+
+#ifdef PARALLEL
+  MPI_File_close(&fh);
+#else
+  fclose(fh);
+#endif
+  safe_free(fkind);
+  safe_free(ftable);
+
+  ok = ckpt_all_ok(ok);
+  if (!ok) {
+    EH(-1, "The Checkpoint Restart File does not match this problem");
+    return -1;
+  }
+  if (same) {
+    DPRINTF(stdout, "Restarted from checkpoint %s\n", fname);
+  } else {
+    DPRINTF(stdout, "Restarted from checkpoint %s, written on %d processors\n",
+	    fname, h.num_proc);
+  }
+  return 0;
+}
+/*****************************************************************************/
+/* END of file rf_checkpoint.c */
+/*****************************************************************************/
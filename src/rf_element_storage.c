@@ -115,10 +115,9 @@ init_element_storage(ELEM_BLK_STRUCT *eb_ptr)
       *
       *****************************************************************/
 {
-  int ip_total, i, numStorage;
+  int ip_total, numStorage, nfield = 0, n;
   ELEMENT_STORAGE_STRUCT *s_ptr;
   double *d_ptr;
-  double *base_ptr = NULL;
   /*
    * Check to make sure that we haven't already allocated storage
    */
@@ -127,8 +126,7 @@ init_element_storage(ELEM_BLK_STRUCT *eb_ptr)
      * Determine the number of quadrature points
      */
     ip_total        = eb_ptr->IP_total;
-    s_ptr = alloc_struct_1(ELEMENT_STORAGE_STRUCT, 
-			   eb_ptr->Num_Elems_In_Block);
+    s_ptr = alloc_struct_1(ELEMENT_STORAGE_STRUCT, 1);
     /*
      *  If porous mass lumping is used, we need to store values at
      *  the nodes as well as at the volumetric guass points. We will
@@ -144,48 +142,44 @@ init_element_storage(ELEM_BLK_STRUCT *eb_ptr)
     }
 
     /*
-     * Do a large block allocation for efficiency
-     * Argg. See PRS comment in rf_element_storage_struct.h 
+     * Do a large block allocation for efficiency, one field after the
+     * other. Argg. See PRS comment in rf_element_storage_struct.h 
      */
-     if (pd->e[R_POR_LIQ_PRES]) {
-       base_ptr = alloc_dbl_1(4 * numStorage * eb_ptr->Num_Elems_In_Block, 
-			      DBL_NOINIT); 
-     }
-     else if (pd->e[R_SHELL_SAT_OPEN] || pd->e[R_SHELL_SAT_OPEN_2] ) {
-       base_ptr = alloc_dbl_1(4 * numStorage * eb_ptr->Num_Elems_In_Block, 
-			      DBL_NOINIT); 
-     }
-     else if(pd->e[R_MESH1] && pd->MeshMotion == LAGRANGIAN) {
-
-       /* This is for shrinkage stress model for thermexp */
-       base_ptr = alloc_dbl_1( numStorage * eb_ptr->Num_Elems_In_Block, 
-			      DBL_NOINIT); 
-     }
+    if (pd->e[R_POR_LIQ_PRES] || pd->e[R_SHELL_SAT_OPEN] ||
+	pd->e[R_SHELL_SAT_OPEN_2]) {
+      nfield = 4;
+    } else if (pd->e[R_MESH1] && pd->MeshMotion == LAGRANGIAN) {
+      /* This is for shrinkage stress model for thermexp */
+      nfield = 1;
+    }
+    n = numStorage * eb_ptr->Num_Elems_In_Block;
+    s_ptr->Num_Storage = numStorage;
+    s_ptr->Num_Elems = eb_ptr->Num_Elems_In_Block;
+    s_ptr->Length = nfield * n;
+    if (s_ptr->Length > 0) {
+      s_ptr->Data = alloc_dbl_1(s_ptr->Length, DBL_NOINIT);
+    }
+
     /*
-     * Assign the pointers into the allocated memory block
+     * Assign the field pointers into the allocated memory block
      */
-    d_ptr = base_ptr;
-    eb_ptr->ElemStorage = s_ptr;
-    for (i = 0; i < eb_ptr->Num_Elems_In_Block; i++, s_ptr++) {
-      if (pd->e[R_POR_LIQ_PRES] || pd->e[R_SHELL_SAT_OPEN] || pd->e[R_SHELL_SAT_OPEN_2] ) {
+    d_ptr = s_ptr->Data;
+    if (nfield == 4) {
       s_ptr->Sat_QP_tn = d_ptr;
-      d_ptr += numStorage;
+      d_ptr += n;
       s_ptr->p_cap_QP = d_ptr;
-      d_ptr += numStorage;
+      d_ptr += n;
       s_ptr->sat_curve_type = d_ptr;
-      d_ptr += numStorage;
+      d_ptr += n;
       s_ptr->sat_curve_type_old = d_ptr;
-      d_ptr += numStorage;
-      }
-      else if (pd->e[R_MESH1] && pd->MeshMotion == LAGRANGIAN) {
-        s_ptr->solidified = d_ptr;
-	d_ptr += numStorage;
-      }
+    } else if (nfield == 1) {
+      s_ptr->solidified = d_ptr;
     }
+    eb_ptr->ElemStorage = s_ptr;
   }
 
   /* To reference use
-   * Element_Blocks->ElemStorage[elem_num].Sat_QP_tn[ip_no]
+   * ES_QP(eb_ptr, Sat_QP_tn, elem_num, ip_no)
    */
 }
 /************************************************************************/
@@ -299,7 +293,7 @@ set_init_Element_Storage(ELEM_BLK_STRUCT *eb_ptr, int mn)
 		{
 		  for (i = 0; i < eb_ptr->Num_Elems_In_Block; i++) 
 		    {
-		      eb_ptr->ElemStorage[i].sat_curve_type[ip] = ev_tmp[i];
+		      ES_QP(eb_ptr, sat_curve_type, i, ip) = ev_tmp[i];
 		    }
 		}
 	      else
@@ -326,7 +320,7 @@ set_init_Element_Storage(ELEM_BLK_STRUCT *eb_ptr, int mn)
 		{
 		  for (i = 0; i < eb_ptr->Num_Elems_In_Block; i++) 
 		    {
-		      eb_ptr->ElemStorage[i].Sat_QP_tn[ip] = ev_tmp[i];
+		      ES_QP(eb_ptr, Sat_QP_tn, i, ip) = ev_tmp[i];
 		    }
 		}
 	      else
@@ -352,7 +346,7 @@ set_init_Element_Storage(ELEM_BLK_STRUCT *eb_ptr, int mn)
 		{
 		  for (i = 0; i < eb_ptr->Num_Elems_In_Block; i++) 
 		    {
-		      eb_ptr->ElemStorage[i].p_cap_QP[ip] = ev_tmp[i];
+		      ES_QP(eb_ptr, p_cap_QP, i, ip) = ev_tmp[i];
 		    }
 		}
 	      else
@@ -393,9 +387,9 @@ set_init_Element_Storage(ELEM_BLK_STRUCT *eb_ptr, int mn)
 	    {
 	      for(ip = 0; ip < ip_total; ip++)
 		{
-		  eb_ptr->ElemStorage[i].p_cap_QP[ip] = pc_switch;
-		  eb_ptr->ElemStorage[i].Sat_QP_tn[ip] = sat_switch;
-		  eb_ptr->ElemStorage[i].sat_curve_type[ip] = Draining_curve;
+		  ES_QP(eb_ptr, p_cap_QP, i, ip) = pc_switch;
+		  ES_QP(eb_ptr, Sat_QP_tn, i, ip) = sat_switch;
+		  ES_QP(eb_ptr, sat_curve_type, i, ip) = Draining_curve;
 		}
 	    }
 	}
@@ -420,7 +414,7 @@ set_init_Element_Storage(ELEM_BLK_STRUCT *eb_ptr, int mn)
 	{
 	  for (i = 0; i < eb_ptr->Num_Elems_In_Block; i++) 
 	    {
-	      eb_ptr->ElemStorage[i].solidified[ip] = 0.0;
+	      ES_QP(eb_ptr, solidified, i, ip) = 0.0;
 	    }
 	}
     }
@@ -488,7 +482,7 @@ free_elemStorage(ELEM_BLK_STRUCT *eb_ptr)
 {
   ELEMENT_STORAGE_STRUCT *s_ptr = eb_ptr->ElemStorage;
   if (s_ptr) {
-    safer_free((void **) &(s_ptr->Sat_QP_tn));
+    safer_free((void **) &(s_ptr->Data));
     safer_free((void **) &(eb_ptr->ElemStorage));
   }
 }
@@ -496,6 +490,31 @@ free_elemStorage(ELEM_BLK_STRUCT *eb_ptr)
 /************************************************************************/
 /************************************************************************/
 
+double *
+elemStorage_block(ELEM_BLK_STRUCT *eb_ptr, int *length)
+
+     /*****************************************************************
+      *
+      * elemStorage_block()
+      *
+      *
+      *  Returns the single chunk of doubles allocated by
+      *  init_element_storage() for the element block, and its length
+      *  in *length, so that it can be saved and restored as a whole.
+      *  Returns NULL, with *length zero, if there is none.
+      *****************************************************************/
+{
+  ELEMENT_STORAGE_STRUCT *s_ptr = eb_ptr->ElemStorage;
+
+  *length = 0;
+  if (s_ptr == NULL || s_ptr->Length <= 0) return NULL;
+  *length = s_ptr->Length;
+  return s_ptr->Data;
+}
+/************************************************************************/
+/************************************************************************/
+/************************************************************************/
+
 double 
 get_nodalSat_tnm1_FromES(int lnn)
 
@@ -507,13 +526,13 @@ get_nodalSat_tnm1_FromES(int lnn)
       *  element storage at the local node number, lnn.
       *
       *  Note: these accessor functions here and below rely on current
-      *        values of  Current_EB_ptr and ei being correct!
+      *        values of  Current_EB_ptr and ei being correct! The
+      *        storage is numbered within the element block.
       *****************************************************************/
 {
-  int ielem = ei->ielem;
+  int ielem = ei->ielem - EXO_ptr->eb_ptr[ei->elem_blk_index];
   int ip_total = Current_EB_ptr->IP_total;
-  ELEMENT_STORAGE_STRUCT *es = Current_EB_ptr->ElemStorage + ielem;
-  return (es->Sat_QP_tn[ip_total + lnn]);
+  return (ES_QP(Current_EB_ptr, Sat_QP_tn, ielem, ip_total + lnn));
 }
 /************************************************************************/
 /************************************************************************/
@@ -531,9 +550,8 @@ get_Sat_tnm1_FromES(int ip)
       *
       *****************************************************************/
 {
-  int ielem = ei->ielem;
-  ELEMENT_STORAGE_STRUCT *es = Current_EB_ptr->ElemStorage + ielem;
-  return (es->Sat_QP_tn[ip]);
+  int ielem = ei->ielem - EXO_ptr->eb_ptr[ei->elem_blk_index];
+  return (ES_QP(Current_EB_ptr, Sat_QP_tn, ielem, ip));
 }
 /************************************************************************/
 /************************************************************************/
@@ -551,10 +569,9 @@ put_nodalSat_tn_IntoES(int lnn, double sat)
       *
       *****************************************************************/
 {
-  int ielem = ei->ielem;
+  int ielem = ei->ielem - EXO_ptr->eb_ptr[ei->elem_blk_index];
   int ip_total = Current_EB_ptr->IP_total;
-  ELEMENT_STORAGE_STRUCT *es = Current_EB_ptr->ElemStorage + ielem;
-  es->Sat_QP_tn[ip_total + lnn] = sat;
+  ES_QP(Current_EB_ptr, Sat_QP_tn, ielem, ip_total + lnn) = sat;
 }
 /************************************************************************/
 /************************************************************************/
@@ -573,9 +590,8 @@ put_Sat_tn_IntoES(int ip, double sat)
       *
       *****************************************************************/
 {
-  int ielem = ei->ielem;
-  ELEMENT_STORAGE_STRUCT *es = Current_EB_ptr->ElemStorage + ielem;
-  es->Sat_QP_tn[ip] = sat;
+  int ielem = ei->ielem - EXO_ptr->eb_ptr[ei->elem_blk_index];
+  ES_QP(Current_EB_ptr, Sat_QP_tn, ielem, ip) = sat;
 }
 /************************************************************************/
 /************************************************************************/
@@ -17,6 +17,7 @@
 
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "std.h"
 
@@ -39,6 +40,20 @@
 
 #include "goma.h"
 
+/*
+ * After compact_node_mat_lists() the Mat_List of every node points into
+ * this one block instead of into its own allocation.
+ */
+static int *Mat_List_Pool = NULL;
+static int Mat_List_Pool_Len = 0;
+
+static int
+in_mat_list_pool(const int *list)
+{
+  return (Mat_List_Pool != NULL && list != NULL &&
+	  list >= Mat_List_Pool && list < Mat_List_Pool + Mat_List_Pool_Len);
+}
+
 /****************************************************************************/
 /****************************************************************************/
 /****************************************************************************/
@@ -149,6 +164,11 @@ void add_to_umi_int_list(UMI_LIST_STRUCT *ls, int addition)
     if (list_loc < ls->Length) {
       if (list[list_loc] == addition) return;
     }
+    if (in_mat_list_pool(list)) {
+      /* it cannot grow in place, give it its own storage again */
+      list = alloc_int_1(ls->Length, INT_NOINIT);
+      memcpy(list, ls->List, ls->Length * sizeof(int));
+    }
     ls->Length++;
     //list = realloc(list, sizeof(int)*(ls->Length));
     realloc_int_1(&list, ls->Length, ls->Length-1);
@@ -300,7 +320,10 @@ free_nodes (void)
     node_ptr = Nodes[i];
     free_umi_list(&(node_ptr->Mat_List));
     safer_free((void **) &(node_ptr->DBC));
+    safer_free((void **) &(node_ptr->DBC_Dofs));
   }
+  safer_free((void **) &Mat_List_Pool);
+  Mat_List_Pool_Len = 0;
   /*
    *  free_umi_list(&(node_ptr->Element_List));
    */
@@ -499,9 +522,51 @@ free_umi_list(UMI_LIST_STRUCT *umi_ptr)
     *********************************************************************/
 {
  if (umi_ptr == NULL) return;
- safer_free((void **) &(umi_ptr->List));
+ if (in_mat_list_pool(umi_ptr->List)) {
+   umi_ptr->List = NULL;
+ } else {
+   safer_free((void **) &(umi_ptr->List));
+ }
  umi_ptr->Length = 0;
 }
+/************************************************************************/
+/************************************************************************/
+/************************************************************************/
+
+void
+compact_node_mat_lists(const int num_nodes)
+
+    /********************************************************************
+     *
+     * compact_node_mat_lists():
+     *
+     *   Move the material lists of nodes [0,num_nodes) out of their
+     *   one-per-node allocations into a single block, in node order, so
+     *   that they cost no allocation overhead and lie next to each other.
+     *   The lists stay UMI lists: one that is added to afterwards gets
+     *   its own storage back.
+     ********************************************************************/
+{
+  int I, total = 0, *pool, *p;
+  UMI_LIST_STRUCT *ls;
+
+  for (I = 0; I < num_nodes; I++) total += Nodes[I]->Mat_List.Length;
+
+  pool = alloc_int_1(MAX(total, 1), INT_NOINIT);
+  p = pool;
+  for (I = 0; I < num_nodes; I++) {
+    ls = &(Nodes[I]->Mat_List);
+    if (ls->Length <= 0) continue;
+    memcpy(p, ls->List, ls->Length * sizeof(int));
+    if (!in_mat_list_pool(ls->List)) safer_free((void **) &(ls->List));
+    ls->List = p;
+    p += ls->Length;
+  }
+
+  safer_free((void **) &Mat_List_Pool);
+  Mat_List_Pool = pool;
+  Mat_List_Pool_Len = MAX(total, 1);
+}
 
 /************************************************************************/
 /************************************************************************/
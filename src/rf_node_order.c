@@ -0,0 +1,377 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * Order in which the nodes get their unknowns (Node Reorder card).
+ *
+ * set_unknown_map() numbers the unknowns node by node.  Following the
+ * order of the EXODUS II file, the rows of neighboring nodes can be far
+ * apart, which gives a wide MSR matrix and poor reuse of the solution and
+ * matrix data during assembly.  Here the nodes are ordered either by
+ * reverse Cuthill-McKee on the node->node graph, or along a Morton
+ * (Z-order) curve through the node coordinates.
+ *
+ * Only the unknowns move.  Node numbers, and so the mesh, the boundary
+ * condition sets and everything written to the output files, stay in the
+ * order of the file.  The internal, boundary and external nodes are each
+ * ordered among themselves, since the solver and the communication
+ * pattern depend on those ranges; the external nodes keep their order.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "std.h"
+#include "rf_fem_const.h"
+#include "rf_io_const.h"
+#include "rf_io.h"
+#include "rf_mp.h"
+#include "rf_allo.h"
+#include "rf_solver.h"
+#include "rf_solver_const.h"
+#include "mm_eh.h"
+#include "exo_struct.h"
+#include "dpi.h"
+
+#define _RF_NODE_ORDER_C
+#include "goma.h"
+
+struct morton_key
+{
+  unsigned long long key;
+  int node;
+};
+
+/*
+ * Breadth first search through the nodes of [lo,hi) not yet done,
+ * starting at root. The nodes reached are left in queue[] level by level.
+ *
+ * Return: number of levels; *num_queued and the start of the last level
+ *         in queue[] are also returned.
+ */
+
+static int
+bfs_levels(Exo_DB *exo,
+	   const int lo,
+	   const int hi,
+	   const int root,
+	   const char *done,
+	   int *stamp,
+	   const int s,
+	   int *queue,
+	   int *num_queued,
+	   int *last_level)
+{
+  int head = 0, tail = 0, level_end, levels = 0;
+  int k, nbr;
+
+  queue[tail++] = root;
+  stamp[root] = s;
+  while (head < tail) {
+    level_end = tail;
+    *last_level = head;
+    levels++;
+    for ( ; head < level_end; head++) {
+      for (k = exo->node_node_pntr[queue[head]];
+	   k < exo->node_node_pntr[queue[head]+1]; k++) {
+	nbr = exo->node_node_list[k];
+	if (nbr < lo || nbr >= hi || done[nbr] || stamp[nbr] == s) continue;
+	stamp[nbr] = s;
+	queue[tail++] = nbr;
+      }
+    }
+  }
+  *num_queued = tail;
+  return levels;
+}
+
+/*
+ * Reverse Cuthill-McKee order of the nodes [lo,hi), written to
+ * order[lo..hi). Each connected piece starts from a pseudo-peripheral
+ * node found by the George-Liu iteration.
+ */
+
+static void
+rcm_range(Exo_DB *exo,
+	  const int lo,
+	  const int hi,
+	  int *order)
+{
+  int i, j, k, n, nbr, pos, head, tail, root, next, t;
+  int levels, new_levels, num_queued, last_level, s = 0;
+  int *deg, *stamp, *queue;
+  char *done;
+
+  n = hi - lo;
+  if (n <= 1) {
+    for (i = lo; i < hi; i++) order[i] = i;
+    return;
+  }
+
+  deg   = alloc_int_1(exo->num_nodes, 0);
+  stamp = alloc_int_1(exo->num_nodes, -1);
+  queue = alloc_int_1(n, -1);
+  done  = (char *) calloc(exo->num_nodes, sizeof(char));
+
+  for (i = lo; i < hi; i++) {
+    for (k = exo->node_node_pntr[i]; k < exo->node_node_pntr[i+1]; k++) {
+      nbr = exo->node_node_list[k];
+      if (nbr >= lo && nbr < hi && nbr != i) deg[i]++;
+    }
+  }
+
+  pos = lo;
+  next = lo;
+  while (pos < hi) {
+    while (done[next]) next++;
+
+    /*
+     * Pseudo-peripheral root of this piece: hop to the lowest degree node
+     * of the last level for as long as that makes the level structure
+     * deeper.
+     */
+    root = next;
+    levels = bfs_levels(exo, lo, hi, root, done, stamp, s++, queue,
+			&num_queued, &last_level);
+    for (j = 0; j < 8; j++) {
+      t = queue[last_level];
+      for (k = last_level + 1; k < num_queued; k++) {
+	if (deg[queue[k]] < deg[t]) t = queue[k];
+      }
+      new_levels = bfs_levels(exo, lo, hi, t, done, stamp, s++, queue,
+			      &num_queued, &last_level);
+      if (new_levels <= levels) break;
+      root = t;
+      levels = new_levels;
+    }
+
+    /*
+     * Cuthill-McKee: breadth first from the root, the new neighbors of
+     * each node taken in order of increasing degree.
+     */
+    head = tail = pos;
+    order[tail++] = root;
+    done[root] = 1;
+    while (head < tail) {
+      i = order[head++];
+      t = tail;
+      for (k = exo->node_node_pntr[i]; k < exo->node_node_pntr[i+1]; k++) {
+	nbr = exo->node_node_list[k];
+	if (nbr < lo || nbr >= hi || done[nbr]) continue;
+	done[nbr] = 1;
+	order[tail++] = nbr;
+      }
+      for (j = t + 1; j < tail; j++) {
+	nbr = order[j];
+	for (k = j; k > t && deg[order[k-1]] > deg[nbr]; k--) {
+	  order[k] = order[k-1];
+	}
+	order[k] = nbr;
+      }
+    }
+    pos = tail;
+  }
+
+  for (i = lo, j = hi - 1; i < j; i++, j--) {
+    t = order[i];
+    order[i] = order[j];
+    order[j] = t;
+  }
+
+  safe_free(deg);
+  safe_free(stamp);
+  safe_free(queue);
+  safe_free(done);
+}
+
+/*
+ * Spread the low 21 bits of v out to every third bit.
+ */
+
+static unsigned long long
+morton_spread(unsigned long long v)
+{
+  v &= 0x1fffffULL;
+  v = (v | v << 32) & 0x1f00000000ffffULL;
+  v = (v | v << 16) & 0x1f0000ff0000ffULL;
+  v = (v | v << 8)  & 0x100f00f00f00f00fULL;
+  v = (v | v << 4)  & 0x10c30c30c30c30c3ULL;
+  v = (v | v << 2)  & 0x1249249249249249ULL;
+  return v;
+}
+
+static int
+morton_compare(const void *a, const void *b)
+{
+  const struct morton_key *ka = (const struct morton_key *) a;
+  const struct morton_key *kb = (const struct morton_key *) b;
+
+  if (ka->key != kb->key) return (ka->key < kb->key) ? -1 : 1;
+  return ka->node - kb->node;
+}
+
+/*
+ * Morton order of the nodes [lo,hi), written to order[lo..hi). The
+ * coordinates are scaled to 21 bits over the bounding box of the range.
+ */
+
+static void
+morton_range(Exo_DB *exo,
+	     const int lo,
+	     const int hi,
+	     int *order)
+{
+  int i, d, n;
+  dbl *coord[3], cmin[3], cscale[3];
+  struct morton_key *keys;
+  unsigned long long q;
+
+  n = hi - lo;
+  if (n <= 1) {
+    for (i = lo; i < hi; i++) order[i] = i;
+    return;
+  }
+
+  coord[0] = exo->x_coord;
+  coord[1] = (exo->num_dim > 1) ? exo->y_coord : NULL;
+  coord[2] = (exo->num_dim > 2) ? exo->z_coord : NULL;
+
+  for (d = 0; d < 3; d++) {
+    dbl cmax;
+    cmin[d] = 0.;
+    cscale[d] = 0.;
+    if (coord[d] == NULL) continue;
+    cmin[d] = cmax = coord[d][lo];
+    for (i = lo + 1; i < hi; i++) {
+      cmin[d] = MIN(cmin[d], coord[d][i]);
+      cmax = MAX(cmax, coord[d][i]);
+    }
+    if (cmax > cmin[d]) cscale[d] = 2097151. / (cmax - cmin[d]);
+  }
+
+  keys = (struct morton_key *) smalloc(n * sizeof(struct morton_key));
+  for (i = lo; i < hi; i++) {
+    keys[i-lo].key = 0;
+    keys[i-lo].node = i;
+    for (d = 0; d < 3; d++) {
+      if (coord[d] == NULL) continue;
+      q = (unsigned long long) ((coord[d][i] - cmin[d]) * cscale[d]);
+      keys[i-lo].key |= morton_spread(q) << d;
+    }
+  }
+
+  qsort(keys, n, sizeof(struct morton_key), morton_compare);
+  for (i = 0; i < n; i++) order[lo+i] = keys[i].node;
+
+  safe_free(keys);
+}
+
+/*
+ * Half bandwidth of the owned part of the node->node graph when node i
+ * is numbered pos[i].
+ */
+
+static int
+node_bandwidth(Exo_DB *exo,
+	       const int num_owned,
+	       const int *pos)
+{
+  int i, k, nbr, bw = 0;
+
+  for (i = 0; i < num_owned; i++) {
+    for (k = exo->node_node_pntr[i]; k < exo->node_node_pntr[i+1]; k++) {
+      nbr = exo->node_node_list[k];
+      if (nbr >= num_owned) continue;
+      bw = MAX(bw, abs(pos[i] - pos[nbr]));
+    }
+  }
+  return bw;
+}
+
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
+int *
+node_unknown_order(const char *method,
+		   Exo_DB *exo,
+		   Dpi *dpi)
+
+    /*************************************************************************
+     *
+     * node_unknown_order():
+     *
+     *  Return: order[k] = the node whose unknowns are numbered k-th, for
+     *          the exo->num_nodes nodes on this processor; NULL when the
+     *          file order is to be kept. The caller frees it.
+     *************************************************************************/
+{
+  int i, bw_file, bw_new;
+  int num_internal, num_owned;
+  int *order, *pos;
+
+  if (method == NULL || strcmp(method, "none") == 0 ||
+      strcmp(method, "") == 0) {
+    return NULL;
+  }
+
+  if (strcmp(method, "rcm") != 0 && strcmp(method, "morton") != 0) {
+    EH(-1, "Node Reorder must be none, rcm or morton");
+  }
+
+  /*
+   * VBR, Epetra and the frontal solver lay out their rows node by node
+   * in the order of the file.
+   */
+  if (strcmp(Matrix_Format, "msr") != 0 || Linear_Solver == FRONT) {
+    WH(-1, "Node Reorder needs the msr matrix format, file order kept");
+    return NULL;
+  }
+
+  if (!exo->node_node_conn_exists) {
+    WH(-1, "Node Reorder needs the node->node connectivity, file order kept");
+    return NULL;
+  }
+
+  num_internal = dpi->num_internal_nodes;
+  num_owned    = dpi->num_internal_nodes + dpi->num_boundary_nodes;
+
+  order = alloc_int_1(exo->num_nodes, -1);
+
+  if (strcmp(method, "rcm") == 0) {
+    rcm_range(exo, 0, num_internal, order);
+    rcm_range(exo, num_internal, num_owned, order);
+  } else {
+    morton_range(exo, 0, num_internal, order);
+    morton_range(exo, num_internal, num_owned, order);
+  }
+  for (i = num_owned; i < exo->num_nodes; i++) order[i] = i;
+
+  /*
+   * Report what it bought in the half bandwidth of the node graph.
+   */
+  pos = alloc_int_1(exo->num_nodes, -1);
+  for (i = 0; i < exo->num_nodes; i++) pos[i] = i;
+  bw_file = node_bandwidth(exo, num_owned, pos);
+  for (i = 0; i < exo->num_nodes; i++) pos[order[i]] = i;
+  bw_new = node_bandwidth(exo, num_owned, pos);
+  safe_free(pos);
+
+  DPRINTF(stdout, "Node Reorder (%s): node bandwidth %d in file order, %d\n",
+	  method, bw_file, bw_new);
+
+  return order;
+}
+/*****************************************************************************/
+/* END of file rf_node_order.c */
+/*****************************************************************************/
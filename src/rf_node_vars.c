@@ -505,6 +505,11 @@ add_var_to_nv_struct(VARIABLE_DESCRIPTION_STRUCT *vd,
    */
   nv->Num_Var_Desc_Per_Type[var_type]++;
 
+  /*
+   * Any Index_Solution() table of the old pattern is now stale
+   */
+  safer_free((void **) &(nv->Index_Table));
+
   /*
    * Calculate the new offset variable.
    */
@@ -671,6 +676,7 @@ nodal_vars_free(NODAL_VARS_STRUCT *nv)
   }
   safer_free((void **) &(nv->Var_Desc_List));
   safer_free((void **) &(nv->Nodal_Offset));
+  safer_free((void **) &(nv->Index_Table));
   (void) memset((void *)nv, 0, sizeof(NODAL_VARS_STRUCT));
 }
 /*****************************************************************************/
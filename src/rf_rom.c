@@ -0,0 +1,572 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * Projection-based reduced order models (Reduced Order Model card).
+ *
+ * collect: every solution that write_solution() writes, whether a time
+ * step, a continuation point or the steady solve, is kept as a snapshot.
+ * At the end of the run the snapshots, less their mean, are reduced by
+ * the method of snapshots to a POD basis, which is written with the mean
+ * to the ROM Basis File.
+ *
+ * solve: the nonlinear solver looks for x = x_mean + Phi q instead. The
+ * samples are the nodes of the rows picked by DEIM from the basis, and
+ * more if ROM Sample Nodes asks; the fills of the reduced Newton loop
+ * assemble only the elements around them, whose residuals and Jacobian
+ * rows are then complete at the sample rows. Each reduced step is the
+ * least squares (Gauss-Newton) step for those rows, min |R_s + J_s Phi dq|,
+ * a dense system of the basis size on every processor.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+
+#include "std.h"
+#include "rf_allo.h"
+#include "rf_fem_const.h"
+#include "rf_fem.h"
+#include "rf_io_const.h"
+#include "rf_io.h"
+#include "rf_solver_const.h"
+#include "rf_solver.h"
+#include "rf_mp.h"
+#include "mm_as_structs.h"
+#include "mm_as.h"
+#include "mm_eh.h"
+#include "exo_struct.h"
+#include "dpi.h"
+
+#define _RF_ROM_C
+#include "goma.h"
+
+/* LAPACK */
+extern FSUB_TYPE dsyev_(char *, char *, int *, double *, int *, double *,
+			double *, int *, int *, int, int);
+extern FSUB_TYPE dgetrf_(int *, int *, double *, int *, int [], int *);
+extern FSUB_TYPE dgetrs_(char *, int *, int *, double *, int *, int [],
+			 double [], int *, int *, unsigned int);
+
+#define ROM_MAGIC 0x524f4d31	/* "ROM1", first int of a basis file */
+
+/* collect */
+static int Num_Snapshots = 0;
+static dbl **Snapshots = NULL;		/* [snapshot][NumUnknowns] */
+
+/* solve */
+static int Rom_Ready = FALSE;
+static int Num_Modes = 0;
+static dbl *Rom_Mean = NULL;		/* [numProcUnknowns] */
+static dbl **Rom_Basis = NULL;		/* [mode][numProcUnknowns] */
+static int Num_Sample_Rows = 0;
+static int *Sample_Rows = NULL;		/* owned rows with complete residuals */
+static int *Sample_Elems = NULL;	/* [num_elems] TRUE if filled */
+
+static void
+rom_sum(dbl *v,
+	const int n)
+
+     /* replace v[n] by its sum over the processors */
+{
+#ifdef PARALLEL
+  dbl *w;
+  int i;
+
+  if (Num_Proc == 1 || n == 0) return;
+  w = alloc_dbl_1(n, 0.0);
+  MPI_Allreduce(v, w, n, MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+  for (i = 0; i < n; i++) v[i] = w[i];
+  free(w);
+#endif
+}
+
+/*
+ * Solve the dense n x n system a y = b in place, a column-major.
+ * Returns the LAPACK info, 0 if it worked.
+ */
+
+static int
+rom_dense_solve(dbl *a,
+		dbl *b,
+		int n)
+{
+  int *ipiv, info = 0, one = 1;
+  char trans = 'N';
+
+  if (n == 0) return (0);
+  ipiv = alloc_int_1(n, 0);
+  dgetrf_(&n, &n, a, &n, ipiv, &info);
+  if (info == 0) dgetrs_(&trans, &n, &one, a, &n, ipiv, b, &n, &info, 1);
+  free(ipiv);
+  return (info);
+}
+
+void
+rom_snapshot(double x[])
+
+     /*****************************************************************
+      * rom_snapshot()
+      *
+      *        keep the owned part of x, being written as a results
+      *        step, for the basis.
+      *****************************************************************/
+{
+  static int warned = FALSE;
+
+  if (Reduced_Order_Model != ROM_COLLECT) return;
+  if (Num_Snapshots >= ROM_Max_Snapshots) {
+    if (!warned) WH(-1, "ROM Snapshots reached, later solutions are not kept");
+    warned = TRUE;
+    return;
+  }
+
+  Snapshots = (dbl **) realloc(Snapshots, (Num_Snapshots + 1) * sizeof(dbl *));
+  if (Snapshots == NULL) EH(-1, "Out of memory for ROM snapshots");
+  Snapshots[Num_Snapshots] = alloc_dbl_1(MAX(NumUnknowns, 1), 0.0);
+  dcopy1(NumUnknowns, x, Snapshots[Num_Snapshots]);
+  Num_Snapshots++;
+}
+
+static void
+rom_write_basis(void)
+
+     /*
+      * The POD basis of the snapshots, by the eigenvectors of their
+      * correlation matrix, written to ROM_Basis_File.
+      */
+{
+  int n = NumUnknowns, m = Num_Snapshots;
+  int i, j, l, r, k, info = 0, lwork;
+  dbl *mean, *c, *w, *work, *phi, total = 0., held = 0.;
+  int head[3];
+  char jobz = 'V', uplo = 'U';
+  FILE *fp;
+
+  mean = alloc_dbl_1(MAX(n, 1), 0.0);
+  for (i = 0; i < m; i++) {
+    for (r = 0; r < n; r++) mean[r] += Snapshots[i][r] / m;
+  }
+  for (i = 0; i < m; i++) {
+    for (r = 0; r < n; r++) Snapshots[i][r] -= mean[r];
+  }
+
+  c = alloc_dbl_1(m * m, 0.0);
+  for (i = 0; i < m; i++) {
+    for (j = 0; j <= i; j++) {
+      for (r = 0; r < n; r++) c[i * m + j] += Snapshots[i][r] * Snapshots[j][r];
+      c[j * m + i] = c[i * m + j];
+    }
+  }
+  rom_sum(c, m * m);
+
+  w = alloc_dbl_1(m, 0.0);
+  lwork = MAX(3 * m, 1);
+  work = alloc_dbl_1(lwork, 0.0);
+  dsyev_(&jobz, &uplo, &m, c, &m, w, work, &lwork, &info, 1, 1);
+  free(work);
+  if (info != 0) EH(-1, "dsyev failed on the ROM snapshot correlations");
+
+  /* eigenvalues ascend: the modes are taken from the top */
+  for (j = 0; j < m; j++) total += MAX(w[j], 0.);
+  k = 0;
+  for (j = m - 1; j >= 0 && k < ROM_Max_Modes; j--) {
+    if (w[j] <= 1.e-14 * w[m - 1] || w[j] <= 0.) break;
+    if (k > 0 && held >= ROM_Energy * total) break;
+    held += w[j];
+    k++;
+  }
+
+  fp = fopen(ROM_Basis_File, "wb");
+  if (fp == NULL) EH(-1, "Cannot open the ROM Basis File for writing");
+  head[0] = ROM_MAGIC;
+  head[1] = n;
+  head[2] = k;
+  if (fwrite(head, sizeof(int), 3, fp) != 3 ||
+      fwrite(mean, sizeof(dbl), n, fp) != (size_t) n) {
+    EH(-1, "Error writing the ROM Basis File");
+  }
+  phi = alloc_dbl_1(MAX(n, 1), 0.0);
+  for (l = 0; l < k; l++) {
+    j = m - 1 - l;
+    init_vec_value(phi, 0.0, n);
+    for (i = 0; i < m; i++) {
+      for (r = 0; r < n; r++) phi[r] += Snapshots[i][r] * c[j * m + i];
+    }
+    for (r = 0; r < n; r++) phi[r] /= sqrt(w[j]);
+    if (fwrite(phi, sizeof(dbl), n, fp) != (size_t) n) {
+      EH(-1, "Error writing the ROM Basis File");
+    }
+  }
+  fclose(fp);
+
+  if (k == 0) {
+    WH(-1, "The ROM snapshots do not differ, the basis has no modes");
+  }
+  DPRINTF(stdout, "\nROM basis: %d snapshots, %d modes, holding %.6g of the energy\n",
+	  m, k, (total > 0.) ? held / total : 1.);
+
+  free(phi);
+  free(w);
+  free(c);
+  free(mean);
+}
+
+/*
+ * Sample rows of the basis by DEIM, then the nodes and the elements
+ * around them. Rows are owned rows, so the residuals of the elements
+ * filled on this processor complete them.
+ */
+
+static void
+rom_sample(Exo_DB *exo,
+	   Dpi *dpi)
+{
+  int n = NumUnknowns, k = Num_Modes;
+  int i, j, l, r, best, e, node, slot, owner;
+  int num_owned_nodes = dpi->num_internal_nodes + dpi->num_boundary_nodes;
+  int num_sampled, extra, stride;
+  int *row_picked, *node_sampled;
+  dbl *res, *p, *a, *b, v, vmax;
+
+  row_picked = alloc_int_1(MAX(n, 1), FALSE);
+  node_sampled = alloc_int_1(MAX(exo->num_nodes, 1), FALSE);
+  res = alloc_dbl_1(MAX(n, 1), 0.0);
+  p = alloc_dbl_1(MAX(k * k, 1), 0.0);	/* [pick][mode] basis at the picks */
+  a = alloc_dbl_1(MAX(k * k, 1), 0.0);
+  b = alloc_dbl_1(MAX(k, 1), 0.0);
+
+  for (j = 0; j < k; j++) {
+    /* residual of interpolating mode j from the rows picked so far */
+    for (i = 0; i < j; i++) {
+      for (l = 0; l < j; l++) a[l * j + i] = p[i * k + l];
+      b[i] = p[i * k + j];
+    }
+    if (rom_dense_solve(a, b, j) != 0) {
+      WH(-1, "DEIM: singular interpolation, fewer sample rows than modes");
+      break;
+    }
+    for (r = 0; r < n; r++) {
+      res[r] = Rom_Basis[j][r];
+      for (l = 0; l < j; l++) res[r] -= b[l] * Rom_Basis[l][r];
+    }
+
+    best = -1;
+    vmax = 0.;
+    for (r = 0; r < n; r++) {
+      if (!row_picked[r] && fabs(res[r]) > vmax) {
+	vmax = fabs(res[r]);
+	best = r;
+      }
+    }
+    gstatus_begin();
+    slot = gstatus_add_maxloc(vmax);
+    gstatus_start();
+    v = gstatus_get(slot);
+    owner = (int) gstatus_get(slot + 1);
+    if (v <= 0.) break;
+
+    for (l = 0; l < k; l++) {
+      p[j * k + l] = (ProcID == owner) ? Rom_Basis[l][best] : 0.;
+    }
+    rom_sum(p + j * k, k);
+    if (ProcID == owner) {
+      row_picked[best] = TRUE;
+      node_sampled[idv[best][2]] = TRUE;
+    }
+  }
+
+  /* more nodes, evenly through the owned ones, for ROM Sample Nodes */
+  num_sampled = 0;
+  for (node = 0; node < num_owned_nodes; node++) num_sampled += node_sampled[node];
+  i = num_sampled;
+  num_sampled = gsum_Int(num_sampled);
+  j = gsum_Int(num_owned_nodes);
+  if (ROM_Sample_Nodes > num_sampled && j > 0) {
+    extra = (int) ((dbl) (ROM_Sample_Nodes - num_sampled) * num_owned_nodes / j + 0.5);
+    extra = MIN(extra, num_owned_nodes - i);
+    if (extra > 0) {
+      stride = MAX(num_owned_nodes / extra, 1);
+      for (node = 0; node < num_owned_nodes && extra > 0; node += stride) {
+	if (!node_sampled[node]) {
+	  node_sampled[node] = TRUE;
+	  extra--;
+	}
+      }
+    }
+  }
+
+  Num_Sample_Rows = 0;
+  for (r = 0; r < n; r++) {
+    if (node_sampled[idv[r][2]]) Num_Sample_Rows++;
+  }
+  Sample_Rows = alloc_int_1(MAX(Num_Sample_Rows, 1), 0);
+  Num_Sample_Rows = 0;
+  for (r = 0; r < n; r++) {
+    if (node_sampled[idv[r][2]]) Sample_Rows[Num_Sample_Rows++] = r;
+  }
+
+  /* the first and last elements do the once-per-fill work of matrix_fill() */
+  Sample_Elems = alloc_int_1(MAX(exo->num_elems, 1), FALSE);
+  for (node = 0; node < num_owned_nodes; node++) {
+    if (!node_sampled[node]) continue;
+    for (i = exo->node_elem_pntr[node]; i < exo->node_elem_pntr[node + 1]; i++) {
+      Sample_Elems[exo->node_elem_list[i]] = TRUE;
+    }
+  }
+  if (exo->num_elems > 0) {
+    Sample_Elems[0] = TRUE;
+    Sample_Elems[exo->num_elems - 1] = TRUE;
+  }
+  e = l = 0;
+  for (i = 0; i < exo->num_elems; i++) {
+    if (dpi->elem_owner[i] != ProcID) continue;
+    e += Sample_Elems[i];
+    l++;
+  }
+
+  num_sampled = 0;
+  for (node = 0; node < num_owned_nodes; node++) num_sampled += node_sampled[node];
+  DPRINTF(stdout, "ROM: %d modes, %d sample nodes, %d of %d elements filled\n",
+	  k, gsum_Int(num_sampled), gsum_Int(e), gsum_Int(l));
+
+  free(b);
+  free(a);
+  free(p);
+  free(res);
+  free(node_sampled);
+  free(row_picked);
+}
+
+static void
+rom_read_basis(Exo_DB *exo,
+	       Dpi *dpi,
+	       Comm_Ex *cx)
+{
+  int n = NumUnknowns, np = NumUnknowns + NumExtUnknowns;
+  int l, head[3];
+  FILE *fp;
+
+  fp = fopen(ROM_Basis_File, "rb");
+  if (fp == NULL) EH(-1, "Cannot open the ROM Basis File");
+  if (fread(head, sizeof(int), 3, fp) != 3 || head[0] != ROM_MAGIC) {
+    EH(-1, "The ROM Basis File is not a basis written by Reduced Order Model = collect");
+  }
+  if (head[1] != n) {
+    EH(-1, "The ROM Basis File is for another mesh, decomposition or set of equations");
+  }
+  Num_Modes = head[2];
+
+  Rom_Mean = alloc_dbl_1(MAX(np, 1), 0.0);
+  if (fread(Rom_Mean, sizeof(dbl), n, fp) != (size_t) n) {
+    EH(-1, "Error reading the ROM Basis File");
+  }
+  exchange_dof(cx, dpi, Rom_Mean);
+  Rom_Basis = (dbl **) smalloc(MAX(Num_Modes, 1) * sizeof(dbl *));
+  for (l = 0; l < Num_Modes; l++) {
+    Rom_Basis[l] = alloc_dbl_1(MAX(np, 1), 0.0);
+    if (fread(Rom_Basis[l], sizeof(dbl), n, fp) != (size_t) n) {
+      EH(-1, "Error reading the ROM Basis File");
+    }
+    exchange_dof(cx, dpi, Rom_Basis[l]);
+  }
+  fclose(fp);
+
+  rom_sample(exo, dpi);
+  Rom_Ready = TRUE;
+}
+
+/*
+ * x = x_mean + Phi q on all the unknowns of this processor; a transient
+ * xdot follows the change of x as in the Newton update.
+ */
+
+static void
+rom_expand(double x[],
+	   double xdot[],
+	   const dbl *q,
+	   const dbl xdot_fac)
+{
+  int np = NumUnknowns + NumExtUnknowns;
+  int r, l;
+  dbl v;
+
+  for (r = 0; r < np; r++) {
+    v = Rom_Mean[r];
+    for (l = 0; l < Num_Modes; l++) v += Rom_Basis[l][r] * q[l];
+    if (xdot_fac != 0.) xdot[r] += (v - x[r]) * xdot_fac;
+    x[r] = v;
+  }
+}
+
+int
+rom_solve(struct Aztec_Linear_Solver_System *ams,
+	  double x[],
+	  double delta_t,
+	  double theta,
+	  double x_old[],
+	  double x_older[],
+	  double xdot[],
+	  double xdot_old[],
+	  double resid_vector[],
+	  double x_update[],
+	  int *converged,
+	  double time_value,
+	  Exo_DB *exo,
+	  Dpi *dpi,
+	  Comm_Ex *cx)
+
+     /*****************************************************************
+      * rom_solve()
+      *
+      *        the reduced Newton (Gauss-Newton) iteration for the
+      *        nonlinear problem, from the projection of x. Returns the
+      *        number of iterations, or -1 if a fill failed.
+      *****************************************************************/
+{
+  double *a = ams->val;
+  int *ija = ams->bindx;
+  int n = NumUnknowns, k;
+  int inewton, i, s, r, l, m, p, err, len;
+  int num_total_nodes = dpi->num_universe_nodes;
+  dbl *q, *jp, *buf, *g, *h, xdot_fac = 0., h_elem_avg = 0., U_norm = 0.;
+  dbl rnorm, dqnorm, qnorm;
+
+  *converged = FALSE;
+  if (!Rom_Ready) rom_read_basis(exo, dpi, cx);
+  k = Num_Modes;
+  if (pd->TimeIntegration != STEADY) xdot_fac = (1.0 + 2 * theta) / delta_t;
+
+  /* start from the projection of x */
+  q = alloc_dbl_1(MAX(k, 1), 0.0);
+  for (l = 0; l < k; l++) {
+    for (r = 0; r < n; r++) q[l] += Rom_Basis[l][r] * (x[r] - Rom_Mean[r]);
+  }
+  rom_sum(q, k);
+  rom_expand(x, xdot, q, xdot_fac);
+
+  len = k * k + k + 1;
+  buf = alloc_dbl_1(len, 0.0);
+  jp = alloc_dbl_1(MAX(k, 1), 0.0);
+  h = buf;			/* [k*k] (J_s Phi)^T (J_s Phi) */
+  g = buf + k * k;		/* [k] (J_s Phi)^T R_s, then R_s^T R_s */
+
+  DPRINTF(stdout, "\n    ROM   |R_s|      |dq|/(1+|q|)\n");
+  for (inewton = 0; inewton < Max_Newton_Steps; inewton++) {
+    af->Assemble_Residual = TRUE;
+    af->Assemble_Jacobian = TRUE;
+    af->Assemble_LSA_Jacobian_Matrix = FALSE;
+    af->Assemble_LSA_Mass_Matrix = FALSE;
+
+    if ((PSPG && Num_Var_In_Type[PRESSURE]) || (Cont_GLS && Num_Var_In_Type[VELOCITY1])) {
+      h_elem_avg = global_h_elem_siz(x, x_old, xdot, resid_vector, exo, dpi);
+      U_norm = global_velocity_norm(x, exo, dpi);
+    }
+
+    init_vec_value(resid_vector, 0.0, NumUnknowns + NumExtUnknowns);
+    init_vec_value(a, 0.0, ams->nnz);
+    fill_element_subset(Sample_Elems);
+    err = matrix_fill_full(ams, x, resid_vector, x_old, x_older, xdot, xdot_old, x_update,
+			   &delta_t, &theta, First_Elem_Side_BC_Array, &time_value,
+			   exo, dpi, &num_total_nodes, &h_elem_avg, &U_norm, NULL);
+    fill_element_subset(NULL);
+    if (err == -1) {
+      inewton = -1;
+      break;
+    }
+
+    /* normal equations of the sample rows */
+    init_vec_value(buf, 0.0, len);
+    for (s = 0; s < Num_Sample_Rows; s++) {
+      r = Sample_Rows[s];
+      for (l = 0; l < k; l++) {
+	jp[l] = a[r] * Rom_Basis[l][r];
+	for (p = ija[r]; p < ija[r + 1]; p++) jp[l] += a[p] * Rom_Basis[l][ija[p]];
+      }
+      for (l = 0; l < k; l++) {
+	for (m = 0; m < k; m++) h[m * k + l] += jp[l] * jp[m];
+	g[l] += jp[l] * resid_vector[r];
+      }
+      g[k] += resid_vector[r] * resid_vector[r];
+    }
+    rom_sum(buf, len);
+    rnorm = sqrt(g[k]);
+
+    if (rom_dense_solve(h, g, k) != 0) {
+      WH(-1, "ROM: singular reduced Jacobian");
+      break;
+    }
+    dqnorm = qnorm = 0.;
+    for (l = 0; l < k; l++) {
+      q[l] -= g[l];
+      dqnorm += g[l] * g[l];
+      qnorm += q[l] * q[l];
+    }
+    dqnorm = sqrt(dqnorm) / (1. + sqrt(qnorm));
+    rom_expand(x, xdot, q, xdot_fac);
+
+    DPRINTF(stdout, "    [%2d]  %9.3e  %9.3e\n", inewton, rnorm, dqnorm);
+    if (dqnorm < Epsilon[0]) {
+      *converged = TRUE;
+      inewton++;
+      break;
+    }
+  }
+
+  for (i = 0; i < n; i++) x_update[i] = 0.;
+  free(jp);
+  free(buf);
+  free(q);
+
+  if (!*converged && inewton >= 0) {
+    DPRINTF(stdout, "    ROM iteration did not converge\n");
+  }
+  return (inewton);
+}
+
+void
+rom_finish(void)
+
+     /*****************************************************************
+      * rom_finish()
+      *
+      *        write the basis of the snapshots collected, and free
+      *        everything.
+      *****************************************************************/
+{
+  int i;
+
+  if (Reduced_Order_Model == ROM_COLLECT && Num_Snapshots > 0) {
+    rom_write_basis();
+  }
+
+  for (i = 0; i < Num_Snapshots; i++) free(Snapshots[i]);
+  free(Snapshots);
+  Snapshots = NULL;
+  Num_Snapshots = 0;
+
+  for (i = 0; Rom_Basis != NULL && i < Num_Modes; i++) free(Rom_Basis[i]);
+  free(Rom_Basis);
+  free(Rom_Mean);
+  free(Sample_Rows);
+  free(Sample_Elems);
+  Rom_Basis = NULL;
+  Rom_Mean = NULL;
+  Sample_Rows = NULL;
+  Sample_Elems = NULL;
+  Num_Modes = Num_Sample_Rows = 0;
+  Rom_Ready = FALSE;
+}
+/*****************************************************************************/
+/*  END of file rf_rom.c  */
+/*****************************************************************************/
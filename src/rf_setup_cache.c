@@ -0,0 +1,270 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * Setup products kept on disk from one launch to the next (Setup Cache
+ * card).
+ *
+ * The MSR graph of the matrix is the slowest part of the setup that does
+ * not depend on anything but the mesh and the unknowns laid out on it,
+ * so a run on the same mesh with the same equations - the next run of a
+ * restart chain, or of a parameter study - can take it from the file the
+ * previous one wrote instead of building the node -> node connectivity
+ * and the graph again. Each processor keeps its own file,
+ * <prefix>.<Num_Proc>.<ProcID>: a header, then the graph as it lies in
+ * memory.
+ *
+ * The header carries a hash of everything the graph is built from - the
+ * element -> node and element -> element connectivity with the element
+ * types, the variable types and first unknown of every node, periodic
+ * links, Inter_Mask and the interpolations and DG Jacobian models of the
+ * materials - so a file written for another mesh, decomposition or deck
+ * is simply not used (and replaced). The hash is made from the data in
+ * memory rather than from the mesh file and the deck, so it also tells
+ * apart two decks that differ only in an equation or an interpolation.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+
+#include "std.h"
+#include "rf_fem_const.h"
+#include "rf_fem.h"
+#include "rf_io_const.h"
+#include "rf_io.h"
+#include "rf_mp.h"
+#include "rf_allo.h"
+#include "el_geom.h"
+#include "mm_as_const.h"
+#include "mm_as_structs.h"
+#include "mm_as.h"
+#include "mm_mp_const.h"
+#include "mm_mp_structs.h"
+#include "mm_mp.h"
+#include "mm_eh.h"
+
+#define _RF_SETUP_CACHE_C
+#include "goma.h"
+
+#define SETUP_CACHE_MAGIC   "GOMASUC"
+#define SETUP_CACHE_VERSION 1
+
+struct setup_cache_header {
+  char magic[8];
+  int version;
+  int one;			/* 1, to catch a byte order change */
+  int num_proc;
+  int proc;
+  int num_rows;
+  int len;
+  uint64_t key;
+};
+
+char Setup_Cache[MAX_FNL] = "";
+
+/*****************************************************************************/
+
+/*
+ * 64 bit FNV-1a over n ints, continuing from h.
+ */
+
+static uint64_t
+setup_cache_hash(uint64_t h,
+		 const int *v,
+		 const int n)
+{
+  int i;
+  const unsigned char *p = (const unsigned char *) v;
+
+  if (v == NULL) return h;
+  for (i = 0; i < n * (int) sizeof(int); i++) {
+    h ^= (uint64_t) p[i];
+    h *= 1099511628211ULL;
+  }
+  return h;
+}
+
+static uint64_t
+setup_cache_key(Exo_DB *exo,
+		const int num_nodes,
+		const int skip_diag,
+		int *num_rows)
+{
+  uint64_t h = 14695981039346656037ULL;
+  int inode, ebi, mn, n, head[6];
+  int *vt, *matID;
+  const int *links = NULL;
+
+  head[0] = num_nodes;
+  head[1] = exo->num_elems;
+  head[2] = exo->num_elem_blocks;
+  head[3] = skip_diag;
+  head[4] = (Debug_Flag < 0);
+  head[5] = upd->Num_Mat;
+  h = setup_cache_hash(h, head, 6);
+
+  h = setup_cache_hash(h, exo->eb_ptr, exo->num_elem_blocks + 1);
+  h = setup_cache_hash(h, exo->eb_elem_itype, exo->num_elem_blocks);
+  h = setup_cache_hash(h, Matilda, exo->num_elem_blocks);
+  h = setup_cache_hash(h, exo->elem_node_pntr, exo->num_elems + 1);
+  h = setup_cache_hash(h, exo->elem_node_list,
+		       exo->elem_node_pntr[exo->num_elems]);
+  if (exo->elem_elem_conn_exists) {
+    h = setup_cache_hash(h, exo->elem_elem_pntr, exo->num_elems + 1);
+    h = setup_cache_hash(h, exo->elem_elem_list,
+			 exo->elem_elem_pntr[exo->num_elems]);
+  }
+
+  vt = alloc_int_1(MAX(MaxVarPerNode, 1), INT_NOINIT);
+  matID = alloc_int_1(MAX(MaxVarPerNode, 1), INT_NOINIT);
+  *num_rows = 0;
+  for (inode = 0; inode < num_nodes; inode++) {
+    n = fill_variable_vector(inode, vt, matID);
+    *num_rows += n;
+    h = setup_cache_hash(h, &Nodes[inode]->First_Unknown, 1);
+    h = setup_cache_hash(h, &n, 1);
+    h = setup_cache_hash(h, vt, n);
+    n = periodic_graph_links(inode, &links);
+    h = setup_cache_hash(h, &n, 1);
+    h = setup_cache_hash(h, links, n);
+  }
+  safer_free((void **) &vt);
+  safer_free((void **) &matID);
+
+  h = setup_cache_hash(h, &Inter_Mask[0][0],
+		       MAX_VARIABLE_TYPES * MAX_VARIABLE_TYPES);
+  for (mn = 0; mn < upd->Num_Mat; mn++) {
+    h = setup_cache_hash(h, pd_glob[mn]->i, MAX_VARIABLE_TYPES);
+    h = setup_cache_hash(h, &vn_glob[mn]->dg_J_model, 1);
+  }
+  for (ebi = 0; ebi < exo->num_elem_blocks; ebi++) {
+    h = setup_cache_hash(h, &exo->eb_id[ebi], 1);
+  }
+
+  return h;
+}
+
+static void
+setup_cache_name(char *fname)
+{
+  sprintf(fname, "%s.%d.%d", Setup_Cache, Num_Proc, ProcID);
+}
+
+/*****************************************************************************/
+
+int *
+setup_cache_read_graph(Exo_DB *exo,
+		       const int num_nodes,
+		       const int skip_diag,
+		       int *len)
+
+    /*************************************************************************
+     *
+     * setup_cache_read_graph():
+     *
+     *  The graph problem_graph_build() would return, from this processor's
+     *  Setup Cache file, if there is one written for this very problem.
+     *
+     *  Return: g, *len of them, from alloc_int_1(); NULL if there is no
+     *          Setup Cache or its file does not fit
+     *************************************************************************/
+{
+  struct setup_cache_header h;
+  char fname[MAX_FNL + 32];
+  int num_rows, *g = NULL;
+  uint64_t key;
+  FILE *fp;
+  dbl start = ut();
+  static char yo[] = "setup_cache_read_graph";
+
+  if (Setup_Cache[0] == '\0' || !exo->elem_node_conn_exists) return NULL;
+
+  setup_cache_name(fname);
+  if ((fp = fopen(fname, "rb")) == NULL) return NULL;
+
+  key = setup_cache_key(exo, num_nodes, skip_diag, &num_rows);
+  if (fread(&h, sizeof(h), 1, fp) == 1 &&
+      strcmp(h.magic, SETUP_CACHE_MAGIC) == 0 &&
+      h.version == SETUP_CACHE_VERSION && h.one == 1 &&
+      h.num_proc == Num_Proc && h.proc == ProcID && h.key == key &&
+      h.num_rows == num_rows && h.len > num_rows) {
+    g = alloc_int_1(h.len, INT_NOINIT);
+    if (fread(g, sizeof(int), h.len, fp) != (size_t) h.len ||
+	g[0] != num_rows + 1 || g[num_rows] != h.len) {
+      safer_free((void **) &g);
+    }
+  }
+  fclose(fp);
+
+  if (g == NULL) {
+    log_msg("Setup Cache %s does not fit this problem, rebuilding", fname);
+    return NULL;
+  }
+  *len = h.len;
+  log_msg("Matrix graph read from Setup Cache %s in %g s", fname, ut() - start);
+  return g;
+}
+
+/*****************************************************************************/
+
+void
+setup_cache_write_graph(Exo_DB *exo,
+			const int num_nodes,
+			const int skip_diag,
+			const int *g,
+			const int len)
+
+    /*************************************************************************
+     *
+     * setup_cache_write_graph():
+     *
+     *  Keep the graph just built in this processor's Setup Cache file, for
+     *  the next launch. It is written to <file>.tmp and renamed when
+     *  complete; a file that cannot be written only costs a warning.
+     *************************************************************************/
+{
+  struct setup_cache_header h;
+  char fname[MAX_FNL + 32], tmp[MAX_FNL + 40];
+  int ok;
+  FILE *fp;
+
+  if (Setup_Cache[0] == '\0' || g == NULL || !exo->elem_node_conn_exists) return;
+
+  memset(&h, 0, sizeof(h));
+  strcpy(h.magic, SETUP_CACHE_MAGIC);
+  h.version  = SETUP_CACHE_VERSION;
+  h.one      = 1;
+  h.num_proc = Num_Proc;
+  h.proc     = ProcID;
+  h.key      = setup_cache_key(exo, num_nodes, skip_diag, &h.num_rows);
+  h.len      = len;
+
+  setup_cache_name(fname);
+  sprintf(tmp, "%s.tmp", fname);
+  if ((fp = fopen(tmp, "wb")) == NULL) {
+    WH(-1, "Could not open the Setup Cache file, nothing kept");
+    return;
+  }
+  ok = (fwrite(&h, sizeof(h), 1, fp) == 1 &&
+	fwrite(g, sizeof(int), len, fp) == (size_t) len);
+  ok &= (fclose(fp) == 0);
+  if (ok) ok = (rename(tmp, fname) == 0);
+  if (!ok) {
+    remove(tmp);
+    WH(-1, "Error writing the Setup Cache file, nothing kept");
+  }
+}
+/*****************************************************************************/
+/* END of file rf_setup_cache.c */
+/*****************************************************************************/
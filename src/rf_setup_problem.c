@@ -58,6 +58,7 @@
 #include "mm_fill_shell.h"
 #include "mm_shell_util.h"
 #include "mm_fill_ptrs.h"
+#include "mm_qp_storage.h"
 
 #include "dp_utils.h"
 
@@ -163,6 +164,11 @@ int setup_problem(Exo_DB *exo,	/* ptr to the finite element mesh database */
    */
   setup_external_nodal_matrls(exo, dpi, cx);
 
+  /*
+   * The material lists are complete; pack them into one block
+   */
+  compact_node_mat_lists(exo->num_nodes);
+
   /*
    * Exchange my idea of what degrees of freedom I have with my
    * surrounding processors. Make sure we are all in sync.
@@ -315,6 +321,8 @@ int setup_problem(Exo_DB *exo,	/* ptr to the finite element mesh database */
   lec->R = (dbl*)smalloc(MAX_LOCAL_VAR_DESC*lec->max_dof*sizeof(dbl));
   lec->J = (dbl*)smalloc(MAX_LOCAL_VAR_DESC*MAX_LOCAL_VAR_DESC*lec->max_dof*lec->max_dof*sizeof(dbl));
   lec->J_stress_neighbor = (dbl*)smalloc(4*lec->max_dof*MAX_LOCAL_VAR_DESC*lec->max_dof*sizeof(dbl));
+  lec->dirichlet_row = alloc_int_1(MAX_LOCAL_VAR_DESC*lec->max_dof, 0);
+  lec->num_dirichlet_rows = 0;
 pd=pd_glob[0];
   return 0;
 }
@@ -329,8 +337,10 @@ free_problem(Exo_DB *exo,     /* ptr to the finite element mesh database */
       */
 {
   /*
-   * Free up the First_Elem_Side_BC_Array array 
+   * Free up the quadrature point storage on the element sides, then
+   * the First_Elem_Side_BC_Array array
    */
+  global_qp_storage_destroy();
   free_Surf_BC(First_Elem_Side_BC_Array, exo, dpi);			      
   free_Edge_BC(First_Elem_Edge_BC_Array, exo, dpi);
   return 0;
@@ -73,6 +73,15 @@ struct elem_edge_bc_struct **First_Elem_Edge_BC_Array;
 
 #define ROUND_TO_ONE 0.9999999
 
+/*
+ * Between the solves of a library session (goma_lib.c) the solution,
+ * the matrix graph and the solver objects are kept, as on the non-final
+ * calls of LIBRARY_MODE.
+ */
+static int Keep_Solve_State = FALSE;
+static double *Kept_x = NULL;
+static double *Kept_xdot = NULL;
+
 
 /*
  * Declarations of static functions defined in this file.
@@ -117,10 +126,89 @@ PROTO(( int,
 		double *,
 		int ));
 
-// direct call to a fortran LAPACK eigenvalue routine
-extern FSUB_TYPE dsyev_(char *JOBZ, char *UPLO, int *N, double *A, int *LDA,
-			double *W, double *WORK, int *LWORK, int *INFO,
-			int len_jobz, int len_uplo);
+static int multirate_rows
+PROTO(( const Exo_DB *,		/* exo */
+	const int ,		/* numProcUnknowns */
+	int *,			/* fast - TRUE for subcycled rows (out) */
+	int * ));		/* slow - TRUE for the others (out) */
+
+static int assemble_only
+PROTO(( struct Aztec_Linear_Solver_System *,
+	double [],		/* x */
+	double [],		/* resid_vector */
+	double [],		/* x_old */
+	double [],		/* x_older */
+	double [],		/* xdot */
+	double [],		/* xdot_old */
+	double [],		/* x_update */
+	double ,		/* delta_t */
+	double ,		/* theta */
+	double ,		/* time_value */
+	Exo_DB *,
+	Dpi *,
+	int ));			/* jacobian - TRUE to fill ams too */
+
+static int explicit_residual
+PROTO(( struct Aztec_Linear_Solver_System *,
+	double [],		/* x */
+	double [],		/* xdot */
+	double [],		/* resid_vector */
+	double [],		/* x_update */
+	double [],		/* scratch */
+	double [],		/* zero */
+	int ,			/* unit_accel */
+	int ,			/* jacobian */
+	double ,		/* delta_t */
+	double ,		/* time_value */
+	Exo_DB *,
+	Dpi * ));
+
+static double explicit_setup
+PROTO(( struct Aztec_Linear_Solver_System *,
+	double [],		/* x */
+	double [],		/* xdot */
+	double [],		/* resid_vector */
+	double [],		/* x_update */
+	double [],		/* mass (out) */
+	double [],		/* diag (out) */
+	double [],		/* scratch */
+	double [],		/* zero */
+	double ,		/* delta_t */
+	double ,		/* time_value */
+	Exo_DB *,
+	Dpi *,
+	Comm_Ex * ));
+
+static int explicit_step
+PROTO(( struct Aztec_Linear_Solver_System *,
+	double [],		/* x */
+	double [],		/* x_old */
+	double [],		/* xdot */
+	double [],		/* xdot_old */
+	double [],		/* resid_vector */
+	double [],		/* x_update */
+	double [],		/* mass */
+	double [],		/* diag */
+	double [],		/* scratch */
+	double [],		/* zero */
+	double ,		/* delta_t */
+	double ,		/* time_value */
+	Exo_DB *,
+	Dpi *,
+	Comm_Ex * ));
+
+static double ptc_residual_norm
+PROTO(( struct Aztec_Linear_Solver_System *,
+	double [],		/* x */
+	double [],		/* resid_vector */
+	double [],		/* x_old */
+	double [],		/* x_older */
+	double [],		/* xdot */
+	double [],		/* xdot_old */
+	double [],		/* x_update */
+	double ,		/* time_value */
+	Exo_DB *,
+	Dpi * ));
 
 // C = A X B
 void slow_square_dgemm(int transpose_b, int N, double A[N][N], double B[N][N], double C[N][N]) {
@@ -157,14 +245,10 @@ initial_guess_stress_to_log_conf(double *x, int num_total_nodes)
   double s[VIM][VIM];
   double log_s[VIM][VIM];
   int s_idx[2][2];
-  int N = VIM;
-  int LDA = N;
   int node,v,i,j;
 
-  int INFO;
-  int LWORK = 20;
-  double WORK[LWORK];
-  double A[VIM*VIM];
+  double A[DIM][DIM];
+  double R[DIM][DIM];
   dbl gamma_dot[DIM][DIM];
   VISCOSITY_DEPENDENCE_STRUCT d_mu_struct;
   VISCOSITY_DEPENDENCE_STRUCT *d_mup = &d_mu_struct;
@@ -183,8 +267,7 @@ initial_guess_stress_to_log_conf(double *x, int num_total_nodes)
     ve[mode]  = ve_glob[mn][mode];
   
     for (node = 0; node < num_total_nodes; node++) {
-      memset(WORK, 0, sizeof(double)*LWORK);
-      memset(A, 0.0, sizeof(double)*VIM*VIM);
+      memset(A, 0.0, sizeof(double)*DIM*DIM);
 
       for (a=0; a < 2; a++) {
         for (b=0; b < 2; b++) {
@@ -224,24 +307,22 @@ initial_guess_stress_to_log_conf(double *x, int num_total_nodes)
         }
       }
     
-      // convert to column major
       for (i = 0; i < VIM; i++) {
         for (j = 0; j < VIM; j++) {
-	  A[i*VIM + j] = s[j][i];
+	  A[i][j] = s[i][j];
         }
       }
 
-      double W[VIM];
+      double W[DIM];
 
       // eig solver
-      dsyev_("V", "U", &N, A, &LDA, W, WORK, &LWORK, &INFO, 1, 1);
+      compute_sym_eigen(A, W, R);
 
       double U[VIM][VIM];
 
-      // transpose (revert to row major)
       for (i = 0; i < VIM; i++) {
         for (j = 0; j < VIM; j++) {
-	  U[i][j] = A[j*VIM + i];
+	  U[i][j] = R[i][j];
         }
       }
 
@@ -319,12 +400,25 @@ solve_problem(Exo_DB *exo,	 /* ptr to the finite element mesh database  */
    * Variables
    */
   double *x_pred = NULL;                /* prediction of solution vector     */
+  int    mr_num = 1;                    /* Multirate Subcycles substeps      */
+  int    *mr_fast = NULL;               /* rows of the subcycled unknowns    */
+  int    *mr_slow = NULL;               /* rows of the others                */
+  double *mr_x_new = NULL;              /* slow unknowns at the step's end   */
+  double *mr_x_sub = NULL;              /* solution at the substep's start   */
+  double *mr_xdot_sub = NULL;           /* its time derivative               */
+  int    ex_on = FALSE;                 /* Explicit Dynamics                 */
+  double ex_dt = 0.0;                   /* its step, a fraction of the stable */
+  double *ex_mass = NULL;               /* lumped mass, 0 on constraint rows */
+  double *ex_diag = NULL;               /* Jacobian diagonal of those        */
+  double *ex_scratch = NULL;
+  double *ex_zero = NULL;
   static double *x_old = NULL;          /* old solution vector               */
   static double *x_older = NULL;        /* older solution vector             */
   static double *x_oldest = NULL;       /* oldest solution vector saved      */
   static double *xdot = NULL;           /* current time derivative of soln   */
   static double *xdot_old = NULL;       /* old time derivative of soln       */
   static double *xdot_older = NULL;     /* old time derivative of soln       */
+  double *xs_exch[3];                   /* vectors exchanged together        */
 
   double *x_sens = NULL;	 /* solution sensitivity                     */
   double **x_sens_p = NULL;	 /* solution sensitivity for parameters      */
@@ -355,6 +449,7 @@ solve_problem(Exo_DB *exo,	 /* ptr to the finite element mesh database  */
   
   double delta_t_exp = 0.0;
   int    n_exp = 0;
+  int    num_subcycle = 0;		/* fill subcycle steps of this time step */
 
 #endif /* COUPLED_FILL */
   
@@ -380,6 +475,10 @@ solve_problem(Exo_DB *exo,	 /* ptr to the finite element mesh database  */
   int	 converged = TRUE;       /* success or failure of Newton iteration   */
   int	 success_dt = TRUE;      /* success or failure of time step          */
   int    failed_recently_countdown = 0;
+  int    bdf_on = FALSE;         /* variable order BDF instead of theta      */
+  int    ckpt_on = FALSE;        /* accepted steps kept for rollback         */
+  int    ckpt_rollbacks = 0;     /* rollbacks done so far                    */
+  double ckpt_file_time = 0.;   /* wall time of the last checkpoint file    */
   int    i, num_total_nodes;
   int    numProcUnknowns;
   int    const_delta_t, const_delta_ts, step_print;
@@ -478,6 +577,8 @@ solve_problem(Exo_DB *exo,	 /* ptr to the finite element mesh database  */
 
   p_gsize = &gsize;
 
+  if (Keep_Solve_State) last_call = FALSE;
+
 #ifdef LIBRARY_MODE
   fprintf(stderr, "  Commencing call #%3d from ANIMAS to solve_problem\n",
           callnum);
@@ -545,6 +646,10 @@ solve_problem(Exo_DB *exo,	 /* ptr to the finite element mesh database  */
       err = create_overlap_acs(exo, nAC-1);
       EH(err, "Problem with create_overlap_acs!");
     }
+  if (Periodic_Native)
+    {
+      (void) periodic_links_setup(exo, dpi);
+    }
   if (nAC > 0 && augc[0].Type == AC_PERIODIC)
     {
       err = create_periodic_acs(exo);
@@ -609,6 +714,7 @@ solve_problem(Exo_DB *exo,	 /* ptr to the finite element mesh database  */
     DPRINTF(stderr, "%s:  problem with load_nodal_tkn()\n", yo);
     EH(-1,"\t");
   }
+  (void) running_stats_register(rd, exo);
 
   /*
    * Post-processing vars are stored in the static local array xp_id,
@@ -733,15 +839,15 @@ solve_problem(Exo_DB *exo,	 /* ptr to the finite element mesh database  */
   /* Allocate solution arrays on first call only */
   if (callnum == 1)
     {
-      x          = alloc_dbl_1(numProcUnknowns, 0.0);
-      x_old      = alloc_dbl_1(numProcUnknowns, 0.0);
-      x_older    = alloc_dbl_1(numProcUnknowns, 0.0);
-      x_oldest   = alloc_dbl_1(numProcUnknowns, 0.0);
-      xdot       = alloc_dbl_1(numProcUnknowns, 0.0);
-      xdot_old   = alloc_dbl_1(numProcUnknowns, 0.0);
-      xdot_older = alloc_dbl_1(numProcUnknowns, 0.0);
+      x          = alloc_dbl_1_ft(numProcUnknowns, 0.0);
+      x_old      = alloc_dbl_1_ft(numProcUnknowns, 0.0);
+      x_older    = alloc_dbl_1_ft(numProcUnknowns, 0.0);
+      x_oldest   = alloc_dbl_1_ft(numProcUnknowns, 0.0);
+      xdot       = alloc_dbl_1_ft(numProcUnknowns, 0.0);
+      xdot_old   = alloc_dbl_1_ft(numProcUnknowns, 0.0);
+      xdot_older = alloc_dbl_1_ft(numProcUnknowns, 0.0);
     }
-  x_update = alloc_dbl_1(numProcUnknowns + numProcUnknowns, 0.0);
+  x_update = alloc_dbl_1_ft(numProcUnknowns + numProcUnknowns, 0.0);
 
   /* Initialize solid inertia flag */
   set_solid_inertia();
@@ -959,6 +1065,7 @@ solve_problem(Exo_DB *exo,	 /* ptr to the finite element mesh database  */
       
     log_msg("sl_init()...");
     sl_init(matrix_systems_mask, ams, exo, dpi, cx);
+    trim_exo(exo);
     if( nAC > 0  || 
 	nn_post_fluxes_sens > 0 ||
 	nn_post_data_sens > 0 ) ams[JAC]->options[AZ_keep_info] = 1;
@@ -1031,6 +1138,96 @@ solve_problem(Exo_DB *exo,	 /* ptr to the finite element mesh database  */
         good_mesh = element_quality(exo, x, ams[0]->proc_config);
       }
 
+    /*
+     * Pseudo Transient: backward Euler steps in pseudo time bring x near
+     * the steady solution first. Each step's size is the last one's times
+     * the drop of the steady residual over it (switched evolution
+     * relaxation); a step that fails is retried at half the size. Once
+     * the step reaches its maximum, or the residual the first Newton
+     * tolerance, the steady Newton iteration below takes over.
+     */
+    if (tran->ptc_delta_t0 > 0.0) {
+      int ptc_step, ptc_mn, ptc_eq, ptc_converged = FALSE, ptc_fails = 0;
+      int ptc_e[MAX_NUMBER_MATLS][MAX_EQNS];
+      double ptc_etm[MAX_NUMBER_MATLS][MAX_EQNS];
+      double ptc_dt = tran->ptc_delta_t0, ptc_r, ptc_r_old;
+
+      ptc_r_old = ptc_residual_norm(ams[JAC], x, resid_vector, x_old, x_older,
+				    xdot, xdot_old, x_update, time1, exo, dpi);
+      DPRINTF(stdout, "\nPseudo transient:    0  |R| = %10.3e\n", ptc_r_old);
+
+      /* every equation gets a unit mass term, as for the LSA mass matrix */
+      for (ptc_mn = 0; ptc_mn < upd->Num_Mat; ptc_mn++) {
+	for (ptc_eq = 0; ptc_eq < MAX_EQNS; ptc_eq++) {
+	  ptc_e[ptc_mn][ptc_eq] = pd_glob[ptc_mn]->e[ptc_eq];
+	  ptc_etm[ptc_mn][ptc_eq] = pd_glob[ptc_mn]->etm[ptc_eq][LOG2_MASS];
+	}
+      }
+
+      for (ptc_step = 1; ptc_step <= tran->ptc_max_steps && ptc_r_old > Epsilon[0] &&
+	     ptc_dt < tran->ptc_delta_t_max; ptc_step++) {
+	dcopy1(numProcUnknowns, x, x_old);
+	dcopy1(numProcUnknowns, x, x_older);
+	init_vec_value(xdot, 0.0, numProcUnknowns);
+	init_vec_value(xdot_old, 0.0, numProcUnknowns);
+
+	TimeIntegration = TRANSIENT;
+	tran->delta_t = ptc_dt;
+	for (ptc_mn = 0; ptc_mn < upd->Num_Mat; ptc_mn++) {
+	  pd_glob[ptc_mn]->TimeIntegration = TRANSIENT;
+	  for (ptc_eq = 0; ptc_eq < MAX_EQNS; ptc_eq++) {
+	    if (pd_glob[ptc_mn]->e[ptc_eq]) {
+	      pd_glob[ptc_mn]->e[ptc_eq] |= T_MASS;
+	      pd_glob[ptc_mn]->etm[ptc_eq][LOG2_MASS] = 1.0;
+	    }
+	  }
+	}
+	err = solve_nonlinear_problem(ams[JAC], x, ptc_dt, 0.0,
+				      x_old, x_older, xdot, xdot_old,
+				      resid_vector, x_update, scale,
+				      &ptc_converged, &nprint, tev, tev_post, gv,
+				      rd, gindex, p_gsize, gvec, gvec_elem,
+				      time1, exo, dpi, cx, 0,
+				      &time_step_reform, FALSE,
+				      x_AC, x_AC_dot, time1, resid_vector_sens,
+				      x_sens, x_sens_p, NULL);
+	TimeIntegration = STEADY;
+	tran->delta_t = 0.0;
+	for (ptc_mn = 0; ptc_mn < upd->Num_Mat; ptc_mn++) {
+	  pd_glob[ptc_mn]->TimeIntegration = STEADY;
+	  for (ptc_eq = 0; ptc_eq < MAX_EQNS; ptc_eq++) {
+	    pd_glob[ptc_mn]->e[ptc_eq] = ptc_e[ptc_mn][ptc_eq];
+	    pd_glob[ptc_mn]->etm[ptc_eq][LOG2_MASS] = ptc_etm[ptc_mn][ptc_eq];
+	  }
+	}
+
+	ptc_r = -1.;
+	if (err != -1 && ptc_converged) {
+	  ptc_r = ptc_residual_norm(ams[JAC], x, resid_vector, x_old, x_older,
+				    xdot, xdot_old, x_update, time1, exo, dpi);
+	}
+	if (ptc_r < 0.) {
+	  dcopy1(numProcUnknowns, x_old, x);
+	  ptc_dt *= 0.5;
+	  DPRINTF(stdout, "Pseudo transient: step %d failed, dt cut to %10.3e\n",
+		  ptc_step, ptc_dt);
+	  if (++ptc_fails > 10) break;
+	  continue;
+	}
+
+	DPRINTF(stdout, "Pseudo transient: %4d  dt = %10.3e  |R| = %10.3e\n",
+		ptc_step, ptc_dt, ptc_r);
+	ptc_dt *= ptc_r_old / MAX(ptc_r, DBL_SMALL);
+	ptc_dt = MIN(ptc_dt, tran->ptc_delta_t_max);
+	ptc_r_old = ptc_r;
+      }
+
+      dcopy1(numProcUnknowns, x, x_old);
+      dcopy1(numProcUnknowns, x, x_older);
+      init_vec_value(xdot, 0.0, numProcUnknowns);
+      init_vec_value(xdot_old, 0.0, numProcUnknowns);
+    }
+
     err = solve_nonlinear_problem(ams[JAC], x, delta_t, theta,
 				  x_old, x_older, xdot, xdot_old,
 				  resid_vector, x_update, scale,  
@@ -1252,18 +1449,7 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
  	  }	/*search  */
 	}	/*  nn_volume	*/
 #endif
-	for (i = 0; i < nn_volume; i++ ) {
-	  evaluate_volume_integral(exo, dpi,
-				   pp_volume[i]->volume_type,
-				   pp_volume[i]->volume_name,
-				   pp_volume[i]->blk_id,
-				   pp_volume[i]->species_no,
-				   pp_volume[i]->volume_fname,
-				   pp_volume[i]->params,
-				   pp_volume[i]->num_params,
-				   NULL,  x, xdot, delta_t,
-				   time1, 1);
-	}
+	evaluate_volume_integrals(exo, dpi, x, xdot, delta_t, time1, 1);
 
     }	/* if converged */
     
@@ -1380,7 +1566,7 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
      *  Allocate space for prediction vector to be saved here,
      *  since it is only used locally 
      */
-    x_pred = alloc_dbl_1(numProcUnknowns, 0.0);
+    x_pred = alloc_dbl_1_ft(numProcUnknowns, 0.0);
     x_pred_static = x_pred;
 
     /*
@@ -1521,7 +1707,10 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
      * appropriate, but the other items are there now, too.
      * Do this only once if in library mode.
      */
-    if (callnum == 1) sl_init(matrix_systems_mask, ams, exo, dpi, cx);	
+    if (callnum == 1) {
+      sl_init(matrix_systems_mask, ams, exo, dpi, cx);
+      trim_exo(exo);
+    }
       
     /*
      * make sure the Aztec was properly initialized
@@ -1575,12 +1764,170 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
         good_mesh = element_quality(exo, x, ams[0]->proc_config);
       }
 
+    /*
+     * Variable order BDF.  The models below carry time discretizations
+     * of their own, written for the theta method.
+     */
+    if (tran->bdf_max_order > 0)
+      {
+	int bdf_max_order = tran->bdf_max_order;
+
+	if (nAC > 0 || tran->solid_inertia || upd->XFEM
+#ifndef COUPLED_FILL
+	    || Explicit_Fill
+#endif
+	    )
+	  {
+	    WH(-1, "BDF Maximum Order ignored with augmenting conditions, solid inertia, XFEM or explicit fill; using the Time step parameter");
+	    bdf_max_order = 0;
+	  }
+	else if (upd->Max_Num_Porous_Eqn > 0 && bdf_max_order > 1)
+	  {
+	    WH(-1, "BDF Maximum Order limited to 1 for porous media");
+	    bdf_max_order = 1;
+	  }
+	bdf_init(numProcUnknowns, bdf_max_order);
+	bdf_on = bdf_active();
+      }
+
+    /*
+     * Checkpoint ring and checkpoint files: everything carried from one
+     * accepted step to the next.  Particles are not part of it.
+     */
+    if (tran->ckpt_depth > 0 || Checkpoint_File[0] != '\0' ||
+	Checkpoint_Restart_File[0] != '\0')
+      {
+	if (Particle_Dynamics)
+	  {
+	    WH(-1, "Checkpoint Ring and Checkpoint Files ignored with particle dynamics");
+	  }
+	else
+	  {
+	    int eb;
+	    size_t nbytes = numProcUnknowns * sizeof(double);
+
+	    ckpt_init(tran->ckpt_depth);
+	    ckpt_register_nodal(x_old, nbytes);
+	    ckpt_register_nodal(x_older, nbytes);
+	    ckpt_register_nodal(x_oldest, nbytes);
+	    ckpt_register_nodal(xdot_old, nbytes);
+	    ckpt_register_nodal(xdot_older, nbytes);
+	    if (tran->solid_inertia)
+	      ckpt_register_nodal(tran->xdbl_dot_old, nbytes);
+	    if (nAC > 0)
+	      {
+		nbytes = nAC * sizeof(double);
+		ckpt_register(x_AC_old, nbytes);
+		ckpt_register(x_AC_older, nbytes);
+		ckpt_register(x_AC_oldest, nbytes);
+		ckpt_register(x_AC_dot_old, nbytes);
+		ckpt_register(x_AC_dot_older, nbytes);
+	      }
+	    for (eb = 0; eb < exo->num_elem_blocks; eb++)
+	      ckpt_register_elem(eb);
+	    if (ls != NULL)
+	      ckpt_register(&ls->Renorm_Countdown, sizeof(int));
+	    ckpt_register(&time, sizeof(double));
+	    ckpt_register(&time_print, sizeof(double));
+	    ckpt_register(&delta_t, sizeof(double));
+	    ckpt_register(&delta_t_old, sizeof(double));
+	    ckpt_register(&delta_t_older, sizeof(double));
+	    ckpt_register(&delta_t_oldest, sizeof(double));
+	    ckpt_register(&nt, sizeof(int));
+	    if (Checkpoint_Restart_File[0] != '\0')
+	      {
+		ckpt_read_file(Checkpoint_Restart_File);
+		tran->delta_t  = delta_t;
+		tran->delta_t_old = delta_t_old;
+		tran->delta_t_avg = 0.25*(delta_t+delta_t_old+delta_t_older
+					  +delta_t_oldest);
+		tran->time_value_old = time;
+		dcopy1(numProcUnknowns, x_old, x);
+		if (nAC > 0) dcopy1(nAC, x_AC_old, x_AC);
+		last_renorm_nt = nt;
+		DPRINTF(stdout, "\tcontinuing from t=%g [%d], dt=%g\n",
+			time, nt, delta_t);
+	      }
+	    ckpt_save();
+	    ckpt_on = TRUE;
+	    ckpt_file_time = wall_time();
+	  }
+      }
+
+    /*
+     * Multirate Subcycles: each step first advances the slow unknowns
+     * with the fast ones held at their prediction, then the fast ones in
+     * substeps with the slow ones interpolated over the step. Both are
+     * row holds in the fills, so the theta method and msr only.
+     */
+    mr_num = tran->multirate_subcycles;
+    if (mr_num > 1)
+      {
+	if (Linear_Solver == FRONT || strcmp(Matrix_Format, "msr") != 0 ||
+	    bdf_on || nAC > 0 || tran->solid_inertia || xfem != NULL)
+	  {
+	    WH(-1, "Multirate Subcycles ignored: needs msr and the theta method, without ACs, solid inertia or XFEM");
+	    mr_num = 1;
+	  }
+	else
+	  {
+	    mr_fast = alloc_int_1(numProcUnknowns, FALSE);
+	    mr_slow = alloc_int_1(numProcUnknowns, FALSE);
+	    if (multirate_rows(exo, numProcUnknowns, mr_fast, mr_slow) == 0)
+	      {
+		WH(-1, "Multirate Subcycles ignored: no unknowns live only in the blocks named");
+		mr_num = 1;
+	      }
+	    mr_x_new = alloc_dbl_1(numProcUnknowns, 0.0);
+	    mr_x_sub = alloc_dbl_1(numProcUnknowns, 0.0);
+	    mr_xdot_sub = alloc_dbl_1(numProcUnknowns, 0.0);
+	  }
+      }
+
+    /*
+     * Explicit Dynamics: central difference steps of the dynamic
+     * Lagrangian mesh displacements, with the row-sum lumped mass and no
+     * linear solves, at the given fraction of the stable step.
+     */
+    if (tran->explicit_cfl > 0.0)
+      {
+	ex_on = (tran->solid_inertia && Linear_Solver != FRONT &&
+		 strcmp(Matrix_Format, "msr") == 0 && nAC == 0 &&
+		 !bdf_on && mr_num == 1 && xfem == NULL);
+	for (i = 0; i < NumUnknowns && ex_on; i++)
+	  {
+	    if (idv[i][0] < MESH_DISPLACEMENT1 || idv[i][0] > MESH_DISPLACEMENT3)
+	      ex_on = FALSE;
+	  }
+	ex_on = gmin_int(ex_on);
+	if (!ex_on)
+	  {
+	    WH(-1, "Explicit Dynamics ignored: needs msr and only dynamic Lagrangian displacements, without ACs or multirate");
+	  }
+	else
+	  {
+	    ex_mass = alloc_dbl_1(numProcUnknowns, 0.0);
+	    ex_diag = alloc_dbl_1(numProcUnknowns, 0.0);
+	    ex_scratch = alloc_dbl_1(numProcUnknowns, 0.0);
+	    ex_zero = alloc_dbl_1(numProcUnknowns, 0.0);
+	    ex_dt = explicit_setup(ams[JAC], x, xdot, resid_vector, x_update,
+				   ex_mass, ex_diag, ex_scratch, ex_zero,
+				   delta_t, time, exo, dpi, cx);
+	    if (ex_dt <= 0.0) EH(-1, "Explicit Dynamics: the fills for the lumped mass failed");
+	    delta_t = MIN(delta_t, ex_dt);
+	    tran->delta_t = delta_t;
+	  }
+      }
+
     /*******************************************************************
      *  TOP OF THE TIME STEP LOOP -> Loop over time steps whether
      *                               they be successful or not
      *******************************************************************/
     for (n = 0; n < max_time_steps; n++)
       {
+      timer_report_step(n);
+      perf_log_begin_step(n);
+
       /*
        * Calculate the absolute time for the current step, time1
        */
@@ -1646,6 +1993,23 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
 	      }
 	    }
 	}
+
+	/*
+	 * Follow transient external displacements with the annealed
+	 * mesh (they are the first external fields, see
+	 * anneal_mesh_with_external_field()).
+	 */
+	if (efv->ev_porous_decouple)
+	  {
+	    for (w=0; w<exo->num_dim && w<efv->Num_external_field; w++)
+	      {
+		if (strcmp(efv->field_type[w], "transient") == 0) break;
+	      }
+	    if (w < exo->num_dim && w < efv->Num_external_field)
+	      {
+		anneal_mesh_with_external_field(exo);
+	      }
+	  }
       }
 
 
@@ -1678,6 +2042,15 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
 	 *  }
 	 */
 	}
+
+      /*
+       * BDF: the order and step set the coefficients, and theta with them.
+       */
+      if (bdf_on)
+	{
+	  if ( (nt - last_renorm_nt) == 0) bdf_restart(time, x_old);
+	  theta = bdf_prepare(delta_t);
+	}
 	  
       /* Reset the node->DBC[] arrays to -1 where set
        * so that the boundary conditions are set correctly
@@ -1696,6 +2069,12 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
               xfem->ielem = -1;
               xfem->tot_vol = alloc_dbl_1(numProcUnknowns, 0.0);
               xfem->active_vol =  alloc_dbl_1(numProcUnknowns, 0.0);
+              xfem->num_rows = 0;
+              xfem->rows = alloc_int_1(numProcUnknowns, 0);
+              xfem->row_bits = alloc_int_1(numProcUnknowns/32 + 1, 0);
+              xfem->elem_cross = alloc_int_1(exo->num_elems, 0);
+              xfem->node_cross = alloc_int_1(exo->num_nodes, 0);
+              xfem->num_xnodes = -1;
               if (ls == NULL)
                 {
                   EH(-1,"Currently, XFEM requires traditional level set (not pf)");
@@ -1741,6 +2120,9 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
             case LS_EVOLVE_SEMILAGRANGIAN:
               DPRINTF(stdout, "\n\t Using semi-Lagrangian Level Set Evolution\n");
               break;
+            case LS_EVOLVE_ADVECT_LUMPED:
+              DPRINTF(stdout, "\n\t Using lumped explicit subcycling for FILL equation.\n");
+              break;
             default:
               EH(-1,"Level Set Evolution scheme not found \n");
           }
@@ -1880,6 +2262,7 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
 
 	  case HUYGENS :
 	  case HUYGENS_C :
+	  case FAST_MARCH :
             Renorm_Now =  ( ls->Force_Initial_Renorm || (ls->Renorm_Freq != 0 && ls->Renorm_Countdown == 0) );
 
 	    did_renorm = huygens_renormalization(x, num_total_nodes, exo, cx, dpi,  
@@ -1921,6 +2304,7 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
 	    break;	
 	  default:
 	      if ( ls->Evolution == LS_EVOLVE_ADVECT_EXPLICIT ||
+                   ls->Evolution == LS_EVOLVE_ADVECT_LUMPED ||
                    ls->Evolution == LS_EVOLVE_ADVECT_COUPLED )
                  WH(-1,"No level set renormalization is on.\n");
 	  } /* end of switch(ls->Renorm_Method ) */
@@ -1988,9 +2372,10 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
 	    dcopy1(numProcUnknowns, x, x_older);
 	    dcopy1(numProcUnknowns, x, x_oldest);
 
-	    exchange_dof(cx, dpi, x);
-	    exchange_dof(cx, dpi, x_old);
-	    exchange_dof(cx, dpi, x_oldest);
+	    xs_exch[0] = x;
+	    xs_exch[1] = x_old;
+	    xs_exch[2] = x_oldest;
+	    exchange_dof_multi(cx, dpi, 3, xs_exch);
 	  }
 
 	}
@@ -2084,9 +2469,10 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
 	  dcopy1(numProcUnknowns, x, x_old);
 	  dcopy1(numProcUnknowns, x, x_older);
 	  dcopy1(numProcUnknowns, x, x_oldest);
-	  exchange_dof(cx, dpi, x);
-	  exchange_dof(cx, dpi, x_old);
-	  exchange_dof(cx, dpi, x_oldest);
+	  xs_exch[0] = x;
+	  xs_exch[1] = x_old;
+	  xs_exch[2] = x_oldest;
+	  exchange_dof_multi(cx, dpi, 3, xs_exch);
 
 	} /* end of phase function initialization */
 
@@ -2129,9 +2515,22 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
 	
 
 	/*
-	 * Calculate the delta_t that will be used in the subcycle
+	 * Calculate the delta_t that will be used in the subcycle. The
+	 * lumped explicit update takes more substeps if the Courant
+	 * number asks for them.
 	 */
-	delta_t_exp =  delta_t/ (double) exp_subcycle ;
+	num_subcycle = exp_subcycle;
+	if ( ls != NULL && ls->Evolution == LS_EVOLVE_ADVECT_LUMPED )
+	  {
+	    double dt_courant = ls->Lumped_Courant *
+	      explicit_fill_time_step(x_old, x_older, xdot_old, xdot_older,
+				      resid_vector, exo);
+	    if ( dt_courant > 0. && delta_t > num_subcycle * dt_courant )
+	      {
+		num_subcycle = (int) ceil(delta_t / dt_courant);
+	      }
+	  }
+	delta_t_exp =  delta_t/ (double) num_subcycle ;
 
 
 
@@ -2171,7 +2570,7 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
 
 
 
-	for (n_exp = 0; n_exp < exp_subcycle; n_exp++) {
+	for (n_exp = 0; n_exp < num_subcycle; n_exp++) {
 	  /*
 	   * always use BE for level set integration 
 	   */
@@ -2202,6 +2601,13 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
 
 	      log_msg("fill subcycle step %d, time = %g", n_exp, time2);
 	    }
+	  else if ( ls->Evolution == LS_EVOLVE_ADVECT_LUMPED )
+	    {
+	      err = integrate_explicit_lumped(ams[FIL], rf, xf, xf_old, xfdot,
+					      tmp_x, tmp_x_old, tmp_xdot,
+					      delta_t_exp, node_to_fill,
+					      exo, dpi, cx);
+	    }
 	  else if ( ls->Evolution == LS_EVOLVE_SEMILAGRANGIAN )
 	    {
 	      DPRINTF(stderr,"\n\tsemi_lagrange time step: %d  time = %e\n", 
@@ -2244,7 +2650,9 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
 #endif /* not COUPLED_FILL */
 
       if (ProcID == 0) {
-	if (theta == 0.0)
+	if (bdf_on)
+	    sprintf(tspstring, "(BDF%d)", bdf_order());
+	else if (theta == 0.0)
 	    strcpy(tspstring, "(BE)");
 	else if (theta == 0.5)
 	    strcpy(tspstring, "(CN)");
@@ -2265,11 +2673,16 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
        * And its derivatives at the old time, time.
        */
 
-      predict_solution(numProcUnknowns, delta_t, delta_t_old,
-		       delta_t_older,  theta, x, x_old, x_older, 
-		       x_oldest, xdot, xdot_old, xdot_older);
+      if (ex_on)
+	{
+	  /* explicit_step() does its own */
+	}
+      else if (!bdf_on || !bdf_predict(numProcUnknowns, x, xdot))
+	predict_solution(numProcUnknowns, delta_t, delta_t_old,
+			 delta_t_older,  theta, x, x_old, x_older, 
+			 x_oldest, xdot, xdot_old, xdot_older);
       
-      if(tran->solid_inertia)
+      if(tran->solid_inertia && !ex_on)
 	{
 	  predict_solution_newmark(num_total_nodes, delta_t, x, x_old, xdot, xdot_old);
 	  exchange_dof(cx, dpi, tran->xdbl_dot);
@@ -2322,8 +2735,9 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
        * time, x[], exchange the degrees of freedom to update the
        * ghost node information.
        */
-      exchange_dof(cx, dpi, x);
-      exchange_dof(cx, dpi, xdot);
+      xs_exch[0] = x;
+      xs_exch[1] = xdot;
+      exchange_dof_multi(cx, dpi, 2, xs_exch);
         
 #ifdef DEBUG
       if (nt == 0) {
@@ -2380,8 +2794,9 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
        *            be exchanged as well.
        */
 
-      exchange_dof(cx, dpi, x);
-      exchange_dof(cx, dpi, xdot);
+      xs_exch[0] = x;
+      xs_exch[1] = xdot;
+      exchange_dof_multi(cx, dpi, 2, xs_exch);
       if(tran->solid_inertia)  exchange_dof(cx, dpi, tran->xdbl_dot);
 
       /*
@@ -2416,6 +2831,15 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
        *  set the flag, converged, to true on return. If not
        *  set the flag to false.
        */
+      if (mr_num > 1) fill_frozen_rows(mr_fast);
+      if (ex_on)
+	{
+	  err = explicit_step(ams[JAC], x, x_old, xdot, xdot_old, resid_vector,
+			      x_update, ex_mass, ex_diag, ex_scratch, ex_zero,
+			      delta_t, time1, exo, dpi, cx);
+	  converged = (err != -1);
+	}
+      else
       err = solve_nonlinear_problem(ams[JAC], x, delta_t, theta, x_old, 
 				    x_older, xdot, xdot_old, resid_vector,  
 				    x_update, scale, &converged, &nprint,
@@ -2426,6 +2850,72 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
 				    x_sens, x_sens_p, NULL);
       if (err == -1) converged = FALSE;
       inewton = err;
+
+      /*
+       * Multirate Subcycles: the fast unknowns catch up from time to
+       * time1 in mr_num substeps. The slow ones are held on the straight
+       * line from x_old to the x just found, with its slope as xdot; each
+       * substep starts the fast ones from a forward Euler prediction.
+       */
+      if (mr_num > 1 && converged)
+	{
+	  double dt_sub = delta_t / (double) mr_num, t_sub, w;
+	  int k;
+
+	  DPRINTF(stderr, "\n\tmultirate: %d substeps of dt=%g\n", mr_num, dt_sub);
+	  dcopy1(numProcUnknowns, x, mr_x_new);
+	  dcopy1(numProcUnknowns, x_old, mr_x_sub);
+	  dcopy1(numProcUnknowns, xdot_old, mr_xdot_sub);
+	  fill_frozen_rows(mr_slow);
+	  for (k = 1; k <= mr_num && converged; k++)
+	    {
+	      t_sub = time + dt_sub * k;
+	      w = (double) k / (double) mr_num;
+	      for (i = 0; i < numProcUnknowns; i++)
+		{
+		  if (mr_fast[i])
+		    {
+		      x[i] = mr_x_sub[i] + dt_sub * mr_xdot_sub[i];
+		      xdot[i] = mr_xdot_sub[i];
+		    }
+		  else
+		    {
+		      xdot[i] = mr_xdot_sub[i] = (mr_x_new[i] - x_old[i]) / delta_t;
+		      mr_x_sub[i] = x_old[i] + (w - 1.0/mr_num) * (mr_x_new[i] - x_old[i]);
+		      x[i] = x_old[i] + w * (mr_x_new[i] - x_old[i]);
+		    }
+		}
+	      tran->delta_t = dt_sub;
+	      tran->time_value_old = t_sub - dt_sub;
+	      tran->time_value = t_sub;
+	      err = solve_nonlinear_problem(ams[JAC], x, dt_sub, theta, mr_x_sub,
+					    x_old, xdot, mr_xdot_sub, resid_vector,
+					    x_update, scale, &converged, &nprint,
+					    tev, tev_post, gv, rd, gindex, p_gsize,
+					    gvec, gvec_elem, t_sub, exo, dpi, cx,
+					    n, &time_step_reform, is_steady_state,
+					    x_AC, x_AC_dot, t_sub, resid_vector_sens,
+					    x_sens, x_sens_p, NULL);
+	      if (err == -1) converged = FALSE;
+	      xs_exch[0] = x;
+	      xs_exch[1] = xdot;
+	      exchange_dof_multi(cx, dpi, 2, xs_exch);
+	      dcopy1(numProcUnknowns, x, mr_x_sub);
+	      dcopy1(numProcUnknowns, xdot, mr_xdot_sub);
+	    }
+	  tran->delta_t = delta_t;
+	  tran->time_value_old = time;
+	  tran->time_value = time1;
+
+	  /* The slow time derivatives the step itself found */
+	  for (i = 0; i < numProcUnknowns; i++)
+	    {
+	      if (mr_fast[i]) continue;
+	      xdot[i] = (1.0 + 2.0 * theta) / delta_t * (x[i] - x_old[i]) -
+		(2.0 * theta) * xdot_old[i];
+	    }
+	}
+      if (mr_num > 1) fill_frozen_rows(NULL);
       evpl_glob[0]->update_flag = 0; /*See get_evp_stress_tensor for description */
       af->Sat_hyst_reevaluate = FALSE; /*See load_saturation for description*/
 
@@ -2441,8 +2931,9 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
        *        then xdot needs to be exchanged as well.
        */
 
-      exchange_dof(cx, dpi, x);
-      exchange_dof(cx, dpi, xdot);
+      xs_exch[0] = x;
+      xs_exch[1] = xdot;
+      exchange_dof_multi(cx, dpi, 2, xs_exch);
 
       if (converged) af->Sat_hyst_reevaluate = TRUE;  /*see load_saturation */
 
@@ -2455,11 +2946,17 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
        * then not accept the current time step, reduced delta_t,
        * and retry.
        */
-      if (converged) {
+      if (converged && ex_on) {
+	/* no truncation error estimate, only the stable step */
+	success_dt = TRUE;
+	delta_t_new = MIN(ex_dt, delta_t_max);
+      }
+      else if (converged) {
 	
 	delta_t_new = time_step_control(delta_t, delta_t_old, const_delta_t,
 					x, x_pred, x_old, x_AC, x_AC_pred,
-					eps, &success_dt, tran->use_var_norm);
+					eps, &success_dt, tran->use_var_norm,
+					inewton);
 	if (const_delta_t) 
           {
 	  success_dt  = TRUE;
@@ -2518,6 +3015,7 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
 	  }
 	nt  += 1;
 	time = time1;
+	running_stats_update(x, exo, delta_t);
   
 	/* Determine whether to print out the data or not */
 	i_print = 0;
@@ -2691,6 +3189,8 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
         /* Fix output if current time step matches frequency */
         if ( (step_fix != 0 && nt == step_fix) ||
              ((i_fix == 1) && (tran->fix_freq > 0)) ) {
+          /* Every piece must be complete on disk before it is fixed */
+          wr_exo_session_close();
 #ifdef PARALLEL
           /* Barrier because fix needs both files to be finished printing
              and fix always occurs on the same timestep as printing */
@@ -2791,6 +3291,7 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
 			
 			case HUYGENS:
 			case HUYGENS_C:
+			case FAST_MARCH:
 				
 				Renorm_Now = ( ls->Renorm_Freq != 0 && 
 					ls->Renorm_Countdown == 0 ) 
@@ -2839,6 +3340,7 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
 				
 		  case HUYGENS:
 		  case HUYGENS_C:
+		  case FAST_MARCH:
 					
 		    Renorm_Now = ( ls->Renorm_Freq != 0 && 
 				   ls->Renorm_Countdown == 0 );
@@ -2876,6 +3378,7 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
 	dcopy1(numProcUnknowns, x_older,  x_oldest);
 	dcopy1(numProcUnknowns, x_old,    x_older);
 	dcopy1(numProcUnknowns, x,        x_old);
+	if (bdf_on) bdf_push(time, x, x_pred);
 	delta_t_oldest = delta_t_older;
 	delta_t_older  = delta_t_old;
 	delta_t_old    = delta_t;
@@ -2894,6 +3397,21 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
 	  dcopy1(nAC, x_AC,         x_AC_old);
 	}
 
+	if (ckpt_on) ckpt_save();
+	if (ckpt_on && Checkpoint_File[0] != '\0')
+	  {
+	    /* rank 0's clock decides, so all of them write together */
+	    int write_now = (wall_time() - ckpt_file_time >= Checkpoint_Interval);
+#ifdef PARALLEL
+	    MPI_Bcast(&write_now, 1, MPI_INT, 0, MPI_COMM_WORLD);
+#endif
+	    if (write_now)
+	      {
+		ckpt_write_file(Checkpoint_File);
+		ckpt_file_time = wall_time();
+	      }
+	  }
+
 	/* Integrate fluxes, forces  
 	 */
 	for (i = 0; i < nn_post_fluxes; i++) {
@@ -3009,16 +3527,7 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
              }
           memset(Spec_source_lumped_mass, 0.0, sizeof(double)*exo->num_nodes);
 #endif
- 	  for (i = 0; i < nn_volume; i++) {
- 	    evaluate_volume_integral(exo, dpi, pp_volume[i]->volume_type,
- 				     pp_volume[i]->volume_name,
- 				     pp_volume[i]->blk_id,
- 				     pp_volume[i]->species_no,
- 				     pp_volume[i]->volume_fname,
- 				     pp_volume[i]->params,
- 				     pp_volume[i]->num_params,
- 				     NULL, x, xdot, delta_t_old, time, 1);
- 	  }
+ 	  evaluate_volume_integrals(exo, dpi, x, xdot, delta_t_old, time, 1);
 
 #ifdef REACTION_PRODUCT_EFV
         for (i = 0; i < exo->num_nodes; i++) {
@@ -3053,6 +3562,8 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
      }
 #endif
 
+	perf_log_step(time1, delta_t, TRUE, inewton);
+
         if (time1 >= (ROUND_TO_ONE * time_max))
           {
 	  DPRINTF(stderr,"\t\tout of time!\n");
@@ -3075,6 +3586,8 @@ DPRINTF(stderr,"new surface value = %g \n",pp_volume[i]->params[pd->Num_Species]
 	  
       else /* not converged or unsuccessful time step */
       {
+	perf_log_step(time1, delta_t, FALSE, inewton);
+	if (bdf_on) bdf_step_failed();
         if(relax_bit && ((n-nt) < no_relax_retry)  ) {
 	      /*success_dt = TRUE;  */
              if(inewton == -1)        {
@@ -3195,6 +3708,30 @@ fprintf(stderr,"should be not successful %d %d %d \n",inewton,converged,success_
       
       if (delta_t <= delta_t_min) {
         DPRINTF(stderr,"\n\tdelta_t = %e < %e\n\n",delta_t, delta_t_min);
+
+	/*
+	 * Go back one more accepted step and take it again from there,
+	 * more carefully.
+	 */
+	if (ckpt_on && ckpt_rollbacks < tran->ckpt_max_rollbacks &&
+	    ckpt_restore(1))
+	  {
+	    ckpt_rollbacks++;
+	    delta_t *= tran->time_step_decelerator;
+	    tran->delta_t  = delta_t;
+	    tran->delta_t_old = delta_t_old;
+	    tran->delta_t_avg = 0.25*(delta_t+delta_t_old+delta_t_older
+				      +delta_t_oldest);
+	    tran->time_value_old = time;
+	    dcopy1(numProcUnknowns, x_old, x);
+	    if (nAC > 0) dcopy1(nAC, x_AC_old, x_AC);
+	    last_renorm_nt = nt;
+	    failed_recently_countdown = tran->const_dt_after_failure;
+	    DPRINTF(stderr,"\trolled back to t=%g [%d], dt=%g (rollback %d of %d)\n",
+		    time, nt, delta_t, ckpt_rollbacks, tran->ckpt_max_rollbacks);
+	    log_msg("Rolled back to t=%g [%d], dt=%g", time, nt, delta_t);
+	    continue;
+	  }
 	
 	DPRINTF(stderr,"time step too small, I'm giving up!\n");
 	break;
@@ -3218,9 +3755,10 @@ fprintf(stderr,"should be not successful %d %d %d \n",inewton,converged,success_
   
  free_and_clear:
 
+  callnum++;
+
 /* If exporting variables to another code, save them now! */
 #ifdef LIBRARY_MODE
-  callnum++;
   *te_out = time;
   if (Num_Export_XS > 0 || Num_Export_XP > 0)
     {
@@ -3267,6 +3805,17 @@ fprintf(stderr,"should be not successful %d %d %d \n",inewton,converged,success_
   }
 
   safer_free((void **) &x_pred); 
+  safer_free((void **) &mr_fast);
+  safer_free((void **) &mr_slow);
+  safer_free((void **) &mr_x_new);
+  safer_free((void **) &mr_x_sub);
+  safer_free((void **) &mr_xdot_sub);
+  safer_free((void **) &ex_mass);
+  safer_free((void **) &ex_diag);
+  safer_free((void **) &ex_scratch);
+  safer_free((void **) &ex_zero);
+  bdf_free();
+  ckpt_free();
 
   if (last_call)
     {
@@ -3348,6 +3897,10 @@ fprintf(stderr,"should be not successful %d %d %d \n",inewton,converged,success_
       {
         free(ams[JAC]->GlobalIDs);
       }
+      if (ams[JAC]->ColumnLIDs != NULL)
+      {
+        free(ams[JAC]->ColumnLIDs);
+      }
     }
 
     sl_free(matrix_systems_mask, ams);
@@ -3384,8 +3937,14 @@ if( ls != NULL )
 }
 
 free_shape_fcn_tree( Subgrid_Tree );
+free_shape_fcn_tree_cache();
+free_subelement_cache();
+free_adaptive_weight_cache();
 
   if (file != NULL) fclose(file);
+
+  Kept_x = last_call ? NULL : x;
+  Kept_xdot = last_call ? NULL : xdot;
  
 #ifdef DEBUG
   fprintf(stderr, "%s: leaving solve_problem()\n", yo);
@@ -3394,6 +3953,30 @@ free_shape_fcn_tree( Subgrid_Tree );
   return;
 } /* END of routine solve_problem()  */
 /**************************************************************************/
+
+void
+solve_problem_keep_state(const int keep)
+
+    /*
+     * keep the state of solve_problem() after each call, so that the
+     * next one starts from its solution, matrix graph and solver
+     */
+{
+  Keep_Solve_State = keep;
+}
+
+double *
+solve_problem_solution(double **xdot)
+
+    /*
+     * the solution kept from the last call of solve_problem(), and its
+     * time derivative. NULL until a call has kept its state.
+     */
+{
+  if (xdot != NULL) *xdot = Kept_xdot;
+  return (Kept_x);
+}
+/**************************************************************************/
 /**************************************************************************/
 /**************************************************************************/
 
@@ -3866,6 +4449,11 @@ anneal_mesh_with_external_field(const Exo_DB *exo)
     /* anneal_mesh_with_external_field -- 
      *         anneal mesh before solving problem with displaced coordinates
      *
+     * The annealed coordinates are kept in Coor[], apart from the
+     * reference coordinates in exo, and updated in place when the external
+     * displacements change; only the geometry cached for elements touching
+     * nodes that moved is thrown away.
+     *
      * Created: 2004/01 Randy Schunk
      *
      */
@@ -3873,21 +4461,35 @@ anneal_mesh_with_external_field(const Exo_DB *exo)
   int dim;
   int i;
   int num_nodes;
+  int num_moved;
   int p;
+  int *moved;
 
   double displacement[DIM], X_old[DIM], X_new[DIM];
-  double **new_coord;
 
   dim       = exo->num_dim;
   num_nodes = exo->num_nodes;
-	      
-  new_coord = (double **) calloc(dim, sizeof(double *));
 
-  for(p = 0; p < dim; p++)
-  {
-    new_coord[p] = (double *) calloc(num_nodes, sizeof(double));
-    dcopy1( num_nodes, Coor[p], new_coord[p] );
-  }
+  /*
+   * Coor[] starts out as the arrays in exo, which hold the reference
+   * state every anneal starts from.
+   */
+  if (Coor[0] == exo->x_coord)
+    {
+      for (p = 0; p < dim; p++)
+	{
+	  Coor[p] = alloc_dbl_1(num_nodes, 0.0);
+	}
+      dcopy1(num_nodes, exo->x_coord, Coor[0]);
+      dcopy1(num_nodes, exo->y_coord, Coor[1]);
+      if( dim > 2 )
+	{
+	  dcopy1(num_nodes, exo->z_coord, Coor[2]);
+	}
+    }
+
+  moved = alloc_int_1(num_nodes, FALSE);
+  num_moved = 0;
 
   for (i=0; i<num_nodes; i++)
     {
@@ -3926,34 +4528,27 @@ anneal_mesh_with_external_field(const Exo_DB *exo)
 	      
       for ( p=0; p<dim; p++)
 	{
-	  new_coord[p][i] = X_new[p];
+	  if (Coor[p][i] != X_new[p])
+	    {
+	      Coor[p][i] = X_new[p];
+	      moved[i] = TRUE;
+	    }
 	}
+      num_moved += moved[i];
     }
 
-
   /* Now we need to make sure that all geometry-related calculations are 
    * performed with these updated coordinates.
    */
+  if (num_moved > 0)
+    {
+      geom_cache_invalidate(exo, moved);
+      h_elem_cache_invalidate(exo, moved);
+      find_id_elem_invalidate();
+      rotation_vectors_invalidate();
+    }
 
-  /*
-   * Temporarily save the old coordinates and assign the new
-   * displaced coordinates for the annealed file...
-   */
-  
-    Coor[0]      = &new_coord[0][0];   /*Old Deprecated holder that is stil
-					*used
-					*/
-    Coor[1]      = &new_coord[1][0];
-
-  if( dim > 2 )
-  {
-    Coor[2]      = &new_coord[2][0];
-  }
-
-  for(p = 0; p < dim; p++) {
-    safer_free((void **) &(new_coord[p]));
-  }
-  safer_free((void **) &new_coord);
+  safer_free((void **) &moved);
 
   return(0);
 } /* END of routine anneal_mesh_with_external_field */
@@ -3980,6 +4575,375 @@ shift_nodal_values ( int var,
 	return;
 }
 /*****************************************************************************/
+
+static int
+multirate_rows(const Exo_DB *exo,
+	       const int numProcUnknowns,
+	       int *fast,
+	       int *slow)
+
+     /*****************************************************************
+      * multirate_rows()
+      *
+      *        flag the rows of the unknowns Multirate Subcycles
+      *        subcycles: the variables active in the materials of the
+      *        blocks it names and in no other block's material. A
+      *        variable shared with the other blocks, such as the mesh
+      *        displacements of a shell on a solid, stays slow. Returns
+      *        the number of fast rows on all processors.
+      *****************************************************************/
+{
+  int ebi, j, v, mn, named, row, num_fast = 0;
+  int in_fast[V_LAST], in_slow[V_LAST];
+
+  memset(in_fast, 0, sizeof(in_fast));
+  memset(in_slow, 0, sizeof(in_slow));
+
+  for (ebi = 0; ebi < exo->num_elem_blocks; ebi++)
+    {
+      mn = Matilda[ebi];
+      if (mn < 0) continue;
+      named = FALSE;
+      for (j = 0; j < tran->multirate_num_blocks && !named; j++)
+	{
+	  if (tran->multirate_block_id[j] == MULTIRATE_SHELL)
+	    named = is_shell_element_type(exo->eb_elem_itype[ebi]);
+	  else
+	    named = (tran->multirate_block_id[j] == exo->eb_id[ebi]);
+	}
+      for (v = V_FIRST; v < V_LAST; v++)
+	{
+	  if (!pd_glob[mn]->v[v]) continue;
+	  if (named) in_fast[v] = TRUE;
+	  else in_slow[v] = TRUE;
+	}
+    }
+
+  /* A processor may hold elements of one side only */
+#ifdef PARALLEL
+  MPI_Allreduce(MPI_IN_PLACE, in_fast, V_LAST, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+  MPI_Allreduce(MPI_IN_PLACE, in_slow, V_LAST, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+#endif
+
+  for (row = 0; row < numProcUnknowns; row++)
+    {
+      v = idv[row][0];
+      fast[row] = (in_fast[v] && !in_slow[v]);
+      slow[row] = !fast[row];
+      if (fast[row] && row < NumUnknowns) num_fast++;
+    }
+
+  return (gsum_Int(num_fast));
+}
+/*****************************************************************************/
+
+static int
+assemble_only(struct Aztec_Linear_Solver_System *ams,
+	      double x[],
+	      double resid_vector[],
+	      double x_old[],
+	      double x_older[],
+	      double xdot[],
+	      double xdot_old[],
+	      double x_update[],
+	      double delta_t,
+	      double theta,
+	      double time_value,
+	      Exo_DB *exo,
+	      Dpi *dpi,
+	      int jacobian)
+
+     /*****************************************************************
+      * assemble_only()
+      *
+      *        One fill of the residual at x, and of the Jacobian in
+      *        ams if jacobian is TRUE, outside of any Newton
+      *        iteration. Returns -1 if the fill fails.
+      *****************************************************************/
+{
+  int err, num_total_nodes = dpi->num_universe_nodes;
+  int save_residual = af->Assemble_Residual;
+  int save_jacobian = af->Assemble_Jacobian;
+  double h_elem_avg = 0.0, U_norm = 0.0;
+
+  af->Assemble_Residual = TRUE;
+  af->Assemble_Jacobian = jacobian;
+  af->Assemble_LSA_Jacobian_Matrix = FALSE;
+  af->Assemble_LSA_Mass_Matrix = FALSE;
+
+  if ((PSPG && Num_Var_In_Type[PRESSURE]) || (Cont_GLS && Num_Var_In_Type[VELOCITY1])) {
+    h_elem_avg = global_h_elem_siz(x, x_old, xdot, resid_vector, exo, dpi);
+    U_norm = global_velocity_norm(x, exo, dpi);
+  }
+  if (Num_ROT > 0) calculate_all_rotation_vectors(exo, x);
+  else if (Use_2D_Rotation_Vectors == TRUE) calculate_2D_rotation_vectors(exo, x);
+
+  init_vec_value(resid_vector, 0.0, NumUnknowns + NumExtUnknowns);
+  if (jacobian) init_vec_value(ams->val, 0.0, ams->nnz);
+  err = matrix_fill_full(ams, x, resid_vector, x_old, x_older, xdot, xdot_old, x_update,
+			 &delta_t, &theta, First_Elem_Side_BC_Array, &time_value,
+			 exo, dpi, &num_total_nodes, &h_elem_avg, &U_norm, NULL);
+
+  af->Assemble_Residual = save_residual;
+  af->Assemble_Jacobian = save_jacobian;
+
+  return (err == -1) ? -1 : 0;
+}
+/*****************************************************************************/
+
+static double
+ptc_residual_norm(struct Aztec_Linear_Solver_System *ams,
+		  double x[],
+		  double resid_vector[],
+		  double x_old[],
+		  double x_older[],
+		  double xdot[],
+		  double xdot_old[],
+		  double x_update[],
+		  double time_value,
+		  Exo_DB *exo,
+		  Dpi *dpi)
+
+     /*****************************************************************
+      * ptc_residual_norm()
+      *
+      *        ||R(x)||_2 of the steady problem, from a residual-only
+      *        fill, for the pseudo time step growth of Pseudo
+      *        Transient. Returns -1 if the fill fails.
+      *****************************************************************/
+{
+  if (assemble_only(ams, x, resid_vector, x_old, x_older, xdot, xdot_old,
+		    x_update, 0.0, 0.0, time_value, exo, dpi, FALSE) == -1) return -1.;
+  return L2_norm(resid_vector, NumUnknowns);
+}
+/*****************************************************************************/
+
+static int
+explicit_residual(struct Aztec_Linear_Solver_System *ams,
+		  double x[],
+		  double xdot[],
+		  double resid_vector[],
+		  double x_update[],
+		  double scratch[],
+		  double zero[],
+		  int unit_accel,
+		  int jacobian,
+		  double delta_t,
+		  double time_value,
+		  Exo_DB *exo,
+		  Dpi *dpi)
+
+     /*****************************************************************
+      * explicit_residual()
+      *
+      *        The residual at x with the acceleration the fills take
+      *        from the Newmark formulas made 0 in every unknown, or 1
+      *        with unit_accel, by the old solution, velocity and
+      *        acceleration they are given. Returns -1 if the fill fails.
+      *****************************************************************/
+{
+  int i, err;
+  double shift = unit_accel ? tran->newmark_beta * delta_t * delta_t : 0.0;
+  double *xdbl_dot_old = tran->xdbl_dot_old;
+
+  for (i = 0; i < NumUnknowns + NumExtUnknowns; i++) scratch[i] = x[i] - shift;
+  tran->xdbl_dot_old = zero;
+  err = assemble_only(ams, x, resid_vector, scratch, scratch, xdot, zero,
+		      x_update, delta_t, 0.0, time_value, exo, dpi, jacobian);
+  tran->xdbl_dot_old = xdbl_dot_old;
+  return err;
+}
+/*****************************************************************************/
+
+static double
+explicit_setup(struct Aztec_Linear_Solver_System *ams,
+	       double x[],
+	       double xdot[],
+	       double resid_vector[],
+	       double x_update[],
+	       double mass[],
+	       double diag[],
+	       double scratch[],
+	       double zero[],
+	       double delta_t,
+	       double time_value,
+	       Exo_DB *exo,
+	       Dpi *dpi,
+	       Comm_Ex *cx)
+
+     /*****************************************************************
+      * explicit_setup()
+      *
+      *        The row-sum lumped mass of each unknown, as the residual
+      *        at zero acceleration less that at unit acceleration, and
+      *        the Jacobian diagonal of the rows without mass (Dirichlet
+      *        conditions), then the initial acceleration. The largest
+      *        frequency comes from a few power iterations on
+      *        M^-1 dR/dx, by differences of residuals. Returns
+      *        Explicit Dynamics' fraction of the stable step 2/omega,
+      *        or -1 if a fill fails.
+      *****************************************************************/
+{
+  int i, it, N = NumUnknowns + NumExtUnknowns;
+  double m_max = 0.0, omega2 = 0.0, eps, norm;
+  double *r0 = alloc_dbl_1(N, 0.0);
+  double *v = alloc_dbl_1(N, 0.0);
+  double *xp = alloc_dbl_1(N, 0.0);
+
+  if (explicit_residual(ams, x, xdot, resid_vector, x_update, scratch, zero,
+			FALSE, TRUE, delta_t, time_value, exo, dpi) == -1) goto fail;
+  dcopy1(N, resid_vector, r0);
+  for (i = 0; i < NumUnknowns; i++) diag[i] = ams->val[i];
+  if (explicit_residual(ams, x, xdot, resid_vector, x_update, scratch, zero,
+			TRUE, FALSE, delta_t, time_value, exo, dpi) == -1) goto fail;
+
+  for (i = 0; i < NumUnknowns; i++)
+    {
+      mass[i] = r0[i] - resid_vector[i];
+      m_max = MAX(m_max, fabs(mass[i]));
+    }
+#ifdef PARALLEL
+  MPI_Allreduce(MPI_IN_PLACE, &m_max, 1, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+#endif
+  for (i = 0; i < NumUnknowns; i++)
+    {
+      if (fabs(mass[i]) <= 1.e-12 * m_max)
+	{
+	  mass[i] = 0.0;
+	  if (diag[i] == 0.0) EH(-1, "Explicit Dynamics: a row with neither mass nor diagonal");
+	}
+      else if (mass[i] < 0.0)
+	{
+	  EH(-1, "Explicit Dynamics: a negative row-sum lumped mass, use linear or biquadratic elements");
+	}
+    }
+
+  /* the initial acceleration */
+  for (i = 0; i < NumUnknowns; i++)
+    {
+      tran->xdbl_dot_old[i] = (mass[i] > 0.0) ? r0[i] / mass[i] : 0.0;
+    }
+  exchange_dof(cx, dpi, tran->xdbl_dot_old);
+  dcopy1(N, tran->xdbl_dot_old, tran->xdbl_dot);
+
+  /* power iterations for the largest omega^2, from a jagged start */
+  for (i = 0; i < NumUnknowns; i++) v[i] = (mass[i] > 0.0) ? (double) (1 - 2 * (i % 2)) : 0.0;
+  norm = L2_norm(v, NumUnknowns);
+  eps = 1.e-7 * (1.0 + L2_norm(x, NumUnknowns));
+  for (it = 0; it < 20 && norm > 0.0; it++)
+    {
+      for (i = 0; i < NumUnknowns; i++) xp[i] = x[i] + eps * v[i] / norm;
+      exchange_dof(cx, dpi, xp);
+      if (explicit_residual(ams, xp, xdot, resid_vector, x_update, scratch, zero,
+			    FALSE, FALSE, delta_t, time_value, exo, dpi) == -1) goto fail;
+      for (i = 0; i < NumUnknowns; i++)
+	{
+	  v[i] = (mass[i] > 0.0) ? -(resid_vector[i] - r0[i]) / (eps * mass[i]) : 0.0;
+	}
+      omega2 = norm = L2_norm(v, NumUnknowns);
+    }
+
+  safer_free((void **) &r0);
+  safer_free((void **) &v);
+  safer_free((void **) &xp);
+
+  if (omega2 <= 0.0) EH(-1, "Explicit Dynamics: no stiffness found for the stable step");
+  DPRINTF(stdout, "\nExplicit Dynamics: stable step %g, using %g\n",
+	  2.0 / sqrt(omega2), tran->explicit_cfl * 2.0 / sqrt(omega2));
+  return tran->explicit_cfl * 2.0 / sqrt(omega2);
+
+ fail:
+  safer_free((void **) &r0);
+  safer_free((void **) &v);
+  safer_free((void **) &xp);
+  return -1.0;
+}
+/*****************************************************************************/
+
+static int
+explicit_step(struct Aztec_Linear_Solver_System *ams,
+	      double x[],
+	      double x_old[],
+	      double xdot[],
+	      double xdot_old[],
+	      double resid_vector[],
+	      double x_update[],
+	      double mass[],
+	      double diag[],
+	      double scratch[],
+	      double zero[],
+	      double delta_t,
+	      double time_value,
+	      Exo_DB *exo,
+	      Dpi *dpi,
+	      Comm_Ex *cx)
+
+     /*****************************************************************
+      * explicit_step()
+      *
+      *        One central difference step from x_old, xdot_old and
+      *        tran->xdbl_dot_old to x, xdot and tran->xdbl_dot at
+      *        time_value:
+      *
+      *          v(1/2) = v(0) + dt/2 a(0),  x(1) = x(0) + dt v(1/2),
+      *          a(1) = M^-1 R(x(1)),        v(1) = v(1/2) + dt/2 a(1)
+      *
+      *        The rows without mass take one Newton step on their own
+      *        diagonal, and then the mass rows are filled again if that
+      *        moved them. Returns -1 if a fill fails.
+      *****************************************************************/
+{
+  int i;
+  double *a_old = tran->xdbl_dot_old, *a = tran->xdbl_dot;
+
+  for (i = 0; i < NumUnknowns; i++)
+    {
+      if (mass[i] > 0.0)
+	{
+	  xdot[i] = xdot_old[i] + 0.5 * delta_t * a_old[i];
+	  x[i] = x_old[i] + delta_t * xdot[i];
+	}
+      else
+	{
+	  xdot[i] = xdot_old[i];
+	  x[i] = x_old[i] + delta_t * xdot_old[i];
+	}
+    }
+  exchange_dof(cx, dpi, x);
+  exchange_dof(cx, dpi, xdot);
+
+  if (explicit_residual(ams, x, xdot, resid_vector, x_update, scratch, zero,
+			FALSE, FALSE, delta_t, time_value, exo, dpi) == -1) return -1;
+
+  for (i = 0; i < NumUnknowns; i++)
+    {
+      scratch[i] = (mass[i] > 0.0) ? 0.0 : -resid_vector[i] / diag[i];
+      x[i] += scratch[i];
+    }
+  if (L2_norm(scratch, NumUnknowns) > 0.0)
+    {
+      exchange_dof(cx, dpi, x);
+      if (explicit_residual(ams, x, xdot, resid_vector, x_update, scratch, zero,
+			    FALSE, FALSE, delta_t, time_value, exo, dpi) == -1) return -1;
+    }
+
+  for (i = 0; i < NumUnknowns; i++)
+    {
+      if (mass[i] > 0.0)
+	{
+	  a[i] = resid_vector[i] / mass[i];
+	  xdot[i] += 0.5 * delta_t * a[i];
+	}
+      else
+	{
+	  a[i] = 0.0;
+	  xdot[i] = (x[i] - x_old[i]) / delta_t;
+	}
+    }
+  exchange_dof(cx, dpi, tran->xdbl_dot);
+  return 0;
+}
+/*****************************************************************************/
 /*****************************************************************************/
 /*****************************************************************************/
 /* load_export_vars -- save requested solution and post-processing vars */
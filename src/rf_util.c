@@ -67,6 +67,8 @@ static char rcsid[] =
 ----------------------------------------------------------------------
 	log2				int		
 	sort2_int_double		void		
+	time_step_error_sum	static double		time_step_control()
+	time_step_controller	static double		time_step_control()
 	time_step_control		double
         path_step_control               double
 	find_max			int		
@@ -502,12 +504,296 @@ filter_conc (const int N,	/* number of nodes */
 } /* END of routine filter_conc */
 /***************************************************************************/
 
+static double
+time_step_error_sum(const double ecp[], const int ncp[],
+		    const double ecp_AC[], const int use_var_norm[],
+		    int *num_unknowns_out)
+
+    /**********************************************************************
+     *
+     * time_step_error_sum()
+     *
+     * Sum the squared predictor-corrector differences, ecp[], of the
+     * variable types selected by use_var_norm[] into a single error norm
+     * and count, in *num_unknowns_out, the unknowns they cover.  ecp_AC[]
+     * may be NULL, in which case the AC unknowns are left out.
+     ***********************************************************************/
+{
+  int i;
+  int eqn;
+  int num_unknowns = 0;
+  double Err_norm = 0.0;
+
+  if (use_var_norm[0]) {
+    Err_norm      += ecp[MESH_DISPLACEMENT1];
+    Err_norm      += ecp[MESH_DISPLACEMENT2];
+    Err_norm      += ecp[MESH_DISPLACEMENT3];
+    Err_norm      += ecp[MAX_STRAIN];
+    Err_norm      += ecp[CUR_STRAIN];
+    num_unknowns += ncp[MESH_DISPLACEMENT1];
+    num_unknowns += ncp[MESH_DISPLACEMENT2];
+    num_unknowns += ncp[MESH_DISPLACEMENT3];
+    num_unknowns += ncp[MAX_STRAIN];
+    num_unknowns += ncp[CUR_STRAIN];
+  }
+
+  if (use_var_norm[1]) {
+    Err_norm      += ecp[VELOCITY1];
+    Err_norm      += ecp[VELOCITY2];
+    Err_norm      += ecp[VELOCITY3];
+    num_unknowns += ncp[VELOCITY1];
+    num_unknowns += ncp[VELOCITY2];
+    num_unknowns += ncp[VELOCITY3];
+
+    /*
+     * Looks like Matt's particle momentum is considered lumped together
+     * with solvent phase momentum equations for the purposes of computing
+     * a global time step norm...
+     */
+    Err_norm      += ecp[PVELOCITY1];
+    Err_norm      += ecp[PVELOCITY2];
+    Err_norm      += ecp[PVELOCITY3];
+    num_unknowns += ncp[PVELOCITY1];
+    num_unknowns += ncp[PVELOCITY2];
+    num_unknowns += ncp[PVELOCITY3];
+  }
+
+  if (use_var_norm[2]) {
+    Err_norm      += ecp[TEMPERATURE];
+    num_unknowns += ncp[TEMPERATURE];
+  }
+
+  if (use_var_norm[3]) {	/* Maybe someday we can discriminate between
+				 * individual species at fault for predictor
+				 * missing the corrector. */
+    Err_norm      += ecp[MASS_FRACTION];
+    Err_norm      += ecp[POR_LIQ_PRES];
+    Err_norm      += ecp[POR_GAS_PRES];
+    Err_norm      += ecp[POR_POROSITY];
+    Err_norm      += ecp[POR_SATURATION];
+    Err_norm      += ecp[POR_SINK_MASS];
+
+    num_unknowns += ncp[MASS_FRACTION];
+    num_unknowns += ncp[POR_LIQ_PRES];
+    num_unknowns += ncp[POR_GAS_PRES];
+    num_unknowns += ncp[POR_POROSITY];
+    num_unknowns += ncp[POR_SATURATION];
+    num_unknowns += ncp[POR_SINK_MASS];
+  }
+
+  if (use_var_norm[4]) {	/* Pressure, even though there is no dP/dt
+				 * term in any of the equations for
+				 * incompressible flow... */
+    Err_norm      += ecp[PRESSURE];
+    num_unknowns += ncp[PRESSURE];
+  }
+
+  if (use_var_norm[5]) {	/* Polymer extra stress contribution */
+    Err_norm      += ecp[POLYMER_STRESS11];
+    Err_norm      += ecp[POLYMER_STRESS12];
+    Err_norm      += ecp[POLYMER_STRESS22];
+    Err_norm      += ecp[POLYMER_STRESS13];
+    Err_norm      += ecp[POLYMER_STRESS23];
+    Err_norm      += ecp[POLYMER_STRESS33];
+
+    num_unknowns += ncp[POLYMER_STRESS11];
+    num_unknowns += ncp[POLYMER_STRESS12];
+    num_unknowns += ncp[POLYMER_STRESS22];
+    num_unknowns += ncp[POLYMER_STRESS13];
+    num_unknowns += ncp[POLYMER_STRESS23];
+    num_unknowns += ncp[POLYMER_STRESS33];
+
+    /*
+     * Hey, lots of multi-mode Giesekus stress equations, too!
+     */
+    for (eqn=POLYMER_STRESS11_1; eqn<=POLYMER_STRESS33_7; eqn++ ) {
+      Err_norm      += ecp[eqn];
+      num_unknowns += ncp[eqn];
+    }
+  }
+
+  if (use_var_norm[6]) {
+    Err_norm      += ecp[VOLTAGE];
+    num_unknowns += ncp[VOLTAGE];
+  }
+
+  if (use_var_norm[7]) {
+    Err_norm      += ecp[SOLID_DISPLACEMENT1];
+    Err_norm      += ecp[SOLID_DISPLACEMENT2];
+    Err_norm      += ecp[SOLID_DISPLACEMENT3];
+
+    num_unknowns += ncp[SOLID_DISPLACEMENT1];
+    num_unknowns += ncp[SOLID_DISPLACEMENT2];
+    num_unknowns += ncp[SOLID_DISPLACEMENT3];
+  }
+
+  if ( nAC > 0 && ecp_AC != NULL )   /* Don't we want to include the AC unknowns in time step control ? */
+    {
+      if (use_var_norm[9]) { /* answer -> not usually since they are often algebraic constraints */
+	for ( i = 0 ; i< nAC ; i++ )
+	  {
+	    Err_norm += ecp_AC[i];
+	  }
+	num_unknowns += nAC;
+      }
+    }
+/** add in shell element components  */
+ 
+    Err_norm      += ecp[SURF_CHARGE];
+    Err_norm      += ecp[SHELL_CURVATURE];
+    Err_norm      += ecp[SHELL_CURVATURE2];
+    Err_norm      += ecp[SHELL_TENSION];
+    Err_norm      += ecp[SHELL_X];
+    Err_norm      += ecp[SHELL_Y];
+    Err_norm      += ecp[SHELL_USER];
+    Err_norm      += ecp[ACOUS_PREAL];
+    Err_norm      += ecp[ACOUS_PIMAG];
+    Err_norm      += ecp[ACOUS_REYN_STRESS];
+    Err_norm      += ecp[SHELL_BDYVELO];
+    Err_norm      += ecp[SHELL_LUBP];
+    Err_norm      += ecp[SHELL_TEMPERATURE];
+    Err_norm      += ecp[SHELL_DELTAH];
+    Err_norm      += ecp[SHELL_FILMP];
+    Err_norm      += ecp[SHELL_FILMH];
+    Err_norm      += ecp[SHELL_PARTC]; 
+    Err_norm      += ecp[LIGHT_INTP];
+    Err_norm      += ecp[LIGHT_INTM];
+    Err_norm      += ecp[LIGHT_INTD];
+    Err_norm      += ecp[RESTIME];  
+/*    Err_norm      += ecp[EXT_VELOCITY];  */
+    Err_norm      += ecp[TFMP_PRES];
+    Err_norm      += ecp[TFMP_SAT];
+ 
+    num_unknowns += ncp[SURF_CHARGE];
+    num_unknowns += ncp[SHELL_CURVATURE];
+    num_unknowns += ncp[SHELL_CURVATURE2];
+    num_unknowns += ncp[SHELL_TENSION];
+    num_unknowns += ncp[SHELL_X];
+    num_unknowns += ncp[SHELL_Y];
+    num_unknowns += ncp[SHELL_USER];
+    num_unknowns += ncp[ACOUS_PREAL];
+    num_unknowns += ncp[ACOUS_PIMAG];
+    num_unknowns += ncp[ACOUS_REYN_STRESS];
+    num_unknowns += ncp[SHELL_BDYVELO];
+    num_unknowns += ncp[SHELL_LUBP];
+    num_unknowns += ncp[SHELL_TEMPERATURE];
+    num_unknowns += ncp[SHELL_DELTAH];
+    num_unknowns += ncp[SHELL_FILMP];
+    num_unknowns += ncp[SHELL_FILMH];
+    num_unknowns += ncp[SHELL_PARTC]; 
+    num_unknowns += ncp[LIGHT_INTP];
+    num_unknowns += ncp[LIGHT_INTM];
+    num_unknowns += ncp[LIGHT_INTD];
+    num_unknowns += ncp[RESTIME];  
+/*    num_unknowns += ncp[EXT_VELOCITY];  */
+    num_unknowns += ncp[TFMP_PRES];
+    num_unknowns += ncp[TFMP_SAT];
+
+  if (use_var_norm[8] ) /* LS equation is set with special card in Level Set section */
+  {
+    Err_norm      += ecp[FILL];
+    num_unknowns += ncp[FILL];
+    Err_norm      += ecp[PHASE1];
+    num_unknowns  += ncp[PHASE1];
+  }
+
+  if (use_var_norm[9]) {
+    Err_norm      += ecp[LUBP];
+    Err_norm      += ecp[LUBP_2];
+    Err_norm      += ecp[SHELL_SAT_CLOSED];
+    Err_norm      += ecp[SHELL_PRESS_OPEN];
+    Err_norm      += ecp[SHELL_PRESS_OPEN_2];
+    Err_norm      += ecp[SHELL_SAT_GASN];
+    Err_norm      += ecp[SHELL_LUB_CURV];
+    Err_norm      += ecp[SHELL_LUB_CURV_2];
+    num_unknowns += ncp[LUBP];
+    num_unknowns += ncp[LUBP_2];
+    num_unknowns += ncp[SHELL_SAT_CLOSED];
+    num_unknowns += ncp[SHELL_PRESS_OPEN];
+    num_unknowns += ncp[SHELL_PRESS_OPEN_2];
+    num_unknowns += ncp[SHELL_SAT_GASN];
+    num_unknowns += ncp[SHELL_LUB_CURV];
+    num_unknowns += ncp[SHELL_LUB_CURV_2];
+  }
+
+#if 0 /* ------------------- maybe someday you'll want these, too... -----*/
+  if (use_var_norm["index for shear rate equation"] ) {
+    Err_norm      += ecp[SHEAR_RATE];
+    num_unknowns += ncp[SHEAR_RATE];
+  }
+  if (use_var_norm["index for vorticity principle shear directions"] )  {
+    Err_norm      += ecp[VORT_DIR1];
+    Err_norm      += ecp[VORT_DIR2];
+    Err_norm      += ecp[VORT_DIR3];
+    Err_norm      += ecp[VORT_LAMBDA];
+    num_unknowns += ncp[VORT_DIR1];
+    num_unknowns += ncp[VORT_DIR2];
+    num_unknowns += ncp[VORT_DIR3];
+    num_unknowns += ncp[VORT_LAMBDA];
+  }
+
+  if (use_var_norm["index for suspension temperature equation"] ) {
+    Err_norm      += ecp[BOND_EVOLUTION];
+    num_unknowns += ncp[BOND_EVOLUTION];
+  }
+#endif
+
+  *num_unknowns_out = num_unknowns;
+  return (Err_norm);
+} /* END of routine time_step_error_sum */
+/***************************************************************************/
+
+/*
+ * Time Step Controller history: the error of the last accepted step, and
+ * whether a rejection came after it.
+ */
+static double TS_Err_Old = -1.0;
+static int    TS_Rejected = FALSE;
+
+static double
+time_step_controller(const double delta_t, const double delta_t_old,
+		     const double err, const double eps, const double expo)
+
+    /**********************************************************************
+     *
+     * time_step_controller()
+     *
+     * Ratio of the next step size to this one, err being the error of
+     * this accepted step and eps its target, for the PI and H211b
+     * controllers (Gustafsson 1991, Soderlind 2003), with k = expo:
+     *
+     *   PI:    (eps/err_n)^(0.7 k) (err_n-1/eps)^(0.4 k)
+     *   H211b: (eps/err_n)^(k/4) (eps/err_n-1)^(k/4) (dt_n/dt_n-1)^(-1/4)
+     *
+     * Without an accepted step before this one both are elementary.
+     ***********************************************************************/
+{
+  double r_n = eps / err, r_old, ratio;
+
+  if (TS_Err_Old <= 0.0) {
+    ratio = pow(r_n, expo);
+  } else {
+    r_old = eps / TS_Err_Old;
+    if (tran->ts_controller == TS_CONTROL_PI) {
+      ratio = pow(r_n, 0.7 * expo) * pow(r_old, -0.4 * expo);
+    } else {
+      ratio = pow(r_n, 0.25 * expo) * pow(r_old, 0.25 * expo);
+      if (delta_t_old > 0.0) ratio *= pow(delta_t / delta_t_old, -0.25);
+    }
+  }
+
+  /* one poor estimate should not collapse the step */
+  return (MAX(ratio, 0.2));
+}
+/***************************************************************************/
+
 double
 time_step_control(const double delta_t,  const double delta_t_old, 
 		  const int const_delta_t,
 		  const double x[], const double x_pred[],  const double x_old[], 
 		  const double x_AC[], const double x_AC_pred[], const double eps,
-		  int *success_dt, const int use_var_norm[])
+		  int *success_dt, const int use_var_norm[],
+		  const int num_newton)
 
     /**********************************************************************
      *
@@ -542,6 +828,8 @@ time_step_control(const double delta_t,  const double delta_t_old,
      * use_var_norm    - this tells us whether or not to use a variable 
      *                   for the norm calculations. 0 means don't use ...
      *                   1 means use. The choice is made in the input deck
+     * num_newton      - Newton iterations the step took, for the Time
+     *                   Step Controller's Newton target
      *
      * Output
      *---------
@@ -581,6 +869,11 @@ time_step_control(const double delta_t,  const double delta_t_old,
   double ecp[MAX_VARIABLE_TYPES]; /* error in corrector-predictor for ea var */
   double *ecp_AC = NULL;
   int inode, idof, valid;
+  int bdf_lo = -1, bdf_hi = -1;	/* other BDF orders whose error is estimated */
+  int num_bdf;
+  double ecp_lo[MAX_VARIABLE_TYPES], ecp_hi[MAX_VARIABLE_TYPES];
+  double err_lo = -1.0, err_hi = -1.0;
+  double expo = 1./3.;		/* of the error ratio in the new time step */
 #ifdef PARALLEL  
   double ecp_buf[MAX_VARIABLE_TYPES]; /* accumulated over all procs */
   int ncp_buf[MAX_VARIABLE_TYPES];    /* accumulated over all procs */
@@ -605,6 +898,14 @@ time_step_control(const double delta_t,  const double delta_t_old,
 
   if (nAC > 0 ) ecp_AC = alloc_dbl_1( nAC, 0 );
 
+  init_vec_value(ecp_lo, 0.0, MAX_VARIABLE_TYPES);
+  init_vec_value(ecp_hi, 0.0, MAX_VARIABLE_TYPES);
+  if (bdf_active())
+    {
+      bdf_error_orders(&bdf_lo, &bdf_hi);
+      expo = 1.0 / (bdf_order() + 1);
+    }
+
   for ( i=0; i<MAX_VARIABLE_TYPES; i++)
     {
       ecp[i] = 0.0;
@@ -660,6 +961,10 @@ time_step_control(const double delta_t,  const double delta_t_old,
       {
         ecp[eqn] += SQUARE(x[i] - x_pred[i]);
         ncp[eqn]++;
+        if (bdf_lo >= 0)
+	  ecp_lo[eqn] += SQUARE(x[i] - bdf_extrapolate(bdf_lo, i));
+        if (bdf_hi >= 0)
+	  ecp_hi[eqn] += SQUARE(x[i] - x_pred[i] - bdf_prev_correction(i));
 /* Set bit TRUE in next line to scale displacements with coordinates
  * instead of displacements to avoid large displacement error when
  * there is near zero displacement - i.e., better timestep control */
@@ -696,6 +1001,17 @@ time_step_control(const double delta_t,  const double delta_t_old,
     max[i] = max_buf[i];
     ncp[i] = ncp_buf[i];
   }
+
+  if (bdf_lo >= 0) {
+    MPI_Allreduce( (void*)ecp_lo, (void *)ecp_buf, MAX_VARIABLE_TYPES, 
+		   MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    for (i = 0; i < MAX_VARIABLE_TYPES; i++) ecp_lo[i] = ecp_buf[i];
+  }
+  if (bdf_hi >= 0) {
+    MPI_Allreduce( (void*)ecp_hi, (void *)ecp_buf, MAX_VARIABLE_TYPES, 
+		   MPI_DOUBLE, MPI_SUM, MPI_COMM_WORLD);
+    for (i = 0; i < MAX_VARIABLE_TYPES; i++) ecp_hi[i] = ecp_buf[i];
+  }
 #endif
 
   /* 
@@ -707,8 +1023,12 @@ time_step_control(const double delta_t,  const double delta_t_old,
       if (max[i] > 0.0) {
 #ifdef VAR_UPDATE_UNITY_SCALE
 	ecp[i] =  ecp[i] / (1.0 + SQUARE(max[i]));
+	ecp_lo[i] /= (1.0 + SQUARE(max[i]));
+	ecp_hi[i] /= (1.0 + SQUARE(max[i]));
 #else
 	ecp[i] =  ecp[i] / SQUARE(max[i]);
+	ecp_lo[i] /= SQUARE(max[i]);
+	ecp_hi[i] /= SQUARE(max[i]);
 #endif
       }
     }
@@ -723,219 +1043,8 @@ time_step_control(const double delta_t,  const double delta_t_old,
    * Construct a single error norm from each variable's contribution
    * depending on user selection specification in the input deck.
    */
-  if (use_var_norm[0]) {
-    Err_norm      += ecp[MESH_DISPLACEMENT1];
-    Err_norm      += ecp[MESH_DISPLACEMENT2];
-    Err_norm      += ecp[MESH_DISPLACEMENT3];
-    Err_norm      += ecp[MAX_STRAIN];
-    Err_norm      += ecp[CUR_STRAIN];
-    num_unknowns += ncp[MESH_DISPLACEMENT1];
-    num_unknowns += ncp[MESH_DISPLACEMENT2];
-    num_unknowns += ncp[MESH_DISPLACEMENT3];
-    num_unknowns += ncp[MAX_STRAIN];
-    num_unknowns += ncp[CUR_STRAIN];
-  }
-
-  if (use_var_norm[1]) {
-    Err_norm      += ecp[VELOCITY1];
-    Err_norm      += ecp[VELOCITY2];
-    Err_norm      += ecp[VELOCITY3];
-    num_unknowns += ncp[VELOCITY1];
-    num_unknowns += ncp[VELOCITY2];
-    num_unknowns += ncp[VELOCITY3];
-
-    /*
-     * Looks like Matt's particle momentum is considered lumped together
-     * with solvent phase momentum equations for the purposes of computing
-     * a global time step norm...
-     */
-    Err_norm      += ecp[PVELOCITY1];
-    Err_norm      += ecp[PVELOCITY2];
-    Err_norm      += ecp[PVELOCITY3];
-    num_unknowns += ncp[PVELOCITY1];
-    num_unknowns += ncp[PVELOCITY2];
-    num_unknowns += ncp[PVELOCITY3];
-  }
-
-  if (use_var_norm[2]) {
-    Err_norm      += ecp[TEMPERATURE];
-    num_unknowns += ncp[TEMPERATURE];
-  }
-
-  if (use_var_norm[3]) {	/* Maybe someday we can discriminate between
-				 * individual species at fault for predictor
-				 * missing the corrector. */
-    Err_norm      += ecp[MASS_FRACTION];
-    Err_norm      += ecp[POR_LIQ_PRES];
-    Err_norm      += ecp[POR_GAS_PRES];
-    Err_norm      += ecp[POR_POROSITY];
-    Err_norm      += ecp[POR_SATURATION];
-    Err_norm      += ecp[POR_SINK_MASS];
-
-    num_unknowns += ncp[MASS_FRACTION];
-    num_unknowns += ncp[POR_LIQ_PRES];
-    num_unknowns += ncp[POR_GAS_PRES];
-    num_unknowns += ncp[POR_POROSITY];
-    num_unknowns += ncp[POR_SATURATION];
-    num_unknowns += ncp[POR_SINK_MASS];
-  }
-
-  if (use_var_norm[4]) {	/* Pressure, even though there is no dP/dt
-				 * term in any of the equations for
-				 * incompressible flow... */
-    Err_norm      += ecp[PRESSURE];
-    num_unknowns += ncp[PRESSURE];
-  }
-
-  if (use_var_norm[5]) {	/* Polymer extra stress contribution */
-    Err_norm      += ecp[POLYMER_STRESS11];
-    Err_norm      += ecp[POLYMER_STRESS12];
-    Err_norm      += ecp[POLYMER_STRESS22];
-    Err_norm      += ecp[POLYMER_STRESS13];
-    Err_norm      += ecp[POLYMER_STRESS23];
-    Err_norm      += ecp[POLYMER_STRESS33];
-
-    num_unknowns += ncp[POLYMER_STRESS11];
-    num_unknowns += ncp[POLYMER_STRESS12];
-    num_unknowns += ncp[POLYMER_STRESS22];
-    num_unknowns += ncp[POLYMER_STRESS13];
-    num_unknowns += ncp[POLYMER_STRESS23];
-    num_unknowns += ncp[POLYMER_STRESS33];
-
-    /*
-     * Hey, lots of multi-mode Giesekus stress equations, too!
-     */
-    for (eqn=POLYMER_STRESS11_1; eqn<=POLYMER_STRESS33_7; eqn++ ) {
-      Err_norm      += ecp[eqn];
-      num_unknowns += ncp[eqn];
-    }
-  }
-
-  if (use_var_norm[6]) {
-    Err_norm      += ecp[VOLTAGE];
-    num_unknowns += ncp[VOLTAGE];
-  }
-
-  if (use_var_norm[7]) {
-    Err_norm      += ecp[SOLID_DISPLACEMENT1];
-    Err_norm      += ecp[SOLID_DISPLACEMENT2];
-    Err_norm      += ecp[SOLID_DISPLACEMENT3];
-
-    num_unknowns += ncp[SOLID_DISPLACEMENT1];
-    num_unknowns += ncp[SOLID_DISPLACEMENT2];
-    num_unknowns += ncp[SOLID_DISPLACEMENT3];
-  }
-
-  if ( nAC > 0 )   /* Don't we want to include the AC unknowns in time step control ? */
-    {
-      if (use_var_norm[9]) { /* answer -> not usually since they are often algebraic constraints */
-	for ( i = 0 ; i< nAC ; i++ )
-	  {
-	    Err_norm += ecp_AC[i];
-	  }
-	num_unknowns += nAC;
-      }
-    }
-/** add in shell element components  */
- 
-    Err_norm      += ecp[SURF_CHARGE];
-    Err_norm      += ecp[SHELL_CURVATURE];
-    Err_norm      += ecp[SHELL_CURVATURE2];
-    Err_norm      += ecp[SHELL_TENSION];
-    Err_norm      += ecp[SHELL_X];
-    Err_norm      += ecp[SHELL_Y];
-    Err_norm      += ecp[SHELL_USER];
-    Err_norm      += ecp[ACOUS_PREAL];
-    Err_norm      += ecp[ACOUS_PIMAG];
-    Err_norm      += ecp[ACOUS_REYN_STRESS];
-    Err_norm      += ecp[SHELL_BDYVELO];
-    Err_norm      += ecp[SHELL_LUBP];
-    Err_norm      += ecp[SHELL_TEMPERATURE];
-    Err_norm      += ecp[SHELL_DELTAH];
-    Err_norm      += ecp[SHELL_FILMP];
-    Err_norm      += ecp[SHELL_FILMH];
-    Err_norm      += ecp[SHELL_PARTC]; 
-    Err_norm      += ecp[LIGHT_INTP];
-    Err_norm      += ecp[LIGHT_INTM];
-    Err_norm      += ecp[LIGHT_INTD];
-    Err_norm      += ecp[RESTIME];  
-/*    Err_norm      += ecp[EXT_VELOCITY];  */
-    Err_norm      += ecp[TFMP_PRES];
-    Err_norm      += ecp[TFMP_SAT];
- 
-    num_unknowns += ncp[SURF_CHARGE];
-    num_unknowns += ncp[SHELL_CURVATURE];
-    num_unknowns += ncp[SHELL_CURVATURE2];
-    num_unknowns += ncp[SHELL_TENSION];
-    num_unknowns += ncp[SHELL_X];
-    num_unknowns += ncp[SHELL_Y];
-    num_unknowns += ncp[SHELL_USER];
-    num_unknowns += ncp[ACOUS_PREAL];
-    num_unknowns += ncp[ACOUS_PIMAG];
-    num_unknowns += ncp[ACOUS_REYN_STRESS];
-    num_unknowns += ncp[SHELL_BDYVELO];
-    num_unknowns += ncp[SHELL_LUBP];
-    num_unknowns += ncp[SHELL_TEMPERATURE];
-    num_unknowns += ncp[SHELL_DELTAH];
-    num_unknowns += ncp[SHELL_FILMP];
-    num_unknowns += ncp[SHELL_FILMH];
-    num_unknowns += ncp[SHELL_PARTC]; 
-    num_unknowns += ncp[LIGHT_INTP];
-    num_unknowns += ncp[LIGHT_INTM];
-    num_unknowns += ncp[LIGHT_INTD];
-    num_unknowns += ncp[RESTIME];  
-/*    num_unknowns += ncp[EXT_VELOCITY];  */
-    num_unknowns += ncp[TFMP_PRES];
-    num_unknowns += ncp[TFMP_SAT];
-
-  if (use_var_norm[8] ) /* LS equation is set with special card in Level Set section */
-  {
-    Err_norm      += ecp[FILL];
-    num_unknowns += ncp[FILL];
-    Err_norm      += ecp[PHASE1];
-    num_unknowns  += ncp[PHASE1];
-  }
-
-  if (use_var_norm[9]) {
-    Err_norm      += ecp[LUBP];
-    Err_norm      += ecp[LUBP_2];
-    Err_norm      += ecp[SHELL_SAT_CLOSED];
-    Err_norm      += ecp[SHELL_PRESS_OPEN];
-    Err_norm      += ecp[SHELL_PRESS_OPEN_2];
-    Err_norm      += ecp[SHELL_SAT_GASN];
-    Err_norm      += ecp[SHELL_LUB_CURV];
-    Err_norm      += ecp[SHELL_LUB_CURV_2];
-    num_unknowns += ncp[LUBP];
-    num_unknowns += ncp[LUBP_2];
-    num_unknowns += ncp[SHELL_SAT_CLOSED];
-    num_unknowns += ncp[SHELL_PRESS_OPEN];
-    num_unknowns += ncp[SHELL_PRESS_OPEN_2];
-    num_unknowns += ncp[SHELL_SAT_GASN];
-    num_unknowns += ncp[SHELL_LUB_CURV];
-    num_unknowns += ncp[SHELL_LUB_CURV_2];
-  }
-
-#if 0 /* ------------------- maybe someday you'll want these, too... -----*/
-  if (use_var_norm["index for shear rate equation"] ) {
-    Err_norm      += ecp[SHEAR_RATE];
-    num_unknowns += ncp[SHEAR_RATE];
-  }
-  if (use_var_norm["index for vorticity principle shear directions"] )  {
-    Err_norm      += ecp[VORT_DIR1];
-    Err_norm      += ecp[VORT_DIR2];
-    Err_norm      += ecp[VORT_DIR3];
-    Err_norm      += ecp[VORT_LAMBDA];
-    num_unknowns += ncp[VORT_DIR1];
-    num_unknowns += ncp[VORT_DIR2];
-    num_unknowns += ncp[VORT_DIR3];
-    num_unknowns += ncp[VORT_LAMBDA];
-  }
-
-  if (use_var_norm["index for suspension temperature equation"] ) {
-    Err_norm      += ecp[BOND_EVOLUTION];
-    num_unknowns += ncp[BOND_EVOLUTION];
-  }
-#endif
+  Err_norm = time_step_error_sum(ecp, ncp, ecp_AC, use_var_norm,
+				 &num_unknowns);
 
   if (num_unknowns == 0) {
     DPRINTF(stderr, 
@@ -948,10 +1057,28 @@ time_step_control(const double delta_t,  const double delta_t_old,
     EH(-1, "Poorly formed time step norm.");
   }
 
-  scaling   = 1.0 / (num_unknowns * (2.0 + delta_t_old / delta_t));
+  /*
+   * Milne's estimate of the local truncation error from the predictor
+   * corrector difference; for BDF the factor depends on the order and
+   * on the past steps, and reduces to this one at order 1.
+   */
+  if (bdf_active()) {
+    scaling = bdf_error_factor(bdf_order()) / num_unknowns;
+  } else {
+    scaling = 1.0 / (num_unknowns * (2.0 + delta_t_old / delta_t));
+  }
   Err_norm *= scaling;
   Err_norm  = sqrt(Err_norm);
 
+  if (bdf_lo >= 0) {
+    err_lo = time_step_error_sum(ecp_lo, ncp, NULL, use_var_norm, &num_bdf);
+    err_lo = sqrt(err_lo * bdf_error_factor(bdf_lo) / MAX(num_bdf, 1));
+  }
+  if (bdf_hi >= 0) {
+    err_hi = time_step_error_sum(ecp_hi, ncp, NULL, use_var_norm, &num_bdf);
+    err_hi = sqrt(err_hi * bdf_error_factor(bdf_hi) / MAX(num_bdf, 1));
+  }
+
   /*
    * Bin the individual variable type errors. Then, scale them.
    */
@@ -1137,6 +1264,7 @@ time_step_control(const double delta_t,  const double delta_t_old,
      * error, decrease the time step by a factor of two and return
      */
     delta_t_new = delta_t / 2.; 
+    TS_Rejected = TRUE;
     return (delta_t_new);
   } else {
     if (Err_norm <= 0.0) {
@@ -1146,13 +1274,44 @@ time_step_control(const double delta_t,  const double delta_t_old,
 	delta_t_new = delta_t; 
       }
     } else if (Err_norm > abs_eps) {
-      delta_t_new = delta_t * pow(abs_eps/Err_norm,1./3.);
+      delta_t_new = delta_t * pow(abs_eps/Err_norm, expo);
     } else if (Err_norm <= abs_eps && 
 	       Err_norm >= abs_eps / alpha) {
       delta_t_new = delta_t;
     } else if (Err_norm < abs_eps / alpha) {
-      delta_t_new = delta_t * pow(abs_eps / (alpha * Err_norm), 1./3.);
+      delta_t_new = delta_t * pow(abs_eps / (alpha * Err_norm), expo);
+    }
+
+    /*
+     * Time Step Controller: the PI and H211b ones replace the above,
+     * then the step after a rejection, and one that took more than the
+     * target number of Newton steps, may grow only so much.
+     */
+    if (tran->ts_controller != TS_CONTROL_ELEMENTARY && Err_norm > 0.0 &&
+	abs_eps > 0.0) {
+      delta_t_new = delta_t * time_step_controller(delta_t, delta_t_old,
+						   Err_norm, abs_eps, expo);
+    }
+    if (TS_Rejected && delta_t_new > tran->ts_reject_growth * delta_t) {
+      delta_t_new = tran->ts_reject_growth * delta_t;
     }
+    if (tran->ts_newton_target > 0 && num_newton > tran->ts_newton_target) {
+      delta_t_new = MIN(delta_t_new, delta_t * (double) tran->ts_newton_target /
+			(double) num_newton);
+    }
+    log_msg("Time step controller: error %g of %g, %d Newton steps%s, dt ratio %g",
+	    Err_norm, abs_eps, num_newton, TS_Rejected ? " after a rejection" : "",
+	    delta_t_new / delta_t);
+    TS_Err_Old  = Err_norm;
+    TS_Rejected = FALSE;
+  }
+
+  /*
+   * BDF: the order for the next step, which may call for another step.
+   */
+  if (bdf_active()) {
+    delta_t_new = bdf_select_order(delta_t, delta_t_new, abs_eps, err_lo,
+				   Err_norm, err_hi, const_delta_t);
   }
   
   /* 
@@ -2241,6 +2400,7 @@ int rd_vectors_from_exoII(double u[],
   int   var;
   MATRL_PROP_STRUCT *matrl = 0;
   double ftimeValue;
+  const Exo_DB *donor_exo = NULL;
 #ifdef DEBUG
   static const char yo[] = "rd_vectors_from_exoII";
 #endif
@@ -2318,6 +2478,8 @@ int rd_vectors_from_exoII(double u[],
    */
 
   if (action_flag == 0) {
+    /* a solution on another mesh, e.g. a Mesh Sequence stage, is interpolated */
+    if (num_nodes != exo->num_nodes) donor_exo = exo;
     for (var = V_FIRST; var < V_LAST; var++) {
       icount = 0;
       if (Num_Var_In_Type[var]) {
@@ -2335,7 +2497,7 @@ int rd_vectors_from_exoII(double u[],
 	    for (w = 0; w < matrl->Num_Species_Eqn; w++) {
 	      error = rd_exoII_nv(u, var, mn, matrl, var_names, 
 				  num_nodes, num_vars,
-				  exoid, time_step, w);
+				  exoid, time_step, w, donor_exo);
 	      if (!error) icount++;
 	    }
 	  }
@@ -2350,7 +2512,11 @@ int rd_vectors_from_exoII(double u[],
 	    } else {
 	      matrl = mp_glob[mn];
 	    }
-            if (mn != -1 && (pd_glob[mn]->i[var] == I_P0)) {
+            if (mn != -1 && donor_exo != NULL &&
+                (pd_glob[mn]->i[var] == I_P0 || pd_glob[mn]->i[var] == I_P1)) {
+              WH(-1, "Element variables of the initial guess are not interpolated from another mesh");
+              error = 0;
+            } else if (mn != -1 && (pd_glob[mn]->i[var] == I_P0)) {
               error = rd_exoII_ev(u, var, mn, matrl, elem_var_names, exo->eb_num_elems[mn],
                                   num_elem_vars, exoid, time_step, 0, exo);
             } else if (mn != -1 && (pd_glob[mn]->i[var] == I_P1)) {
@@ -2361,7 +2527,7 @@ int rd_vectors_from_exoII(double u[],
               }
             } else {
               error = rd_exoII_nv(u, var, mn, matrl, var_names, num_nodes, num_vars, exoid,
-                                  time_step, 0);
+                                  time_step, 0, donor_exo);
             }
             if (!error)
               icount++;
@@ -2373,6 +2539,12 @@ int rd_vectors_from_exoII(double u[],
   
   if (action_flag == 1) {
     if (efv->ev) {	    
+      /*
+       * A field on another mesh is interpolated to this one.
+       */
+      int donor = (num_nodes != exo->num_nodes || Ext_Field_Donor_Mesh);
+      if (donor) num_nodes = exo->num_nodes;
+
       /*
        * Allocate memory for external field variable arrays
        */
@@ -2394,6 +2566,10 @@ int rd_vectors_from_exoII(double u[],
       if (vdex == -1) {      
 	DPRINTF(stdout,
 		"\n Cannot find external fields in exoII database, setting to null");
+      } else if (donor) {
+	error = rd_donor_nodal_field(exoid, time_step, vdex, exo,
+				     efv->ext_fld_ndl_val[variable_no]);
+	EH(error, "rd_donor_nodal_field");
       } else {
 	error = ex_get_var(exoid, time_step, EX_NODAL, vdex, 1, num_nodes,
 			   efv->ext_fld_ndl_val[variable_no]);
@@ -2607,7 +2783,7 @@ rd_trans_vectors_from_exoII(double u[], const char *file_nm,
 int
 rd_exoII_nv(double *u, int varType, int mn, MATRL_PROP_STRUCT *matrl, 
 	    char **var_names, int num_nodes, int num_vars, int exoII_id,
-	    int time_step, int spec) 
+	    int time_step, int spec, const Exo_DB *donor_exo) 
 
      /*************************************************************************
       *
@@ -2619,6 +2795,10 @@ rd_exoII_nv(double *u, int varType, int mn, MATRL_PROP_STRUCT *matrl,
       * type, this routine will initialize all variables of the variable type,
       * Var_exoII->Index at the node irrespective of what material they
       * are in.
+      *
+      *    With donor_exo, the file's mesh differs from donor_exo, the
+      * problem mesh, and the variable is interpolated onto it
+      * (rd_donor_field.c).
       *************************************************************************/
 {
   int vdex = -1, i, error, status = 0;
@@ -2632,12 +2812,18 @@ rd_exoII_nv(double *u, int varType, int mn, MATRL_PROP_STRUCT *matrl,
     }
   }
   if (vdex != -1) {
-    variable = alloc_dbl_1(num_nodes, 0.0);
     status = vdex;
     DPRINTF(stdout,"Nodal variable %s found in exoII database - reading.\n", 
 	    exo_var_name);
-    error = ex_get_var(exoII_id, time_step, EX_NODAL, vdex, 1, num_nodes, variable);
-    EH(error, "ex_get_var nodal");
+    if (donor_exo != NULL) {
+      variable = alloc_dbl_1(donor_exo->num_nodes, 0.0);
+      error = rd_donor_nodal_field(exoII_id, time_step, vdex, donor_exo, variable);
+      EH(error, "rd_donor_nodal_field");
+    } else {
+      variable = alloc_dbl_1(num_nodes, 0.0);
+      error = ex_get_var(exoII_id, time_step, EX_NODAL, vdex, 1, num_nodes, variable);
+      EH(error, "ex_get_var nodal");
+    }
     inject_nodal_vec(u, varType, spec, 0, mn, variable);
     safer_free((void **) &variable);
   }
@@ -0,0 +1,252 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * Autotuning of the Aztec solver and preconditioner (Linear Solver
+ * Autotune card).
+ *
+ * On the first Aztec solve, the matrix and right hand side are solved
+ * from scratch with each of a short list of Krylov method and subdomain
+ * preconditioner settings, the options of the deck among them. The one
+ * that reaches the tolerance in the least wall time, the slowest
+ * processor counting, is kept for the rest of the run. When a later
+ * solve fails or takes more than Autotune_Degrade times the iterations
+ * the winner took, the next solve is tuned again, at most
+ * AUTOTUNE_MAX_TUNES times in all.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include "std.h"
+#include "rf_allo.h"
+#include "rf_fem_const.h"
+#include "rf_fem.h"
+#include "rf_mp.h"
+#include "rf_io_const.h"
+#include "rf_io.h"
+#include "rf_solver.h"
+#include "mm_eh.h"
+#include "sl_util_structs.h"
+
+#ifdef PARALLEL
+#ifndef MPI
+#define MPI			/* otherwise az_aztec.h trounces MPI_Request */
+#endif
+#endif
+
+#include "az_aztec.h"
+
+#define _SL_AUTOTUNE_C
+#include "goma.h"
+
+#define AUTOTUNE_MAX_TUNES 3
+
+struct autotune_candidate {
+  const char *name;
+  int solver;			/* AZ_solver, -1 for the deck's */
+  int subdomain_solve;		/* AZ_subdomain_solve under AZ_dom_decomp */
+  int graph_fill;		/* AZ_graph_fill */
+  dbl ilut_fill;		/* AZ_ilut_fill */
+};
+
+/* the first is whatever the deck asked for */
+static const struct autotune_candidate Candidate[] = {
+  { "deck",           -1,          -1,       0, 0. },
+  { "gmres ilu(0)",   AZ_gmres,    AZ_ilu,   0, 0. },
+  { "gmres ilu(1)",   AZ_gmres,    AZ_ilu,   1, 0. },
+  { "gmres ilu(2)",   AZ_gmres,    AZ_ilu,   2, 0. },
+  { "gmres ilut 2",   AZ_gmres,    AZ_ilut,  0, 2. },
+  { "bicgstab ilu(1)", AZ_bicgstab, AZ_ilu,  1, 0. },
+  { "gmres lu",       AZ_gmres,    AZ_lu,    0, 0. }
+};
+#define AUTOTUNE_NUM_CANDIDATES \
+  ((int) (sizeof(Candidate) / sizeof(struct autotune_candidate)))
+
+int Autotune_Linear_Solver = FALSE;
+dbl Autotune_Degrade = 3.;
+
+static int Tune_Pending = TRUE;
+static int Tunes = 0;
+static int Tuned_Its = -1;
+static int Deck_Saved = FALSE;
+static int Deck_Options[AZ_OPTIONS_SIZE];
+static double Deck_Params[AZ_PARAMS_SIZE];
+
+static dbl
+max_rss_kb(void)
+{
+  struct rusage ru;
+
+  if (getrusage(RUSAGE_SELF, &ru) != 0) return 0.;
+  return (dbl) ru.ru_maxrss;
+}
+
+/* the deck options with candidate c laid over them */
+static void
+autotune_options(const int c,
+		 int options[],
+		 double params[])
+{
+  memcpy(options, Deck_Options, AZ_OPTIONS_SIZE * sizeof(int));
+  memcpy(params, Deck_Params, AZ_PARAMS_SIZE * sizeof(double));
+  if (Candidate[c].solver < 0) return;
+
+  options[AZ_solver] = Candidate[c].solver;
+  options[AZ_precond] = AZ_dom_decomp;
+  options[AZ_subdomain_solve] = Candidate[c].subdomain_solve;
+  options[AZ_graph_fill] = Candidate[c].graph_fill;
+  if (Candidate[c].subdomain_solve == AZ_ilut) {
+    params[AZ_ilut_fill] = Candidate[c].ilut_fill;
+    params[AZ_drop] = 0.;
+  }
+}
+
+int
+aztec_autotune_pending(void)
+{
+  return (Autotune_Linear_Solver && Tune_Pending &&
+	  strcmp(Matrix_Format, "msr") == 0 &&
+	  Tunes < AUTOTUNE_MAX_TUNES);
+}
+
+void
+aztec_autotune(struct Aztec_Linear_Solver_System *ams,
+	       double delta_x[],
+	       double resid_vector[])
+
+    /*************************************************************************
+     *
+     * aztec_autotune():
+     *
+     *  Solve ams for resid_vector with each candidate and leave the
+     *  fastest one's options in ams->options and ams->params, set to
+     *  calculate its preconditioner afresh. delta_x is used as scratch;
+     *  ams->val and resid_vector are returned as they came.
+     *************************************************************************/
+{
+  int c, best = -1, best_its = -1, its, ok, nnz, n;
+  dbl t[2], tmax[2], best_time = 0., rss0;
+  double *val_save, *rhs_save;
+
+  if (!Deck_Saved) {
+    memcpy(Deck_Options, ams->options, AZ_OPTIONS_SIZE * sizeof(int));
+    memcpy(Deck_Params, ams->params, AZ_PARAMS_SIZE * sizeof(double));
+    Deck_Saved = TRUE;
+  }
+  Tune_Pending = FALSE;
+  Tunes++;
+
+  n = ams->npu;
+  nnz = ams->bindx[ams->npu];
+  val_save = alloc_dbl_1(nnz, 0.);
+  rhs_save = alloc_dbl_1(n, 0.);
+  memcpy(val_save, ams->val, nnz * sizeof(double));
+  memcpy(rhs_save, resid_vector, n * sizeof(double));
+
+  DPRINTF(stdout, "\nLinear Solver Autotune, pass %d:\n", Tunes);
+  DPRINTF(stdout, "  %-18s %12s %8s %10s %s\n", "candidate", "wall s",
+	  "its", "+rss KB", "");
+
+  for (c = 0; c < AUTOTUNE_NUM_CANDIDATES; c++) {
+    memcpy(ams->val, val_save, nnz * sizeof(double));
+    memcpy(resid_vector, rhs_save, n * sizeof(double));
+    memset(delta_x, 0, ams->npu_plus * sizeof(double));
+
+    autotune_options(c, ams->options, ams->params);
+    AZ_free_memory(ams->data_org[AZ_name]);
+    ams->options[AZ_pre_calc] = AZ_calc;
+
+    rss0 = max_rss_kb();
+    t[0] = wall_time();
+    AZ_solve(delta_x, resid_vector, ams->options, ams->params,
+	     ams->indx, ams->bindx, ams->rpntr, ams->cpntr,
+	     ams->bpntr, ams->val, ams->data_org, ams->status,
+	     ams->proc_config);
+    t[0] = wall_time() - t[0];
+    t[1] = max_rss_kb() - rss0;
+    its = (int) ams->status[AZ_its];
+    ok = (ams->status[AZ_why] == AZ_normal);
+
+    tmax[0] = t[0];
+    tmax[1] = t[1];
+#ifdef PARALLEL
+    if (Num_Proc > 1) {
+      int all_ok;
+      MPI_Allreduce(t, tmax, 2, MPI_DOUBLE, MPI_MAX, MPI_COMM_WORLD);
+      MPI_Allreduce(&ok, &all_ok, 1, MPI_INT, MPI_MIN, MPI_COMM_WORLD);
+      ok = all_ok;
+    }
+#endif
+
+    DPRINTF(stdout, "  %-18s %12.4e %8d %10.0f %s\n", Candidate[c].name,
+	    tmax[0], its, tmax[1], ok ? "" : "(not converged)");
+
+    if (ok && (best < 0 || tmax[0] < best_time)) {
+      best = c;
+      best_time = tmax[0];
+      best_its = its;
+    }
+  }
+
+  if (best < 0) {
+    best = 0;
+    DPRINTF(stdout, "  none converged, keeping the deck's options\n");
+  } else {
+    DPRINTF(stdout, "  using %s\n", Candidate[best].name);
+  }
+  Tuned_Its = best_its;
+
+  autotune_options(best, ams->options, ams->params);
+  AZ_free_memory(ams->data_org[AZ_name]);
+  ams->options[AZ_pre_calc] = AZ_calc;
+
+  memcpy(ams->val, val_save, nnz * sizeof(double));
+  memcpy(resid_vector, rhs_save, n * sizeof(double));
+  memset(delta_x, 0, ams->npu_plus * sizeof(double));
+  safe_free(val_save);
+  safe_free(rhs_save);
+}
+
+void
+aztec_autotune_check(struct Aztec_Linear_Solver_System *ams)
+
+    /*************************************************************************
+     *
+     * aztec_autotune_check():
+     *
+     *  After a solve with the tuned options: ask for another tuning if it
+     *  failed or took too many more iterations than the tuning did.
+     *************************************************************************/
+{
+  int degraded;
+
+  if (!Autotune_Linear_Solver || Tunes == 0) return;
+
+  degraded = (ams->status[AZ_why] != AZ_normal ||
+	      (Tuned_Its > 0 &&
+	       ams->status[AZ_its] > Autotune_Degrade * Tuned_Its));
+#ifdef PARALLEL
+  if (Num_Proc > 1) {
+    int any;
+    MPI_Allreduce(&degraded, &any, 1, MPI_INT, MPI_MAX, MPI_COMM_WORLD);
+    degraded = any;
+  }
+#endif
+  if (degraded && Tunes < AUTOTUNE_MAX_TUNES) Tune_Pending = TRUE;
+}
+/*****************************************************************************/
+/* END of file sl_autotune.c */
+/*****************************************************************************/
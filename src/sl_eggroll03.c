@@ -100,7 +100,7 @@ gevp_transformation(int UMF_system_id,
 	            int nnz,
                     int *ija,
                     dbl *jac,
-                    dbl *mas,
+                    EGG_MASS *mas,
                     dbl *mat, 
 			 /*	int soln_tech,  */
                     dbl *w,
@@ -117,7 +117,7 @@ gevp_transformation(int UMF_system_id,
 
   /* z = M v 
    */
-  MV_MSR(&nj, &ija[0], &mas[0], &v[0], &z[0]);
+  egg_mass_mv(mas, ija, v, z);
 
   /* Real shift matrix-vector product
    */
@@ -25,6 +25,7 @@ static const char rcs_id[] = "$Id: sl_eggrollutil.c,v 5.1 2007-09-18 18:53:47 pr
 #include <math.h>
 
 #include "std.h"
+#include "sl_auxutil.h"
 #include "sl_eggroll.h"
 
 /* Utility routines for sl_eggroll*.c.
@@ -46,3 +47,100 @@ cdiv(dbl ar, dbl ai,
   (*cr) = (ar*br+ai*bi)/s;
   (*ci) = (ai*br-ar*bi)/s;
 }
+
+
+/* Pick the nonzeros of the mass matrix mas[], stored in the full MSR
+ * pattern ija[] of the Jacobian, out into m.  The mass matrix has no
+ * spatial derivative coupling, so this is far fewer entries; once it is
+ * done mas[] can be freed.
+ */
+void
+egg_mass_compress(int n,
+		  int *ija,
+		  dbl *mas,
+		  EGG_MASS *m)
+{
+  int i, k, nnz;
+
+  nnz = 0;
+  for(i = 0; i < n; i++)
+    {
+      if(mas[i] != 0.0) nnz++;
+      for(k = ija[i]; k < ija[i+1]; k++)
+	if(mas[k] != 0.0) nnz++;
+    }
+
+  m->n   = n;
+  m->nnz = nnz;
+  m->ptr = Ivector_birth(n+1);
+  m->pos = Ivector_birth(MAX(nnz, 1));
+  m->val = Dvector_birth(MAX(nnz, 1));
+
+  nnz = 0;
+  for(i = 0; i < n; i++)
+    {
+      m->ptr[i] = nnz;
+      if(mas[i] != 0.0)
+	{
+	  m->pos[nnz] = i;
+	  m->val[nnz++] = mas[i];
+	}
+      for(k = ija[i]; k < ija[i+1]; k++)
+	if(mas[k] != 0.0)
+	  {
+	    m->pos[nnz] = k;
+	    m->val[nnz++] = mas[k];
+	  }
+    }
+  m->ptr[n] = nnz;
+}
+
+/* z = M v
+ */
+void
+egg_mass_mv(EGG_MASS *m,
+	    int *ija,
+	    dbl *v,
+	    dbl *z)
+{
+  int i, k, p;
+  dbl sum;
+
+  for(i = 0; i < m->n; i++)
+    {
+      sum = 0.0;
+      for(k = m->ptr[i]; k < m->ptr[i+1]; k++)
+	{
+	  p = m->pos[k];
+	  sum += m->val[k] * v[(p < m->n) ? i : ija[p]];
+	}
+      z[i] = sum;
+    }
+}
+
+/* mat = jac - sigma M, in the MSR pattern of jac
+ */
+void
+egg_mass_shift(EGG_MASS *m,
+	       int nnz,
+	       dbl *jac,
+	       dbl sigma,
+	       dbl *mat)
+{
+  int k;
+
+  memcpy(mat, jac, nnz * sizeof(dbl));
+  for(k = 0; k < m->nnz; k++)
+    mat[m->pos[k]] -= sigma * m->val[k];
+}
+
+void
+egg_mass_free(EGG_MASS *m)
+{
+  Ivector_death(m->ptr, m->n+1);
+  Ivector_death(m->pos, MAX(m->nnz, 1));
+  Dvector_death(m->val, MAX(m->nnz, 1));
+  m->ptr = m->pos = NULL;
+  m->val = NULL;
+  m->n = m->nnz = 0;
+}
@@ -22,6 +22,7 @@ static const char rcs_id[] = "$Id: sl_eggrollwrap.c,v 5.2 2007-09-18 18:53:47 pr
 #include <stdio.h>
 #include <string.h>
 #include <strings.h>
+#include <math.h>
 
 #include "goma.h"
 
@@ -49,13 +50,23 @@ static const char rcs_id[] = "$Id: sl_eggrollwrap.c,v 5.2 2007-09-18 18:53:47 pr
  *   - Feb 98 -> Oct 98, another checkin
  *   - Jan 13, 2000, MMH rearranged and conformed to Goma style.
  */
+
+/* With "Eigen Warm Start", the leading eigenvector and the eigenvalues of
+ * one solve are the initial vector and shifts of the next, e.g. the next
+ * stability check of a transient or the next wave number.
+ */
+static dbl *Egg_Warm_Vec = NULL;
+static int Egg_Warm_Len = 0;
+static int Egg_Warm_Num_Shifts = 0;
+static dbl Egg_Warm_Shifts[4];
+
 void eggrollwrap(int *istuff, /* info for eigenvalue extraction */
                  dbl *dstuff, /* info for eigenvalue extraction */
 
                  int *ija, /* column pointer array */
                  dbl *jac, /* nonzero array */
-                 dbl *mas, /* nonzero array - same structure
-                              as jac[] (ija[]) */
+                 EGG_MASS *mas, /* mass matrix, a subset of the
+                                   structure of jac[] (ija[]) */
 
                  dbl *x,           /* Value of the solution vector */
                  char *ExoFileOut, /* Name of exoII output file */
@@ -170,6 +181,17 @@ void eggrollwrap(int *istuff, /* info for eigenvalue extraction */
    */
   vinit(nj, &v1[0], 0.5);
 
+  /* Or start where the last solve finished. Each shift is kept a little
+   * to the right of its eigenvalue, so that J-sM stays invertible.
+   */
+  if (eigen->Eigen_Warm_Start && Egg_Warm_Len == nj)
+    {
+      vcopy(nj, &v1[0], 1.0, &Egg_Warm_Vec[0]);
+      for (i = 0; i < Egg_Warm_Num_Shifts && i < init_shft; i++)
+	ev_r[i] = Egg_Warm_Shifts[i];
+      printf(" warm start with %d shifts from the last solve ... ", MIN(Egg_Warm_Num_Shifts, init_shft));
+    }
+
   /* GEVP solution
    */
   ic = 0;
@@ -191,11 +213,11 @@ void eggrollwrap(int *istuff, /* info for eigenvalue extraction */
 	MV_MSR(&nj, &ija[0], &jac[0], &v1[0], &v2[0]);
 	break;  
       case  2: /* v2 = M*v1 */
-	MV_MSR(&nj, &ija[0], &mas[0], &v1[0], &v2[0]);
+	egg_mass_mv(mas, ija, v1, v2);
 	break;  
       case  3: /* inv(J-sM) */
 	/* Shift matrix step */
-	v2sum(nnz_j, &mat[0], 1.0, &jac[0], -dwork[0], &mas[0]);
+	egg_mass_shift(mas, nnz_j, jac, dwork[0], mat);
 
 	/* Invert step - get LU for later */
 	if(first_linear_solver_call == 1)
@@ -230,7 +252,7 @@ void eggrollwrap(int *istuff, /* info for eigenvalue extraction */
 	  EH(-1, "Tried to transform eigenvectors before a solve!");
 	gevp_transformation(UMF_system_id, first_linear_solver_call,
 			    Factor_Flag, matr_form, 1, nj, nnz_j,
-			    &ija[0], &jac[0], &mas[0], &mat[0],
+			    &ija[0], &jac[0], mas, &mat[0],
 			    /*			  soln_tech, */
 			    &v2[0], &v1[0], dwork[0], dwork[1]);
 	break;
@@ -287,6 +309,30 @@ void eggrollwrap(int *istuff, /* info for eigenvalue extraction */
   for (i=0;i<nev_found;i++)
     printf(" % 10.6e %+10.6e i % 10.6e\n", ev_r[i], ev_i[i], ev_e[i]);
 
+  /* Keep the leading mode and the eigenvalues for the next solve
+   */
+  if (eigen->Eigen_Warm_Start && nev_found > 0)
+    {
+      dbl norm = nnorm(nj, &evect[lead][0]);
+
+      if (norm > 0.0)
+	{
+	  if (Egg_Warm_Len != nj)
+	    {
+	      free(Egg_Warm_Vec);
+	      Egg_Warm_Vec = (dbl *) smalloc(nj * sizeof(dbl));
+	      Egg_Warm_Len = nj;
+	    }
+	  vcopy(nj, &Egg_Warm_Vec[0], 1.0/norm, &evect[lead][0]);
+	  Egg_Warm_Num_Shifts = MIN(nev_found, 4);
+	  for (i = 0; i < Egg_Warm_Num_Shifts; i++)
+	    {
+	      dbl offset = 0.01 * (fabs(ev_r[i]) + fabs(ev_i[i]));
+	      Egg_Warm_Shifts[i] = ev_r[i] + (offset > 0.0 ? offset : 1.0e-3);
+	    }
+	}
+    }
+
   /* MMH: I know this is stupid, but the filename for the "regular"
    * Exodus output is a global variable!!!  It is required in
    * post_process_nodal().  I swap it out here, and will swap it back
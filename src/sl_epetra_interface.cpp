@@ -25,6 +25,10 @@
 
 /**
  * Create a row matrix with a row map of size NumberProcRows
+ *
+ * The map is made with goma_gid sizes, so it has 64 bit global ids when
+ * goma is built with GOMA_GLOBAL_INDEX_64
+ *
  * @param NumberProcRows the number of rows on this processor
  * @return C compatible pointer to row matrix
  */
@@ -35,7 +39,8 @@ C_Epetra_RowMatrix_t* EpetraCreateRowMatrix(int NumberProcRows) {
   Epetra_SerialComm comm;
 #endif
   Epetra_RowMatrix *AMatrix;
-  Epetra_Map RowMap(-1, NumberProcRows, 0, comm);
+  goma_gid NumGlobalRows = -1, IndexBase = 0;
+  Epetra_Map RowMap(NumGlobalRows, NumberProcRows, IndexBase, comm);
 
   AMatrix = new Epetra_CrsMatrix(Copy, RowMap, 0);
 
@@ -55,8 +60,8 @@ C_Epetra_RowMatrix_t* EpetraCreateRowMatrix(int NumberProcRows) {
  * @param Values Values to insert
  * @param Indices Indices of values
  */
-void EpetraInsertGlobalRowMatrix(C_Epetra_RowMatrix_t *AMatrix, int GlobalRow,
-    int NumEntries, const double *Values, const int *Indices) {
+void EpetraInsertGlobalRowMatrix(C_Epetra_RowMatrix_t *AMatrix, goma_gid GlobalRow,
+    int NumEntries, const double *Values, const goma_gid *Indices) {
   Epetra_CrsMatrix* CrsMatrix = dynamic_cast<Epetra_CrsMatrix*>(AMatrix);
   if (CrsMatrix->Filled()) {
     CrsMatrix->ReplaceGlobalValues(GlobalRow, NumEntries, Values, Indices);
@@ -73,8 +78,8 @@ void EpetraInsertGlobalRowMatrix(C_Epetra_RowMatrix_t *AMatrix, int GlobalRow,
  * @param Values Values to sum
  * @param Indices Indices for values
  */
-void EpetraSumIntoGlobalRowMatrix(C_Epetra_RowMatrix_t *AMatrix, int GlobalRow,
-    int NumEntries, const double* Values, const int* Indices) {
+void EpetraSumIntoGlobalRowMatrix(C_Epetra_RowMatrix_t *AMatrix, goma_gid GlobalRow,
+    int NumEntries, const double* Values, const goma_gid* Indices) {
   Epetra_CrsMatrix* CrsMatrix = dynamic_cast<Epetra_CrsMatrix*>(AMatrix);
   int ierr = CrsMatrix->SumIntoGlobalValues(GlobalRow, NumEntries, Values,
       Indices);
@@ -82,6 +87,26 @@ void EpetraSumIntoGlobalRowMatrix(C_Epetra_RowMatrix_t *AMatrix, int GlobalRow,
     printf("Error in sum into epetra %d\n", ierr);
 }
 
+/**
+ * Sum into local values for epetra row matrix (C interface)
+ *
+ * Skips the global to local id lookups of EpetraSumIntoGlobalRowMatrix
+ *
+ * @param AMatrix Matrix to sum into values, must be filled
+ * @param MyRow Local Row
+ * @param NumEntries Number of Entries
+ * @param Values Values to sum
+ * @param Indices Column map local indices for values
+ */
+void EpetraSumIntoMyRowMatrix(C_Epetra_RowMatrix_t *AMatrix, int MyRow,
+    int NumEntries, const double* Values, const int* Indices) {
+  Epetra_CrsMatrix* CrsMatrix = dynamic_cast<Epetra_CrsMatrix*>(AMatrix);
+  int ierr = CrsMatrix->SumIntoMyValues(MyRow, NumEntries, Values,
+      Indices);
+  if (ierr)
+    printf("Error in sum into epetra %d\n", ierr);
+}
+
 /**
  * Set an Epetra Row Matrix to a specified scalar value for all NZ entries (C interface)
  * @param AMatrix Row matrix to set
@@ -102,7 +127,7 @@ void EpetraFillCompleteRowMatrix(C_Epetra_RowMatrix_t *AMatrix) {
 }
 
 int EpetraExtractRowValuesRowMatrix(C_Epetra_RowMatrix_t *AMatrix,
-    int GlobalRow, int size, double *values, int *indices) {
+    goma_gid GlobalRow, int size, double *values, goma_gid *indices) {
   Epetra_CrsMatrix* CrsMatrix = dynamic_cast<Epetra_CrsMatrix*>(AMatrix);
   int NumEntries;
   CrsMatrix->ExtractGlobalRowCopy(GlobalRow, size, NumEntries, values, indices);
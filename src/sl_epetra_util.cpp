@@ -64,18 +64,11 @@ extern "C" {
  * @param exo exodus file for this processor
  */
 void EpetraCreateGomaProblemGraph(struct Aztec_Linear_Solver_System *ams, Exo_DB *exo, Dpi *dpi) {
-  int j, inode, i1, i2, eb1;
-  int iunknown, inter_unknown, inter_node, row_num_unknowns, col_num_unknowns;
-  int irow_index = 0;
-  int icol_index, rowVarType, colVarType;
-  int add_var = 0;
-  NODE_INFO_STRUCT *nodeCol;
-  NODAL_VARS_STRUCT *nv, *nvCol;
-  int inode_varType[MaxVarPerNode], inode_matID[MaxVarPerNode];
-  int inter_node_varType[MaxVarPerNode], inter_node_matID[MaxVarPerNode];
+  int irow_index, len;
+  int *graph;
   int nnz = 0;
   int total_nodes = Num_Internal_Nodes + Num_Border_Nodes + Num_External_Nodes;
-  std::vector<int> Indices;
+  std::vector<goma_gid> Indices;
   std::vector<double> Values;
 
   int NumMyRows = num_internal_dofs + num_boundary_dofs;
@@ -88,7 +81,7 @@ void EpetraCreateGomaProblemGraph(struct Aztec_Linear_Solver_System *ams, Exo_DB
    *
    * Creates an array to be communicated of ints cast to double to use the exchange_dof
    * communicator, then casts doubles back to int and sets those as global ids
-   * for the epetra array
+   * for the epetra array (doubles hold 64 bit global ids exactly up to 2^53)
    *
    * TODO: replace with non-double conversion routine
    */
@@ -97,10 +90,14 @@ void EpetraCreateGomaProblemGraph(struct Aztec_Linear_Solver_System *ams, Exo_DB
   Epetra_Map RowMap = ams->RowMatrix->RowMatrixRowMap();
 
   // get the global elements for this processor
-  int *MyGlobalElements = RowMap.MyGlobalElements ();
+#ifdef GOMA_GLOBAL_INDEX_64
+  goma_gid *MyGlobalElements = RowMap.MyGlobalElements64 ();
+#else
+  goma_gid *MyGlobalElements = RowMap.MyGlobalElements ();
+#endif
 
   double *dblColGIDs = new double[NumMyCols];
-  ams->GlobalIDs = (int *) malloc(sizeof(int)*NumMyCols);
+  ams->GlobalIDs = (goma_gid *) malloc(sizeof(goma_gid)*NumMyCols);
 
   // copy global id's and convert to double for boundary exchange
   for( int i=0; i<NumMyRows; i++) dblColGIDs[i] = (double) MyGlobalElements[i];
@@ -109,130 +106,41 @@ void EpetraCreateGomaProblemGraph(struct Aztec_Linear_Solver_System *ams, Exo_DB
 
   // convert back to int with known global id's from all processors
   for (int j = 0; j < NumMyCols; j++) {
-    ams->GlobalIDs[j] = (int) dblColGIDs[j];
+    ams->GlobalIDs[j] = (goma_gid) dblColGIDs[j];
   }
 
   /*
-   * loop over all of the nodes on this processor
+   * The same graph as the MSR matrix, diagonal included; rows are the
+   * unknowns of all of the nodes on this processor
    */
-  for (inode = 0; inode < total_nodes; inode++) {
-    nv = Nodes[inode]->Nodal_Vars_Info;
-    /*
-     * Fill the vector list which points to the unknowns defined at this
-     * node...
-     */
-    row_num_unknowns = fill_variable_vector(inode, inode_varType, inode_matID);
-    /*
-     * Do a check against the number of unknowns at this
-     * node stored in the global array
-     */
-    if (row_num_unknowns != nv->Num_Unknowns) {
-      EH(-1, "Inconsistency counting unknowns.");
-    }
-
-    /*
-     * Loop over the unknowns defined at this row node
-     */
-    for (iunknown = 0; iunknown < row_num_unknowns; iunknown++) {
-      /*
-       * Retrieve the var type of the current unknown
-       */
-      rowVarType = inode_varType[iunknown];
-
-      Indices.clear();
-      Values.clear();
-
-      /*
-       * Loop over the nodes which are determined to have an interaction
-       * with the current row node
-       */
-      for (j = exo->node_node_pntr[inode]; j < exo->node_node_pntr[inode + 1];
-          j++) {
-        inter_node = exo->node_node_list[j];
-        nodeCol = Nodes[inter_node];
-        nvCol = nodeCol->Nodal_Vars_Info;
-
-        /*
-         * fill the vector list which points to the unknowns
-         * defined at this interaction node
-         */
-        col_num_unknowns = fill_variable_vector(inter_node, inter_node_varType,
-            inter_node_matID);
-        if (col_num_unknowns != nvCol->Num_Unknowns) {
-          EH(-1, "Inconsistency counting unknowns.");
-        }
-
-        /*
-         * Loop over the unknowns associated with the
-         * interacting node and see if there should be an interaction.
-         */
-
-        for (inter_unknown = 0; inter_unknown < col_num_unknowns;
-            inter_unknown++) {
-
-          /*
-           * HKM ->
-           *  The entire process below is designed to find out
-           *  what unknown we are processing. This coding is very
-           *  convoluted and fraught with pitfalls. It should
-           *  be rewritten using the structured approach in MPSalsa
-           *  to variable indentification.
-           */
-          colVarType = inter_node_varType[inter_unknown];
-
-          /*
-           * Query the Interaction mask to determine if a jacobian entry
-           * should be created
-           */
-          add_var = Inter_Mask[rowVarType][colVarType];
-
-          /* The following code should be activated when solving DG viscoelastic problems
-           * with full Jacobian treatment of upwind element stress terms
-           */
-          if (exo->centroid_list[inode] != -1 && inode != inter_node
-              && exo->centroid_list[inter_node] != -1) {
-            eb1 = exo->elem_eb[exo->centroid_list[inode]];
-
-            if (vn_glob[Matilda[eb1]]->dg_J_model == FULL_DG) {
-              i1 = pd_glob[Matilda[eb1]]->i[rowVarType];
-              i2 = pd_glob[Matilda[eb1]]->i[colVarType];
-
-              if ((rowVarType == colVarType)
-                  && (i1 == I_P0 || i1 == I_P1 || i1 == I_PQ1 || i1 == I_PQ2)
-                  && (i2 == I_P0 || i2 == I_P1 || i2 == I_PQ1 || i2 == I_PQ2)
-                  && (rowVarType != PRESSURE)
-                  && (rowVarType > VELOCITY_GRADIENT33
-                      || rowVarType < VELOCITY_GRADIENT11)) {
-                add_var = Inter_Mask[rowVarType][colVarType];
-              } else {
-                add_var = 0;
-              }
-            }
-          }
-
-          if (Debug_Flag < 0)
-            add_var = TRUE; /* add all vars for checking jacobian */
-
-          if (add_var) {
-            /*
-             * Determine the equation number of the current unknown
-             */
-            icol_index = nodeCol->First_Unknown + inter_unknown;
-            Indices.push_back(ams->GlobalIDs[icol_index]);
-            Values.push_back(0);
-          }
-        }
-      }
-      EpetraInsertGlobalRowMatrix(ams->RowMatrix, ams->GlobalIDs[irow_index], Indices.size(), &Values[0],
-          &Indices[0]);
-      nnz += Indices.size();
-      irow_index++;
+  graph = problem_graph_build(exo, total_nodes, FALSE, &len);
+
+  for (irow_index = 0; irow_index < graph[0] - 1; irow_index++) {
+    Indices.clear();
+    Values.clear();
+    for (int k = graph[irow_index]; k < graph[irow_index + 1]; k++) {
+      Indices.push_back(ams->GlobalIDs[graph[k]]);
+      Values.push_back(0);
     }
+    EpetraInsertGlobalRowMatrix(ams->RowMatrix, ams->GlobalIDs[irow_index], Indices.size(), &Values[0],
+        &Indices[0]);
+    nnz += Indices.size();
   }
+  safer_free((void **) &graph);
 
   EpetraFillCompleteRowMatrix(ams->RowMatrix);
   EpetraPutScalarRowMatrix(ams->RowMatrix, 0);
 
+  /*
+   * Local rows are already in row map order; the column map orders the
+   * external columns its own way, so keep where each goma dof went
+   */
+  const Epetra_Map &ColMap = ams->RowMatrix->RowMatrixColMap();
+  ams->ColumnLIDs = (int *) malloc(sizeof(int)*NumMyCols);
+  for (int j = 0; j < NumMyCols; j++) {
+    ams->ColumnLIDs[j] = ColMap.LID(ams->GlobalIDs[j]);
+  }
+
   /*
    * Add ams values that are needed elsewhere
    */
@@ -244,11 +152,11 @@ void EpetraCreateGomaProblemGraph(struct Aztec_Linear_Solver_System *ams, Exo_DB
 
   ams->npu = num_internal_dofs + num_boundary_dofs;
   ams->npu_plus = num_universe_dofs;
-  int total_unknowns = gsum_Int(num_internal_dofs + num_boundary_dofs);
+  goma_gid total_unknowns = gsum_Gid(num_internal_dofs + num_boundary_dofs);
 
   delete[] dblColGIDs;
 
-  DPRINTF(stderr, "\n%-30s= %d\n", "Number of unknowns", total_unknowns);
+  DPRINTF(stderr, "\n%-30s= %lld\n", "Number of unknowns", (long long) total_unknowns);
   DPRINTF(stderr, "\n%-30s= %d\n", "Number of matrix nonzeroes", nnz);
 }
 
@@ -257,6 +165,9 @@ void EpetraCreateGomaProblemGraph(struct Aztec_Linear_Solver_System *ams, Exo_DB
  *
  * Modified from MSR version in mm_fill load_lec
  *
+ * Rows and columns go in by local id (ams->ColumnLIDs), which skips the
+ * global id hash lookups for every entry
+ *
  * @param exo ptr to EXODUS II finite element mesh db
  * @param ielem Element number we are working on
  * @param ams Matrix contianer
@@ -272,6 +183,7 @@ void EpetraLoadLec(Exo_DB *exo, int ielem, struct Aztec_Linear_Solver_System *am
   int col_index, ledof;
   int je_new;
   struct Element_Indices *ei_ptr;
+  /* per call, assembly threads load their elements concurrently */
   std::vector<int> Indices;
   std::vector<double> Values;
 
@@ -322,7 +234,7 @@ void EpetraLoadLec(Exo_DB *exo, int ielem, struct Aztec_Linear_Solver_System *am
                               kv, ei_ptr->Baby_Dolphin[v][j],
                               ei_ptr->matID_ledof[ledof]);
                           EH(col_index, "Bad var index.");
-                          Indices.push_back(ams->GlobalIDs[col_index]);
+                          Indices.push_back(ams->ColumnLIDs[col_index]);
                           Values.push_back(lec->J[LEC_J_INDEX(pe,pv,i,j)]);
                         }
                       }
@@ -342,13 +254,13 @@ void EpetraLoadLec(Exo_DB *exo, int ielem, struct Aztec_Linear_Solver_System *am
                           EH(-1, "LEC Indexing error");
                         }
                         EH(col_index, "Bad var index.");
-                        Indices.push_back(ams->GlobalIDs[col_index]);
+                        Indices.push_back(ams->ColumnLIDs[col_index]);
                         Values.push_back(lec->J[LEC_J_INDEX(pe,pv,i,j)]);
                       }
                     }
                   }
                 }
-                EpetraSumIntoGlobalRowMatrix(ams->RowMatrix, ams->GlobalIDs[row_index],
+                EpetraSumIntoMyRowMatrix(ams->RowMatrix, row_index,
                     Indices.size(), &Values[0], &Indices[0]);
                 Indices.clear();
                 Values.clear();
@@ -407,7 +319,7 @@ void EpetraLoadLec(Exo_DB *exo, int ielem, struct Aztec_Linear_Solver_System *am
                           }
                         }
                         EH(col_index, "Bad var index.");
-                        Indices.push_back(ams->GlobalIDs[col_index]);
+                        Indices.push_back(ams->ColumnLIDs[col_index]);
                         Values.push_back(lec->J[LEC_J_INDEX(pe,pv,i,j)]);
                       }
                     }
@@ -437,13 +349,13 @@ void EpetraLoadLec(Exo_DB *exo, int ielem, struct Aztec_Linear_Solver_System *am
                         EH(-1, "LEC Indexing error");
                       }
                       EH(col_index, "Bad var index.");
-                      Indices.push_back(ams->GlobalIDs[col_index]);
+                      Indices.push_back(ams->ColumnLIDs[col_index]);
                       Values.push_back(lec->J[LEC_J_INDEX(pe,pv,i,j)]);
                     }
                   }
                 }
               }
-              EpetraSumIntoGlobalRowMatrix(ams->RowMatrix, ams->GlobalIDs[row_index], Indices.size(),
+              EpetraSumIntoMyRowMatrix(ams->RowMatrix, row_index, Indices.size(),
                   &Values[0], &Indices[0]);
               Indices.clear();
               Values.clear();
@@ -480,12 +392,12 @@ void EpetraRowSumScale(struct Aztec_Linear_Solver_System *ams, double *b, double
  * @param ams Aztec_Linear_Solver_System matrix struct containing epetra matrix
  * @param GlobalRow global row to set to diagonal only
  */
-void EpetraSetDiagonalOnly(struct Aztec_Linear_Solver_System *ams, int GlobalRow)
+void EpetraSetDiagonalOnly(struct Aztec_Linear_Solver_System *ams, goma_gid GlobalRow)
 {
   Epetra_CrsMatrix* CrsMatrix = dynamic_cast<Epetra_CrsMatrix*>(ams->RowMatrix);
   int size = CrsMatrix->NumGlobalEntries(GlobalRow);
   double *values = new double[size];
-  int *indices = new int[size];
+  goma_gid *indices = new goma_gid[size];
   int NumEntries;
   CrsMatrix->ExtractGlobalRowCopy(GlobalRow, size, NumEntries, values, indices);
   for (int i = 0; i < NumEntries; i++) {
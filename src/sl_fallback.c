@@ -0,0 +1,285 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * Fallback chain of stronger linear solvers (Linear Solver Fallback card).
+ *
+ * When an Aztec solve of an msr matrix fails, the same matrix and right
+ * hand side are solved again, within the same Newton iteration, with each
+ * level of the chain in turn until one converges: gmres with ilu(k) or
+ * ilut subdomains, exact lu subdomains, or a direct Amesos solve. The
+ * options of the deck (or of Linear Solver Autotune) are put back for the
+ * next solve. When the first level tried has failed on FALLBACK_PROMOTE
+ * solves in a row, later solves start from the lowest level that got
+ * those through, for the rest of the run.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "std.h"
+#include "rf_allo.h"
+#include "rf_fem_const.h"
+#include "rf_fem.h"
+#include "rf_mp.h"
+#include "rf_io_const.h"
+#include "rf_io.h"
+#include "rf_solver.h"
+#include "mm_eh.h"
+#include "sl_util_structs.h"
+#include "sl_amesos_interface.h"
+
+#ifdef PARALLEL
+#ifndef MPI
+#define MPI			/* otherwise az_aztec.h trounces MPI_Request */
+#endif
+#endif
+
+#include "az_aztec.h"
+
+#define _SL_FALLBACK_C
+#include "goma.h"
+
+#define FALLBACK_PROMOTE 3
+
+int Num_Fallback_Levels = 0;
+int Fallback_Type[MAX_FALLBACK_LEVELS];
+dbl Fallback_Fill[MAX_FALLBACK_LEVELS];
+
+/* level 0 is the deck's own options, level l > 0 is Fallback_Type[l-1] */
+static int Start_Level = 0;
+static int Tries[MAX_FALLBACK_LEVELS + 1];
+static int Successes[MAX_FALLBACK_LEVELS + 1];
+static int Failed_Run = 0;	/* solves in a row the start level failed */
+static int Run_Level = 0;	/* lowest level that got them through */
+static int Force_Calc = FALSE;	/* the preconditioner was freed */
+
+static int Base_Options[AZ_OPTIONS_SIZE];
+static double Base_Params[AZ_PARAMS_SIZE];
+static double *Val_Save = NULL, *Rhs_Save = NULL;
+static int Val_Size = 0, Rhs_Size = 0;
+
+static void
+fallback_name(const int level,
+	      char *name)
+{
+  int t;
+
+  if (level == 0) {
+    strcpy(name, "deck");
+    return;
+  }
+  t = level - 1;
+  switch (Fallback_Type[t]) {
+  case FALLBACK_ILU:
+    sprintf(name, "gmres ilu(%d)", (int) Fallback_Fill[t]);
+    break;
+  case FALLBACK_ILUT:
+    sprintf(name, "gmres ilut %g", Fallback_Fill[t]);
+    break;
+  case FALLBACK_LU:
+    strcpy(name, "gmres lu");
+    break;
+  case FALLBACK_AMESOS:
+    sprintf(name, "amesos %s", Amesos_Package);
+    break;
+  default:
+    strcpy(name, "?");
+  }
+}
+
+/* the base options with level laid over them */
+static void
+fallback_options(const int level,
+		 int options[],
+		 double params[])
+{
+  int t;
+
+  memcpy(options, Base_Options, AZ_OPTIONS_SIZE * sizeof(int));
+  memcpy(params, Base_Params, AZ_PARAMS_SIZE * sizeof(double));
+  if (level == 0) return;
+
+  t = level - 1;
+  if (Fallback_Type[t] == FALLBACK_AMESOS) return;
+  options[AZ_solver] = AZ_gmres;
+  options[AZ_precond] = AZ_dom_decomp;
+  options[AZ_graph_fill] = 0;
+  switch (Fallback_Type[t]) {
+  case FALLBACK_ILU:
+    options[AZ_subdomain_solve] = AZ_ilu;
+    options[AZ_graph_fill] = (int) Fallback_Fill[t];
+    break;
+  case FALLBACK_ILUT:
+    options[AZ_subdomain_solve] = AZ_ilut;
+    params[AZ_ilut_fill] = Fallback_Fill[t];
+    params[AZ_drop] = 0.;
+    break;
+  case FALLBACK_LU:
+    options[AZ_subdomain_solve] = AZ_lu;
+    break;
+  }
+}
+
+int
+linear_fallback_begin(struct Aztec_Linear_Solver_System *ams,
+		      double resid_vector[])
+
+    /*************************************************************************
+     *
+     * linear_fallback_begin():
+     *
+     *  Just before the first attempt at ams: keep its matrix, right hand
+     *  side and options for the fallback levels and set the options of
+     *  the level to start from. Returns the number of attempts the chain
+     *  allows, 1 if there is no chain.
+     *************************************************************************/
+{
+  int nnz, n;
+
+  if (Num_Fallback_Levels == 0 || strcmp(Matrix_Format, "msr") != 0) return 1;
+
+  n = ams->npu;
+  nnz = ams->bindx[ams->npu];
+  if (nnz > Val_Size) {
+    safe_free(Val_Save);
+    Val_Save = alloc_dbl_1(nnz, 0.);
+    Val_Size = nnz;
+  }
+  if (n > Rhs_Size) {
+    safe_free(Rhs_Save);
+    Rhs_Save = alloc_dbl_1(n, 0.);
+    Rhs_Size = n;
+  }
+  memcpy(Val_Save, ams->val, nnz * sizeof(double));
+  memcpy(Rhs_Save, resid_vector, n * sizeof(double));
+
+  memcpy(Base_Options, ams->options, AZ_OPTIONS_SIZE * sizeof(int));
+  memcpy(Base_Params, ams->params, AZ_PARAMS_SIZE * sizeof(double));
+
+  if (Start_Level > 0) {
+    int pre_calc = ams->options[AZ_pre_calc];
+    fallback_options(Start_Level, ams->options, ams->params);
+    ams->options[AZ_pre_calc] = pre_calc;
+  }
+  if (Force_Calc) {
+    ams->options[AZ_pre_calc] = AZ_calc;
+    Force_Calc = FALSE;
+  }
+  Tries[Start_Level]++;
+
+  return 1 + Num_Fallback_Levels - Start_Level;
+}
+
+int
+linear_fallback_next(struct Aztec_Linear_Solver_System *ams,
+		     const int attempt,
+		     double delta_x[],
+		     double resid_vector[])
+
+    /*************************************************************************
+     *
+     * linear_fallback_next():
+     *
+     *  After attempt - 1 failed: put back the matrix and right hand side
+     *  and set up the next level, to calculate its preconditioner afresh.
+     *  An Amesos level is solved here, and TRUE returned, with the Aztec
+     *  status set as if Aztec had solved it.
+     *************************************************************************/
+{
+  int level = Start_Level + attempt;
+  char name[40];
+
+  memcpy(ams->val, Val_Save, ams->bindx[ams->npu] * sizeof(double));
+  memcpy(resid_vector, Rhs_Save, ams->npu * sizeof(double));
+  memset(delta_x, 0, ams->npu_plus * sizeof(double));
+
+  fallback_options(level, ams->options, ams->params);
+  AZ_free_memory(ams->data_org[AZ_name]);
+  ams->options[AZ_pre_calc] = AZ_calc;
+  Force_Calc = TRUE;
+  Tries[level]++;
+
+  fallback_name(level, name);
+  DPRINTF(stdout, "\n  linear solve failed, trying %s\n", name);
+
+  if (Fallback_Type[level - 1] == FALLBACK_AMESOS) {
+    amesos_solve_msr(Amesos_Package, ams, delta_x, resid_vector, 1);
+    ams->status[AZ_why] = AZ_normal;
+    ams->status[AZ_its] = 1;
+    return TRUE;
+  }
+  return FALSE;
+}
+
+void
+linear_fallback_end(struct Aztec_Linear_Solver_System *ams,
+		    const int attempts,
+		    const int solved)
+
+    /*************************************************************************
+     *
+     * linear_fallback_end():
+     *
+     *  After the last attempt at ams: count it, move the start level up
+     *  if it keeps failing, and put the base options back for the next
+     *  solve.
+     *************************************************************************/
+{
+  int level = Start_Level + attempts - 1;
+  char name[40];
+
+  if (Num_Fallback_Levels == 0 || strcmp(Matrix_Format, "msr") != 0) return;
+
+  if (solved) Successes[level]++;
+
+  if (attempts == 1) {
+    if (solved) Failed_Run = 0;
+  } else if (solved) {
+    if (Failed_Run == 0 || level < Run_Level) Run_Level = level;
+    Failed_Run++;
+    if (Failed_Run >= FALLBACK_PROMOTE) {
+      Start_Level = Run_Level;
+      Failed_Run = 0;
+      fallback_name(Start_Level, name);
+      DPRINTF(stdout, "\nLinear Solver Fallback: starting from %s from now on\n",
+	      name);
+    }
+  }
+
+  fallback_options(0, ams->options, ams->params);
+}
+
+void
+linear_fallback_report(void)
+{
+  int l;
+  char name[40];
+
+  if (Num_Fallback_Levels == 0) return;
+
+  DPRINTF(stdout, "\nLinear Solver Fallback:\n");
+  DPRINTF(stdout, "  %-18s %8s %8s\n", "level", "tries", "solved");
+  for (l = 0; l <= Num_Fallback_Levels; l++) {
+    fallback_name(l, name);
+    DPRINTF(stdout, "  %-18s %8d %8d%s\n", name, Tries[l], Successes[l],
+	    l == Start_Level ? "  (start)" : "");
+  }
+  safe_free(Val_Save);
+  safe_free(Rhs_Save);
+  Val_Save = Rhs_Save = NULL;
+  Val_Size = Rhs_Size = 0;
+}
+/*****************************************************************************/
+/* END of file sl_fallback.c */
+/*****************************************************************************/
@@ -0,0 +1,292 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * Dump and replay of the linear systems handed to the solver.
+ *
+ * matrix_replay_dump() writes this processor's MSR system as the solver
+ * is about to see it (row sum scaled, when that is on) in native binary:
+ * a header, bindx, val, the right hand side, and for each dof its
+ * variable type, local nodal dof and global node, then the node
+ * coordinates. There is one file per processor, <file>.<ProcID> when
+ * in parallel.
+ *
+ * With a Matrix Replay File, solve_nonlinear_problem() loads such a
+ * system in place of the first assembly, solves it with the solver the
+ * input deck asks for, prints the times and stops. The deck, mesh and
+ * decomposition must be the ones the dump was made with; only the solver
+ * cards are meant to change between replays.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+#include "std.h"
+#include "rf_allo.h"
+#include "rf_fem_const.h"
+#include "rf_fem.h"
+#include "rf_mp.h"
+#include "rf_io_const.h"
+#include "rf_io.h"
+#include "rf_solver.h"
+#include "mm_eh.h"
+#include "sl_util_structs.h"
+
+#define _SL_MATRIX_REPLAY_C
+#include "goma.h"
+
+#define REPLAY_MAGIC   "GOMAMSR"
+#define REPLAY_VERSION 1
+
+struct replay_header {
+  char magic[8];
+  int version;
+  int one;			/* 1, to catch a byte order change */
+  int proc;
+  int num_proc;
+  int npu;			/* owned rows */
+  int npu_plus;			/* owned and external dofs */
+  int bindx_len;		/* bindx[npu] */
+  int num_dim;
+  int num_nodes;
+};
+
+char Matrix_Replay_Dump_File[MAX_FNL] = "";
+int Matrix_Replay_Dump_Count = 1;
+char Matrix_Replay_File[MAX_FNL] = "";
+
+static void
+replay_file_name(const char *base, char *fname)
+{
+  if (Num_Proc > 1) {
+    sprintf(fname, "%s.%d", base, ProcID);
+  } else {
+    strcpy(fname, base);
+  }
+}
+
+static int
+replay_write(const void *buf, const size_t size, const size_t n, FILE *fp)
+{
+  if (n == 0) return 0;
+  return (fwrite(buf, size, n, fp) == n) ? 0 : -1;
+}
+
+static int
+replay_read(void *buf, const size_t size, const size_t n, FILE *fp)
+{
+  if (n == 0) return 0;
+  return (fread(buf, size, n, fp) == n) ? 0 : -1;
+}
+
+/*****************************************************************************/
+/*****************************************************************************/
+/*****************************************************************************/
+
+void
+matrix_replay_dump(struct Aztec_Linear_Solver_System *ams,
+		   Exo_DB *exo,
+		   Dpi *dpi,
+		   double resid_vector[])
+
+    /*************************************************************************
+     *
+     * matrix_replay_dump():
+     *
+     *  Write the system about to be solved to the Matrix Replay Dump file
+     *  when this is the Matrix_Replay_Dump_Count'th call; otherwise do
+     *  nothing.
+     *************************************************************************/
+{
+  static int count = 0;
+  struct replay_header h;
+  char fname[MAX_FNL + 16];
+  dbl *coord[3], start;
+  int *iv, i, d, err = 0;
+  FILE *fp;
+
+  if (Matrix_Replay_Dump_File[0] == '\0') return;
+  if (++count != Matrix_Replay_Dump_Count) return;
+
+  if (strcmp(Matrix_Format, "msr") != 0 || Linear_Solver == FRONT) {
+    WH(-1, "Matrix Replay Dump needs the msr matrix format, nothing dumped");
+    return;
+  }
+
+  start = ut();
+  replay_file_name(Matrix_Replay_Dump_File, fname);
+  if ((fp = fopen(fname, "wb")) == NULL) {
+    WH(-1, "Could not open the Matrix Replay Dump file, nothing dumped");
+    return;
+  }
+
+  memset(&h, 0, sizeof(h));
+  strcpy(h.magic, REPLAY_MAGIC);
+  h.version   = REPLAY_VERSION;
+  h.one       = 1;
+  h.proc      = ProcID;
+  h.num_proc  = Num_Proc;
+  h.npu       = ams->npu;
+  h.npu_plus  = ams->npu_plus;
+  h.bindx_len = ams->bindx[ams->npu];
+  h.num_dim   = exo->num_dim;
+  h.num_nodes = exo->num_nodes;
+
+  err |= replay_write(&h, sizeof(h), 1, fp);
+  err |= replay_write(ams->bindx, sizeof(int), h.bindx_len, fp);
+  err |= replay_write(ams->val, sizeof(double), h.bindx_len, fp);
+  err |= replay_write(resid_vector, sizeof(double), h.npu, fp);
+
+  /* variable type, local nodal dof and global node of each dof */
+  iv = alloc_int_1(3 * MAX(h.npu_plus, 1), -1);
+  for (i = 0; i < h.npu_plus; i++) {
+    iv[3*i]   = idv[i][0];
+    iv[3*i+1] = idv[i][1];
+    iv[3*i+2] = dpi->node_index_global[idv[i][2]];
+  }
+  err |= replay_write(iv, sizeof(int), 3 * h.npu_plus, fp);
+  safe_free(iv);
+
+  coord[0] = exo->x_coord;
+  coord[1] = exo->y_coord;
+  coord[2] = exo->z_coord;
+  for (d = 0; d < h.num_dim; d++) {
+    err |= replay_write(coord[d], sizeof(double), h.num_nodes, fp);
+  }
+
+  if (fclose(fp) != 0) err = -1;
+  if (err) {
+    WH(-1, "Error writing the Matrix Replay Dump file");
+    return;
+  }
+  DPRINTF(stdout, "Matrix Replay Dump: system %d written to %s in %g s\n",
+	  count, Matrix_Replay_Dump_File, ut() - start);
+}
+
+/*****************************************************************************/
+
+int
+matrix_replay_load(struct Aztec_Linear_Solver_System *ams,
+		   double resid_vector[])
+
+    /*************************************************************************
+     *
+     * matrix_replay_load():
+     *
+     *  Read the Matrix Replay File into ams->val and resid_vector. The
+     *  file must hold a system of exactly the structure of ams, written
+     *  by the same processor of the same decomposition.
+     *
+     *  Return: 0 on success, -1 otherwise (with a message)
+     *************************************************************************/
+{
+  struct replay_header h;
+  char fname[MAX_FNL + 16];
+  int *bindx = NULL;
+  FILE *fp;
+  int i, err = 0;
+
+  if (strcmp(Matrix_Format, "msr") != 0 || Linear_Solver == FRONT) {
+    EH(-1, "Matrix Replay File needs the msr matrix format");
+    return -1;
+  }
+
+  replay_file_name(Matrix_Replay_File, fname);
+  if ((fp = fopen(fname, "rb")) == NULL) {
+    EH(-1, "Could not open the Matrix Replay File");
+    return -1;
+  }
+
+  if (replay_read(&h, sizeof(h), 1, fp) ||
+      strcmp(h.magic, REPLAY_MAGIC) != 0 || h.one != 1 ||
+      h.version != REPLAY_VERSION) {
+    fclose(fp);
+    EH(-1, "The Matrix Replay File is not a matrix dump of this machine");
+    return -1;
+  }
+  if (h.proc != ProcID || h.num_proc != Num_Proc || h.npu != ams->npu ||
+      h.bindx_len != ams->bindx[ams->npu]) {
+    fclose(fp);
+    EH(-1, "The Matrix Replay File does not match this problem and decomposition");
+    return -1;
+  }
+
+  bindx = alloc_int_1(h.bindx_len, 0);
+  err |= replay_read(bindx, sizeof(int), h.bindx_len, fp);
+  for (i = 0; i < h.bindx_len && !err; i++) {
+    if (bindx[i] != ams->bindx[i]) err = 1;
+  }
+  safe_free(bindx);
+  if (err) {
+    fclose(fp);
+    EH(-1, "The Matrix Replay File has a different sparsity pattern");
+    return -1;
+  }
+
+  err |= replay_read(ams->val, sizeof(double), h.bindx_len, fp);
+  err |= replay_read(resid_vector, sizeof(double), h.npu, fp);
+  fclose(fp);
+  if (err) {
+    EH(-1, "Error reading the Matrix Replay File");
+    return -1;
+  }
+  return 0;
+}
+
+/*****************************************************************************/
+
+void
+matrix_replay_report(const dbl wall,
+		     const dbl cpu,
+		     const int krylov_its)
+
+    /*************************************************************************
+     *
+     * matrix_replay_report():
+     *
+     *  Print the cost of the replayed solve: the wall and CPU seconds,
+     *  the largest over the processors, the Krylov iterations (-1 for a
+     *  direct solve) and the largest maximum resident size.
+     *************************************************************************/
+{
+  struct rusage ru;
+  dbl t[3], tmax[3];
+
+  t[0] = wall;
+  t[1] = cpu;
+  t[2] = (getrusage(RUSAGE_SELF, &ru) == 0) ? (dbl) ru.ru_maxrss : 0.;
+  tmax[0] = t[0];
+  tmax[1] = t[1];
+  tmax[2] = t[2];
+#ifdef PARALLEL
+  if (Num_Proc > 1) {
+    MPI_Reduce(t, tmax, 3, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+  }
+#endif
+
+  if (ProcID != 0) return;
+  fprintf(stdout, "\nMatrix Replay of %s on %d processors:\n",
+	  Matrix_Replay_File, Num_Proc);
+  fprintf(stdout, "  linear solve wall s   %.6e\n", tmax[0]);
+  fprintf(stdout, "  linear solve CPU s    %.6e\n", tmax[1]);
+  if (krylov_its >= 0) {
+    fprintf(stdout, "  Krylov iterations     %d\n", krylov_its);
+  }
+  fprintf(stdout, "  max resident KB       %.0f\n", tmax[2]);
+  fflush(stdout);
+}
+/*****************************************************************************/
+/* END of file sl_matrix_replay.c */
+/*****************************************************************************/
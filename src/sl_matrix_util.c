@@ -61,10 +61,10 @@ canine_chaos(int local_order,					      /* (in) */
 	     int local_order_plus,      /* order including external rows (in) */
 	     int local_nnz,			  /* number of nonzeroes (in) */
 	     int local_nnz_plus,              /* including external rows (in) */
-	     int *global_order,			      /* the real order (out) */
-	     int *global_order_plus,      /* overcounting external rows (out) */
-	     int *global_nnz,			    /* the strict count (out) */
-	     int *global_nnz_plus)        /* overcounting external rows (out) */
+	     goma_gid *global_order,		 /* the real order (out) */
+	     goma_gid *global_order_plus, /* overcounting external rows (out) */
+	     goma_gid *global_nnz,		   /* the strict count (out) */
+	     goma_gid *global_nnz_plus)   /* overcounting external rows (out) */
 {
 
   /*
@@ -82,14 +82,10 @@ canine_chaos(int local_order,					      /* (in) */
    */
 
 #ifdef PARALLEL
-      MPI_Allreduce(&local_order, global_order, 
-		    1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
-      MPI_Allreduce(&local_order_plus, global_order_plus, 
-		    1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
-      MPI_Allreduce(&local_nnz, global_nnz,
-		    1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
-      MPI_Allreduce(&local_nnz_plus, global_nnz_plus,
-		    1, MPI_INT, MPI_SUM, MPI_COMM_WORLD);
+      *global_order      = gsum_Gid(*global_order);
+      *global_order_plus = gsum_Gid(*global_order_plus);
+      *global_nnz        = gsum_Gid(*global_nnz);
+      *global_nnz_plus   = gsum_Gid(*global_nnz_plus);
 #endif  
 
   return;
@@ -25,48 +25,386 @@
 #include "sl_stratimikos_interface.h"
 
 #include "Thyra_SolveSupportTypes.hpp"
+#include "Thyra_DefaultPreconditioner.hpp"
 #include "EpetraExt_RowMatrixOut.h"
 #include "EpetraExt_VectorOut.h"
+#include "Ifpack_BlockRelaxation.h"
+#include "Ifpack_DenseContainer.h"
 
+#ifdef HAVE_TEKO
+#include "Teko_InverseLibrary.hpp"
+#include "Teko_InverseFactory.hpp"
+#include "Teko_PreconditionerInverseFactory.hpp"
+#include "Teko_BlockedEpetraOperator.hpp"
+#include "Teko_EpetraBlockPreconditioner.hpp"
+#include "Teko_StratimikosFactory.hpp"
+#endif
+
+#include <algorithm>
+#include <sstream>
+#include <string>
+#include <vector>
 
 extern "C" {
+#include "std.h"
+#include "rf_fem_const.h"
+#include "rf_bc_const.h"
+#include "rf_allo.h"
+#include "mm_eh.h"
 
-int stratimikos_solve(struct Aztec_Linear_Solver_System *ams, double *x_,
-    double *b_, int *iterations, char *stratimikos_file)
+/* mm_unknown_map.c */
+extern int var_type_dof_sets(const int, int **, int **, int **);
+extern int node_dof_blocks(const int, int **);
+extern int near_null_space(const int, double **);
+
+/* globals.c */
+extern int Krylov_Recycle;
+extern int Krylov_Guess;
+}
+
+/*
+ * State carried from one Newton solve to the next.
+ *
+ * With Krylov_Recycle the solver factory and the solver built for the
+ * first Newton solve are kept and only reinitialized with each new
+ * matrix, so that a recycling Belos solver ("GCRODR" in the stratimikos
+ * file, with "Num Recycled Blocks") keeps its deflation space.
+ *
+ * With Krylov_Guess the updates of the last two time steps are kept for
+ * each Newton iteration and the next update is extrapolated linearly in
+ * time from them, then used as the initial guess if its residual is
+ * smaller than that of zero.
+ */
+static int Next_Newton = -1;		/* set by stratimikos_next_solve() */
+static double Next_Dt = 0.;
+
+static Teuchos::RCP<Thyra::LinearOpWithSolveFactoryBase<double> > Recycle_Factory;
+static Teuchos::RCP<Thyra::LinearOpWithSolveBase<double> > Recycle_Solver;
+static Teuchos::RCP<Teuchos::ParameterList> Recycle_Block_Params;
+static Teuchos::RCP<Teuchos::ParameterList> Recycle_Point_Params;
+
+/*
+ * The solver of the last solve and its matrix, so that further right
+ * hand sides with that matrix (those of the augmenting conditions) reuse
+ * its preconditioner.
+ */
+static Teuchos::RCP<Thyra::LinearOpWithSolveBase<double> > Last_Solver;
+static Epetra_RowMatrix *Last_Matrix = NULL;
+
+struct newton_guess_history {
+  std::vector<double> d[2];		/* updates, latest first */
+  double dt[2];				/* time steps they were taken with */
+  int n;
+};
+static std::vector<newton_guess_history> Guess_History;
+
+static void
+newton_guess(const Epetra_RowMatrix &A, Epetra_Vector &x,
+             const Epetra_Vector &b, const int newton, const double dt)
+{
+  if (newton >= (int) Guess_History.size()) return;
+  const newton_guess_history &h = Guess_History[newton];
+  const int n = x.MyLength();
+  if (h.n == 0 || (int) h.d[0].size() != n) return;
+
+  double r = 0.;
+  if (h.n > 1 && dt > 0. && h.dt[0] > 0.) r = dt / h.dt[0];
+
+  Epetra_Vector x0(x.Map()), res(b.Map());
+  for (int i = 0; i < n; i++) {
+    x0[i] = (r > 0.) ? (1. + r) * h.d[0][i] - r * h.d[1][i] : h.d[0][i];
+  }
+  A.Multiply(false, x0, res);
+  res.Update(1., b, -1.);
+
+  double bnorm, rnorm;
+  b.Norm2(&bnorm);
+  res.Norm2(&rnorm);
+  if (rnorm < bnorm) x.Update(1., x0, 0.);
+}
+
+static void
+newton_guess_record(const double *x, const int n, const int newton,
+                    const double dt)
+{
+  if (newton >= (int) Guess_History.size()) {
+    newton_guess_history empty;
+    empty.dt[0] = empty.dt[1] = 0.;
+    empty.n = 0;
+    Guess_History.resize(newton + 1, empty);
+  }
+  newton_guess_history &h = Guess_History[newton];
+  h.d[1].swap(h.d[0]);
+  h.d[0].assign(x, x + n);
+  h.dt[1] = h.dt[0];
+  h.dt[0] = dt;
+  h.n = std::min(h.n + 1, 2);
+}
+
+#ifdef HAVE_TEKO
+/*
+ * Field-split preconditioning.
+ *
+ * If the stratimikos file has a "Goma Block Preconditioner" sublist, the
+ * unknowns are split into blocks by variable type and a Teko block
+ * preconditioner (SIMPLE, LSC, block Gauss-Seidel, ...) is built for the
+ * solve, e.g.
+ *
+ *  <ParameterList name="Goma Block Preconditioner">
+ *    <Parameter name="Blocks" type="Array(string)"
+ *               value="{VELOCITY1 VELOCITY2 VELOCITY3, PRESSURE}"/>
+ *    <Parameter name="Inverse Type" type="string" value="SIMPLE"/>
+ *    <ParameterList name="Inverse Factory Library">
+ *      ... Teko inverse definitions, including "SIMPLE" ...
+ *    </ParameterList>
+ *  </ParameterList>
+ *
+ * Each entry of "Blocks" is a list of variable names (Var_Name[] long or
+ * short names); unknowns of any variable not listed form one last block.
+ * The Stratimikos linear solver should then use "Preconditioner Type" =
+ * "None", the block preconditioner is handed to it directly.
+ */
+static int
+var_name_to_type(const std::string &name)
+{
+  for (int v = 0; v < Num_Var_Names; v++) {
+    if (name == Var_Name[v].name1 || name == Var_Name[v].name2) {
+      return Var_Name[v].Index;
+    }
+  }
+  return -1;
+}
+
+static Teuchos::RCP<const Thyra::PreconditionerBase<double> >
+build_block_preconditioner(Teuchos::ParameterList &blockParams,
+                           const Teuchos::RCP<Epetra_RowMatrix> &epetra_A,
+                           const Teuchos::RCP<const Thyra::LinearOpBase<double> > &A)
 {
   using Teuchos::RCP;
-  bool success = true;
-  bool verbose = true;
-  try {
-    Epetra_Map map = ams->RowMatrix->RowMatrixRowMap();
+  using Teuchos::rcp;
 
-    // Assign A with false so it doesn't get garbage collected.
-    RCP<Epetra_RowMatrix> epetra_A = Teuchos::rcp(ams->RowMatrix, false);
-    RCP<Epetra_Vector> epetra_x = Teuchos::rcp(
-        new Epetra_Vector(Copy, map, x_));
-    RCP<Epetra_Vector> epetra_b = Teuchos::rcp(
-        new Epetra_Vector(Copy, map, b_));
+  const Epetra_Map &map = epetra_A->RowMatrixRowMap();
+  int num_rows = map.NumMyElements();
 
-    RCP<const Thyra::LinearOpBase<double> > A = Thyra::epetraLinearOp(epetra_A);
-    RCP<Thyra::VectorBase<double> > x = Thyra::create_Vector(epetra_x,
-        A->domain());
-    RCP<const Thyra::VectorBase<double> > b = Thyra::create_Vector(epetra_b,
-        A->range());
+  Teuchos::Array<std::string> blocks =
+      blockParams.get<Teuchos::Array<std::string> >("Blocks");
+  std::string inverse_type = blockParams.get<std::string>("Inverse Type");
+
+  /* which block each variable type goes to */
+  int num_blocks = blocks.size();
+  std::vector<int> block_of_var(MAX_VARIABLE_TYPES, -1);
+  for (int b = 0; b < (int) blocks.size(); b++) {
+    std::istringstream names(blocks[b]);
+    std::string name;
+    while (names >> name) {
+      int v = var_name_to_type(name);
+      if (v < 0) {
+        EH(-1, "Unknown variable name in Goma Block Preconditioner Blocks");
+      }
+      block_of_var[v] = b;
+    }
+  }
+
+  int *set_var = NULL, *set_ptr = NULL, *set_list = NULL;
+  int num_sets = var_type_dof_sets(num_rows, &set_var, &set_ptr, &set_list);
+
+  bool need_rest = false;
+  for (int s = 0; s < num_sets; s++) {
+    if (block_of_var[set_var[s]] < 0) need_rest = true;
+  }
+  if (need_rest) num_blocks++;
+
+  std::vector<std::vector<int> > gids(num_blocks);
+  for (int s = 0; s < num_sets; s++) {
+    int b = block_of_var[set_var[s]];
+    if (b < 0) b = num_blocks - 1;
+    for (int k = set_ptr[s]; k < set_ptr[s+1]; k++) {
+      gids[b].push_back(map.GID(set_list[k]));
+    }
+  }
+  safer_free((void **) &set_var);
+  safer_free((void **) &set_ptr);
+  safer_free((void **) &set_list);
+
+  RCP<Teko::InverseLibrary> invLib = Teko::InverseLibrary::buildFromParameterList(
+      blockParams.sublist("Inverse Factory Library"));
+  RCP<Teko::InverseFactory> inverse = invLib->getInverseFactory(inverse_type);
+  RCP<Teko::PreconditionerInverseFactory> precInverse =
+      Teuchos::rcp_dynamic_cast<Teko::PreconditionerInverseFactory>(inverse);
+  if (precInverse.is_null()) {
+    EH(-1, "Goma Block Preconditioner Inverse Type must be a Teko block preconditioner");
+  }
+
+  RCP<Teko::Epetra::BlockedEpetraOperator> blocked_A =
+      rcp(new Teko::Epetra::BlockedEpetraOperator(gids, epetra_A));
+  RCP<Teko::Epetra::EpetraBlockPreconditioner> prec =
+      rcp(new Teko::Epetra::EpetraBlockPreconditioner(precInverse->getPrecFactory()));
+  prec->buildPreconditioner(blocked_A);
+
+  /* Teko applies the preconditioner through ApplyInverse() */
+  RCP<const Thyra::LinearOpBase<double> > precOp =
+      Thyra::epetraLinearOp(prec, Thyra::NOTRANS,
+                            Thyra::EPETRA_OP_APPLY_APPLY_INVERSE,
+                            Thyra::EPETRA_OP_ADJOINT_UNSUPPORTED,
+                            A->domain(), A->range());
+  return Thyra::unspecifiedPrec<double>(precOp);
+}
+#endif /* HAVE_TEKO */
 
-    Teuchos::RCP<Teuchos::FancyOStream> outstream =
-        Teuchos::VerboseObjectBase::getDefaultOStream();
+/*
+ * Point-block preconditioning.
+ *
+ * If the stratimikos file has a "Goma Point Block Preconditioner"
+ * sublist, all unknowns of a node form one dense block, which is
+ * factored exactly, and the blocks are applied by Ifpack block
+ * relaxation, e.g.
+ *
+ *  <ParameterList name="Goma Point Block Preconditioner">
+ *    <Parameter name="Type" type="string" value="symmetric Gauss-Seidel"/>
+ *    <Parameter name="Sweeps" type="int" value="2"/>
+ *    <Parameter name="Damping Factor" type="double" value="1.0"/>
+ *    <Parameter name="Overlap" type="int" value="0"/>
+ *  </ParameterList>
+ *
+ * Type is "Jacobi" (block Jacobi with the node block inverses, the
+ * default), "Gauss-Seidel" or "symmetric Gauss-Seidel". The blocks come
+ * from node_dof_blocks(), so velocity, pressure, temperature, species and
+ * stress unknowns at a node are coupled in one block. As with the field
+ * split, the Stratimikos solver should use "Preconditioner Type" = "None".
+ */
+static Teuchos::RCP<const Thyra::PreconditionerBase<double> >
+build_point_block_preconditioner(Teuchos::ParameterList &pointParams,
+                                 const Teuchos::RCP<Epetra_RowMatrix> &epetra_A,
+                                 const Teuchos::RCP<const Thyra::LinearOpBase<double> > &A)
+{
+  using Teuchos::RCP;
+  using Teuchos::rcp;
 
+  int num_rows = epetra_A->NumMyRows();
+  int *block_of_row = NULL;
+  int num_blocks = node_dof_blocks(num_rows, &block_of_row);
+
+  Teuchos::ParameterList ifpackParams;
+  ifpackParams.set("relaxation: type",
+                   pointParams.get<std::string>("Type", "Jacobi"));
+  ifpackParams.set("relaxation: sweeps", pointParams.get<int>("Sweeps", 1));
+  ifpackParams.set("relaxation: damping factor",
+                   pointParams.get<double>("Damping Factor", 1.0));
+  ifpackParams.set("partitioner: type", "user");
+  ifpackParams.set("partitioner: local parts", num_blocks);
+  ifpackParams.set("partitioner: map", block_of_row);
+  ifpackParams.set("partitioner: overlap", pointParams.get<int>("Overlap", 0));
+
+  RCP<Ifpack_BlockRelaxation<Ifpack_DenseContainer> > prec =
+      rcp(new Ifpack_BlockRelaxation<Ifpack_DenseContainer>(epetra_A.get()));
+  int err = prec->SetParameters(ifpackParams);
+  if (err == 0) err = prec->Initialize();
+  if (err == 0) err = prec->Compute();
+  safer_free((void **) &block_of_row);
+  if (err != 0) {
+    EH(-1, "Goma Point Block Preconditioner: Ifpack block relaxation setup failed");
+  }
+
+  /* Ifpack applies the preconditioner through ApplyInverse() */
+  RCP<const Thyra::LinearOpBase<double> > precOp =
+      Thyra::epetraLinearOp(prec, Thyra::NOTRANS,
+                            Thyra::EPETRA_OP_APPLY_APPLY_INVERSE,
+                            Thyra::EPETRA_OP_ADJOINT_UNSUPPORTED,
+                            A->domain(), A->range());
+  return Thyra::unspecifiedPrec<double>(precOp);
+}
+
+/*
+ * Near null space for ML.
+ *
+ * If the stratimikos file sets
+ *
+ *  <Parameter name="Goma Rigid Body Modes" type="bool" value="true"/>
+ *
+ * the ML preconditioner ("Preconditioner Type" = "ML") is given the rigid
+ * body modes of the mesh and real-solid displacements, built from the
+ * node coordinates by near_null_space(), with a constant vector for each
+ * other variable type, instead of its default null space. The vectors
+ * are kept here for as long as ML may use them.
+ */
+static std::vector<double> Null_Space;
+
+static void
+set_ml_null_space(Teuchos::ParameterList &solverParams, const int num_rows)
+{
+  double *vectors = NULL;
+  int num_vectors = near_null_space(num_rows, &vectors);
+  Null_Space.assign(vectors, vectors + num_vectors * num_rows);
+  safer_free((void **) &vectors);
+  if (Null_Space.empty()) return;
+
+  Teuchos::ParameterList &mlParams = solverParams.sublist("Preconditioner Types")
+      .sublist("ML").sublist("ML Settings");
+  mlParams.set("null space: type", std::string("pre-computed"));
+  mlParams.set("null space: dimension", num_vectors);
+  mlParams.set("null space: vectors", &Null_Space[0]);
+  mlParams.set("null space: add default vectors", false);
+}
+
+/*
+ * The solver for A from the stratimikos file, or with recycle the one
+ * kept from the last time, reinitialized with A. It is also left in
+ * Last_Solver for stratimikos_solve_multi().
+ */
+static Teuchos::RCP<Thyra::LinearOpWithSolveBase<double> >
+setup_solver(const Teuchos::RCP<Epetra_RowMatrix> &epetra_A,
+             const Teuchos::RCP<const Thyra::LinearOpBase<double> > &A,
+             const char *stratimikos_file, const bool recycle)
+{
+  using Teuchos::RCP;
+
+  Teuchos::RCP<Teuchos::FancyOStream> outstream =
+      Teuchos::VerboseObjectBase::getDefaultOStream();
+
+  RCP<Thyra::LinearOpWithSolveFactoryBase<double> > solverFactory;
+  RCP<Thyra::LinearOpWithSolveBase<double> > solver;
+  RCP<Teuchos::ParameterList> blockParams;
+  RCP<Teuchos::ParameterList> pointParams;
+  if (recycle && !Recycle_Solver.is_null()) {
+    solverFactory = Recycle_Factory;
+    solver = Recycle_Solver;
+    blockParams = Recycle_Block_Params;
+    pointParams = Recycle_Point_Params;
+  } else {
     // Get parameters from file
     RCP<Teuchos::ParameterList> solverParams;
     solverParams = Teuchos::getParametersFromXmlFile(stratimikos_file);
 
+    // Field-split settings are ours, not Stratimikos'
+    if (solverParams->isSublist("Goma Block Preconditioner")) {
+      blockParams = Teuchos::rcp(new Teuchos::ParameterList(
+          solverParams->sublist("Goma Block Preconditioner")));
+      solverParams->remove("Goma Block Preconditioner");
+    }
+    if (solverParams->isSublist("Goma Point Block Preconditioner")) {
+      pointParams = Teuchos::rcp(new Teuchos::ParameterList(
+          solverParams->sublist("Goma Point Block Preconditioner")));
+      solverParams->remove("Goma Point Block Preconditioner");
+    }
+    if (!blockParams.is_null() && !pointParams.is_null()) {
+      EH(-1, "Use either Goma Block Preconditioner or Goma Point Block Preconditioner, not both");
+    }
+    if (solverParams->isParameter("Goma Rigid Body Modes")) {
+      bool modes = solverParams->get<bool>("Goma Rigid Body Modes");
+      solverParams->remove("Goma Rigid Body Modes");
+      if (modes) set_ml_null_space(*solverParams, epetra_A->NumMyRows());
+    }
+
     // Set up base builder
     Stratimikos::DefaultLinearSolverBuilder linearSolverBuilder;
+#ifdef HAVE_TEKO
+    // also allows "Preconditioner Type" = "Teko" with strided blocking
+    Teko::addTekoToStratimikosBuilder(linearSolverBuilder);
+#endif
     linearSolverBuilder.setParameterList(solverParams);
 
     // set up solver factory using base/params
-    RCP<Thyra::LinearOpWithSolveFactoryBase<double> > solverFactory =
-        linearSolverBuilder.createLinearSolveStrategy("");
+    solverFactory = linearSolverBuilder.createLinearSolveStrategy("");
 
     // set output stream
     solverFactory->setOStream(outstream);
@@ -74,25 +412,123 @@ int stratimikos_solve(struct Aztec_Linear_Solver_System *ams, double *x_,
     // set solver verbosity
     solverFactory->setDefaultVerbLevel(Teuchos::VERB_NONE);
 
-    RCP<Thyra::LinearOpWithSolveBase<double> > solver =
-        Thyra::linearOpWithSolve(*solverFactory, A);
+    solver = solverFactory->createOp();
+  }
+
+  // an existing solver is reinitialized, which keeps any recycle space
+  if (!pointParams.is_null()) {
+    RCP<const Thyra::PreconditionerBase<double> > prec =
+        build_point_block_preconditioner(*pointParams, epetra_A, A);
+    Thyra::initializePreconditionedOp<double>(*solverFactory, A, prec,
+                                              solver.ptr());
+  } else if (blockParams.is_null()) {
+    Thyra::initializeOp<double>(*solverFactory, A, solver.ptr());
+  } else {
+#ifdef HAVE_TEKO
+    RCP<const Thyra::PreconditionerBase<double> > prec =
+        build_block_preconditioner(*blockParams, epetra_A, A);
+    Thyra::initializePreconditionedOp<double>(*solverFactory, A, prec,
+                                              solver.ptr());
+#else
+    EH(-1, "Goma Block Preconditioner needs goma built with Teko (HAVE_TEKO)");
+#endif
+  }
 
-    Thyra::SolveStatus<double> status = Thyra::solve<double>(*solver,
-        Thyra::NOTRANS, *b, x.ptr());
+  if (recycle) {
+    Recycle_Factory = solverFactory;
+    Recycle_Solver = solver;
+    Recycle_Block_Params = blockParams;
+    Recycle_Point_Params = pointParams;
+  }
 
-    x = Teuchos::null;
+  Last_Solver = solver;
+  Last_Matrix = epetra_A.get();
+  return solver;
+}
 
-    *iterations = 1;
-    if (!status.extraParameters.is_null()) {
-      try {
-        *iterations = status.extraParameters.get()->get<int> ("Iteration Count");
-      } catch (const Teuchos::Exceptions::InvalidParameter &excpt) {}
-    }
+/*
+ * Solve with solver, to tolerance relative to the norm of b if it is
+ * positive, else to the file's; *iterations is -1 if it did not converge.
+ */
+static Thyra::SolveStatus<double>
+solve_status(const Thyra::LinearOpWithSolveBase<double> &solver,
+             const Thyra::MultiVectorBase<double> &b,
+             const Teuchos::Ptr<Thyra::MultiVectorBase<double> > &x,
+             const double tolerance, int *iterations)
+{
+  Thyra::SolveCriteria<double> criteria;
+  Teuchos::Ptr<const Thyra::SolveCriteria<double> > criteria_ptr;
+  if (tolerance > 0) {
+    criteria.solveMeasureType = Thyra::SolveMeasureType(
+        Thyra::SOLVE_MEASURE_NORM_RESIDUAL, Thyra::SOLVE_MEASURE_NORM_RHS);
+    criteria.requestedTol = tolerance;
+    criteria_ptr = Teuchos::constPtr(criteria);
+  }
+
+  Thyra::SolveStatus<double> status = Thyra::solve<double>(solver,
+      Thyra::NOTRANS, b, x, criteria_ptr);
+
+  *iterations = 1;
+  if (!status.extraParameters.is_null()) {
+    try {
+      *iterations = status.extraParameters.get()->get<int> ("Iteration Count");
+    } catch (const Teuchos::Exceptions::InvalidParameter &excpt) {}
+  }
+
+  if (status.solveStatus != Thyra::SOLVE_STATUS_CONVERGED) {
+    *iterations = -1;
+  }
+  return status;
+}
+
+extern "C" {
+
+void stratimikos_next_solve(int newton_its, double delta_t)
+{
+  Next_Newton = newton_its;
+  Next_Dt = delta_t;
+}
+
+int stratimikos_solve(struct Aztec_Linear_Solver_System *ams, double *x_,
+    double *b_, int *iterations, char *stratimikos_file, double tolerance)
+{
+  using Teuchos::RCP;
+  bool success = true;
+  bool verbose = true;
+  const int newton = Next_Newton;
+  const double dt = Next_Dt;
+  Next_Newton = -1;
+  try {
+    Epetra_Map map = ams->RowMatrix->RowMatrixRowMap();
+
+    // Assign A with false so it doesn't get garbage collected.
+    RCP<Epetra_RowMatrix> epetra_A = Teuchos::rcp(ams->RowMatrix, false);
+    RCP<Epetra_Vector> epetra_x = Teuchos::rcp(
+        new Epetra_Vector(Copy, map, x_));
+    RCP<Epetra_Vector> epetra_b = Teuchos::rcp(
+        new Epetra_Vector(Copy, map, b_));
+
+    RCP<const Thyra::LinearOpBase<double> > A = Thyra::epetraLinearOp(epetra_A);
+    RCP<Thyra::VectorBase<double> > x = Thyra::create_Vector(epetra_x,
+        A->domain());
+    RCP<const Thyra::VectorBase<double> > b = Thyra::create_Vector(epetra_b,
+        A->range());
+
+    RCP<Thyra::LinearOpWithSolveBase<double> > solver =
+        setup_solver(epetra_A, A, stratimikos_file, Krylov_Recycle && newton >= 0);
 
-    if (status.solveStatus != Thyra::SOLVE_STATUS_CONVERGED) {
-      *iterations = -1;
+    if (Krylov_Guess && newton >= 0) {
+      newton_guess(*epetra_A, *epetra_x, *epetra_b, newton, dt);
     }
 
+    Thyra::SolveStatus<double> status = solve_status(*solver, *b, x.ptr(),
+                                                     tolerance, iterations);
+
+    // -1 if the solver does not know (SolveStatus::unknownTolerance())
+    ams->status[AZ_scaled_r] = status.achievedTol;
+
+    x = Teuchos::null;
+
     /* Convert solution vector */
     int NumMyRows = map.NumMyElements();
 
@@ -101,6 +537,60 @@ int stratimikos_solve(struct Aztec_Linear_Solver_System *ams, double *x_,
       x_[i] = (*raw_x)[i];
     }
 
+    if (Krylov_Guess && newton >= 0 && *iterations != -1) {
+      newton_guess_record(x_, NumMyRows, newton, dt);
+    }
+
+  } TEUCHOS_STANDARD_CATCH_STATEMENTS(verbose, std::cerr, success)
+
+  if (success) {
+    return 0;
+  } else {
+    return -1;
+  }
+}
+
+int stratimikos_solve_multi(struct Aztec_Linear_Solver_System *ams,
+    double **x_, double **b_, int nrhs, int *iterations,
+    char *stratimikos_file, double tolerance)
+{
+  using Teuchos::RCP;
+  bool success = true;
+  bool verbose = true;
+  try {
+    Epetra_Map map = ams->RowMatrix->RowMatrixRowMap();
+
+    RCP<Epetra_RowMatrix> epetra_A = Teuchos::rcp(ams->RowMatrix, false);
+    RCP<Epetra_MultiVector> epetra_x = Teuchos::rcp(
+        new Epetra_MultiVector(Copy, map, x_, nrhs));
+    RCP<Epetra_MultiVector> epetra_b = Teuchos::rcp(
+        new Epetra_MultiVector(Copy, map, b_, nrhs));
+
+    RCP<const Thyra::LinearOpBase<double> > A = Thyra::epetraLinearOp(epetra_A);
+    RCP<Thyra::MultiVectorBase<double> > x = Thyra::create_MultiVector(epetra_x,
+        A->domain());
+    RCP<const Thyra::MultiVectorBase<double> > b = Thyra::create_MultiVector(
+        Teuchos::rcp_implicit_cast<const Epetra_MultiVector>(epetra_b), A->range());
+
+    // the matrix of the last solve, and its preconditioner, if it is this one
+    RCP<Thyra::LinearOpWithSolveBase<double> > solver;
+    if (!Last_Solver.is_null() && Last_Matrix == ams->RowMatrix) {
+      solver = Last_Solver;
+    } else {
+      solver = setup_solver(epetra_A, A, stratimikos_file, false);
+    }
+
+    solve_status(*solver, *b, x.ptr(), tolerance, iterations);
+
+    x = Teuchos::null;
+
+    int NumMyRows = map.NumMyElements();
+    for (int k = 0; k < nrhs; k++) {
+      for (int i = 0; i < NumMyRows; i++) {
+        x_[k][i] = (*epetra_x)[k][i];
+      }
+    }
+
   } TEUCHOS_STANDARD_CATCH_STATEMENTS(verbose, std::cerr, success)
 
   if (success) {
@@ -119,8 +609,20 @@ extern "C" {
 #include "std.h"
 #include "mm_eh.h"
 
+void stratimikos_next_solve(int newton_its, double delta_t)
+{
+}
+
 int stratimikos_solve(struct Aztec_Linear_Solver_System *ams, double *x_,
-    double *b_, int *iterations, char *stratimikos_file)
+    double *b_, int *iterations, char *stratimikos_file, double tolerance)
+{
+  EH(-1, "Not built with stratimikos support!");
+  return -1;
+}
+
+int stratimikos_solve_multi(struct Aztec_Linear_Solver_System *ams,
+    double **x_, double **b_, int nrhs, int *iterations,
+    char *stratimikos_file, double tolerance)
 {
   EH(-1, "Not built with stratimikos support!");
   return -1;
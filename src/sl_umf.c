@@ -69,6 +69,10 @@
 #define _SL_UMF_C
 #include "goma.h"
 
+/* Direct Solve Refinement card: 0 tolerance is off */
+dbl Direct_Refine_Tol = 0.;
+int Direct_Refine_Steps = 5;
+
 /* how many different linear systems might UMF be used for? */
 #ifndef UMF_MAX_SYSTEMS
 #define UMF_MAX_SYSTEMS   20
@@ -349,5 +353,96 @@ SL_UMF ( int system_id,
 
 } /* END of routine SL_UMF */
 /*****************************************************************************/
+
+static void
+msr_residual(const int n,
+	     const int *ija,
+	     const double *a,
+	     const double *b,
+	     const double *x,
+	     double *r)
+{
+  int i, j;
+
+  for (i = 0; i < n; i++) {
+    r[i] = b[i] - a[i] * x[i];
+    for (j = ija[i]; j < ija[i+1]; j++) {
+      r[i] -= a[j] * x[ija[j]];
+    }
+  }
+}
+
+static dbl
+vec_norm2(const int n, const double *v)
+{
+  int i;
+  dbl s = 0.;
+
+  for (i = 0; i < n; i++) s += v[i] * v[i];
+  return sqrt(s);
+}
+
+int
+SL_UMF_refine(int system_id,
+	      int n,
+	      int nnz,
+	      int *ija,
+	      double *a,
+	      double *b,
+	      double *x)
+
+    /*************************************************************************
+     *
+     * SL_UMF_refine():
+     *
+     *  Solve the MSR system (ija, a) for b with the factors UMFPACK already
+     *  holds for system_id, those of an earlier matrix of the same
+     *  pattern, by iterative refinement against a itself:
+     *
+     *     x = 0, r = b;  repeat  x += LU \ r,  r = b - a x
+     *
+     *  until |r| <= Direct_Refine_Tol |b|, at most Direct_Refine_Steps
+     *  times, giving up as soon as |r| fails to drop.
+     *
+     *  Return: the number of solves with the old factors when x meets the
+     *          tolerance, -1 when it does not (x is then garbage and the
+     *          matrix must be factored afresh)
+     *************************************************************************/
+{
+  int i, k, first = 0, fact_optn = 3, matr_form = 1;
+  dbl bnorm, rnorm, rnorm_old;
+  double *r, *dx;
+
+  if (system_id < 0 || Direct_Refine_Steps < 1) return -1;
+
+  r = (double *) smalloc(n * sizeof(double));
+  dx = (double *) smalloc(n * sizeof(double));
+
+  for (i = 0; i < n; i++) {
+    x[i] = 0.;
+    r[i] = b[i];
+  }
+  bnorm = vec_norm2(n, b);
+  rnorm_old = bnorm;
+
+  for (k = 1; k <= Direct_Refine_Steps; k++) {
+    SL_UMF(system_id, &first, &fact_optn, &matr_form, &n, &nnz,
+	   ija, ija, a, r, dx);
+    for (i = 0; i < n; i++) x[i] += dx[i];
+    msr_residual(n, ija, a, b, x, r);
+    rnorm = vec_norm2(n, r);
+    if (rnorm <= Direct_Refine_Tol * bnorm) break;
+    if (!(rnorm < rnorm_old)) {
+      k = Direct_Refine_Steps + 1;
+      break;
+    }
+    rnorm_old = rnorm;
+  }
+
+  safe_free(r);
+  safe_free(dx);
+  return (k <= Direct_Refine_Steps) ? k : -1;
+}
+/*****************************************************************************/
 /* END of file sl_umf.c */
 /*****************************************************************************/
@@ -1920,7 +1920,8 @@ solve_NxN_system(dbl *A,
     }
 }
 
-/* Alternate amesos_solve_msr() for builds without Trilinos & Amesos */
+/* Alternate amesos_solve_msr(), amesos_solve_msr_multi() and
+ * amesos_solve_epetra_multi() for builds without Trilinos & Amesos */
 
 #if defined(ENABLE_AMESOS) && defined(TRILINOS)
 /* Use the function in sl_amesos_interface.C; do nothing here! */
@@ -1938,6 +1939,31 @@ amesos_solve_msr ( char *choice,
   fprintf(stderr, "   Also make sure appropriate libraries are linked for solver packages.");
   exit(-1);
 }
+
+void
+amesos_solve_msr_multi ( char *choice,
+			 struct Aztec_Linear_Solver_System *ams,
+			 double **x_,
+			 double **b_,
+			 int nrhs,
+			 int flag)
+{
+  amesos_solve_msr(choice, ams, x_[0], b_[0], flag);
+}
+
+int
+amesos_solve_epetra_multi ( char *choice,
+			    struct Aztec_Linear_Solver_System *ams,
+			    double **x_,
+			    double **b_,
+			    int nrhs,
+			    int flag)
+{
+  fprintf(stderr, "Error: Need to compile with ENABLE_AMESOS flag before using AMESOS solver packages.");
+  fprintf(stderr, "   Also make sure appropriate libraries are linked for solver packages.");
+  exit(-1);
+  return -1;
+}
 #endif
 
 /******************************************************************************/
@@ -50,7 +50,12 @@
 #include <stdlib.h>
 #include <stdio.h>
 #include <string.h>
+#include <stdint.h>
+#include <math.h>
 #include <unistd.h>		/* for getuid() */
+#ifdef GOMA_ASYNC_OUTPUT
+#include <pthread.h>
+#endif
 
 #ifndef lint
 #ifdef USE_RCSID
@@ -82,6 +87,600 @@ extern char **Argv;		/* global shadow of argv, def'd in main.c */
 
 static Spfrtn sr;		/* sprintf() return type, whatever it is. */
 
+/*
+ * Output session.
+ *
+ * The results writers below are called once per variable per output step.
+ * Rather than ex_open()/ex_close() the results file for every one of those
+ * calls, the file is kept open between calls and only flushed with
+ * ex_update() every Exo_Flush_Interval output steps. The session is closed
+ * whenever something else is about to open or rewrite an EXODUS II file,
+ * when a different file is written, and at the end of the run.
+ *
+ * Exo_Flush_Interval = 0 restores the old open/write/close per call.
+ */
+
+static int  Session_Exoid = -1;		/* open handle, -1 when closed */
+static char Session_File[MAX_FNL];	/* file the handle belongs to */
+static int  Session_Comp_Wordsize;
+static int  Session_IO_Wordsize;
+static float Session_Version;
+static int  Session_Time_Step = -1;	/* last step whose time was put */
+static double Session_Time_Value;	/* ... and the time put for it */
+static int  Session_Step = -1;		/* step being written */
+static int  Session_Unflushed = 0;	/* steps written since last flush */
+
+static void wr_exo_session_close_now(void);
+
+static void
+wr_exo_session_open(Exo_DB *exo, const char *filename, const int time_step)
+
+     /*****************************************************************
+      * wr_exo_session_open()
+      *     -- make exo->exoid a writable handle on filename, reusing
+      *        the open session when it is for the same file.
+      ******************************************************************/
+{
+  char err_msg[MAX_CHAR_IN_INPUT];
+  int error;
+
+  if (Session_Exoid >= 0 && strcmp(filename, Session_File) != 0) {
+    wr_exo_session_close_now();
+  }
+
+  if (Session_Exoid < 0) {
+    exo->cmode = EX_WRITE;
+    exo->io_wordsize = 0;		/* query */
+    exo->exoid = ex_open(filename, exo->cmode, &exo->comp_wordsize, 
+			 &exo->io_wordsize, &exo->version);
+    if (exo->exoid < 0) {
+      sr = sprintf(err_msg, 
+		   "ex_open() = %d on \"%s\" failure @ step %d",
+		   exo->exoid, filename, time_step);
+      EH(-1, err_msg);
+    }
+    if (Exo_Flush_Interval <= 0) return;
+
+    Session_Exoid = exo->exoid;
+    strncpy(Session_File, filename, MAX_FNL-1);
+    Session_File[MAX_FNL-1] = '\0';
+    Session_Comp_Wordsize = exo->comp_wordsize;
+    Session_IO_Wordsize = exo->io_wordsize;
+    Session_Version = exo->version;
+    Session_Time_Step = -1;
+    Session_Step = -1;
+    Session_Unflushed = 0;
+  } else {
+    exo->cmode = EX_WRITE;
+    exo->exoid = Session_Exoid;
+    exo->comp_wordsize = Session_Comp_Wordsize;
+    exo->io_wordsize = Session_IO_Wordsize;
+    exo->version = Session_Version;
+  }
+
+  /*
+   * A new time step means the previous one is complete.
+   */
+  if (time_step != Session_Step) {
+    if (Session_Step >= 0 && ++Session_Unflushed >= Exo_Flush_Interval) {
+      error = ex_update(Session_Exoid);
+      EH(error, "ex_update");
+      Session_Unflushed = 0;
+    }
+    Session_Step = time_step;
+  }
+}
+
+static int
+wr_exo_session_put_time(Exo_DB *exo, const int time_step, double time_value)
+{
+  int error = 0;
+
+  /* The time only needs writing once per step while the session is open */
+  if (exo->exoid != Session_Exoid || time_step != Session_Time_Step ||
+      time_value != Session_Time_Value) {
+    error = ex_put_time(exo->exoid, time_step, &time_value);
+  }
+  if (exo->exoid == Session_Exoid) {
+    Session_Time_Step = time_step;
+    Session_Time_Value = time_value;
+  }
+  return(error);
+}
+
+static void
+wr_exo_session_release(Exo_DB *exo)
+{
+  int error;
+
+  /* Outside of a session, close as before */
+  if (exo->exoid != Session_Exoid) {
+    error = ex_close(exo->exoid);
+    EH(error, "ex_close");
+  }
+}
+
+static void
+wr_exo_session_close_now(void)
+
+     /*****************************************************************
+      * wr_exo_session_close_now()
+      *     -- flush and close the results file held open between
+      *        writes, if any. Only the thread doing the writes (the
+      *        output writer, when running) may call this.
+      ******************************************************************/
+{
+  int error;
+
+  if (Session_Exoid < 0) return;
+
+  error = ex_close(Session_Exoid);
+  EH(error, "ex_close");
+  Session_Exoid = -1;
+  Session_File[0] = '\0';
+  Session_Time_Step = -1;
+  Session_Step = -1;
+  Session_Unflushed = 0;
+}
+
+/*
+ * Output jobs.
+ *
+ * Each call to one of the results writers becomes an Output_Job: one
+ * variable at one time step, as a list of (block id, length, values)
+ * pieces. Run synchronously, the pieces point straight at the caller's
+ * arrays.
+ *
+ * When goma is built with GOMA_ASYNC_OUTPUT and Async_Output_Memory > 0,
+ * the values are instead copied into the job and queued for a background
+ * writer thread, and the time loop carries on. No more than
+ * Async_Output_Memory MB can be queued at once; a caller who would go
+ * over that waits for the writer to catch up. The writer is the only
+ * thread making EXODUS II calls while it has work.
+ * wr_exo_session_close() waits for it to finish before anything else
+ * touches a file.
+ */
+
+struct Output_Job {
+  struct Output_Job *next;
+  Exo_DB *exo;			/* db for the session (&exo_copy if queued) */
+  Exo_DB exo_copy;
+  char filename[MAX_FNL];
+  int ex_type;			/* EX_NODAL, EX_ELEM_BLOCK or EX_GLOBAL */
+  int time_step;
+  double time_value;
+  int put_time;			/* write the time value too */
+  int var_index;		/* 1 based */
+  int num_pieces;
+  int *piece_id;		/* [num_pieces] block id (1 for nodal, 0 global) */
+  int *piece_len;		/* [num_pieces] */
+  double **piece_val;		/* [num_pieces] */
+  double *buf;			/* staged copy of the values, if queued */
+  size_t bytes;			/* size of the staged copy */
+};
+
+static void
+wr_exo_job_run(struct Output_Job *job)
+{
+  int error, k;
+
+  wr_exo_session_open(job->exo, job->filename, job->time_step);
+  if (job->put_time) {
+    error = wr_exo_session_put_time(job->exo, job->time_step, job->time_value);
+    EH(error, "ex_put_time");
+  }
+  for (k = 0; k < job->num_pieces; k++) {
+    error = ex_put_var(job->exo->exoid, job->time_step, job->ex_type,
+		       job->var_index, job->piece_id[k], job->piece_len[k],
+		       job->piece_val[k]);
+    EH(error, "ex_put_var");
+  }
+  wr_exo_session_release(job->exo);
+}
+
+#ifdef GOMA_ASYNC_OUTPUT
+
+static pthread_t        Writer_Thread;
+static pthread_mutex_t  Writer_Lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t   Writer_Work = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t   Writer_Done = PTHREAD_COND_INITIALIZER;
+static int              Writer_Running = FALSE;
+static int              Writer_Busy = FALSE;
+static int              Writer_Stop = FALSE;
+static struct Output_Job *Queue_Head = NULL, *Queue_Tail = NULL;
+static size_t           Queue_Bytes = 0;	/* staged, not yet written */
+
+static void
+wr_exo_job_free(struct Output_Job *job)
+{
+  safer_free((void **) &job->piece_id);
+  safer_free((void **) &job->piece_len);
+  safer_free((void **) &job->piece_val);
+  safer_free((void **) &job->buf);
+  safer_free((void **) &job);
+}
+
+static void *
+wr_exo_writer(void *arg)
+{
+  struct Output_Job *job;
+
+  pthread_mutex_lock(&Writer_Lock);
+  for (;;) {
+    while (Queue_Head == NULL && !Writer_Stop) {
+      pthread_cond_wait(&Writer_Work, &Writer_Lock);
+    }
+    if (Queue_Head == NULL) break;
+
+    job = Queue_Head;
+    Queue_Head = job->next;
+    if (Queue_Head == NULL) Queue_Tail = NULL;
+    Writer_Busy = TRUE;
+    pthread_mutex_unlock(&Writer_Lock);
+
+    wr_exo_job_run(job);
+
+    pthread_mutex_lock(&Writer_Lock);
+    Queue_Bytes -= job->bytes;
+    Writer_Busy = FALSE;
+    wr_exo_job_free(job);
+    pthread_cond_broadcast(&Writer_Done);
+  }
+  pthread_mutex_unlock(&Writer_Lock);
+  return(NULL);
+}
+
+static void
+wr_exo_job_queue(struct Output_Job *sync_job)
+
+     /*****************************************************************
+      * wr_exo_job_queue()
+      *     -- stage a copy of sync_job's values and hand it to the
+      *        writer thread.
+      ******************************************************************/
+{
+  struct Output_Job *job;
+  size_t limit = (size_t) Async_Output_Memory * 1048576;
+  int k, n, off;
+
+  job = (struct Output_Job *) smalloc(sizeof(struct Output_Job));
+  *job = *sync_job;
+  job->next = NULL;
+  job->exo_copy = *sync_job->exo;
+  job->exo = &job->exo_copy;
+
+  n = 0;
+  for (k = 0; k < job->num_pieces; k++) n += job->piece_len[k];
+  job->bytes = n * sizeof(double);
+  job->buf = alloc_dbl_1(MAX(n, 1), DBL_NOINIT);
+  job->piece_id = alloc_int_1(MAX(job->num_pieces, 1), INT_NOINIT);
+  job->piece_len = alloc_int_1(MAX(job->num_pieces, 1), INT_NOINIT);
+  job->piece_val = (double **) smalloc(MAX(job->num_pieces, 1) * sizeof(double *));
+  off = 0;
+  for (k = 0; k < job->num_pieces; k++) {
+    job->piece_id[k] = sync_job->piece_id[k];
+    job->piece_len[k] = sync_job->piece_len[k];
+    job->piece_val[k] = job->buf + off;
+    dcopy1(job->piece_len[k], sync_job->piece_val[k], job->piece_val[k]);
+    off += job->piece_len[k];
+  }
+
+  pthread_mutex_lock(&Writer_Lock);
+  if (!Writer_Running) {
+    if (pthread_create(&Writer_Thread, NULL, wr_exo_writer, NULL) != 0) {
+      EH(-1, "could not start the output writer thread");
+    }
+    Writer_Running = TRUE;
+  }
+  /* back-pressure: wait while the writer is too far behind */
+  while (Queue_Bytes > 0 && Queue_Bytes + job->bytes > limit) {
+    pthread_cond_wait(&Writer_Done, &Writer_Lock);
+  }
+  if (Queue_Tail == NULL) {
+    Queue_Head = job;
+  } else {
+    Queue_Tail->next = job;
+  }
+  Queue_Tail = job;
+  Queue_Bytes += job->bytes;
+  pthread_cond_signal(&Writer_Work);
+  pthread_mutex_unlock(&Writer_Lock);
+}
+
+static void
+wr_exo_writer_drain(void)
+{
+  if (!Writer_Running) return;
+
+  pthread_mutex_lock(&Writer_Lock);
+  while (Queue_Head != NULL || Writer_Busy) {
+    pthread_cond_wait(&Writer_Done, &Writer_Lock);
+  }
+  pthread_mutex_unlock(&Writer_Lock);
+}
+
+#endif /* GOMA_ASYNC_OUTPUT */
+
+static void
+wr_exo_job_submit(struct Output_Job *job)
+{
+#ifdef GOMA_ASYNC_OUTPUT
+  if (Async_Output_Memory > 0) {
+    wr_exo_job_queue(job);
+    return;
+  }
+#endif
+  wr_exo_job_run(job);
+}
+
+void
+wr_exo_session_close(void)
+
+     /*****************************************************************
+      * wr_exo_session_close()
+      *     -- wait for any queued output to be written, then flush and
+      *        close the results file held open between writes, if any.
+      ******************************************************************/
+{
+#ifdef GOMA_ASYNC_OUTPUT
+  wr_exo_writer_drain();
+#endif
+  wr_exo_session_close_now();
+}
+
+void
+wr_exo_output_finish(void)
+
+     /*****************************************************************
+      * wr_exo_output_finish()
+      *     -- end of run: write out everything still queued, stop the
+      *        writer thread and close the results file.
+      ******************************************************************/
+{
+  wr_exo_session_close();
+#ifdef GOMA_ASYNC_OUTPUT
+  if (Writer_Running) {
+    pthread_mutex_lock(&Writer_Lock);
+    Writer_Stop = TRUE;
+    pthread_cond_signal(&Writer_Work);
+    pthread_mutex_unlock(&Writer_Lock);
+    pthread_join(Writer_Thread, NULL);
+    Writer_Running = FALSE;
+    Writer_Stop = FALSE;
+  }
+#endif
+}
+
+/*
+ * Compressed results.
+ *
+ * With an Output Compression Level the results file is created as
+ * NetCDF-4 (HDF5), and every variable defined on it afterwards is
+ * deflated, after a byte shuffle if asked for. That goes through the
+ * EXODUS II options, so it needs a library built with NetCDF-4.
+ */
+
+static int
+wr_exo_create_mode(const int cmode)
+{
+#ifdef EX_NETCDF4
+  if (Output_Compression_Level > 0) return (cmode | EX_NETCDF4 | EX_NOCLASSIC);
+#endif
+  return (cmode);
+}
+
+static void
+wr_exo_set_compression(const int exoid)
+{
+#ifdef EX_NETCDF4
+  int error;
+
+  if (Output_Compression_Level <= 0) return;
+  error = ex_set_option(exoid, EX_OPT_COMPRESSION_LEVEL, Output_Compression_Level);
+  EH(error, "ex_set_option compression level");
+  if (Output_Compression_Shuffle) {
+    error = ex_set_option(exoid, EX_OPT_COMPRESSION_SHUFFLE, 1);
+    EH(error, "ex_set_option compression shuffle");
+  }
+#else
+  static int warned = FALSE;
+
+  if (Output_Compression_Level > 0 && !warned) {
+    WH(-1, "This EXODUS II library has no NetCDF-4 files, writing results uncompressed");
+    warned = TRUE;
+  }
+#endif
+}
+
+/*
+ * Output subsets.
+ *
+ * wr_result_prelim_exo() matches each Output Subset card to a nodal or
+ * element variable of the file it sets up. An element variable limited
+ * to element blocks is left out of the truth table of the other blocks,
+ * so it takes no space there. Any other region zeroes the values outside
+ * of it: the nodes not in the mask, the elements none of whose nodes
+ * are. Off its stride a variable is not written at all.
+ *
+ * With Output Significant Digits the values written keep only the
+ * mantissa bits those digits need, rounded to nearest, which leaves
+ * long runs of zero bits for deflate.
+ */
+
+static char  Subset_File[MAX_FNL];	/* file the maps below belong to */
+static int   Nodal_Subset[MAX_NNV];	/* Output_Subsets index, -1 = none */
+static int   Elem_Subset[MAX_NEV];
+static char *Subset_Node_Mask[MAX_OUTPUT_SUBSETS];	/* built on first use */
+
+static void
+wr_exo_subsets_resolve(const struct Results_Description *rd,
+		       const char *filename)
+{
+  char err_msg[MAX_CHAR_IN_INPUT];
+  int i, k, found;
+
+  strncpy(Subset_File, filename, MAX_FNL-1);
+  Subset_File[MAX_FNL-1] = '\0';
+  for (i = 0; i < MAX_NNV; i++) Nodal_Subset[i] = -1;
+  for (i = 0; i < MAX_NEV; i++) Elem_Subset[i] = -1;
+  for (k = 0; k < MAX_OUTPUT_SUBSETS; k++) safer_free((void **) &Subset_Node_Mask[k]);
+
+  for (k = 0; k < Num_Output_Subsets; k++) {
+    found = FALSE;
+    for (i = 0; i < rd->nnv && i < MAX_NNV; i++) {
+      if (strcmp(rd->nvname[i], Output_Subsets[k].var_name) == 0) {
+	Nodal_Subset[i] = k;
+	found = TRUE;
+      }
+    }
+    for (i = 0; i < rd->nev && i < MAX_NEV; i++) {
+      if (strcmp(rd->evname[i], Output_Subsets[k].var_name) == 0) {
+	Elem_Subset[i] = k;
+	found = TRUE;
+      }
+    }
+    if (!found) {
+      sr = sprintf(err_msg, "Output Subset %s is not a variable of \"%s\"",
+		   Output_Subsets[k].var_name, filename);
+      WH(-1, err_msg);
+    }
+  }
+}
+
+static int
+wr_exo_subset_of(const char *filename, const int *map, const int index)
+{
+  if (Num_Output_Subsets == 0 || strcmp(filename, Subset_File) != 0) return (-1);
+  return (map[index]);
+}
+
+static int
+wr_exo_subset_has_block(const int k, const int eb_id)
+{
+  int i;
+
+  if (k < 0 || Output_Subsets[k].region != OUTPUT_SUBSET_BLOCK) return (TRUE);
+  for (i = 0; i < Output_Subsets[k].num_ids; i++) {
+    if (Output_Subsets[k].ids[i] == eb_id) return (TRUE);
+  }
+  return (FALSE);
+}
+
+static int *
+wr_exo_subset_truth_table(const struct Results_Description *rd, Exo_DB *exo)
+
+     /*****************************************************************
+      * wr_exo_subset_truth_table()
+      *     -- the truth table for the file: exo->elem_var_tab, less
+      *        the blocks an element variable's subset leaves out.
+      ******************************************************************/
+{
+  static int *file_tab = NULL;
+  int b, i, k;
+
+  if (Num_Output_Subsets == 0) return (exo->elem_var_tab);
+
+  safer_free((void **) &file_tab);
+  file_tab = alloc_int_1(MAX(exo->num_elem_blocks * rd->nev, 1), INT_NOINIT);
+  for (b = 0; b < exo->num_elem_blocks; b++) {
+    for (i = 0; i < rd->nev; i++) {
+      k = (i < MAX_NEV) ? Elem_Subset[i] : -1;
+      file_tab[b * rd->nev + i] = exo->elem_var_tab[b * rd->nev + i] &&
+	wr_exo_subset_has_block(k, exo->eb_id[b]);
+    }
+  }
+  return (file_tab);
+}
+
+static const char *
+wr_exo_subset_node_mask(Exo_DB *exo, const int k)
+
+     /*****************************************************************
+      * wr_exo_subset_node_mask()
+      *     -- [num_nodes] TRUE where subset k keeps a nodal value.
+      ******************************************************************/
+{
+  struct Output_Subset *os = Output_Subsets + k;
+  char *mask;
+  const double *box = os->box;
+  int b, e, i, j, n;
+
+  if (Subset_Node_Mask[k] != NULL) return (Subset_Node_Mask[k]);
+
+  mask = (char *) smalloc(MAX(exo->num_nodes, 1) * sizeof(char));
+  memset(mask, 0, MAX(exo->num_nodes, 1));
+
+  switch (os->region) {
+  case OUTPUT_SUBSET_BLOCK:
+    for (b = 0; b < exo->num_elem_blocks; b++) {
+      if (!wr_exo_subset_has_block(k, exo->eb_id[b])) continue;
+      for (e = exo->eb_ptr[b]; e < exo->eb_ptr[b + 1]; e++) {
+	for (j = exo->elem_ptr[e]; j < exo->elem_ptr[e + 1]; j++) {
+	  mask[exo->node_list[j]] = TRUE;
+	}
+      }
+    }
+    break;
+  case OUTPUT_SUBSET_NODESET:
+    for (b = 0; b < exo->num_node_sets; b++) {
+      for (i = 0; i < os->num_ids && os->ids[i] != exo->ns_id[b]; i++);
+      if (i == os->num_ids) continue;
+      for (j = 0; j < exo->ns_num_nodes[b]; j++) {
+	mask[exo->ns_node_list[exo->ns_node_index[b] + j]] = TRUE;
+      }
+    }
+    break;
+  case OUTPUT_SUBSET_BOX:
+    for (n = 0; n < exo->num_nodes; n++) {
+      mask[n] = (exo->x_coord[n] >= box[0] && exo->x_coord[n] <= box[1] &&
+		 (exo->num_dim < 2 ||
+		  (exo->y_coord[n] >= box[2] && exo->y_coord[n] <= box[3])) &&
+		 (exo->num_dim < 3 ||
+		  (exo->z_coord[n] >= box[4] && exo->z_coord[n] <= box[5])));
+    }
+    break;
+  default:
+    memset(mask, TRUE, MAX(exo->num_nodes, 1));
+    break;
+  }
+
+  Subset_Node_Mask[k] = mask;
+  return (mask);
+}
+
+static int
+wr_exo_subset_skip(const int k, const int time_step)
+{
+  return (k >= 0 && Output_Subsets[k].stride > 1 &&
+	  (time_step - 1) % Output_Subsets[k].stride != 0);
+}
+
+static void
+wr_exo_quantize(const int n, double *v)
+
+     /*****************************************************************
+      * wr_exo_quantize()
+      *     -- round v[] to the mantissa bits that carry
+      *        Output_Significant_Digits decimal digits.
+      ******************************************************************/
+{
+  uint64_t bits, keep, half;
+  int i, drop;
+
+  /* 3.33 bits a digit and one to round on */
+  drop = 52 - (int) ceil(Output_Significant_Digits * 3.321928) - 1;
+  if (Output_Significant_Digits <= 0 || drop <= 0) return;
+  keep = ~(((uint64_t) 1 << drop) - 1);
+  half = (uint64_t) 1 << (drop - 1);
+
+  for (i = 0; i < n; i++) {
+    memcpy(&bits, v + i, sizeof(double));
+    if ((bits & 0x7ff0000000000000ULL) == 0x7ff0000000000000ULL) continue; /* inf, nan */
+    bits = (bits + half) & keep;
+    memcpy(v + i, &bits, sizeof(double));
+  }
+}
+
 /***********************************************************************/
 /***********************************************************************/
 /***********************************************************************/
@@ -109,6 +708,13 @@ wr_mesh_exo(Exo_DB *x,		/* def'd in exo_struct.h */
       fprintf(stderr, "wr_mesh_exo() begins.\n");
     }
 
+  wr_exo_session_close();
+
+  /*
+   * Memory Lean may have freed the distribution factors.
+   */
+  rd_exo_distfacts(x);
+
   /*
    * Mesh data is so fundamental that we'll create the file with clobber,
    * obliterating any existing file of the same name. That is, preserving
@@ -126,10 +732,11 @@ wr_mesh_exo(Exo_DB *x,		/* def'd in exo_struct.h */
   fprintf(stderr, "\t\tio_wordsize = %d\n", x->io_wordsize);
 #endif
 
-  x->cmode = EX_CLOBBER;
+  x->cmode = wr_exo_create_mode(EX_CLOBBER);
   x->exoid = ex_create(filename, x->cmode, &x->comp_wordsize, 
 		       &x->io_wordsize);
   EH(x->exoid, "ex_create");
+  wr_exo_set_compression(x->exoid);
       
   if ( verbosity > 1 )
     {
@@ -554,6 +1161,8 @@ void wr_result_prelim_exo(struct Results_Description *rd,
     EH(-1, "No file specified to write EXODUS II info.");
   }
 
+  wr_exo_session_close();
+
   /*
    *  Figure out whether the file exists and is readable by this
    *  user.
@@ -599,9 +1208,12 @@ void wr_result_prelim_exo(struct Results_Description *rd,
         ex_open(filename, exo->cmode, &exo->comp_wordsize, &exo->io_wordsize, &exo->version);
     EH(exo->exoid, "ex_open");
   } else {
-    exo->exoid = ex_create(filename, exo->cmode, &exo->comp_wordsize, &exo->io_wordsize);
+    exo->exoid = ex_create(filename, wr_exo_create_mode(exo->cmode), &exo->comp_wordsize,
+                           &exo->io_wordsize);
     EH(exo->exoid, "ex_create");
   }
+  wr_exo_set_compression(exo->exoid);
+  wr_exo_subsets_resolve(rd, filename);
 
   /*
    * Analysis Results
@@ -678,8 +1290,8 @@ wr_nodal_result_exo(Exo_DB *exo, char *filename, double vector[],
 
      /*****************************************************************
       * write_nodal_result_exo() 
-      *     -- open/write/close EXODUS II db for 1 nodal var at one
-      *        time step.
+      *     -- write 1 nodal var at one time step into the EXODUS II
+      *        db held open by the output session.
       *
       * The output EXODUS II database contains the original model
       * information with some minor QA and info additions, with new 
@@ -687,25 +1299,46 @@ wr_nodal_result_exo(Exo_DB *exo, char *filename, double vector[],
       * 
       ******************************************************************/
 {
-  char err_msg[MAX_CHAR_IN_INPUT];
-  int error;
-  exo->cmode = EX_WRITE;
-  exo->io_wordsize = 0;		/* query */
-  exo->exoid = ex_open(filename, exo->cmode, &exo->comp_wordsize, 
-		       &exo->io_wordsize, &exo->version);
-  if (exo->exoid < 0)
-    {
-      sr = sprintf(err_msg, 
-		   "ex_open() = %d on \"%s\" failure @ step %d, time = %g",
-		   exo->exoid, filename, time_step, time_value);
-      EH(-1, err_msg);
+  struct Output_Job job;
+  int id = 1;
+  int k, n;
+  double *staged = NULL;
+  const char *mask;
+
+  k = wr_exo_subset_of(filename, Nodal_Subset, variable_index - 1);
+
+  job.exo = exo;
+  strncpy(job.filename, filename, MAX_FNL-1);
+  job.filename[MAX_FNL-1] = '\0';
+  job.ex_type = EX_NODAL;
+  job.time_step = time_step;
+  job.time_value = time_value;
+  job.put_time = TRUE;
+  job.var_index = variable_index;
+  job.num_pieces = wr_exo_subset_skip(k, time_step) ? 0 : 1;
+  job.piece_id = &id;
+  job.piece_len = &exo->num_nodes;
+  job.piece_val = &vector;
+  job.buf = NULL;
+  job.bytes = 0;
+
+  if (job.num_pieces > 0 &&
+      ((k >= 0 && Output_Subsets[k].region != OUTPUT_SUBSET_ALL) ||
+       Output_Significant_Digits > 0)) {
+    staged = alloc_dbl_1(MAX(exo->num_nodes, 1), DBL_NOINIT);
+    dcopy1(exo->num_nodes, vector, staged);
+    if (k >= 0 && Output_Subsets[k].region != OUTPUT_SUBSET_ALL) {
+      mask = wr_exo_subset_node_mask(exo, k);
+      for (n = 0; n < exo->num_nodes; n++) {
+	if (!mask[n]) staged[n] = 0.;
+      }
     }
-  error      = ex_put_time(exo->exoid, time_step, &time_value);
-  EH(error, "ex_put_time");
-  error      = ex_put_var(exo->exoid, time_step, EX_NODAL, variable_index, 1,
-				exo->num_nodes, vector);
-  EH(error, "ex_put_var nodal");
-  error      = ex_close(exo->exoid);
+    wr_exo_quantize(exo->num_nodes, staged);
+    job.piece_val = &staged;
+  }
+
+  wr_exo_job_submit(&job);
+  safer_free((void **) &staged);
   return;
 }
 /***********************************************************************/
@@ -718,57 +1351,99 @@ wr_elem_result_exo(Exo_DB *exo, const char *filename, double ***vector,
 		   const double time_value, 
 		   struct Results_Description *rd)
 {
-  int error, i;
-  double local_time_value=time_value;
+  struct Output_Job job;
+  int i, e, j, k, n, off, zero;
+  double *staged = NULL;
+  const char *mask = NULL;
   /* static char *yo = "wr_elem_result_exo"; */
 
   /*
    * This file must already exist.
    */
 
-  exo->cmode = EX_WRITE;
-
-  exo->io_wordsize = 0;		/* query */
-  exo->exoid = ex_open(filename, exo->cmode, &exo->comp_wordsize, 
-		       &exo->io_wordsize, &exo->version);
-  EH(exo->exoid, "ex_open");
-
 #ifdef DEBUG
   fprintf(stderr, "\t\tfilename    = \"%s\"\n", filename);
-  fprintf(stderr, "\t\tcomp_ws     = %d\n", exo->comp_wordsize);
-  fprintf(stderr, "\t\tio_wordsize = %d\n", exo->io_wordsize);
 #endif
 
-  error = ex_put_time (exo->exoid, time_step, &local_time_value );
-  EH(error, "ex_put_time");
+  job.exo = exo;
+  strncpy(job.filename, filename, MAX_FNL-1);
+  job.filename[MAX_FNL-1] = '\0';
+  job.ex_type = EX_ELEM_BLOCK;
+  job.time_step = time_step;
+  job.time_value = time_value;
+  job.put_time = TRUE;
+  job.var_index = variable_index+1; /* Convert to 1 based for exodus */
+  job.piece_id = alloc_int_1(MAX(exo->num_elem_blocks, 1), INT_NOINIT);
+  job.piece_len = alloc_int_1(MAX(exo->num_elem_blocks, 1), INT_NOINIT);
+  job.piece_val = (double **) smalloc(MAX(exo->num_elem_blocks, 1) * sizeof(double *));
+  job.buf = NULL;
+  job.bytes = 0;
 
   /* If the truth table has NOT been set up, this will be really slow... */
 
-  for (i = 0; i < exo->num_elem_blocks; i++) {
-    if (exo->elem_var_tab_exists == TRUE) {
-      /* Only write out vals if this variable exists for the block */
-      if (exo->elem_var_tab[i*rd->nev + variable_index] == 1) {
-	error = ex_put_var(exo->exoid, time_step, EX_ELEM_BLOCK, variable_index+1,
-				exo->eb_id[i], exo->eb_num_elems[i],
-				vector[i][variable_index]);
-	EH(error, "ex_put_var elem");
+  k = wr_exo_subset_of(filename, Elem_Subset, variable_index);
+
+  job.num_pieces = 0;
+  for (i = 0; i < exo->num_elem_blocks && !wr_exo_subset_skip(k, time_step); i++) {
+    /*
+     * Only write out vals if this variable exists for the block;
+     * without a truth table write it anyway (not really recommended
+     * from a performance viewpoint)
+     */
+    if ((exo->elem_var_tab_exists != TRUE ||
+	 exo->elem_var_tab[i*rd->nev + variable_index] == 1) &&
+	wr_exo_subset_has_block(k, exo->eb_id[i])) {
+      job.piece_id[job.num_pieces] = exo->eb_id[i];
+      job.piece_len[job.num_pieces] = exo->eb_num_elems[i];
+      job.piece_val[job.num_pieces] = vector[i][variable_index];
+      job.num_pieces++;
+    }
+  }
+
+  /*
+   * Zero the elements outside a node set or box, and round, on a copy.
+   */
+  if (job.num_pieces > 0 &&
+      ((k >= 0 && Output_Subsets[k].region != OUTPUT_SUBSET_ALL &&
+	Output_Subsets[k].region != OUTPUT_SUBSET_BLOCK) ||
+       Output_Significant_Digits > 0)) {
+    if (k >= 0 && Output_Subsets[k].region != OUTPUT_SUBSET_ALL &&
+	Output_Subsets[k].region != OUTPUT_SUBSET_BLOCK) {
+      mask = wr_exo_subset_node_mask(exo, k);
+    }
+    n = 0;
+    for (j = 0; j < job.num_pieces; j++) n += job.piece_len[j];
+    staged = alloc_dbl_1(MAX(n, 1), DBL_NOINIT);
+    off = 0;
+    for (j = 0; j < job.num_pieces; j++) {
+      dcopy1(job.piece_len[j], job.piece_val[j], staged + off);
+      job.piece_val[j] = staged + off;
+      off += job.piece_len[j];
+    }
+    if (mask != NULL) {
+      for (i = 0; i < exo->num_elem_blocks; i++) {
+	for (j = 0; j < job.num_pieces && job.piece_id[j] != exo->eb_id[i]; j++);
+	if (j == job.num_pieces) continue;
+	for (e = exo->eb_ptr[i]; e < exo->eb_ptr[i + 1]; e++) {
+	  zero = TRUE;
+	  for (n = exo->elem_ptr[e]; n < exo->elem_ptr[e + 1] && zero; n++) {
+	    if (mask[exo->node_list[n]]) zero = FALSE;
+	  }
+	  if (zero) job.piece_val[j][e - exo->eb_ptr[i]] = 0.;
+	}
       }
     }
-    else {
-      /* write it anyway (not really recommended from a performance viewpoint) */
-      error      = ex_put_var ( exo->exoid,
-				time_step, EX_ELEM_BLOCK,
-				variable_index+1, /* Convert to 1 based for
-						     exodus */
-				exo->eb_id[i],
-				exo->eb_num_elems[i],
-				vector[i][variable_index] );
-      EH(error, "ex_put_var elem");
+    for (j = 0; j < job.num_pieces; j++) {
+      wr_exo_quantize(job.piece_len[j], job.piece_val[j]);
     }
   }
 
-  error      = ex_close ( exo->exoid );
-  EH(error, "ex_close");
+  wr_exo_job_submit(&job);
+
+  safer_free((void **) &staged);
+  safer_free((void **) &job.piece_id);
+  safer_free((void **) &job.piece_len);
+  safer_free((void **) &job.piece_val);
 
   return;
 }
@@ -783,14 +1458,17 @@ wr_global_result_exo( Exo_DB *exo,
 {
      /*****************************************************************
       * write_global_result_exo() 
-      *     -- open/write/close EXODUS II db for all global values
+      *     -- write all global values into the EXODUS II db held open
+      *        by the output session
       *
       * The output EXODUS II database contains the original model
       * information with some minor QA and info additions, with new 
       * global data written.
       * 
       ******************************************************************/
-  int error;
+  struct Output_Job job;
+  int id = 0;
+  int len = ngv;
 
 
   /* 
@@ -800,19 +1478,21 @@ wr_global_result_exo( Exo_DB *exo,
 
   if( u == NULL ) return ; /* Do nothing if this is NULL */
 
-  exo->cmode = EX_WRITE;
-  exo->io_wordsize = 0;		/* query */
-  exo->exoid = ex_open(filename, exo->cmode, &exo->comp_wordsize, 
-		       &exo->io_wordsize, &exo->version);
-  if (exo->exoid < 0) {
-    EH(-1,"wr_nodal_result_exo: could not open the output file");
-  }
-
-  error = ex_put_var( exo->exoid, time_step, EX_GLOBAL, 1, 0, ngv, u );
-
-  EH(error, "ex_put_var glob_vars");
-
-  error = ex_close( exo->exoid);
+  job.exo = exo;
+  strncpy(job.filename, filename, MAX_FNL-1);
+  job.filename[MAX_FNL-1] = '\0';
+  job.ex_type = EX_GLOBAL;
+  job.time_step = time_step;
+  job.time_value = 0.;
+  job.put_time = FALSE;
+  job.var_index = 1;
+  job.num_pieces = 1;
+  job.piece_id = &id;
+  job.piece_len = &len;
+  job.piece_val = &u;
+  job.buf = NULL;
+  job.bytes = 0;
+  wr_exo_job_submit(&job);
 
 
   return;
@@ -1149,7 +1829,7 @@ void create_truth_table(struct Results_Description *rd, Exo_DB *exo, double ***g
 
   /* write out table */
   error = ex_put_truth_table(exo->exoid, EX_ELEM_BLOCK, exo->num_elem_blocks, rd->nev,
-                             exo->elem_var_tab);
+                             wr_exo_subset_truth_table(rd, exo));
   EH(error, "ex_put_truth_table EX_ELEM_BLOCK");
 
   /* Now set truth table exists flag */
@@ -1471,6 +2151,8 @@ void wr_resetup_exo(Exo_DB *exo, char *filename, int verbosity) {
    * This file must already exist.
    */
 
+  wr_exo_session_close();
+
   exo->cmode = EX_WRITE;
 
 #ifdef DEBUG
@@ -1544,6 +2226,8 @@ void wr_result_exo(Exo_DB *exo, char *filename, int verbosity) {
    * This file should already exist.
    */
 
+  wr_exo_session_close();
+
   exo->cmode = EX_WRITE;
 
 #ifdef DEBUG
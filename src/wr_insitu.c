@@ -0,0 +1,332 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * In situ output through the Catalyst 2 API.
+ *
+ * With a "Catalyst Script" named in the input and goma built with
+ * GOMA_CATALYST, every output step is also handed to catalyst_execute() on
+ * channel "grid" as a multi-domain Conduit Mesh Blueprint, one domain per
+ * element block of this processor. Coordinates and fields are passed as
+ * external pointers, so nothing is copied when the arrays outlive the
+ * step; the solution variables, which write_solution() extracts one after
+ * another into the same work vector, are the exception. Connectivity is
+ * built once, from the corner nodes of the elements this processor owns,
+ * so that the pipeline sees each element once and in a linear shape.
+ *
+ * Which Catalyst implementation runs the script is the usual Catalyst
+ * choice (CATALYST_IMPLEMENTATION_NAME and _PATHS in the environment, or
+ * the "Catalyst Implementation" card): ParaView for in situ
+ * visualization, or e.g. the ADIOS2 one to stage the data to a separate
+ * job.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "std.h"
+#include "rf_allo.h"
+#include "mm_eh.h"
+#include "exo_struct.h"
+#include "dpi.h"
+
+#define _WR_INSITU_C
+#include "goma.h"
+
+#ifdef GOMA_CATALYST
+#include <catalyst.h>
+
+#define INSITU_PATH_LEN 512
+
+struct Insitu_Block
+{
+  int domain_id;		/* unique over all processors */
+  const char *shape;		/* blueprint element shape */
+  int num_corners;
+  int num_elems;		/* owned elements of the block */
+  int *conn;			/* [num_elems*num_corners] */
+};
+
+static int Insitu_Ready = FALSE;
+static int Num_Insitu_Blocks = 0;
+static struct Insitu_Block *Insitu_Blocks = NULL;
+static Exo_DB *Insitu_Exo = NULL;
+
+static conduit_node *Insitu_Step = NULL; /* step being described */
+static int Num_Insitu_Copies = 0;
+static dbl **Insitu_Copies = NULL;	/* values copied for this step */
+
+/*
+ * Blueprint name and corner count of an element shape, NULL if it has
+ * none.
+ */
+
+static const char *
+insitu_shape(const int elem_type,
+	     int *num_corners)
+{
+  switch (type2shape(elem_type)) {
+  case LINE_SEGMENT:
+    *num_corners = 2;
+    return "line";
+  case TRIANGLE:
+  case TRISHELL:
+    *num_corners = 3;
+    return "tri";
+  case QUADRILATERAL:
+  case SHELL:
+    *num_corners = 4;
+    return "quad";
+  case TETRAHEDRON:
+    *num_corners = 4;
+    return "tet";
+  case PRISM:
+    *num_corners = 6;
+    return "wedge";
+  case PYRAMID:
+    *num_corners = 5;
+    return "pyramid";
+  case HEXAHEDRON:
+    *num_corners = 8;
+    return "hex";
+  default:
+    *num_corners = 0;
+    return NULL;
+  }
+}
+
+static void
+insitu_initialize(Exo_DB *exo,
+		  Dpi *dpi)
+{
+  conduit_node *params;
+  struct Insitu_Block *ib;
+  int b, e, j, k, npe;
+
+  params = conduit_node_create();
+  conduit_node_set_path_char8_str(params, "catalyst/scripts/script0",
+				  Catalyst_Script);
+  if (Catalyst_Implementation[0] != '\0') {
+    conduit_node_set_path_char8_str(params, "catalyst_load/implementation",
+				    Catalyst_Implementation);
+  }
+  if (catalyst_initialize(params) != catalyst_status_ok) {
+    WH(-1, "catalyst_initialize failed, in situ output is off");
+    Catalyst_Script[0] = '\0';
+    conduit_node_destroy(params);
+    return;
+  }
+  conduit_node_destroy(params);
+
+  Insitu_Exo = exo;
+  Insitu_Blocks = (struct Insitu_Block *)
+    smalloc(MAX(exo->num_elem_blocks, 1) * sizeof(struct Insitu_Block));
+  Num_Insitu_Blocks = 0;
+  for (b = 0; b < exo->num_elem_blocks; b++) {
+    ib = Insitu_Blocks + Num_Insitu_Blocks;
+    ib->shape = insitu_shape(exo->eb_elem_itype[b], &ib->num_corners);
+    if (ib->shape == NULL) {
+      DPRINTF(stderr, "In situ output skips element block %d, its shape has no blueprint\n",
+	      exo->eb_id[b]);
+      continue;
+    }
+    ib->domain_id = ProcID * dpi->num_elem_blocks_global + dpi->eb_index_global[b];
+    npe = exo->eb_num_nodes_per_elem[b];
+
+    ib->num_elems = 0;
+    for (e = exo->eb_ptr[b]; e < exo->eb_ptr[b + 1]; e++) {
+      if (dpi->elem_owner[e] == ProcID) ib->num_elems++;
+    }
+    ib->conn = (int *) smalloc(MAX(ib->num_elems * ib->num_corners, 1) * sizeof(int));
+    k = 0;
+    for (e = exo->eb_ptr[b]; e < exo->eb_ptr[b + 1]; e++) {
+      if (dpi->elem_owner[e] != ProcID) continue;
+      for (j = 0; j < ib->num_corners && j < npe; j++) {
+	ib->conn[k++] = exo->node_list[exo->elem_ptr[e] + j];
+      }
+    }
+    Num_Insitu_Blocks++;
+  }
+
+  Insitu_Ready = TRUE;
+}
+#endif /* GOMA_CATALYST */
+
+int
+insitu_active(void)
+{
+#ifdef GOMA_CATALYST
+  return (Catalyst_Script[0] != '\0');
+#else
+  return (FALSE);
+#endif
+}
+
+void
+insitu_step_begin(Exo_DB *exo,
+		  Dpi *dpi,
+		  const int step,
+		  const dbl time)
+
+     /*****************************************************************
+      * insitu_step_begin()
+      *
+      *        start describing output step "step" to Catalyst: its
+      *        time and the mesh. Fields follow through
+      *        insitu_nodal_field() until insitu_step_execute().
+      *****************************************************************/
+{
+#ifdef GOMA_CATALYST
+  char path[INSITU_PATH_LEN];
+  struct Insitu_Block *ib;
+  int b;
+
+  if (!insitu_active()) return;
+  if (!Insitu_Ready) insitu_initialize(exo, dpi);
+  if (!Insitu_Ready) return;
+  if (Insitu_Step != NULL) insitu_step_execute();
+
+  Insitu_Step = conduit_node_create();
+  conduit_node_set_path_int64(Insitu_Step, "catalyst/state/timestep", step);
+  conduit_node_set_path_float64(Insitu_Step, "catalyst/state/time", time);
+  conduit_node_set_path_char8_str(Insitu_Step, "catalyst/channels/grid/type", "mesh");
+
+  for (b = 0; b < Num_Insitu_Blocks; b++) {
+    ib = Insitu_Blocks + b;
+
+#define INSITU_PATH(leaf) \
+    (snprintf(path, INSITU_PATH_LEN, "catalyst/channels/grid/data/domain_%d/%s", \
+	      ib->domain_id, (leaf)), path)
+
+    conduit_node_set_path_int64(Insitu_Step, INSITU_PATH("state/domain_id"),
+				ib->domain_id);
+    conduit_node_set_path_char8_str(Insitu_Step, INSITU_PATH("coordsets/coords/type"),
+				    "explicit");
+    conduit_node_set_path_external_float64_ptr(Insitu_Step,
+					       INSITU_PATH("coordsets/coords/values/x"),
+					       exo->x_coord, exo->num_nodes);
+    if (exo->num_dim > 1) {
+      conduit_node_set_path_external_float64_ptr(Insitu_Step,
+						 INSITU_PATH("coordsets/coords/values/y"),
+						 exo->y_coord, exo->num_nodes);
+    }
+    if (exo->num_dim > 2) {
+      conduit_node_set_path_external_float64_ptr(Insitu_Step,
+						 INSITU_PATH("coordsets/coords/values/z"),
+						 exo->z_coord, exo->num_nodes);
+    }
+    conduit_node_set_path_char8_str(Insitu_Step, INSITU_PATH("topologies/mesh/type"),
+				    "unstructured");
+    conduit_node_set_path_char8_str(Insitu_Step, INSITU_PATH("topologies/mesh/coordset"),
+				    "coords");
+    conduit_node_set_path_char8_str(Insitu_Step,
+				    INSITU_PATH("topologies/mesh/elements/shape"),
+				    ib->shape);
+    conduit_node_set_path_external_int32_ptr(Insitu_Step,
+					     INSITU_PATH("topologies/mesh/elements/connectivity"),
+					     (conduit_int32 *) ib->conn,
+					     ib->num_elems * ib->num_corners);
+#undef INSITU_PATH
+  }
+#endif
+}
+
+void
+insitu_nodal_field(const char *name,
+		   dbl *values,
+		   const int hold)
+
+     /*****************************************************************
+      * insitu_nodal_field()
+      *
+      *        add a nodal variable to the open step, if there is one.
+      *****************************************************************/
+{
+#ifdef GOMA_CATALYST
+  char path[INSITU_PATH_LEN];
+  dbl *v = values;
+  int b, n;
+
+  if (Insitu_Step == NULL) return;
+
+  if (hold == INSITU_COPY) {
+    v = (dbl *) smalloc(MAX(Insitu_Exo->num_nodes, 1) * sizeof(dbl));
+    for (n = 0; n < Insitu_Exo->num_nodes; n++) v[n] = values[n];
+    Insitu_Copies = (dbl **) realloc(Insitu_Copies,
+				     (Num_Insitu_Copies + 1) * sizeof(dbl *));
+    if (Insitu_Copies == NULL) EH(-1, "Out of memory for in situ fields");
+    Insitu_Copies[Num_Insitu_Copies++] = v;
+  }
+
+  for (b = 0; b < Num_Insitu_Blocks; b++) {
+    snprintf(path, INSITU_PATH_LEN, "catalyst/channels/grid/data/domain_%d/fields/%s/",
+	     Insitu_Blocks[b].domain_id, name);
+    n = strlen(path);
+    strncpy(path + n, "association", INSITU_PATH_LEN - n);
+    conduit_node_set_path_char8_str(Insitu_Step, path, "vertex");
+    strncpy(path + n, "topology", INSITU_PATH_LEN - n);
+    conduit_node_set_path_char8_str(Insitu_Step, path, "mesh");
+    strncpy(path + n, "values", INSITU_PATH_LEN - n);
+    conduit_node_set_path_external_float64_ptr(Insitu_Step, path, v,
+					       Insitu_Exo->num_nodes);
+  }
+#endif
+}
+
+void
+insitu_step_execute(void)
+{
+#ifdef GOMA_CATALYST
+  int i;
+
+  if (Insitu_Step == NULL) return;
+
+  if (catalyst_execute(Insitu_Step) != catalyst_status_ok) {
+    WH(-1, "catalyst_execute failed for this output step");
+  }
+  conduit_node_destroy(Insitu_Step);
+  Insitu_Step = NULL;
+
+  for (i = 0; i < Num_Insitu_Copies; i++) free(Insitu_Copies[i]);
+  free(Insitu_Copies);
+  Insitu_Copies = NULL;
+  Num_Insitu_Copies = 0;
+#endif
+}
+
+void
+insitu_finalize(void)
+{
+#ifdef GOMA_CATALYST
+  conduit_node *params;
+  int b;
+
+  if (!Insitu_Ready) return;
+  insitu_step_execute();
+
+  params = conduit_node_create();
+  if (catalyst_finalize(params) != catalyst_status_ok) {
+    WH(-1, "catalyst_finalize failed");
+  }
+  conduit_node_destroy(params);
+
+  for (b = 0; b < Num_Insitu_Blocks; b++) free(Insitu_Blocks[b].conn);
+  free(Insitu_Blocks);
+  Insitu_Blocks = NULL;
+  Num_Insitu_Blocks = 0;
+  Insitu_Ready = FALSE;
+#endif
+}
+/*****************************************************************************/
+/*  END of file wr_insitu.c  */
+/*****************************************************************************/
@@ -28,6 +28,9 @@ static char rcsid[] =
 #define _XOPEN_SOURCE
 
 #include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include <string.h>
 #include <math.h>
 #include <time.h>
 #include <strings.h>
@@ -69,6 +72,167 @@ char err_msg[MAX_CHAR_IN_INPUT];
 
 FILE	*uf;			/* file pointer for this user data */
 
+/*
+ * Node set output maps.
+ *
+ * The owned nodes of a node set and the positions of their mesh
+ * displacements and of the printed variable in the solution vector are
+ * found once per (node set, variable, species, material) and kept for
+ * the rest of the run; they do not change after setup.
+ */
+
+struct NS_Dof_Map
+{
+  int ns_id, quantity, species, mat;
+  int nsp;			/* node set pointer, -1 if not on this proc */
+  int num;			/* owned nodes of the node set */
+  int *node;			/* [num] */
+  int (*dof)[4];		/* [num] mesh x, y, z and variable, or -1 */
+  struct NS_Dof_Map *next;
+};
+
+static struct NS_Dof_Map *NS_Dof_Maps = NULL;
+
+static struct NS_Dof_Map *
+ns_dof_map(const int ns_id, const int quantity, const int species,
+	   const int mat)
+{
+  struct NS_Dof_Map *m;
+  int j, node;
+
+  for (m = NS_Dof_Maps; m != NULL; m = m->next) {
+    if (m->ns_id == ns_id && m->quantity == quantity &&
+	m->species == species && m->mat == mat) return m;
+  }
+
+  m = (struct NS_Dof_Map *) smalloc(sizeof(struct NS_Dof_Map));
+  m->ns_id = ns_id;
+  m->quantity = quantity;
+  m->species = species;
+  m->mat = mat;
+  m->nsp = match_nsid(ns_id);
+  m->num = 0;
+  m->node = NULL;
+  m->dof = NULL;
+
+  if (m->nsp != -1) {
+    m->node = alloc_int_1(MAX(Proc_NS_Count[m->nsp], 1), -1);
+    m->dof = (int (*)[4]) smalloc(MAX(Proc_NS_Count[m->nsp], 1) * sizeof(int [4]));
+    for (j = 0; j < Proc_NS_Count[m->nsp]; j++) {
+      node = Proc_NS_List[Proc_NS_Pointers[m->nsp]+j];
+      if (node >= num_internal_dofs + num_boundary_dofs) continue;
+      m->node[m->num] = node;
+      m->dof[m->num][0] = Index_Solution(node, MESH_DISPLACEMENT1, 0, 0, -1);
+      m->dof[m->num][1] = Index_Solution(node, MESH_DISPLACEMENT2, 0, 0, -1);
+      m->dof[m->num][2] = (pd->Num_Dim == 3) ?
+	Index_Solution(node, MESH_DISPLACEMENT3, 0, 0, -1) : -1;
+      if (quantity == MASS_FRACTION) {
+	m->dof[m->num][3] = Index_Solution(node, quantity, species, 0, mat);
+      } else if (quantity < 0) {
+	m->dof[m->num][3] = -1;
+      } else {
+	m->dof[m->num][3] = Index_Solution(node, quantity, 0, 0, mat);
+      }
+      m->num++;
+    }
+  }
+
+  m->next = NS_Dof_Maps;
+  NS_Dof_Maps = m;
+  return m;
+}
+
+static void
+ns_dof_map_position(const struct NS_Dof_Map *m, const int k, const double x[],
+		    dbl *x_pos, dbl *y_pos, dbl *z_pos)
+{
+  const int node = m->node[k];
+
+  if (m->dof[k][0] == -1) {
+    *x_pos = Coor[0][node];
+    WH(-1, "Mesh variable not found.  May get undeformed coords.");
+  } else {
+    *x_pos = Coor[0][node] + x[m->dof[k][0]];
+  }
+  *y_pos = Coor[1][node] + ((m->dof[k][1] == -1) ? 0. : x[m->dof[k][1]]);
+  *z_pos = 0.;
+  if (pd->Num_Dim == 3) {
+    *z_pos = Coor[2][node] + ((m->dof[k][2] == -1) ? 0. : x[m->dof[k][2]]);
+  }
+}
+
+/*
+ * The lines each processor prints in one call are collected in a buffer
+ * and written by processor 0 in processor order, from one gather, rather
+ * than by every processor in turn.
+ */
+
+struct NS_Out
+{
+  char *buf;
+  int len, size;
+};
+
+static void
+ns_out_printf(struct NS_Out *o, const char *format, ...)
+{
+  va_list args;
+  int n;
+
+  for (;;) {
+    va_start(args, format);
+    n = vsnprintf(o->buf + o->len, o->size - o->len, format, args);
+    va_end(args);
+    if (n < 0) return;
+    if (o->len + n < o->size) break;
+    o->size = MAX(2 * o->size, o->len + n + 256);
+    o->buf = (char *) realloc(o->buf, o->size);
+    if (o->buf == NULL) EH(-1, "Out of memory for node set output");
+  }
+  o->len += n;
+}
+
+static void
+ns_out_write(const char *filenm, struct NS_Out *o)
+{
+  char *all = o->buf;
+  int len = o->len;
+#ifdef PARALLEL
+  int *lens = NULL, *displs = NULL, i;
+
+  if (Num_Proc > 1) {
+    if (ProcID == 0) {
+      lens = alloc_int_1(Num_Proc, 0);
+      displs = alloc_int_1(Num_Proc + 1, 0);
+    }
+    MPI_Gather(&o->len, 1, MPI_INT, lens, 1, MPI_INT, 0, MPI_COMM_WORLD);
+    all = NULL;
+    if (ProcID == 0) {
+      for (i = 0; i < Num_Proc; i++) displs[i+1] = displs[i] + lens[i];
+      len = displs[Num_Proc];
+      all = (char *) smalloc(MAX(len, 1));
+    }
+    MPI_Gatherv(o->buf, o->len, MPI_CHAR, all, lens, displs, MPI_CHAR, 0,
+		MPI_COMM_WORLD);
+  }
+#endif
+
+  if (ProcID == 0 && len > 0 && (uf = fopen(filenm, "a")) != NULL) {
+    fwrite(all, 1, len, uf);
+    fclose(uf);
+  }
+
+#ifdef PARALLEL
+  if (Num_Proc > 1) {
+    if (ProcID == 0) safe_free(all);
+    safer_free((void **) &lens);
+    safer_free((void **) &displs);
+  }
+#endif
+  safer_free((void **) &o->buf);
+  o->len = o->size = 0;
+}
+
 int
 ns_data_print(pp_Data * p, 
 	      double x[], 
@@ -94,12 +258,14 @@ ns_data_print(pp_Data * p,
   int elem_list[4], elem_ct=0, face, ielem, node2;
   int local_node[4];
   int node = -1;
-  int idx, idy, idz, id_var;
+  int id_var;
   int iprint;
   int nsp;			/* node set pointer for this node set */
   dbl x_pos, y_pos, z_pos;
-  int j, wspec;
+  int j, k, wspec;
   int doPressure = 0;
+  struct NS_Dof_Map *map;
+  struct NS_Out out = { NULL, 0, 0 };
 
 #ifdef PARALLEL
   double some_time=0.0;
@@ -134,7 +300,8 @@ ns_data_print(pp_Data * p,
     pd = pd_glob[0];
   }
 
-  nsp = match_nsid(node_set_id);  
+  map = ns_dof_map(node_set_id, quantity, species_id, mat_num);
+  nsp = map->nsp;
 
   if( nsp != -1 )
     {
@@ -148,8 +315,6 @@ ns_data_print(pp_Data * p,
 
   /* first right time stamp or run stamp to separate the sets */
 
-  print_sync_start(FALSE);
-
   if (*first_time)
     {
       if ( format_flag[0] != '\0' ) 
@@ -184,38 +349,11 @@ ns_data_print(pp_Data * p,
 
   if (nsp != -1 ) {
 
-    for (j = 0; j < Proc_NS_Count[nsp]; j++) {
-      node = Proc_NS_List[Proc_NS_Pointers[nsp]+j];
-      if (node < num_internal_dofs + num_boundary_dofs ) {
-        idx = Index_Solution(node, MESH_DISPLACEMENT1, 0, 0, -1);
-        if (idx == -1) {
-          x_pos = Coor[0][node];
-          WH(idx, "Mesh variable not found.  May get undeformed coords.");
-        } else {
-          x_pos = Coor[0][node] + x[idx];
-        }
-        idy = Index_Solution(node, MESH_DISPLACEMENT2, 0, 0, -1);
-        if (idy == -1) {
-          y_pos = Coor[1][node];
-        } else {
-          y_pos = Coor[1][node] + x[idy];
-        }
-        z_pos = 0.;
-        if(pd->Num_Dim == 3) {
-          idz = Index_Solution(node, MESH_DISPLACEMENT3, 0, 0, -1);
-          if (idz == -1) {
-	    z_pos = Coor[2][node];
-          }  else{
-	    z_pos = Coor[2][node] + x[idz];
-          }
-        }
-        if (quantity == MASS_FRACTION) {
-          id_var = Index_Solution(node, quantity, species_id, 0, mat_num);
-        } else if (quantity < 0) {
-          id_var = -1;
-        } else {
-          id_var = Index_Solution(node, quantity, 0, 0, mat_num);
-        }
+    for (k = 0; k < map->num; k++) {
+      node = map->node[k];
+      {
+        ns_dof_map_position(map, k, x, &x_pos, &y_pos, &z_pos);
+        id_var = map->dof[k][3];
 
 	/*
 	 * In the easy case, the variable can be found somewhere in the
@@ -569,13 +707,12 @@ ns_data_print(pp_Data * p,
 	    if(id_var == -1) iprint = 0;
 	  }
 
-        if ((uf=fopen(filenm,"a")) != NULL)
-	  {
+	{
 	    if ( format_flag[0] == '\0' )
 	      {
 		if (iprint)
 		  {
-		    fprintf(uf,"  %e %e %e %e \n", x_pos, y_pos, z_pos, ordinate);
+		    ns_out_printf(&out, "  %e %e %e %e \n", x_pos, y_pos, z_pos, ordinate);
 		  }
 	      }
 	    else
@@ -602,15 +739,14 @@ ns_data_print(pp_Data * p,
 		  }
 		if (iprint)
 		  {
-		    fprintf(uf, "%.16g\t%.16g\n", abscissa, ordinate);
+		    ns_out_printf(&out, "%.16g\t%.16g\n", abscissa, ordinate);
 		  }
 	      }
-	    fclose(uf);
 	  }
       }
     }
   }
-  print_sync_end(FALSE);
+  ns_out_write(filenm, &out);
 
   return(1);
 } /* END of routine ns_data_print */
@@ -634,17 +770,16 @@ ns_data_sens_print(const struct Post_Processing_Data_Sens *p,
   const char *qtity_str = p->data_type_name;
   const int sens_ct     = p->vector_id;
 
-  int node;
-  int idx, idy, idz, id_var;
+  int id_var;
   int nsp;                      /* node set pointer for this node set */
   dbl x_pos, y_pos, z_pos;
-  int j;
+  int k;
+  struct NS_Dof_Map *map;
+  struct NS_Out out = { NULL, 0, 0 };
 
-  nsp            = match_nsid(node_set_id);
-  if( nsp != -1 ) {
-     node           = Proc_NS_List[Proc_NS_Pointers[nsp]];
-  }
-  else
+  map            = ns_dof_map(node_set_id, quantity, species_id, mat_id);
+  nsp            = map->nsp;
+  if( nsp == -1 )
   {
     sprintf(err_msg, "Node set ID %d not found.", node_set_id);
     if( Num_Proc == 1 ) EH(-1,err_msg);
@@ -652,8 +787,6 @@ ns_data_sens_print(const struct Post_Processing_Data_Sens *p,
 
   /* first right time stamp or run stamp to separate the sets */
 
-  print_sync_start(TRUE);
-
   if (ProcID == 0 && (uf=fopen(filenm,"a")) != NULL)
     {
       fprintf(uf,"Time/iteration = %e \n", time_value);
@@ -693,51 +826,20 @@ ns_data_sens_print(const struct Post_Processing_Data_Sens *p,
 
   if( nsp != -1 ) {
 
-    for (j = 0; j < Proc_NS_Count[nsp]; j++) {
-      node = Proc_NS_List[Proc_NS_Pointers[nsp]+j];
-      if( node < num_internal_dofs + num_boundary_dofs ) {
-        idx = Index_Solution (node, MESH_DISPLACEMENT1, 0, 0, -1);
-        if (idx == -1) {
-	  x_pos = Coor[0][node];
-          WH(idx, "Mesh variable not found.  May get undeformed coords.");
-        } else {
-	  x_pos = Coor[0][node] + x[idx];
-        }
-        idy = Index_Solution (node, MESH_DISPLACEMENT2, 0, 0, -1);
-        if (idy == -1) {
-	  y_pos = Coor[1][node];
-        } else {
-	  y_pos = Coor[1][node] + x[idy];
-        }
-        z_pos = 0.;
-        if (pd->Num_Dim == 3) {
-	  idz = Index_Solution(node, MESH_DISPLACEMENT3, 0, 0, -1);
-	  if (idz == -1) {
-	    z_pos = Coor[2][node];
-	  } else {
-	    z_pos = Coor[2][node] + x[idz];
-	  }
-        }
-        if(quantity == MASS_FRACTION) {
-	  id_var = Index_Solution(node, quantity, species_id, 0, mat_id);
-        } else {
-	  id_var = Index_Solution(node, quantity, 0, 0, mat_id);
-        }
-        WH(id_var,
-	   "Requested print variable is not defined at all nodes. May get 0.");
-
-        if ((uf=fopen(filenm,"a")) != NULL) {
-	  if (id_var != -1) {
-	    fprintf(uf, "  %e %e %e %e \n",
-		    x_pos, y_pos, z_pos, x_sens[sens_ct][id_var]);
-	  }
-	  fclose(uf);
-        }
+    for (k = 0; k < map->num; k++) {
+      ns_dof_map_position(map, k, x, &x_pos, &y_pos, &z_pos);
+      id_var = map->dof[k][3];
+      WH(id_var,
+	 "Requested print variable is not defined at all nodes. May get 0.");
+
+      if (id_var != -1) {
+	ns_out_printf(&out, "  %e %e %e %e \n",
+		      x_pos, y_pos, z_pos, x_sens[sens_ct][id_var]);
       }
     }
   }
 
-  print_sync_end(TRUE);
+  ns_out_write(filenm, &out);
 
   return(1);
 } /* END of routine ns_data_sens_print */
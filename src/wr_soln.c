@@ -60,17 +60,27 @@ void write_solution(char output_file[],             /* name EXODUS II file */
  *************************************************************************/
 {
   int i, i_post, step = 0;
+  dbl wall_start = wall_time();
 #ifdef DEBUG
   static char *yo = "write_solution";
   fprintf(stderr, "%s: begins\n", yo);
 #endif
 
+  timer_push("output");
+
+  /* Every solution written is a snapshot for Reduced Order Model = collect */
+  rom_snapshot(x);
+
+  /* The nodal results of this step also go to the in situ pipeline */
+  insitu_step_begin(exo, dpi, (*nprint) + 1, time_value);
+
   /* First nodal quantities */
   for (i = 0; i < rd->TotalNVSolnOutput; i++) {
     extract_nodal_vec(x, rd->nvtype[i], rd->nvkind[i], rd->nvmatID[i], gvec, exo, FALSE,
                       time_value);
     step = (*nprint) + 1;
     wr_nodal_result_exo(exo, output_file, gvec, i + 1, step, time_value);
+    insitu_nodal_field(rd->nvname[i], gvec, INSITU_COPY);
   }
 
 #ifdef DEBUG
@@ -111,6 +121,12 @@ void write_solution(char output_file[],             /* name EXODUS II file */
     }
   }
 
+  /* Running Statistics so far */
+  running_stats_write(rd, exo, output_file, gvec, (*nprint) + 1, time_value);
+
+  /* post_process_nodal() has run it already if there were fields to share */
+  insitu_step_execute();
+
   /* Now element quantities */
   for (i = 0; i < tev; i++) {
     bool is_P1 = FALSE;
@@ -164,6 +180,9 @@ void write_solution(char output_file[],             /* name EXODUS II file */
       }
     }
   }
+
+  timer_pop("output");
+  perf_log_output(wall_time() - wall_start);
 }
 /*****************************************************************************/
 /*  END of file wr_soln.c  */
@@ -0,0 +1,242 @@
+/************************************************************************ *
+* Goma - Multiphysics finite element software                             *
+* Sandia National Laboratories                                            *
+*                                                                         *
+* Copyright (c) 2014 Sandia Corporation.                                  *
+*                                                                         *
+* Under the terms of Contract DE-AC04-94AL85000 with Sandia Corporation,  *
+* the U.S. Government retains certain rights in this software.            *
+*                                                                         *
+* This software is distributed under the GNU General Public License.      *
+\************************************************************************/
+
+/*
+ * Running statistics of nodal solution variables.
+ *
+ * Averages of a transient used to need every step in the results file.
+ * Instead, each variable named on the "Running Statistics" card is
+ * sampled at every accepted time step, weighted by the step size, into a
+ * running mean and variance (West's weighted form of Welford's update)
+ * and a running minimum and maximum. These, and the time integral, are
+ * five more nodal variables of the results file, <name>_AVG, _VAR, _MIN,
+ * _MAX and _INT, so with a large print frequency only the final step,
+ * and any others printed, carry them. The sample of a step is the
+ * solution at its end.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <float.h>
+
+#include "std.h"
+#include "rf_allo.h"
+#include "mm_eh.h"
+#include "exo_struct.h"
+#include "dpi.h"
+
+#define _WR_STATS_C
+#include "goma.h"
+
+#define NUM_STATS 5		/* AVG, VAR, MIN, MAX, INT */
+
+struct Stats_Var
+{
+  int var;			/* nvtype, nvkind, nvmatID of the source */
+  int kind;
+  int matID;
+  int index;			/* of its first statistic in rd */
+  dbl *mean;			/* [num_nodes] each */
+  dbl *m2;			/* weighted sum of squared deviations */
+  dbl *min;
+  dbl *max;
+};
+
+static int Num_Stats_Vars = 0;
+static struct Stats_Var *Stats_Vars = NULL;
+static struct Results_Description *Stats_Rd = NULL;
+static dbl Stats_Weight = 0.;	/* time sampled so far */
+static dbl *Stats_Work = NULL;
+
+static const char *Stats_Suffix[NUM_STATS] = { "_AVG", "_VAR", "_MIN", "_MAX", "_INT" };
+
+static void
+running_stats_free(void)
+{
+  int s;
+
+  for (s = 0; s < Num_Stats_Vars; s++) {
+    free(Stats_Vars[s].mean);
+    free(Stats_Vars[s].m2);
+    free(Stats_Vars[s].min);
+    free(Stats_Vars[s].max);
+  }
+  free(Stats_Vars);
+  free(Stats_Work);
+  Stats_Vars = NULL;
+  Stats_Work = NULL;
+  Num_Stats_Vars = 0;
+  Stats_Rd = NULL;
+  Stats_Weight = 0.;
+}
+
+int
+running_stats_register(struct Results_Description *rd,
+		       Exo_DB *exo)
+
+     /*****************************************************************
+      * running_stats_register()
+      *
+      *        append the statistics of the variables on the Running
+      *        Statistics card to the nodal variables of rd, which
+      *        load_nodal_tkn() has just filled in.
+      *****************************************************************/
+{
+  char list[MAX_CHAR_IN_INPUT], name[MAX_VAR_NAME_LNGTH];
+  char *tok;
+  struct Stats_Var *sv;
+  int i, k, n, nn = MAX(exo->num_nodes, 1);
+
+  running_stats_free();
+  if (Running_Statistics[0] == '\0' || TimeIntegration == STEADY) return 0;
+
+  strncpy(list, Running_Statistics, MAX_CHAR_IN_INPUT - 1);
+  list[MAX_CHAR_IN_INPUT - 1] = '\0';
+  Stats_Vars = (struct Stats_Var *)
+    smalloc(MAX(rd->TotalNVSolnOutput, 1) * sizeof(struct Stats_Var));
+
+  for (tok = strtok(list, " \t,"); tok != NULL; tok = strtok(NULL, " \t,")) {
+    for (i = 0; i < rd->TotalNVSolnOutput; i++) {
+      if (strcmp(rd->nvname[i], tok) == 0) break;
+    }
+    if (i == rd->TotalNVSolnOutput) {
+      DPRINTF(stderr, "Running Statistics: %s is not a nodal solution variable of the results, skipped\n",
+	      tok);
+      continue;
+    }
+    for (k = 0; k < Num_Stats_Vars; k++) {
+      if (Stats_Vars[k].var == rd->nvtype[i] && Stats_Vars[k].kind == rd->nvkind[i] &&
+	  Stats_Vars[k].matID == rd->nvmatID[i]) break;
+    }
+    if (k < Num_Stats_Vars) continue;
+    if (rd->nnv + NUM_STATS > MAX_NNV) {
+      WH(-1, "Running Statistics: no room for more nodal variables (MAX_NNV)");
+      break;
+    }
+
+    sv = Stats_Vars + Num_Stats_Vars;
+    sv->var = rd->nvtype[i];
+    sv->kind = rd->nvkind[i];
+    sv->matID = rd->nvmatID[i];
+    sv->index = rd->nnv;
+    for (k = 0; k < NUM_STATS; k++) {
+      n = strlen(rd->nvname[i]);
+      if (n > MAX_VAR_NAME_LNGTH - 5) n = MAX_VAR_NAME_LNGTH - 5;
+      strncpy(name, rd->nvname[i], n);
+      strcpy(name + n, Stats_Suffix[k]);
+      set_nv_tkud(rd, rd->nnv, sv->var, sv->kind, sv->matID, name, "[1]",
+		  name, FALSE);
+      rd->nnv++;
+    }
+    sv->mean = alloc_dbl_1(nn, 0.0);
+    sv->m2 = alloc_dbl_1(nn, 0.0);
+    sv->min = alloc_dbl_1(nn, DBL_MAX);
+    sv->max = alloc_dbl_1(nn, -DBL_MAX);
+    Num_Stats_Vars++;
+  }
+
+  if (Num_Stats_Vars > 0) {
+    Stats_Rd = rd;
+    Stats_Work = alloc_dbl_1(nn, 0.0);
+  }
+  return (Num_Stats_Vars * NUM_STATS);
+}
+
+void
+running_stats_update(double x[],
+		     Exo_DB *exo,
+		     const dbl delta_t)
+
+     /*****************************************************************
+      * running_stats_update()
+      *
+      *        sample x, the solution at the end of a step of size
+      *        delta_t, into the statistics.
+      *****************************************************************/
+{
+  struct Stats_Var *sv;
+  dbl v, d, f;
+  int s, n;
+
+  if (Num_Stats_Vars == 0 || delta_t <= 0.) return;
+
+  Stats_Weight += delta_t;
+  f = delta_t / Stats_Weight;
+  for (s = 0; s < Num_Stats_Vars; s++) {
+    sv = Stats_Vars + s;
+    extract_nodal_vec(x, sv->var, sv->kind, sv->matID, Stats_Work, exo, FALSE, 0.);
+    for (n = 0; n < exo->num_nodes; n++) {
+      v = Stats_Work[n];
+      d = v - sv->mean[n];
+      sv->mean[n] += f * d;
+      sv->m2[n] += delta_t * d * (v - sv->mean[n]);
+      if (v < sv->min[n]) sv->min[n] = v;
+      if (v > sv->max[n]) sv->max[n] = v;
+    }
+  }
+}
+
+void
+running_stats_write(struct Results_Description *rd,
+		    Exo_DB *exo,
+		    char *filename,
+		    dbl *gvec,
+		    const int step,
+		    const dbl time_value)
+
+     /*****************************************************************
+      * running_stats_write()
+      *
+      *        write the statistics so far as nodal variables of output
+      *        step "step", if they belong to this results file. Before
+      *        the first sample they are all written as zero.
+      *****************************************************************/
+{
+  struct Stats_Var *sv;
+  int s, k, n;
+
+  if (Num_Stats_Vars == 0 || rd != Stats_Rd) return;
+
+  for (s = 0; s < Num_Stats_Vars; s++) {
+    sv = Stats_Vars + s;
+    for (k = 0; k < NUM_STATS; k++) {
+      for (n = 0; n < exo->num_nodes; n++) {
+	if (Stats_Weight <= 0.) {
+	  gvec[n] = 0.;
+	  continue;
+	}
+	switch (k) {
+	case 0:
+	  gvec[n] = sv->mean[n];
+	  break;
+	case 1:
+	  gvec[n] = sv->m2[n] / Stats_Weight;
+	  break;
+	case 2:
+	  gvec[n] = sv->min[n];
+	  break;
+	case 3:
+	  gvec[n] = sv->max[n];
+	  break;
+	default:
+	  gvec[n] = sv->mean[n] * Stats_Weight;
+	  break;
+	}
+      }
+      wr_nodal_result_exo(exo, filename, gvec, sv->index + k + 1, step, time_value);
+    }
+  }
+}
+/*****************************************************************************/
+/*  END of file wr_stats.c  */
+/*****************************************************************************/